@@ -49,6 +49,10 @@
 #include "utils/rls.h"
 #include "utils/snapmgr.h"
 
+/*  YB includes. */
+#include "executor/ybcModifyTable.h"
+#include "pg_yb_utils.h"
+
 
 #define ISOCTAL(c) (((c) >= '0') && ((c) <= '7'))
 #define OCTVALUE(c) ((c) - '0')
@@ -2526,8 +2530,14 @@ CopyFrom(CopyState cstate)
 		 (resultRelInfo->ri_TrigDesc->trig_insert_before_row ||
 		  resultRelInfo->ri_TrigDesc->trig_insert_instead_row)) ||
 		cstate->partition_dispatch_info != NULL ||
-		cstate->volatile_defexprs)
+		cstate->volatile_defexprs ||
+		(IsYugaByteEnabled() && IsYBSupportedTable(RelationGetRelid(cstate->rel))))
 	{
+		/*
+		 * YugaByte tables are loaded one row at a time through
+		 * YBCExecuteInsert(), which reuses the insert statement of the
+		 * relation and lets pggate buffer the writes.
+		 */
 		useHeapMultiInsert = false;
 	}
 	else
@@ -2773,6 +2783,17 @@ CopyFrom(CopyState cstate)
 						bufferedTuplesSize = 0;
 					}
 				}
+				else if (IsYugaByteEnabled() &&
+						 IsYBSupportedTable(RelationGetRelid(resultRelInfo->ri_RelationDesc)))
+				{
+					YBCExecuteInsert(resultRelInfo->ri_RelationDesc,
+									 RelationGetDescr(resultRelInfo->ri_RelationDesc),
+									 tuple);
+
+					/* AFTER ROW INSERT Triggers */
+					ExecARInsertTriggers(estate, resultRelInfo, tuple,
+										 NIL, cstate->transition_capture);
+				}
 				else
 				{
 					List	   *recheckIndexes = NIL;
@@ -150,6 +150,48 @@ YBCPgExpr YBCNewConstant(YBCPgStatement ybc_stmt, Oid type_id, Datum datum, bool
 	return expr;
 }
 
+void YBCUpdateConstant(YBCPgExpr expr, Oid type_id, Datum datum, bool is_null) {
+	if (YBCIsPgBinarySerializedType(type_id) || type_id == INT4ARRAYOID) {
+		char* data = NULL;
+		int64_t size = 0;
+		if (!is_null) {
+			data = VARDATA_ANY(datum);
+			size = VARSIZE_ANY_EXHDR(datum);
+		}
+		HandleYBStatus(YBCPgUpdateConstChar(expr, data, size, is_null));
+		return;
+	}
+
+	switch (type_id)
+	{
+		case BOOLOID:
+			HandleYBStatus(YBCPgUpdateConstBool(expr, DatumGetBool(datum), is_null));
+			break;
+		case INT8OID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			HandleYBStatus(YBCPgUpdateConstInt8(expr, DatumGetInt64(datum), is_null));
+			break;
+		case INT2OID:
+			HandleYBStatus(YBCPgUpdateConstInt2(expr, DatumGetInt16(datum), is_null));
+			break;
+		case INT4OID:
+		case OIDOID:
+			HandleYBStatus(YBCPgUpdateConstInt4(expr, DatumGetInt32(datum), is_null));
+			break;
+		case FLOAT4OID:
+			HandleYBStatus(YBCPgUpdateConstFloat4(expr, DatumGetFloat4(datum), is_null));
+			break;
+		case FLOAT8OID:
+			HandleYBStatus(YBCPgUpdateConstFloat8(expr, DatumGetFloat8(datum), is_null));
+			break;
+		default:
+			/* YBCNewConstant() does not construct constants of other types. */
+			YB_REPORT_TYPE_NOT_SUPPORTED(type_id);
+			break;
+	}
+}
+
 YBCPgExpr YBCNewColumnRef(YBCPgStatement ybc_stmt, int16_t attr_num) {
 	YBCPgExpr expr = NULL;
 	HandleYBStatus(YBCPgNewColumnRef(ybc_stmt, attr_num, &expr));
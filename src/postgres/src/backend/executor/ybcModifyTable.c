@@ -28,6 +28,9 @@
 #include "utils/relcache.h"
 #include "utils/rel.h"
 #include "utils/lsyscache.h"
+#include "utils/hsearch.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
 #include "commands/dbcommands.h"
 #include "executor/tuptable.h"
 #include "executor/ybcExpr.h"
@@ -37,8 +40,79 @@
 #include "yb/yql/pggate/ybc_pggate.h"
 #include "pg_yb_utils.h"
 
-Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple)
+/*
+ * INSERT statements are cached per relation for the lifetime of the backend, so
+ * that repeated inserts into the same table reuse the YugaByte statement with its
+ * request and column bindings, and only update the values of the bound constants.
+ * Entries are dropped when the relation is invalidated, e.g. by ALTER TABLE.
+ */
+typedef struct YBCInsertCacheEntry
+{
+	Oid				relid;			/* hash key, must be first */
+	YBCPgStatement	ybc_stmt;
+	int				natts;
+	Oid			   *type_ids;		/* type of each attribute */
+	YBCPgExpr	   *exprs;			/* constant bound to each attribute */
+	Bitmapset	   *pkey;			/* primary key attribute numbers */
+} YBCInsertCacheEntry;
+
+static HTAB *ybc_insert_cache = NULL;
+
+static void
+YBCInsertCacheRemove(YBCInsertCacheEntry *entry)
 {
+	YBCPgStatement ybc_stmt = entry->ybc_stmt;
+
+	pfree(entry->type_ids);
+	pfree(entry->exprs);
+	bms_free(entry->pkey);
+	hash_search(ybc_insert_cache, &entry->relid, HASH_REMOVE, NULL);
+	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+}
+
+static void
+YBCInsertCacheCallback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS		status;
+	YBCInsertCacheEntry *entry;
+
+	hash_seq_init(&status, ybc_insert_cache);
+	while ((entry = (YBCInsertCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (relid == InvalidOid || entry->relid == relid)
+		{
+			YBCInsertCacheRemove(entry);
+		}
+	}
+}
+
+static YBCInsertCacheEntry *
+YBCGetInsertStatement(Relation rel, TupleDesc tupleDesc)
+{
+	Oid					relid = RelationGetRelid(rel);
+	YBCInsertCacheEntry *entry;
+	bool				found;
+
+	if (ybc_insert_cache == NULL)
+	{
+		HASHCTL ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(YBCInsertCacheEntry);
+		ybc_insert_cache = hash_create("YB insert statement cache", 16, &ctl,
+									   HASH_ELEM | HASH_BLOBS);
+		CacheRegisterRelcacheCallback(YBCInsertCacheCallback, (Datum) 0);
+	}
+
+	entry = (YBCInsertCacheEntry *) hash_search(ybc_insert_cache, &relid, HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		if (entry->natts == tupleDesc->natts)
+			return entry;
+		YBCInsertCacheRemove(entry);
+	}
+
 	Bitmapset      *pkey         = NULL;
 	char           *dbname       = get_database_name(MyDatabaseId);
 	Oid            schemaoid     = rel->rd_rel->relnamespace;
@@ -46,16 +120,18 @@ Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple)
 	char           *tablename    = NameStr(rel->rd_rel->relname);
 	YBCPgStatement ybc_stmt      = NULL;
 	YBCPgTableDesc ybc_tabledesc = NULL;
+	MemoryContext  oldcontext;
 
 	/*
-	 * Get the primary key columns 'pkey' from YugaByte. Used below to
-	 * check that values for all primary key columns are given (not null)
+	 * Get the primary key columns 'pkey' from YugaByte. Used to check that
+	 * values for all primary key columns are given (not null)
 	 */
 	HandleYBStatus(YBCPgGetTableDesc(ybc_pg_session,
 	                                 dbname,
 	                                 tablename,
 	                                 &ybc_tabledesc));
 
+	oldcontext = MemoryContextSwitchTo(CacheMemoryContext);
 	for (AttrNumber attrNum = 1; attrNum <= rel->rd_att->natts; attrNum++)
 	{
 		bool is_primary = false;
@@ -69,39 +145,68 @@ Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple)
 			pkey = bms_add_member(pkey, attrNum);
 		}
 	}
+	MemoryContextSwitchTo(oldcontext);
 	HandleYBStatus(YBCPgDeleteTableDesc(ybc_tabledesc));
 	ybc_tabledesc = NULL;
 
-	/* Create the INSERT request and add the given values. */
+	/* Create the INSERT request and bind a constant to every column. */
 	HandleYBStatus(YBCPgNewInsert(ybc_pg_session,
 	                              dbname,
 	                              schemaname,
 	                              tablename,
 	                              &ybc_stmt));
-	bool     is_null = false;
+	Oid       *type_ids = MemoryContextAlloc(CacheMemoryContext,
+	                                         tupleDesc->natts * sizeof(Oid));
+	YBCPgExpr *exprs    = MemoryContextAlloc(CacheMemoryContext,
+	                                         tupleDesc->natts * sizeof(YBCPgExpr));
+	for (int i = 0; i < tupleDesc->natts; i++)
+	{
+		/* Attribute numbers start from 1 */
+		int attnum = i + 1;
+
+		type_ids[i] = tupleDesc->attrs[i]->atttypid;
+		exprs[i] = YBCNewConstant(ybc_stmt, type_ids[i], (Datum) 0, true /* is_null */);
+		HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt, attnum, exprs[i]),
+		                   ybc_stmt);
+	}
+
+	entry = (YBCInsertCacheEntry *) hash_search(ybc_insert_cache, &relid, HASH_ENTER, &found);
+	entry->ybc_stmt = ybc_stmt;
+	entry->natts = tupleDesc->natts;
+	entry->type_ids = type_ids;
+	entry->exprs = exprs;
+	entry->pkey = pkey;
+	return entry;
+}
+
+Oid YBCExecuteInsert(Relation rel, TupleDesc tupleDesc, HeapTuple tuple)
+{
+	YBCInsertCacheEntry *entry  = YBCGetInsertStatement(rel, tupleDesc);
+	bool                is_null = false;
+
+	/* Update the bound constants with the given values. */
 	for (int i = 0; i < tupleDesc->natts; i++)
 	{
-		Oid       type_id  = tupleDesc->attrs[i]->atttypid;
 		/* Attribute numbers start from 1 */
 		int       attnum   = i + 1;
 		Datum     datum    = heap_getattr(tuple, attnum, tupleDesc, &is_null);
 
-		if (is_null && bms_is_member(attnum, pkey))
+		if (is_null && bms_is_member(attnum, entry->pkey))
 		{
-			HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
 			ereport(ERROR,
 			        (errcode(ERRCODE_NOT_NULL_VIOLATION), errmsg(
 					        "Missing/null value for primary key column")));
 		}
-		YBCPgExpr ybc_expr = YBCNewConstant(ybc_stmt, type_id, datum, is_null);
-		HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt, attnum, ybc_expr),
-		                   ybc_stmt);
+		YBCUpdateConstant(entry->exprs[i], entry->type_ids[i], datum, is_null);
 	}
 
-	/* Execute the insert and clean up. */
-	HandleYBStmtStatus(YBCPgExecInsert(ybc_stmt), ybc_stmt);
-	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
-	ybc_stmt = NULL;
+	/* Execute the insert. The statement is kept for the next insert unless it failed. */
+	YBCStatus status = YBCPgExecInsert(entry->ybc_stmt);
+	if (status)
+	{
+		YBCInsertCacheRemove(entry);
+		HandleYBStatus(status);
+	}
 
 	/* YugaByte tables do not currently support Oids. */
 	return InvalidOid;
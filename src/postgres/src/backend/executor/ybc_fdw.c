@@ -54,6 +54,9 @@
 /*  YB includes. */
 #include "commands/dbcommands.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_type.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/array.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 
@@ -85,6 +88,9 @@ typedef struct YbFdwPlanState
 	/* (Equality) Conditions on range key -- filtered by YugaByte */
 	List *yb_rconds;
 
+	/* Simple conditions on other columns -- filtered by YugaByte */
+	List *yb_filter_conds;
+
 	/* Rest of baserestrictinfo conditions -- filtered by Postgres */
 	List *pg_conds;
 
@@ -96,6 +102,107 @@ typedef struct YbFdwPlanState
 
 } YbFdwPlanState;
 
+/*
+ * Returns whether YugaByte compares values of the given type the same way as
+ * Postgres does.
+ */
+static bool
+ybcIsFilterType(Oid type_id, bool is_eq)
+{
+	switch (type_id)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return true;
+		case BOOLOID:
+			return is_eq;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Returns whether an expression is a column (attribute) of the relation.
+ */
+static bool
+ybcIsFilterColumn(Expr *expr)
+{
+	return IsA(expr, Var) && ((Var *) expr)->varattno > 0 &&
+	       ((Var *) expr)->varlevelsup == 0;
+}
+
+/*
+ * Returns whether a condition can be evaluated by YugaByte to filter the rows
+ * it returns, instead of by Postgres. Supported conditions are:
+ * - '<col> <op> <value>' or '<value> <op> <col>' for comparison operators.
+ * - '<col> IN (<values>)'.
+ * - '<col> IS NULL' and '<col> IS NOT NULL'.
+ */
+static bool
+ybcIsFilterExpr(Expr *expr)
+{
+	if (IsA(expr, OpExpr))
+	{
+		OpExpr *opExpr = (OpExpr *) expr;
+		if (list_length(opExpr->args) != 2)
+			return false;
+
+		Expr *left  = linitial(opExpr->args);
+		Expr *right = lsecond(opExpr->args);
+		if (!((ybcIsFilterColumn(left) && IsA(right, Const)) ||
+		      (IsA(left, Const) && ybcIsFilterColumn(right))) ||
+		    exprType((Node *) left) != exprType((Node *) right))
+			return false;
+
+		char *opname = get_opname(opExpr->opno);
+		if (opname == NULL)
+			return false;
+		bool is_eq   = strcmp(opname, "=") == 0 ||
+		               strcmp(opname, "<>") == 0;
+		bool is_ineq = strcmp(opname, ">") == 0 ||
+		               strcmp(opname, ">=") == 0 ||
+		               strcmp(opname, "<") == 0 ||
+		               strcmp(opname, "<=") == 0;
+		pfree(opname);
+
+		return (is_eq || is_ineq) &&
+		       ybcIsFilterType(exprType((Node *) left), is_eq);
+	}
+
+	if (IsA(expr, ScalarArrayOpExpr))
+	{
+		ScalarArrayOpExpr *saop = (ScalarArrayOpExpr *) expr;
+		if (!saop->useOr || list_length(saop->args) != 2)
+			return false;
+
+		Expr *left  = linitial(saop->args);
+		Expr *right = lsecond(saop->args);
+		if (!ybcIsFilterColumn(left) || !IsA(right, Const) ||
+		    ((Const *) right)->constisnull ||
+		    get_element_type(exprType((Node *) right)) != exprType((Node *) left))
+			return false;
+
+		char *opname = get_opname(saop->opno);
+		if (opname == NULL)
+			return false;
+		bool is_eq = strcmp(opname, "=") == 0;
+		pfree(opname);
+
+		return is_eq && ybcIsFilterType(exprType((Node *) left), is_eq);
+	}
+
+	if (IsA(expr, NullTest))
+	{
+		NullTest *nullTest = (NullTest *) expr;
+		return !nullTest->argisrow && ybcIsFilterColumn(nullTest->arg);
+	}
+
+	return false;
+}
+
 /*
  * Returns whether an expression can be pushed down to be evaluated by YugaByte.
  * Otherwise, it will need to be evaluated by Postgres as it filters the rows
@@ -185,10 +292,35 @@ void ybcClassifyWhereExpr(RelOptInfo *baserel,
 		}
 	}
 
+	if (baserel->reloptkind == RELOPT_BASEREL && ybcIsFilterExpr(expr))
+	{
+		yb_state->yb_filter_conds = lappend(yb_state->yb_filter_conds, expr);
+		return;
+	}
+
 	/* Otherwise let postgres handle the condition (default) */
 	yb_state->pg_conds = lappend(yb_state->pg_conds, expr);
 }
 
+/*
+ * Defer key conditions that cannot be used to look up the rows, because the
+ * key is not fully set, to be filtered by YugaByte if possible, otherwise by
+ * Postgres.
+ */
+static void
+ybcDeferKeyConds(YbFdwPlanState *yb_state, List *conds)
+{
+	ListCell *lc;
+	foreach(lc, conds)
+	{
+		Expr *expr = (Expr *) lfirst(lc);
+		if (ybcIsFilterExpr(expr))
+			yb_state->yb_filter_conds = lappend(yb_state->yb_filter_conds, expr);
+		else
+			yb_state->pg_conds = lappend(yb_state->pg_conds, expr);
+	}
+}
+
 /*
  * Add a Postgres expression as a where condition to a YugaByte select
  * statement. Assumes the expression can be evaluated by YugaByte
@@ -217,6 +349,89 @@ void ybcAddWhereCond(Expr* expr, YBCPgStatement yb_stmt)
 	HandleYBStatus(YBCPgDmlBindColumn(yb_stmt, col_desc->varattno, ybc_expr));
 }
 
+/*
+ * Add a Postgres expression as a condition to filter the rows of a YugaByte
+ * select statement. Assumes the expression can be evaluated by YugaByte
+ * (i.e. ybcIsFilterExpr returns true).
+ */
+static void
+ybcAddFilterCond(Expr *expr, YBCPgStatement yb_stmt)
+{
+	YBCPgExpr ybc_op = NULL;
+
+	if (IsA(expr, OpExpr))
+	{
+		OpExpr *opExpr = (OpExpr *) expr;
+		char   *opname = get_opname(opExpr->opno);
+		ListCell *lc;
+
+		HandleYBStatus(YBCPgNewOperator(yb_stmt, opname, &ybc_op));
+		foreach(lc, opExpr->args)
+		{
+			Expr      *arg = (Expr *) lfirst(lc);
+			YBCPgExpr ybc_arg;
+			if (IsA(arg, Var))
+			{
+				ybc_arg = YBCNewColumnRef(yb_stmt, ((Var *) arg)->varattno);
+			}
+			else
+			{
+				Const *arg_val = (Const *) arg;
+				ybc_arg = YBCNewConstant(yb_stmt,
+				                         arg_val->consttype,
+				                         arg_val->constvalue,
+				                         arg_val->constisnull);
+			}
+			HandleYBStatus(YBCPgOperatorAppendArg(ybc_op, ybc_arg));
+		}
+		pfree(opname);
+	}
+	else if (IsA(expr, ScalarArrayOpExpr))
+	{
+		ScalarArrayOpExpr *saop    = (ScalarArrayOpExpr *) expr;
+		Var               *col_desc = (Var *) linitial(saop->args);
+		ArrayType         *values  = DatumGetArrayTypeP(((Const *) lsecond(saop->args))->constvalue);
+		Oid               elem_type = ARR_ELEMTYPE(values);
+		int16             elem_len;
+		bool              elem_byval;
+		char              elem_align;
+		Datum             *elems;
+		bool              *elem_nulls;
+		int               num_elems;
+
+		get_typlenbyvalalign(elem_type, &elem_len, &elem_byval, &elem_align);
+		deconstruct_array(values, elem_type, elem_len, elem_byval, elem_align,
+		                  &elems, &elem_nulls, &num_elems);
+
+		/* The column is followed by the values it is tested against. */
+		HandleYBStatus(YBCPgNewOperator(yb_stmt, "in", &ybc_op));
+		HandleYBStatus(YBCPgOperatorAppendArg(ybc_op,
+		                                      YBCNewColumnRef(yb_stmt, col_desc->varattno)));
+		for (int i = 0; i < num_elems; i++)
+		{
+			HandleYBStatus(YBCPgOperatorAppendArg(ybc_op,
+			                                      YBCNewConstant(yb_stmt,
+			                                                     elem_type,
+			                                                     elems[i],
+			                                                     elem_nulls[i])));
+		}
+	}
+	else
+	{
+		NullTest *nullTest = (NullTest *) expr;
+		Var      *col_desc = (Var *) nullTest->arg;
+
+		HandleYBStatus(YBCPgNewOperator(yb_stmt,
+		                                nullTest->nulltesttype == IS_NULL ? "is null"
+		                                                                  : "is not null",
+		                                &ybc_op));
+		HandleYBStatus(YBCPgOperatorAppendArg(ybc_op,
+		                                      YBCNewColumnRef(yb_stmt, col_desc->varattno)));
+	}
+
+	HandleYBStatus(YBCPgDmlAppendWhere(yb_stmt, ybc_op));
+}
+
 /*
  * ybcGetForeignRelSize
  *		Obtain relation size estimates for a foreign table
@@ -356,6 +571,7 @@ ybcGetForeignPlan(PlannerInfo *root,
 		Expr *expr = (Expr *) lfirst(lc);
 		if (!list_member_ptr(yb_plan_state->yb_hconds, expr) &&
 		    !list_member_ptr(yb_plan_state->yb_rconds, expr) &&
+		    !list_member_ptr(yb_plan_state->yb_filter_conds, expr) &&
 		    !list_member_ptr(yb_plan_state->pg_conds, expr))
 		{
 			ybcClassifyWhereExpr(baserel, yb_plan_state, expr);
@@ -364,20 +580,33 @@ ybcGetForeignPlan(PlannerInfo *root,
 
 	/*
 	 * If hash key is not fully set, we must do a full-table scan in YugaByte
-	 * and defer all filtering to Postgres.
+	 * and defer filtering for key column conds.
 	 * Else, if primary key is not fully set we need to remove all range
-	 * key conds and defer filtering for range column conds to Postgres.
+	 * key conds and defer filtering for range column conds.
+	 * Deferred conds are filtered by YugaByte when possible, or by Postgres.
 	 */
 	if (!bms_is_subset(yb_plan_state->hash_key, yb_plan_state->yb_cols))
 	{
-		yb_plan_state->pg_conds  = scan_clauses;
+		List *yb_key_conds = list_concat(yb_plan_state->yb_hconds,
+		                                 yb_plan_state->yb_rconds);
+		yb_plan_state->pg_conds  = NIL;
 		yb_plan_state->yb_hconds = NIL;
 		yb_plan_state->yb_rconds = NIL;
+		foreach(lc, scan_clauses)
+		{
+			Expr *expr = (Expr *) lfirst(lc);
+			if (list_member_ptr(yb_plan_state->yb_filter_conds, expr))
+				continue;
+			if (list_member_ptr(yb_key_conds, expr) && ybcIsFilterExpr(expr))
+				yb_plan_state->yb_filter_conds =
+					lappend(yb_plan_state->yb_filter_conds, expr);
+			else
+				yb_plan_state->pg_conds = lappend(yb_plan_state->pg_conds, expr);
+		}
 	}
 	else if (!bms_is_subset(yb_plan_state->primary_key, yb_plan_state->yb_cols))
 	{
-		yb_plan_state->pg_conds = list_concat(yb_plan_state->pg_conds,
-		                                      yb_plan_state->yb_rconds);
+		ybcDeferKeyConds(yb_plan_state, yb_plan_state->yb_rconds);
 		yb_plan_state->yb_rconds = NIL;
 	}
 
@@ -386,6 +615,8 @@ ybcGetForeignPlan(PlannerInfo *root,
 	 * Specifically, any columns that are either:
 	 * 1. Referenced in the select targets (i.e. selected columns or exprs).
 	 * 2. Referenced in the WHERE clause exprs that Postgres must evaluate.
+	 * Columns that are only referenced by the conds filtered by YugaByte are
+	 * read by YugaByte but not returned.
 	 */
 	foreach(lc, baserel->reltarget->exprs)
 	{
@@ -446,14 +677,15 @@ ybcGetForeignPlan(PlannerInfo *root,
 	                             yb_plan_state->yb_rconds);
 
 	/* Create the ForeignScan node */
-	fdw_private = list_make2(target_attrs, yb_conds);
+	fdw_private = list_make3(target_attrs, yb_conds, yb_plan_state->yb_filter_conds);
 	return make_foreignscan(tlist,  /* target list */
 	                        yb_plan_state->pg_conds,  /* checked by Postgres */
 	                        scan_relid,
 	                        NIL,    /* expressions YB may evaluate (none) */
 	                        fdw_private,  /* private data for YB */
 	                        NIL,    /* custom YB target list (none for now */
-	                        yb_conds,    /* checked by YB */
+	                        list_concat(list_copy(yb_conds),
+	                                    yb_plan_state->yb_filter_conds),    /* checked by YB */
 	                        outer_plan);
 }
 
@@ -484,10 +716,11 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 	                                                      ->relnamespace);
 	char        *tablename   = NameStr(relation->rd_rel->relname);
 
-	/* Planning function above should ensure both target and conds are set */
-	Assert(foreignScan->fdw_private->length == 2);
-	List *target_attrs = linitial(foreignScan->fdw_private);
-	List *yb_conds     = lsecond(foreignScan->fdw_private);
+	/* Planning function above should ensure target and conds are set */
+	Assert(foreignScan->fdw_private->length == 3);
+	List *target_attrs    = linitial(foreignScan->fdw_private);
+	List *yb_conds        = lsecond(foreignScan->fdw_private);
+	List *yb_filter_conds = lthird(foreignScan->fdw_private);
 
 	YbFdwExecState *ybc_state = NULL;
 	ListCell       *lc;
@@ -516,6 +749,13 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 		ybcAddWhereCond(expr, ybc_state->handle);
 	}
 
+	/* Set WHERE clause conditions filtered by YugaByte. */
+	foreach(lc, yb_filter_conds)
+	{
+		Expr *expr = (Expr *) lfirst(lc);
+		ybcAddFilterCond(expr, ybc_state->handle);
+	}
+
 	/* Set scan targets. */
 	foreach(lc, target_attrs)
 	{
@@ -33,6 +33,7 @@
 #include "utils/rel.h"
 #include "catalog/pg_database.h"
 #include "utils/builtins.h"
+#include "utils/inval.h"
 #include "catalog/pg_type.h"
 
 #include "pg_yb_utils.h"
@@ -130,6 +131,21 @@ HandleYBTableDescStatus(YBCStatus status, YBCPgTableDesc table)
 	HandleYBStatus(status);
 }
 
+/*
+ * Relation cache invalidation callback. The descriptors of YugaByte tables
+ * cached by PgGate are keyed by name, so we drop all of them whenever a
+ * relation is invalidated, e.g. by an ALTER TABLE or DROP TABLE in another
+ * backend.
+ */
+static void
+YBRelCacheCallback(Datum arg, Oid relid)
+{
+	if (ybc_pg_session != NULL)
+	{
+		HandleYBStatus(YBCPgInvalidateCache(ybc_pg_session));
+	}
+}
+
 void
 YBInitPostgresBackend(
 					  const char *program_name,
@@ -168,6 +184,7 @@ YBInitPostgresBackend(
 			HandleYBStatus(YBCPgCreateSession(
 				/* pg_env */ NULL, user_name, &ybc_pg_session));
 		}
+		CacheRegisterRelcacheCallback(YBRelCacheCallback, (Datum) 0);
 	}
 }
 
@@ -35,6 +35,10 @@
 // Construct constant expression using the given datatype "type_id" and value "datum".
 extern YBCPgExpr YBCNewConstant(YBCPgStatement ybc_stmt, Oid type_id, Datum datum, bool is_null);
 
+// Update the value of a constant expression that was constructed by YBCNewConstant() with the same
+// datatype "type_id".
+extern void YBCUpdateConstant(YBCPgExpr expr, Oid type_id, Datum datum, bool is_null);
+
 // Construct column reference expression.
 extern YBCPgExpr YBCNewColumnRef(YBCPgStatement ybc_stmt, int16_t attr_num);
 
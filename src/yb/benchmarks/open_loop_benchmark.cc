@@ -0,0 +1,288 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/open_loop_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+#include "yb/common/ql_protocol_util.h"
+#include "yb/gutil/strings/split.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/stol_utils.h"
+
+using namespace std::literals;
+
+DEFINE_string(open_loop_benchmark_rates, "1000,2000,4000,8000,16000,32000",
+              "Comma separated list of target rates, in operations per second, swept by the open "
+              "loop benchmark in the given order.");
+
+DEFINE_int32(open_loop_benchmark_step_duration_sec, 30,
+             "Duration of each rate step of the open loop benchmark in seconds.");
+
+DEFINE_int32(open_loop_benchmark_read_percent, 50,
+             "Percent of the operations issued by the open loop benchmark that are reads, the "
+             "rest are writes.");
+
+DEFINE_int32(open_loop_benchmark_threads, 4,
+             "Number of threads issuing operations for the open loop benchmark. Each thread has "
+             "its own session and sends an equal share of the target rate.");
+
+DEFINE_int64(open_loop_benchmark_max_in_flight, 100000,
+             "Maximal number of operations in flight per thread of the open loop benchmark. When "
+             "it is reached the thread waits, which is accounted for in the latency of the "
+             "operations that are sent late.");
+
+DEFINE_int32(open_loop_benchmark_max_batch_ops, 16,
+             "Maximal number of operations the open loop benchmark session sends in one batch.");
+
+DEFINE_int32(open_loop_benchmark_max_batch_window_us, 1000,
+             "Maximal time the open loop benchmark session waits for more operations before "
+             "sending a batch.");
+
+DEFINE_double(open_loop_benchmark_knee_throughput_ratio, 0.95,
+              "A rate step is considered saturated when the achieved throughput is below this "
+              "fraction of its target rate.");
+
+DEFINE_double(open_loop_benchmark_knee_p99_factor, 10.0,
+              "A rate step is considered saturated when its p99 latency exceeds the p99 latency "
+              "of the first step by this factor.");
+
+DEFINE_bool(open_loop_benchmark_stop_at_knee, true,
+            "Stop sweeping rates after the first saturated rate step.");
+
+namespace yb {
+namespace benchmarks {
+
+namespace {
+
+const uint64_t kMaxTrackableLatencyUs = 60 * 1000 * 1000;
+const int kLatencySignificantDigits = 3;
+
+struct StepStats {
+  StepStats() : latency(kMaxTrackableLatencyUs, kLatencySignificantDigits) {}
+
+  HdrHistogram latency;
+  std::atomic<int64_t> errors{0};
+};
+
+struct StepResult {
+  int64_t target_rate = 0;
+  double achieved_rate = 0;
+  int64_t p99_us = 0;
+};
+
+Result<std::vector<int64_t>> ParseRates() {
+  std::vector<int64_t> rates;
+  std::vector<std::string> entries = strings::Split(
+      FLAGS_open_loop_benchmark_rates, ",", strings::SkipEmpty());
+  for (const auto& entry : entries) {
+    auto rate = VERIFY_RESULT(CheckedStoll(entry));
+    if (rate <= 0) {
+      return STATUS_FORMAT(InvalidArgument, "Target rate should be positive: $0", entry);
+    }
+    rates.push_back(rate);
+  }
+  if (rates.empty()) {
+    return STATUS(InvalidArgument, "No target rates specified");
+  }
+  return rates;
+}
+
+class OpenLoopBenchmark {
+ public:
+  OpenLoopBenchmark(client::YBClient* client,
+                    const client::TableHandle* table,
+                    const OpenLoopBenchmarkOptions& options)
+      : client_(client), table_(table), options_(options), value_(options.value_size, 'v') {}
+
+  void Run(const std::vector<int64_t>& rates) {
+    std::vector<StepResult> results;
+    for (auto rate : rates) {
+      results.push_back(RunStep(rate));
+      const auto& result = results.back();
+      if (IsSaturated(result, results.front())) {
+        LOG(INFO) << "Open loop benchmark saturated at " << rate << " ops/s";
+        if (FLAGS_open_loop_benchmark_stop_at_knee) {
+          break;
+        }
+      }
+    }
+
+    int64_t knee = 0;
+    for (const auto& result : results) {
+      if (IsSaturated(result, results.front())) {
+        break;
+      }
+      knee = result.target_rate;
+    }
+    if (knee == 0) {
+      LOG(INFO) << "Open loop benchmark: none of the rates was sustained";
+    } else {
+      LOG(INFO) << "Open loop benchmark: highest sustained rate before the knee " << knee
+                << " ops/s";
+    }
+  }
+
+ private:
+  StepResult RunStep(int64_t rate) {
+    StepStats stats;
+    const int num_threads = std::max(FLAGS_open_loop_benchmark_threads, 1);
+    const auto duration = MonoDelta::FromSeconds(FLAGS_open_loop_benchmark_step_duration_sec);
+    // Start all threads from the same schedule, a bit in the future so they are all running.
+    const auto start = MonoTime::Now() + 10ms;
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i != num_threads; ++i) {
+      threads.emplace_back([this, &stats, rate, num_threads, i, start, duration] {
+        Dispatch(&stats, static_cast<double>(rate) / num_threads, start, duration);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const auto passed = MonoTime::Now() - start;
+
+    StepResult result;
+    result.target_rate = rate;
+    result.achieved_rate = stats.latency.TotalCount() / std::max(passed.ToSeconds(), 1e-6);
+    result.p99_us = stats.latency.ValueAtPercentile(99);
+
+    const auto& latency = stats.latency;
+    LOG(INFO) << "Open loop benchmark target " << rate << " ops/s: "
+              << latency.TotalCount() << " ops in " << passed << ", "
+              << result.achieved_rate << " ops/s, "
+              << stats.errors.load() << " errors, latency us: "
+              << "mean " << latency.MeanValue()
+              << ", p50 " << latency.ValueAtPercentile(50)
+              << ", p99 " << result.p99_us
+              << ", p99.9 " << latency.ValueAtPercentile(99.9)
+              << ", max " << latency.MaxValue();
+    return result;
+  }
+
+  // Sends operations at the given rate from start until start + duration, and waits for all of
+  // them to complete.
+  void Dispatch(StepStats* stats, double rate, MonoTime start, MonoDelta duration) {
+    std::mt19937_64 rng(std::random_device{}());
+    std::uniform_int_distribution<int64_t> key_distribution(0, options_.num_keys - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    auto session = client_->NewSession();
+    session->SetTimeout(60s);
+    session->SetAutoFlush(FLAGS_open_loop_benchmark_max_batch_ops, 0 /* max_bytes */,
+                          MonoDelta::FromMicroseconds(
+                              FLAGS_open_loop_benchmark_max_batch_window_us));
+    std::atomic<int64_t> in_flight{0};
+
+    const auto interval_ns = 1e9 / rate;
+    for (int64_t i = 0;; ++i) {
+      // The intended send time only depends on the schedule, so falling behind it is not
+      // compensated by sending later operations later.
+      const auto intended = start + MonoDelta::FromNanoseconds(
+          static_cast<int64_t>(i * interval_ns));
+      if (intended - start >= duration) {
+        break;
+      }
+      const auto now = MonoTime::Now();
+      if (now < intended) {
+        SleepFor(intended - now);
+      }
+      while (in_flight.load(std::memory_order_acquire) >=
+                 FLAGS_open_loop_benchmark_max_in_flight) {
+        SleepFor(100us);
+      }
+
+      const auto key = "key:" + std::to_string(key_distribution(rng));
+      client::YBqlOpPtr op;
+      if (percent(rng) < FLAGS_open_loop_benchmark_read_percent) {
+        auto read_op = table_->NewReadOp();
+        QLAddStringHashValue(read_op->mutable_request(), key);
+        table_->AddColumns({"k", "v"}, read_op->mutable_request());
+        op = std::move(read_op);
+      } else {
+        auto write_op = table_->NewInsertOp();
+        QLAddStringHashValue(write_op->mutable_request(), key);
+        table_->AddStringColumnValue(write_op->mutable_request(), "v", value_);
+        op = std::move(write_op);
+      }
+      in_flight.fetch_add(1, std::memory_order_acq_rel);
+      session->ApplyAsync(op, [stats, op, intended, &in_flight](const Status& status) {
+        stats->latency.Increment((MonoTime::Now() - intended).ToMicroseconds());
+        if (!status.ok() || !op->succeeded()) {
+          if (stats->errors.fetch_add(1, std::memory_order_relaxed) == 0) {
+            LOG(WARNING) << "Open loop benchmark operation failed: "
+                         << (status.ok() ? op->response().ShortDebugString() : status.ToString());
+          }
+        }
+        in_flight.fetch_sub(1, std::memory_order_acq_rel);
+      });
+    }
+
+    while (in_flight.load(std::memory_order_acquire) != 0) {
+      SleepFor(1ms);
+    }
+  }
+
+  static bool IsSaturated(const StepResult& result, const StepResult& first) {
+    if (result.achieved_rate <
+            result.target_rate * FLAGS_open_loop_benchmark_knee_throughput_ratio) {
+      return true;
+    }
+    return &result != &first &&
+           result.p99_us > first.p99_us * FLAGS_open_loop_benchmark_knee_p99_factor;
+  }
+
+  client::YBClient* const client_;
+  const client::TableHandle* const table_;
+  const OpenLoopBenchmarkOptions options_;
+  const std::string value_;
+};
+
+} // namespace
+
+Status RunOpenLoopBenchmark(client::YBClient* client,
+                            const client::TableHandle* table,
+                            const OpenLoopBenchmarkOptions& options) {
+  if (options.num_keys <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Number of keys should be positive: $0",
+                         options.num_keys);
+  }
+  if (FLAGS_open_loop_benchmark_step_duration_sec <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Step duration should be positive: $0",
+                         FLAGS_open_loop_benchmark_step_duration_sec);
+  }
+  if (FLAGS_open_loop_benchmark_read_percent < 0 ||
+      FLAGS_open_loop_benchmark_read_percent > 100) {
+    return STATUS_FORMAT(InvalidArgument, "Read percent should be in [0, 100]: $0",
+                         FLAGS_open_loop_benchmark_read_percent);
+  }
+  auto rates = VERIFY_RESULT(ParseRates());
+
+  OpenLoopBenchmark benchmark(client, table, options);
+  benchmark.Run(rates);
+  return Status::OK();
+}
+
+} // namespace benchmarks
+} // namespace yb
@@ -0,0 +1,52 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_OPEN_LOOP_BENCHMARK_H
+#define YB_BENCHMARKS_OPEN_LOOP_BENCHMARK_H
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+class TableHandle;
+
+} // namespace client
+
+namespace benchmarks {
+
+struct OpenLoopBenchmarkOptions {
+  // Number of distinct keys read and written.
+  int64_t num_keys = 0;
+  // Size of the written values.
+  size_t value_size = 0;
+};
+
+// Issues reads and writes against the key-value table at a fixed target rate, without waiting for
+// earlier operations to complete, for each rate of --open_loop_benchmark_rates in turn.
+//
+// Latency of an operation is measured from the time it was scheduled to be sent rather than the
+// time it was actually sent. So a stall of the cluster, or of the benchmark itself, shows up in
+// the latency of every operation that should have been sent during it, instead of silently
+// lowering the offered load. Latency histograms of each rate are logged, followed by the highest
+// rate the cluster sustained before reaching the saturation knee.
+CHECKED_STATUS RunOpenLoopBenchmark(client::YBClient* client,
+                                    const client::TableHandle* table,
+                                    const OpenLoopBenchmarkOptions& options);
+
+} // namespace benchmarks
+} // namespace yb
+
+#endif // YB_BENCHMARKS_OPEN_LOOP_BENCHMARK_H
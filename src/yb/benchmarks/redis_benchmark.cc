@@ -0,0 +1,258 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/redis_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/benchmarks/workload_util.h"
+#include "yb/gutil/walltime.h"
+#include "yb/yql/redis/redisserver/redis_client.h"
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_util.h"
+
+DEFINE_int32(redis_benchmark_connections, 16,
+             "Number of connections opened to the redis proxies by the redis benchmark. Each "
+             "connection is driven by its own thread.");
+
+DEFINE_int32(redis_benchmark_pipeline_depth, 16,
+             "Number of commands the redis benchmark sends on a connection before waiting for "
+             "their responses.");
+
+DEFINE_int32(redis_benchmark_duration_sec, 60, "Duration of the redis benchmark in seconds.");
+
+DEFINE_string(redis_benchmark_command_mix, "get:50,set:50",
+              "Comma separated list of <command>:<weight> pairs defining the commands sent by "
+              "the redis benchmark. Supported commands are get, set, hget, hset, zadd and tsadd.");
+
+DEFINE_string(redis_benchmark_key_distribution, "uniform",
+              "Distribution of the keys accessed by the redis benchmark: uniform, zipfian or "
+              "hotkey.");
+
+DEFINE_double(redis_benchmark_zipfian_theta, 0.99,
+              "Skew of the zipfian key distribution, must be in (0, 1).");
+
+DEFINE_double(redis_benchmark_hot_key_fraction, 0.01,
+              "Fraction of the keys that are hot for the hotkey key distribution.");
+
+DEFINE_double(redis_benchmark_hot_key_probability, 0.9,
+              "Probability that a command accesses a hot key for the hotkey key distribution.");
+
+DEFINE_int32(redis_benchmark_hash_fields, 10,
+             "Number of distinct fields accessed by hget and hset in the redis benchmark.");
+
+namespace yb {
+namespace benchmarks {
+
+using redisserver::RedisClient;
+using redisserver::RedisCommand;
+using redisserver::RedisReply;
+using redisserver::RedisReplyType;
+
+namespace {
+
+YB_DEFINE_ENUM(BenchmarkCommand, (kGet)(kSet)(kHGet)(kHSet)(kZAdd)(kTsAdd));
+
+const std::vector<std::string> kCommandNames = {"get", "set", "hget", "hset", "zadd", "tsadd"};
+
+// Latencies are tracked in microseconds, up to one minute.
+const uint64_t kMaxTrackableLatencyUs = 60 * 1000 * 1000;
+const int kLatencySignificantDigits = 3;
+
+struct CommandStats {
+  CommandStats() : latency(kMaxTrackableLatencyUs, kLatencySignificantDigits) {}
+
+  HdrHistogram latency;
+  std::atomic<int64_t> errors{0};
+};
+
+class RedisBenchmark {
+ public:
+  RedisBenchmark(const RedisBenchmarkOptions& options,
+                 std::vector<HostPort> servers,
+                 std::vector<int64_t> weights,
+                 std::unique_ptr<KeyGenerator> key_generator)
+      : options_(options),
+        servers_(std::move(servers)),
+        command_distribution_(weights.begin(), weights.end()),
+        key_generator_(std::move(key_generator)),
+        stats_(kElementsInBenchmarkCommand) {
+    std::mt19937_64 rng(std::random_device{}());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    value_pool_.reserve(options_.max_value_size);
+    while (value_pool_.size() < options_.max_value_size) {
+      value_pool_.push_back(letter(rng));
+    }
+  }
+
+  void Run() {
+    const auto start = MonoTime::Now();
+    const auto deadline = start + MonoDelta::FromSeconds(FLAGS_redis_benchmark_duration_sec);
+    std::vector<std::thread> threads;
+    threads.reserve(FLAGS_redis_benchmark_connections);
+    for (int i = 0; i != FLAGS_redis_benchmark_connections; ++i) {
+      threads.emplace_back([this, i, deadline] {
+        Connection(servers_[i % servers_.size()], deadline);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    Report(MonoTime::Now() - start);
+  }
+
+ private:
+  void Connection(const HostPort& server, MonoTime deadline) {
+    std::mt19937_64 rng(std::random_device{}());
+    RedisClient client(server.host(), server.port());
+    auto command_distribution = command_distribution_;
+    std::vector<RedisCommand> batch(FLAGS_redis_benchmark_pipeline_depth);
+    std::vector<BenchmarkCommand> batch_commands(batch.size());
+    while (MonoTime::Now() < deadline) {
+      for (size_t i = 0; i != batch.size(); ++i) {
+        batch_commands[i] = static_cast<BenchmarkCommand>(command_distribution(rng));
+        FillCommand(batch_commands[i], &rng, &batch[i]);
+      }
+      const auto sent = MonoTime::Now();
+      for (size_t i = 0; i != batch.size(); ++i) {
+        CommandStats* stats = &stats_[to_underlying(batch_commands[i])];
+        client.Send(std::move(batch[i]), [stats, sent](const RedisReply& reply) {
+          stats->latency.Increment((MonoTime::Now() - sent).ToMicroseconds());
+          if (reply.get_type() == RedisReplyType::kError) {
+            if (stats->errors.fetch_add(1, std::memory_order_relaxed) == 0) {
+              LOG(WARNING) << "Redis benchmark command failed: " << reply.error();
+            }
+          }
+        });
+      }
+      client.Commit();
+    }
+  }
+
+  void FillCommand(BenchmarkCommand command, std::mt19937_64* rng, RedisCommand* out) const {
+    const std::string key_index = std::to_string(key_generator_->Next(rng));
+    switch (command) {
+      case BenchmarkCommand::kGet:
+        *out = {"GET", "key:" + key_index};
+        return;
+      case BenchmarkCommand::kSet:
+        *out = {"SET", "key:" + key_index, RandomValue(rng)};
+        return;
+      case BenchmarkCommand::kHGet:
+        *out = {"HGET", "hash:" + key_index, RandomField(rng)};
+        return;
+      case BenchmarkCommand::kHSet:
+        *out = {"HSET", "hash:" + key_index, RandomField(rng), RandomValue(rng)};
+        return;
+      case BenchmarkCommand::kZAdd:
+        *out = {"ZADD", "zset:" + key_index, std::to_string((*rng)() % 1000000),
+                RandomValue(rng)};
+        return;
+      case BenchmarkCommand::kTsAdd:
+        // Use the wall clock so that samples of a key mostly arrive in order, like real
+        // time series.
+        *out = {"TSADD", "ts:" + key_index,
+                std::to_string(GetCurrentTimeMicros()), RandomValue(rng)};
+        return;
+    }
+    FATAL_INVALID_ENUM_VALUE(BenchmarkCommand, command);
+  }
+
+  std::string RandomValue(std::mt19937_64* rng) const {
+    std::uniform_int_distribution<size_t> size(options_.min_value_size, options_.max_value_size);
+    std::uniform_int_distribution<size_t> offset(0, options_.max_value_size);
+    const auto value_size = size(*rng);
+    return value_pool_.substr(offset(*rng) % (options_.max_value_size - value_size + 1),
+                              value_size);
+  }
+
+  std::string RandomField(std::mt19937_64* rng) const {
+    return "f" + std::to_string((*rng)() % std::max(FLAGS_redis_benchmark_hash_fields, 1));
+  }
+
+  void Report(MonoDelta passed) const {
+    const double seconds = std::max(passed.ToSeconds(), 1e-6);
+    LOG(INFO) << "Redis benchmark completed in " << passed << ", connections: "
+              << FLAGS_redis_benchmark_connections << ", pipeline depth: "
+              << FLAGS_redis_benchmark_pipeline_depth << ", key distribution: "
+              << FLAGS_redis_benchmark_key_distribution;
+    for (size_t i = 0; i != stats_.size(); ++i) {
+      const auto& latency = stats_[i].latency;
+      if (latency.TotalCount() == 0) {
+        continue;
+      }
+      LOG(INFO) << kCommandNames[i] << ": "
+                << latency.TotalCount() << " ops, "
+                << latency.TotalCount() / seconds << " ops/s, "
+                << stats_[i].errors.load() << " errors, latency us: "
+                << "mean " << latency.MeanValue()
+                << ", p50 " << latency.ValueAtPercentile(50)
+                << ", p99 " << latency.ValueAtPercentile(99)
+                << ", p99.9 " << latency.ValueAtPercentile(99.9)
+                << ", max " << latency.MaxValue();
+    }
+  }
+
+  const RedisBenchmarkOptions options_;
+  const std::vector<HostPort> servers_;
+  const std::discrete_distribution<int> command_distribution_;
+  const std::unique_ptr<KeyGenerator> key_generator_;
+  std::string value_pool_;
+  std::vector<CommandStats> stats_;
+};
+
+} // namespace
+
+Status RunRedisBenchmark(const RedisBenchmarkOptions& options) {
+  if (options.num_keys <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Number of keys should be positive: $0",
+                         options.num_keys);
+  }
+  if (options.min_value_size > options.max_value_size) {
+    return STATUS_FORMAT(InvalidArgument, "Min value size $0 is greater than max value size $1",
+                         options.min_value_size, options.max_value_size);
+  }
+  if (FLAGS_redis_benchmark_connections <= 0 || FLAGS_redis_benchmark_pipeline_depth <= 0) {
+    return STATUS(InvalidArgument, "Connections and pipeline depth should be positive");
+  }
+  auto servers = VERIFY_RESULT(HostPort::ParseStrings(options.addresses, 6379));
+  if (servers.empty()) {
+    return STATUS(InvalidArgument, "No redis proxy addresses specified");
+  }
+  auto weights = VERIFY_RESULT(ParseOperationMix(FLAGS_redis_benchmark_command_mix, kCommandNames));
+  KeyDistributionOptions key_options;
+  key_options.distribution = FLAGS_redis_benchmark_key_distribution;
+  key_options.num_keys = options.num_keys;
+  key_options.zipfian_theta = FLAGS_redis_benchmark_zipfian_theta;
+  key_options.hot_key_fraction = FLAGS_redis_benchmark_hot_key_fraction;
+  key_options.hot_key_probability = FLAGS_redis_benchmark_hot_key_probability;
+  auto key_generator = VERIFY_RESULT(CreateKeyGenerator(key_options));
+
+  RedisBenchmark benchmark(options, std::move(servers), std::move(weights),
+                           std::move(key_generator));
+  benchmark.Run();
+  return Status::OK();
+}
+
+} // namespace benchmarks
+} // namespace yb
@@ -0,0 +1,43 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_REDIS_BENCHMARK_H
+#define YB_BENCHMARKS_REDIS_BENCHMARK_H
+
+#include <string>
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace benchmarks {
+
+struct RedisBenchmarkOptions {
+  // Comma separated list of <host:port> addresses of the redis proxy servers.
+  std::string addresses;
+  // Number of distinct keys per command type.
+  int64_t num_keys = 0;
+  // Values are chosen uniformly from [min_value_size, max_value_size].
+  size_t min_value_size = 0;
+  size_t max_value_size = 0;
+};
+
+// Drives the redis proxies with RESP commands over a number of connections, keeping up to
+// --redis_benchmark_pipeline_depth commands in flight per connection. Commands, key distribution
+// and duration are taken from the --redis_benchmark_* flags. Per command latency histograms are
+// logged when the run completes.
+CHECKED_STATUS RunRedisBenchmark(const RedisBenchmarkOptions& options);
+
+} // namespace benchmarks
+} // namespace yb
+
+#endif // YB_BENCHMARKS_REDIS_BENCHMARK_H
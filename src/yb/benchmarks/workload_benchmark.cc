@@ -0,0 +1,452 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/workload_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/benchmarks/workload_util.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/transaction.h"
+#include "yb/client/transaction_manager.h"
+#include "yb/client/yb_op.h"
+#include "yb/common/ql_protocol_util.h"
+#include "yb/common/ql_rowblock.h"
+#include "yb/common/ql_type.h"
+#include "yb/server/hybrid_clock.h"
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/string_case.h"
+
+using namespace std::literals;
+
+DEFINE_string(workload_benchmark_mix, "read:50,update:50",
+              "Comma separated list of <operation>:<weight> pairs defining the operations of the "
+              "workload benchmark. Supported operations are read, update, insert, scan, rmw "
+              "(read-modify-write) and txn (multi-row transaction).");
+
+DEFINE_int32(workload_benchmark_threads, 16,
+             "Number of threads running operations of the workload benchmark. Each thread waits "
+             "for its operation to complete before starting the next one.");
+
+DEFINE_int32(workload_benchmark_duration_sec, 60,
+             "Duration of the workload benchmark in seconds.");
+
+DEFINE_bool(workload_benchmark_load, true,
+            "Load all keys before running the workload benchmark.");
+
+DEFINE_string(workload_benchmark_key_distribution, "zipfian",
+              "Distribution of the keys accessed by the workload benchmark: uniform, zipfian, "
+              "latest or hotspot.");
+
+DEFINE_double(workload_benchmark_zipfian_theta, 0.99,
+              "Skew of the zipfian and latest key distributions, must be in (0, 1).");
+
+DEFINE_double(workload_benchmark_hot_key_fraction, 0.01,
+              "Fraction of the keys that are hot for the hotspot key distribution.");
+
+DEFINE_double(workload_benchmark_hot_key_probability, 0.9,
+              "Probability that an operation accesses a hot key for the hotspot key "
+              "distribution.");
+
+DEFINE_string(workload_benchmark_value_size_distribution, "uniform",
+              "Distribution of the value sizes written by the workload benchmark: fixed, uniform "
+              "or zipfian. Fixed always uses the max value size, zipfian favours small values.");
+
+DEFINE_int32(workload_benchmark_rows_per_key, 1,
+             "Number of clustering rows per partition key, set it above one for wide rows. Point "
+             "operations access one of the rows, scans read all of them.");
+
+DEFINE_int32(workload_benchmark_scan_limit, 100,
+             "Maximal number of rows returned by a scan of the workload benchmark.");
+
+DEFINE_int32(workload_benchmark_collection_size, 0,
+             "Number of entries of the map column written with every row by the workload "
+             "benchmark. 0 leaves the map column empty.");
+
+DEFINE_int32(workload_benchmark_txn_rows, 4,
+             "Number of rows, of random keys, written by a multi-row transaction of the workload "
+             "benchmark.");
+
+namespace yb {
+namespace benchmarks {
+
+namespace {
+
+YB_DEFINE_ENUM(WorkloadOperation, (kRead)(kUpdate)(kInsert)(kScan)(kRmw)(kTxn));
+
+const std::vector<std::string> kOperationNames = {
+    "read", "update", "insert", "scan", "rmw", "txn"};
+
+const int kLoadBatchSize = 128;
+
+// Latencies are tracked in microseconds, up to one minute.
+const uint64_t kMaxTrackableLatencyUs = 60 * 1000 * 1000;
+const int kLatencySignificantDigits = 3;
+
+struct OperationStats {
+  OperationStats() : latency(kMaxTrackableLatencyUs, kLatencySignificantDigits) {}
+
+  HdrHistogram latency;
+  std::atomic<int64_t> errors{0};
+};
+
+std::string KeyByIndex(int64_t index) {
+  return "key:" + std::to_string(index);
+}
+
+class WorkloadBenchmark {
+ public:
+  WorkloadBenchmark(const client::YBClientPtr& client,
+                    const WorkloadBenchmarkOptions& options,
+                    std::vector<int64_t> weights)
+      : client_(client),
+        options_(options),
+        operation_distribution_(weights.begin(), weights.end()),
+        transactional_(weights[to_underlying(WorkloadOperation::kTxn)] != 0),
+        latest_key_(options.num_keys),
+        stats_(kElementsInWorkloadOperation) {
+    std::mt19937_64 rng(std::random_device{}());
+    std::uniform_int_distribution<int> letter('a', 'z');
+    value_pool_.reserve(options_.max_value_size);
+    while (value_pool_.size() < options_.max_value_size) {
+      value_pool_.push_back(letter(rng));
+    }
+  }
+
+  CHECKED_STATUS Init() {
+    KeyDistributionOptions key_options;
+    key_options.distribution = FLAGS_workload_benchmark_key_distribution;
+    key_options.num_keys = options_.num_keys;
+    key_options.zipfian_theta = FLAGS_workload_benchmark_zipfian_theta;
+    key_options.hot_key_fraction = FLAGS_workload_benchmark_hot_key_fraction;
+    key_options.hot_key_probability = FLAGS_workload_benchmark_hot_key_probability;
+    key_options.latest_key = &latest_key_;
+    key_generator_ = VERIFY_RESULT(CreateKeyGenerator(key_options));
+
+    std::string size_distribution;
+    ToLowerCase(FLAGS_workload_benchmark_value_size_distribution, &size_distribution);
+    if (size_distribution == "fixed") {
+      fixed_value_size_ = true;
+    } else if (size_distribution == "uniform" || size_distribution == "zipfian") {
+      // Value sizes are generated like keys, so small sizes are the popular ones for zipfian.
+      KeyDistributionOptions size_options;
+      size_options.distribution = size_distribution;
+      size_options.num_keys = options_.max_value_size - options_.min_value_size + 1;
+      size_options.zipfian_theta = FLAGS_workload_benchmark_zipfian_theta;
+      value_size_generator_ = VERIFY_RESULT(CreateKeyGenerator(size_options));
+    } else {
+      return STATUS_FORMAT(InvalidArgument, "Unknown value size distribution: $0",
+                           FLAGS_workload_benchmark_value_size_distribution);
+    }
+
+    RETURN_NOT_OK(CreateTable());
+    if (transactional_) {
+      clock_.reset(new server::HybridClock());
+      RETURN_NOT_OK(clock_->Init());
+      transaction_manager_ = std::make_unique<client::TransactionManager>(
+          client_, clock_, client::LocalTabletFilter());
+    }
+    return Status::OK();
+  }
+
+  void Load() {
+    const auto start = MonoTime::Now();
+    std::atomic<int64_t> next_key{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i != FLAGS_workload_benchmark_threads; ++i) {
+      threads.emplace_back([this, &next_key] {
+        std::mt19937_64 rng(std::random_device{}());
+        auto session = NewSession();
+        for (;;) {
+          const auto first = next_key.fetch_add(kLoadBatchSize, std::memory_order_acq_rel);
+          if (first >= options_.num_keys) {
+            break;
+          }
+          const auto last = std::min<int64_t>(first + kLoadBatchSize, options_.num_keys);
+          for (auto key = first; key != last; ++key) {
+            ApplyWideRow(key, &rng, session.get());
+          }
+          auto status = session->Flush();
+          LOG_IF(WARNING, !status.ok()) << "Workload benchmark load failed: " << status;
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    LOG(INFO) << "Workload benchmark loaded " << options_.num_keys << " keys in "
+              << MonoTime::Now() - start;
+  }
+
+  void Run() {
+    const auto start = MonoTime::Now();
+    const auto deadline = start + MonoDelta::FromSeconds(FLAGS_workload_benchmark_duration_sec);
+    std::vector<std::thread> threads;
+    threads.reserve(FLAGS_workload_benchmark_threads);
+    for (int i = 0; i != FLAGS_workload_benchmark_threads; ++i) {
+      threads.emplace_back([this, deadline] {
+        Worker(deadline);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    Report(MonoTime::Now() - start);
+  }
+
+ private:
+  CHECKED_STATUS CreateTable() {
+    client::YBSchemaBuilder builder;
+    builder.AddColumn("k")->Type(DataType::STRING)->HashPrimaryKey()->NotNull();
+    builder.AddColumn("r")->Type(DataType::INT32)->PrimaryKey()->NotNull();
+    builder.AddColumn("v")->Type(DataType::BINARY);
+    builder.AddColumn("m")->Type(QLType::CreateTypeMap(DataType::STRING, DataType::STRING));
+    if (transactional_) {
+      TableProperties table_properties;
+      table_properties.SetTransactional(true);
+      builder.SetTableProperties(table_properties);
+    }
+    RETURN_NOT_OK(client_->CreateNamespaceIfNotExists(options_.table_name.namespace_name()));
+    auto status = table_.Create(
+        options_.table_name, options_.num_tablets, client_.get(), &builder);
+    if (status.IsAlreadyPresent()) {
+      LOG(INFO) << "Workload benchmark table " << options_.table_name.ToString()
+                << " already exists, reusing it";
+      return table_.Open(options_.table_name, client_.get());
+    }
+    return status;
+  }
+
+  client::YBSessionPtr NewSession() const {
+    auto session = client_->NewSession();
+    session->SetTimeout(60s);
+    return session;
+  }
+
+  void Worker(MonoTime deadline) {
+    std::mt19937_64 rng(std::random_device{}());
+    auto operation_distribution = operation_distribution_;
+    auto session = NewSession();
+    while (MonoTime::Now() < deadline) {
+      const auto operation = static_cast<WorkloadOperation>(operation_distribution(rng));
+      OperationStats* stats = &stats_[to_underlying(operation)];
+      const auto start = MonoTime::Now();
+      auto status = Execute(operation, &rng, session.get());
+      stats->latency.Increment((MonoTime::Now() - start).ToMicroseconds());
+      if (!status.ok()) {
+        if (stats->errors.fetch_add(1, std::memory_order_relaxed) == 0) {
+          LOG(WARNING) << "Workload benchmark " << kOperationNames[to_underlying(operation)]
+                       << " failed: " << status;
+        }
+      }
+    }
+  }
+
+  CHECKED_STATUS Execute(
+      WorkloadOperation operation, std::mt19937_64* rng, client::YBSession* session) {
+    switch (operation) {
+      case WorkloadOperation::kRead:
+        return ReadRow(key_generator_->Next(rng), RandomRow(rng), session).status();
+      case WorkloadOperation::kUpdate:
+        return Write(session, WriteOp(
+            key_generator_->Next(rng), RandomRow(rng), RandomValueSize(rng), rng));
+      case WorkloadOperation::kInsert:
+        ApplyWideRow(latest_key_.fetch_add(1, std::memory_order_acq_rel), rng, session);
+        return session->Flush();
+      case WorkloadOperation::kScan:
+        return Scan(key_generator_->Next(rng), session);
+      case WorkloadOperation::kRmw:
+        return ReadModifyWrite(key_generator_->Next(rng), RandomRow(rng), rng, session);
+      case WorkloadOperation::kTxn:
+        return Transaction(rng);
+    }
+    FATAL_INVALID_ENUM_VALUE(WorkloadOperation, operation);
+  }
+
+  Result<QLRowBlock> ReadRow(int64_t key, int32_t row, client::YBSession* session) const {
+    auto op = table_.NewReadOp();
+    auto* const req = op->mutable_request();
+    QLAddStringHashValue(req, KeyByIndex(key));
+    table_.AddInt32Condition(req->mutable_where_expr()->mutable_condition(), "r", QL_OP_EQUAL,
+                             row);
+    table_.AddColumns({"v", "m"}, req);
+    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    RETURN_NOT_OK(CheckResponse(*op));
+    return op->MakeRowBlock();
+  }
+
+  CHECKED_STATUS Scan(int64_t key, client::YBSession* session) const {
+    auto op = table_.NewReadOp();
+    auto* const req = op->mutable_request();
+    QLAddStringHashValue(req, KeyByIndex(key));
+    table_.AddColumns({"r", "v", "m"}, req);
+    req->set_limit(FLAGS_workload_benchmark_scan_limit);
+    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    return CheckResponse(*op);
+  }
+
+  CHECKED_STATUS ReadModifyWrite(
+      int64_t key, int32_t row, std::mt19937_64* rng, client::YBSession* session) {
+    auto rows = VERIFY_RESULT(ReadRow(key, row, session));
+    // Keep the size of the value, like an application updating a record in place would.
+    auto value_size = rows.row_count() != 0 && !rows.row(0).column(0).IsNull()
+        ? rows.row(0).column(0).binary_value().size() : RandomValueSize(rng);
+    return Write(session, WriteOp(key, row, value_size, rng));
+  }
+
+  CHECKED_STATUS Transaction(std::mt19937_64* rng) {
+    auto transaction = std::make_shared<client::YBTransaction>(transaction_manager_.get());
+    RETURN_NOT_OK(transaction->Init(IsolationLevel::SNAPSHOT_ISOLATION));
+    auto session = NewSession();
+    session->SetTransaction(transaction);
+    std::vector<client::YBqlWriteOpPtr> ops;
+    for (int i = 0; i != FLAGS_workload_benchmark_txn_rows; ++i) {
+      ops.push_back(WriteOp(key_generator_->Next(rng), RandomRow(rng), RandomValueSize(rng), rng));
+      RETURN_NOT_OK(session->Apply(ops.back()));
+    }
+    RETURN_NOT_OK(session->Flush());
+    for (const auto& op : ops) {
+      RETURN_NOT_OK(CheckResponse(*op));
+    }
+    return transaction->CommitFuture().get();
+  }
+
+  // Applies all rows of the key to the session, without flushing it.
+  void ApplyWideRow(int64_t key, std::mt19937_64* rng, client::YBSession* session) {
+    for (int32_t row = 0; row != std::max(FLAGS_workload_benchmark_rows_per_key, 1); ++row) {
+      auto status = session->Apply(WriteOp(key, row, RandomValueSize(rng), rng));
+      LOG_IF(WARNING, !status.ok()) << "Workload benchmark apply failed: " << status;
+    }
+  }
+
+  client::YBqlWriteOpPtr WriteOp(
+      int64_t key, int32_t row, size_t value_size, std::mt19937_64* rng) {
+    auto op = table_.NewInsertOp();
+    auto* const req = op->mutable_request();
+    QLAddStringHashValue(req, KeyByIndex(key));
+    QLAddInt32RangeValue(req, row);
+    table_.AddBinaryColumnValue(req, "v", RandomValue(value_size, rng));
+    auto* map = table_.PrepareColumn(req, "m")->mutable_map_value();
+    for (int i = 0; i != FLAGS_workload_benchmark_collection_size; ++i) {
+      map->add_keys()->set_string_value("f" + std::to_string(i));
+      map->add_values()->set_string_value(RandomValue(RandomValueSize(rng), rng));
+    }
+    return op;
+  }
+
+  CHECKED_STATUS Write(client::YBSession* session, const client::YBqlWriteOpPtr& op) {
+    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    return CheckResponse(*op);
+  }
+
+  static CHECKED_STATUS CheckResponse(const client::YBqlOp& op) {
+    if (op.response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS_FORMAT(RemoteError, "Operation failed: $0", op.response().error_message());
+    }
+    return Status::OK();
+  }
+
+  int32_t RandomRow(std::mt19937_64* rng) const {
+    return (*rng)() % std::max(FLAGS_workload_benchmark_rows_per_key, 1);
+  }
+
+  size_t RandomValueSize(std::mt19937_64* rng) const {
+    if (fixed_value_size_) {
+      return options_.max_value_size;
+    }
+    return options_.min_value_size + value_size_generator_->Next(rng);
+  }
+
+  std::string RandomValue(size_t size, std::mt19937_64* rng) const {
+    size = std::min(size, options_.max_value_size);
+    std::uniform_int_distribution<size_t> offset(0, options_.max_value_size - size);
+    return value_pool_.substr(offset(*rng), size);
+  }
+
+  void Report(MonoDelta passed) const {
+    const double seconds = std::max(passed.ToSeconds(), 1e-6);
+    LOG(INFO) << "Workload benchmark completed in " << passed << ", threads: "
+              << FLAGS_workload_benchmark_threads << ", key distribution: "
+              << FLAGS_workload_benchmark_key_distribution << ", rows per key: "
+              << FLAGS_workload_benchmark_rows_per_key;
+    for (size_t i = 0; i != stats_.size(); ++i) {
+      const auto& latency = stats_[i].latency;
+      if (latency.TotalCount() == 0) {
+        continue;
+      }
+      LOG(INFO) << kOperationNames[i] << ": "
+                << latency.TotalCount() << " ops, "
+                << latency.TotalCount() / seconds << " ops/s, "
+                << stats_[i].errors.load() << " errors, latency us: "
+                << "mean " << latency.MeanValue()
+                << ", p50 " << latency.ValueAtPercentile(50)
+                << ", p99 " << latency.ValueAtPercentile(99)
+                << ", p99.9 " << latency.ValueAtPercentile(99.9)
+                << ", max " << latency.MaxValue();
+    }
+  }
+
+  const client::YBClientPtr client_;
+  const WorkloadBenchmarkOptions options_;
+  const std::discrete_distribution<int> operation_distribution_;
+  const bool transactional_;
+  // Index of the next key to insert, the latest key distribution is skewed towards it.
+  std::atomic<int64_t> latest_key_;
+  std::unique_ptr<KeyGenerator> key_generator_;
+  bool fixed_value_size_ = false;
+  std::unique_ptr<KeyGenerator> value_size_generator_;
+  std::string value_pool_;
+  client::TableHandle table_;
+  server::ClockPtr clock_;
+  std::unique_ptr<client::TransactionManager> transaction_manager_;
+  std::vector<OperationStats> stats_;
+};
+
+} // namespace
+
+Status RunWorkloadBenchmark(const client::YBClientPtr& client,
+                            const WorkloadBenchmarkOptions& options) {
+  if (options.num_keys <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Number of keys should be positive: $0",
+                         options.num_keys);
+  }
+  if (options.min_value_size > options.max_value_size) {
+    return STATUS_FORMAT(InvalidArgument, "Min value size $0 is greater than max value size $1",
+                         options.min_value_size, options.max_value_size);
+  }
+  if (FLAGS_workload_benchmark_threads <= 0) {
+    return STATUS(InvalidArgument, "Number of workload benchmark threads should be positive");
+  }
+  auto weights = VERIFY_RESULT(ParseOperationMix(FLAGS_workload_benchmark_mix, kOperationNames));
+
+  WorkloadBenchmark benchmark(client, options, std::move(weights));
+  RETURN_NOT_OK(benchmark.Init());
+  if (FLAGS_workload_benchmark_load) {
+    benchmark.Load();
+  }
+  benchmark.Run();
+  return Status::OK();
+}
+
+} // namespace benchmarks
+} // namespace yb
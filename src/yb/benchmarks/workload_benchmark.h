@@ -0,0 +1,48 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_WORKLOAD_BENCHMARK_H
+#define YB_BENCHMARKS_WORKLOAD_BENCHMARK_H
+
+#include "yb/client/client.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace benchmarks {
+
+struct WorkloadBenchmarkOptions {
+  // Table created for the workload. Its schema differs from the load test table, so it should not
+  // be shared with it.
+  client::YBTableName table_name;
+  int num_tablets = 0;
+  // Number of partition keys loaded before the run. Inserts add keys after them.
+  int64_t num_keys = 0;
+  // Value sizes are chosen from [min_value_size, max_value_size] according to
+  // --workload_benchmark_value_size_distribution.
+  size_t min_value_size = 0;
+  size_t max_value_size = 0;
+};
+
+// Runs a YCSB style workload through the YQL client: point reads, updates, inserts, scans of wide
+// rows, read-modify-writes and multi-row transactions, mixed according to
+// --workload_benchmark_mix. Keys are chosen according to --workload_benchmark_key_distribution.
+// Rows carry a map column of --workload_benchmark_collection_size entries. Per operation type
+// latency histograms are logged when the run completes.
+CHECKED_STATUS RunWorkloadBenchmark(const client::YBClientPtr& client,
+                                    const WorkloadBenchmarkOptions& options);
+
+} // namespace benchmarks
+} // namespace yb
+
+#endif // YB_BENCHMARKS_WORKLOAD_BENCHMARK_H
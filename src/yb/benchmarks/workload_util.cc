@@ -0,0 +1,186 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/workload_util.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "yb/gutil/strings/split.h"
+#include "yb/util/stol_utils.h"
+#include "yb/util/string_case.h"
+
+namespace yb {
+namespace benchmarks {
+
+namespace {
+
+class UniformKeyGenerator : public KeyGenerator {
+ public:
+  explicit UniformKeyGenerator(int64_t num_keys) : distribution_(0, num_keys - 1) {}
+
+  int64_t Next(std::mt19937_64* rng) const override {
+    auto distribution = distribution_;
+    return distribution(*rng);
+  }
+
+ private:
+  std::uniform_int_distribution<int64_t> distribution_;
+};
+
+// Zipfian generator from "Quickly Generating Billion-Record Synthetic Databases" by Gray et al.,
+// the same one YCSB uses. Key 0 is the most popular one.
+class ZipfianKeyGenerator : public KeyGenerator {
+ public:
+  ZipfianKeyGenerator(int64_t num_keys, double theta)
+      : num_keys_(num_keys), theta_(theta), alpha_(1.0 / (1.0 - theta)) {
+    zeta_n_ = Zeta(num_keys, theta);
+    const double zeta_2 = Zeta(2, theta);
+    eta_ = (1.0 - std::pow(2.0 / num_keys, 1.0 - theta)) / (1.0 - zeta_2 / zeta_n_);
+  }
+
+  int64_t Next(std::mt19937_64* rng) const override {
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    const double u = distribution(*rng);
+    const double uz = u * zeta_n_;
+    if (uz < 1.0) {
+      return 0;
+    }
+    if (uz < 1.0 + std::pow(0.5, theta_)) {
+      return std::min<int64_t>(1, num_keys_ - 1);
+    }
+    auto result = static_cast<int64_t>(num_keys_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+    return std::min(result, num_keys_ - 1);
+  }
+
+ private:
+  static double Zeta(int64_t n, double theta) {
+    double result = 0;
+    for (int64_t i = 1; i <= n; ++i) {
+      result += 1.0 / std::pow(i, theta);
+    }
+    return result;
+  }
+
+  const int64_t num_keys_;
+  const double theta_;
+  const double alpha_;
+  double zeta_n_;
+  double eta_;
+};
+
+// Sends a fixed fraction of the accesses to a small set of hot keys and spreads the rest
+// uniformly over the remaining keys.
+class HotKeyGenerator : public KeyGenerator {
+ public:
+  HotKeyGenerator(int64_t num_keys, double hot_fraction, double hot_probability)
+      : num_keys_(num_keys),
+        num_hot_keys_(std::max<int64_t>(1, std::min<int64_t>(num_keys, num_keys * hot_fraction))),
+        hot_probability_(hot_probability) {}
+
+  int64_t Next(std::mt19937_64* rng) const override {
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    if (num_hot_keys_ == num_keys_ || coin(*rng) < hot_probability_) {
+      return std::uniform_int_distribution<int64_t>(0, num_hot_keys_ - 1)(*rng);
+    }
+    return std::uniform_int_distribution<int64_t>(num_hot_keys_, num_keys_ - 1)(*rng);
+  }
+
+ private:
+  const int64_t num_keys_;
+  const int64_t num_hot_keys_;
+  const double hot_probability_;
+};
+
+// Picks the distance from the latest key from a zipfian distribution over the initial number of
+// keys, like the YCSB latest distribution. So the most recently inserted keys are the most popular
+// ones while keys keep being inserted.
+class LatestKeyGenerator : public KeyGenerator {
+ public:
+  LatestKeyGenerator(int64_t num_keys, double theta, const std::atomic<int64_t>* latest_key)
+      : distance_(num_keys, theta), latest_key_(latest_key) {}
+
+  int64_t Next(std::mt19937_64* rng) const override {
+    const auto latest = latest_key_->load(std::memory_order_acquire);
+    return std::max<int64_t>(0, latest - 1 - distance_.Next(rng));
+  }
+
+ private:
+  const ZipfianKeyGenerator distance_;
+  const std::atomic<int64_t>* const latest_key_;
+};
+
+} // namespace
+
+Result<std::unique_ptr<KeyGenerator>> CreateKeyGenerator(const KeyDistributionOptions& options) {
+  if (options.num_keys <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Number of keys should be positive: $0",
+                         options.num_keys);
+  }
+  std::string distribution;
+  ToLowerCase(options.distribution, &distribution);
+  if (distribution == "uniform") {
+    return std::unique_ptr<KeyGenerator>(new UniformKeyGenerator(options.num_keys));
+  }
+  if (distribution == "zipfian" || distribution == "latest") {
+    const double theta = options.zipfian_theta;
+    if (theta <= 0 || theta >= 1) {
+      return STATUS_FORMAT(InvalidArgument, "Zipfian theta should be in (0, 1): $0", theta);
+    }
+    if (distribution == "zipfian") {
+      return std::unique_ptr<KeyGenerator>(new ZipfianKeyGenerator(options.num_keys, theta));
+    }
+    if (!options.latest_key) {
+      return STATUS(NotSupported, "Latest key distribution is not supported by this workload");
+    }
+    return std::unique_ptr<KeyGenerator>(
+        new LatestKeyGenerator(options.num_keys, theta, options.latest_key));
+  }
+  if (distribution == "hotspot" || distribution == "hotkey") {
+    return std::unique_ptr<KeyGenerator>(new HotKeyGenerator(
+        options.num_keys, options.hot_key_fraction, options.hot_key_probability));
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", options.distribution);
+}
+
+Result<std::vector<int64_t>> ParseOperationMix(const std::string& mix,
+                                               const std::vector<std::string>& names) {
+  std::vector<int64_t> weights(names.size());
+  int64_t total = 0;
+  std::vector<std::string> entries = strings::Split(mix, ",", strings::SkipEmpty());
+  for (const auto& entry : entries) {
+    std::vector<std::string> parts = strings::Split(entry, ":");
+    if (parts.size() != 2) {
+      return STATUS_FORMAT(InvalidArgument, "Bad operation mix entry: $0", entry);
+    }
+    std::string name;
+    ToLowerCase(parts[0], &name);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+      return STATUS_FORMAT(InvalidArgument, "Unsupported operation: $0", parts[0]);
+    }
+    auto weight = VERIFY_RESULT(CheckedStoll(parts[1]));
+    if (weight < 0) {
+      return STATUS_FORMAT(InvalidArgument, "Negative weight for $0", parts[0]);
+    }
+    weights[it - names.begin()] += weight;
+    total += weight;
+  }
+  if (total == 0) {
+    return STATUS(InvalidArgument, "Operation mix does not contain any operations");
+  }
+  return weights;
+}
+
+} // namespace benchmarks
+} // namespace yb
@@ -0,0 +1,61 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_WORKLOAD_UTIL_H
+#define YB_BENCHMARKS_WORKLOAD_UTIL_H
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "yb/util/result.h"
+
+namespace yb {
+namespace benchmarks {
+
+// Generates key indexes according to a key distribution.
+class KeyGenerator {
+ public:
+  virtual ~KeyGenerator() {}
+  virtual int64_t Next(std::mt19937_64* rng) const = 0;
+};
+
+struct KeyDistributionOptions {
+  // uniform, zipfian, hotspot (or its alias hotkey) or latest.
+  std::string distribution = "uniform";
+  // Keys are generated in [0, num_keys).
+  int64_t num_keys = 0;
+  // Skew of the zipfian and latest distributions, should be in (0, 1).
+  double zipfian_theta = 0.99;
+  // Fraction of the keys that are hot for the hotspot distribution.
+  double hot_key_fraction = 0.01;
+  // Probability that a hot key is generated by the hotspot distribution.
+  double hot_key_probability = 0.9;
+  // The latest distribution generates keys in [0, *latest_key) skewed towards *latest_key, so
+  // recently inserted keys are the most popular ones. It is not supported when null.
+  const std::atomic<int64_t>* latest_key = nullptr;
+};
+
+Result<std::unique_ptr<KeyGenerator>> CreateKeyGenerator(const KeyDistributionOptions& options);
+
+// Parses a comma separated list of <operation>:<weight> pairs into a weight per operation, indexed
+// like names. Operation names are case insensitive.
+Result<std::vector<int64_t>> ParseOperationMix(const std::string& mix,
+                                               const std::vector<std::string>& names);
+
+} // namespace benchmarks
+} // namespace yb
+
+#endif // YB_BENCHMARKS_WORKLOAD_UTIL_H
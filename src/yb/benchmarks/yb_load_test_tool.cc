@@ -39,6 +39,9 @@
 #include "yb/util/subprocess.h"
 #include "yb/util/threadpool.h"
 
+#include "yb/benchmarks/open_loop_benchmark.h"
+#include "yb/benchmarks/redis_benchmark.h"
+#include "yb/benchmarks/workload_benchmark.h"
 #include "yb/integration-tests/load_generator.h"
 
 DEFINE_int32(rpc_timeout_sec, 30, "Timeout for RPC calls, in seconds");
@@ -100,6 +103,26 @@ DEFINE_bool(
     stop_on_empty_read, true,
     "Stop reading if we get an empty set of rows on a read operation");
 
+DEFINE_bool(
+    redis_benchmark, false,
+    "Run the pipelined redis protocol benchmark against target_redis_server_addresses instead "
+    "of the load test. See the redis_benchmark_* flags.");
+
+DEFINE_bool(
+    open_loop_benchmark, false,
+    "Run the open loop latency benchmark, which sweeps fixed target rates and measures latency "
+    "from the intended send time, instead of the load test. See the open_loop_benchmark_* flags.");
+
+DEFINE_bool(
+    workload_benchmark, false,
+    "Run the YCSB style workload benchmark on its own <table_name>_workload table instead of the "
+    "load test. See the workload_benchmark_* flags.");
+
+DEFINE_int64(
+    max_value_size_bytes, 0,
+    "If greater than value_size_bytes, the redis and workload benchmarks pick value sizes between "
+    "value_size_bytes and this value.");
+
 using strings::Substitute;
 using std::atomic_long;
 using std::atomic_bool;
@@ -189,6 +212,19 @@ int main(int argc, char *argv[]) {
       if (FLAGS_reads_only) {
         SingleThreadedScanner scanner(&table);
         scanner.CountRows();
+      } else if (FLAGS_open_loop_benchmark) {
+        yb::benchmarks::OpenLoopBenchmarkOptions options;
+        options.num_keys = FLAGS_num_rows;
+        options.value_size = FLAGS_value_size_bytes;
+        CHECK_OK(yb::benchmarks::RunOpenLoopBenchmark(client.get(), &table, options));
+      } else if (FLAGS_workload_benchmark) {
+        yb::benchmarks::WorkloadBenchmarkOptions options;
+        options.table_name = YBTableName("my_keyspace", FLAGS_table_name + "_workload");
+        options.num_tablets = FLAGS_num_tablets;
+        options.num_keys = FLAGS_num_rows;
+        options.min_value_size = FLAGS_value_size_bytes;
+        options.max_value_size = std::max(FLAGS_value_size_bytes, FLAGS_max_value_size_bytes);
+        CHECK_OK(yb::benchmarks::RunWorkloadBenchmark(client, options));
       } else if (FLAGS_noop_only) {
         NoopSessionFactory session_factory(client.get(), &table);
         // Noop operations are done as write operations.
@@ -204,7 +240,14 @@ int main(int argc, char *argv[]) {
         LOG(INFO) << "Done creating redis table";
         return 0;
       }
-      if (FLAGS_noop_only) {
+      if (FLAGS_redis_benchmark) {
+        yb::benchmarks::RedisBenchmarkOptions options;
+        options.addresses = FLAGS_target_redis_server_addresses;
+        options.num_keys = FLAGS_num_rows;
+        options.min_value_size = FLAGS_value_size_bytes;
+        options.max_value_size = std::max(FLAGS_value_size_bytes, FLAGS_max_value_size_bytes);
+        CHECK_OK(yb::benchmarks::RunRedisBenchmark(options));
+      } else if (FLAGS_noop_only) {
         RedisNoopSessionFactory session_factory(FLAGS_target_redis_server_addresses);
         LaunchYBLoadTest(&session_factory);
       } else {
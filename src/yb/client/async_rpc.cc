@@ -12,6 +12,9 @@
 //
 
 #include "yb/client/async_rpc.h"
+
+#include <mutex>
+
 #include "yb/client/batcher.h"
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
@@ -22,6 +25,8 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/common/transaction.h"
 
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/logging.h"
@@ -44,8 +49,13 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, yb_client_read_restarts, "yb.client.Read restarts", yb::MetricUnit::kRequests,
+    "Number of Read and Write calls that were rejected because the read at the specified read "
+    "time requires restart");
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
+DECLARE_int64(retryable_rpc_single_call_timeout_ms);
 
 DEFINE_bool(forward_redis_requests, true, "If false, the redis op will not be served if it's not "
             "a local request. The op response will be set to the redis error "
@@ -94,17 +104,20 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      read_restarts(METRIC_yb_client_read_restarts.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(
     const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
-    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level)
+    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level,
+    bool read_from_followers)
     : Rpc(batcher->deadline(), batcher->messenger(), &batcher->proxy_cache()),
       batcher_(batcher),
       trace_(new Trace),
       tablet_invoker_(LocalTabletServerOnly(ops),
-                      yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX,
+                      yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX ||
+                          read_from_followers,
                       batcher->client_,
                       this,
                       this,
@@ -116,8 +129,10 @@ AsyncRpc::AsyncRpc(
       async_rpc_metrics_(batcher->async_rpc_metrics()) {
   mutable_retrier()->mutable_controller()->set_allow_local_calls_in_curr_thread(
       allow_local_calls_in_curr_thread);
+  include_trace_ = IsTracingEnabled();
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    include_trace_ = include_trace_ || Trace::CurrentTrace()->remote_traces_requested();
   }
 }
 
@@ -142,6 +157,24 @@ void AsyncRpc::SendRpc() {
   tablet_invoker_.Execute(std::string(), num_attempts() > 1);
 }
 
+void AsyncRpc::SendWithinInFlightLimit(size_t in_flight_bytes_limit) {
+  if (in_flight_bytes_limit == 0) {
+    SendRpc();
+    return;
+  }
+
+  // Empty requests still take a slot, so they are ordered with other requests.
+  in_flight_bytes_ = std::max<size_t>(RequestBytes(), 1);
+  in_flight_bytes_limit_ = in_flight_bytes_limit;
+  auto self = std::static_pointer_cast<AsyncRpc>(shared_from_this());
+  if (tablet_invoker_.tablet()->AcquireInFlightBytes(
+          in_flight_bytes_, in_flight_bytes_limit, [self] { self->SendRpc(); })) {
+    SendRpc();
+  } else {
+    TRACE_TO(trace_, "Waiting for requests in flight to the tablet");
+  }
+}
+
 std::string AsyncRpc::ToString() const {
   return Substitute("$0(tablet: $1, num_ops: $2, num_attempts: $3)",
                     ops_.front()->yb_op->read_only() ? "Read" : "Write",
@@ -157,6 +190,10 @@ const YBTable* AsyncRpc::table() const {
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
+    if (in_flight_bytes_ != 0) {
+      tablet_invoker_.tablet()->ReleaseInFlightBytes(in_flight_bytes_, in_flight_bytes_limit_);
+      in_flight_bytes_ = 0;
+    }
     ProcessResponseFromTserver(new_status);
     batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, PropagatedHybridTime());
     batcher_->CheckForFinishedFlush();
@@ -247,15 +284,19 @@ void AsyncRpc::SendRpcToTserver() {
 template <class Req, class Resp>
 AsyncRpcBase<Req, Resp>::AsyncRpcBase(
     const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
-    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel consistency_level)
-    : AsyncRpc(batcher, tablet, allow_local_calls_in_curr_thread, ops, consistency_level) {
+    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel consistency_level,
+    bool read_from_followers)
+    : AsyncRpc(batcher, tablet, allow_local_calls_in_curr_thread, ops, consistency_level,
+               read_from_followers) {
   req_.set_tablet_id(tablet_invoker_.tablet()->tablet_id());
-  req_.set_include_trace(IsTracingEnabled());
+  req_.set_include_trace(include_trace_);
   const ConsistentReadPoint* read_point = batcher_->read_point();
   if (read_point) {
     req_.set_propagated_hybrid_time(read_point->Now().ToUint64());
     // Set read time for consistent read only if the table is transaction-enabled.
-    if (table()->InternalSchema().table_properties().is_transactional()) {
+    // Single shard commit reads and writes at the current time of the tablet.
+    if (table()->InternalSchema().table_properties().is_transactional() &&
+        !batcher_->single_shard_commit()) {
       auto read_time = read_point->GetReadTime(tablet_invoker_.tablet()->tablet_id());
       if (read_time) {
         read_time.AddToPB(&req_);
@@ -287,6 +328,9 @@ bool AsyncRpcBase<Req, Resp>::CommonResponseCheck(const Status& status) {
     if (read_point) {
       read_point->RestartRequired(req_.tablet_id(), restart_read_time);
     }
+    if (async_rpc_metrics_) {
+      async_rpc_metrics_->read_restarts->Increment();
+    }
     Failed(STATUS_FORMAT(TryAgain, "Restart read required at: $0", restart_read_time));
     return false;
   }
@@ -555,9 +599,14 @@ void WriteRpc::ProcessResponseFromTserver(const Status& status) {
 
 ReadRpc::ReadRpc(
     const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
-    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level)
-    : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level) {
+    bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel yb_consistency_level,
+    bool read_from_followers)
+    : AsyncRpcBase(batcher, tablet, allow_local_calls_in_curr_thread, ops, yb_consistency_level,
+                   read_from_followers) {
   TRACE_TO(trace_, "ReadRpc initiated to $0", tablet->tablet_id());
+  // Reads are idempotent, so follower reads could be sent to several replicas.
+  tablet_invoker_.set_read_hedging(&table()->read_hedging());
+  req_.set_include_trace(include_trace_);
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(batcher->proxy_uuid());
 
@@ -628,12 +677,116 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
-  tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&ReadRpc::Finished, this, Status::OK()));
+  auto hedge_delay = tablet_invoker_.HedgeDelay();
+  if (hedge_delay.Initialized()) {
+    CallRemoteMethodHedged(hedge_delay);
+  } else {
+    tablet_invoker_.proxy()->ReadAsync(
+        req_, &resp_, PrepareController(),
+        std::bind(&ReadRpc::Finished, this, Status::OK()));
+  }
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+// A call of a hedged read. The call that did not respond first could outlive the RPC, so calls use
+// their own responses and controllers, which are swapped into the RPC by the call that wins.
+struct ReadRpc::HedgedCall {
+  // Copy of the request, only used by the hedged call. Local calls could read the request after
+  // the RPC is finished.
+  tserver::ReadRequestPB req;
+  tserver::ReadResponsePB resp;
+  rpc::RpcController controller;
+  RemoteTabletServer* ts = nullptr;
+  MonoTime send_time;
+};
+
+struct ReadRpc::HedgedCalls {
+  MonoTime deadline;
+  std::mutex mutex;
+  // Calls that were sent and did not respond yet.
+  int in_flight = 0;
+  // Whether a response was already handled.
+  bool done = false;
+  HedgedCall primary;
+  HedgedCall hedge;
+};
+
+void ReadRpc::CallRemoteMethodHedged(MonoDelta hedge_delay) {
+  auto self = std::static_pointer_cast<ReadRpc>(shared_from_this());
+  auto calls = std::make_shared<HedgedCalls>();
+  calls->deadline = std::min(
+      retrier().deadline(),
+      MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_retryable_rpc_single_call_timeout_ms));
+  calls->in_flight = 1;
+  calls->primary.controller.set_deadline(calls->deadline);
+  calls->primary.send_time = MonoTime::Now();
+  tablet_invoker_.proxy()->ReadAsync(
+      req_, &calls->primary.resp, &calls->primary.controller,
+      std::bind(&ReadRpc::HedgedCallFinished, self, calls, false));
+
+  auto task_id = messenger()->ScheduleOnReactor(
+      [self, calls](const Status& status) {
+        if (status.ok()) {
+          self->SendHedgedCall(calls);
+        }
+      },
+      hedge_delay, SOURCE_LOCATION(), messenger());
+  if (task_id == rpc::kInvalidTaskId) {
+    VLOG(1) << ToString() << ": Failed to schedule hedged read";
+  }
+}
+
+void ReadRpc::SendHedgedCall(const std::shared_ptr<HedgedCalls>& calls) {
+  // The lock is held while the request is sent, so it is not changed by the response handling.
+  std::lock_guard<std::mutex> lock(calls->mutex);
+  if (calls->done || calls->in_flight == 0) {
+    return;
+  }
+  auto* ts = tablet_invoker_.SelectHedgeTabletServer();
+  if (ts == nullptr) {
+    return;
+  }
+  TRACE_TO(trace_, "Hedging read to $0", ts->ToString());
+  auto& hedge = calls->hedge;
+  hedge.req = req_;
+  hedge.ts = ts;
+  hedge.send_time = MonoTime::Now();
+  hedge.controller.set_deadline(calls->deadline);
+  ++calls->in_flight;
+  ts->proxy()->ReadAsync(
+      hedge.req, &hedge.resp, &hedge.controller,
+      std::bind(&ReadRpc::HedgedCallFinished,
+                std::static_pointer_cast<ReadRpc>(shared_from_this()), calls, true));
+}
+
+void ReadRpc::HedgedCallFinished(const std::shared_ptr<HedgedCalls>& calls, bool hedge) {
+  auto& call = hedge ? calls->hedge : calls->primary;
+  {
+    std::lock_guard<std::mutex> lock(calls->mutex);
+    --calls->in_flight;
+    if (calls->done) {
+      return;
+    }
+    // Failures are only handled when there is no other call to wait for.
+    const bool failed = !call.controller.status().ok() || call.resp.has_error();
+    if (failed && calls->in_flight != 0) {
+      return;
+    }
+    calls->done = true;
+  }
+
+  if (hedge) {
+    TRACE_TO(trace_, "Hedged read responded first");
+    tablet_invoker_.HedgeResponded(call.ts, call.send_time);
+  }
+  resp_.Swap(&call.resp);
+  auto* controller = mutable_retrier()->mutable_controller();
+  const bool allow_local_calls = controller->allow_local_calls_in_curr_thread();
+  controller->Swap(&call.controller);
+  controller->set_allow_local_calls_in_curr_thread(allow_local_calls);
+  Finished(Status::OK());
+}
+
 void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
   size_t redis_idx = 0;
   size_t ql_idx = 0;
@@ -755,6 +908,13 @@ void ReadRpc::ProcessResponseFromTserver(const Status& status) {
   if (resp_.has_trace_buffer()) {
     TRACE_TO(trace_, "Received from server: $0", resp_.trace_buffer());
   }
+  // Should be done before the batcher is notified, because it could finish the flush.
+  if (status.ok() && resp_.has_local_limit_ht()) {
+    auto read_point = batcher_->read_point();
+    if (read_point) {
+      read_point->UpdateLocalLimit(req_.tablet_id(), HybridTime(resp_.local_limit_ht()));
+    }
+  }
   batcher_->ProcessReadResponse(*this, status);
   if (!CommonResponseCheck(status)) {
     SwapRequestsAndResponses(true);
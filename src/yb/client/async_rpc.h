@@ -42,6 +42,7 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> read_restarts;
 };
 
 typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
@@ -55,16 +56,22 @@ typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
 // This class deletes itself after Rpc returns and is processed.
 class AsyncRpc : public rpc::Rpc, public TabletRpc {
  public:
+  // If read_from_followers is true, the rpc could be sent to a follower, even with strong
+  // consistency level.
   AsyncRpc(
       const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
       bool allow_local_calls_in_curr_thread, InFlightOps ops,
-      YBConsistencyLevel yb_consistency_level);
+      YBConsistencyLevel yb_consistency_level, bool read_from_followers = false);
 
   virtual ~AsyncRpc();
 
   void SendRpc() override;
   string ToString() const override;
 
+  // Sends the RPC for the first time. If in_flight_bytes_limit is not zero, the send is delayed
+  // until the tablet has less than the limit of bytes in flight from this client.
+  void SendWithinInFlightLimit(size_t in_flight_bytes_limit);
+
   const YBTable* table() const;
   const RemoteTablet& tablet() const { return *tablet_invoker_.tablet(); }
   const InFlightOps& ops() const { return ops_; }
@@ -83,6 +90,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // Return latest hybrid time that was present on tserver during processing of this request.
   virtual HybridTime PropagatedHybridTime() = 0;
 
+  // Return serialized size of the request.
+  virtual size_t RequestBytes() const = 0;
+
   void Failed(const Status& status) override;
 
   // Is this a local call?
@@ -95,6 +105,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
+  // Whether the tablet server should return its trace, to be included into trace_.
+  bool include_trace_ = false;
+
   TabletInvoker tablet_invoker_;
 
   // Operations which were batched into this RPC.
@@ -104,6 +117,10 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
   MonoTime start_;
   std::shared_ptr<AsyncRpcMetrics> async_rpc_metrics_;
   rpc::RpcCommandPtr retained_self_;
+
+  // Bytes acquired from the tablet by SendWithinInFlightLimit, released when the RPC is finished.
+  size_t in_flight_bytes_ = 0;
+  size_t in_flight_bytes_limit_ = 0;
 };
 
 template <class Req, class Resp>
@@ -111,7 +128,8 @@ class AsyncRpcBase : public AsyncRpc {
  public:
   AsyncRpcBase(
       const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
-      bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel consistency_level);
+      bool allow_local_calls_in_curr_thread, InFlightOps ops, YBConsistencyLevel consistency_level,
+      bool read_from_followers = false);
 
   const Resp& resp() const { return resp_; }
   Resp& resp() { return resp_; }
@@ -129,6 +147,10 @@ class AsyncRpcBase : public AsyncRpc {
     return GetPropagatedHybridTime(resp_);
   }
 
+  size_t RequestBytes() const override {
+    return req_.ByteSizeLong();
+  }
+
   Req req_;
   Resp resp_;
 };
@@ -153,14 +175,24 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   ReadRpc(
       const scoped_refptr<Batcher>& batcher, RemoteTablet* const tablet,
       bool allow_local_calls_in_curr_thread, InFlightOps ops,
-      YBConsistencyLevel yb_consistency_level = YBConsistencyLevel::STRONG);
+      YBConsistencyLevel yb_consistency_level = YBConsistencyLevel::STRONG,
+      bool read_from_followers = false);
 
   virtual ~ReadRpc();
 
  private:
+  struct HedgedCall;
+  struct HedgedCalls;
+
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  // Sends the read to the current tablet server, and to another replica if there is no response
+  // after hedge_delay. The first response is handled as the response of the RPC.
+  void CallRemoteMethodHedged(MonoDelta hedge_delay);
+  void SendHedgedCall(const std::shared_ptr<HedgedCalls>& calls);
+  void HedgedCallFinished(const std::shared_ptr<HedgedCalls>& calls, bool hedge);
 };
 
 }  // namespace internal
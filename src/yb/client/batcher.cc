@@ -68,6 +68,20 @@ DEFINE_bool(redis_allow_reads_from_followers, false,
 TAG_FLAG(redis_allow_reads_from_followers, evolving);
 TAG_FLAG(redis_allow_reads_from_followers, runtime);
 
+DEFINE_int64(client_max_in_flight_bytes_per_tablet, 0,
+             "Limit of bytes of requests in flight from a client to a single tablet. Requests of "
+             "successive flushes to the tablet are delayed until enough of the previous ones "
+             "are completed. 0 for no limit.");
+TAG_FLAG(client_max_in_flight_bytes_per_tablet, advanced);
+TAG_FLAG(client_max_in_flight_bytes_per_tablet, runtime);
+
+DEFINE_bool(send_strong_reads_to_followers, false,
+            "If true, non-transactional reads with strong consistency level are sent to the "
+            "closest replica, which can be a follower. Requires serve_strong_reads_from_followers "
+            "on tablet servers.");
+TAG_FLAG(send_strong_reads_to_followers, advanced);
+TAG_FLAG(send_strong_reads_to_followers, runtime);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -134,9 +148,11 @@ void Batcher::Abort(const Status& status) {
     MarkInFlightOpFailedUnlocked(op, status);
   }
 
-  if (flush_callback_) {
-    l.unlock();
+  bool run_callback = static_cast<bool>(flush_callback_);
+  l.unlock();
 
+  NotifyOperationsCompleted(to_abort);
+  if (run_callback) {
     RunCallback(status);
   }
 }
@@ -244,9 +260,7 @@ void Batcher::FlushAsync(StatusFunctor callback) {
   FlushBuffersIfReady();
 }
 
-Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
-  // As soon as we get the op, start looking up where it belongs,
-  // so that when the user calls Flush, we are ready to go.
+Result<InFlightOpPtr> Batcher::PrepareInFlightOp(shared_ptr<YBOperation> yb_op) {
   auto in_flight_op = std::make_shared<InFlightOp>();
   RETURN_NOT_OK(yb_op->GetPartitionKey(&in_flight_op->partition_key));
   in_flight_op->yb_op = yb_op;
@@ -285,20 +299,85 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
     }
   }
 
+  return in_flight_op;
+}
+
+Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
+  // As soon as we get the op, start looking up where it belongs,
+  // so that when the user calls Flush, we are ready to go.
+  auto in_flight_op = VERIFY_RESULT(PrepareInFlightOp(std::move(yb_op)));
   AddInFlightOp(in_flight_op);
-  VLOG(3) << "Looking up tablet for " << in_flight_op->yb_op->ToString();
+  LookupTablet(std::move(in_flight_op));
+  return Status::OK();
+}
+
+Status Batcher::Add(const std::vector<shared_ptr<YBOperation>>& ops, size_t* num_added) {
+  Status status;
+  std::vector<InFlightOpPtr> in_flight_ops;
+  in_flight_ops.reserve(ops.size());
+  for (const auto& yb_op : ops) {
+    auto in_flight_op = PrepareInFlightOp(yb_op);
+    if (!in_flight_op.ok()) {
+      status = in_flight_op.status();
+      break;
+    }
+    in_flight_ops.push_back(std::move(*in_flight_op));
+  }
+  *num_added = in_flight_ops.size();
+
+  // Sequence numbers are assigned in the order of ops, before the lookups are reordered.
+  for (const auto& in_flight_op : in_flight_ops) {
+    AddInFlightOp(in_flight_op);
+  }
+
+  std::sort(in_flight_ops.begin(), in_flight_ops.end(),
+            [](const InFlightOpPtr& lhs, const InFlightOpPtr& rhs) {
+    const auto* lhs_table = lhs->yb_op->table();
+    const auto* rhs_table = rhs->yb_op->table();
+    if (lhs_table != rhs_table) {
+      return lhs_table < rhs_table;
+    }
+    return lhs->partition_key < rhs->partition_key;
+  });
 
-  if (yb_op->tablet()) {
-    TabletLookupFinished(std::move(in_flight_op), yb_op->tablet());
+  auto& meta_cache = *client_->data_->meta_cache_;
+  const YBTable* last_table = nullptr;
+  internal::RemoteTabletPtr last_tablet;
+  for (auto& in_flight_op : in_flight_ops) {
+    const auto* table = in_flight_op->yb_op->table();
+    if (!in_flight_op->yb_op->tablet()) {
+      if (!last_tablet || table != last_table ||
+          !last_tablet->partition().ContainsKey(in_flight_op->partition_key)) {
+        last_table = table;
+        last_tablet = meta_cache.LookupTabletByKeyIfCached(table, in_flight_op->partition_key);
+      }
+      if (last_tablet) {
+        VLOG(3) << "Batch lookup: found tablet " << last_tablet->tablet_id() << " for "
+                << in_flight_op->yb_op->ToString();
+        TabletLookupFinished(std::move(in_flight_op), last_tablet);
+        continue;
+      }
+    }
+    LookupTablet(std::move(in_flight_op));
+  }
+
+  return status;
+}
+
+void Batcher::LookupTablet(InFlightOpPtr op) {
+  VLOG(3) << "Looking up tablet for " << op->yb_op->ToString();
+
+  auto tablet = op->yb_op->tablet();
+  if (tablet) {
+    TabletLookupFinished(std::move(op), tablet);
   } else {
     // deadline_ is set in FlushAsync(), after all Add() calls are done, so
     // here we're forced to create a new deadline.
     MonoTime deadline = ComputeDeadlineUnlocked();
     client_->data_->meta_cache_->LookupTabletByKey(
-        in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline,
-        std::bind(&Batcher::TabletLookupFinished, BatcherPtr(this), in_flight_op, _1));
+        op->yb_op->table(), op->partition_key, deadline,
+        std::bind(&Batcher::TabletLookupFinished, BatcherPtr(this), op, _1));
   }
-  return Status::OK();
 }
 
 void Batcher::AddInFlightOp(const InFlightOpPtr& op) {
@@ -329,10 +408,24 @@ void Batcher::MarkInFlightOpFailedUnlocked(const InFlightOpPtr& in_flight_op, co
   CHECK_EQ(1, ops_.erase(in_flight_op)) << "Could not remove op " << in_flight_op->ToString()
                                         << " from in-flight list";
 
-  error_collector_->AddError(in_flight_op->yb_op, s);
+  AddOpError(in_flight_op, s);
   had_errors_ = true;
 }
 
+void Batcher::AddOpError(const InFlightOpPtr& op, const Status& s) {
+  error_collector_->AddError(op->yb_op, s);
+  op->error = s;
+}
+
+void Batcher::NotifyOperationsCompleted(const InFlightOps& ops) {
+  for (const auto& op : ops) {
+    if (operation_callback_) {
+      operation_callback_(op->yb_op, op->error);
+    }
+    op->yb_op->InvokeCompletionCallback(op->error);
+  }
+}
+
 void Batcher::TabletLookupFinished(
     InFlightOpPtr op, const Result<internal::RemoteTabletPtr>& lookup_result) {
   // Acquire the batcher lock early to atomically:
@@ -348,7 +441,8 @@ void Batcher::TabletLookupFinished(
   if (IsAbortedUnlocked()) {
     VLOG(1) << "Aborted batch: TabletLookupFinished for " << op->yb_op->ToString();
     MarkInFlightOpFailedUnlocked(op, STATUS(Aborted, "Batch aborted"));
-    // 'op' is deleted by above function.
+    l.unlock();
+    NotifyOperationsCompleted({op});
     return;
   }
 
@@ -357,6 +451,7 @@ void Batcher::TabletLookupFinished(
   if (!lookup_result.ok()) {
     MarkInFlightOpFailedUnlocked(op, lookup_result.status());
     l.unlock();
+    NotifyOperationsCompleted({op});
     CheckForFinishedFlush();
 
     // Even if we failed our lookup, it's possible that other requests were still
@@ -422,6 +517,9 @@ void Batcher::FlushBuffersIfReady() {
   // 1. The batcher is in the flushing state (i.e. FlushAsync was called).
   // 2. All outstanding ops have finished lookup. Why? To avoid a situation
   //    where ops are flushed one by one as they finish lookup.
+  //    In streaming mode, i.e. when the operation callback is set, the ops that are ready are
+  //    flushed anyway, so a slow lookup does not delay the whole batch. A transaction has to
+  //    prepare all ops at once, so it always waits.
   {
     std::lock_guard<simple_spinlock> l(lock_);
     if (state_ != kFlushing) {
@@ -429,13 +527,18 @@ void Batcher::FlushBuffersIfReady() {
       return;
     }
 
-    if (outstanding_lookups_ != 0) {
+    auto transaction = this->transaction();
+    if (outstanding_lookups_ != 0 && (!operation_callback_ || transaction)) {
       VLOG(3) << "FlushBuffersIfReady: " << outstanding_lookups_ << " ops still in lookup";
       return;
     }
 
-    auto transaction = this->transaction();
-    if (transaction) {
+    if (single_shard_commit_requested_) {
+      single_shard_commit_requested_ = false;
+      single_shard_commit_ = transaction && transaction->PrepareSingleShardCommit(ops_);
+    }
+
+    if (transaction && !single_shard_commit_) {
       // If this Batcher is executed in context of transaction,
       // then this transaction should initialize metadata used by RPC calls.
       //
@@ -552,10 +655,16 @@ void Batcher::FlushBuffer(
       rpc = std::make_shared<WriteRpc>(
           this, tablet, allow_local_calls_in_curr_thread, std::move(ops));
       break;
-    case OpGroup::kLeaderRead:
-      rpc =
-          std::make_shared<ReadRpc>(this, tablet, allow_local_calls_in_curr_thread, std::move(ops));
+    case OpGroup::kLeaderRead: {
+      // Reads with a read time are served by the leader only.
+      bool read_from_followers =
+          FLAGS_send_strong_reads_to_followers && !transaction_ &&
+          (!read_point_ || !read_point_->GetReadTime(tablet->tablet_id()));
+      rpc = std::make_shared<ReadRpc>(
+          this, tablet, allow_local_calls_in_curr_thread, std::move(ops),
+          YBConsistencyLevel::STRONG, read_from_followers);
       break;
+    }
     case OpGroup::kConsistentPrefixRead:
       rpc = std::make_shared<ReadRpc>(
           this, tablet, allow_local_calls_in_curr_thread, std::move(ops),
@@ -565,7 +674,7 @@ void Batcher::FlushBuffer(
   if (!rpc) {
     FATAL_INVALID_ENUM_VALUE(OpGroup, op_group);
   }
-  rpc->SendRpc();
+  rpc->SendWithinInFlightLimit(GetAtomicFlag(&FLAGS_client_max_in_flight_bytes_per_tablet));
 }
 
 using tserver::ReadResponsePB;
@@ -587,12 +696,13 @@ void Batcher::RemoveInFlightOpsAfterFlushing(
     }
   }
   auto transaction = this->transaction();
-  if (transaction) {
+  if (transaction && !single_shard_commit_) {
     transaction->Flushed(ops, status);
   }
   if (status.ok() && read_point_) {
     read_point_->UpdateClock(propagated_hybrid_time);
   }
+  NotifyOperationsCompleted(ops);
 }
 
 void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
@@ -605,7 +715,7 @@ void Batcher::ProcessRpcStatus(const AsyncRpc &rpc, const Status &s) {
   if (PREDICT_FALSE(!s.ok())) {
     // Mark each of the ops as failed, since the whole RPC failed.
     for (auto& in_flight_op : rpc.ops()) {
-      error_collector_->AddError(in_flight_op->yb_op, s);
+      AddOpError(in_flight_op, s);
     }
     MarkHadErrors();
   }
@@ -635,10 +745,11 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
                  << rpc.resp().DebugString();
       continue;
     }
-    shared_ptr<YBOperation> yb_op = rpc.ops()[err_pb.row_index()]->yb_op;
-    VLOG(1) << "Error on op " << yb_op->ToString() << ": " << err_pb.error().ShortDebugString();
+    const auto& op = rpc.ops()[err_pb.row_index()];
+    VLOG(1) << "Error on op " << op->yb_op->ToString() << ": "
+            << err_pb.error().ShortDebugString();
     Status op_status = StatusFromPB(err_pb.error());
-    error_collector_->AddError(yb_op, op_status);
+    AddOpError(op, op_status);
     MarkHadErrors();
   }
 }
@@ -110,6 +110,13 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // NOTE: If this returns not-OK, does not take ownership of 'write_op'.
   CHECKED_STATUS Add(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
+  // Adds operations in bulk. Their tablets are resolved in partition key order, so operations
+  // with keys in the same tablet reuse the tablet found for the previous one. If preparing one of
+  // the operations fails, the operations before it are still added, their number is stored in
+  // num_added and the error is returned.
+  CHECKED_STATUS Add(
+      const std::vector<std::shared_ptr<YBOperation>>& ops, size_t* num_added) WARN_UNUSED_RESULT;
+
   // Return true if any operations are still pending. An operation is no longer considered
   // pending once it has either errored or succeeded.  Operations are considering pending
   // as soon as they are added, even if Flush has not been called.
@@ -152,10 +159,26 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
     return may_have_metadata_;
   }
 
+  // Requests the batcher to commit its transaction by the flush, when the transaction allows it.
+  // See YBTransaction::PrepareSingleShardCommit.
+  void RequestSingleShardCommit() {
+    single_shard_commit_requested_ = true;
+  }
+
+  // Whether the transaction was committed by writing ops of this batcher.
+  bool single_shard_commit() const {
+    return single_shard_commit_;
+  }
+
   void set_allow_local_calls_in_curr_thread(bool flag) { allow_local_calls_in_curr_thread_ = flag; }
 
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
+  // Should be set before operations are added. See YBSession::SetOperationCallback.
+  void set_operation_callback(YBOperationCallback callback) {
+    operation_callback_ = std::move(callback);
+  }
+
   const std::string& proxy_uuid() const;
 
   const ClientId& client_id() const;
@@ -172,9 +195,15 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   ~Batcher();
 
+  // Creates an in-flight op for yb_op, with partition key and hash code set.
+  Result<InFlightOpPtr> PrepareInFlightOp(std::shared_ptr<YBOperation> yb_op);
+
   // Add an op to the in-flight set and increment the ref-count.
   void AddInFlightOp(const InFlightOpPtr& op);
 
+  // Starts looking up the tablet of an added op.
+  void LookupTablet(InFlightOpPtr op);
+
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, HybridTime propagated_hybrid_time);
 
@@ -192,6 +221,12 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   void MarkInFlightOpFailed(const InFlightOpPtr& op, const Status& s);
   void MarkInFlightOpFailedUnlocked(const InFlightOpPtr& in_flight_op, const Status& s);
 
+  // Reports the operation failure to the error collector.
+  void AddOpError(const InFlightOpPtr& op, const Status& s);
+
+  // Invokes the operation callback for completed operations. Should be called without locks.
+  void NotifyOperationsCompleted(const InFlightOps& ops);
+
   void CheckForFinishedFlush();
   void FlushBuffersIfReady();
   void FlushBuffer(
@@ -277,6 +312,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // If true, we might allow the local calls to be run in the same IPC thread.
   bool allow_local_calls_in_curr_thread_ = true;
 
+  // If set, invoked for every completed operation, and buffers are flushed without waiting for
+  // lookups of all operations.
+  YBOperationCallback operation_callback_;
+
   // The number of bytes used in the buffer for pending operations.
   AtomicInt<int64_t> buffer_bytes_used_;
 
@@ -288,6 +327,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   bool may_have_metadata_ = false;
 
+  bool single_shard_commit_requested_ = false;
+  bool single_shard_commit_ = false;
+
   // The consistent read point for this batch if it is specified.
   ConsistentReadPoint* read_point_ = nullptr;
 
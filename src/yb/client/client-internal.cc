@@ -66,9 +66,11 @@
 #include "yb/tserver/tserver_flags.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/curl_util.h"
+#include "yb/util/enums.h"
 #include "yb/util/flags.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -80,6 +82,12 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(latency_aware_replica_selection, true,
+            "When choosing the closest replica, pick between two random replicas of the closest "
+            "placement the one with lower observed RPC latency.");
+TAG_FLAG(latency_aware_replica_selection, advanced);
+TAG_FLAG(latency_aware_replica_selection, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -296,6 +304,57 @@ YBClient::Data::~Data() {
   rpcs_.Shutdown();
 }
 
+namespace {
+
+// Distance from the client to the tablet server, by placement. Lower is closer.
+YB_DEFINE_ENUM(ReplicaProximity, (kNode)(kZone)(kRegion)(kCloud)(kRemote));
+
+bool SamePlacement(const std::string& lhs, const std::string& rhs) {
+  return !lhs.empty() && lhs == rhs;
+}
+
+ReplicaProximity Proximity(
+    const CloudInfoPB& client_cloud_info, const RemoteTabletServer& rts, bool local) {
+  if (local) {
+    return ReplicaProximity::kNode;
+  }
+  const auto& ts_cloud_info = rts.cloud_info();
+  if (SamePlacement(client_cloud_info.placement_zone(), ts_cloud_info.placement_zone())) {
+    return ReplicaProximity::kZone;
+  }
+  if (SamePlacement(client_cloud_info.placement_region(), ts_cloud_info.placement_region())) {
+    return ReplicaProximity::kRegion;
+  }
+  if (SamePlacement(client_cloud_info.placement_cloud(), ts_cloud_info.placement_cloud())) {
+    return ReplicaProximity::kCloud;
+  }
+  return ReplicaProximity::kRemote;
+}
+
+// Power of two choices: of two random replicas, prefers the one with lower latency.
+// Replicas without latency samples are preferred, so they get some traffic to be measured.
+RemoteTabletServer* ChooseByLatency(const vector<RemoteTabletServer*>& replicas) {
+  if (replicas.size() == 1 || !GetAtomicFlag(&FLAGS_latency_aware_replica_selection)) {
+    return RandomElement(replicas);
+  }
+  size_t first = RandomUniformInt<size_t>(0, replicas.size() - 1);
+  size_t second = RandomUniformInt<size_t>(0, replicas.size() - 2);
+  if (second >= first) {
+    ++second;
+  }
+  auto first_latency = replicas[first]->latency();
+  auto second_latency = replicas[second]->latency();
+  if (!first_latency.Initialized()) {
+    return replicas[first];
+  }
+  if (!second_latency.Initialized()) {
+    return replicas[second];
+  }
+  return replicas[second_latency < first_latency ? second : first];
+}
+
+} // namespace
+
 RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
                                                   const ReplicaSelection selection,
                                                   const set<string>& blacklist,
@@ -335,35 +394,22 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
         if (!filtered.empty()) {
           ret = filtered[0];
         }
-      } else if (selection == CLOSEST_REPLICA) {
-        // Choose the closest replica.
-        bool local_zone_ts = false;
+      } else if (selection == CLOSEST_REPLICA && !filtered.empty()) {
+        // Choose among the replicas with the closest placement. The local tserver is the only
+        // one with node proximity, so it is always selected when available.
+        vector<RemoteTabletServer*> closest;
+        auto closest_proximity = ReplicaProximity::kRemote;
         for (RemoteTabletServer* rts : filtered) {
-          if (IsTabletServerLocal(*rts)) {
-            ret = rts;
-            // If the tserver is local, we are done here.
-            break;
-          } else if (cloud_info_pb_.has_placement_zone() && rts->cloud_info().has_placement_zone()
-              && cloud_info_pb_.placement_zone() == rts->cloud_info().placement_zone()) {
-            // Note down that we have found a zone local tserver and continue looking for node
-            // local tserver.
-            ret = rts;
-            local_zone_ts = true;
-          } else if (cloud_info_pb_.has_placement_region() &&
-              rts->cloud_info().has_placement_region() &&
-              cloud_info_pb_.placement_region() == rts->cloud_info().placement_region() &&
-              !local_zone_ts) {
-            // Look for a region local tserver only if we haven't found a zone local tserver yet.
-            ret = rts;
+          auto proximity = Proximity(cloud_info_pb_, *rts, IsTabletServerLocal(*rts));
+          if (proximity < closest_proximity) {
+            closest_proximity = proximity;
+            closest.clear();
+          }
+          if (proximity == closest_proximity) {
+            closest.push_back(rts);
           }
         }
-
-        // If ret is not null here, it should point to the closest replica from the client.
-
-        // Fallback to a random replica if none are local.
-        if (ret == nullptr && !filtered.empty()) {
-          ret = filtered[rand() % filtered.size()];
-        }
+        ret = ChooseByLatency(closest);
       }
       break;
     }
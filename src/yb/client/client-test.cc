@@ -31,7 +31,11 @@
 //
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <future>
+#include <map>
+#include <mutex>
 #include <thread>
 #include <set>
 #include <vector>
@@ -79,8 +83,10 @@
 #include "yb/util/thread.h"
 #include "yb/util/tostring.h"
 
+DECLARE_bool(cache_tablet_locations_on_open);
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_bool(log_inject_latency);
+DECLARE_int64(client_max_in_flight_bytes_per_tablet);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(heartbeat_interval_ms);
 DECLARE_int32(log_inject_latency_ms_mean);
@@ -737,6 +743,49 @@ TEST_F(ClientTest, TestGetTabletServerBlacklist) {
   }
 }
 
+// Test that the closest replica selection avoids the replica with much higher latency.
+TEST_F(ClientTest, ClosestReplicaByLatency) {
+  constexpr int kSelections = 100;
+
+  TableHandle table;
+  ASSERT_NO_FATALS(CreateTable(YBTableName("latency"), kNumTablets, &table));
+  InsertTestRows(table, 1, 0);
+
+  scoped_refptr<internal::RemoteTablet> rt;
+  vector<internal::RemoteTabletServer*> tservers;
+  for (;;) {
+    rt = ASSERT_RESULT(client_->data_->meta_cache_->LookupTabletByKeyFuture(
+        table.get(), "" /* partition_key */, MonoTime::Max()).get());
+    tservers.clear();
+    rt->GetRemoteTabletServers(&tservers, internal::UpdateLocalTsState::kFalse);
+    if (tservers.size() == 3) {
+      break;
+    }
+    rt->MarkStale();
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+
+  auto* slow = tservers[0];
+  for (int i = 0; i != 100; ++i) {
+    for (auto* ts : tservers) {
+      ts->UpdateLatency(ts == slow ? 1s : 1ms);
+    }
+  }
+
+  std::map<internal::RemoteTabletServer*, int> selected;
+  vector<internal::RemoteTabletServer*> candidates;
+  for (int i = 0; i != kSelections; ++i) {
+    auto* ts = client_->data_->SelectTServer(rt.get(), YBClient::CLOSEST_REPLICA, {}, &candidates);
+    ASSERT_NE(ts, nullptr);
+    ++selected[ts];
+  }
+  if (selected.size() == 1 && client_->data_->IsTabletServerLocal(*selected.begin()->first)) {
+    // The local tserver is always preferred.
+    return;
+  }
+  ASSERT_EQ(0, selected[slow]);
+}
+
 TEST_F(ClientTest, TestScanWithEncodedRangePredicate) {
   TableHandle table;
   ASSERT_NO_FATALS(CreateTable(YBTableName("split-table"),
@@ -880,21 +929,30 @@ CHECKED_STATUS ApplyDeleteToSession(YBSession* session,
 } // namespace
 
 TEST_F(ClientTest, TestWriteTimeout) {
-  auto session = CreateSession();
+  // The write should look up its tablet in the master, so use a client that did not cache
+  // tablet locations when the table was opened.
+  FLAGS_cache_tablet_locations_on_open = false;
+  shared_ptr<YBClient> client;
+  ASSERT_OK(YBClientBuilder()
+      .add_master_server_addr(yb::ToString(cluster_->mini_master()->bound_rpc_addr()))
+      .Build(&client));
+  TableHandle table;
+  ASSERT_OK(table.Open(kTableName, client.get()));
+  auto session = CreateSession(client.get());
 
   // First time out the lookup on the master side.
   {
     google::FlagSaver saver;
     FLAGS_master_inject_latency_on_tablet_lookups_ms = 110;
     session->SetTimeout(100ms);
-    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
+    ASSERT_OK(ApplyInsertToSession(session.get(), table, 1, 1, "row"));
     Status s = session->Flush();
     ASSERT_TRUE(s.IsIOError()) << "unexpected status: " << s.ToString();
     auto error = GetSingleErrorFromSession(session.get());
     ASSERT_TRUE(error->status().IsTimedOut()) << error->status().ToString();
     ASSERT_STR_CONTAINS(error->status().ToString(),
         strings::Substitute("GetTableLocations($0, hash_code: NaN, 1) failed: "
-            "timed out after deadline expired", client_table_->name().ToString()));
+            "timed out after deadline expired", table->name().ToString()));
   }
 
   // Next time out the actual write on the tablet server.
@@ -904,7 +962,7 @@ TEST_F(ClientTest, TestWriteTimeout) {
     SetAtomicFlag(110, &FLAGS_log_inject_latency_ms_mean);
     SetAtomicFlag(0, &FLAGS_log_inject_latency_ms_stddev);
 
-    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
+    ASSERT_OK(ApplyInsertToSession(session.get(), table, 1, 1, "row"));
     Status s = session->Flush();
     ASSERT_TRUE(s.IsIOError());
     auto error = GetSingleErrorFromSession(session.get());
@@ -934,6 +992,117 @@ TEST_F(ClientTest, TestAsyncFlushResponseAfterSessionDropped) {
   ASSERT_OK(s.Wait());
 }
 
+TEST_F(ClientTest, OperationCallback) {
+  constexpr int kNumRows = 100;
+
+  auto session = CreateSession();
+  std::mutex mutex;
+  std::vector<Status> statuses;
+  session->SetOperationCallback([&mutex, &statuses](const YBOperationPtr& op, const Status& s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    statuses.push_back(s);
+  });
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, i, i, "row"));
+  }
+  ASSERT_OK(session->Flush());
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(static_cast<size_t>(kNumRows), statuses.size());
+  for (const auto& status : statuses) {
+    ASSERT_OK(status);
+  }
+}
+
+// Test that successive flushes complete, when the tablets could have only one request in flight.
+TEST_F(ClientTest, LimitInFlightBytesPerTablet) {
+  constexpr int kNumBatches = 10;
+  constexpr int kRowsPerBatch = 20;
+
+  FLAGS_client_max_in_flight_bytes_per_tablet = 1;
+
+  auto session = CreateSession();
+  std::vector<std::future<Status>> futures;
+  for (int i = 0; i != kNumBatches; ++i) {
+    for (int j = 0; j != kRowsPerBatch; ++j) {
+      int key = i * kRowsPerBatch + j;
+      ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, key, key, "row"));
+    }
+    futures.push_back(session->FlushFuture());
+  }
+  for (auto& future : futures) {
+    ASSERT_OK(future.get());
+  }
+  ASSERT_EQ(kNumBatches * kRowsPerBatch, CountRowsFromClient(client_table_));
+}
+
+// Test that operations applied to a session with auto flush are written without explicit flush.
+TEST_F(ClientTest, AutoFlush) {
+  constexpr int kNumRows = 25;
+
+  auto session = CreateSession();
+  std::mutex mutex;
+  std::vector<Status> statuses;
+  session->SetOperationCallback([&mutex, &statuses](const YBOperationPtr& op, const Status& s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    statuses.push_back(s);
+  });
+  session->SetAutoFlush(10 /* max_ops */, 0 /* max_bytes */, 10ms /* max_window */);
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, i, i, "row"));
+  }
+
+  ASSERT_OK(WaitFor([&mutex, &statuses] {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statuses.size() == static_cast<size_t>(kNumRows);
+  }, 30s, "All operations flushed"));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& status : statuses) {
+      ASSERT_OK(status);
+    }
+  }
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+}
+
+TEST_F(ClientTest, ApplyAsync) {
+  constexpr int kNumRows = 100;
+
+  auto session = CreateSession();
+  session->SetAutoFlush(20 /* max_ops */, 0 /* max_bytes */, 10ms /* max_window */);
+  std::vector<std::future<Status>> futures;
+  for (int i = 0; i != kNumRows; ++i) {
+    futures.push_back(session->ApplyFuture(BuildTestRow(client_table_, i)));
+  }
+  for (auto& future : futures) {
+    ASSERT_OK(future.get());
+  }
+  ASSERT_EQ(kNumRows, CountRowsFromClient(client_table_));
+
+  // Reads of the inserted rows, completed by callbacks in any order.
+  std::atomic<int> completed(0);
+  std::atomic<int> found(0);
+  for (int i = 0; i != kNumRows; ++i) {
+    auto op = client_table_.NewReadOp();
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, i);
+    client_table_.AddColumns({"int_val"}, req);
+    session->ApplyAsync(op, [op, &completed, &found](const Status& status) {
+      if (status.ok() && op->succeeded()) {
+        auto rows = op->MakeRowBlock();
+        if (rows.ok() && rows->row_count() == 1) {
+          ++found;
+        }
+      }
+      ++completed;
+    });
+  }
+  ASSERT_OK(WaitFor([&completed] {
+    return completed.load() == kNumRows;
+  }, 30s, "All reads completed"));
+  ASSERT_EQ(kNumRows, found.load());
+}
+
 TEST_F(ClientTest, TestSessionClose) {
   auto session = CreateSession();
   ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1, 1, "row"));
@@ -1923,6 +2092,7 @@ TEST_F(ClientTest, TestReadFromFollower) {
       rpc::RpcController controller;
       req.set_tablet_id(tablet_id);
       req.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+      req.set_include_cost(true);
       QLReadRequestPB *ql_read = req.mutable_ql_batch()->Add();
       std::shared_ptr<std::vector<ColumnSchema>> selected_cols =
           std::make_shared<std::vector<ColumnSchema>>(schema_.columns());
@@ -1948,6 +2118,9 @@ TEST_F(ClientTest, TestReadFromFollower) {
       Slice rows_data;
       EXPECT_TRUE(controller.finished());
       EXPECT_OK(controller.GetSidecar(ql_resp.rows_data_sidecar(), &rows_data));
+      EXPECT_TRUE(resp.has_cost());
+      EXPECT_GE(resp.cost().response_bytes(), rows_data.size());
+      EXPECT_GT(resp.cost().seeks(), 0);
       yb::ql::RowsResult rowsResult(kReadFromFollowerTable, selected_cols, rows_data.ToBuffer());
       row_block = rowsResult.GetRowBlock();
       return FLAGS_test_scan_num_rows == row_block->row_count();
@@ -1114,6 +1114,12 @@ Status YBMetaDataCache::GetTable(const TableId& table_id,
   return Status::OK();
 }
 
+shared_ptr<YBTable> YBMetaDataCache::GetCachedTable(const YBTableName& table_name) {
+  std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+  auto itr = cached_tables_by_name_.find(table_name);
+  return itr != cached_tables_by_name_.end() ? itr->second : nullptr;
+}
+
 void YBMetaDataCache::RemoveCachedTable(const YBTableName& table_name) {
   std::lock_guard<std::mutex> lock(cached_tables_mutex_);
   const auto itr = cached_tables_by_name_.find(table_name);
@@ -1134,6 +1140,12 @@ void YBMetaDataCache::RemoveCachedTable(const TableId& table_id) {
   }
 }
 
+void YBMetaDataCache::RemoveAllCachedTables() {
+  std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+  cached_tables_by_name_.clear();
+  cached_tables_by_id_.clear();
+}
+
 Status YBMetaDataCache::GetUDType(const string& keyspace_name,
                                   const string& type_name,
                                   shared_ptr<QLType> *type,
@@ -1370,6 +1382,11 @@ YBTableCreator& YBTableCreator::schema(const YBSchema* schema) {
   return *this;
 }
 
+YBTableCreator& YBTableCreator::table_properties(const TableProperties& table_properties) {
+  data_->table_properties_ = table_properties;
+  return *this;
+}
+
 YBTableCreator& YBTableCreator::add_hash_partitions(const std::vector<std::string>& columns,
                                                         int32_t num_buckets) {
   return add_hash_partitions(columns, num_buckets, 0);
@@ -1451,8 +1468,14 @@ Status YBTableCreator::Create() {
     redis_schema.reset(new YBSchema());
     YBSchemaBuilder b;
     b.AddColumn(kRedisKeyColumnName)->Type(BINARY)->NotNull()->HashPrimaryKey();
+    if (data_->table_properties_) {
+      b.SetTableProperties(*data_->table_properties_);
+    }
     RETURN_NOT_OK(b.Build(redis_schema.get()));
     schema(redis_schema.get());
+  } else if (data_->table_properties_) {
+    return STATUS_FORMAT(InvalidArgument, "Table properties of $0 should be set in its schema",
+                         object_type);
   }
   if (!data_->schema_) {
     return STATUS(InvalidArgument, "Missing schema");
@@ -1612,6 +1635,10 @@ const std::vector<std::string>& YBTable::GetPartitions() const {
   return data_->partitions_;
 }
 
+internal::ReadHedging& YBTable::read_hedging() const {
+  return *data_->read_hedging_;
+}
+
 //--------------------------------------------------------------------------------------------------
 
 YBqlWriteOp* YBTable::NewQLWrite() {
@@ -1740,6 +1767,10 @@ void YBSession::FlushAsync(StatusFunctor callback) {
   data_->FlushAsync(std::move(callback));
 }
 
+void YBSession::FlushAndCommitAsync(StatusFunctor callback) {
+  data_->FlushAndCommitAsync(std::move(callback));
+}
+
 std::future<Status> YBSession::FlushFuture() {
   return MakeFuture<Status>([this](auto callback) { this->FlushAsync(std::move(callback)); });
 }
@@ -1768,6 +1799,22 @@ Status YBSession::ApplyAndFlush(std::shared_ptr<YBOperation> yb_op) {
   return data_->ApplyAndFlush(std::move(yb_op));
 }
 
+void YBSession::ApplyAsync(YBOperationPtr yb_op, StatusFunctor callback) {
+  // The callback should be set before apply, since the operation could be completed before
+  // Apply returns.
+  yb_op->set_completion_callback(std::move(callback));
+  auto status = Apply(yb_op);
+  if (!status.ok()) {
+    yb_op->InvokeCompletionCallback(status);
+  }
+}
+
+std::future<Status> YBSession::ApplyFuture(YBOperationPtr yb_op) {
+  return MakeFuture<Status>([this, &yb_op](auto callback) {
+    this->ApplyAsync(std::move(yb_op), std::move(callback));
+  });
+}
+
 Status YBSession::Apply(const std::vector<YBOperationPtr>& ops) {
   return data_->Apply(ops);
 }
@@ -1801,6 +1848,14 @@ bool YBSession::allow_local_calls_in_curr_thread() const {
   return data_->allow_local_calls_in_curr_thread();
 }
 
+void YBSession::SetOperationCallback(YBOperationCallback callback) {
+  data_->SetOperationCallback(std::move(callback));
+}
+
+void YBSession::SetAutoFlush(size_t max_ops, size_t max_bytes, MonoDelta max_window) {
+  data_->SetAutoFlush(max_ops, max_bytes, max_window);
+}
+
 ////////////////////////////////////////////////////////////
 // YBTableAlterer
 ////////////////////////////////////////////////////////////
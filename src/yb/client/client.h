@@ -119,6 +119,7 @@ class MetaCache;
 class RemoteTablet;
 class RemoteTabletServer;
 class AsyncRpc;
+class ReadHedging;
 class TabletInvoker;
 }  // namespace internal
 
@@ -589,10 +590,17 @@ class YBMetaDataCache {
                           std::shared_ptr<YBTable>* table,
                           bool* cache_used);
 
+  // Returns the table with the given name if it was opened before, or nullptr otherwise.
+  // Never does an RPC.
+  std::shared_ptr<YBTable> GetCachedTable(const YBTableName& table_name);
+
   // Remove the table from cached_tables_ if it is in the cache.
   void RemoveCachedTable(const YBTableName& table_name);
   void RemoveCachedTable(const TableId& table_id);
 
+  // Remove all tables from cached_tables_.
+  void RemoveAllCachedTables();
+
   // Opens the type with the given name. If the type has been opened before, returns the
   // previously opened type from cached_types_. If the type has not been opened before
   // in this client, this will do an RPC to ensure that the type exists and look up its info.
@@ -687,6 +695,10 @@ class YBTableCreator {
   // the lifetime of the builder. Required.
   YBTableCreator& schema(const YBSchema* schema);
 
+  // Sets the table properties of a table whose schema is made by the builder, i.e. a Redis
+  // table. Other tables take their properties from the schema. Optional.
+  YBTableCreator& table_properties(const TableProperties& table_properties);
+
   // Adds a set of hash partitions to the table.
   //
   // For each set of hash partitions added to the table, the total number of
@@ -801,6 +813,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
 
   const std::vector<std::string>& GetPartitions() const;
 
+  // Hedging state of reads of this table, shared by reads from all sessions of the client.
+  internal::ReadHedging& read_hedging() const;
+
   // Indexes available on the table.
   const IndexMap& index_map() const;
 
@@ -1043,6 +1058,19 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   CHECKED_STATUS ApplyAndFlush(const std::vector<YBOperationPtr>& ops,
                                VerifyResponse verify_response = VerifyResponse::kFalse);
 
+  // Apply the operation and invoke the callback as soon as this operation is completed, without
+  // waiting for other operations of its batch. No thread is blocked while the operation is in
+  // flight, so a single thread could keep a lot of operations in flight.
+  //
+  // The session is not flushed by this call, so it should be used together with SetAutoFlush, or
+  // followed by FlushAsync. The status passed to the callback is the status of delivering the
+  // operation, the result of the operation itself should be checked in its response.
+  //
+  // The callback is invoked inline if the operation could not be applied. Otherwise it may be
+  // invoked from an IO thread and should not block.
+  void ApplyAsync(YBOperationPtr yb_op, StatusFunctor callback);
+  std::future<Status> ApplyFuture(YBOperationPtr yb_op);
+
   // Flush any pending writes.
   //
   // Returns a bad status if there are any pending errors after the rows have
@@ -1080,6 +1108,14 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void FlushAsync(StatusFunctor callback);
   std::future<Status> FlushFuture();
 
+  // Flushes buffered operations and commits the transaction of this session, then detaches the
+  // transaction from the session.
+  //
+  // When the transaction was not flushed before and all operations are writes to the same
+  // tablet, they are written atomically by that tablet, without the status tablet round trips.
+  // Otherwise it is the same as commit of the transaction after successful flush.
+  void FlushAndCommitAsync(StatusFunctor callback);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
@@ -1119,6 +1155,30 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  // Set the callback that is invoked for every operation of the following flushes, as soon as
+  // the operation is completed, instead of waiting for the whole batch. The operation is also
+  // reported to the error collector if it failed, and the flush callback is still invoked once
+  // all the operations are completed.
+  //
+  // It also makes flushes of non transactional sessions streaming: operations of a tablet are
+  // sent as soon as their tablet is looked up, instead of waiting for lookups of all operations
+  // of the batch.
+  //
+  // The callback may be invoked from an IO thread and should not block.
+  void SetOperationCallback(YBOperationCallback callback);
+
+  // Enable auto flush of applied operations. Buffered operations are flushed as soon as there
+  // are max_ops of them, their requests take max_bytes, or the flush window elapses after the
+  // first of them was applied. 0 disables the corresponding limit.
+  //
+  // The flush window adapts to the latency of recent flushes: it is a quarter of their average
+  // latency, but not more than max_window. So waiting for more operations adds little to the
+  // latency the operations would see anyway.
+  //
+  // Auto flushes are not awaited by the caller, so results of operations should be taken from the
+  // operation callback. Flush could still be called to flush buffered operations immediately.
+  void SetAutoFlush(size_t max_ops, size_t max_bytes, MonoDelta max_window);
+
   YBClient* client() const;
 
  private:
@@ -71,6 +71,9 @@ class YBTableName;
 
 typedef std::function<void(std::vector<const TabletId*>*)> LocalTabletFilter;
 
+// Invoked with status of the operation, when it is completed.
+typedef std::function<void(const YBOperationPtr&, const Status&)> YBOperationCallback;
+
 YB_STRONGLY_TYPED_BOOL(UseCache);
 
 namespace internal {
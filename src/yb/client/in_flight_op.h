@@ -18,6 +18,7 @@
 
 #include "yb/util/locks.h"
 #include "yb/util/enums.h"
+#include "yb/util/status.h"
 
 namespace yb {
 namespace client {
@@ -113,6 +114,9 @@ struct InFlightOp {
   // order of operations. This is important when multiple operations act on the same row.
   int sequence_number_;
 
+  // Failure of the operation, passed to the operation callback of the batcher.
+  Status error;
+
   std::string ToString() const;
 };
 
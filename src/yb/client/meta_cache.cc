@@ -167,6 +167,21 @@ const CloudInfoPB& RemoteTabletServer::cloud_info() const {
   return cloud_info_pb_;
 }
 
+void RemoteTabletServer::UpdateLatency(MonoDelta latency) {
+  // Zero is reserved for unknown latency.
+  int64_t latency_us = std::max<int64_t>(latency.ToMicroseconds(), 1);
+  int64_t average = latency_us_.load(std::memory_order_relaxed);
+  // Concurrent updates could lose a sample, that is fine for an estimate.
+  latency_us_.store(
+      average == 0 ? latency_us : std::max<int64_t>(average + (latency_us - average) / 8, 1),
+      std::memory_order_relaxed);
+}
+
+MonoDelta RemoteTabletServer::latency() const {
+  int64_t latency_us = latency_us_.load(std::memory_order_relaxed);
+  return latency_us == 0 ? MonoDelta() : MonoDelta::FromMicroseconds(latency_us);
+}
+
 shared_ptr<TabletServerServiceProxy> RemoteTabletServer::proxy() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return proxy_;
@@ -244,6 +259,40 @@ bool RemoteTablet::stale() const {
   return stale_;
 }
 
+bool RemoteTablet::AcquireInFlightBytes(
+    size_t bytes, size_t limit, std::function<void()> send) {
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    // Requests are sent in order, so a new request could not pass the waiting ones.
+    if (in_flight_bytes_ != 0 && (!waiting_sends_.empty() || in_flight_bytes_ + bytes > limit)) {
+      waiting_sends_.push_back(WaitingSend{bytes, std::move(send)});
+      VLOG(4) << "Delay send of " << bytes << " bytes to " << tablet_id_ << ", in flight: "
+              << in_flight_bytes_ << ", waiting: " << waiting_sends_.size();
+      return false;
+    }
+    in_flight_bytes_ += bytes;
+  }
+  return true;
+}
+
+void RemoteTablet::ReleaseInFlightBytes(size_t bytes, size_t limit) {
+  std::vector<std::function<void()>> ready;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    DCHECK_GE(in_flight_bytes_, bytes);
+    in_flight_bytes_ -= bytes;
+    while (!waiting_sends_.empty() &&
+           (in_flight_bytes_ == 0 || in_flight_bytes_ + waiting_sends_.front().bytes <= limit)) {
+      in_flight_bytes_ += waiting_sends_.front().bytes;
+      ready.push_back(std::move(waiting_sends_.front().send));
+      waiting_sends_.pop_front();
+    }
+  }
+  for (const auto& send : ready) {
+    send();
+  }
+}
+
 bool RemoteTablet::MarkReplicaFailed(RemoteTabletServer *ts,
                                      const Status& status) {
   std::lock_guard<simple_spinlock> l(lock_);
@@ -635,6 +684,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   RemoteTabletPtr result;
   bool first = true;
   std::vector<std::pair<LookupTabletCallback, internal::RemoteTabletPtr>> to_notify;
+  std::vector<const TableId*> changed_tables;
 
   {
     std::lock_guard<decltype(mutex_)> l(mutex_);
@@ -667,6 +717,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
           CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
           CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+          changed_tables.push_back(&table_id);
         }
         remote->Refresh(ts_cache_, loc.replicas());
 
@@ -695,6 +746,17 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         }
       }
     }
+
+    if (!changed_tables.empty()) {
+      // Lookups that use the old snapshot, would just miss the new tablets and retry under
+      // mutex_.
+      TabletsByTable tablets_by_table(*tablets_by_table_.get());
+      for (const auto* table_id : changed_tables) {
+        tablets_by_table[*table_id] = std::make_shared<const TabletsByPartition>(
+            tables_[*table_id].tablets_by_partition);
+      }
+      tablets_by_table_.Set(std::move(tablets_by_table));
+    }
   }
 
   for (const auto& callback_and_remote_tablet : to_notify) {
@@ -896,9 +958,27 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
     return nullptr;
   }
 
+  return LookupTabletByKeyFastPath(it->second.tablets_by_partition, table, partition_key);
+}
+
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
+                                                     const std::string& partition_key) {
+  auto tablets_by_table = tablets_by_table_.get();
+  auto it = tablets_by_table->find(table->id());
+  if (PREDICT_FALSE(it == tablets_by_table->end())) {
+    // No cache available for this table.
+    return nullptr;
+  }
+
+  return LookupTabletByKeyFastPath(*it->second, table, partition_key);
+}
+
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const TabletsByPartition& tablets,
+                                                     const YBTable* table,
+                                                     const std::string& partition_key) {
   DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
-  auto tablet_it = it->second.tablets_by_partition.find(partition_key);
-  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.end())) {
+  auto tablet_it = tablets.find(partition_key);
+  if (PREDICT_FALSE(tablet_it == tablets.end())) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
@@ -937,6 +1017,15 @@ bool MetaCache::FastLookupTabletByKeyUnlocked(
   return false;
 }
 
+RemoteTabletPtr MetaCache::LookupTabletByKeyIfCached(const YBTable* table,
+                                                     const std::string& partition_key) {
+  auto result = LookupTabletByKeyFastPath(table, table->FindPartitionStart(partition_key));
+  if (result && result->HasLeader()) {
+    return result;
+  }
+  return nullptr;
+}
+
 void MetaCache::LookupTabletByKey(const YBTable* table,
                                   const string& partition_key,
                                   const MonoTime& deadline,
@@ -945,8 +1034,10 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
 
   rpc::Rpcs::Handle rpc;
   {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
+    auto result = LookupTabletByKeyFastPath(table, partition_start);
+    if (result && result->HasLeader()) {
+      VLOG(3) << "Fast lookup: found tablet " << result->tablet_id();
+      callback(result);
       return;
     }
   }
@@ -33,6 +33,8 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
+#include <deque>
 #include <map>
 #include <string>
 #include <memory>
@@ -56,6 +58,7 @@
 #include "yb/tablet/metadata.pb.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/semaphore.h"
@@ -127,6 +130,12 @@ class RemoteTabletServer {
 
   const CloudInfoPB& cloud_info() const;
 
+  // Accounts the round trip time of an RPC completed by this server.
+  void UpdateLatency(MonoDelta latency);
+
+  // Moving average of RPC latency to this server, not initialized if nothing was sent to it.
+  MonoDelta latency() const;
+
  private:
   mutable simple_spinlock lock_;
   const std::string uuid_;
@@ -136,6 +145,7 @@ class RemoteTabletServer {
   yb::CloudInfoPB cloud_info_pb_;
   std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
   scoped_refptr<Histogram> dns_resolve_histogram_;
+  std::atomic<int64_t> latency_us_{0};
 
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
@@ -227,10 +237,24 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   std::string ToString() const;
 
+  // Limits the size of requests in flight from this client to this tablet, so successive flushes
+  // are pipelined without flooding the tablet.
+  //
+  // Returns true if a request of the specified size could be sent right away. Otherwise 'send' is
+  // queued and invoked, once enough bytes are released by the requests in flight.
+  // A request is always allowed when nothing is in flight, even if it is bigger than the limit.
+  bool AcquireInFlightBytes(size_t bytes, size_t limit, std::function<void()> send);
+  void ReleaseInFlightBytes(size_t bytes, size_t limit);
+
  private:
   // Same as ReplicasAsString(), except that the caller must hold lock_.
   std::string ReplicasAsStringUnlocked() const;
 
+  struct WaitingSend {
+    size_t bytes;
+    std::function<void()> send;
+  };
+
   const std::string tablet_id_;
   const Partition partition_;
 
@@ -242,6 +266,9 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   // The state of this tablet at each specific replica. Only updated after calling GetTabletStatus.
   std::unordered_map<std::string, tablet::TabletStatePB> replica_tablet_state_map_;
 
+  size_t in_flight_bytes_ = 0;
+  std::deque<WaitingSend> waiting_sends_;
+
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
 };
 
@@ -285,6 +312,11 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
     });
   }
 
+  // Returns the cached tablet that hosts the given partition key for a table, if it is known and
+  // has a non-failed leader. Returns nullptr otherwise, without sending any RPCs.
+  RemoteTabletPtr LookupTabletByKeyIfCached(const YBTable* table,
+                                            const std::string& partition_key);
+
   void LookupTabletById(const TabletId& tablet_id,
                         const MonoTime& deadline,
                         LookupTabletCallback callback,
@@ -319,11 +351,23 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
+  typedef std::string PartitionKey;
+  typedef std::unordered_map<PartitionKey, RemoteTabletPtr> TabletsByPartition;
+
   // Lookup the given tablet by key, only consulting local information.
   // Returns true and sets *remote_tablet if successful.
   RemoteTabletPtr LookupTabletByKeyFastPathUnlocked(const YBTable* table,
                                                     const std::string& partition_key);
 
+  // Same as above, but uses the snapshot of tablets instead of tables_, so does not require
+  // mutex_ to be held.
+  RemoteTabletPtr LookupTabletByKeyFastPath(const YBTable* table,
+                                            const std::string& partition_key);
+
+  static RemoteTabletPtr LookupTabletByKeyFastPath(const TabletsByPartition& tablets,
+                                                   const YBTable* table,
+                                                   const std::string& partition_key);
+
   RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
 
   // Update our information about the given tablet server.
@@ -375,16 +419,23 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   };
 
   typedef std::unordered_map<std::string, std::vector<LookupData>> PartitionToLookupData;
-  typedef std::string PartitionKey;
   typedef std::string PartitionGroupKey;
 
   struct TableData {
-    std::unordered_map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
+    TabletsByPartition tablets_by_partition;
     std::unordered_map<PartitionGroupKey, PartitionToLookupData> tablet_lookups_by_group;
   };
 
   std::unordered_map<TableId, TableData> tables_;
 
+  // Immutable copy of tablets_by_partition of all tables, used by the fast path of lookups by
+  // key, so they don't touch mutex_. Tablets of a table are shared between snapshots, so
+  // only maps of changed tables are copied when the snapshot is replaced.
+  //
+  // Replaced under exclusive mutex_, after tables_ was updated.
+  typedef std::unordered_map<TableId, std::shared_ptr<const TabletsByPartition>> TabletsByTable;
+  ConcurrentValue<TabletsByTable> tablets_by_table_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
@@ -37,6 +37,11 @@ DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(yb_num_shards_per_tserver);
 DECLARE_int64(db_block_cache_size_bytes);
 DECLARE_bool(flush_rocksdb_on_shutdown);
+DECLARE_bool(serve_strong_reads_from_followers);
+DECLARE_bool(send_strong_reads_to_followers);
+DECLARE_double(read_hedging_latency_percentile);
+DECLARE_int32(read_hedging_budget_percent);
+DECLARE_int32(read_hedging_window_reads);
 
 namespace yb {
 namespace client {
@@ -475,6 +480,35 @@ TEST_F(QLDmlTest, TestInsertMultipleRows) {
   }
 }
 
+// Rows applied as one batch are routed to their tablets, which are looked up in partition key
+// order.
+TEST_F(QLDmlTest, TestInsertBatch) {
+  constexpr int kNumRows = 200;
+
+  auto session = NewSession();
+  std::vector<YBOperationPtr> ops;
+  for (int i = 0; i != kNumRows; ++i) {
+    const auto key = KeyForIndex(i);
+    const auto value = ValueForIndex(i);
+    const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+    auto* const req = op->mutable_request();
+    QLAddInt32HashValue(req, key.h1);
+    QLAddStringHashValue(req, key.h2);
+    QLAddInt32RangeValue(req, key.r1);
+    QLAddStringRangeValue(req, key.r2);
+    table_.AddInt32ColumnValue(req, "c1", value.c1);
+    table_.AddStringColumnValue(req, "c2", value.c2);
+    ops.push_back(op);
+  }
+  ASSERT_OK(session->ApplyAndFlush(ops, VerifyResponse::kTrue));
+
+  for (int i = 0; i != kNumRows; ++i) {
+    auto row = ReadRow(session, KeyForIndex(i));
+    ASSERT_OK(row);
+    ASSERT_EQ(*row, ValueForIndex(i));
+  }
+}
+
 TEST_F(QLDmlTest, TestSelectMultipleRows) {
   const auto session = NewSession();
   {
@@ -1206,6 +1240,49 @@ TEST_F(QLDmlTest, OpenRecentlyCreatedTable) {
   }
 }
 
+// Strong reads served by followers should see every row written before them, without retries.
+TEST_F(QLDmlTest, StrongReadFollower) {
+  FLAGS_serve_strong_reads_from_followers = true;
+  constexpr int kNumRows = 20;
+
+  ASSERT_NO_FATALS(InsertRows(kNumRows));
+
+  FLAGS_send_strong_reads_to_followers = true;
+  auto session = NewSession();
+  for (size_t i = 0; i != kNumRows; ++i) {
+    auto row = ReadRow(session, KeyForIndex(i), YBConsistencyLevel::STRONG);
+    ASSERT_OK(row);
+    ASSERT_EQ(*row, ValueForIndex(i));
+  }
+}
+
+// Almost all follower reads are hedged, and should still see their rows.
+TEST_F(QLDmlTest, HedgedReadFollower) {
+  constexpr int kNumRows = 100;
+  FLAGS_read_hedging_latency_percentile = 1;
+  FLAGS_read_hedging_budget_percent = 100;
+  FLAGS_read_hedging_window_reads = 10;
+
+  ASSERT_NO_FATALS(InsertRows(kNumRows));
+
+  auto must_see_all_rows_after_this_deadline = MonoTime::Now() + 5s * kTimeMultiplier;
+  auto session = NewSession();
+  for (int iteration = 0; iteration != 3; ++iteration) {
+    for (size_t i = 0; i != kNumRows; ++i) {
+      for (;;) {
+        auto row = ReadRow(session, KeyForIndex(i), YBConsistencyLevel::CONSISTENT_PREFIX);
+        if (!row.ok() && row.status().IsNotFound()) {
+          ASSERT_LE(MonoTime::Now(), must_see_all_rows_after_this_deadline);
+          continue;
+        }
+        ASSERT_OK(row);
+        ASSERT_EQ(*row, ValueForIndex(i));
+        break;
+      }
+    }
+  }
+}
+
 TEST_F(QLDmlTest, ReadFollower) {
   DontVerifyClusterBeforeNextTearDown();
   FLAGS_flush_rocksdb_on_shutdown = false;
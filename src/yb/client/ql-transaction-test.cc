@@ -24,6 +24,8 @@
 #include "yb/client/transaction_rpc.h"
 #include "yb/client/transaction_manager.h"
 
+#include "yb/common/wire_protocol.h"
+
 #include "yb/consensus/consensus.h"
 
 #include "yb/yql/cql/ql/util/errcodes.h"
@@ -66,6 +68,7 @@ DECLARE_int32(intents_flush_max_delay_ms);
 DECLARE_int32(remote_bootstrap_max_chunk_size);
 DECLARE_int32(load_balancer_max_concurrent_adds);
 DECLARE_int32(master_inject_latency_on_transactional_tablet_lookups_ms);
+DECLARE_int32(transaction_conflict_wait_ms);
 
 namespace yb {
 namespace client {
@@ -458,6 +461,25 @@ TEST_F(QLTransactionTest, ReadRestartWithPendingIntents) {
   TestReadRestart(false /* commit */);
 }
 
+// Writes made to a tablet after a transaction read from it are later than the local limit
+// returned by that read, so they should not cause read restarts when the transaction reads from
+// the same tablet again.
+TEST_F(QLTransactionTest, ReuseLocalLimit) {
+  SetAtomicFlag(250000ULL, &FLAGS_max_clock_skew_usec);
+
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  auto row = SelectRow(session, 0);
+  ASSERT_TRUE(!row.ok() && row.status().IsNotFound()) << row;
+
+  ASSERT_OK(WriteRow(CreateSession(), 0, 0));
+
+  row = SelectRow(session, 0);
+  ASSERT_TRUE(!row.ok() && row.status().IsNotFound()) << row;
+  ASSERT_FALSE(txn->IsRestartRequired());
+  ASSERT_OK(txn->CommitFuture().get());
+}
+
 // Non transactional restart happens in server, so we just checking that we read correct values.
 // Skewed clocks are used because there could be case when applied intents or commit transaction
 // has time greater than max safetime to read, that causes restart.
@@ -780,6 +802,28 @@ TEST_F(QLTransactionTest, ConflictResolution) {
   }
 }
 
+// When conflicting transaction has higher priority, the write should wait for it instead of
+// failing. So after it is aborted the write succeeds, whatever priorities transactions got.
+TEST_F(QLTransactionTest, WaitForConflictingTransaction) {
+  FLAGS_transaction_conflict_wait_ms = 10000;
+
+  auto txn1 = CreateTransaction();
+  ASSERT_OK(WriteRow(CreateSession(txn1), 0, 1));
+
+  auto txn2 = CreateTransaction();
+  auto session2 = CreateSession(txn2);
+  ASSERT_OK(WriteRow(session2, 0, 2, WriteOpType::INSERT, Flush::kFalse));
+  auto flush_future = session2->FlushFuture();
+  std::this_thread::sleep_for(100ms);
+  txn1->Abort();
+
+  ASSERT_OK(flush_future.get());
+  ASSERT_OK(txn2->CommitFuture().get());
+
+  auto row = ASSERT_RESULT(SelectRow(CreateSession(), 0));
+  ASSERT_EQ(2, row);
+}
+
 TEST_F(QLTransactionTest, SimpleWriteConflict) {
   auto transaction = CreateTransaction();
   WriteRows(CreateSession(transaction));
@@ -1220,29 +1264,31 @@ struct TransactionState {
     ASSERT_EQ(status_future.wait_for(NonTsanVsTsan(3s, 10s)), std::future_status::ready);
     auto resp = status_future.get();
     ASSERT_OK(resp);
+    ASSERT_EQ(1, resp->status().size());
+    ASSERT_EQ(1, resp->status_hybrid_time().size());
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    if (resp->status(0) == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (resp->status(0) == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status(0));
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(resp->status(0), TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(resp->status(0));
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = resp->status(0);
   }
 };
 
@@ -1304,7 +1350,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
@@ -1326,6 +1372,104 @@ TEST_F(QLTransactionTest, StatusEvolution) {
   }
 }
 
+// Test that transaction writing to a single tablet is committed without the status tablet, and
+// transaction writing to several tablets is committed as usual.
+TEST_F(QLTransactionTest, SingleShardCommit) {
+  {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    ASSERT_OK(WriteRow(session, 0 /* key */, 1 /* value */, WriteOpType::INSERT, Flush::kFalse));
+    ASSERT_OK(WriteRow(session, 0 /* key */, 2 /* value */, WriteOpType::UPDATE, Flush::kFalse));
+    ASSERT_OK(MakeFuture<Status>([session](auto callback) {
+      session->FlushAndCommitAsync(std::move(callback));
+    }).get());
+    ASSERT_EQ(0, CountTransactions());
+    VERIFY_ROW(CreateSession(), 0, 2);
+  }
+
+  {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    for (size_t r = 0; r != kNumRows; ++r) {
+      ASSERT_OK(WriteRow(
+          session, KeyForTransactionAndIndex(1, r),
+          ValueForTransactionAndIndex(1, r, WriteOpType::INSERT),
+          WriteOpType::INSERT, Flush::kFalse));
+    }
+    ASSERT_OK(MakeFuture<Status>([session](auto callback) {
+      session->FlushAndCommitAsync(std::move(callback));
+    }).get());
+    ASSERT_NO_FATALS(VerifyRows(CreateSession(), 1));
+  }
+}
+
+// Test that status of several transactions could be requested by a single RPC.
+TEST_F(QLTransactionTest, StatusOfSeveralTransactions) {
+  auto txn = CreateTransaction();
+  ASSERT_OK(WriteRow(CreateSession(txn), 0, 0));
+  auto metadata = txn->TEST_GetMetadata().get();
+  auto unknown_id = GenerateTransactionId();
+
+  tserver::GetTransactionStatusRequestPB req;
+  req.set_tablet_id(metadata.status_tablet);
+  req.add_transaction_id(metadata.transaction_id.data, metadata.transaction_id.size());
+  req.add_transaction_id(unknown_id.data, unknown_id.size());
+  rpc::Rpcs rpcs;
+  auto resp = ASSERT_RESULT(rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
+      GetTransactionStatus, &rpcs)(
+          TransactionRpcDeadline(), nullptr /* tablet */, client_.get(), &req).get());
+
+  ASSERT_EQ(2, resp.status().size());
+  ASSERT_EQ(2, resp.status_hybrid_time().size());
+  ASSERT_EQ(TransactionStatus::PENDING, resp.status(0));
+  ASSERT_EQ(TransactionStatus::ABORTED, resp.status(1));
+
+  ASSERT_OK(txn->CommitFuture().get());
+}
+
+TEST_F(QLTransactionTest, HeartbeatSeveralTransactions) {
+  auto txn = CreateTransaction();
+  ASSERT_OK(WriteRow(CreateSession(txn), 0, 0));
+  auto metadata = txn->TEST_GetMetadata().get();
+  auto unknown_id = GenerateTransactionId();
+
+  tserver::UpdateTransactionRequestPB req;
+  req.set_tablet_id(metadata.status_tablet);
+  req.mutable_state()->set_transaction_id(
+      metadata.transaction_id.data, metadata.transaction_id.size());
+  req.mutable_state()->set_status(TransactionStatus::PENDING);
+  auto& unknown_state = *req.add_additional_states();
+  unknown_state.set_transaction_id(unknown_id.data, unknown_id.size());
+  unknown_state.set_status(TransactionStatus::PENDING);
+  rpc::Rpcs rpcs;
+  auto resp = ASSERT_RESULT(rpc::WrapRpcFuture<tserver::UpdateTransactionResponsePB>(
+      HeartbeatTransactions, &rpcs)(
+          TransactionRpcDeadline(), nullptr /* tablet */, client_.get(), &req).get());
+
+  // Unknown transaction should not fail heartbeat of the running one.
+  ASSERT_EQ(2, resp.heartbeat_statuses().size());
+  ASSERT_OK(StatusFromPB(resp.heartbeat_statuses(0)));
+  ASSERT_TRUE(StatusFromPB(resp.heartbeat_statuses(1)).IsExpired());
+
+  ASSERT_OK(txn->CommitFuture().get());
+}
+
+TEST_F(QLTransactionTest, HeartbeatManyTransactions) {
+  constexpr int kTransactions = 20;
+  std::vector<YBTransactionPtr> transactions;
+  for (int i = 0; i != kTransactions; ++i) {
+    transactions.push_back(CreateTransaction());
+    ASSERT_OK(WriteRow(CreateSession(transactions.back()), i, i));
+  }
+  // Heartbeats of transactions with the same status tablet are batched, all transactions should
+  // survive the timeout.
+  std::this_thread::sleep_for(GetTransactionTimeout() * 2);
+  for (const auto& txn : transactions) {
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+  CheckNoRunningTransactions();
+}
+
 // Writing multiple keys concurrently, each key is increasing by 1 at each step.
 // At the same time concurrently execute several transactions that read all those keys.
 // Suppose two transactions have read values t1_i and t2_i respectively.
@@ -40,8 +40,12 @@
 #include "yb/client/error_collector.h"
 #include "yb/client/yb_op.h"
 
+#include "yb/gutil/casts.h"
+
 #include "yb/rpc/messenger.h"
 
+#include "yb/util/enums.h"
+
 DEFINE_int32(client_read_write_timeout_ms, 60000, "Timeout for client read and write operations.");
 
 namespace yb {
@@ -54,6 +58,28 @@ using internal::ErrorCollector;
 
 using std::shared_ptr;
 
+namespace {
+
+size_t RequestBytes(const YBOperation& op) {
+  switch (op.type()) {
+    case YBOperation::Type::QL_READ:
+      return down_cast<const YBqlReadOp&>(op).request().ByteSizeLong();
+    case YBOperation::Type::QL_WRITE:
+      return down_cast<const YBqlWriteOp&>(op).request().ByteSizeLong();
+    case YBOperation::Type::REDIS_READ:
+      return down_cast<const YBRedisReadOp&>(op).request().ByteSizeLong();
+    case YBOperation::Type::REDIS_WRITE:
+      return down_cast<const YBRedisWriteOp&>(op).request().ByteSizeLong();
+    case YBOperation::Type::PGSQL_READ:
+      return down_cast<const YBPgsqlReadOp&>(op).request().ByteSizeLong();
+    case YBOperation::Type::PGSQL_WRITE:
+      return down_cast<const YBPgsqlWriteOp&>(op).request().ByteSizeLong();
+  }
+  FATAL_INVALID_ENUM_VALUE(YBOperation::Type, op.type());
+}
+
+} // namespace
+
 YBSessionData::YBSessionData(shared_ptr<YBClient> client, const scoped_refptr<ClockBase>& clock)
     : client_(std::move(client)),
       read_point_(clock ? std::make_unique<ConsistentReadPoint>(clock) : nullptr),
@@ -67,9 +93,12 @@ YBSessionData::~YBSessionData() {
 }
 
 void YBSessionData::SetTransaction(YBTransactionPtr transaction) {
-  transaction_ = std::move(transaction);
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
+  {
+    auto lock = LockBatcher();
+    transaction_ = std::move(transaction);
+    old_batcher = TakeBatcher();
+  }
   if (old_batcher) {
     LOG_IF(DFATAL, old_batcher->HasPendingOperations()) << "SetTransaction with non empty batcher";
     old_batcher->Abort(STATUS(Aborted, "Transaction changed"));
@@ -82,9 +111,15 @@ void YBSessionData::FlushFinished(internal::BatcherPtr batcher) {
 }
 
 void YBSessionData::Abort() {
-  if (batcher_ && batcher_->HasPendingOperations()) {
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+  internal::BatcherPtr batcher;
+  {
+    auto lock = LockBatcher();
+    if (batcher_ && batcher_->HasPendingOperations()) {
+      batcher = TakeBatcher();
+    }
+  }
+  if (batcher) {
+    batcher->Abort(STATUS(Aborted, "Batch aborted"));
   }
 }
 
@@ -98,13 +133,18 @@ void YBSessionData::SetReadPoint(const Restart restart) {
 }
 
 Status YBSessionData::Close(bool force) {
-  if (batcher_) {
+  internal::BatcherPtr batcher;
+  {
+    auto lock = LockBatcher();
+    if (!batcher_) {
+      return Status::OK();
+    }
     if (batcher_->HasPendingOperations() && !force) {
       return STATUS(IllegalState, "Could not close. There are pending operations.");
     }
-    batcher_->Abort(STATUS(Aborted, "Batch aborted"));
-    batcher_.reset();
+    batcher = TakeBatcher();
   }
+  batcher->Abort(STATUS(Aborted, "Batch aborted"));
   return Status::OK();
 }
 
@@ -117,19 +157,153 @@ void YBSessionData::FlushAsync(StatusFunctor callback) {
   // the batch fails "inline" on the same thread.
 
   internal::BatcherPtr old_batcher;
-  old_batcher.swap(batcher_);
-  if (old_batcher) {
+  {
+    auto lock = LockBatcher();
+    old_batcher = TakeBatcher();
+  }
+  FlushBatcher(std::move(old_batcher), std::move(callback));
+}
+
+void YBSessionData::FlushAndCommitAsync(StatusFunctor callback) {
+  YBTransactionPtr transaction;
+  internal::BatcherPtr batcher;
+  {
+    auto lock = LockBatcher();
+    transaction.swap(transaction_);
+    batcher = TakeBatcher();
+  }
+  if (!transaction) {
+    callback(STATUS(IllegalState, "Session does not have a transaction to commit"));
+    return;
+  }
+  if (!batcher) {
+    transaction->Commit(std::move(callback));
+    return;
+  }
+
+  batcher->RequestSingleShardCommit();
+  FlushBatcher(batcher, [batcher, transaction, callback](const Status& status) {
+    if (batcher->single_shard_commit()) {
+      callback(status);
+    } else if (status.ok()) {
+      transaction->Commit(callback);
+    } else {
+      transaction->Abort();
+      callback(status);
+    }
+  });
+}
+
+std::unique_lock<std::mutex> YBSessionData::LockBatcher() {
+  return auto_flush() ? std::unique_lock<std::mutex>(batcher_mutex_)
+                      : std::unique_lock<std::mutex>();
+}
+
+internal::BatcherPtr YBSessionData::TakeBatcher() {
+  internal::BatcherPtr result;
+  result.swap(batcher_);
+  buffered_ops_ = 0;
+  buffered_bytes_ = 0;
+  return result;
+}
+
+void YBSessionData::FlushBatcher(internal::BatcherPtr batcher, StatusFunctor callback) {
+  if (batcher) {
     {
       std::lock_guard<simple_spinlock> l(lock_);
-      flushed_batchers_.insert(old_batcher);
+      flushed_batchers_.insert(batcher);
     }
-    old_batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
-    old_batcher->FlushAsync(std::move(callback));
+    batcher->set_allow_local_calls_in_curr_thread(allow_local_calls_in_curr_thread_);
+    batcher->FlushAsync(std::move(callback));
   } else {
     callback(Status::OK());
   }
 }
 
+void YBSessionData::SetAutoFlush(size_t max_ops, size_t max_bytes, MonoDelta max_window) {
+  std::lock_guard<std::mutex> lock(batcher_mutex_);
+  auto_flush_max_ops_ = max_ops;
+  auto_flush_max_bytes_ = max_bytes;
+  auto_flush_max_window_ = max_window;
+}
+
+internal::BatcherPtr YBSessionData::AutoFlushAppliedUnlocked(
+    const YBOperationPtr* begin, const YBOperationPtr* end) {
+  bool was_empty = buffered_ops_ == 0;
+  buffered_ops_ += end - begin;
+  if (auto_flush_max_bytes_ != 0) {
+    for (auto it = begin; it != end; ++it) {
+      buffered_bytes_ += RequestBytes(**it);
+    }
+  }
+
+  if ((auto_flush_max_ops_ != 0 && buffered_ops_ >= auto_flush_max_ops_) ||
+      (auto_flush_max_bytes_ != 0 && buffered_bytes_ >= auto_flush_max_bytes_)) {
+    return TakeBatcher();
+  }
+
+  if (was_empty && auto_flush_max_window_.Initialized()) {
+    // The batcher is identified by address only, so a timer could flush a newer batcher at the
+    // same address a bit early. It is harmless.
+    std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+    const internal::Batcher* batcher = batcher_.get();
+    const auto& messenger = client_->messenger();
+    auto task_id = messenger->ScheduleOnReactor(
+        [weak_self, batcher](const Status& status) {
+          auto self = weak_self.lock();
+          if (status.ok() && self) {
+            self->AutoFlushTimerFired(batcher);
+          }
+        },
+        AutoFlushWindow(), SOURCE_LOCATION(), messenger);
+    if (task_id == rpc::kInvalidTaskId) {
+      return TakeBatcher();
+    }
+  }
+  return nullptr;
+}
+
+void YBSessionData::AutoFlushTimerFired(const internal::Batcher* batcher) {
+  internal::BatcherPtr to_flush;
+  {
+    auto lock = LockBatcher();
+    if (batcher_.get() != batcher) {
+      // Already flushed.
+      return;
+    }
+    to_flush = TakeBatcher();
+  }
+  AutoFlush(std::move(to_flush));
+}
+
+void YBSessionData::AutoFlush(internal::BatcherPtr batcher) {
+  if (!batcher) {
+    return;
+  }
+  auto start = MonoTime::Now();
+  std::weak_ptr<YBSessionData> weak_self = shared_from_this();
+  // Failed operations are reported through the operation callback and the error collector, so
+  // the status of the auto flush itself is not needed.
+  FlushBatcher(std::move(batcher), [weak_self, start](const Status& status) {
+    auto self = weak_self.lock();
+    if (!self) {
+      return;
+    }
+    int64_t latency = MonoTime::Now().GetDeltaSince(start).ToMicroseconds();
+    int64_t average = self->auto_flush_latency_us_.load(std::memory_order_relaxed);
+    self->auto_flush_latency_us_.store(
+        average == 0 ? latency : average + (latency - average) / 8, std::memory_order_relaxed);
+  });
+}
+
+MonoDelta YBSessionData::AutoFlushWindow() const {
+  auto latency = auto_flush_latency_us_.load(std::memory_order_relaxed);
+  if (latency == 0) {
+    return auto_flush_max_window_;
+  }
+  return std::min(auto_flush_max_window_, MonoDelta::FromMicroseconds(latency / 4));
+}
+
 bool YBSessionData::allow_local_calls_in_curr_thread() const {
   return allow_local_calls_in_curr_thread_;
 }
@@ -138,6 +312,10 @@ void YBSessionData::set_allow_local_calls_in_curr_thread(bool flag) {
   allow_local_calls_in_curr_thread_ = flag;
 }
 
+void YBSessionData::SetOperationCallback(YBOperationCallback callback) {
+  operation_callback_ = std::move(callback);
+}
+
 internal::Batcher& YBSessionData::Batcher() {
   if (!batcher_) {
     batcher_.reset(new internal::Batcher(
@@ -146,17 +324,28 @@ internal::Batcher& YBSessionData::Batcher() {
     if (timeout_.Initialized()) {
       batcher_->SetTimeout(timeout_);
     }
+    if (operation_callback_) {
+      batcher_->set_operation_callback(operation_callback_);
+    }
   }
   return *batcher_;
 }
 
 Status YBSessionData::Apply(YBOperationPtr yb_op) {
-  Status s = Batcher().Add(yb_op);
-  if (!PREDICT_FALSE(s.ok())) {
-    error_collector_->AddError(yb_op, s);
-    return s;
+  internal::BatcherPtr to_flush;
+  {
+    auto lock = LockBatcher();
+    Status s = Batcher().Add(yb_op);
+    if (!PREDICT_FALSE(s.ok())) {
+      error_collector_->AddError(yb_op, s);
+      return s;
+    }
+    if (lock.owns_lock()) {
+      to_flush = AutoFlushAppliedUnlocked(&yb_op, &yb_op + 1);
+    }
   }
 
+  AutoFlush(std::move(to_flush));
   return Status::OK();
 }
 
@@ -167,14 +356,26 @@ Status YBSessionData::ApplyAndFlush(YBOperationPtr yb_op) {
 }
 
 Status YBSessionData::Apply(const std::vector<YBOperationPtr>& ops) {
-  auto& batcher = Batcher();
-  for (const auto& op : ops) {
-    Status s = batcher.Add(op);
+  internal::BatcherPtr to_flush;
+  {
+    auto lock = LockBatcher();
+    size_t num_added = 0;
+    Status s = Batcher().Add(ops, &num_added);
     if (!PREDICT_FALSE(s.ok())) {
-      error_collector_->AddError(op, s);
+      error_collector_->AddError(ops[num_added], s);
+      if (lock.owns_lock()) {
+        to_flush = AutoFlushAppliedUnlocked(ops.data(), ops.data() + num_added);
+      }
+      lock.unlock();
+      AutoFlush(std::move(to_flush));
       return s;
     }
+    if (lock.owns_lock()) {
+      to_flush = AutoFlushAppliedUnlocked(ops.data(), ops.data() + ops.size());
+    }
   }
+
+  AutoFlush(std::move(to_flush));
   return Status::OK();
 }
 
@@ -32,6 +32,8 @@
 #ifndef YB_CLIENT_SESSION_INTERNAL_H_
 #define YB_CLIENT_SESSION_INTERNAL_H_
 
+#include <atomic>
+#include <mutex>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
@@ -68,6 +70,8 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
 
   void FlushAsync(StatusFunctor callback);
 
+  void FlushAndCommitAsync(StatusFunctor callback);
+
   CHECKED_STATUS Flush();
 
   // Called by Batcher when a flush has finished.
@@ -104,15 +108,49 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   void set_allow_local_calls_in_curr_thread(bool flag);
   bool allow_local_calls_in_curr_thread() const;
 
+  void SetOperationCallback(YBOperationCallback callback);
+
+  void SetAutoFlush(size_t max_ops, size_t max_bytes, MonoDelta max_window);
+
  private:
   internal::Batcher& Batcher();
 
+  bool auto_flush() const {
+    return auto_flush_max_ops_ != 0 || auto_flush_max_bytes_ != 0 ||
+           auto_flush_max_window_.Initialized();
+  }
+
+  // Locks batcher_mutex_ when auto flush is enabled, since then batcher_ is also accessed by the
+  // flush timer.
+  std::unique_lock<std::mutex> LockBatcher();
+
+  // Takes the current batcher for flushing. Should be called with the batcher locked.
+  internal::BatcherPtr TakeBatcher();
+
+  // Sends off the batcher returned by TakeBatcher. Should be called without the lock.
+  void FlushBatcher(internal::BatcherPtr batcher, StatusFunctor callback);
+
+  // Accounts the applied operations. Returns the batcher that should be flushed, when auto flush
+  // limits are reached. Should be called with the batcher locked.
+  internal::BatcherPtr AutoFlushAppliedUnlocked(
+      const YBOperationPtr* begin, const YBOperationPtr* end);
+
+  // Flushes the batcher taken by auto flush, and tracks latency of the flush.
+  void AutoFlush(internal::BatcherPtr batcher);
+
+  // Flushes the batcher if it is still the one, that was current when the timer was scheduled.
+  void AutoFlushTimerFired(const internal::Batcher* batcher);
+
+  // Time to wait for more operations, before flushing the buffered ones.
+  MonoDelta AutoFlushWindow() const;
+
   // The client that this session is associated with.
   const std::shared_ptr<YBClient> client_;
 
   std::unique_ptr<ConsistentReadPoint> read_point_;
   YBTransactionPtr transaction_;
   bool allow_local_calls_in_curr_thread_ = true;
+  YBOperationCallback operation_callback_;
 
   // Lock protecting flushed_batchers_.
   mutable simple_spinlock lock_;
@@ -136,6 +174,19 @@ class YBSessionData : public std::enable_shared_from_this<YBSessionData> {
   // Timeout for the next batch.
   MonoDelta timeout_;
 
+  // Auto flush limits, see YBSession::SetAutoFlush.
+  size_t auto_flush_max_ops_ = 0;
+  size_t auto_flush_max_bytes_ = 0;
+  MonoDelta auto_flush_max_window_;
+
+  // Protects batcher_ and the counters below, when auto flush is enabled.
+  std::mutex batcher_mutex_;
+  size_t buffered_ops_ = 0;
+  size_t buffered_bytes_ = 0;
+
+  // Moving average of auto flush latency, in microseconds.
+  std::atomic<int64_t> auto_flush_latency_us_{0};
+
   internal::AsyncRpcMetricsPtr async_rpc_metrics_;
 };
 
@@ -35,6 +35,8 @@
 #include <string>
 
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/tablet_rpc.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
@@ -42,8 +44,16 @@
 #include "yb/master/master.proxy.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/util/backoff_waiter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/monotime.h"
 
+DEFINE_bool(cache_tablet_locations_on_open, true,
+            "Whether opening a table populates the meta cache of the client with locations of "
+            "all the tablets of the table, so first operations on the table do not have to look "
+            "them up in the master.");
+TAG_FLAG(cache_tablet_locations_on_open, advanced);
+TAG_FLAG(cache_tablet_locations_on_open, runtime);
+
 namespace yb {
 
 using master::GetTableLocationsRequestPB;
@@ -82,7 +92,8 @@ YBTable::Data::Data(shared_ptr<YBClient> client, Info info)
     : client_(std::move(client)),
       // The table type is set after the table is opened.
       table_type_(YBTableType::UNKNOWN_TABLE_TYPE),
-      info_(std::move(info)) {
+      info_(std::move(info)),
+      read_hedging_(new internal::ReadHedging()) {
 }
 
 YBTable::Data::~Data() {
@@ -175,6 +186,11 @@ Status YBTable::Data::Open() {
         partitions_.push_back(tablet_location.partition().partition_key_start());
       }
       std::sort(partitions_.begin(), partitions_.end());
+      if (GetAtomicFlag(&FLAGS_cache_tablet_locations_on_open)) {
+        // The response already has locations of all the tablets, so a burst of lookups of
+        // separate partition groups is avoided, when a new client starts to use the table.
+        client_->data_->meta_cache_->ProcessTabletLocations(resp.tablet_locations(), nullptr);
+      }
       break;
     }
 
@@ -65,6 +65,8 @@ class YBTableCreator::Data {
 
   const YBSchema* schema_ = nullptr;
 
+  boost::optional<TableProperties> table_properties_;
+
   std::vector<const YBPartialRow*> split_rows_;
 
   PartitionSchemaPB partition_schema_;
@@ -22,6 +22,7 @@
 
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/hdr_histogram.h"
 
 DEFINE_test_flag(bool, assert_local_op, false,
                  "When set, we crash if we received an operation that cannot be served locally");
@@ -30,12 +31,79 @@ DEFINE_int32(force_lookup_cache_refresh_secs, 0, "If greater than 0, the lookup
              "placement zone and it hasn't been updated for at least the specified number of "
              "seconds");
 
+DEFINE_double(read_hedging_latency_percentile, 0,
+              "Reads that could be served by followers, and take longer than this percentile of "
+              "recent read latencies of the table, are also sent to another replica, and the first "
+              "response is used. 0 disables hedging of reads.");
+TAG_FLAG(read_hedging_latency_percentile, advanced);
+TAG_FLAG(read_hedging_latency_percentile, runtime);
+DEFINE_int32(read_hedging_budget_percent, 5,
+             "Maximum percentage of reads of a table that are hedged.");
+TAG_FLAG(read_hedging_budget_percent, advanced);
+TAG_FLAG(read_hedging_budget_percent, runtime);
+DEFINE_int32(read_hedging_window_reads, 1000,
+             "Number of reads of a table the hedging latency percentile is computed over.");
+TAG_FLAG(read_hedging_window_reads, advanced);
+TAG_FLAG(read_hedging_window_reads, runtime);
+
 using namespace std::placeholders;
 
 namespace yb {
 namespace client {
 namespace internal {
 
+namespace {
+
+// Longer latencies are accounted as this one.
+constexpr int64_t kMaxTrackedLatencyUs = 60 * 1000 * 1000;
+
+std::unique_ptr<HdrHistogram> NewLatencyHistogram() {
+  return std::make_unique<HdrHistogram>(kMaxTrackedLatencyUs, 2);
+}
+
+} // namespace
+
+ReadHedging::ReadHedging() : histogram_(NewLatencyHistogram()) {}
+
+ReadHedging::~ReadHedging() {}
+
+void ReadHedging::RecordLatency(MonoDelta latency) {
+  const double percentile = GetAtomicFlag(&FLAGS_read_hedging_latency_percentile);
+  if (percentile <= 0) {
+    return;
+  }
+  const int64_t latency_us = std::min(latency.ToMicroseconds(), kMaxTrackedLatencyUs);
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  histogram_->Increment(std::max<int64_t>(latency_us, 0));
+  ++reads_;
+  if (histogram_->TotalCount() >=
+          static_cast<uint64_t>(std::max(GetAtomicFlag(&FLAGS_read_hedging_window_reads), 1))) {
+    delay_us_.store(histogram_->ValueAtPercentile(std::min(percentile, 100.0)),
+                    std::memory_order_release);
+    histogram_ = NewLatencyHistogram();
+    reads_ /= 2;
+    hedges_ /= 2;
+  }
+}
+
+MonoDelta ReadHedging::HedgeDelay() const {
+  if (GetAtomicFlag(&FLAGS_read_hedging_latency_percentile) <= 0) {
+    return MonoDelta();
+  }
+  const int64_t delay_us = delay_us_.load(std::memory_order_acquire);
+  return delay_us == 0 ? MonoDelta() : MonoDelta::FromMicroseconds(delay_us);
+}
+
+bool ReadHedging::TryAcquireHedge() {
+  const int64_t budget_percent = GetAtomicFlag(&FLAGS_read_hedging_budget_percent);
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  if ((hedges_ + 1) * 100 > budget_percent * reads_) {
+    return false;
+  }
+  ++hedges_;
+  return true;
+}
+
 TabletInvoker::TabletInvoker(const bool local_tserver_only,
                              const bool consistent_prefix,
                              YBClient* client,
@@ -140,10 +208,12 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   }
 
   // Sets current_ts_.
+  follower_read_ = false;
   if (local_tserver_only_) {
     SelectLocalTabletServer();
   } else if (consistent_prefix_ && !leader_only) {
     SelectTabletServerWithConsistentPrefix();
+    follower_read_ = true;
   } else {
     SelectTabletServer();
   }
@@ -187,6 +257,7 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica "
           << current_ts_->ToString();
 
+  send_time_ = MonoTime::Now();
   rpc_->SendRpcToTserver();
 }
 
@@ -216,6 +287,16 @@ bool TabletInvoker::Done(Status* status) {
     return true;
   }
 
+  // Only the calls that reached the server tell its latency, failures are tracked by marking
+  // the replica as failed.
+  if (status->ok() && current_ts_ != nullptr && send_time_.Initialized()) {
+    const auto latency = MonoTime::Now().GetDeltaSince(send_time_);
+    current_ts_->UpdateLatency(latency);
+    if (read_hedging_ != nullptr && follower_read_) {
+      read_hedging_->RecordLatency(latency);
+    }
+  }
+
   // Prefer early failures over controller failures.
   if (status->ok() && retrier_->HandleResponse(command_, status)) {
     return false;
@@ -249,14 +330,16 @@ bool TabletInvoker::Done(Status* status) {
     VLOG(4) << "Retryable failure: " << *status
             << ", response: " << yb::ToString(rpc_->response_error());
 
+    const auto error_code = ErrorCode(rpc_->response_error());
     const bool leader_is_not_ready =
-        ErrorCode(rpc_->response_error()) ==
-            tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
+        error_code == tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
         status->IsLeaderNotReadyToServe();
+    const bool write_throttled = error_code == tserver::TabletServerErrorPB::WRITE_THROTTLED;
 
-    // If the leader just is not ready - let's retry the same tserver.
+    // If the leader just is not ready or throttles writes - let's retry the same tserver after
+    // the retrier's backoff delay.
     // Else the leader became a follower and must be reset on retry.
-    if (!leader_is_not_ready) {
+    if (!leader_is_not_ready && !write_throttled) {
       followers_.insert(current_ts_);
     }
 
@@ -326,6 +409,47 @@ void TabletInvoker::InitialLookupTabletDone(const Result<RemoteTabletPtr>& resul
   }
 }
 
+MonoDelta TabletInvoker::HedgeDelay() const {
+  // Local calls could keep pointers to the request after the hedged request responded.
+  if (read_hedging_ == nullptr || !follower_read_ || current_ts_ == nullptr ||
+      current_ts_->IsLocal()) {
+    return MonoDelta();
+  }
+  return read_hedging_->HedgeDelay();
+}
+
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() {
+  std::vector<RemoteTabletServer*> replicas;
+  tablet_->GetRemoteTabletServers(&replicas, UpdateLocalTsState::kFalse);
+  RemoteTabletServer* result = nullptr;
+  MonoDelta result_latency;
+  for (auto* ts : replicas) {
+    if (ts == current_ts_) {
+      continue;
+    }
+    // Prefer the replica with the lowest observed latency, replicas that were not measured yet
+    // are preferred, so they get measured.
+    const auto latency = ts->latency();
+    if (result == nullptr ||
+        (result_latency.Initialized() && (!latency.Initialized() || latency < result_latency))) {
+      result = ts;
+      result_latency = latency;
+    }
+  }
+  if (result == nullptr || !result->InitProxy(client_).ok() ||
+      !read_hedging_->TryAcquireHedge()) {
+    return nullptr;
+  }
+  return result;
+}
+
+void TabletInvoker::HedgeResponded(RemoteTabletServer* ts, MonoTime send_time) {
+  VLOG(2) << "Tablet " << tablet_id_ << ": Hedged read to " << ts->ToString()
+          << " responded before the read to " << current_ts_->ToString();
+  current_ts_ = ts;
+  send_time_ = send_time;
+}
+
 bool TabletInvoker::IsLocalCall() const {
   return current_ts_ != nullptr && current_ts_->IsLocal();
 }
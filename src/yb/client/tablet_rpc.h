@@ -16,6 +16,8 @@
 #ifndef YB_CLIENT_TABLET_RPC_H
 #define YB_CLIENT_TABLET_RPC_H
 
+#include <atomic>
+#include <memory>
 #include <unordered_set>
 
 #include "yb/client/client-internal.h"
@@ -26,12 +28,15 @@
 
 #include "yb/tserver/tserver.pb.h"
 
+#include "yb/util/locks.h"
 #include "yb/util/result.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
 
 namespace yb {
 
+class HdrHistogram;
+
 namespace tserver {
 class TabletServerServiceProxy;
 }
@@ -48,6 +53,39 @@ class TabletRpc {
   ~TabletRpc() {}
 };
 
+// Hedging of reads of a table, which could be served by followers. A read that takes longer than
+// --read_hedging_latency_percentile of recent reads of the table is sent to another replica as
+// well, and the first response is used. Hedged requests are limited to --read_hedging_budget_percent
+// of reads, so a slow cluster is not overloaded by them.
+class ReadHedging {
+ public:
+  ReadHedging();
+  ~ReadHedging();
+
+  // Records latency of a read that was served successfully.
+  void RecordLatency(MonoDelta latency);
+
+  // Returns the delay after which a read should be hedged, not initialized if reads should not be
+  // hedged, e.g. because hedging is disabled or there are not enough samples yet.
+  MonoDelta HedgeDelay() const;
+
+  // Returns true if a hedged request fits into the budget, and accounts it.
+  bool TryAcquireHedge();
+
+ private:
+  simple_spinlock mutex_;
+  // Latencies of the current window of reads.
+  std::unique_ptr<HdrHistogram> histogram_;
+  // Reads and hedged requests, halved at the end of each window.
+  int64_t reads_ = 0;
+  int64_t hedges_ = 0;
+
+  // Latency percentile of the last complete window.
+  std::atomic<int64_t> delay_us_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(ReadHedging);
+};
+
 tserver::TabletServerErrorPB_Code ErrorCode(const tserver::TabletServerErrorPB* error);
 class TabletInvoker {
  public:
@@ -75,6 +113,21 @@ class TabletInvoker {
   const RemoteTabletServer& current_ts() { return *current_ts_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
+  // Allows hedging of follower reads sent by this invoker, see ReadHedging.
+  void set_read_hedging(ReadHedging* read_hedging) { read_hedging_ = read_hedging; }
+
+  // Returns the delay after which the call to the current tablet server should be hedged, not
+  // initialized if it should not be hedged. Only follower reads to remote tablet servers are hedged.
+  MonoDelta HedgeDelay() const;
+
+  // Returns another replica with a working proxy to send a hedged request to, nullptr if there is
+  // no such replica or the hedging budget is exhausted.
+  RemoteTabletServer* SelectHedgeTabletServer();
+
+  // Called when the hedged request, sent to ts at send_time, responded first, so the response is
+  // handled as coming from ts.
+  void HedgeResponded(RemoteTabletServer* ts, MonoTime send_time);
+
  private:
   void SelectTabletServer();
 
@@ -132,12 +185,20 @@ class TabletInvoker {
 
   const bool consistent_prefix_;
 
+  // Whether the current call was sent to a replica that is not necessarily the leader.
+  bool follower_read_ = false;
+
+  ReadHedging* read_hedging_ = nullptr;
+
   // The TS receiving the write. May change if the write is retried.
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
 
   MonoTime last_tablet_refresh_time_ = MonoTime::kUninitialized;
+
+  // When the RPC was sent to current_ts_, used to track latency of tablet servers.
+  MonoTime send_time_;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
@@ -32,6 +32,8 @@
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/scheduler.h"
 
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/result.h"
@@ -44,6 +46,11 @@ DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heart
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
 DEFINE_bool(transaction_disable_proactive_cleanup_in_tests, false,
             "Disable cleanup of intents in abort path.");
+DEFINE_bool(transaction_single_shard_commit, true,
+            "Whether a transaction that writes to a single tablet and is committed by its "
+            "first flush is written by that tablet directly, without the status tablet.");
+TAG_FLAG(transaction_single_shard_commit, advanced);
+TAG_FLAG(transaction_single_shard_commit, runtime);
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -158,7 +165,7 @@ class YBTransaction::Impl final {
       if (!ready_) {
         waiters_.push_back(std::move(waiter));
         lock.unlock();
-        RequestStatusTablet();
+        RequestStatusTablet(WrittenTabletLeader(ops));
         VLOG_WITH_PREFIX(2) << "Prepare, rejected (not ready, requesting status tablet)";
         return false;
       }
@@ -205,6 +212,29 @@ class YBTransaction::Impl final {
     return true;
   }
 
+  bool PrepareSingleShardCommit(const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    if (!GetAtomicFlag(&FLAGS_transaction_single_shard_commit) || ops.empty()) {
+      return false;
+    }
+    const internal::RemoteTablet* tablet = nullptr;
+    for (const auto& op : ops) {
+      if (op->yb_op->read_only() || (tablet != nullptr && op->tablet.get() != tablet)) {
+        return false;
+      }
+      tablet = op->tablet.get();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The transaction should not be known to any tablet, including the status tablet.
+    if (child_ || ready_ || !tablets_.empty() || !waiters_.empty() || IsRestartRequired() ||
+        state_.load(std::memory_order_acquire) != TransactionState::kRunning) {
+      return false;
+    }
+    VLOG_WITH_PREFIX(1) << "Single shard commit to " << tablet->tablet_id();
+    state_.store(TransactionState::kCommitted, std::memory_order_release);
+    return true;
+  }
+
   void Flushed(const internal::InFlightOps& ops, const Status& status) {
     if (status.ok()) {
       std::lock_guard<std::mutex> lock(mutex_);
@@ -554,14 +584,30 @@ class YBTransaction::Impl final {
     manager_->rpcs().Unregister(&abort_handle_);
   }
 
-  void RequestStatusTablet() {
+  // Returns the leader of a tablet written by ops, if known. The transaction coordinator is
+  // preferably placed next to it.
+  static const internal::RemoteTabletServer* WrittenTabletLeader(
+      const std::unordered_set<internal::InFlightOpPtr>& ops) {
+    for (const auto& op : ops) {
+      if (op->tablet && !op->yb_op->read_only()) {
+        auto* leader = op->tablet->LeaderTServer();
+        if (leader) {
+          return leader;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  void RequestStatusTablet(const internal::RemoteTabletServer* preferred_leader = nullptr) {
     bool expected = false;
     if (!requested_status_tablet_.compare_exchange_strong(
         expected, true, std::memory_order_acq_rel)) {
       return;
     }
     manager_->PickStatusTablet(
-        std::bind(&Impl::StatusTabletPicked, this, _1, transaction_->shared_from_this()));
+        std::bind(&Impl::StatusTabletPicked, this, _1, transaction_->shared_from_this()),
+        preferred_leader);
   }
 
   void StatusTabletPicked(const Result<std::string>& tablet,
@@ -625,6 +671,14 @@ class YBTransaction::Impl final {
       return;
     }
 
+    if (status == TransactionStatus::PENDING) {
+      // Heartbeats of pending transactions are sent by the manager, batched per status tablet.
+      manager_->SendHeartbeat(
+          status_tablet_, metadata_.transaction_id,
+          std::bind(&Impl::HeartbeatDone, this, _1, _2, status, transaction));
+      return;
+    }
+
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -809,6 +863,11 @@ void YBTransaction::Flushed(const internal::InFlightOps& ops, const Status& stat
   impl_->Flushed(ops, status);
 }
 
+bool YBTransaction::PrepareSingleShardCommit(
+    const std::unordered_set<internal::InFlightOpPtr>& ops) {
+  return impl_->PrepareSingleShardCommit(ops);
+}
+
 void YBTransaction::Commit(CommitCallback callback) {
   impl_->Commit(std::move(callback));
 }
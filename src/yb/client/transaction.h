@@ -80,6 +80,13 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
                TransactionMetadata* metadata,
                bool* may_have_metadata);
 
+  // Checks whether the transaction could be committed by writing the specified ops, as a single
+  // non transactional write. It is possible when all of them are writes to the same tablet, and
+  // the transaction has not been sent anywhere yet.
+  // If it returns true, the transaction is marked as committed, and ops should be sent without
+  // transaction metadata.
+  bool PrepareSingleShardCommit(const std::unordered_set<internal::InFlightOpPtr>& ops);
+
   // Notifies transaction that specified ops were flushed with some status.
   void Flushed(const internal::InFlightOps& ops, const Status& status);
 
@@ -15,19 +15,41 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <unordered_map>
+
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/util/async_util.h"
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/transaction.h"
 
+#include "yb/common/wire_protocol.h"
+
 #include "yb/master/master_defaults.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
+DEFINE_int32(transaction_max_heartbeats_per_rpc, 1000,
+             "Max number of transaction heartbeats sent together in one RPC to status tablet. "
+             "0 disables batching, so every transaction sends its own heartbeat RPC.");
+TAG_FLAG(transaction_max_heartbeats_per_rpc, advanced);
+TAG_FLAG(transaction_max_heartbeats_per_rpc, runtime);
+
+DEFINE_bool(transaction_status_tablet_locality, true,
+            "Prefer status tablets led by the leader of a tablet written by the transaction, or by "
+            "a tablet server in its zone, so fewer transaction RPCs cross nodes and zones.");
+TAG_FLAG(transaction_status_tablet_locality, runtime);
+
 namespace yb {
 namespace client {
 
@@ -40,38 +62,89 @@ const YBTableName kTransactionTableName(master::kSystemNamespaceName, kTransacti
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
-void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+struct TransactionTableState {
+  LocalTabletFilter local_tablet_filter;
+  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
+  std::vector<TabletId> tablets;
+  // Status tablets as known by the meta cache, so their current leaders could be checked. Empty if
+  // some of them could not be looked up.
+  std::vector<internal::RemoteTabletPtr> remote_tablets;
+};
+
+bool SameZone(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return !lhs.placement_zone().empty() &&
+         lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region() &&
+         lhs.placement_zone() == rhs.placement_zone();
+}
+
+// Returns status tablets, whose leaders satisfy predicate.
+template <class Predicate>
+std::vector<const TabletId*> StatusTabletsWithLeader(
+    const std::vector<internal::RemoteTabletPtr>& remote_tablets, const Predicate& predicate) {
+  std::vector<const TabletId*> result;
+  for (const auto& tablet : remote_tablets) {
+    auto* leader = tablet->LeaderTServer();
+    if (leader && predicate(*leader)) {
+      result.push_back(&tablet->tablet_id());
+    }
+  }
+  return result;
+}
+
+void InvokeCallback(const TransactionTableState& table_state,
+                    const internal::RemoteTabletServer* preferred_leader,
                     const PickStatusTabletCallback& callback) {
-  if (filter) {
+  const auto& tablets = table_state.tablets;
+  if (!GetAtomicFlag(&FLAGS_transaction_status_tablet_locality)) {
+    preferred_leader = nullptr;
+  }
+  if (preferred_leader) {
+    auto ids = StatusTabletsWithLeader(
+        table_state.remote_tablets, [preferred_leader](const internal::RemoteTabletServer& ts) {
+          return &ts == preferred_leader;
+        });
+    if (!ids.empty()) {
+      callback(*RandomElement(ids));
+      return;
+    }
+  }
+  if (table_state.local_tablet_filter) {
     std::vector<const TabletId*> ids;
     ids.reserve(tablets.size());
     for (const auto& id : tablets) {
       ids.push_back(&id);
     }
-    filter(&ids);
+    table_state.local_tablet_filter(&ids);
     if (!ids.empty()) {
       callback(*RandomElement(ids));
       return;
     }
     LOG(WARNING) << "No local transaction status tablet";
   }
+  if (preferred_leader) {
+    const auto& cloud_info = preferred_leader->cloud_info();
+    auto ids = StatusTabletsWithLeader(
+        table_state.remote_tablets, [&cloud_info](const internal::RemoteTabletServer& ts) {
+          return SameZone(ts.cloud_info(), cloud_info);
+        });
+    if (!ids.empty()) {
+      callback(*RandomElement(ids));
+      return;
+    }
+  }
   callback(RandomElement(tablets));
 }
 
-struct TransactionTableState {
-  LocalTabletFilter local_tablet_filter;
-  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
-  std::vector<TabletId> tablets;
-};
-
 // Picks status tablet for transaction.
 class PickStatusTabletTask {
  public:
   PickStatusTabletTask(const YBClientPtr& client,
                        TransactionTableState* table_state,
-                       PickStatusTabletCallback callback)
+                       PickStatusTabletCallback callback,
+                       const internal::RemoteTabletServer* preferred_leader)
       : client_(client), table_state_(table_state),
-        callback_(std::move(callback)) {
+        callback_(std::move(callback)), preferred_leader_(preferred_leader) {
   }
 
   void Run() {
@@ -90,10 +163,19 @@ class PickStatusTabletTask {
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
       table_state_->tablets = tablets;
+      table_state_->remote_tablets = LookupRemoteTablets(tablets);
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
     }
+    if (table_state_->status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
+      InvokeCallback(*table_state_, preferred_leader_, callback_);
+      return;
+    }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    // Another task is resolving the table, so pick from the tablets without leader information.
+    TransactionTableState resolved_state;
+    resolved_state.local_tablet_filter = table_state_->local_tablet_filter;
+    resolved_state.tablets = std::move(tablets);
+    InvokeCallback(resolved_state, preferred_leader_, callback_);
   }
 
   void Done(const Status& status) {
@@ -105,21 +187,45 @@ class PickStatusTabletTask {
   }
 
  private:
+  std::vector<internal::RemoteTabletPtr> LookupRemoteTablets(const std::vector<TabletId>& tablets) {
+    std::vector<std::future<Result<internal::RemoteTabletPtr>>> futures;
+    futures.reserve(tablets.size());
+    auto deadline = TransactionRpcDeadline();
+    for (const auto& tablet_id : tablets) {
+      futures.push_back(MakeFuture<Result<internal::RemoteTabletPtr>>([&](auto callback) {
+        client_->LookupTabletById(tablet_id, deadline, std::move(callback), UseCache::kTrue);
+      }));
+    }
+    std::vector<internal::RemoteTabletPtr> result;
+    result.reserve(tablets.size());
+    for (auto& future : futures) {
+      auto remote_tablet = future.get();
+      if (!remote_tablet.ok()) {
+        LOG(WARNING) << "Failed to lookup transaction status tablet: " << remote_tablet.status();
+        return {};
+      }
+      result.push_back(std::move(*remote_tablet));
+    }
+    return result;
+  }
 
   YBClientPtr client_;
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
+  const internal::RemoteTabletServer* preferred_leader_;
 };
 
 class InvokeCallbackTask {
  public:
   InvokeCallbackTask(TransactionTableState* table_state,
-                     PickStatusTabletCallback callback)
-      : table_state_(table_state), callback_(std::move(callback)) {
+                     PickStatusTabletCallback callback,
+                     const internal::RemoteTabletServer* preferred_leader)
+      : table_state_(table_state), callback_(std::move(callback)),
+        preferred_leader_(preferred_leader) {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(*table_state_, preferred_leader_, callback_);
   }
 
   void Done(const Status& status) {
@@ -132,6 +238,21 @@ class InvokeCallbackTask {
  private:
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
+  const internal::RemoteTabletServer* preferred_leader_;
+};
+
+struct TransactionHeartbeat {
+  TransactionId id;
+  TransactionHeartbeatCallback callback;
+};
+
+// Heartbeats of transactions with the same status tablet. Heartbeats that are queued while RPC
+// to this tablet is in flight are sent together by the next RPC.
+struct StatusTabletHeartbeats {
+  internal::RemoteTabletPtr tablet;
+  std::vector<TransactionHeartbeat> queue;
+  bool in_flight = false;
+  rpc::Rpcs::Handle handle;
 };
 
 constexpr size_t kQueueLimit = 150;
@@ -152,22 +273,50 @@ class TransactionManager::Impl {
     CHECK(clock);
   }
 
-  void PickStatusTablet(PickStatusTabletCallback callback) {
+  void PickStatusTablet(PickStatusTabletCallback callback,
+                        const internal::RemoteTabletServer* preferred_leader) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
-      } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
+        InvokeCallback(table_state_, preferred_leader, callback);
+      } else if (!invoke_callback_tasks_.Enqueue(
+                     &thread_pool_, &table_state_, callback, preferred_leader)) {
         callback(STATUS_FORMAT(ServiceUnavailable,
                               "Invoke callback queue overflow, number of tasks: $0",
                               invoke_callback_tasks_.size()));
       }
       return;
     }
-    if (!tasks_pool_.Enqueue(&thread_pool_, client_, &table_state_, std::move(callback))) {
+    if (!tasks_pool_.Enqueue(
+            &thread_pool_, client_, &table_state_, std::move(callback), preferred_leader)) {
       callback(STATUS_FORMAT(ServiceUnavailable, "Tasks overflow, exists: $0", tasks_pool_.size()));
     }
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     TransactionHeartbeatCallback callback) {
+    if (GetAtomicFlag(&FLAGS_transaction_max_heartbeats_per_rpc) <= 0) {
+      tserver::UpdateTransactionRequestPB req;
+      FillHeartbeat(transaction_id, req.mutable_state());
+      SendHeartbeats(status_tablet.get(), &req, {{transaction_id, std::move(callback)}},
+                     /* batch */ nullptr);
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(heartbeats_mutex_);
+    auto& batch = heartbeats_[status_tablet->tablet_id()];
+    if (!batch.tablet) {
+      batch.tablet = status_tablet;
+      batch.handle = rpcs_.InvalidHandle();
+    }
+    batch.queue.push_back({transaction_id, std::move(callback)});
+    if (batch.in_flight) {
+      return;
+    }
+    batch.in_flight = true;
+    SendQueuedHeartbeats(&batch, &lock);
+  }
+
   const scoped_refptr<ClockBase>& clock() const {
     return clock_;
   }
@@ -198,6 +347,86 @@ class TransactionManager::Impl {
   }
 
  private:
+  void FillHeartbeat(const TransactionId& id, tserver::TransactionStatePB* state) {
+    state->set_transaction_id(id.begin(), id.size());
+    state->set_status(TransactionStatus::PENDING);
+  }
+
+  // Sends up to transaction_max_heartbeats_per_rpc heartbeats from the queue of batch.
+  // The lock is released before sending.
+  void SendQueuedHeartbeats(StatusTabletHeartbeats* batch, std::unique_lock<std::mutex>* lock) {
+    size_t limit = std::max(GetAtomicFlag(&FLAGS_transaction_max_heartbeats_per_rpc), 1);
+    std::vector<TransactionHeartbeat> heartbeats;
+    if (batch->queue.size() <= limit) {
+      heartbeats.swap(batch->queue);
+    } else {
+      auto end = batch->queue.begin() + limit;
+      heartbeats.assign(std::make_move_iterator(batch->queue.begin()),
+                        std::make_move_iterator(end));
+      batch->queue.erase(batch->queue.begin(), end);
+    }
+    lock->unlock();
+
+    tserver::UpdateTransactionRequestPB req;
+    FillHeartbeat(heartbeats.front().id, req.mutable_state());
+    for (auto it = heartbeats.begin() + 1; it != heartbeats.end(); ++it) {
+      FillHeartbeat(it->id, req.add_additional_states());
+    }
+    SendHeartbeats(batch->tablet.get(), &req, std::move(heartbeats), batch);
+  }
+
+  void SendHeartbeats(internal::RemoteTablet* tablet,
+                      tserver::UpdateTransactionRequestPB* req,
+                      std::vector<TransactionHeartbeat> heartbeats,
+                      StatusTabletHeartbeats* batch) {
+    req->set_tablet_id(tablet->tablet_id());
+    req->set_propagated_hybrid_time(Now().ToUint64());
+    auto shared_heartbeats = std::make_shared<std::vector<TransactionHeartbeat>>(
+        std::move(heartbeats));
+    auto handle = std::make_shared<rpc::Rpcs::Handle>(rpcs_.InvalidHandle());
+    auto* handle_ptr = batch ? &batch->handle : handle.get();
+    rpcs_.RegisterAndStart(
+        HeartbeatTransactions(
+            TransactionRpcDeadline(),
+            tablet,
+            client_.get(),
+            req,
+            [this, shared_heartbeats, handle, handle_ptr, batch](
+                const Status& status, const tserver::UpdateTransactionResponsePB& resp) {
+              HeartbeatsDone(status, resp, *shared_heartbeats, handle_ptr, batch);
+            }),
+        handle_ptr);
+  }
+
+  void HeartbeatsDone(const Status& status,
+                      const tserver::UpdateTransactionResponsePB& resp,
+                      const std::vector<TransactionHeartbeat>& heartbeats,
+                      rpc::Rpcs::Handle* handle,
+                      StatusTabletHeartbeats* batch) {
+    auto propagated_hybrid_time = internal::GetPropagatedHybridTime(resp);
+    UpdateClock(propagated_hybrid_time);
+    rpcs_.Unregister(handle);
+
+    for (size_t i = 0; i != heartbeats.size(); ++i) {
+      // Single heartbeat does not have results, its status is the status of the whole RPC.
+      if (!status.ok() || i >= static_cast<size_t>(resp.heartbeat_statuses().size())) {
+        heartbeats[i].callback(status, propagated_hybrid_time);
+      } else {
+        heartbeats[i].callback(StatusFromPB(resp.heartbeat_statuses(i)), propagated_hybrid_time);
+      }
+    }
+
+    if (!batch) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(heartbeats_mutex_);
+    if (batch->queue.empty()) {
+      batch->in_flight = false;
+      return;
+    }
+    SendQueuedHeartbeats(batch, &lock);
+  }
+
   YBClientPtr client_;
   scoped_refptr<ClockBase> clock_;
   TransactionTableState table_state_;
@@ -206,6 +435,10 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+
+  std::mutex heartbeats_mutex_;
+  // Entries are never erased, so pointers to them stay valid while their RPCs are in flight.
+  std::unordered_map<TabletId, StatusTabletHeartbeats> heartbeats_;
 };
 
 TransactionManager::TransactionManager(
@@ -217,8 +450,15 @@ TransactionManager::~TransactionManager() {
   impl_->Shutdown();
 }
 
-void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
-  impl_->PickStatusTablet(std::move(callback));
+void TransactionManager::PickStatusTablet(
+    PickStatusTabletCallback callback, const internal::RemoteTabletServer* preferred_leader) {
+  impl_->PickStatusTablet(std::move(callback), preferred_leader);
+}
+
+void TransactionManager::SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                                       const TransactionId& transaction_id,
+                                       TransactionHeartbeatCallback callback) {
+  impl_->SendHeartbeat(status_tablet, transaction_id, std::move(callback));
 }
 
 const YBClientPtr& TransactionManager::client() const {
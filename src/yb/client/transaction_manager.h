@@ -23,6 +23,7 @@
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
@@ -32,6 +33,7 @@ namespace yb {
 namespace client {
 
 typedef std::function<void(const Result<std::string>&)> PickStatusTabletCallback;
+typedef std::function<void(const Status&, HybridTime)> TransactionHeartbeatCallback;
 
 // TransactionManager manages multiple transactions. It lives at the YQL engine layer.
 class TransactionManager {
@@ -40,7 +42,17 @@ class TransactionManager {
                      LocalTabletFilter local_tablet_filter);
   ~TransactionManager();
 
-  void PickStatusTablet(PickStatusTabletCallback callback);
+  // Picks a status tablet for a new transaction. Status tablets led by preferred_leader, the leader
+  // of a tablet written by the transaction, are preferred, then the local ones, then the ones led
+  // by a tablet server in the zone of preferred_leader.
+  void PickStatusTablet(PickStatusTabletCallback callback,
+                        const internal::RemoteTabletServer* preferred_leader = nullptr);
+
+  // Sends heartbeat of pending transaction to its status tablet. Heartbeats of transactions with
+  // the same status tablet are sent together, in one UpdateTransaction RPC.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     TransactionHeartbeatCallback callback);
 
   rpc::Rpcs& rpcs();
   const YBClientPtr& client() const;
@@ -153,6 +153,29 @@ struct UpdateTransactionTraits {
 
 constexpr const char* UpdateTransactionTraits::kName;
 
+struct HeartbeatTransactionsTraits {
+  static constexpr const char* kName = "HeartbeatTransactions";
+
+  typedef tserver::UpdateTransactionRequestPB Request;
+  typedef tserver::UpdateTransactionResponsePB Response;
+  typedef HeartbeatTransactionsCallback Callback;
+
+  static void CallCallback(
+      const Callback& callback, const Status& status, const Response& response) {
+    callback(status, response);
+  }
+
+  static void InvokeAsync(tserver::TabletServerServiceProxy* proxy,
+                          const Request& request,
+                          Response* response,
+                          rpc::RpcController* controller,
+                          rpc::ResponseCallback callback) {
+    proxy->UpdateTransactionAsync(request, response, controller, std::move(callback));
+  }
+};
+
+constexpr const char* HeartbeatTransactionsTraits::kName;
+
 struct GetTransactionStatusTraits {
   static constexpr const char* kName = "GetTransactionStatus";
 
@@ -211,6 +234,16 @@ rpc::RpcCommandPtr UpdateTransaction(
       deadline, tablet, client, req, std::move(callback));
 }
 
+rpc::RpcCommandPtr HeartbeatTransactions(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    HeartbeatTransactionsCallback callback) {
+  return std::make_shared<TransactionRpc<HeartbeatTransactionsTraits>>(
+      deadline, tablet, client, req, std::move(callback));
+}
+
 rpc::RpcCommandPtr GetTransactionStatus(
     const MonoTime& deadline,
     internal::RemoteTablet* tablet,
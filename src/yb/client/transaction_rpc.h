@@ -36,6 +36,7 @@ class AbortTransactionResponsePB;
 class GetTransactionStatusRequestPB;
 class GetTransactionStatusResponsePB;
 class UpdateTransactionRequestPB;
+class UpdateTransactionResponsePB;
 
 }
 
@@ -58,6 +59,18 @@ MUST_USE_RESULT rpc::RpcCommandPtr UpdateTransaction(
     tserver::UpdateTransactionRequestPB* req,
     UpdateTransactionCallback callback);
 
+typedef std::function<void(const Status&, const tserver::UpdateTransactionResponsePB&)>
+    HeartbeatTransactionsCallback;
+
+// Sends heartbeats of several transactions with the same status tablet, in state and
+// additional_states of req. Result of every heartbeat is returned in heartbeat_statuses.
+MUST_USE_RESULT rpc::RpcCommandPtr HeartbeatTransactions(
+    const MonoTime& deadline,
+    internal::RemoteTablet* tablet,
+    YBClient* client,
+    tserver::UpdateTransactionRequestPB* req,
+    HeartbeatTransactionsCallback callback);
+
 typedef std::function<void(const Status&, const tserver::GetTransactionStatusResponsePB&)>
     GetTransactionStatusCallback;
 
@@ -32,6 +32,8 @@
 
 #include "yb/client/yb_op.h"
 
+#include <gflags/gflags.h>
+
 #include "yb/client/client.h"
 #include "yb/client/meta_cache.h"
 
@@ -43,12 +45,58 @@
 #include "yb/common/ql_rowblock.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 
+#include "yb/util/flag_tags.h"
+#include "yb/util/object_pool.h"
+
+DEFINE_int32(ql_request_recycle_max_size, 64 * 1024,
+             "QL requests of destroyed client operations are cleared and reused by new "
+             "operations, when their last serialized size is not bigger than this number of bytes. "
+             "0 to disable reuse.");
+TAG_FLAG(ql_request_recycle_max_size, advanced);
+TAG_FLAG(ql_request_recycle_max_size, runtime);
+
 namespace yb {
 namespace client {
 
 using std::shared_ptr;
 using std::unique_ptr;
 
+namespace {
+
+// Cleared protobufs keep memory of their strings and repeated fields, so the CQL proxy, that runs
+// the same statements over and over, fills reused requests mostly without memory allocations.
+template <class Request>
+ThreadSafeObjectPool<Request>& RequestPool() {
+  // Never destroyed, since operations could be destroyed by static objects after exit.
+  static auto* pool = new ThreadSafeObjectPool<Request>([] { return new Request; });
+  return *pool;
+}
+
+template <class Request>
+Request* TakeRequest() {
+  if (FLAGS_ql_request_recycle_max_size <= 0) {
+    return new Request;
+  }
+  return RequestPool<Request>().Take();
+}
+
+template <class Request>
+void RecycleRequest(std::unique_ptr<Request>* request) {
+  if (!*request) {
+    return;
+  }
+  // Cached size is filled when the request is serialized, and is zero otherwise.
+  if (FLAGS_ql_request_recycle_max_size <= 0 ||
+      (**request).GetCachedSize() > FLAGS_ql_request_recycle_max_size) {
+    request->reset();
+    return;
+  }
+  (**request).Clear();
+  RequestPool<Request>().Release(request->release());
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 // YBOperation
 //--------------------------------------------------------------------------------------------------
@@ -59,6 +107,15 @@ YBOperation::YBOperation(const shared_ptr<YBTable>& table)
 
 YBOperation::~YBOperation() {}
 
+void YBOperation::InvokeCompletionCallback(const Status& status) {
+  if (!completion_callback_) {
+    return;
+  }
+  auto callback = std::move(completion_callback_);
+  completion_callback_ = nullptr;
+  callback(status);
+}
+
 void YBOperation::SetTablet(const scoped_refptr<internal::RemoteTablet>& tablet) {
   tablet_ = tablet;
 }
@@ -174,10 +231,12 @@ YBqlOp::~YBqlOp() {
 // YBqlWriteOp -----------------------------------------------------------------
 
 YBqlWriteOp::YBqlWriteOp(const shared_ptr<YBTable>& table)
-    : YBqlOp(table), ql_write_request_(new QLWriteRequestPB()) {
+    : YBqlOp(table), ql_write_request_(TakeRequest<QLWriteRequestPB>()) {
 }
 
-YBqlWriteOp::~YBqlWriteOp() {}
+YBqlWriteOp::~YBqlWriteOp() {
+  RecycleRequest(&ql_write_request_);
+}
 
 static YBqlWriteOp *NewYBqlWriteOp(const shared_ptr<YBTable>& table,
                                    QLWriteRequestPB::QLStmtType stmt_type) {
@@ -323,11 +382,13 @@ bool YBqlWriteOp::PrimaryKeyComparator::operator() (const YBqlWriteOpPtr& op1,
 
 YBqlReadOp::YBqlReadOp(const shared_ptr<YBTable>& table)
     : YBqlOp(table),
-      ql_read_request_(new QLReadRequestPB()),
+      ql_read_request_(TakeRequest<QLReadRequestPB>()),
       yb_consistency_level_(YBConsistencyLevel::STRONG) {
 }
 
-YBqlReadOp::~YBqlReadOp() {}
+YBqlReadOp::~YBqlReadOp() {
+  RecycleRequest(&ql_read_request_);
+}
 
 YBqlReadOp *YBqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   YBqlReadOp *op = new YBqlReadOp(table);
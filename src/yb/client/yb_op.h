@@ -41,6 +41,8 @@
 #include "yb/common/partition.h"
 #include "yb/common/read_hybrid_time.h"
 
+#include "yb/util/async_util.h"
+
 namespace yb {
 
 class RedisWriteRequestPB;
@@ -111,6 +113,15 @@ class YBOperation {
   // Returns the partition key of the operation.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const = 0;
 
+  // Sets the callback that is invoked once, when this operation is completed by the batcher it
+  // was applied to. See YBSession::ApplyAsync.
+  void set_completion_callback(StatusFunctor callback) {
+    completion_callback_ = std::move(callback);
+  }
+
+  // Invokes and resets the completion callback, if it was set.
+  void InvokeCompletionCallback(const Status& status);
+
  protected:
   explicit YBOperation(const std::shared_ptr<YBTable>& table);
 
@@ -121,6 +132,8 @@ class YBOperation {
 
   scoped_refptr<internal::RemoteTablet> tablet_;
 
+  StatusFunctor completion_callback_;
+
   DISALLOW_COPY_AND_ASSIGN(YBOperation);
 };
 
@@ -35,9 +35,24 @@ void ConsistentReadPoint::SetCurrentReadTime() {
   restarts_.clear();
 }
 
+namespace {
+
+void UpdateLimit(const TabletId& tablet, HybridTime local_limit,
+                 ConsistentReadPoint::HybridTimeMap* map) {
+  auto emplace_result = map->emplace(tablet, local_limit);
+  bool inserted = emplace_result.second;
+  if (!inserted) {
+    auto& existing_local_limit = emplace_result.first->second;
+    existing_local_limit = std::min(existing_local_limit, local_limit);
+  }
+}
+
+} // namespace
+
 ReadHybridTime ConsistentReadPoint::GetReadTime(const TabletId& tablet) const {
   ReadHybridTime read_time = read_time_;
   if (read_time) {
+    std::lock_guard<std::mutex> lock(mutex_);
     // Use the local limit for the tablet but no earlier than the read time we want.
     const auto it = local_limits_.find(tablet);
     if (it != local_limits_.end()) {
@@ -56,11 +71,15 @@ void ConsistentReadPoint::RestartRequired(const TabletId& tablet,
   if (restarts_.empty()) {
     restarts_ = local_limits_;
   }
-  auto emplace_result = restarts_.emplace(tablet, restart_time.local_limit);
-  bool inserted = emplace_result.second;
-  if (!inserted) {
-    auto& existing_local_limit = emplace_result.first->second;
-    existing_local_limit = std::min(existing_local_limit, restart_time.local_limit);
+  UpdateLimit(tablet, restart_time.local_limit, &restarts_);
+}
+
+void ConsistentReadPoint::UpdateLocalLimit(const TabletId& tablet, HybridTime local_limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  UpdateLimit(tablet, local_limit, &local_limits_);
+  // Restart inherits local limits, so keep them in restarts when they were already inherited.
+  if (!restarts_.empty()) {
+    UpdateLimit(tablet, local_limit, &restarts_);
   }
 }
 
@@ -91,6 +110,11 @@ void ConsistentReadPoint::PrepareChildTransactionData(ChildTransactionDataPB* da
 }
 
 void ConsistentReadPoint::FinishChildTransactionResult(ChildTransactionResultPB* result) const {
+  auto& local_limits = *result->mutable_local_limits();
+  for (const auto& entry : local_limits_) {
+    typedef std::remove_reference<decltype(*local_limits.begin())>::type PairType;
+    local_limits.insert(PairType(entry.first, entry.second.ToUint64()));
+  }
   if (IsRestartRequired()) {
     result->set_restart_read_ht(restart_read_ht_.ToUint64());
     auto& restarts = *result->mutable_read_restarts();
@@ -104,6 +128,9 @@ void ConsistentReadPoint::FinishChildTransactionResult(ChildTransactionResultPB*
 }
 
 void ConsistentReadPoint::ApplyChildTransactionResult(const ChildTransactionResultPB& result) {
+  for (const auto& local_limit : result.local_limits()) {
+    UpdateLocalLimit(local_limit.first, HybridTime(local_limit.second));
+  }
   HybridTime restart_read_ht(result.restart_read_ht());
   if (restart_read_ht.is_valid()) {
     ReadHybridTime read_time;
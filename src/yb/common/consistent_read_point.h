@@ -40,9 +40,13 @@ class ConsistentReadPoint {
 
   const ReadHybridTime& GetReadTime() const { return read_time_; }
 
-  // Get the read time of this read point for a tablet.
+  // Get the read time of this read point for a tablet. This method is thread-safe.
   ReadHybridTime GetReadTime(const TabletId& tablet) const;
 
+  // Notify that a read from the tablet used the specified local limit, so later reads from this
+  // tablet could use it. Keeps the smallest local limit reported. This method is thread-safe.
+  void UpdateLocalLimit(const TabletId& tablet, HybridTime local_limit);
+
   // Notify that a tablet requires restart. This method is thread-safe.
   void RestartRequired(const TabletId& tablet, const ReadHybridTime& restart_time);
 
@@ -72,11 +76,12 @@ class ConsistentReadPoint {
  private:
   scoped_refptr<ClockBase> clock_;
 
-  std::mutex mutex_;
+  mutable std::mutex mutex_;
   ReadHybridTime read_time_;
   HybridTime restart_read_ht_;
 
-  // Local limits for separate tablets. Does not change during lifetime of a consistent read.
+  // Local limits for separate tablets. Could only decrease during lifetime of a consistent read,
+  // when tablets report the local limits they used.
   // Times such that anything happening at that hybrid time or later is definitely after the
   // original request arrived and therefore does not have to be shown in results.
   HybridTimeMap local_limits_;
@@ -13,6 +13,7 @@
 
 #include "yb/common/doc_hybrid_time.h"
 
+#include "yb/gutil/macros.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/cast.h"
@@ -22,7 +23,7 @@
 
 using yb::util::VarInt;
 using yb::util::FastEncodeDescendingSignedVarInt;
-using yb::util::FastDecodeDescendingSignedVarInt;
+using yb::util::FastDecodeDescendingSignedVarInts;
 using yb::util::FormatBytesAsStr;
 using yb::util::FormatSliceAsStr;
 using yb::util::QuotesType;
@@ -86,28 +87,22 @@ char* DocHybridTime::EncodedInDocDbFormat(char* dest) const {
 
 Status DocHybridTime::DecodeFrom(Slice *slice) {
   const size_t previous_size = slice->size();
-  {
-    // Currently we just ignore the generation number as it should always be 0.
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice));
-    int64_t decoded_micros =
-        kYugaByteMicrosecondEpoch + VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
-
-    int64_t decoded_logical = VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
-
-    hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded_logical);
-  }
-
-  const auto ptr_before_decoding_write_id = slice->data();
-  int64_t decoded_shifted_write_id = VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
-
+  const auto ptr_before_decoding = slice->data();
+  // Generation number, microseconds, logical value and shifted write id, decoded in one batch.
+  // Currently we just ignore the generation number as it should always be 0.
+  int64_t components[4];
+  RETURN_NOT_OK(FastDecodeDescendingSignedVarInts(slice, components, arraysize(components)));
+  hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(
+      kYugaByteMicrosecondEpoch + components[1], components[2]);
+
+  const int64_t decoded_shifted_write_id = components[3];
   if (decoded_shifted_write_id < 0) {
     return STATUS_SUBSTITUTE(
         Corruption,
         "Negative decoded_shifted_write_id: $0. Was trying to decode from: $1",
         decoded_shifted_write_id,
         FormatSliceAsStr(
-            Slice(ptr_before_decoding_write_id,
-                  slice->data() + slice->size() - ptr_before_decoding_write_id),
+            Slice(ptr_before_decoding, previous_size),
             QuotesType::kDoubleQuotes,
             /* max_length = */ 32));
   }
@@ -64,6 +64,7 @@ IndexInfo::IndexInfo(const IndexInfoPB& pb)
       schema_version_(pb.version()),
       is_local_(pb.is_local()),
       is_unique_(pb.is_unique()),
+      is_backfilling_(pb.is_backfilling()),
       columns_(IndexColumnFromPB(pb.columns())),
       hash_column_count_(pb.hash_column_count()),
       range_column_count_(pb.range_column_count()),
@@ -80,6 +81,7 @@ void IndexInfo::ToPB(IndexInfoPB* pb) const {
   pb->set_version(schema_version_);
   pb->set_is_local(is_local_);
   pb->set_is_unique(is_unique_);
+  pb->set_is_backfilling(is_backfilling_);
   for (const auto& column : columns_) {
     column.ToPB(pb->add_columns());
   }
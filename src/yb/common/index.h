@@ -50,6 +50,7 @@ class IndexInfo {
   uint32_t schema_version() const { return schema_version_; }
   bool is_local() const { return is_local_; }
   bool is_unique() const { return is_unique_; }
+  bool is_backfilling() const { return is_backfilling_; }
 
   const std::vector<IndexColumn>& columns() const { return columns_; }
   const IndexColumn& column(const size_t idx) const { return columns_[idx]; }
@@ -79,6 +80,7 @@ class IndexInfo {
   const uint32_t schema_version_ = 0; // Index table's schema version.
   const bool is_local_ = false;       // Whether this is a local index.
   const bool is_unique_ = false;      // Whether this is a unique index.
+  const bool is_backfilling_ = false; // Whether existing rows are still being added to the index.
   const std::vector<IndexColumn> columns_; // Index columns.
   const size_t hash_column_count_ = 0;     // Number of hash columns in the index.
   const size_t range_column_count_ = 0;    // Number of range columns in the index.
@@ -151,5 +151,44 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+TEST(JsonbTest, TestApplyJsonbOperators) {
+  Jsonb jsonb;
+  std::string json = R"#({ "a" : { "b" : "x", "c" : 2 }, "z" : 5)#";
+  // Enough keys for the binary search at the top level to take several steps.
+  for (int i = 0; i != 100; ++i) {
+    json += ", \"k" + to_string(i) + "\" : " + to_string(i);
+  }
+  json += "}";
+  ASSERT_OK(jsonb.FromString(json));
+
+  auto make_ops = [](const std::vector<std::string>& path, JsonOperatorPB last_operator) {
+    QLJsonColumnOperationsPB ops;
+    for (size_t i = 0; i != path.size(); ++i) {
+      auto* op = ops.add_json_operations();
+      op->set_json_operator(i + 1 == path.size() ? last_operator : JsonOperatorPB::JSON_OBJECT);
+      op->mutable_operand()->mutable_value()->set_string_value(path[i]);
+    }
+    return ops;
+  };
+
+  QLValue result;
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(
+      jsonb.SerializedJsonb(), make_ops({"a", "b"}, JsonOperatorPB::JSON_TEXT), &result));
+  ASSERT_EQ("x", result.string_value());
+
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(
+      jsonb.SerializedJsonb(), make_ops({"k42"}, JsonOperatorPB::JSON_TEXT), &result));
+  ASSERT_EQ("42", result.string_value());
+
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(
+      jsonb.SerializedJsonb(), make_ops({"a", "missing"}, JsonOperatorPB::JSON_TEXT), &result));
+  ASSERT_TRUE(result.IsNull());
+
+  // Intermediate scalar results yield null.
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(
+      jsonb.SerializedJsonb(), make_ops({"z", "b"}, JsonOperatorPB::JSON_TEXT), &result));
+  ASSERT_TRUE(result.IsNull());
+}
+
 }  // namespace common
 }  // namespace yb
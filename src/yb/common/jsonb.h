@@ -79,6 +79,12 @@ class Jsonb {
   CHECKED_STATUS ApplyJsonbOperators(const QLJsonColumnOperationsPB& json_ops,
                                      QLValue* result) const;
 
+  // Applies the json operators directly to a serialized jsonb, e.g. a column value, without
+  // copying or decoding the document. Each object level is a binary search over the sorted keys.
+  static CHECKED_STATUS ApplyJsonbOperators(const Slice& serialized_jsonb,
+                                            const QLJsonColumnOperationsPB& json_ops,
+                                            QLValue* result);
+
   const std::string& SerializedJsonb() const;
 
   // Use with extreme care since this destroys the internal state of the object. The only purpose
@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <cmath>
+
+#include "yb/common/ql_column_batch.h"
+#include "yb/common/ql_expr.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+TEST(QLColumnBatchTest, Simple) {
+  QLColumnBatch batch({ColumnId(10), ColumnId(20)});
+  ASSERT_EQ(0, batch.ColumnIndex(ColumnId(10)));
+  ASSERT_EQ(1, batch.ColumnIndex(ColumnId(20)));
+  ASSERT_EQ(-1, batch.ColumnIndex(ColumnId(30)));
+
+  for (int pass = 0; pass != 2; ++pass) {
+    batch.Clear();
+    for (int row = 0; row != 3; ++row) {
+      batch.AllocRow();
+      batch.AllocValue(0)->set_int32_value(row + pass);
+      // Second column is null for odd rows.
+      if (row % 2 == pass) {
+        batch.AllocValue(1)->set_string_value("row" + std::to_string(row));
+      }
+    }
+
+    ASSERT_EQ(3, batch.num_rows());
+    for (int row = 0; row != 3; ++row) {
+      ASSERT_FALSE(batch.IsNull(0, row));
+      ASSERT_EQ(row + pass, batch.value(0, row).int32_value());
+      ASSERT_EQ(row % 2 != pass, batch.IsNull(1, row));
+      ASSERT_EQ(row % 2 != pass, batch.value(1, row).IsNull());
+    }
+  }
+}
+
+namespace {
+
+void AddColumnCondition(
+    QLConditionPB* condition, QLOperator op, int32_t column_id, const QLValuePB& value) {
+  condition->set_op(op);
+  condition->add_operands()->set_column_id(column_id);
+  *condition->add_operands()->mutable_value() = value;
+}
+
+QLValuePB Int64Value(int64_t value) {
+  QLValuePB result;
+  result.set_int64_value(value);
+  return result;
+}
+
+// Checks that filter selects the same rows as QLExprExecutor::EvalCondition.
+void CheckFilter(const QLConditionPB& condition, const QLColumnBatch& batch) {
+  auto filter = QLColumnBatchFilter::Compile(condition);
+  ASSERT_NE(filter, nullptr);
+  std::vector<uint8_t> selected;
+  ASSERT_OK(filter->Evaluate(batch, &selected));
+  ASSERT_EQ(batch.num_rows(), selected.size());
+
+  QLExprExecutor executor;
+  for (size_t row = 0; row != batch.num_rows(); ++row) {
+    QLTableRow table_row;
+    for (size_t column = 0; column != batch.num_columns(); ++column) {
+      table_row.AllocColumn(batch.column_ids()[column], batch.value(column, row));
+    }
+    QLValue result;
+    ASSERT_OK(executor.EvalCondition(condition, table_row, &result));
+    ASSERT_EQ(result.bool_value(), selected[row] != 0) << "Row: " << row;
+  }
+}
+
+} // namespace
+
+TEST(QLColumnBatchTest, Filter) {
+  QLColumnBatch batch({ColumnId(10), ColumnId(20)});
+  for (int row = 0; row != 20; ++row) {
+    batch.AllocRow();
+    batch.AllocValue(0)->set_int64_value(row);
+    // Second column is null for each third row.
+    if (row % 3 != 0) {
+      batch.AllocValue(1)->set_double_value(row % 2 ? 0.5 * row : std::nan(""));
+    }
+  }
+
+  QLValuePB double_value;
+  double_value.set_double_value(4.5);
+  for (auto op : {QL_OP_EQUAL, QL_OP_NOT_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL,
+                  QL_OP_GREATER_THAN, QL_OP_GREATER_THAN_EQUAL}) {
+    QLConditionPB condition;
+    AddColumnCondition(&condition, op, 10, Int64Value(7));
+    ASSERT_NO_FATALS(CheckFilter(condition, batch));
+
+    condition.Clear();
+    AddColumnCondition(&condition, op, 20, double_value);
+    ASSERT_NO_FATALS(CheckFilter(condition, batch));
+  }
+
+  QLValuePB list;
+  for (int64_t value : {13, 2, 21, 8}) {
+    *list.mutable_list_value()->add_elems() = Int64Value(value);
+  }
+  for (auto op : {QL_OP_IN, QL_OP_NOT_IN}) {
+    QLConditionPB condition;
+    AddColumnCondition(&condition, op, 10, list);
+    ASSERT_NO_FATALS(CheckFilter(condition, batch));
+  }
+
+  // (c10 > 3 AND c20 <= 4.5) OR c10 IN (13, 2, 21, 8).
+  QLConditionPB condition;
+  condition.set_op(QL_OP_OR);
+  auto* and_condition = condition.add_operands()->mutable_condition();
+  and_condition->set_op(QL_OP_AND);
+  AddColumnCondition(
+      and_condition->add_operands()->mutable_condition(), QL_OP_GREATER_THAN, 10, Int64Value(3));
+  AddColumnCondition(
+      and_condition->add_operands()->mutable_condition(), QL_OP_LESS_THAN_EQUAL, 20,
+      double_value);
+  AddColumnCondition(condition.add_operands()->mutable_condition(), QL_OP_IN, 10, list);
+  ASSERT_NO_FATALS(CheckFilter(condition, batch));
+
+  // Values of different types are not comparable.
+  condition.Clear();
+  AddColumnCondition(&condition, QL_OP_EQUAL, 20, Int64Value(1));
+  auto filter = QLColumnBatchFilter::Compile(condition);
+  ASSERT_NE(filter, nullptr);
+  std::vector<uint8_t> selected;
+  ASSERT_NOK(filter->Evaluate(batch, &selected));
+
+  // Conditions on expressions are not supported.
+  condition.Clear();
+  condition.set_op(QL_OP_IS_NULL);
+  condition.add_operands()->set_column_id(10);
+  ASSERT_EQ(QLColumnBatchFilter::Compile(condition), nullptr);
+}
+
+} // namespace yb
@@ -0,0 +1,325 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_column_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+QLColumnBatch::QLColumnBatch(std::vector<ColumnId> column_ids)
+    : column_ids_(std::move(column_ids)), columns_(column_ids_.size()) {
+}
+
+void QLColumnBatch::Clear() {
+  num_rows_ = 0;
+}
+
+int QLColumnBatch::ColumnIndex(ColumnId column_id) const {
+  for (size_t i = 0; i != column_ids_.size(); ++i) {
+    if (column_ids_[i] == column_id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void QLColumnBatch::AllocRow() {
+  for (auto& column : columns_) {
+    if (column.values.size() == num_rows_) {
+      column.values.emplace_back();
+      column.is_null.push_back(true);
+    } else {
+      column.is_null[num_rows_] = true;
+    }
+  }
+  ++num_rows_;
+}
+
+QLValuePB* QLColumnBatch::AllocValue(size_t column_index) {
+  DCHECK_GT(num_rows_, 0);
+  auto& column = columns_[column_index];
+  column.is_null[num_rows_ - 1] = false;
+  auto* result = column.values[num_rows_ - 1].mutable_value();
+  // Value could be left from previous use of the batch.
+  result->Clear();
+  return result;
+}
+
+const QLValue& QLColumnBatch::value(size_t column_index, size_t row_index) const {
+  static const QLValue kNullValue;
+  const auto& column = columns_[column_index];
+  return column.is_null[row_index] ? kNullValue : column.values[row_index];
+}
+
+std::string QLColumnBatch::ToString() const {
+  std::string result = "{ ";
+  for (size_t row = 0; row != num_rows_; ++row) {
+    result += row ? ", [" : "[";
+    for (size_t column = 0; column != columns_.size(); ++column) {
+      if (column) {
+        result += ", ";
+      }
+      result += IsNull(column, row) ? "null" : value(column, row).ToString();
+    }
+    result += "]";
+  }
+  result += " }";
+  return result;
+}
+
+namespace {
+
+// Whether values of this type could be compared by the batch filter.
+bool IsBatchComparable(QLValuePB::ValueCase value_case) {
+  switch (value_case) {
+    case QLValuePB::kMapValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kSetValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kListValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kFrozenValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::VALUE_NOT_SET:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Returns error if a not null value in the column has a different type than the constants.
+CHECKED_STATUS CheckComparable(
+    const QLColumnBatch& batch, size_t column_index, QLValuePB::ValueCase value_case) {
+  for (size_t row = 0; row != batch.num_rows(); ++row) {
+    if (!batch.IsNull(column_index, row) &&
+        batch.value(column_index, row).value().value_case() != value_case) {
+      return STATUS(RuntimeError, "values not comparable");
+    }
+  }
+  return Status::OK();
+}
+
+// Sets selected[row] to op(get(value), constant) for all rows, 0 for null values.
+template <class T, class Get, class Op>
+void CompareColumnLoop(const QLColumnBatch& batch, size_t column_index, const T& constant,
+                       const Get& get, const Op& op, uint8_t* selected) {
+  const size_t num_rows = batch.num_rows();
+  for (size_t row = 0; row != num_rows; ++row) {
+    selected[row] = !batch.IsNull(column_index, row) &&
+                    op(get(batch.value(column_index, row).value()), constant);
+  }
+}
+
+template <class T, class Get>
+void CompareColumn(QLOperator op, const QLColumnBatch& batch, size_t column_index,
+                   const T& constant, const Get& get, uint8_t* selected) {
+  switch (op) {
+    case QL_OP_EQUAL:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::equal_to<T>(), selected);
+    case QL_OP_NOT_EQUAL:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::not_equal_to<T>(), selected);
+    case QL_OP_LESS_THAN:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::less<T>(), selected);
+    case QL_OP_LESS_THAN_EQUAL:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::less_equal<T>(), selected);
+    case QL_OP_GREATER_THAN:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::greater<T>(), selected);
+    case QL_OP_GREATER_THAN_EQUAL:
+      return CompareColumnLoop(
+          batch, column_index, constant, get, std::greater_equal<T>(), selected);
+    default:
+      LOG(DFATAL) << "Unexpected comparison operator: " << op;
+      std::fill_n(selected, batch.num_rows(), 0);
+  }
+}
+
+bool IsComparisonOperator(QLOperator op) {
+  switch (op) {
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+std::unique_ptr<QLColumnBatchFilter> QLColumnBatchFilter::Compile(const QLConditionPB& condition) {
+  std::unique_ptr<QLColumnBatchFilter> result(new QLColumnBatchFilter());
+  if (!result->CompileNode(condition, &result->root_)) {
+    return nullptr;
+  }
+  return result;
+}
+
+bool QLColumnBatchFilter::CompileNode(const QLConditionPB& condition, Node* node) {
+  const auto& operands = condition.operands();
+  node->op = condition.op();
+  if (node->op == QL_OP_AND || node->op == QL_OP_OR) {
+    if (operands.empty()) {
+      return false;
+    }
+    node->children.resize(operands.size());
+    for (int i = 0; i != operands.size(); ++i) {
+      if (operands.Get(i).expr_case() != QLExpressionPB::ExprCase::kCondition ||
+          !CompileNode(operands.Get(i).condition(), &node->children[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const bool is_in = node->op == QL_OP_IN || node->op == QL_OP_NOT_IN;
+  if ((!is_in && !IsComparisonOperator(node->op)) || operands.size() != 2 ||
+      operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kColumnId ||
+      operands.Get(1).expr_case() != QLExpressionPB::ExprCase::kValue) {
+    return false;
+  }
+  node->column_id = ColumnId(operands.Get(0).column_id());
+  const QLValuePB& value = operands.Get(1).value();
+  if (is_in) {
+    if (value.value_case() != QLValuePB::kListValue) {
+      return false;
+    }
+    const auto& elems = value.list_value().elems();
+    for (const auto& elem : elems) {
+      if (!IsBatchComparable(elem.value_case()) ||
+          elem.value_case() != elems.Get(0).value_case()) {
+        return false;
+      }
+    }
+    node->values.assign(elems.begin(), elems.end());
+    std::sort(node->values.begin(), node->values.end());
+  } else {
+    if (!IsBatchComparable(value.value_case())) {
+      return false;
+    }
+    node->value = value;
+  }
+  if (std::find(column_ids_.begin(), column_ids_.end(), node->column_id) == column_ids_.end()) {
+    column_ids_.push_back(node->column_id);
+  }
+  return true;
+}
+
+Status QLColumnBatchFilter::Evaluate(
+    const QLColumnBatch& batch, std::vector<uint8_t>* selected) const {
+  selected->resize(batch.num_rows());
+  if (batch.num_rows() == 0) {
+    return Status::OK();
+  }
+  return EvaluateNode(root_, batch, selected->data());
+}
+
+Status QLColumnBatchFilter::EvaluateNode(
+    const Node& node, const QLColumnBatch& batch, uint8_t* selected) {
+  const size_t num_rows = batch.num_rows();
+  if (node.op == QL_OP_AND || node.op == QL_OP_OR) {
+    RETURN_NOT_OK(EvaluateNode(node.children[0], batch, selected));
+    std::vector<uint8_t> child_selected(num_rows);
+    for (size_t i = 1; i != node.children.size(); ++i) {
+      RETURN_NOT_OK(EvaluateNode(node.children[i], batch, child_selected.data()));
+      if (node.op == QL_OP_AND) {
+        for (size_t row = 0; row != num_rows; ++row) {
+          selected[row] &= child_selected[row];
+        }
+      } else {
+        for (size_t row = 0; row != num_rows; ++row) {
+          selected[row] |= child_selected[row];
+        }
+      }
+    }
+    return Status::OK();
+  }
+
+  const int column_index = batch.ColumnIndex(node.column_id);
+  if (column_index < 0) {
+    return STATUS_FORMAT(InternalError, "Column $0 is missing in batch", node.column_id);
+  }
+  if (node.op == QL_OP_IN || node.op == QL_OP_NOT_IN) {
+    return EvaluateIn(node, batch, column_index, selected);
+  }
+  return EvaluateComparison(node, batch, column_index, selected);
+}
+
+Status QLColumnBatchFilter::EvaluateComparison(
+    const Node& node, const QLColumnBatch& batch, size_t column_index, uint8_t* selected) {
+  RETURN_NOT_OK(CheckComparable(batch, column_index, node.value.value_case()));
+  switch (node.value.value_case()) {
+    case QLValuePB::kInt32Value:
+      CompareColumn(node.op, batch, column_index, node.value.int32_value(),
+              [](const QLValuePB& value) { return value.int32_value(); }, selected);
+      return Status::OK();
+    case QLValuePB::kInt64Value:
+      CompareColumn(node.op, batch, column_index, node.value.int64_value(),
+              [](const QLValuePB& value) { return value.int64_value(); }, selected);
+      return Status::OK();
+    case QLValuePB::kTimestampValue:
+      CompareColumn(node.op, batch, column_index, node.value.timestamp_value(),
+              [](const QLValuePB& value) { return value.timestamp_value(); }, selected);
+      return Status::OK();
+    case QLValuePB::kDoubleValue: {
+      // NaN is equal to NaN and greater than any other value, as in QLValue comparison.
+      const double constant = node.value.double_value();
+      if (!std::isnan(constant)) {
+        CompareColumn(node.op, batch, column_index, 0,
+                [constant](const QLValuePB& value) {
+                  const double v = value.double_value();
+                  return std::isnan(v) ? 1 : (v < constant ? -1 : (v > constant ? 1 : 0));
+                },
+                selected);
+        return Status::OK();
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  const QLValuePB& constant = node.value;
+  CompareColumn(node.op, batch, column_index, 0,
+                [&constant](const QLValuePB& value) { return Compare(value, constant); },
+                selected);
+  return Status::OK();
+}
+
+Status QLColumnBatchFilter::EvaluateIn(
+    const Node& node, const QLColumnBatch& batch, size_t column_index, uint8_t* selected) {
+  const size_t num_rows = batch.num_rows();
+  const uint8_t in = node.op == QL_OP_IN;
+  if (node.values.empty()) {
+    std::fill_n(selected, num_rows, !in);
+    return Status::OK();
+  }
+  RETURN_NOT_OK(CheckComparable(batch, column_index, node.values.front().value_case()));
+  for (size_t row = 0; row != num_rows; ++row) {
+    // Null is not equal to any constant.
+    selected[row] = !batch.IsNull(column_index, row) &&
+                    std::binary_search(node.values.begin(), node.values.end(),
+                                       batch.value(column_index, row).value())
+                    ? in : !in;
+  }
+  return Status::OK();
+}
+
+} // namespace yb
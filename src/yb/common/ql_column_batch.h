@@ -0,0 +1,129 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains the class that represents a batch of QL rows stored column-wise, and the
+// class that evaluates a WHERE condition over such batches.
+
+#ifndef YB_COMMON_QL_COLUMN_BATCH_H
+#define YB_COMMON_QL_COLUMN_BATCH_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/common/ql_value.h"
+#include "yb/common/schema.h"
+
+namespace yb {
+
+// A batch of QL rows stored column-wise: one value vector per column plus a null bitmap.
+// It is used by scans that decode rows straight into column vectors, avoiding per-row column maps.
+// Values are kept allocated when batch is cleared, so the same batch could be reused for
+// consecutive reads without reallocating column values.
+class QLColumnBatch {
+ public:
+  explicit QLColumnBatch(std::vector<ColumnId> column_ids);
+
+  QLColumnBatch(const QLColumnBatch&) = delete;
+  void operator=(const QLColumnBatch&) = delete;
+
+  // Removes all rows from the batch.
+  void Clear();
+
+  size_t num_rows() const { return num_rows_; }
+
+  size_t num_columns() const { return column_ids_.size(); }
+
+  const std::vector<ColumnId>& column_ids() const { return column_ids_; }
+
+  // Returns index of column with specified id, or -1 if batch does not contain such column.
+  int ColumnIndex(ColumnId column_id) const;
+
+  // Appends new row with all columns set to null.
+  void AllocRow();
+
+  // Returns value of specified column in the last row, marking it as not null.
+  QLValuePB* AllocValue(size_t column_index);
+
+  bool IsNull(size_t column_index, size_t row_index) const {
+    return columns_[column_index].is_null[row_index];
+  }
+
+  // Returns value of specified column and row. Null values have no value set.
+  const QLValue& value(size_t column_index, size_t row_index) const;
+
+  std::string ToString() const;
+
+ private:
+  struct Column {
+    std::vector<QLValue> values;
+    std::vector<bool> is_null;
+  };
+
+  std::vector<ColumnId> column_ids_;
+  std::vector<Column> columns_;
+  size_t num_rows_ = 0;
+};
+
+// A WHERE condition compiled for evaluation over column batches. Instead of walking the condition
+// tree for each row, each comparison is evaluated for all rows of a batch at once by a loop
+// specialized for the operator and the value type.
+//
+// Supported conditions are comparisons of a column with a constant, IN and NOT IN with a list of
+// constants, and AND / OR of supported conditions. The results are the same as of
+// QLExprExecutor::EvalCondition.
+class QLColumnBatchFilter {
+ public:
+  // Returns nullptr if the condition is not supported.
+  static std::unique_ptr<QLColumnBatchFilter> Compile(const QLConditionPB& condition);
+
+  // Ids of columns referenced by the condition. All of them should be present in evaluated
+  // batches.
+  const std::vector<ColumnId>& column_ids() const { return column_ids_; }
+
+  // Sets (*selected)[i] to 1 if i-th row of batch matches the condition, and to 0 otherwise.
+  CHECKED_STATUS Evaluate(const QLColumnBatch& batch, std::vector<uint8_t>* selected) const;
+
+ private:
+  struct Node {
+    QLOperator op;
+    // For comparisons, IN and NOT IN.
+    ColumnId column_id;
+    // Constant of comparison.
+    QLValuePB value;
+    // Constants of IN and NOT IN, sorted.
+    std::vector<QLValuePB> values;
+    // Operands of AND and OR.
+    std::vector<Node> children;
+  };
+
+  QLColumnBatchFilter() {}
+
+  bool CompileNode(const QLConditionPB& condition, Node* node);
+
+  static CHECKED_STATUS EvaluateNode(
+      const Node& node, const QLColumnBatch& batch, uint8_t* selected);
+
+  static CHECKED_STATUS EvaluateComparison(
+      const Node& node, const QLColumnBatch& batch, size_t column_index, uint8_t* selected);
+
+  static CHECKED_STATUS EvaluateIn(
+      const Node& node, const QLColumnBatch& batch, size_t column_index, uint8_t* selected);
+
+  Node root_;
+  std::vector<ColumnId> column_ids_;
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COLUMN_BATCH_H
@@ -5,9 +5,64 @@
 #include "yb/common/jsonb.h"
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_bfunc.h"
+#include "yb/common/ql_scalar_value.h"
+#include "yb/util/result.h"
 
 namespace yb {
 
+namespace {
+
+// Returns the value of an operand that is a constant or a column reference without copying it, or
+// none if the operand has to be evaluated or its type is not supported by QLScalarValue.
+boost::optional<QLScalarValue> BorrowOperand(const QLExpressionPB& operand,
+                                             const QLTableRow& table_row) {
+  switch (operand.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue:
+      return QLScalarValue::Borrow(operand.value());
+    case QLExpressionPB::ExprCase::kColumnId: {
+      auto value = table_row.GetValue(operand.column_id());
+      if (!value) {
+        return QLScalarValue();
+      }
+      return QLScalarValue::Borrow(*value);
+    }
+    default:
+      return boost::none;
+  }
+}
+
+// Evaluates whether the left operand is in the list of constants of the right operand without
+// copying them. Returns none if the operands are not supported by QLScalarValue.
+Result<boost::optional<bool>> EvalScalarIn(const QLExpressionPB& left_operand,
+                                           const QLExpressionPB& right_operand,
+                                           const QLTableRow& table_row) {
+  if (right_operand.expr_case() != QLExpressionPB::ExprCase::kValue) {
+    return boost::none;
+  }
+  auto left = BorrowOperand(left_operand, table_row);
+  if (!left) {
+    return boost::none;
+  }
+  const auto& elems = right_operand.value().list_value().elems();
+  for (const QLValuePB& elem : elems) {
+    if (!QLScalarValue::IsSupportedType(elem.value_case())) {
+      return boost::none;
+    }
+  }
+  for (const QLValuePB& elem : elems) {
+    auto right = QLScalarValue::Borrow(elem);
+    if (!right->Comparable(*left)) {
+      return STATUS(RuntimeError, "values not comparable");
+    }
+    if (*right == *left) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
 bfql::TSOpcode QLExprExecutor::GetTSWriteInstruction(const QLExpressionPB& ql_expr) const {
   // "kSubDocInsert" instructs the tablet server to insert a new value or replace an existing value.
   if (ql_expr.has_tscall()) {
@@ -31,11 +86,15 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       break;
 
     case QLExpressionPB::ExprCase::kJsonColumn: {
-      QLValue ql_value;
       const QLJsonColumnOperationsPB& json_ops = ql_expr.json_column();
-      RETURN_NOT_OK(table_row.ReadColumn(json_ops.column_id(), &ql_value));
-      common::Jsonb jsonb(std::move(ql_value.jsonb_value()));
-      RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, result));
+      // Navigate the serialized column value in place instead of copying it out of the row.
+      auto column_value = table_row.GetValue(json_ops.column_id());
+      if (!column_value || !column_value->has_jsonb_value()) {
+        result->SetNull();
+        break;
+      }
+      RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(
+          column_value->jsonb_value(), json_ops, result));
       break;
     }
 
@@ -156,6 +215,14 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 #define QL_EVALUATE_RELATIONAL_OP(op)                                                              \
   do {                                                                                             \
     CHECK_EQ(operands.size(), 2);                                                                  \
+    auto left_scalar = BorrowOperand(operands.Get(0), table_row);                                  \
+    auto right_scalar = left_scalar ? BorrowOperand(operands.Get(1), table_row) : boost::none;     \
+    if (right_scalar) {                                                                            \
+      if (!left_scalar->Comparable(*right_scalar))                                                 \
+        return STATUS(RuntimeError, "values not comparable");                                      \
+      result->set_bool_value(*left_scalar op *right_scalar);                                       \
+      return Status::OK();                                                                         \
+    }                                                                                              \
     QLValue left, right;                                                                           \
     RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));                                    \
     RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));                                   \
@@ -168,6 +235,17 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 #define QL_EVALUATE_BETWEEN(op1, op2, rel_op)                                                      \
   do {                                                                                             \
       CHECK_EQ(operands.size(), 3);                                                                \
+      auto temp_scalar = BorrowOperand(operands.Get(0), table_row);                                \
+      auto lower_scalar = temp_scalar ? BorrowOperand(operands.Get(1), table_row) : boost::none;   \
+      auto upper_scalar = lower_scalar ? BorrowOperand(operands.Get(2), table_row) : boost::none;  \
+      if (upper_scalar) {                                                                          \
+        if (!temp_scalar->Comparable(*lower_scalar) || !temp_scalar->Comparable(*upper_scalar)) {  \
+          return STATUS(RuntimeError, "values not comparable");                                    \
+        }                                                                                          \
+        result->set_bool_value(                                                                    \
+            *temp_scalar >= *lower_scalar rel_op *temp_scalar <= *upper_scalar);                   \
+        return Status::OK();                                                                       \
+      }                                                                                            \
       QLValue lower, upper;                                                                        \
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));                                  \
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &lower));                                 \
@@ -277,6 +355,11 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
     case QL_OP_IN: {
       CHECK_EQ(operands.size(), 2);
+      auto scalar_result = VERIFY_RESULT(EvalScalarIn(operands.Get(0), operands.Get(1), table_row));
+      if (scalar_result) {
+        result->set_bool_value(*scalar_result);
+        return Status::OK();
+      }
       QLValue left, right;
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
@@ -296,6 +379,11 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
     case QL_OP_NOT_IN: {
       CHECK_EQ(operands.size(), 2);
+      auto scalar_result = VERIFY_RESULT(EvalScalarIn(operands.Get(0), operands.Get(1), table_row));
+      if (scalar_result) {
+        result->set_bool_value(!*scalar_result);
+        return Status::OK();
+      }
       QLValue left, right;
       RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));
       RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));
@@ -358,7 +446,9 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const PgsqlExpressionPB& ql_expr,
     case PgsqlExpressionPB::ExprCase::kTscall:
       return EvalTSCall(ql_expr.tscall(), table_row, result);
 
-    case PgsqlExpressionPB::ExprCase::kBocall: FALLTHROUGH_INTENDED;
+    case PgsqlExpressionPB::ExprCase::kBocall:
+      return EvalBOCall(ql_expr.bocall(), table_row, result);
+
     case PgsqlExpressionPB::ExprCase::kBindId: FALLTHROUGH_INTENDED;
     case PgsqlExpressionPB::ExprCase::kAliasId: FALLTHROUGH_INTENDED;
     case PgsqlExpressionPB::ExprCase::EXPR_NOT_SET:
@@ -417,6 +507,115 @@ CHECKED_STATUS QLExprExecutor::EvalBFCall(const PgsqlBCallPB& bfcall,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS QLExprExecutor::EvalBOCall(const PgsqlBCallPB& bocall,
+                                          const QLTableRow::SharedPtrConst& table_row,
+                                          QLValue *result) {
+#define PGSQL_EVALUATE_RELATIONAL_OP(op)                                                           \
+  do {                                                                                             \
+    if (operands.size() != 2) {                                                                    \
+      return STATUS(RuntimeError, "Wrong number of operands");                                     \
+    }                                                                                              \
+    QLValue left, right;                                                                           \
+    RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &left));                                    \
+    RETURN_NOT_OK(EvalExpr(operands.Get(1), table_row, &right));                                   \
+    if (left.IsNull() || right.IsNull()) {                                                         \
+      result->set_bool_value(false);                                                               \
+      return Status::OK();                                                                         \
+    }                                                                                              \
+    if (!left.Comparable(right)) {                                                                 \
+      return STATUS(RuntimeError, "values not comparable");                                        \
+    }                                                                                              \
+    result->set_bool_value(left.value() op right.value());                                         \
+    return Status::OK();                                                                           \
+  } while (false)
+
+  QLValue temp;
+  const auto& operands = bocall.operands();
+  switch (static_cast<QLOperator>(bocall.opcode())) {
+    case QL_OP_IS_NULL:
+      if (operands.size() != 1) {
+        return STATUS(RuntimeError, "Wrong number of operands");
+      }
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
+      result->set_bool_value(temp.IsNull());
+      return Status::OK();
+
+    case QL_OP_IS_NOT_NULL:
+      if (operands.size() != 1) {
+        return STATUS(RuntimeError, "Wrong number of operands");
+      }
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
+      result->set_bool_value(!temp.IsNull());
+      return Status::OK();
+
+    case QL_OP_EQUAL:
+      PGSQL_EVALUATE_RELATIONAL_OP(==);
+
+    case QL_OP_LESS_THAN:
+      PGSQL_EVALUATE_RELATIONAL_OP(<);                                                   // NOLINT
+
+    case QL_OP_LESS_THAN_EQUAL:
+      PGSQL_EVALUATE_RELATIONAL_OP(<=);
+
+    case QL_OP_GREATER_THAN:
+      PGSQL_EVALUATE_RELATIONAL_OP(>);                                                   // NOLINT
+
+    case QL_OP_GREATER_THAN_EQUAL:
+      PGSQL_EVALUATE_RELATIONAL_OP(>=);
+
+    case QL_OP_NOT_EQUAL:
+      PGSQL_EVALUATE_RELATIONAL_OP(!=);
+
+    case QL_OP_AND:
+      result->set_bool_value(true);
+      for (const auto& operand : operands) {
+        RETURN_NOT_OK(EvalExpr(operand, table_row, &temp));
+        if (temp.IsNull() || !temp.bool_value()) {
+          result->set_bool_value(false);
+          break;
+        }
+      }
+      return Status::OK();
+
+    // The first operand is tested against the values of the remaining ones.
+    case QL_OP_IN: {
+      if (operands.size() < 2) {
+        return STATUS(RuntimeError, "Wrong number of operands");
+      }
+      result->set_bool_value(false);
+      RETURN_NOT_OK(EvalExpr(operands.Get(0), table_row, &temp));
+      if (temp.IsNull()) {
+        return Status::OK();
+      }
+      for (int i = 1; i < operands.size(); i++) {
+        QLValue elem;
+        RETURN_NOT_OK(EvalExpr(operands.Get(i), table_row, &elem));
+        if (elem.IsNull()) {
+          continue;
+        }
+        if (!temp.Comparable(elem)) {
+          return STATUS(RuntimeError, "values not comparable");
+        }
+        if (temp.value() == elem.value()) {
+          result->set_bool_value(true);
+          break;
+        }
+      }
+      return Status::OK();
+    }
+
+    default:
+      break;
+  }
+
+  result->SetNull();
+  return STATUS_SUBSTITUTE(RuntimeError, "Unsupported operator $0", bocall.opcode());
+
+#undef PGSQL_EVALUATE_RELATIONAL_OP
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS QLExprExecutor::EvalTSCall(const PgsqlBCallPB& ql_expr,
                                           const QLTableRow::SharedPtrConst& table_row,
                                           QLValue *result) {
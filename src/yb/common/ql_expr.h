@@ -230,6 +230,12 @@ class QLExprExecutor {
                                     const QLTableRow::SharedPtrConst& table_row,
                                     QLValue *result);
 
+  // Evaluate call to builtin operator. The opcode is a QLOperator. Comparisons with a null operand
+  // are false, so that rows are filtered the same way as by a WHERE clause in Postgres.
+  virtual CHECKED_STATUS EvalBOCall(const PgsqlBCallPB& ql_expr,
+                                    const QLTableRow::SharedPtrConst& table_row,
+                                    QLValue *result);
+
   // Evaluate call to tablet-server builtin operator.
   virtual CHECKED_STATUS EvalTSCall(const PgsqlBCallPB& ql_expr,
                                     const QLTableRow::SharedPtrConst& table_row,
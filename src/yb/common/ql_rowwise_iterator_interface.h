@@ -23,6 +23,7 @@ namespace yb {
 class HybridTime;
 class PgsqlReadRequestPB;
 class PgsqlResponsePB;
+class QLColumnBatch;
 class QLReadRequestPB;
 class QLResponsePB;
 class QLTableRow;
@@ -79,6 +80,14 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator does not provide row-key");
   }
 
+  // Reads up to max_rows next rows using the specified projection, decoding them column-wise into
+  // the batch. Batch columns that are not present in the projection are left null.
+  // Returns NotSupported without reading anything if iterator does not support this mode.
+  virtual CHECKED_STATUS NextRowBatch(const Schema& projection, size_t max_rows,
+                                      QLColumnBatch* batch) {
+    return STATUS(NotSupported, "This iterator does not support column batches");
+  }
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
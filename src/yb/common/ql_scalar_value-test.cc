@@ -0,0 +1,137 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <cmath>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/ql_scalar_value.h"
+#include "yb/common/ql_value.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+std::vector<QLValuePB> TestValues() {
+  std::vector<QLValuePB> result;
+  for (double value : {-1.5, 0.0, 2.5, std::nan("")}) {
+    result.emplace_back();
+    result.back().set_double_value(value);
+  }
+  for (int64_t value : {-7, 0, 7}) {
+    result.emplace_back();
+    result.back().set_int64_value(value);
+  }
+  for (const char* value : {"", "a", "ab", "a long string that does not fit inline"}) {
+    result.emplace_back();
+    result.back().set_string_value(value);
+  }
+  result.emplace_back();
+  return result;
+}
+
+} // namespace
+
+// Checks that comparisons of borrowed values are the same as of QLValuePB.
+TEST(QLScalarValueTest, Compare) {
+  const auto values = TestValues();
+  for (const auto& lhs_pb : values) {
+    auto lhs = QLScalarValue::Borrow(lhs_pb);
+    ASSERT_TRUE(lhs);
+    for (const auto& rhs_pb : values) {
+      auto rhs = QLScalarValue::Borrow(rhs_pb);
+      ASSERT_TRUE(rhs);
+      ASSERT_EQ(Comparable(lhs_pb, rhs_pb), lhs->Comparable(*rhs));
+      if (!Comparable(lhs_pb, rhs_pb)) {
+        continue;
+      }
+      const auto description = lhs_pb.ShortDebugString() + " vs " + rhs_pb.ShortDebugString();
+      ASSERT_EQ(lhs_pb < rhs_pb, *lhs < *rhs) << description;
+      ASSERT_EQ(lhs_pb <= rhs_pb, *lhs <= *rhs) << description;
+      ASSERT_EQ(lhs_pb > rhs_pb, *lhs > *rhs) << description;
+      ASSERT_EQ(lhs_pb >= rhs_pb, *lhs >= *rhs) << description;
+      ASSERT_EQ(lhs_pb == rhs_pb, *lhs == *rhs) << description;
+      ASSERT_EQ(lhs_pb != rhs_pb, *lhs != *rhs) << description;
+    }
+  }
+
+  QLValuePB uuid_pb;
+  uuid_pb.set_uuid_value("0123456789abcdef");
+  ASSERT_FALSE(QLScalarValue::Borrow(uuid_pb));
+}
+
+TEST(QLScalarValueTest, OwnedBytes) {
+  for (const std::string& bytes : {std::string("short"), std::string(100, 'x')}) {
+    QLScalarValue value;
+    {
+      std::string temp = bytes;
+      value.set_bytes_value(QLValuePB::kBinaryValue, temp);
+    }
+    // Copies own their bytes too.
+    QLScalarValue copy = value;
+    value.SetNull();
+    ASSERT_EQ(bytes, copy.bytes_value().ToBuffer());
+
+    QLValuePB pb;
+    copy.ToPB(&pb);
+    ASSERT_EQ(bytes, pb.binary_value());
+  }
+}
+
+// Checks that conditions evaluated on borrowed values give the same results as on QLValue.
+TEST(QLScalarValueTest, EvalCondition) {
+  QLTableRow row;
+  row.AllocColumn(ColumnId(10)).value.set_string_value("b");
+  row.AllocColumn(ColumnId(20)).value.set_int64_value(5);
+
+  QLExprExecutor executor;
+  auto check = [&executor, &row](QLOperator op, int32_t column_id,
+                                 std::vector<QLValuePB> args, bool expected) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    condition.add_operands()->set_column_id(column_id);
+    for (auto& arg : args) {
+      *condition.add_operands()->mutable_value() = std::move(arg);
+    }
+    bool result = !expected;
+    ASSERT_OK(executor.EvalCondition(condition, row, &result));
+    ASSERT_EQ(expected, result) << condition.ShortDebugString();
+  };
+
+  QLValuePB a, c, four, six, list;
+  a.set_string_value("a");
+  c.set_string_value("c");
+  four.set_int64_value(4);
+  six.set_int64_value(6);
+  *list.mutable_list_value()->add_elems() = a;
+  *list.mutable_list_value()->add_elems() = c;
+
+  ASSERT_NO_FATALS(check(QL_OP_GREATER_THAN, 10, {a}, true));
+  ASSERT_NO_FATALS(check(QL_OP_LESS_THAN, 10, {a}, false));
+  ASSERT_NO_FATALS(check(QL_OP_BETWEEN, 20, {four, six}, true));
+  ASSERT_NO_FATALS(check(QL_OP_BETWEEN, 20, {six, four}, false));
+  ASSERT_NO_FATALS(check(QL_OP_IN, 10, {list}, false));
+  ASSERT_NO_FATALS(check(QL_OP_NOT_IN, 10, {list}, true));
+  // A missing column is null.
+  ASSERT_NO_FATALS(check(QL_OP_EQUAL, 30, {a}, false));
+
+  QLConditionPB condition;
+  condition.set_op(QL_OP_EQUAL);
+  condition.add_operands()->set_column_id(10);
+  *condition.add_operands()->mutable_value() = four;
+  bool result;
+  ASSERT_NOK(executor.EvalCondition(condition, row, &result));
+}
+
+} // namespace yb
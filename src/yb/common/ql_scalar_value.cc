@@ -0,0 +1,313 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_scalar_value.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <glog/logging.h>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+namespace {
+
+template<typename T>
+int GenericCompare(const T& lhs, const T& rhs) {
+  if (lhs < rhs) return -1;
+  if (lhs > rhs) return 1;
+  return 0;
+}
+
+// NaN is greater than any other number and equal to itself, like in Compare of QLValuePB.
+template<typename T>
+int CompareFloatingPoint(T lhs, T rhs) {
+  const bool lhs_is_nan = std::isnan(lhs);
+  const bool rhs_is_nan = std::isnan(rhs);
+  if (lhs_is_nan || rhs_is_nan) {
+    return GenericCompare(lhs_is_nan, rhs_is_nan);
+  }
+  return GenericCompare(lhs, rhs);
+}
+
+bool IsBytesType(QLValuePB::ValueCase type) {
+  switch (type) {
+    case QLValuePB::kDecimalValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kVarintValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kStringValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kBinaryValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kJsonbValue:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+QLScalarValue::QLScalarValue(const QLScalarValue& other) {
+  CopyFrom(other);
+}
+
+QLScalarValue& QLScalarValue::operator=(const QLScalarValue& other) {
+  if (this != &other) {
+    CopyFrom(other);
+  }
+  return *this;
+}
+
+void QLScalarValue::CopyFrom(const QLScalarValue& other) {
+  type_ = other.type_;
+  int_ = other.int_;
+  // Borrowed bytes stay borrowed, owned ones are copied.
+  if (IsBytesType(other.type_) &&
+      (other.data_ == other.inline_ || other.data_ == other.owned_.data())) {
+    set_bytes_value(other.type_, other.bytes_value());
+  } else {
+    data_ = other.data_;
+    size_ = other.size_;
+  }
+}
+
+bool QLScalarValue::IsSupportedType(InternalType type) {
+  switch (type) {
+    case QLValuePB::kInt8Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt16Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt32Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt64Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kFloatValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kDoubleValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kBoolValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kTimestampValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kDateValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kTimeValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::VALUE_NOT_SET:
+      return true;
+    default:
+      return IsBytesType(type);
+  }
+}
+
+boost::optional<QLScalarValue> QLScalarValue::Borrow(const QLValuePB& pb) {
+  QLScalarValue result;
+  const std::string* bytes = nullptr;
+  switch (pb.value_case()) {
+    case QLValuePB::kInt8Value:
+      result.set_int8_value(pb.int8_value());
+      return result;
+    case QLValuePB::kInt16Value:
+      result.set_int16_value(pb.int16_value());
+      return result;
+    case QLValuePB::kInt32Value:
+      result.set_int32_value(pb.int32_value());
+      return result;
+    case QLValuePB::kInt64Value:
+      result.set_int64_value(pb.int64_value());
+      return result;
+    case QLValuePB::kFloatValue:
+      result.set_float_value(pb.float_value());
+      return result;
+    case QLValuePB::kDoubleValue:
+      result.set_double_value(pb.double_value());
+      return result;
+    case QLValuePB::kBoolValue:
+      result.set_bool_value(pb.bool_value());
+      return result;
+    case QLValuePB::kTimestampValue:
+      result.set_timestamp_value(pb.timestamp_value());
+      return result;
+    case QLValuePB::kDateValue:
+      result.set_date_value(pb.date_value());
+      return result;
+    case QLValuePB::kTimeValue:
+      result.set_time_value(pb.time_value());
+      return result;
+    case QLValuePB::kDecimalValue:
+      bytes = &pb.decimal_value();
+      break;
+    case QLValuePB::kVarintValue:
+      bytes = &pb.varint_value();
+      break;
+    case QLValuePB::kStringValue:
+      bytes = &pb.string_value();
+      break;
+    case QLValuePB::kBinaryValue:
+      bytes = &pb.binary_value();
+      break;
+    case QLValuePB::kJsonbValue:
+      bytes = &pb.jsonb_value();
+      break;
+    case QLValuePB::VALUE_NOT_SET:
+      return result;
+    default:
+      return boost::none;
+  }
+  result.type_ = pb.value_case();
+  result.data_ = bytes->data();
+  result.size_ = bytes->size();
+  return result;
+}
+
+void QLScalarValue::set_float_value(float value) {
+  type_ = QLValuePB::kFloatValue;
+  float_ = value;
+}
+
+void QLScalarValue::set_double_value(double value) {
+  type_ = QLValuePB::kDoubleValue;
+  double_ = value;
+}
+
+void QLScalarValue::set_bool_value(bool value) {
+  type_ = QLValuePB::kBoolValue;
+  bool_ = value;
+}
+
+void QLScalarValue::set_bytes_value(InternalType type, const Slice& value) {
+  DCHECK(IsBytesType(type)) << type;
+  type_ = type;
+  size_ = value.size();
+  if (value.size() <= kInlineCapacity) {
+    memcpy(inline_, value.data(), value.size());
+    data_ = inline_;
+  } else {
+    owned_.assign(value.cdata(), value.size());
+    data_ = owned_.data();
+  }
+}
+
+int QLScalarValue::CompareTo(const QLScalarValue& other) const {
+  CHECK_EQ(type_, other.type_);
+  CHECK(!IsNull());
+  switch (type_) {
+    case QLValuePB::kInt8Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt16Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt32Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kInt64Value: FALLTHROUGH_INTENDED;
+    case QLValuePB::kTimestampValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kDateValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kTimeValue:
+      return GenericCompare(int_, other.int_);
+    case QLValuePB::kFloatValue:
+      return CompareFloatingPoint(float_, other.float_);
+    case QLValuePB::kDoubleValue:
+      return CompareFloatingPoint(double_, other.double_);
+    case QLValuePB::kBoolValue:
+      return GenericCompare(bool_, other.bool_);
+    // Encoded decimals and varints are byte-comparable.
+    case QLValuePB::kDecimalValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kVarintValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kStringValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kBinaryValue: FALLTHROUGH_INTENDED;
+    case QLValuePB::kJsonbValue:
+      return bytes_value().compare(other.bytes_value());
+    default:
+      break;
+  }
+  LOG(FATAL) << "Internal error: unsupported type " << type_;
+  return 0;
+}
+
+void QLScalarValue::ToPB(QLValuePB* pb) const {
+  switch (type_) {
+    case QLValuePB::kInt8Value:
+      pb->set_int8_value(int_);
+      return;
+    case QLValuePB::kInt16Value:
+      pb->set_int16_value(int_);
+      return;
+    case QLValuePB::kInt32Value:
+      pb->set_int32_value(int_);
+      return;
+    case QLValuePB::kInt64Value:
+      pb->set_int64_value(int_);
+      return;
+    case QLValuePB::kTimestampValue:
+      pb->set_timestamp_value(int_);
+      return;
+    case QLValuePB::kDateValue:
+      pb->set_date_value(int_);
+      return;
+    case QLValuePB::kTimeValue:
+      pb->set_time_value(int_);
+      return;
+    case QLValuePB::kFloatValue:
+      pb->set_float_value(float_);
+      return;
+    case QLValuePB::kDoubleValue:
+      pb->set_double_value(double_);
+      return;
+    case QLValuePB::kBoolValue:
+      pb->set_bool_value(bool_);
+      return;
+    case QLValuePB::kDecimalValue:
+      pb->set_decimal_value(data_, size_);
+      return;
+    case QLValuePB::kVarintValue:
+      pb->set_varint_value(data_, size_);
+      return;
+    case QLValuePB::kStringValue:
+      pb->set_string_value(data_, size_);
+      return;
+    case QLValuePB::kBinaryValue:
+      pb->set_binary_value(data_, size_);
+      return;
+    case QLValuePB::kJsonbValue:
+      pb->set_jsonb_value(data_, size_);
+      return;
+    case QLValuePB::VALUE_NOT_SET:
+      pb->Clear();
+      return;
+    default:
+      break;
+  }
+  LOG(FATAL) << "Internal error: unsupported type " << type_;
+}
+
+std::string QLScalarValue::ToString() const {
+  QLValuePB pb;
+  ToPB(&pb);
+  return pb.ShortDebugString();
+}
+
+bool operator <(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) < 0;
+}
+
+bool operator >(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) > 0;
+}
+
+bool operator <=(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) <= 0;
+}
+
+bool operator >=(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) >= 0;
+}
+
+bool operator ==(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  // Equality holds for null values.
+  if (lhs.IsNull() && rhs.IsNull()) {
+    return true;
+  }
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) == 0;
+}
+
+bool operator !=(const QLScalarValue& lhs, const QLScalarValue& rhs) {
+  return !lhs.IsNull() && !rhs.IsNull() && lhs.CompareTo(rhs) != 0;
+}
+
+} // namespace yb
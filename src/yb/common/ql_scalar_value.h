@@ -0,0 +1,128 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains the QLScalarValue class that represents scalar QL values during expression
+// evaluation without protobuf.
+
+#ifndef YB_COMMON_QL_SCALAR_VALUE_H
+#define YB_COMMON_QL_SCALAR_VALUE_H
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "yb/common/ql_protocol.pb.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// A compact value of a scalar QL type. Numbers are stored inline. Bytes of strings and of other
+// types stored as bytes are either borrowed, typically from the QLValuePB of a column in a row or
+// of a constant in a request, or owned, in which case short ones are stored inline. So a value is
+// obtained from a QLValuePB without allocations, and is converted back to QLValuePB only when it
+// has to be sent.
+//
+// Only types whose values are ordered by comparing the stored numbers or bytes are supported:
+// integers, floating point numbers, bool, decimal, varint, string, binary, jsonb, timestamp, date
+// and time. Values of other types should be evaluated as QLValue.
+class QLScalarValue {
+ public:
+  typedef QLValuePB::ValueCase InternalType;
+
+  // Creates a null value.
+  QLScalarValue() {}
+
+  QLScalarValue(const QLScalarValue& other);
+  QLScalarValue& operator=(const QLScalarValue& other);
+
+  // Returns a value that refers to the bytes of pb, which should outlive the result. Returns none
+  // if the type of pb is not supported.
+  static boost::optional<QLScalarValue> Borrow(const QLValuePB& pb);
+
+  // Returns whether values of the type are supported.
+  static bool IsSupportedType(InternalType type);
+
+  InternalType type() const { return type_; }
+  bool IsNull() const { return type_ == QLValuePB::VALUE_NOT_SET; }
+  void SetNull() { type_ = QLValuePB::VALUE_NOT_SET; }
+
+  int64_t int_value() const { return int_; }
+  float float_value() const { return float_; }
+  double double_value() const { return double_; }
+  bool bool_value() const { return bool_; }
+  // Bytes of decimal, varint, string, binary and jsonb values.
+  Slice bytes_value() const { return Slice(data_, size_); }
+
+  void set_int8_value(int8_t value) { SetInt(QLValuePB::kInt8Value, value); }
+  void set_int16_value(int16_t value) { SetInt(QLValuePB::kInt16Value, value); }
+  void set_int32_value(int32_t value) { SetInt(QLValuePB::kInt32Value, value); }
+  void set_int64_value(int64_t value) { SetInt(QLValuePB::kInt64Value, value); }
+  void set_timestamp_value(int64_t value) { SetInt(QLValuePB::kTimestampValue, value); }
+  void set_date_value(uint32_t value) { SetInt(QLValuePB::kDateValue, value); }
+  void set_time_value(int64_t value) { SetInt(QLValuePB::kTimeValue, value); }
+  void set_float_value(float value);
+  void set_double_value(double value);
+  void set_bool_value(bool value);
+
+  // Copies value into this value. type should be one of the types stored as bytes.
+  void set_bytes_value(InternalType type, const Slice& value);
+
+  // Whether the values could be compared, i.e. they have the same type or one of them is null.
+  bool Comparable(const QLScalarValue& other) const {
+    return type_ == other.type_ || IsNull() || other.IsNull();
+  }
+
+  // Compares values of the same type, neither of them null. The order is the same as of
+  // Compare(const QLValuePB&, const QLValuePB&).
+  int CompareTo(const QLScalarValue& other) const;
+
+  void ToPB(QLValuePB* pb) const;
+
+  std::string ToString() const;
+
+ private:
+  // Capacity of the inline buffer for owned bytes. Longer bytes are stored in owned_.
+  static constexpr size_t kInlineCapacity = 23;
+
+  void SetInt(InternalType type, int64_t value) {
+    type_ = type;
+    int_ = value;
+  }
+
+  void CopyFrom(const QLScalarValue& other);
+
+  InternalType type_ = QLValuePB::VALUE_NOT_SET;
+  union {
+    int64_t int_;
+    float float_;
+    double double_;
+    bool bool_;
+  };
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  char inline_[kInlineCapacity];
+  std::string owned_;
+};
+
+// Comparisons with the same semantics as the ones of QLValuePB: nulls are only equal to each
+// other, and other comparisons with nulls are false.
+bool operator <(const QLScalarValue& lhs, const QLScalarValue& rhs);
+bool operator >(const QLScalarValue& lhs, const QLScalarValue& rhs);
+bool operator <=(const QLScalarValue& lhs, const QLScalarValue& rhs);
+bool operator >=(const QLScalarValue& lhs, const QLScalarValue& rhs);
+bool operator ==(const QLScalarValue& lhs, const QLScalarValue& rhs);
+bool operator !=(const QLScalarValue& lhs, const QLScalarValue& rhs);
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_SCALAR_VALUE_H
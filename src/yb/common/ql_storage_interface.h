@@ -46,6 +46,22 @@ class YQLStorageIf {
                                      const QLScanSpec& spec,
                                      std::unique_ptr<YQLRowwiseIteratorIf>* iter) const = 0;
 
+  // Same as GetIterator, but restricts a forward scan to rows with encoded keys in
+  // [lower_bound, upper_bound). An empty bound means no restriction.
+  virtual CHECKED_STATUS GetIteratorForKeyRange(
+      const QLReadRequestPB& request,
+      const Schema& projection,
+      const Schema& schema,
+      const TransactionOperationContextOpt& txn_op_context,
+      MonoTime deadline,
+      const ReadHybridTime& read_time,
+      const QLScanSpec& spec,
+      const Slice& lower_bound,
+      const Slice& upper_bound,
+      std::unique_ptr<YQLRowwiseIteratorIf>* iter) const {
+    return STATUS(NotSupported, "Key range scans are not supported");
+  }
+
   virtual CHECKED_STATUS BuildYQLScanSpec(const QLReadRequestPB& request,
                                           const ReadHybridTime& read_time,
                                           const Schema& schema,
@@ -83,6 +83,27 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   if (HasCopartitionTableId()) {
     pb->set_copartition_table_id(copartition_table_id_);
   }
+  if (bloom_filter_range_components_ != 0) {
+    pb->set_bloom_filter_range_components(bloom_filter_range_components_);
+  }
+  if (HasHistoryRetentionMinSec()) {
+    pb->set_history_retention_min_sec(history_retention_min_sec_);
+  }
+  if (HasHistoryRetentionMaxSec()) {
+    pb->set_history_retention_max_sec(history_retention_max_sec_);
+  }
+  if (mmap_reads_) {
+    pb->set_mmap_reads(mmap_reads_);
+  }
+  if (min_blob_value_size_ != 0) {
+    pb->set_min_blob_value_size(min_blob_value_size_);
+  }
+  if (compaction_time_window_sec_ != 0) {
+    pb->set_compaction_time_window_sec(compaction_time_window_sec_);
+  }
+  if (in_memory_) {
+    pb->set_in_memory(in_memory_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -102,6 +123,27 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_copartition_table_id()) {
     table_properties.SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_bloom_filter_range_components()) {
+    table_properties.SetBloomFilterRangeComponents(pb.bloom_filter_range_components());
+  }
+  if (pb.has_history_retention_min_sec()) {
+    table_properties.SetHistoryRetentionMinSec(pb.history_retention_min_sec());
+  }
+  if (pb.has_history_retention_max_sec()) {
+    table_properties.SetHistoryRetentionMaxSec(pb.history_retention_max_sec());
+  }
+  if (pb.has_mmap_reads()) {
+    table_properties.SetMmapReads(pb.mmap_reads());
+  }
+  if (pb.has_min_blob_value_size()) {
+    table_properties.SetMinBlobValueSize(pb.min_blob_value_size());
+  }
+  if (pb.has_compaction_time_window_sec()) {
+    table_properties.SetCompactionTimeWindowSec(pb.compaction_time_window_sec());
+  }
+  if (pb.has_in_memory()) {
+    table_properties.SetInMemory(pb.in_memory());
+  }
   return table_properties;
 }
 
@@ -118,6 +160,12 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_copartition_table_id()) {
     SetCopartitionTableId(pb.copartition_table_id());
   }
+  if (pb.has_history_retention_min_sec()) {
+    SetHistoryRetentionMinSec(pb.history_retention_min_sec());
+  }
+  if (pb.has_history_retention_max_sec()) {
+    SetHistoryRetentionMaxSec(pb.history_retention_max_sec());
+  }
 }
 
 void TableProperties::Reset() {
@@ -126,6 +174,13 @@ void TableProperties::Reset() {
   is_transactional_ = false;
   consistency_level_ = YBConsistencyLevel::STRONG;
   copartition_table_id_ = kNoCopartitionTableId;
+  bloom_filter_range_components_ = 0;
+  history_retention_min_sec_ = kNoHistoryRetentionBound;
+  history_retention_max_sec_ = kNoHistoryRetentionBound;
+  mmap_reads_ = false;
+  min_blob_value_size_ = 0;
+  compaction_time_window_sec_ = 0;
+  in_memory_ = false;
 }
 
 Schema::Schema(const Schema& other)
@@ -419,6 +419,70 @@ class TableProperties {
     copartition_table_id_ = copartition_table_id;
   }
 
+  uint32_t bloom_filter_range_components() const {
+    return bloom_filter_range_components_;
+  }
+
+  void SetBloomFilterRangeComponents(uint32_t bloom_filter_range_components) {
+    bloom_filter_range_components_ = bloom_filter_range_components;
+  }
+
+  bool HasHistoryRetentionMinSec() const {
+    return history_retention_min_sec_ != kNoHistoryRetentionBound;
+  }
+
+  int64_t history_retention_min_sec() const {
+    return history_retention_min_sec_;
+  }
+
+  void SetHistoryRetentionMinSec(int64_t history_retention_min_sec) {
+    history_retention_min_sec_ = history_retention_min_sec;
+  }
+
+  bool HasHistoryRetentionMaxSec() const {
+    return history_retention_max_sec_ != kNoHistoryRetentionBound;
+  }
+
+  int64_t history_retention_max_sec() const {
+    return history_retention_max_sec_;
+  }
+
+  void SetHistoryRetentionMaxSec(int64_t history_retention_max_sec) {
+    history_retention_max_sec_ = history_retention_max_sec;
+  }
+
+  bool mmap_reads() const {
+    return mmap_reads_;
+  }
+
+  void SetMmapReads(bool mmap_reads) {
+    mmap_reads_ = mmap_reads;
+  }
+
+  uint64_t min_blob_value_size() const {
+    return min_blob_value_size_;
+  }
+
+  void SetMinBlobValueSize(uint64_t min_blob_value_size) {
+    min_blob_value_size_ = min_blob_value_size;
+  }
+
+  uint64_t compaction_time_window_sec() const {
+    return compaction_time_window_sec_;
+  }
+
+  void SetCompactionTimeWindowSec(uint64_t compaction_time_window_sec) {
+    compaction_time_window_sec_ = compaction_time_window_sec;
+  }
+
+  bool in_memory() const {
+    return in_memory_;
+  }
+
+  void SetInMemory(bool in_memory) {
+    in_memory_ = in_memory;
+  }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -429,11 +493,19 @@ class TableProperties {
 
  private:
   static const int kNoDefaultTtl = -1;
+  static const int64_t kNoHistoryRetentionBound = -1;
   int64_t default_time_to_live_ = kNoDefaultTtl;
   bool contain_counters_ = false;
   bool is_transactional_ = false;
   YBConsistencyLevel consistency_level_ = YBConsistencyLevel::STRONG;
   TableId copartition_table_id_ = kNoCopartitionTableId;
+  uint32_t bloom_filter_range_components_ = 0;
+  int64_t history_retention_min_sec_ = kNoHistoryRetentionBound;
+  int64_t history_retention_max_sec_ = kNoHistoryRetentionBound;
+  bool mmap_reads_ = false;
+  uint64_t min_blob_value_size_ = 0;
+  uint64_t compaction_time_window_sec_ = 0;
+  bool in_memory_ = false;
 };
 
 // The schema for a set of rows.
@@ -625,6 +697,10 @@ class Schema {
     table_properties_.SetCopartitionTableId(copartition_table_id);
   }
 
+  void SetInMemory(bool in_memory) {
+    table_properties_.SetInMemory(in_memory);
+  }
+
   // Return the column index corresponding to the given column,
   // or kColumnNotFound if the column is not in this schema.
   int find_column(const GStringPiece col_name) const {
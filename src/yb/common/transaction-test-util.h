@@ -47,6 +47,9 @@ class TransactionStatusManagerMock : public TransactionStatusManager {
   void Cleanup(TransactionIdSet&& set) override {
   }
 
+  void WaitForTransactionsCompletion(MonoTime deadline) override {
+  }
+
   int64_t RegisterRequest() override {
     return 0;
   }
@@ -114,6 +114,10 @@ class TransactionStatusManager {
 
   virtual void Cleanup(TransactionIdSet&& set) = 0;
 
+  // Waits until some transaction is applied or cleaned up on this tablet, or until deadline.
+  // Used by conflict resolution to wait for conflicting transactions to complete.
+  virtual void WaitForTransactionsCompletion(MonoTime deadline) = 0;
+
  private:
   friend class RequestScope;
 
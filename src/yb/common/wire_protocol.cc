@@ -41,6 +41,7 @@
 #include "yb/gutil/strings/fastmem.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/sockaddr.h"
@@ -59,6 +60,12 @@ DEFINE_string(use_private_ip, "never",
                   "region and zone."
               "never - would never use private IP if broadcast address is specified.");
 
+DEFINE_bool(compress_cross_region_rpcs, true,
+            "Whether to compress internal RPCs, like Raft replication and remote bootstrap, "
+            "between nodes placed in different clouds or regions.");
+TAG_FLAG(compress_cross_region_rpcs, advanced);
+TAG_FLAG(compress_cross_region_rpcs, runtime);
+
 namespace yb {
 
 namespace {
@@ -408,6 +415,18 @@ bool UsePublicIp(const CloudInfoPB& connect_to,
   return mode != UsePrivateIpMode::zone;
 }
 
+bool ShouldCompressRpcs(const CloudInfoPB& connect_to, const CloudInfoPB& connect_from) {
+  if (!FLAGS_compress_cross_region_rpcs) {
+    return false;
+  }
+  // Placement of some nodes could be unknown, for instance in tests.
+  if (!connect_to.has_placement_cloud() || !connect_from.has_placement_cloud()) {
+    return false;
+  }
+  return connect_to.placement_cloud() != connect_from.placement_cloud() ||
+         connect_to.placement_region() != connect_from.placement_region();
+}
+
 const HostPortPB& DesiredHostPort(
     const google::protobuf::RepeatedPtrField<HostPortPB>& broadcast_addresses,
     const google::protobuf::RepeatedPtrField<HostPortPB>& private_host_ports,
@@ -130,6 +130,10 @@ YB_DEFINE_ENUM(UsePrivateIpMode, (cloud)(region)(zone)(never));
 // Returns mode for selecting between private and public IP.
 Result<UsePrivateIpMode> GetPrivateIpMode();
 
+// Whether internal RPCs from connect_from to connect_to should be compressed, i.e. nodes are placed
+// in different clouds or regions.
+bool ShouldCompressRpcs(const CloudInfoPB& connect_to, const CloudInfoPB& connect_from);
+
 // Pick host and port that should be used to connect node
 // broadcast_addresses - node public host ports
 // private_host_ports - node private host ports
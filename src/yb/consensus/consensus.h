@@ -184,6 +184,12 @@ class Consensus {
     return STATUS(NotSupported, "Not implemented.");
   }
 
+  // Steps down in favor of a peer that has caught up with the log, so the tablet does not stay
+  // without a leader for the election timeout, e.g. when this server is being shut down.
+  virtual CHECKED_STATUS TransferLeadership() {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Wait until the node has LEADER role.
   // Returns Status::TimedOut if the role is not LEADER within 'timeout'.
   virtual CHECKED_STATUS WaitUntilLeaderForTests(const MonoDelta& timeout) = 0;
@@ -21,6 +21,7 @@ namespace yb {
 namespace consensus {
 
 class Consensus;
+class MultiRaftManager;
 class PeerProxyFactory;
 class PeerMessageQueue;
 class ReplicaOperationFactory;
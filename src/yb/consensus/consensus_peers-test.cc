@@ -57,6 +57,8 @@ using namespace std::chrono_literals;
 
 METRIC_DECLARE_entity(tablet);
 
+DECLARE_int32(consensus_max_in_flight_update_requests);
+
 namespace yb {
 namespace consensus {
 
@@ -208,6 +210,29 @@ TEST_F(ConsensusPeersTest, TestRemotePeer) {
   CheckLastRemoteEntry(proxy, 2, 20);
 }
 
+// Tests that a remote peer catches up when requests are sent to it without waiting for responses
+// to the previous ones.
+TEST_F(ConsensusPeersTest, TestPipelinedRemotePeer) {
+  FLAGS_consensus_max_in_flight_update_requests = 4;
+
+  std::shared_ptr<Peer> remote_peer;
+  BOOST_SCOPE_EXIT(&remote_peer) {
+    remote_peer->Close();
+  } BOOST_SCOPE_EXIT_END
+
+  DelayablePeerProxy<NoOpTestPeerProxy>* proxy = NewRemotePeer(kFollowerUuid, &remote_peer);
+
+  // Negotiate with the peer first, so the following requests are pipelined.
+  ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kAlwaysSend));
+  for (int i = 1; i <= 20; ++i) {
+    AppendReplicateMessagesToQueue(message_queue_.get(), clock_, i, 1);
+    ASSERT_OK(remote_peer->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+  }
+
+  WaitForMajorityReplicatedIndex(20);
+  CheckLastRemoteEntry(proxy, 2, 20);
+}
+
 TEST_F(ConsensusPeersTest, TestLocalAppendAndRemotePeerDelay) {
   // Create a set of remote peers.
   std::shared_ptr<Peer> remote_peer1;
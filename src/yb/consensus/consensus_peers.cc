@@ -49,6 +49,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -72,6 +73,17 @@ DEFINE_int32(consensus_rpc_timeout_ms, 3000,
              "Timeout used for all consensus internal RPC communications.");
 TAG_FLAG(consensus_rpc_timeout_ms, advanced);
 
+DEFINE_bool(consensus_send_serialized_ops, true,
+            "Whether the leader serializes each replicate message once and sends the same bytes "
+            "to all followers, instead of serializing it for every UpdateConsensus RPC.");
+TAG_FLAG(consensus_send_serialized_ops, advanced);
+
+DEFINE_int32(consensus_max_in_flight_update_requests, 1,
+             "The maximum number of UpdateConsensus requests the leader sends to a follower "
+             "without waiting for their responses. Values above 1 pipeline replication to "
+             "followers with high round trip time.");
+TAG_FLAG(consensus_max_in_flight_update_requests, advanced);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -96,6 +108,29 @@ using rpc::PeriodicTimer;
 using rpc::RpcController;
 using strings::Substitute;
 
+struct Peer::UpdateRequest {
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+
+  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
+  // loaded these messages from the LogCache, in which case we are potentially sharing the same
+  // object as other peers. Since the PB request itself can't hold reference counts, this holds
+  // them.
+  ReplicateMsgs msg_refs;
+
+  rpc::RpcController controller;
+
+  PeerMessageQueue::SentLeaseExpirations sent_leases;
+
+  // Whether the response was received.
+  bool done = false;
+
+  ~UpdateRequest() {
+    // We don't own the ops (the queue does).
+    request.mutable_ops()->ExtractSubrange(0, request.ops_size(), /* elements */ nullptr);
+  }
+};
+
 Result<PeerPtr> Peer::NewRemotePeer(const RaftPeerPB& peer_pb,
                                     const string& tablet_id,
                                     const string& leader_uuid,
@@ -120,12 +155,16 @@ Peer::Peer(
       peer_pb_(peer_pb),
       proxy_(std::move(proxy)),
       queue_(queue),
+      last_sent_committed_index_(kMinimumOpIdIndex),
       raft_pool_token_(raft_pool_token),
       consensus_(consensus),
       messenger_(std::move(messenger)) {}
 
 void Peer::SetTermForTest(int term) {
-  response_.set_responder_term(term);
+  std::lock_guard<simple_spinlock> lock(peer_lock_);
+  for (auto& update_request : update_requests_) {
+    update_request->response.set_responder_term(term);
+  }
 }
 
 Status Peer::Init() {
@@ -149,7 +188,8 @@ Status Peer::Init() {
 
 Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   // If the peer is currently sending, return Status::OK().
-  // If there are new requests in the queue we'll get them on ProcessResponse().
+  // If there are new requests in the queue we'll get them after the current request is sent, or
+  // on DoProcessResponses().
   auto performing_lock = LockPerforming(std::try_to_lock);
   if (!performing_lock.owns_lock()) {
     return Status::OK();
@@ -180,6 +220,13 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
     if (failed_attempts_ > 0 && trigger_mode == RequestTriggerMode::kNonEmptyOnly) {
       return Status::OK();
     }
+
+    // Don't send more requests than allowed without waiting for their responses.
+    const size_t max_in_flight_requests = can_pipeline_requests_
+        ? std::max(FLAGS_consensus_max_in_flight_update_requests, 1) : 1;
+    if (update_requests_.size() >= max_in_flight_requests) {
+      return Status::OK();
+    }
   }
 
   auto status = raft_pool_token_->SubmitFunc(
@@ -204,12 +251,21 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   bool needs_remote_bootstrap = false;
   bool last_exchange_successful = false;
   RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
-  int64_t commit_index_before = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
-  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request_,
-      &replicate_msg_refs_, &needs_remote_bootstrap, &member_type, &last_exchange_successful);
-  int64_t commit_index_after = request_.has_committed_index() ?
-      request_.committed_index().index() : kMinimumOpIdIndex;
+  int64_t commit_index_before = last_sent_committed_index_;
+  const bool serialized_ops =
+      FLAGS_consensus_send_serialized_ops && proxy_->SendsSerializedRequests();
+  auto update_request = std::make_unique<UpdateRequest>();
+  auto& request = update_request->request;
+  // Taken before the queue sets the lease duration, so the expiration we rely on is not later than
+  // the one the follower uses.
+  const auto request_time = MonoTime::Now();
+  Status s = queue_->RequestForPeer(peer_pb_.permanent_uuid(), &request,
+      &update_request->msg_refs, &needs_remote_bootstrap, &member_type, &last_exchange_successful,
+      serialized_ops);
+  int64_t commit_index_after = request.has_committed_index() ?
+      request.committed_index().index() : kMinimumOpIdIndex;
+  last_sent_committed_index_ = commit_index_after;
+  can_pipeline_requests_ = last_exchange_successful;
 
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(INFO) << "Could not obtain request from queue for peer: " << s;
@@ -274,11 +330,12 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     }
   }
 
-  request_.set_tablet_id(tablet_id_);
-  request_.set_caller_uuid(leader_uuid_);
-  request_.set_dest_uuid(peer_pb_.permanent_uuid());
+  request.set_tablet_id(tablet_id_);
+  request.set_caller_uuid(leader_uuid_);
+  request.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops =
+      !update_request->msg_refs.empty() || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
@@ -292,12 +349,24 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
-  controller_.Reset();
+  update_request->sent_leases.leader_lease_expiration =
+      request_time + MonoDelta::FromMilliseconds(request.leader_lease_duration_ms());
+  update_request->sent_leases.ht_lease_expiration = request.ht_lease_expiration();
+
+  // The request is owned by update_requests_ until its response is handled, which could only
+  // happen after the callback is invoked.
+  auto* update_request_ptr = update_request.get();
+  update_requests_.push_back(std::move(update_request));
 
   processing_lock.unlock();
-  performing_lock.release();
-  proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, retain_self));
+  // Keep performing_lock while sending, so requests are sent in the order they were prepared.
+  proxy_->UpdateAsync(&update_request_ptr->request, trigger_mode, &update_request_ptr->response,
+                      &update_request_ptr->controller,
+                      std::bind(&Peer::ProcessResponse, retain_self, update_request_ptr));
+  performing_lock.unlock();
+
+  // Send the following ops without waiting for the response, if the window allows it.
+  s = SignalRequest(RequestTriggerMode::kNonEmptyOnly);
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -311,19 +380,60 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
   return lock;
 }
 
-void Peer::ProcessResponse() {
+void Peer::ProcessResponse(UpdateRequest* update_request) {
   // Note: This method runs on the reactor thread.
+  {
+    std::lock_guard<simple_spinlock> lock(peer_lock_);
+    update_request->done = true;
+  }
 
-  DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
+  // The queue's handling of the peer response may generate IO (reads against the WAL) and
+  // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
+  // our thread pool and not on the reactor thread.
+  Status s = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::DoProcessResponses, shared_from_this()));
+  if (PREDICT_FALSE(!s.ok())) {
+    LOG_WITH_PREFIX(WARNING) << "Unable to process peer response: " << s
+                             << ": " << update_request->response.ShortDebugString();
+  }
+}
 
-  auto performing_lock = LockPerforming(std::adopt_lock);
-  auto processing_lock = StartProcessingUnlocked();
-  if (!processing_lock.owns_lock()) {
-    return;
+void Peer::DoProcessResponses() {
+  auto retain_self = shared_from_this();
+  std::lock_guard<std::mutex> responses_lock(responses_mutex_);
+
+  bool more_pending = false;
+  bool handled_any = false;
+  for (;;) {
+    std::unique_ptr<UpdateRequest> update_request;
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
+    // Responses that were received before the responses to the earlier requests wait for them.
+    if (update_requests_.empty() || !update_requests_.front()->done) {
+      break;
+    }
+    update_request = std::move(update_requests_.front());
+    update_requests_.pop_front();
+    more_pending = HandleResponseUnlocked(*update_request);
+    handled_any = true;
   }
 
-  if (!controller_.status().ok()) {
-    if (controller_.status().IsRemoteError()) {
+  if (handled_any && more_pending) {
+    Status s = SignalRequest(RequestTriggerMode::kAlwaysSend);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG_WITH_PREFIX(WARNING) << "Unexpected error when trying to send request: " << s;
+    }
+  }
+}
+
+bool Peer::HandleResponseUnlocked(const UpdateRequest& update_request) {
+  const auto& controller = update_request.controller;
+  const auto& response = update_request.response;
+
+  if (!controller.status().ok()) {
+    if (controller.status().IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
       // failure to serialize a protobuf. Therefore, we generally consider these errors to indicate
       // an unreachable peer.  However, a RemoteError wraps some other error propagated from the
@@ -331,74 +441,48 @@ void Peer::ProcessResponse() {
       // remote is responsive.
       queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
     }
-    ProcessResponseError(controller_.status());
-    return;
+    ProcessResponseError(controller.status());
+    return false;
   }
 
   // We should try to evict a follower which returns a WRONG UUID error.
-  if (response_.has_error() &&
-      response_.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
+  if (response.has_error() &&
+      response.error().code() == tserver::TabletServerErrorPB::WRONG_SERVER_UUID) {
     queue_->NotifyObserversOfFailedFollower(
         peer_pb_.permanent_uuid(),
         Substitute("Leader communication with peer $0 received error $1, will try to "
                    "evict peer", peer_pb_.permanent_uuid(),
-                   response_.error().ShortDebugString()));
-    ProcessResponseError(StatusFromPB(response_.error().status()));
-    return;
+                   response.error().ShortDebugString()));
+    ProcessResponseError(StatusFromPB(response.error().status()));
+    return false;
   }
 
   // Pass through errors we can respond to, like not found, since in that case
   // we will need to remotely bootstrap. TODO: Handle DELETED response once implemented.
-  if ((response_.has_error() &&
-      response_.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
-      (response_.status().has_error() &&
-          response_.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
+  if ((response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) ||
+      (response.status().has_error() &&
+          response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE)) {
     // Again, let the queue know that the remote is still responsive, since we will not be sending
     // this error response through to the queue.
     queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
-    ProcessResponseError(StatusFromPB(response_.error().status()));
-    return;
-  }
-
-  processing_lock.unlock();
-  // The queue's handling of the peer response may generate IO (reads against the WAL) and
-  // SendNextRequest() may do the same thing. So we run the rest of the response handling logic on
-  // our thread pool and not on the reactor thread.
-  Status s = raft_pool_token_->SubmitFunc(std::bind(&Peer::DoProcessResponse, shared_from_this()));
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG_WITH_PREFIX(WARNING) << "Unable to process peer response: " << s
-                             << ": " << response_.ShortDebugString();
-  } else {
-    performing_lock.release();
-  }
-}
-
-void Peer::DoProcessResponse() {
-  auto retain_self = shared_from_this();
-  DCHECK(performing_mutex_.is_locked());
-  auto performing_lock = LockPerforming(std::adopt_lock);
-  auto processing_lock = StartProcessingUnlocked();
-  if (!processing_lock.owns_lock()) {
-    return;
+    ProcessResponseError(StatusFromPB(response.error().status()));
+    return false;
   }
 
   failed_attempts_ = 0;
   bool more_pending = false;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
-
-  if (more_pending) {
-    processing_lock.unlock();
-    performing_lock.release();
-    SendNextRequest(RequestTriggerMode::kAlwaysSend);
-  }
+  queue_->ResponseFromPeer(
+      peer_pb_.permanent_uuid(), response, &more_pending, &update_request.sent_leases);
+  return more_pending;
 }
 
 Status Peer::SendRemoteBootstrapRequest() {
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(INFO, 30) << "Sending request to remotely bootstrap";
-  controller_.Reset();
+  rb_controller_.Reset();
   return raft_pool_token_->SubmitFunc([retain_self = shared_from_this()]() {
     retain_self->proxy_->StartRemoteBootstrap(
-      &retain_self->rb_request_, &retain_self->rb_response_, &retain_self->controller_,
+      &retain_self->rb_request_, &retain_self->rb_response_, &retain_self->rb_controller_,
       std::bind(&Peer::ProcessRemoteBootstrapResponse, retain_self));
   });
 }
@@ -423,7 +507,7 @@ void Peer::ProcessRemoteBootstrapResponse() {
 }
 
 void Peer::ProcessResponseError(const Status& status) {
-  DCHECK(performing_mutex_.is_locked());
+  DCHECK(peer_lock_.is_locked());
   failed_attempts_++;
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Couldn't send request. "
       << " Status: " << status.ToString() << ". Retrying in the next heartbeat period."
@@ -468,18 +552,18 @@ Peer::~Peer() {
     std::lock_guard<simple_spinlock> processing_lock(peer_lock_);
     CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
   }
-
-  // We don't own the ops (the queue does).
-  request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), /* elements */ nullptr);
 }
 
 void Peer::ReleaseResourcesUnlocked() {
-  replicate_msg_refs_.clear();
+  // Requests in flight are released once their responses are received.
   LOG_WITH_PREFIX(INFO) << "Closed peer";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher,
+                           bool compress)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      heartbeat_batcher_(std::move(heartbeat_batcher)), compress_(compress) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -487,7 +571,14 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                ConsensusResponsePB* response,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
+  // Only heartbeats without ops are batched, since the batch is sent with a delay.
+  if (heartbeat_batcher_ && trigger_mode == RequestTriggerMode::kAlwaysSend &&
+      request->ops_size() == 0 && request->unknown_fields().field_count() == 0) {
+    heartbeat_batcher_->AddRequestToBatch(request, response, controller, callback);
+    return;
+  }
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  controller->set_enable_compression(compress_);
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
@@ -523,13 +614,19 @@ void RpcPeerProxy::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* req
 RpcPeerProxy::~RpcPeerProxy() {}
 
 RpcPeerProxyFactory::RpcPeerProxyFactory(
-    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from)
-    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)) {}
+    shared_ptr<Messenger> messenger, rpc::ProxyCache* proxy_cache, CloudInfoPB from,
+    MultiRaftManager* multi_raft_manager)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache), from_(std::move(from)),
+      multi_raft_manager_(multi_raft_manager) {}
 
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  auto heartbeat_batcher =
+      multi_raft_manager_ ? multi_raft_manager_->AddOrGetBatcher(hostport) : nullptr;
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(heartbeat_batcher),
+      ShouldCompressRpcs(peer_pb.cloud_info(), from_));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
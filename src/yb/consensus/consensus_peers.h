@@ -33,7 +33,9 @@
 #ifndef YB_CONSENSUS_CONSENSUS_PEERS_H_
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <atomic>
@@ -118,6 +120,8 @@ namespace consensus {
 //        v                               v
 //  SignalRequest()                    return
 //
+class MultiRaftHeartbeatBatcher;
+class MultiRaftManager;
 class Peer;
 typedef std::shared_ptr<Peer> PeerPtr;
 
@@ -177,15 +181,22 @@ class Peer : public std::enable_shared_from_this<Peer> {
   }
 
  private:
+  struct UpdateRequest;
+
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
-  // Signals that a response was received from the peer.  This method is called from the reactor
-  // thread and calls DoProcessResponse() on raft_pool_token_ to do any work that requires IO or
-  // lock-taking.
-  void ProcessResponse();
+  // Signals that a response to 'update_request' was received from the peer.  This method is called
+  // from the reactor thread and calls DoProcessResponses() on raft_pool_token_ to do any work that
+  // requires IO or lock-taking.
+  void ProcessResponse(UpdateRequest* update_request);
+
+  // Run on 'raft_pool_token'. Handles received responses in the order the requests were sent,
+  // which requires IO or may block.
+  void DoProcessResponses();
 
-  // Run on 'raft_pool_token'. Does response handling that requires IO or may block.
-  void DoProcessResponse();
+  // Handles the response to 'update_request', returns whether the peer has more requests pending.
+  // Should be called with peer_lock_ held.
+  bool HandleResponseUnlocked(const UpdateRequest& update_request);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -224,24 +235,29 @@ class Peer : public std::enable_shared_from_this<Peer> {
   PeerMessageQueue* queue_;
   uint64_t failed_attempts_ = 0;
 
-  // The latest consensus update request and response.
-  ConsensusRequestPB request_;
-  ConsensusResponsePB response_;
+  // Consensus update requests that were sent to the peer and whose responses were not handled yet,
+  // in the order they were sent. Protected by peer_lock_.
+  std::deque<std::unique_ptr<UpdateRequest>> update_requests_;
+
+  // The committed index sent with the latest consensus update request.
+  int64_t last_sent_committed_index_;
+
+  // Whether the last exchange with this peer was successful, so the following requests could be
+  // sent before the responses to the previous ones are received.
+  bool can_pipeline_requests_ = false;
+
+  // Held while responses are handled, so they are handled in order.
+  std::mutex responses_mutex_;
 
   // The latest remote bootstrap request and response.
   StartRemoteBootstrapRequestPB rb_request_;
   StartRemoteBootstrapResponsePB rb_response_;
 
-  // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
-  // loaded these messages from the LogCache, in which case we are potentially sharing the same
-  // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
-  // them.
-  ReplicateMsgs replicate_msg_refs_;
-
-  rpc::RpcController controller_;
+  rpc::RpcController rb_controller_;
 
-  // Held if there is an outstanding request.  This is used in order to ensure that we only have a
-  // single request outstanding at a time, and to wait for the outstanding requests at Close().
+  // Held while a request is prepared and sent, or if there is an outstanding remote bootstrap
+  // request.  This is used in order to ensure that requests are sent in order, and to wait for the
+  // outstanding requests at Close().
   AtomicTryMutex performing_mutex_;
 
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
@@ -307,6 +323,10 @@ class PeerProxy {
     LOG(DFATAL) << "Not implemented";
   }
 
+  // Returns true if requests passed to UpdateAsync are only serialized and sent over the wire, so
+  // replicate messages could be added to them in the serialized form.
+  virtual bool SendsSerializedRequests() const { return false; }
+
   virtual ~PeerProxy() {}
 };
 
@@ -328,7 +348,11 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  // Heartbeats are sent via 'heartbeat_batcher' if it is not null.
+  // Replication requests are compressed if 'compress' is true, see ShouldCompressRpcs().
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher = nullptr,
+               bool compress = false);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -356,18 +380,24 @@ class RpcPeerProxy : public PeerProxy {
                                        rpc::RpcController* controller,
                                        const rpc::ResponseCallback& callback) override;
 
+  bool SendsSerializedRequests() const override { return true; }
+
   virtual ~RpcPeerProxy();
 
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher_;
+  const bool compress_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
 class RpcPeerProxyFactory : public PeerProxyFactory {
  public:
+  // 'multi_raft_manager' is optional, heartbeats are batched with the ones of other tablets when it
+  // is specified.
   RpcPeerProxyFactory(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache,
-                      CloudInfoPB from);
+                      CloudInfoPB from, MultiRaftManager* multi_raft_manager = nullptr);
 
   PeerProxyPtr NewProxy(const RaftPeerPB& peer_pb) override;
 
@@ -379,6 +409,7 @@ class RpcPeerProxyFactory : public PeerProxyFactory {
   std::shared_ptr<rpc::Messenger> messenger_;
   rpc::ProxyCache* const proxy_cache_;
   const CloudInfoPB from_;
+  MultiRaftManager* const multi_raft_manager_;
 };
 
 // Query the consensus service at last known host/port that is specified in 'remote_peer' and set
@@ -54,6 +54,9 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_bool(consensus_adaptive_batch_size);
+DECLARE_int32(consensus_batch_target_latency_ms);
+DECLARE_bool(remote_bootstrap_from_closest_peer);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -264,6 +267,82 @@ TEST_F(ConsensusQueueTest, TestStartTrackingAfterStart) {
   request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
 }
 
+// Tests that a request with serialized ops is parsed by the follower as a regular request.
+// Tests that the batch size target of a peer is decreased when batches are acknowledged too slowly,
+// and is kept when the peer does not lag behind.
+TEST_F(ConsensusQueueTest, TestAdaptiveBatchSize) {
+  FLAGS_consensus_adaptive_batch_size = true;
+  // Every acknowledgement is too slow.
+  FLAGS_consensus_batch_target_latency_ms = -1;
+
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  UpdatePeerWatermarkToOp(&request, &response, MakeOpId(7, 50), MinimumOpId(), &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(50, request.ops_size());
+  SetLastReceivedAndLastCommitted(&response, request.ops(49).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_EQ(FLAGS_consensus_max_batch_size_bytes / 2,
+            queue_->GetTrackedPeerForTests(kPeerUuid).batch_size_target_bytes);
+
+  // A batch that was not full is not a reason to grow the target.
+  FLAGS_consensus_batch_target_latency_ms = 3600 * 1000;
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 101, 10);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(10, request.ops_size());
+  SetLastReceivedAndLastCommitted(&response, request.ops(9).id());
+  queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  ASSERT_EQ(FLAGS_consensus_max_batch_size_bytes / 2,
+            queue_->GetTrackedPeerForTests(kPeerUuid).batch_size_target_bytes);
+
+  // Extract the ops from the request to avoid double free.
+  request.mutable_ops()->ExtractSubrange(0, request.ops_size(), nullptr);
+}
+
+TEST_F(ConsensusQueueTest, TestSerializedOps) {
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+  UpdatePeerWatermarkToOp(&request, &response, MakeOpId(7, 50), MinimumOpId(), &more_pending);
+  ASSERT_TRUE(more_pending);
+
+  for (int i = 0; i != 2; ++i) {
+    ReplicateMsgs refs;
+    bool needs_remote_bootstrap;
+    ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap,
+                                     nullptr /* member_type */,
+                                     nullptr /* last_exchange_successful */,
+                                     true /* serialized_ops */));
+    ASSERT_FALSE(needs_remote_bootstrap);
+    ASSERT_EQ(0, request.ops_size());
+    ASSERT_EQ(50, refs.size());
+
+    ConsensusRequestPB received;
+    ASSERT_TRUE(received.ParseFromString(request.SerializeAsString()));
+    ASSERT_EQ(refs.size(), received.ops_size());
+    for (size_t j = 0; j != refs.size(); ++j) {
+      ASSERT_EQ(refs[j]->SerializeAsString(), received.ops(j).SerializeAsString());
+    }
+    ASSERT_EQ(request.preceding_id().ShortDebugString(),
+              received.preceding_id().ShortDebugString());
+  }
+}
+
 // Tests that the peers gets the messages pages, with the size of a page being
 // 'consensus_max_batch_size_bytes'
 TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
@@ -863,5 +942,57 @@ TEST_F(ConsensusQueueTest, TestTriggerRemoteBootstrapIfTabletNotFound) {
             rb_req.source_private_addr()[0].ShortDebugString());
 }
 
+// Test that a caught up follower in the same zone as the new peer is picked as the remote
+// bootstrap source instead of the leader.
+TEST_F(ConsensusQueueTest, TestRemoteBootstrapFromClosestPeer) {
+  FLAGS_remote_bootstrap_from_closest_peer = true;
+  static const char* kNewPeerUuid = "peer-2";
+
+  RaftConfigPB config = BuildRaftConfigPBForTests(3);
+  for (int i = 1; i < config.peers_size(); ++i) {
+    CloudInfoPB* cloud_info = config.mutable_peers(i)->mutable_cloud_info();
+    cloud_info->set_placement_cloud("cloud");
+    cloud_info->set_placement_region("region");
+    cloud_info->set_placement_zone("remote-zone");
+  }
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), config);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100);
+
+  ConsensusRequestPB request;
+  ReplicateMsgs refs;
+  bool needs_remote_bootstrap;
+  bool more_pending = false;
+
+  // The first follower acknowledges all the operations.
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  queue_->TrackPeer(kPeerUuid);
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  SetLastReceivedAndLastCommitted(&response, MakeOpId(14, 100));
+  queue_->ResponseFromPeer(kPeerUuid, response, &more_pending);
+
+  // The second follower does not have the tablet.
+  response.Clear();
+  response.set_responder_uuid(kNewPeerUuid);
+  queue_->TrackPeer(kNewPeerUuid);
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kNewPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  response.mutable_error()->set_code(tserver::TabletServerErrorPB::TABLET_NOT_FOUND);
+  StatusToPB(STATUS(NotFound, "No such tablet"), response.mutable_error()->mutable_status());
+  queue_->ResponseFromPeer(kNewPeerUuid, response, &more_pending);
+
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kNewPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(needs_remote_bootstrap);
+
+  StartRemoteBootstrapRequestPB rb_req;
+  ASSERT_OK(queue_->GetRemoteBootstrapRequestForPeer(kNewPeerUuid, &rb_req));
+  ASSERT_EQ(kPeerUuid, rb_req.bootstrap_peer_uuid());
+  ASSERT_EQ(config.peers(1).last_known_private_addr(0).ShortDebugString(),
+            rb_req.source_private_addr(0).ShortDebugString());
+  ASSERT_EQ("remote-zone", rb_req.source_cloud_info().placement_zone());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -41,6 +41,7 @@
 #include <boost/container/small_vector.hpp>
 
 #include <gflags/gflags.h>
+#include <google/protobuf/unknown_field_set.h>
 
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/log.h"
@@ -68,6 +69,7 @@
 #include "yb/util/enums.h"
 #include "yb/util/tostring.h"
 
+using yb::operator"" _KB;
 using yb::operator"" _MB;
 
 DECLARE_int32(rpc_max_message_size);
@@ -96,6 +98,32 @@ DECLARE_int32(rpc_max_message_size);
 
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
+DEFINE_bool(consensus_adaptive_batch_size, false,
+            "Adjust the size of batches of ops sent to each peer using the measured latency of "
+            "its acknowledgements, between consensus_min_batch_size_bytes and "
+            "consensus_max_batch_size_bytes.");
+TAG_FLAG(consensus_adaptive_batch_size, advanced);
+TAG_FLAG(consensus_adaptive_batch_size, runtime);
+
+DEFINE_int32(consensus_min_batch_size_bytes, 64_KB,
+             "The minimal batch size target when consensus_adaptive_batch_size is set.");
+TAG_FLAG(consensus_min_batch_size_bytes, advanced);
+
+DEFINE_int32(consensus_batch_target_latency_ms, 50,
+             "The acknowledgement latency of a batch of ops, above which the batch size target of "
+             "the peer is decreased, and below which it is increased while the peer lags behind.");
+TAG_FLAG(consensus_batch_target_latency_ms, advanced);
+TAG_FLAG(consensus_batch_target_latency_ms, runtime);
+
+DEFINE_bool(remote_bootstrap_from_closest_peer, false,
+            "When set, the leader lets a caught up follower that is placed closer to the peer "
+            "being bootstrapped (same zone, then same region) act as the remote bootstrap source. "
+            "Otherwise the leader always bootstraps new peers itself.");
+TAG_FLAG(remote_bootstrap_from_closest_peer, advanced);
+TAG_FLAG(remote_bootstrap_from_closest_peer, runtime);
+
+DECLARE_int32(consensus_max_in_flight_update_requests);
+
 namespace yb {
 namespace consensus {
 
@@ -113,6 +141,17 @@ METRIC_DEFINE_gauge_int64(tablet, in_progress_ops, "Leader Operations in Progres
                           MetricUnit::kOperations,
                           "Number of operations in the leader queue ack'd by a minority of "
                           "peers.");
+METRIC_DEFINE_histogram(tablet, raft_batch_ack_latency, "Raft Batch Ack Latency",
+                        MetricUnit::kMicroseconds,
+                        "Microseconds from sending a batch of ops to a peer till it is "
+                        "acknowledged.",
+                        60000000LU, 2);
+METRIC_DEFINE_counter(tablet, raft_batch_size_increases, "Raft Batch Size Increases",
+                      MetricUnit::kUnits,
+                      "Number of times the batch size target of a peer was increased.");
+METRIC_DEFINE_counter(tablet, raft_batch_size_decreases, "Raft Batch Size Decreases",
+                      MetricUnit::kUnits,
+                      "Number of times the batch size target of a peer was decreased.");
 
 std::string PeerMessageQueue::TrackedPeer::ToString() const {
   return Substitute("Peer: $0, Is new: $1, Last received: $2, Next index: $3, "
@@ -128,7 +167,10 @@ std::string PeerMessageQueue::TrackedPeer::ToString() const {
   x.Instantiate(metric_entity, 0)
 PeerMessageQueue::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : num_majority_done_ops(INSTANTIATE_METRIC(METRIC_majority_done_ops)),
-    num_in_progress_ops(INSTANTIATE_METRIC(METRIC_in_progress_ops)) {
+    num_in_progress_ops(INSTANTIATE_METRIC(METRIC_in_progress_ops)),
+    batch_ack_latency(METRIC_raft_batch_ack_latency.Instantiate(metric_entity)),
+    batch_size_increases(METRIC_raft_batch_size_increases.Instantiate(metric_entity)),
+    batch_size_decreases(METRIC_raft_batch_size_decreases.Instantiate(metric_entity)) {
 }
 #undef INSTANTIATE_METRIC
 
@@ -138,13 +180,15 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
                                    const RaftPeerPB& local_peer_pb,
                                    const string& tablet_id,
                                    const server::ClockPtr& clock,
-                                   unique_ptr<ThreadPoolToken> raft_pool_token)
+                                   unique_ptr<ThreadPoolToken> raft_pool_token,
+                                   unique_ptr<ThreadPoolToken> log_cache_prefetch_token)
     : raft_pool_observers_token_(std::move(raft_pool_token)),
       local_peer_pb_(local_peer_pb),
       local_peer_uuid_(local_peer_pb_.has_permanent_uuid() ? local_peer_pb_.permanent_uuid()
                                                            : string()),
       tablet_id_(tablet_id),
-      log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id),
+      log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id,
+                 std::move(log_cache_prefetch_token)),
       metrics_(metric_entity),
       clock_(clock) {
   DCHECK(local_peer_pb_.has_permanent_uuid());
@@ -326,11 +370,13 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgs* msg_refs,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        bool serialized_ops) {
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
   bool is_new;
   int64_t next_index;
+  int64_t batch_size_target;
   HybridTime propagated_safe_time;
   {
     LockGuard lock(queue_lock_);
@@ -360,6 +406,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
     // Clear the requests without deleting the entries, as they may be in use by other peers.
     request->mutable_ops()->ExtractSubrange(0, request->ops_size(), /* elements */ nullptr);
+    request->mutable_unknown_fields()->Clear();
+    msg_refs->clear();
 
     // This is initialized to the queue's last appended op but gets set to the id of the
     // log entry preceding the first one in 'messages' if messages are found for the peer.
@@ -373,6 +421,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
     is_new = peer->is_new;
     next_index = peer->next_index;
+    batch_size_target = BatchSizeTargetUnlocked(*peer);
   }
 
   if (unreachable_time.ToSeconds() > FLAGS_follower_unavailable_considered_failed_sec) {
@@ -403,7 +452,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     DCHECK_LT(FLAGS_consensus_max_batch_size_bytes + 1_KB, FLAGS_rpc_max_message_size);
     // The batch of messages to send to the peer.
     ReplicateMsgs messages;
-    int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
+    std::vector<RefCntBuffer> serialized_messages;
+    int max_batch_size = batch_size_target - request->ByteSize();
     bool have_more_messages = false;
 
     // We try to get the follower's next_index from our log.
@@ -411,7 +461,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                   max_batch_size,
                                   &messages,
                                   &preceding_id,
-                                  &have_more_messages);
+                                  &have_more_messages,
+                                  serialized_ops ? &serialized_messages : nullptr);
     if (PREDICT_FALSE(!s.ok())) {
       if (PREDICT_TRUE(s.IsNotFound())) {
         // It's normal to have a NotFound() here if a follower falls behind where the leader has
@@ -440,8 +491,18 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
     // point. At some point we may want to allow partially loading (and not pinning) earlier
     // messages. At that point we'll need to do something smarter here, like copy or ref-count.
-    for (const auto& msg : messages) {
-      request->mutable_ops()->AddAllocated(msg.get());
+    if (serialized_ops) {
+      // A length-delimited unknown field with the number of ops is serialized exactly as an
+      // element of ops, so the follower parses it as usual, while we only copy the bytes.
+      auto* unknown_fields = request->mutable_unknown_fields();
+      for (const auto& serialized_msg : serialized_messages) {
+        unknown_fields->AddLengthDelimited(ConsensusRequestPB::kOpsFieldNumber)->assign(
+            serialized_msg.data(), serialized_msg.size());
+      }
+    } else {
+      for (const auto& msg : messages) {
+        request->mutable_ops()->AddAllocated(msg.get());
+      }
     }
     if (propagated_safe_time && !have_more_messages) {
       // Get the current local safe time on the leader and propagate it to the follower.
@@ -451,17 +512,38 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
     msg_refs->swap(messages);
     DCHECK_LE(request->ByteSize(), FLAGS_consensus_max_batch_size_bytes);
+
+    if (GetAtomicFlag(&FLAGS_consensus_adaptive_batch_size) && !msg_refs->empty()) {
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (peer && peer->measured_batch.last_index == kInvalidOpIdIndex) {
+        peer->measured_batch.last_index = msg_refs->back()->id().index();
+        peer->measured_batch.full = have_more_messages;
+        peer->measured_batch.send_time = MonoTime::Now();
+      }
+    }
+
+    if (FLAGS_consensus_max_in_flight_update_requests > 1 && !msg_refs->empty()) {
+      // The following request could be sent before the response to this one is received, so
+      // optimistically advance next_index past the ops of this request. If they are not received,
+      // the peer will respond with an LMP mismatch and next_index will be moved back.
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (peer && peer->is_last_exchange_successful && peer->next_index == next_index) {
+        peer->next_index = msg_refs->back()->id().index() + 1;
+      }
+    }
   }
 
   DCHECK(preceding_id.IsInitialized());
   request->mutable_preceding_id()->CopyFrom(preceding_id);
 
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
-    if (request->ops_size() > 0) {
+    if (!msg_refs->empty()) {
       VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending request with operations to Peer: " << uuid
-          << ". Size: " << request->ops_size()
-          << ". From: " << request->ops(0).id().ShortDebugString() << ". To: "
-          << request->ops(request->ops_size() - 1).id().ShortDebugString();
+          << ". Size: " << msg_refs->size()
+          << ". From: " << msg_refs->front()->id().ShortDebugString() << ". To: "
+          << msg_refs->back()->id().ShortDebugString();
     } else {
       VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending status only request to Peer: " << uuid
           << ": " << request->DebugString();
@@ -474,6 +556,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
+  RaftPeerPB source_pb = local_peer_pb_;
   {
     LockGuard lock(queue_lock_);
     DCHECK_EQ(queue_state_.state, State::kQueueOpen);
@@ -482,6 +565,9 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     if (PREDICT_FALSE(peer == nullptr || queue_state_.mode == Mode::NON_LEADER)) {
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
+    if (FLAGS_remote_bootstrap_from_closest_peer) {
+      SelectRemoteBootstrapSourceUnlocked(uuid, &source_pb);
+    }
   }
 
   if (PREDICT_FALSE(!peer->needs_remote_bootstrap)) {
@@ -496,15 +582,83 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
   req->Clear();
   req->set_dest_uuid(uuid);
   req->set_tablet_id(tablet_id_);
-  req->set_bootstrap_peer_uuid(local_peer_uuid_);
-  *req->mutable_source_private_addr() = local_peer_pb_.last_known_private_addr();
-  *req->mutable_source_broadcast_addr() = local_peer_pb_.last_known_broadcast_addr();
-  *req->mutable_source_cloud_info() = local_peer_pb_.cloud_info();
+  req->set_bootstrap_peer_uuid(source_pb.permanent_uuid());
+  *req->mutable_source_private_addr() = source_pb.last_known_private_addr();
+  *req->mutable_source_broadcast_addr() = source_pb.last_known_broadcast_addr();
+  *req->mutable_source_cloud_info() = source_pb.cloud_info();
   req->set_caller_term(queue_state_.current_term);
   peer->needs_remote_bootstrap = false; // Now reset the flag.
   return Status::OK();
 }
 
+namespace {
+
+// Returns 2 if both cloud infos are in the same zone, 1 if they are only in the same region and 0
+// otherwise.
+int PlacementProximity(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  if (!lhs.has_placement_region() || lhs.placement_cloud() != rhs.placement_cloud() ||
+      lhs.placement_region() != rhs.placement_region()) {
+    return 0;
+  }
+  return lhs.has_placement_zone() && lhs.placement_zone() == rhs.placement_zone() ? 2 : 1;
+}
+
+} // namespace
+
+void PeerMessageQueue::SelectRemoteBootstrapSourceUnlocked(
+    const std::string& uuid, RaftPeerPB* source_pb) {
+  DCHECK(queue_lock_.is_locked());
+  if (!queue_state_.active_config) {
+    return;
+  }
+
+  const RaftPeerPB* target_pb = nullptr;
+  for (const RaftPeerPB& peer_pb : queue_state_.active_config->peers()) {
+    if (peer_pb.permanent_uuid() == uuid) {
+      target_pb = &peer_pb;
+      break;
+    }
+  }
+  if (target_pb == nullptr || !target_pb->has_cloud_info()) {
+    return;
+  }
+
+  // The leader remains the source unless a follower is strictly closer to the target. Among
+  // equally close followers prefer the one that has received the most operations.
+  int best_proximity = PlacementProximity(target_pb->cloud_info(), local_peer_pb_.cloud_info());
+  const RaftPeerPB* best_pb = nullptr;
+  int64_t best_index = 0;
+  for (const RaftPeerPB& peer_pb : queue_state_.active_config->peers()) {
+    const std::string& peer_uuid = peer_pb.permanent_uuid();
+    if (peer_uuid == uuid || peer_uuid == local_peer_uuid_ ||
+        peer_pb.member_type() != RaftPeerPB::VOTER) {
+      continue;
+    }
+    const TrackedPeer* candidate = FindPtrOrNull(peers_map_, peer_uuid);
+    // Only use followers that are reachable and caught up to the majority replicated op, so the
+    // new peer can continue replicating from the leader's log once the bootstrap is done.
+    if (candidate == nullptr || !candidate->is_last_exchange_successful ||
+        candidate->needs_remote_bootstrap ||
+        candidate->last_received.index() < queue_state_.majority_replicated_opid.index()) {
+      continue;
+    }
+    const int proximity = PlacementProximity(target_pb->cloud_info(), peer_pb.cloud_info());
+    if (proximity > best_proximity ||
+        (best_pb != nullptr && proximity == best_proximity &&
+         candidate->last_received.index() > best_index)) {
+      best_proximity = proximity;
+      best_pb = &peer_pb;
+      best_index = candidate->last_received.index();
+    }
+  }
+
+  if (best_pb != nullptr) {
+    LOG_WITH_PREFIX_UNLOCKED(INFO) << "Using follower " << best_pb->permanent_uuid()
+                                   << " as the remote bootstrap source for peer " << uuid;
+    *source_pb = *best_pb;
+  }
+}
+
 void PeerMessageQueue::UpdateAllReplicatedOpId(OpId* result) {
   OpId new_op_id = MaximumOpId();
 
@@ -708,7 +862,8 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
 
 void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const ConsensusResponsePB& response,
-                                        bool* more_pending) {
+                                        bool* more_pending,
+                                        const SentLeaseExpirations* sent_leases) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -785,10 +940,18 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     // we've never successfully sent them anything, start after the last-committed op in their log,
     // which is guaranteed by the Raft protocol to be a valid op.
 
+    // When requests are pipelined, next_index could be already advanced past the ops that are
+    // still in flight, so we keep it while the peer accepts our ops.
+    const bool pipelined =
+        FLAGS_consensus_max_in_flight_update_requests > 1 && !status.has_error();
+    const int64_t pipelined_next_index = pipelined ? previous.next_index : kInvalidOpIdIndex;
+
     bool peer_has_prefix_of_log = IsOpInLog(status.last_received());
     if (peer_has_prefix_of_log) {
       // If the latest thing in their log is in our log, we are in sync.
-      peer->last_received = status.last_received();
+      if (!pipelined || previous.last_received.index() <= status.last_received().index()) {
+        peer->last_received = status.last_received();
+      }
       peer->next_index = peer->last_received.index() + 1;
 
     } else if (!OpIdEquals(status.last_received_current_leader(), MinimumOpId())) {
@@ -808,8 +971,11 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       peer->next_index = peer->last_known_committed_idx + 1;
     }
 
+    peer->next_index = std::max(peer->next_index, pipelined_next_index);
+
     if (PREDICT_FALSE(status.has_error())) {
       peer->is_last_exchange_successful = false;
+      peer->measured_batch = TrackedPeer::MeasuredBatch();
       switch (status.error().code()) {
         case ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH: {
           DCHECK(status.has_last_received());
@@ -841,6 +1007,11 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     peer->is_last_exchange_successful = true;
 
+    if (peer->measured_batch.last_index != kInvalidOpIdIndex &&
+        peer->last_received.index() >= peer->measured_batch.last_index) {
+      AdjustBatchSizeUnlocked(peer);
+    }
+
     if (response.has_responder_term()) {
       // The peer must have responded with a term that is greater than or equal to the last known
       // term for that peer.
@@ -874,10 +1045,12 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
       peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+          sent_leases ? sent_leases->leader_lease_expiration
+                      : peer->last_leader_lease_expiration_sent_to_follower;
 
       peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+          sent_leases ? sent_leases->ht_lease_expiration
+                      : peer->last_ht_lease_expiration_sent_to_follower;
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
@@ -896,6 +1069,47 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
   }
 }
 
+int64_t PeerMessageQueue::BatchSizeTargetUnlocked(const TrackedPeer& peer) const {
+  if (!GetAtomicFlag(&FLAGS_consensus_adaptive_batch_size) || peer.batch_size_target_bytes == 0) {
+    return FLAGS_consensus_max_batch_size_bytes;
+  }
+  return std::min<int64_t>(peer.batch_size_target_bytes, FLAGS_consensus_max_batch_size_bytes);
+}
+
+void PeerMessageQueue::AdjustBatchSizeUnlocked(TrackedPeer* peer) {
+  auto latency = MonoTime::Now().GetDeltaSince(peer->measured_batch.send_time);
+  const bool full = peer->measured_batch.full;
+  peer->measured_batch = TrackedPeer::MeasuredBatch();
+  metrics_.batch_ack_latency->Increment(latency.ToMicroseconds());
+  if (!GetAtomicFlag(&FLAGS_consensus_adaptive_batch_size)) {
+    return;
+  }
+
+  const int64_t max_size = FLAGS_consensus_max_batch_size_bytes;
+  const int64_t min_size = std::min<int64_t>(FLAGS_consensus_min_batch_size_bytes, max_size);
+  int64_t current = BatchSizeTargetUnlocked(*peer);
+  int64_t target = current;
+  if (latency.ToMilliseconds() > GetAtomicFlag(&FLAGS_consensus_batch_target_latency_ms)) {
+    // Large batches delay the ops of other tablets on the link, and the acknowledgement of the
+    // ops in the batch, so halve it.
+    target = std::max(current / 2, min_size);
+    if (target < current) {
+      metrics_.batch_size_decreases->Increment();
+    }
+  } else if (full) {
+    // The peer lags behind and is fast enough to handle a bigger batch.
+    target = std::min(current * 2, max_size);
+    if (target > current) {
+      metrics_.batch_size_increases->Increment();
+    }
+  }
+  if (target != current) {
+    VLOG_WITH_PREFIX_UNLOCKED(1) << "Batch size target of " << peer->uuid << " changed from "
+                                 << current << " to " << target << ", latency: " << latency;
+  }
+  peer->batch_size_target_bytes = target;
+}
+
 PeerMessageQueue::TrackedPeer PeerMessageQueue::GetTrackedPeerForTests(string uuid) {
   LockGuard scoped_lock(queue_lock_);
   TrackedPeer* tracked = FindOrDie(peers_map_, uuid);
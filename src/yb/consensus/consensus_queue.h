@@ -150,6 +150,20 @@ class PeerMessageQueue {
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
+    // Target size of a batch of ops sent to the peer, adjusted using the measured latency of
+    // acknowledgements when consensus_adaptive_batch_size is set. 0 if not adjusted yet.
+    int64_t batch_size_target_bytes = 0;
+
+    // The batch sent to the peer, whose acknowledgement latency is being measured. Only one batch
+    // is measured at a time, requests sent meanwhile are not.
+    struct MeasuredBatch {
+      // Index of the last op of the batch, kInvalidOpIdIndex if no batch is measured.
+      int64_t last_index = kInvalidOpIdIndex;
+      // Whether the batch was limited by the target size, i.e. more ops were waiting for it.
+      bool full = false;
+      MonoTime send_time;
+    } measured_batch;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -157,13 +171,21 @@ class PeerMessageQueue {
     int64_t last_seen_term_ = 0;
   };
 
+  // Lease expirations that were sent to a peer with a request, they are established once the peer
+  // acknowledges this request.
+  struct SentLeaseExpirations {
+    MonoTime leader_lease_expiration;
+    MicrosTime ht_lease_expiration = HybridTime::kMin.GetPhysicalValueMicros();
+  };
+
   PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const std::shared_ptr<MemTracker>& server_tracker,
                    const RaftPeerPB& local_peer_pb,
                    const std::string& tablet_id,
                    const server::ClockPtr& clock,
-                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token);
+                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token,
+                   std::unique_ptr<ThreadPoolToken> log_cache_prefetch_token = nullptr);
 
   // Initialize the queue.
   virtual void Init(const OpId& last_locally_replicated);
@@ -234,13 +256,19 @@ class PeerMessageQueue {
   // not delete the entries. The simplest way is to pass the same instance of ConsensusRequestPB to
   // RequestForPeer(): the buffer will replace the old entries with new ones without de-allocating
   // the old ones if they are still required.
+  //
+  // If serialized_ops is true, entries are added to 'request' as unknown fields holding their
+  // serialized form instead, which is shared with other peers through the log cache. Such a request
+  // could only be serialized, and its ops() are empty. In both cases 'msg_refs' contains the entries
+  // added to 'request'.
   virtual CHECKED_STATUS RequestForPeer(
       const std::string& uuid,
       ConsensusRequestPB* request,
       ReplicateMsgs* msg_refs,
       bool* needs_remote_bootstrap,
       RaftPeerPB::MemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      bool serialized_ops = false);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
@@ -256,9 +284,14 @@ class PeerMessageQueue {
 
   // Updates the request queue with the latest response of a peer, returns whether this peer has
   // more requests pending.
+  //
+  // Responses of a peer should be passed in the order the requests were sent. 'sent_leases' are the
+  // lease expirations sent with the request being acknowledged, when not specified the ones sent
+  // with the latest request are used.
   virtual void ResponseFromPeer(const std::string& peer_uuid,
                                 const ConsensusResponsePB& response,
-                                bool* more_pending);
+                                bool* more_pending,
+                                const SentLeaseExpirations* sent_leases = nullptr);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -291,6 +324,11 @@ class PeerMessageQueue {
     scoped_refptr<AtomicGauge<int64_t> > num_majority_done_ops;
     // Keeps track of the number of ops. that are still in progress (IsDone() returns false).
     scoped_refptr<AtomicGauge<int64_t> > num_in_progress_ops;
+    // Latency of acknowledgements of batches of ops from peers.
+    scoped_refptr<Histogram> batch_ack_latency;
+    // Number of times the batch size target of a peer was increased or decreased.
+    scoped_refptr<Counter> batch_size_increases;
+    scoped_refptr<Counter> batch_size_decreases;
 
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
   };
@@ -377,6 +415,10 @@ class PeerMessageQueue {
   // If the log cache returns some error other than NotFound, crashes with a fatal error.
   bool IsOpInLog(const OpId& desired_op) const;
 
+  // Replaces 'source_pb' with the config entry of a caught up follower that is placed strictly
+  // closer to the peer 'uuid' than the local peer, if there is one.
+  void SelectRemoteBootstrapSourceUnlocked(const std::string& uuid, RaftPeerPB* source_pb);
+
   void NotifyObserversOfMajorityReplOpChange(const MajorityReplicatedData& data);
 
   void NotifyObserversOfMajorityReplOpChangeTask(const MajorityReplicatedData& data);
@@ -400,6 +442,12 @@ class PeerMessageQueue {
   // Updates the metrics based on index math.
   void UpdateMetrics();
 
+  // Returns the maximal size of the next batch of ops sent to 'peer'.
+  int64_t BatchSizeTargetUnlocked(const TrackedPeer& peer) const;
+
+  // Adjusts the batch size target of 'peer', when the measured batch is acknowledged.
+  void AdjustBatchSizeUnlocked(TrackedPeer* peer);
+
   void ClearUnlocked();
 
   // Returns the last operation in the message queue, or 'preceding_first_op_in_queue_' if the queue
@@ -53,6 +53,11 @@ class ReplicaOperationFactory {
       const ConsensusRoundPtr& context, HybridTime propagated_safe_time) = 0;
   virtual void SetPropagatedSafeTime(HybridTime ht) = 0;
 
+  // Called on a follower around applying the operations committed by one leader request, so
+  // their writes could be batched.
+  virtual void StartApplyBatch() {}
+  virtual void FinishApplyBatch() {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
@@ -207,6 +207,34 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+TEST_F(LogTest, TestCompressedEntryBatches) {
+  options_.compression_type = LZ4_COMPRESSION;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(1);
+  opid.set_index(1);
+
+  // A batch of similar entries is compressible, while a batch with a single entry is not, so it is
+  // stored uncompressed.
+  ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &opid, 100));
+  ASSERT_OK(AppendNoOpToLogSync(clock_, log_.get(), &opid));
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(LZ4_COMPRESSION, segments[0]->header().compression_type());
+
+  auto read_entries = segments[0]->ReadEntries();
+  ASSERT_OK(read_entries.status);
+  ASSERT_EQ(101, read_entries.entries.size());
+  for (size_t i = 0; i != read_entries.entries.size(); ++i) {
+    ASSERT_EQ(i + 1, read_entries.entries[i]->replicate().id().index());
+  }
+
+  ASSERT_OK(log_->Close());
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
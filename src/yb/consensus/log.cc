@@ -42,6 +42,7 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
@@ -358,6 +359,10 @@ Log::Log(LogOptions options, FsManager* fs_manager, string log_path,
       metric_entity_(metric_entity),
       on_disk_size_(0) {
   CHECK_OK(ThreadPoolBuilder("log-alloc").set_max_threads(1).Build(&allocation_pool_));
+  if (durable_wal_write_) {
+    // Tablet WAL path is <data dir>/wals/table-<id>/tablet-<id>.
+    sync_group_ = LogSyncGroup::ForDirectory(DirName(DirName(tablet_wal_path_)));
+  }
   if (metric_entity_) {
     metrics_.reset(new LogMetrics(metric_entity_));
   }
@@ -674,6 +679,9 @@ Status Log::Sync() {
     if (durable_wal_write_ || timed_or_data_limit_sync) {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
+      if (sync_group_ && durable_wal_write_) {
+        sync_group_->WaitForGroup();
+      }
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
         RETURN_NOT_OK(active_segment_->Sync());
       }
@@ -997,6 +1005,7 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  header.set_compression_type(options_.compression_type);
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
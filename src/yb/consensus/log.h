@@ -68,6 +68,7 @@ struct LogMetrics;
 class LogEntryBatch;
 class LogIndex;
 class LogReader;
+class LogSyncGroup;
 
 // Log interface, inspired by Raft's (logcabin) Log. Provides durability to YugaByte as a normal
 // Write Ahead Log and also plays the role of persistent storage for the consensus state machine.
@@ -212,6 +213,12 @@ class Log : public RefCountedThreadSafe<Log> {
     return active_segment_->path();
   }
 
+  // Returns whether appends are ever synced, either on every write or periodically.
+  bool IsDurableForTests() const {
+    return durable_wal_write_ || interval_durable_wal_write_.Initialized() ||
+           bytes_durable_wal_write_mb_ > 0;
+  }
+
   // Forces the Log to allocate a new segment and roll over.  This can be used to make sure all
   // entries appended up to this point are available in closed, readable segments.
   CHECKED_STATUS AllocateSegmentAndRollOver();
@@ -401,6 +408,9 @@ class Log : public RefCountedThreadSafe<Log> {
   // If true, sync on all appends.
   bool durable_wal_write_;
 
+  // If set, syncs of this log are grouped with syncs of other logs in the same data directory.
+  LogSyncGroup* sync_group_ = nullptr;
+
   // If non-zero, sync every interval of time.
   MonoDelta interval_durable_wal_write_;
 
@@ -61,6 +61,8 @@ DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
 
 METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_counter(log_cache_disk_read_ops);
+METRIC_DECLARE_counter(log_cache_prefetch_hit_ops);
 
 using std::atomic;
 using std::vector;
@@ -106,12 +108,14 @@ class LogCacheTest : public YBTest {
     ASSERT_OK(log_->WaitUntilAllFlushed());
   }
 
-  void CloseAndReopenCache(const OpId& preceding_id) {
+  void CloseAndReopenCache(
+      const OpId& preceding_id, std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr) {
     // Blow away the memtrackers before creating the new cache.
     cache_.reset();
 
     cache_.reset(new LogCache(
-        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet));
+        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet,
+        std::move(prefetch_token)));
     cache_->Init(preceding_id);
   }
 
@@ -256,6 +260,42 @@ TEST_F(LogCacheTest, TestCacheEdgeCases) {
 }
 
 
+// Test that ops following the ones read from the disk are read ahead, and later requests of a
+// lagging peer are served from them.
+TEST_F(LogCacheTest, TestPrefetch) {
+  std::unique_ptr<ThreadPool> prefetch_pool;
+  ASSERT_OK(ThreadPoolBuilder("prefetch").Build(&prefetch_pool));
+  CloseAndReopenCache(MinimumOpId(),
+                      prefetch_pool->NewToken(ThreadPool::ExecutionMode::SERIAL));
+
+  const int kNumMessages = 100;
+  const int kPayloadSize = 1000;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumMessages, kPayloadSize));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  cache_->EvictThroughOp(kNumMessages);
+
+  auto disk_read_ops = METRIC_log_cache_disk_read_ops.Instantiate(metric_entity_);
+  auto prefetch_hit_ops = METRIC_log_cache_prefetch_hit_ops.Instantiate(metric_entity_);
+  const auto initial_disk_read_ops = disk_read_ops->value();
+
+  int64_t after_op_index = 0;
+  while (after_op_index < kNumMessages) {
+    ReplicateMsgs messages;
+    OpId preceding;
+    ASSERT_OK(cache_->ReadOps(after_op_index, 10 * kPayloadSize, &messages, &preceding));
+    ASSERT_EQ(after_op_index, preceding.index());
+    ASSERT_FALSE(messages.empty());
+    for (const auto& msg : messages) {
+      ASSERT_EQ(++after_op_index, msg->id().index());
+    }
+    prefetch_pool->Wait();
+  }
+
+  ASSERT_GT(prefetch_hit_ops->value(), 0);
+  ASSERT_EQ(kNumMessages, disk_read_ops->value() - initial_disk_read_ops +
+                          prefetch_hit_ops->value());
+}
+
 TEST_F(LogCacheTest, TestMemoryLimit) {
   FLAGS_log_cache_size_limit_mb = 1;
   CloseAndReopenCache(MinimumOpId());
@@ -33,6 +33,7 @@
 #include "yb/consensus/log_cache.h"
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -55,6 +56,7 @@
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 
 using namespace std::literals;
 
@@ -70,6 +72,11 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_int32(log_cache_prefetch_size_mb, 8,
+             "The amount of consensus entries following the ones read from the disk for a lagging "
+             "peer, which are read ahead in the background. 0 disables read ahead.");
+TAG_FLAG(log_cache_prefetch_size_mb, advanced);
+
 using strings::Substitute;
 
 namespace yb {
@@ -81,6 +88,15 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_num_ops, "Log Cache Operation Count"
 METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
                           MetricUnit::kBytes,
                           "Amount of memory in use for caching the local log.");
+METRIC_DEFINE_counter(tablet, log_cache_disk_read_ops, "Log Cache Disk Read Operations",
+                      MetricUnit::kOperations,
+                      "Number of operations read from the disk while preparing peer requests.");
+METRIC_DEFINE_counter(tablet, log_cache_prefetched_ops, "Log Cache Prefetched Operations",
+                      MetricUnit::kOperations,
+                      "Number of operations read ahead from the disk for lagging peers.");
+METRIC_DEFINE_counter(tablet, log_cache_prefetch_hit_ops, "Log Cache Prefetch Hit Operations",
+                      MetricUnit::kOperations,
+                      "Number of operations sent to lagging peers from the read ahead ones.");
 
 namespace {
 
@@ -94,12 +110,14 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const MemTrackerPtr& server_tracker,
                    const string& local_uuid,
-                   const string& tablet_id)
+                   const string& tablet_id,
+                   std::unique_ptr<ThreadPoolToken> prefetch_token)
   : log_(log),
     local_uuid_(local_uuid),
     tablet_id_(tablet_id),
     next_sequential_op_index_(0),
     min_pinned_op_index_(0),
+    prefetch_token_(std::move(prefetch_token)),
     metrics_(metric_entity) {
 
   const int64_t max_ops_size_bytes = FLAGS_log_cache_size_limit_mb * 1_MB;
@@ -117,6 +135,12 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
       AddToParent::kTrue, CreateMetrics::kFalse);
   tracker_->SetMetricEntity(metric_entity, kParentMemTrackerId);
 
+  // Prefetched ops are kept until they are sent, so allow two prefetches worth of them.
+  prefetch_tracker_ = MemTracker::CreateTracker(
+      2 * FLAGS_log_cache_prefetch_size_mb * 1_MB,
+      Format("$0-$1-prefetch", kParentMemTrackerId, tablet_id), parent_tracker_,
+      AddToParent::kTrue, CreateMetrics::kFalse);
+
   // Put a fake message at index 0, since this simplifies a lot of our code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
@@ -124,6 +148,13 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
 }
 
 LogCache::~LogCache() {
+  if (prefetch_token_) {
+    prefetch_token_->Shutdown();
+  }
+  prefetch_tracker_->Release(prefetch_tracker_->consumption());
+  prefetched_.clear();
+  prefetch_tracker_->UnregisterFromParent();
+
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
@@ -167,6 +198,8 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
         cache_.erase(it);
       }
     }
+    ErasePrefetchedUnlocked(first_idx_in_batch, std::numeric_limits<int64_t>::max());
+    ++prefetch_generation_;
   }
 
   // Try to consume the memory. If it can't be consumed, we may need to evict.
@@ -280,22 +313,33 @@ namespace {
 
 // Calculate the total byte size that will be used on the wire to replicate this message as part of
 // a consensus update request. This accounts for the length delimiting and tagging of the message.
-int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
-  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
-    msg.ByteSize());
+int64_t TotalByteSizeForSerializedSize(size_t serialized_size) {
+  int msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(serialized_size);
   msg_size += 1; // for the type tag
   return msg_size;
 }
 
+int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+  return TotalByteSizeForSerializedSize(msg.ByteSize());
+}
+
+RefCntBuffer SerializeMessage(const ReplicateMsg& msg) {
+  RefCntBuffer result(msg.ByteSize());
+  msg.SerializeWithCachedSizesToArray(result.udata());
+  return result;
+}
+
 } // anonymous namespace
 
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
                          OpId* preceding_op,
-                         bool* have_more_messages) {
+                         bool* have_more_messages,
+                         std::vector<RefCntBuffer>* serialized_messages) {
   DCHECK_ONLY_NOTNULL(messages);
   DCHECK_ONLY_NOTNULL(preceding_op);
+  DCHECK(!serialized_messages || serialized_messages->size() == messages->size());
   DCHECK_GE(after_op_index, 0);
   RETURN_NOT_OK(LookupOpId(after_op_index, preceding_op));
   if (have_more_messages) {
@@ -321,6 +365,36 @@ Status LogCache::ReadOps(int64_t after_op_index,
         up_to = iter->first - 1;
       }
 
+      // Use the ops read ahead, if any.
+      auto prefetched_it = prefetched_.find(next_index);
+      if (prefetched_it != prefetched_.end()) {
+        bool served_all = true;
+        while (prefetched_it != prefetched_.end() && prefetched_it->first == next_index &&
+               next_index <= up_to) {
+          const ReplicateMsgPtr msg = prefetched_it->second.msg;
+          remaining_space -= TotalByteSizeForMessage(*msg);
+          if (remaining_space < 0 && !messages->empty()) {
+            if (have_more_messages) {
+              *have_more_messages = true;
+            }
+            served_all = false;
+            break;
+          }
+          messages->push_back(msg);
+          if (serialized_messages) {
+            serialized_messages->emplace_back();
+          }
+          prefetch_tracker_->Release(prefetched_it->second.mem_usage);
+          prefetched_it = prefetched_.erase(prefetched_it);
+          metrics_.log_cache_prefetch_hit_ops->Increment();
+          next_index++;
+        }
+        if (served_all && next_index <= up_to) {
+          StartPrefetchUnlocked(next_index, up_to);
+        }
+        continue;
+      }
+
       l.unlock();
 
       ReplicateMsgs raw_replicate_ptrs;
@@ -331,6 +405,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
       l.lock();
       LOG_WITH_PREFIX_UNLOCKED(INFO) << "Successfully read " << raw_replicate_ptrs.size() << " ops "
                             << "from disk.";
+      metrics_.log_cache_disk_read_ops->IncrementBy(raw_replicate_ptrs.size());
 
       for (auto& msg : raw_replicate_ptrs) {
         CHECK_EQ(next_index, msg->id().index());
@@ -338,22 +413,33 @@ Status LogCache::ReadOps(int64_t after_op_index,
         remaining_space -= TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
           messages->push_back(msg);
+          if (serialized_messages) {
+            // Ops read from disk are not cached, so they are serialized for this request only.
+            serialized_messages->emplace_back();
+          }
           next_index++;
         } else if (have_more_messages) {
           *have_more_messages = true;
         }
       }
 
+      // Read the following ops in background, while this batch is being sent.
+      if (next_index <= up_to) {
+        StartPrefetchUnlocked(next_index, up_to);
+      }
+
     } else {
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
         const ReplicateMsgPtr& msg = iter->second.msg;
+        const RefCntBuffer& serialized_msg = iter->second.serialized_msg;
         int64_t index = msg->id().index();
         if (index != next_index) {
           continue;
         }
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        remaining_space -= serialized_msg ? TotalByteSizeForSerializedSize(serialized_msg.size())
+                                          : TotalByteSizeForMessage(*msg);
         if (remaining_space < 0 && !messages->empty()) {
           if (have_more_messages) {
             *have_more_messages = true;
@@ -362,17 +448,111 @@ Status LogCache::ReadOps(int64_t after_op_index,
         }
 
         messages->push_back(msg);
+        if (serialized_messages) {
+          serialized_messages->push_back(serialized_msg);
+        }
         next_index++;
       }
     }
   }
+
+  if (!serialized_messages) {
+    return Status::OK();
+  }
+
+  // Serialize the messages that were not serialized yet outside of the lock, and keep the result
+  // in the cache, so the other peers would send the same bytes.
+  l.unlock();
+  std::vector<size_t> newly_serialized;
+  for (size_t i = 0; i != messages->size(); ++i) {
+    if (!(*serialized_messages)[i]) {
+      (*serialized_messages)[i] = SerializeMessage(*(*messages)[i]);
+      newly_serialized.push_back(i);
+    }
+  }
+  if (newly_serialized.empty()) {
+    return Status::OK();
+  }
+
+  l.lock();
+  for (auto i : newly_serialized) {
+    auto it = cache_.find((*messages)[i]->id().index());
+    if (it == cache_.end() || it->second.msg != (*messages)[i] || it->second.serialized_msg) {
+      continue;
+    }
+    const auto& serialized_msg = (*serialized_messages)[i];
+    it->second.serialized_msg = serialized_msg;
+    it->second.mem_usage += serialized_msg.size();
+    tracker_->Consume(serialized_msg.size());
+    metrics_.log_cache_size->IncrementBy(serialized_msg.size());
+  }
   return Status::OK();
 }
 
 
+void LogCache::StartPrefetchUnlocked(int64_t from_index, int64_t to_index) {
+  DCHECK(lock_.is_locked());
+  if (!prefetch_token_ || prefetch_in_progress_ || FLAGS_log_cache_prefetch_size_mb <= 0 ||
+      prefetched_.count(from_index) || prefetch_tracker_->SpareCapacity() <= 0) {
+    return;
+  }
+  prefetch_in_progress_ = true;
+  auto status = prefetch_token_->SubmitFunc(std::bind(
+      &LogCache::Prefetch, this, from_index, to_index, prefetch_generation_));
+  if (!status.ok()) {
+    prefetch_in_progress_ = false;
+  }
+}
+
+void LogCache::Prefetch(int64_t from_index, int64_t to_index, uint64_t generation) {
+  ReplicateMsgs msgs;
+  auto status = log_->GetLogReader()->ReadReplicatesInRange(
+      from_index, to_index, FLAGS_log_cache_prefetch_size_mb * 1_MB, &msgs);
+
+  // SpaceUsed is relatively expensive, so do calculations outside the lock.
+  std::vector<CacheEntry> entries;
+  entries.reserve(msgs.size());
+  for (auto& msg : msgs) {
+    auto mem_usage = static_cast<int64_t>(msg->SpaceUsedLong());
+    entries.push_back({ std::move(msg), mem_usage });
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  prefetch_in_progress_ = false;
+  if (!status.ok()) {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to read ahead ops " << from_index << ".."
+                                      << to_index << ": " << status;
+    return;
+  }
+  if (generation != prefetch_generation_) {
+    return;
+  }
+  for (auto& entry : entries) {
+    const int64_t index = entry.msg->id().index();
+    if (cache_.count(index) || prefetched_.count(index)) {
+      continue;
+    }
+    if (!prefetch_tracker_->TryConsume(entry.mem_usage)) {
+      break;
+    }
+    prefetched_.emplace(index, std::move(entry));
+    metrics_.log_cache_prefetched_ops->Increment();
+  }
+}
+
+void LogCache::ErasePrefetchedUnlocked(int64_t from_index, int64_t to_index) {
+  DCHECK(lock_.is_locked());
+  auto it = prefetched_.lower_bound(from_index);
+  while (it != prefetched_.end() && static_cast<int64_t>(it->first) <= to_index) {
+    prefetch_tracker_->Release(it->second.mem_usage);
+    it = prefetched_.erase(it);
+  }
+}
+
 void LogCache::EvictThroughOp(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
 
+  ErasePrefetchedUnlocked(0, index);
   EvictSomeUnlocked(index, MathLimits<int64_t>::kMax);
 }
 
@@ -503,7 +683,10 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   x.Instantiate(metric_entity, 0)
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : log_cache_num_ops(INSTANTIATE_METRIC(METRIC_log_cache_num_ops)),
-    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)) {
+    log_cache_size(INSTANTIATE_METRIC(METRIC_log_cache_size)),
+    log_cache_disk_read_ops(INSTANTIATE_METRIC(METRIC_log_cache_disk_read_ops)),
+    log_cache_prefetched_ops(INSTANTIATE_METRIC(METRIC_log_cache_prefetched_ops)),
+    log_cache_prefetch_hit_ops(INSTANTIATE_METRIC(METRIC_log_cache_prefetch_hit_ops)) {
 }
 #undef INSTANTIATE_METRIC
 
@@ -47,6 +47,7 @@
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/opid.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/result.h"
 
@@ -54,6 +55,7 @@ namespace yb {
 
 class MetricEntity;
 class MemTracker;
+class ThreadPoolToken;
 
 namespace log {
 class Log;
@@ -69,13 +71,18 @@ class ReplicateMsg;
 // This stores a set of log messages by their index. New operations can be appended to the end as
 // they are written to the log. Readers fetch entries that were explicitly appended, or they can
 // fetch older entries which are asynchronously fetched from the disk.
+//
+// When older entries are read from the disk, the following entries are prefetched on
+// 'prefetch_token' into a bounded side cache, so a lagging peer catching up does not wait for disk
+// reads of its next request.
 class LogCache {
  public:
   LogCache(const scoped_refptr<MetricEntity>& metric_entity,
            const scoped_refptr<log::Log>& log,
            const std::shared_ptr<MemTracker>& server_tracker,
            const std::string& local_uuid,
-           const std::string& tablet_id);
+           const std::string& tablet_id,
+           std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr);
   ~LogCache();
 
   // Initialize the cache.
@@ -98,11 +105,15 @@ class LogCache {
   // If the ops being requested are not available in the log, this will synchronously read these ops
   // from disk. Therefore, this function may take a substantial amount of time and should not be
   // called with important locks held, etc.
+  //
+  // If serialized_messages is not null, it is filled with the serialized form of each returned op.
+  // The serialized form of a cached op is computed once and shared by all callers.
   CHECKED_STATUS ReadOps(int64_t after_op_index,
                  int max_size_bytes,
                  ReplicateMsgs* messages,
                  OpId* preceding_op,
-                 bool* have_more_messages = nullptr);
+                 bool* have_more_messages = nullptr,
+                 std::vector<RefCntBuffer>* serialized_messages = nullptr);
 
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
@@ -159,8 +170,10 @@ class LogCache {
   struct CacheEntry {
     ReplicateMsgPtr msg;
     // The cached value of msg->SpaceUsedLong(). This method is expensive
-    // to compute, so we compute it only once upon insertion.
+    // to compute, so we compute it only once upon insertion. Includes the size of serialized_msg.
     int64_t mem_usage;
+    // Serialized msg, computed when the entry is read to be sent to a peer for the first time.
+    RefCntBuffer serialized_msg;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
@@ -195,6 +208,15 @@ class LogCache {
 
   Result<PrepareAppendResult> PrepareAppendOperations(const ReplicateMsgs& msgs);
 
+  // Starts asynchronous loading of ops in [from_index, to_index] from the disk into prefetched_,
+  // unless it is already in progress.
+  void StartPrefetchUnlocked(int64_t from_index, int64_t to_index);
+
+  void Prefetch(int64_t from_index, int64_t to_index, uint64_t generation);
+
+  // Removes the prefetched entries in [from_index, to_index].
+  void ErasePrefetchedUnlocked(int64_t from_index, int64_t to_index);
+
   scoped_refptr<log::Log> const log_;
 
   // The UUID of the local peer.
@@ -231,6 +253,21 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  // Ops read ahead from the disk for lagging peers, which are not in cache_. An entry is removed
+  // once it is returned by ReadOps.
+  MessageCache prefetched_;
+
+  // Tracks memory of prefetched_, under the same global limit as the cache.
+  std::shared_ptr<MemTracker> prefetch_tracker_;
+
+  std::unique_ptr<ThreadPoolToken> prefetch_token_;
+
+  bool prefetch_in_progress_ = false;
+
+  // Incremented when ops could be overwritten, so that the result of a prefetch that was in
+  // progress at that moment is dropped.
+  uint64_t prefetch_generation_ = 0;
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -239,6 +276,15 @@ class LogCache {
 
     // Keeps track of the memory consumed by the cache, in bytes.
     scoped_refptr<AtomicGauge<int64_t> > log_cache_size;
+
+    // Number of ops read from the disk synchronously by ReadOps.
+    scoped_refptr<Counter> log_cache_disk_read_ops;
+
+    // Number of ops read from the disk ahead of time.
+    scoped_refptr<Counter> log_cache_prefetched_ops;
+
+    // Number of ops returned by ReadOps from the prefetched ones.
+    scoped_refptr<Counter> log_cache_prefetch_hit_ops;
   };
   Metrics metrics_;
 
@@ -0,0 +1,50 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <thread>
+#include <vector>
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace log {
+
+class LogSyncGroupTest : public YBTest {
+};
+
+TEST_F(LogSyncGroupTest, FullGroupIsReleasedBeforeWindow) {
+  constexpr size_t kNumThreads = 4;
+  // Window is long enough for the test to time out if a full group was not released early.
+  LogSyncGroup group(MonoDelta::FromSeconds(600), kNumThreads);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([&group] { group.WaitForGroup(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(1, group.num_groups());
+}
+
+TEST_F(LogSyncGroupTest, LonelyWaiterIsReleasedAfterWindow) {
+  LogSyncGroup group(MonoDelta::FromMilliseconds(10), 16);
+  group.WaitForGroup();
+  group.WaitForGroup();
+  ASSERT_EQ(2, group.num_groups());
+}
+
+}  // namespace log
+}  // namespace yb
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(log_group_sync_window_us, 0,
+             "When durable_wal_write is on, the time a WAL fsync waits for fsyncs of other tablets "
+             "with WAL in the same directory, so they are issued together. 0 turns grouping off.");
+TAG_FLAG(log_group_sync_window_us, advanced);
+TAG_FLAG(log_group_sync_window_us, experimental);
+
+DEFINE_int32(log_group_sync_max_tablets, 64,
+             "The number of tablets whose WAL fsyncs release a group before its window elapses.");
+TAG_FLAG(log_group_sync_max_tablets, advanced);
+TAG_FLAG(log_group_sync_max_tablets, experimental);
+
+namespace yb {
+namespace log {
+
+LogSyncGroup::LogSyncGroup(MonoDelta window, size_t max_group_size)
+    : window_(std::chrono::microseconds(window.ToMicroseconds())),
+      max_group_size_(std::max<size_t>(max_group_size, 1)) {
+}
+
+LogSyncGroup* LogSyncGroup::ForDirectory(const std::string& dir) {
+  if (FLAGS_log_group_sync_window_us <= 0) {
+    return nullptr;
+  }
+
+  static std::mutex groups_mutex;
+  // Groups are never destroyed, since logs could be closed concurrently with process shutdown.
+  static auto* groups = new std::unordered_map<std::string, std::unique_ptr<LogSyncGroup>>();
+
+  std::lock_guard<std::mutex> lock(groups_mutex);
+  auto& group = (*groups)[dir];
+  if (!group) {
+    group = std::make_unique<LogSyncGroup>(
+        MonoDelta::FromMicroseconds(FLAGS_log_group_sync_window_us),
+        FLAGS_log_group_sync_max_tablets);
+  }
+  return group.get();
+}
+
+void LogSyncGroup::WaitForGroup() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto generation = generation_;
+  ++group_size_;
+
+  if (group_size_ == 1) {
+    // We are the leader of a new group.
+    cond_.wait_for(lock, window_, [this] { return group_size_ >= max_group_size_; });
+    group_size_ = 0;
+    ++generation_;
+    lock.unlock();
+    cond_.notify_all();
+    return;
+  }
+
+  if (group_size_ >= max_group_size_) {
+    // Wake up the leader, the group is full.
+    cond_.notify_all();
+  }
+  cond_.wait(lock, [this, generation] { return generation_ != generation; });
+}
+
+uint64_t LogSyncGroup::num_groups() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+}  // namespace log
+}  // namespace yb
@@ -0,0 +1,68 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace log {
+
+// Aligns WAL fsyncs of the tablets sharing a data directory into groups.
+//
+// The first log that wants to sync becomes the group leader and waits for up to 'window' for logs
+// of other tablets to join. Then all logs of the group are released together and issue their
+// fsyncs concurrently, so the file system could commit them with a single journal commit and
+// device cache flush, instead of one per tablet.
+//
+// This class is thread-safe.
+class LogSyncGroup {
+ public:
+  LogSyncGroup(MonoDelta window, size_t max_group_size);
+
+  // Returns the group shared by all logs in the given directory, or nullptr if grouping of syncs is
+  // turned off by flags.
+  static LogSyncGroup* ForDirectory(const std::string& dir);
+
+  // Blocks until the group the caller has joined is released.
+  void WaitForGroup();
+
+  // Number of groups released so far.
+  uint64_t num_groups() const;
+
+ private:
+  const std::chrono::steady_clock::duration window_;
+  const size_t max_group_size_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+
+  // Incremented each time a group is released.
+  uint64_t generation_ = 0;
+
+  // Number of callers in the current group, including the leader.
+  size_t group_size_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(LogSyncGroup);
+};
+
+}  // namespace log
+}  // namespace yb
+
+#endif  // YB_CONSENSUS_LOG_SYNC_GROUP_H
@@ -39,6 +39,7 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
 
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
@@ -48,6 +49,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
+#include "yb/util/cast.h"
 #include "yb/util/coding-inl.h"
 #include "yb/util/coding.h"
 #include "yb/util/crc.h"
@@ -87,6 +89,20 @@ DEFINE_bool(log_async_preallocate_segments, true,
             "Whether the WAL segments preallocation should happen asynchronously");
 TAG_FLAG(log_async_preallocate_segments, advanced);
 
+DEFINE_string(log_compression_type, "none",
+              "Compression of entry batches in new WAL segments: none or lz4.");
+TAG_FLAG(log_compression_type, advanced);
+
+static bool ValidateLogCompressionType(const char* flagname, const std::string& value) {
+  if (value == "none" || value == "lz4") {
+    return true;
+  }
+  LOG(ERROR) << flagname << " must be none or lz4, value " << value << " is invalid";
+  return false;
+}
+static bool log_compression_type_validator_registered = google::RegisterFlagValidator(
+    &FLAGS_log_compression_type, &ValidateLogCompressionType);
+
 DECLARE_string(fs_data_dirs);
 
 DEFINE_bool(require_durable_wal_write, false, "Whether durable WAL write is required."
@@ -136,9 +152,61 @@ LogOptions::LogOptions()
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
       preallocate_segments(FLAGS_log_preallocate_segments),
-      async_preallocate_segments(FLAGS_log_async_preallocate_segments) {
+      async_preallocate_segments(FLAGS_log_async_preallocate_segments),
+      compression_type(FLAGS_log_compression_type == "lz4" ? LZ4_COMPRESSION : NO_COMPRESSION) {
+  DCHECK(log_compression_type_validator_registered);
+}
+
+namespace {
+
+// Appends the given entry batch to 'out' in the format described by LogSegmentHeaderPB.
+void CompressEntryBatch(LogCompressionTypePB compression_type, const Slice& data,
+                        faststring* out) {
+  DCHECK_EQ(compression_type, LZ4_COMPRESSION);
+  out->clear();
+  const int max_compressed_size = LZ4_compressBound(data.size());
+  // Reserve space for the varint32 prefix, which is at most 5 bytes.
+  out->resize(5 + max_compressed_size);
+  uint8_t* const compressed_start = InlineEncodeVarint32(out->data(), data.size());
+  const int compressed_size = LZ4_compress_default(
+      data.cdata(), to_char_ptr(compressed_start), data.size(), max_compressed_size);
+  if (compressed_size <= 0 || static_cast<size_t>(compressed_size) >= data.size()) {
+    // Batch is not compressible, store it as is.
+    out->clear();
+    PutVarint32(out, 0);
+    out->append(data.data(), data.size());
+    return;
+  }
+  out->resize(compressed_start - out->data() + compressed_size);
+}
+
+// Decodes an entry batch written by CompressEntryBatch. Result points either into 'data' or into
+// 'buffer'.
+Result<Slice> UncompressEntryBatch(LogCompressionTypePB compression_type, Slice data,
+                                   faststring* buffer) {
+  if (compression_type != LZ4_COMPRESSION) {
+    return STATUS_FORMAT(NotSupported, "Unknown log compression type: $0", compression_type);
+  }
+  uint32_t uncompressed_size;
+  if (!GetVarint32(&data, &uncompressed_size)) {
+    return STATUS(Corruption, "Could not decode uncompressed size of log entry batch");
+  }
+  if (uncompressed_size == 0) {
+    return data;
+  }
+  buffer->clear();
+  buffer->resize(uncompressed_size);
+  const int decompressed_size = LZ4_decompress_safe(
+      data.cdata(), to_char_ptr(buffer->data()), data.size(), uncompressed_size);
+  if (decompressed_size < 0 || static_cast<uint32_t>(decompressed_size) != uncompressed_size) {
+    return STATUS_FORMAT(Corruption, "Could not decompress log entry batch: got $0 of $1 bytes",
+                         decompressed_size, uncompressed_size);
+  }
+  return Slice(buffer->data(), uncompressed_size);
 }
 
+} // namespace
+
 Status ReadableLogSegment::Open(Env* env,
                                 const string& path,
                                 scoped_refptr<ReadableLogSegment>* segment) {
@@ -718,10 +786,17 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice uncompressed_entry_batch = entry_batch_slice;
+  faststring uncompressed_buffer;
+  if (header_.compression_type() != NO_COMPRESSION) {
+    uncompressed_entry_batch = VERIFY_RESULT(UncompressEntryBatch(
+        header_.compression_type(), entry_batch_slice, &uncompressed_buffer));
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              uncompressed_entry_batch.data(),
+                              uncompressed_entry_batch.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -792,11 +867,17 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  Slice data = batch_data;
+  if (header_.compression_type() != NO_COMPRESSION) {
+    CompressEntryBatch(header_.compression_type(), batch_data, &compressed_buffer_);
+    data = Slice(compressed_buffer_);
+  }
+
   // First encode the length of the message.
   uint32_t len = data.size();
   InlineEncodeFixed32(&header_buf[0], len);
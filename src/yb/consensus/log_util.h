@@ -101,6 +101,9 @@ struct LogOptions {
   // Whether the allocation should happen asynchronously.
   bool async_preallocate_segments;
 
+  // Compression of entry batches in new segments.
+  LogCompressionTypePB compression_type;
+
   LogOptions();
 };
 
@@ -421,6 +424,9 @@ class WritableLogSegment {
   // The offset where the last written entry ends.
   int64_t written_offset_;
 
+  // Buffer for compressed entry batches, reused between batches.
+  faststring compressed_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(WritableLogSegment);
 };
 
@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+
+DEFINE_int32(multi_raft_heartbeat_window_ms, 0,
+             "The time heartbeats of tablet leaders to the same tablet server are collected, "
+             "before they are sent in a single RPC. 0 sends every heartbeat in its own RPC.");
+TAG_FLAG(multi_raft_heartbeat_window_ms, advanced);
+TAG_FLAG(multi_raft_heartbeat_window_ms, experimental);
+
+DEFINE_int32(multi_raft_batch_size, 512,
+             "The maximum number of heartbeats sent in a single RPC.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+TAG_FLAG(multi_raft_batch_size, experimental);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    const HostPort& hostport, rpc::ProxyCache* proxy_cache,
+    std::shared_ptr<rpc::Messenger> messenger)
+    : messenger_(std::move(messenger)),
+      consensus_proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport)) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+}
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(const ConsensusRequestPB* request,
+                                                  ConsensusResponsePB* response,
+                                                  rpc::RpcController* controller,
+                                                  rpc::ResponseCallback callback) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!current_batch_) {
+    current_batch_ = std::make_shared<BatchData>();
+    std::weak_ptr<MultiRaftHeartbeatBatcher> weak_self = shared_from_this();
+    auto batch_id = batch_id_;
+    // The batch is sent even if the task is aborted, so the callbacks are invoked in any case.
+    messenger_->scheduler().Schedule(
+        [weak_self, batch_id](const Status& status) {
+          auto self = weak_self.lock();
+          if (self) {
+            self->SendBatch(batch_id);
+          }
+        },
+        std::chrono::milliseconds(FLAGS_multi_raft_heartbeat_window_ms));
+  }
+
+  current_batch_->request.add_consensus_request()->CopyFrom(*request);
+  current_batch_->response_data.push_back({request, response, controller, std::move(callback)});
+  const size_t max_batch_size = std::max(FLAGS_multi_raft_batch_size, 1);
+  if (current_batch_->response_data.size() >= max_batch_size) {
+    SendBatchUnlocked(&lock);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(uint64_t batch_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (batch_id != batch_id_ || !current_batch_) {
+    // This batch was already sent because it was full.
+    return;
+  }
+  SendBatchUnlocked(&lock);
+}
+
+void MultiRaftHeartbeatBatcher::SendBatchUnlocked(std::unique_lock<std::mutex>* lock) {
+  auto batch = std::move(current_batch_);
+  ++batch_id_;
+  lock->unlock();
+
+  batch->controller = std::make_unique<rpc::RpcController>();
+  batch->controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  consensus_proxy_->MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, batch->controller.get(),
+      std::bind(&MultiRaftHeartbeatBatcher::BatchResponseReceived, shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::BatchResponseReceived(const std::shared_ptr<BatchData>& batch) {
+  const auto& status = batch->controller->status();
+  const size_t num_requests = batch->response_data.size();
+  if (status.ok() &&
+      static_cast<size_t>(batch->response.consensus_response_size()) == num_requests) {
+    for (size_t i = 0; i != num_requests; ++i) {
+      auto& data = batch->response_data[i];
+      data.response->Swap(batch->response.mutable_consensus_response(i));
+      data.callback();
+    }
+    return;
+  }
+
+  // The remote server could be unreachable or not support batched heartbeats. Send the requests
+  // separately, so each tablet gets the actual status of its request.
+  YB_LOG_EVERY_N_SECS(WARNING, 10)
+      << "Failed to send " << num_requests << " heartbeats in a batch: "
+      << (status.ok() ? STATUS_FORMAT(IllegalState, "Got $0 responses",
+                                      batch->response.consensus_response_size())
+                      : status);
+  for (auto& data : batch->response_data) {
+    data.controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+    consensus_proxy_->UpdateConsensusAsync(
+        *data.request, data.response, data.controller, std::move(data.callback));
+  }
+}
+
+MultiRaftManager::MultiRaftManager(
+    std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache)
+    : messenger_(std::move(messenger)), proxy_cache_(proxy_cache) {
+}
+
+MultiRaftHeartbeatBatcherPtr MultiRaftManager::AddOrGetBatcher(const HostPort& hostport) {
+  if (FLAGS_multi_raft_heartbeat_window_ms <= 0) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& weak_batcher = batchers_[hostport];
+  auto batcher = weak_batcher.lock();
+  if (!batcher) {
+    batcher = std::make_shared<MultiRaftHeartbeatBatcher>(hostport, proxy_cache_, messenger_);
+    weak_batcher = batcher;
+  }
+  return batcher;
+}
+
+}  // namespace consensus
+}  // namespace yb
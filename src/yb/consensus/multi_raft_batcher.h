@@ -0,0 +1,115 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus_fwd.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/rpc/response_callback.h"
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+namespace consensus {
+
+// Collects heartbeat-only UpdateConsensus requests of tablet leaders to the same tablet server, and
+// sends them in a single MultiRaftUpdateConsensus RPC, so an idle server with many tablets does not
+// send an RPC per tablet and follower every heartbeat interval.
+//
+// This class is thread-safe.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  MultiRaftHeartbeatBatcher(
+      const HostPort& hostport, rpc::ProxyCache* proxy_cache,
+      std::shared_ptr<rpc::Messenger> messenger);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds the request to the current batch. When the response is received it is stored in
+  // 'response' and 'callback' is invoked, as it would be by ConsensusServiceProxy. If the batch
+  // could not be sent, the request is sent separately using 'controller'.
+  void AddRequestToBatch(const ConsensusRequestPB* request,
+                         ConsensusResponsePB* response,
+                         rpc::RpcController* controller,
+                         rpc::ResponseCallback callback);
+
+ private:
+  struct ResponseData {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  struct BatchData {
+    MultiRaftConsensusRequestPB request;
+    MultiRaftConsensusResponsePB response;
+    std::vector<ResponseData> response_data;
+    std::unique_ptr<rpc::RpcController> controller;
+  };
+
+  void SendBatch(uint64_t batch_id);
+  void SendBatchUnlocked(std::unique_lock<std::mutex>* lock);
+  void BatchResponseReceived(const std::shared_ptr<BatchData>& batch);
+
+  const std::shared_ptr<rpc::Messenger> messenger_;
+  const ConsensusServiceProxyPtr consensus_proxy_;
+
+  std::mutex mutex_;
+
+  // The batch being collected, null if there is none.
+  std::shared_ptr<BatchData> current_batch_;
+
+  // Incremented when a batch is sent, so the scheduled sending of a batch that was already sent
+  // is ignored.
+  uint64_t batch_id_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiRaftHeartbeatBatcher);
+};
+
+typedef std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcherPtr;
+
+// Keeps a MultiRaftHeartbeatBatcher per remote tablet server, shared by all tablets of the local
+// server.
+class MultiRaftManager {
+ public:
+  MultiRaftManager(std::shared_ptr<rpc::Messenger> messenger, rpc::ProxyCache* proxy_cache);
+
+  // Returns the batcher for heartbeats to the server at 'hostport', or nullptr if heartbeats
+  // should not be batched.
+  MultiRaftHeartbeatBatcherPtr AddOrGetBatcher(const HostPort& hostport);
+
+ private:
+  const std::shared_ptr<rpc::Messenger> messenger_;
+  rpc::ProxyCache* const proxy_cache_;
+
+  std::mutex mutex_;
+  std::unordered_map<HostPort, std::weak_ptr<MultiRaftHeartbeatBatcher>, HostPortHash> batchers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MultiRaftManager);
+};
+
+}  // namespace consensus
+}  // namespace yb
+
+#endif  // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
@@ -56,8 +56,10 @@
 #include "yb/server/metadata.h"
 #include "yb/tserver/tserver.pb.h"
 
+#include "yb/util/async_io_executor.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
+#include "yb/util/failure_detector.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
@@ -85,6 +87,27 @@ DEFINE_double(leader_failure_max_missed_heartbeat_periods, 6.0,
               "The value passed to this flag may be fractional.");
 TAG_FLAG(leader_failure_max_missed_heartbeat_periods, advanced);
 
+DEFINE_double(leader_failure_min_missed_heartbeat_periods, 3.0,
+              "Minimum heartbeat periods that the leader can fail to heartbeat in before we "
+              "consider the leader to be failed, when the failure timeout is adapted by "
+              "the phi accrual failure detector. The value passed to this flag may be fractional.");
+TAG_FLAG(leader_failure_min_missed_heartbeat_periods, advanced);
+
+DEFINE_double(leader_failure_phi_threshold, 8.0,
+              "Suspicion level of the phi accrual failure detector at which a follower considers "
+              "the leader to be failed. The detector adapts the failure timeout to the observed "
+              "intervals between messages from the leader, within "
+              "leader_failure_min_missed_heartbeat_periods and "
+              "leader_failure_max_missed_heartbeat_periods heartbeat periods. 0 disables the "
+              "detector, so the failure timeout is always the maximum.");
+TAG_FLAG(leader_failure_phi_threshold, advanced);
+
+DEFINE_bool(use_preelection, true,
+            "Whether to run a pre-election before a leader election triggered by leader failure "
+            "detection. Replicas vote in a pre-election without advancing their terms, so a "
+            "replica that could not win the election does not make the leader step down.");
+TAG_FLAG(use_preelection, advanced);
+
 DEFINE_int32(leader_failure_exp_backoff_max_delta_ms, 20 * 1000,
              "Maximum time to sleep in between leader election retries, in addition to the "
              "regular timeout. When leader election fails the interval in between retries "
@@ -187,6 +210,16 @@ using std::weak_ptr;
 using strings::Substitute;
 using tserver::TabletServerErrorPB;
 
+namespace {
+
+// Number of last intervals between messages from the leader used to estimate their distribution.
+constexpr size_t kLeaderHeartbeatWindowSize = 100;
+
+// Number of intervals that should be observed before the failure timeout is adapted to them.
+constexpr size_t kLeaderHeartbeatMinIntervals = 10;
+
+} // namespace
+
 shared_ptr<RaftConsensus> RaftConsensus::Create(
     const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -201,12 +234,15 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
-    RetryableRequests* retryable_requests) {
+    RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager,
+    AsyncIoExecutor* io_executor) {
   gscoped_ptr<PeerProxyFactory> rpc_factory(new RpcPeerProxyFactory(
-      messenger, proxy_cache, local_peer_pb.cloud_info()));
+      messenger, proxy_cache, local_peer_pb.cloud_info(), multi_raft_manager));
 
   // The message queue that keeps track of which operations need to be replicated
-  // where.
+  // where. WAL reads for lagging peers go to the I/O threads when there are any, so a slow disk
+  // does not hold Raft threads.
   gscoped_ptr<PeerMessageQueue> queue(
       new PeerMessageQueue(metric_entity,
                            log,
@@ -214,7 +250,9 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
                            local_peer_pb,
                            options.tablet_id,
                            clock,
-                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)));
+                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL),
+                           io_executor ? io_executor->NewSerialToken()
+                                       : raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)));
 
   DCHECK(local_peer_pb.has_permanent_uuid());
   const string& peer_uuid = local_peer_pb.permanent_uuid();
@@ -287,6 +325,10 @@ RaftConsensus::RaftConsensus(
           METRIC_dns_resolve_latency_during_update_raft_config.Instantiate(metric_entity)) {
   DCHECK_NOTNULL(log_.get());
 
+  leader_heartbeat_detector_ = new PhiAccrualFailureDetector(
+      FLAGS_leader_failure_phi_threshold, kLeaderHeartbeatWindowSize,
+      MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms / 4));
+
   if (PREDICT_FALSE(FLAGS_follower_reject_update_consensus_requests_seconds > 0)) {
     withold_replica_updates_until_ = MonoTime::Now() +
         MonoDelta::FromSeconds(FLAGS_follower_reject_update_consensus_requests_seconds);
@@ -406,9 +448,22 @@ Status RaftConsensus::DoStartElection(
     const OpId& must_be_committed_opid,
     const std::string& originator_uuid,
     TEST_SuppressVoteRequest suppress_vote_request) {
+  // Only elections triggered by the failure detector could disrupt a live leader, so the other
+  // ones do not need a pre-election.
+  const PreElection preelection(
+      mode == NORMAL_ELECTION && GetAtomicFlag(&FLAGS_use_preelection));
+  return DoStartElection(
+      LeaderElectionData{mode, originator_uuid, preelection, suppress_vote_request},
+      pending_commit, must_be_committed_opid);
+}
+
+Status RaftConsensus::DoStartElection(const LeaderElectionData& data,
+                                      bool pending_commit,
+                                      const OpId& must_be_committed_opid) {
   TRACE_EVENT2("consensus", "RaftConsensus::StartElection",
                "peer", peer_uuid(),
                "tablet", tablet_id());
+  const ElectionMode mode = data.mode;
   if (FLAGS_do_not_start_election_test_only) {
     LOG(INFO) << "Election start skipped as do_not_start_election_test_only flag is set to true.";
     return Status::OK();
@@ -459,17 +514,20 @@ Status RaftConsensus::DoStartElection(
     }
 
     if (start_now) {
+      const char* election_name = data.preelection ? "pre-election" : "leader election";
       if (state_->HasLeaderUnlocked()) {
         LOG_WITH_PREFIX(INFO)
             << "Fail of leader " << state_->GetLeaderUuidUnlocked()
-            << " detected. Triggering leader election, mode=" << mode;
+            << " detected. Triggering " << election_name << ", mode=" << mode;
       } else {
         LOG_WITH_PREFIX(INFO)
-            << "Triggering leader election, mode=" << mode;
+            << "Triggering " << election_name << ", mode=" << mode;
       }
 
-      // Increment the term.
-      RETURN_NOT_OK(IncrementTermUnlocked());
+      // Increment the term. A pre-election is run for the next term without changing ours.
+      if (!data.preelection) {
+        RETURN_NOT_OK(IncrementTermUnlocked());
+      }
 
       // Snooze to avoid the election timer firing again as much as possible.
       // We do not disable the election timer while running an election.
@@ -487,7 +545,9 @@ Status RaftConsensus::DoStartElection(
 
       // Vote for ourselves.
       // TODO: Consider using a separate Mutex for voting, which must sync to disk.
-      RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      if (!data.preelection) {
+        RETURN_NOT_OK(state_->SetVotedForCurrentTermUnlocked(state_->GetPeerUuid()));
+      }
       bool duplicate;
       RETURN_NOT_OK(counter->RegisterVote(state_->GetPeerUuid(), VOTE_GRANTED, &duplicate));
       CHECK(!duplicate) << state_->LogPrefix()
@@ -497,7 +557,10 @@ Status RaftConsensus::DoStartElection(
       VoteRequestPB request;
       request.set_ignore_live_leader(mode == ELECT_EVEN_IF_LEADER_IS_ALIVE);
       request.set_candidate_uuid(state_->GetPeerUuid());
-      request.set_candidate_term(state_->GetCurrentTermUnlocked());
+      request.set_candidate_term(state_->GetCurrentTermUnlocked() + (data.preelection ? 1 : 0));
+      if (data.preelection) {
+        request.set_preelection(true);
+      }
       request.set_tablet_id(state_->GetOptions().tablet_id);
       *request.mutable_candidate_status()->mutable_last_received() =
         state_->GetLastReceivedOpIdUnlocked();
@@ -508,8 +571,8 @@ Status RaftConsensus::DoStartElection(
           request,
           std::move(counter),
           timeout,
-          suppress_vote_request,
-          std::bind(&RaftConsensus::ElectionCallback, shared_from_this(), originator_uuid,
+          data.suppress_vote_request,
+          std::bind(&RaftConsensus::ElectionCallback, shared_from_this(), data,
                     std::placeholders::_1)));
 
       // Clear the pending election op id so that we won't start the same pending election again.
@@ -673,6 +736,36 @@ Status RaftConsensus::StepDown(const LeaderStepDownRequestPB* req, LeaderStepDow
   return Status::OK();
 }
 
+Status RaftConsensus::TransferLeadership() {
+  LeaderStepDownRequestPB req;
+  req.set_dest_uuid(peer_uuid());
+  req.set_tablet_id(tablet_id());
+  {
+    auto lock = state_->LockForRead();
+    if (state_->GetActiveRoleUnlocked() != RaftPeerPB::LEADER) {
+      return STATUS(IllegalState, "Not currently leader");
+    }
+    for (const RaftPeerPB& peer : state_->GetActiveConfigUnlocked().peers()) {
+      if (peer.member_type() == RaftPeerPB::VOTER &&
+          peer.permanent_uuid() != state_->GetPeerUuid() &&
+          queue_->CanPeerBecomeLeader(peer.permanent_uuid())) {
+        req.set_new_leader_uuid(peer.permanent_uuid());
+        break;
+      }
+    }
+  }
+  if (!req.has_new_leader_uuid()) {
+    return STATUS(IllegalState, "No peer is caught up to take over leadership");
+  }
+
+  LeaderStepDownResponsePB resp;
+  RETURN_NOT_OK(StepDown(&req, &resp));
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  return Status::OK();
+}
+
 Status RaftConsensus::ElectionLostByProtege(const std::string& election_lost_by_uuid) {
   if (election_lost_by_uuid.empty()) {
     return STATUS(InvalidArgument, "election_lost_by_uuid could not be empty");
@@ -1513,7 +1606,8 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
     // Snooze the failure detector as soon as we decide to accept the message.
     // We are guaranteed to be acting as a FOLLOWER at this point by the above
     // sanity check.
-    SnoozeFailureDetector(DO_NOT_LOG);
+    const auto leader_failure_timeout = LeaderFailureTimeoutUnlocked(request->caller_uuid());
+    SnoozeFailureDetector(DO_NOT_LOG, leader_failure_timeout);
 
     last_message_from_leader_time_ = MonoTime::Now();
 
@@ -1525,8 +1619,9 @@ Status RaftConsensus::UpdateReplica(ConsensusRequestPB* request,
           request->ht_lease_expiration());
     }
 
-    // Also prohibit voting for anyone for the minimum election timeout.
-    withhold_votes_until_ = MonoTime::Now() + MinimumElectionTimeout();
+    // Also prohibit voting for anyone until we would consider the leader failed ourselves.
+    withhold_votes_until_ = MonoTime::Now() + (
+        leader_failure_timeout.Initialized() ? leader_failure_timeout : MinimumElectionTimeout());
 
     // 1 - Early commit pending (and committed) operations
     RETURN_NOT_OK(EarlyCommitUnlocked(*request, deduped_req));
@@ -1590,7 +1685,15 @@ Status RaftConsensus::EarlyCommitUnlocked(const ConsensusRequestPB& request,
 
   VLOG_WITH_PREFIX(1) << "Early marking committed up to " << early_apply_up_to.ShortDebugString();
   TRACE("Early marking committed up to $0.$1", early_apply_up_to.term(), early_apply_up_to.index());
-  return state_->AdvanceCommittedIndexUnlocked(early_apply_up_to);
+  return AdvanceCommittedIndexOnReplicaUnlocked(early_apply_up_to);
+}
+
+Status RaftConsensus::AdvanceCommittedIndexOnReplicaUnlocked(const OpId& committed_index) {
+  auto* operation_factory = state_->GetReplicaOperationFactoryUnlocked();
+  operation_factory->StartApplyBatch();
+  auto status = state_->AdvanceCommittedIndexUnlocked(committed_index);
+  operation_factory->FinishApplyBatch();
+  return status;
 }
 
 Result<bool> RaftConsensus::EnqueuePreparesUnlocked(const ConsensusRequestPB& request,
@@ -1779,7 +1882,7 @@ Status RaftConsensus::MarkOperationsAsCommittedUnlocked(const ConsensusRequestPB
 
   VLOG_WITH_PREFIX(1) << "Marking committed up to " << apply_up_to.ShortDebugString();
   TRACE(Substitute("Marking committed up to $0", apply_up_to.ShortDebugString()));
-  return state_->AdvanceCommittedIndexUnlocked(apply_up_to);
+  return AdvanceCommittedIndexOnReplicaUnlocked(apply_up_to);
 }
 
 void RaftConsensus::FillConsensusResponseOKUnlocked(ConsensusResponsePB* response) {
@@ -1880,8 +1983,8 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondAlreadyVotedForOther(request, response);
   }
 
-  // The term advanced.
-  if (request->candidate_term() > state_->GetCurrentTermUnlocked()) {
+  // The term advanced. Voting in a pre-election does not change our term.
+  if (!request->preelection() && request->candidate_term() > state_->GetCurrentTermUnlocked()) {
     RETURN_NOT_OK_PREPEND(HandleTermAdvanceUnlocked(request->candidate_term()),
         Substitute("Could not step down in RequestVote. Current term: $0, candidate term: $1",
                    state_->GetCurrentTermUnlocked(), request->candidate_term()));
@@ -1894,6 +1997,10 @@ Status RaftConsensus::RequestVote(const VoteRequestPB* request, VoteResponsePB*
     return RequestVoteRespondLastOpIdTooOld(local_last_logged_opid, request, response);
   }
 
+  if (request->preelection()) {
+    return RequestVoteRespondPreElectionVoteGranted(request, response);
+  }
+
   // Clear the pending election op id if any before granting the vote. If another peer jumps in
   // before we can catch up and start the election, let's not disrupt the quorum with another
   // election.
@@ -2412,6 +2519,16 @@ Status RaftConsensus::RequestVoteRespondVoteGranted(const VoteRequestPB* request
   return Status::OK();
 }
 
+Status RaftConsensus::RequestVoteRespondPreElectionVoteGranted(const VoteRequestPB* request,
+                                                               VoteResponsePB* response) {
+  FillVoteResponseVoteGranted(response);
+  LOG(INFO) << Substitute("$0: Granting yes pre-election vote for candidate $1 in term $2.",
+                          GetRequestVoteLogPrefix(),
+                          request->candidate_uuid(),
+                          request->candidate_term());
+  return Status::OK();
+}
+
 RaftPeerPB::Role RaftConsensus::GetRoleUnlocked() const {
   DCHECK(state_->IsLocked());
   return state_->GetActiveRoleUnlocked();
@@ -2547,14 +2664,13 @@ ReplicaState* RaftConsensus::GetReplicaStateForTests() {
   return state_.get();
 }
 
-void RaftConsensus::ElectionCallback(const std::string& originator_uuid,
+void RaftConsensus::ElectionCallback(const LeaderElectionData& data,
                                      const ElectionResult& result) {
   // The election callback runs on a reactor thread, so we need to defer to our
   // threadpool. If the threadpool is already shut down for some reason, it's OK --
   // we're OK with the callback never running.
   WARN_NOT_OK(raft_pool_token_->SubmitFunc(
-              std::bind(&RaftConsensus::DoElectionCallback, shared_from_this(), originator_uuid,
-                        result)),
+              std::bind(&RaftConsensus::DoElectionCallback, shared_from_this(), data, result)),
               state_->LogPrefix() + "Unable to run election callback");
 }
 
@@ -2601,8 +2717,9 @@ void RaftConsensus::NotifyOriginatorAboutLostElection(const std::string& origina
                            << ", config: " << active_config.ShortDebugString();
 }
 
-void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
+void RaftConsensus::DoElectionCallback(const LeaderElectionData& data,
                                        const ElectionResult& result) {
+  const char* election_name = data.preelection ? "Pre-election" : "Leader election";
   // Snooze to avoid the election timer firing again as much as possible.
   {
     auto lock = state_->LockForRead();
@@ -2616,11 +2733,11 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
     SnoozeFailureDetector(ALLOW_LOGGING, LeaderElectionExpBackoffDeltaUnlocked());
   }
   if (result.decision == VOTE_DENIED) {
-    LOG_WITH_PREFIX(INFO) << "Leader election lost for term " << result.election_term
+    LOG_WITH_PREFIX(INFO) << election_name << " lost for term " << result.election_term
                              << ". Reason: "
                              << (!result.message.empty() ? result.message : "None given")
-                             << ". Originator: " << originator_uuid;
-    NotifyOriginatorAboutLostElection(originator_uuid);
+                             << ". Originator: " << data.originator_uuid;
+    NotifyOriginatorAboutLostElection(data.originator_uuid);
     return;
   }
 
@@ -2633,8 +2750,10 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
     return;
   }
 
-  if (result.election_term != state_->GetCurrentTermUnlocked()) {
-    LOG_WITH_PREFIX(INFO) << "Leader election decision for defunct term "
+  // A pre-election is run for the term after ours.
+  const auto expected_term = result.election_term - (data.preelection ? 1 : 0);
+  if (expected_term != state_->GetCurrentTermUnlocked()) {
+    LOG_WITH_PREFIX(INFO) << election_name << " decision for defunct term "
                           << result.election_term << ": "
                           << (result.decision == VOTE_GRANTED ? "won" : "lost");
     return;
@@ -2656,6 +2775,18 @@ void RaftConsensus::DoElectionCallback(const std::string& originator_uuid,
     return;
   }
 
+  if (data.preelection) {
+    LOG_WITH_PREFIX(INFO) << "Pre-election won for term " << result.election_term
+                          << ", starting leader election";
+    lock.unlock();
+    auto election_data = data;
+    election_data.preelection = PreElection::kFalse;
+    WARN_NOT_OK(DoStartElection(election_data, false /* pending_commit */,
+                                OpId::default_instance()),
+                LogPrefix() + "Failed to start leader election after pre-election");
+    return;
+  }
+
   LOG_WITH_PREFIX(INFO) << "Leader election won for term " << result.election_term;
 
   if (result.old_leader_lease_expiration) {
@@ -2769,6 +2900,37 @@ MonoDelta RaftConsensus::MinimumElectionTimeout() const {
   return MonoDelta::FromMilliseconds(failure_timeout);
 }
 
+MonoDelta RaftConsensus::LeaderFailureTimeoutUnlocked(const std::string& leader_uuid) {
+  if (FLAGS_leader_failure_phi_threshold <= 0) {
+    return MonoDelta();
+  }
+
+  const auto now = MonoTime::Now();
+  if (leader_heartbeat_detector_uuid_ != leader_uuid) {
+    // Intervals between messages from the previous leader say nothing about the new one.
+    if (!leader_heartbeat_detector_uuid_.empty()) {
+      WARN_NOT_OK(leader_heartbeat_detector_->UnTrack(leader_heartbeat_detector_uuid_),
+                  LogPrefix() + "Failed to stop tracking leader");
+    }
+    leader_heartbeat_detector_uuid_ = leader_uuid;
+    WARN_NOT_OK(leader_heartbeat_detector_->Track(
+                  leader_uuid, now, FailureDetector::FailureDetectedCallback()),
+                LogPrefix() + "Failed to track leader");
+    return MonoDelta();
+  }
+
+  WARN_NOT_OK(leader_heartbeat_detector_->MessageFrom(leader_uuid, now),
+              LogPrefix() + "Failed to record message from leader");
+  auto timeout = leader_heartbeat_detector_->FailureTimeout(
+      leader_uuid, kLeaderHeartbeatMinIntervals);
+  if (!timeout.Initialized()) {
+    return MonoDelta();
+  }
+  const auto min_timeout = MonoDelta::FromMilliseconds(
+      FLAGS_leader_failure_min_missed_heartbeat_periods * FLAGS_raft_heartbeat_interval_ms);
+  return std::min(std::max(timeout, min_timeout), MinimumElectionTimeout());
+}
+
 MonoDelta RaftConsensus::LeaderElectionExpBackoffDeltaUnlocked() {
   // Compute a backoff factor based on how many leader elections have
   // taken place since a leader was successfully elected.
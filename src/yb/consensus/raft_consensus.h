@@ -60,8 +60,10 @@ namespace yb {
 typedef std::lock_guard<simple_spinlock> Lock;
 typedef gscoped_ptr<Lock> ScopedLock;
 
+class AsyncIoExecutor;
 class Counter;
 class HostPort;
+class PhiAccrualFailureDetector;
 class ThreadPool;
 class ThreadPoolToken;
 
@@ -83,6 +85,7 @@ struct ElectionResult;
 constexpr int32_t kDefaultLeaderLeaseDurationMs = 2000;
 
 YB_STRONGLY_TYPED_BOOL(WriteEmpty);
+YB_STRONGLY_TYPED_BOOL(PreElection);
 
 class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
                       public Consensus,
@@ -105,7 +108,9 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     const Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     TableType table_type,
     ThreadPool* raft_pool,
-    RetryableRequests* retryable_requests);
+    RetryableRequests* retryable_requests,
+    MultiRaftManager* multi_raft_manager = nullptr,
+    AsyncIoExecutor* io_executor = nullptr);
 
   RaftConsensus(
     const ConsensusOptions& options,
@@ -143,6 +148,8 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   CHECKED_STATUS StepDown(const LeaderStepDownRequestPB* req,
                           LeaderStepDownResponsePB* resp) override;
 
+  CHECKED_STATUS TransferLeadership() override;
+
   CHECKED_STATUS TEST_Replicate(const ConsensusRoundPtr& round) override;
   CHECKED_STATUS ReplicateBatch(ConsensusRounds* rounds) override;
 
@@ -270,6 +277,19 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
       const std::string& originator_uuid,
       TEST_SuppressVoteRequest suppress_vote_request) override;
 
+  // Parameters of an election that are passed to its callback.
+  struct LeaderElectionData {
+    ElectionMode mode;
+    std::string originator_uuid;
+    // Whether this is a pre-election, after winning which the real election is started.
+    PreElection preelection;
+    TEST_SuppressVoteRequest suppress_vote_request;
+  };
+
+  CHECKED_STATUS DoStartElection(const LeaderElectionData& data,
+                                 bool pending_commit,
+                                 const OpId& must_be_committed_opid);
+
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
@@ -429,10 +449,15 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   CHECKED_STATUS RequestVoteRespondVoteGranted(const VoteRequestPB* request,
                                        VoteResponsePB* response);
 
+  // Respond to a pre-election VoteRequest that the vote would be granted for candidate.
+  // Neither the term nor the vote is persisted.
+  CHECKED_STATUS RequestVoteRespondPreElectionVoteGranted(const VoteRequestPB* request,
+                                                          VoteResponsePB* response);
+
   // Callback for leader election driver. ElectionCallback is run on the
   // reactor thread, so it simply defers its work to DoElectionCallback.
-  void ElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
-  void DoElectionCallback(const std::string& originator_uuid, const ElectionResult& result);
+  void ElectionCallback(const LeaderElectionData& data, const ElectionResult& result);
+  void DoElectionCallback(const LeaderElectionData& data, const ElectionResult& result);
   void NotifyOriginatorAboutLostElection(const std::string& originator_uuid);
 
   // Helper struct that tracks the RunLeaderElection as part of leadership transferral.
@@ -475,6 +500,12 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   // jitter, election timeouts may be longer than this.
   MonoDelta MinimumElectionTimeout() const;
 
+  // Records a message from the leader in the phi accrual detector and returns the time after which
+  // the leader should be considered failed. It adapts to the observed intervals between messages
+  // from the leader, and is between FLAGS_leader_failure_min_missed_heartbeat_periods heartbeat
+  // intervals and the minimum election timeout.
+  MonoDelta LeaderFailureTimeoutUnlocked(const std::string& leader_uuid);
+
   // Calculates a snooze delta for leader election.
   // The delta increases exponentially with the difference
   // between the current term and the term of the last committed
@@ -556,6 +587,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   CHECKED_STATUS WaitWritesUnlocked(const LeaderRequest& deduped_req,
                                     Synchronizer* log_synchronizer);
 
+  // Advances the committed index on a follower, applying the newly committed operations as one
+  // apply batch.
+  CHECKED_STATUS AdvanceCommittedIndexOnReplicaUnlocked(const OpId& committed_index);
+
   // See comment for ReplicaState::CancelPendingOperation
   void RollbackIdAndDeleteOpId(const ReplicateMsgPtr& replicate_msg, bool should_exists);
 
@@ -584,6 +619,10 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   std::shared_ptr<rpc::PeriodicTimer> failure_detector_;
 
+  // Tracks intervals between messages from the leader, to adapt the failure detection timeout.
+  scoped_refptr<PhiAccrualFailureDetector> leader_heartbeat_detector_;
+  std::string leader_heartbeat_detector_uuid_;
+
   // If any RequestVote() RPC arrives before this hybrid time,
   // the request will be ignored. This prevents abandoned or partitioned
   // nodes from disturbing the healthy leader.
@@ -1008,5 +1008,126 @@ TEST_F(RaftConsensusQuorumTest, TestRequestVote) {
   LOG(INFO) << "Follower rejected old heartbeat, as expected: " << res.ShortDebugString();
 }
 
+// A follower that stops hearing from the leader, e.g. because it is partitioned from it, starts
+// with a pre-election. Voters that still hear from the leader refuse it without advancing their
+// terms, so the leader keeps its leadership.
+TEST_F(RaftConsensusQuorumTest, TestPreElectionDoesNotDisruptLiveLeader) {
+  const int kCandidateIdx = 0;
+  const int kVoterIdx = 1;
+  const int kLeaderIdx = 2;
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_op_id;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 kLeaderIdx,
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, kCandidateIdx, kLeaderIdx);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, kVoterIdx, kLeaderIdx);
+  const int64_t term = last_op_id.term();
+
+  shared_ptr<RaftConsensus> candidate;
+  ASSERT_OK(peers_->GetPeerByIdx(kCandidateIdx, &candidate));
+  shared_ptr<RaftConsensus> voter;
+  ASSERT_OK(peers_->GetPeerByIdx(kVoterIdx, &voter));
+  shared_ptr<RaftConsensus> leader;
+  ASSERT_OK(peers_->GetPeerByIdx(kLeaderIdx, &leader));
+
+  VoteRequestPB request;
+  request.set_tablet_id(kTestTablet);
+  request.set_candidate_uuid(candidate->peer_uuid());
+  request.set_candidate_term(term + 1);
+  request.set_preelection(true);
+  request.mutable_candidate_status()->mutable_last_received()->CopyFrom(last_op_id);
+
+  // Neither the follower nor the leader votes while the leader is alive.
+  VoteResponsePB response;
+  ASSERT_OK(voter->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LEADER_IS_ALIVE, response.consensus_error().code());
+  response.Clear();
+  ASSERT_OK(leader->RequestVote(&request, &response));
+  ASSERT_FALSE(response.vote_granted());
+  ASSERT_EQ(ConsensusErrorPB::LEADER_IS_ALIVE, response.consensus_error().code());
+
+  // A granted pre-election vote is neither recorded nor advances the term of the voter.
+  request.set_ignore_live_leader(true);
+  response.Clear();
+  ASSERT_OK(voter->RequestVote(&request, &response));
+  ASSERT_TRUE(response.vote_granted());
+  ASSERT_EQ(term, response.responder_term());
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kVoterIdx, term));
+
+  // The pre-election run by the candidate, as when its failure detector fires, is lost.
+  ASSERT_OK(candidate->StartElection(Consensus::NORMAL_ELECTION));
+  SleepFor(MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms * 2));
+  ASSERT_EQ(RaftPeerPB::LEADER, leader->role());
+  ASSERT_EQ(RaftPeerPB::FOLLOWER, candidate->role());
+  for (int i = 0; i < 3; ++i) {
+    shared_ptr<RaftConsensus> peer;
+    ASSERT_OK(peers_->GetPeerByIdx(i, &peer));
+    ASSERT_EQ(term, peer->ConsensusState(CONSENSUS_CONFIG_ACTIVE).current_term());
+  }
+  ASSERT_NO_FATALS(AssertDurableTermWithoutVote(kCandidateIdx, term));
+
+  // The leader keeps replicating to all replicas in its term.
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 kLeaderIdx,
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  ASSERT_EQ(term, last_op_id.term());
+}
+
+// Once the leader is gone, the candidate wins the pre-election and then runs the real election,
+// which advances the term exactly once no matter how many pre-elections were lost before.
+TEST_F(RaftConsensusQuorumTest, TestPreElectionFollowedByElection) {
+  const int kCandidateIdx = 0;
+  const int kVoterIdx = 1;
+  const int kLeaderIdx = 2;
+  ASSERT_OK(BuildAndStartConfig(3));
+
+  OpId last_op_id;
+  vector<scoped_refptr<ConsensusRound> > rounds;
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 kLeaderIdx,
+                                 WAIT_FOR_ALL_REPLICAS,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, kCandidateIdx, kLeaderIdx);
+  WaitForCommitIfNotAlreadyPresent(last_op_id, kVoterIdx, kLeaderIdx);
+  const int64_t term = last_op_id.term();
+
+  shared_ptr<RaftConsensus> leader;
+  ASSERT_OK(peers_->GetPeerByIdx(kLeaderIdx, &leader));
+  leader->Shutdown();
+  peers_->RemovePeer(leader->peer_uuid());
+
+  // The voter refuses pre-elections until it would consider the leader failed itself.
+  shared_ptr<RaftConsensus> candidate;
+  ASSERT_OK(peers_->GetPeerByIdx(kCandidateIdx, &candidate));
+  ASSERT_OK(WaitFor([candidate]() -> Result<bool> {
+    RETURN_NOT_OK(candidate->StartElection(Consensus::NORMAL_ELECTION));
+    return candidate->WaitUntilLeaderForTests(MonoDelta::FromMilliseconds(500)).ok();
+  }, MonoDelta::FromSeconds(30), "Candidate becomes leader"));
+
+  ASSERT_EQ(term + 1, candidate->ConsensusState(CONSENSUS_CONFIG_ACTIVE).current_term());
+  ASSERT_NO_FATALS(AssertDurableTermAndVote(kCandidateIdx, term + 1, candidate->peer_uuid()));
+  ASSERT_NO_FATALS(AssertDurableTermAndVote(kVoterIdx, term + 1, candidate->peer_uuid()));
+
+  REPLICATE_SEQUENCE_OF_MESSAGES(10,
+                                 kCandidateIdx,
+                                 WAIT_FOR_MAJORITY,
+                                 COMMIT_ONE_BY_ONE,
+                                 &last_op_id,
+                                 &rounds);
+  ASSERT_EQ(term + 1, last_op_id.term());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -22,14 +22,30 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/intent_prefix_filter.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
 
+DEFINE_int32(transaction_conflict_wait_ms, 0,
+             "How long a transaction that conflicts with a pending transaction of higher priority "
+             "waits for it to commit or abort before failing with a conflict. 0 means failing "
+             "immediately. Since transactions only wait for transactions of higher priority, waits "
+             "cannot form a cycle. Locks of the waiting operation are held while it waits.");
+TAG_FLAG(transaction_conflict_wait_ms, advanced);
+TAG_FLAG(transaction_conflict_wait_ms, runtime);
+
+DEFINE_int32(transaction_conflict_wait_poll_ms, 10,
+             "Interval to re-check status of conflicting transactions, while waiting for them. "
+             "Used for transactions that were aborted elsewhere and not yet cleaned up locally.");
+TAG_FLAG(transaction_conflict_wait_poll_ms, advanced);
+TAG_FLAG(transaction_conflict_wait_poll_ms, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -105,6 +121,23 @@ class ConflictResolver {
     return status_manager_.Metadata(id);
   }
 
+  // Invoked when we conflict with a pending transaction of higher priority.
+  // Returns true if we should wait for it to complete, instead of failing.
+  bool WaitForHigherPriority() {
+    auto wait_ms = FLAGS_transaction_conflict_wait_ms;
+    if (wait_ms <= 0) {
+      return false;
+    }
+    auto now = MonoTime::Now();
+    if (!wait_deadline_.Initialized()) {
+      wait_deadline_ = now + MonoDelta::FromMilliseconds(wait_ms);
+    } else if (now >= wait_deadline_) {
+      return false;
+    }
+    wait_requested_ = true;
+    return true;
+  }
+
   CHECKED_STATUS Resolve() {
     RETURN_NOT_OK(context_.ReadConflicts(this));
     return ResolveConflicts();
@@ -112,13 +145,18 @@ class ConflictResolver {
 
   // Reads conflicts for specified intent from DB.
   CHECKED_STATUS ReadIntentConflicts(IntentType type, KeyBytes* intent_key_prefix) {
+    if (doc_db_.intent_prefix_filter &&
+        !doc_db_.intent_prefix_filter->MayHaveIntents(intent_key_prefix->AsSlice())) {
+      return Status::OK();
+    }
+
     EnsureIntentIteratorCreated();
 
     const auto& conflicting_intent_types = kIntentConflicts[static_cast<size_t>(type)];
 
-    KeyBytes upperbound_key(*intent_key_prefix);
-    upperbound_key.AppendValueType(ValueType::kMaxByte);
-    intent_key_upperbound_ = upperbound_key.AsSlice();
+    upperbound_key_buffer_.Reset(intent_key_prefix->AsSlice());
+    upperbound_key_buffer_.AppendValueType(ValueType::kMaxByte);
+    intent_key_upperbound_ = upperbound_key_buffer_.AsSlice();
 
     intent_key_prefix->AppendValueType(ValueType::kIntentType);
     BOOST_SCOPE_EXIT(intent_key_prefix, &intent_key_upperbound_) {
@@ -196,6 +234,15 @@ class ConflictResolver {
 
       RETURN_NOT_OK(context_.CheckPriority(this, &transactions_));
 
+      if (wait_requested_) {
+        // Transactions of lower priority are aborted once we are not waiting for anything else.
+        wait_requested_ = false;
+        status_manager().WaitForTransactionsCompletion(std::min(
+            wait_deadline_,
+            MonoTime::Now() + MonoDelta::FromMilliseconds(FLAGS_transaction_conflict_wait_poll_ms)));
+        continue;
+      }
+
       RETURN_NOT_OK(AbortTransactions());
 
       RETURN_NOT_OK(Cleanup());
@@ -311,11 +358,16 @@ class ConflictResolver {
   DocDB doc_db_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   Slice intent_key_upperbound_;
+  // Reusable buffer for intent_key_upperbound_, so reading conflicts of each intent does not
+  // allocate.
+  KeyBytes upperbound_key_buffer_;
   TransactionStatusManager& status_manager_;
   RequestScope request_scope_;
   ConflictResolverContext& context_;
   TransactionIdSet conflicts_;
   std::vector<TransactionData> transactions_;
+  MonoTime wait_deadline_;
+  bool wait_requested_ = false;
 };
 
 // Utility class for ResolveTransactionConflicts implementation.
@@ -406,7 +458,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
         transaction.metadata = std::move(*their_metadata);
       }
       auto their_priority = transaction.metadata.priority;
-      if (our_priority < their_priority) {
+      if (our_priority < their_priority && !resolver->WaitForHigherPriority()) {
         return MakeConflictStatus(transaction.id, "higher priority", conflicts_metric_);
       }
     }
@@ -15,8 +15,14 @@
 
 #include "yb/rocksdb/db/dbformat.h"
 
+#include "yb/gutil/endian.h"
+
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_kv_util.h"
+#include "yb/docdb/value.h"
+
+#include "yb/server/hybrid_clock.h"
 
 namespace yb {
 namespace docdb {
@@ -30,6 +36,7 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+constexpr rocksdb::UserBoundaryTag kExpirationTag = 2;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +87,69 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores the hybrid time when a record expires.
+// Encoded in big endian, so encoded values are ordered in the same way as hybrid times.
+class ExpirationValue : public rocksdb::UserBoundaryValue {
+ public:
+  explicit ExpirationValue(HybridTime value) : value_(value) {
+    BigEndian::Store64(buffer_, value.ToUint64());
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_FORMAT(Corruption, "Bad encoded expiration size: $0", data.size());
+    }
+
+    *value = std::make_shared<ExpirationValue>(HybridTime(BigEndian::Load64(data.data())));
+    return Status::OK();
+  }
+
+  virtual ~ExpirationValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kExpirationTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ExpirationValue*>(&pre_rhs);
+    return value_.CompareTo(rhs->value_);
+  }
+
+  HybridTime value() const {
+    return value_;
+  }
+
+ private:
+  HybridTime value_;
+  char buffer_[sizeof(uint64_t)];
+};
+
+// Returns the hybrid time when the record with the specified value, written at write_ht, expires
+// because of its own TTL. Records without TTL are expired by the table level TTL, that could be
+// altered later, so for them write_ht is returned and the table level TTL is applied by
+// FileExpirationTime.
+HybridTime RecordExpiration(HybridTime write_ht, Slice value) {
+  uint64_t merge_flags = 0;
+  MonoDelta ttl;
+  // TTL merge records change TTL of older records, so files containing them never expire.
+  if (!Value::DecodeMergeFlags(&value, &merge_flags).ok() || merge_flags != 0 ||
+      !Value::DecodeTTL(&value, &ttl).ok()) {
+    return HybridTime::kMax;
+  }
+  if (ttl.Equals(Value::kMaxTtl)) {
+    return write_ht;
+  }
+  if (ttl.ToMilliseconds() == kResetTTL) {
+    return HybridTime::kMax;
+  }
+  return server::HybridClock::AddPhysicalTimeToHybridTime(write_ht, ttl);
+}
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -138,6 +208,11 @@ class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
 
 class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
  public:
+  // Files with the expiration tag cannot be opened by versions that do not know it, so the tag is
+  // only written when track_expiration is set. It is always accepted when decoding.
+  explicit DocBoundaryValuesExtractor(bool track_expiration)
+      : track_expiration_(track_expiration) {}
+
   virtual ~DocBoundaryValuesExtractor() {}
 
   Status Decode(rocksdb::UserBoundaryTag tag,
@@ -147,6 +222,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kExpirationTag) {
+      return ExpirationValue::Create(data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -177,6 +255,14 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
 
+    // Values of intents start with transaction id and are never expired.
+    if (track_expiration_ && !value.empty() && value[0] != ValueTypeAsChar::kTransactionId) {
+      DocHybridTime doc_ht;
+      RETURN_NOT_OK(doc_ht.FullyDecodeFrom(slices.back()));
+      values->push_back(std::make_shared<ExpirationValue>(
+          RecordExpiration(doc_ht.hybrid_time(), value)));
+    }
+
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
       values->push_back(std::move(temp));
@@ -221,14 +307,43 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
 #endif
     return true;
   }
+
+ private:
+  const bool track_expiration_;
+};
+
+// Assigns files to time windows by the hybrid time of their latest record.
+class DocTimeWindowExtractor : public rocksdb::TimeWindowExtractor {
+ public:
+  explicit DocTimeWindowExtractor(MonoDelta window)
+      : window_micros_(std::max<int64_t>(window.ToMicroseconds(), 1)) {}
+
+  uint64_t TimeWindow(const rocksdb::UserBoundaryValues& largest) override {
+    DocHybridTime doc_ht;
+    // Files written before hybrid times were tracked are put to the earliest window.
+    if (!GetDocHybridTime(largest, &doc_ht).ok()) {
+      return 0;
+    }
+    return doc_ht.hybrid_time().GetPhysicalValueMicros() / window_micros_;
+  }
+
+ private:
+  const uint64_t window_micros_;
 };
 
 } // namespace
 
-std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance() {
+std::shared_ptr<rocksdb::TimeWindowExtractor> CreateDocTimeWindowExtractor(MonoDelta window) {
+  return std::make_shared<DocTimeWindowExtractor>(window);
+}
+
+std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance(
+    bool track_expiration) {
   static std::shared_ptr<rocksdb::BoundaryValuesExtractor> instance =
-      std::make_shared<DocBoundaryValuesExtractor>();
-  return instance;
+      std::make_shared<DocBoundaryValuesExtractor>(false);
+  static std::shared_ptr<rocksdb::BoundaryValuesExtractor> tracking_instance =
+      std::make_shared<DocBoundaryValuesExtractor>(true);
+  return track_expiration ? tracking_instance : instance;
 }
 
 // Used in tests
@@ -252,6 +367,20 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+HybridTime FileExpirationTime(const rocksdb::UserBoundaryValues& largest, MonoDelta table_ttl) {
+  if (table_ttl.Equals(Value::kMaxTtl)) {
+    return HybridTime::kMax;
+  }
+  // Files written before expiration was tracked don't have this value.
+  auto expiration = rocksdb::UserValueWithTag(largest, kExpirationTag);
+  DocHybridTime doc_ht;
+  if (!expiration || !GetDocHybridTime(largest, &doc_ht).ok()) {
+    return HybridTime::kMax;
+  }
+  return std::max(down_cast<ExpirationValue*>(expiration.get())->value(),
+                  server::HybridClock::AddPhysicalTimeToHybridTime(doc_ht.hybrid_time(), table_ttl));
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
@@ -251,6 +251,64 @@ CHECKED_STATUS DocExprExecutor::EvalAvg(const QLValue& val, QLValue *aggr_avg) {
   return Status::OK();
 }
 
+bool DocExprExecutor::IsMergeableAggregate(const QLBCallPB& tscall) {
+  switch (static_cast<TSOpcode>(tscall.opcode())) {
+    case TSOpcode::kCount: FALLTHROUGH_INTENDED;
+    case TSOpcode::kSum: FALLTHROUGH_INTENDED;
+    case TSOpcode::kMin: FALLTHROUGH_INTENDED;
+    case TSOpcode::kMax: FALLTHROUGH_INTENDED;
+    case TSOpcode::kAvg:
+      return true;
+    default:
+      return false;
+  }
+}
+
+CHECKED_STATUS DocExprExecutor::MergeAggregate(const QLBCallPB& tscall,
+                                               const QLValue& partial,
+                                               QLValue *aggr_result) {
+  if (partial.IsNull()) {
+    return Status::OK();
+  }
+  if (aggr_result->IsNull()) {
+    *aggr_result = partial;
+    return Status::OK();
+  }
+
+  switch (static_cast<TSOpcode>(tscall.opcode())) {
+    case TSOpcode::kCount:
+      aggr_result->set_int64_value(aggr_result->int64_value() + partial.int64_value());
+      return Status::OK();
+
+    case TSOpcode::kSum:
+      return EvalSum(partial, aggr_result);
+
+    case TSOpcode::kMin:
+      return EvalMin(partial, aggr_result);
+
+    case TSOpcode::kMax:
+      return EvalMax(partial, aggr_result);
+
+    case TSOpcode::kAvg: {
+      // Partial average is a map from count to sum, see EvalAvg.
+      const QLMapValuePB& partial_map = partial.map_value();
+      QLMapValuePB* map = aggr_result->mutable_map_value();
+      QLValue count(map->keys(0));
+      count.set_int64_value(count.int64_value() + partial_map.keys(0).int64_value());
+      QLValue sum(map->values(0));
+      RETURN_NOT_OK(EvalSum(QLValue(partial_map.values(0)), &sum));
+      *map->mutable_keys(0) = count.value();
+      *map->mutable_values(0) = sum.value();
+      return Status::OK();
+    }
+
+    default:
+      break;
+  }
+  return STATUS_SUBSTITUTE(NotSupported, "Cannot merge partial results of operator $0",
+                           tscall.opcode());
+}
+
 //--------------------------------------------------------------------------------------------------
 
 }  // namespace docdb
@@ -43,6 +43,13 @@ class DocExprExecutor : public QLExprExecutor {
   CHECKED_STATUS EvalMin(const QLValue& val, QLValue *aggr_min);
   CHECKED_STATUS EvalAvg(const QLValue& val, QLValue *aggr_avg);
 
+  // Whether partial results of the given aggregate call could be combined by MergeAggregate.
+  static bool IsMergeableAggregate(const QLBCallPB& tscall);
+
+  // Combines partial result of an aggregate call, computed over a subset of rows, into aggr_result.
+  CHECKED_STATUS MergeAggregate(const QLBCallPB& tscall, const QLValue& partial,
+                                QLValue *aggr_result);
+
  protected:
   virtual CHECKED_STATUS GetTupleId(QLValue *result) const;
   vector<QLValue> aggr_result_;
@@ -330,6 +330,50 @@ TEST(DocKeyTest, TestNumSharedPrefixComponents) {
                 PrimitiveValue("some_more"))));
 }
 
+TEST(DocKeyTest, TestSubDocKeyView) {
+  const DocKey doc_key(0x1234, {PrimitiveValue("a")}, {PrimitiveValue("b"), PrimitiveValue(10L)});
+  const SubDocKey k1(doc_key, PrimitiveValue("value"), PrimitiveValue(1000L),
+                     HybridTime::FromMicros(12345));
+  const KeyBytes encoded = k1.Encode();
+
+  SubDocKeyView view;
+  ASSERT_OK(view.FullyDecodeFrom(encoded.AsSlice()));
+  ASSERT_EQ(doc_key.Encode().AsSlice(), view.doc_key());
+  ASSERT_EQ(2U, view.num_subkeys());
+  ASSERT_EQ(k1.doc_hybrid_time(), view.doc_hybrid_time());
+  ASSERT_EQ(k1.EncodeWithoutHt().AsSlice(), view.encoded_without_hybrid_time());
+  PrimitiveValue subkey;
+  Slice subkey_slice = view.subkey(1);
+  ASSERT_OK(subkey.DecodeFromKey(&subkey_slice));
+  ASSERT_EQ(PrimitiveValue(1000L), subkey);
+
+  // The copy must stay valid after the original bytes are gone.
+  SubDocKeyView copy;
+  std::string buffer;
+  {
+    KeyBytes temp = k1.Encode();
+    SubDocKeyView temp_view;
+    ASSERT_OK(temp_view.FullyDecodeFrom(temp.AsSlice()));
+    copy.CopyFrom(temp_view, &buffer);
+  }
+  ASSERT_EQ(3, copy.NumSharedPrefixComponents(view));
+  ASSERT_EQ(k1.ToString(), copy.ToString());
+
+  SubDocKeyView other;
+  const KeyBytes other_encoded = SubDocKey(
+      doc_key, PrimitiveValue("value"), HybridTime::FromMicros(1)).Encode();
+  ASSERT_OK(other.FullyDecodeFrom(other_encoded.AsSlice()));
+  ASSERT_EQ(2, other.NumSharedPrefixComponents(view));
+  ASSERT_EQ(k1.NumSharedPrefixComponents(SubDocKey(doc_key, PrimitiveValue("value"))),
+            view.NumSharedPrefixComponents(other));
+
+  // Decoding errors are reported the same way as by SubDocKey.
+  const KeyBytes without_ht = k1.EncodeWithoutHt();
+  ASSERT_NOK(view.FullyDecodeFrom(without_ht.AsSlice()));
+  ASSERT_OK(view.FullyDecodeFrom(without_ht.AsSlice(), HybridTimeRequired::kFalse));
+  ASSERT_EQ(2U, view.num_subkeys());
+}
+
 std::string EncodeSubDocKey(const std::string& hash_key,
     const std::string& range_key, const std::string& sub_key, uint64_t time) {
   DocKey dk(DocKey(0, PrimitiveValues(hash_key), PrimitiveValues(range_key)));
@@ -373,6 +417,40 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestRangeComponentsKeyMatching) {
+  DocDbAwareFilterPolicy policy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr,
+                                1 /* num_range_components */);
+  DocDbAwareFilterPolicy hashed_policy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr);
+  ASSERT_STRNE(hashed_policy.Name(), policy.Name());
+  const auto* transformer = policy.GetKeyTransformer();
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& range_key : { "r1", "r2" }) {
+    builder->AddKey(transformer->Transform(EncodeSubDocKey("h", range_key, "sub_key", 12345L)));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& key) {
+    return reader->MayMatch(transformer->Transform(key));
+  };
+
+  ASSERT_TRUE(may_match(EncodeSubDocKey("h", "r1", "another_sub_key", 55555L)));
+  ASSERT_TRUE(may_match(EncodeSubDocKey("h", "r2", "sub_key", 12345L)));
+  ASSERT_FALSE(may_match(EncodeSubDocKey("h", "r3", "sub_key", 12345L)));
+  ASSERT_FALSE(may_match(EncodeSubDocKey("g", "r1", "sub_key", 12345L)));
+
+  // Scans could use the filter only when the prefix contains all filtered range components.
+  const KeyBytes range_prefix =
+      DocKey(0, PrimitiveValues("h"), PrimitiveValues("r1", "r2")).Encode();
+  ASSERT_TRUE(transformer->IsPrefixFilterable(range_prefix.AsSlice()));
+  const KeyBytes hashed_prefix = DocKey(0, PrimitiveValues("h")).Encode();
+  ASSERT_FALSE(transformer->IsPrefixFilterable(hashed_prefix.AsSlice()));
+  ASSERT_TRUE(hashed_policy.GetKeyTransformer()->IsPrefixFilterable(hashed_prefix.AsSlice()));
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
@@ -720,6 +720,104 @@ KeyBytes SubDocKey::AdvanceOutOfDocKeyPrefix() const {
   return doc_key_encoded;
 }
 
+// ------------------------------------------------------------------------------------------------
+// SubDocKeyView
+// ------------------------------------------------------------------------------------------------
+
+void SubDocKeyView::Clear() {
+  key_ = Slice();
+  without_ht_size_ = 0;
+  doc_key_ = Slice();
+  subkeys_.clear();
+  doc_ht_ = DocHybridTime::kInvalid;
+}
+
+Status SubDocKeyView::DecodeFrom(Slice* slice, HybridTimeRequired require_hybrid_time) {
+  Clear();
+  const Slice original_bytes(*slice);
+
+  const size_t doc_key_size = VERIFY_RESULT(
+      DocKey::EncodedSize(*slice, DocKeyPart::WHOLE_DOC_KEY));
+  doc_key_ = Slice(slice->data(), doc_key_size);
+  slice->remove_prefix(doc_key_size);
+  for (;;) {
+    const auto subkey_begin = slice->data();
+    auto decode_result = SubDocKey::DecodeSubkey(slice);
+    RETURN_NOT_OK_PREPEND(
+        decode_result,
+        Substitute("While decoding SubDocKey $0", ToShortDebugStr(original_bytes)));
+    if (!decode_result.get()) {
+      break;
+    }
+    subkeys_.emplace_back(subkey_begin, slice->data());
+  }
+  without_ht_size_ = slice->data() - original_bytes.data();
+
+  if (slice->empty()) {
+    if (!require_hybrid_time) {
+      key_ = Slice(original_bytes.data(), slice->data());
+      return Status::OK();
+    }
+    return STATUS_SUBSTITUTE(
+        Corruption,
+        "Found too few bytes in the end of a SubDocKey for a type-prefixed hybrid_time: $0",
+        ToShortDebugStr(*slice));
+  }
+
+  // Same reasoning as in SubDocKey::DoDecode.
+  DCHECK_EQ(ValueType::kHybridTime, DecodeValueType(*slice));
+  slice->consume_byte();
+  RETURN_NOT_OK(ConsumeHybridTimeFromKey(slice, &doc_ht_));
+  key_ = Slice(original_bytes.data(), slice->data());
+
+  return Status::OK();
+}
+
+Status SubDocKeyView::FullyDecodeFrom(const Slice& slice, HybridTimeRequired require_hybrid_time) {
+  Slice mutable_slice = slice;
+  Status status = DecodeFrom(&mutable_slice, require_hybrid_time);
+  if (!mutable_slice.empty()) {
+    return STATUS_SUBSTITUTE(InvalidArgument,
+        "Expected all bytes of the slice to be decoded into DocKey, found $0 extra bytes: $1",
+        mutable_slice.size(), ToShortDebugStr(mutable_slice));
+  }
+  return status;
+}
+
+void SubDocKeyView::CopyFrom(const SubDocKeyView& source, std::string* buffer) {
+  buffer->assign(source.key_.cdata(), source.key_.size());
+  const auto* new_base = util::to_uchar_ptr(buffer->data());
+  auto rebase = [&source, new_base](Slice slice) {
+    return Slice(new_base + (slice.data() - source.key_.data()), slice.size());
+  };
+
+  key_ = Slice(new_base, source.key_.size());
+  without_ht_size_ = source.without_ht_size_;
+  doc_key_ = rebase(source.doc_key_);
+  subkeys_.clear();
+  for (const auto& subkey : source.subkeys_) {
+    subkeys_.push_back(rebase(subkey));
+  }
+  doc_ht_ = source.doc_ht_;
+}
+
+int SubDocKeyView::NumSharedPrefixComponents(const SubDocKeyView& other) const {
+  if (doc_key_ != other.doc_key_) {
+    return 0;
+  }
+  const int min_num_subkeys = std::min(num_subkeys(), other.num_subkeys());
+  for (int i = 0; i < min_num_subkeys; ++i) {
+    if (subkeys_[i] != other.subkeys_[i]) {
+      return i + 1;
+    }
+  }
+  return min_num_subkeys + 1;
+}
+
+std::string SubDocKeyView::ToString() const {
+  return SubDocKey::DebugSliceToString(key_);
+}
+
 // ------------------------------------------------------------------------------------------------
 // DocDbAwareFilterPolicy
 // ------------------------------------------------------------------------------------------------
@@ -743,8 +841,68 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 };
 
+// Extracts hashed components and up to num_range_components first range components of the key.
+class RangeComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangeComponentsExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+
+  RangeComponentsExtractor(const RangeComponentsExtractor&) = delete;
+  RangeComponentsExtractor& operator=(const RangeComponentsExtractor&) = delete;
+
+  Slice Transform(Slice key) const override {
+    size_t num_decoded;
+    return Slice(key.data(), EncodedPrefixSize(key, &num_decoded));
+  }
+
+  bool IsPrefixFilterable(Slice key_prefix) const override {
+    size_t num_decoded;
+    EncodedPrefixSize(key_prefix, &num_decoded);
+    return num_decoded == num_range_components_;
+  }
+
+ private:
+  size_t EncodedPrefixSize(Slice key, size_t* num_decoded) const {
+    auto size = CHECK_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
+    Slice range_part(key.data() + size, key.size() - size);
+    for (*num_decoded = 0; *num_decoded < num_range_components_; ++*num_decoded) {
+      if (range_part.empty() || range_part[0] == ValueTypeAsChar::kGroupEnd) {
+        break;
+      }
+      // Keys shorter than num_range_components_, e.g. keys of static columns, are transformed to
+      // the decoded part.
+      Slice component = range_part;
+      if (!PrimitiveValue::DecodeKey(&component, nullptr /* out */).ok()) {
+        break;
+      }
+      range_part = component;
+    }
+    return range_part.data() - key.data();
+  }
+
+  const size_t num_range_components_;
+};
+
 } // namespace
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components,
+    bool use_blocked_bloom) {
+  const auto new_policy = use_blocked_bloom ? rocksdb::NewFixedSizeBlockedFilterPolicy
+                                            : rocksdb::NewFixedSizeFilterPolicy;
+  builtin_policy_.reset(new_policy(
+      filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+  const char* kind = use_blocked_bloom ? "Blocked" : "";
+  if (num_range_components == 0) {
+    name_ = Substitute("DocKeyHashedComponents$0Filter", kind);
+  } else {
+    range_components_extractor_ = std::make_unique<RangeComponentsExtractor>(num_range_components);
+    name_ = Substitute("DocKeyRangeComponents$0Filter$1", kind, num_range_components);
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() = default;
+
 
 void DocDbAwareFilterPolicy::CreateFilter(
     const rocksdb::Slice* keys, int n, std::string* dst) const {
@@ -771,6 +929,9 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
 }
 
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (range_components_extractor_) {
+    return range_components_extractor_.get();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
@@ -522,20 +522,92 @@ inline std::ostream& operator <<(std::ostream& out, const SubDocKey& subdoc_key)
   return out;
 }
 
+// ------------------------------------------------------------------------------------------------
+// SubDocKeyView
+// ------------------------------------------------------------------------------------------------
+
+// A non-owning decoded representation of a SubDocKey. Instead of materializing PrimitiveValues,
+// the document key and each of the subkeys are kept as slices pointing into the encoded key, so
+// the buffer the key was decoded from must outlive the view.
+//
+// The key encoding of primitive values is one-to-one, so comparing encoded components for
+// equality gives the same result as comparing decoded ones. This makes the view suitable for scan
+// and compaction paths that only need to compare or skip key components.
+class SubDocKeyView {
+ public:
+  SubDocKeyView() {}
+
+  void Clear();
+
+  // Same semantics as SubDocKey::DecodeFrom / SubDocKey::FullyDecodeFrom.
+  CHECKED_STATUS DecodeFrom(Slice* slice,
+                            HybridTimeRequired require_hybrid_time = HybridTimeRequired::kTrue);
+
+  CHECKED_STATUS FullyDecodeFrom(
+      const Slice& slice, HybridTimeRequired require_hybrid_time = HybridTimeRequired::kTrue);
+
+  // Copies the bytes referenced by source into buffer and makes this view refer to the copy. Used
+  // to keep a key across RocksDB iterations, when the original block buffer could go away.
+  void CopyFrom(const SubDocKeyView& source, std::string* buffer);
+
+  // Encoded document key, including the group end markers.
+  Slice doc_key() const {
+    return doc_key_;
+  }
+
+  size_t num_subkeys() const {
+    return subkeys_.size();
+  }
+
+  // Encoded subkey with the given index, starting with its value type.
+  Slice subkey(size_t index) const {
+    return subkeys_[index];
+  }
+
+  const DocHybridTime& doc_hybrid_time() const {
+    return doc_ht_;
+  }
+
+  // Encoded document key followed by all subkeys, i.e. the whole key without the hybrid time.
+  Slice encoded_without_hybrid_time() const {
+    return Slice(key_.data(), without_ht_size_);
+  }
+
+  // Same as SubDocKey::NumSharedPrefixComponents.
+  int NumSharedPrefixComponents(const SubDocKeyView& other) const;
+
+  std::string ToString() const;
+
+ private:
+  // All bytes consumed while decoding, other slices point into it.
+  Slice key_;
+  size_t without_ht_size_ = 0;
+  Slice doc_key_;
+  boost::container::small_vector<Slice, 8> subkeys_;
+  DocHybridTime doc_ht_;
+};
+
 // A best-effort to decode the given sequence of key bytes as either a DocKey or a SubDocKey.
 // If not possible to decode, return the key_bytes directly as a readable string.
 std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
-// This filter policy only takes into account hashed components of keys for filtering.
+// This filter policy only takes into account hashed components of keys for filtering, plus the
+// first num_range_components range components when that number is not zero. In the latter case a
+// scan could use the filter only when it fixes all of those range components.
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  // When use_blocked_bloom is true, filter blocks use NewFixedSizeBlockedFilterPolicy instead of
+  // NewFixedSizeFilterPolicy.
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components = 0,
+      bool use_blocked_bloom = false);
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  ~DocDbAwareFilterPolicy();
+
+  // Filters built with different number of range components or with different kinds of bloom
+  // filters are not compatible, so they are stored under different names.
+  const char* Name() const override { return name_.c_str(); }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -551,12 +623,18 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
 
  private:
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  std::unique_ptr<const KeyTransformer> range_components_extractor_;
+  std::string name_;
 };
 
+class IntentPrefixFilter;
+
 // Combined DB to store regular records and intents.
 struct DocDB {
   rocksdb::DB* regular;
   rocksdb::DB* intents;
+  // Summary of the intents stored in intents, lets conflict resolution skip seeks. Could be null.
+  const IntentPrefixFilter* intent_prefix_filter = nullptr;
 
   static DocDB FromRegular(rocksdb::DB* regular) {
     return {regular, nullptr /* intents */};
@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_kv_util.h"
 
 #include <string>
+#include <vector>
 
 #include "yb/docdb/value.h"
 #include "yb/util/test_macros.h"
@@ -114,6 +115,69 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make zero and 0xff bytes frequent, so both the escapes and the runs are exercised.
+      auto r = rng.Next() % 4;
+      s.push_back(r == 0 ? '\0' : r == 1 ? '\xff' : static_cast<char>(rng.Next()));
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str.append("suffix");
+    rocksdb::Slice slice(encoded_str);
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    ASSERT_EQ("suffix", slice.ToBuffer());
+  }
+}
+
+TEST(DocKVUtilTest, ZeroEncodingPerformance) {
+  rocksdb::Random rng(12345);
+  std::vector<string> strings(10000);
+  for (auto& s : strings) {
+    int len = 16 + rng.Next() % 64;
+    for (int j = 0; j < len; ++j) {
+      s.push_back(rng.Next() % 32 == 0 ? '\0' : static_cast<char>('a' + rng.Next() % 26));
+    }
+  }
+  const int kIterations = AllowSlowTests() ? 1000 : 50;
+  for (bool complement : {false, true}) {
+    std::vector<string> encoded(strings.size());
+    auto start = MonoTime::Now();
+    for (int i = 0; i != kIterations; ++i) {
+      for (size_t j = 0; j != strings.size(); ++j) {
+        encoded[j].clear();
+        if (complement) {
+          ComplementZeroEncodeAndAppendStrToKey(strings[j], &encoded[j]);
+        } else {
+          ZeroEncodeAndAppendStrToKey(strings[j], &encoded[j]);
+        }
+      }
+    }
+    auto encode_time = MonoTime::Now() - start;
+    start = MonoTime::Now();
+    string decoded;
+    for (int i = 0; i != kIterations; ++i) {
+      for (const auto& e : encoded) {
+        rocksdb::Slice slice(e);
+        decoded.clear();
+        ASSERT_OK_FAST(complement ? DecodeComplementZeroEncodedStr(&slice, &decoded)
+                                  : DecodeZeroEncodedStr(&slice, &decoded));
+      }
+    }
+    auto decode_time = MonoTime::Now() - start;
+    LOG(INFO) << (complement ? "Complement zero" : "Zero") << " encoding of "
+              << kIterations * strings.size() << " strings: " << encode_time
+              << ", decoding: " << decode_time;
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_kv_util.h"
 
+#include <string.h>
+
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
@@ -72,22 +74,48 @@ Status CheckHybridTimeSizeAndValueType(
   return Status::OK();
 }
 
+namespace {
+
+// Appends [begin, end) to dest, with every byte xor'ed with END_OF_STRING. The loop for '\xff' is
+// simple enough for the compiler to vectorize.
+template <char END_OF_STRING>
+inline void AppendXoredRun(const char* begin, const char* end, string* dest) {
+  if (END_OF_STRING == '\0') {
+    dest->append(begin, end);
+  } else {
+    const size_t old_size = dest->size();
+    dest->resize(old_size + (end - begin));
+    char* out = &(*dest)[old_size];
+    for (const char* p = begin; p != end; ++p, ++out) {
+      *out = *p ^ END_OF_STRING;
+    }
+  }
+}
+
+// Returns the first occurrence of c in [begin, end), or end. memchr scans with SIMD instructions.
+inline const char* FindChar(const char* begin, const char* end, char c) {
+  auto result = static_cast<const char*>(memchr(begin, static_cast<unsigned char>(c), end - begin));
+  return result ? result : end;
+}
+
+} // namespace
+
 template <char END_OF_STRING>
 void AppendEncodedStrToKey(const string &s, string *dest) {
   static_assert(END_OF_STRING == '\0' || END_OF_STRING == '\xff',
                 "Only characters '\0' and '\xff' allowed as a template parameter");
-  if (END_OF_STRING == '\0' && s.find('\0') == string::npos) {
-    // Fast path: no zero characters, nothing to encode.
-    dest->append(s);
-  } else {
-    for (char c : s) {
-      if (c == '\0') {
-        dest->push_back(END_OF_STRING);
-        dest->push_back(END_OF_STRING ^ 1);
-      } else {
-        dest->push_back(END_OF_STRING ^ c);
-      }
+  // Zero characters are escaped, the runs between them are copied in bulk.
+  const char* p = s.data();
+  const char* end = p + s.size();
+  for (;;) {
+    const char* zero = FindChar(p, end, '\0');
+    AppendXoredRun<END_OF_STRING>(p, zero, dest);
+    if (zero == end) {
+      break;
     }
+    dest->push_back(END_OF_STRING);
+    dest->push_back(END_OF_STRING ^ 1);
+    p = zero + 1;
   }
 }
 
@@ -122,34 +150,36 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* end = p + slice->size();
 
   while (p != end) {
+    // Copy the run up to the next END_OF_STRING character in bulk.
+    const char* run_end = FindChar(p, end, END_OF_STRING);
+    if (result != nullptr) {
+      AppendXoredRun<END_OF_STRING>(p, run_end, result);
+    }
+    p = run_end;
+    if (p == end) {
+      break;
+    }
+    ++p;
+    if (p == end) {
+      return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
+                                             END_OF_STRING));
+    }
     if (*p == END_OF_STRING) {
+      // Found two END_OF_STRING characters, this is the end of the encoded string.
       ++p;
-      if (p == end) {
-        return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
-                                               END_OF_STRING));
-      }
-      if (*p == END_OF_STRING) {
-        // Found two END_OF_STRING characters, this is the end of the encoded string.
-        ++p;
-        break;
-      }
-      if (*p == END_OF_STRING_ESCAPE) {
-        // Character END_OF_STRING is encoded as AB.
-        if (result != nullptr) {
-          result->push_back(END_OF_STRING ^ END_OF_STRING);
-        }
-        ++p;
-      } else {
-        return STATUS(Corruption, StringPrintf(
-            "Invalid sequence in encoded string: "
-            R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
-            END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
-      }
-    } else {
+      break;
+    }
+    if (*p == END_OF_STRING_ESCAPE) {
+      // Character END_OF_STRING is encoded as AB.
       if (result != nullptr) {
-        result->push_back((*p) ^ END_OF_STRING);
+        result->push_back(END_OF_STRING ^ END_OF_STRING);
       }
       ++p;
+    } else {
+      return STATUS(Corruption, StringPrintf(
+          "Invalid sequence in encoded string: "
+          R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
+          END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
     }
   }
   if (result != nullptr) {
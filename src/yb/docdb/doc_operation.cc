@@ -13,8 +13,13 @@
 
 #include "yb/docdb/doc_operation.h"
 
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
 #include "yb/common/jsonb.h"
 #include "yb/common/partition.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_protocol_util.h"
 #include "yb/common/ql_scanspec.h"
@@ -28,13 +33,16 @@
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/hot_key_value_cache.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/subdocument.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/stol_utils.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/redis_util.h"
 
@@ -42,6 +50,10 @@ DECLARE_bool(trace_docdb_calls);
 
 using strings::Substitute;
 
+DEFINE_int32(ql_scan_column_batch_size, 128,
+             "Number of rows decoded column-wise at once by CQL reads that return columns as is. "
+             "0 disables column batches.");
+
 DEFINE_bool(emulate_redis_responses,
     true,
     "If emulate_redis_responses is false, we hope to get slightly better performance by just "
@@ -49,6 +61,16 @@ DEFINE_bool(emulate_redis_responses,
     "and HDEL. If emulate_redis_responses is true, we read the required records to compute the "
     "response as specified by the official Redis API documentation. https://redis.io/commands");
 
+DEFINE_int32(redis_packed_collection_max_entries, 0,
+             "Redis hashes and sets with at most this number of entries are stored as a single "
+             "packed value instead of one key per entry. They are converted to one key per entry "
+             "when they grow past this limit or past redis_packed_collection_max_bytes. 0 disables "
+             "packing of new collections. Packed values cannot be read by older versions.");
+
+DEFINE_int32(redis_packed_collection_max_bytes, 512,
+             "Maximum encoded size of a packed Redis hash or set, see "
+             "redis_packed_collection_max_entries.");
+
 DEFINE_test_flag(bool, pause_write_apply_after_if, false,
                  "Pause application of QLWriteOperation after evaluating if condition.");
 
@@ -162,7 +184,8 @@ Result<RedisDataType> GetRedisValueType(
     const RedisKeyValuePB &key_value_pb,
     DocWriteBatch* doc_write_batch = nullptr,
     int subkey_index = kNilSubkeyIndex,
-    bool always_override = false) {
+    bool always_override = false,
+    ValueType* found_value_type = nullptr) {
   if (!key_value_pb.has_key()) {
     return STATUS(Corruption, "Expected KeyValuePB");
   }
@@ -206,12 +229,17 @@ Result<RedisDataType> GetRedisValueType(
     return REDIS_TYPE_NONE;
   }
 
+  if (found_value_type) {
+    *found_value_type = doc.value_type();
+  }
   switch (doc.value_type()) {
     case ValueType::kInvalid: FALLTHROUGH_INTENDED;
     case ValueType::kTombstone:
       return REDIS_TYPE_NONE;
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
     case ValueType::kObject:
       return REDIS_TYPE_HASH;
+    case ValueType::kPackedRedisSet: FALLTHROUGH_INTENDED;
     case ValueType::kRedisSet:
       return REDIS_TYPE_SET;
     case ValueType::kRedisTS:
@@ -406,6 +434,34 @@ CHECKED_STATUS AddResponseValuesSortedSets(const PrimitiveValue& first,
   return Status::OK();
 }
 
+// Appends children of a collection subdocument directly to the redis array response, so
+// HGETALL-like commands don't need to build the whole collection in memory.
+class RedisResponseArrayVisitor : public DocVisitor {
+ public:
+  RedisResponseArrayVisitor(RedisArrayPB* array, bool add_keys, bool add_values)
+      : array_(array), add_keys_(add_keys), add_values_(add_values) {}
+
+  CHECKED_STATUS StartSubDocument(const SubDocKey &key) override { return Status::OK(); }
+  CHECKED_STATUS EndSubDocument() override { return Status::OK(); }
+  CHECKED_STATUS StartObject() override { return Status::OK(); }
+  CHECKED_STATUS EndObject() override { return Status::OK(); }
+  CHECKED_STATUS StartArray() override { return Status::OK(); }
+  CHECKED_STATUS EndArray() override { return Status::OK(); }
+
+  CHECKED_STATUS VisitKey(const PrimitiveValue& key) override {
+    return add_keys_ ? AddPrimitiveValueToResponseArray(key, array_) : Status::OK();
+  }
+
+  CHECKED_STATUS VisitValue(const PrimitiveValue& value) override {
+    return add_values_ ? AddPrimitiveValueToResponseArray(value, array_) : Status::OK();
+  }
+
+ private:
+  RedisArrayPB* array_;
+  const bool add_keys_;
+  const bool add_values_;
+};
+
 template <typename T, typename AddResponseRow>
 CHECKED_STATUS PopulateRedisResponseFromInternal(T iter,
                                                  AddResponseRow add_response_row,
@@ -496,6 +552,99 @@ CHECKED_STATUS GetAndPopulateResponseValues(
   return Status::OK();
 }
 
+// Populates the response with sorted set members that have indexes in [low_idx, high_idx] in
+// ascending order of scores, scanning the forward mapping backward from its end.
+// So only card - low_idx entries are visited instead of high_idx + 1 entries for the forward scan,
+// that makes queries for the highest ranks, like ZREVRANGE key 0 N, independent of the set size.
+// Returns false if an entry of unexpected layout was found, so the forward scan should be used.
+Result<bool> GetSortedSetRangeFromEnd(IntentAwareIterator* iterator,
+                                      const RedisKeyValuePB& key_value,
+                                      int64_t card,
+                                      int64_t low_idx,
+                                      int64_t high_idx,
+                                      bool add_scores,
+                                      bool reverse,
+                                      RedisResponsePB* response) {
+  auto encoded_doc_key = DocKey::EncodedFromRedisKey(key_value.hash_code(), key_value.key());
+  IntentAwareIteratorPrefixScope prefix_scope(encoded_doc_key, iterator);
+
+  // Entries written before the latest overwrite of the sorted set, i.e. before it was deleted and
+  // created again, are not visible.
+  DocHybridTime max_overwrite_ht(DocHybridTime::kMin);
+  Expiration exp;
+  iterator->Seek(encoded_doc_key.AsSlice());
+  RETURN_NOT_OK(FindLastWriteTime(iterator, encoded_doc_key, &max_overwrite_ht, &exp));
+  KeyBytes forward_prefix = encoded_doc_key;
+  PrimitiveValue(ValueType::kSSForward).AppendToKey(&forward_prefix);
+  RETURN_NOT_OK(FindLastWriteTime(iterator, forward_prefix, &max_overwrite_ht, &exp));
+
+  const size_t entries_to_skip = card - 1 - high_idx;
+  const size_t entries_to_return = high_idx - low_idx + 1;
+  // Pairs of member and score in descending order.
+  std::vector<std::pair<PrimitiveValue, PrimitiveValue>> entries;
+  entries.reserve(entries_to_return);
+  size_t skipped_entries = 0;
+
+  KeyBytes seek_key = forward_prefix;
+  seek_key.AppendValueType(ValueType::kMaxByte);
+  iterator->PrevSubDocKey(seek_key);
+  SubDocKey found_key;
+  DocHybridTime doc_ht;
+  while (iterator->valid() && entries.size() < entries_to_return) {
+    auto key_slice = VERIFY_RESULT(iterator->FetchKey(&doc_ht));
+    if (!key_slice.starts_with(forward_prefix)) {
+      break;
+    }
+    RETURN_NOT_OK(found_key.FullyDecodeFrom(key_slice, HybridTimeRequired::kFalse));
+    // Forward mapping entry is kSSForward -> score -> member.
+    if (found_key.num_subkeys() != 3) {
+      return false;
+    }
+    if (doc_ht >= max_overwrite_ht) {
+      ValueType value_type;
+      uint64_t merge_flags = 0;
+      MonoDelta entry_ttl;
+      RETURN_NOT_OK(Value::DecodePrimitiveValueType(
+          iterator->value(), &value_type, &merge_flags, &entry_ttl));
+      if (merge_flags == Value::kTtlFlag) {
+        return false;
+      }
+      bool alive = value_type != ValueType::kTombstone;
+      if (alive && entry_ttl != Value::kMaxTtl) {
+        bool has_expired = false;
+        RETURN_NOT_OK(HasExpiredTTL(
+            doc_ht.hybrid_time(), entry_ttl, iterator->read_time().read, &has_expired));
+        alive = !has_expired;
+      }
+      if (alive) {
+        if (skipped_entries < entries_to_skip) {
+          ++skipped_entries;
+        } else {
+          entries.emplace_back(found_key.subkeys()[2], found_key.subkeys()[1]);
+        }
+      }
+    }
+    iterator->PrevSubDocKey(KeyBytes(key_slice));
+  }
+
+  response->set_allocated_array_response(new RedisArrayPB());
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+  auto add_entry = [response, add_scores](const std::pair<PrimitiveValue, PrimitiveValue>& entry) {
+    return AddResponseValuesGeneric(entry.first, entry.second, response,
+                                    /* add_keys */ true, /* add_values */ add_scores);
+  };
+  if (reverse) {
+    for (const auto& entry : entries) {
+      RETURN_NOT_OK(add_entry(entry));
+    }
+  } else {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+      RETURN_NOT_OK(add_entry(*it));
+    }
+  }
+  return true;
+}
+
 // Get normalized (with respect to card) upper and lower index bounds for reverse range scans.
 void GetNormalizedBounds(int64 low_idx, int64 high_idx, int64 card, bool reverse,
                          int64* low_idx_normalized, int64* high_idx_normalized) {
@@ -611,6 +760,99 @@ Result<RedisDataType> RedisWriteOperation::GetValueType(
       iterator_.get(), request_.key_value(), data.doc_write_batch, subkey_index);
 }
 
+Result<bool> RedisWriteOperation::ReadPackedCollection(
+    const DocOperationApplyData& data, SubDocument* collection, Expiration* exp) {
+  if (!iterator_) {
+    InitializeIterator(data);
+  }
+  ValueType value_type = ValueType::kInvalid;
+  RETURN_NOT_OK(GetRedisValueType(
+      iterator_.get(), request_.key_value(), data.doc_write_batch, kNilSubkeyIndex,
+      /* always_override */ false, &value_type));
+  if (!IsPackedCollectionType(value_type)) {
+    return false;
+  }
+  const RedisKeyValuePB& kv = request_.key_value();
+  auto encoded_doc_key = DocKey::EncodedFromRedisKey(kv.hash_code(), kv.key());
+  bool doc_found = false;
+  GetSubDocumentData get_data = { encoded_doc_key, collection, &doc_found };
+  RETURN_NOT_OK(GetSubDocument(
+      iterator_.get(), get_data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
+  if (!doc_found) {
+    return false;
+  }
+  *exp = get_data.exp;
+  return true;
+}
+
+Status RedisWriteOperation::WriteRedisCollection(
+    const DocOperationApplyData& data, SubDocument collection, MonoDelta ttl) {
+  const RedisKeyValuePB& kv = request_.key_value();
+  DocPath doc_path = DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key());
+  const int num_entries = collection.object_num_keys();
+  if (num_entries == 0) {
+    // Like in Redis, removing the last entry of a collection removes its key.
+    return data.doc_write_batch->SetPrimitive(
+        doc_path, Value::Tombstone(), data.read_time, data.deadline, redis_query_id());
+  }
+  if (num_entries <= FLAGS_redis_packed_collection_max_entries) {
+    PrimitiveValue packed;
+    RETURN_NOT_OK(collection.ToPackedValue(&packed));
+    if (packed.GetPackedCollection().size() <=
+        static_cast<size_t>(std::max(FLAGS_redis_packed_collection_max_bytes, 0))) {
+      return data.doc_write_batch->SetPrimitive(
+          doc_path, Value(packed, ttl), data.read_time, data.deadline, redis_query_id());
+    }
+  }
+  // The collection outgrew the packing limits: write every entry as its own key.
+  return data.doc_write_batch->InsertSubDocument(
+      doc_path, collection, data.read_time, data.deadline, redis_query_id(), ttl);
+}
+
+Result<bool> RedisWriteOperation::ApplyToPackedCollection(
+    const DocOperationApplyData& data, const SubDocument& changes, RedisDataType data_type,
+    MonoDelta entry_ttl) {
+  SubDocument collection;
+  Expiration exp;
+  const bool packed = VERIFY_RESULT(ReadPackedCollection(data, &collection, &exp));
+  if (!packed && (data_type != REDIS_TYPE_NONE || entry_ttl != Value::kMaxTtl ||
+                  FLAGS_redis_packed_collection_max_entries <= 0)) {
+    return false;
+  }
+  const MonoDelta ttl = packed ?
+      VERIFY_RESULT(exp.ComputeRelativeTtl(data.read_time.read)) : Value::kMaxTtl;
+  if (entry_ttl != Value::kMaxTtl) {
+    // Entries with their own TTL can only be stored one key per entry.
+    const RedisKeyValuePB& kv = request_.key_value();
+    DocPath doc_path = DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key());
+    RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
+        doc_path, collection, data.read_time, data.deadline, redis_query_id(), ttl));
+    RETURN_NOT_OK(data.doc_write_batch->ExtendSubDocument(
+        doc_path, changes, data.read_time, data.deadline, redis_query_id(), entry_ttl));
+    return true;
+  }
+  const bool is_set =
+      data_type == REDIS_TYPE_SET || changes.value_type() == ValueType::kRedisSet;
+  SubDocument merged;
+  if (packed) {
+    for (auto& entry : collection.object_container()) {
+      merged.SetChild(entry.first, std::move(entry.second));
+    }
+  }
+  for (const auto& change : changes.object_container()) {
+    if (change.second.value_type() == ValueType::kTombstone) {
+      merged.DeleteChild(change.first);
+    } else {
+      merged.SetChild(change.first, SubDocument(change.second));
+    }
+  }
+  if (is_set && merged.object_num_keys() > 0) {
+    RETURN_NOT_OK(merged.ConvertToRedisSet());
+  }
+  RETURN_NOT_OK(WriteRedisCollection(data, std::move(merged), ttl));
+  return true;
+}
+
 Result<RedisValue> RedisWriteOperation::GetValue(
     const DocOperationApplyData& data, int subkey_index, Expiration* ttl) {
   if (!iterator_) {
@@ -620,6 +862,26 @@ Result<RedisValue> RedisWriteOperation::GetValue(
                        subkey_index, /* always_override */ false, ttl);
 }
 
+bool RedisWriteOperation::GetCachedValue(const DocOperationApplyData& data, RedisValue* value) {
+  if (data.hot_key_value_cache == nullptr) {
+    return false;
+  }
+  const RedisKeyValuePB& kv = request_.key_value();
+  auto encoded_doc_key = DocKey::EncodedFromRedisKey(kv.hash_code(), kv.key());
+  if (data.doc_write_batch->LookupCache(encoded_doc_key)) {
+    // The key is modified by a preceding operation in this batch, which is not applied yet.
+    return false;
+  }
+  HybridTime write_time;
+  if (!data.hot_key_value_cache->Get(
+          encoded_doc_key.AsSlice(), data.read_time.read, &value->value, &write_time)) {
+    return false;
+  }
+  value->type = REDIS_TYPE_STRING;
+  value->exp = Expiration(write_time);
+  return true;
+}
+
 Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
   const RedisKeyValuePB& kv = request_.key_value();
   const MonoDelta ttl = request_.set_request().has_ttl() ?
@@ -659,6 +921,10 @@ Status RedisWriteOperation::ApplySet(const DocOperationApplyData& data) {
           // If flag is false, no int response is returned.
           SetOptionalInt(*type, 0, 1, &response_);
         }
+        if (kv.type() == REDIS_TYPE_HASH &&
+            VERIFY_RESULT(ApplyToPackedCollection(data, kv_entries, *data_type, ttl))) {
+          break;
+        }
         if (*data_type == REDIS_TYPE_NONE && kv.type() == REDIS_TYPE_TIMESERIES) {
           // Need to insert the document instead of extending it.
           RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
@@ -897,6 +1163,16 @@ Status RedisWriteOperation::ApplySetTtl(const DocOperationApplyData& data) {
       MonoDelta::FromMilliseconds(request_.set_ttl_request().ttl());
   }
 
+  SubDocument packed_collection;
+  Expiration packed_exp;
+  if (VERIFY_RESULT(ReadPackedCollection(data, &packed_collection, &packed_exp))) {
+    // A TTL-only entry would hide the older packed value from readers, so the packed collection
+    // is rewritten with the new TTL instead.
+    RETURN_NOT_OK(WriteRedisCollection(data, std::move(packed_collection), ttl));
+    response_.set_int_response(1);
+    return Status::OK();
+  }
+
   ValueType v_type = ValueTypeFromRedisType(value->type);
   if (v_type == ValueType::kInvalid)
     return STATUS(Corruption, "Invalid value type.");
@@ -939,8 +1215,11 @@ Status RedisWriteOperation::ApplyAppend(const DocOperationApplyData& data) {
         "Append kv should have 1 value, found $0", kv.value_size());
   }
 
-  auto value = GetValue(data);
-  RETURN_NOT_OK(value);
+  Result<RedisValue> value = RedisValue();
+  if (!GetCachedValue(data, &*value)) {
+    value = GetValue(data);
+    RETURN_NOT_OK(value);
+  }
 
   if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
                             VerifySuccessIfMissing::kTrue)) {
@@ -958,7 +1237,7 @@ Status RedisWriteOperation::ApplyAppend(const DocOperationApplyData& data) {
   return data.doc_write_batch->SetPrimitive(
       DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()),
       Value(PrimitiveValue(value->value),
-            VERIFY_RESULT(value->exp.ComputeRelativeTtl(iterator_->read_time().read))),
+            VERIFY_RESULT(value->exp.ComputeRelativeTtl(data.read_time.read))),
       data.read_time,
       data.deadline,
       redis_query_id());
@@ -1064,7 +1343,9 @@ Status RedisWriteOperation::ApplyDel(const DocOperationApplyData& data) {
     }
   }
 
-  if (num_keys != 0) {
+  const bool packable = kv.type() == REDIS_TYPE_HASH || kv.type() == REDIS_TYPE_SET;
+  if (num_keys != 0 &&
+      (!packable || !VERIFY_RESULT(ApplyToPackedCollection(data, values, *data_type)))) {
     DocPath doc_path = DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key());
     RETURN_NOT_OK(data.doc_write_batch->ExtendSubDocument(doc_path, values,
         data.read_time, data.deadline, redis_query_id()));
@@ -1119,17 +1400,21 @@ Status RedisWriteOperation::ApplyIncr(const DocOperationApplyData& data) {
                              "Redis data type $0 not supported in Incr command", kv.type());
   }
 
-  auto container_type = GetValueType(data);
-  RETURN_NOT_OK(container_type);
-  if (!VerifyTypeAndSetCode(kv.type(), *container_type, &response_,
-                            VerifySuccessIfMissing::kTrue)) {
-    // We've already set the error code in the response.
-    return Status::OK();
-  }
+  // A cached value is always a top-level string, so the container type check is skipped for it.
+  Result<RedisValue> value = RedisValue();
+  RedisDataType container_type = REDIS_TYPE_NONE;
+  if (kv.type() != REDIS_TYPE_STRING || !GetCachedValue(data, &*value)) {
+    container_type = VERIFY_RESULT(GetValueType(data));
+    if (!VerifyTypeAndSetCode(kv.type(), container_type, &response_,
+                              VerifySuccessIfMissing::kTrue)) {
+      // We've already set the error code in the response.
+      return Status::OK();
+    }
 
-  int subkey = (kv.type() == REDIS_TYPE_HASH ? 0 : -1);
-  auto value = GetValue(data, subkey);
-  RETURN_NOT_OK(value);
+    int subkey = (kv.type() == REDIS_TYPE_HASH ? 0 : -1);
+    value = GetValue(data, subkey);
+    RETURN_NOT_OK(value);
+  }
 
   if (!VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
       VerifySuccessIfMissing::kTrue)) {
@@ -1169,13 +1454,21 @@ Status RedisWriteOperation::ApplyIncr(const DocOperationApplyData& data) {
     PrimitiveValue subkey_value;
     RETURN_NOT_OK(PrimitiveValueFromSubKeyStrict(kv.subkey(0), kv.type(), &subkey_value));
     kv_entries.SetChild(subkey_value, SubDocument(new_pvalue));
+    if (VERIFY_RESULT(ApplyToPackedCollection(data, kv_entries, container_type))) {
+      return Status::OK();
+    }
     return data.doc_write_batch->ExtendSubDocument(
         doc_path, kv_entries, data.read_time, data.deadline, redis_query_id());
   } else {  // kv.type() == REDIS_TYPE_STRING
     // TODO: update the TTL with the write time rather than read time,
     // or store the expiration.
     Value new_val = Value(new_pvalue,
-        VERIFY_RESULT(value->exp.ComputeRelativeTtl(iterator_->read_time().read)));
+        VERIFY_RESULT(value->exp.ComputeRelativeTtl(data.read_time.read)));
+    if (!iterator_) {
+      // The value was found in the hot key value cache, so no iterator was created.
+      return data.doc_write_batch->SetPrimitive(
+          doc_path, new_val, data.read_time, data.deadline, redis_query_id());
+    }
     return data.doc_write_batch->SetPrimitive(doc_path, new_val, std::move(iterator_));
   }
 }
@@ -1304,14 +1597,14 @@ Status RedisWriteOperation::ApplyAdd(const DocOperationApplyData& data) {
 
   RETURN_NOT_OK(set_entries.ConvertToRedisSet());
 
-  Status s;
-
-  if (*data_type == REDIS_TYPE_NONE) {
-    RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
-        doc_path, set_entries, data.read_time, data.deadline, redis_query_id()));
-  } else {
-    RETURN_NOT_OK(data.doc_write_batch->ExtendSubDocument(
-        doc_path, set_entries, data.read_time, data.deadline, redis_query_id()));
+  if (!VERIFY_RESULT(ApplyToPackedCollection(data, set_entries, *data_type))) {
+    if (*data_type == REDIS_TYPE_NONE) {
+      RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
+          doc_path, set_entries, data.read_time, data.deadline, redis_query_id()));
+    } else {
+      RETURN_NOT_OK(data.doc_write_batch->ExtendSubDocument(
+          doc_path, set_entries, data.read_time, data.deadline, redis_query_id()));
+    }
   }
 
   response_.set_code(RedisResponsePB_RedisStatusCode_OK);
@@ -1386,10 +1679,18 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
     data.count_only = !return_array_response;
   }
 
+  boost::optional<RedisResponseArrayVisitor> visitor;
+  if (return_array_response) {
+    response_.set_allocated_array_response(new RedisArrayPB());
+    if (!has_cardinality_subkey) {
+      // Stream hash and set members directly to the response.
+      visitor.emplace(response_.mutable_array_response(), add_keys, add_values);
+      data.visitor = visitor.get_ptr();
+    }
+  }
+
   RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
                                SeekFwdSuffices::kFalse));
-  if (return_array_response)
-    response_.set_allocated_array_response(new RedisArrayPB());
 
   if (!doc_found) {
     response_.set_code(RedisResponsePB_RedisStatusCode_OK);
@@ -1400,8 +1701,11 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
 
   if (VerifyTypeAndSetCode(value_type, doc.value_type(), &response_)) {
     if (return_array_response) {
-      RETURN_NOT_OK(PopulateResponseFrom(doc.object_container(), AddResponseValuesGeneric,
-                                         &response_, add_keys, add_values));
+      // Hash and set members are primitive, so all of them were already streamed by visitor.
+      if (!visitor) {
+        RETURN_NOT_OK(PopulateResponseFrom(doc.object_container(), AddResponseValuesGeneric,
+                                           &response_, add_keys, add_values));
+      }
     } else {
       int64_t card = has_cardinality_subkey ?
         VERIFY_RESULT(GetCardinality(iterator_.get(), request_.key_value())) :
@@ -1409,6 +1713,9 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
       response_.set_int_response(card);
       response_.set_code(RedisResponsePB_RedisStatusCode_OK);
     }
+  } else if (visitor) {
+    // Drop members of a value of wrong type that were streamed before its type was checked.
+    response_.mutable_array_response()->Clear();
   }
   return Status::OK();
 }
@@ -1589,12 +1896,24 @@ Status RedisReadOperation::ExecuteCollectionGetRange() {
                                            true));
         return Status::OK();
       }
+
+      bool add_keys = request_.get_collection_range_request().with_scores();
+
+      // Forward scan visits high_idx_normalized + 1 entries, while backward scan visits
+      // card - low_idx_normalized entries.
+      if (card - low_idx_normalized < high_idx_normalized + 1) {
+        bool done = VERIFY_RESULT(GetSortedSetRangeFromEnd(
+            iterator_.get(), request_.key_value(), card, low_idx_normalized, high_idx_normalized,
+            add_keys, reverse, &response_));
+        if (done) {
+          break;
+        }
+      }
+
       auto encoded_doc_key = DocKey::EncodedFromRedisKey(
           request_.key_value().hash_code(), request_.key_value().key());
       PrimitiveValue(ValueType::kSSForward).AppendToKey(&encoded_doc_key);
 
-      bool add_keys = request_.get_collection_range_request().with_scores();
-
       IndexBound low_bound = IndexBound(low_idx_normalized, true /* is_lower */);
       IndexBound high_bound = IndexBound(high_idx_normalized, false /* is_lower */);
 
@@ -1890,16 +2209,31 @@ Status RedisReadOperation::ExecuteGetRange() {
 }
 
 Status RedisReadOperation::ExecuteKeys() {
-  iterator_->Seek(DocKey());
-  int threshold = request_.keys_request().threshold();
+  const auto& keys_request = request_.keys_request();
+  if (keys_request.has_start_hash_code()) {
+    iterator_->Seek(DocKey(keys_request.start_hash_code(), {}, {}));
+  } else {
+    iterator_->Seek(DocKey());
+  }
+  int threshold = keys_request.has_threshold() ? keys_request.threshold()
+                                               : numeric_limits<int>::max();
+  int remaining_to_examine = keys_request.has_count() ? keys_request.count()
+                                                      : numeric_limits<int>::max();
+  boost::optional<DocKeyHash> stop_after_hash;
 
   while (iterator_->valid()) {
     auto key = VERIFY_RESULT(iterator_->FetchKey());
     DocKey doc_key;
     RETURN_NOT_OK(doc_key.FullyDecodeFrom(key));
+    if (stop_after_hash && doc_key.hash() != *stop_after_hash) {
+      // Keys with the same hash code are always returned by the same request, so SCAN could
+      // resume from the next hash code.
+      response_.set_next_hash_code(*stop_after_hash + 1);
+      break;
+    }
     const PrimitiveValue& key_primitive = doc_key.hashed_group().front();
     if (key_primitive.IsString() &&
-        RedisUtil::RedisPatternMatch(request_.keys_request().pattern(),
+        RedisUtil::RedisPatternMatch(keys_request.pattern(),
                                      key_primitive.GetString(),
                                      false)) {
       if (--threshold < 0) {
@@ -1911,6 +2245,9 @@ Status RedisReadOperation::ExecuteKeys() {
       RETURN_NOT_OK(AddPrimitiveValueToResponseArray(key_primitive,
                                                      response_.mutable_array_response()));
     }
+    if (--remaining_to_examine == 0 && doc_key.hash() != numeric_limits<DocKeyHash>::max()) {
+      stop_after_hash = doc_key.hash();
+    }
     iterator_->SeekOutOfSubDoc(key);
   }
 
@@ -2047,6 +2384,39 @@ bool JoinNonStaticRow(
   return join_successful;
 }
 
+void RemoveColumnRef(int32_t column_id, google::protobuf::RepeatedField<int32_t>* ids) {
+  ids->erase(std::remove(ids->begin(), ids->end(), column_id), ids->end());
+}
+
+// The analyzer references a list column assigned by index, i.e. `l[i] = v`, so the row is read
+// before the write. But ReplaceCqlInList finds the element by its own scan of the list, so the
+// list does not have to be read with the rest of the row, unless the column is also referenced in
+// a condition, in the status row or by an index, or assigned without a subscript.
+void RemoveListIndexColumnRefs(const Schema& schema, QLWriteRequestPB* request) {
+  if (!request->has_column_refs() || request->has_if_expr() || request->returns_status() ||
+      !request->update_index_ids().empty()) {
+    return;
+  }
+  std::unordered_set<int32_t> subscripted, unsubscripted;
+  for (const auto& column_value : request->column_values()) {
+    if (column_value.subscript_args().empty()) {
+      unsubscripted.insert(column_value.column_id());
+      continue;
+    }
+    const auto column = schema.column_by_id(ColumnId(column_value.column_id()));
+    if (column.ok() && column->type()->main() == LIST) {
+      subscripted.insert(column_value.column_id());
+    }
+  }
+  auto* column_refs = request->mutable_column_refs();
+  for (const auto column_id : subscripted) {
+    if (unsubscripted.count(column_id) == 0) {
+      RemoveColumnRef(column_id, column_refs->mutable_ids());
+      RemoveColumnRef(column_id, column_refs->mutable_static_ids());
+    }
+  }
+}
+
 } // namespace
 
 Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response) {
@@ -2056,6 +2426,8 @@ Status QLWriteOperation::Init(QLWriteRequestPB* request, QLResponsePB* response)
                               unique_index_key_schema_ != nullptr;
   require_read_ = RequireRead(request_, schema_) || insert_into_unique_index_;
   update_indexes_ = !request_.update_index_ids().empty();
+  // Done after require_read_ is set, since an index assignment still needs a read snapshot.
+  RemoveListIndexColumnRefs(schema_, &request_);
 
   // Determine if static / non-static columns are being written.
   bool write_static_columns = false;
@@ -2850,6 +3222,11 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     row_count_limit = request_.limit();
   }
 
+  if (parallel_scan_options_ != nullptr && CanUseParallelScan(schema)) {
+    return ExecuteParallelScan(
+        ql_storage, deadline, read_time, schema, query_schema, resultset, restart_read_ht);
+  }
+
   // Create the projections of the non-key columns selected by the row block plus any referenced in
   // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
   // projection only to scan sub-documents. The query schema is used to select only referenced
@@ -2866,12 +3243,37 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   RETURN_NOT_OK(ql_storage.BuildYQLScanSpec(
       request_, read_time, schema, read_static_columns, static_projection, &spec,
       &static_row_spec, &req_read_time));
-  RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
-                                       deadline, req_read_time, *spec, &iter));
+  if (scan_range_lower_.empty() && scan_range_upper_.empty()) {
+    RETURN_NOT_OK(ql_storage.GetIterator(request_, query_schema, schema, txn_op_context_,
+                                         deadline, req_read_time, *spec, &iter));
+  } else {
+    RETURN_NOT_OK(ql_storage.GetIteratorForKeyRange(
+        request_, query_schema, schema, txn_op_context_, deadline, req_read_time, *spec,
+        scan_range_lower_, scan_range_upper_, &iter));
+  }
   if (FLAGS_trace_docdb_calls) {
     TRACE("Initialized iterator");
   }
 
+  std::unique_ptr<QLColumnBatchFilter> batch_filter;
+  if (FLAGS_ql_scan_column_batch_size > 0 && !read_static_columns && !read_distinct_columns &&
+      static_row_spec == nullptr && !schema.has_statics() && CanUseColumnBatch(&batch_filter)) {
+    bool batch_supported = false;
+    RETURN_NOT_OK(ExecuteColumnBatchScan(
+        non_static_projection, batch_filter.get(), row_count_limit, offset, iter.get(), resultset,
+        &num_rows_skipped, &batch_supported));
+    if (batch_supported) {
+      if (FLAGS_trace_docdb_calls) {
+        TRACE("Fetched $0 rows in column batches.", resultset->rsrow_count());
+      }
+      *restart_read_ht = iter->RestartReadHt();
+      if (resultset->rsrow_count() >= row_count_limit || request_.has_offset()) {
+        RETURN_NOT_OK(iter->SetPagingStateIfNecessary(request_, num_rows_skipped, &response_));
+      }
+      return Status::OK();
+    }
+  }
+
   QLTableRow static_row;
   QLTableRow non_static_row;
   QLTableRow& selected_row = read_distinct_columns ? static_row : non_static_row;
@@ -2987,6 +3389,208 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   return Status::OK();
 }
 
+namespace {
+
+// State of a single sub-range of a parallel scan. Shared with thread pool tasks, which could run
+// after the scan is finished when the calling thread took over their sub-ranges.
+struct ParallelScanRange {
+  std::unique_ptr<QLReadOperation> op;
+  std::atomic<bool> claimed{false};
+  Status status;
+  HybridTime restart_read_ht;
+};
+
+} // namespace
+
+bool QLReadOperation::CanUseParallelScan(const Schema& schema) const {
+  if (parallel_scan_options_->split_keys.empty() ||
+      parallel_scan_options_->thread_pool == nullptr) {
+    return false;
+  }
+  // Partial aggregates could be merged only when every row is processed independently of other
+  // rows in the scan: no offset, distinct or static columns. Scans of a single hash key are small,
+  // and paged or reverse scans are not splittable.
+  if (!request_.is_aggregate() || request_.has_offset() || request_.distinct() ||
+      !request_.hashed_column_values().empty() || !request_.is_forward_scan() ||
+      !request_.paging_state().next_row_key().empty() || schema.has_statics()) {
+    return false;
+  }
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    if (expr.expr_case() != QLExpressionPB::ExprCase::kTscall ||
+        !IsMergeableAggregate(expr.tscall())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status QLReadOperation::ExecuteParallelScan(const common::YQLStorageIf& ql_storage,
+                                            MonoTime deadline,
+                                            const ReadHybridTime& read_time,
+                                            const Schema& schema,
+                                            const Schema& query_schema,
+                                            QLResultSet* resultset,
+                                            HybridTime* restart_read_ht) {
+  const auto& split_keys = parallel_scan_options_->split_keys;
+  auto ranges = std::make_shared<std::vector<ParallelScanRange>>(split_keys.size() + 1);
+  for (size_t i = 0; i != ranges->size(); ++i) {
+    auto& range = (*ranges)[i];
+    range.op = std::make_unique<QLReadOperation>(request_, txn_op_context_);
+    range.op->scan_range_lower_ = i == 0 ? Slice() : split_keys[i - 1].AsSlice();
+    range.op->scan_range_upper_ = i == split_keys.size() ? Slice() : split_keys[i].AsSlice();
+  }
+
+  const QLRSRowDesc rsrow_desc(request_.rsrow_desc());
+  CountDownLatch latch(ranges->size());
+  auto execute_range = [&](ParallelScanRange* range) {
+    // Partial aggregates are taken from the operation, rows of this result set are not used.
+    faststring rows_data;
+    QLResultSet range_resultset(&rsrow_desc, &rows_data);
+    range->status = range->op->Execute(
+        ql_storage, deadline, read_time, schema, query_schema, &range_resultset,
+        &range->restart_read_ht);
+    latch.CountDown();
+  };
+
+  // The first sub-range is always scanned by this thread. Sub-ranges that could not be submitted,
+  // or were not picked up by the pool yet, are also scanned here.
+  for (size_t i = 1; i < ranges->size(); ++i) {
+    auto status = parallel_scan_options_->thread_pool->SubmitFunc(
+        [ranges, i, &execute_range] {
+      auto& range = (*ranges)[i];
+      if (!range.claimed.exchange(true)) {
+        execute_range(&range);
+      }
+    });
+    if (!status.ok()) {
+      VLOG(2) << "Failed to submit parallel scan range: " << status;
+      break;
+    }
+  }
+  for (auto& range : *ranges) {
+    if (!range.claimed.exchange(true)) {
+      execute_range(&range);
+    }
+  }
+  latch.Wait();
+
+  *restart_read_ht = HybridTime::kInvalid;
+  for (auto& range : *ranges) {
+    RETURN_NOT_OK(range.status);
+    if (range.restart_read_ht.is_valid() &&
+        (!restart_read_ht->is_valid() || range.restart_read_ht > *restart_read_ht)) {
+      *restart_read_ht = range.restart_read_ht;
+    }
+
+    const auto& partial = range.op->aggr_result_;
+    if (partial.empty()) {
+      // No rows matched in this sub-range.
+      continue;
+    }
+    if (aggr_result_.empty()) {
+      aggr_result_.resize(partial.size());
+    }
+    for (size_t i = 0; i != partial.size(); ++i) {
+      RETURN_NOT_OK(MergeAggregate(request_.selected_exprs(i).tscall(), partial[i],
+                                   &aggr_result_[i]));
+    }
+  }
+
+  if (FLAGS_trace_docdb_calls) {
+    TRACE("Merged partial aggregates of $0 ranges.", ranges->size());
+  }
+  if (!aggr_result_.empty()) {
+    RETURN_NOT_OK(PopulateAggregate(QLTableRow(), resultset));
+  }
+  return Status::OK();
+}
+
+bool QLReadOperation::CanUseColumnBatch(std::unique_ptr<QLColumnBatchFilter>* filter) const {
+  // Column batches could be used when rows are passed to the result set as is: all selected
+  // expressions are plain column references, there is no aggregation and the WHERE condition, if
+  // any, could be evaluated over column batches.
+  if (request_.is_aggregate() || request_.selected_exprs_size() == 0) {
+    return false;
+  }
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    if (expr.expr_case() != QLExpressionPB::ExprCase::kColumnId) {
+      return false;
+    }
+  }
+  if (request_.has_where_expr()) {
+    if (request_.where_expr().expr_case() != QLExpressionPB::ExprCase::kCondition) {
+      return false;
+    }
+    *filter = QLColumnBatchFilter::Compile(request_.where_expr().condition());
+    return *filter != nullptr;
+  }
+  return true;
+}
+
+Status QLReadOperation::ExecuteColumnBatchScan(const Schema& projection,
+                                               const QLColumnBatchFilter* filter,
+                                               size_t row_count_limit,
+                                               size_t offset,
+                                               common::YQLRowwiseIteratorIf* iter,
+                                               QLResultSet* resultset,
+                                               size_t* num_rows_skipped,
+                                               bool* supported) {
+  std::vector<ColumnId> column_ids;
+  column_ids.reserve(request_.selected_exprs_size());
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    column_ids.emplace_back(expr.column_id());
+  }
+  // Columns referenced by the filter are read too, even if they are not selected.
+  if (filter != nullptr) {
+    for (const auto& column_id : filter->column_ids()) {
+      if (std::find(column_ids.begin(), column_ids.end(), column_id) == column_ids.end()) {
+        column_ids.push_back(column_id);
+      }
+    }
+  }
+  // The same column could be selected several times, so map each selected expression to its batch
+  // column.
+  QLColumnBatch batch(column_ids);
+  std::vector<int> rscol_to_batch;
+  rscol_to_batch.reserve(request_.selected_exprs_size());
+  for (const QLExpressionPB& expr : request_.selected_exprs()) {
+    rscol_to_batch.push_back(batch.ColumnIndex(ColumnId(expr.column_id())));
+  }
+  std::vector<uint8_t> selected;
+
+  *supported = true;
+  while (resultset->rsrow_count() < row_count_limit && iter->HasNext()) {
+    batch.Clear();
+    const size_t max_rows = std::min<size_t>(
+        FLAGS_ql_scan_column_batch_size,
+        row_count_limit - resultset->rsrow_count() + offset - std::min(offset, *num_rows_skipped));
+    auto status = iter->NextRowBatch(projection, max_rows, &batch);
+    if (status.IsNotSupported()) {
+      *supported = false;
+      return Status::OK();
+    }
+    RETURN_NOT_OK(status);
+    if (filter != nullptr) {
+      RETURN_NOT_OK(filter->Evaluate(batch, &selected));
+    }
+
+    for (size_t row = 0; row != batch.num_rows(); ++row) {
+      if (filter != nullptr && !selected[row]) {
+        continue;
+      }
+      if (*num_rows_skipped < offset) {
+        ++*num_rows_skipped;
+        continue;
+      }
+      resultset->AllocateRow();
+      for (size_t rscol_index = 0; rscol_index != rscol_to_batch.size(); ++rscol_index) {
+        resultset->AppendColumn(rscol_index, batch.value(rscol_to_batch[rscol_index], row));
+      }
+    }
+  }
+  return Status::OK();
+}
+
 CHECKED_STATUS QLReadOperation::PopulateResultSet(const QLTableRow& table_row,
                                                   QLResultSet *resultset) {
   resultset->AllocateRow();
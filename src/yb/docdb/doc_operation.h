@@ -34,6 +34,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_path.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/intent_aware_iterator.h"
@@ -41,6 +42,10 @@
 #include "yb/server/hybrid_clock.h"
 
 namespace yb {
+
+class QLColumnBatchFilter;
+class ThreadPool;
+
 namespace docdb {
 
 class DocWriteBatch;
@@ -83,11 +88,15 @@ struct Expiration {
   }
 };
 
+class HotKeyValueCache;
+
 struct DocOperationApplyData {
   DocWriteBatch* doc_write_batch;
   MonoTime deadline;
   ReadHybridTime read_time;
   HybridTime* restart_read_ht;
+  // Latest values of recently written keys of the tablet, may be null.
+  HotKeyValueCache* hot_key_value_cache = nullptr;
 };
 
 // When specifiying the parent key, the constant -1 is used for the subkey index.
@@ -150,6 +159,26 @@ class RedisWriteOperation : public DocOperation {
       int subkey_index = kNilSubkeyIndex);
   Result<RedisValue> GetValue(const DocOperationApplyData& data,
       int subkey_index = kNilSubkeyIndex, Expiration* exp = nullptr);
+  // Looks the value of a top-level string up in the hot key value cache of the tablet. Returns
+  // false if the value is not cached.
+  bool GetCachedValue(const DocOperationApplyData& data, RedisValue* value);
+
+  // Reads the hash or set at the request key if it is stored as a single packed value. Returns
+  // false if the key holds anything else.
+  Result<bool> ReadPackedCollection(
+      const DocOperationApplyData& data, SubDocument* collection, Expiration* exp);
+
+  // Writes collection as the new value of the request key: packed if it fits the packing limits
+  // and one key per entry otherwise. An empty collection deletes the key.
+  CHECKED_STATUS WriteRedisCollection(
+      const DocOperationApplyData& data, SubDocument collection, MonoDelta ttl);
+
+  // Applies changes (entries to set, or tombstones for entries to remove) to a hash or set that
+  // is packed or does not exist yet, packing or unpacking it as needed. Returns false if the
+  // collection is stored one key per entry, in which case the caller writes the changes.
+  Result<bool> ApplyToPackedCollection(
+      const DocOperationApplyData& data, const SubDocument& changes, RedisDataType data_type,
+      MonoDelta entry_ttl = Value::kMaxTtl);
 
   CHECKED_STATUS ApplySetTtl(const DocOperationApplyData& data);
   CHECKED_STATUS ApplySet(const DocOperationApplyData& data);
@@ -359,6 +388,16 @@ class QLWriteOperation : public DocOperation, public DocExprExecutor {
   bool liveness_column_exists_ = false;
 };
 
+// Describes how an aggregate QL scan could be split into key sub-ranges scanned concurrently.
+struct QLParallelScanOptions {
+  // Encoded DocKeys splitting the tablet key space into sub-ranges, in increasing order.
+  std::vector<KeyBytes> split_keys;
+
+  // Pool used to scan sub-ranges. The calling thread also scans sub-ranges, so the scan makes
+  // progress even when the pool is busy.
+  ThreadPool* thread_pool = nullptr;
+};
+
 class QLReadOperation : public DocExprExecutor {
  public:
   QLReadOperation(
@@ -389,10 +428,51 @@ class QLReadOperation : public DocExprExecutor {
 
   QLResponsePB& response() { return response_; }
 
+  // Allows Execute to split aggregate scans according to the given options. The options should
+  // outlive Execute.
+  void SetParallelScanOptions(const QLParallelScanOptions* options) {
+    parallel_scan_options_ = options;
+  }
+
  private:
+  // Whether an aggregate request could be evaluated as a merge of partial aggregates computed over
+  // key sub-ranges.
+  bool CanUseParallelScan(const Schema& schema) const;
+
+  // Evaluates the aggregate request concurrently over the sub-ranges of parallel_scan_options_.
+  CHECKED_STATUS ExecuteParallelScan(const common::YQLStorageIf& ql_storage,
+                                     MonoTime deadline,
+                                     const ReadHybridTime& read_time,
+                                     const Schema& schema,
+                                     const Schema& query_schema,
+                                     QLResultSet* resultset,
+                                     HybridTime* restart_read_ht);
+
+  // Whether rows could be read in column batches and passed to result set without evaluation.
+  // Sets filter to the compiled WHERE condition, if the request has one.
+  bool CanUseColumnBatch(std::unique_ptr<QLColumnBatchFilter>* filter) const;
+
+  // Reads rows from iter in column batches, skipping rows that do not match filter, if it is not
+  // null. Sets supported to false when iter does not support column batches, no rows are read in
+  // this case.
+  CHECKED_STATUS ExecuteColumnBatchScan(const Schema& projection,
+                                        const QLColumnBatchFilter* filter,
+                                        size_t row_count_limit,
+                                        size_t offset,
+                                        common::YQLRowwiseIteratorIf* iter,
+                                        QLResultSet* resultset,
+                                        size_t* num_rows_skipped,
+                                        bool* supported);
+
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
   QLResponsePB response_;
+
+  const QLParallelScanOptions* parallel_scan_options_ = nullptr;
+
+  // Encoded key range of the scan, used when executing a sub-range of a parallel scan.
+  Slice scan_range_lower_;
+  Slice scan_range_upper_;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -110,10 +110,8 @@ DocPgsqlScanSpec::DocPgsqlScanSpec(const Schema& schema,
       lower_doc_key_(bound_key(schema, true)),
       upper_doc_key_(bound_key(schema, false)),
       is_forward_scan_(is_forward_scan) {
-  if (where_expr_) {
-    // Should never get here until WHERE clause is supported.
-    LOG(FATAL) << "DEVELOPERS: Add support for condition (where clause)";
-  }
+  // The where condition does not narrow the scan range. It is used by PgsqlReadOperation to filter
+  // the rows that are read.
 }
 
 DocKey DocPgsqlScanSpec::bound_key(const Schema& schema, const bool lower_bound) const {
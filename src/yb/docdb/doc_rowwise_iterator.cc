@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_rowwise_iterator.h"
 
 #include "yb/common/partition.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/transaction.h"
 #include "yb/common/ql_scanspec.h"
 #include "yb/docdb/docdb.h"
@@ -36,6 +37,28 @@ using yb::FormatRocksDBSliceAsStr;
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Returns the key used to check bloom filters for a scan between the given bounds: the lower bound
+// with only the leading range components that are fixed by the scan, i.e. equal in both bounds.
+KeyBytes EncodeFilterKey(const DocKey& lower_doc_key, const DocKey& upper_doc_key) {
+  const auto& lower_range = lower_doc_key.range_group();
+  const auto& upper_range = upper_doc_key.range_group();
+  size_t num_fixed = 0;
+  while (num_fixed < lower_range.size() && num_fixed < upper_range.size() &&
+         lower_range[num_fixed] == upper_range[num_fixed]) {
+    ++num_fixed;
+  }
+  if (num_fixed == lower_range.size()) {
+    return lower_doc_key.Encode();
+  }
+  DocKey filter_doc_key = lower_doc_key;
+  filter_doc_key.ResizeRangeComponents(num_fixed);
+  return filter_doc_key.Encode();
+}
+
+} // namespace
+
 DocRowwiseIterator::DocRowwiseIterator(
     const Schema &projection,
     const Schema &schema,
@@ -72,13 +95,47 @@ Status DocRowwiseIterator::Init() {
       boost::none /* user_key_for_filter */, query_id, txn_op_context_, deadline_, read_time_);
 
   row_key_ = DocKey(schema_);
-  db_iter_->Seek(row_key_);
+  if (scan_range_lower_.empty()) {
+    db_iter_->Seek(row_key_);
+  } else {
+    db_iter_->Seek(scan_range_lower_.AsSlice());
+  }
   row_ready_ = false;
   has_bound_key_ = false;
 
   return Status::OK();
 }
 
+void DocRowwiseIterator::SetScanKeyRange(KeyBytes lower, KeyBytes upper) {
+  scan_range_lower_ = std::move(lower);
+  scan_range_upper_ = std::move(upper);
+}
+
+std::shared_ptr<rocksdb::ReadFileFilter> DocRowwiseIterator::CreateFileFilter(
+    const DocKey& lower_doc_key, const DocKey& upper_doc_key,
+    std::shared_ptr<rocksdb::ReadFileFilter> spec_file_filter) const {
+  KeyBytes lower_bound;
+  if (!lower_doc_key.empty()) {
+    lower_bound = lower_doc_key.Encode();
+  }
+  if (!scan_range_lower_.empty() &&
+      (lower_bound.empty() || scan_range_lower_.AsSlice().compare(lower_bound.AsSlice()) > 0)) {
+    lower_bound = scan_range_lower_;
+  }
+  // Upper bound of the scan spec is greater than all keys in the range, because it ends with
+  // +inf component.
+  KeyBytes upper_bound;
+  if (!upper_doc_key.empty()) {
+    upper_bound = upper_doc_key.Encode();
+  }
+  if (!scan_range_upper_.empty() &&
+      (upper_bound.empty() || scan_range_upper_.AsSlice().compare(upper_bound.AsSlice()) < 0)) {
+    upper_bound = scan_range_upper_;
+  }
+  return CreateKeyBoundsFileFilter(
+      std::move(lower_bound), std::move(upper_bound), std::move(spec_file_filter));
+}
+
 Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   const DocQLScanSpec& doc_spec = dynamic_cast<const DocQLScanSpec&>(spec);
   is_forward_scan_ = doc_spec.is_forward_scan();
@@ -99,10 +156,12 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key_encoded = EncodeFilterKey(lower_doc_key, upper_doc_key);
 
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      doc_db_, mode, filter_key_encoded.AsSlice(), doc_spec.QueryId(), txn_op_context_,
+      deadline_, read_time_,
+      CreateFileFilter(lower_doc_key, upper_doc_key, doc_spec.CreateFileFilter()));
 
   row_ready_ = false;
 
@@ -143,7 +202,12 @@ Status DocRowwiseIterator::Init(const common::QLScanSpec& spec) {
   }
 
   if (is_forward_scan_) {
-    db_iter_->Seek(lower_doc_key);
+    if (!scan_range_lower_.empty() &&
+        scan_range_lower_.AsSlice().compare(row_key_encoded_as_slice) > 0) {
+      db_iter_->Seek(scan_range_lower_.AsSlice());
+    } else {
+      db_iter_->Seek(lower_doc_key);
+    }
   } else {
     // TODO consider adding an operator bool to DocKey to use instead of empty() here.
     if (!upper_doc_key.empty()) {
@@ -176,10 +240,12 @@ Status DocRowwiseIterator::Init(const common::PgsqlScanSpec& spec) {
 
   const KeyBytes row_key_encoded = lower_doc_key.Encode();
   const Slice row_key_encoded_as_slice = row_key_encoded.AsSlice();
+  const KeyBytes filter_key_encoded = EncodeFilterKey(lower_doc_key, upper_doc_key);
 
   db_iter_ = CreateIntentAwareIterator(
-      doc_db_, mode, row_key_encoded_as_slice, doc_spec.QueryId(), txn_op_context_,
-      deadline_, read_time_, doc_spec.CreateFileFilter());
+      doc_db_, mode, filter_key_encoded.AsSlice(), doc_spec.QueryId(), txn_op_context_,
+      deadline_, read_time_,
+      CreateFileFilter(lower_doc_key, upper_doc_key, doc_spec.CreateFileFilter()));
 
   row_ready_ = false;
 
@@ -214,7 +280,9 @@ Status DocRowwiseIterator::EnsureIteratorPositionCorrect() const {
     // Seek to the current target doc key if needed.
     if (current_scan_target_ != row_key_ && !FinishedScanTargetsList()) {
       if (is_forward_scan_) {
-        db_iter_->Seek(current_scan_target_);
+        // Scan targets are visited in ascending order, so use batched lookup to reuse iterator
+        // position between neighboring targets.
+        db_iter_->SeekToKeyInBatch(current_scan_target_);
       } else {
         DocKey tmp = current_scan_target_;
         tmp.AddRangeComponent(PrimitiveValue(ValueType::kHighest));
@@ -268,6 +336,11 @@ bool DocRowwiseIterator::HasNext() const {
       return true;
     }
     iter_key_.Reset(*fetched_key);
+    if (!scan_range_upper_.empty() &&
+        iter_key_.AsSlice().compare(scan_range_upper_.AsSlice()) >= 0) {
+      done_ = true;
+      return false;
+    }
 
     const Result<size_t> dockey_size = row_key_.DecodeFrom(iter_key_);
     if (!dockey_size.ok()) {
@@ -362,15 +435,82 @@ CHECKED_STATUS SetQLPrimaryKeyColumnValues(const Schema& schema,
         column_type, begin_index, begin_index + column_count - 1, schema.num_columns());
   }
   for (size_t i = 0, j = begin_index; i < column_count; i++, j++) {
-    const auto ql_type = schema.column(j).type();
+    const auto& ql_type = schema.column(j).type();
     QLTableColumn& column = table_row->AllocColumn(schema.column_id(j));
     PrimitiveValue::ToQLValuePB(values[i], ql_type, &column.value);
   }
   return Status::OK();
 }
 
+// Set primary key column values (hashed or range columns) in a column batch. batch_indexes
+// contains batch column index for each of the key columns, or -1 if column is not in batch.
+CHECKED_STATUS SetBatchPrimaryKeyColumnValues(const Schema& schema,
+                                              const size_t begin_index,
+                                              const char* column_type,
+                                              const vector<PrimitiveValue>& values,
+                                              const std::vector<int>& batch_indexes,
+                                              QLColumnBatch* batch) {
+  if (values.size() != batch_indexes.size()) {
+    return STATUS_SUBSTITUTE(Corruption, "$0 $1 primary key columns found but $2 expected",
+                             values.size(), column_type, batch_indexes.size());
+  }
+  for (size_t i = 0; i < values.size(); i++) {
+    if (batch_indexes[i] >= 0) {
+      PrimitiveValue::ToQLValuePB(
+          values[i], schema.column(begin_index + i).type(), batch->AllocValue(batch_indexes[i]));
+    }
+  }
+  return Status::OK();
+}
+
 } // namespace
 
+Status DocRowwiseIterator::NextRowBatch(
+    const Schema& projection, size_t max_rows, QLColumnBatch* batch) {
+  // Batch column indexes are resolved once per batch, instead of looking up column map per row.
+  std::vector<int> hash_indexes(schema_.num_hash_key_columns());
+  for (size_t i = 0; i < hash_indexes.size(); i++) {
+    hash_indexes[i] = batch->ColumnIndex(schema_.column_id(i));
+  }
+  std::vector<int> range_indexes(schema_.num_range_key_columns());
+  for (size_t i = 0; i < range_indexes.size(); i++) {
+    range_indexes[i] = batch->ColumnIndex(schema_.column_id(schema_.num_hash_key_columns() + i));
+  }
+  std::vector<ProjectedColumn> value_columns;
+  for (const auto& column : ProjectedColumns(projection)) {
+    auto index = batch->ColumnIndex(column.id);
+    if (index >= 0) {
+      value_columns.push_back(column);
+      value_columns.back().batch_index = index;
+    }
+  }
+
+  while (batch->num_rows() < max_rows && HasNext()) {
+    // An error happened in HasNext.
+    RETURN_NOT_OK(status_);
+
+    batch->AllocRow();
+    RETURN_NOT_OK(SetBatchPrimaryKeyColumnValues(
+        schema_, 0, "hash", row_key_.hashed_group(), hash_indexes, batch));
+    if (!row_key_.range_group().empty()) {
+      RETURN_NOT_OK(SetBatchPrimaryKeyColumnValues(
+          schema_, schema_.num_hash_key_columns(), "range", row_key_.range_group(), range_indexes,
+          batch));
+    }
+
+    for (const auto& column : value_columns) {
+      const SubDocument* column_value = row_.GetChild(column.subkey);
+      if (column_value != nullptr) {
+        SubDocument::ToQLValuePB(*column_value, column.type, batch->AllocValue(column.batch_index));
+      }
+    }
+
+    row_ready_ = false;
+  }
+
+  return Status::OK();
+}
+
 void DocRowwiseIterator::SkipRow() {
   row_ready_ = false;
 }
@@ -416,13 +556,11 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
         "range", row_key_.range_group(), table_row));
   }
 
-  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
-    const auto& column_id = projection.column_id(i);
-    const auto ql_type = projection.column(i).type();
-    const SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
+  for (const auto& projected_column : ProjectedColumns(projection)) {
+    const SubDocument* column_value = row_.GetChild(projected_column.subkey);
     if (column_value != nullptr) {
-      QLTableColumn& column = table_row->AllocColumn(column_id);
-      SubDocument::ToQLValuePB(*column_value, ql_type, &column.value);
+      QLTableColumn& column = table_row->AllocColumn(projected_column.id);
+      SubDocument::ToQLValuePB(*column_value, projected_column.type, &column.value);
       column.ttl_seconds = column_value->GetTtl();
       if (column_value->IsWriteTimeSet()) {
         column.write_time = column_value->GetWriteTime();
@@ -434,6 +572,24 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   return Status::OK();
 }
 
+const std::vector<DocRowwiseIterator::ProjectedColumn>& DocRowwiseIterator::ProjectedColumns(
+    const Schema& projection) {
+  for (const auto& entry : projected_columns_) {
+    if (entry.first == &projection) {
+      return entry.second;
+    }
+  }
+  std::vector<ProjectedColumn> columns;
+  columns.reserve(projection.num_columns() - projection.num_key_columns());
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+    const auto column_id = projection.column_id(i);
+    columns.push_back(
+        ProjectedColumn{column_id, PrimitiveValue(column_id), projection.column(i).type(), -1});
+  }
+  projected_columns_.emplace_back(&projection, std::move(columns));
+  return projected_columns_.back().second;
+}
+
 bool DocRowwiseIterator::LivenessColumnExists() const {
   const SubDocument* subdoc = row_.GetChild(
       PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
@@ -65,6 +65,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Init scan iterator.
   CHECKED_STATUS Init();
 
+  // Restricts a forward QL scan to rows with encoded keys in [lower, upper), an empty bound means
+  // no restriction. Used to split a scan into sub-ranges. Should be called before Init.
+  void SetScanKeyRange(KeyBytes lower, KeyBytes upper);
+
   // Init QL read scan.
   CHECKED_STATUS Init(const common::QLScanSpec& spec);
   CHECKED_STATUS Init(const common::PgsqlScanSpec& spec);
@@ -106,6 +110,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   virtual CHECKED_STATUS GetKeyContent(faststring *key_content) const override;
 
+  // Reads rows straight into column vectors of the batch, without building QLTableRow per row.
+  CHECKED_STATUS NextRowBatch(const Schema& projection, size_t max_rows,
+                              QLColumnBatch* batch) override;
+
  private:
 
   // Retrieves the next key to read after the iterator finishes for the given page.
@@ -147,6 +155,21 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
+  // A value column of a projection with what is needed to read it from row_, resolved once per
+  // projection instead of once per row.
+  struct ProjectedColumn {
+    ColumnId id;
+    PrimitiveValue subkey;
+    std::shared_ptr<QLType> type;
+    // Index of the column in the batch for NextRowBatch.
+    int batch_index;
+  };
+
+  // Returns the value columns of projection, resolving them on the first use of the projection.
+  // Projections are identified by address, so a projection should not be destroyed while the
+  // iterator is used, as is already required for projection_.
+  const std::vector<ProjectedColumn>& ProjectedColumns(const Schema& projection);
+
   // Returns true if this is a (multi)key scan (as opposed to an e.g. sequential scan).
   // It means we have a (non-empty) list of target keys that we will seek for in order (or reverse
   // order for reverse scans).
@@ -181,6 +204,12 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // are done so it cleares the scan target idxs array.
   void GoToScanTarget(const DocKey &new_target) const;
 
+  // Extends the file filter of the scan spec to also skip SST files that have no keys between the
+  // given bounds and within the range set by SetScanKeyRange.
+  std::shared_ptr<rocksdb::ReadFileFilter> CreateFileFilter(
+      const DocKey& lower_doc_key, const DocKey& upper_doc_key,
+      std::shared_ptr<rocksdb::ReadFileFilter> spec_file_filter) const;
+
   const Schema& projection_;
   // Used to maintain ownership of projection_.
   // Separate field is used since ownership could be optional.
@@ -205,6 +234,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   bool has_bound_key_;
   DocKey bound_key_;
 
+  // Encoded key range set by SetScanKeyRange.
+  KeyBytes scan_range_lower_;
+  KeyBytes scan_range_upper_;
+
   // TODO (mihnea) refactor this logic into a separate class for iterating through options.
   // For (multi)key scans (e.g. selects with 'IN' condition on the range columns) we hold the
   // options for each range column as we iteratively seek to each target key.
@@ -247,6 +280,11 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   mutable std::vector<PrimitiveValue> projection_subkeys_;
 
+  // Value columns of the projections used to read rows from this iterator. An iterator is read with
+  // a couple of projections at most, e.g. with static and non-static columns, so they are looked
+  // up by linear search.
+  std::vector<std::pair<const Schema*, std::vector<ProjectedColumn>>> projected_columns_;
+
   // Used for keeping track of errors that happen in HasNext. Returned
   mutable Status status_;
 };
@@ -18,11 +18,13 @@
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/status.h"
+#include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
@@ -55,8 +57,11 @@ using rocksdb::WriteOptions;
 
 using namespace std::chrono_literals;
 
+DECLARE_bool(rocksdb_track_file_expiration);
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_int32(redis_ts_downsample_after_sec);
+DECLARE_int64(redis_ts_downsample_bucket_size);
 
 namespace yb {
 namespace docdb {
@@ -979,6 +984,48 @@ SubDocKey(DocKey([], ["k1"]), ["s2"; HT{ physical: 1000 }]) -> "v21"; ttl: 0.003
       )#");
 }
 
+TEST_F(DocDBTest, RedisTimeSeriesDownsampleCompactionTest) {
+  FLAGS_redis_ts_downsample_after_sec = 1;
+  FLAGS_redis_ts_downsample_bucket_size = 10;
+  const HybridTime t0 = 1000_usec_ht;
+  const HybridTime t1 = 2000_usec_ht;
+  const HybridTime t2 = 3000000_usec_ht;
+
+  KeyBytes ts_key(DocKey(PrimitiveValues("ts")).Encode());
+  ASSERT_OK(SetPrimitive(DocPath(ts_key), Value(PrimitiveValue(ValueType::kRedisTS)), t0));
+  for (int64_t timestamp : {10, 11, 19, 20, 25}) {
+    ASSERT_OK(SetPrimitive(DocPath(ts_key, PrimitiveValue(timestamp, SortOrder::kDescending)),
+                           PrimitiveValue(Format("v$0", timestamp)), t1));
+  }
+  // Samples written after the downsampling cutoff are kept, but still claim their bucket.
+  ASSERT_OK(SetPrimitive(DocPath(ts_key, PrimitiveValue(31, SortOrder::kDescending)),
+                         PrimitiveValue("v31"), t2));
+  ASSERT_OK(SetPrimitive(DocPath(ts_key, PrimitiveValue(32, SortOrder::kDescending)),
+                         PrimitiveValue("v32"), t2));
+  ASSERT_OK(SetPrimitive(DocPath(ts_key, PrimitiveValue(30, SortOrder::kDescending)),
+                         PrimitiveValue("v30"), t1));
+
+  // Documents other than time series are not downsampled.
+  KeyBytes obj_key(DocKey(PrimitiveValues("obj")).Encode());
+  ASSERT_OK(SetPrimitive(DocPath(obj_key), Value(PrimitiveValue(ValueType::kObject)), t0));
+  for (int64_t timestamp : {10, 11}) {
+    ASSERT_OK(SetPrimitive(DocPath(obj_key, PrimitiveValue(timestamp, SortOrder::kDescending)),
+                           PrimitiveValue(Format("v$0", timestamp)), t1));
+  }
+
+  FullyCompactHistoryBefore(HybridTime::FromMicros(2500000));
+  AssertDocDbDebugDumpStrEq(R"#(
+SubDocKey(DocKey([], ["obj"]), [HT{ physical: 1000 }]) -> {}
+SubDocKey(DocKey([], ["obj"]), [11; HT{ physical: 2000 }]) -> "v11"
+SubDocKey(DocKey([], ["obj"]), [10; HT{ physical: 2000 }]) -> "v10"
+SubDocKey(DocKey([], ["ts"]), [HT{ physical: 1000 }]) -> <>
+SubDocKey(DocKey([], ["ts"]), [32; HT{ physical: 3000000 }]) -> "v32"
+SubDocKey(DocKey([], ["ts"]), [31; HT{ physical: 3000000 }]) -> "v31"
+SubDocKey(DocKey([], ["ts"]), [25; HT{ physical: 2000 }]) -> "v25"
+SubDocKey(DocKey([], ["ts"]), [19; HT{ physical: 2000 }]) -> "v19"
+      )#");
+}
+
 // Compaction testing with TTL merge records for generic Redis collections.
 // Observe that because only collection-level merge records are supported,
 // all tests begin with initializing a vanilla collection and adding TTL over it.
@@ -2005,6 +2052,65 @@ SubDocKey(DocKey([], ["k"]), [HT{ physical: 5000 }]) -> "v5"  // file 11
       )#");
 }
 
+TEST_F(DocDBTest, FlushRemovesOverwrittenVersions) {
+  ASSERT_OK(DisableCompactions());
+  ASSERT_OK(EnableFilterOnFlush());
+  const DocKey doc_key(PrimitiveValues("k"));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  for (int i = 1; i <= 4; ++i) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key), Value(PV(Format("v$0", i))), HybridTime::FromMicros(i * 1000)));
+  }
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PV("s")), Value(PV("x")), 1500_usec_ht));
+
+  SetHistoryCutoffHybridTime(3000_usec_ht);
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(1, NumSSTableFiles());
+  // Versions overwritten at or before the history cutoff are not written to the flushed file.
+  AssertDocDbDebugDumpStrEq(
+      R"#(
+SubDocKey(DocKey([], ["k"]), [HT{ physical: 4000 }]) -> "v4"
+SubDocKey(DocKey([], ["k"]), [HT{ physical: 3000 }]) -> "v3"
+      )#");
+
+  // Versions in earlier files are kept, since the flushed memtable does not shadow them.
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key), Value(PV("v5")), 5000_usec_ht));
+  SetHistoryCutoffHybridTime(6000_usec_ht);
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(2, NumSSTableFiles());
+  AssertDocDbDebugDumpStrEq(
+      R"#(
+SubDocKey(DocKey([], ["k"]), [HT{ physical: 5000 }]) -> "v5"
+SubDocKey(DocKey([], ["k"]), [HT{ physical: 4000 }]) -> "v4"
+SubDocKey(DocKey([], ["k"]), [HT{ physical: 3000 }]) -> "v3"
+      )#");
+}
+
+// Versions removed by the history cleanup are dropped from the flushed file, rather than being
+// written as deletion markers.
+TEST_F(DocDBTest, FlushCollapsesOverwrittenVersions) {
+  ASSERT_OK(DisableCompactions());
+  ASSERT_OK(EnableFilterOnFlush());
+  KeyBytes encoded_doc_key(DocKey(PrimitiveValues("counter")).Encode());
+  for (int64_t i = 1; i <= 100; ++i) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(encoded_doc_key), PrimitiveValue(i), HybridTime::FromMicros(i * 1000)));
+  }
+
+  SetHistoryCutoffHybridTime(99000_usec_ht);
+  ASSERT_OK(FlushRocksDbAndWait());
+  AssertDocDbDebugDumpStrEq(
+      R"#(
+SubDocKey(DocKey([], ["counter"]), [HT{ physical: 100000 }]) -> 100
+SubDocKey(DocKey([], ["counter"]), [HT{ physical: 99000 }]) -> 99
+      )#");
+
+  rocksdb::TablePropertiesCollection props;
+  ASSERT_OK(rocksdb()->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1, props.size());
+  ASSERT_EQ(2, props.begin()->second->num_entries);
+}
+
 TEST_F(DocDBTest, MinorCompactionWithDeletions) {
   ASSERT_OK(DisableCompactions());
   const DocKey doc_key(PrimitiveValues("k"));
@@ -3163,6 +3269,84 @@ TXN REV 30303030-3030-3030-3030-303030303032 HT{ physical: 5000 w: 1 } -> \
       )#");
 }
 
+TEST_F(DocDBTest, RemovedIntentsAreNotFlushed) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  auto txn = ASSERT_RESULT(FullyDecodeTransactionId("0000000000000001"));
+  SetCurrentTransactionId(txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key), PrimitiveValue::kObject, 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, "subkey1"), PrimitiveValue("value1"), 2000_usec_ht));
+  ResetCurrentTransactionId();
+
+  rocksdb::WriteBatch intents_batch;
+  ASSERT_OK(PrepareApplyIntentsBatch(
+      txn, HybridTime::kInvalid, nullptr /* regular_batch */, intents_db(), &intents_batch));
+  ASSERT_OK(intents_db()->Write(write_options(), &intents_batch));
+
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = true;
+  ASSERT_OK(intents_db()->Flush(flush_options));
+
+  // Intents and their removals cancel each other out during flush.
+  rocksdb::TablePropertiesCollection props;
+  ASSERT_OK(intents_db()->GetPropertiesOfAllTables(&props));
+  uint64_t entries = 0;
+  for (const auto& file_and_props : props) {
+    entries += file_and_props.second->num_entries;
+  }
+  ASSERT_EQ(0, entries);
+}
+
+// The oldest files are deleted when all their records are expired by the table level TTL, but not
+// while some of their records have a longer TTL of their own.
+TEST_F(DocDBTest, DeleteExpiredFiles) {
+  const MonoDelta kTableTtl = 10ms;
+  FLAGS_rocksdb_track_file_expiration = true;
+  ASSERT_OK(InitRocksDBOptions());
+  ASSERT_OK(ReopenRocksDB());
+
+  auto encoded_key = [](int i) {
+    return DocKey(PrimitiveValues("mydockey", i)).Encode();
+  };
+  auto num_files = [this] {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    rocksdb()->GetLiveFilesMetaData(&files);
+    return files.size();
+  };
+
+  ASSERT_OK(SetPrimitive(DocPath(encoded_key(1)), PrimitiveValue("value1"), 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_key(2)), Value(PrimitiveValue("value2"), 1s), 2000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_key(3)), PrimitiveValue("value3"), 3000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(3, num_files());
+
+  // Nothing expires without the table level TTL.
+  ASSERT_EQ(0, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 20000_usec_ht, Value::kMaxTtl)));
+  ASSERT_EQ(0, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 10000_usec_ht, kTableTtl)));
+  ASSERT_EQ(1, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 20000_usec_ht, kTableTtl)));
+  ASSERT_EQ(2, num_files());
+
+  // The second file keeps the third one, that is already expired, until its own TTL passes.
+  ASSERT_EQ(0, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 100000_usec_ht, kTableTtl)));
+  ASSERT_EQ(2, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 1100000_usec_ht, kTableTtl)));
+  ASSERT_EQ(0, num_files());
+
+  // Files written without expiration tracking are never deleted.
+  FLAGS_rocksdb_track_file_expiration = false;
+  ASSERT_OK(InitRocksDBOptions());
+  ASSERT_OK(ReopenRocksDB());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_key(4)), PrimitiveValue("value4"), 4000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(0, ASSERT_RESULT(DeleteExpiredFiles(rocksdb(), 1100000_usec_ht, kTableTtl)));
+  ASSERT_EQ(1, num_files());
+}
 
 }  // namespace docdb
 }  // namespace yb
@@ -31,6 +31,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/intent_prefix_filter.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -43,6 +44,7 @@
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/date_time.h"
 #include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/status.h"
 #include "yb/util/metrics.h"
@@ -62,6 +64,12 @@ using yb::util::FormatBytesAsStr;
 using yb::FormatRocksDBSliceAsStr;
 using strings::Substitute;
 
+DEFINE_bool(docdb_single_delete_intents, true,
+            "Remove applied and aborted intents with SingleDelete. Every intent and reverse index "
+            "record is written once, so a removal that reaches the intents memtable before a "
+            "flush cancels the record out and neither of them is written to SST files.");
+TAG_FLAG(docdb_single_delete_intents, advanced);
+TAG_FLAG(docdb_single_delete_intents, runtime);
 
 namespace yb {
 namespace docdb {
@@ -189,10 +197,12 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
                                 KeyValueWriteBatchPB* write_batch,
                                 InitMarkerBehavior init_marker_behavior,
                                 std::atomic<int64_t>* monotonic_counter,
-                                HybridTime* restart_read_ht) {
+                                HybridTime* restart_read_ht,
+                                HotKeyValueCache* hot_key_value_cache) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
   DocWriteBatch doc_write_batch(doc_db, init_marker_behavior, monotonic_counter);
-  DocOperationApplyData data = {&doc_write_batch, deadline, read_time, restart_read_ht};
+  DocOperationApplyData data = {
+      &doc_write_batch, deadline, read_time, restart_read_ht, hot_key_value_cache};
   for (const unique_ptr<DocOperation>& doc_op : doc_write_ops) {
     Status s = doc_op->Apply(data);
     if (s.IsQLError()) {
@@ -292,12 +302,14 @@ class PrepareTransactionWriteBatchHelper {
                                      rocksdb::WriteBatch* rocksdb_write_batch,
                                      const TransactionId& transaction_id,
                                      IsolationLevel isolation_level,
-                                     IntraTxnWriteId* intra_txn_write_id)
+                                     IntraTxnWriteId* intra_txn_write_id,
+                                     IntentPrefixFilter* intent_prefix_filter)
       : hybrid_time_(hybrid_time),
         rocksdb_write_batch_(rocksdb_write_batch),
         transaction_id_(transaction_id),
         intent_types_(GetWriteIntentsForIsolationLevel(isolation_level)),
-        intra_txn_write_id_(intra_txn_write_id) {
+        intra_txn_write_id_(intra_txn_write_id),
+        intent_prefix_filter_(intent_prefix_filter) {
   }
 
   // Using operator() to pass this object conveniently to EnumerateIntents.
@@ -329,6 +341,9 @@ class PrepareTransactionWriteBatchHelper {
         Slice(intent_type, 2),
         doc_ht_buffer.EncodeWithValueType(hybrid_time_, write_id_++),
     }};
+    if (intent_prefix_filter_) {
+      intent_prefix_filter_->Add(transaction_id_, key->AsSlice());
+    }
     AddIntent(transaction_id_, key_parts, value, rocksdb_write_batch_);
 
     return Status::OK();
@@ -346,6 +361,9 @@ class PrepareTransactionWriteBatchHelper {
     }};
 
     for (const auto& intent : weak_intents_) {
+      if (intent_prefix_filter_) {
+        intent_prefix_filter_->Add(transaction_id_, intent);
+      }
       std::array<Slice, 3> key = {{
           Slice(intent),
           Slice(intent_type, 2),
@@ -366,6 +384,7 @@ class PrepareTransactionWriteBatchHelper {
   std::unordered_set<std::string> weak_intents_;
   IntraTxnWriteId write_id_ = 0;
   IntraTxnWriteId* intra_txn_write_id_;
+  IntentPrefixFilter* intent_prefix_filter_;
 };
 
 // We have the following distinct types of data in this "intent store":
@@ -384,11 +403,13 @@ void PrepareTransactionWriteBatch(
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
     IsolationLevel isolation_level,
-    IntraTxnWriteId* write_id) {
+    IntraTxnWriteId* write_id,
+    IntentPrefixFilter* intent_prefix_filter) {
   VLOG(4) << "PrepareTransactionWriteBatch(), write_id = " << *write_id;
 
   PrepareTransactionWriteBatchHelper helper(
-      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, write_id);
+      hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, write_id,
+      intent_prefix_filter);
 
   // We cannot recover from failures here, because it means that we cannot apply replicated
   // operation.
@@ -411,6 +432,70 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Fills data.result with the entries of a packed hash or set found at data.subdocument_key,
+// applying the same subkey bounds, limit, counting and visitor handling BuildSubDocument applies
+// to the children of an exploded collection.
+CHECKED_STATUS BuildPackedSubDocument(const Value& doc_value, const GetSubDocumentData& data) {
+  SubDocument packed;
+  RETURN_NOT_OK(SubDocument::FromPackedValue(doc_value.primitive_value(), &packed));
+  *data.result = SubDocument(UnpackedCollectionType(doc_value.value_type()));
+  KeyBytes child_key(data.subdocument_key);
+  const size_t subdocument_key_size = child_key.size();
+  for (auto& entry : packed.object_container()) {
+    child_key.Truncate(subdocument_key_size);
+    entry.first.AppendToKey(&child_key);
+    if (!data.low_subkey->CanInclude(child_key.AsSlice())) {
+      continue;
+    }
+    if (!data.high_subkey->CanInclude(child_key.AsSlice())) {
+      break;
+    }
+    size_t num_children = data.result->object_num_keys();
+    if (data.visitor) {
+      num_children += data.record_count;
+    }
+    if (data.limit != 0 && num_children >= data.limit) {
+      break;
+    }
+    if (data.count_only) {
+      data.record_count++;
+    } else if (data.visitor) {
+      RETURN_NOT_OK(data.visitor->VisitKey(entry.first));
+      RETURN_NOT_OK(data.visitor->VisitValue(entry.second));
+      data.record_count++;
+    } else {
+      data.result->SetChild(entry.first, std::move(entry.second));
+    }
+  }
+  return Status::OK();
+}
+
+// Looks a child of a packed collection stored at an ancestor of data.subdocument_key up.
+// remaining_subkeys holds the encoded subkeys of data.subdocument_key below that ancestor.
+CHECKED_STATUS GetFromPackedAncestor(
+    const Value& ancestor_value, Slice remaining_subkeys, const ReadHybridTime& read_time,
+    const GetSubDocumentData& data) {
+  PrimitiveValue subkey;
+  RETURN_NOT_OK(subkey.DecodeFromKey(&remaining_subkeys));
+  if (!remaining_subkeys.empty()) {
+    // Entries of packed collections are primitive values, so they have no nested subkeys.
+    return Status::OK();
+  }
+  bool has_expired = false;
+  RETURN_NOT_OK(HasExpiredTTL(data.exp.write_ht, data.exp.ttl, read_time.read, &has_expired));
+  if (has_expired || data.exp.ttl.IsNegative()) {
+    return Status::OK();
+  }
+  SubDocument packed;
+  RETURN_NOT_OK(SubDocument::FromPackedValue(ancestor_value.primitive_value(), &packed));
+  SubDocument* child = packed.GetChild(subkey);
+  if (child != nullptr) {
+    *data.doc_found = true;
+    *data.result = std::move(*child);
+  }
+  return Status::OK();
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -490,6 +575,15 @@ CHECKED_STATUS BuildSubDocument(
         value_type = ValueType::kTombstone;
       }
 
+      if (IsPackedCollectionType(value_type)) {
+        // A packed collection replaces any older entries, and writes to it always replace the
+        // whole packed value, so there is nothing else to read inside this subdocument.
+        RETURN_NOT_OK(BuildPackedSubDocument(doc_value, data));
+        VLOG(3) << "SeekOutOfSubDoc: " << SubDocKey::DebugSliceToString(key);
+        iter->SeekOutOfSubDoc(&key_copy);
+        return Status::OK();
+      }
+
       const bool is_collection = IsCollectionType(value_type);
       // We have found some key that matches our entire subdocument_key, i.e. we didn't skip ahead
       // to a lower level key (with optional object init markers).
@@ -599,6 +693,9 @@ CHECKED_STATUS BuildSubDocument(
     SubDocument* current = data.result;
     size_t num_children;
     RETURN_NOT_OK(current->NumChildren(&num_children));
+    if (data.visitor) {
+      num_children += data.record_count;
+    }
     if (data.limit != 0 && num_children >= data.limit) {
       // We have processed enough records.
       return Status::OK();
@@ -614,7 +711,13 @@ CHECKED_STATUS BuildSubDocument(
         PrimitiveValue child;
         RETURN_NOT_OK(child.DecodeFromKey(&temp));
         if (temp.empty()) {
-          current->SetChild(child, std::move(descendant));
+          if (data.visitor && current == data.result && descendant.IsPrimitive()) {
+            RETURN_NOT_OK(data.visitor->VisitKey(child));
+            RETURN_NOT_OK(data.visitor->VisitValue(descendant));
+            data.record_count++;
+          } else {
+            current->SetChild(child, std::move(descendant));
+          }
           break;
         }
         current = current->GetOrAddChild(child).first;
@@ -756,11 +859,20 @@ yb::Status GetSubDocument(
     auto temp_key = data.subdocument_key;
     temp_key.remove_prefix(dockey_size);
     for (;;) {
+      Slice remaining_subkeys = temp_key;
       auto decode_result = VERIFY_RESULT(SubDocKey::DecodeSubkey(&temp_key));
       if (!decode_result) {
         break;
       }
-      RETURN_NOT_OK(FindLastWriteTime(db_iter, key_slice, &max_overwrite_ht, &data.exp));
+      const DocHybridTime previous_overwrite_ht = max_overwrite_ht;
+      Value ancestor_value(PrimitiveValue(ValueType::kInvalid));
+      RETURN_NOT_OK(FindLastWriteTime(
+          db_iter, key_slice, &max_overwrite_ht, &data.exp, &ancestor_value));
+      if (IsPackedCollectionType(ancestor_value.value_type()) &&
+          max_overwrite_ht > previous_overwrite_ht) {
+        return GetFromPackedAncestor(
+            ancestor_value, remaining_subkeys, db_iter->read_time(), data);
+      }
       key_slice = Slice(key_slice.data(), temp_key.data() - key_slice.data());
     }
   }
@@ -797,7 +909,7 @@ yb::Status GetSubDocument(
                                    &num_values_observed));
     *data.doc_found = data.result->value_type() != ValueType::kInvalid;
     if (*data.doc_found) {
-      if (value_type == ValueType::kRedisSet) {
+      if (value_type == ValueType::kRedisSet || value_type == ValueType::kPackedRedisSet) {
         RETURN_NOT_OK(data.result->ConvertToRedisSet());
       } else if (value_type == ValueType::kRedisTS) {
         RETURN_NOT_OK(data.result->ConvertToRedisTS());
@@ -809,6 +921,26 @@ yb::Status GetSubDocument(
     }
     return Status::OK();
   }
+  if (IsPackedCollectionType(value_type)) {
+    SubDocument packed;
+    RETURN_NOT_OK(SubDocument::FromPackedValue(doc_value.primitive_value(), &packed));
+    bool has_expired = false;
+    RETURN_NOT_OK(HasExpiredTTL(data.exp.write_ht, data.exp.ttl,
+                                db_iter->read_time().read, &has_expired));
+    *data.result = SubDocument();
+    for (const PrimitiveValue& subkey : *projection) {
+      SubDocument* child = has_expired ? nullptr : packed.GetChild(subkey);
+      *data.doc_found = child != nullptr;
+      data.result->SetChild(
+          subkey, child != nullptr ? std::move(*child) : SubDocument(ValueType::kInvalid));
+    }
+    KeyBytes key_bytes(data.subdocument_key);
+    key_bytes.Truncate(dockey_size);
+    key_bytes.AppendValueType(ValueType::kMaxByte);
+    db_iter->SeekForward(&key_bytes);
+    return Status::OK();
+  }
+
   // Seed key_bytes with the subdocument key. For each subkey in the projection, build subdocument
   // and reuse key_bytes while appending the subkey.
   *data.result = SubDocument();
@@ -1133,6 +1265,11 @@ Status PrepareApplyIntentsBatch(
 
   DocHybridTimeBuffer doc_ht_buffer;
 
+  // Keys of intents and of their reverse index records contain the hybrid time of the write, so
+  // each of them is put once. Transaction metadata could be stored again, e.g. by a retried write,
+  // so it is removed with a regular delete.
+  const bool single_delete = FLAGS_docdb_single_delete_intents;
+
   IntraTxnWriteId write_id = 0;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
@@ -1154,11 +1291,17 @@ Status PrepareApplyIntentsBatch(
             regular_batch, &write_id));
       }
 
-      intents_batch->Delete(reverse_index_iter->value());
+      if (single_delete) {
+        intents_batch->SingleDelete(reverse_index_iter->value());
+        intents_batch->SingleDelete(reverse_index_iter->key());
+      } else {
+        intents_batch->Delete(reverse_index_iter->value());
+        intents_batch->Delete(reverse_index_iter->key());
+      }
+    } else {
+      intents_batch->Delete(reverse_index_iter->key());
     }
 
-    intents_batch->Delete(reverse_index_iter->key());
-
     reverse_index_iter->Next();
   }
 
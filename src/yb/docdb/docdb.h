@@ -123,7 +123,8 @@ CHECKED_STATUS ExecuteDocWriteOperation(
     KeyValueWriteBatchPB* write_batch,
     InitMarkerBehavior init_marker_behavior,
     std::atomic<int64_t>* monotonic_counter,
-    HybridTime* restart_read_ht);
+    HybridTime* restart_read_ht,
+    HotKeyValueCache* hot_key_value_cache = nullptr);
 
 void PrepareNonTransactionWriteBatch(
     const docdb::KeyValueWriteBatchPB& put_batch,
@@ -154,7 +155,8 @@ void PrepareTransactionWriteBatch(
     rocksdb::WriteBatch* rocksdb_write_batch,
     const TransactionId& transaction_id,
     IsolationLevel isolation_level,
-    IntraTxnWriteId* write_id);
+    IntraTxnWriteId* write_id,
+    IntentPrefixFilter* intent_prefix_filter = nullptr);
 
 CHECKED_STATUS PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
@@ -347,8 +349,14 @@ struct GetSubDocumentData {
   int32_t limit = 0;
   // Only store a count of the number of records found, but don't store the records themselves.
   bool count_only = false;
-  // Stores the count of records found, if count_only option is set.
+  // Stores the count of records found, if count_only option is set, or the count of children passed
+  // to visitor.
   mutable size_t record_count = 0;
+  // When set, primitive children of the requested subdocument are passed to this visitor, as
+  // VisitKey followed by VisitValue in key order, instead of being added to result. So large
+  // collections could be streamed to the response without building per-element SubDocument tree.
+  // Result still receives the type of the subdocument and its non-primitive children.
+  DocVisitor* visitor = nullptr;
 
   GetSubDocumentData Adjusted(
       const Slice& subdoc_key, SubDocument* result_, bool* doc_found_ = nullptr) const {
@@ -15,6 +15,7 @@
 
 #include <memory>
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
@@ -25,6 +26,14 @@
 #include "yb/docdb/value.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 
+DEFINE_int32(redis_ts_downsample_after_sec, 0,
+             "Redis time series samples written longer than this number of seconds before the "
+             "history cutoff are downsampled by major compactions, keeping only the latest sample "
+             "of every bucket. 0 disables downsampling.");
+DEFINE_int64(redis_ts_downsample_bucket_size, 60000,
+             "Size of a Redis time series downsampling bucket, in the units of the sample "
+             "timestamps.");
+
 using std::shared_ptr;
 using std::unique_ptr;
 using std::unordered_set;
@@ -46,6 +55,16 @@ DocDBCompactionFilter::DocDBCompactionFilter(HybridTime history_cutoff,
       filter_usage_logged_(false),
       table_ttl_(table_ttl),
       deleted_cols_(deleted_cols) {
+  if (FLAGS_redis_ts_downsample_after_sec > 0 && FLAGS_redis_ts_downsample_bucket_size > 0 &&
+      is_major_compaction_ && history_cutoff_.is_valid()) {
+    const MicrosTime cutoff_micros = history_cutoff_.GetPhysicalValueMicros();
+    const MicrosTime age_micros = static_cast<MicrosTime>(FLAGS_redis_ts_downsample_after_sec) *
+                                  MonoTime::kMicrosecondsPerSecond;
+    if (cutoff_micros > age_micros) {
+      ts_downsample_cutoff_ = HybridTime::FromMicros(cutoff_micros - age_micros);
+      ts_downsample_bucket_size_ = FLAGS_redis_ts_downsample_bucket_size;
+    }
+  }
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -69,7 +88,9 @@ bool DocDBCompactionFilter::Filter(int level,
     return true;
   }
 
-  SubDocKey subdoc_key;
+  // Decoding into a view avoids materializing the primitive values of the key, since we only
+  // compare key components here.
+  SubDocKeyView subdoc_key;
 
   // TODO: Find a better way for handling of data corruption encountered during compactions.
   const Status key_decode_status = subdoc_key.FullyDecodeFrom(key);
@@ -85,6 +106,16 @@ bool DocDBCompactionFilter::Filter(int level,
   }
 
   const size_t num_shared_components = prev_subdoc_key_.NumSharedPrefixComponents(subdoc_key);
+  if (num_shared_components == 0 && ts_downsample_bucket_size_ != 0) {
+    // The first entry of a document is its latest root entry, if it has one. Redis time series
+    // are recognized by their init marker.
+    ValueType root_value_type = ValueType::kInvalid;
+    if (subdoc_key.num_subkeys() == 0) {
+      CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &root_value_type));
+    }
+    is_redis_ts_ = root_value_type == ValueType::kRedisTS;
+    has_ts_bucket_ = false;
+  }
   // Remove overwrite hybrid_times for components that are no longer relevant for the current
   // SubDocKey.
   overwrite_ht_.resize(min(overwrite_ht_.size(), num_shared_components));
@@ -154,8 +185,9 @@ bool DocDBCompactionFilter::Filter(int level,
     overwrite_ht_.pop_back();
     expiration_.pop_back();
   }
-  if (subdoc_key.doc_key() != prev_subdoc_key_.doc_key() ||
-      subdoc_key.subkeys() != prev_subdoc_key_.subkeys()) {
+  const bool is_first_version = subdoc_key.encoded_without_hybrid_time() !=
+                                prev_subdoc_key_.encoded_without_hybrid_time();
+  if (is_first_version) {
     within_merge_block_ = false;
   }
 
@@ -165,7 +197,11 @@ bool DocDBCompactionFilter::Filter(int level,
   // hybrid time that does not exceed the cutoff hybrid time. In that case this entry is obviously
   // too new to be garbage-collected.
   if (ht.hybrid_time() > history_cutoff_) {
-    prev_subdoc_key_ = std::move(subdoc_key);
+    if (is_redis_ts_ && is_first_version && !isTtlRow) {
+      // Too new to be downsampled itself, but still the latest sample of its bucket.
+      IsRedundantTimeSeriesSample(subdoc_key, existing_value, false /* can_drop */);
+    }
+    prev_subdoc_key_.CopyFrom(subdoc_key, &prev_subdoc_key_buffer_);
     overwrite_ht_.push_back(prev_overwrite_ht);
     expiration_.push_back(prev_exp);
     return false;
@@ -177,11 +213,14 @@ bool DocDBCompactionFilter::Filter(int level,
   // TODO: could there be a case when there is still a read request running that uses an old schema,
   //       and we end up removing some data that the client expects to see?
   if (subdoc_key.num_subkeys() > 0) {
-    const auto& first_subkey = subdoc_key.subkeys()[0];
+    Slice first_subkey_slice = subdoc_key.subkey(0);
     // Column ID is the first subkey in every CQL row.
-    if (first_subkey.value_type() == ValueType::kColumnId &&
-        deleted_cols_->find(first_subkey.GetColumnId()) != deleted_cols_->end()) {
-      return true;
+    if (DecodeValueType(first_subkey_slice) == ValueType::kColumnId) {
+      PrimitiveValue first_subkey;
+      CHECK_OK(first_subkey.DecodeFromKey(&first_subkey_slice));
+      if (deleted_cols_->find(first_subkey.GetColumnId()) != deleted_cols_->end()) {
+        return true;
+      }
     }
   }
   overwrite_ht_.push_back(isTtlRow ? prev_overwrite_ht : max(prev_overwrite_ht, ht));
@@ -208,7 +247,7 @@ bool DocDBCompactionFilter::Filter(int level,
 
   CHECK_EQ(new_stack_size, overwrite_ht_.size());
   CHECK_EQ(new_stack_size, expiration_.size());
-  prev_subdoc_key_ = std::move(subdoc_key);
+  prev_subdoc_key_.CopyFrom(subdoc_key, &prev_subdoc_key_buffer_);
 
   // If the entry has the TTL flag, delete the entry.
   if (isTtlRow) {
@@ -229,6 +268,14 @@ bool DocDBCompactionFilter::Filter(int level,
   // compact away each column if it has expired, including the liveness system column. The init
   // markers in Redis wouldn't be affected since they don't have any TTL associated with them and
   // the TTL would default to kMaxTtl which would make has_expired false.
+  if (!has_expired && is_redis_ts_ && is_first_version &&
+      IsRedundantTimeSeriesSample(subdoc_key, existing_value,
+                                  ht.hybrid_time() <= ts_downsample_cutoff_)) {
+    // Only major compactions downsample, so the older versions of this sample are dropped as
+    // well and nothing is exposed by removing it.
+    return true;
+  }
+
   if (has_expired) {
     // This is consistent with the condition we're testing for deletes at the bottom of the function
     // because ht_at_or_below_cutoff is implied by has_expired.
@@ -261,6 +308,39 @@ bool DocDBCompactionFilter::Filter(int level,
   return value_type == ValueType::kTombstone && is_major_compaction_;
 }
 
+bool DocDBCompactionFilter::IsRedundantTimeSeriesSample(const SubDocKeyView& subdoc_key,
+                                                        const rocksdb::Slice& existing_value,
+                                                        bool can_drop) const {
+  if (subdoc_key.num_subkeys() != 1) {
+    return false;
+  }
+  Slice subkey_slice = subdoc_key.subkey(0);
+  if (DecodeValueType(subkey_slice) != ValueType::kInt64Descending) {
+    return false;
+  }
+  ValueType value_type;
+  CHECK_OK(Value::DecodePrimitiveValueType(existing_value, &value_type));
+  if (value_type == ValueType::kTombstone) {
+    return false;
+  }
+  PrimitiveValue timestamp;
+  CHECK_OK(timestamp.DecodeFromKey(&subkey_slice));
+
+  // Samples are ordered by descending timestamp, so the previous kept sample is the latest one of
+  // its bucket.
+  const int64_t ts = timestamp.GetInt64();
+  int64_t bucket = ts / ts_downsample_bucket_size_;
+  if (ts % ts_downsample_bucket_size_ < 0) {
+    --bucket;
+  }
+  if (can_drop && has_ts_bucket_ && bucket == last_ts_bucket_) {
+    return true;
+  }
+  last_ts_bucket_ = bucket;
+  has_ts_bucket_ = true;
+  return false;
+}
+
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
@@ -268,9 +348,9 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    shared_ptr<HistoryRetentionPolicy> retention_policy)
-    :
-    retention_policy_(retention_policy) {
+    shared_ptr<HistoryRetentionPolicy> retention_policy, bool filter_on_flush)
+    : retention_policy_(retention_policy),
+      filter_on_flush_(filter_on_flush) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -288,5 +368,19 @@ const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+rocksdb::Slice DocDBCompactionFilterFactory::GetSubcompactionBoundary(
+    const rocksdb::Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    // Keys that are not doc keys, for instance transaction metadata, belong to no document.
+    return user_key;
+  }
+  return rocksdb::Slice(user_key.data(), *doc_key_size);
+}
+
+bool DocDBCompactionFilterFactory::FilterOnFlush() const {
+  return filter_on_flush_;
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "yb/rocksdb/compaction_filter.h"
@@ -44,12 +45,23 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
               bool* value_changed) const override;
   const char* Name() const override;
 
+  // Every DocDB key contains the hybrid time and write id of its version, so it is never written
+  // again.
+  bool RemovedKeysAreUnique() const override { return true; }
+
   // This indicates we don't have a cached TTL. We need this to be different from kMaxTtl
   // and kResetTtl because a PERSIST call would lead to a cached TTL of kMaxTtl, and kResetTtl
   // indicates no TTL in Cassandra.
   const MonoDelta kNoTtl = MonoDelta::FromNanoseconds(-1);
 
  private:
+  // Returns true if the given live Redis time series sample could be dropped because a later
+  // sample in the same downsampling bucket is kept. Otherwise remembers the sample's bucket.
+  // can_drop is false for samples that are too recent to be downsampled.
+  bool IsRedundantTimeSeriesSample(const SubDocKeyView& subdoc_key,
+                                   const rocksdb::Slice& existing_value,
+                                   bool can_drop) const;
+
   // We will not keep history below this hybrid_time. The view of the database at this hybrid_time
   // is preserved, but after the compaction completes, we should not expect to be able to do
   // consistent scans at DocDB hybrid times lower than this. Those scans will result in missing
@@ -59,7 +71,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   const bool is_major_compaction_;
 
   mutable bool is_first_key_value_;
-  mutable SubDocKey prev_subdoc_key_;
+  // Previous key, decoded as a view pointing into prev_subdoc_key_buffer_.
+  mutable std::string prev_subdoc_key_buffer_;
+  mutable SubDocKeyView prev_subdoc_key_;
 
   // A stack of highest hybrid_times lower than or equal to history_cutoff_ at which parent
   // subdocuments of the key that has just been processed, or the subdocument / primitive value
@@ -108,6 +122,17 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   MonoDelta table_ttl_;
   mutable bool within_merge_block_ = false;
   ColumnIdsPtr deleted_cols_;
+
+  // Redis time series samples written at or before this hybrid time are downsampled to one sample
+  // per bucket of ts_downsample_bucket_size_. Downsampling is disabled when the bucket size is 0.
+  HybridTime ts_downsample_cutoff_ = HybridTime::kMin;
+  int64_t ts_downsample_bucket_size_ = 0;
+
+  // Whether the document being processed is a Redis time series, and the downsampling bucket of
+  // its latest kept sample.
+  mutable bool is_redis_ts_ = false;
+  mutable bool has_ts_bucket_ = false;
+  mutable int64_t last_ts_bucket_ = 0;
 };
 
 // A strategy for deciding the history cutoff. We may implement this differently in production and
@@ -147,14 +172,24 @@ class FixedHybridTimeRetentionPolicy : public HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  // If filter_on_flush is set, flushes drop versions of the memtable that are overwritten inside it
+  // at or before the history cutoff, as a minor compaction of the flushed file would.
+  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+                                        bool filter_on_flush = false);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // Returns the encoded doc key of the given key, so a subcompaction always receives all keys
+  // of a document and DocDBCompactionFilter could track overwrites of the document.
+  rocksdb::Slice GetSubcompactionBoundary(const rocksdb::Slice& user_key) const override;
+
+  bool FilterOnFlush() const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const bool filter_on_flush_;
 };
 
 }  // namespace docdb
@@ -13,18 +13,28 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
-#include <thread>
+#include <algorithm>
 #include <memory>
+#include <thread>
+
+#include <boost/container/small_vector.hpp>
 
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/db/compaction.h"
+#include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/metadata.h"
 #include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table.h"
+#include "yb/rocksdb/util/compression.h"
 
+#include "yb/docdb/doc_key.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
@@ -55,6 +65,45 @@ DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Max number of key ranges a single large compaction is split into, to be compacted "
+             "in parallel. 1 - no split.");
+DEFINE_int32(rocksdb_memtable_insert_parallelism, 1,
+             "Max number of threads inserting updates of a single large write batch into the "
+             "memtable. 1 - updates are inserted by the writing thread only.");
+DEFINE_int32(rocksdb_hashed_memtable_bucket_count, 50000,
+             "Number of hash buckets of memtables that hash entries by hashed components of doc "
+             "keys.");
+DEFINE_int32(rocksdb_min_memtable_insert_entries_per_thread, 1024,
+             "Min number of updates of a write batch inserted into the memtable by each thread, "
+             "when rocksdb_memtable_insert_parallelism is greater than 1.");
+DEFINE_int32(rocksdb_compression_dict_max_bytes, 0,
+             "When positive, SST data blocks are compressed with ZSTD using a dictionary of at "
+             "most this size, trained on sampled data blocks of the previous flush or compaction "
+             "output of the tablet. 0 - Snappy compression without a dictionary.");
+DEFINE_int32(rocksdb_compression_dict_max_train_bytes, 0,
+             "Max size of data blocks sampled from a single SST file to train the compression "
+             "dictionary. 0 - 100 times rocksdb_compression_dict_max_bytes.");
+DEFINE_int32(rocksdb_universal_compression_size_percent, -1,
+             "Percentage of the tablet data, counted from the oldest SST file, that universal "
+             "compactions compress. Outputs of compactions of newer files, which are soon "
+             "compacted again, are not compressed. -1 - all compaction outputs are compressed.");
+DEFINE_uint64(rocksdb_min_compressed_output_size_bytes, 0,
+              "Flush and universal compaction outputs estimated to be smaller than this are not "
+              "compressed, since the CPU spent is not worth the space saved. 0 - no limit.");
+DEFINE_uint64(rocksdb_large_output_compression_size_bytes, 0,
+              "Universal compaction outputs estimated to be at least this large are compressed "
+              "with rocksdb_large_output_compression. 0 - large outputs use the default "
+              "compression.");
+DEFINE_string(rocksdb_large_output_compression, "zstd",
+              "Compression of large universal compaction outputs: snappy, lz4, zstd or none.");
+DEFINE_int32(rocksdb_large_output_compression_level, -1,
+             "Level of the compression of large universal compaction outputs, for codecs that "
+             "support levels. -1 - default level of the codec.");
+
+DEFINE_bool(rocksdb_use_direct_io_for_compaction, false,
+            "Read compaction input files and write compaction output files bypassing the OS page "
+            "cache, so compactions do not evict data cached for foreground reads.");
 
 DEFINE_int64(db_block_size_bytes, 32_KB,
              "Size of RocksDB data block (in bytes).");
@@ -62,6 +111,14 @@ DEFINE_int64(db_block_size_bytes, 32_KB,
 DEFINE_int64(db_filter_block_size_bytes, 64_KB,
              "Size of RocksDB filter block (in bytes).");
 
+DEFINE_bool(db_cache_filter_index, false,
+            "Whether to load index of RocksDB bloom filter on demand through the block cache "
+            "instead of keeping it in memory while the SST file is open.");
+
+DEFINE_bool(db_cache_filter_blocks_with_high_priority, false,
+            "Whether to put RocksDB bloom filter blocks and filter index into the multi-touch part "
+            "of the block cache, so they are not evicted by data blocks read once.");
+
 DEFINE_int64(db_index_block_size_bytes, 32_KB,
              "Size of RocksDB index block (in bytes).");
 
@@ -73,10 +130,24 @@ DEFINE_int64(db_write_buffer_size, -1,
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(use_blocked_bloom_filter, false,
+            "Whether the DocDbAwareFilterPolicy should build blocked bloom filters, which are "
+            "checked with one mask comparison per key. Filters of SST files written before the "
+            "flag was changed are not used until the files are compacted.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
+DEFINE_bool(use_shared_block_prefix_key_encoding, false,
+            "Whether to delta encode keys at restart points of SST data blocks against the first "
+            "key of the block, so that DocDB key prefixes (hash and hashed components) are stored "
+            "once per block. Files written with this option could not be read by older versions.");
+DEFINE_bool(rocksdb_track_file_expiration, false,
+            "Whether to record the expiration time of the latest record in the metadata of SST "
+            "files, so that fully expired files could be deleted without a compaction. Takes "
+            "effect when a tablet is opened. Files written with this option could not be opened "
+            "by older versions, so it should only be enabled after an upgrade is finalized.");
+TAG_FLAG(rocksdb_track_file_expiration, advanced);
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
@@ -88,7 +159,58 @@ using strings::Substitute;
 namespace yb {
 namespace docdb {
 
-std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
+std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance(
+    bool track_expiration);
+HybridTime FileExpirationTime(const rocksdb::UserBoundaryValues& largest, MonoDelta table_ttl);
+std::shared_ptr<rocksdb::TimeWindowExtractor> CreateDocTimeWindowExtractor(MonoDelta window);
+
+namespace {
+
+// Extracts hashed components of doc keys, so all keys of a hashed key prefix, e.g. of a Redis key,
+// are put to the same memtable bucket.
+class HashedComponentsTransform : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "DocKeyHashedComponents"; }
+
+  Slice Transform(const Slice& key) const override {
+    auto size = DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY);
+    // Keys that could not be decoded are hashed as a whole.
+    return size.ok() ? Slice(key.data(), *size) : key;
+  }
+
+  bool InDomain(const Slice& key) const override { return true; }
+
+  bool InRange(const Slice& dst) const override { return true; }
+};
+
+class KeyBoundsFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  KeyBoundsFileFilter(KeyBytes lower_bound, KeyBytes upper_bound,
+                      std::shared_ptr<rocksdb::ReadFileFilter> file_filter)
+      : lower_bound_(std::move(lower_bound)), upper_bound_(std::move(upper_bound)),
+        file_filter_(std::move(file_filter)) {}
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    if (!lower_bound_.empty() && file.largest.user_key().compare(lower_bound_.AsSlice()) < 0) {
+      return false;
+    }
+    if (!upper_bound_.empty() && file.smallest.user_key().compare(upper_bound_.AsSlice()) > 0) {
+      return false;
+    }
+    return !file_filter_ || file_filter_->Filter(file);
+  }
+
+ private:
+  const KeyBytes lower_bound_;
+  const KeyBytes upper_bound_;
+  const std::shared_ptr<rocksdb::ReadFileFilter> file_filter_;
+};
+
+// Seek keys that are built from a key and a short suffix. Typical keys fit into the inline buffer,
+// so such seeks do not allocate.
+typedef boost::container::small_vector<char, 64> SeekKeyBuffer;
+
+} // namespace
 
 Status SeekToValidKvAtTs(
     rocksdb::Iterator *iter,
@@ -142,7 +264,7 @@ Status SeekToValidKvAtTs(
     // a.b @ HT(20)
     // a.c @ HT(10)
 
-    seek_key_bytes = KeyBytes(iter->key());
+    seek_key_bytes.Reset(iter->key());
     // Continuing the example above, we would seek at a.b @ HT(15) and find a.c @ HT(10) on the next
     // loop iteration.
     RETURN_NOT_OK(seek_key_bytes.ReplaceLastHybridTimeForSeek(hybrid_time));
@@ -203,14 +325,18 @@ KeyBytes AppendDocHt(const Slice& key, const DocHybridTime& doc_ht) {
 }
 
 void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter) {
-  SeekForward(AppendDocHt(key, DocHybridTime::kMin), iter);
+  char buf[kMaxBytesPerEncodedHybridTime + 1];
+  buf[0] = ValueTypeAsChar::kHybridTime;
+  auto end = DocHybridTime::kMin.EncodedInDocDbFormat(buf + 1);
+  SeekKeyBuffer seek_key(key.cdata(), key.cend());
+  seek_key.insert(seek_key.end(), buf, end);
+  SeekForward(Slice(seek_key.data(), seek_key.size()), iter);
 }
 
 void SeekOutOfSubKey(const Slice& key, rocksdb::Iterator* iter) {
-  KeyBytes key_bytes;
-  key_bytes.Reserve(key.size() + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekOutOfSubKey(&key_bytes, iter);
+  SeekKeyBuffer seek_key(key.cdata(), key.cend());
+  seek_key.push_back(ValueTypeAsChar::kMaxByte);
+  SeekForward(Slice(seek_key.data(), seek_key.size()), iter);
 }
 
 void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter) {
@@ -334,13 +460,46 @@ rocksdb::ReadOptions PrepareReadOptions(
     read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
         NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
   }
+  // Reads using bloom filters do not go beyond hashed components of the key, so memtables that
+  // hash entries by hashed components could look into a single bucket.
+  read_opts.memtable_prefix_seek = bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER;
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
   return read_opts;
 }
 
+Result<rocksdb::CompressionType> LargeOutputCompression() {
+  const auto& name = FLAGS_rocksdb_large_output_compression;
+  rocksdb::CompressionType result;
+  if (name == "snappy") {
+    result = rocksdb::kSnappyCompression;
+  } else if (name == "lz4") {
+    result = rocksdb::kLZ4Compression;
+  } else if (name == "zstd") {
+    result = rocksdb::kZSTDNotFinalCompression;
+  } else if (name == "none") {
+    result = rocksdb::kNoCompression;
+  } else {
+    return STATUS_FORMAT(InvalidArgument, "Unknown compression: $0", name);
+  }
+  if (!rocksdb::CompressionTypeSupported(result)) {
+    return STATUS_FORMAT(NotSupported, "Compression is not supported: $0", name);
+  }
+  return result;
+}
+
 } // namespace
 
+std::shared_ptr<rocksdb::ReadFileFilter> CreateKeyBoundsFileFilter(
+    KeyBytes lower_bound, KeyBytes upper_bound,
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter) {
+  if (lower_bound.empty() && upper_bound.empty()) {
+    return file_filter;
+  }
+  return std::make_shared<KeyBoundsFileFilter>(
+      std::move(lower_bound), std::move(upper_bound), std::move(file_filter));
+}
+
 unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -373,7 +532,8 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& tablet_id,
     const shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options) {
+    const tablet::TabletOptions& tablet_options,
+    size_t bloom_filter_range_components) {
   options->create_if_missing = true;
   options->disableDataSync = true;
   options->statistics = statistics;
@@ -381,11 +541,44 @@ void InitRocksDBOptions(
   options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
-  options->boundary_extractor = DocBoundaryValuesExtractorInstance();
+  options->boundary_extractor = DocBoundaryValuesExtractorInstance(
+      FLAGS_rocksdb_track_file_expiration);
   options->memory_monitor = tablet_options.memory_monitor;
+  if (FLAGS_rocksdb_memtable_insert_parallelism > 1 && tablet_options.memtable_insert_pool) {
+    options->allow_concurrent_memtable_write = true;
+    options->memtable_insert_thread_pool = tablet_options.memtable_insert_pool;
+    options->memtable_insert_parallelism = FLAGS_rocksdb_memtable_insert_parallelism;
+    options->min_memtable_insert_entries_per_thread =
+        std::max(FLAGS_rocksdb_min_memtable_insert_entries_per_thread, 1);
+  }
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
   }
+  if (FLAGS_rocksdb_compression_dict_max_bytes > 0) {
+    if (rocksdb::ZSTD_Supported() && rocksdb::ZSTD_TrainDictionarySupported()) {
+      options->compression = rocksdb::kZSTDNotFinalCompression;
+      options->compression_opts.max_dict_bytes = FLAGS_rocksdb_compression_dict_max_bytes;
+      options->compression_opts.zstd_max_train_bytes =
+          std::max(FLAGS_rocksdb_compression_dict_max_train_bytes, 0);
+    } else {
+      LOG(WARNING) << options->log_prefix
+                   << "ZSTD dictionary compression is not supported, using default compression";
+    }
+  }
+  options->min_compressed_output_size = FLAGS_rocksdb_min_compressed_output_size_bytes;
+  if (FLAGS_rocksdb_large_output_compression_size_bytes > 0) {
+    auto large_output_compression = LargeOutputCompression();
+    if (large_output_compression.ok()) {
+      options->large_output_size = FLAGS_rocksdb_large_output_compression_size_bytes;
+      options->large_output_compression = *large_output_compression;
+      if (FLAGS_rocksdb_large_output_compression_level != -1) {
+        options->compression_opts.level = FLAGS_rocksdb_large_output_compression_level;
+      }
+    } else {
+      LOG(WARNING) << options->log_prefix << large_output_compression.status()
+                   << ", using default compression for large compaction outputs";
+    }
+  }
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
       tablet_options.listeners.end()); // Append listeners
@@ -400,15 +593,20 @@ void InitRocksDBOptions(
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
   }
+  table_options.block_cache_compressed = tablet_options.persistent_block_cache;
   table_options.block_size = FLAGS_db_block_size_bytes;
   table_options.filter_block_size = FLAGS_db_filter_block_size_bytes;
+  table_options.cache_filter_index = FLAGS_db_cache_filter_index && !table_options.no_block_cache;
+  table_options.cache_filter_blocks_with_high_priority =
+      FLAGS_db_cache_filter_blocks_with_high_priority;
   table_options.index_block_size = FLAGS_db_index_block_size_bytes;
   table_options.min_keys_per_index_block = FLAGS_db_min_keys_per_index_block;
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        bloom_filter_range_components, FLAGS_use_blocked_bloom_filter));
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -417,6 +615,11 @@ void InitRocksDBOptions(
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
 
+  if (FLAGS_use_shared_block_prefix_key_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix;
+  }
+
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
   // Compaction related options.
@@ -461,8 +664,14 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_size_ratio;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    options->compaction_options_universal.compression_size_percent =
+        FLAGS_rocksdb_universal_compression_size_percent;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    options->max_subcompactions = FLAGS_rocksdb_max_subcompactions;
+    options->use_direct_io_for_compaction = FLAGS_rocksdb_use_direct_io_for_compaction;
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
@@ -474,5 +683,73 @@ void InitRocksDBOptions(
   }
 }
 
+namespace {
+
+bool IsLiveFile(rocksdb::DB* db, const std::string& name) {
+  std::vector<rocksdb::LiveFileMetaData> live_files;
+  db->GetLiveFilesMetaData(&live_files);
+  for (const auto& file : live_files) {
+    if (file.name == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+Result<size_t> DeleteExpiredFiles(
+    rocksdb::DB* db, HybridTime history_cutoff, MonoDelta table_ttl) {
+  if (table_ttl.Equals(Value::kMaxTtl)) {
+    return 0;
+  }
+  rocksdb::ColumnFamilyMetaData cf_meta;
+  db->GetColumnFamilyMetaData(&cf_meta);
+  if (cf_meta.levels.empty()) {
+    return 0;
+  }
+  for (size_t level = 1; level < cf_meta.levels.size(); ++level) {
+    if (!cf_meta.levels[level].files.empty()) {
+      // Only files of the last level could be deleted.
+      return 0;
+    }
+  }
+  // Level 0 files are ordered from the newest to the oldest.
+  const auto& files = cf_meta.levels[0].files;
+  size_t deleted = 0;
+  for (auto it = files.rbegin(); it != files.rend(); ++it) {
+    if (it->being_compacted) {
+      break;
+    }
+    auto expiration = FileExpirationTime(it->largest.user_values, table_ttl);
+    if (expiration > history_cutoff) {
+      break;
+    }
+    LOG(INFO) << "Deleting expired file " << it->name << ", expiration: " << expiration
+              << ", history cutoff: " << history_cutoff;
+    RETURN_NOT_OK(db->DeleteFile(it->name));
+    // DeleteFile succeeds without deleting a file that was picked by a compaction in the meantime.
+    if (IsLiveFile(db, it->name)) {
+      LOG(INFO) << "Expired file " << it->name << " was not deleted, it is being compacted";
+      break;
+    }
+    ++deleted;
+  }
+  return deleted;
+}
+
+void UseHashedComponentsMemTable(rocksdb::Options* options) {
+  options->memtable_factory.reset(rocksdb::NewOrderedHashLinkListRepFactory(
+      std::make_shared<HashedComponentsTransform>(),
+      std::max(FLAGS_rocksdb_hashed_memtable_bucket_count, 1)));
+  // Hash linked list memtables do not support concurrent inserts.
+  options->allow_concurrent_memtable_write = false;
+  options->memtable_insert_thread_pool = nullptr;
+}
+
+void UseTimeWindowCompaction(rocksdb::Options* options, MonoDelta window) {
+  options->time_window_extractor = CreateDocTimeWindowExtractor(window);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -129,13 +129,39 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
     const Slice* iterate_upper_bound = nullptr);
 
+// Returns a filter that skips SST files without keys in [lower_bound, upper_bound], in addition to
+// files skipped by file_filter. Bounds are encoded keys, an empty bound means that the range is not
+// bounded from that side. Only the smallest and largest keys of the file are checked, so files are
+// skipped without opening them.
+std::shared_ptr<rocksdb::ReadFileFilter> CreateKeyBoundsFileFilter(
+    KeyBytes lower_bound, KeyBytes upper_bound,
+    std::shared_ptr<rocksdb::ReadFileFilter> file_filter);
+
 // Initialize the RocksDB 'options' object for tablet identified by 'tablet_id'. The 'statistics'
 // object provided by the caller will be used by RocksDB to maintain the stats for the tablet
-// specified by 'tablet_id'.
+// specified by 'tablet_id'. Bloom filter keys include the first 'bloom_filter_range_components'
+// range components of doc keys, in addition to hashed components.
 void InitRocksDBOptions(
     rocksdb::Options* options, const std::string& tablet_id,
     const std::shared_ptr<rocksdb::Statistics>& statistics,
-    const tablet::TabletOptions& tablet_options);
+    const tablet::TabletOptions& tablet_options,
+    size_t bloom_filter_range_components = 0);
+
+// Makes memtables hash entries by hashed components of doc keys, in addition to keeping them in
+// key order. So reads with BloomFilterMode::USE_BLOOM_FILTER, e.g. Redis GET, look up a single
+// hash bucket instead of searching the whole memtable. Disables concurrent memtable inserts.
+void UseHashedComponentsMemTable(rocksdb::Options* options);
+
+// Makes universal compaction keep SST files of different time windows apart, grouping files by the
+// hybrid time of their latest records. Suits time series tables with TTL, whose files are then
+// deleted a window at a time once they expire, see DeleteExpiredFiles.
+void UseTimeWindowCompaction(rocksdb::Options* options, MonoDelta window);
+
+// Deletes the oldest SST files of the regular RocksDB, if all their records are expired at
+// history_cutoff, given the table level TTL. There are no older records that records of such files
+// could overwrite, so they are deleted without compaction. Returns the number of deleted files.
+Result<size_t> DeleteExpiredFiles(
+    rocksdb::DB* db, HybridTime history_cutoff, MonoDelta table_ttl);
 
 }  // namespace docdb
 }  // namespace yb
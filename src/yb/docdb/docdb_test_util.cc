@@ -96,6 +96,10 @@ class NonTransactionalStatusProvider: public TransactionStatusManager {
     Fail();
   }
 
+  void WaitForTransactionsCompletion(MonoTime deadline) override {
+    Fail();
+  }
+
  private:
   static void Fail() {
     LOG(FATAL) << "Internal error: trying to get transaction status for non transactional table";
@@ -174,6 +174,13 @@ class DocDBRocksDBUtil {
     return ReopenRocksDB();
   }
 
+  CHECKED_STATUS EnableFilterOnFlush() {
+    rocksdb_options_.compaction_filter_factory =
+        std::make_shared<DocDBCompactionFilterFactory>(
+            retention_policy_, true /* filter_on_flush */);
+    return ReopenRocksDB();
+  }
+
   CHECKED_STATUS ReinitDBOptions();
 
   std::atomic<int64_t>& monotonic_counter() {
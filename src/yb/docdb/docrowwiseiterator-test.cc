@@ -441,6 +441,49 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorIncompleteProjection) {
   }
 }
 
+// Rows of the same iterator could be read with different projections, e.g. with static and
+// non-static columns.
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorDifferentProjections) {
+  auto dwb = MakeDocWriteBatch();
+
+  for (const auto* doc_key : {&kEncodedDocKey1, &kEncodedDocKey2}) {
+    ASSERT_OK(dwb.SetPrimitive(DocPath(*doc_key, PrimitiveValue(30_ColId)),
+        PrimitiveValue("c")));
+    ASSERT_OK(dwb.SetPrimitive(DocPath(*doc_key, PrimitiveValue(40_ColId)),
+        PrimitiveValue(10000)));
+  }
+
+  ASSERT_OK(WriteToRocksDB(dwb, HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  Schema c_projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"c"}, &c_projection));
+  Schema d_projection;
+  ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"d"}, &d_projection));
+
+  DocRowwiseIterator iter(
+      kProjectionForIteratorTests, schema, kNonTransactionalOperationContext, doc_db(),
+      MonoTime::Max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  for (const auto* projection : {&c_projection, &d_projection}) {
+    QLTableRow row;
+    ASSERT_TRUE(iter.HasNext());
+    ASSERT_OK(iter.NextRow(*projection, &row));
+
+    QLValue value;
+    ASSERT_OK(row.GetValue(30_ColId, &value));
+    ASSERT_EQ(projection == &d_projection, value.IsNull());
+    ASSERT_OK(row.GetValue(40_ColId, &value));
+    ASSERT_EQ(projection == &c_projection, value.IsNull());
+    if (!value.IsNull()) {
+      ASSERT_EQ(10000, value.int64_value());
+    }
+  }
+
+  ASSERT_FALSE(iter.HasNext());
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorMultipleDeletes) {
   auto dwb = MakeDocWriteBatch();
 
@@ -915,6 +958,49 @@ TXN REV 30303030-3030-3030-3030-303030303031 HT{ physical: 500 w: 1 } -> \
   ASSERT_EQ(doc_ht.ToString(), "HT{ physical: 1000 }");
 }
 
+TEST_F(DocRowwiseIteratorTest, IntentAwareIteratorSeekToKeyInBatch) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+
+  TransactionStatusManagerMock txn_status_manager;
+
+  Result<TransactionId> txn = FullyDecodeTransactionId("0000000000000001");
+  ASSERT_OK(txn);
+
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+
+  SetCurrentTransactionId(*txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_txn"), HybridTime::FromMicros(500)));
+  ResetCurrentTransactionId();
+
+  IntentAwareIterator iter(
+      doc_db(), rocksdb::ReadOptions(), MonoTime::Max() /* deadline */,
+      ReadHybridTime::FromMicros(2000), TransactionOperationContext(*txn, &txn_status_manager));
+
+  // Look up both keys from a sorted batch, first one is regular record, second one is intent.
+  for (const auto& expected : {std::make_pair(&kEncodedDocKey1, "row1_c"),
+                               std::make_pair(&kEncodedDocKey2, "row2_c_txn")}) {
+    iter.SeekToKeyInBatch(*expected.first);
+    ASSERT_TRUE(iter.valid());
+    Result<Slice> key = iter.FetchKey();
+    ASSERT_OK(key);
+    ASSERT_TRUE(key->starts_with(expected.first->AsSlice()));
+    Value value;
+    ASSERT_OK(value.Decode(iter.value()));
+    ASSERT_EQ(expected.second, value.primitive_value().GetString());
+  }
+
+  // Key before current position falls back to regular seek.
+  iter.SeekToKeyInBatch(kEncodedDocKey1);
+  ASSERT_TRUE(iter.valid());
+  Result<Slice> key = iter.FetchKey();
+  ASSERT_OK(key);
+  ASSERT_TRUE(key->starts_with(kEncodedDocKey1.AsSlice()));
+}
+
 TEST_F(DocRowwiseIteratorTest, SeekTwiceWithinTheSameTxn) {
   SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
 
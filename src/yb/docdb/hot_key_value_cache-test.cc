@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/hot_key_value_cache.h"
+#include "yb/docdb/value.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class HotKeyValueCacheTest : public YBTest {
+ protected:
+  static std::string RedisKey(const std::string& key) {
+    return DocKey::EncodedFromRedisKey(0, key).data();
+  }
+
+  static void AddPair(const std::string& key, const Value& value, KeyValueWriteBatchPB* batch) {
+    auto* kv_pair = batch->add_kv_pairs();
+    kv_pair->set_key(key);
+    kv_pair->set_value(value.Encode());
+  }
+
+  static Value StringValue(const std::string& str) {
+    return Value(PrimitiveValue(str));
+  }
+};
+
+TEST_F(HotKeyValueCacheTest, UpdateAndInvalidate) {
+  HotKeyValueCache cache(2);
+  const HybridTime write_time(1000);
+  std::string value;
+  HybridTime cached_write_time;
+
+  KeyValueWriteBatchPB batch;
+  AddPair(RedisKey("a"), StringValue("1"), &batch);
+  AddPair(RedisKey("b"), Value(PrimitiveValue("2"), MonoDelta::FromSeconds(10)), &batch);
+  cache.Invalidate(batch);
+  cache.Update(batch, write_time);
+
+  ASSERT_TRUE(cache.Get(RedisKey("a"), write_time, &value, &cached_write_time));
+  ASSERT_EQ("1", value);
+  ASSERT_EQ(write_time, cached_write_time);
+  // Values are not visible before they are written.
+  ASSERT_FALSE(cache.Get(RedisKey("a"), HybridTime(999), &value, &cached_write_time));
+  // Values with TTL are not cached.
+  ASSERT_FALSE(cache.Get(RedisKey("b"), write_time, &value, &cached_write_time));
+
+  // Writing a subkey of a cached document invalidates it.
+  KeyValueWriteBatchPB subkey_batch;
+  KeyBytes subkey = DocKey::EncodedFromRedisKey(0, "a");
+  PrimitiveValue("field").AppendToKey(&subkey);
+  AddPair(subkey.data(), StringValue("3"), &subkey_batch);
+  cache.Invalidate(subkey_batch);
+  ASSERT_FALSE(cache.Get(RedisKey("a"), write_time, &value, &cached_write_time));
+  cache.Update(subkey_batch, write_time);
+  ASSERT_FALSE(cache.Get(RedisKey("a"), write_time, &value, &cached_write_time));
+}
+
+TEST_F(HotKeyValueCacheTest, EvictLeastRecentlyUpdated) {
+  HotKeyValueCache cache(2);
+  const HybridTime write_time(1000);
+  std::string value;
+  HybridTime cached_write_time;
+
+  for (const auto& key : {"a", "b", "a", "c"}) {
+    KeyValueWriteBatchPB batch;
+    AddPair(RedisKey(key), StringValue(key), &batch);
+    cache.Invalidate(batch);
+    cache.Update(batch, write_time);
+  }
+
+  ASSERT_TRUE(cache.Get(RedisKey("a"), write_time, &value, &cached_write_time));
+  ASSERT_EQ("a", value);
+  ASSERT_FALSE(cache.Get(RedisKey("b"), write_time, &value, &cached_write_time));
+  ASSERT_TRUE(cache.Get(RedisKey("c"), write_time, &value, &cached_write_time));
+
+  cache.Clear();
+  ASSERT_FALSE(cache.Get(RedisKey("a"), write_time, &value, &cached_write_time));
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,120 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/hot_key_value_cache.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/value.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Returns the size of the encoded doc key at the start of the given key, or an error if the key
+// could not be decoded.
+Result<size_t> DocKeySize(const std::string& key) {
+  return DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+}
+
+} // namespace
+
+HotKeyValueCache::HotKeyValueCache(size_t capacity) : capacity_(capacity) {
+}
+
+bool HotKeyValueCache::Get(const Slice& encoded_doc_key, HybridTime read_time, std::string* value,
+                           HybridTime* write_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(encoded_doc_key.ToBuffer());
+  if (it == entries_.end() || it->second.write_time > read_time) {
+    return false;
+  }
+  *value = it->second.value;
+  *write_time = it->second.write_time;
+  return true;
+}
+
+void HotKeyValueCache::Invalidate(const KeyValueWriteBatchPB& put_batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.empty()) {
+    return;
+  }
+  for (const auto& kv_pair : put_batch.kv_pairs()) {
+    auto doc_key_size = DocKeySize(kv_pair.key());
+    if (!doc_key_size.ok()) {
+      // We do not know which document is modified, so nothing could be trusted.
+      entries_.clear();
+      lru_.clear();
+      return;
+    }
+    EraseUnlocked(kv_pair.key().substr(0, *doc_key_size));
+  }
+}
+
+void HotKeyValueCache::Update(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& kv_pair : put_batch.kv_pairs()) {
+    auto doc_key_size = DocKeySize(kv_pair.key());
+    if (!doc_key_size.ok()) {
+      continue;
+    }
+    std::string doc_key = kv_pair.key().substr(0, *doc_key_size);
+
+    // Key of a top-level document does not have subkeys, and is replicated without hybrid time.
+    Value value;
+    if (*doc_key_size != kv_pair.key().size() ||
+        kv_pair.value().size() > kMaxValueSize ||
+        !value.Decode(kv_pair.value()).ok() ||
+        value.value_type() != ValueType::kString ||
+        value.has_ttl() || value.has_user_timestamp() || value.merge_flags() != 0) {
+      EraseUnlocked(doc_key);
+      continue;
+    }
+
+    auto it = entries_.find(doc_key);
+    if (it != entries_.end()) {
+      lru_.erase(it->second.lru_position);
+    } else {
+      if (entries_.size() >= capacity_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+      }
+      it = entries_.emplace(doc_key, Entry()).first;
+    }
+    lru_.push_front(doc_key);
+    it->second.value = value.primitive_value().GetString();
+    it->second.write_time = hybrid_time;
+    it->second.lru_position = lru_.begin();
+  }
+}
+
+void HotKeyValueCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+void HotKeyValueCache::EraseUnlocked(const std::string& encoded_doc_key) {
+  auto it = entries_.find(encoded_doc_key);
+  if (it != entries_.end()) {
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_HOT_KEY_VALUE_CACHE_H_
+#define YB_DOCDB_HOT_KEY_VALUE_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+class KeyValueWriteBatchPB;
+
+// A per-tablet cache of the latest values of recently written top-level primitive documents,
+// e.g. Redis strings. Read-modify-write operations such as INCR and APPEND on hot keys look the
+// current value up here instead of reading it from RocksDB.
+//
+// The cache is kept in sync with the regular RocksDB by the apply path: every non-transactional
+// write batch is passed to Invalidate before it is written to RocksDB, and to Update after that.
+// So a value found in the cache is always the latest one stored in RocksDB for its key.
+//
+// Only values without TTL, user timestamp and merge flags are cached, since their visibility does
+// not depend on the read time once they are written.
+//
+// This class is thread-safe.
+class HotKeyValueCache {
+ public:
+  // Values longer than this are not cached.
+  static constexpr size_t kMaxValueSize = 1024;
+
+  explicit HotKeyValueCache(size_t capacity);
+
+  // Looks up the value of the document with the given encoded doc key. Returns false when the value
+  // is not cached, or when it was written after read_time and hence is not visible at read_time.
+  bool Get(const Slice& encoded_doc_key, HybridTime read_time, std::string* value,
+           HybridTime* write_time);
+
+  // Removes the entries of all documents modified by put_batch.
+  void Invalidate(const KeyValueWriteBatchPB& put_batch);
+
+  // Caches the values of top-level primitive documents written by put_batch at hybrid_time.
+  void Update(const KeyValueWriteBatchPB& put_batch, HybridTime hybrid_time);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    std::string value;
+    HybridTime write_time;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  void EraseUnlocked(const std::string& encoded_doc_key);
+
+  const size_t capacity_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // Encoded doc keys from the most to the least recently updated.
+  std::list<std::string> lru_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_HOT_KEY_VALUE_CACHE_H_
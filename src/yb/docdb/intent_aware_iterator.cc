@@ -34,6 +34,9 @@ using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
+DEFINE_int32(max_nexts_to_avoid_seek_in_batch, 8,
+             "The number of next calls to try before doing a real seek when looking up the next key "
+             "of a sorted batch of point lookups.");
 
 namespace yb {
 namespace docdb {
@@ -274,13 +277,49 @@ void IntentAwareIterator::Seek(const Slice& key) {
   }
 }
 
+void IntentAwareIterator::SeekToKeyInBatch(const DocKey& doc_key) {
+  SeekToKeyInBatch(doc_key.Encode());
+}
+
+void IntentAwareIterator::SeekToKeyInBatch(const Slice& key) {
+  VLOG(4) << "SeekToKeyInBatch(" << SubDocKey::DebugSliceToString(key) << ")";
+  if (!status_.ok()) {
+    return;
+  }
+
+  if (!iter_->Valid() || iter_->key().compare(key) > 0) {
+    // Keys are expected to be sorted, but the iterator could be already positioned past the
+    // requested key (e.g. after reverse movement), fall back to regular seek in this case.
+    Seek(key);
+    return;
+  }
+
+  // Neighboring keys of a sorted batch usually reside in the same or adjacent data blocks, so try
+  // to reach the key by moving forward before paying for a top-of-index binary search.
+  int nexts = 0;
+  while (iter_->Valid() && iter_->key().compare(key) < 0) {
+    if (nexts++ >= FLAGS_max_nexts_to_avoid_seek_in_batch) {
+      iter_->Seek(key);
+      break;
+    }
+    iter_->Next();
+  }
+  skip_future_records_needed_ = true;
+
+  if (intent_iter_) {
+    // SeekForwardToSuitableIntent does not touch intent_iter_ if already resolved intent is
+    // not before the requested key.
+    seek_intent_iter_needed_ = SeekIntentIterNeeded::kSeekForward;
+    GetIntentPrefixForKeyWithoutHt(key, &seek_key_buffer_);
+  }
+}
+
 void IntentAwareIterator::SeekForward(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key plus kMaxBytesPerEncodedHybridTime + 1 bytes for SeekForward() below to
   // avoid extra realloc while appending the read time.
-  key_bytes.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekForward(&key_bytes);
+  key_buffer_.Reserve(key.size() + kMaxBytesPerEncodedHybridTime + 1);
+  key_buffer_.Reset(key);
+  SeekForward(&key_buffer_);
 }
 
 void IntentAwareIterator::SeekForward(KeyBytes* key_bytes) {
@@ -338,12 +377,11 @@ void IntentAwareIterator::SeekOutOfSubDoc(KeyBytes* key_bytes) {
 }
 
 void IntentAwareIterator::SeekOutOfSubDoc(const Slice& key) {
-  KeyBytes key_bytes;
   // Reserve space for key + 1 byte for docdb::SeekOutOfSubKey() above to avoid extra realloc while
   // appending kMaxByte.
-  key_bytes.Reserve(key.size() + 1);
-  key_bytes.AppendRawBytes(key);
-  SeekOutOfSubDoc(&key_bytes);
+  key_buffer_.Reserve(key.size() + 1);
+  key_buffer_.Reset(key);
+  SeekOutOfSubDoc(&key_buffer_);
 }
 
 void IntentAwareIterator::SeekToLastDocKey() {
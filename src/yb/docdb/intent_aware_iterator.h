@@ -105,6 +105,15 @@ class IntentAwareIterator {
   void SeekForward(const Slice& key);
   void SeekForward(KeyBytes* key);
 
+  // Seek to the smallest key which is greater or equal than doc_key, where doc_key is the next key
+  // of a batch of point lookups sorted in ascending order (e.g. IN-list or multi-key get).
+  // Instead of doing a fresh seek on both sub-iterators for every key, the regular iterator is
+  // moved forward with up to FLAGS_max_nexts_to_avoid_seek_in_batch Next() calls (staying within
+  // already loaded data blocks), and the intents iterator is only re-seeked when its resolved
+  // intent is before the new key. Falls back to Seek() when doc_key is before current position.
+  void SeekToKeyInBatch(const DocKey& doc_key);
+  void SeekToKeyInBatch(const Slice& key);
+
   // Seek past specified subdoc key (it is responsibility of caller to make sure it doesn't have
   // hybrid time).
   void SeekPastSubKey(const Slice& key);
@@ -280,6 +289,10 @@ class IntentAwareIterator {
 
   // Reusable buffer to prepare seek key to avoid reallocating temporary buffers in critical paths.
   KeyBytes seek_key_buffer_;
+
+  // Reusable buffer for keys passed as slices to SeekForward and SeekOutOfSubDoc, so seeks do not
+  // allocate once the buffer has grown to the size of the keys of the table.
+  KeyBytes key_buffer_;
 };
 
 // Utility class that controls stack of prefixes in IntentAwareIterator.
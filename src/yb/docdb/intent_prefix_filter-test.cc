@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/intent_prefix_filter.h"
+
+namespace yb {
+namespace docdb {
+
+class IntentPrefixFilterTest : public DocDBTestBase {
+ protected:
+  static TransactionId TxnId(const std::string& str) {
+    return CHECK_RESULT(FullyDecodeTransactionId(str));
+  }
+
+  static KeyBytes EncodedKey(const std::string& key) {
+    return DocKey(PrimitiveValues(key, 1)).Encode();
+  }
+};
+
+TEST_F(IntentPrefixFilterTest, AddAndRemove) {
+  IntentPrefixFilter filter;
+  auto key1 = EncodedKey("key1");
+  auto key2 = EncodedKey("key2");
+
+  // Everything could have intents until the filter is rebuilt.
+  ASSERT_TRUE(filter.MayHaveIntents(key1.AsSlice()));
+  ASSERT_OK(filter.Rebuild(intents_db()));
+  ASSERT_FALSE(filter.MayHaveIntents(key1.AsSlice()));
+  ASSERT_FALSE(filter.MayHaveIntents(key2.AsSlice()));
+
+  auto txn1 = TxnId("0000000000000001");
+  auto txn2 = TxnId("0000000000000002");
+  filter.Add(txn1, key1.AsSlice());
+  filter.Add(txn1, key1.AsSlice());
+  filter.Add(txn2, key1.AsSlice());
+  ASSERT_TRUE(filter.MayHaveIntents(key1.AsSlice()));
+  ASSERT_FALSE(filter.MayHaveIntents(key2.AsSlice()));
+
+  filter.Remove(txn1);
+  ASSERT_TRUE(filter.MayHaveIntents(key1.AsSlice()));
+  // Removing a transaction for the second time does not release the intents of the other one.
+  filter.Remove(txn1);
+  ASSERT_TRUE(filter.MayHaveIntents(key1.AsSlice()));
+  filter.Remove(txn2);
+  ASSERT_FALSE(filter.MayHaveIntents(key1.AsSlice()));
+}
+
+TEST_F(IntentPrefixFilterTest, Rebuild) {
+  auto key1 = EncodedKey("key1");
+  auto key2 = EncodedKey("key2");
+  auto txn = TxnId("0000000000000001");
+
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  SetCurrentTransactionId(txn);
+  ASSERT_OK(SetPrimitive(DocPath(key1, "subkey"), PrimitiveValue("value"), 1000_usec_ht));
+
+  IntentPrefixFilter filter;
+  ASSERT_OK(filter.Rebuild(intents_db()));
+  // Both the weak intent on the document and the strong intent on the subkey are counted.
+  ASSERT_TRUE(filter.MayHaveIntents(key1.AsSlice()));
+  KeyBytes subkey_prefix(key1);
+  PrimitiveValue("subkey").AppendToKey(&subkey_prefix);
+  ASSERT_TRUE(filter.MayHaveIntents(subkey_prefix.AsSlice()));
+  ASSERT_FALSE(filter.MayHaveIntents(key2.AsSlice()));
+
+  filter.Remove(txn);
+  ASSERT_FALSE(filter.MayHaveIntents(key1.AsSlice()));
+  ASSERT_FALSE(filter.MayHaveIntents(subkey_prefix.AsSlice()));
+}
+
+}  // namespace docdb
+}  // namespace yb
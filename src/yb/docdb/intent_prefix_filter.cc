@@ -0,0 +1,103 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/intent_prefix_filter.h"
+
+#include <algorithm>
+
+#include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/value_type.h"
+#include "yb/rocksdb/db.h"
+
+namespace yb {
+namespace docdb {
+
+IntentPrefixFilter::IntentPrefixFilter() {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+uint32_t IntentPrefixFilter::Bucket(Slice intent_prefix) {
+  return intent_prefix.hash() % kNumBuckets;
+}
+
+Status IntentPrefixFilter::Rebuild(rocksdb::DB* intents_db) {
+  auto iter = CreateRocksDBIterator(
+      intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+      rocksdb::kDefaultQueryId);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    auto key = iter->key();
+    // Transaction metadata and reverse index records start with the transaction id.
+    if (key.empty() || key[0] == ValueTypeAsChar::kTransactionId) {
+      continue;
+    }
+    auto value = iter->value();
+    if (value.size() < 1 + TransactionId::static_size() ||
+        value[0] != ValueTypeAsChar::kTransactionId) {
+      return STATUS_FORMAT(Corruption, "Transaction prefix expected in intent: $0 => $1",
+                           key.ToDebugHexString(), value.ToDebugHexString());
+    }
+    auto transaction_id = VERIFY_RESULT(FullyDecodeTransactionId(
+        Slice(value.data() + 1, TransactionId::static_size())));
+    auto intent = VERIFY_RESULT(ParseIntentKey(key, value));
+    AddUnlocked(transaction_id, Bucket(intent.doc_path));
+  }
+  RETURN_NOT_OK(iter->status());
+  ready_.store(true, std::memory_order_release);
+  return Status::OK();
+}
+
+bool IntentPrefixFilter::MayHaveIntents(Slice intent_prefix) const {
+  if (!ready_.load(std::memory_order_acquire)) {
+    return true;
+  }
+  return counts_[Bucket(intent_prefix)].load(std::memory_order_acquire) != 0;
+}
+
+void IntentPrefixFilter::Add(const TransactionId& transaction_id, Slice intent_prefix) {
+  auto bucket = Bucket(intent_prefix);
+  std::lock_guard<std::mutex> lock(mutex_);
+  AddUnlocked(transaction_id, bucket);
+}
+
+void IntentPrefixFilter::AddUnlocked(const TransactionId& transaction_id, uint32_t bucket) {
+  auto& buckets = transactions_[transaction_id];
+  auto it = std::lower_bound(buckets.begin(), buckets.end(), bucket);
+  if (it != buckets.end() && *it == bucket) {
+    return;
+  }
+  buckets.insert(it, bucket);
+  counts_[bucket].fetch_add(1, std::memory_order_acq_rel);
+}
+
+void IntentPrefixFilter::Remove(const TransactionId& transaction_id) {
+  std::vector<uint32_t> buckets;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = transactions_.find(transaction_id);
+    if (it == transactions_.end()) {
+      return;
+    }
+    buckets = std::move(it->second);
+    transactions_.erase(it);
+  }
+  for (auto bucket : buckets) {
+    counts_[bucket].fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,83 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_INTENT_PREFIX_FILTER_H_
+#define YB_DOCDB_INTENT_PREFIX_FILTER_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/transaction.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace rocksdb {
+class DB;
+}
+
+namespace yb {
+namespace docdb {
+
+// A per-tablet in-memory summary of the intents stored in the intents DB. It counts, for buckets
+// of hashed intent prefixes (the encoded DocPath in front of ValueType::kIntentType), the number
+// of transactions having intents with such a prefix. Conflict resolution only has to seek the
+// intents DB for a prefix when its bucket is not empty.
+//
+// The filter is kept in sync by the apply path: Add is called for every intent before it is
+// written, and Remove after all intents of a transaction were applied or removed. So the filter
+// never misses an intent that is present in the intents DB. It can over count, e.g. for intents
+// that are removed by compactions, which only costs an unnecessary seek.
+//
+// Until Rebuild counted the intents that were already in the intents DB when the tablet was opened,
+// MayHaveIntents always returns true.
+//
+// This class is thread-safe.
+class IntentPrefixFilter {
+ public:
+  static constexpr size_t kNumBuckets = 4096;
+
+  IntentPrefixFilter();
+
+  // Counts the intents stored in intents_db.
+  CHECKED_STATUS Rebuild(rocksdb::DB* intents_db);
+
+  // Returns false only when there are certainly no intents with the given prefix.
+  bool MayHaveIntents(Slice intent_prefix) const;
+
+  // Registers an intent of the given transaction that is about to be written.
+  void Add(const TransactionId& transaction_id, Slice intent_prefix);
+
+  // Unregisters all intents of the given transaction, after they were removed from the intents DB.
+  void Remove(const TransactionId& transaction_id);
+
+ private:
+  static uint32_t Bucket(Slice intent_prefix);
+
+  void AddUnlocked(const TransactionId& transaction_id, uint32_t bucket);
+
+  std::atomic<bool> ready_{false};
+  std::array<std::atomic<uint32_t>, kNumBuckets> counts_;
+
+  std::mutex mutex_;
+  // Sorted buckets of each transaction that has intents, so that a bucket is counted once per
+  // transaction.
+  std::unordered_map<TransactionId, std::vector<uint32_t>, TransactionIdHash> transactions_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_INTENT_PREFIX_FILTER_H_
@@ -175,6 +175,9 @@ string PrimitiveValue::ToString() const {
       return inetaddress_val_->ToString();
     case ValueType::kJsonb:
       return FormatBytesAsStr(json_val_);
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet:
+      return Format("$0($1)", type_, FormatBytesAsStr(packed_val_));
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kUuid:
       return uuid_val_.ToString();
@@ -379,6 +382,10 @@ void PrimitiveValue::AppendToKey(KeyBytes* key_bytes) const {
       key_bytes->AppendIntentType(static_cast<IntentType>(uint16_val_));
       return;
 
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet:
+      break;
+
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
   }
   FATAL_INVALID_ENUM_VALUE(ValueType, type_);
@@ -496,6 +503,11 @@ string PrimitiveValue::ToValue() const {
       return result;
     }
 
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet:
+      result.append(packed_val_);
+      return result;
+
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTransactionId: FALLTHROUGH_INTENDED;
     case ValueType::kTableId: FALLTHROUGH_INTENDED;
@@ -875,6 +887,8 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       type_ref = value_type;
       return Status::OK();
     }
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet: FALLTHROUGH_INTENDED;
     case ValueType::kMaxByte:
       break;
 
@@ -1029,6 +1043,12 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
       return Status::OK();
     }
 
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet:
+      new(&packed_val_) string(slice.ToBuffer());
+      type_ = value_type;
+      return Status::OK();
+
     case ValueType::kInetaddress: {
       if (slice.size() != kInetAddressV4Size && slice.size() != kInetAddressV6Size) {
         return STATUS_FORMAT(Corruption,
@@ -1200,6 +1220,14 @@ PrimitiveValue PrimitiveValue::Jsonb(const std::string& json) {
   return primitive_value;
 }
 
+PrimitiveValue PrimitiveValue::PackedCollection(ValueType packed_type, std::string entries) {
+  DCHECK(IsPackedCollectionType(packed_type)) << packed_type;
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = packed_type;
+  new(&primitive_value.packed_val_) string(std::move(entries));
+  return primitive_value;
+}
+
 KeyBytes PrimitiveValue::ToKeyBytes() const {
   KeyBytes kb;
   AppendToKey(&kb);
@@ -1274,6 +1302,8 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
     case ValueType::kColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kSystemColumnId: return column_id_val_ == other.column_id_val_;
     case ValueType::kHybridTime: return hybrid_time_val_.CompareTo(other.hybrid_time_val_) == 0;
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet: return packed_val_ == other.packed_val_;
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
   }
   FATAL_INVALID_ENUM_VALUE(ValueType, type_);
@@ -1373,6 +1403,9 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
     case ValueType::kHybridTime:
       // HybridTimes are sorted in reverse order when wrapped in a PrimitiveValue.
       return -hybrid_time_val_.CompareTo(other.hybrid_time_val_);
+    case ValueType::kPackedObject: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRedisSet:
+      return packed_val_.compare(other.packed_val_);
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
   }
   LOG(FATAL) << "Comparing invalid PrimitiveValues: " << *this << " and " << other;
@@ -1395,6 +1428,8 @@ PrimitiveValue::PrimitiveValue(ValueType value_type)
     frozen_val_ = new FrozenContainer();
   } else if (value_type == ValueType::kJsonb) {
     new(&json_val_) std::string();
+  } else if (IsPackedCollectionType(value_type)) {
+    new(&packed_val_) std::string();
   }
 }
 
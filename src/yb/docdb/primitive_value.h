@@ -70,6 +70,9 @@ class PrimitiveValue {
     } else if (other.type_ == ValueType::kJsonb) {
       type_ = other.type_;
       new(&json_val_) std::string(other.json_val_);
+    } else if (IsPackedCollectionType(other.type_)) {
+      type_ = other.type_;
+      new(&packed_val_) std::string(other.packed_val_);
     } else if (other.type_ == ValueType::kInetaddress
         || other.type_ == ValueType::kInetaddressDescending) {
       type_ = other.type_;
@@ -210,6 +213,8 @@ class PrimitiveValue {
       str_val_.~basic_string();
     } else if (type_ == ValueType::kJsonb) {
       json_val_.~basic_string();
+    } else if (IsPackedCollectionType(type_)) {
+      packed_val_.~basic_string();
     } else if (type_ == ValueType::kInetaddress || type_ == ValueType::kInetaddressDescending) {
       delete inetaddress_val_;
     } else if (type_ == ValueType::kDecimal || type_ == ValueType::kDecimalDescending) {
@@ -247,6 +252,8 @@ class PrimitiveValue {
   static PrimitiveValue TableId(Uuid table_id);
   static PrimitiveValue IntentTypeValue(IntentType intent_type);
   static PrimitiveValue Jsonb(const std::string& json);
+  // Creates a value of type kPackedObject or kPackedRedisSet holding the given encoded entries.
+  static PrimitiveValue PackedCollection(ValueType packed_type, std::string entries);
 
   KeyBytes ToKeyBytes() const;
 
@@ -348,6 +355,11 @@ class PrimitiveValue {
     return json_val_;
   }
 
+  const std::string& GetPackedCollection() const {
+    DCHECK(IsPackedCollectionType(type_));
+    return packed_val_;
+  }
+
   const Uuid& GetUuid() const {
     DCHECK(type_ == ValueType::kUuid || type_ == ValueType::kUuidDescending ||
            type_ == ValueType::kTransactionId || type_ == ValueType::kTableId);
@@ -445,6 +457,7 @@ class PrimitiveValue {
     std::string decimal_val_;
     std::string varint_val_;
     std::string json_val_;
+    std::string packed_val_;
   };
 
  private:
@@ -469,6 +482,9 @@ class PrimitiveValue {
     } else if (other->type_ == ValueType::kJsonb) {
       type_ = other->type_;
       new(&json_val_) std::string(std::move(other->json_val_));
+    } else if (IsPackedCollectionType(other->type_)) {
+      type_ = other->type_;
+      new(&packed_val_) std::string(std::move(other->packed_val_));
     } else if (other->type_ == ValueType::kDecimal ||
         other->type_ == ValueType::kDecimalDescending) {
       type_ = other->type_;
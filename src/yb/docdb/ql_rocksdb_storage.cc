@@ -43,6 +43,25 @@ CHECKED_STATUS QLRocksDBStorage::GetIterator(
   return Status::OK();
 }
 
+CHECKED_STATUS QLRocksDBStorage::GetIteratorForKeyRange(
+    const QLReadRequestPB& request,
+    const Schema& projection,
+    const Schema& schema,
+    const TransactionOperationContextOpt& txn_op_context,
+    MonoTime deadline,
+    const ReadHybridTime& read_time,
+    const common::QLScanSpec& spec,
+    const Slice& lower_bound,
+    const Slice& upper_bound,
+    std::unique_ptr<common::YQLRowwiseIteratorIf>* iter) const {
+  auto doc_iter = std::make_unique<DocRowwiseIterator>(
+      projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  doc_iter->SetScanKeyRange(KeyBytes(lower_bound), KeyBytes(upper_bound));
+  RETURN_NOT_OK(doc_iter->Init(spec));
+  *iter = std::move(doc_iter);
+  return Status::OK();
+}
+
 CHECKED_STATUS QLRocksDBStorage::BuildYQLScanSpec(const QLReadRequestPB& request,
                                                   const ReadHybridTime& read_time,
                                                   const Schema& schema,
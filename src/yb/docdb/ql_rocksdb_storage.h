@@ -41,6 +41,18 @@ class QLRocksDBStorage : public common::YQLStorageIf {
                              const common::QLScanSpec& spec,
                              std::unique_ptr<common::YQLRowwiseIteratorIf> *iter) const override;
 
+  CHECKED_STATUS GetIteratorForKeyRange(
+      const QLReadRequestPB& request,
+      const Schema& projection,
+      const Schema& schema,
+      const TransactionOperationContextOpt& txn_op_context,
+      MonoTime deadline,
+      const ReadHybridTime& read_time,
+      const common::QLScanSpec& spec,
+      const Slice& lower_bound,
+      const Slice& upper_bound,
+      std::unique_ptr<common::YQLRowwiseIteratorIf>* iter) const override;
+
   CHECKED_STATUS BuildYQLScanSpec(const QLReadRequestPB& request,
                                   const ReadHybridTime& read_time,
                                   const Schema& schema,
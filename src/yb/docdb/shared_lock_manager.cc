@@ -13,6 +13,7 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <functional>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -240,30 +241,44 @@ void SharedLockManager::Lock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Acquired a lock batch of $0 keys", key_to_intent_type.size());
 }
 
+SharedLockManager::Stripe& SharedLockManager::StripeForKey(const std::string& key) {
+  return stripes_[std::hash<std::string>()(key) % kNumStripes];
+}
+
 std::vector<SharedLockManager::LockEntry*> SharedLockManager::Reserve(
     const KeyToIntentTypeMap& key_to_intent_type) {
   std::vector<SharedLockManager::LockEntry*> reserved;
   reserved.reserve(key_to_intent_type.size());
-  {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    for (const auto& key_and_intent_type : key_to_intent_type) {
-      auto it = locks_.emplace(key_and_intent_type.first, std::make_unique<LockEntry>()).first;
-      it->second->num_using++;
-      reserved.push_back(&*it->second);
+  for (const auto& key_and_intent_type : key_to_intent_type) {
+    auto& stripe = StripeForKey(key_and_intent_type.first);
+    std::lock_guard<ProfiledMutex> lock(stripe.mutex);
+    auto it = stripe.locks.emplace(key_and_intent_type.first, nullptr).first;
+    if (!it->second) {
+      it->second = std::make_unique<LockEntry>();
     }
+    it->second->num_using++;
+    reserved.push_back(&*it->second);
   }
   return reserved;
 }
 
 void SharedLockManager::Unlock(const KeyToIntentTypeMap& key_to_intent_type) {
   TRACE("Unlocking a batch of $0 keys", key_to_intent_type.size());
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& key_and_intent_type : boost::adaptors::reverse(key_to_intent_type)) {
     VLOG(4) << "Unlocking " << docdb::ToString(key_and_intent_type.second) << ": "
             << util::FormatBytesAsStr(key_and_intent_type.first);
-    locks_[key_and_intent_type.first]->Unlock(key_and_intent_type.second);
+    auto& stripe = StripeForKey(key_and_intent_type.first);
+    std::lock_guard<ProfiledMutex> lock(stripe.mutex);
+    auto it = stripe.locks.find(key_and_intent_type.first);
+    DCHECK(it != stripe.locks.end())
+        << "Unlocking a key that is not locked: "
+        << util::FormatBytesAsStr(key_and_intent_type.first);
+    it->second->Unlock(key_and_intent_type.second);
+    // Update refcounts and maybe collect garbage.
+    if (--it->second->num_using == 0) {
+      stripe.locks.erase(it);
+    }
   }
-  Cleanup(key_to_intent_type);
 }
 
 void SharedLockManager::LockInTest(const string& key, IntentType intent_type) {
@@ -274,15 +289,5 @@ void SharedLockManager::UnlockInTest(const string& key, IntentType intent_type)
   Unlock({{key, intent_type}});
 }
 
-void SharedLockManager::Cleanup(const KeyToIntentTypeMap& key_to_intent_type) {
-  for (const auto& item : key_to_intent_type) {
-    auto it = locks_.find(item.first);
-    it->second->num_using--;
-    if (it->second->num_using == 0) {
-      locks_.erase(it);
-    }
-  }
-}
-
 }  // namespace docdb
 }  // namespace yb
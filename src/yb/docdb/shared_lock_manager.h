@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_SHARED_LOCK_MANAGER_H
 #define YB_DOCDB_SHARED_LOCK_MANAGER_H
 
+#include <array>
 #include <map>
 #include <mutex>
 #include <string>
@@ -24,6 +25,7 @@
 #include "yb/docdb/lock_batch.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/cross_thread_mutex.h"
+#include "yb/util/profiled_mutex.h"
 
 namespace yb {
 namespace docdb {
@@ -63,7 +65,8 @@ class SharedLockManager {
 
     std::condition_variable cond_var;
 
-    // Refcounting for garbage collection. Can only be used while the global lock is held.
+    // Refcounting for garbage collection. Can only be used while the lock of the stripe owning
+    // this entry is held.
     size_t num_using = 0;
 
     // Number of holders for each type
@@ -81,19 +84,26 @@ class SharedLockManager {
 
   typedef std::unordered_map<std::string, std::unique_ptr<LockEntry>> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
-  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
+  // The lock entries are spread over stripes by key hash, so that batches touching different keys
+  // don't serialize on a single mutex.
+  struct Stripe {
+    // Taken only for very short duration, with no blocking wait.
+    ProfiledMutex mutex;
+
+    // Can only be modified if the mutex is held.
+    LockEntryMap locks;
+  };
 
-  // Update refcounts and maybe collect garbage.
-  void Cleanup(const KeyToIntentTypeMap& key_to_intent_type);
+  static constexpr size_t kNumStripes = 64;
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  Stripe& StripeForKey(const std::string& key);
+
+  // Make sure the entries exist in the stripe maps and return pointers so we can access
+  // them without holding the stripe locks. Returns a vector with pointers in the same order
+  // as the keys in the batch.
+  std::vector<LockEntry*> Reserve(const KeyToIntentTypeMap& batch);
 
-  // Can only be modified if the global mutex is held.
-  LockEntryMap locks_;
+  std::array<Stripe, kNumStripes> stripes_;
 };
 
 extern const std::array<LockState, kIntentTypeMapSize> kIntentConflicts;
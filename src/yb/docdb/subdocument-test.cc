@@ -164,5 +164,35 @@ TEST(SubDocumentTest, TestCopyMove) {
   ASSERT_EQ(ValueType::kNull, s2.value_type());
 }
 
+TEST(SubDocumentTest, PackedValue) {
+  SubDocument hash({{"f1", "v1"}, {"f2", ""}});
+  PrimitiveValue packed;
+  ASSERT_OK(hash.ToPackedValue(&packed));
+  ASSERT_EQ(ValueType::kPackedObject, packed.value_type());
+
+  // The packed value survives the value encoding of DocDB.
+  PrimitiveValue decoded;
+  ASSERT_OK(decoded.DecodeFromValue(packed.ToValue()));
+  ASSERT_EQ(packed, decoded);
+
+  SubDocument unpacked;
+  ASSERT_OK(SubDocument::FromPackedValue(decoded, &unpacked));
+  ASSERT_EQ(hash, unpacked);
+
+  SubDocument set;
+  set.SetChildPrimitive(PrimitiveValue("m1"), PrimitiveValue(ValueType::kNull));
+  ASSERT_OK(set.ConvertToRedisSet());
+  ASSERT_OK(set.ToPackedValue(&packed));
+  ASSERT_EQ(ValueType::kPackedRedisSet, packed.value_type());
+  ASSERT_OK(SubDocument::FromPackedValue(packed, &unpacked));
+  ASSERT_EQ(ValueType::kRedisSet, unpacked.value_type());
+  ASSERT_NE(nullptr, unpacked.GetChild(PrimitiveValue("m1")));
+
+  // Only flat collections can be packed.
+  SubDocument nested;
+  nested.SetChild(PrimitiveValue("a"), SubDocument({{"b", "c"}}));
+  ASSERT_NOK(nested.ToPackedValue(&packed));
+}
+
 } // namespace docdb
 } // namespace yb
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "yb/common/ql_bfunc.h"
+#include "yb/util/fast_varint.h"
 
 using std::endl;
 using std::make_pair;
@@ -238,6 +239,64 @@ void SubDocument::SetChild(const PrimitiveValue& key, SubDocument&& value) {
   }
 }
 
+Status SubDocument::ToPackedValue(PrimitiveValue* out) const {
+  ValueType packed_type;
+  switch (type_) {
+    case ValueType::kObject:
+      packed_type = ValueType::kPackedObject;
+      break;
+    case ValueType::kRedisSet:
+      packed_type = ValueType::kPackedRedisSet;
+      break;
+    default:
+      return STATUS_FORMAT(InvalidArgument, "Cannot pack a subdocument of type $0", type_);
+  }
+  string entries;
+  if (has_valid_object_container()) {
+    KeyBytes key_bytes;
+    for (const auto& entry : object_container()) {
+      if (!entry.second.IsPrimitive()) {
+        return STATUS_FORMAT(InvalidArgument, "Cannot pack a non-primitive child: $0",
+                             entry.second);
+      }
+      key_bytes.Clear();
+      entry.first.AppendToKey(&key_bytes);
+      entries.append(key_bytes.data());
+      const string value = entry.second.ToValue();
+      FastAppendSignedVarIntToStr(value.size(), &entries);
+      entries.append(value);
+    }
+  }
+  *out = PrimitiveValue::PackedCollection(packed_type, std::move(entries));
+  return Status::OK();
+}
+
+Status SubDocument::FromPackedValue(const PrimitiveValue& packed, SubDocument* out) {
+  if (!IsPackedCollectionType(packed.value_type())) {
+    return STATUS_FORMAT(Corruption, "Not a packed collection: $0", packed);
+  }
+  SubDocument result;
+  Slice entries(packed.GetPackedCollection());
+  while (!entries.empty()) {
+    PrimitiveValue subkey;
+    RETURN_NOT_OK(subkey.DecodeFromKey(&entries));
+    const int64_t value_size = VERIFY_RESULT(FastDecodeSignedVarInt(&entries));
+    if (value_size <= 0 || static_cast<size_t>(value_size) > entries.size()) {
+      return STATUS_FORMAT(Corruption, "Bad packed entry size $0, $1 bytes left",
+                           value_size, entries.size());
+    }
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(Slice(entries.data(), value_size)));
+    entries.remove_prefix(value_size);
+    result.SetChild(subkey, SubDocument(std::move(value)));
+  }
+  if (packed.value_type() == ValueType::kPackedRedisSet) {
+    RETURN_NOT_OK(result.ConvertToRedisSet());
+  }
+  *out = std::move(result);
+  return Status::OK();
+}
+
 bool SubDocument::DeleteChild(const PrimitiveValue& key) {
   CHECK_EQ(ValueType::kObject, type_);
   if (!has_valid_object_container())
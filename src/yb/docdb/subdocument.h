@@ -132,6 +132,14 @@ class SubDocument : public PrimitiveValue {
   // Returns the number of children for this subdocument.
   CHECKED_STATUS NumChildren(size_t *num_children);
 
+  // Encodes the primitive children of this hash (kObject) or set (kRedisSet) as a single packed
+  // value of type kPackedObject or kPackedRedisSet. Every entry is stored as its subkey in key
+  // encoding, followed by the varint length of the value and the value itself.
+  CHECKED_STATUS ToPackedValue(PrimitiveValue* out) const;
+
+  // Decodes a value produced by ToPackedValue into a hash or set SubDocument.
+  static CHECKED_STATUS FromPackedValue(const PrimitiveValue& packed, SubDocument* out);
+
   const SubDocument* GetChild(const PrimitiveValue& key) const;
 
   // Returns the child of this object at the given subkey, or default-constructs one if it does not
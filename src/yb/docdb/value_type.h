@@ -82,6 +82,9 @@ namespace docdb {
     ((kDoubleDescending, 'L'))  /* ASCII code 76 */ \
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kUInt32, 'O'))  /* ASCII code 78 */ \
+    /* A small Redis hash or set stored as a single value instead of one key per entry. */ \
+    ((kPackedObject, 'P'))  /* ASCII code 80 */ \
+    ((kPackedRedisSet, 'Q'))  /* ASCII code 81 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
@@ -221,6 +224,16 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
   return IsObjectType(value_type) || value_type == ValueType::kArray;
 }
 
+// Packed collections are stored as a single primitive value, see SubDocument::ToPackedValue.
+constexpr inline bool IsPackedCollectionType(const ValueType value_type) {
+  return value_type == ValueType::kPackedObject || value_type == ValueType::kPackedRedisSet;
+}
+
+// Returns the type of the collection a packed value unpacks to.
+constexpr inline ValueType UnpackedCollectionType(const ValueType value_type) {
+  return value_type == ValueType::kPackedRedisSet ? ValueType::kRedisSet : ValueType::kObject;
+}
+
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
          !IsCollectionType(value_type) &&
@@ -11,9 +11,15 @@
 // under the License.
 //
 
+#include <algorithm>
+#include <map>
+
 #include <cassandra.h>
 
+#include "yb/client/client-test-util.h"
+#include "yb/client/table_handle.h"
 #include "yb/integration-tests/external_mini_cluster-itest-base.h"
+#include "yb/util/curl_util.h"
 #include "yb/util/jsonreader.h"
 
 using std::string;
@@ -100,7 +106,8 @@ class CppCassandraDriverTest : public ExternalMiniClusterITestBase {
 
     LOG(INFO) << "Starting YB ExternalMiniCluster...";
     // Start up with 3 (default) tablet servers.
-    ASSERT_NO_FATALS(StartCluster());
+    ASSERT_NO_FATALS(StartCluster(ExtraTServerFlags(), {} /* extra_master_flags */,
+                                  3 /* num_tablet_servers */, NumMasters()));
 
     driver_.reset(CHECK_NOTNULL(new CppCassandraDriver(*cluster_)));
 
@@ -116,6 +123,14 @@ class CppCassandraDriverTest : public ExternalMiniClusterITestBase {
   }
 
  protected:
+  virtual std::vector<std::string> ExtraTServerFlags() {
+    return {};
+  }
+
+  virtual int NumMasters() {
+    return 1;
+  }
+
   std::unique_ptr<CppCassandraDriver> driver_;
 };
 
@@ -467,4 +482,179 @@ TEST_F(CppCassandraDriverTest, TestLongJson) {
   }
 }
 
+class CppCassandraDriverBackfillTest : public CppCassandraDriverTest {
+ protected:
+  const string kKeyspace = "examples";
+  static constexpr int kNumRows = 1000;
+  static constexpr int kNumValues = 10;
+
+  std::vector<std::string> ExtraTServerFlags() override {
+    // Backfill in many small requests, so the backfill is in progress for a while.
+    return {"--index_backfill_rows_per_request=10"};
+  }
+
+  int NumMasters() override {
+    return 3;
+  }
+
+  // Creates table t with rows (k, k % kNumValues) and returns them.
+  std::map<int32_t, int32_t> CreateTable() {
+    driver_->ExecuteQuery(
+        "CREATE TABLE t (k int PRIMARY KEY, v int) WITH transactions = { 'enabled' : true };");
+    std::map<int32_t, int32_t> rows;
+    for (int32_t k = 0; k != kNumRows; ++k) {
+      driver_->ExecuteQuery(Format("INSERT INTO t (k, v) VALUES ($0, $1);", k, k % kNumValues));
+      rows.emplace(k, k % kNumValues);
+    }
+    return rows;
+  }
+
+  // Returns the keys of the rows of t with the given value, in ascending order.
+  std::vector<int32_t> SelectKeys(int32_t value) {
+    const string query = Format("SELECT k FROM t WHERE v = $0;", value);
+    std::vector<int32_t> keys;
+    const CassResult* result = nullptr;
+    do {
+      CassStatement* statement = CHECK_NOTNULL(cass_statement_new(query.c_str(), 0));
+      if (result != nullptr) {
+        CHECK_EQ(CASS_OK, cass_statement_set_paging_state(statement, result));
+        cass_result_free(result);
+      }
+      result = driver_->ExecuteStatement(statement, true /* need_result */);
+      CassIterator* iterator = cass_iterator_from_result(result);
+      while (cass_iterator_next(iterator)) {
+        cass_int32_t key = 0;
+        CHECK_EQ(CASS_OK, cass_value_get_int32(
+            cass_row_get_column(cass_iterator_get_row(iterator), 0), &key));
+        keys.push_back(key);
+      }
+      cass_iterator_free(iterator);
+    } while (cass_result_has_more_pages(result));
+    cass_result_free(result);
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
+  // Returns whether an index of t is being backfilled, according to the master.
+  Result<bool> IsBackfilling() {
+    std::shared_ptr<client::YBTable> table;
+    RETURN_NOT_OK(client_->OpenTable(client::YBTableName(kKeyspace, "t"), &table));
+    for (const auto& index : table->index_map()) {
+      if (index.second.is_backfilling()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WaitBackfilled() {
+    ASSERT_OK(WaitFor([this]() -> Result<bool> {
+      auto backfilling = IsBackfilling();
+      if (!backfilling.ok()) {
+        // E.g. while a new master leader is elected.
+        LOG(INFO) << "Failed to get indexes of t: " << backfilling.status();
+        return false;
+      }
+      return !*backfilling;
+    }, MonoDelta::FromSeconds(120), "Wait for index backfill"));
+  }
+
+  // Checks that index i has exactly the given rows of t, and that queries by value return them.
+  void CheckIndex(const std::map<int32_t, int32_t>& rows) {
+    client::TableHandle index;
+    ASSERT_OK(index.Open(client::YBTableName(kKeyspace, "i"), client_.get()));
+    ASSERT_EQ(static_cast<int64_t>(rows.size()), client::CountTableRows(index));
+
+    std::map<int32_t, std::vector<int32_t>> keys_by_value;
+    for (const auto& row : rows) {
+      keys_by_value[row.second].push_back(row.first);
+    }
+    for (const auto& entry : keys_by_value) {
+      ASSERT_EQ(entry.second, SelectKeys(entry.first)) << "Value: " << entry.first;
+    }
+  }
+
+  // Returns the master web page of index i.
+  Result<string> IndexPage() {
+    EasyCurl curl;
+    faststring buffer;
+    RETURN_NOT_OK(curl.FetchURL(
+        Format("http://$0/table?keyspace_name=$1&table_name=i",
+               cluster_->GetLeaderMaster()->bound_http_hostport(), kKeyspace),
+        &buffer));
+    return buffer.ToString();
+  }
+};
+
+TEST_F(CppCassandraDriverBackfillTest, BackfillIndex) {
+  auto rows = CreateTable();
+  driver_->ExecuteQuery("CREATE INDEX i ON t (v);");
+
+  // The index does not have all rows while it is backfilled, so queries must not use it.
+  std::vector<int32_t> expected_keys;
+  for (int32_t k = 3; k < kNumRows; k += kNumValues) {
+    expected_keys.push_back(k);
+  }
+  int checks = 0;
+  while (ASSERT_RESULT(IsBackfilling())) {
+    ASSERT_EQ(expected_keys, SelectKeys(3));
+    ++checks;
+  }
+  LOG(INFO) << "Queried " << checks << " times during backfill";
+
+  ASSERT_NO_FATALS(CheckIndex(rows));
+}
+
+TEST_F(CppCassandraDriverBackfillTest, WritesDuringBackfill) {
+  auto rows = CreateTable();
+  driver_->ExecuteQuery("CREATE INDEX i ON t (v);");
+
+  // Keep updating and deleting rows while the backfill is in progress, so some of the writes are
+  // done before its read time and some after. Either way the index must not keep the old values.
+  int32_t k = 0;
+  do {
+    if (k % 2 == 0) {
+      driver_->ExecuteQuery(Format("DELETE FROM t WHERE k = $0;", k));
+      rows.erase(k);
+    } else {
+      driver_->ExecuteQuery(Format("UPDATE t SET v = $0 WHERE k = $1;", kNumValues + k, k));
+      rows[k] = kNumValues + k;
+    }
+    k += 7;
+  } while (k < kNumRows && ASSERT_RESULT(IsBackfilling()));
+
+  ASSERT_NO_FATALS(WaitBackfilled());
+  ASSERT_NO_FATALS(CheckIndex(rows));
+}
+
+TEST_F(CppCassandraDriverBackfillTest, MasterFailover) {
+  auto rows = CreateTable();
+  driver_->ExecuteQuery("CREATE INDEX i ON t (v);");
+
+  // The new master leader continues the backfill from the progress in the sys catalog.
+  cluster_->GetLeaderMaster()->Shutdown();
+
+  ASSERT_NO_FATALS(WaitBackfilled());
+  ASSERT_NO_FATALS(CheckIndex(rows));
+}
+
+TEST_F(CppCassandraDriverBackfillTest, DuplicateValuesInUniqueIndex) {
+  auto rows = CreateTable();
+  driver_->ExecuteQuery("CREATE UNIQUE INDEX i ON t (v);");
+
+  // Retries would hit the same duplicates, so the backfill is stopped and the failure recorded.
+  ASSERT_OK(WaitFor([this]() -> Result<bool> {
+    return VERIFY_RESULT(IndexPage()).find("Duplicate value disallowed by unique index") !=
+           string::npos;
+  }, MonoDelta::FromSeconds(60), "Wait for index backfill failure"));
+
+  // The index stays unused by queries.
+  ASSERT_TRUE(ASSERT_RESULT(IsBackfilling()));
+  std::vector<int32_t> expected_keys;
+  for (int32_t k = 3; k < kNumRows; k += kNumValues) {
+    expected_keys.push_back(k);
+  }
+  ASSERT_EQ(expected_keys, SelectKeys(3));
+}
+
 }  // namespace yb
@@ -77,7 +77,8 @@ class ExternalMiniClusterITestBase : public YBTest {
  protected:
   void StartCluster(const std::vector<std::string>& extra_ts_flags = std::vector<std::string>(),
                     const std::vector<std::string>& extra_master_flags = std::vector<std::string>(),
-                    int num_tablet_servers = 3);
+                    int num_tablet_servers = 3,
+                    int num_masters = 1);
 
   gscoped_ptr<ExternalMiniCluster> cluster_;
   gscoped_ptr<itest::ExternalMiniClusterFsInspector> inspect_;
@@ -87,9 +88,11 @@ class ExternalMiniClusterITestBase : public YBTest {
 
 void ExternalMiniClusterITestBase::StartCluster(const std::vector<std::string>& extra_ts_flags,
                                                 const std::vector<std::string>& extra_master_flags,
-                                                int num_tablet_servers) {
+                                                int num_tablet_servers,
+                                                int num_masters) {
   ExternalMiniClusterOptions opts;
   opts.num_tablet_servers = num_tablet_servers;
+  opts.num_masters = num_masters;
   opts.extra_master_flags = extra_master_flags;
   opts.extra_tserver_flags = extra_ts_flags;
   opts.extra_tserver_flags.push_back("--never_fsync"); // fsync causes flakiness on EC2.
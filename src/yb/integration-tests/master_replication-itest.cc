@@ -197,6 +197,40 @@ TEST_F(MasterReplicationTest, TestSysTablesReplication) {
   ASSERT_NO_FATALS(VerifyTableExists(client, kTableName2));
 }
 
+// Verify that a follower master lists the tables replicated to its sys catalog when the request
+// accepts bounded staleness.
+TEST_F(MasterReplicationTest, TestListTablesOnFollower) {
+  shared_ptr<YBClient> client;
+  ASSERT_OK(CreateClient(&client));
+  ASSERT_OK(CreateTable(client, kTableName1));
+
+  MiniMaster* leader = cluster_->leader_mini_master();
+  MiniMaster* follower = nullptr;
+  for (int i = 0; i < num_masters_; ++i) {
+    if (cluster_->mini_master(i) != leader) {
+      follower = cluster_->mini_master(i);
+      break;
+    }
+  }
+  ASSERT_NE(nullptr, follower);
+
+  ListTablesRequestPB req;
+  req.mutable_namespace_()->set_name(kKeyspaceName);
+  req.set_max_follower_staleness_ms(60 * 1000);
+  ASSERT_OK(WaitFor([follower, &req]() -> Result<bool> {
+    ListTablesResponsePB resp;
+    if (!follower->master()->catalog_manager()->ListTablesOnFollower(&req, &resp).ok()) {
+      return false;
+    }
+    for (const auto& table : resp.tables()) {
+      if (table.name() == kTableName1.table_name()) {
+        return true;
+      }
+    }
+    return false;
+  }, MonoDelta::FromSeconds(30), "Table listed on follower master"));
+}
+
 // When all masters are down, test that we can timeout the connection
 // attempts after a specified deadline.
 TEST_F(MasterReplicationTest, TestTimeoutWhenAllMastersAreDown) {
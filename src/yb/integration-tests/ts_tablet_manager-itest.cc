@@ -58,6 +58,7 @@
 
 DECLARE_bool(enable_leader_failure_detection);
 DECLARE_bool(catalog_manager_wait_for_new_tablets_to_elect_leader);
+DECLARE_int32(leader_transfer_on_shutdown_timeout_ms);
 DEFINE_int32(num_election_test_loops, 3,
              "Number of random EmulateElection() loops to execute in "
              "TestReportNewLeaderOnLeaderChange");
@@ -211,5 +212,63 @@ TEST_F(TsTabletManagerITest, TestReportNewLeaderOnLeaderChange) {
   }
 }
 
+// Test that a tablet server hands over leadership of its tablets to a caught up follower when it
+// is shut down, so the tablet does not wait for the failure detection to elect a new leader.
+TEST_F(TsTabletManagerITest, TestTransferLeadershipOnShutdown) {
+  // Leader failure detection is disabled, so leadership could only move by the transfer.
+  FLAGS_enable_leader_failure_detection = false;
+  FLAGS_catalog_manager_wait_for_new_tablets_to_elect_leader = false;
+  FLAGS_leader_transfer_on_shutdown_timeout_ms = 10000;
+
+  ASSERT_OK(client_->CreateNamespaceIfNotExists(kTableName.namespace_name()));
+  gscoped_ptr<YBTableCreator> table_creator(client_->NewTableCreator());
+  ASSERT_OK(table_creator->table_name(kTableName)
+            .schema(&schema_)
+            .hash_schema(YBHashSchema::kMultiColumnHash)
+            .num_tablets(1)
+            .Create());
+
+  rpc::ProxyCache proxy_cache(client_messenger_);
+  MasterServiceProxy master_proxy(&proxy_cache, cluster_->mini_master()->bound_rpc_addr());
+  itest::TabletServerMap ts_map;
+  ASSERT_OK(CreateTabletServerMap(&master_proxy, &proxy_cache, &ts_map));
+
+  vector<std::shared_ptr<TabletPeer> > tablet_peers;
+  for (int replica = 0; replica < kNumReplicas; replica++) {
+    MiniTabletServer* ts = cluster_->mini_tablet_server(replica);
+    vector<std::shared_ptr<TabletPeer> > cur_ts_tablet_peers;
+    ASSERT_OK(WaitFor([ts, &cur_ts_tablet_peers]() -> Result<bool> {
+      ts->server()->tablet_manager()->GetTabletPeers(&cur_ts_tablet_peers);
+      return !cur_ts_tablet_peers.empty();
+    }, MonoDelta::FromSeconds(10), "Tablet replica is created"));
+    ASSERT_EQ(1, cur_ts_tablet_peers.size());
+    ASSERT_OK(cur_ts_tablet_peers[0]->WaitUntilConsensusRunning(MonoDelta::FromSeconds(10)));
+    tablet_peers.push_back(cur_ts_tablet_peers[0]);
+  }
+
+  ASSERT_OK(CHECK_NOTNULL(tablet_peers[0]->consensus())->EmulateElection());
+  ASSERT_OK(WaitForServersToAgree(MonoDelta::FromSeconds(5), ts_map, tablet_peers[0]->tablet_id(),
+                                  1 /* minimum_index */));
+  // The leader is ready once it knows that a follower has replicated its first operation.
+  ASSERT_OK(WaitFor([&tablet_peers]() -> Result<bool> {
+    return tablet_peers[0]->LeaderStatus() == consensus::LeaderStatus::LEADER_AND_READY;
+  }, MonoDelta::FromSeconds(10), "Leader is ready"));
+
+  cluster_->mini_tablet_server(0)->Shutdown();
+
+  ASSERT_OK(WaitFor([&tablet_peers]() -> Result<bool> {
+    for (int replica = 1; replica < kNumReplicas; replica++) {
+      if (tablet_peers[replica]->LeaderStatus() == consensus::LeaderStatus::LEADER_AND_READY) {
+        return true;
+      }
+    }
+    return false;
+  }, MonoDelta::FromSeconds(10), "Leadership is transferred"));
+  for (int replica = 1; replica < kNumReplicas; replica++) {
+    ASSERT_EQ(2, tablet_peers[replica]->consensus()->ConsensusState(
+        consensus::CONSENSUS_CONFIG_ACTIVE).current_term());
+  }
+}
+
 }  // namespace tserver
 }  // namespace yb
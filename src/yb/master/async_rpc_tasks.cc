@@ -355,6 +355,30 @@ void RetryingTSRpcTask::TransitionToTerminalState(MonitoredTaskState expected,
   }
 }
 
+namespace {
+
+void FillCreateTabletRequest(const string& permanent_uuid,
+                             const TabletInfo& tablet,
+                             tserver::CreateTabletRequestPB* req) {
+  auto table_lock = tablet.table()->LockForRead();
+  const SysTabletsEntryPB& tablet_pb = tablet.metadata().dirty().pb;
+
+  req->set_dest_uuid(permanent_uuid);
+  req->set_table_id(tablet.table()->id());
+  req->set_tablet_id(tablet.tablet_id());
+  req->set_table_type(tablet.table()->metadata().state().pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_table_name(table_lock->data().pb.name());
+  req->mutable_schema()->CopyFrom(table_lock->data().pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  if (table_lock->data().pb.has_index_info()) {
+    req->mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
+  }
+}
+
+} // namespace
+
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
@@ -367,21 +391,7 @@ AsyncCreateReplica::AsyncCreateReplica(Master *master,
   deadline_ = start_ts_;
   deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
 
-  auto table_lock = tablet->table()->LockForRead();
-  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
-
-  req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_table_name(table_lock->data().pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
-  if (table_lock->data().pb.has_index_info()) {
-    req_.mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
-  }
+  FillCreateTabletRequest(permanent_uuid, *tablet, &req_);
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
@@ -409,6 +419,75 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(Master *master,
+                                         ThreadPool *callback_pool,
+                                         const string& permanent_uuid,
+                                         const scoped_refptr<TableInfo>& table,
+                                         const std::vector<TabletInfo*>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, table) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  req_.set_dest_uuid(permanent_uuid);
+  for (const TabletInfo* tablet : tablets) {
+    FillCreateTabletRequest(permanent_uuid, *tablet, req_.add_tablets());
+  }
+}
+
+string AsyncCreateReplicas::description() const {
+  return Format("CreateTablets RPC for $0 tablets of table $1 on TS $2",
+                req_.tablets_size(), table_->id(), permanent_uuid_);
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG(WARNING) << "CreateTablets RPC on TS " << permanent_uuid_ << " failed: "
+                 << StatusFromPB(resp_.error().status()).ToString();
+    return;
+  }
+  if (resp_.tablets_size() != req_.tablets_size()) {
+    LOG(WARNING) << "CreateTablets RPC on TS " << permanent_uuid_ << " returned "
+                 << resp_.tablets_size() << " results for " << req_.tablets_size() << " tablets";
+    return;
+  }
+
+  // Keep only the tablets that still have to be created for the next attempt.
+  google::protobuf::RepeatedPtrField<tserver::CreateTabletRequestPB> failed_tablets;
+  for (int i = 0; i < req_.tablets_size(); ++i) {
+    const tserver::CreateTabletResponsePB& tablet_resp = resp_.tablets(i);
+    if (!tablet_resp.has_error()) {
+      continue;
+    }
+    const TabletId& tablet_id = req_.tablets(i).tablet_id();
+    Status s = StatusFromPB(tablet_resp.error().status());
+    if (s.IsAlreadyPresent()) {
+      LOG(INFO) << "CreateTablets RPC for tablet " << tablet_id
+                << " on TS " << permanent_uuid_ << " returned already present: "
+                << s.ToString();
+      continue;
+    }
+    LOG(WARNING) << "CreateTablets RPC for tablet " << tablet_id
+                 << " on TS " << permanent_uuid_ << " failed: " << s.ToString();
+    failed_tablets.Add()->Swap(req_.mutable_tablets(i));
+  }
+
+  req_.mutable_tablets()->Swap(&failed_tablets);
+  if (req_.tablets_size() == 0) {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+  }
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  resp_.Clear();
+  ts_admin_proxy_->CreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send create tablets request to " << permanent_uuid_
+          << " (attempt " << attempt << ") for " << req_.tablets_size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncDeleteReplica.
 // ============================================================================
@@ -662,6 +741,82 @@ bool AsyncTruncate::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncBackfillIndex.
+// ============================================================================
+AsyncBackfillIndex::AsyncBackfillIndex(Master* master,
+                                       ThreadPool* callback_pool,
+                                       const scoped_refptr<TabletInfo>& tablet,
+                                       const scoped_refptr<TableInfo>& index_table,
+                                       HybridTime read_time,
+                                       std::string start_row_key)
+    : RetryingTSRpcTask(master,
+                        callback_pool,
+                        gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+                        index_table),
+      tablet_(tablet),
+      read_time_(read_time),
+      start_row_key_(std::move(start_row_key)) {
+}
+
+string AsyncBackfillIndex::description() const {
+  return Format("$0 Backfill Index RPC for index $1", tablet_->ToString(), table_->ToString());
+}
+
+TabletId AsyncBackfillIndex::tablet_id() const {
+  return tablet_->tablet_id();
+}
+
+TabletServerId AsyncBackfillIndex::permanent_uuid() const {
+  return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
+}
+
+void AsyncBackfillIndex::HandleResponse(int attempt) {
+  server::UpdateClock(resp_, master_->clock());
+
+  if (resp_.has_error()) {
+    auto status = StatusFromPB(resp_.error().status());
+    LOG(WARNING) << "TS " << permanent_uuid() << ": backfill of index " << table_->ToString()
+                 << " failed for tablet " << tablet_id() << ": " << status;
+    if (status.IsInvalidArgument()) {
+      // Retries would fail the same way.
+      TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kFailed);
+      WARN_NOT_OK(master_->catalog_manager()->IndexBackfillFailed(table_, read_time_, status),
+                  Format("Failed to record backfill failure of index $0", table_->ToString()));
+    }
+    return;
+  }
+
+  TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+  VLOG(1) << "TS " << permanent_uuid() << ": backfilled index " << table_->ToString()
+          << " on tablet " << tablet_id() << " up to "
+          << Slice(resp_.next_row_key()).ToDebugHexString();
+  // The index table is kept in table_, so this task is unregistered from it only after the task
+  // for the next range is registered. So an index with a backfill in progress always has a task.
+  auto status = master_->catalog_manager()->IndexBackfillProgressed(
+      table_, tablet_, read_time_, resp_.next_row_key());
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to record backfill progress of index " << table_->ToString()
+                 << " on tablet " << tablet_id() << ": " << status;
+  }
+}
+
+bool AsyncBackfillIndex::SendRequest(int attempt) {
+  tserver::BackfillIndexRequestPB req;
+  req.set_dest_uuid(permanent_uuid());
+  req.set_tablet_id(tablet_id());
+  req.set_index_table_id(table_->id());
+  req.set_read_hybrid_time(read_time_.ToUint64());
+  req.set_start_row_key(start_row_key_);
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+
+  ts_admin_proxy_->BackfillIndexAsync(req, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send backfill index request to " << permanent_uuid()
+          << " (attempt " << attempt << "):\n"
+          << req.DebugString();
+  return true;
+}
+
 // ============================================================================
 //  Class CommonInfoForRaftTask.
 // ============================================================================
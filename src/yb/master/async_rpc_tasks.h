@@ -28,6 +28,7 @@
 #include "yb/util/status.h"
 #include "yb/util/memory/memory.h"
 #include "yb/common/entity_ids.h"
+#include "yb/common/hybrid_time.h"
 
 #include "yb/server/monitored_task.h"
 #include "yb/rpc/rpc_controller.h"
@@ -265,6 +266,35 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+// Fire off a single CreateTablets RPC creating a batch of tablets of the same table on one
+// tablet server. The same locking requirements as for AsyncCreateReplica apply to every tablet.
+// Tablets that the tablet server created (or already had) are dropped from the request, so
+// retries only resend the tablets that failed.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const scoped_refptr<TableInfo>& table,
+                      const std::vector<TabletInfo*>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override { return TabletId(); }
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::CreateTabletsRequestPB req_;
+  tserver::CreateTabletsResponsePB resp_;
+};
+
 // Send a DeleteTablet() RPC request.
 class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
  public:
@@ -385,6 +415,38 @@ class AsyncTruncate : public RetryingTSRpcTask {
   tserver::TruncateResponsePB resp_;
 };
 
+// Send a BackfillIndex() RPC request for the next range of rows of a tablet of the indexed table to
+// the leader of the tablet. The catalog manager records the progress and sends the request for the
+// range after it.
+class AsyncBackfillIndex : public RetryingTSRpcTask {
+ public:
+  AsyncBackfillIndex(Master* master,
+                     ThreadPool* callback_pool,
+                     const scoped_refptr<TabletInfo>& tablet,
+                     const scoped_refptr<TableInfo>& index_table,
+                     HybridTime read_time,
+                     std::string start_row_key);
+
+  Type type() const override { return ASYNC_BACKFILL_INDEX; }
+
+  std::string type_name() const override { return "Backfill Index"; }
+
+  std::string description() const override;
+
+ private:
+  TabletId tablet_id() const override;
+
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  const scoped_refptr<TabletInfo> tablet_;
+  const HybridTime read_time_;
+  const std::string start_row_key_;
+  tserver::BackfillIndexResponsePB resp_;
+};
+
 class CommonInfoForRaftTask : public RetryingTSRpcTask {
  public:
   CommonInfoForRaftTask(
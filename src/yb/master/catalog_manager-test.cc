@@ -122,6 +122,39 @@ TEST(TestTSDescriptor, TestReplicaCreationsDecay) {
   }
 }
 
+TEST(TabletInfoTest, TestCachedReplicasInvalidation) {
+  scoped_refptr<TableInfo> table(new TableInfo(CURRENT_TEST_NAME()));
+  scoped_refptr<TabletInfo> tablet(new TabletInfo(table, "tablet"));
+  std::shared_ptr<TSDescriptor> ts0 = SetupTS("0000", "a");
+  std::shared_ptr<TSDescriptor> ts1 = SetupTS("1111", "a");
+
+  TabletInfo::ReplicaMap replicas;
+  int64_t version = 0;
+  tablet->GetReplicaLocations(&replicas, &version);
+  auto entry = std::make_shared<CachedTabletReplicas>();
+  entry->version = version;
+  tablet->set_cached_replicas(entry);
+  ASSERT_EQ(entry, tablet->cached_replicas());
+
+  // Adding a replica invalidates the cached entry.
+  TabletReplica replica;
+  NewReplica(ts0.get(), tablet::RUNNING, consensus::RaftPeerPB::LEADER, &replica);
+  ASSERT_TRUE(tablet->AddToReplicaLocations(replica));
+  ASSERT_EQ(nullptr, tablet->cached_replicas());
+
+  // So does replacing the replica locations, e.g. after a leader change.
+  tablet->GetReplicaLocations(&replicas, &version);
+  entry = std::make_shared<CachedTabletReplicas>();
+  entry->version = version;
+  tablet->set_cached_replicas(entry);
+  ASSERT_EQ(entry, tablet->cached_replicas());
+  NewReplica(ts1.get(), tablet::RUNNING, consensus::RaftPeerPB::LEADER, &replica);
+  replicas.clear();
+  InsertOrDie(&replicas, ts1->permanent_uuid(), replica);
+  tablet->SetReplicaLocations(replicas);
+  ASSERT_EQ(nullptr, tablet->cached_replicas());
+}
+
 TEST(TestLoadBalancerCommunity, TestLoadBalancerAlgorithm) {
   const TableId table_id = CURRENT_TEST_NAME();
   auto options = make_shared<yb::master::Options>();
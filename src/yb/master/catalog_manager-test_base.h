@@ -81,9 +81,11 @@ void NewReplica(
   replica->ts_desc = ts_desc;
   replica->state = state;
   replica->role = role;
+  replica->member_type = consensus::RaftPeerPB::VOTER;
 }
 
-std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
+std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az,
+                                      const string& placement_uuid = "") {
   NodeInstancePB node;
   node.set_permanent_uuid(uuid);
 
@@ -96,6 +98,9 @@ std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
   ci->set_placement_cloud(default_cloud);
   ci->set_placement_region(default_region);
   ci->set_placement_zone(az);
+  if (!placement_uuid.empty()) {
+    reg.mutable_common()->set_placement_uuid(placement_uuid);
+  }
 
   std::shared_ptr<TSDescriptor> ts(new YB_EDITION_NS_PREFIX TSDescriptor(node.permanent_uuid()));
   CHECK_OK(ts->Register(node, reg, CloudInfoPB(), nullptr));
@@ -179,6 +184,16 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    gflags::SetCommandLineOption("leader_balance_threshold", "0");
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeadersByTabletLoad();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeadersWithAffinitizedZones();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestReadReplicaPlacement();
   }
 
  protected:
@@ -668,6 +683,58 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestBalancingLeadersByTabletLoad() {
+    LOG(INFO) << "Testing moving leaders off a tablet server with a hot tablet";
+    LOG(INFO) << "Leader distribution: 2 1 1";
+    ASSERT_OK(AnalyzeTablets());
+
+    // By leader count the distribution is as balanced as it can be.
+    string placeholder, tablet_id;
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    // Report tablet 0, led by ts0, as hot. Its leader is too heavy to move without making the
+    // target the most loaded server, so the other leader of ts0 should be moved instead.
+    gflags::SetCommandLineOption("load_balancer_tablet_ops_weight", "1");
+    TabletMetricsPB metrics;
+    metrics.set_tablet_id(tablets_[0]->tablet_id());
+    metrics.set_read_ops_per_sec(2);
+    tablets_[0]->set_reported_metrics(metrics);
+    LOG(INFO) << "Leader load: 4 1 1";
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+
+    TestMoveLeader(&tablet_id, ts_descs_[0]->permanent_uuid(), "");
+    ASSERT_EQ(tablets_[3]->tablet_id(), tablet_id);
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    tablets_[0]->set_reported_metrics(TabletMetricsPB());
+    gflags::SetCommandLineOption("load_balancer_tablet_ops_weight", "0");
+  }
+
+  void TestBalancingLeadersWithAffinitizedZones() {
+    LOG(INFO) << "Testing moving leaders into the preferred leader zones";
+    // Prefer zones a and b, so ts2 in zone c should not keep any leader.
+    for (const string& az : {"a", "b"}) {
+      CloudInfoPB cloud_info;
+      cloud_info.set_placement_cloud(default_cloud);
+      cloud_info.set_placement_region(default_region);
+      cloud_info.set_placement_zone(az);
+      affinitized_zones_.insert(cloud_info);
+    }
+    LOG(INFO) << "Leader distribution: 2 1 1. Preferred zones: a, b";
+    ASSERT_OK(AnalyzeTablets());
+
+    // The leader on ts2 is moved to the least loaded server in the preferred zones.
+    string placeholder, tablet_id;
+    TestMoveLeader(&tablet_id, ts_descs_[2]->permanent_uuid(), ts_descs_[1]->permanent_uuid());
+    ASSERT_EQ(tablets_[2]->tablet_id(), tablet_id);
+
+    // With 2 leaders on both ts0 and ts1 the preferred zones are balanced.
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+    affinitized_zones_.clear();
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -774,6 +841,51 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestReadReplicaPlacement() {
+    LOG(INFO) << "Testing that observers are placed on the servers of the read replica cluster";
+    const string kReadReplicaUuid = "read_replica";
+    auto* read_replicas = replication_info_.add_read_replicas();
+    read_replicas->set_num_replicas(1);
+    read_replicas->set_placement_uuid(kReadReplicaUuid);
+    const std::set<string> read_replica_servers = {"3333", "4444"};
+    ts_descs_.push_back(SetupTS("3333", "a", kReadReplicaUuid));
+    ts_descs_.push_back(SetupTS("4444", "b", kReadReplicaUuid));
+
+    // The live cluster is balanced, the empty read replica servers should not get voters.
+    auto* options = cb_->state_->options_;
+    options->read_replica_placement_uuids = {kReadReplicaUuid};
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    string placeholder;
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+
+    // Each tablet gets one observer on a read replica server.
+    options->type = ReplicaType::kReadOnly;
+    options->placement_uuid = kReadReplicaUuid;
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_OBSERVER, cb_->GetDefaultMemberType());
+    ASSERT_EQ(tablets_.size(), static_cast<size_t>(get_total_under_replication()));
+    std::set<TabletId> tablets_with_observers;
+    for (int i = 0; i < tablets_.size(); ++i) {
+      string tablet_id, to_ts;
+      ASSERT_TRUE(ASSERT_RESULT(HandleAddReplicas(&tablet_id, &placeholder, &to_ts)));
+      ASSERT_EQ(1, read_replica_servers.count(to_ts)) << to_ts;
+      tablets_with_observers.insert(tablet_id);
+    }
+    ASSERT_EQ(tablets_.size(), tablets_with_observers.size());
+    // Observers are never leaders, so there is nothing to move.
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    options->type = ReplicaType::kLive;
+    options->placement_uuid.clear();
+    options->read_replica_placement_uuids.clear();
+  }
+
+  int get_total_under_replication() const {
+    return cb_->get_total_under_replication();
+  }
+
   // Methods to prepare the state of the current test.
   void PrepareTestState(const TSDescriptorVector& ts_descs) {
     // Clear old state.
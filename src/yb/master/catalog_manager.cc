@@ -56,6 +56,7 @@
 #include <algorithm>
 #include <bitset>
 #include <functional>
+#include <map>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -166,6 +167,13 @@ DEFINE_int32(max_create_tablets_per_ts, 50,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
+DEFINE_int32(max_tablets_per_create_tablets_rpc, 50,
+             "Maximum number of new tablets of a table sent to a tablet server in a single "
+             "CreateTablets RPC. If set to 1 or less, one CreateTablet RPC is sent per replica, "
+             "which is required while any tablet server does not yet support CreateTablets.");
+TAG_FLAG(max_tablets_per_create_tablets_rpc, advanced);
+TAG_FLAG(max_tablets_per_create_tablets_rpc, runtime);
+
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
              "Amount of time to give a newly-elected leader master to load"
              " the previous master's metadata and become active. If this time"
@@ -207,6 +215,22 @@ DEFINE_uint64(transaction_table_num_tablets, 0,
     "Number of tablets to use when creating the transaction status table."
     "0 to use the same default num tablets as for regular tables.");
 
+DEFINE_bool(catalog_manager_cache_tablet_locations, true,
+            "Whether to cache the replica locations built for tablet location lookups, until the "
+            "replicas of the tablet change.");
+TAG_FLAG(catalog_manager_cache_tablet_locations, advanced);
+TAG_FLAG(catalog_manager_cache_tablet_locations, runtime);
+
+DEFINE_int64(tablet_split_size_threshold_bytes, 0,
+             "SST file size above which a tablet is reported as a split candidate. "
+             "0 disables the check.");
+
+DEFINE_bool(enable_index_backfill, true,
+            "Add the rows the indexed table has when an index is created to the index. The index is "
+            "not used by queries until then. Without it, only rows written after the index was "
+            "created are indexed.");
+TAG_FLAG(enable_index_backfill, advanced);
+
 namespace yb {
 namespace master {
 
@@ -297,8 +321,8 @@ class TableLoader : public Visitor<PersistentTableInfo> {
 
     l->Commit();
 
-    LOG(INFO) << "Loaded metadata for table " << table->ToString();
-    VLOG(1) << "Metadata for table " << table->ToString() << ": " << metadata.ShortDebugString();
+    VLOG(1) << "Loaded metadata for table " << table->ToString();
+    VLOG(2) << "Metadata for table " << table->ToString() << ": " << metadata.ShortDebugString();
 
     return Status::OK();
   }
@@ -384,9 +408,9 @@ class TabletLoader : public Visitor<PersistentTabletInfo> {
     // TODO(KUDU-1070): if we see a running tablet under a deleted table,
     // we should "roll forward" the deletion of the tablet here.
 
-    LOG(INFO) << "Loaded metadata for tablet " << tablet_id
-              << " (first table " << first_table->ToString() << ")";
-    VLOG(1) << "Metadata for tablet " << tablet_id << ": " << metadata.ShortDebugString();
+    VLOG(1) << "Loaded metadata for tablet " << tablet_id
+            << " (first table " << first_table->ToString() << ")";
+    VLOG(2) << "Metadata for tablet " << tablet_id << ": " << metadata.ShortDebugString();
 
     return Status::OK();
   }
@@ -683,6 +707,8 @@ void CatalogManagerBgTasks::Run() {
       // Report metrics.
       catalog_manager_->ReportMetrics();
 
+      catalog_manager_->StartIndexBackfills();
+
       TabletInfos to_delete;
       TabletInfos to_process;
 
@@ -743,6 +769,7 @@ CatalogManager::CatalogManager(Master* master)
       tablet_exists_(false),
       state_(kConstructed),
       leader_ready_term_(-1),
+      tablet_locations_version_(GetCurrentTimeMicros()),
       leader_lock_(RWMutex::Priority::PREFER_WRITING),
       load_balance_policy_(new YB_EDITION_NS_PREFIX ClusterLoadBalancer(this)) {
   yb::InitCommonFlags();
@@ -946,56 +973,47 @@ Status CatalogManager::RunLoaders() {
     ts_desc->set_has_tablet_report(false);
   }
 
-  // Visit tables and tablets, load them into memory.
-  // TODO(hector): Refactor this code.
-  LOG(INFO) << __func__ << ": Loading tables into memory.";
-  unique_ptr<TableLoader> table_loader(new TableLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(table_loader.get()), "Failed while visiting tables in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading tablets into memory.";
-  unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading namespaces into memory.";
-  unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(namespace_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading user-defined types into memory.";
-  unique_ptr<UDTypeLoader> udtype_loader(new UDTypeLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(udtype_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading cluster configuration into memory.";
-  unique_ptr<ClusterConfigLoader> config_loader(new ClusterConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(config_loader.get()), "Failed while visiting config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading roles into memory.";
-  unique_ptr<RoleLoader> role_loader(new RoleLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(role_loader.get()),
-      "Failed while visiting roles in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading Redis config into memory.";
-  unique_ptr<RedisConfigLoader> redis_config_loader(new RedisConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(redis_config_loader.get()),
-      "Failed while visiting redis config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading sys config into memory.";
-  unique_ptr<SysConfigLoader> sys_config_loader(new SysConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(sys_config_loader.get()),
-      "Failed while visiting sys config in sys catalog");
+  // Visit tables and tablets, load them into memory. Tables have to be loaded before tablets.
+  std::vector<SysCatalogLoadPhase> phases;
+  auto run_loader = [this, &phases](const char* name, VisitorBase* loader) -> Status {
+    LOG(INFO) << "RunLoaders: Loading " << name << " into memory.";
+    auto start = MonoTime::Now();
+    RETURN_NOT_OK_PREPEND(sys_catalog_->Visit(loader),
+                          Format("Failed while visiting $0 in sys catalog", name));
+    phases.push_back({name, loader->num_visited(), MonoTime::Now() - start});
+    LOG(INFO) << "RunLoaders: Loaded " << phases.back().num_entries << " " << name
+              << " in " << phases.back().duration.ToString();
+    return Status::OK();
+  };
+
+  TableLoader table_loader(this);
+  RETURN_NOT_OK(run_loader("tables", &table_loader));
+  TabletLoader tablet_loader(this);
+  RETURN_NOT_OK(run_loader("tablets", &tablet_loader));
+  NamespaceLoader namespace_loader(this);
+  RETURN_NOT_OK(run_loader("namespaces", &namespace_loader));
+  UDTypeLoader udtype_loader(this);
+  RETURN_NOT_OK(run_loader("user-defined types", &udtype_loader));
+  ClusterConfigLoader config_loader(this);
+  RETURN_NOT_OK(run_loader("cluster configuration", &config_loader));
+  RoleLoader role_loader(this);
+  RETURN_NOT_OK(run_loader("roles", &role_loader));
+  RedisConfigLoader redis_config_loader(this);
+  RETURN_NOT_OK(run_loader("Redis config", &redis_config_loader));
+  SysConfigLoader sys_config_loader(this);
+  RETURN_NOT_OK(run_loader("sys config", &sys_config_loader));
+
+  std::lock_guard<simple_spinlock> l(sys_catalog_load_phases_lock_);
+  sys_catalog_load_phases_ = std::move(phases);
 
   return Status::OK();
 }
 
+std::vector<SysCatalogLoadPhase> CatalogManager::GetSysCatalogLoadPhases() const {
+  std::lock_guard<simple_spinlock> l(sys_catalog_load_phases_lock_);
+  return sys_catalog_load_phases_;
+}
+
 Status CatalogManager::PrepareDefaultClusterConfig(int64_t term) {
   // Verify we have the catalog manager lock.
   if (!lock_.is_locked()) {
@@ -1560,11 +1578,11 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
 Status CatalogManager::ValidateTableReplicationInfo(const ReplicationInfoPB& replication_info) {
   // TODO(bogdan): add the actual subset rules, instead of just erroring out as not supported.
   const auto& live_placement_info = replication_info.live_replicas();
+  // Only the preferred leader zones can be set at the table level so far.
   if (!(live_placement_info.placement_blocks().empty() &&
         live_placement_info.num_replicas() <= 0 &&
         live_placement_info.placement_uuid().empty()) ||
-      !replication_info.read_replicas().empty() ||
-      !replication_info.affinitized_leaders().empty()) {
+      !replication_info.read_replicas().empty()) {
     return STATUS(
         InvalidArgument,
         "Unsupported: cannot set table level replication info yet.");
@@ -1939,6 +1957,13 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   if (PREDICT_FALSE(!s.ok())) {
     return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
   }
+  for (const auto& cloud_info : req.replication_info().affinitized_leaders()) {
+    s = CatalogManagerUtil::DoesPlacementInfoContainCloudInfo(replication_info.live_replicas(),
+                                                              cloud_info);
+    if (PREDICT_FALSE(!s.ok())) {
+      return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
+    }
+  }
 
   // For index table, populate the index info.
   scoped_refptr<TableInfo> indexed_table;
@@ -1958,6 +1983,7 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
                                   req.is_local_index(),
                                   req.is_unique_index(),
                                   &index_info));
+    index_info.set_is_backfilling(FLAGS_enable_index_backfill);
   }
 
   TSDescriptorVector all_ts_descs;
@@ -2009,6 +2035,10 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
 
   // Update the on-disk table state to "running".
   table->mutable_metadata()->mutable_dirty()->pb.set_state(SysTablesEntryPB::RUNNING);
+  if (index_info.is_backfilling()) {
+    // The backfill is started by the background tasks once the indexed table has the index.
+    table->mutable_metadata()->mutable_dirty()->pb.mutable_backfill();
+  }
   s = sys_catalog_->AddItem(table.get(), leader_ready_term_);
   if (PREDICT_FALSE(!s.ok())) {
     return AbortTableCreation(table.get(), tablets,
@@ -2303,6 +2333,11 @@ TableInfo *CatalogManager::CreateTableInfo(const CreateTableRequestPB& req,
   metadata->set_version(0);
   metadata->set_next_column_id(ColumnId(schema.max_col_id() + 1));
   // TODO(bogdan): add back in replication_info once we allow overrides!
+  // Until then, only the preferred leader zones of the table are kept.
+  if (!req.replication_info().affinitized_leaders().empty()) {
+    *metadata->mutable_replication_info()->mutable_affinitized_leaders() =
+        req.replication_info().affinitized_leaders();
+  }
   // Use the Schema object passed in, since it has the column IDs already assigned,
   // whereas the user request PB does not.
   CHECK_OK(SchemaToPB(schema, metadata->mutable_schema()));
@@ -2512,8 +2547,7 @@ Status CatalogManager::IsTruncateTableDone(const IsTruncateTableDoneRequestPB* r
 
   // Lookup the truncated table.
   TRACE("Looking up table $0", req->table_id());
-  std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table = GetTableInfo(req->table_id());
 
   if (table == nullptr) {
     Status s = STATUS(NotFound, "The table does not exist");
@@ -2773,22 +2807,26 @@ Status CatalogManager::DeleteTableInMemory(const TableIdentifierPB& table_identi
 void CatalogManager::MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo> deleted_table,
                                                  TableInfo* table_info) {
   DCHECK_NOTNULL(deleted_table.get());
-  std::lock_guard<LockType> l_map(lock_);
-
-  if (deleted_table->HasTablets()) {
-    VLOG(1) << "The deleted table still has " << deleted_table->NumTablets()
-            << " tablets, table id=" << deleted_table->id();
-    return;
-  }
-
-  LOG(INFO) << "All tablets were deleted from deleted table " << deleted_table->id();
   // Try to use pointer from the arguments (may be NULL).
   scoped_refptr<TableInfo> table(table_info);
+  {
+    // The global lock only protects the deleted tablets and the table lookup. It is released
+    // before the table is locked for write, so that lookups are not blocked behind the commit.
+    boost::shared_lock<LockType> l_map(lock_);
 
-  if (table == nullptr) {
-    table = FindPtrOrNull(table_ids_map_, deleted_table->id());
+    if (deleted_table->HasTablets()) {
+      VLOG(1) << "The deleted table still has " << deleted_table->NumTablets()
+              << " tablets, table id=" << deleted_table->id();
+      return;
+    }
+
+    if (table == nullptr) {
+      table = FindPtrOrNull(table_ids_map_, deleted_table->id());
+    }
   }
 
+  LOG(INFO) << "All tablets were deleted from deleted table " << deleted_table->id();
+
   if (table != nullptr) {
     DCHECK_EQ(table->id(), deleted_table->id());
     auto l = table->LockForWrite();
@@ -2806,25 +2844,36 @@ void CatalogManager::MarkTableDeletedIfNoTablets(scoped_refptr<DeletedTableInfo>
 }
 
 void CatalogManager::CleanUpDeletedTables() {
-  std::lock_guard<LockType> l_map(lock_);
   // Garbage collecting.
-  // Going through all tables under the global lock.
-  for (TableInfoMap::iterator it = table_ids_map_.begin(); it != table_ids_map_.end();) {
-    scoped_refptr<TableInfo> table(it->second);
-
-    if (!table->HasTasks()) {
-      // Lock the candidate table and check the tablets under the lock.
-      auto l = table->LockForRead();
-
-      if (l->data().is_deleted()) {
-        LOG(INFO) << "Removing from by-ids map table " << table->ToString();
-        it = table_ids_map_.erase(it);
-        // TODO: Check if we want to delete the totally deleted table from the sys_catalog here.
-        continue;
+  // Find the deleted tables under the shared lock first, so that lookups can go on while the
+  // tables are checked, and only take the global lock exclusively to erase them.
+  std::vector<scoped_refptr<TableInfo>> deleted_tables;
+  {
+    boost::shared_lock<LockType> l_map(lock_);
+    for (const auto& entry : table_ids_map_) {
+      const scoped_refptr<TableInfo>& table = entry.second;
+      if (!table->HasTasks()) {
+        // Lock the candidate table and check the tablets under the lock.
+        auto l = table->LockForRead();
+        if (l->data().is_deleted()) {
+          deleted_tables.push_back(table);
+        }
       }
     }
+  }
+  if (deleted_tables.empty()) {
+    return;
+  }
 
-    ++it;
+  std::lock_guard<LockType> l_map(lock_);
+  for (const auto& table : deleted_tables) {
+    // A deleted table never comes back, but make sure the map still points to the same object.
+    auto it = table_ids_map_.find(table->id());
+    if (it != table_ids_map_.end() && it->second == table) {
+      LOG(INFO) << "Removing from by-ids map table " << table->ToString();
+      table_ids_map_.erase(it);
+      // TODO: Check if we want to delete the totally deleted table from the sys_catalog here.
+    }
   }
 }
 
@@ -2834,8 +2883,7 @@ Status CatalogManager::IsDeleteTableDone(const IsDeleteTableDoneRequestPB* req,
 
   // Lookup the deleted table.
   TRACE("Looking up table $0", req->table_id());
-  std::lock_guard<LockType> l_map(lock_);
-  scoped_refptr<TableInfo> table = FindPtrOrNull(table_ids_map_, req->table_id());
+  scoped_refptr<TableInfo> table = GetTableInfo(req->table_id());
 
   if (table == nullptr) {
     LOG(INFO) << "Servicing IsDeleteTableDone request for table id "
@@ -3244,6 +3292,111 @@ Status CatalogManager::ListTables(const ListTablesRequestPB* req,
   return Status::OK();
 }
 
+namespace {
+
+// Collects the namespace names by id, for serving catalog reads on a follower master.
+class NamespaceNameCollector : public Visitor<PersistentNamespaceInfo> {
+ public:
+  Status Visit(const NamespaceId& ns_id, const SysNamespaceEntryPB& metadata) override {
+    names_[ns_id] = metadata.name();
+    return Status::OK();
+  }
+
+  const std::unordered_map<NamespaceId, NamespaceName>& names() const { return names_; }
+
+ private:
+  std::unordered_map<NamespaceId, NamespaceName> names_;
+};
+
+// Same filtering as CatalogManager::ListTables, but applied to the persisted table entries.
+class ListTablesCollector : public Visitor<PersistentTableInfo> {
+ public:
+  ListTablesCollector(const ListTablesRequestPB& req,
+                      const NamespaceId& namespace_id,
+                      const std::unordered_map<NamespaceId, NamespaceName>& namespace_names,
+                      ListTablesResponsePB* resp)
+      : req_(req), namespace_id_(namespace_id), namespace_names_(namespace_names), resp_(resp) {}
+
+  Status Visit(const TableId& table_id, const SysTablesEntryPB& metadata) override {
+    if (metadata.state() != SysTablesEntryPB::RUNNING &&
+        metadata.state() != SysTablesEntryPB::ALTERING) {
+      return Status::OK();
+    }
+    if (!namespace_id_.empty() && namespace_id_ != metadata.namespace_id()) {
+      return Status::OK();
+    }
+    if (req_.has_name_filter() && metadata.name().find(req_.name_filter()) == string::npos) {
+      return Status::OK();
+    }
+    // Followers do not track the system tablets, so system tables are recognized by namespace.
+    if (req_.exclude_system_tables() &&
+        (metadata.namespace_id() == kSystemNamespaceId ||
+         metadata.namespace_id() == kSystemSchemaNamespaceId ||
+         metadata.namespace_id() == kSystemAuthNamespaceId ||
+         metadata.table_type() == REDIS_TABLE_TYPE)) {
+      return Status::OK();
+    }
+
+    ListTablesResponsePB::TableInfo* table = resp_->add_tables();
+    table->set_id(table_id);
+    table->set_name(metadata.name());
+    table->set_table_type(metadata.table_type());
+    auto it = namespace_names_.find(metadata.namespace_id());
+    if (it != namespace_names_.end()) {
+      table->mutable_namespace_()->set_id(it->first);
+      table->mutable_namespace_()->set_name(it->second);
+    }
+    return Status::OK();
+  }
+
+ private:
+  const ListTablesRequestPB& req_;
+  const NamespaceId& namespace_id_;
+  const std::unordered_map<NamespaceId, NamespaceName>& namespace_names_;
+  ListTablesResponsePB* resp_;
+};
+
+} // namespace
+
+Status CatalogManager::ListTablesOnFollower(const ListTablesRequestPB* req,
+                                           ListTablesResponsePB* resp) {
+  RETURN_NOT_OK(CheckOnline());
+
+  // Only answer if the leader has replicated to us recently, otherwise let the client go to the
+  // leader.
+  auto consensus = tablet_peer()->shared_consensus();
+  const MonoTime last_message_from_leader =
+      consensus ? consensus->TimeSinceLastMessageFromLeader() : MonoTime::kUninitialized;
+  if (last_message_from_leader == MonoTime::kUninitialized ||
+      MonoTime::Now().GetDeltaSince(last_message_from_leader).ToMilliseconds() >
+          req->max_follower_staleness_ms()) {
+    Status s = STATUS(IllegalState, "Stale follower master, retry on the leader");
+    return SetupError(resp->mutable_error(), MasterErrorPB::NOT_THE_LEADER, s);
+  }
+
+  NamespaceNameCollector namespace_collector;
+  RETURN_NOT_OK(sys_catalog_->Visit(&namespace_collector));
+
+  NamespaceId namespace_id;
+  if (req->has_namespace_()) {
+    const NamespaceIdentifierPB& ns_identifier = req->namespace_();
+    for (const auto& entry : namespace_collector.names()) {
+      if ((ns_identifier.has_id() && entry.first == ns_identifier.id()) ||
+          (!ns_identifier.has_id() && entry.second == ns_identifier.name())) {
+        namespace_id = entry.first;
+        break;
+      }
+    }
+    if (namespace_id.empty()) {
+      Status s = STATUS(NotFound, "Keyspace name not found", ns_identifier.ShortDebugString());
+      return SetupError(resp->mutable_error(), MasterErrorPB::NAMESPACE_NOT_FOUND, s);
+    }
+  }
+
+  ListTablesCollector table_collector(*req, namespace_id, namespace_collector.names(), resp);
+  return sys_catalog_->Visit(&table_collector);
+}
+
 scoped_refptr<TableInfo> CatalogManager::GetTableInfo(const TableId& table_id) {
   boost::shared_lock<LockType> l(lock_);
   return FindPtrOrNull(table_ids_map_, table_id);
@@ -3707,6 +3860,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
   // The report will not have a committed_consensus_state if it is in the
   // middle of starting up, such as during tablet bootstrap.
+  bool locations_changed = false;
   if (report.has_committed_consensus_state()) {
     const ConsensusStatePB& prev_cstate = tablet_lock->data().pb.committed_consensus_state();
     ConsensusStatePB cstate = report.committed_consensus_state();
@@ -3808,6 +3962,7 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
 
       RETURN_NOT_OK(ResetTabletReplicasFromReportedConfig(*final_report, tablet,
                                                           tablet_lock.get(), table_lock.get()));
+      locations_changed = true;
 
       // Sanity check replicas for this tablet.
       TabletInfo::ReplicaMap replica_map;
@@ -3836,6 +3991,9 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
     return s;
   }
   tablet_lock->Commit();
+  if (locations_changed) {
+    tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
+  }
 
   // Need to defer the AlterTable command to after we've committed the new tablet data,
   // since the tablet report may also be updating the raft config, and the Alter Table
@@ -4726,9 +4884,12 @@ Status CatalogManager::RedisConfigGet(
     const RedisConfigGetRequestPB* req, RedisConfigGetResponsePB* resp, rpc::RpcContext* rpc) {
   DCHECK(req->has_keyword());
   resp->set_keyword(req->keyword());
-  TRACE("Acquired catalog manager lock");
-  std::lock_guard<LockType> l_big(lock_);
-  scoped_refptr<RedisConfigInfo> cfg = FindPtrOrNull(redis_config_map_, req->keyword());
+  scoped_refptr<RedisConfigInfo> cfg;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    TRACE("Acquired catalog manager lock");
+    cfg = FindPtrOrNull(redis_config_map_, req->keyword());
+  }
   if (cfg == nullptr) {
     Status s = STATUS(NotFound, Substitute("Redis config for $0 does not exists", req->keyword()));
     return SetupError(resp->mutable_error(), MasterErrorPB::REDIS_CONFIG_NOT_FOUND, s);
@@ -5558,6 +5719,197 @@ Status CatalogManager::HandleTabletSchemaVersionReport(TabletInfo *tablet, uint3
   return Status::OK();
 }
 
+void CatalogManager::StartIndexBackfills() {
+  std::vector<scoped_refptr<TableInfo>> index_tables;
+  {
+    boost::shared_lock<LockType> l(lock_);
+    for (const auto& entry : table_ids_map_) {
+      const auto& table = entry.second;
+      auto table_lock = table->LockForRead();
+      if (table_lock->data().pb.has_backfill() &&
+          !table_lock->data().pb.backfill().has_failure() && table_lock->data().is_running() &&
+          !table->HasTasks(MonitoredTask::ASYNC_BACKFILL_INDEX)) {
+        index_tables.push_back(table);
+      }
+    }
+  }
+
+  for (const auto& index_table : index_tables) {
+    WARN_NOT_OK(StartIndexBackfill(index_table),
+                Format("Failed to start backfill of index $0", index_table->ToString()));
+  }
+}
+
+Status CatalogManager::StartIndexBackfill(const scoped_refptr<TableInfo>& index_table) {
+  if (index_table->IsCreateInProgress()) {
+    return Status::OK();
+  }
+  const auto indexed_table = GetTableInfo(index_table->indexed_table_id());
+  if (indexed_table == nullptr) {
+    return STATUS_FORMAT(NotFound, "Indexed table $0 does not exist",
+                         index_table->indexed_table_id());
+  }
+
+  bool is_backfilling = false;
+  {
+    auto l = indexed_table->LockForRead();
+    if (l->data().pb.state() != SysTablesEntryPB::RUNNING) {
+      // Rows written by tablets that do not have the index yet would be missed.
+      return Status::OK();
+    }
+    for (const auto& index_info : l->data().pb.indexes()) {
+      if (index_info.table_id() == index_table->id()) {
+        is_backfilling = index_info.is_backfilling();
+        break;
+      }
+    }
+  }
+  if (!is_backfilling) {
+    // The index was marked as backfilled, but the progress was not cleared yet.
+    return MarkIndexBackfilled(index_table);
+  }
+
+  TabletInfos tablets;
+  indexed_table->GetAllTablets(&tablets);
+  IndexBackfillPB backfill;
+  {
+    auto l = index_table->LockForWrite();
+    backfill = l->data().pb.backfill();
+    if (backfill.has_failure()) {
+      return Status::OK();
+    }
+    if (!backfill.has_read_hybrid_time()) {
+      backfill.set_read_hybrid_time(master_->clock()->Now().ToUint64());
+      for (const auto& tablet : tablets) {
+        backfill.add_tablets()->set_tablet_id(tablet->tablet_id());
+      }
+      *l->mutable_data()->pb.mutable_backfill() = backfill;
+      RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get(), leader_ready_term_));
+      l->Commit();
+    }
+  }
+
+  const HybridTime read_time(backfill.read_hybrid_time());
+  LOG(INFO) << "Backfilling index " << index_table->ToString() << " of "
+            << indexed_table->ToString() << " at " << read_time;
+  bool done = true;
+  for (const auto& tablet_progress : backfill.tablets()) {
+    if (tablet_progress.done()) {
+      continue;
+    }
+    done = false;
+    auto it = std::find_if(
+        tablets.begin(), tablets.end(), [&tablet_progress](const auto& tablet) {
+          return tablet->tablet_id() == tablet_progress.tablet_id();
+        });
+    if (it == tablets.end()) {
+      return STATUS_FORMAT(NotFound, "Tablet $0 of $1 does not exist",
+                           tablet_progress.tablet_id(), indexed_table->ToString());
+    }
+    SendBackfillIndexRequest(index_table, *it, read_time, tablet_progress.next_row_key());
+  }
+  return done ? MarkIndexBackfilled(index_table) : Status::OK();
+}
+
+Status CatalogManager::IndexBackfillProgressed(const scoped_refptr<TableInfo>& index_table,
+                                               const scoped_refptr<TabletInfo>& tablet,
+                                               HybridTime read_time,
+                                               const std::string& next_row_key) {
+  bool done = true;
+  {
+    auto l = index_table->LockForWrite();
+    if (!l->data().pb.has_backfill() ||
+        l->data().pb.backfill().read_hybrid_time() != read_time.ToUint64()) {
+      return STATUS_FORMAT(IllegalState, "Backfill of $0 at $1 is not in progress",
+                           index_table->ToString(), read_time);
+    }
+    if (l->data().pb.backfill().has_failure()) {
+      // Another tablet failed, so the rest of this tablet is not added.
+      return Status::OK();
+    }
+    for (auto& tablet_progress : *l->mutable_data()->pb.mutable_backfill()->mutable_tablets()) {
+      if (tablet_progress.tablet_id() == tablet->tablet_id()) {
+        tablet_progress.set_next_row_key(next_row_key);
+        tablet_progress.set_done(next_row_key.empty());
+      }
+      done = done && tablet_progress.done();
+    }
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get(), leader_ready_term_));
+    l->Commit();
+  }
+
+  if (!next_row_key.empty()) {
+    SendBackfillIndexRequest(index_table, tablet, read_time, next_row_key);
+    return Status::OK();
+  }
+  LOG(INFO) << "Backfilled index " << index_table->ToString() << " on tablet "
+            << tablet->tablet_id();
+  return done ? MarkIndexBackfilled(index_table) : Status::OK();
+}
+
+Status CatalogManager::IndexBackfillFailed(const scoped_refptr<TableInfo>& index_table,
+                                           HybridTime read_time,
+                                           const Status& failure) {
+  auto l = index_table->LockForWrite();
+  const auto& backfill = l->data().pb.backfill();
+  if (!l->data().pb.has_backfill() || backfill.read_hybrid_time() != read_time.ToUint64() ||
+      backfill.has_failure()) {
+    return Status::OK();
+  }
+  StatusToPB(failure, l->mutable_data()->pb.mutable_backfill()->mutable_failure());
+  RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get(), leader_ready_term_));
+  l->Commit();
+  LOG(ERROR) << "Backfill of index " << index_table->ToString() << " failed, the index is not "
+             << "used by queries: " << failure;
+  return Status::OK();
+}
+
+Status CatalogManager::MarkIndexBackfilled(const scoped_refptr<TableInfo>& index_table) {
+  const auto indexed_table = GetTableInfo(index_table->indexed_table_id());
+  if (indexed_table != nullptr) {
+    auto l = indexed_table->LockForWrite();
+    bool found = false;
+    for (auto& index_info : *l->mutable_data()->pb.mutable_indexes()) {
+      if (index_info.table_id() == index_table->id() && index_info.is_backfilling()) {
+        index_info.set_is_backfilling(false);
+        found = true;
+      }
+    }
+    if (found) {
+      // Tablets and clients pick up the index with the new schema version.
+      auto& pb = l->mutable_data()->pb;
+      pb.set_version(pb.version() + 1);
+      l->mutable_data()->set_state(SysTablesEntryPB::ALTERING,
+                                   Substitute("Alter table version=$0 ts=$1",
+                                              pb.version(), LocalTimeAsString()));
+      RETURN_NOT_OK(sys_catalog_->UpdateItem(indexed_table.get(), leader_ready_term_));
+      l->Commit();
+      SendAlterTableRequest(indexed_table);
+    }
+  }
+
+  auto l = index_table->LockForWrite();
+  auto& pb = l->mutable_data()->pb;
+  pb.clear_backfill();
+  if (pb.has_index_info()) {
+    pb.mutable_index_info()->set_is_backfilling(false);
+  }
+  RETURN_NOT_OK(sys_catalog_->UpdateItem(index_table.get(), leader_ready_term_));
+  l->Commit();
+  LOG(INFO) << "Index " << index_table->ToString() << " is backfilled";
+  return Status::OK();
+}
+
+void CatalogManager::SendBackfillIndexRequest(const scoped_refptr<TableInfo>& index_table,
+                                              const scoped_refptr<TabletInfo>& tablet,
+                                              HybridTime read_time,
+                                              const std::string& start_row_key) {
+  auto call = std::make_shared<AsyncBackfillIndex>(
+      master_, worker_pool_.get(), tablet, index_table, read_time, start_row_key);
+  index_table->AddTask(call);
+  WARN_NOT_OK(call->Run(), "Failed to send backfill index request");
+}
+
 // Helper class to commit TabletInfo mutations at the end of a scope.
 namespace {
 
@@ -5844,17 +6196,39 @@ Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB&
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  const int batch_size = FLAGS_max_tablets_per_create_tablets_rpc;
+  // Tablets to create, grouped by table and then by the tablet server hosting the replica.
+  std::map<TableId, std::map<TabletServerId, vector<TabletInfo*>>> batches;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
     for (const RaftPeerPB& peer : config.peers()) {
+      if (batch_size > 1) {
+        batches[tablet->table()->id()][peer.permanent_uuid()].push_back(tablet);
+        continue;
+      }
       auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
           peer.permanent_uuid(), tablet);
       tablet->table()->AddTask(task);
       WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
     }
   }
+
+  for (const auto& table_batches : batches) {
+    for (const auto& ts_batch : table_batches.second) {
+      const vector<TabletInfo*>& ts_tablets = ts_batch.second;
+      const scoped_refptr<TableInfo>& table = ts_tablets.front()->table();
+      for (size_t begin = 0; begin < ts_tablets.size(); begin += batch_size) {
+        const size_t end = std::min(ts_tablets.size(), begin + batch_size);
+        auto task = std::make_shared<AsyncCreateReplicas>(master_, worker_pool_.get(),
+            ts_batch.first, table,
+            vector<TabletInfo*>(ts_tablets.begin() + begin, ts_tablets.begin() + end));
+        table->AddTask(task);
+        WARN_NOT_OK(task->Run(), "Failed to send new tablets request");
+      }
+    }
+  }
 }
 
 shared_ptr<TSDescriptor> CatalogManager::PickBetterReplicaLocation(
@@ -6009,7 +6383,9 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
   TSRegistrationPB reg;
 
   TabletInfo::ReplicaMap locs;
+  int64_t locs_version = 0;
   consensus::ConsensusStatePB cstate;
+  std::shared_ptr<const CachedTabletReplicas> cached;
   {
     auto l_tablet = tablet->LockForRead();
     if (PREDICT_FALSE(l_tablet->data().is_deleted())) {
@@ -6020,15 +6396,37 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       return STATUS(ServiceUnavailable, "Tablet not running");
     }
 
-    tablet->GetReplicaLocations(&locs);
-    if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
-      cstate = l_tablet->data().pb.committed_consensus_state();
+    locs_pb->mutable_partition()->CopyFrom(tablet->metadata().state().pb.partition());
+
+    if (FLAGS_catalog_manager_cache_tablet_locations) {
+      cached = tablet->cached_replicas();
+      if (cached) {
+        for (const auto& ts_seqno : cached->ts_seqnos) {
+          if (ts_seqno.first->latest_seqno() != ts_seqno.second) {
+            cached = nullptr;
+            break;
+          }
+        }
+      }
     }
 
-    locs_pb->mutable_partition()->CopyFrom(tablet->metadata().state().pb.partition());
+    if (!cached) {
+      tablet->GetReplicaLocations(&locs, &locs_version);
+      if (locs.empty() && l_tablet->data().pb.has_committed_consensus_state()) {
+        cstate = l_tablet->data().pb.committed_consensus_state();
+      }
+    }
   }
 
   locs_pb->set_tablet_id(tablet->tablet_id());
+
+  // Serve the replicas from the cache if their locations did not change since it was built.
+  if (cached) {
+    locs_pb->set_stale(false);
+    *locs_pb->mutable_replicas() = cached->replicas;
+    return Status::OK();
+  }
+
   locs_pb->set_stale(locs.empty());
 
   // If the locations are cached.
@@ -6052,6 +6450,17 @@ Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>&
       replica_pb->mutable_ts_info()->set_placement_uuid(
           tsinfo_pb.registration().common().placement_uuid());
     }
+
+    if (FLAGS_catalog_manager_cache_tablet_locations) {
+      auto entry = std::make_shared<CachedTabletReplicas>();
+      entry->version = locs_version;
+      for (const TabletInfo::ReplicaMap::value_type& replica : locs) {
+        entry->ts_seqnos.emplace_back(replica.second.ts_desc,
+                                      replica.second.ts_desc->latest_seqno());
+      }
+      entry->replicas = locs_pb->replicas();
+      tablet->set_cached_replicas(std::move(entry));
+    }
     return Status::OK();
   }
 
@@ -6074,6 +6483,41 @@ Result<shared_ptr<tablet::AbstractTablet>> CatalogManager::GetSystemTablet(const
   return iter->second;
 }
 
+void CatalogManager::ProcessTabletMetrics(
+    const google::protobuf::RepeatedPtrField<TabletMetricsPB>& metrics) {
+  const int64_t threshold = FLAGS_tablet_split_size_threshold_bytes;
+  for (const TabletMetricsPB& tablet_metrics : metrics) {
+    scoped_refptr<TabletInfo> tablet_info;
+    {
+      boost::shared_lock<LockType> l(lock_);
+      if (!FindCopy(tablet_map_, tablet_metrics.tablet_id(), &tablet_info)) {
+        continue;
+      }
+    }
+    const int64_t old_size = tablet_info->reported_metrics().sst_file_size();
+    const int64_t new_size = tablet_metrics.sst_file_size();
+    tablet_info->set_reported_metrics(tablet_metrics);
+    if (threshold > 0 && old_size <= threshold && new_size > threshold) {
+      LOG(INFO) << "Tablet " << tablet_info->ToString() << " has grown to "
+                << new_size << " bytes and is a split candidate";
+    }
+  }
+}
+
+void CatalogManager::GetTabletSplitCandidates(TabletInfos* tablets) {
+  tablets->clear();
+  const int64_t threshold = FLAGS_tablet_split_size_threshold_bytes;
+  if (threshold <= 0) {
+    return;
+  }
+  boost::shared_lock<LockType> l(lock_);
+  for (const auto& entry : tablet_map_) {
+    if (entry.second->reported_metrics().sst_file_size() > threshold) {
+      tablets->push_back(entry.second);
+    }
+  }
+}
+
 Status CatalogManager::GetTabletLocations(const TabletId& tablet_id, TabletLocationsPB* locs_pb) {
   RETURN_NOT_OK(CheckOnline());
 
@@ -6496,6 +6940,20 @@ Status CatalogManager::AreLeadersOnPreferredOnly(const AreLeadersOnPreferredOnly
   return Status::OK();
 }
 
+Status CatalogManager::ListTabletSplitCandidates(const ListTabletSplitCandidatesRequestPB* req,
+                                                 ListTabletSplitCandidatesResponsePB* resp) {
+  TabletInfos tablets;
+  GetTabletSplitCandidates(&tablets);
+  for (const auto& tablet : tablets) {
+    auto* candidate = resp->add_candidates();
+    candidate->set_tablet_id(tablet->tablet_id());
+    candidate->set_table_id(tablet->table()->id());
+    candidate->set_table_name(tablet->table()->name());
+    candidate->set_sst_file_size(tablet->reported_metrics().sst_file_size());
+  }
+  return Status::OK();
+}
+
 void BlacklistState::Reset() {
   tservers_.clear();
   initial_load_ = 0;
@@ -6665,6 +7123,7 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  ++replica_locations_version_;
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
@@ -6672,9 +7131,33 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
   *replica_locations = replica_locations_;
 }
 
+void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations, int64_t* version) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  *replica_locations = replica_locations_;
+  *version = replica_locations_version_;
+}
+
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (!InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica)) {
+    return false;
+  }
+  ++replica_locations_version_;
+  return true;
+}
+
+std::shared_ptr<const CachedTabletReplicas> TabletInfo::cached_replicas() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (cached_replicas_ && cached_replicas_->version == replica_locations_version_) {
+    return cached_replicas_;
+  }
+  return nullptr;
+}
+
+void TabletInfo::set_cached_replicas(
+    std::shared_ptr<const CachedTabletReplicas> cached_replicas) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  cached_replicas_ = std::move(cached_replicas);
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
@@ -6701,6 +7184,16 @@ uint32_t TabletInfo::reported_schema_version() const {
   return reported_schema_version_;
 }
 
+void TabletInfo::set_reported_metrics(const TabletMetricsPB& metrics) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  reported_metrics_ = metrics;
+}
+
+TabletMetricsPB TabletInfo::reported_metrics() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return reported_metrics_;
+}
+
 std::string TabletInfo::ToString() const {
   return Substitute("$0 (table $1)", tablet_id_,
                     (table_ != nullptr ? table_->ToString() : "MISSING"));
@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -180,6 +181,13 @@ struct PersistentTabletInfo : public Persistent<SysTabletsEntryPB, SysRowEntry::
   void set_state(SysTabletsEntryPB::State state, const std::string& msg);
 };
 
+// Time spent loading one type of entries from the sys catalog.
+struct SysCatalogLoadPhase {
+  std::string name;
+  int64_t num_entries;
+  MonoDelta duration;
+};
+
 // Information on a current replica of a tablet.
 // This is copyable so that no locking is needed.
 struct TabletReplica {
@@ -196,6 +204,19 @@ struct TabletReplica {
   }
 };
 
+// Replica locations of a tablet built by BuildLocationsForTablet(), kept so that the next lookup
+// does not have to build them again.
+struct CachedTabletReplicas {
+  // Version of the replica locations the entry was built from.
+  int64_t version;
+
+  // Instance sequence number of each replica's tablet server when the entry was built. A tablet
+  // server that re-registers may have changed addresses.
+  std::vector<std::pair<TSDescriptor*, int64_t>> ts_seqnos;
+
+  google::protobuf::RepeatedPtrField<TabletLocationsPB_ReplicaPB> replicas;
+};
+
 // The information about a single tablet which exists in the cluster,
 // including its state and locations.
 //
@@ -230,6 +251,15 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   void SetReplicaLocations(ReplicaMap replica_locations);
   void GetReplicaLocations(ReplicaMap* replica_locations) const;
 
+  // Same as the above, also returns the version of the replica locations, which changes every time
+  // they are updated.
+  void GetReplicaLocations(ReplicaMap* replica_locations, int64_t* version) const;
+
+  // Accessors for the cached replica locations. The getter returns nullptr if the replica
+  // locations changed since the entry was stored.
+  std::shared_ptr<const CachedTabletReplicas> cached_replicas() const;
+  void set_cached_replicas(std::shared_ptr<const CachedTabletReplicas> cached_replicas);
+
   // Adds the given replica to the replica_locations_ map.
   // Returns true iff the replica was inserted.
   bool AddToReplicaLocations(const TabletReplica& replica);
@@ -242,6 +272,10 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   bool set_reported_schema_version(uint32_t version);
   uint32_t reported_schema_version() const;
 
+  // Accessors for the load last reported by the leader of this tablet.
+  void set_reported_metrics(const TabletMetricsPB& metrics);
+  TabletMetricsPB reported_metrics() const;
+
   // No synchronization needed.
   std::string ToString() const override;
 
@@ -275,9 +309,17 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // reported. The map is keyed by tablet server UUID.
   ReplicaMap replica_locations_;
 
+  // Incremented every time replica_locations_ changes.
+  int64_t replica_locations_version_ = 0;
+
+  std::shared_ptr<const CachedTabletReplicas> cached_replicas_;
+
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
 
+  // Load reported by the tablet leader (in-memory only).
+  TabletMetricsPB reported_metrics_;
+
   LeaderStepDownFailureTimes leader_stepdown_failure_times_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletInfo);
@@ -844,6 +886,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS ListTables(const ListTablesRequestPB* req,
                             ListTablesResponsePB* resp);
 
+  // List all the running tables from the local copy of the sys catalog, without relying on the
+  // in-memory maps, which are only maintained by the leader. Used by follower masters to serve
+  // requests that accept bounded staleness (max_follower_staleness_ms).
+  CHECKED_STATUS ListTablesOnFollower(const ListTablesRequestPB* req,
+                                      ListTablesResponsePB* resp);
+
   CHECKED_STATUS GetTableLocations(const GetTableLocationsRequestPB* req,
                                    GetTableLocationsResponsePB* resp);
 
@@ -868,6 +916,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                      TabletReportUpdatesPB *report_update,
                                      rpc::RpcContext* rpc);
 
+  // Record the tablet load reported by a tablet server in its heartbeat, and log the tablets
+  // that have grown past --tablet_split_size_threshold_bytes.
+  void ProcessTabletMetrics(const google::protobuf::RepeatedPtrField<TabletMetricsPB>& metrics);
+
+  // Fill 'tablets' with the tablets whose last reported size is above
+  // --tablet_split_size_threshold_bytes. Empty if the threshold is not set.
+  void GetTabletSplitCandidates(TabletInfos* tablets);
+
   // Create a new Namespace with the specified attributes.
   //
   // The RPC context is provided for logging/tracing purposes,
@@ -996,6 +1052,13 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   void GetAllNamespaces(std::vector<scoped_refptr<NamespaceInfo> >* namespaces);
 
+  // Version of tablet locations, i.e. of replicas and leaders of all tablets. It changes when
+  // a tablet report changes the consensus state of a tablet, and is sent to tablet servers in
+  // heartbeat responses, so CQL proxies could tell drivers to refresh system.partitions.
+  uint64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
   // Return all the available (user-defined) types.
   void GetAllUDTypes(std::vector<scoped_refptr<UDTypeInfo> >* types);
 
@@ -1123,6 +1186,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS AreLeadersOnPreferredOnly(const AreLeadersOnPreferredOnlyRequestPB* req,
                                            AreLeadersOnPreferredOnlyResponsePB* resp);
 
+  // API to list the tablets returned by GetTabletSplitCandidates.
+  CHECKED_STATUS ListTabletSplitCandidates(const ListTabletSplitCandidatesRequestPB* req,
+                                           ListTabletSplitCandidatesResponsePB* resp);
+
   // Return the placement uuid of the primary cluster containing this master.
   string placement_uuid() const;
 
@@ -1132,6 +1199,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS VisitSysCatalog(int64_t term);
   virtual CHECKED_STATUS RunLoaders();
 
+  // Returns the time spent in each phase of the last sys catalog load.
+  std::vector<SysCatalogLoadPhase> GetSysCatalogLoadPhases() const;
+
   // Waits for the worker queue to finish processing, returns OK if worker queue is idle before
   // the provided timeout, TimedOut Status otherwise.
   CHECKED_STATUS WaitForWorkerPoolTests(
@@ -1380,6 +1450,38 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   CHECKED_STATUS HandleTabletSchemaVersionReport(TabletInfo *tablet, uint32_t version);
 
+  // Starts backfill tasks for the indexes, whose backfill is pending and has no tasks running,
+  // i.e. new indexes, indexes whose tasks failed and indexes backfilled by the previous leader.
+  void StartIndexBackfills();
+
+  // Starts backfill tasks for tablets of the indexed table, that were not backfilled yet. A
+  // backfill starts once the indexed table is not altering, i.e. once all its tablets update the
+  // index on writes. Only then the read hybrid time is picked.
+  CHECKED_STATUS StartIndexBackfill(const scoped_refptr<TableInfo>& index_table);
+
+  // Records that rows of the tablet before next_row_key were added to the index, and sends the
+  // request for the next rows. An empty next_row_key means that all rows of the tablet were added.
+  // When all tablets are done, the index is marked as usable by queries.
+  CHECKED_STATUS IndexBackfillProgressed(const scoped_refptr<TableInfo>& index_table,
+                                         const scoped_refptr<TabletInfo>& tablet,
+                                         HybridTime read_time,
+                                         const std::string& next_row_key);
+
+  // Records that the backfill failed with an error that retries would not fix. The backfill is not
+  // restarted, and the index stays unused by queries, with the failure in its backfill progress.
+  CHECKED_STATUS IndexBackfillFailed(const scoped_refptr<TableInfo>& index_table,
+                                     HybridTime read_time,
+                                     const Status& failure);
+
+  // Clears the backfilling flag of the index in the indexed table and the backfill progress of
+  // the index table.
+  CHECKED_STATUS MarkIndexBackfilled(const scoped_refptr<TableInfo>& index_table);
+
+  void SendBackfillIndexRequest(const scoped_refptr<TableInfo>& index_table,
+                                const scoped_refptr<TabletInfo>& tablet,
+                                HybridTime read_time,
+                                const std::string& start_row_key);
+
   // Send the create tablet requests to the selected peers of the consensus configurations.
   // The creation is async, and at the moment there is no error checking on the
   // caller side. We rely on the assignment timeout. If we don't see the tablet
@@ -1659,6 +1761,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // correctly.
   int64_t leader_ready_term_;
 
+  // Starts from the current time, so the version still changes when another master becomes
+  // the leader.
+  std::atomic<uint64_t> tablet_locations_version_;
+
   // Lock used to fence operations and leader elections. All logical operations
   // (i.e. create table, alter table, etc.) should acquire this lock for
   // reading. Following an election where this master is elected leader, it
@@ -1673,6 +1779,7 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Async operations are accessing some private methods
   // (TODO: this stuff should be deferred and done in the background thread)
   friend class AsyncAlterTable;
+  friend class AsyncBackfillIndex;
 
   // Number of live tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_live_;
@@ -1699,6 +1806,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
       PermissionType::SELECT_PERMISSION
   };
 
+  // Timing of the last sys catalog load, shown on the master web UI.
+  mutable simple_spinlock sys_catalog_load_phases_lock_;
+  std::vector<SysCatalogLoadPhase> sys_catalog_load_phases_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CatalogManager);
 };
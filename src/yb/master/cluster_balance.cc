@@ -60,6 +60,17 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_double(load_balancer_tablet_ops_weight,
+              0,
+              "Extra load a tablet replica adds to its tablet server for each operation per second "
+              "reported by the tablet leader. With the default of 0, every replica counts as a "
+              "load of 1.");
+
+DEFINE_double(load_balancer_tablet_size_weight_per_gb,
+              0,
+              "Extra load a tablet replica adds to its tablet server for each GB of SST files "
+              "reported by the tablet leader.");
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -77,7 +88,10 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   // Set the placement information on a per-table basis, only once.
   if (!state_->placement_by_table_.count(table_id)) {
     PlacementInfoPB pb;
-    {
+    if (state_->options_->type == ReplicaType::kReadOnly) {
+      // Read replicas can only be configured for the whole cluster.
+      pb.CopyFrom(GetReadReplicaPlacementInfo(state_->options_->placement_uuid));
+    } else {
       auto l = tablet->table()->LockForRead();
       // If we have a custom per-table placement policy, use that.
       if (l->data().pb.replication_info().has_live_replicas()) {
@@ -98,6 +112,16 @@ const PlacementInfoPB& ClusterLoadBalancer::GetPlacementByTablet(const TabletId&
   return state_->placement_by_table_.at(table_id);
 }
 
+const PlacementInfoPB& ClusterLoadBalancer::GetReadReplicaPlacementInfo(
+    const std::string& placement_uuid) const {
+  for (const auto& placement_info : GetClusterReplicationInfo().read_replicas()) {
+    if (placement_info.placement_uuid() == placement_uuid) {
+      return placement_info;
+    }
+  }
+  return PlacementInfoPB::default_instance();
+}
+
 int ClusterLoadBalancer::get_total_wrong_placement() const {
   return state_->tablets_wrong_placement_.size();
 }
@@ -154,6 +178,29 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   // Lock the CatalogManager maps for the duration of the load balancer run.
   boost::shared_lock<CatalogManager::LockType> l(catalog_manager_->lock_);
 
+  const ReplicationInfoPB replication_info = GetClusterReplicationInfo();
+  options->read_replica_placement_uuids.clear();
+  for (const auto& placement_info : replication_info.read_replicas()) {
+    options->read_replica_placement_uuids.insert(placement_info.placement_uuid());
+  }
+
+  options->type = ReplicaType::kLive;
+  options->placement_uuid = replication_info.live_replicas().placement_uuid();
+  RunLoadBalancerWithOptions(options);
+
+  // Observers of the read replica clusters are added on their own servers, without taking part in
+  // the write quorum of the live cluster.
+  for (const auto& placement_info : replication_info.read_replicas()) {
+    if (placement_info.num_replicas() <= 0) {
+      continue;
+    }
+    options->type = ReplicaType::kReadOnly;
+    options->placement_uuid = placement_info.placement_uuid();
+    RunLoadBalancerWithOptions(options);
+  }
+}
+
+void ClusterLoadBalancer::RunLoadBalancerWithOptions(Options* options) {
   int remaining_adds = options->kMaxConcurrentAdds;
   int remaining_removals = options->kMaxConcurrentRemovals;
   int remaining_leader_moves = options->kMaxConcurrentLeaderMoves;
@@ -226,7 +273,10 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       --remaining_removals;
     }
 
-    // Handle tablet servers with too many leaders.
+    // Handle tablet servers with too many leaders. Observers never become leaders.
+    if (options->type == ReplicaType::kReadOnly) {
+      remaining_leader_moves = 0;
+    }
     for (int i = 0; i < remaining_leader_moves; ++i) {
       auto handle_leader = HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
       if (!handle_leader.ok()) {
@@ -254,6 +304,11 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
 
+  // Same for the preferred leader zones, which decide what servers take part in leader balancing.
+  AffinitizedZonesSet affinitized_zones;
+  GetAffinitizedZones(table_uuid, &affinitized_zones);
+  state_->SetAffinitizedZones(affinitized_zones);
+
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
   // assigned any tablets yet).
@@ -317,7 +372,8 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
       RETURN_NOT_OK(state_->RemoveReplica(
           tablet_id, state_->pending_remove_replica_tasks_[table_uuid][tablet_id]));
     }
-    if (state_->pending_stepdown_leader_tasks_[table_uuid].count(tablet_id) > 0) {
+    if (state_->pending_stepdown_leader_tasks_[table_uuid].count(tablet_id) > 0 &&
+        state_->options_->type == ReplicaType::kLive) {
       const auto& tablet_meta = state_->per_tablet_meta_[tablet_id];
       const auto& from_ts = tablet_meta.leader_uuid;
       const auto& to_ts = state_->pending_stepdown_leader_tasks_[table_uuid][tablet_id];
@@ -442,7 +498,7 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
+    double load = state_->GetLoad(uuid);
     out << uuid << ":" << load << " ";
   }
   VLOG(1) << out.str();
@@ -479,7 +535,7 @@ Result<bool> ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
@@ -514,7 +570,7 @@ Result<bool> ClusterLoadBalancer::ShouldSkipLeaderAsVictim(const TabletId& table
   {
     auto l = tablet->table()->LockForRead();
     // If we have a custom per-table placement policy, use that.
-    if (l->data().pb.has_replication_info()) {
+    if (l->data().pb.replication_info().has_live_replicas()) {
       num_replicas = l->data().pb.replication_info().live_replicas().num_replicas();
     } else {
       // Otherwise, default to cluster policy.
@@ -556,8 +612,13 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  const double load_variance = state_->GetLoad(from_ts) - state_->GetLoad(to_ts);
   for (const auto& tablet_id : non_over_replicated_tablets) {
     const auto& placement_info = GetPlacementByTablet(tablet_id);
+    // Skip tablets so hot or large that moving them would just swap which TS is overloaded.
+    if (2 * state_->GetTabletWeight(tablet_id) > load_variance) {
+      continue;
+    }
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
     // leaving us with more than the minimum.
     //
@@ -584,6 +645,11 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
 
 Result<bool> ClusterLoadBalancer::GetLeaderToMove(
     TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId *to_ts) {
+  // Getting leaders into the preferred zones takes priority over balancing them.
+  if (VERIFY_RESULT(GetLeaderToMoveToAffinitizedZone(moving_tablet_id, from_ts, to_ts))) {
+    return true;
+  }
+
   if (state_->sorted_leader_load_.empty() ||
       state_->IsLeaderLoadBelowThreshold(state_->sorted_leader_load_.back())) {
     return false;
@@ -616,7 +682,7 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
+      double load_variance =
           state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
@@ -639,29 +705,16 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
       for (const auto& tablet_id : intersection) {
+        // Do not move a leader that would just make the lower loaded TS the higher loaded one.
+        if (2 * state_->GetTabletWeight(tablet_id) > load_variance) {
+          continue;
+        }
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
 
-        const auto& per_tablet_meta = state_->per_tablet_meta_;
-        const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
-        if (PREDICT_TRUE(tablet_meta_iter != per_tablet_meta.end())) {
-          const auto& tablet_meta = tablet_meta_iter->second;
-          const auto& stepdown_failures = tablet_meta.leader_stepdown_failures;
-          const auto stepdown_failure_iter = stepdown_failures.find(low_load_uuid);
-          if (stepdown_failure_iter != stepdown_failures.end()) {
-            const auto time_since_failure = current_time - stepdown_failure_iter->second;
-            if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
-              LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
-                        << *from_ts << " to TS " << *to_ts << " yet: previous attempt with the same"
-                        << " intended leader failed only " << ToString(time_since_failure)
-                        << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
-                        << "ms).";
-            }
-            continue;
-          }
-        } else {
-          LOG(WARNING) << "Did not find load balancer metadata for tablet " << *moving_tablet_id;
+        if (HasRecentLeaderStepDownFailure(tablet_id, low_load_uuid, current_time)) {
+          continue;
         }
         return true;
       }
@@ -672,6 +725,50 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
   FATAL_ERROR("Load balancing algorithm reached invalid state!");
 }
 
+Result<bool> ClusterLoadBalancer::GetLeaderToMoveToAffinitizedZone(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto current_time = MonoTime::Now();
+  for (const auto& non_affinitized_uuid : state_->non_affinitized_servers_) {
+    for (const auto& tablet_id : state_->per_ts_meta_[non_affinitized_uuid].leaders) {
+      // sorted_leader_load_ is sorted ascending, so the least loaded candidate is found first.
+      for (const auto& affinitized_uuid : state_->sorted_leader_load_) {
+        if (state_->per_ts_meta_[affinitized_uuid].running_tablets.count(tablet_id) == 0 ||
+            HasRecentLeaderStepDownFailure(tablet_id, affinitized_uuid, current_time)) {
+          continue;
+        }
+        *moving_tablet_id = tablet_id;
+        *from_ts = non_affinitized_uuid;
+        *to_ts = affinitized_uuid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ClusterLoadBalancer::HasRecentLeaderStepDownFailure(
+    const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime current_time) const {
+  const auto& per_tablet_meta = state_->per_tablet_meta_;
+  const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
+  if (PREDICT_FALSE(tablet_meta_iter == per_tablet_meta.end())) {
+    LOG(WARNING) << "Did not find load balancer metadata for tablet " << tablet_id;
+    return false;
+  }
+  const auto& stepdown_failures = tablet_meta_iter->second.leader_stepdown_failures;
+  const auto stepdown_failure_iter = stepdown_failures.find(to_ts);
+  if (stepdown_failure_iter == stepdown_failures.end()) {
+    return false;
+  }
+  const auto time_since_failure = current_time - stepdown_failure_iter->second;
+  if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
+    LOG(INFO) << "Cannot move tablet " << tablet_id << " leader to TS " << to_ts
+              << " yet: previous attempt with the same intended leader failed only "
+              << ToString(time_since_failure) << " ago (less than "
+              << FLAGS_min_leader_stepdown_retry_interval_ms << "ms).";
+  }
+  return true;
+}
+
 Result<bool> ClusterLoadBalancer::HandleRemoveReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts) {
   // Give high priority to removing tablets that are not respecting the placement policy.
@@ -830,11 +927,34 @@ const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
   return l->data().pb.replication_info().live_replicas();
 }
 
+const ReplicationInfoPB& ClusterLoadBalancer::GetClusterReplicationInfo() const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  return l->data().pb.replication_info();
+}
+
 const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
   return l->data().pb.server_blacklist();
 }
 
+void ClusterLoadBalancer::GetAffinitizedZones(const TableId& table_uuid,
+                                              AffinitizedZonesSet* affinitized_zones) const {
+  const auto table = GetTableInfo(table_uuid);
+  if (table) {
+    auto l = table->LockForRead();
+    for (const auto& cloud_info : l->data().pb.replication_info().affinitized_leaders()) {
+      affinitized_zones->insert(cloud_info);
+    }
+  }
+  if (!affinitized_zones->empty()) {
+    return;
+  }
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  for (const auto& cloud_info : l->data().pb.replication_info().affinitized_leaders()) {
+    affinitized_zones->insert(cloud_info);
+  }
+}
+
 bool ClusterLoadBalancer::SkipLoadBalancing(const TableInfo& table) const {
   // Skip load-balancing of system tables. They are virtual tables not hosted by tservers.
   return catalog_manager_->IsSystemTable(table);
@@ -896,6 +1016,9 @@ void ClusterLoadBalancer::SendReplicaChanges(
 }
 
 consensus::RaftPeerPB::MemberType ClusterLoadBalancer::GetDefaultMemberType() {
+  if (state_->options_ && state_->options_->type == ReplicaType::kReadOnly) {
+    return consensus::RaftPeerPB::PRE_OBSERVER;
+  }
   return consensus::RaftPeerPB::PRE_VOTER;
 }
 
@@ -106,9 +106,18 @@ class ClusterLoadBalancer {
   // Get the placement information from the cluster configuration.
   virtual const PlacementInfoPB& GetClusterPlacementInfo() const;
 
+  // Get the replication information from the cluster configuration, including the read replica
+  // clusters.
+  virtual const ReplicationInfoPB& GetClusterReplicationInfo() const;
+
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
+  // Get the preferred leader zones for the given table: the table level ones if it has any,
+  // otherwise the cluster level ones.
+  virtual void GetAffinitizedZones(const TableId& table_uuid,
+                                   AffinitizedZonesSet* affinitized_zones) const;
+
   // Should skip load-balancing of this table?
   virtual bool SkipLoadBalancing(const TableInfo& table) const;
 
@@ -134,13 +143,17 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
-  // Returns default member type for newly created replicas (PRE_VOTER).
+  // Returns default member type for newly created replicas: PRE_VOTER, or PRE_OBSERVER when
+  // balancing a read replica cluster.
   virtual consensus::RaftPeerPB::MemberType GetDefaultMemberType();
 
   //
   // Higher level methods and members.
   //
 
+  // Balances the replicas of the cluster described by options over all tables.
+  void RunLoadBalancerWithOptions(Options* options);
+
   // Recreates the ClusterLoadState object.
   virtual void ResetState();
 
@@ -217,6 +230,19 @@ class ClusterLoadBalancer {
   Result<bool> GetLeaderToMove(
       TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Find a leader on a tablet server outside of the preferred leader zones that has a running
+  // replica on a tablet server inside them, picking the least leader loaded one.
+  //
+  // Returns true if we could find such a leader and sets the three output parameters.
+  // Returns false otherwise.
+  Result<bool> GetLeaderToMoveToAffinitizedZone(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Returns true if a previous attempt to move the leader of the given tablet to to_ts failed, in
+  // which case we should not try that move again yet.
+  bool HasRecentLeaderStepDownFailure(
+      const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime current_time) const;
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   CHECKED_STATUS MoveReplica(
@@ -240,6 +266,9 @@ class ClusterLoadBalancer {
 
   const PlacementInfoPB& GetPlacementByTablet(const TabletId& tablet_id) const;
 
+  // Returns the placement of the read replica cluster with the given placement uuid.
+  const PlacementInfoPB& GetReadReplicaPlacementInfo(const std::string& placement_uuid) const;
+
   // Get access to all the tablets for the given table.
   const CHECKED_STATUS GetTabletsForTable(const TableId& table_uuid,
                                   vector<scoped_refptr<TabletInfo>>* tablets) const;
@@ -36,8 +36,17 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     return replication_info_.live_replicas();
   }
 
+  const ReplicationInfoPB& GetClusterReplicationInfo() const override {
+    return replication_info_;
+  }
+
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
+  void GetAffinitizedZones(const TableId& table_uuid,
+                           AffinitizedZonesSet* affinitized_zones) const override {
+    *affinitized_zones = affinitized_zones_;
+  }
+
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
                           const bool is_add, const bool should_remove,
                           const TabletServerId& new_leader_uuid) override {
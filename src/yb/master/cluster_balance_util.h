@@ -48,6 +48,10 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_double(load_balancer_tablet_ops_weight);
+
+DECLARE_double(load_balancer_tablet_size_weight_per_gb);
+
 namespace yb {
 namespace master {
 
@@ -116,6 +120,10 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Load that one replica of this tablet puts on its tablet server, computed from the metrics
+  // reported by the tablet leader.
+  double weight = 1.0;
+
   std::string ToString() const {
     return Format("{ running: $0 starting: $1 is_under_replicated: $2 "
                       "under_replicated_placements: $3 is_over_replicated: $4 "
@@ -143,9 +151,27 @@ struct CBTabletServerMetadata {
   std::set<TabletId> leaders;
 };
 
+// Type of the replicas a run of the load balancer works on. The voters of the live cluster and the
+// observers of each read replica cluster are balanced separately, each over the tablet servers of
+// their own cluster.
+enum class ReplicaType {
+  kLive,
+  kReadOnly,
+};
+
 struct Options {
   Options() {}
   virtual ~Options() {}
+
+  ReplicaType type = ReplicaType::kLive;
+
+  // Placement uuid of the cluster being balanced.
+  std::string placement_uuid;
+
+  // Placement uuids of all read replica clusters. Used to tell their tablet servers apart from the
+  // live ones when the live cluster has no placement uuid.
+  std::set<std::string> read_replica_placement_uuids;
+
   // If variance between load on TS goes past this number, we should try to balance.
   double kMinLoadVarianceToBalance = 2.0;
 
@@ -187,8 +213,8 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetLoad(a);
+    double load_b = GetLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -224,19 +250,48 @@ class ClusterLoadState {
     ClusterLoadState* state_;
   };
 
-  // Get the load for a certain TS.
-  int GetLoad(const TabletServerId& ts_uuid) const {
+  // Get the load for a certain TS, as the sum of the weights of the tablets it hosts.
+  double GetLoad(const TabletServerId& ts_uuid) const {
     const auto& ts_meta = per_ts_meta_.at(ts_uuid);
-    return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    double load = 0;
+    for (const auto& tablet_id : ts_meta.starting_tablets) {
+      load += GetTabletWeight(tablet_id);
+    }
+    for (const auto& tablet_id : ts_meta.running_tablets) {
+      load += GetTabletWeight(tablet_id);
+    }
+    return load;
   }
 
-  // Get the load for a certain TS.
-  int GetLeaderLoad(const TabletServerId& ts_uuid) const {
-    return per_ts_meta_.at(ts_uuid).leaders.size();
+  // Get the leader load for a certain TS, as the sum of the weights of the tablets it leads.
+  double GetLeaderLoad(const TabletServerId& ts_uuid) const {
+    double load = 0;
+    for (const auto& tablet_id : per_ts_meta_.at(ts_uuid).leaders) {
+      load += GetTabletWeight(tablet_id);
+    }
+    return load;
+  }
+
+  // Get the weight of a tablet, 1 for tablets we have no metrics for.
+  double GetTabletWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it == per_tablet_meta_.end() ? 1.0 : it->second.weight;
+  }
+
+  // Compute the weight of a tablet from the load last reported by its leader.
+  static double ComputeTabletWeight(const TabletMetricsPB& metrics) {
+    const double ops = metrics.read_ops_per_sec() + metrics.write_ops_per_sec();
+    const double size_gb = static_cast<double>(metrics.sst_file_size()) / (1024 * 1024 * 1024);
+    return 1.0 + FLAGS_load_balancer_tablet_ops_weight * ops +
+           FLAGS_load_balancer_tablet_size_weight_per_gb * size_gb;
   }
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  void SetAffinitizedZones(const AffinitizedZonesSet& affinitized_zones) {
+    affinitized_zones_ = affinitized_zones;
+  }
+
   // Update the per-tablet information for this tablet.
   Status UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -246,9 +301,18 @@ class ClusterLoadState {
     // Get the placement for this tablet.
     const auto& placement = placement_by_table_[tablet->table()->id()];
 
-    // Get replicas for this tablet.
+    tablet_meta.weight = ComputeTabletWeight(tablet->reported_metrics());
+
+    // Get replicas for this tablet, only those of the cluster being balanced count.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
+    for (auto it = replica_map.begin(); it != replica_map.end();) {
+      if (IsReplicaOfBalancedCluster(it->second)) {
+        ++it;
+      } else {
+        it = replica_map.erase(it);
+      }
+    }
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -291,6 +355,11 @@ class ClusterLoadState {
       if (blacklisted_servers_.count(ts_uuid)) {
         tablet_meta.blacklisted_tablet_servers.insert(ts_uuid);
       }
+
+      // A voter on a read replica server, or the other way around, should be moved away.
+      if (!IsTsInBalancedCluster(*ts_meta_it->second.descriptor)) {
+        tablet_meta.wrong_placement_tablet_servers.insert(ts_uuid);
+      }
     }
 
     // Only set the over-replication section if we need to.
@@ -377,6 +446,11 @@ class ClusterLoadState {
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
 
+    // Servers of other clusters are only tracked for the replicas that have to be moved off them.
+    if (!IsTsInBalancedCluster(*ts_desc)) {
+      return;
+    }
+
     sorted_load_.push_back(ts_uuid);
 
     // Mark as blacklisted if it matches.
@@ -394,7 +468,13 @@ class ClusterLoadState {
     if (!is_blacklisted &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
         FLAGS_leader_balance_unresponsive_timeout_ms) {
-      sorted_leader_load_.push_back(ts_uuid);
+      // With preferred leader zones, only the servers in those zones take part in leader
+      // balancing, and the leaders on the other servers are moved into them.
+      if (affinitized_zones_.empty() || IsInAffinitizedZone(*ts_desc)) {
+        sorted_leader_load_.push_back(ts_uuid);
+      } else {
+        non_affinitized_servers_.push_back(ts_uuid);
+      }
     }
 
     if (ts_desc->HasTabletDeletePending()) {
@@ -578,7 +658,8 @@ class ClusterLoadState {
 
   inline bool IsLeaderLoadBelowThreshold(const TabletServerId& ts_uuid) {
     return ((leader_balance_threshold_ > 0) &&
-            (GetLeaderLoad(ts_uuid) <= leader_balance_threshold_));
+            (static_cast<int>(per_ts_meta_.at(ts_uuid).leaders.size()) <=
+                 leader_balance_threshold_));
   }
 
   void AdjustLeaderBalanceThreshold() {
@@ -597,6 +678,37 @@ class ClusterLoadState {
     }
   }
 
+  bool IsInAffinitizedZone(const TSDescriptor& ts_desc) const {
+    for (const auto& cloud_info : affinitized_zones_) {
+      if (ts_desc.MatchesCloudInfo(cloud_info)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool IsTsInBalancedCluster(const TSDescriptor& ts_desc) const {
+    if (!options_) {
+      return true;
+    }
+    const auto placement_uuid = ts_desc.placement_uuid();
+    if (options_->type == ReplicaType::kReadOnly || !options_->placement_uuid.empty()) {
+      return placement_uuid == options_->placement_uuid;
+    }
+    return options_->read_replica_placement_uuids.count(placement_uuid) == 0;
+  }
+
+  // Observers belong to the read replica cluster of their tablet server, all other replicas to the
+  // live cluster.
+  bool IsReplicaOfBalancedCluster(const TabletReplica& replica) const {
+    const bool is_observer = replica.member_type == consensus::RaftPeerPB::OBSERVER ||
+                             replica.member_type == consensus::RaftPeerPB::PRE_OBSERVER;
+    if (!options_ || options_->type == ReplicaType::kLive) {
+      return !is_observer;
+    }
+    return is_observer && replica.ts_desc->placement_uuid() == options_->placement_uuid;
+  }
+
   virtual void GetReplicaLocations(TabletInfo* tablet, TabletInfo::ReplicaMap* replica_locations) {
     tablet->GetReplicaLocations(replica_locations);
   }
@@ -657,6 +769,13 @@ class ClusterLoadState {
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
 
+  // The preferred leader zones of the table being balanced, empty if leaders can go anywhere.
+  AffinitizedZonesSet affinitized_zones_;
+
+  // Responsive tablet servers outside of the preferred leader zones, whose leaders should be moved
+  // to the servers in sorted_leader_load_.
+  vector<TabletServerId> non_affinitized_servers_;
+
   unordered_map<TableId, TabletToTabletServerMap> pending_add_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
@@ -665,7 +784,7 @@ class ClusterLoadState {
   MonoTime current_time_;
 
   // The knobs we use for tweaking the flow of the algorithm.
-  Options* options_;
+  Options* options_ = nullptr;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadState);
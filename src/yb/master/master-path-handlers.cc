@@ -437,6 +437,17 @@ void MasterPathHandlers::HandleTablePage(const Webserver::WebRequest& req,
             << state
             << EscapeForHtmlToString(l->data().pb.state_msg())
             << "</td></tr>\n";
+    if (l->data().pb.has_backfill()) {
+      const auto& backfill = l->data().pb.backfill();
+      *output << "  <tr><td>Index backfill:</td><td>";
+      if (backfill.has_failure()) {
+        *output << EscapeForHtmlToString(
+            "Failed: " + StatusFromPB(backfill.failure()).ToString());
+      } else {
+        *output << "In progress";
+      }
+      *output << "</td></tr>\n";
+    }
     *output << "</table>\n";
 
     SchemaFromPB(l->data().pb.schema(), &schema);
@@ -901,6 +912,27 @@ void MasterPathHandlers::HandleGetClusterConfig(
   << "<pre class=\"prettyprint\">" << config.DebugString() << "</pre>";
 }
 
+void MasterPathHandlers::HandleSysCatalogLoad(
+  const Webserver::WebRequest& req, stringstream* output) {
+  *output << "<h1>Sys Catalog Load</h1>\n";
+  auto phases = master_->catalog_manager()->GetSysCatalogLoadPhases();
+  if (phases.empty()) {
+    *output << "<div class=\"alert alert-warning\">The sys catalog has not been loaded.</div>";
+    return;
+  }
+
+  MonoDelta total = MonoDelta::FromNanoseconds(0);
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Phase</th><th>Entries</th><th>Time</th></tr>\n";
+  for (const auto& phase : phases) {
+    *output << Substitute("  <tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                          EscapeForHtmlToString(phase.name), phase.num_entries,
+                          phase.duration.ToString());
+    total += phase.duration;
+  }
+  *output << Substitute("  <tr><th>Total</th><td></td><th>$0</th></tr>\n", total.ToString());
+  *output << "</table>\n";
+}
 
 Status MasterPathHandlers::Register(Webserver* server) {
   bool is_styled = true;
@@ -940,6 +972,11 @@ Status MasterPathHandlers::Register(Webserver* server) {
       "/cluster-config", "Cluster Config",
       std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
       false);
+  cb = std::bind(&MasterPathHandlers::HandleSysCatalogLoad, this, _1, _2);
+  server->RegisterPathHandler(
+      "/sys-catalog-load", "Sys Catalog Load",
+      std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
+      false);
   return Status::OK();
 }
 
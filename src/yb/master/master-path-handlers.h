@@ -109,6 +109,7 @@ class MasterPathHandlers {
   void HandleDumpEntities(const Webserver::WebRequest& req,
                           std::stringstream* output);
   void HandleGetClusterConfig(const Webserver::WebRequest& req, std::stringstream* output);
+  void HandleSysCatalogLoad(const Webserver::WebRequest& req, std::stringstream* output);
 
   // Checks if the table is system managed table (including redis table).
   bool IsSystemTable(const TableInfo& table);
@@ -42,6 +42,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master-test-util.h"
 #include "yb/master/call_home.h"
+#include "yb/master/catalog_manager.h"
 #include "yb/master/master.h"
 #include "yb/master/master.proxy.h"
 #include "yb/master/mini_master.h"
@@ -66,6 +67,7 @@ DECLARE_string(callhome_tag);
 DECLARE_string(callhome_url);
 DECLARE_bool(catalog_manager_check_ts_count_for_create_table);
 DECLARE_double(leader_failure_max_missed_heartbeat_periods);
+DECLARE_int64(tablet_split_size_threshold_bytes);
 
 #define NAMESPACE_ENTRY(namespace) \
     std::make_tuple(k##namespace##NamespaceName, k##namespace##NamespaceId)
@@ -491,6 +493,74 @@ Status MasterTest::DeleteTable(const NamespaceName& namespace_name,
   return Status::OK();
 }
 
+TEST_F(MasterTest, TestTabletSplitCandidates) {
+  FLAGS_tablet_split_size_threshold_bytes = 1000;
+  const char *kTableName = "testtb";
+  const Schema kTableSchema({ ColumnSchema("key", INT32) }, 1);
+  ASSERT_OK(CreateTable(kTableName, kTableSchema));
+
+  auto table = mini_master_->master()->catalog_manager()->
+      GetTableInfoFromNamespaceNameAndTableName(default_namespace_name, kTableName);
+  ASSERT_TRUE(table != nullptr);
+  TabletInfos tablets;
+  table->GetAllTablets(&tablets);
+  ASSERT_GE(tablets.size(), 2);
+
+  TSToMasterCommonPB common;
+  common.mutable_ts_instance()->set_permanent_uuid("my-ts-uuid");
+  common.mutable_ts_instance()->set_instance_seqno(1);
+  TSRegistrationPB fake_reg;
+  MakeHostPortPB("localhost", 1000, fake_reg.mutable_common()->add_private_rpc_addresses());
+  MakeHostPortPB("localhost", 2000, fake_reg.mutable_common()->add_http_addresses());
+
+  // The leader of the first tablet reports a size above the threshold, and of the second below.
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    req.mutable_registration()->CopyFrom(fake_reg);
+    auto* metrics = req.add_tablet_metrics();
+    metrics->set_tablet_id(tablets[0]->tablet_id());
+    metrics->set_sst_file_size(2000);
+    metrics = req.add_tablet_metrics();
+    metrics->set_tablet_id(tablets[1]->tablet_id());
+    metrics->set_sst_file_size(500);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.needs_reregister());
+  }
+
+  {
+    ListTabletSplitCandidatesRequestPB req;
+    ListTabletSplitCandidatesResponsePB resp;
+    ASSERT_OK(proxy_->ListTabletSplitCandidates(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+    ASSERT_EQ(1, resp.candidates_size());
+    ASSERT_EQ(tablets[0]->tablet_id(), resp.candidates(0).tablet_id());
+    ASSERT_EQ(table->id(), resp.candidates(0).table_id());
+    ASSERT_EQ(kTableName, resp.candidates(0).table_name());
+    ASSERT_EQ(2000, resp.candidates(0).sst_file_size());
+  }
+
+  // Once the tablet is reported below the threshold again, it is no longer a candidate.
+  {
+    TSHeartbeatRequestPB req;
+    TSHeartbeatResponsePB resp;
+    req.mutable_common()->CopyFrom(common);
+    auto* metrics = req.add_tablet_metrics();
+    metrics->set_tablet_id(tablets[0]->tablet_id());
+    metrics->set_sst_file_size(900);
+    ASSERT_OK(proxy_->TSHeartbeat(req, &resp, ResetAndGetController()));
+  }
+
+  {
+    ListTabletSplitCandidatesRequestPB req;
+    ListTabletSplitCandidatesResponsePB resp;
+    ASSERT_OK(proxy_->ListTabletSplitCandidates(req, &resp, ResetAndGetController()));
+    ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+    ASSERT_EQ(0, resp.candidates_size());
+  }
+}
+
 TEST_F(MasterTest, TestCatalog) {
   const char *kTableName = "testtb";
   const char *kOtherTableName = "tbtest";
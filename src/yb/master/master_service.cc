@@ -45,6 +45,7 @@
 #include "yb/master/master.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
+#include "yb/rpc/inbound_call.h"
 #include "yb/server/webserver.h"
   #include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
@@ -87,6 +88,12 @@ MasterServiceImpl::MasterServiceImpl(Master* server)
     MasterServiceBase(server) {
 }
 
+// Delayed heartbeats could make the master consider tablet servers dead.
+rpc::CallPriority MasterServiceImpl::GetCallPriority(const rpc::InboundCall& call) {
+  return call.method_name() == "TSHeartbeat" ? rpc::CallPriority::kConsensus
+                                             : rpc::CallPriority::kLatencySensitive;
+}
+
 void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
                                     TSHeartbeatResponsePB* resp,
                                     RpcContext rpc) {
@@ -172,6 +179,10 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     ts_desc->UpdateMetrics(req->metrics());
   }
 
+  if (req->tablet_metrics_size() > 0) {
+    server_->catalog_manager()->ProcessTabletMetrics(req->tablet_metrics());
+  }
+
   if (req->has_tablet_report()) {
     s = server_->catalog_manager()->ProcessTabletReport(
       ts_desc.get(), req->tablet_report(), resp->mutable_tablet_report(), &rpc);
@@ -191,6 +202,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
   for (const auto& desc : descs) {
     desc->GetTSInformationPB(resp->add_tservers());
   }
+  resp->set_tablet_locations_version(server_->catalog_manager()->tablet_locations_version());
 
   rpc.RespondSuccess();
 }
@@ -293,6 +305,18 @@ void MasterServiceImpl::IsAlterTableDone(const IsAlterTableDoneRequestPB* req,
 void MasterServiceImpl::ListTables(const ListTablesRequestPB* req,
                                    ListTablesResponsePB* resp,
                                    RpcContext rpc) {
+  if (req->max_follower_staleness_ms() > 0) {
+    CatalogManager::ScopedLeaderSharedLock l(server_->catalog_manager());
+    if (!l.CheckIsInitializedOrRespond(resp, &rpc)) {
+      return;
+    }
+    if (!l.leader_status().ok()) {
+      Status s = server_->catalog_manager()->ListTablesOnFollower(req, resp);
+      CheckRespErrorOrSetUnknown(s, resp);
+      rpc.RespondSuccess();
+      return;
+    }
+  }
   HandleIn(req, resp, &rpc, &CatalogManager::ListTables);
 }
 
@@ -598,6 +622,12 @@ void MasterServiceImpl::AreLeadersOnPreferredOnly(
   HandleIn(req, resp, &rpc, &CatalogManager::AreLeadersOnPreferredOnly);
 }
 
+void MasterServiceImpl::ListTabletSplitCandidates(
+    const ListTabletSplitCandidatesRequestPB* req, ListTabletSplitCandidatesResponsePB* resp,
+    RpcContext rpc) {
+  HandleIn(req, resp, &rpc, &CatalogManager::ListTabletSplitCandidates);
+}
+
 void MasterServiceImpl::FlushTables(const FlushTablesRequestPB* req,
                                     FlushTablesResponsePB* resp,
                                     RpcContext rpc) {
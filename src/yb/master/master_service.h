@@ -53,6 +53,8 @@ class MasterServiceImpl : public MasterServiceIf,
                            TSHeartbeatResponsePB* resp,
                            rpc::RpcContext rpc) override;
 
+  rpc::CallPriority GetCallPriority(const rpc::InboundCall& call) override;
+
   virtual void GetTabletLocations(const GetTabletLocationsRequestPB* req,
                                   GetTabletLocationsResponsePB* resp,
                                   rpc::RpcContext rpc) override;
@@ -196,6 +198,10 @@ class MasterServiceImpl : public MasterServiceIf,
       const AreLeadersOnPreferredOnlyRequestPB* req, AreLeadersOnPreferredOnlyResponsePB* resp,
       rpc::RpcContext rpc) override;
 
+  virtual void ListTabletSplitCandidates(
+      const ListTabletSplitCandidatesRequestPB* req, ListTabletSplitCandidatesResponsePB* resp,
+      rpc::RpcContext rpc) override;
+
   virtual void FlushTables(
       const FlushTablesRequestPB* req, FlushTablesResponsePB* resp,
       rpc::RpcContext rpc) override;
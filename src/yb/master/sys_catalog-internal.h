@@ -32,7 +32,11 @@ class VisitorBase {
 
   virtual CHECKED_STATUS Visit(Slice id, Slice data) = 0;
 
+  // Number of entries visited so far.
+  int64_t num_visited() const { return num_visited_; }
+
  protected:
+  int64_t num_visited_ = 0;
 };
 
 template <class PersistentDataEntryClass>
@@ -47,6 +51,7 @@ class Visitor : public VisitorBase {
         pb_util::ParseFromArray(&metadata, data.data(), data.size()),
         "Unable to parse metadata field for item id: " + id.ToBuffer());
 
+    ++num_visited_;
     return Visit(id.ToBuffer(), metadata);
   }
 
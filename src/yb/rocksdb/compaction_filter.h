@@ -130,6 +130,11 @@ class CompactionFilter {
   // using a snapshot.
   virtual bool IgnoreSnapshots() const { return false; }
 
+  // Returns true if keys removed by Filter() never have other versions, i.e. entries with the same
+  // user key and smaller sequence numbers, in other files. Such keys are dropped from the output
+  // instead of being replaced with deletion markers.
+  virtual bool RemovedKeysAreUnique() const { return false; }
+
   // Returns a name that identifies this compaction filter.
   // The name will be printed to LOG file on start up for diagnosis.
   virtual const char* Name() const = 0;
@@ -146,6 +151,19 @@ class CompactionFilterFactory {
 
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
+
+  // Returns prefix of user_key shared by all keys that should be processed by the same compaction
+  // filter, e.g. keys of the same document. Key ranges of subcompactions start at such prefixes,
+  // so a compaction filter that tracks state across keys always sees all of them.
+  virtual Slice GetSubcompactionBoundary(const Slice& user_key) const {
+    return user_key;
+  }
+
+  // Whether memtable flushes should also pass their output through a compaction filter created by
+  // this factory. Such a filter is created as for a minor automatic compaction.
+  virtual bool FilterOnFlush() const {
+    return false;
+  }
 };
 
 }  // namespace rocksdb
@@ -393,6 +393,16 @@ class DB {
     //      pending; otherwise, returns 0.
     static const std::string kCompactionPending;
 
+    //  "rocksdb.compaction-urgency-score" - returns urgency of compacting the
+    //      column family, multiplied by 100, see
+    //      VersionStorageInfo::CompactionUrgencyScore.
+    static const std::string kCompactionUrgencyScore;
+
+    //  "rocksdb.l0-delay-trigger-count" - returns the number of level 0 files
+    //      (sorted runs for universal compaction) that is compared with
+    //      level0_slowdown_writes_trigger and level0_stop_writes_trigger.
+    static const std::string kL0DelayTriggerCount;
+
     //  "rocksdb.num-running-compactions" - returns the number of currently
     //      running compactions.
     static const std::string kNumRunningCompactions;
@@ -786,6 +796,11 @@ class DB {
   virtual uint64_t GetTotalSSTFileSize() { return 0; }
   virtual uint64_t GetUncompressedSSTFileSize() { return 0; }
 
+  // Closes the SST table readers that no read is using at the moment, if no read was started
+  // since the previous call. Closed readers are opened again on the next access. Does nothing when
+  // max_open_files is -1, since all table readers are pinned then.
+  virtual void CloseTableReadersIfIdle() {}
+
   // Returns a list of all table files with their level, start key
   // and end key
   virtual void GetLiveFilesMetaData(std::vector<LiveFileMetaData>* /*metadata*/) {}
@@ -0,0 +1,314 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/db/blob_file.h"
+
+#include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/db/version_edit.h"
+#include "yb/rocksdb/table/internal_iterator.h"
+#include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr size_t kBlobChecksumSize = sizeof(uint32_t);
+
+class BlobIndexResolvingIterator : public InternalIterator {
+ public:
+  BlobIndexResolvingIterator(InternalIterator* iter, BlobFileCache* blob_file_cache,
+                             bool arena_mode)
+      : iter_(iter), blob_file_cache_(blob_file_cache), arena_mode_(arena_mode) {}
+
+  ~BlobIndexResolvingIterator() {
+    if (arena_mode_) {
+      iter_->~InternalIterator();
+    } else {
+      delete iter_;
+    }
+  }
+
+  bool Valid() const override { return iter_->Valid() && status_.ok(); }
+
+  void SeekToFirst() override {
+    iter_->SeekToFirst();
+    UpdateCurrent();
+  }
+
+  void SeekToLast() override {
+    iter_->SeekToLast();
+    UpdateCurrent();
+  }
+
+  void Seek(const Slice& target) override {
+    iter_->Seek(target);
+    UpdateCurrent();
+  }
+
+  void Next() override {
+    iter_->Next();
+    UpdateCurrent();
+  }
+
+  void Prev() override {
+    iter_->Prev();
+    UpdateCurrent();
+  }
+
+  Slice key() const override { return is_blob_ ? Slice(key_) : iter_->key(); }
+
+  Slice value() const override { return is_blob_ ? Slice(value_) : iter_->value(); }
+
+  Status status() const override { return status_.ok() ? iter_->status() : status_; }
+
+  Status PinData() override { return iter_->PinData(); }
+
+  Status ReleasePinnedData() override { return iter_->ReleasePinnedData(); }
+
+  bool IsKeyPinned() const override { return !is_blob_ && iter_->IsKeyPinned(); }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(std::move(prop_name), prop);
+  }
+
+ private:
+  void UpdateCurrent() {
+    is_blob_ = false;
+    status_ = Status::OK();
+    if (!iter_->Valid()) {
+      return;
+    }
+    const Slice key = iter_->key();
+    if (ExtractValueType(key) != kTypeBlobIndex) {
+      return;
+    }
+    status_ = blob_file_cache_->Get(iter_->value(), &value_);
+    if (!status_.ok()) {
+      return;
+    }
+    uint64_t sequence;
+    ValueType type;
+    UnPackSequenceAndType(DecodeFixed64(key.cdata() + key.size() - 8), &sequence, &type);
+    key_.assign(key.cdata(), key.size() - 8);
+    PutFixed64(&key_, PackSequenceAndType(sequence, kTypeValue));
+    is_blob_ = true;
+  }
+
+  InternalIterator* const iter_;
+  BlobFileCache* const blob_file_cache_;
+  const bool arena_mode_;
+  bool is_blob_ = false;
+  Status status_;
+  std::string key_;
+  std::string value_;
+};
+
+} // namespace
+
+InternalIterator* NewBlobIndexResolvingIterator(
+    InternalIterator* iter, BlobFileCache* blob_file_cache, Arena* arena) {
+  if (arena == nullptr) {
+    return new BlobIndexResolvingIterator(iter, blob_file_cache, false /* arena_mode */);
+  }
+  auto mem = arena->AllocateAligned(sizeof(BlobIndexResolvingIterator));
+  return new (mem) BlobIndexResolvingIterator(iter, blob_file_cache, true /* arena_mode */);
+}
+
+void BlobIndex::EncodeTo(std::string* dst) const {
+  PutVarint64(dst, file_number);
+  PutVarint64(dst, offset);
+  PutVarint64(dst, size);
+}
+
+Status BlobIndex::DecodeFrom(Slice src) {
+  if (!GetVarint64(&src, &file_number) || !GetVarint64(&src, &offset) ||
+      !GetVarint64(&src, &size) || !src.empty()) {
+    return STATUS(Corruption, "Bad blob index");
+  }
+  if (offset < kBlobChecksumSize) {
+    return STATUS_FORMAT(Corruption, "Bad offset in blob index: $0", offset);
+  }
+  return Status::OK();
+}
+
+BlobFileCache::BlobFileCache(Env* env, std::string dir)
+    : env_(env), dir_(std::move(dir)) {}
+
+Status BlobFileCache::GetReader(uint64_t file_number,
+                                std::shared_ptr<RandomAccessFileReader>* reader) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = readers_.find(file_number);
+    if (it != readers_.end()) {
+      *reader = it->second;
+      return Status::OK();
+    }
+  }
+  if (dir_.empty()) {
+    return STATUS(NotSupported, "Blob files are not supported without a DB path");
+  }
+  std::unique_ptr<RandomAccessFile> file;
+  RETURN_NOT_OK(env_->NewRandomAccessFile(BlobFileName(dir_, file_number), &file, env_options_));
+  auto new_reader = std::make_shared<RandomAccessFileReader>(std::move(file), env_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  *reader = readers_.emplace(file_number, std::move(new_reader)).first->second;
+  return Status::OK();
+}
+
+Status BlobFileCache::Get(const Slice& encoded_blob_index, std::string* value) {
+  BlobIndex blob_index;
+  RETURN_NOT_OK(blob_index.DecodeFrom(encoded_blob_index));
+  return Get(blob_index, value);
+}
+
+Status BlobFileCache::Get(const BlobIndex& blob_index, std::string* value) {
+  std::shared_ptr<RandomAccessFileReader> reader;
+  RETURN_NOT_OK(GetReader(blob_index.file_number, &reader));
+
+  const size_t record_size = kBlobChecksumSize + blob_index.size;
+  std::unique_ptr<char[]> scratch(new char[record_size]);
+  Slice record;
+  RETURN_NOT_OK(reader->Read(
+      blob_index.offset - kBlobChecksumSize, record_size, &record, scratch.get()));
+  if (record.size() != record_size) {
+    return STATUS_FORMAT(Corruption, "Truncated value in blob file $0 at $1",
+                         blob_index.file_number, blob_index.offset);
+  }
+  const uint32_t expected = crc32c::Unmask(DecodeFixed32(record.cdata()));
+  record.remove_prefix(kBlobChecksumSize);
+  if (crc32c::Value(record.cdata(), record.size()) != expected) {
+    return STATUS_FORMAT(Corruption, "Checksum mismatch in blob file $0 at $1",
+                         blob_index.file_number, blob_index.offset);
+  }
+  value->assign(record.cdata(), record.size());
+  return Status::OK();
+}
+
+void BlobFileCache::Evict(uint64_t file_number) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  readers_.erase(file_number);
+}
+
+BlobFileBuilder::BlobFileBuilder(const ImmutableCFOptions& ioptions, const EnvOptions& env_options,
+                                 Env::IOPriority io_priority, uint64_t file_number,
+                                 uint64_t relocate_below)
+    : ioptions_(ioptions),
+      env_options_(env_options),
+      io_priority_(io_priority),
+      file_number_(file_number),
+      relocate_below_(relocate_below),
+      fname_(ioptions.db_paths.empty()
+                 ? std::string() : BlobFileName(ioptions.db_paths[0].path, file_number)) {}
+
+BlobFileBuilder::~BlobFileBuilder() {}
+
+Status BlobFileBuilder::AddToTable(const Slice& key, const Slice& value,
+                                   const Slice* resolved_value, TableBuilder* builder,
+                                   FileMetaData* meta, Slice* table_key) {
+  *table_key = key;
+  const auto type = ExtractValueType(key);
+  if (type == kTypeBlobIndex) {
+    BlobIndex blob_index;
+    RETURN_NOT_OK(blob_index.DecodeFrom(value));
+    if (blob_index.file_number >= relocate_below_) {
+      builder->Add(key, value);
+      meta->blob_files.insert(blob_index.file_number);
+      return Status::OK();
+    }
+    if (resolved_value == nullptr) {
+      RETURN_NOT_OK(ioptions_.blob_file_cache->Get(blob_index, &value_buffer_));
+      return AddValue(key, value_buffer_, builder, meta, table_key);
+    }
+    return AddValue(key, *resolved_value, builder, meta, table_key);
+  }
+  if (type == kTypeValue && ioptions_.min_blob_size > 0 &&
+      value.size() >= ioptions_.min_blob_size) {
+    return AddValue(key, value, builder, meta, table_key);
+  }
+  builder->Add(key, value);
+  return Status::OK();
+}
+
+Status BlobFileBuilder::AddValue(const Slice& key, const Slice& value, TableBuilder* builder,
+                                 FileMetaData* meta, Slice* table_key) {
+  uint64_t sequence;
+  ValueType type;
+  UnPackSequenceAndType(DecodeFixed64(key.cdata() + key.size() - 8), &sequence, &type);
+  key_buffer_.assign(key.cdata(), key.size() - 8);
+
+  // A relocated value could be small enough to be kept in the SST file.
+  if (ioptions_.min_blob_size == 0 || value.size() < ioptions_.min_blob_size) {
+    PutFixed64(&key_buffer_, PackSequenceAndType(sequence, kTypeValue));
+    builder->Add(key_buffer_, value);
+    *table_key = key_buffer_;
+    return Status::OK();
+  }
+
+  if (!writer_) {
+    std::unique_ptr<WritableFile> file;
+    RETURN_NOT_OK(NewWritableFile(ioptions_.env, fname_, &file, env_options_));
+    file->SetIOPriority(io_priority_);
+    writer_.reset(new WritableFileWriter(std::move(file), env_options_));
+  }
+
+  char checksum[kBlobChecksumSize];
+  EncodeFixed32(checksum, crc32c::Mask(crc32c::Value(value.cdata(), value.size())));
+  RETURN_NOT_OK(writer_->Append(Slice(checksum, sizeof(checksum))));
+  BlobIndex blob_index;
+  blob_index.file_number = file_number_;
+  blob_index.offset = writer_->GetFileSize();
+  blob_index.size = value.size();
+  RETURN_NOT_OK(writer_->Append(value));
+
+  blob_index_buffer_.clear();
+  blob_index.EncodeTo(&blob_index_buffer_);
+  PutFixed64(&key_buffer_, PackSequenceAndType(sequence, kTypeBlobIndex));
+  builder->Add(key_buffer_, blob_index_buffer_);
+  meta->blob_files.insert(file_number_);
+  *table_key = key_buffer_;
+  return Status::OK();
+}
+
+Status BlobFileBuilder::Finish() {
+  if (!writer_) {
+    return Status::OK();
+  }
+  Status s = writer_->Flush();
+  if (s.ok() && !ioptions_.disable_data_sync) {
+    s = writer_->Sync(ioptions_.use_fsync);
+  }
+  if (s.ok()) {
+    s = writer_->Close();
+  }
+  return s;
+}
+
+void BlobFileBuilder::Abandon() {
+  if (!writer_) {
+    return;
+  }
+  writer_->Close();
+  writer_.reset();
+  ioptions_.env->DeleteFile(fname_);
+}
+
+uint64_t BlobFileBuilder::file_size() const {
+  return writer_ ? writer_->GetFileSize() : 0;
+}
+
+} // namespace rocksdb
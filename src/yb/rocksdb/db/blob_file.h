@@ -0,0 +1,129 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_DB_BLOB_FILE_H
+#define YB_ROCKSDB_DB_BLOB_FILE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/status.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class Arena;
+struct FileMetaData;
+class InternalIterator;
+class RandomAccessFileReader;
+class TableBuilder;
+class WritableFileWriter;
+
+// Large values are kept in blob files, so compactions that keep them only rewrite references to
+// them. A blob file is written together with an SST file by a flush or a compaction, is named after
+// that SST file and is never modified afterwards, but it outlives the SST file while SST files
+// written later reference values in it. Each value is stored as the masked crc32c of the value
+// followed by the value. SST files store references to values as kTypeBlobIndex entries.
+
+// Reference to a value in a blob file.
+struct BlobIndex {
+  uint64_t file_number = 0;
+  // Offset of the value in the blob file. Its checksum is stored right before it.
+  uint64_t offset = 0;
+  uint64_t size = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(Slice src);
+};
+
+// Readers of blob files, opened on first use and kept until the file is deleted.
+class BlobFileCache {
+ public:
+  BlobFileCache(Env* env, std::string dir);
+
+  // Reads the value referenced by the encoded blob index into value.
+  Status Get(const Slice& encoded_blob_index, std::string* value);
+  Status Get(const BlobIndex& blob_index, std::string* value);
+
+  // Closes the reader of the blob file, should be called when the file is deleted.
+  void Evict(uint64_t file_number);
+
+ private:
+  Status GetReader(uint64_t file_number, std::shared_ptr<RandomAccessFileReader>* reader);
+
+  Env* const env_;
+  const std::string dir_;
+  const EnvOptions env_options_;
+
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, std::shared_ptr<RandomAccessFileReader>> readers_;
+};
+
+// Returns an iterator over entries of iter, which returns kTypeBlobIndex entries as kTypeValue
+// entries with the values they reference. Takes ownership of iter, which should be allocated in
+// arena if it is not null.
+InternalIterator* NewBlobIndexResolvingIterator(
+    InternalIterator* iter, BlobFileCache* blob_file_cache, Arena* arena = nullptr);
+
+// Adds entries to an SST file that is being written by a flush or a compaction, and moves values of
+// at least ImmutableCFOptions::min_blob_size to the blob file of the job. References to values in
+// blob files with numbers below relocate_below are resolved and the values are moved to the new
+// blob file, so old blob files are released even if some of their values are still live.
+class BlobFileBuilder {
+ public:
+  BlobFileBuilder(const ImmutableCFOptions& ioptions, const EnvOptions& env_options,
+                  Env::IOPriority io_priority, uint64_t file_number, uint64_t relocate_below = 0);
+  ~BlobFileBuilder();
+
+  // Adds key and value to builder and records the blob files the entry references in meta.
+  // resolved_value, when not null, is the value referenced by a kTypeBlobIndex entry, so it does
+  // not have to be read again if the value is relocated. The key that was added, which differs from
+  // key in its value type when the value was moved, is returned in table_key and is valid until the
+  // next call.
+  Status AddToTable(const Slice& key, const Slice& value, const Slice* resolved_value,
+                    TableBuilder* builder, FileMetaData* meta, Slice* table_key);
+
+  // Syncs and closes the blob file. Does nothing if no values were written to it.
+  Status Finish();
+
+  // Deletes the blob file.
+  void Abandon();
+
+  bool empty() const { return writer_ == nullptr; }
+  uint64_t file_number() const { return file_number_; }
+  uint64_t file_size() const;
+
+ private:
+  Status AddValue(const Slice& key, const Slice& value, TableBuilder* builder,
+                  FileMetaData* meta, Slice* table_key);
+
+  const ImmutableCFOptions& ioptions_;
+  const EnvOptions& env_options_;
+  const Env::IOPriority io_priority_;
+  const uint64_t file_number_;
+  const uint64_t relocate_below_;
+  const std::string fname_;
+
+  std::unique_ptr<WritableFileWriter> writer_;
+  std::string key_buffer_;
+  std::string value_buffer_;
+  std::string blob_index_buffer_;
+};
+
+} // namespace rocksdb
+
+#endif // YB_ROCKSDB_DB_BLOB_FILE_H
@@ -27,6 +27,8 @@
 #include <deque>
 #include <vector>
 
+#include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db/blob_file.h"
 #include "yb/rocksdb/db/compaction_iterator.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/filename.h"
@@ -57,11 +59,12 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& ioptions,
                               WritableFileWriter* file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters) {
+                              const bool skip_filters,
+                              CompressionDictHolder* compression_dict_holder) {
   return ioptions.table_factory->NewTableBuilder(
       TableBuilderOptions(ioptions, internal_comparator,
                           int_tbl_prop_collector_factories, compression_type,
-                          compression_opts, skip_filters),
+                          compression_opts, skip_filters, compression_dict_holder),
       column_family_id, file);
 }
 
@@ -73,11 +76,12 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& ioptions,
                               WritableFileWriter* data_file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters) {
+                              const bool skip_filters,
+                              CompressionDictHolder* compression_dict_holder) {
   return ioptions.table_factory->NewTableBuilder(
       TableBuilderOptions(ioptions, internal_comparator,
           int_tbl_prop_collector_factories, compression_type,
-          compression_opts, skip_filters),
+          compression_opts, skip_filters, compression_dict_holder),
       column_family_id, metadata_file, data_file);
 }
 
@@ -114,7 +118,8 @@ Status BuildTable(const std::string& dbname,
                   InternalStats* internal_stats,
                   BoundaryValuesExtractor* boundary_values_extractor,
                   const Env::IOPriority io_priority,
-                  TableProperties* table_properties) {
+                  TableProperties* table_properties,
+                  CompressionDictHolder* compression_dict_holder) {
   // Reports the IOStats for flush for every following bytes.
   const size_t kReportFlushIOStatsEvery = 1048576;
   Status s;
@@ -140,7 +145,8 @@ Status BuildTable(const std::string& dbname,
     std::unique_ptr<TableBuilder> builder(NewTableBuilder(
         ioptions, internal_comparator, int_tbl_prop_collector_factories,
         column_family_id, base_file_writer.get(), data_file_writer.get(), compression,
-        compression_opts));
+        compression_opts, false /* skip_filters */, compression_dict_holder));
+    BlobFileBuilder blob_builder(ioptions, env_options, io_priority, meta->fd.GetNumber());
 
     MergeHelper merge(env, internal_comparator->user_comparator(),
                       ioptions.merge_operator, nullptr, ioptions.info_log,
@@ -148,18 +154,37 @@ Status BuildTable(const std::string& dbname,
                       true /* internal key corruption is not ok */,
                       snapshots.empty() ? 0 : snapshots.back());
 
+    std::unique_ptr<CompactionFilter> compaction_filter;
+    if (ioptions.compaction_filter_factory != nullptr &&
+        ioptions.compaction_filter_factory->FilterOnFlush()) {
+      CompactionFilter::Context context;
+      context.is_full_compaction = false;
+      context.is_manual_compaction = false;
+      context.column_family_id = column_family_id;
+      compaction_filter = ioptions.compaction_filter_factory->CreateCompactionFilter(context);
+    }
+
     CompactionIterator c_iter(iter, internal_comparator->user_comparator(),
                               &merge, kMaxSequenceNumber, &snapshots,
                               earliest_write_conflict_snapshot, env,
-                              true /* internal key corruption is not ok */);
+                              true /* internal key corruption is not ok */,
+                              nullptr /* compaction */, compaction_filter.get());
     c_iter.SeekToFirst();
     for (; c_iter.Valid(); c_iter.Next()) {
       const Slice& key = c_iter.key();
       const Slice& value = c_iter.value();
-      builder->Add(key, value);
-      auto boundaries = MakeFileBoundaryValues(boundary_values_extractor, key, value);
+      Slice table_key;
+      s = blob_builder.AddToTable(
+          key, value, nullptr /* resolved_value */, builder.get(), meta, &table_key);
+      if (!s.ok()) {
+        builder->Abandon();
+        blob_builder.Abandon();
+        return s;
+      }
+      auto boundaries = MakeFileBoundaryValues(boundary_values_extractor, table_key, value);
       if (!boundaries) {
         builder->Abandon();
+        blob_builder.Abandon();
         return std::move(boundaries.status());
       }
       auto& boundary_values = *boundaries;
@@ -178,8 +203,13 @@ Status BuildTable(const std::string& dbname,
     s = c_iter.status();
     if (!s.ok() || empty) {
       builder->Abandon();
+      blob_builder.Abandon();
     } else {
-      s = builder->Finish();
+      // Values are written to the blob file before the SST file that references them.
+      s = blob_builder.Finish();
+      if (s.ok()) {
+        s = builder->Finish();
+      }
     }
 
     if (s.ok() && !empty) {
@@ -233,6 +263,10 @@ Status BuildTable(const std::string& dbname,
     if (is_split_sst) {
       env->DeleteFile(data_fname);
     }
+    if (!meta->blob_files.empty()) {
+      env->DeleteFile(BlobFileName(ioptions.db_paths[0].path, meta->fd.GetNumber()));
+      meta->blob_files.clear();
+    }
   }
   return s;
 }
@@ -47,6 +47,7 @@ class Iterator;
 class TableCache;
 class VersionEdit;
 class TableBuilder;
+class CompressionDictHolder;
 class WritableFileWriter;
 class InternalStats;
 class InternalIterator;
@@ -58,7 +59,8 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               WritableFileWriter* file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters = false);
+                              const bool skip_filters = false,
+                              CompressionDictHolder* compression_dict_holder = nullptr);
 
 TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               const InternalKeyComparatorPtr& internal_comparator,
@@ -68,7 +70,8 @@ TableBuilder* NewTableBuilder(const ImmutableCFOptions& options,
                               WritableFileWriter* data_file,
                               const CompressionType compression_type,
                               const CompressionOptions& compression_opts,
-                              const bool skip_filters = false);
+                              const bool skip_filters = false,
+                              CompressionDictHolder* compression_dict_holder = nullptr);
 
 // Build a Table file from the contents of *iter.  The generated file
 // will be named according to number specified in meta. On success, the rest of
@@ -94,7 +97,8 @@ extern Status BuildTable(
     InternalStats* internal_stats,
     BoundaryValuesExtractor* boundary_values_extractor,
     const Env::IOPriority io_priority = Env::IO_HIGH,
-    TableProperties* table_properties = nullptr);
+    TableProperties* table_properties = nullptr,
+    CompressionDictHolder* compression_dict_holder = nullptr);
 
 }  // namespace rocksdb
 
@@ -136,6 +136,13 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
           " is not linked with the binary.");
     }
   }
+  if (cf_options.large_output_size > 0 &&
+      !CompressionTypeSupported(cf_options.large_output_compression)) {
+    return STATUS(InvalidArgument,
+        "Compression type " +
+        CompressionTypeToString(cf_options.large_output_compression) +
+        " is not linked with the binary.");
+  }
   return Status::OK();
 }
 
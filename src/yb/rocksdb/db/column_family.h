@@ -40,6 +40,7 @@
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/table/table_builder.h"
 #include "yb/rocksdb/util/mutable_cf_options.h"
 #include "yb/rocksdb/util/thread_local.h"
 
@@ -294,6 +295,9 @@ class ColumnFamilyData {
     return int_tbl_prop_collector_factories_;
   }
 
+  // thread-safe
+  CompressionDictHolder* compression_dict_holder() { return &compression_dict_holder_; }
+
   SuperVersion* GetSuperVersion() { return super_version_; }
   // thread-safe
   // Return a already referenced SuperVersion to be used safely.
@@ -356,6 +360,9 @@ class ColumnFamilyData {
 
   InternalKeyComparatorPtr internal_comparator_;
   IntTblPropCollectorFactories int_tbl_prop_collector_factories_;
+  // Dictionary for compression of SST files written by flushes and compactions of this column
+  // family.
+  CompressionDictHolder compression_dict_holder_;
 
   const Options options_;
   const ImmutableCFOptions ioptions_;
@@ -80,6 +80,24 @@ void Compaction::SetInputVersion(Version* _input_version) {
   cfd_->Ref();
   input_version_->Ref();
   edit_.SetColumnFamily(cfd_->GetID());
+
+  // Values are moved out of the oldest blob_garbage_collection_age_cutoff fraction of blob files
+  // referenced by the inputs.
+  std::vector<uint64_t> blob_files;
+  for (const auto& input : inputs_) {
+    for (const auto* file : input.files) {
+      blob_files.insert(blob_files.end(), file->blob_files.begin(), file->blob_files.end());
+    }
+  }
+  if (!blob_files.empty()) {
+    std::sort(blob_files.begin(), blob_files.end());
+    blob_files.erase(std::unique(blob_files.begin(), blob_files.end()), blob_files.end());
+    const auto cutoff = std::min(
+        std::max(cfd_->ioptions()->blob_garbage_collection_age_cutoff, 0.0), 1.0);
+    const auto index = static_cast<size_t>(blob_files.size() * cutoff);
+    blob_relocate_below_ =
+        index < blob_files.size() ? blob_files[index] : blob_files.back() + 1;
+  }
 }
 
 void Compaction::GetBoundaryKeys(
@@ -506,7 +524,8 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, outputs of subcompactions form a single sorted run in level 0.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
@@ -181,6 +181,9 @@ class Compaction {
   // Whether need to write output file to second DB path.
   uint32_t output_path_id() const { return output_path_id_; }
 
+  // Values in blob files with numbers below this one should be moved to blob files of the outputs.
+  uint64_t blob_relocate_below() const { return blob_relocate_below_; }
+
   // Is this a trivial compaction that can be implemented by just
   // moving a single input file to the next level (no merging or splitting)
   bool IsTrivialMove() const;
@@ -319,6 +322,7 @@ class Compaction {
   Arena arena_;          // Arena used to allocate space for file_levels_
 
   const uint32_t output_path_id_;
+  uint64_t blob_relocate_below_ = 0;
   CompressionType output_compression_;
   // If true, then the comaction can be done by simply deleting input files.
   const bool deletion_compaction_;
@@ -21,6 +21,9 @@
 //
 
 #include "yb/rocksdb/db/compaction_iterator.h"
+
+#include "yb/rocksdb/db/blob_file.h"
+#include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 
 namespace rocksdb {
@@ -42,11 +45,12 @@ CompactionIterator::CompactionIterator(
       compaction_filter_(compaction_filter),
       log_buffer_(log_buffer),
       merge_out_iter_(merge_helper_) {
-  assert(compaction_filter_ == nullptr || compaction_ != nullptr);
   bottommost_level_ =
       compaction_ == nullptr ? false : compaction_->bottommost_level();
   if (compaction_ != nullptr) {
     level_ptrs_ = std::vector<size_t>(compaction_->number_levels(), 0);
+    blob_file_cache_ =
+        compaction_->column_family_data()->ioptions()->blob_file_cache.get();
   }
 
   if (snapshots_->size() == 0) {
@@ -166,9 +170,11 @@ void CompactionIterator::NextFromInput() {
       has_outputted_key_ = false;
       current_user_key_sequence_ = kMaxSequenceNumber;
       current_user_key_snapshot_ = 0;
+      current_key_removed_by_filter_ = false;
 
       // apply the compaction filter to the first occurrence of the user key
-      if (compaction_filter_ != nullptr && ikey_.type == kTypeValue &&
+      if (compaction_filter_ != nullptr &&
+          (ikey_.type == kTypeValue || ikey_.type == kTypeBlobIndex) &&
           (visible_at_tip_ || ikey_.sequence > latest_snapshot_ ||
            ignore_snapshots_)) {
         // If the user has specified a compaction filter and the sequence
@@ -178,10 +184,15 @@ void CompactionIterator::NextFromInput() {
         bool value_changed = false;
         bool to_delete = false;
         compaction_filter_value_.clear();
+        Slice user_value;
+        status_ = GetUserValue(&user_value);
+        if (!status_.ok()) {
+          return;
+        }
         {
           StopWatchNano timer(env_, true);
           to_delete = compaction_filter_->Filter(
-              compaction_->level(), ikey_.user_key, value_,
+              compaction_ == nullptr ? 0 : compaction_->level(), ikey_.user_key, user_value,
               &compaction_filter_value_, &value_changed);
           iter_stats_.total_filter_time +=
               env_ != nullptr ? timer.ElapsedNanos() : 0;
@@ -193,8 +204,15 @@ void CompactionIterator::NextFromInput() {
           // no value associated with delete
           value_.clear();
           iter_stats_.num_record_drop_user++;
+          current_key_removed_by_filter_ = compaction_filter_->RemovedKeysAreUnique();
         } else if (value_changed) {
           value_ = compaction_filter_value_;
+          if (ikey_.type == kTypeBlobIndex) {
+            // The new value replaces the reference to the value in the blob file.
+            ikey_.type = kTypeValue;
+            current_key_.UpdateInternalKey(ikey_.sequence, kTypeValue);
+            key_ = current_key_.GetKey();
+          }
         }
       }
     } else {
@@ -224,9 +242,14 @@ void CompactionIterator::NextFromInput() {
       // In the previous iteration we encountered a single delete that we could
       // not compact out.  We will keep this Put, but can drop it's data.
       // (See Optimization 3, below.)
-      assert(ikey_.type == kTypeValue);
+      assert(ikey_.type == kTypeValue || ikey_.type == kTypeBlobIndex);
       assert(current_user_key_snapshot_ == last_snapshot);
 
+      if (ikey_.type == kTypeBlobIndex) {
+        ikey_.type = kTypeValue;
+        current_key_.UpdateInternalKey(ikey_.sequence, kTypeValue);
+        key_ = current_key_.GetKey();
+      }
       value_.clear();
       valid_ = true;
       clear_and_output_next_key_ = false;
@@ -355,6 +378,13 @@ void CompactionIterator::NextFromInput() {
       assert(last_sequence >= current_user_key_sequence_);
       ++iter_stats_.num_record_drop_hidden;  // (A)
       input_->Next();
+    } else if (current_key_removed_by_filter_ && ikey_.type == kTypeDeletion &&
+               ikey_.sequence <= earliest_snapshot_) {
+      // The compaction filter has removed this key, and no other versions of it could exist in
+      // files outside of this compaction or flush, so no deletion marker is needed to hide them.
+      // Versions with smaller sequence numbers in the input are dropped by rule (A) above.
+      ++iter_stats_.num_record_drop_obsolete;
+      input_->Next();
     } else if (compaction_ != nullptr && ikey_.type == kTypeDeletion &&
                ikey_.sequence <= earliest_snapshot_ &&
                compaction_->KeyNotExistsBeyondOutputLevel(ikey_.user_key,
@@ -417,6 +447,23 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
+Status CompactionIterator::GetUserValue(Slice* value) {
+  if (ikey_.type != kTypeBlobIndex) {
+    *value = value_;
+    return Status::OK();
+  }
+  if (resolved_blob_index_ != value_) {
+    if (blob_file_cache_ == nullptr) {
+      return STATUS(Corruption, "Unexpected blob index", ikey_.DebugString(true));
+    }
+    resolved_blob_index_.clear();
+    RETURN_NOT_OK(blob_file_cache_->Get(value_, &blob_value_));
+    resolved_blob_index_.assign(value_.cdata(), value_.size());
+  }
+  *value = blob_value_;
+  return Status::OK();
+}
+
 void CompactionIterator::PrepareOutput() {
   // Zeroing out the sequence number leads to better compression.
   // If this is the bottommost level (no files in lower levels)
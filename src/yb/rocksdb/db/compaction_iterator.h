@@ -36,6 +36,8 @@
 
 namespace rocksdb {
 
+class BlobFileCache;
+
 struct CompactionIteratorStats {
   // Compaction statistics
   int64_t num_record_drop_user = 0;
@@ -85,6 +87,10 @@ class CompactionIterator {
   const Slice& user_key() const { return current_user_key_; }
   const CompactionIteratorStats& iter_stats() const { return iter_stats_; }
 
+  // Returns the value of the current output, reading it from its blob file if the output is a
+  // kTypeBlobIndex entry. The returned value is valid until the next modification of the iterator.
+  Status GetUserValue(Slice* value);
+
  private:
   // Processes the input stream to find the next output
   void NextFromInput();
@@ -149,12 +155,21 @@ class CompactionIterator {
   // True if the iterator has already returned a record for the current key.
   bool has_outputted_key_ = false;
 
+  // True if the compaction filter has replaced the current key with a deletion marker that could be
+  // dropped, because the key has no versions in other files.
+  bool current_key_removed_by_filter_ = false;
+
   // truncated the value of the next key and output it without applying any
   // compaction rules.  This is used for outputting a put after a single delete.
   bool clear_and_output_next_key_ = false;
 
   MergeOutputIterator merge_out_iter_;
   std::string compaction_filter_value_;
+  // Blob files of the compacted column family, null for flushes, which do not read SST files.
+  BlobFileCache* blob_file_cache_ = nullptr;
+  // The last value read from a blob file, and the encoded blob index it was read for.
+  std::string blob_value_;
+  std::string resolved_blob_index_;
   // "level_ptrs" holds indices that remember which file of an associated
   // level we were last checking during the last call to compaction->
   // KeyNotExistsBeyondOutputLevel(). This allows future calls to the function
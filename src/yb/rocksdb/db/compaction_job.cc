@@ -37,6 +37,7 @@
 #include <thread>
 #include <utility>
 
+#include "yb/rocksdb/db/blob_file.h"
 #include "yb/rocksdb/db/builder.h"
 #include "yb/rocksdb/db/db_iter.h"
 #include "yb/rocksdb/db/dbformat.h"
@@ -100,6 +101,7 @@ struct CompactionJob::SubcompactionState {
   std::unique_ptr<WritableFileWriter> base_outfile;
   std::unique_ptr<WritableFileWriter> data_outfile;
   std::unique_ptr<TableBuilder> builder;
+  std::unique_ptr<BlobFileBuilder> blob_builder;
   Output* current_output() {
     if (outputs.empty()) {
       // This subcompaction's outptut could be empty if compaction was aborted
@@ -146,6 +148,7 @@ struct CompactionJob::SubcompactionState {
     base_outfile = std::move(o.base_outfile);
     data_outfile = std::move(o.data_outfile);
     builder = std::move(o.builder);
+    blob_builder = std::move(o.blob_builder);
     total_bytes = std::move(o.total_bytes);
     num_input_records = std::move(o.num_input_records);
     num_output_records = std::move(o.num_output_records);
@@ -242,6 +245,7 @@ CompactionJob::CompactionJob(
       dbname_(dbname),
       db_options_(db_options),
       env_options_(env_options),
+      output_env_options_(db_options.env->OptimizeForCompactionTableWrite(env_options, db_options)),
       env_(db_options.env),
       versions_(versions),
       shutting_down_(shutting_down),
@@ -330,26 +334,35 @@ void CompactionJob::Prepare() {
   // Is this compaction producing files at the bottommost level?
   bottommost_level_ = c->bottommost_level();
 
-  if (c->ShouldFormSubcompactions()) {
-    const uint64_t start_micros = env_->NowMicros();
-    GenSubcompactionBoundaries();
-    MeasureTime(stats_, SUBCOMPACTION_SETUP_TIME,
-                env_->NowMicros() - start_micros);
+  // Subcompactions are formed by Run, because their boundaries are picked using indexes of the
+  // input files, that should not be read while holding the DB mutex.
+  if (!c->ShouldFormSubcompactions()) {
+    compact_->sub_compact_states.emplace_back(c, nullptr, nullptr);
+  }
+}
 
-    assert(sizes_.size() == boundaries_.size() + 1);
+void CompactionJob::FormSubcompactions() {
+  auto* c = compact_->compaction;
+  const uint64_t start_micros = env_->NowMicros();
+  GenSubcompactionBoundaries();
+  MeasureTime(stats_, SUBCOMPACTION_SETUP_TIME,
+              env_->NowMicros() - start_micros);
 
-    for (size_t i = 0; i <= boundaries_.size(); i++) {
-      Slice* start = i == 0 ? nullptr : &boundaries_[i - 1];
-      Slice* end = i == boundaries_.size() ? nullptr : &boundaries_[i];
-      compact_->sub_compact_states.emplace_back(c, start, end, sizes_[i]);
-    }
-    MeasureTime(stats_, NUM_SUBCOMPACTIONS_SCHEDULED,
-                compact_->sub_compact_states.size());
-  } else {
-    compact_->sub_compact_states.emplace_back(c, nullptr, nullptr);
+  assert(sizes_.size() == boundaries_.size() + 1);
+
+  for (size_t i = 0; i <= boundaries_.size(); i++) {
+    Slice* start = i == 0 ? nullptr : &boundaries_[i - 1];
+    Slice* end = i == boundaries_.size() ? nullptr : &boundaries_[i];
+    compact_->sub_compact_states.emplace_back(c, start, end, sizes_[i]);
   }
+  MeasureTime(stats_, NUM_SUBCOMPACTIONS_SCHEDULED,
+              compact_->sub_compact_states.size());
 }
 
+// Number of keys sampled from each input file per subcompaction, when picking subcompaction
+// boundaries using data index samples.
+constexpr size_t kSubcompactionBoundarySamplesPerFile = 8;
+
 struct RangeWithSize {
   Range range;
   uint64_t size;
@@ -367,6 +380,8 @@ void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
+  auto* filter_factory = cfd->ioptions()->compaction_filter == nullptr
+      ? cfd->ioptions()->compaction_filter_factory : nullptr;
   std::vector<Slice> bounds;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
@@ -408,6 +423,29 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  // With a single level all files are in level 0, and usually each of them covers almost the whole
+  // key range, so their boundaries are not enough to split the compaction. So we also use keys
+  // sampled from data indexes of the input files.
+  if (c->number_levels() == 1) {
+    const size_t samples_per_file =
+        db_options_.max_subcompactions * kSubcompactionBoundarySamplesPerFile;
+    const LevelFilesBrief* flevel = c->input_levels(0);
+    for (size_t i = 0; i < flevel->num_files; i++) {
+      TableReader* table_reader = nullptr;
+      std::unique_ptr<InternalIterator> iter(cfd->table_cache()->NewIterator(
+          ReadOptions(), env_options_, cfd->internal_comparator(), flevel->files[i].fd,
+          &table_reader));
+      if (table_reader != nullptr) {
+        for (auto& key : table_reader->GetSampleKeys(samples_per_file)) {
+          sample_keys_.push_back(std::move(key));
+        }
+      }
+    }
+    for (const auto& key : sample_keys_) {
+      bounds.emplace_back(key);
+    }
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -422,8 +460,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
   // size of data covered by keys in that range
   uint64_t sum = 0;
   std::vector<RangeWithSize> ranges;
-  auto* v = cfd->current();
-  for (auto it = bounds.begin();;) {
+  // We are not holding the DB mutex, so use version referenced by the compaction.
+  auto* v = c->input_version();
+  for (auto it = bounds.begin(); it != bounds.end();) {
     const Slice a = *it;
     it++;
 
@@ -439,9 +478,14 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
+  // Output file size is not limited for level 0 of universal compaction, in this case we avoid
+  // subcompactions that produce files smaller than target file size.
+  uint64_t max_file_size = c->mutable_cf_options()->MaxFileSizeForLevel(out_lvl);
+  if (max_file_size == std::numeric_limits<uint64_t>::max()) {
+    max_file_size = c->mutable_cf_options()->target_file_size_base;
+  }
   uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+      sum / min_file_fill_percent / max_file_size));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -462,7 +506,15 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory != nullptr) {
+          boundary = filter_factory->GetSubcompactionBoundary(boundary);
+        }
+        if (!boundaries_.empty() && cfd_comparator->Compare(boundaries_.back(), boundary) >= 0) {
+          // Boundary was moved to the previous one, so keep adding ranges to this subcompaction.
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -475,6 +527,25 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::UnifyOutputSequenceNumbers() {
+  // Widening sequence number range of a file is safe, since the range of the whole compaction
+  // output does not overlap ranges of other level 0 files.
+  SequenceNumber smallest_seqno = kMaxSequenceNumber;
+  SequenceNumber largest_seqno = 0;
+  for (const auto& state : compact_->sub_compact_states) {
+    for (const auto& output : state.outputs) {
+      smallest_seqno = std::min(smallest_seqno, output.meta.smallest.seqno);
+      largest_seqno = std::max(largest_seqno, output.meta.largest.seqno);
+    }
+  }
+  for (auto& state : compact_->sub_compact_states) {
+    for (auto& output : state.outputs) {
+      output.meta.smallest.seqno = smallest_seqno;
+      output.meta.largest.seqno = largest_seqno;
+    }
+  }
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -482,8 +553,13 @@ Status CompactionJob::Run() {
   log_buffer_->FlushBufferToLog();
   LogCompaction();
 
-  const size_t num_threads = compact_->sub_compact_states.size();
+  if (compact_->sub_compact_states.empty()) {
+    FormSubcompactions();
+  }
+
+  size_t num_threads = compact_->sub_compact_states.size();
   assert(num_threads > 0);
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::Run():NumSubcompactions", &num_threads);
   const uint64_t start_micros = env_->NowMicros();
 
   // Launch a thread for each of subcompactions 1...num_threads-1
@@ -519,6 +595,11 @@ Status CompactionJob::Run() {
     }
   }
 
+  if (status.ok() && compact_->sub_compact_states.size() > 1 &&
+      compact_->compaction->output_level() == 0) {
+    UnifyOutputSequenceNumbers();
+  }
+
   TablePropertiesCollection tp;
   for (const auto& state : compact_->sub_compact_states) {
     for (const auto& output : state.outputs) {
@@ -712,10 +793,27 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
     assert(sub_compact->builder != nullptr);
     assert(sub_compact->current_output() != nullptr);
-    sub_compact->builder->Add(key, value);
+    // Values of kTypeBlobIndex entries are only needed to extract boundary values, or when they
+    // are moved to the blob file of this compaction.
+    Slice user_value = value;
+    const Slice* resolved_value = nullptr;
+    if (c_iter->ikey().type == kTypeBlobIndex && db_options_.boundary_extractor) {
+      status = c_iter->GetUserValue(&user_value);
+      if (!status.ok()) {
+        break;
+      }
+      resolved_value = &user_value;
+    }
+    Slice table_key;
+    status = sub_compact->blob_builder->AddToTable(
+        key, value, resolved_value, sub_compact->builder.get(),
+        &sub_compact->current_output()->meta, &table_key);
+    if (!status.ok()) {
+      break;
+    }
     auto boundaries = MakeFileBoundaryValues(db_options_.boundary_extractor.get(),
-                                             key,
-                                             value);
+                                             table_key,
+                                             user_value);
     if (!boundaries) {
       status = std::move(boundaries.status());
       break;
@@ -758,6 +856,9 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     status = STATUS(ShutdownInProgress,
         "Database shutdown or Column family drop during compaction");
   }
+  if (status.ok()) {
+    status = c_iter->status();
+  }
   if (status.ok() && sub_compact->builder != nullptr) {
     status = FinishCompactionOutputFile(input->status(), sub_compact);
   }
@@ -842,10 +943,14 @@ Status CompactionJob::FinishCompactionOutputFile(
   auto meta = &sub_compact->current_output()->meta;
   const uint64_t current_entries = sub_compact->builder->NumEntries();
   meta->marked_for_compaction = sub_compact->builder->NeedCompact();
+  if (s.ok()) {
+    s = sub_compact->blob_builder->Finish();
+  }
   if (s.ok()) {
     s = sub_compact->builder->Finish();
   } else {
     sub_compact->builder->Abandon();
+    sub_compact->blob_builder->Abandon();
   }
 
   const uint64_t current_total_bytes = sub_compact->builder->TotalFileSize();
@@ -910,6 +1015,9 @@ Status CompactionJob::FinishCompactionOutputFile(
     if (is_split_sst) {
       sfm->OnAddFile(TableBaseToDataFileName(fn));
     }
+    if (!sub_compact->blob_builder->empty()) {
+      sfm->OnAddFile(BlobFileName(cfd->ioptions()->db_paths[0].path, output_number));
+    }
     if (sfm->IsMaxAllowedSpaceReached()) {
       InstrumentedMutexLock l(db_mutex_);
       if (db_bg_error_->ok()) {
@@ -922,6 +1030,7 @@ Status CompactionJob::FinishCompactionOutputFile(
   }
 
   sub_compact->builder.reset();
+  sub_compact->blob_builder.reset();
   return s;
 }
 
@@ -979,7 +1088,7 @@ void CompactionJob::RecordCompactionIOStats() {
 Status CompactionJob::OpenFile(const std::string table_name, uint64_t file_number,
     const std::string file_type_label, const std::string fname,
     std::unique_ptr<WritableFile>* writable_file) {
-  Status s = NewWritableFile(env_, fname, writable_file, env_options_);
+  Status s = NewWritableFile(env_, fname, writable_file, output_env_options_);
   if (!s.ok()) {
     RLOG(InfoLogLevel::ERROR_LEVEL, db_options_.info_log,
         "[%s] [JOB %d] OpenCompactionOutputFiles for table #%" PRIu64
@@ -1043,10 +1152,10 @@ Status CompactionJob::OpenCompactionOutputFile(
     const size_t preallocation_data_block_size = static_cast<size_t>(
         sub_compact->compaction->OutputFilePreallocationSize());
     // if we don't have separate data file - preallocate size for base file
-    setup_outfile(env_options_, is_split_sst ? 0 : preallocation_data_block_size,
+    setup_outfile(output_env_options_, is_split_sst ? 0 : preallocation_data_block_size,
         &base_writable_file, &sub_compact->base_outfile);
     if (is_split_sst) {
-      setup_outfile(env_options_, preallocation_data_block_size, &data_writable_file,
+      setup_outfile(output_env_options_, preallocation_data_block_size, &data_writable_file,
           &sub_compact->data_outfile);
     }
   }
@@ -1061,7 +1170,10 @@ Status CompactionJob::OpenCompactionOutputFile(
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
       sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
-      skip_filters));
+      skip_filters, cfd->compression_dict_holder()));
+  sub_compact->blob_builder = std::make_unique<BlobFileBuilder>(
+      *cfd->ioptions(), output_env_options_, Env::IO_LOW, file_number,
+      sub_compact->compaction->blob_relocate_below());
   LogFlush(db_options_.info_log);
   return s;
 }
@@ -1074,6 +1186,8 @@ void CompactionJob::CleanupCompaction() {
       // May happen if we get a shutdown call in the middle of compaction
       sub_compact.builder->Abandon();
       sub_compact.builder.reset();
+      sub_compact.blob_builder->Abandon();
+      sub_compact.blob_builder.reset();
     } else if (sub_status.ok() &&
         (sub_compact.base_outfile != nullptr || sub_compact.data_outfile != nullptr)) {
       std::string log_message;
@@ -98,7 +98,12 @@ class CompactionJob {
   struct SubcompactionState;
 
   void AggregateStatistics();
+  // Splits the compaction into subcompactions by key ranges.
+  void FormSubcompactions();
   void GenSubcompactionBoundaries();
+  // Makes all level 0 outputs of subcompactions share the same sequence number range, so they are
+  // treated as a single sorted run, see InSameSortedRun.
+  void UnifyOutputSequenceNumbers();
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -141,6 +146,8 @@ class CompactionJob {
   const std::string& dbname_;
   const DBOptions& db_options_;
   const EnvOptions& env_options_;
+  // Options used to write compaction output files.
+  const EnvOptions output_env_options_;
   Env* env_;
   VersionSet* versions_;
   std::atomic<bool>* shutting_down_;
@@ -168,6 +175,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Keys sampled from the input files to pick subcompaction boundaries, referenced by boundaries_.
+  std::vector<std::string> sample_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -155,6 +155,19 @@ CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
   }
 }
 
+CompressionType GetUniversalCompressionType(const ImmutableCFOptions& ioptions,
+                                            int level, uint64_t estimated_output_size,
+                                            const bool enable_compression) {
+  if (estimated_output_size < ioptions.min_compressed_output_size) {
+    return kNoCompression;
+  }
+  if (enable_compression && ioptions.large_output_size > 0 &&
+      estimated_output_size >= ioptions.large_output_size) {
+    return ioptions.large_output_compression;
+  }
+  return GetCompressionType(ioptions, level, 1, enable_compression);
+}
+
 CompactionPicker::CompactionPicker(const ImmutableCFOptions& ioptions,
                                    const InternalKeyComparator* icmp)
     : ioptions_(ioptions), icmp_(icmp) {}
@@ -609,6 +622,19 @@ Compaction* CompactionPicker::CompactRange(
     }
   }
 
+  CompressionType compression;
+  if (ioptions_.compaction_style == kCompactionStyleUniversal) {
+    uint64_t estimated_total_size = 0;
+    for (const auto& level_inputs : compaction_inputs) {
+      for (const auto* file : level_inputs.files) {
+        estimated_total_size += file->fd.GetTotalFileSize();
+      }
+    }
+    compression = GetUniversalCompressionType(ioptions_, output_level, estimated_total_size);
+  } else {
+    compression = GetCompressionType(ioptions_, output_level, vstorage->base_level());
+  }
+
   std::vector<FileMetaData*> grandparents;
   GetGrandparents(vstorage, inputs, output_level_inputs, &grandparents);
   Compaction* compaction = new Compaction(
@@ -616,7 +642,7 @@ Compaction* CompactionPicker::CompactRange(
       mutable_cf_options.MaxFileSizeForLevel(output_level),
       mutable_cf_options.MaxGrandParentOverlapBytes(input_level),
       output_path_id,
-      GetCompressionType(ioptions_, output_level, vstorage->base_level()),
+      compression,
       std::move(grandparents), /* is manual compaction */ true);
 
   TEST_SYNC_POINT_CALLBACK("CompactionPicker::CompactRange:Return", compaction);
@@ -1148,7 +1174,197 @@ bool LevelCompactionPicker::PickCompactionBySize(VersionStorageInfo* vstorage,
 bool UniversalCompactionPicker::NeedsCompaction(
     const VersionStorageInfo* vstorage) const {
   const int kLevel0 = 0;
-  return vstorage->CompactionScore(kLevel0) >= 1;
+  if (ioptions_.time_window_extractor && vstorage->num_levels() == 1) {
+    std::vector<TimeWindowRun> runs;
+    return CalculateTimeWindowRuns(*vstorage, std::numeric_limits<uint64_t>::max(), &runs);
+  }
+  return vstorage->CompactionScore(kLevel0) >= 1 ||
+         DeleteTriggeredCompactionStart(*vstorage) != vstorage->LevelFiles(kLevel0).size();
+}
+
+size_t UniversalCompactionPicker::DeleteTriggeredCompactionStart(
+    const VersionStorageInfo& vstorage) const {
+  const auto& files = vstorage.LevelFiles(0);
+  const uint64_t percent =
+      ioptions_.compaction_options_universal.delete_triggered_compaction_percent;
+  if (percent == 0 || vstorage.num_levels() != 1) {
+    return files.size();
+  }
+
+  // Files are ordered from the newest to the earliest, so go backwards accumulating entries of
+  // the files that would be compacted together with the earliest one.
+  size_t result = files.size();
+  uint64_t entries = 0;
+  uint64_t deletions = 0;
+  for (size_t i = files.size(); i-- > 0;) {
+    const auto* f = files[i];
+    if (f->being_compacted || !f->init_stats_from_file) {
+      break;
+    }
+    entries += f->num_entries;
+    deletions += f->num_deletions;
+    if (deletions != 0 && deletions * 100 >= percent * entries) {
+      result = i;
+    }
+  }
+  return result;
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionUniversalDeleteTriggered(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, double score, LogBuffer* log_buffer) {
+  const auto& files = vstorage->LevelFiles(0);
+  size_t start = DeleteTriggeredCompactionStart(*vstorage);
+  if (start == files.size()) {
+    return nullptr;
+  }
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = 0;
+  uint64_t estimated_total_size = 0;
+  for (size_t i = start; i != files.size(); ++i) {
+    inputs[0].files.push_back(files[i]);
+    estimated_total_size += files[i]->fd.GetTotalFileSize();
+  }
+  uint64_t max_file_size = mutable_cf_options.max_file_size_for_compaction;
+  if (estimated_total_size > max_file_size) {
+    RDEBUG(ioptions_.info_log,
+           "[%s] Universal: delete triggered compaction of %" PRIu64 " bytes is too large\n",
+           cf_name.c_str(), estimated_total_size);
+    return nullptr;
+  }
+  LOG_TO_BUFFER(log_buffer,
+                "[%s] Universal: delete triggered compaction of %" ROCKSDB_PRIszt " files\n",
+                cf_name.c_str(), inputs[0].files.size());
+
+  return new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs),
+      /* output level */ 0,
+      mutable_cf_options.MaxFileSizeForLevel(0),
+      /* max_grandparent_overlap_bytes */ LLONG_MAX,
+      GetPathId(ioptions_, estimated_total_size),
+      GetUniversalCompressionType(ioptions_, 0, estimated_total_size),
+      /* grandparents */ {}, /* is manual */ false, score,
+      false /* deletion_compaction */,
+      CompactionReason::kFilesMarkedForCompaction);
+}
+
+struct UniversalCompactionPicker::TimeWindowRun {
+  // Range of level 0 files of the sorted run.
+  size_t begin;
+  size_t end;
+  // The latest time window of the files.
+  uint64_t window;
+  uint64_t size;
+  // False if some of the files are being compacted or are too large to compact.
+  bool compactable;
+};
+
+bool UniversalCompactionPicker::CalculateTimeWindowRuns(
+    const VersionStorageInfo& vstorage, uint64_t max_file_size,
+    std::vector<TimeWindowRun>* runs) const {
+  const auto& files = vstorage.LevelFiles(0);
+  runs->clear();
+  for (size_t i = 0; i != files.size();) {
+    TimeWindowRun run = {i, i, 0, 0, true};
+    do {
+      const auto* f = files[run.end];
+      run.window = std::max(
+          run.window, ioptions_.time_window_extractor->TimeWindow(f->largest.user_values));
+      run.size += f->fd.GetTotalFileSize();
+      run.compactable = run.compactable && !f->being_compacted &&
+                        f->fd.GetTotalFileSize() <= max_file_size;
+      ++run.end;
+    } while (run.end != files.size() && InSameSortedRun(*files[run.end - 1], *files[run.end]));
+    runs->push_back(run);
+    i = run.end;
+  }
+
+  for (size_t i = 1; i < runs->size(); ++i) {
+    const auto& newer = (*runs)[i - 1];
+    const auto& older = (*runs)[i];
+    if (newer.compactable && older.compactable && newer.window == older.window) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Compaction* UniversalCompactionPicker::PickCompactionTimeWindow(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const uint64_t max_file_size = mutable_cf_options.max_file_size_for_compaction;
+  std::vector<TimeWindowRun> runs;
+  if (!CalculateTimeWindowRuns(*vstorage, max_file_size, &runs)) {
+    RDEBUG(ioptions_.info_log, "[%s] Universal: nothing to do in time windows\n",
+           cf_name.c_str());
+    return nullptr;
+  }
+
+  // Runs of past windows are compacted as soon as there are two of them, so each past window ends
+  // up in a single file. Runs of the latest window keep receiving flushes, so they are compacted
+  // when there are enough of them to trigger a regular compaction.
+  const uint64_t latest_window = runs.front().window;
+  const size_t latest_window_trigger =
+      std::max(mutable_cf_options.level0_file_num_compaction_trigger, 2);
+  const size_t max_runs =
+      std::max<size_t>(ioptions_.compaction_options_universal.max_merge_width, 2);
+
+  // Go from the oldest runs, looking for sequences of compactable runs of the same window.
+  size_t end = runs.size();
+  while (end > 0) {
+    size_t begin = end - 1;
+    if (!runs[begin].compactable) {
+      end = begin;
+      continue;
+    }
+    const uint64_t window = runs[begin].window;
+    while (begin > 0 && runs[begin - 1].compactable && runs[begin - 1].window == window) {
+      --begin;
+    }
+    const size_t trigger = window == latest_window ? latest_window_trigger : 2;
+    if (end - begin < trigger) {
+      end = begin;
+      continue;
+    }
+
+    // Take the oldest runs of the sequence that fit into limits.
+    size_t first = end;
+    uint64_t estimated_total_size = 0;
+    while (first > begin && end - first < max_runs &&
+           estimated_total_size + runs[first - 1].size <= max_file_size) {
+      --first;
+      estimated_total_size += runs[first].size;
+    }
+    if (end - first < 2) {
+      end = begin;
+      continue;
+    }
+
+    std::vector<CompactionInputFiles> inputs(1);
+    inputs[0].level = 0;
+    const auto& files = vstorage->LevelFiles(0);
+    for (size_t i = runs[first].begin; i != runs[end - 1].end; ++i) {
+      inputs[0].files.push_back(files[i]);
+    }
+    LOG_TO_BUFFER(log_buffer,
+                  "[%s] Universal: compacting %" ROCKSDB_PRIszt " sorted runs of time window %"
+                  PRIu64 "\n",
+                  cf_name.c_str(), end - first, window);
+    MeasureTime(ioptions_.statistics, NUM_FILES_IN_SINGLE_COMPACTION, inputs[0].files.size());
+
+    return new Compaction(
+        vstorage, mutable_cf_options, std::move(inputs),
+        /* output level */ 0,
+        mutable_cf_options.MaxFileSizeForLevel(0),
+        /* max_grandparent_overlap_bytes */ LLONG_MAX,
+        GetPathId(ioptions_, estimated_total_size),
+        GetUniversalCompressionType(ioptions_, 0, estimated_total_size),
+        /* grandparents */ {}, /* is manual */ false, vstorage->CompactionScore(0),
+        false /* deletion_compaction */,
+        CompactionReason::kUniversalSortedRunNum);
+  }
+  return nullptr;
 }
 
 struct UniversalCompactionPicker::SortedRun {
@@ -1162,6 +1378,18 @@ struct UniversalCompactionPicker::SortedRun {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
     assert((level != 0) != (file != nullptr));
+    if (file) {
+      files.push_back(file);
+    }
+  }
+
+  // Adds level 0 file to the sorted run, see InSameSortedRun.
+  void AddFile(FileMetaData* f) {
+    assert(level == 0);
+    files.push_back(f);
+    size += f->fd.GetTotalFileSize();
+    compensated_file_size += f->compensated_file_size;
+    being_compacted = being_compacted || f->being_compacted;
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1173,8 +1401,10 @@ struct UniversalCompactionPicker::SortedRun {
 
   int level;
   // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
+  // for this file, and for files produced together with it by subcompactions, they are listed in
+  // `files`.
   FileMetaData* file;
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1209,8 +1439,7 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             file->fd.GetNumber(), sorted_run_count, size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,15 +1454,30 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
-    if (f->fd.GetTotalFileSize() <= max_file_size) {
+  const auto& level0_files = vstorage.LevelFiles(0);
+  for (size_t i = 0; i != level0_files.size();) {
+    // Files of the same sorted run are compacted together, so the run is too large to compact if
+    // any of its files is too large.
+    size_t run_end = i + 1;
+    bool too_large = level0_files[i]->fd.GetTotalFileSize() > max_file_size;
+    while (run_end != level0_files.size() &&
+           InSameSortedRun(*level0_files[run_end - 1], *level0_files[run_end])) {
+      too_large = too_large || level0_files[run_end]->fd.GetTotalFileSize() > max_file_size;
+      ++run_end;
+    }
+    if (!too_large) {
+      FileMetaData* f = level0_files[i];
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
+      for (size_t j = i + 1; j != run_end; ++j) {
+        ret.back().back().AddFile(level0_files[j]);
+      }
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
     // a row. So we just don't start new sequence in this case.
     } else if (!ret.back().empty()) {
       ret.emplace_back();
     }
+    i = run_end;
   }
 
   for (int level = 1; level < vstorage.num_levels(); level++) {
@@ -1353,6 +1597,17 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  // Compactions across time windows would mix old and new data, so no other compactions are
+  // picked in time window mode.
+  if (ioptions_.time_window_extractor && vstorage->num_levels() == 1) {
+    Compaction* result = PickCompactionTimeWindow(
+        cf_name, mutable_cf_options, vstorage, log_buffer);
+    if (result != nullptr) {
+      level0_compactions_in_progress_.insert(result);
+    }
+    return result;
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1364,7 +1619,13 @@ Compaction* UniversalCompactionPicker::PickCompaction(
       return result;
     }
   }
-  return nullptr;
+
+  Compaction* result = PickCompactionUniversalDeleteTriggered(
+      cf_name, mutable_cf_options, vstorage, vstorage->CompactionScore(0), log_buffer);
+  if (result != nullptr) {
+    level0_compactions_in_progress_.insert(result);
+  }
+  return result;
 }
 
 Compaction* UniversalCompactionPicker::DoPickCompaction(
@@ -1453,14 +1714,16 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
 
   size_t level_index = 0U;
   if (c->start_level() == 0) {
+    const FileMetaData* prev = nullptr;
     for (auto f : *c->inputs(0)) {
       DCHECK_LE(f->smallest.seqno, f->largest.seqno);
       if (is_first) {
         is_first = false;
-      } else {
+      } else if (!InSameSortedRun(*prev, *f)) {
         DCHECK_GT(prev_smallest_seqno, f->largest.seqno);
       }
       prev_smallest_seqno = f->smallest.seqno;
+      prev = f;
     }
     level_index = 1U;
   }
@@ -1688,8 +1951,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1711,7 +1974,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   return new Compaction(
       vstorage, mutable_cf_options, std::move(inputs), output_level,
       mutable_cf_options.MaxFileSizeForLevel(output_level), LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, start_level, 1, enable_compression),
+      GetUniversalCompressionType(ioptions_, start_level, estimated_total_size,
+                                  enable_compression),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */, compaction_reason);
 }
@@ -1814,8 +2078,8 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      inputs[0].files.insert(
+          inputs[0].files.end(), picking_sr.files.begin(), picking_sr.files.end());
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1833,7 +2097,7 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
       vstorage->num_levels() - 1,
       mutable_cf_options.MaxFileSizeForLevel(vstorage->num_levels() - 1),
       /* max_grandparent_overlap_bytes */ LLONG_MAX, path_id,
-      GetCompressionType(ioptions_, vstorage->num_levels() - 1, 1),
+      GetUniversalCompressionType(ioptions_, vstorage->num_levels() - 1, estimated_total_size),
       /* grandparents */ {}, /* is manual */ false, score,
       false /* deletion_compaction */,
       CompactionReason::kUniversalSizeAmplification);
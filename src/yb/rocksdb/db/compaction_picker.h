@@ -273,6 +273,29 @@ class UniversalCompactionPicker : public CompactionPicker {
       unsigned int num_files, const std::vector<SortedRun>& sorted_runs,
       LogBuffer* log_buffer);
 
+  // Returns index of the newest level 0 file, such that files starting from it contain enough
+  // deletions to trigger compaction, see delete_triggered_compaction_percent.
+  // Returns number of level 0 files if there is no such file.
+  size_t DeleteTriggeredCompactionStart(const VersionStorageInfo& vstorage) const;
+
+  // Pick Universal compaction to drop deletions and the entries they delete.
+  Compaction* PickCompactionUniversalDeleteTriggered(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, double score, LogBuffer* log_buffer);
+
+  // Time window compaction, see ColumnFamilyOptions::time_window_extractor.
+  // Level 0 files are split into sorted runs, together with their time windows, ordered from the
+  // newest to the oldest. Returns true if there are two adjacent compactable runs of the same
+  // window.
+  struct TimeWindowRun;
+  bool CalculateTimeWindowRuns(const VersionStorageInfo& vstorage, uint64_t max_file_size,
+                               std::vector<TimeWindowRun>* runs) const;
+
+  // Pick compaction of sorted runs of the oldest time window that needs it.
+  Compaction* PickCompactionTimeWindow(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
   // Pick Universal compaction to limit space amplification.
   Compaction* PickCompactionUniversalSizeAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
@@ -365,6 +388,13 @@ CompressionType GetCompressionType(const ImmutableCFOptions& ioptions,
                                    int level, int base_level,
                                    const bool enable_compression = true);
 
+// Determines the compression type of the output of a universal compaction, like
+// GetCompressionType, but also based on the size of the output, estimated as the total size of the
+// compaction inputs: small outputs are not compressed and large ones use large_output_compression.
+CompressionType GetUniversalCompressionType(const ImmutableCFOptions& ioptions,
+                                            int level, uint64_t estimated_output_size,
+                                            const bool enable_compression = true);
+
 }  // namespace rocksdb
 
 #endif // ROCKSDB_DB_COMPACTION_PICKER_H
@@ -430,6 +430,48 @@ TEST_F(DBBloomFilterTest, BloomFilterIndex) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBBloomFilterTest, CachedFilterIndex) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_block_size = 1024;
+  table_options.filter_policy.reset(NewFixedSizeFilterPolicy(
+      table_options.filter_block_size * 8, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+      nullptr));
+  table_options.block_cache = NewLRUCache(8 * 1024 * 1024);
+  table_options.cache_filter_index = true;
+  table_options.cache_filter_blocks_with_high_priority = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  const int kNumKeys = 5000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(1, Key(i), Key(i)));
+  }
+  ASSERT_OK(Flush(1));
+
+  const auto filter_misses = TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS);
+  const auto multi_touch_adds = TestGetTickerCount(options, BLOCK_CACHE_MULTI_TOUCH_ADD);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(Key(i), Get(1, Key(i)));
+  }
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ("NOT_FOUND", Get(1, Key(i) + ".missing"));
+  }
+  ASSERT_GT(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+
+  // Filter index and filter blocks are loaded once, and then are taken from the block cache.
+  const auto new_filter_misses = TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS) -
+                                 filter_misses;
+  ASSERT_GT(new_filter_misses, 1);
+  ASSERT_LT(new_filter_misses, kNumKeys / 10);
+  ASSERT_GT(TestGetTickerCount(options, BLOCK_CACHE_FILTER_HIT), 2 * kNumKeys);
+  // Filter index and filter blocks are put in the multi-touch part of the block cache.
+  ASSERT_GE(TestGetTickerCount(options, BLOCK_CACHE_MULTI_TOUCH_ADD) - multi_touch_adds,
+            new_filter_misses);
+}
+
 TEST_F(DBBloomFilterTest, BloomFilterRate) {
   while (ChangeFilterOptions()) {
     Options options = CurrentOptions();
@@ -132,11 +132,12 @@ Status DBImpl::GetLiveFiles(std::vector<std::string> &ret,
 
   // Make a set of all of the live *.sst files
   std::vector<FileDescriptor> live;
+  std::unordered_set<uint64_t> live_blob_files;
   for (auto cfd : *versions_->GetColumnFamilySet()) {
     if (cfd->IsDropped()) {
       continue;
     }
-    cfd->current()->AddLiveFiles(&live);
+    cfd->current()->AddLiveFiles(&live, &live_blob_files);
   }
 
   ret.clear();
@@ -155,6 +156,9 @@ Status DBImpl::GetLiveFiles(std::vector<std::string> &ret,
       ret.push_back(TableBaseToDataFileName(base_fname));
     }
   }
+  for (auto blob_file : live_blob_files) {
+    ret.push_back(BlobFileName("", blob_file));
+  }
 
   ret.push_back(CurrentFileName(""));
   ret.push_back(DescriptorFileName("", versions_->manifest_file_number()));
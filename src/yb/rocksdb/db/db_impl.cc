@@ -56,6 +56,7 @@
 #include "yb/util/fault_injection.h"
 
 #include "yb/rocksdb/db/auto_roll_logger.h"
+#include "yb/rocksdb/db/blob_file.h"
 #include "yb/rocksdb/db/builder.h"
 #include "yb/rocksdb/db/compaction_job.h"
 #include "yb/rocksdb/db/db_info_dumper.h"
@@ -208,6 +209,12 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
+  if (result.use_direct_io_for_compaction && result.compaction_readahead_size == 0) {
+    // Direct reads are not served from the OS page cache, so compaction inputs are read in large
+    // chunks.
+    result.compaction_readahead_size = 2 * 1024 * 1024;
+  }
+
   if (result.compaction_readahead_size > 0) {
     result.new_table_reader_for_compaction_inputs = true;
   }
@@ -630,7 +637,12 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
   job_context->log_number = versions_->MinLogNumber();
   job_context->prev_log_number = versions_->prev_log_number();
 
-  versions_->AddLiveFiles(&job_context->sst_live);
+  versions_->AddLiveFiles(&job_context->sst_live, &job_context->blob_live);
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->ioptions()->blob_file_cache) {
+      job_context->blob_file_caches.push_back(cfd->ioptions()->blob_file_cache);
+    }
+  }
   if (doing_the_full_scan) {
     for (size_t path_id = 0; path_id < db_options_.db_paths.size(); path_id++) {
       // set of all files in the directory. We'll exclude files that are still
@@ -748,6 +760,9 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state) {
     candidate_files.emplace_back(
         MakeTableFileName(kDumbDbName, file->fd.GetNumber()),
         file->fd.GetPathId());
+    for (auto blob_file : file->blob_files) {
+      candidate_files.emplace_back(BlobFileName(kDumbDbName, blob_file), 0);
+    }
     delete file;
   }
 
@@ -801,6 +816,10 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state) {
         // SST base file.
         keep = true;
         break;
+      case kBlobFile:
+        // Blob files of flushes and compactions in progress have pending output numbers.
+        keep = state.blob_live.count(number) || number >= state.min_pending_output;
+        break;
       case kTempFile:
         // Any temp files that are currently being written to must
         // be recorded in pending_outputs_, which is inserted into "live".
@@ -838,6 +857,11 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state) {
       // evict from cache
       TableCache::Evict(table_cache_.get(), number);
       fname = TableFileName(db_options_.db_paths, number, path_id);
+    } else if (type == kBlobFile) {
+      for (const auto& blob_file_cache : state.blob_file_caches) {
+        blob_file_cache->Evict(number);
+      }
+      fname = BlobFileName(db_options_.db_paths[0].path, number);
     } else {
       fname = ((type == kLogFile) ?
           db_options_.wal_dir : dbname_) + "/" + to_delete;
@@ -863,6 +887,8 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state) {
           file_deletion_status = s;
         }
       }
+    } else if (type == kBlobFile) {
+      file_deletion_status = DeleteSSTFile(&db_options_, fname, 0);
     } else {
       file_deletion_status = env_->DeleteFile(fname);
     }
@@ -1508,7 +1534,8 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                      cfd->internal_stats(),
                      db_options_.boundary_extractor.get(),
                      Env::IO_HIGH,
-                     &info.table_properties);
+                     &info.table_properties,
+                     cfd->compression_dict_holder());
       LogFlush(db_options_.info_log);
       RLOG(InfoLogLevel::DEBUG_LEVEL, db_options_.info_log,
           "[%s] [WriteLevel0TableForRecovery]"
@@ -1620,6 +1647,9 @@ Status DBImpl::FlushMemTableToOutputFile(
       if (cfd->ioptions()->table_factory->IsSplitSstForWriteSupported()) {
         sfm->OnAddFile(TableBaseToDataFileName(file_path));
       }
+      if (file_meta.blob_files.count(file_meta.fd.GetNumber())) {
+        sfm->OnAddFile(BlobFileName(db_options_.db_paths[0].path, file_meta.fd.GetNumber()));
+      }
       if (sfm->IsMaxAllowedSpaceReached() && bg_error_.ok()) {
         bg_error_ = STATUS(IOError, "Max allowed space was reached");
         TEST_SYNC_POINT(
@@ -1657,6 +1687,21 @@ uint64_t DBImpl::GetUncompressedSSTFileSize() {
   return total_uncompressed_file_size;
 }
 
+void DBImpl::CloseTableReadersIfIdle() {
+  if (db_options_.max_open_files == -1) {
+    return;
+  }
+  const uint64_t num_reads = num_reads_.load(std::memory_order_relaxed);
+  if (num_reads_at_idle_check_.exchange(num_reads) != num_reads) {
+    return;
+  }
+  // Shrinking the capacity evicts the table readers that are not referenced. The capacity is
+  // restored, so readers opened later are still bounded by max_open_files.
+  const size_t capacity = table_cache_->GetCapacity();
+  table_cache_->SetCapacity(0);
+  table_cache_->SetCapacity(capacity);
+}
+
 void DBImpl::NotifyOnFlushCompleted(ColumnFamilyData* cfd,
                                     FileMetaData* file_meta,
                                     const MutableCFOptions& mutable_cf_options,
@@ -2662,6 +2707,10 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     return;
   }
 
+  if (bg_compaction_scheduled_ >= bg_compactions_allowed || unscheduled_compactions_ <= 0) {
+    return;
+  }
+  const double score = CompactionUrgencyScore();
   while (bg_compaction_scheduled_ < bg_compactions_allowed &&
          unscheduled_compactions_ > 0) {
     CompactionArg* ca = new CompactionArg;
@@ -2669,9 +2718,22 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     ca->m = nullptr;
     bg_compaction_scheduled_++;
     unscheduled_compactions_--;
-    env_->Schedule(&DBImpl::BGWorkCompaction, ca, Env::Priority::LOW, this,
-                   &DBImpl::UnscheduleCallback);
+    env_->ScheduleWithScore(&DBImpl::BGWorkCompaction, ca, score, Env::Priority::LOW, this,
+                            &DBImpl::UnscheduleCallback);
+  }
+}
+
+double DBImpl::CompactionUrgencyScore() {
+  mutex_.AssertHeld();
+  double result = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    result = std::max(result, cfd->current()->storage_info()->CompactionUrgencyScore(
+        *cfd->GetLatestMutableCFOptions(), cfd->ioptions()->compaction_options_universal));
   }
+  return result;
 }
 
 int DBImpl::BGCompactionsAllowed() const {
@@ -3513,6 +3575,7 @@ Status DBImpl::GetImpl(const ReadOptions& read_options,
                        ColumnFamilyHandle* column_family, const Slice& key,
                        std::string* value, bool* value_found) {
   StopWatch sw(env_, stats_, DB_GET);
+  num_reads_.fetch_add(1, std::memory_order_relaxed);
   PERF_TIMER_GUARD(get_snapshot_time);
 
   auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
@@ -3574,6 +3637,7 @@ std::vector<Status> DBImpl::MultiGet(
     const std::vector<Slice>& keys, std::vector<std::string>* values) {
 
   StopWatch sw(env_, stats_, DB_MULTIGET);
+  num_reads_.fetch_add(1, std::memory_order_relaxed);
   PERF_TIMER_GUARD(get_snapshot_time);
 
   struct MultiGetColumnFamilyData {
@@ -4149,6 +4213,7 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
   }
   auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family);
   auto cfd = cfh->cfd();
+  num_reads_.fetch_add(1, std::memory_order_relaxed);
 
   XFUNC_TEST("", "managed_new", managed_new1, xf_manage_new,
              reinterpret_cast<DBImpl*>(this),
@@ -4257,6 +4322,7 @@ Status DBImpl::NewIterators(
     return STATUS(NotSupported,
         "ReadTier::kPersistedData is not yet supported in iterators.");
   }
+  num_reads_.fetch_add(1, std::memory_order_relaxed);
   iterators->clear();
   iterators->reserve(column_families.size());
   XFUNC_TEST("", "managed_new", managed_new1, xf_manage_new,
@@ -4602,6 +4668,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 4. Merges are not okay
     // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
     //    parallel memtable writes.
+    // 6. Frontiers are not okay, since merging them into the memtable is not thread-safe.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -4618,10 +4685,20 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         total_count += WriteBatchInternal::Count(writer->batch);
         total_byte_size = WriteBatchInternal::AppendedByteSize(
             total_byte_size, WriteBatchInternal::ByteSize(writer->batch));
-        parallel = parallel && !writer->batch->HasMerge();
+        parallel = parallel && !writer->batch->HasMerge() && !writer->batch->Frontiers();
       }
     }
 
+    // A large batch that is written alone could be split between several inserting threads.
+    // Frontiers of such batch are merged by the writing thread only.
+    const bool parallel_batch =
+        db_options_.allow_concurrent_memtable_write &&
+        db_options_.memtable_insert_thread_pool != nullptr &&
+        db_options_.memtable_insert_parallelism > 1 &&
+        write_group.size() == 1 && !w.CallbackFailed() &&
+        total_count >= 2 * db_options_.min_memtable_insert_entries_per_thread &&
+        !w.batch->HasMerge();
+
     const SequenceNumber current_sequence = last_sequence + 1;
 
 #ifndef NDEBUG
@@ -4736,7 +4813,14 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         }
       }
 
-      if (!parallel) {
+      if (parallel_batch) {
+        w.status = WriteBatchInternal::InsertIntoParallel(
+            w.batch, current_sequence, versions_->GetColumnFamilySet(), &flush_scheduler_,
+            write_options.ignore_missing_column_families, this,
+            db_options_.memtable_insert_thread_pool, db_options_.memtable_insert_parallelism,
+            db_options_.min_memtable_insert_entries_per_thread);
+        status = w.FinalStatus();
+      } else if (!parallel) {
         status = WriteBatchInternal::InsertInto(
             write_group, current_sequence, column_family_memtables_.get(),
             &flush_scheduler_, write_options.ignore_missing_column_families,
@@ -378,6 +378,11 @@ class DBImpl : public DB {
   // compaction status.
   int BGCompactionsAllowed() const;
 
+  // Returns max compaction urgency score of the column families, that orders compactions of DBs
+  // sharing the Env.
+  // REQUIRES: mutex held.
+  double CompactionUrgencyScore();
+
   // Returns the list of live files in 'live' and the list
   // of all files in the filesystem in 'candidate_files'.
   // If force == false and the last call was less than
@@ -623,6 +628,8 @@ class DBImpl : public DB {
 
   uint64_t GetUncompressedSSTFileSize() override;
 
+  void CloseTableReadersIfIdle() override;
+
   void PrintStatistics();
 
   // dump rocksdb.stats to LOG
@@ -891,6 +898,10 @@ class DBImpl : public DB {
   // last time stats were dumped to LOG
   std::atomic<uint64_t> last_stats_dump_time_microsec_;
 
+  // Number of reads started, and its value at the previous CloseTableReadersIfIdle call.
+  std::atomic<uint64_t> num_reads_{0};
+  std::atomic<uint64_t> num_reads_at_idle_check_{0};
+
   // Each flush or compaction gets its own job id. this counter makes sure
   // they're unique
   std::atomic<int> next_job_id_;
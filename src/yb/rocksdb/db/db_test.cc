@@ -86,6 +86,7 @@
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/mock_env.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
 #include "yb/util/tsan_util.h"
@@ -5321,8 +5322,206 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, ParallelMemtableInsert) {
+  constexpr int kNumKeys = 10000;
+  std::unique_ptr<yb::ThreadPool> thread_pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("memtable-insert").set_max_threads(4).Build(&thread_pool));
+
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.memtable_insert_thread_pool = thread_pool.get();
+  options.memtable_insert_parallelism = 4;
+  options.min_memtable_insert_entries_per_thread = 100;
+  DestroyAndReopen(options);
+
+  WriteBatch batch;
+  for (int i = 0; i != kNumKeys; ++i) {
+    ASSERT_OK(batch.Put(Key(i), "v1_" + ToString(i)));
+  }
+  // Updates of the same key inserted by different threads should be ordered as in the batch.
+  for (int i = 0; i < kNumKeys; i += 10) {
+    ASSERT_OK(batch.Put(Key(i), "v2_" + ToString(i)));
+  }
+  for (int i = 5; i < kNumKeys; i += 10) {
+    ASSERT_OK(batch.Delete(Key(i)));
+  }
+  const SequenceNumber start_seqno = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(start_seqno + batch.Count(), db_->GetLatestSequenceNumber());
+
+  uint64_t num_entries = 0;
+  ASSERT_TRUE(db_->GetIntProperty(DB::Properties::kNumEntriesActiveMemTable, &num_entries));
+  ASSERT_EQ(batch.Count(), num_entries);
+
+  auto check = [this] {
+    for (int i = 0; i != kNumKeys; ++i) {
+      if (i % 10 == 0) {
+        ASSERT_EQ("v2_" + ToString(i), Get(Key(i)));
+      } else if (i % 10 == 5) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else {
+        ASSERT_EQ("v1_" + ToString(i), Get(Key(i)));
+      }
+    }
+  };
+  check();
+  ASSERT_OK(Flush());
+  check();
+
+  Close();
+  thread_pool->Shutdown();
+}
+
+TEST_F(DBTest, OrderedHashLinkListMemtable) {
+  Options options = CurrentOptions();
+  options.prefix_extractor.reset();
+  options.memtable_factory.reset(NewOrderedHashLinkListRepFactory(
+      std::shared_ptr<const SliceTransform>(NewFixedPrefixTransform(3)), 16 /* bucket_count */,
+      3 /* threshold_use_skiplist */));
+  DestroyAndReopen(options);
+  ASSERT_EQ(std::string("OrderedHashLinkListRepFactory"),
+            db_->GetOptions().memtable_factory->Name());
+
+  // Some prefixes have enough keys for their buckets to become skip lists.
+  const std::vector<std::string> prefixes = {"aaa", "bbb", "ccc", "ddd"};
+  std::vector<std::string> keys;
+  for (size_t i = 0; i != prefixes.size(); ++i) {
+    for (size_t j = 0; j <= i * 2; ++j) {
+      keys.push_back(prefixes[i] + ToString(j));
+    }
+  }
+  // Insert in reverse order, so both the hash buckets and the ordered list have to sort keys.
+  for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+    ASSERT_OK(Put(*it, "v" + *it));
+  }
+
+  // Total order iteration goes through all keys.
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    size_t idx = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++idx) {
+      ASSERT_LT(idx, keys.size());
+      ASSERT_EQ(keys[idx], iter->key().ToString());
+    }
+    ASSERT_EQ(keys.size(), idx);
+  }
+
+  // Prefix seek stays within the bucket of the seek target, in both directions.
+  ReadOptions prefix_read_options;
+  prefix_read_options.memtable_prefix_seek = true;
+  for (size_t i = 0; i != prefixes.size(); ++i) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(prefix_read_options));
+    iter->Seek(prefixes[i]);
+    for (size_t j = 0; j <= i * 2; ++j) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(prefixes[i] + ToString(j), iter->key().ToString());
+      ASSERT_EQ("v" + prefixes[i] + ToString(j), iter->value().ToString());
+      iter->Next();
+    }
+    for (size_t j = i * 2 + 1; j-- > 0;) {
+      if (j == i * 2) {
+        iter->Seek(prefixes[i] + ToString(j));
+      } else {
+        iter->Prev();
+      }
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(prefixes[i] + ToString(j), iter->key().ToString());
+    }
+  }
+
+  for (const auto& key : keys) {
+    ASSERT_EQ("v" + key, Get(key));
+  }
+  ASSERT_EQ("NOT_FOUND", Get("eee0"));
+
+  ASSERT_OK(Flush());
+  for (const auto& key : keys) {
+    ASSERT_EQ("v" + key, Get(key));
+  }
+}
+
+TEST_F(DBTest, CompressionDictionary) {
+  if (!ZSTD_Supported() || !ZSTD_TrainDictionarySupported()) {
+    return;
+  }
+  constexpr int kKeysPerFile = 2000;
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compression = kZSTDNotFinalCompression;
+  options.compression_opts.max_dict_bytes = 4096;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  auto value = [](int i) {
+    const auto id = ToString(i);
+    return "{\"id\": " + id + ", \"name\": \"user_" + id + "\", \"email\": \"user_" + id +
+           "@example.com\", \"tags\": [\"alpha\", \"beta\"], \"active\": " +
+           (i % 2 == 0 ? "true" : "false") + "}";
+  };
+
+  // The first file is compressed without a dictionary and gives samples to train it on, the
+  // second one is compressed with the dictionary.
+  for (int file = 0; file != 2; ++file) {
+    for (int i = file * kKeysPerFile; i != (file + 1) * kKeysPerFile; ++i) {
+      ASSERT_OK(Put(Key(i), value(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(2U, props.size());
+  const auto& first_file_props = props.begin()->second;
+  const auto& second_file_props = props.rbegin()->second;
+  auto compression_ratio = [](const TableProperties& props) {
+    return static_cast<double>(props.data_size) / (props.raw_key_size + props.raw_value_size);
+  };
+  ASSERT_LT(compression_ratio(*second_file_props), compression_ratio(*first_file_props));
+
+  // The dictionary is read from the file after reopen.
+  Reopen(options);
+  for (int i = 0; i != 2 * kKeysPerFile; ++i) {
+    ASSERT_EQ(value(i), Get(Key(i)));
+  }
+}
+
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest, DirectIOForCompaction) {
+  constexpr int kFiles = 3;
+  constexpr int kKeysPerFile = 1000;
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.use_direct_io_for_compaction = true;
+  DestroyAndReopen(options);
+  ASSERT_GT(dbfull()->GetDBOptions().compaction_readahead_size, 0U);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int file = 0; file != kFiles; ++file) {
+    for (int i = 0; i != kKeysPerFile; ++i) {
+      // Values of odd sizes, so file sizes are not aligned.
+      values.push_back(RandomString(&rnd, 100 + i % 7));
+      ASSERT_OK(Put(Key(file * kKeysPerFile + i), values.back()));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ(ToString(kFiles), FilesPerLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel(0));
+
+  for (int i = 0; i != kFiles * kKeysPerFile; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+  Reopen(options);
+  for (int i = 0; i != kFiles * kKeysPerFile; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
 TEST_F(DBTest, SanitizeNumThreads) {
   for (int attempt = 0; attempt < 2; attempt++) {
     const size_t kTotalTasks = 8;
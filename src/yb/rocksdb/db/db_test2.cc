@@ -22,6 +22,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cstdlib>
 #include "yb/rocksdb/db/db_test_util.h"
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/port/stack_trace.h"
 
 namespace rocksdb {
@@ -72,6 +73,130 @@ TEST_F(DBTest2, IteratorPropertyVersionNumber) {
   delete iter2;
   delete iter3;
 }
+
+namespace {
+
+std::vector<uint64_t> ListBlobFiles(Env* env, const std::string& dir) {
+  std::vector<std::string> files;
+  EXPECT_OK(env->GetChildren(dir, &files));
+  std::vector<uint64_t> result;
+  for (const auto& file : files) {
+    uint64_t number;
+    FileType type;
+    if (ParseFileName(file, &number, &type) && type == kBlobFile) {
+      result.push_back(number);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace
+
+TEST_F(DBTest2, BlobFiles) {
+  Options options = CurrentOptions();
+  options.min_blob_size = 100;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  const std::string large_value(1000, 'a');
+  ASSERT_OK(Put("key1", large_value));
+  ASSERT_OK(Put("key2", "small"));
+  ASSERT_OK(Flush());
+  auto blob_files = ListBlobFiles(env_, dbname_);
+  ASSERT_EQ(1, blob_files.size());
+
+  ASSERT_EQ(large_value, Get("key1"));
+  ASSERT_EQ("small", Get("key2"));
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("key1", iter->key().ToString());
+    ASSERT_EQ(large_value, iter->value().ToString());
+    iter->Next();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ("small", iter->value().ToString());
+  }
+
+  // With the age cutoff of 1.0 a compaction moves all values to its own blob file, so the blob
+  // file of the flush is deleted.
+  // key2 is written again, so the files overlap and the compaction is not a trivial move.
+  const std::string other_value(1000, 'b');
+  ASSERT_OK(Put("key2", "small"));
+  ASSERT_OK(Put("key3", other_value));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, ListBlobFiles(env_, dbname_).size());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  auto compacted_blob_files = ListBlobFiles(env_, dbname_);
+  ASSERT_EQ(1, compacted_blob_files.size());
+  ASSERT_GT(compacted_blob_files[0], blob_files[0]);
+  ASSERT_EQ(large_value, Get("key1"));
+  ASSERT_EQ(other_value, Get("key3"));
+
+  // Blob files are released when no value in them is live.
+  ASSERT_OK(Delete("key1"));
+  ASSERT_OK(Delete("key3"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, ListBlobFiles(env_, dbname_).size());
+  ASSERT_EQ("small", Get("key2"));
+
+  Reopen(options);
+  ASSERT_EQ("small", Get("key2"));
+  ASSERT_EQ("NOT_FOUND", Get("key1"));
+}
+
+// The blob file of a flushed SST file is recorded in the MANIFEST, so it is not deleted as
+// obsolete on reopen.
+TEST_F(DBTest2, BlobFilesSurviveReopen) {
+  Options options = CurrentOptions();
+  options.min_blob_size = 100;
+  options.disable_auto_compactions = true;
+  Reopen(options);
+
+  const std::string large_value(1000, 'a');
+  ASSERT_OK(Put("key1", large_value));
+  ASSERT_OK(Flush());
+  auto blob_files = ListBlobFiles(env_, dbname_);
+  ASSERT_EQ(1, blob_files.size());
+
+  Reopen(options);
+  ASSERT_EQ(blob_files, ListBlobFiles(env_, dbname_));
+  ASSERT_EQ(large_value, Get("key1"));
+
+  // The blob file of a compaction output, or of a trivially moved file, is kept as well.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Reopen(options);
+  ASSERT_EQ(1, ListBlobFiles(env_, dbname_).size());
+  ASSERT_EQ(large_value, Get("key1"));
+}
+
+TEST_F(DBTest2, CloseTableReadersIfIdle) {
+  Options options = CurrentOptions();
+  options.max_open_files = 100;
+  Reopen(options);
+
+  ASSERT_OK(Put("key1", "value1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("value1", Get("key1"));
+  Cache* table_cache = dbfull()->TEST_table_cache();
+  ASSERT_GT(table_cache->GetUsage(), 0);
+
+  // There was a read since the DB was opened, so it is not idle yet.
+  db_->CloseTableReadersIfIdle();
+  ASSERT_GT(table_cache->GetUsage(), 0);
+  db_->CloseTableReadersIfIdle();
+  ASSERT_EQ(0, table_cache->GetUsage());
+
+  // The table reader is opened again by the next read.
+  ASSERT_EQ("value1", Get("key1"));
+  ASSERT_GT(table_cache->GetUsage(), 0);
+  db_->CloseTableReadersIfIdle();
+  ASSERT_GT(table_cache->GetUsage(), 0);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
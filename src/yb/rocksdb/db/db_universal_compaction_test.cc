@@ -115,6 +115,15 @@ class DelayFilter : public CompactionFilter {
   DBTestBase* db_test;
 };
 
+// Test boundary values store reversed keys, so keys ending with a digit are put to the time window
+// of that digit.
+class LastDigitTimeWindowExtractor : public TimeWindowExtractor {
+ public:
+  uint64_t TimeWindow(const UserBoundaryValues& largest) override {
+    return test::GetBoundaryString(largest)[0] - '0';
+  }
+};
+
 class DelayFilterFactory : public CompactionFilterFactory {
  public:
   explicit DelayFilterFactory(DBTestBase* d) : db_test(d) {}
@@ -388,6 +397,82 @@ TEST_P(DBTestUniversalCompaction, UniversalCompactionSizeAmplification) {
   ASSERT_EQ(NumSortedRuns(1), 1);
 }
 
+TEST_P(DBTestUniversalCompaction, UniversalCompactionDeleteTriggered) {
+  if (num_levels_ != 1) {
+    return;
+  }
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.level0_file_num_compaction_trigger = 10;
+  options.compaction_options_universal.delete_triggered_compaction_percent = 30;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 100;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "value"));
+  }
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+  // There are no deletions, and there are too few files to trigger regular compaction.
+  ASSERT_EQ(NumSortedRuns(0), 1);
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Delete(Key(i)));
+  }
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+  // Half of the entries are deletions, so both files are compacted, and nothing is left.
+  ASSERT_EQ(NumSortedRuns(0), 0);
+}
+
+TEST_P(DBTestUniversalCompaction, UniversalCompactionTimeWindow) {
+  if (num_levels_ != 1) {
+    return;
+  }
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.level0_file_num_compaction_trigger = 3;
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  options.time_window_extractor = std::make_shared<LastDigitTimeWindowExtractor>();
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 10;
+  auto flush_window = [this](int window) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(Key(i) + "_" + std::to_string(window), "value"));
+    }
+    ASSERT_OK(Flush());
+    dbfull()->TEST_WaitForCompact();
+  };
+
+  // Files of the latest window are compacted only after the regular trigger.
+  flush_window(1);
+  flush_window(1);
+  ASSERT_EQ(NumSortedRuns(0), 2);
+
+  // Once a window is over, its files are compacted into one, but not with files of other windows.
+  flush_window(2);
+  ASSERT_EQ(NumSortedRuns(0), 2);
+
+  flush_window(2);
+  ASSERT_EQ(NumSortedRuns(0), 3);
+  flush_window(2);
+  ASSERT_EQ(NumSortedRuns(0), 2);
+
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(files.size(), 2);
+  std::set<std::string> windows;
+  for (const auto& file : files) {
+    windows.insert(test::GetBoundaryString(file.largest.user_values).substr(0, 1));
+  }
+  ASSERT_EQ(windows, std::set<std::string>({"1", "2"}));
+}
+
 TEST_P(DBTestUniversalCompaction, CompactFilesOnUniversalCompaction) {
   const int kTestKeySize = 16;
   const int kTestValueSize = 984;
@@ -660,6 +745,65 @@ INSTANTIATE_TEST_CASE_P(DBTestUniversalCompactionParallel,
                         ::testing::Combine(::testing::Values(1, 10),
                                            ::testing::Bool()));
 
+TEST_P(DBTestUniversalCompaction, SingleLevelSubcompactions) {
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.write_buffer_size = 100 << 10;  // 100KB
+  options.target_file_size_base = 32 << 10;  // 32KB
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_background_compactions = 4;
+  options.max_subcompactions = 4;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  std::atomic<size_t> num_subcompactions(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():NumSubcompactions", [&](void* arg) {
+        num_subcompactions.store(*static_cast<size_t*>(arg));
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const int kNumKeys = 4000;
+  for (int file = 0; file < 4; ++file) {
+    for (int i = file; i < kNumKeys; i += 4) {
+      ASSERT_OK(Put(Key(i), RandomString(&rnd, 100)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(Put(Key(0), "value0"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  dbfull()->TEST_WaitForCompact();
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+
+  // The compaction was split, and its outputs cover the same range of sequence numbers, so
+  // they are treated as a single sorted run and are not compacted again.
+  ASSERT_GT(num_subcompactions.load(), 1U);
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1U);
+  for (const auto& file : files) {
+    ASSERT_EQ(files[0].smallest.seqno, file.smallest.seqno);
+    ASSERT_EQ(files[0].largest.seqno, file.largest.seqno);
+  }
+  const auto num_files = files.size();
+  ASSERT_OK(Put(Key(1), "value1"));
+  ASSERT_OK(Flush());
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_EQ(num_files + 1, static_cast<size_t>(NumTableFilesAtLevel(0)));
+
+  ASSERT_EQ("value0", Get(Key(0)));
+  ASSERT_EQ("value1", Get(Key(1)));
+  Reopen(options);
+  ASSERT_EQ("value0", Get(Key(0)));
+  ASSERT_EQ("value1", Get(Key(1)));
+  for (int i = 2; i < kNumKeys; ++i) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+}
+
 TEST_P(DBTestUniversalCompaction, UniversalCompactionOptions) {
   Options options;
   options.compaction_style = kCompactionStyleUniversal;
@@ -877,6 +1021,54 @@ TEST_P(DBTestUniversalCompaction, UniversalCompactionCompressRatio2) {
   ASSERT_LT(TotalSize(), 120000U * 12 * 0.8 + 120000 * 2);
 }
 
+TEST_P(DBTestUniversalCompaction, UniversalCompactionCompressBySize) {
+  if (!Snappy_Supported()) {
+    return;
+  }
+  auto check_compression = [this](const std::string& expected) {
+    TablePropertiesCollection props;
+    ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+    ASSERT_FALSE(props.empty());
+    for (const auto& file_props : props) {
+      ASSERT_EQ(expected, file_props.second->compression_name) << file_props.first;
+    }
+  };
+
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.write_buffer_size = 100 << 10;     // 100KB
+  options.level0_file_num_compaction_trigger = 2;
+  options.num_levels = num_levels_;
+  options.compression = kSnappyCompression;
+  // Outputs are too small to be compressed.
+  options.min_compressed_output_size = 1ULL << 30;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  int key_idx = 0;
+  for (int num = 0; num < 4; num++) {
+    for (int i = 0; i < 12; i++) {
+      ASSERT_OK(Put(Key(key_idx), CompressibleString(&rnd, 10000)));
+      key_idx++;
+    }
+    ASSERT_OK(Flush());
+    dbfull()->TEST_WaitForCompact();
+  }
+  check_compression("NoCompression");
+  ASSERT_GT(TotalSize(), 120000U * 4);
+
+  // Outputs are compressed with the large output codec only.
+  options.compression = kNoCompression;
+  options.min_compressed_output_size = 0;
+  options.large_output_size = 1;
+  options.large_output_compression = kSnappyCompression;
+  Reopen(options);
+  ASSERT_OK(dbfull()->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  check_compression("Snappy");
+  ASSERT_LT(TotalSize(), 120000U * 4 * 0.9);
+}
+
 // Test that checks trivial move in universal compaction
 TEST_P(DBTestUniversalCompaction, UniversalCompactionTrivialMoveTest1) {
   int32_t trivial_move = 0;
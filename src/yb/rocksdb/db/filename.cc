@@ -44,6 +44,7 @@ static const char kRocksDbTFileExt[] = "sst";
 static const char kLevelDbTFileExt[] = "ldb";
 static const char kRocksDbTSBlockExtSuffix[] = "sblock";
 static const char kRocksDbTSBlockFileExt[] = "sst.sblock.0";
+static const char kBlobFileExt[] = "blob";
 
 // Given a path, flatten the path name by replacing all chars not in
 // {[0-9,a-z,A-Z,-,_,.]} with _. And append '_LOG\0' at the end.
@@ -101,6 +102,10 @@ std::string MakeTableFileName(const std::string& path, uint64_t number) {
   return MakeFileName(path, number, kRocksDbTFileExt);
 }
 
+std::string BlobFileName(const std::string& path, uint64_t number) {
+  return MakeFileName(path, number, kBlobFileExt);
+}
+
 std::string Rocks2LevelTableFileName(const std::string& fullname) {
   assert(fullname.size() > sizeof(kRocksDbTFileExt));
   if (fullname.size() <= sizeof(kRocksDbTFileExt)) {
@@ -354,6 +359,8 @@ bool ParseFileName(const std::string& fname, uint64_t* number,
       *type = kTableFile;
     } else if (suffix == Slice(kRocksDbTSBlockFileExt)) {
       *type = kTableSBlockFile;
+    } else if (suffix == Slice(kBlobFileExt)) {
+      *type = kBlobFile;
     } else if (suffix == Slice(kTempFileNameSuffix)) {
       *type = kTempFile;
     } else {
@@ -48,6 +48,7 @@ enum FileType {
   kDBLockFile,
   kTableFile,
   kTableSBlockFile,
+  kBlobFile,
   kDescriptorFile,
   kCurrentFile,
   kTempFile,
@@ -73,6 +74,10 @@ extern std::string ArchivedLogFileName(const std::string& dbname,
 
 extern std::string MakeTableFileName(const std::string& name, uint64_t number);
 
+// Return the name of the blob file with the specified number in the directory "path". Blob files
+// are numbered after the SST file whose flush or compaction created them.
+extern std::string BlobFileName(const std::string& path, uint64_t number);
+
 // Return the name of sstable with LevelDB suffix
 // created from RocksDB sstable suffixed name
 extern std::string Rocks2LevelTableFileName(const std::string& fullname);
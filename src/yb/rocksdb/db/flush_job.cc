@@ -261,6 +261,12 @@ Status FlushJob::WriteLevel0Table(const autovector<MemTable*>& mems,
                          << total_num_deletes << "memory_usage"
                          << total_memory_usage;
 
+    // A small flush output is compacted soon, so it is not worth compressing.
+    if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal &&
+        total_memory_usage < cfd_->ioptions()->min_compressed_output_size) {
+      output_compression_ = kNoCompression;
+    }
+
     TableFileCreationInfo info;
     {
       ScopedArenaIterator iter(
@@ -290,7 +296,8 @@ Status FlushJob::WriteLevel0Table(const autovector<MemTable*>& mems,
                      cfd_->internal_stats(),
                      db_options_.boundary_extractor.get(),
                      Env::IO_HIGH,
-                     &table_properties_);
+                     &table_properties_,
+                     cfd_->compression_dict_holder());
       info.table_properties = table_properties_;
       LogFlush(db_options_.info_log);
     }
@@ -125,6 +125,8 @@ static const std::string num_immutable_mem_table_flushed =
     "num-immutable-mem-table-flushed";
 static const std::string mem_table_flush_pending = "mem-table-flush-pending";
 static const std::string compaction_pending = "compaction-pending";
+static const std::string compaction_urgency_score = "compaction-urgency-score";
+static const std::string l0_delay_trigger_count = "l0-delay-trigger-count";
 static const std::string background_errors = "background-errors";
 static const std::string cur_size_active_mem_table =
                           "cur-size-active-mem-table";
@@ -175,6 +177,10 @@ const std::string DB::Properties::kMemTableFlushPending =
                       rocksdb_prefix + mem_table_flush_pending;
 const std::string DB::Properties::kCompactionPending =
                       rocksdb_prefix + compaction_pending;
+const std::string DB::Properties::kCompactionUrgencyScore =
+    rocksdb_prefix + compaction_urgency_score;
+const std::string DB::Properties::kL0DelayTriggerCount =
+    rocksdb_prefix + l0_delay_trigger_count;
 const std::string DB::Properties::kNumRunningCompactions =
     rocksdb_prefix + num_running_compactions;
 const std::string DB::Properties::kNumRunningFlushes =
@@ -244,6 +250,10 @@ const std::unordered_map<std::string,
      {false, nullptr, &InternalStats::HandleMemTableFlushPending}},
     {DB::Properties::kCompactionPending,
      {false, nullptr, &InternalStats::HandleCompactionPending}},
+    {DB::Properties::kCompactionUrgencyScore,
+     {false, nullptr, &InternalStats::HandleCompactionUrgencyScore}},
+    {DB::Properties::kL0DelayTriggerCount,
+     {false, nullptr, &InternalStats::HandleL0DelayTriggerCount}},
     {DB::Properties::kBackgroundErrors,
      {false, nullptr, &InternalStats::HandleBackgroundErrors}},
     {DB::Properties::kCurSizeActiveMemTable,
@@ -444,6 +454,20 @@ bool InternalStats::HandleCompactionPending(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleCompactionUrgencyScore(uint64_t* value, DBImpl* db,
+                                                 Version* version) {
+  const auto* vstorage = cfd_->current()->storage_info();
+  *value = static_cast<uint64_t>(100 * vstorage->CompactionUrgencyScore(
+      *cfd_->GetLatestMutableCFOptions(), cfd_->ioptions()->compaction_options_universal));
+  return true;
+}
+
+bool InternalStats::HandleL0DelayTriggerCount(uint64_t* value, DBImpl* db,
+                                              Version* version) {
+  *value = cfd_->current()->storage_info()->l0_delay_trigger_count();
+  return true;
+}
+
 bool InternalStats::HandleNumRunningCompactions(uint64_t* value, DBImpl* db,
                                                 Version* version) {
   *value = db->num_total_running_compactions_;
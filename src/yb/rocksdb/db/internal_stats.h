@@ -330,6 +330,8 @@ class InternalStats {
                                   Version* version);
   bool HandleNumRunningFlushes(uint64_t* value, DBImpl* db, Version* version);
   bool HandleCompactionPending(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleCompactionUrgencyScore(uint64_t* value, DBImpl* db, Version* version);
+  bool HandleL0DelayTriggerCount(uint64_t* value, DBImpl* db, Version* version);
   bool HandleNumRunningCompactions(uint64_t* value, DBImpl* db,
                                    Version* version);
   bool HandleBackgroundErrors(uint64_t* value, DBImpl* db, Version* version);
@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "yb/rocksdb/db/column_family.h"
@@ -31,6 +33,7 @@
 
 namespace rocksdb {
 
+class BlobFileCache;
 class MemTable;
 
 struct JobContext {
@@ -64,6 +67,12 @@ struct JobContext {
   // the list of all live sst files that cannot be deleted
   std::vector<FileDescriptor> sst_live;
 
+  // numbers of blob files referenced by live sst files
+  std::unordered_set<uint64_t> blob_live;
+
+  // blob file caches of column families, to close readers of deleted blob files
+  std::vector<std::shared_ptr<BlobFileCache>> blob_file_caches;
+
   // a list of sst files that we need to delete
   std::vector<FileMetaData*> sst_delete_files;
 
@@ -68,6 +68,7 @@ namespace {
 EntryType GetEntryType(ValueType value_type) {
   switch (value_type) {
     case kTypeValue:
+    case kTypeBlobIndex:
       return kEntryPut;
     case kTypeDeletion:
       return kEntryDelete;
@@ -56,6 +56,12 @@ bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b) {
   return a->fd.GetNumber() > b->fd.GetNumber();
 }
 
+bool InSameSortedRun(const FileMetaData& a, const FileMetaData& b) {
+  // Files added by DB::AddFile() have zero sequence numbers, and could overlap.
+  return a.largest.seqno != 0 &&
+         a.smallest.seqno == b.smallest.seqno && a.largest.seqno == b.largest.seqno;
+}
+
 namespace {
 bool BySmallestKey(FileMetaData* a, FileMetaData* b,
                    const InternalKeyComparator* cmp) {
@@ -153,7 +159,8 @@ class VersionBuilder::Rep {
           assert(f1->largest.seqno > f2->largest.seqno ||
                  // We can have multiple files with seqno = 0 as a result of
                  // using DB::AddFile()
-                 (f1->largest.seqno == 0 && f2->largest.seqno == 0));
+                 (f1->largest.seqno == 0 && f2->largest.seqno == 0) ||
+                 InSameSortedRun(*f1, *f2));
         } else {
           assert(level_nonzero_cmp_(f1, f2));
 
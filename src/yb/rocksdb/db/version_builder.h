@@ -54,4 +54,9 @@ class VersionBuilder {
 };
 
 extern bool NewestFirstBySeqNo(FileMetaData* a, FileMetaData* b);
+
+// Returns true if level 0 files a and b, that are adjacent in level 0 order, belong to the same
+// sorted run. It is true for outputs of the same compaction split into subcompactions: such files
+// have disjoint key ranges and share the sequence number range of the whole compaction output.
+extern bool InSameSortedRun(const FileMetaData& a, const FileMetaData& b);
 }  // namespace rocksdb
@@ -201,6 +201,9 @@ bool VersionEdit::EncodeTo(VersionEditPB* dst) const {
     if (f.imported) {
       new_file.set_imported(true);
     }
+    for (auto blob_file : f.blob_files) {
+      new_file.add_blob_files(blob_file);
+    }
   }
 
   // 0 is default and does not need to be explicitly written
@@ -283,6 +286,7 @@ Status VersionEdit::DecodeFrom(BoundaryValuesExtractor* extractor, const Slice&
     meta.marked_for_compaction = source.marked_for_compaction();
     max_level_ = std::max(max_level_, level);
     meta.imported = source.imported();
+    meta.blob_files.insert(source.blob_files().begin(), source.blob_files().end());
   }
 
   column_family_ = pb.column_family();
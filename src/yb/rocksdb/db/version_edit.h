@@ -124,6 +124,9 @@ struct FileMetaData {
   bool marked_for_compaction;  // True if client asked us nicely to compact this
                                // file.
 
+  // Numbers of blob files that this file references values in.
+  std::set<uint64_t> blob_files;
+
   FileMetaData();
 
   // REQUIRED: Keys must be given to the function in sorted order (it expects
@@ -197,6 +200,7 @@ class VersionEdit {
     nf.largest = f.largest;
     nf.marked_for_compaction = f.marked_for_compaction;
     nf.imported = f.imported;
+    nf.blob_files = f.blob_files;
     new_files_.emplace_back(level, std::move(nf));
   }
 
@@ -1219,6 +1219,42 @@ void VersionStorageInfo::EstimateCompactionBytesNeeded(
   }
 }
 
+double VersionStorageInfo::CompactionUrgencyScore(
+    const MutableCFOptions& mutable_cf_options,
+    const CompactionOptionsUniversal& compaction_options_universal) const {
+  int num_sorted_runs = 0;
+  uint64_t total_size = 0;
+  uint64_t oldest_run_size = 0;
+  const FileMetaData* prev = nullptr;
+  for (auto* f : files_[0]) {
+    if (!prev || !InSameSortedRun(*prev, *f)) {
+      num_sorted_runs++;
+      oldest_run_size = 0;
+    }
+    total_size += f->fd.GetTotalFileSize();
+    oldest_run_size += f->fd.GetTotalFileSize();
+    prev = f;
+  }
+  for (int level = 1; level < num_levels(); level++) {
+    if (!files_[level].empty()) {
+      num_sorted_runs++;
+      oldest_run_size = NumLevelBytes(level);
+      total_size += oldest_run_size;
+    }
+  }
+  double score = mutable_cf_options.level0_file_num_compaction_trigger > 0
+      ? static_cast<double>(num_sorted_runs) / mutable_cf_options.level0_file_num_compaction_trigger
+      : 0;
+  if (compaction_style_ == kCompactionStyleUniversal && num_sorted_runs > 1 &&
+      oldest_run_size > 0 && compaction_options_universal.max_size_amplification_percent > 0) {
+    double space_amp_percent =
+        100.0 * (total_size - oldest_run_size) / oldest_run_size;
+    score = std::max(
+        score, space_amp_percent / compaction_options_universal.max_size_amplification_percent);
+  }
+  return score;
+}
+
 void VersionStorageInfo::ComputeCompactionScore(
     const MutableCFOptions& mutable_cf_options,
     const CompactionOptionsFIFO& compaction_options_fifo) {
@@ -1238,11 +1274,15 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          if (!prev || !InSameSortedRun(*prev, *f)) {
+            num_sorted_runs++;
+          }
         }
+        prev = f;
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
         // For universal compaction, we use level0 score to indicate
@@ -1874,15 +1914,15 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableCFOptions& ioptions,
                                             const MutableCFOptions& options) {
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
+  // Files of the same sorted run are counted once.
   int num_l0_count = 0;
-  if (options.max_file_size_for_compaction == std::numeric_limits<uint64_t>::max()) {
-    num_l0_count = static_cast<int>(files_[0].size());
-  } else {
-    for (const auto& file : files_[0]) {
-      if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction) {
-        ++num_l0_count;
-      }
+  const FileMetaData* prev = nullptr;
+  for (const auto& file : files_[0]) {
+    if (file->fd.GetTotalFileSize() <= options.max_file_size_for_compaction &&
+        (!prev || !InSameSortedRun(*prev, *file))) {
+      ++num_l0_count;
     }
+    prev = file;
   }
   if (compaction_style_ == kCompactionStyleUniversal) {
     // For universal compaction, we use level0 score to indicate
@@ -2029,11 +2069,15 @@ uint64_t VersionStorageInfo::EstimateLiveDataSize() const {
 }
 
 
-void Version::AddLiveFiles(std::vector<FileDescriptor>* live) {
+void Version::AddLiveFiles(std::vector<FileDescriptor>* live,
+                           std::unordered_set<uint64_t>* live_blob_files) {
   for (int level = 0; level < storage_info_.num_levels(); level++) {
     const std::vector<FileMetaData*>& files = storage_info_.files_[level];
     for (const auto& file : files) {
       live->push_back(file->fd);
+      if (live_blob_files != nullptr) {
+        live_blob_files->insert(file->blob_files.begin(), file->blob_files.end());
+      }
     }
   }
 }
@@ -2092,7 +2136,8 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(
+          db_options->env->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -3415,7 +3460,8 @@ uint64_t VersionSet::ApproximateSize(Version* v, const FdWithBoundaries& f, cons
   return result;
 }
 
-void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
+void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list,
+                              std::unordered_set<uint64_t>* live_blob_files) {
   // pre-calculate space requirement
   int64_t total_files = 0;
   for (auto cfd : *column_family_set_) {
@@ -3438,7 +3484,7 @@ void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
     Version* dummy_versions = cfd->dummy_versions();
     for (Version* v = dummy_versions->next_; v != dummy_versions;
          v = v->next_) {
-      v->AddLiveFiles(live_list);
+      v->AddLiveFiles(live_list, live_blob_files);
       if (v == current) {
         found_current = true;
       }
@@ -3446,7 +3492,7 @@ void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
     if (!found_current && current != nullptr) {
       // Should never happen unless it is a bug.
       assert(false);
-      current->AddLiveFiles(live_list);
+      current->AddLiveFiles(live_list, live_blob_files);
     }
   }
 }
@@ -3457,6 +3503,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
   read_options.verify_checksums =
     c->mutable_cf_options()->verify_checksums_in_compaction;
   read_options.fill_cache = false;
+  read_options.resolve_blob_indexes = false;
   if (c->ShouldFormSubcompactions()) {
     read_options.total_order_seek = true;
   }
@@ -3484,7 +3531,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
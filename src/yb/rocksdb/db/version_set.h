@@ -43,6 +43,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -142,6 +143,16 @@ class VersionStorageInfo {
       const MutableCFOptions& mutable_cf_options,
       const CompactionOptionsFIFO& compaction_options_fifo);
 
+  // Returns how urgent it is to compact this version, used to order compactions of DBs sharing
+  // the same Env. It is the max of read amplification, as the number of sorted runs relative to
+  // level0_file_num_compaction_trigger, and for universal compaction of space amplification
+  // relative to max_size_amplification_percent. Unlike compaction scores, files being compacted
+  // are also counted, so picking a compaction does not reduce the score.
+  // REQUIRES: db_mutex held!!
+  double CompactionUrgencyScore(
+      const MutableCFOptions& mutable_cf_options,
+      const CompactionOptionsUniversal& compaction_options_universal) const;
+
   // Estimate est_comp_needed_bytes_
   void EstimateCompactionBytesNeeded(
       const MutableCFOptions& mutable_cf_options);
@@ -475,8 +486,10 @@ class Version {
   // and return true. Otherwise, return false.
   bool Unref();
 
-  // Add all files listed in the current version to *live.
-  void AddLiveFiles(std::vector<FileDescriptor>* live);
+  // Add all files listed in the current version to *live, and blob files they reference to
+  // *live_blob_files if it is not null.
+  void AddLiveFiles(std::vector<FileDescriptor>* live,
+                    std::unordered_set<uint64_t>* live_blob_files = nullptr);
 
   // Return a human readable string that describes this version's contents.
   std::string DebugString(bool hex = false) const;
@@ -715,8 +728,10 @@ class VersionSet {
   // The caller should delete the iterator when no longer needed.
   InternalIterator* MakeInputIterator(Compaction* c);
 
-  // Add all files listed in any live version to *live.
-  void AddLiveFiles(std::vector<FileDescriptor>* live_list);
+  // Add all files listed in any live version to *live, and blob files they reference to
+  // *live_blob_files if it is not null.
+  void AddLiveFiles(std::vector<FileDescriptor>* live_list,
+                    std::unordered_set<uint64_t>* live_blob_files = nullptr);
 
   // Return the approximate size of data to be scanned for range [start, end)
   // in levels [start_level, end_level). If end_level == 0 it will search
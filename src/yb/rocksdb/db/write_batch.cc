@@ -43,6 +43,7 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
 #include <vector>
@@ -62,6 +63,9 @@
 
 #include "yb/gutil/macros.h"
 
+#include "yb/util/countdown_latch.h"
+#include "yb/util/threadpool.h"
+
 namespace rocksdb {
 
 // anon namespace for file-local types
@@ -288,13 +292,28 @@ Status WriteBatch::Iterate(Handler* handler) const {
   }
 
   input.remove_prefix(kHeader);
-  Slice key, value, blob;
   size_t found = 0;
   Status s;
 
   if (frontiers_) {
     s = handler->Frontiers(*frontiers_);
   }
+  if (s.ok()) {
+    s = IterateRecords(input, handler, &found);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  if (found != WriteBatchInternal::Count(this)) {
+    return STATUS(Corruption, "WriteBatch has wrong count");
+  } else {
+    return Status::OK();
+  }
+}
+
+Status WriteBatch::IterateRecords(Slice input, Handler* handler, size_t* found) const {
+  Slice key, value, blob;
+  Status s;
   while (s.ok() && !input.empty() && handler->Continue()) {
     char tag = 0;
     uint32_t column_family = 0;  // default
@@ -311,28 +330,28 @@ Status WriteBatch::Iterate(Handler* handler) const {
         assert(content_flags_.load(std::memory_order_relaxed) &
                (ContentFlags::DEFERRED | ContentFlags::HAS_PUT));
         s = handler->PutCF(column_family, key, value);
-        found++;
+        ++*found;
         break;
       case kTypeColumnFamilyDeletion:
       case kTypeDeletion:
         assert(content_flags_.load(std::memory_order_relaxed) &
                (ContentFlags::DEFERRED | ContentFlags::HAS_DELETE));
         s = handler->DeleteCF(column_family, key);
-        found++;
+        ++*found;
         break;
       case kTypeColumnFamilySingleDeletion:
       case kTypeSingleDeletion:
         assert(content_flags_.load(std::memory_order_relaxed) &
                (ContentFlags::DEFERRED | ContentFlags::HAS_SINGLE_DELETE));
         s = handler->SingleDeleteCF(column_family, key);
-        found++;
+        ++*found;
         break;
       case kTypeColumnFamilyMerge:
       case kTypeMerge:
         assert(content_flags_.load(std::memory_order_relaxed) &
                (ContentFlags::DEFERRED | ContentFlags::HAS_MERGE));
         s = handler->MergeCF(column_family, key, value);
-        found++;
+        ++*found;
         break;
       case kTypeLogData:
         handler->LogData(blob);
@@ -341,14 +360,7 @@ Status WriteBatch::Iterate(Handler* handler) const {
         return STATUS(Corruption, "unknown WriteBatch tag");
     }
   }
-  if (!s.ok()) {
-    return s;
-  }
-  if (found != WriteBatchInternal::Count(this)) {
-    return STATUS(Corruption, "WriteBatch has wrong count");
-  } else {
-    return Status::OK();
-  }
+  return s;
 }
 
 uint32_t WriteBatchInternal::Count(const WriteBatch* b) {
@@ -887,6 +899,110 @@ Status WriteBatchInternal::InsertInto(const WriteBatch* batch,
   return batch->Iterate(&inserter);
 }
 
+Status WriteBatchInternal::InsertIntoParallel(const WriteBatch* batch,
+                                              SequenceNumber sequence,
+                                              ColumnFamilySet* column_family_set,
+                                              FlushScheduler* flush_scheduler,
+                                              bool ignore_missing_column_families,
+                                              DB* db,
+                                              yb::ThreadPool* thread_pool,
+                                              size_t parallelism,
+                                              size_t min_entries_per_chunk) {
+  DCHECK(!batch->HasMerge());
+
+  struct Chunk {
+    Slice input;
+    SequenceNumber sequence;
+    size_t count;
+    Status status;
+  };
+
+  Slice input(batch->rep_);
+  if (input.size() < kHeader) {
+    return STATUS(Corruption, "malformed WriteBatch (too small)");
+  }
+  input.remove_prefix(kHeader);
+
+  const size_t total_count = Count(batch);
+  const size_t entries_per_chunk = std::max(
+      min_entries_per_chunk, (total_count + parallelism - 1) / std::max<size_t>(parallelism, 1));
+
+  // Split records into chunks of consecutive updates. Since records have variable length, the
+  // batch is scanned once to find chunk boundaries.
+  std::vector<Chunk> chunks;
+  {
+    const char* chunk_start = input.cdata();
+    SequenceNumber chunk_sequence = sequence;
+    size_t chunk_count = 0;
+    Slice key, value, blob;
+    while (!input.empty()) {
+      char tag = 0;
+      uint32_t column_family = 0;
+      RETURN_NOT_OK(ReadRecordFromWriteBatch(
+          &input, &tag, &column_family, &key, &value, &blob));
+      if (tag != kTypeLogData) {
+        ++chunk_count;
+      }
+      if (chunk_count == entries_per_chunk || input.empty()) {
+        chunks.push_back(Chunk{
+            Slice(chunk_start, input.cdata() - chunk_start), chunk_sequence, chunk_count,
+            Status::OK()});
+        chunk_start = input.cdata();
+        chunk_sequence += chunk_count;
+        chunk_count = 0;
+      }
+    }
+    if (chunk_sequence - sequence != total_count) {
+      return STATUS(Corruption, "WriteBatch has wrong count");
+    }
+  }
+
+  auto insert_chunk = [=](Chunk* chunk, bool apply_frontiers) {
+    // ColumnFamilyMemTables caches the current column family, so each thread uses its own.
+    ColumnFamilyMemTablesImpl memtables(column_family_set);
+    MemTableInserter inserter(
+        chunk->sequence, &memtables, flush_scheduler, ignore_missing_column_families,
+        0 /* log_number */, db, true /* dont_filter_deletes */,
+        true /* concurrent_memtable_writes */);
+    // Merging frontiers into the memtable is not thread-safe, so it is done by a single thread.
+    if (apply_frontiers && batch->Frontiers()) {
+      chunk->status = inserter.Frontiers(*batch->Frontiers());
+      if (!chunk->status.ok()) {
+        return;
+      }
+    }
+    size_t found = 0;
+    chunk->status = batch->IterateRecords(chunk->input, &inserter, &found);
+    if (chunk->status.ok() && found != chunk->count) {
+      chunk->status = STATUS(Corruption, "WriteBatch has wrong count");
+    }
+  };
+
+  if (chunks.empty()) {
+    chunks.push_back(Chunk{input, sequence, 0, Status::OK()});
+  }
+  yb::CountDownLatch latch(static_cast<int>(chunks.size() - 1));
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    auto* chunk = &chunks[i];
+    auto submit_status = thread_pool->SubmitFunc([chunk, &insert_chunk, &latch] {
+      insert_chunk(chunk, false /* apply_frontiers */);
+      latch.CountDown();
+    });
+    if (!submit_status.ok()) {
+      // The pool is shutting down or overloaded, insert the chunk from the calling thread.
+      insert_chunk(chunk, false /* apply_frontiers */);
+      latch.CountDown();
+    }
+  }
+  insert_chunk(&chunks[0], true /* apply_frontiers */);
+  latch.Wait();
+
+  for (const auto& chunk : chunks) {
+    RETURN_NOT_OK(chunk.status);
+  }
+  return Status::OK();
+}
+
 void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   DCHECK_GE(contents.size(), kHeader);
   b->rep_.assign(contents.cdata(), contents.size());
@@ -33,11 +33,18 @@
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/autovector.h"
 
+namespace yb {
+
+class ThreadPool;
+
+}
+
 namespace rocksdb {
 
 class MemTable;
 class FlushScheduler;
 class ColumnFamilyData;
+class ColumnFamilySet;
 
 class ColumnFamilyMemTables {
  public:
@@ -170,6 +177,24 @@ class WriteBatchInternal {
                            const bool dont_filter_deletes = true,
                            bool concurrent_memtable_writes = false);
 
+  // Inserts the batch into memtables from several threads, assigning sequence numbers starting
+  // from sequence. Updates of the batch are split into up to parallelism chunks of consecutive
+  // updates, with at least min_entries_per_chunk updates each. The first chunk and the frontiers
+  // of the batch are inserted by the calling thread, other chunks by threads of thread_pool.
+  // Returns when all chunks are inserted.
+  //
+  // The caller should be the only writer, and memtables should support concurrent inserts.
+  // The batch should not contain merges.
+  static Status InsertIntoParallel(const WriteBatch* batch,
+                                   SequenceNumber sequence,
+                                   ColumnFamilySet* column_family_set,
+                                   FlushScheduler* flush_scheduler,
+                                   bool ignore_missing_column_families,
+                                   DB* db,
+                                   yb::ThreadPool* thread_pool,
+                                   size_t parallelism,
+                                   size_t min_entries_per_chunk);
+
   static void Append(WriteBatch* dst, const WriteBatch* src);
 
   // Returns the byte size of appending a WriteBatch with ByteSize
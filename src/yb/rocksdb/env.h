@@ -105,6 +105,14 @@ struct EnvOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then read data with direct I/O, bypassing the OS page cache. Ignored when
+  // use_mmap_reads is true.
+  bool use_direct_reads = false;
+
+  // If true, then write data with direct I/O, bypassing the OS page cache. Ignored when
+  // use_mmap_writes is true.
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -306,6 +314,16 @@ class Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) = 0;
 
+  // Same as Schedule, but queued jobs with higher score are started first. Jobs with equal score,
+  // and jobs scheduled by Schedule, that are treated as having the highest score, are started in
+  // the order they were scheduled. So when several DBs share the Env, the most urgent of their
+  // compactions runs first. The default implementation ignores the score.
+  virtual void ScheduleWithScore(void (*function)(void* arg), void* arg, double score,
+                                 Priority pri = LOW, void* tag = nullptr,
+                                 void (*unschedFunction)(void* arg) = 0) {
+    Schedule(function, arg, pri, tag, unschedFunction);
+  }
+
   // Arrange to remove jobs for given arg from the queue_ if they are not
   // already scheduled. Caller is expected to have exclusive lock on arg.
   virtual int UnSchedule(void* arg, Priority pri) { return 0; }
@@ -387,6 +405,17 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for reading compaction input table files.
+  // Default implementation enables direct reads if db_options.use_direct_io_for_compaction is set.
+  virtual EnvOptions OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                                    const DBOptions& db_options) const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for writing compaction output table files.
+  // Default implementation enables direct writes if db_options.use_direct_io_for_compaction is
+  // set.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -490,6 +519,14 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asks the platform to start reading [offset, offset + n) in the background, so that subsequent
+  // reads of this range do not block on I/O. Does not wait for the data to be read.
+  virtual void Readahead(uint64_t offset, size_t n) {}
+
+  // Whether Read returns slices pointing into a memory mapping of the file, that stay valid while
+  // the file is open, instead of copying data to the scratch buffer.
+  virtual bool IsMemoryMapped() const { return false; }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -932,6 +969,11 @@ class EnvWrapper : public Env {
     return target_->Schedule(f, a, pri, tag, u);
   }
 
+  void ScheduleWithScore(void (*f)(void* arg), void* a, double score, Priority pri,
+                         void* tag = nullptr, void (*u)(void* arg) = 0) override {
+    return target_->ScheduleWithScore(f, a, score, pri, tag, u);
+  }
+
   int UnSchedule(void* tag, Priority pri) override {
     return target_->UnSchedule(tag, pri);
   }
@@ -35,6 +35,9 @@ class MemTracker;
 
 namespace rocksdb {
 
+class BlobFileCache;
+class TimeWindowExtractor;
+
 // ImmutableCFOptions is a data struct used by RocksDB internal. It contains a
 // subset of Options that should not be changed during the entire lifetime
 // of DB. You shouldn't need to access this data structure unless you are
@@ -130,6 +133,21 @@ struct ImmutableCFOptions {
   std::shared_ptr<Cache> row_cache;
 
   std::shared_ptr<yb::MemTracker> mem_tracker;
+
+  uint64_t min_blob_size;
+
+  double blob_garbage_collection_age_cutoff;
+
+  uint64_t min_compressed_output_size;
+
+  uint64_t large_output_size;
+
+  CompressionType large_output_compression;
+
+  // Readers of blob files of the column family, shared by its tables.
+  std::shared_ptr<BlobFileCache> blob_file_cache;
+
+  TimeWindowExtractor* time_window_extractor;
 };
 
 }  // namespace rocksdb
@@ -180,7 +180,8 @@ class HashLinkListRep : public MemTableRep {
                   size_t bucket_size, uint32_t threshold_use_skiplist,
                   size_t huge_page_tlb_size, Logger* logger,
                   int bucket_entries_logging_threshold,
-                  bool if_log_bucket_dist_when_flash);
+                  bool if_log_bucket_dist_when_flash,
+                  bool keep_total_order);
 
   KeyHandle Allocate(const size_t len, char** buf) override;
 
@@ -221,6 +222,10 @@ class HashLinkListRep : public MemTableRep {
   int bucket_entries_logging_threshold_;
   bool if_log_bucket_dist_when_flash_;
 
+  // All entries in total order, when keep_total_order is set. Makes total order iteration cheap,
+  // instead of sorting all entries of the memtable for each iterator.
+  std::unique_ptr<MemtableSkipList> full_list_;
+
   bool LinkListContains(Node* head, const Slice& key) const;
 
   SkipListBucketHeader* GetSkipListBucketHeader(Pointer* first_next_pointer)
@@ -264,11 +269,17 @@ class HashLinkListRep : public MemTableRep {
 
   Node* FindGreaterOrEqualInBucket(Node* head, const Slice& key) const;
 
+  // Returns the last node of the bucket with a key less than the key of the given node.
+  Node* FindLessInBucket(Node* head, const Node* node) const;
+
   class FullListIterator : public MemTableRep::Iterator {
    public:
     explicit FullListIterator(MemtableSkipList* list, Allocator* allocator)
         : iter_(list), full_list_(list), allocator_(allocator) {}
 
+    // Iterates the list owned by the memtable.
+    explicit FullListIterator(const MemtableSkipList* list) : iter_(list) {}
+
     virtual ~FullListIterator() {
     }
 
@@ -347,12 +358,12 @@ class HashLinkListRep : public MemTableRep {
       node_ = node_->Next();
     }
 
-    // Advances to the previous position.
+    // Advances to the previous position within the bucket.
     // REQUIRES: Valid()
     void Prev() override {
-      // Prefix iterator does not support total order.
-      // We simply set the iterator to invalid state
-      Reset(nullptr);
+      assert(Valid());
+      // Buckets are short singly linked lists, so the previous node is found from the head.
+      node_ = hash_link_list_rep_->FindLessInBucket(head_, node_);
     }
 
     // Advance to the first entry with a key >= target
@@ -452,6 +463,14 @@ class HashLinkListRep : public MemTableRep {
       }
     }
 
+    void Prev() override {
+      if (skip_list_iter_) {
+        skip_list_iter_->Prev();
+      } else {
+        HashLinkListRep::LinkListIterator::Prev();
+      }
+    }
+
    private:
     // the underlying memtable
     const HashLinkListRep& memtable_rep_;
@@ -486,7 +505,8 @@ HashLinkListRep::HashLinkListRep(const MemTableRep::KeyComparator& compare,
                                  uint32_t threshold_use_skiplist,
                                  size_t huge_page_tlb_size, Logger* logger,
                                  int bucket_entries_logging_threshold,
-                                 bool if_log_bucket_dist_when_flash)
+                                 bool if_log_bucket_dist_when_flash,
+                                 bool keep_total_order)
     : MemTableRep(allocator),
       bucket_size_(bucket_size),
       // Threshold to use skip list doesn't make sense if less than 3, so we
@@ -496,7 +516,8 @@ HashLinkListRep::HashLinkListRep(const MemTableRep::KeyComparator& compare,
       compare_(compare),
       logger_(logger),
       bucket_entries_logging_threshold_(bucket_entries_logging_threshold),
-      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash) {
+      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash),
+      full_list_(keep_total_order ? new MemtableSkipList(compare, allocator) : nullptr) {
   char* mem = allocator_->AllocateAligned(sizeof(Pointer) * bucket_size,
                                       huge_page_tlb_size, logger);
 
@@ -562,6 +583,9 @@ Node* HashLinkListRep::GetLinkListFirstNode(Pointer* first_next_pointer) const {
 void HashLinkListRep::Insert(KeyHandle handle) {
   Node* x = static_cast<Node*>(handle);
   assert(!Contains(x->key));
+  if (full_list_) {
+    full_list_->Insert(x->key);
+  }
   Slice internal_key = GetLengthPrefixedSlice(x->key);
   auto transformed = GetPrefix(internal_key);
   auto& bucket = buckets_[GetHash(transformed)];
@@ -729,6 +753,14 @@ void HashLinkListRep::Get(const LookupKey& k, void* callback_args,
 }
 
 MemTableRep::Iterator* HashLinkListRep::GetIterator(Arena* alloc_arena) {
+  if (full_list_) {
+    if (alloc_arena == nullptr) {
+      return new FullListIterator(full_list_.get());
+    }
+    auto mem = alloc_arena->AllocateAligned(sizeof(FullListIterator));
+    return new (mem) FullListIterator(full_list_.get());
+  }
+
   // allocate a new arena of similar size to the one currently in use
   Arena* new_arena = new Arena(allocator_->BlockSize());
   auto list = new MemtableSkipList(compare_, new_arena);
@@ -811,15 +843,23 @@ Node* HashLinkListRep::FindGreaterOrEqualInBucket(Node* head,
   return x;
 }
 
+Node* HashLinkListRep::FindLessInBucket(Node* head, const Node* node) const {
+  Node* prev = nullptr;
+  for (Node* x = head; x != nullptr && x != node; x = x->Next()) {
+    prev = x;
+  }
+  return prev;
+}
+
 } // anon namespace
 
 MemTableRep* HashLinkListRepFactory::CreateMemTableRep(
     const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
     const SliceTransform* transform, Logger* logger) {
-  return new HashLinkListRep(compare, allocator, transform, bucket_count_,
-                             threshold_use_skiplist_, huge_page_tlb_size_,
+  return new HashLinkListRep(compare, allocator, transform_ ? transform_.get() : transform,
+                             bucket_count_, threshold_use_skiplist_, huge_page_tlb_size_,
                              logger, bucket_entries_logging_threshold_,
-                             if_log_bucket_dist_when_flash_);
+                             if_log_bucket_dist_when_flash_, keep_total_order_);
 }
 
 MemTableRepFactory* NewHashLinkListRepFactory(
@@ -831,5 +871,14 @@ MemTableRepFactory* NewHashLinkListRepFactory(
       bucket_entries_logging_threshold, if_log_bucket_dist_when_flash);
 }
 
+MemTableRepFactory* NewOrderedHashLinkListRepFactory(
+    std::shared_ptr<const SliceTransform> transform, size_t bucket_count,
+    uint32_t threshold_use_skiplist) {
+  return new HashLinkListRepFactory(
+      bucket_count, threshold_use_skiplist, 0 /* huge_page_tlb_size */,
+      4096 /* bucket_entries_logging_threshold */, false /* if_log_bucket_dist_when_flash */,
+      std::move(transform), true /* keep_total_order */);
+}
+
 } // namespace rocksdb
 #endif  // ROCKSDB_LITE
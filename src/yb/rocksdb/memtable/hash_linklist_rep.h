@@ -23,6 +23,8 @@
 
 #pragma once
 #ifndef ROCKSDB_LITE
+#include <memory>
+
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/memtablerep.h"
 
@@ -34,12 +36,16 @@ class HashLinkListRepFactory : public MemTableRepFactory {
                                   uint32_t threshold_use_skiplist,
                                   size_t huge_page_tlb_size,
                                   int bucket_entries_logging_threshold,
-                                  bool if_log_bucket_dist_when_flash)
+                                  bool if_log_bucket_dist_when_flash,
+                                  std::shared_ptr<const SliceTransform> transform = nullptr,
+                                  bool keep_total_order = false)
       : bucket_count_(bucket_count),
         threshold_use_skiplist_(threshold_use_skiplist),
         huge_page_tlb_size_(huge_page_tlb_size),
         bucket_entries_logging_threshold_(bucket_entries_logging_threshold),
-        if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash) {}
+        if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash),
+        transform_(std::move(transform)),
+        keep_total_order_(keep_total_order) {}
 
   virtual ~HashLinkListRepFactory() {}
 
@@ -47,8 +53,10 @@ class HashLinkListRepFactory : public MemTableRepFactory {
       const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
       const SliceTransform* transform, Logger* logger) override;
 
+  // Column family options are sanitized to use a skip list instead of HashLinkListRepFactory
+  // without prefix extractor, so the factory with its own transform has a different name.
   virtual const char* Name() const override {
-    return "HashLinkListRepFactory";
+    return transform_ ? "OrderedHashLinkListRepFactory" : "HashLinkListRepFactory";
   }
 
  private:
@@ -57,6 +65,9 @@ class HashLinkListRepFactory : public MemTableRepFactory {
   const size_t huge_page_tlb_size_;
   int bucket_entries_logging_threshold_;
   bool if_log_bucket_dist_when_flash_;
+  // Used instead of the column family prefix extractor if set.
+  const std::shared_ptr<const SliceTransform> transform_;
+  const bool keep_total_order_;
 };
 
 }
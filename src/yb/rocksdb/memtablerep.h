@@ -309,6 +309,15 @@ extern MemTableRepFactory* NewHashLinkListRepFactory(
     bool if_log_bucket_dist_when_flash = true,
     uint32_t threshold_use_skiplist = 256);
 
+// The factory creates hash linked list memtables that hash entries by the prefix extracted by
+// transform, instead of the column family prefix extractor. So point lookups could use the hash
+// without prefix seek in SST files. Such memtable also keeps all entries in a skip list, to
+// support cheap total order iteration.
+// Iterators use the hash only when created with ReadOptions::memtable_prefix_seek.
+extern MemTableRepFactory* NewOrderedHashLinkListRepFactory(
+    std::shared_ptr<const SliceTransform> transform, size_t bucket_count = 50000,
+    uint32_t threshold_use_skiplist = 256);
+
 // This factory creates a cuckoo-hashing based mem-table representation.
 // Cuckoo-hash is a closed-hash strategy, in which all key/value pairs
 // are stored in the bucket array itself intead of in some data structures
@@ -45,6 +45,7 @@
 namespace yb {
 
 class MemTracker;
+class ThreadPool;
 
 }
 
@@ -64,6 +65,7 @@ class MemTable;
 class MergeOperator;
 class Snapshot;
 class TableFactory;
+class TimeWindowExtractor;
 class MemTableRepFactory;
 class TablePropertiesCollectorFactory;
 class RateLimiter;
@@ -163,9 +165,20 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of the dictionary used to compress data blocks with ZSTD, 0 means that no
+  // dictionary is used. The dictionary is trained on samples of data blocks of a flushed or
+  // compacted file and is used for SST files of the same column family written after it. Each SST
+  // file stores a copy of the dictionary it was compressed with.
+  uint32_t max_dict_bytes;
+  // Maximum size of data blocks sampled from a single file to train the dictionary.
+  // 0 means 100 * max_dict_bytes.
+  uint32_t zstd_max_train_bytes;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), zstd_max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _zstd_max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        zstd_max_train_bytes(_zstd_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -813,6 +826,41 @@ struct ColumnFamilyOptions {
   // Default: false
   bool compaction_measure_io_stats;
 
+  // Values of at least this size are written by flushes and compactions to blob files instead of
+  // SST files, and SST files keep references to them. So compactions that keep such values do not
+  // rewrite them. Blob files are deleted once no live SST file references them.
+  // Default: 0, values are not separated.
+  uint64_t min_blob_size;
+
+  // Compactions move values out of the oldest blob files, this fraction of the blob files
+  // referenced by the compaction inputs, into new blob files. So blob files that keep few live
+  // values because the rest was overwritten or deleted are eventually released.
+  // Default: 0.25
+  double blob_garbage_collection_age_cutoff;
+
+  // With universal compaction, outputs of compactions whose size, estimated as the total size of
+  // their input files, is below this are not compressed, and neither are outputs of flushes of less
+  // memtable memory. Such files are usually rewritten soon, so compressing them is mostly wasted.
+  // Default: 0, the size does not disable compression.
+  uint64_t min_compressed_output_size;
+
+  // With universal compaction, outputs of compactions whose estimated size is at least
+  // large_output_size use large_output_compression instead of compression, e.g. a slower codec
+  // with a better ratio for large files, which are rewritten rarely. The codec uses
+  // compression_opts, so its level could be set there.
+  // Default: 0, compression is used for all sizes.
+  uint64_t large_output_size;
+  CompressionType large_output_compression;
+
+  // Enables time window compaction with universal compaction style and a single level. Level 0
+  // files are grouped into time windows by the time of their latest write, and only consecutive
+  // files of the same window are compacted together, so old data is not rewritten with new data.
+  // Files of the latest window are compacted once there are level0_file_num_compaction_trigger of
+  // them, files of earlier windows as soon as there are two of them, so each past window ends up in
+  // a single file.
+  // Default: nullptr, size tiered universal compaction.
+  std::shared_ptr<TimeWindowExtractor> time_window_extractor;
+
   // Create ColumnFamilyOptions with default values for all fields
   ColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -1158,6 +1206,15 @@ struct DBOptions {
   // Default: 0
   size_t compaction_readahead_size;
 
+  // If true, compaction input files are read and compaction output files are written with direct
+  // I/O (O_DIRECT), bypassing the OS page cache, so compactions do not evict data of foreground
+  // reads from it. Foreground reads and flushes keep using the OS page cache.
+  // When true, we also force new_table_reader_for_compaction_inputs to true and, if
+  // compaction_readahead_size is 0, set it to 2MB.
+  //
+  // Default: false
+  bool use_direct_io_for_compaction;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -1246,6 +1303,17 @@ struct DBOptions {
   // Default: false
   bool allow_concurrent_memtable_write;
 
+  // If set together with allow_concurrent_memtable_write, updates of a write batch that is
+  // written alone, i.e. not grouped with other batches, and contains no merges are inserted into
+  // the memtable by up to memtable_insert_parallelism threads, the writing thread and threads of
+  // this pool. Each thread inserts at least min_memtable_insert_entries_per_thread updates.
+  // Not owned.
+  //
+  // Default: nullptr
+  yb::ThreadPool* memtable_insert_thread_pool = nullptr;
+  size_t memtable_insert_parallelism = 1;
+  size_t min_memtable_insert_entries_per_thread = 1024;
+
   // If true, threads synchronizing with the write batch group leader will
   // wait for up to write_thread_max_yield_usec before blocking on a mutex.
   // This can substantially improve throughput for concurrent workloads,
@@ -1492,6 +1560,16 @@ struct ReadOptions {
 
   std::shared_ptr<ReadFileFilter> file_filter;
 
+  // Seek in memtables created by NewOrderedHashLinkListRepFactory looks only for entries with the
+  // same prefix as the seek target, and the iterator is positioned out of that prefix only by
+  // becoming invalid. Should be set only for reads that do not go beyond the prefix of the seek
+  // target. Memtables of other types ignore it.
+  bool memtable_prefix_seek = false;
+
+  // Values stored in blob files are read from them by table readers. Compactions read references
+  // to them instead, so values they keep are not rewritten.
+  bool resolve_blob_indexes = true;
+
   static const ReadOptions kDefault;
 
   ReadOptions();
@@ -206,6 +206,13 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Compression of SST blocks: size of the blocks that compression was applied to, size of the
+  // same blocks as written, and time spent compressing them. So the CPU time spent per byte saved
+  // by compression is COMPRESSION_TIME_NANOS / (COMPRESSION_INPUT_BYTES - COMPRESSION_OUTPUT_BYTES).
+  COMPRESSION_INPUT_BYTES,
+  COMPRESSION_OUTPUT_BYTES,
+  COMPRESSION_TIME_NANOS,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -300,7 +307,10 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {COMPRESSION_INPUT_BYTES, "rocksdb_compression_input_bytes"},
+    {COMPRESSION_OUTPUT_BYTES, "rocksdb_compression_output_bytes"},
+    {COMPRESSION_TIME_NANOS, "rocksdb_compression_time_nanos"}
 };
 
 /**
@@ -79,6 +79,16 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+YB_DEFINE_ENUM(KeyValueEncodingFormat,
+  // Each key is delta encoded against the previous key, keys at restart points are stored in full.
+  (kKeyDeltaEncodingSharedPrefix)
+
+  // Same as kKeyDeltaEncodingSharedPrefix, but keys at restart points (other than the first one)
+  // are delta encoded against the first key of the block. Long key prefixes that are common to the
+  // whole block (e.g. DocDB hash and hashed components) are then stored once per block.
+  (kKeyDeltaEncodingSharedBlockPrefix)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -97,6 +107,15 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If true, index of fixed-size bloom filter is not pinned by the table reader, but is loaded on
+  // demand through the block cache together with the filter blocks it points to. So filter of a
+  // large table does not consume memory while the table is not read.
+  bool cache_filter_index = false;
+
+  // If true, fixed-size bloom filter blocks and filter index are put in the multi-touch part of
+  // the block cache, so they are not evicted by data blocks that are read once, e.g. by scans.
+  bool cache_filter_blocks_with_high_priority = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -163,6 +182,12 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Key encoding used for data blocks when use_delta_encoding is true. Index and meta blocks always
+  // use kKeyDeltaEncodingSharedPrefix. The format is stored in table properties, so files written
+  // with different formats could be read by the same table factory.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -213,6 +238,8 @@ struct BlockBasedTablePropertyNames {
   static const char kWholeKeyFiltering[];
   // value is "1" for true and "0" for false.
   static const char kPrefixFiltering[];
+  // value of this property is a fixed int32 number, see KeyValueEncodingFormat.
+  static const char kDataBlockKeyValueEncodingFormat[];
 };
 
 // Create default block based table factory.
@@ -98,7 +98,8 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -110,6 +111,16 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  key_value_encoding_format_ = key_value_encoding_format;
+  if (SharesBlockPrefix()) {
+    uint32_t shared, non_shared, value_length;
+    const char* key_ptr = DecodeEntry(data_, data_ + restarts_, &shared, &non_shared,
+                                      &value_length);
+    // In case of corruption first_key_ stays empty and decoding of restart keys will fail.
+    if (key_ptr != nullptr && shared == 0) {
+      first_key_ = Slice(key_ptr, non_shared);
+    }
+  }
 }
 
 
@@ -180,6 +191,11 @@ bool BlockIter::ParseNextKey() {
   // Decode next entry
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
+  if (p != nullptr && shared != 0 && SharesBlockPrefix() && AtRestartPoint(current_)) {
+    // Restart keys are delta encoded against the first key of the block. The size check below
+    // detects a corrupted shared size.
+    key_.SetKey(first_key_, false /* copy */);
+  }
   if (p == nullptr || key_.Size() < shared) {
     CorruptionError();
     return false;
@@ -209,16 +225,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
-    uint32_t region_offset = GetRestartPoint(mid);
-    uint32_t shared, non_shared, value_length;
-    const char* key_ptr =
-        DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+    Slice mid_key;
+    if (!DecodeRestartKey(mid, &mid_key)) {
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
     int cmp = Compare(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
@@ -240,18 +251,42 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
-  uint32_t region_offset = GetRestartPoint(block_index);
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  Slice block_key;
+  if (!DecodeRestartKey(block_index, &block_key)) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
-  Slice block_key(key_ptr, non_shared);
   return Compare(block_key, target);
 }
 
+bool BlockIter::DecodeRestartKey(uint32_t index, Slice* key) {
+  uint32_t region_offset = GetRestartPoint(index);
+  uint32_t shared, non_shared, value_length;
+  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
+                                    &shared, &non_shared, &value_length);
+  if (key_ptr == nullptr) {
+    return false;
+  }
+  if (shared == 0) {
+    *key = Slice(key_ptr, non_shared);
+    return true;
+  }
+  if (!SharesBlockPrefix() || index == 0 || first_key_.size() < shared) {
+    return false;
+  }
+  restart_key_.SetKey(first_key_, false /* copy */);
+  restart_key_.TrimAppend(shared, key_ptr, non_shared);
+  *key = restart_key_.GetKey();
+  return true;
+}
+
+bool BlockIter::AtRestartPoint(uint32_t offset) {
+  if (restart_index_ < num_restarts_ && GetRestartPoint(restart_index_) == offset) {
+    return true;
+  }
+  return restart_index_ + 1 < num_restarts_ && GetRestartPoint(restart_index_ + 1) == offset;
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool BlockIter::BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
@@ -355,7 +390,8 @@ Block::Block(BlockContents&& contents)
 }
 
 InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
-                                     bool total_order_seek) {
+                                     bool total_order_seek,
+                                     KeyValueEncodingFormat key_value_encoding_format) {
   if (size_ < 2*sizeof(uint32_t)) {
     if (iter != nullptr) {
       iter->SetStatus(STATUS(Corruption, "bad block contents"));
@@ -380,10 +416,10 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     }
   }
 
@@ -32,6 +32,7 @@
 
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/table.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/table/block_prefix_index.h"
 #include "yb/rocksdb/table/block_hash_index.h"
@@ -82,9 +83,14 @@ class Block {
   // If total_order_seek is true, hash_index_ and prefix_index_ are ignored.
   // This option only applies for index block. For data block, hash_index_
   // and prefix_index_ are null, so this option does not matter.
+  //
+  // key_value_encoding_format should match the format the block was built with, see
+  // BlockBuilder.
   InternalIterator* NewIterator(const Comparator* comparator,
                                 BlockIter* iter = nullptr,
-                                bool total_order_seek = true);
+                                bool total_order_seek = true,
+                                KeyValueEncodingFormat key_value_encoding_format =
+                                    KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
   void SetBlockHashIndex(BlockHashIndex* hash_index);
   void SetBlockPrefixIndex(BlockPrefixIndex* prefix_index);
 
@@ -115,19 +121,24 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        key_value_encoding_format_(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index,
+       KeyValueEncodingFormat key_value_encoding_format =
+           KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index,
+      KeyValueEncodingFormat key_value_encoding_format =
+          KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -180,6 +191,17 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  KeyValueEncodingFormat key_value_encoding_format_;
+
+  // First key of the block, only set for kKeyDeltaEncodingSharedBlockPrefix where keys at restart
+  // points are delta encoded against it.
+  Slice first_key_;
+  // Buffer used to restore keys at restart points during binary search.
+  IterKey restart_key_;
+
+  bool SharesBlockPrefix() const {
+    return key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix;
+  }
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -215,6 +237,13 @@ class BlockIter : public InternalIterator {
 
   int CompareBlockKey(uint32_t block_index, const Slice& target);
 
+  // Decodes the key at restart point with the given index into *key. Returns false on corruption.
+  bool DecodeRestartKey(uint32_t index, Slice* key);
+
+  // Whether the entry at the given offset is located at a restart point, assuming that
+  // restart_index_ was not yet advanced past it.
+  bool AtRestartPoint(uint32_t offset);
+
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
                             uint32_t left, uint32_t right,
                             uint32_t* index);
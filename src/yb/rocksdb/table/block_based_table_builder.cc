@@ -107,9 +107,11 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 }
 
 // format_version is the block format as defined in include/rocksdb/table.h
+// compression_dict is only supported by ZSTD and ignored by other compression types.
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -163,7 +165,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -289,6 +291,14 @@ struct BlockBasedTableBuilder::Rep {
   std::string last_filter_key;
   const CompressionType compression_type;
   const CompressionOptions compression_opts;
+  // Dictionary used to compress data blocks of this file, empty if no dictionary is used.
+  std::shared_ptr<const std::string> compression_dict;
+  // Receives the dictionary trained on samples of data blocks of this file. Null if dictionary
+  // compression is not used.
+  CompressionDictHolder* const compression_dict_holder;
+  // Concatenated samples of uncompressed data blocks and their sizes, used to train the dictionary.
+  std::string dict_samples;
+  std::vector<size_t> dict_sample_lens;
   TableProperties props;
 
   bool closed = false;  // Either Finish() or Abandon() has been called.
@@ -312,7 +322,8 @@ struct BlockBasedTableBuilder::Rep {
       WritableFileWriter* data_file,
       const CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
-      const bool skip_filters);
+      const bool skip_filters,
+      CompressionDictHolder* _compression_dict_holder);
 
   bool is_split_sst() const { return data_writer != metadata_writer; }
 };
@@ -331,6 +342,9 @@ Status BlockBasedTableBuilder::BlockBasedTablePropertiesCollector::Finish(
   val.clear();
   PutFixed32(&val, rep_->data_index_builder->NumLevels());
   properties->emplace(BlockBasedTablePropertyNames::kNumIndexLevels, val);
+  val.clear();
+  PutFixed32(&val, static_cast<uint32_t>(rep_->table_options.data_block_key_value_encoding_format));
+  properties->emplace(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat, val);
   return Status::OK();
 }
 
@@ -344,7 +358,8 @@ BlockBasedTableBuilder::Rep::Rep(
     WritableFileWriter* data_file,
     const CompressionType _compression_type,
     const CompressionOptions& _compression_opts,
-    const bool skip_filters)
+    const bool skip_filters,
+    CompressionDictHolder* _compression_dict_holder)
     : ioptions(_ioptions),
       table_options(table_opt),
       internal_comparator(icomparator),
@@ -352,7 +367,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -368,6 +384,9 @@ BlockBasedTableBuilder::Rep::Rep(
               nullptr /* prefix_extractor */, table_options)),
       compression_type(_compression_type),
       compression_opts(_compression_opts),
+      compression_dict_holder(
+          _compression_type == kZSTDNotFinalCompression && _compression_opts.max_dict_bytes > 0
+              ? _compression_dict_holder : nullptr),
       flush_block_policy(
           table_options.flush_block_policy_factory->NewFlushBlockPolicy(
               table_options, data_block_builder)) {
@@ -375,6 +394,9 @@ BlockBasedTableBuilder::Rep::Rep(
     mem_tracker = yb::MemTracker::FindOrCreateTracker(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
+  if (compression_dict_holder != nullptr) {
+    compression_dict = compression_dict_holder->Get();
+  }
 
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
@@ -404,7 +426,8 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
     WritableFileWriter* data_file,
     const CompressionType compression_type,
     const CompressionOptions& compression_opts,
-    const bool skip_filters) {
+    const bool skip_filters,
+    CompressionDictHolder* compression_dict_holder) {
   BlockBasedTableOptions sanitized_table_options(table_options);
   if (sanitized_table_options.format_version == 0 &&
       sanitized_table_options.checksum != kCRC32c) {
@@ -418,7 +441,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
 
   rep_ = new Rep(ioptions, sanitized_table_options, internal_comparator,
                  int_tbl_prop_collector_factories, column_family_id, metadata_file, data_file,
-                 compression_type, compression_opts, skip_filters);
+                 compression_type, compression_opts, skip_filters, compression_dict_holder);
 
   if (rep_->filter_block_builder != nullptr) {
     rep_->filter_block_builder->StartBlock(0);
@@ -472,6 +495,9 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
   r->last_key.assign(key.cdata(), key.size());
   r->data_block_builder.Add(key, value);
   r->props.num_entries++;
+  if (ExtractValueType(key) == kTypeBlobIndex) {
+    r->props.num_blob_indexes++;
+  }
   r->props.raw_key_size += key.size();
   r->props.raw_value_size += value.size();
 
@@ -490,11 +516,13 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
 
   if (!r->data_block_builder.empty()) {
     data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+        r->data_writer.get(), true /* is_data_block */);
   }
   if (!ok()) return;
 
-  if (!r->table_options.skip_table_builder_flush) {
+  // Unbuffered writer would rewrite unaligned tail of the file on each flush, so it is only
+  // flushed when its buffer is full.
+  if (!r->table_options.skip_table_builder_flush && r->data_writer->writer->UseOSBuffer()) {
     r->status = r->data_writer->writer->Flush();
   }
   if (!ok()) return;
@@ -543,7 +571,7 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
       &r->filter_pending_handle, r->metadata_writer.get());
   if (!ok()) return;
 
-  if (!r->table_options.skip_table_builder_flush) {
+  if (!r->table_options.skip_table_builder_flush && r->metadata_writer->writer->UseOSBuffer()) {
     r->status = r->metadata_writer->writer->Flush();
   }
   if (!ok()) return;
@@ -563,15 +591,17 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
 
 size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          bool is_data_block) {
+  size_t block_size = WriteBlock(block->Finish(), handle, writer_info, is_data_block);
   block->Reset();
   return block_size;
 }
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          bool is_data_block) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -579,12 +609,35 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   assert(ok());
   Rep* r = rep_;
 
+  Slice compression_dict;
+  if (is_data_block && r->compression_dict_holder != nullptr) {
+    if (r->compression_dict) {
+      compression_dict = *r->compression_dict;
+    }
+    const size_t max_train_bytes = r->compression_opts.zstd_max_train_bytes > 0
+        ? r->compression_opts.zstd_max_train_bytes
+        : r->compression_opts.max_dict_bytes * 100ULL;
+    if (r->dict_samples.size() + raw_block_contents.size() <= max_train_bytes) {
+      r->dict_samples.append(raw_block_contents.cdata(), raw_block_contents.size());
+      r->dict_sample_lens.push_back(raw_block_contents.size());
+    }
+  }
+
   auto type = r->compression_type;
   Slice block_contents;
   if (raw_block_contents.size() < kCompressionSizeLimit) {
+    Statistics* const statistics = r->ioptions.statistics;
+    const bool record_compression = statistics != nullptr && type != kNoCompression;
+    StopWatchNano timer(r->ioptions.env, record_compression);
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict,
+                      &r->compressed_output);
+    if (record_compression) {
+      RecordTick(statistics, COMPRESSION_TIME_NANOS, timer.ElapsedNanos());
+      RecordTick(statistics, COMPRESSION_INPUT_BYTES, raw_block_contents.size());
+      RecordTick(statistics, COMPRESSION_OUTPUT_BYTES, block_contents.size());
+    }
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -727,6 +780,13 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && r->compression_dict && !r->compression_dict->empty()) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(*r->compression_dict, kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -770,6 +830,7 @@ Status BlockBasedTableBuilder::Finish() {
       PropertyBlockBuilder property_block_builder;
       r->props.filter_policy_name = r->table_options.filter_policy != nullptr ?
           r->table_options.filter_policy->Name() : "";
+      r->props.compression_name = CompressionTypeToString(r->compression_type);
       r->props.data_index_size =
           r->data_index_builder->EstimatedSize() + kBlockTrailerSize;
 
@@ -835,6 +896,18 @@ Status BlockBasedTableBuilder::Finish() {
     }
   }
 
+  // Train the dictionary for the next files of the column family on data of this file.
+  if (ok() && r->compression_dict_holder != nullptr && !r->dict_sample_lens.empty()) {
+    auto dict = ZSTD_TrainDictionary(
+        r->dict_samples, r->dict_sample_lens, r->compression_opts.max_dict_bytes);
+    if (!dict.empty()) {
+      r->compression_dict_holder->Set(std::make_shared<const std::string>(std::move(dict)));
+    }
+  }
+  r->dict_samples.clear();
+  r->dict_samples.shrink_to_fit();
+  r->dict_sample_lens.clear();
+
   return r->status;
 }
 
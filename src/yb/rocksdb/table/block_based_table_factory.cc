@@ -97,7 +97,8 @@ TableBuilder* BlockBasedTableFactory::NewTableBuilder(
       data_file,
       table_builder_options.compression_type,
       table_builder_options.compression_opts,
-      table_builder_options.skip_filters);
+      table_builder_options.skip_filters,
+      table_builder_options.compression_dict_holder);
 
   return table_builder;
 }
@@ -115,6 +116,9 @@ Status BlockBasedTableFactory::SanitizeOptions(
     return STATUS(InvalidArgument, "Enable cache_index_and_filter_blocks, "
         ", but block cache is disabled");
   }
+  if (table_options_.cache_filter_index && table_options_.no_block_cache) {
+    return STATUS(InvalidArgument, "Enable cache_filter_index, but block cache is disabled");
+  }
   if (!BlockBasedTableSupportedVersion(table_options_.format_version)) {
     return STATUS(InvalidArgument,
         "Unsupported BlockBasedTable format_version. Please check "
@@ -136,6 +140,12 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_filter_index: %d\n",
+           table_options_.cache_filter_index);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_filter_blocks_with_high_priority: %d\n",
+           table_options_.cache_filter_blocks_with_high_priority);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -177,6 +187,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_value_encoding_format: %d\n",
+           yb::to_underlying(table_options_.data_block_key_value_encoding_format));
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
@@ -214,6 +227,8 @@ const char BlockBasedTablePropertyNames::kWholeKeyFiltering[] =
     "rocksdb.block.based.table.whole.key.filtering";
 const char BlockBasedTablePropertyNames::kPrefixFiltering[] =
     "rocksdb.block.based.table.prefix.filtering";
+const char BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat[] =
+    "rocksdb.block.based.table.data.block.key.value.encoding.format";
 const char kHashIndexPrefixesBlock[] = "rocksdb.hashindex.prefixes";
 const char kHashIndexPrefixesMetadataBlock[] =
     "rocksdb.hashindex.metadata";
@@ -25,8 +25,13 @@
 
 #include <string>
 #include <utility>
+#include <algorithm>
 #include <cinttypes>
+#include <limits>
 
+#include <gflags/gflags.h>
+
+#include "yb/rocksdb/db/blob_file.h"
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/rocksdb/cache.h"
@@ -65,6 +70,22 @@
 #include "yb/util/logging.h"
 #include "yb/util/atomic.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(rocksdb_readahead_min_sequential_blocks, 2,
+             "Number of data blocks an iterator should read sequentially from an SST file before "
+             "it starts reading ahead.");
+
+DEFINE_uint64(rocksdb_readahead_initial_size, 64_KB,
+              "Size of the first readahead issued by an iterator that reads data blocks "
+              "sequentially. Each following readahead doubles it up to "
+              "--rocksdb_readahead_max_size.");
+
+DEFINE_uint64(rocksdb_readahead_max_size, 2_MB,
+              "Maximal amount of data an iterator reads ahead of its position in an SST file, 0 to "
+              "disable readahead.");
 
 namespace rocksdb {
 
@@ -115,6 +136,18 @@ Cache::Handle* GetEntryFromCache(Cache* block_cache, const Slice& key,
   return cache_handle;
 }
 
+// Whether the block is stored uncompressed in a memory mapped file. Such a block can be used
+// directly from the mapping, so caching it would only duplicate the page cache.
+bool IsUncompressedMappedBlock(RandomAccessFileReader* file, const BlockHandle& handle) {
+  if (!file->IsMemoryMapped()) {
+    return false;
+  }
+  Slice compression_type;
+  auto status = file->Read(handle.offset() + handle.size(), 1, &compression_type, nullptr);
+  return status.ok() && compression_type.size() == 1 &&
+         static_cast<CompressionType>(compression_type[0]) == kNoCompression;
+}
+
 class NotMatchingFilterBlockReader : public FilterBlockReader {
  public:
   NotMatchingFilterBlockReader() {}
@@ -228,6 +261,10 @@ struct BlockBasedTable::Rep {
   bool hash_index_allow_collision;
   bool whole_key_filtering;
   bool prefix_filtering;
+  // Format of data blocks, read from table properties. Files without this property were written
+  // with kKeyDeltaEncodingSharedPrefix.
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
   // TODO(kailiu) It is very ugly to use internal key in table, since table
   // module should not be relying on db module. However to make things easier
   // and compatible with existing code, we introduce a wrapper that allows
@@ -235,6 +272,8 @@ struct BlockBasedTable::Rep {
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
   yb::MemTrackerPtr mem_tracker;
+  // Dictionary used to compress data blocks of this file, empty if there is no dictionary.
+  BlockContents compression_dict_block;
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -252,6 +291,9 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (block_type_ == BlockType::kData) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -263,6 +305,54 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   }
 
  private:
+  // Data blocks follow each other in the data file, so an iterator that moves to the block right
+  // after the previous one reads the file sequentially. After a few such blocks, asks the file to
+  // read ahead of the iterator position, so the following blocks do not block on I/O. The
+  // readahead window starts small and doubles while the access stays sequential, so short range
+  // scans do not pay for reading data they do not need.
+  // Only used for data block states, those are created per iterator and are not shared between
+  // threads.
+  void MaybeReadahead(const Slice& index_value) {
+    const uint64_t max_size = FLAGS_rocksdb_readahead_max_size;
+    if (max_size == 0) {
+      return;
+    }
+    BlockHandle handle;
+    Slice input = index_value;
+    if (!handle.DecodeFrom(&input).ok()) {
+      return;
+    }
+    if (handle.offset() == next_block_offset_) {
+      ++sequential_blocks_;
+    } else {
+      sequential_blocks_ = 0;
+      readahead_size_ = 0;
+      readahead_limit_ = 0;
+    }
+    next_block_offset_ = handle.offset() + handle.size() + kBlockTrailerSize;
+    if (sequential_blocks_ < FLAGS_rocksdb_readahead_min_sequential_blocks) {
+      return;
+    }
+    if (readahead_size_ == 0) {
+      readahead_size_ = std::min<uint64_t>(FLAGS_rocksdb_readahead_initial_size, max_size);
+    }
+    // Issue the next readahead when half of the previous window was consumed, so the I/O is in
+    // flight before the iterator gets there.
+    if (next_block_offset_ + readahead_size_ / 2 < readahead_limit_) {
+      return;
+    }
+    auto* reader = table_->GetBlockReader(BlockType::kData);
+    if (reader == nullptr || !reader->reader) {
+      return;
+    }
+    const auto start = std::max(next_block_offset_, readahead_limit_);
+    readahead_limit_ = next_block_offset_ + readahead_size_;
+    if (readahead_limit_ > start) {
+      reader->reader->Readahead(start, readahead_limit_ - start);
+    }
+    readahead_size_ = std::min<uint64_t>(readahead_size_ * 2, max_size);
+  }
+
   // Don't own table_. BlockEntryIteratorState should only be stored in iterators or in
   // corresponding BlockBasedTable. TableReader (superclass of BlockBasedTable) is only destroyed
   // after iterator is deleted.
@@ -270,6 +360,13 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  // Offset the next data block would start at if the iterator reads the file sequentially.
+  uint64_t next_block_offset_ = std::numeric_limits<uint64_t>::max();
+  int sequential_blocks_ = 0;
+  uint64_t readahead_size_ = 0;
+  // End of the range already requested to be read ahead.
+  uint64_t readahead_limit_ = 0;
 };
 
 
@@ -324,6 +421,11 @@ BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
   if (table->rep_->filter_type == FilterType::kFixedSizeFilter) {
+    const auto* filter_key_transformer = table->rep_->filter_key_transformer;
+    if (filter_key_transformer && !filter_key_transformer->IsPrefixFilterable(user_key_)) {
+      // Keys we are looking for could have different filter keys, so take this file into account.
+      return true;
+    }
     const auto filter_key = table->GetFilterKeyFromUserKey(user_key_);
     auto filter_entry = table->GetFilter(read_options_.query_id,
         read_options_.read_tier == kBlockCacheTier /* no_io */, &filter_key);
@@ -436,6 +538,18 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary, it is required to uncompress data blocks.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+    s = ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        compression_dict_handle, &rep->compression_dict_block, rep->ioptions.env,
+        rep->mem_tracker, false /* do_uncompress */);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -474,6 +588,13 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     rep->prefix_filtering &= IsFeatureSupported(
         *(rep->table_properties),
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
+
+    auto& props = rep->table_properties->user_collected_properties;
+    auto pos = props.find(BlockBasedTablePropertyNames::kDataBlockKeyValueEncodingFormat);
+    if (pos != props.end()) {
+      rep->data_block_key_value_encoding_format = static_cast<KeyValueEncodingFormat>(
+          DecodeFixed32(pos->second.c_str()));
+    }
   }
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
@@ -497,9 +618,9 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
   if (s.ok() && prefetch_filter == PrefetchFilter::YES) {
     // pre-fetching of blocks is turned on
     // NOTE: Table reader objects are cached in table cache (table_cache.cc).
-    if (rep->filter_policy && rep->filter_type == FilterType::kFixedSizeFilter) {
-      // TODO: may be put it in block cache instead of table reader in case
-      // table_options.cache_index_and_filter_blocks is set?
+    if (rep->filter_policy && rep->filter_type == FilterType::kFixedSizeFilter &&
+        !(table_options.cache_filter_index && table_options.block_cache)) {
+      // Otherwise filter index is loaded on demand through the block cache, see GetFilterIndex.
       s = new_table->CreateFilterIndexReader(&rep->filter_index_reader);
     }
 
@@ -686,7 +807,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -730,7 +851,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -758,7 +879,7 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -767,7 +888,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -812,7 +933,8 @@ Status BlockBasedTable::PutDataBlockToCache(
   return s;
 }
 
-Status BlockBasedTable::CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) {
+Status BlockBasedTable::CreateFilterIndexReader(
+    std::unique_ptr<IndexReader>* filter_index_reader) const {
   auto base_file_reader = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
   auto footer = rep_->footer;
@@ -868,25 +990,73 @@ FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_ha
   return nullptr;
 }
 
-Status BlockBasedTable::GetFixedSizeFilterBlockHandle(const Slice& filter_key,
-    BlockHandle* filter_block_handle) const {
-  // Determine block of fixed-size bloom filter using filter index.
-  BlockIter fiter;
-  rep_->filter_index_reader->NewIterator(&fiter,
-      // Following parameters are ignored by BinarySearchIndexReader which we use as
-      // filter_index_reader.
-      nullptr /* index_iterator_state */, true /* total_order_seek */);
-  fiter.Seek(filter_key);
-  if (fiter.Valid()) {
-    Slice filter_block_handle_encoded = fiter.value();
-    return filter_block_handle->DecodeFrom(&filter_block_handle_encoded);
-  } else {
-    // We are beyond the index, that means key is absent in filter, we use null block handle
-    // stub to indicate that.
-    filter_block_handle->set_offset(0);
-    filter_block_handle->set_size(0);
+QueryId BlockBasedTable::FilterCacheQueryId(const QueryId query_id) const {
+  return rep_->table_options.cache_filter_blocks_with_high_priority && query_id != kNoCacheQueryId
+      ? kInMultiTouchId : query_id;
+}
+
+Status BlockBasedTable::GetFilterIndex(
+    const QueryId query_id, CachableEntry<IndexReader>* filter_index) const {
+  IndexReader* filter_index_reader = rep_->filter_index_reader.get();
+  if (filter_index_reader) {
+    // Filter index has been pre-loaded on open.
+    *filter_index = {filter_index_reader, nullptr /* cache handle */};
+    return Status::OK();
+  }
+
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr) {
+    return STATUS(IllegalState, "Filter index is not loaded and there is no block cache");
+  }
+
+  char cache_key_buffer[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  auto cache_key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
+      rep_->filter_handle, cache_key_buffer);
+  Statistics* statistics = rep_->ioptions.statistics;
+  auto cache_handle = GetEntryFromCache(block_cache, cache_key,
+      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+  if (cache_handle != nullptr) {
+    *filter_index = {static_cast<IndexReader*>(block_cache->Value(cache_handle)), cache_handle};
     return Status::OK();
   }
+
+  // As for filter blocks, we ignore no_io and always load filter index.
+  std::unique_ptr<IndexReader> filter_index_holder;
+  RETURN_NOT_OK(CreateFilterIndexReader(&filter_index_holder));
+  RETURN_NOT_OK(block_cache->Insert(cache_key, query_id, filter_index_holder.get(),
+                                    filter_index_holder->usable_size(),
+                                    &DeleteCachedEntry<IndexReader>, &cache_handle, statistics));
+  *filter_index = {filter_index_holder.release(), cache_handle};
+  return Status::OK();
+}
+
+Status BlockBasedTable::GetFixedSizeFilterBlockHandle(const QueryId query_id,
+    const Slice& filter_key, BlockHandle* filter_block_handle) const {
+  CachableEntry<IndexReader> filter_index;
+  RETURN_NOT_OK(GetFilterIndex(query_id, &filter_index));
+
+  Status s;
+  {
+    // Determine block of fixed-size bloom filter using filter index.
+    BlockIter fiter;
+    filter_index.value->NewIterator(&fiter,
+        // Following parameters are ignored by BinarySearchIndexReader which we use as
+        // filter_index_reader.
+        nullptr /* index_iterator_state */, true /* total_order_seek */);
+    fiter.Seek(filter_key);
+    if (fiter.Valid()) {
+      Slice filter_block_handle_encoded = fiter.value();
+      s = filter_block_handle->DecodeFrom(&filter_block_handle_encoded);
+    } else {
+      // We are beyond the index, that means key is absent in filter, we use null block handle
+      // stub to indicate that.
+      filter_block_handle->set_offset(0);
+      filter_block_handle->set_size(0);
+    }
+  }
+  // Iterator should be destroyed before filter index is released.
+  filter_index.Release(rep_->table_options.block_cache.get());
+  return s;
 }
 
 Slice BlockBasedTable::GetFilterKeyFromInternalKey(const Slice &internal_key) const {
@@ -930,23 +1100,30 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     return {nullptr /* filter */, nullptr /* cache handle */};
   }
 
+  const QueryId cache_query_id = FilterCacheQueryId(query_id);
   const BlockHandle* filter_block_handle;
   // Determine filter block handle
   BlockHandle fixed_size_filter_block_handle;
   if (is_fixed_size_filter) {
-    Status s = GetFixedSizeFilterBlockHandle(*filter_key, &fixed_size_filter_block_handle);
+    Status s = GetFixedSizeFilterBlockHandle(
+        cache_query_id, *filter_key, &fixed_size_filter_block_handle);
     if (s.ok()) {
       if (fixed_size_filter_block_handle.IsNull()) {
         // Key is beyond filter index - return stub filter.
         return rep_->not_matching_filter_entry;
       }
       filter_block_handle = &fixed_size_filter_block_handle;
+    } else if (s.IsIncomplete()) {
+      // Filter index could not be put to the block cache because of strict capacity limit, so
+      // just do not use the filter, as we do when filter block could not be cached.
+      return CachableEntry<FilterBlockReader>();
     } else {
       // If we failed to decode filter block handle from filter index we will just log error in
       // production to continue operation in case of just filter corruption,
       // but we should fail in debug and under tests to be able to catch possible bugs.
       RLOG(InfoLogLevel::ERROR_LEVEL, rep_->ioptions.info_log,
-          "Failed to decode fixed-size filter block handle from filter index.");
+          "Failed to get fixed-size filter block handle from filter index: %s",
+          s.ToString().c_str());
       FAIL_IF_NOT_PRODUCTION();
       return {nullptr /* filter */, nullptr /* cache handle */};
     }
@@ -961,7 +1138,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
 
   Statistics* statistics = rep_->ioptions.statistics;
   auto cache_handle = GetEntryFromCache(block_cache, filter_block_cache_key,
-      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, query_id);
+      BLOCK_CACHE_FILTER_MISS, BLOCK_CACHE_FILTER_HIT, statistics, cache_query_id);
 
   FilterBlockReader* filter = nullptr;
   if (cache_handle != nullptr) {
@@ -976,7 +1153,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key, cache_query_id,
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -1120,9 +1297,15 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
-
-  // If either block cache is enabled, we'll try to read from it.
-  if (block_cache != nullptr || block_cache_compressed != nullptr) {
+  // Only data blocks are compressed with the dictionary.
+  const Slice compression_dict =
+      block_type == BlockType::kData ? rep_->compression_dict_block.data : Slice();
+
+  // If either block cache is enabled, we'll try to read from it. Uncompressed data blocks of memory
+  // mapped files are read from the mapping instead.
+  if ((block_cache != nullptr || block_cache_compressed != nullptr) &&
+      !(block_type == BlockType::kData &&
+        IsUncompressedMappedBlock(reader->reader.get(), handle))) {
     Statistics* statistics = rep_->ioptions.statistics;
     char cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
     char compressed_cache_key[block_based_table::kMaxCacheKeyPrefixSize + kMaxVarint64Length];
@@ -1140,7 +1323,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1148,13 +1331,14 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                compression_dict);
       }
     }
   }
@@ -1173,7 +1357,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1181,7 +1365,10 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
   InternalIterator* iter;
   if (s.ok() && block.value != nullptr) {
-    iter = block.value->NewIterator(rep_->comparator.get(), input_iter);
+    iter = block.value->NewIterator(
+        rep_->comparator.get(), input_iter, true /* total_order_seek */,
+        block_type == BlockType::kData ? rep_->data_block_key_value_encoding_format
+                                       : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
     if (block.cache_handle != nullptr) {
       iter->RegisterCleanup(&ReleaseCachedEntry, block_cache,
           block.cache_handle);
@@ -1306,9 +1493,14 @@ InternalIterator* BlockBasedTable::NewIterator(const ReadOptions& read_options,
   // them, and decide the free / no free based on that. This callsite, for example, allows us to
   // put the top level iterator on the arena and potentially even the State object, however, not
   // the IndexIterator, as that does not expose arena allocation semantics...
-  return NewTwoLevelIterator(
+  auto* iter = NewTwoLevelIterator(
       state.release(), NewIndexIterator(read_options), arena, true /* need_free_iter_and_state */
   );
+  if (read_options.resolve_blob_indexes && rep_->table_properties &&
+      rep_->table_properties->num_blob_indexes > 0) {
+    return NewBlobIndexResolvingIterator(iter, rep_->ioptions.blob_file_cache.get(), arena);
+  }
+  return iter;
 }
 
 bool BlockBasedTable::NonBlockBasedFilterKeyMayMatch(FilterBlockReader* filter,
@@ -1357,6 +1549,8 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
     RETURN_NOT_OK(iiter.status());
 
     bool done = false;
+    std::string blob_value;
+    Status blob_status;
     for (iiter.Seek(internal_key); iiter.Valid() && !done; iiter.Next()) {
       {
         Slice data_block_handle_encoded = iiter.value();
@@ -1401,12 +1595,23 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
           s = STATUS(Corruption, Slice());
         }
 
-        if (!get_context->SaveValue(parsed_key, biter.value())) {
+        Slice value = biter.value();
+        if (parsed_key.type == kTypeBlobIndex && read_options.resolve_blob_indexes) {
+          blob_status = rep_->ioptions.blob_file_cache->Get(value, &blob_value);
+          if (!blob_status.ok()) {
+            done = true;
+            break;
+          }
+          parsed_key.type = kTypeValue;
+          value = blob_value;
+        }
+
+        if (!get_context->SaveValue(parsed_key, value)) {
           done = true;
           break;
         }
       }
-      s = biter.status();
+      s = blob_status.ok() ? biter.status() : blob_status;
     }
     if (s.ok()) {
       s = iiter.status();
@@ -1611,6 +1816,31 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+std::vector<std::string> BlockBasedTable::GetSampleKeys(size_t max_keys) {
+  std::vector<std::string> result;
+  const uint64_t num_data_blocks =
+      rep_->table_properties ? rep_->table_properties->num_data_blocks : 0;
+  if (max_keys == 0 || num_data_blocks <= 1) {
+    return result;
+  }
+  // Every step-th data block ends a sample, the last block is not used since it ends the table.
+  const uint64_t step = std::max<uint64_t>(num_data_blocks / (max_keys + 1), 1);
+  result.reserve(std::min<uint64_t>(max_keys, num_data_blocks));
+
+  ReadOptions read_options;
+  // Sampling is done once per compaction, so there is no reason to keep index blocks in cache.
+  read_options.fill_cache = false;
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(read_options));
+  uint64_t block_idx = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid() && result.size() < max_keys;
+       index_iter->Next()) {
+    if (++block_idx % step == 0 && block_idx < num_data_blocks) {
+      result.push_back(index_iter->key().ToBuffer());
+    }
+  }
+  return result;
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -164,6 +164,10 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Samples keys of the data index, so the key of every returned entry is the upper bound of
+  // approximately the same number of data blocks.
+  std::vector<std::string> GetSampleKeys(size_t max_keys) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -203,8 +207,17 @@ class BlockBasedTable : public TableReader {
   class BlockEntryIteratorState;
   class IndexIteratorHolder;
 
+  // Returns query id to be used for block cache access to fixed-size bloom filter blocks and
+  // filter index, depending on BlockBasedTableOptions::cache_filter_blocks_with_high_priority.
+  QueryId FilterCacheQueryId(const QueryId query_id) const;
+
+  // Returns index of fixed-size bloom filter, pinned by the table reader or loaded through the
+  // block cache if BlockBasedTableOptions::cache_filter_index is set.
+  // filter_index should be released by the caller.
+  Status GetFilterIndex(const QueryId query_id, CachableEntry<IndexReader>* filter_index) const;
+
   // Returns filter block handle for fixed-size bloom filter using filter index and filter key.
-  Status GetFixedSizeFilterBlockHandle(const Slice& filter_key,
+  Status GetFixedSizeFilterBlockHandle(const QueryId query_id, const Slice& filter_key,
       BlockHandle* filter_block_handle) const;
 
   // Returns key to be added to filter or verified against filter based on internal_key.
@@ -248,7 +261,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -263,7 +277,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const Slice& compression_dict = Slice());
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -293,7 +308,7 @@ class BlockBasedTable : public TableReader {
       size_t* filter_size = nullptr);
 
   // CreateFilterIndexReader from sst
-  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader);
+  Status CreateFilterIndexReader(std::unique_ptr<IndexReader>* filter_index_reader) const;
 
   // Helper function to setup the cache key's prefix for block of file passed within a reader
   // instance. Used for both data and metadata files.
@@ -38,7 +38,9 @@
 //     value_length: varint32
 //     key_delta: char[unshared_bytes]
 //     value: char[value_length]
-// shared_bytes == 0 for restart points.
+// shared_bytes == 0 for restart points, unless the block uses
+// KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix. In that case shared_bytes for restart
+// points (other than the first one) is the number of bytes shared with the first key of the block.
 //
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
@@ -57,9 +59,26 @@
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+namespace {
+
+size_t SharedPrefixSize(const Slice& lhs, const Slice& rhs) {
+  const size_t min_length = std::min(lhs.size(), rhs.size());
+  size_t shared = 0;
+  while ((shared < min_length) && (lhs[shared] == rhs[shared])) {
+    shared++;
+  }
+  return shared;
+}
+
+} // namespace
+
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           KeyValueEncodingFormat key_value_encoding_format)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      share_block_prefix_(
+          use_delta_encoding &&
+          key_value_encoding_format == KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -74,6 +93,7 @@ void BlockBuilder::Reset() {
   counter_ = 0;
   finished_ = false;
   last_key_.clear();
+  first_key_.clear();
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
@@ -120,16 +140,21 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
   size_t shared = 0;  // number of bytes shared with prev key
+  bool restart = false;
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
+    restart = true;
+    if (share_block_prefix_) {
+      shared = SharedPrefixSize(first_key_, key);
+    }
   } else if (use_delta_encoding_) {
     // See how much sharing to do with previous string
-    const size_t min_length = std::min(last_key_piece.size(), key.size());
-    while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
-      shared++;
-    }
+    shared = SharedPrefixSize(last_key_piece, key);
+  }
+  if (share_block_prefix_ && buffer_.empty()) {
+    first_key_.assign(key.cdata(), key.size());
   }
   const size_t non_shared = key.size() - shared;
 
@@ -143,8 +168,12 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   buffer_.append(value.cdata(), value.size());
 
   // Update state
-  last_key_.resize(shared);
-  last_key_.append(key.cdata() + shared, non_shared);
+  if (restart) {
+    last_key_.assign(key.cdata(), key.size());
+  } else {
+    last_key_.resize(shared);
+    last_key_.append(key.cdata() + shared, non_shared);
+  }
   assert(Slice(last_key_) == key);
   counter_++;
 }
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include "yb/rocksdb/table.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -36,7 +37,9 @@ class BlockBuilder {
   void operator=(const BlockBuilder&) = delete;
 
   explicit BlockBuilder(int block_restart_interval,
-                        bool use_delta_encoding = true);
+                        bool use_delta_encoding = true,
+                        KeyValueEncodingFormat key_value_encoding_format =
+                            KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   // Reset the contents as if the BlockBuilder was just constructed.
   void Reset();
@@ -67,12 +70,15 @@ class BlockBuilder {
  private:
   const int          block_restart_interval_;
   const bool         use_delta_encoding_;
+  // Whether restart keys are delta encoded against the first key of the block.
+  const bool         share_block_prefix_;
 
   std::string           buffer_;    // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
   int                   counter_;   // Number of entries emitted since restart
   bool                  finished_;  // Has Finish() been called?
   std::string           last_key_;
+  std::string           first_key_;  // Only maintained when share_block_prefix_ is set.
 };
 
 }  // namespace rocksdb
@@ -135,6 +135,61 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+TEST_F(BlockTest, SharedBlockPrefixEncoding) {
+  Random rnd(301);
+  Options options = Options();
+
+  // Keys share a long prefix, similar to DocDB keys with the same hash and hashed components.
+  const std::string common_prefix(40, 'p');
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  const int num_records = 1000;
+  for (int i = 0; i < num_records; i++) {
+    keys.push_back(common_prefix + GenerateKey(i, 0, 0, &rnd));
+    values.push_back(RandomString(&rnd, 10));
+  }
+
+  BlockBuilder old_builder(16);
+  BlockBuilder builder(16, true /* use_delta_encoding */,
+                       KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix);
+  for (int i = 0; i < num_records; i++) {
+    old_builder.Add(keys[i], values[i]);
+    builder.Add(keys[i], values[i]);
+  }
+  Slice rawblock = builder.Finish();
+  ASSERT_LT(rawblock.size(), old_builder.Finish().size());
+
+  BlockContents contents;
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block reader(std::move(contents));
+
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(
+      options.comparator, nullptr /* iter */, true /* total_order_seek */,
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedBlockPrefix));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); count++, iter->Next()) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(num_records, count);
+
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    --count;
+    ASSERT_EQ(keys[count], iter->key().ToString());
+  }
+  ASSERT_EQ(0, count);
+
+  for (int i = 0; i < num_records; i++) {
+    int index = rnd.Uniform(num_records);
+    iter->Seek(keys[index]);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(keys[index], iter->key().ToString());
+    ASSERT_EQ(values[index], iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
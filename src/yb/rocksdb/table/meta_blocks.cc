@@ -87,11 +87,17 @@ void PropertyBlockBuilder::AddTableProperty(const TableProperties& props) {
   Add(TablePropertiesNames::kFilterSize, props.filter_size);
   Add(TablePropertiesNames::kFormatVersion, props.format_version);
   Add(TablePropertiesNames::kFixedKeyLen, props.fixed_key_len);
+  if (props.num_blob_indexes > 0) {
+    Add(TablePropertiesNames::kNumBlobIndexes, props.num_blob_indexes);
+  }
 
   if (!props.filter_policy_name.empty()) {
     Add(TablePropertiesNames::kFilterPolicy,
         props.filter_policy_name);
   }
+  if (!props.compression_name.empty()) {
+    Add(TablePropertiesNames::kCompression, props.compression_name);
+  }
 }
 
 Slice PropertyBlockBuilder::Finish() {
@@ -188,7 +194,8 @@ Status ReadProperties(const Slice& handle_value, RandomAccessFileReader* file,
       {TablePropertiesNames::kNumFilterBlocks, &new_table_properties->num_filter_blocks},
       {TablePropertiesNames::kNumDataIndexBlocks, &new_table_properties->num_data_index_blocks},
       {TablePropertiesNames::kFormatVersion, &new_table_properties->format_version},
-      {TablePropertiesNames::kFixedKeyLen, &new_table_properties->fixed_key_len}, };
+      {TablePropertiesNames::kFixedKeyLen, &new_table_properties->fixed_key_len},
+      {TablePropertiesNames::kNumBlobIndexes, &new_table_properties->num_blob_indexes}, };
 
   std::string last_key;
   for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
@@ -220,6 +227,8 @@ Status ReadProperties(const Slice& handle_value, RandomAccessFileReader* file,
       *(pos->second) = val;
     } else if (key == TablePropertiesNames::kFilterPolicy) {
       new_table_properties->filter_policy_name = raw_val.ToString();
+    } else if (key == TablePropertiesNames::kCompression) {
+      new_table_properties->compression_name = raw_val.ToString();
     } else {
       // handle user-collected properties
       new_table_properties->user_collected_properties.insert(
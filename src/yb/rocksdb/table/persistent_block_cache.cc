@@ -0,0 +1,389 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/table/persistent_block_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/table/block.h"
+#include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/util/crc32c.h"
+#include "yb/rocksdb/util/hash.h"
+
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Approximate memory used by an index entry, in addition to its key.
+constexpr size_t kIndexEntryOverhead = 96;
+
+// Number of recently offered blocks tracked by the admission policy.
+constexpr size_t kAdmissionHistorySize = 64 * 1024;
+
+const char* const kFilePrefix = "block-cache-";
+
+// Log structured file of the cache. Blocks are appended to the newest file, and the oldest file is
+// removed as a whole when the cache is full.
+struct CacheFile {
+  uint64_t id;
+  std::string path;
+  // Readers keep the file alive, so it could be safely read after the file was removed from the
+  // cache.
+  std::unique_ptr<RandomAccessFile> reader;
+  size_t size = 0;
+  // Keys of the blocks that were written to this file.
+  std::vector<std::string> keys;
+};
+
+typedef std::shared_ptr<CacheFile> CacheFilePtr;
+
+struct BlockLocation {
+  CacheFilePtr file;
+  uint64_t offset;
+  size_t size;
+  uint32_t crc;
+  CompressionType compression_type;
+};
+
+class PersistentBlockCache : public Cache {
+ public:
+  explicit PersistentBlockCache(const PersistentBlockCacheOptions& options)
+      : options_(options),
+        env_(options.env ? options.env : Env::Default()),
+        file_size_(std::max<size_t>(std::min(options.file_size, options.capacity / 4), 4096)) {
+  }
+
+  ~PersistentBlockCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!files_.empty()) {
+      RemoveOldestFileUnlocked();
+    }
+  }
+
+  Status Init() {
+    RETURN_NOT_OK(env_->CreateDirIfMissing(options_.path));
+    // The index is not persisted, so files of the previous run are useless.
+    std::vector<std::string> children;
+    RETURN_NOT_OK(env_->GetChildren(options_.path, &children));
+    for (const auto& child : children) {
+      if (child.compare(0, strlen(kFilePrefix), kFilePrefix) == 0) {
+        RETURN_NOT_OK(env_->DeleteFile(options_.path + "/" + child));
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return StartNewFileUnlocked();
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    if (handle != nullptr) {
+      return STATUS(NotSupported, "Persistent block cache does not return handles on insert");
+    }
+    if (query_id != kNoCacheQueryId) {
+      auto status = Write(key, query_id, *static_cast<Block*>(value));
+      if (!status.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to write block to persistent block cache: "
+                                         << status;
+      }
+    }
+    // The block was copied to the file, or rejected, so the value is not needed anymore.
+    // Failures are not reported to the caller, since the block is already deleted, and the read
+    // that inserts it should not fail because of the cache.
+    (*deleter)(key, value);
+    return Status::OK();
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    BlockLocation location;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key.ToBuffer());
+      if (it == index_.end()) {
+        return nullptr;
+      }
+      location = it->second;
+    }
+
+    // Read outside of the lock, the file is kept alive by the location.
+    std::unique_ptr<char[]> buffer(new char[location.size]);
+    Slice data;
+    auto status = location.file->reader->Read(location.offset, location.size, &data, buffer.get());
+    if (status.ok() && data.size() != location.size) {
+      status = STATUS_FORMAT(Corruption, "Short read: $0 instead of $1",
+                             data.size(), location.size);
+    }
+    if (status.ok() && crc32c::Value(data.cdata(), data.size()) != location.crc) {
+      status = STATUS(Corruption, "Checksum mismatch");
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read block from " << location.file->path << " at "
+                   << location.offset << ": " << status;
+      Erase(key);
+      return nullptr;
+    }
+    if (data.data() != buffer.get()) {
+      memcpy(buffer.get(), data.data(), data.size());
+    }
+    BlockContents contents(std::move(buffer), location.size, true /* cachable */,
+                           location.compression_type, options_.mem_tracker);
+    return reinterpret_cast<Handle*>(new Block(std::move(contents)));
+  }
+
+  void Release(Handle* handle) override {
+    delete reinterpret_cast<Block*>(handle);
+  }
+
+  void* Value(Handle* handle) override {
+    return handle;
+  }
+
+  void Erase(const Slice& key) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key.ToBuffer());
+    if (it != index_.end()) {
+      // Space in the file is reclaimed when the whole file is removed.
+      EraseUnlocked(it);
+    }
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.capacity = capacity;
+    while (files_.size() > 1 && usage_ > options_.capacity) {
+      RemoveOldestFileUnlocked();
+    }
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return true;
+  }
+
+  size_t GetCapacity() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_.capacity;
+  }
+
+  size_t GetUsage() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usage_;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<Block*>(handle)->size();
+  }
+
+  size_t GetPinnedUsage() const override {
+    return 0;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    // Values are not kept in memory.
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    // Block cache metrics of the server entity belong to the in-memory block cache, hits and
+    // misses of this cache are reported by the compressed block cache statistics tickers.
+  }
+
+ private:
+  typedef std::unordered_map<std::string, BlockLocation> Index;
+
+  // Returns true if the block with the given key should be written to the cache.
+  bool AdmitUnlocked(const Slice& key, QueryId query_id) {
+    if (options_.admission_threshold <= 1 || query_id == kInMultiTouchId) {
+      return true;
+    }
+    auto hash = Hash(key.data(), key.size(), 0);
+    auto it = offers_.find(hash);
+    if (it == offers_.end()) {
+      while (offers_order_.size() >= kAdmissionHistorySize) {
+        offers_.erase(offers_order_.front());
+        offers_order_.pop_front();
+      }
+      offers_.emplace(hash, 1);
+      offers_order_.push_back(hash);
+      return false;
+    }
+    if (++it->second < options_.admission_threshold) {
+      return false;
+    }
+    // The hash stays in the order queue, and is removed from it when its turn comes.
+    offers_.erase(it);
+    return true;
+  }
+
+  Status Write(const Slice& key, QueryId query_id, const Block& block) {
+    if (block.compression_type() == kNoCompression) {
+      return STATUS(InvalidArgument, "Persistent block cache accepts only compressed blocks");
+    }
+    if (block.size() > file_size_) {
+      return STATUS(Incomplete, "Block is too big for persistent block cache");
+    }
+    std::string key_str = key.ToBuffer();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (index_.count(key_str) || !AdmitUnlocked(key, query_id)) {
+        return Status::OK();
+      }
+    }
+
+    // Writers are serialized, so blocks are appended in the order their offsets are reserved.
+    // mutex_ is not held during I/O, so lookups are not blocked by writes.
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    CacheFilePtr file;
+    uint64_t offset;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (index_.count(key_str)) {
+        return Status::OK();
+      }
+      if (files_.back()->size + block.size() > file_size_) {
+        RETURN_NOT_OK(StartNewFileUnlocked());
+      }
+      while (files_.size() > 1 && usage_ + block.size() > options_.capacity) {
+        RemoveOldestFileUnlocked();
+      }
+      // Only writers start new files, so the newest file is not removed until this write is
+      // published.
+      file = files_.back();
+      offset = file->size;
+      file->size += block.size();
+      usage_ += block.size();
+    }
+
+    // Files are read by offset with pread, so appended data is visible to readers as soon as
+    // Append returns.
+    auto status = writer_->Append(Slice(block.data(), block.size()));
+    if (status.ok()) {
+      status = writer_->Flush();
+    }
+    const uint32_t crc = crc32c::Value(block.data(), block.size());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!status.ok()) {
+      // The block could be partially written, so offsets of the next blocks appended to this file
+      // would be wrong. The file is marked as full, so they are written to a new file.
+      usage_ += file_size_ - file->size;
+      file->size = file_size_;
+      return status;
+    }
+    BlockLocation location = {file, offset, block.size(), crc, block.compression_type()};
+    file->keys.push_back(key_str);
+    if (options_.mem_tracker) {
+      options_.mem_tracker->Consume(key_str.size() * 2 + kIndexEntryOverhead);
+    }
+    index_.emplace(std::move(key_str), std::move(location));
+    return Status::OK();
+  }
+
+  void EraseUnlocked(Index::iterator it) {
+    if (options_.mem_tracker) {
+      options_.mem_tracker->Release(it->first.size() + kIndexEntryOverhead);
+    }
+    index_.erase(it);
+  }
+
+  Status StartNewFileUnlocked() {
+    auto file = std::make_shared<CacheFile>();
+    file->id = ++last_file_id_;
+    file->path = yb::Format("$0/$1$2", options_.path, kFilePrefix, file->id);
+    std::unique_ptr<WritableFile> writer;
+    RETURN_NOT_OK(env_->NewWritableFile(file->path, &writer, EnvOptions()));
+    RETURN_NOT_OK(env_->NewRandomAccessFile(file->path, &file->reader, EnvOptions()));
+    if (writer_) {
+      WARN_NOT_OK(writer_->Close(), "Failed to close persistent block cache file");
+    }
+    writer_ = std::move(writer);
+    files_.push_back(std::move(file));
+    return Status::OK();
+  }
+
+  void RemoveOldestFileUnlocked() {
+    auto file = std::move(files_.front());
+    files_.pop_front();
+    if (files_.empty()) {
+      // Destruction of the cache.
+      WARN_NOT_OK(writer_->Close(), "Failed to close persistent block cache file");
+      writer_.reset();
+    }
+    for (const auto& key : file->keys) {
+      auto it = index_.find(key);
+      if (it != index_.end() && it->second.file == file) {
+        EraseUnlocked(it);
+      }
+    }
+    if (options_.mem_tracker) {
+      // Keys of the file are accounted together with their index entries.
+      int64_t keys_size = 0;
+      for (const auto& key : file->keys) {
+        keys_size += key.size();
+      }
+      options_.mem_tracker->Release(keys_size);
+    }
+    usage_ -= file->size;
+    WARN_NOT_OK(env_->DeleteFile(file->path), "Failed to remove persistent block cache file");
+  }
+
+  PersistentBlockCacheOptions options_;
+  Env* const env_;
+  const size_t file_size_;
+  std::atomic<uint64_t> last_id_{0};
+
+  // Serializes writers. Acquired before mutex_. Guards writer_, which is replaced under both
+  // mutexes.
+  std::mutex write_mutex_;
+
+  mutable std::mutex mutex_;
+  Index index_;
+  std::deque<CacheFilePtr> files_;
+  std::unique_ptr<WritableFile> writer_;
+  uint64_t last_file_id_ = 0;
+  size_t usage_ = 0;
+
+  // Number of offers of recently offered blocks that were not admitted yet.
+  std::unordered_map<uint32_t, int> offers_;
+  std::deque<uint32_t> offers_order_;
+};
+
+} // namespace
+
+yb::Result<std::shared_ptr<Cache>> NewPersistentBlockCache(
+    const PersistentBlockCacheOptions& options) {
+  auto result = std::make_shared<PersistentBlockCache>(options);
+  RETURN_NOT_OK(result->Init());
+  return std::shared_ptr<Cache>(std::move(result));
+}
+
+}  // namespace rocksdb
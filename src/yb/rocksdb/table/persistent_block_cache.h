@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_TABLE_PERSISTENT_BLOCK_CACHE_H
+#define YB_ROCKSDB_TABLE_PERSISTENT_BLOCK_CACHE_H
+
+#include <memory>
+#include <string>
+
+#include "yb/rocksdb/cache.h"
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+class MemTracker;
+
+}
+
+namespace rocksdb {
+
+class Env;
+
+struct PersistentBlockCacheOptions {
+  // Directory for the cache files, it should be on a fast local device. Files found in this
+  // directory on startup are removed.
+  std::string path;
+
+  // Max total size of the cache files.
+  size_t capacity = 0;
+
+  // Size of a single cache file. The oldest file is removed as a whole when the cache is full.
+  size_t file_size = 64 * 1024 * 1024;
+
+  // Block is written to the cache only when it is inserted this number of times within the recent
+  // history. So blocks read only once, for instance by a scan, do not wear the device.
+  int admission_threshold = 2;
+
+  Env* env = nullptr;
+
+  // Accounts memory of the in-memory index and of the blocks read from the cache.
+  std::shared_ptr<yb::MemTracker> mem_tracker;
+};
+
+// Creates a cache of compressed blocks, that keeps them in log structured files on a local
+// device, and keeps only the index of the blocks in memory. It is intended to be used as
+// BlockBasedTableOptions::block_cache_compressed, under the in-memory block cache, when SST files
+// reside on network attached storage from which block reads take milliseconds.
+//
+// Values should be compressed Block objects, inserted without obtaining the handle. Lookup
+// reads the block from the file and returns a handle to a new Block, that is deleted by Release.
+extern yb::Result<std::shared_ptr<Cache>> NewPersistentBlockCache(
+    const PersistentBlockCacheOptions& options);
+
+}  // namespace rocksdb
+
+#endif  // YB_ROCKSDB_TABLE_PERSISTENT_BLOCK_CACHE_H
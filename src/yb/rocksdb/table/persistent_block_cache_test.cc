@@ -0,0 +1,151 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/table/block.h"
+#include "yb/rocksdb/table/format.h"
+#include "yb/rocksdb/table/persistent_block_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+
+namespace rocksdb {
+
+class PersistentBlockCacheTest : public testing::Test {
+ protected:
+  std::shared_ptr<Cache> CreateCache(size_t capacity, int admission_threshold) {
+    PersistentBlockCacheOptions options;
+    options.path = test::TmpDir() + "/persistent_block_cache_test";
+    options.capacity = capacity;
+    options.admission_threshold = admission_threshold;
+    auto result = NewPersistentBlockCache(options);
+    if (!result.ok()) {
+      ADD_FAILURE() << "Failed to create cache: " << result.status();
+      return nullptr;
+    }
+    return *result;
+  }
+
+  static std::string Contents(int index, size_t size) {
+    std::string result(size, 'a' + index % 26);
+    result[0] = static_cast<char>(index);
+    return result;
+  }
+
+  static void DeleteBlock(const Slice& key, void* value) {
+    delete static_cast<Block*>(value);
+  }
+
+  void Insert(Cache* cache, const std::string& key, const std::string& contents) {
+    std::unique_ptr<char[]> data(new char[contents.size()]);
+    memcpy(data.get(), contents.data(), contents.size());
+    auto* block = new Block(BlockContents(
+        std::move(data), contents.size(), true /* cachable */, kSnappyCompression,
+        nullptr /* mem_tracker */));
+    ASSERT_OK(cache->Insert(key, kDefaultQueryId, block, block->usable_size(), &DeleteBlock));
+  }
+
+  // Returns contents of the block, or empty string if it is not in the cache.
+  std::string Lookup(Cache* cache, const std::string& key) {
+    auto* handle = cache->Lookup(key, kDefaultQueryId);
+    if (handle == nullptr) {
+      return std::string();
+    }
+    auto* block = static_cast<Block*>(cache->Value(handle));
+    EXPECT_EQ(kSnappyCompression, block->compression_type());
+    std::string result(block->data(), block->size());
+    cache->Release(handle);
+    return result;
+  }
+};
+
+TEST_F(PersistentBlockCacheTest, Admission) {
+  auto cache = CreateCache(1024 * 1024, 2 /* admission_threshold */);
+  ASSERT_TRUE(cache != nullptr);
+
+  auto contents = Contents(1, 1000);
+  Insert(cache.get(), "key1", contents);
+  // Block that was read once is not admitted.
+  ASSERT_EQ("", Lookup(cache.get(), "key1"));
+
+  Insert(cache.get(), "key1", contents);
+  ASSERT_EQ(contents, Lookup(cache.get(), "key1"));
+  ASSERT_EQ(contents.size(), cache->GetUsage());
+
+  cache->Erase("key1");
+  ASSERT_EQ("", Lookup(cache.get(), "key1"));
+}
+
+TEST_F(PersistentBlockCacheTest, Eviction) {
+  constexpr size_t kCapacity = 64 * 1024;
+  constexpr size_t kBlockSize = 1000;
+  constexpr int kBlocks = 200;
+
+  auto cache = CreateCache(kCapacity, 1 /* admission_threshold */);
+  ASSERT_TRUE(cache != nullptr);
+
+  for (int i = 0; i != kBlocks; ++i) {
+    Insert(cache.get(), std::to_string(i), Contents(i, kBlockSize));
+    ASSERT_LE(cache->GetUsage(), kCapacity);
+  }
+
+  // The oldest blocks are removed together with their files, the newest ones are still there.
+  ASSERT_EQ("", Lookup(cache.get(), "0"));
+  for (int i = kBlocks - 10; i != kBlocks; ++i) {
+    ASSERT_EQ(Contents(i, kBlockSize), Lookup(cache.get(), std::to_string(i)));
+  }
+}
+
+TEST_F(PersistentBlockCacheTest, ConcurrentWritesAndLookups) {
+  constexpr size_t kBlockSize = 1000;
+  constexpr int kThreads = 4;
+  constexpr int kBlocksPerThread = 200;
+
+  auto cache = CreateCache(16 * 1024 * 1024, 1 /* admission_threshold */);
+  ASSERT_TRUE(cache != nullptr);
+
+  // Each block is found with its own contents at once, while other threads write and read too.
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([this, &cache, t] {
+      for (int i = t * kBlocksPerThread; i != (t + 1) * kBlocksPerThread; ++i) {
+        const auto key = std::to_string(i);
+        Insert(cache.get(), key, Contents(i, kBlockSize));
+        EXPECT_EQ(Contents(i, kBlockSize), Lookup(cache.get(), key));
+        const auto other = std::to_string(i % kBlocksPerThread);
+        const auto other_contents = Lookup(cache.get(), other);
+        EXPECT_TRUE(other_contents.empty() ||
+                    other_contents == Contents(i % kBlocksPerThread, kBlockSize));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kThreads * kBlocksPerThread * kBlockSize, cache->GetUsage());
+  for (int i = 0; i != kThreads * kBlocksPerThread; ++i) {
+    ASSERT_EQ(Contents(i, kBlockSize), Lookup(cache.get(), std::to_string(i)));
+  }
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -26,6 +26,8 @@
 
 #include <stdint.h>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +63,26 @@ struct TableReaderOptions {
   bool skip_filters;
 };
 
+// Holds the dictionary used to compress data blocks of new SST files of a column family, see
+// CompressionOptions::max_dict_bytes.
+// Thread safe.
+class CompressionDictHolder {
+ public:
+  std::shared_ptr<const std::string> Get() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dict_;
+  }
+
+  void Set(std::shared_ptr<const std::string> dict) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dict_ = std::move(dict);
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::shared_ptr<const std::string> dict_;
+};
+
 struct TableBuilderOptions {
   TableBuilderOptions(
       const ImmutableCFOptions& _ioptions,
@@ -68,13 +90,15 @@ struct TableBuilderOptions {
       const IntTblPropCollectorFactories& _int_tbl_prop_collector_factories,
       CompressionType _compression_type,
       const CompressionOptions& _compression_opts,
-      bool _skip_filters)
+      bool _skip_filters,
+      CompressionDictHolder* _compression_dict_holder = nullptr)
       : ioptions(_ioptions),
         internal_comparator(_internal_comparator),
         int_tbl_prop_collector_factories(&_int_tbl_prop_collector_factories),
         compression_type(_compression_type),
         compression_opts(_compression_opts),
-        skip_filters(_skip_filters) {}
+        skip_filters(_skip_filters),
+        compression_dict_holder(_compression_dict_holder) {}
 
   const ImmutableCFOptions& ioptions;
   std::shared_ptr<const InternalKeyComparator> internal_comparator;
@@ -83,6 +107,9 @@ struct TableBuilderOptions {
   const CompressionOptions& compression_opts;
   // This is only used for BlockBasedTableBuilder
   bool skip_filters = false;
+  // Source of the compression dictionary for the new file, which also receives the dictionary
+  // trained on the new file data. Not owned, may be null. Only used for BlockBasedTableBuilder.
+  CompressionDictHolder* compression_dict_holder = nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
@@ -95,6 +95,11 @@ std::string TableProperties::ToString(
       filter_policy_name.empty() ? std::string("N/A") : filter_policy_name,
       prop_delim, kv_delim);
 
+  AppendProperty(
+      &result, "compression",
+      compression_name.empty() ? std::string("N/A") : compression_name,
+      prop_delim, kv_delim);
+
   return result;
 }
 
@@ -109,6 +114,7 @@ void TableProperties::Add(const TableProperties& tp) {
   num_filter_blocks += tp.num_filter_blocks;
   num_data_index_blocks += tp.num_data_index_blocks;
   num_entries += tp.num_entries;
+  num_blob_indexes += tp.num_blob_indexes;
 }
 
 const std::string TablePropertiesNames::kDataSize  =
@@ -133,14 +139,19 @@ const std::string TablePropertiesNames::kNumDataIndexBlocks =
     "rocksdb.num.data.index.blocks";
 const std::string TablePropertiesNames::kFilterPolicy =
     "rocksdb.filter.policy";
+const std::string TablePropertiesNames::kCompression =
+    "rocksdb.compression";
 const std::string TablePropertiesNames::kFormatVersion =
     "rocksdb.format.version";
 const std::string TablePropertiesNames::kFixedKeyLen =
     "rocksdb.fixed.key.length";
+const std::string TablePropertiesNames::kNumBlobIndexes =
+    "rocksdb.num.blob.indexes";
 
 extern const std::string kPropertiesBlock = "rocksdb.properties";
 // Old property block name for backward compatibility
 extern const std::string kPropertiesBlockOldName = "rocksdb.stats";
+extern const std::string kCompressionDictBlock = "rocksdb.compression_dict";
 
 // Seek to the properties block.
 // Return true if it successfully seeks to the properties block.
@@ -65,6 +65,8 @@
 #include "yb/util/enums.h"
 
 DECLARE_double(cache_single_touch_ratio);
+DECLARE_uint64(rocksdb_readahead_initial_size);
+DECLARE_uint64(rocksdb_readahead_max_size);
 
 namespace rocksdb {
 
@@ -1570,6 +1572,147 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+namespace {
+
+// Records readahead requests instead of performing them.
+class ReadaheadRecordingSource : public test::StringSource {
+ public:
+  explicit ReadaheadRecordingSource(const Slice& contents) : StringSource(contents) {}
+
+  void Readahead(uint64_t offset, size_t n) override {
+    requests_.emplace_back(offset, n);
+  }
+
+  std::vector<std::pair<uint64_t, size_t>>& requests() { return requests_; }
+
+ private:
+  std::vector<std::pair<uint64_t, size_t>> requests_;
+};
+
+} // namespace
+
+TEST_F(BlockBasedTableTest, SequentialScanReadahead) {
+  google::FlagSaver flag_saver;
+  FLAGS_rocksdb_readahead_initial_size = 4000;
+  FLAGS_rocksdb_readahead_max_size = 16000;
+
+  Options options;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1000;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions(options);
+  const auto& comparator = GetPlainInternalComparator(options.comparator);
+
+  unique_ptr<WritableFileWriter> file_writer(test::GetWritableFileWriter(new test::StringSink()));
+  IntTblPropCollectorFactories int_tbl_prop_collector_factories;
+  unique_ptr<TableBuilder> builder(ioptions.table_factory->NewTableBuilder(
+      TableBuilderOptions(ioptions, comparator, int_tbl_prop_collector_factories,
+                          options.compression, CompressionOptions(), /* skip_filters */ false),
+      TablePropertiesCollectorFactory::Context::kUnknownColumnFamily, file_writer.get()));
+  const int kNumKeys = 1000;
+  std::vector<std::string> keys;
+  for (int i = 0; i != kNumKeys; ++i) {
+    keys.push_back("key" + std::to_string(1000000 + i));
+    builder->Add(keys.back(), std::string(100, 'v'));
+  }
+  ASSERT_OK(builder->Finish());
+  ASSERT_OK(file_writer->Flush());
+
+  const auto& contents =
+      static_cast<test::StringSink*>(file_writer->writable_file())->contents();
+  auto* source = new ReadaheadRecordingSource(contents);
+  unique_ptr<TableReader> table_reader;
+  EnvOptions env_options;
+  ASSERT_OK(ioptions.table_factory->NewTableReader(
+      TableReaderOptions(ioptions, env_options, comparator),
+      unique_ptr<RandomAccessFileReader>(test::GetRandomAccessFileReader(source)),
+      contents.size(), &table_reader));
+
+  // A full scan reads ahead, with windows growing up to the max size and never going back.
+  {
+    unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, count);
+  }
+  const auto& requests = source->requests();
+  ASSERT_GT(requests.size(), 1);
+  uint64_t limit = 0;
+  for (const auto& request : requests) {
+    ASSERT_GE(request.first, limit);
+    ASSERT_LE(request.second, FLAGS_rocksdb_readahead_max_size);
+    limit = request.first + request.second;
+  }
+
+  // Point lookups do not read ahead.
+  source->requests().clear();
+  {
+    unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions()));
+    for (int i = kNumKeys - 1; i >= 0; i -= 97) {
+      iter->Seek(keys[i]);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys[i], iter->key().ToString());
+    }
+  }
+  ASSERT_TRUE(source->requests().empty());
+}
+
+// Uncompressed data blocks of memory mapped files are served from the mapping, bypassing the block
+// cache.
+TEST_F(BlockBasedTableTest, MemoryMappedReadsBypassBlockCache) {
+  Options options;
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1000;
+  table_options.block_cache = NewLRUCache(1024 * 1024);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableCFOptions ioptions(options);
+  const auto& comparator = GetPlainInternalComparator(options.comparator);
+
+  unique_ptr<WritableFileWriter> file_writer(test::GetWritableFileWriter(new test::StringSink()));
+  IntTblPropCollectorFactories int_tbl_prop_collector_factories;
+  unique_ptr<TableBuilder> builder(ioptions.table_factory->NewTableBuilder(
+      TableBuilderOptions(ioptions, comparator, int_tbl_prop_collector_factories,
+                          options.compression, CompressionOptions(), /* skip_filters */ false),
+      TablePropertiesCollectorFactory::Context::kUnknownColumnFamily, file_writer.get()));
+  const int kNumKeys = 100;
+  for (int i = 0; i != kNumKeys; ++i) {
+    builder->Add("key" + std::to_string(1000000 + i), std::string(100, 'v'));
+  }
+  ASSERT_OK(builder->Finish());
+  ASSERT_OK(file_writer->Flush());
+  const auto& contents =
+      static_cast<test::StringSink*>(file_writer->writable_file())->contents();
+
+  // Read through the mapping first, so the block cache is empty before the buffered read.
+  for (bool mmap : {true, false}) {
+    unique_ptr<TableReader> table_reader;
+    ASSERT_OK(ioptions.table_factory->NewTableReader(
+        TableReaderOptions(ioptions, EnvOptions(), comparator),
+        unique_ptr<RandomAccessFileReader>(test::GetRandomAccessFileReader(
+            new test::StringSource(contents, 0 /* uniq_id */, mmap))),
+        contents.size(), &table_reader));
+
+    unique_ptr<InternalIterator> iter(table_reader->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(std::string(100, 'v'), iter->value().ToString());
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, count);
+    if (mmap) {
+      ASSERT_EQ(0, table_options.block_cache->GetUsage());
+    } else {
+      ASSERT_GT(table_options.block_cache->GetUsage(), 0);
+    }
+  }
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
@@ -74,11 +74,17 @@ struct TableProperties {
   uint64_t format_version = 0;
   // If 0, key is variable length. Otherwise number of bytes for each key.
   uint64_t fixed_key_len = 0;
+  // the number of entries that reference values in blob files
+  uint64_t num_blob_indexes = 0;
 
   // The name of the filter policy used in this table.
   // If no filter policy is used, `filter_policy_name` will be an empty string.
   std::string filter_policy_name;
 
+  // The name of the compression type the data blocks of this table were written with. Blocks that
+  // do not compress well enough are still stored uncompressed.
+  std::string compression_name;
+
   // user collected properties
   UserCollectedProperties user_collected_properties;
   UserCollectedProperties readable_properties;
@@ -107,10 +113,13 @@ struct TablePropertiesNames {
   static const std::string kNumDataIndexBlocks;
   static const std::string kFormatVersion;
   static const std::string kFixedKeyLen;
+  static const std::string kNumBlobIndexes;
   static const std::string kFilterPolicy;
+  static const std::string kCompression;
 };
 
 extern const std::string kPropertiesBlock;
+extern const std::string kCompressionDictBlock;
 
 enum EntryType {
   kEntryPut,
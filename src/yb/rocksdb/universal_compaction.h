@@ -89,6 +89,14 @@ class CompactionOptionsUniversal {
   // Default: false
   bool allow_trivial_move;
 
+  // If deletions make at least this percentage of the entries in a sequence of sorted runs that
+  // ends with the earliest one, those runs are compacted together regardless of their number and
+  // sizes. Such compaction produces the bottommost output, so deletions are dropped together with
+  // the entries they delete, and files that contain only deleted data disappear.
+  // Only used when the column family has a single level. 0 disables.
+  // Default: 0
+  unsigned int delete_triggered_compaction_percent;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -97,7 +105,8 @@ class CompactionOptionsUniversal {
         max_size_amplification_percent(200),
         compression_size_percent(-1),
         stop_style(kCompactionStopStyleTotalSize),
-        allow_trivial_move(false) {}
+        allow_trivial_move(false),
+        delete_triggered_compaction_percent(0) {}
 };
 
 }  // namespace rocksdb
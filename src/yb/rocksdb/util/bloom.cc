@@ -23,6 +23,10 @@
 
 #include <cstdlib>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "yb/rocksdb/filter_policy.h"
 
 #include "yb/rocksdb/table/block_based_filter_block.h"
@@ -30,6 +34,7 @@
 #include "yb/rocksdb/table/fixed_size_filter_block.h"
 #include "yb/rocksdb/util/hash.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/util/hash_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/math_util.h"
 
@@ -534,6 +539,218 @@ class FixedSizeFilterPolicy : public FilterPolicy {
   Logger* logger_;
 };
 
+// A fixed size blocked bloom filter sets and checks all bits for a key within a single 64-byte
+// block, which is treated as 8 64-bit words with one bit set in each word. So a key is checked by
+// loading one cache line and comparing it with a mask computed from the hash of the key, without
+// data-dependent branches, in two 256-bit operations when AVX2 is available.
+//
+// The filter is encoded as num_blocks blocks followed by the same metadata as in FullFilter, where
+// num_probes is always kBlockedBloomProbes.
+//
+// Since bits of a key are not spread over the whole filter, it needs slightly more bits per key
+// than a regular bloom filter for the same false positive rate, e.g. about 10.1 instead of 9.6 for
+// 1%.
+constexpr size_t kBlockedBloomBlockSize = 64;
+constexpr size_t kBlockedBloomProbes = 8;
+constexpr size_t kBlockedBloomWordBits = 64;
+
+// Multipliers used to get the bit of each word from the hash of a key.
+constexpr uint32_t kBlockedBloomSalts[kBlockedBloomProbes] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+inline uint64_t BlockedBloomHash(const Slice& key) {
+  return yb::HashUtil::MurmurHash2_64(key.data(), static_cast<int>(key.size()), 0xbc9f1d34);
+}
+
+// The block is chosen by the upper half of the hash and the bits within it by the lower half.
+inline uint32_t BlockedBloomBlockIndex(uint64_t hash, uint32_t num_blocks) {
+  return static_cast<uint32_t>(((hash >> 32) * num_blocks) >> 32);
+}
+
+inline uint32_t BlockedBloomBit(uint32_t hash, size_t word) {
+  return (hash * kBlockedBloomSalts[word]) >> 26;
+}
+
+void BlockedBloomAddHash(uint64_t hash, uint32_t num_blocks, char* data) {
+  char* block = data + BlockedBloomBlockIndex(hash, num_blocks) * kBlockedBloomBlockSize;
+  const uint32_t lower = static_cast<uint32_t>(hash);
+  for (size_t i = 0; i != kBlockedBloomProbes; ++i) {
+    const uint32_t bit = BlockedBloomBit(lower, i);
+    block[i * (kBlockedBloomWordBits / 8) + bit / 8] |= 1 << (bit % 8);
+  }
+}
+
+bool BlockedBloomHashMayMatch(uint64_t hash, uint32_t num_blocks, const char* data) {
+  const char* block = data + BlockedBloomBlockIndex(hash, num_blocks) * kBlockedBloomBlockSize;
+  const uint32_t lower = static_cast<uint32_t>(hash);
+#if defined(__AVX2__)
+  const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kBlockedBloomSalts));
+  const __m256i bits = _mm256_srli_epi32(
+      _mm256_mullo_epi32(_mm256_set1_epi32(lower), salts), 26);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i low_mask = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+  const __m256i high_mask = _mm256_sllv_epi64(
+      one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+  const __m256i low_words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  const __m256i high_words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+  // testc returns 1 when all bits of the mask are set in the words.
+  return _mm256_testc_si256(low_words, low_mask) & _mm256_testc_si256(high_words, high_mask);
+#else
+  int missing = 0;
+  for (size_t i = 0; i != kBlockedBloomProbes; ++i) {
+    const uint32_t bit = BlockedBloomBit(lower, i);
+    missing |= ~block[i * (kBlockedBloomWordBits / 8) + bit / 8] & (1 << (bit % 8));
+  }
+  return missing == 0;
+#endif
+}
+
+// Expected false positive rate of the blocked bloom filter with the specified average number of
+// keys per block. The number of keys in a block has Poisson distribution, and with i keys in the
+// block, each probed bit is set with probability 1 - (1 - 1/64)^i.
+double BlockedBloomFalsePositiveRate(double keys_per_block) {
+  double result = 0;
+  double poisson = exp(-keys_per_block);
+  for (size_t i = 0; i != 4 * kBlockedBloomBlockSize * 8; ++i) {
+    if (i != 0) {
+      poisson *= keys_per_block / i;
+    }
+    const double bit_set = 1 - pow(1 - 1.0 / kBlockedBloomWordBits, i);
+    result += poisson * pow(bit_set, kBlockedBloomProbes);
+  }
+  return result;
+}
+
+// Returns the maximum average number of keys per block that keeps the false positive rate of the
+// blocked bloom filter within error_rate.
+double BlockedBloomMaxKeysPerBlock(double error_rate) {
+  double min = 0;
+  double max = kBlockedBloomBlockSize * 8;
+  for (int i = 0; i != 40; ++i) {
+    const double middle = (min + max) / 2;
+    if (BlockedBloomFalsePositiveRate(middle) <= error_rate) {
+      min = middle;
+    } else {
+      max = middle;
+    }
+  }
+  return min;
+}
+
+class FixedSizeBlockedFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  FixedSizeBlockedFilterBitsBuilder(const FixedSizeBlockedFilterBitsBuilder&) = delete;
+  void operator=(const FixedSizeBlockedFilterBitsBuilder&) = delete;
+
+  FixedSizeBlockedFilterBitsBuilder(uint32_t num_blocks, size_t max_keys)
+      : num_blocks_(num_blocks), max_keys_(max_keys),
+        data_(new char[FilterSize()]) {
+    memset(data_.get(), 0, FilterSize());
+  }
+
+  void AddKey(const Slice& key) override {
+    ++keys_added_;
+    BlockedBloomAddHash(BlockedBloomHash(key), num_blocks_, data_.get());
+  }
+
+  bool IsFull() const override { return keys_added_ >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    char* metadata = data_.get() + num_blocks_ * kBlockedBloomBlockSize;
+    metadata[0] = static_cast<char>(kBlockedBloomProbes);
+    EncodeFixed32(metadata + 1, num_blocks_);
+    buf->reset(data_.release());
+    return Slice(buf->get(), FilterSize());
+  }
+
+  static constexpr size_t kMetaDataSize = FullFilterBitsBuilder::kMetaDataSize;
+
+ private:
+  size_t FilterSize() const { return num_blocks_ * kBlockedBloomBlockSize + kMetaDataSize; }
+
+  const uint32_t num_blocks_;
+  const size_t max_keys_;
+  size_t keys_added_ = 0;
+  std::unique_ptr<char[]> data_;
+};
+
+class FixedSizeBlockedFilterBitsReader : public FilterBitsReader {
+ public:
+  FixedSizeBlockedFilterBitsReader(const FixedSizeBlockedFilterBitsReader&) = delete;
+  void operator=(const FixedSizeBlockedFilterBitsReader&) = delete;
+
+  FixedSizeBlockedFilterBitsReader(const Slice& contents, Logger* logger)
+      : data_(contents.cdata()) {
+    constexpr size_t kMetaDataSize = FixedSizeBlockedFilterBitsBuilder::kMetaDataSize;
+    if (contents.size() > kMetaDataSize) {
+      const char* metadata = contents.cend() - kMetaDataSize;
+      num_blocks_ = DecodeFixed32(metadata + 1);
+      if (static_cast<uint8_t>(metadata[0]) != kBlockedBloomProbes || num_blocks_ == 0 ||
+          contents.size() != num_blocks_ * kBlockedBloomBlockSize + kMetaDataSize) {
+        RLOG(InfoLogLevel::ERROR_LEVEL, logger, "Bloom filter data is broken, won't be used.");
+        FAIL_IF_NOT_PRODUCTION();
+        num_blocks_ = 0;
+        broken_ = true;
+      }
+    }
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (num_blocks_ == 0) {
+      // A broken filter is regarded as match, an empty one as mismatch.
+      return broken_;
+    }
+    return BlockedBloomHashMayMatch(BlockedBloomHash(entry), num_blocks_, data_);
+  }
+
+ private:
+  const char* data_;
+  uint32_t num_blocks_ = 0;
+  bool broken_ = false;
+};
+
+class FixedSizeBlockedFilterPolicy : public FilterPolicy {
+ public:
+  FixedSizeBlockedFilterPolicy(uint32_t total_bits, double error_rate, Logger* logger)
+      : num_blocks_(yb::ceil_div<uint32_t>(total_bits, kBlockedBloomBlockSize * 8)),
+        max_keys_(static_cast<size_t>(num_blocks_ * BlockedBloomMaxKeysPerBlock(error_rate))),
+        logger_(logger) {
+    DCHECK_GT(error_rate, 0);
+    DCHECK_GT(total_bits, 0);
+  }
+
+  FilterType GetFilterType() const override { return FilterType::kFixedSizeFilter; }
+
+  const char* Name() const override {
+    return "rocksdb.FixedSizeBlockedBloomFilter";
+  }
+
+  // Not used in FixedSizeFilter. GetFilterBitsBuilder/Reader interface should be used.
+  void CreateFilter(const Slice* keys, int n, std::string* dst) const override {
+    assert(!"FixedSizeBlockedFilterPolicy::CreateFilter is not supported");
+  }
+
+  bool KeyMayMatch(const Slice& key, const Slice& filter) const override {
+    assert(!"FixedSizeBlockedFilterPolicy::KeyMayMatch is not supported");
+    return true;
+  }
+
+  FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    return new FixedSizeBlockedFilterBitsBuilder(num_blocks_, max_keys_);
+  }
+
+  FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    return new FixedSizeBlockedFilterBitsReader(contents, logger_);
+  }
+
+ private:
+  const uint32_t num_blocks_;
+  const size_t max_keys_;
+  Logger* logger_;
+};
+
 }  // namespace
 
 const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
@@ -548,4 +765,10 @@ const FilterPolicy* NewFixedSizeFilterPolicy(uint32_t total_bits,
   return new FixedSizeFilterPolicy(total_bits, error_rate, logger);
 }
 
+const FilterPolicy* NewFixedSizeBlockedFilterPolicy(uint32_t total_bits,
+                                                    double error_rate,
+                                                    Logger* logger) {
+  return new FixedSizeBlockedFilterPolicy(total_bits, error_rate, logger);
+}
+
 }  // namespace rocksdb
@@ -34,6 +34,7 @@ int main() {
 
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/util/logging.h"
+#include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/arena.h"
@@ -42,6 +43,7 @@ int main() {
 using GFLAGS::ParseCommandLineFlags;
 
 DEFINE_int32(bits_per_key, 10, "");
+DEFINE_bool(enable_perf, false, "");
 
 namespace rocksdb {
 
@@ -234,7 +236,25 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
           nullptr)};
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+class FixedSizeBlockedFilterBloomTestContext : public BloomTestContext {
+ public:
+  const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
+
+  size_t max_keys() const override { return std::numeric_limits<size_t>::max(); }
+
+  void CheckFilterSize(size_t filter_size, size_t num_keys) const override {
+    ASSERT_LE(filter_size, FilterPolicy::kDefaultFixedSizeFilterBits / 8 + 64 + 5) << num_keys;
+  }
+
+ private:
+  std::unique_ptr<const FilterPolicy> filter_policy_{
+      NewFixedSizeBlockedFilterPolicy(
+          FilterPolicy::kDefaultFixedSizeFilterBits, FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+          nullptr)};
+};
+
+YB_DEFINE_ENUM(BuilderReaderBloomTestType,
+               (kFullFilter)(kFixedSizeFilter)(kFixedSizeBlockedFilter));
 
 namespace {
 
@@ -244,6 +264,8 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
       return std::make_unique<FixedSizeFilterBloomTestContext>();
+    case BuilderReaderBloomTestType::kFixedSizeBlockedFilter:
+      return std::make_unique<FixedSizeBlockedFilterBloomTestContext>();
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -370,9 +392,36 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
   ASSERT_LE(mediocre_filters, good_filters/5);
 }
 
+// Measures the latency of checking keys against full fixed-size filter blocks, half of the keys
+// being present.
+TEST_P(BuilderReaderBloomTest, MayMatchPerf) {
+  if (!FLAGS_enable_perf) {
+    return;
+  }
+  char buffer[sizeof(size_t)];
+  size_t num_keys = 0;
+  for (; !ShouldFlush() && num_keys < context_->max_keys(); ++num_keys) {
+    Add(Key(num_keys, buffer));
+  }
+  Build();
+
+  constexpr size_t kNumChecks = 10000000;
+  StopWatchNano timer(Env::Default(), true /* auto_start */);
+  size_t matches = 0;
+  for (size_t i = 0; i != kNumChecks; ++i) {
+    matches += Matches(Key(i % (2 * num_keys), buffer));
+  }
+  const uint64_t elapsed = timer.ElapsedNanos();
+  LOG(INFO) << ToString(GetParam()) << ": " << num_keys << " keys, " << FilterSize()
+            << " bytes, avg query latency " << elapsed / kNumChecks << " ns, matches "
+            << matches;
+  ASSERT_GE(matches, kNumChecks / 2);
+}
+
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFixedSizeBlockedFilter));
 
 }  // namespace rocksdb
 
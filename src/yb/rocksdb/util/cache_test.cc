@@ -23,7 +23,9 @@
 
 #include "yb/rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -675,6 +677,110 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_F(CacheTest, ClockCacheHitAndMiss) {
+  auto cache = NewClockCache(kCacheSize, kNumShardBits, false);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  Insert(cache, 100, 101);
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(-1,  Lookup(cache, 200));
+
+  Insert(cache, 100, 102);
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(0U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockCacheEntriesArePinned) {
+  auto cache = NewClockCache(kCacheSize, kNumShardBits, false);
+  Insert(cache, 100, 101);
+  Cache::Handle* h1 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache->Value(h1)));
+
+  Insert(cache, 100, 102);
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(2U, cache->GetUsage());
+  ASSERT_EQ(1U, cache->GetPinnedUsage());
+
+  cache->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+  ASSERT_EQ(1U, cache->GetUsage());
+  ASSERT_EQ(0U, cache->GetPinnedUsage());
+}
+
+TEST_F(CacheTest, ClockCacheScanResistance) {
+  constexpr int kHotEntries = 50;
+  constexpr QueryId kScanQueryId = 3;
+
+  auto cache = NewClockCache(kCacheSize2, 0 /* num_shard_bits */, false);
+  for (int i = 0; i != kHotEntries; ++i) {
+    Insert(cache, i, i);
+    // Lookup by another query makes the entry hot.
+    ASSERT_EQ(i, Lookup(cache, i, kTestQueryId + 1));
+  }
+
+  // Blocks of a long scan are inserted and read once by the same query.
+  for (int i = 1000; i != 1000 + 10 * kCacheSize2; ++i) {
+    Insert(cache, i, i, 1, kScanQueryId);
+    ASSERT_EQ(i, Lookup(cache, i, kScanQueryId));
+  }
+
+  for (int i = 0; i != kHotEntries; ++i) {
+    ASSERT_EQ(i, Lookup(cache, i));
+  }
+  ASSERT_LE(cache->GetUsage(), static_cast<size_t>(kCacheSize2));
+}
+
+TEST_F(CacheTest, ClockCacheReinsertedAfterEvictionIsHot) {
+  auto cache = NewClockCache(kCacheSize2, 0 /* num_shard_bits */, false);
+  Insert(cache, 100, 101);
+  for (int i = 0; i != kCacheSize2; ++i) {
+    Insert(cache, 1000 + i, i);
+  }
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  // Entry that was evicted before being reused is considered hot when it is inserted again.
+  Insert(cache, 100, 102);
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 100, 102));
+}
+
+TEST_F(CacheTest, ClockCacheConcurrentLookups) {
+  constexpr int kThreads = 8;
+  constexpr int kKeys = 2 * kCacheSize;
+
+  auto cache = NewClockCache(kCacheSize, kNumShardBits, false);
+  std::atomic<int> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([this, t, cache, &mismatches] {
+      for (int i = 0; i != 10 * kKeys; ++i) {
+        int key = (i * 7 + t) % kKeys;
+        int value = Lookup(cache, key, t);
+        if (value == -1) {
+          // Deleter of the fixture is not thread safe.
+          ASSERT_OK(cache->Insert(
+              EncodeKey(key), t, EncodeValue(key), 1, [](const Slice&, void*) {}));
+        } else if (value != key) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(0, mismatches.load());
+  // Capacity of every shard is rounded up.
+  ASSERT_LE(cache->GetUsage(), static_cast<size_t>(kCacheSize + (1 << kNumShardBits)));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,729 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/metrics.h"
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/autovector.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+DECLARE_double(cache_single_touch_ratio);
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation.
+//
+// Entries of a shard are kept in a hash table and in a circular list, the clock. Instead of moving
+// an entry to the head of a list on every hit, a hit only takes a reference and bumps the usage
+// count of the entry. So lookups take the shard lock in shared mode, and do not contend with each
+// other. Inserts, erases and evictions take the lock in exclusive mode.
+//
+// Scan resistance is provided in the same way as by the single-touch and multi-touch pools of
+// the LRU cache. A new entry is cold, i.e. has zero usage, and only hits from a query other than
+// the one that inserted it make it hot and increase its usage. Hot entries take at most
+// 1 - cache_single_touch_ratio of the capacity.
+//
+// To find a victim the clock hand sweeps the entries: pinned entries are skipped, hot entries get
+// their usage decremented only while hot entries take more than their share, and the first
+// unpinned cold entry is evicted. So blocks read once by a scan are evicted by the hand, while
+// blocks used by different queries survive any number of passes.
+//
+// In addition, like the test period of CLOCK-Pro, the shard remembers hashes of cold entries that
+// were evicted. When such an entry is inserted again soon, the previous eviction was premature,
+// and the entry is inserted as hot.
+//
+// The reference count and the in cache bit of an entry share a single atomic word, so exactly one
+// of the last release and the removal from the cache frees the entry, without taking the lock on
+// release.
+
+constexpr uint32_t kInCacheBit = 1;
+constexpr uint32_t kOneRef = 2;
+constexpr uint8_t kMaxUsage = 3;
+
+struct ClockHandle {
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  ClockHandle* next_hash;
+  // Neighbours in the clock.
+  ClockHandle* next;
+  ClockHandle* prev;
+  size_t charge;
+  size_t key_length;
+  // kInCacheBit if this entry is referenced by the hash table, plus kOneRef for each external
+  // reference.
+  std::atomic<uint32_t> flags;
+  std::atomic<uint8_t> usage;
+  uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
+  QueryId query_id;   // Query id that added the value to the cache.
+  char key_data[1];   // Beginning of key
+
+  Slice key() const {
+    return Slice(key_data, key_length);
+  }
+
+  bool pinned() const {
+    return flags.load(std::memory_order_acquire) >= kOneRef;
+  }
+
+  static ClockHandle* Create(const Slice& key) {
+    auto* result = new (new char[sizeof(ClockHandle) - 1 + key.size()]) ClockHandle;
+    result->key_length = key.size();
+    memcpy(result->key_data, key.data(), key.size());
+    return result;
+  }
+
+  void Free() {
+    (*deleter)(key(), value);
+    Destroy();
+  }
+
+  // Destroys the entry without invoking the deleter.
+  void Destroy() {
+    this->~ClockHandle();
+    delete[] reinterpret_cast<char*>(this);
+  }
+};
+
+// Chained hash table of the clock cache entries, similar to the one used by LRU cache.
+class ClockHandleTable {
+ public:
+  ClockHandleTable() {
+    Resize();
+  }
+
+  template <class F>
+  void ApplyToAllCacheEntries(const F& func) const {
+    for (auto* h : list_) {
+      while (h != nullptr) {
+        auto next = h->next_hash;
+        func(h);
+        h = next;
+      }
+    }
+  }
+
+  ClockHandle* Lookup(const Slice& key, uint32_t hash) const {
+    return *FindPointer(key, hash);
+  }
+
+  ClockHandle* Insert(ClockHandle* h) {
+    ClockHandle** ptr = FindPointer(h->key(), h->hash);
+    ClockHandle* old = *ptr;
+    h->next_hash = (old == nullptr ? nullptr : old->next_hash);
+    *ptr = h;
+    if (old == nullptr) {
+      ++elems_;
+      if (elems_ > list_.size()) {
+        Resize();
+      }
+    }
+    return old;
+  }
+
+  ClockHandle* Remove(const Slice& key, uint32_t hash) {
+    ClockHandle** ptr = FindPointer(key, hash);
+    ClockHandle* result = *ptr;
+    if (result != nullptr) {
+      *ptr = result->next_hash;
+      --elems_;
+    }
+    return result;
+  }
+
+  size_t size() const {
+    return elems_;
+  }
+
+ private:
+  ClockHandle** FindPointer(const Slice& key, uint32_t hash) const {
+    auto* ptr = const_cast<ClockHandle**>(&list_[hash & (list_.size() - 1)]);
+    while (*ptr != nullptr && ((*ptr)->hash != hash || key != (*ptr)->key())) {
+      ptr = &(*ptr)->next_hash;
+    }
+    return ptr;
+  }
+
+  void Resize() {
+    size_t new_length = 16;
+    while (new_length < elems_ * 1.5) {
+      new_length *= 2;
+    }
+    std::vector<ClockHandle*> new_list(new_length, nullptr);
+    ApplyToAllCacheEntries([&new_list](ClockHandle* h) {
+      auto& bucket = new_list[h->hash & (new_list.size() - 1)];
+      h->next_hash = bucket;
+      bucket = h;
+    });
+    list_.swap(new_list);
+  }
+
+  std::vector<ClockHandle*> list_;
+  size_t elems_ = 0;
+};
+
+// A single shard of sharded clock cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() {}
+
+  ~ClockCacheShard() {
+    table_.ApplyToAllCacheEntries([](ClockHandle* h) {
+      // Entries that are still referenced externally would be freed by their last release.
+      if (h->flags.fetch_and(~kInCacheBit, std::memory_order_acq_rel) == kInCacheBit) {
+        h->Free();
+      }
+    });
+  }
+
+  void SetCapacity(size_t capacity) {
+    autovector<ClockHandle*> deleted;
+    {
+      WriteLock l(&mutex_);
+      capacity_ = capacity;
+      hot_capacity_ = capacity -
+          static_cast<size_t>(round(FLAGS_cache_single_touch_ratio * capacity));
+      EvictUnlocked(0, &deleted);
+    }
+    FreeEntries(deleted);
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) {
+    WriteLock l(&mutex_);
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  void SetMetrics(shared_ptr<yb::CacheMetrics> metrics) {
+    WriteLock l(&mutex_);
+    metrics_ = std::move(metrics);
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const {
+    ReadLock l(&mutex_);
+    size_t unpinned = 0;
+    table_.ApplyToAllCacheEntries([&unpinned](ClockHandle* h) {
+      if (!h->pinned()) {
+        unpinned += h->charge;
+      }
+    });
+    return GetUsage() - std::min(GetUsage(), unpinned);
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) {
+    if (thread_safe) {
+      mutex_.ReadLock();
+    }
+    table_.ApplyToAllCacheEntries([callback](ClockHandle* h) {
+      callback(h->value, h->charge);
+    });
+    if (thread_safe) {
+      mutex_.ReadUnlock();
+    }
+  }
+
+ private:
+  // Evicts entries until there is room for the given charge, or there are no more entries that
+  // could be evicted. Requires mutex_ to be held in exclusive mode.
+  void EvictUnlocked(size_t charge, autovector<ClockHandle*>* deleted);
+
+  // Removes entry, that was already removed from the hash table, from the clock, and clears its
+  // in cache bit. Returns true if the entry is not referenced anymore and should be freed.
+  // Requires mutex_ to be held in exclusive mode.
+  bool RemoveUnlocked(ClockHandle* e);
+
+  // Links entry into the clock right behind the hand, so it is the last one visited by the hand.
+  void ClockInsertUnlocked(ClockHandle* e);
+
+  // Remembers hash of the entry that was evicted without being reused.
+  void RememberEvictedUnlocked(uint32_t hash);
+
+  // Returns true if the entry with the given hash was recently evicted without being reused,
+  // and forgets about it.
+  bool TestEvictedUnlocked(uint32_t hash);
+
+  // Stops accounting charge of the entry that is neither referenced nor in the cache.
+  void DecrementUsage(size_t charge) {
+    usage_.fetch_sub(charge, std::memory_order_relaxed);
+    if (metrics_ != nullptr) {
+      metrics_->cache_usage->DecrementBy(charge);
+    }
+  }
+
+  void FreeEntries(const autovector<ClockHandle*>& entries) {
+    for (auto* entry : entries) {
+      entry->Free();
+    }
+  }
+
+  // Whether to reject insertion if cache reaches its full capacity.
+  bool strict_capacity_limit_ = false;
+
+  size_t capacity_ = 0;
+
+  // Max memory size of hot entries, i.e. entries with non zero usage.
+  size_t hot_capacity_ = 0;
+
+  // Memory size of hot entries in the hash table.
+  std::atomic<size_t> hot_usage_{0};
+
+  // Memory size of entries in the hash table, and of entries removed from it that are still
+  // referenced externally, like the usage of LRU cache.
+  std::atomic<size_t> usage_{0};
+
+  // Lookups take the lock in shared mode, all other operations that modify the table take it
+  // in exclusive mode. Release does not take the lock.
+  mutable port::RWMutex mutex_;
+
+  ClockHandleTable table_;
+
+  // Next entry to be visited by the clock hand, nullptr when the shard is empty.
+  ClockHandle* hand_ = nullptr;
+
+  // Hashes of entries evicted without being reused, in the order of their eviction.
+  std::unordered_set<uint32_t> evicted_;
+  std::deque<uint32_t> evicted_order_;
+
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+void ClockCacheShard::ClockInsertUnlocked(ClockHandle* e) {
+  if (hand_ == nullptr) {
+    e->next = e->prev = e;
+    hand_ = e;
+    return;
+  }
+  e->next = hand_;
+  e->prev = hand_->prev;
+  e->prev->next = e;
+  hand_->prev = e;
+}
+
+bool ClockCacheShard::RemoveUnlocked(ClockHandle* e) {
+  if (e->next == e) {
+    hand_ = nullptr;
+  } else {
+    if (hand_ == e) {
+      hand_ = e->next;
+    }
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+  }
+  e->next = e->prev = nullptr;
+  if (e->usage.load(std::memory_order_relaxed) > 0) {
+    hot_usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  }
+  if (e->flags.fetch_and(~kInCacheBit, std::memory_order_acq_rel) != kInCacheBit) {
+    return false;
+  }
+  DecrementUsage(e->charge);
+  return true;
+}
+
+void ClockCacheShard::RememberEvictedUnlocked(uint32_t hash) {
+  // Remember about as many evicted entries as there are entries in the shard.
+  const size_t limit = std::max<size_t>(table_.size(), 16);
+  while (evicted_order_.size() >= limit) {
+    evicted_.erase(evicted_order_.front());
+    evicted_order_.pop_front();
+  }
+  if (evicted_.insert(hash).second) {
+    evicted_order_.push_back(hash);
+  }
+}
+
+bool ClockCacheShard::TestEvictedUnlocked(uint32_t hash) {
+  // The hash stays in the order queue, and is removed from it when its turn comes.
+  return evicted_.erase(hash) != 0;
+}
+
+void ClockCacheShard::EvictUnlocked(size_t charge, autovector<ClockHandle*>* deleted) {
+  // While hot entries take more than their share, every entry is visited at most kMaxUsage + 1
+  // times before it becomes a victim. So this bound is reached only when entries are pinned, or
+  // hot entries that take their share are enough to exceed the capacity.
+  size_t steps_left = table_.size() * (kMaxUsage + 2);
+  while (usage_.load(std::memory_order_relaxed) + charge > capacity_ && hand_ != nullptr &&
+         steps_left-- > 0) {
+    ClockHandle* e = hand_;
+    hand_ = e->next;
+    if (e->pinned()) {
+      continue;
+    }
+    auto usage = e->usage.load(std::memory_order_relaxed);
+    if (usage > 0) {
+      if (hot_usage_.load(std::memory_order_relaxed) > hot_capacity_) {
+        // Nobody could change usage while we hold the exclusive lock.
+        e->usage.store(usage - 1, std::memory_order_relaxed);
+        if (usage == 1) {
+          hot_usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+        }
+      }
+      continue;
+    }
+    table_.Remove(e->key(), e->hash);
+    // Nobody could take a new reference while we hold the exclusive lock.
+    if (RemoveUnlocked(e)) {
+      deleted->push_back(e);
+    }
+    RememberEvictedUnlocked(e->hash);
+    if (metrics_) {
+      metrics_->evictions->Increment();
+    }
+  }
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
+                                       Statistics* statistics) {
+  ClockHandle* e;
+  bool multi_touch = false;
+  {
+    ReadLock l(&mutex_);
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      e->flags.fetch_add(kOneRef, std::memory_order_acq_rel);
+
+      // Usage is updated under the shared lock, so it does not race with the eviction that
+      // decrements it, or with the removal of the entry that subtracts it from hot_usage_, both
+      // done under the exclusive lock.
+      // Repeated touches by the query that inserted the entry do not make it hot.
+      auto usage = e->usage.load(std::memory_order_relaxed);
+      if (e->query_id != query_id || query_id == kInMultiTouchId) {
+        // Store only when the value changes, so hits on the most used entries do not write to
+        // shared memory. Only one of racing hits turns a cold entry hot, other racing hits could
+        // only lose an increment, that is fine for the approximate usage count.
+        if (usage == 0) {
+          if (e->usage.compare_exchange_strong(usage, 1, std::memory_order_relaxed)) {
+            hot_usage_.fetch_add(e->charge, std::memory_order_relaxed);
+          }
+        } else if (usage < kMaxUsage) {
+          e->usage.store(usage + 1, std::memory_order_relaxed);
+        }
+        multi_touch = true;
+      } else {
+        multi_touch = usage > 0;
+      }
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (e != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (multi_touch) {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      }
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_MISS);
+    }
+  }
+  // metrics_ is set once during startup, before the cache is used.
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  auto* e = reinterpret_cast<ClockHandle*>(handle);
+  // The last reference to an entry, that was already removed from the cache, frees it.
+  if (e->flags.fetch_sub(kOneRef, std::memory_order_acq_rel) == kOneRef) {
+    DecrementUsage(e->charge);
+    e->Free();
+  }
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
+                               void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics) {
+  // Allocate the memory here outside of the mutex.
+  ClockHandle* e = ClockHandle::Create(key);
+  e->value = value;
+  e->deleter = deleter;
+  e->charge = charge;
+  e->hash = hash;
+  e->query_id = query_id;
+  e->next = e->prev = e->next_hash = nullptr;
+  e->flags.store(kInCacheBit + (handle == nullptr ? 0 : kOneRef), std::memory_order_relaxed);
+
+  Status s;
+  autovector<ClockHandle*> deleted;
+  ClockHandle* rejected = nullptr;
+  {
+    WriteLock l(&mutex_);
+    EvictUnlocked(charge, &deleted);
+    if (strict_capacity_limit_ && usage_.load(std::memory_order_relaxed) + charge > capacity_) {
+      if (handle == nullptr) {
+        // Deleter is invoked by the cache, as if the entry was inserted and evicted.
+        rejected = e;
+      } else {
+        e->Destroy();
+        *handle = nullptr;
+      }
+      s = STATUS(Incomplete, "Insert failed due to clock cache being full.");
+    } else {
+      bool hot = query_id == kInMultiTouchId || TestEvictedUnlocked(hash);
+      ClockHandle* old = table_.Insert(e);
+      if (old != nullptr) {
+        // Replaced value keeps the usage of the old one.
+        hot = hot || old->usage.load(std::memory_order_relaxed) > 0;
+        if (RemoveUnlocked(old)) {
+          deleted.push_back(old);
+        }
+      }
+      e->usage.store(hot ? 1 : 0, std::memory_order_relaxed);
+      if (hot) {
+        hot_usage_.fetch_add(charge, std::memory_order_relaxed);
+      }
+      ClockInsertUnlocked(e);
+      usage_.fetch_add(charge, std::memory_order_relaxed);
+      if (metrics_ != nullptr) {
+        metrics_->inserts->Increment();
+        metrics_->cache_usage->IncrementBy(charge);
+      }
+      if (handle != nullptr) {
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+    }
+  }
+
+  if (statistics != nullptr) {
+    if (s.ok()) {
+      RecordTick(statistics, BLOCK_CACHE_ADD);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+    } else {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+  }
+
+  // We free the entries here outside of mutex for performance reasons.
+  FreeEntries(deleted);
+  if (rejected != nullptr) {
+    rejected->Free();
+  }
+
+  return s;
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ClockHandle* e;
+  bool last_reference = false;
+  {
+    WriteLock l(&mutex_);
+    e = table_.Remove(key, hash);
+    if (e != nullptr) {
+      last_reference = RemoveUnlocked(e);
+    }
+  }
+  if (last_reference) {
+    e->Free();
+  }
+}
+
+constexpr int kNumShardBits = 4;          // default values, can be overridden
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit)
+      : num_shard_bits_(num_shard_bits),
+        shards_(1 << num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit) {
+    SetCapacity(capacity);
+    SetStrictCapacityLimit(strict_capacity_limit);
+  }
+
+  ~ShardedClockCache() {
+    if (disowned_) {
+      // Entries and their data are leaked on purpose, see DisownData.
+      new std::vector<ClockCacheShard>(std::move(shards_));
+    }
+  }
+
+  void SetCapacity(size_t capacity) override {
+    const size_t per_shard = (capacity + (shards_.size() - 1)) / shards_.size();
+    MutexLock l(&capacity_mutex_);
+    for (auto& shard : shards_) {
+      shard.SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    for (auto& shard : shards_) {
+      shard.SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  Status Insert(const Slice& key, const QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(key, hash, query_id, value, charge, deleter,
+                                       handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, const QueryId query_id, Statistics* statistics) override {
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    auto* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  size_t GetCapacity() const override { return capacity_; }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetUsage() const override {
+    size_t usage = 0;
+    for (const auto& shard : shards_) {
+      usage += shard.GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    size_t usage = 0;
+    for (const auto& shard : shards_) {
+      usage += shard.GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    auto* h = reinterpret_cast<ClockHandle*>(e);
+    return h->usage.load(std::memory_order_relaxed) > 0 ? MULTI_TOUCH : SINGLE_TOUCH;
+  }
+
+  void DisownData() override {
+    disowned_ = true;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    for (auto& shard : shards_) {
+      shard.ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (auto& shard : shards_) {
+      shard.SetMetrics(metrics_);
+    }
+  }
+
+ private:
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  const int num_shard_bits_;
+  std::vector<ClockCacheShard> shards_;
+  port::Mutex capacity_mutex_;
+  std::atomic<uint64_t> last_id_{0};
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  bool disowned_ = false;
+  shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // end anonymous namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit);
+}
+
+}  // namespace rocksdb
@@ -26,10 +26,13 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
 
+#include "yb/util/slice.h"
+
 #ifdef SNAPPY
 #include <snappy.h>
 #endif
@@ -49,6 +52,9 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+#if ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
+#include <zdict.h>
+#endif  // ZSTD_VERSION_NUMBER >= 10103
 #endif
 
 namespace rocksdb {
@@ -620,8 +626,11 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+// compression_dict is used to prime the compression library. Blocks compressed with a dictionary
+// should be uncompressed with the same dictionary.
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +642,23 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+#if ZSTD_VERSION_NUMBER >= 800  // v0.8.0+
+  if (!compression_dict.empty()) {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    outlen = ZSTD_compress_usingDict(
+        context, &(*output)[output_header_len], compressBound, input, length,
+        compression_dict.data(), compression_dict.size(), opts.level);
+    ZSTD_freeCCtx(context);
+  } else {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
+                           input, length, opts.level);
+  }
+#else  // ZSTD_VERSION_NUMBER >= 800
+  outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
+                         input, length, opts.level);
+#endif  // ZSTD_VERSION_NUMBER >= 800
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +668,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const Slice& compression_dict = Slice()) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -654,13 +678,55 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   }
 
   char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  size_t actual_output_length;
+#if ZSTD_VERSION_NUMBER >= 800  // v0.8.0+
+  if (!compression_dict.empty()) {
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    actual_output_length = ZSTD_decompress_usingDict(
+        context, output, output_len, input_data, input_length, compression_dict.data(),
+        compression_dict.size());
+    ZSTD_freeDCtx(context);
+  } else {
+    actual_output_length = ZSTD_decompress(output, output_len, input_data, input_length);
+  }
+#else  // ZSTD_VERSION_NUMBER >= 800
+  actual_output_length = ZSTD_decompress(output, output_len, input_data, input_length);
+#endif  // ZSTD_VERSION_NUMBER >= 800
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    delete[] output;
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
   return output;
 #endif
   return nullptr;
 }
 
+inline bool ZSTD_TrainDictionarySupported() {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 10103
+  return true;
+#endif
+  return false;
+}
+
+// Trains ZSTD dictionary of at most max_dict_bytes on samples, which are concatenated in
+// samples, with sizes listed in sample_lens. Returns empty string if there are too few samples or
+// training is not supported.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_lens,
+                                        size_t max_dict_bytes) {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 10103  // v1.1.3+
+  std::string dict_data(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict_data[0], max_dict_bytes, samples.data(), sample_lens.data(),
+      static_cast<unsigned>(sample_lens.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict_data.resize(dict_len);
+  return dict_data;
+#endif
+  return std::string();
+}
+
 }  // namespace rocksdb
@@ -180,6 +180,14 @@ class PosixEnv : public Env {
                                      unique_ptr<RandomAccessFile>* result,
                                      const EnvOptions& options) override {
     result->reset();
+    if (options.use_direct_reads && !options.use_mmap_reads) {
+      int fd = OpenDirect(fname, O_RDONLY);
+      if (fd >= 0) {
+        SetFD_CLOEXEC(fd, &options);
+        result->reset(new PosixRandomAccessFile(fname, fd, options));
+        return Status::OK();
+      }
+    }
     Status s;
     int fd;
     {
@@ -206,7 +214,10 @@ class PosixEnv : public Env {
       }
       close(fd);
     } else {
-      result->reset(new PosixRandomAccessFile(fname, fd, options));
+      // Direct I/O was requested but is not supported for this file.
+      EnvOptions no_direct_reads_options = options;
+      no_direct_reads_options.use_direct_reads = false;
+      result->reset(new PosixRandomAccessFile(fname, fd, no_direct_reads_options));
     }
     return s;
   }
@@ -215,6 +226,14 @@ class PosixEnv : public Env {
                                  unique_ptr<WritableFile>* result,
                                  const EnvOptions& options) override {
     result->reset();
+    if (options.use_direct_writes && !options.use_mmap_writes) {
+      int fd = OpenDirect(fname, O_CREAT | O_RDWR | O_TRUNC);
+      if (fd >= 0) {
+        SetFD_CLOEXEC(fd, &options);
+        result->reset(new PosixWritableFile(fname, fd, options));
+        return Status::OK();
+      }
+    }
     Status s;
     int fd = -1;
     do {
@@ -241,6 +260,7 @@ class PosixEnv : public Env {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
         no_mmap_writes_options.use_mmap_writes = false;
+        no_mmap_writes_options.use_direct_writes = false;
 
         result->reset(new PosixWritableFile(fname, fd, no_mmap_writes_options));
       }
@@ -463,6 +483,10 @@ class PosixEnv : public Env {
                         Priority pri = LOW, void* tag = nullptr,
                         void (*unschedFunction)(void* arg) = 0) override;
 
+  void ScheduleWithScore(void (*function)(void* arg1), void* arg, double score,
+                         Priority pri = LOW, void* tag = nullptr,
+                         void (*unschedFunction)(void* arg) = 0) override;
+
   int UnSchedule(void* arg, Priority pri) override;
 
   void StartThread(void (*function)(void* arg), void* arg) override;
@@ -684,6 +708,24 @@ class PosixEnv : public Env {
 #endif
   }
 
+  // Opens the file bypassing the page cache. Returns a negative value if the platform or the file
+  // system does not support direct I/O, so the caller falls back to buffered I/O.
+  int OpenDirect(const std::string& fname, int flags) {
+#ifdef O_DIRECT
+    int fd;
+    do {
+      IOSTATS_TIMER_GUARD(open_nanos);
+      fd = open(fname.c_str(), flags | O_DIRECT, 0644);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+      VLOG(1) << "Failed to open " << fname << " for direct I/O: " << strerror(errno);
+    }
+    return fd;
+#else
+    return -1;
+#endif
+  }
+
   size_t page_size_;
 
   std::vector<ThreadPool> thread_pools_;
@@ -712,6 +754,12 @@ void PosixEnv::Schedule(void (*function)(void* arg1), void* arg, Priority pri,
   thread_pools_[pri].Schedule(function, arg, tag, unschedFunction);
 }
 
+void PosixEnv::ScheduleWithScore(void (*function)(void* arg1), void* arg, double score,
+                                 Priority pri, void* tag, void (*unschedFunction)(void* arg)) {
+  assert(pri >= Priority::LOW && pri <= Priority::HIGH);
+  thread_pools_[pri].Schedule(function, arg, tag, unschedFunction, score);
+}
+
 int PosixEnv::UnSchedule(void* arg, Priority pri) {
   return thread_pools_[pri].UnSchedule(arg);
 }
@@ -156,6 +156,47 @@ TEST_F(EnvPosixTest, RunMany) {
   ASSERT_EQ(4, cur);
 }
 
+TEST_F(EnvPosixTest, ScheduleWithScore) {
+  std::atomic<int> last_id(0);
+
+  struct CB {
+    std::atomic<int>* last_id_ptr;  // Pointer to shared slot
+    int id;                         // Order# for the execution of this callback
+
+    CB(std::atomic<int>* p, int i) : last_id_ptr(p), id(i) {}
+
+    static void Run(void* v) {
+      CB* cb = reinterpret_cast<CB*>(v);
+      int cur = cb->last_id_ptr->load(std::memory_order_relaxed);
+      ASSERT_EQ(cb->id - 1, cur);
+      cb->last_id_ptr->store(cb->id, std::memory_order_release);
+    }
+  };
+
+  env_->SetBackgroundThreads(1, Env::LOW);
+
+  // Block the low priority queue, so all callbacks are queued before any of them starts.
+  test::SleepingBackgroundTask sleeping_task;
+  env_->Schedule(&test::SleepingBackgroundTask::DoSleepTask, &sleeping_task,
+                 Env::Priority::LOW);
+  sleeping_task.WaitUntilSleeping();
+
+  // Callbacks with higher score run first, callbacks with equal score run in schedule order.
+  CB cb1(&last_id, 1);
+  CB cb2(&last_id, 2);
+  CB cb3(&last_id, 3);
+  CB cb4(&last_id, 4);
+  env_->ScheduleWithScore(&CB::Run, &cb3, 1);
+  env_->ScheduleWithScore(&CB::Run, &cb1, 5);
+  env_->ScheduleWithScore(&CB::Run, &cb4, 1);
+  env_->ScheduleWithScore(&CB::Run, &cb2, 3);
+
+  sleeping_task.WakeUp();
+  Env::Default()->SleepForMicroseconds(kDelayMicros);
+  int cur = last_id.load(std::memory_order_acquire);
+  ASSERT_EQ(4, cur);
+}
+
 struct State {
   port::Mutex mu;
   int val;
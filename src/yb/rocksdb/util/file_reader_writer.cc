@@ -464,6 +464,12 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  void Readahead(uint64_t offset, size_t n) override { file_->Readahead(offset, n); }
+
+  // Buffered reads are copied to the scratch buffer, so only forwarded reads are served from the
+  // mapping.
+  bool IsMemoryMapped() const override { return forward_calls_ && file_->IsMemoryMapped(); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
@@ -103,6 +103,10 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  void Readahead(uint64_t offset, size_t n) { file_->Readahead(offset, n); }
+
+  bool IsMemoryMapped() const { return file_->IsMemoryMapped(); }
+
   RandomAccessFile* file() { return file_.get(); }
 };
 
@@ -174,6 +178,10 @@ class WritableFileWriter {
 
   WritableFile* writable_file() const { return writable_file_.get(); }
 
+  // Returns false if data is written bypassing OS buffers, i.e. with aligned writes of the whole
+  // buffer.
+  bool UseOSBuffer() const { return use_os_buffer_; }
+
  private:
   // Used when os buffering is OFF and we are writing
   // DMA such as in Windows unbuffered mode
@@ -36,12 +36,16 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #ifdef OS_LINUX
 #include <sys/statfs.h>
 #include <sys/syscall.h>
 #endif
+#include <algorithm>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
@@ -155,14 +159,53 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(options.use_direct_reads) {
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
 
 PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
+// Reads whole aligned pages covering the requested range into an aligned buffer, and copies the
+// requested part of them to scratch.
+Status PosixRandomAccessFile::DirectRead(uint64_t offset, size_t n, Slice* result,
+                                         char* scratch) const {
+  const uint64_t aligned_offset = TruncateToPageBoundary(kDirectIOAlignment, offset);
+  const size_t offset_in_page = static_cast<size_t>(offset - aligned_offset);
+  const size_t aligned_size = Roundup(offset_in_page + n, kDirectIOAlignment);
+  AlignedBuffer buffer;
+  buffer.Alignment(kDirectIOAlignment);
+  buffer.AllocateNewBuffer(aligned_size);
+
+  size_t read = 0;
+  while (read < aligned_size) {
+    ssize_t r = pread(fd_, buffer.Destination(), aligned_size - read,
+                      static_cast<off_t>(aligned_offset + read));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      *result = Slice(scratch, 0);
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    if (r == 0) {
+      // End of file.
+      break;
+    }
+    read += r;
+    buffer.Size(read);
+  }
+
+  const size_t copied = read > offset_in_page ? buffer.Read(scratch, offset_in_page, n) : 0;
+  *result = Slice(scratch, copied);
+  return Status::OK();
+}
+
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    char* scratch) const {
+  if (use_direct_io_) {
+    return DirectRead(offset, n, result, scratch);
+  }
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -223,6 +266,16 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+void PosixRandomAccessFile::Readahead(uint64_t offset, size_t n) {
+  // Reads with O_DIRECT or without OS buffer do not go through the page cache, so reading ahead
+  // into it would not help them.
+  if (use_direct_io_ || !use_os_buffer_) {
+    return;
+  }
+  // On Linux, POSIX_FADV_WILLNEED initiates a non-blocking read of the range into the page cache.
+  Fadvise(fd_, static_cast<off_t>(offset), n, POSIX_FADV_WILLNEED);
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -273,6 +326,18 @@ Status PosixMmapReadableFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+void PosixMmapReadableFile::Readahead(uint64_t offset, size_t n) {
+  if (offset >= length_) {
+    return;
+  }
+  n = std::min<size_t>(n, length_ - offset);
+  // madvise requires a page aligned address.
+  static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+  const size_t aligned_offset = offset & ~(kPageSize - 1);
+  madvise(static_cast<char*>(mmapped_region_) + aligned_offset, n + offset - aligned_offset,
+          MADV_WILLNEED);
+}
+
 Status PosixMmapReadableFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -517,7 +582,7 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+    : filename_(fname), fd_(fd), filesize_(0), use_direct_io_(options.use_direct_writes) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +614,36 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  filesize_ = std::max<uint64_t>(filesize_, offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
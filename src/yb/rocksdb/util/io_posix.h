@@ -41,6 +41,10 @@ namespace rocksdb {
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
+// Alignment of offsets, sizes and buffers of direct I/O requests. Covers logical block sizes of
+// all devices we run on.
+constexpr size_t kDirectIOAlignment = 4096;
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -63,6 +67,10 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  // File is opened with O_DIRECT, so reads should be aligned.
+  bool use_direct_io_;
+
+  Status DirectRead(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -75,6 +83,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual void Readahead(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -83,6 +92,9 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  // File is opened with O_DIRECT. WritableFileWriter does aligned positioned appends to such file,
+  // because it does not use OS buffer.
+  const bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -94,10 +106,18 @@ class PosixWritableFile : public WritableFile {
   ~PosixWritableFile();
 
   // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // and it does not need any additional information.
+  // Direct I/O writes whole pages, so the file is trimmed to its actual size here.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
+  // Data written with O_DIRECT still has to be synced to make file metadata and device caches
+  // durable, so UseDirectIO() keeps returning false.
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual size_t GetRequiredBufferAlignment() const override {
+    return use_direct_io_ ? kDirectIOAlignment : WritableFile::GetRequiredBufferAlignment();
+  }
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
@@ -124,6 +144,8 @@ class PosixMmapReadableFile : public RandomAccessFile {
   virtual ~PosixMmapReadableFile();
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const override;
+  virtual void Readahead(uint64_t offset, size_t n) override;
+  virtual bool IsMemoryMapped() const override { return true; }
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -35,6 +35,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/rocksdb/db/blob_file.h"
 #include "yb/rocksdb/comparator.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/sst_file_manager.h"
@@ -102,7 +103,15 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       listeners(options.listeners),
       row_cache(options.row_cache),
-      mem_tracker(options.mem_tracker) {}
+      mem_tracker(options.mem_tracker),
+      min_blob_size(options.min_blob_size),
+      blob_garbage_collection_age_cutoff(options.blob_garbage_collection_age_cutoff),
+      min_compressed_output_size(options.min_compressed_output_size),
+      large_output_size(options.large_output_size),
+      large_output_compression(options.large_output_compression),
+      blob_file_cache(std::make_shared<BlobFileCache>(
+          env, db_paths.empty() ? std::string() : db_paths[0].path)),
+      time_window_extractor(options.time_window_extractor.get()) {}
 
 ColumnFamilyOptions::ColumnFamilyOptions()
     : comparator(BytewiseComparator()),
@@ -156,7 +165,12 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       min_partial_merge_operands(2),
       optimize_filters_for_hits(false),
       paranoid_file_checks(false),
-      compaction_measure_io_stats(false) {
+      compaction_measure_io_stats(false),
+      min_blob_size(0),
+      blob_garbage_collection_age_cutoff(0.25),
+      min_compressed_output_size(0),
+      large_output_size(0),
+      large_output_compression(kNoCompression) {
   assert(memtable_factory.get() != nullptr);
 }
 
@@ -225,7 +239,13 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       min_partial_merge_operands(options.min_partial_merge_operands),
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       paranoid_file_checks(options.paranoid_file_checks),
-      compaction_measure_io_stats(options.compaction_measure_io_stats) {
+      compaction_measure_io_stats(options.compaction_measure_io_stats),
+      min_blob_size(options.min_blob_size),
+      blob_garbage_collection_age_cutoff(options.blob_garbage_collection_age_cutoff),
+      min_compressed_output_size(options.min_compressed_output_size),
+      large_output_size(options.large_output_size),
+      large_output_compression(options.large_output_compression),
+      time_window_extractor(options.time_window_extractor) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -283,6 +303,7 @@ DBOptions::DBOptions()
       access_hint_on_compaction_start(NORMAL),
       new_table_reader_for_compaction_inputs(false),
       compaction_readahead_size(0),
+      use_direct_io_for_compaction(false),
       random_access_max_buffer_size(1024 * 1024),
       writable_file_max_buffer_size(1024 * 1024),
       use_adaptive_mutex(false),
@@ -384,6 +405,8 @@ void DBOptions::Dump(Logger* log) const {
       "               Options.compaction_readahead_size: %" ROCKSDB_PRIszt
          "d",
          compaction_readahead_size);
+  RHEADER(log, "            Options.use_direct_io_for_compaction: %d",
+      use_direct_io_for_compaction);
   RHEADER(
       log,
       "               Options.random_access_max_buffer_size: %" ROCKSDB_PRIszt
@@ -410,6 +433,10 @@ void DBOptions::Dump(Logger* log) const {
       enable_thread_tracking);
   RHEADER(log, "         Options.allow_concurrent_memtable_write: %d",
       allow_concurrent_memtable_write);
+  RHEADER(log, "             Options.memtable_insert_parallelism: %" ROCKSDB_PRIszt,
+      memtable_insert_parallelism);
+  RHEADER(log, "  Options.min_memtable_insert_entries_per_thread: %" ROCKSDB_PRIszt,
+      min_memtable_insert_entries_per_thread);
   RHEADER(log, "      Options.enable_write_thread_adaptive_yield: %d",
       enable_write_thread_adaptive_yield);
   RHEADER(log, "             Options.write_thread_max_yield_usec: %" PRIu64,
@@ -466,6 +493,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -567,6 +598,18 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       paranoid_file_checks);
   RHEADER(log, "               Options.compaction_measure_io_stats: %d",
       compaction_measure_io_stats);
+  RHEADER(log, "                           Options.min_blob_size: %" PRIu64,
+      min_blob_size);
+  RHEADER(log, "      Options.blob_garbage_collection_age_cutoff: %f",
+      blob_garbage_collection_age_cutoff);
+  RHEADER(log, "              Options.min_compressed_output_size: %" PRIu64,
+      min_compressed_output_size);
+  RHEADER(log, "                       Options.large_output_size: %" PRIu64,
+      large_output_size);
+  RHEADER(log, "                Options.large_output_compression: %s",
+      CompressionTypeToString(large_output_compression).c_str());
+  RHEADER(log, "                   Options.time_window_extractor: %s",
+      time_window_extractor ? "set" : "None");
 }  // ColumnFamilyOptions::Dump
 
 void Options::Dump(Logger* log) const {
@@ -394,6 +394,21 @@ static std::unordered_map<std::string, OptionTypeInfo> cf_options_type_info = {
     {"hard_pending_compaction_bytes_limit",
      {offsetof(struct ColumnFamilyOptions, hard_pending_compaction_bytes_limit),
       OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"min_blob_size",
+     {offsetof(struct ColumnFamilyOptions, min_blob_size),
+      OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"blob_garbage_collection_age_cutoff",
+     {offsetof(struct ColumnFamilyOptions, blob_garbage_collection_age_cutoff),
+      OptionType::kDouble, OptionVerificationType::kNormal}},
+    {"min_compressed_output_size",
+     {offsetof(struct ColumnFamilyOptions, min_compressed_output_size),
+      OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"large_output_size",
+     {offsetof(struct ColumnFamilyOptions, large_output_size),
+      OptionType::kUInt64T, OptionVerificationType::kNormal}},
+    {"large_output_compression",
+     {offsetof(struct ColumnFamilyOptions, large_output_compression),
+      OptionType::kCompressionType, OptionVerificationType::kNormal}},
     {"hard_rate_limit",
      {offsetof(struct ColumnFamilyOptions, hard_rate_limit),
       OptionType::kDouble, OptionVerificationType::kDeprecated}},
@@ -522,6 +537,12 @@ static std::unordered_map<std::string,
     {"cache_index_and_filter_blocks",
      {offsetof(struct BlockBasedTableOptions, cache_index_and_filter_blocks),
       OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"cache_filter_index",
+     {offsetof(struct BlockBasedTableOptions, cache_filter_index),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
+    {"cache_filter_blocks_with_high_priority",
+     {offsetof(struct BlockBasedTableOptions, cache_filter_blocks_with_high_priority),
+      OptionType::kBoolean, OptionVerificationType::kNormal}},
     {"index_type",
      {offsetof(struct BlockBasedTableOptions, index_type),
       OptionType::kBlockBasedTableIndexType, OptionVerificationType::kNormal}},
@@ -21,6 +21,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
+#include <limits>
+
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 
@@ -38,8 +40,10 @@ class ThreadPool {
   void IncBackgroundThreadsIfNeeded(int num);
   void SetBackgroundThreads(int num);
   void StartBGThreads();
+  // Queued jobs with higher score are started first, see Env::ScheduleWithScore.
   void Schedule(void (*function)(void* arg1), void* arg, void* tag,
-                void (*unschedFunction)(void* arg));
+                void (*unschedFunction)(void* arg),
+                double score = std::numeric_limits<double>::max());
   int UnSchedule(void* arg);
 
   unsigned int GetQueueLen() const {
@@ -82,6 +86,7 @@ class ThreadPool {
     void (*function)(void*);
     void* tag;
     void (*unschedFunction)(void*);
+    double score;
   };
   typedef std::deque<BGItem> BGQueue;
 
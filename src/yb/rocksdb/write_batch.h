@@ -261,6 +261,10 @@ class WriteBatch : public WriteBatchBase {
   // Performs deferred computation of content_flags if necessary
   uint32_t ComputeContentFlags() const;
 
+  // Iterates records stored in input, that should be a part of rep_ starting at a record boundary.
+  // Frontiers are not passed to the handler. Adds number of iterated updates to found.
+  CHECKED_STATUS IterateRecords(Slice input, Handler* handler, size_t* found) const;
+
  protected:
   std::string rep_;  // See comment in write_batch.cc for the format of rep_
   const UserFrontiers* frontiers_ = nullptr;
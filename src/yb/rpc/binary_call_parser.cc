@@ -45,7 +45,7 @@ Result<size_t> BinaryCallParser::Parse(const rpc::ConnectionPtr& connection, con
       break;
     }
 
-    std::vector<char> call_data;
+    CallData call_data;
     IoVecsToBuffer(
         data, consumed + (include_header_ ? 0 : header_size), consumed + total_length, &call_data);
     RETURN_NOT_OK(listener_->HandleCall(connection, &call_data));
@@ -28,7 +28,7 @@ YB_STRONGLY_TYPED_BOOL(IncludeHeader);
 class BinaryCallParserListener {
  public:
   virtual CHECKED_STATUS HandleCall(
-      const ConnectionPtr& connection, std::vector<char>* call_data) = 0;
+      const ConnectionPtr& connection, CallData* call_data) = 0;
  protected:
   ~BinaryCallParserListener() {}
 };
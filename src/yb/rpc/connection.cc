@@ -64,6 +64,16 @@ METRIC_DEFINE_histogram(
     yb::MetricUnit::kMicroseconds, "Microseconds spent to queue and write the response to the wire",
     60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    server, rpc_bytes_per_write, "Bytes per socket write", yb::MetricUnit::kBytes,
+    "Number of bytes written to a RPC connection socket by a single system call",
+    64 * 1024 * 1024, 2);
+
+METRIC_DEFINE_histogram(
+    server, rpc_transfers_per_write, "Transfers per socket write", yb::MetricUnit::kRequests,
+    "Number of calls and responses, whose transfer was completed by a single system call",
+    100000, 2);
+
 namespace yb {
 namespace rpc {
 
@@ -80,8 +90,12 @@ Connection::Connection(Reactor* reactor,
       last_activity_time_(CoarseMonoClock::Now()),
       context_(std::move(context)) {
   const auto metric_entity = reactor->messenger()->metric_entity();
-  handler_latency_outbound_transfer_ = metric_entity ?
-      METRIC_handler_latency_outbound_transfer.Instantiate(metric_entity) : nullptr;
+  if (metric_entity) {
+    handler_latency_outbound_transfer_ =
+        METRIC_handler_latency_outbound_transfer.Instantiate(metric_entity);
+    bytes_per_write_ = METRIC_rpc_bytes_per_write.Instantiate(metric_entity);
+    transfers_per_write_ = METRIC_rpc_transfers_per_write.Instantiate(metric_entity);
+  }
 }
 
 Connection::~Connection() {}
@@ -261,7 +275,7 @@ Result<size_t> Connection::ProcessReceived(const IoVecs& data, ReadBufferFull re
   return *consumed;
 }
 
-Status Connection::HandleCallResponse(std::vector<char>* call_data) {
+Status Connection::HandleCallResponse(CallData* call_data) {
   DCHECK(reactor_->IsCurrentThread());
   CallResponse resp;
   RETURN_NOT_OK(resp.ParseFrom(call_data));
@@ -446,6 +460,13 @@ void Connection::Transferred(const OutboundDataPtr& data, const Status& status)
   data->Transferred(status, this);
 }
 
+void Connection::DataWritten(size_t bytes, size_t transfers) {
+  if (bytes_per_write_) {
+    bytes_per_write_->Increment(bytes);
+    transfers_per_write_->Increment(transfers);
+  }
+}
+
 void Connection::Destroy(const Status& status) {
   reactor_->DestroyConnection(this, status);
 }
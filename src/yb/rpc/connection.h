@@ -166,7 +166,7 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // An incoming packet has completed on the client side. This parses the
   // call response, looks up the CallAwaitingResponse, and calls the
   // client callback.
-  CHECKED_STATUS HandleCallResponse(std::vector<char>* call_data);
+  CHECKED_STATUS HandleCallResponse(CallData* call_data);
 
   ConnectionContext& context() { return *context_; }
 
@@ -189,6 +189,7 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
 
   void UpdateLastActivity() override;
   void Transferred(const OutboundDataPtr& data, const Status& status) override;
+  void DataWritten(size_t bytes, size_t transfers) override;
   void Destroy(const Status& status) override;
   Result<size_t> ProcessReceived(const IoVecs& data, ReadBufferFull read_buffer_full) override;
   void Connected() override;
@@ -220,6 +221,8 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // it involves spin lock and search in a metrics map. Therefore we prepare metric instances
   // at connection level.
   scoped_refptr<Histogram> handler_latency_outbound_transfer_;
+  scoped_refptr<Histogram> bytes_per_write_;
+  scoped_refptr<Histogram> transfers_per_write_;
 
   struct CompareExpiration {
     template<class Pair>
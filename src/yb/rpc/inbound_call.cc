@@ -46,6 +46,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
 #include "yb/util/trace.h"
 #include "yb/util/memory/memory.h"
 
@@ -71,6 +72,14 @@ DEFINE_int32(print_trace_every, 0,
 TAG_FLAG(print_trace_every, advanced);
 TAG_FLAG(print_trace_every, runtime);
 
+DEFINE_int32(rpc_trace_sampling_every_n, 0,
+             "Starts a sampled end-to-end trace for one of every N calls that are not already part "
+             "of a trace. Calls made while handling a sampled call are part of its trace, also on "
+             "remote servers. Spans of sampled traces are logged as JSON in the OpenTelemetry "
+             "format. 0 disables sampling.");
+TAG_FLAG(rpc_trace_sampling_every_n, advanced);
+TAG_FLAG(rpc_trace_sampling_every_n, runtime);
+
 DEFINE_int32(rpc_slow_query_threshold_ms, 10000,
              "Traces for calls that take longer than this threshold (in ms) are logged");
 TAG_FLAG(rpc_slow_query_threshold_ms, advanced);
@@ -140,11 +149,23 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_handled.Initialized()) << "Already marked as started";
   timing_.time_handled = MonoTime::Now();
   VLOG_WITH_PREFIX(4) << "Handling";
-  incoming_queue_time->Increment(
-      timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
+  const auto queue_time_us =
+      timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds();
+  incoming_queue_time->Increment(queue_time_us);
+
+  const auto sampling_every_n = GetAtomicFlag(&FLAGS_rpc_trace_sampling_every_n);
+  if (!trace_->sampled() && sampling_every_n > 0 && RandomWithChance(sampling_every_n)) {
+    trace_->StartSampledTrace();
+  }
+  TRACE_TO_WITH_TIME(trace_, timing_.time_handled, "Handling started after $0us in queue",
+                     queue_time_us);
 }
 
 MonoDelta InboundCall::GetTimeInQueue() const {
+  // Local calls are handled without passing through a service queue.
+  if (!timing_.time_handled.Initialized()) {
+    return MonoDelta::kZero;
+  }
   return timing_.time_handled.GetDeltaSince(timing_.time_received);
 }
 
@@ -171,6 +192,9 @@ bool InboundCall::ClientTimedOut() const {
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
   LogTrace();
+  if (trace_->sampled()) {
+    trace_->ExportSpan(service_name() + "." + method_name(), timing_.time_received);
+  }
   bool expected = false;
   if (responded_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
     connection()->context().QueueResponse(connection(), shared_from(this));
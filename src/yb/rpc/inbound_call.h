@@ -130,7 +130,7 @@ class InboundCall : public RpcCall {
   virtual MonoTime GetClientDeadline() const = 0;
 
   // Returns the time spent in the service queue -- from the time the call was received, until
-  // it gets handled.
+  // it gets handled. Zero for calls that did not go through a service queue.
   MonoDelta GetTimeInQueue() const;
 
   virtual const std::string& method_name() const = 0;
@@ -139,9 +139,11 @@ class InboundCall : public RpcCall {
 
   std::string LogPrefix() const override;
 
+  // Calls are allocated from SizeClassPool, since they are created by the reactor thread and
+  // usually destroyed by a worker thread.
   template <class T, class ...Args>
   static std::shared_ptr<T> Create(Args&&... args) {
-    auto result = std::make_shared<T>(std::forward<Args>(args)...);
+    auto result = std::allocate_shared<T>(SizeClassAllocator<T>(), std::forward<Args>(args)...);
     result->RecordCallReceived();
     return result;
   }
@@ -162,7 +164,7 @@ class InboundCall : public RpcCall {
   Slice serialized_request_;
 
   // Data source of this call.
-  std::vector<char> request_data_;
+  CallData request_data_;
 
   // The trace buffer.
   scoped_refptr<Trace> trace_;
@@ -0,0 +1,349 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/io_uring.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define YB_HAS_IO_URING 1
+#endif
+#endif
+
+#ifdef YB_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstring>
+
+#include <glog/logging.h>
+
+#include "yb/util/errno.h"
+
+#ifdef YB_HAS_IO_URING
+
+// Numbers of io_uring system calls are the same on all architectures, while old glibc headers do
+// not define them.
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+#endif
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+Status ErrnoStatus(const char* syscall_name, int err) {
+  return STATUS(NetworkError, std::string(syscall_name) + " failed: " + ErrnoToString(err),
+                Slice(), err);
+}
+
+} // namespace
+
+#ifdef YB_HAS_IO_URING
+
+class IoUring::Impl {
+ public:
+  Impl() {}
+
+  ~Impl() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (ring_ != MAP_FAILED) {
+      munmap(ring_, ring_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  CHECKED_STATUS Init(uint32_t entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd_ < 0) {
+      return ErrnoStatus("io_uring_setup", errno);
+    }
+    // Single mmap is available since 5.4, and no drop of completions since 5.5, so the kernel
+    // also supports sendmsg and recvmsg operations.
+    constexpr uint32_t kRequiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP;
+    if ((params.features & kRequiredFeatures) != kRequiredFeatures) {
+      return STATUS_FORMAT(NotSupported, "io_uring features not supported: $0", params.features);
+    }
+
+    ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                          params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                 IORING_OFF_SQ_RING);
+    if (ring_ == MAP_FAILED) {
+      return ErrnoStatus("mmap of io_uring ring", errno);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                 IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+      return ErrnoStatus("mmap of io_uring submission entries", errno);
+    }
+
+    auto* ring = static_cast<char*>(ring_);
+    sq_head_ = reinterpret_cast<std::atomic<uint32_t>*>(ring + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<std::atomic<uint32_t>*>(ring + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<uint32_t*>(ring + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = reinterpret_cast<uint32_t*>(ring + params.sq_off.array);
+    cq_head_ = reinterpret_cast<std::atomic<uint32_t>*>(ring + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<std::atomic<uint32_t>*>(ring + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32_t*>(ring + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+
+    sqe_head_ = sqe_tail_ = sq_tail_->load(std::memory_order_relaxed);
+
+    return Status::OK();
+  }
+
+  CHECKED_STATUS RegisterEventFd(int event_fd) {
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_EVENTFD, &event_fd, 1) != 0) {
+      return ErrnoStatus("io_uring_register", errno);
+    }
+    return Status::OK();
+  }
+
+  Result<io_uring_sqe*> GetSqe() {
+    if (sqe_tail_ - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+      // Submission queue is full, so pass queued entries to the kernel to free them.
+      RETURN_NOT_OK(Submit());
+      if (sqe_tail_ - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+        return STATUS(Busy, "io_uring submission queue is full");
+      }
+    }
+    auto* result = static_cast<io_uring_sqe*>(sqes_) + (sqe_tail_ & sq_mask_);
+    ++sqe_tail_;
+    memset(result, 0, sizeof(*result));
+    return result;
+  }
+
+  CHECKED_STATUS Submit() {
+    auto tail = sq_tail_->load(std::memory_order_relaxed);
+    while (sqe_head_ != sqe_tail_) {
+      sq_array_[tail & sq_mask_] = sqe_head_ & sq_mask_;
+      ++tail;
+      ++sqe_head_;
+    }
+    sq_tail_->store(tail, std::memory_order_release);
+
+    // Entries that were not consumed by the previous call are also passed.
+    auto to_submit = tail - sq_head_->load(std::memory_order_acquire);
+    if (to_submit == 0) {
+      return Status::OK();
+    }
+    if (syscall(__NR_io_uring_enter, fd_, to_submit, 0, 0, nullptr, 0) < 0) {
+      int err = errno;
+      // Entries that were not consumed stay in the queue and are retried by the next call.
+      if (err == EINTR || err == EAGAIN || err == EBUSY) {
+        return Status::OK();
+      }
+      return ErrnoStatus("io_uring_enter", err);
+    }
+    return Status::OK();
+  }
+
+  template <class Handler>
+  size_t ProcessCompletions(const Handler& handler) {
+    size_t result = 0;
+    auto head = cq_head_->load(std::memory_order_relaxed);
+    for (;;) {
+      auto tail = cq_tail_->load(std::memory_order_acquire);
+      if (head == tail) {
+        break;
+      }
+      while (head != tail) {
+        const auto& cqe = cqes_[head & cq_mask_];
+        auto* operation = reinterpret_cast<IoUringOperation*>(cqe.user_data);
+        auto res = cqe.res;
+        // Release the entry before invoking the handler, so the kernel could reuse it.
+        cq_head_->store(++head, std::memory_order_release);
+        handler(operation, res);
+        ++result;
+      }
+    }
+    return result;
+  }
+
+  CHECKED_STATUS WaitCompletion() {
+    RETURN_NOT_OK(Submit());
+    for (;;) {
+      if (syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0) {
+        return Status::OK();
+      }
+      if (errno != EINTR) {
+        return ErrnoStatus("io_uring_enter", errno);
+      }
+    }
+  }
+
+ private:
+  int fd_ = -1;
+  void* ring_ = MAP_FAILED;
+  size_t ring_size_ = 0;
+  void* sqes_ = MAP_FAILED;
+  size_t sqes_size_ = 0;
+
+  std::atomic<uint32_t>* sq_head_ = nullptr;
+  std::atomic<uint32_t>* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t* sq_array_ = nullptr;
+
+  std::atomic<uint32_t>* cq_head_ = nullptr;
+  std::atomic<uint32_t>* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+
+  // Range of submission entries that were prepared, but not passed to the kernel yet.
+  uint32_t sqe_head_ = 0;
+  uint32_t sqe_tail_ = 0;
+};
+
+bool IoUring::IsSupported() {
+  static const bool result = [] {
+    auto ring = Create(1);
+    LOG_IF(INFO, !ring.ok()) << "io_uring is not supported: " << ring.status();
+    return ring.ok();
+  }();
+  return result;
+}
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  auto impl = std::make_unique<Impl>();
+  RETURN_NOT_OK(impl->Init(entries));
+  return std::unique_ptr<IoUring>(new IoUring(std::move(impl)));
+}
+
+Status IoUring::RegisterEventFd(int event_fd) {
+  return impl_->RegisterEventFd(event_fd);
+}
+
+Status IoUring::PrepareSendMsg(
+    int fd, const msghdr* msg, int flags, IoUringOperation* operation) {
+  auto* sqe = VERIFY_RESULT(impl_->GetSqe());
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(msg);
+  sqe->len = 1;
+  sqe->msg_flags = flags;
+  sqe->user_data = reinterpret_cast<uint64_t>(operation);
+  ++operations_in_flight_;
+  return Status::OK();
+}
+
+Status IoUring::PrepareRecvMsg(int fd, msghdr* msg, int flags, IoUringOperation* operation) {
+  auto* sqe = VERIFY_RESULT(impl_->GetSqe());
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(msg);
+  sqe->len = 1;
+  sqe->msg_flags = flags;
+  sqe->user_data = reinterpret_cast<uint64_t>(operation);
+  ++operations_in_flight_;
+  return Status::OK();
+}
+
+Status IoUring::PreparePollAdd(int fd, int16_t poll_events, IoUringOperation* operation) {
+  auto* sqe = VERIFY_RESULT(impl_->GetSqe());
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll_events = static_cast<uint16_t>(poll_events);
+  sqe->user_data = reinterpret_cast<uint64_t>(operation);
+  ++operations_in_flight_;
+  return Status::OK();
+}
+
+Status IoUring::Submit() {
+  return impl_->Submit();
+}
+
+size_t IoUring::ProcessCompletions() {
+  return impl_->ProcessCompletions([this](IoUringOperation* operation, int32_t result) {
+    --operations_in_flight_;
+    operation->Completed(result);
+  });
+}
+
+Status IoUring::WaitCompletion() {
+  return impl_->WaitCompletion();
+}
+
+#else
+
+class IoUring::Impl {
+};
+
+bool IoUring::IsSupported() {
+  return false;
+}
+
+Result<std::unique_ptr<IoUring>> IoUring::Create(uint32_t entries) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::RegisterEventFd(int event_fd) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::PrepareSendMsg(
+    int fd, const msghdr* msg, int flags, IoUringOperation* operation) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::PrepareRecvMsg(int fd, msghdr* msg, int flags, IoUringOperation* operation) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::PreparePollAdd(int fd, int16_t poll_events, IoUringOperation* operation) {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+Status IoUring::Submit() {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+size_t IoUring::ProcessCompletions() {
+  return 0;
+}
+
+Status IoUring::WaitCompletion() {
+  return STATUS(NotSupported, "io_uring is not supported on this platform");
+}
+
+#endif
+
+IoUring::IoUring(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {
+}
+
+IoUring::~IoUring() {
+}
+
+} // namespace rpc
+} // namespace yb
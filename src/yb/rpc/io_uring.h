@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_IO_URING_H
+#define YB_RPC_IO_URING_H
+
+#include <sys/socket.h>
+
+#include <memory>
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace rpc {
+
+// Operation submitted to IoUring. Completed is invoked with the result of the operation, i.e.
+// a non negative value on success or a negated errno on failure.
+class IoUringOperation {
+ public:
+  virtual void Completed(int32_t result) = 0;
+
+ protected:
+  ~IoUringOperation() {}
+};
+
+// Minimal wrapper over the Linux io_uring interface, that talks to the kernel directly so it does
+// not require liburing.
+//
+// Operations are only queued by the Prepare* functions, and are passed to the kernel in a single
+// system call by Submit.
+//
+// This class is not thread-safe.
+class IoUring {
+ public:
+  // Whether io_uring, with the features required by this class, is supported by the running
+  // kernel.
+  static bool IsSupported();
+
+  static Result<std::unique_ptr<IoUring>> Create(uint32_t entries);
+
+  ~IoUring();
+
+  // Registers eventfd that is signalled when completions are posted.
+  CHECKED_STATUS RegisterEventFd(int event_fd);
+
+  // The operation should stay alive until it is completed. The memory referenced by msg should
+  // stay valid until the operation is submitted.
+  CHECKED_STATUS PrepareSendMsg(
+      int fd, const msghdr* msg, int flags, IoUringOperation* operation);
+  CHECKED_STATUS PrepareRecvMsg(int fd, msghdr* msg, int flags, IoUringOperation* operation);
+  CHECKED_STATUS PreparePollAdd(int fd, int16_t poll_events, IoUringOperation* operation);
+
+  // Passes all prepared operations to the kernel, without waiting for their completion.
+  CHECKED_STATUS Submit();
+
+  // Invokes Completed of every completed operation, returns the number of completed operations.
+  size_t ProcessCompletions();
+
+  // Blocks until at least one operation is completed.
+  CHECKED_STATUS WaitCompletion();
+
+  // Number of prepared operations that were not completed yet.
+  size_t operations_in_flight() const {
+    return operations_in_flight_;
+  }
+
+ private:
+  class Impl;
+
+  explicit IoUring(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+  size_t operations_in_flight_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(IoUring);
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_IO_URING_H
@@ -47,6 +47,10 @@ const std::shared_ptr<LocalYBInboundCall>& LocalOutboundCall::CreateLocalInbound
   const MonoTime deadline = timeout.Initialized() ? start_ + timeout : MonoTime::Max();
   auto outbound_call = std::static_pointer_cast<LocalOutboundCall>(shared_from(this));
   inbound_call_ = InboundCall::Create<LocalYBInboundCall>(remote_method(), outbound_call, deadline);
+  // Local calls have no header, so the trace context is passed directly.
+  if (trace_->sampled()) {
+    inbound_call_->trace()->StartSpan(trace_->trace_id(), trace_->span_id());
+  }
   return inbound_call_;
 }
 
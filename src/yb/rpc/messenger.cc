@@ -331,7 +331,7 @@ rpc::ThreadPool& Messenger::ThreadPool(ServicePriority priority) {
       }
       const ThreadPoolOptions& options = normal_thread_pool_->options();
       high_priority_thread_pool_.reset(new rpc::ThreadPool(
-          name_ + "-high-pri", options.queue_limit, options.max_workers));
+          name_ + "-high-pri", options.queue_limit, options.max_workers, options.metric_entity));
       return *high_priority_thread_pool_.get();
   }
   FATAL_INVALID_ENUM_VALUE(ServicePriority, priority);
@@ -471,7 +471,8 @@ Messenger::Messenger(const MessengerBuilder &bld)
       retain_self_(this),
       io_thread_pool_(name_, FLAGS_io_thread_pool_size),
       scheduler_(&io_thread_pool_.io_service()),
-      normal_thread_pool_(new rpc::ThreadPool(name_, bld.queue_limit_, bld.workers_limit_)) {
+      normal_thread_pool_(new rpc::ThreadPool(
+          name_, bld.queue_limit_, bld.workers_limit_, bld.metric_entity_)) {
 #ifndef NDEBUG
   creation_stack_trace_.Collect(/* skip_frames */ 1);
 #endif
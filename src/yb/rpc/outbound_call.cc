@@ -50,6 +50,7 @@
 #include "yb/rpc/serialization.h"
 
 #include "yb/util/concurrent_value.h"
+#include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/memory/memory.h"
@@ -181,6 +182,8 @@ OutboundCall::OutboundCall(
 
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    // The call to the remote server is a span of its own, which is the parent of the server's span.
+    trace_->StartChildSpan();
   }
 
   DVLOG(4) << "OutboundCall " << this << " constructed with state_: " << StateName(state_)
@@ -198,6 +201,9 @@ OutboundCall::~OutboundCall() {
               << "us. Trace:";
     trace_->Dump(&LOG(INFO), true);
   }
+  if (trace_->sampled()) {
+    trace_->ExportSpan(remote_method_->ToString(), start_);
+  }
 }
 
 void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
@@ -241,6 +247,13 @@ Status OutboundCall::SetRequestParam(const Message& message) {
 
   RequestHeader header;
   InitHeader(&header);
+  if (peer_accepts_compression_ && peer_accepts_compression_->load(std::memory_order_acquire)) {
+    auto compressed = SetCompressedRequestParam(message, &header);
+    if (!compressed.ok() || *compressed) {
+      remote_method_pool_->Release(header.release_remote_method());
+      return compressed.ok() ? Status::OK() : compressed.status();
+    }
+  }
   status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
   remote_method_pool_->Release(header.release_remote_method());
   if (!status.ok()) {
@@ -253,6 +266,28 @@ Status OutboundCall::SetRequestParam(const Message& message) {
                           header_size);
 }
 
+Result<bool> OutboundCall::SetCompressedRequestParam(const Message& message,
+                                                     RequestHeader* header) {
+  RefCntBuffer body;
+  RETURN_NOT_OK(serialization::SerializeMessage(message,
+                                                &body,
+                                                /* additional_size */ 0,
+                                                /* use_cached_size */ true));
+  faststring compressed;
+  if (!VERIFY_RESULT(serialization::CompressBody(
+          CompressionTypePB::LZ4, Slice(body.udata(), body.size()), &compressed))) {
+    return false;
+  }
+
+  header->set_compression(CompressionTypePB::LZ4);
+  header->set_uncompressed_size(body.size());
+  size_t header_size = 0;
+  RETURN_NOT_OK(serialization::SerializeHeader(
+      *header, compressed.size(), &buffer_, compressed.size(), &header_size));
+  memcpy(buffer_.udata() + header_size, compressed.data(), compressed.size());
+  return true;
+}
+
 Status OutboundCall::status() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return status_;
@@ -351,6 +386,10 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
   call_response_ = std::move(resp);
   Slice r(call_response_.serialized_response());
 
+  if (peer_accepts_compression_ && call_response_.peer_accepts_compression()) {
+    peer_accepts_compression_->store(true, std::memory_order_release);
+  }
+
   if (call_response_.is_success()) {
     // TODO: here we're deserializing the call response within the reactor thread,
     // which isn't great, since it would block processing of other RPCs in parallel.
@@ -491,6 +530,13 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     header->set_timeout_millis(timeout.ToMilliseconds());
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  if (peer_accepts_compression_) {
+    header->set_accept_compression(CompressionTypePB::LZ4);
+  }
+  if (trace_->sampled()) {
+    header->set_trace_id(trace_->trace_id());
+    header->set_parent_span_id(trace_->span_id());
+  }
 }
 
 ///
@@ -550,13 +596,22 @@ Status CallResponse::GetSidecar(int idx, Slice* sidecar) const {
   return Status::OK();
 }
 
-Status CallResponse::ParseFrom(std::vector<char>* call_data) {
+Status CallResponse::ParseFrom(CallData* call_data) {
   CHECK(!parsed_);
   Slice entire_message;
 
   response_data_.swap(*call_data);
   Slice source(response_data_.data(), response_data_.size());
-  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
+  Slice body;
+  RETURN_NOT_OK(serialization::ParseYBHeader(source, &header_, &body));
+  if (header_.compression() != CompressionTypePB::NO_COMPRESSION) {
+    CallData decompressed;
+    RETURN_NOT_OK(serialization::DecompressBody(
+        header_.compression(), body, header_.uncompressed_size(), &decompressed));
+    response_data_.swap(decompressed);
+    body = Slice(response_data_.data(), response_data_.size());
+  }
+  RETURN_NOT_OK(serialization::ParseYBBody(body, &entire_message));
 
   // Use information from header to extract the payload slices.
   const size_t sidecars = header_.sidecar_offsets_size();
@@ -32,7 +32,9 @@
 #ifndef YB_RPC_OUTBOUND_CALL_H_
 #define YB_RPC_OUTBOUND_CALL_H_
 
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -53,6 +55,7 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/object_pool.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/result.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
@@ -140,7 +143,7 @@ class CallResponse {
 
   // Parse the response received from a call. This must be called before any
   // other methods on this object. Takes ownership of data content.
-  CHECKED_STATUS ParseFrom(std::vector<char>* data);
+  CHECKED_STATUS ParseFrom(CallData* data);
 
   // Return true if the call succeeded.
   bool is_success() const {
@@ -164,6 +167,12 @@ class CallResponse {
   // See RpcController::GetSidecar()
   CHECKED_STATUS GetSidecar(int idx, Slice* sidecar) const;
 
+  // Whether the server is able to decompress requests, see RequestHeader::accept_compression.
+  bool peer_accepts_compression() const {
+    DCHECK(parsed_);
+    return header_.accept_compression() != CompressionTypePB::NO_COMPRESSION;
+  }
+
  private:
   // True once ParseFrom() is called.
   bool parsed_;
@@ -181,7 +190,7 @@ class CallResponse {
 
   // The incoming transfer data - retained because serialized_response_
   // and sidecar_slices_ refer into its data.
-  std::vector<char> response_data_;
+  CallData response_data_;
 
   DISALLOW_COPY_AND_ASSIGN(CallResponse);
 };
@@ -211,6 +220,15 @@ class OutboundCall : public RpcCall {
   // subsequently mutated with no ill effects.
   virtual CHECKED_STATUS SetRequestParam(const google::protobuf::Message& req);
 
+  // Enables compression of this call, should be invoked before SetRequestParam().
+  // The response is compressed when the server supports compression. The request is compressed
+  // only when 'peer_accepts_compression' is true, i.e. some previous response from the same server
+  // has confirmed that it is able to decompress it. This call updates it when the response
+  // is received.
+  void EnableCompression(std::shared_ptr<std::atomic<bool>> peer_accepts_compression) {
+    peer_accepts_compression_ = std::move(peer_accepts_compression);
+  }
+
   // Serialize the call for the wire. Requires that SetRequestParam()
   // is called first. This is called from the Reactor thread.
   void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) const override;
@@ -317,6 +335,11 @@ class OutboundCall : public RpcCall {
 
   void InitHeader(RequestHeader* header);
 
+  // Serializes the compressed request to buffer_. Returns false when the request is not worth
+  // compressing, in this case neither buffer_ nor header is modified.
+  Result<bool> SetCompressedRequestParam(const google::protobuf::Message& message,
+                                         RequestHeader* header);
+
   // Lock for state_ status_, error_pb_ fields, since they
   // may be mutated by the reactor thread while the client thread
   // reads them.
@@ -341,6 +364,9 @@ class OutboundCall : public RpcCall {
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
+  // Set when compression is enabled for this call, see EnableCompression().
+  std::shared_ptr<std::atomic<bool>> peer_accepts_compression_;
+
   // The trace buffer.
   scoped_refptr<Trace> trace_;
 
@@ -47,6 +47,7 @@
 #include <google/protobuf/compiler/code_generator.h>
 #include <google/protobuf/compiler/plugin.h>
 #include <google/protobuf/descriptor.h>
+#include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/io/printer.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/stubs/common.h>
@@ -512,12 +513,24 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "    auto rpc_context = yb_call->IsLocalCall() ?\n"
         "        ::yb::rpc::RpcContext(\n"
         "            std::static_pointer_cast<::yb::rpc::LocalYBInboundCall>(yb_call), \n"
-        "            metrics_[$metric_enum_key$]) :\n"
-        "        ::yb::rpc::RpcContext(\n"
-        "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
-        "            metrics_[$metric_enum_key$]);\n"
+        "            metrics_[$metric_enum_key$]) :\n");
+        // Messages of files with arenas enabled are allocated in a per call arena, so parsing a
+        // request with many nested messages does not allocate each of them on the heap.
+        if (method->input_type()->file()->options().cc_enable_arenas() &&
+            method->output_type()->file()->options().cc_enable_arenas()) {
+          Print(printer, *subs,
+          "        ::yb::rpc::RpcContext::InArena<$request$, $response$>(\n"
+          "            yb_call, \n"
+          "            metrics_[$metric_enum_key$]);\n");
+        } else {
+          Print(printer, *subs,
+          "        ::yb::rpc::RpcContext(\n"
+          "            yb_call, \n"
+          "            std::make_shared<$request$>(),\n"
+          "            std::make_shared<$response$>(),\n"
+          "            metrics_[$metric_enum_key$]);\n");
+        }
+        Print(printer, *subs,
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
         "      auto* resp = static_cast<$response$*>(rpc_context.response_pb());\n"
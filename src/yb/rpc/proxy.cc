@@ -122,6 +122,9 @@ void Proxy::AsyncRequest(const RemoteMethod* method,
                                      controller,
                                      std::move(callback));
   auto call = controller->call_.get();
+  if (controller->enable_compression() && !call_local_service_) {
+    call->EnableCompression(peer_accepts_compression_);
+  }
   Status s = call->SetRequestParam(req);
   if (PREDICT_FALSE(!s.ok())) {
     // Failed to serialize request: likely the request is missing a required
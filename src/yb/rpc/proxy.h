@@ -175,6 +175,11 @@ class Proxy {
   ConcurrentPod<Endpoint> resolved_ep_;
 
   scoped_refptr<Histogram> latency_hist_;
+
+  // Whether the remote server has confirmed that it is able to decompress requests,
+  // shared with the calls that have compression enabled.
+  std::shared_ptr<std::atomic<bool>> peer_accepts_compression_ =
+      std::make_shared<std::atomic<bool>>(false);
 };
 
 class ProxyCache {
@@ -34,14 +34,17 @@
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include <boost/scope_exit.hpp>
 
@@ -57,6 +60,7 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/yb_rpc.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/errno.h"
 #include "yb/util/flag_tags.h"
@@ -71,6 +75,18 @@
 
 using namespace std::literals;
 
+DEFINE_bool(rpc_pin_reactors_to_cores, false,
+            "Pin each reactor thread to its own core, assigning cores to reactors of all "
+            "messengers round robin.");
+TAG_FLAG(rpc_pin_reactors_to_cores, advanced);
+
+DEFINE_int32(rpc_outbound_call_coalescing_window_us, 0,
+             "When positive, outbound calls queued to a reactor are accumulated for this number "
+             "of microseconds before being sent, so calls to the same server issued within this "
+             "window are written to the socket together. Trades latency for a lower packet rate.");
+TAG_FLAG(rpc_outbound_call_coalescing_window_us, advanced);
+TAG_FLAG(rpc_outbound_call_coalescing_window_us, runtime);
+
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
 
@@ -110,6 +126,25 @@ bool HasReactorStartedClosing(ReactorState state) {
   return state == ReactorState::kClosing || state == ReactorState::kClosed;
 }
 
+void PinCurrentThreadToNextCore(const std::string& name) {
+#if defined(__linux__)
+  static std::atomic<size_t> next_core{0};
+  auto num_cores = std::max(std::thread::hardware_concurrency(), 1U);
+  auto core = next_core.fetch_add(1, std::memory_order_relaxed) % num_cores;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(core, &cpu_set);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (err != 0) {
+    LOG(WARNING) << name << ": failed to pin to core " << core << ": " << ErrnoToString(err);
+  } else {
+    VLOG(1) << name << ": pinned to core " << core;
+  }
+#else
+  LOG(WARNING) << name << ": pinning to core is not supported";
+#endif
+}
+
 } // anonymous namespace
 
 // ------------------------------------------------------------------------------------------------
@@ -157,6 +192,9 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  outbound_coalescing_timer_.set(loop_);
+  outbound_coalescing_timer_.set<Reactor, &Reactor::OutboundCoalescingTimerHandler>(this);
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -239,6 +277,7 @@ void Reactor::ShutdownInternal() {
   }
 
   VLOG(1) << name() << ": aborting outbound calls";
+  outbound_coalescing_timer_.stop();
   CHECK(processing_outbound_queue_.empty()) << yb::ToString(processing_outbound_queue_);
   {
     std::lock_guard<simple_spinlock> lock(outbound_queue_lock_);
@@ -474,6 +513,9 @@ void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
   DVLOG(6) << "Calling Reactor::RunThread()...";
+  if (FLAGS_rpc_pin_reactors_to_cores) {
+    PinCurrentThreadToNextCore(name_);
+  }
   loop_.run(/* flags */ 0);
   VLOG(1) << name() << " thread exiting.";
 
@@ -636,6 +678,23 @@ void Reactor::DestroyConnection(Connection *conn, const Status &conn_status) {
 }
 
 void Reactor::ProcessOutboundQueue() {
+  auto coalescing_window_us = GetAtomicFlag(&FLAGS_rpc_outbound_call_coalescing_window_us);
+  if (coalescing_window_us > 0 && !stopping_) {
+    // Calls queued before the timer fires do not schedule this task again, since the queue is not
+    // empty, so all of them are processed together.
+    if (!outbound_coalescing_timer_.is_active()) {
+      outbound_coalescing_timer_.start(coalescing_window_us / 1e6, 0);
+    }
+    return;
+  }
+  DoProcessOutboundQueue();
+}
+
+void Reactor::OutboundCoalescingTimerHandler(ev::timer& watcher, int revents) { // NOLINT
+  DoProcessOutboundQueue();
+}
+
+void Reactor::DoProcessOutboundQueue() {
   CHECK(processing_outbound_queue_.empty()) << yb::ToString(processing_outbound_queue_);
   {
     std::lock_guard<simple_spinlock> lock(outbound_queue_lock_);
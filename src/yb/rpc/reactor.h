@@ -404,6 +404,10 @@ class Reactor {
   void ShutdownInternal();
 
   void ProcessOutboundQueue();
+  void DoProcessOutboundQueue();
+
+  // libev callback that sends outbound calls accumulated during the coalescing window.
+  void OutboundCoalescingTimerHandler(ev::timer& watcher, int revents); // NOLINT
 
   void CheckReadyToStop();
 
@@ -449,6 +453,10 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  // Fires when the outbound call coalescing window elapses, see
+  // rpc_outbound_call_coalescing_window_us.
+  ev::timer outbound_coalescing_timer_;
+
   // Scheduled (but not yet run) delayed tasks.
   std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
 
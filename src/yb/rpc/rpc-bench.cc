@@ -30,14 +30,23 @@
 // under the License.
 //
 
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <thread>
 
 #include <gtest/gtest.h>
 
+#include "yb/gutil/endian.h"
+
+#include "yb/rpc/binary_call_parser.h"
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
+
 #include "yb/util/countdown_latch.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_util.h"
 
 using namespace std::literals; // NOLINT
@@ -45,9 +54,79 @@ using namespace std::literals; // NOLINT
 using std::string;
 using std::shared_ptr;
 
+DEFINE_int32(rpc_bench_duration_ms, 5000, "Duration of every benchmark run.");
+DEFINE_string(rpc_bench_results_file, "",
+              "File to append benchmark results to, one JSON object per line.");
+
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Highest tracked latency is 1 minute, in microseconds.
+constexpr uint64_t kMaxLatencyUs = 60000000;
+constexpr int kSignificantDigits = 3;
+
+#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
+constexpr int kMaxClients = 4;
+#else
+constexpr int kMaxClients = 16;
+#endif
+
+typedef std::vector<std::pair<std::string, int64_t>> BenchParams;
+
+std::chrono::milliseconds BenchDuration() {
+  return std::chrono::milliseconds(FLAGS_rpc_bench_duration_ms);
+}
+
+// Writes the result of the benchmark as one line of JSON to the log and, if specified, to
+// --rpc_bench_results_file. So results of different runs could be compared by a script.
+void ReportResult(const std::string& benchmark, const BenchParams& params,
+                  const std::string& unit, const HdrHistogram& histogram,
+                  double seconds, const BenchParams& extra = BenchParams()) {
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::COMPACT);
+  writer.StartObject();
+  writer.String("benchmark");
+  writer.String(benchmark);
+  writer.String("params");
+  writer.StartObject();
+  for (const auto& param : params) {
+    writer.String(param.first);
+    writer.Int64(param.second);
+  }
+  writer.EndObject();
+  writer.String("ops_per_sec");
+  writer.Double(histogram.TotalCount() / seconds);
+  for (const auto& value : extra) {
+    writer.String(value.first);
+    writer.Int64(value.second);
+  }
+  writer.String("unit");
+  writer.String(unit);
+  writer.String("count");
+  writer.Uint64(histogram.TotalCount());
+  writer.String("min");
+  writer.Uint64(histogram.MinValue());
+  writer.String("mean");
+  writer.Double(histogram.MeanValue());
+  for (auto percentile : {50.0, 90.0, 99.0, 99.9}) {
+    writer.String(Format("p$0", percentile));
+    writer.Uint64(histogram.ValueAtPercentile(percentile));
+  }
+  writer.String("max");
+  writer.Uint64(histogram.MaxValue());
+  writer.EndObject();
+
+  LOG(INFO) << "Benchmark result: " << out.str();
+  if (!FLAGS_rpc_bench_results_file.empty()) {
+    std::ofstream file(FLAGS_rpc_bench_results_file, std::ios_base::app);
+    file << out.str() << std::endl;
+  }
+}
+
+} // namespace
+
 class RpcBench : public RpcTestBase {
  public:
   RpcBench()
@@ -56,6 +135,48 @@ class RpcBench : public RpcTestBase {
  protected:
   friend class ClientThread;
 
+  // Makes a call using proxies that were created from the provided proxy cache.
+  typedef std::function<Status()> BenchCall;
+  typedef std::function<BenchCall(ProxyCache* proxy_cache)> BenchCallFactory;
+
+  // Runs 'num_clients' threads that make calls in a loop during BenchDuration().
+  // Every thread has its own messenger, so it uses its own connection to the server.
+  // Returns latencies of successful calls in microseconds, failed calls are counted in 'failed'.
+  void RunClients(int num_clients, const BenchCallFactory& factory, HdrHistogram* latency,
+                  std::atomic<int64_t>* failed, double* seconds) {
+    std::atomic<bool> run{true};
+    std::vector<std::thread> threads;
+    CountDownLatch ready(num_clients);
+    for (int i = 0; i != num_clients; ++i) {
+      threads.emplace_back([this, &factory, &run, &ready, latency, failed] {
+        auto messenger = CreateMessenger("Client");
+        {
+          ProxyCache proxy_cache(messenger);
+          auto call = factory(&proxy_cache);
+          ready.CountDown();
+          while (run.load(std::memory_order_acquire)) {
+            auto start = MonoTime::Now();
+            auto status = call();
+            if (status.ok()) {
+              latency->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+            } else {
+              failed->fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+        }
+        messenger->Shutdown();
+      });
+    }
+    ready.Wait();
+    auto start = MonoTime::Now();
+    std::this_thread::sleep_for(BenchDuration());
+    run.store(false, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    *seconds = MonoTime::Now().GetDeltaSince(start).ToSeconds();
+  }
+
   HostPort server_hostport_;
   shared_ptr<Messenger> client_messenger_;
   std::atomic<bool> should_run_{true};
@@ -63,8 +184,9 @@ class RpcBench : public RpcTestBase {
 
 class ClientThread {
  public:
-  explicit ClientThread(RpcBench *bench)
+  explicit ClientThread(RpcBench *bench, HdrHistogram* latency)
     : bench_(bench),
+      latency_(latency),
       request_count_(0) {
   }
 
@@ -89,7 +211,9 @@ class ClientThread {
       req.set_y(request_count_);
       RpcController controller;
       controller.set_timeout(MonoDelta::FromSeconds(10));
+      auto start = MonoTime::Now();
       CHECK_OK(p.Add(req, &resp, &controller));
+      latency_->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
       CHECK_EQ(req.x() + req.y(), resp.result());
       request_count_++;
     }
@@ -97,6 +221,7 @@ class ClientThread {
 
   std::unique_ptr<std::thread> thread_;
   RpcBench *bench_;
+  HdrHistogram* latency_;
   int request_count_;
 };
 
@@ -118,19 +243,16 @@ TEST_F(RpcBench, BenchmarkCalls) {
   Stopwatch sw(Stopwatch::ALL_THREADS);
   sw.start();
 
+  HdrHistogram latency(kMaxLatencyUs, kSignificantDigits);
   std::vector<std::unique_ptr<ClientThread>> threads;
-#if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
-  constexpr int kNumThreads = 4;
-#else
-  constexpr int kNumThreads = 16;
-#endif
+  constexpr int kNumThreads = kMaxClients;
   for (int i = 0; i < kNumThreads; i++) {
-    auto thr = std::make_unique<ClientThread>(this);
+    auto thr = std::make_unique<ClientThread>(this, &latency);
     thr->Start();
     threads.push_back(std::move(thr));
   }
 
-  std::this_thread::sleep_for(10s);
+  std::this_thread::sleep_for(BenchDuration());
   should_run_.store(false, std::memory_order_release);
 
   int total_reqs = 0;
@@ -148,8 +270,192 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Reqs/sec:         " << reqs_per_second;
   LOG(INFO) << "User CPU per req: " << user_cpu_micros_per_req << "us";
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
+
+  ReportResult("calls", {{"clients", kNumThreads}}, "us", latency, sw.elapsed().wall_seconds(),
+               {{"user_cpu_ns_per_op", static_cast<int64_t>(user_cpu_micros_per_req * 1000)},
+                {"sys_cpu_ns_per_op", static_cast<int64_t>(sys_cpu_micros_per_req * 1000)}});
+}
+
+// Throughput and latency of echo calls for different payload sizes, number of connections and
+// number of server reactors.
+TEST_F(RpcBench, BenchmarkPayloads) {
+  for (int reactors : {1, 4}) {
+    TestServerOptions options;
+    options.messenger_options.n_reactors = reactors;
+    StartTestServerWithGeneratedCode(&server_hostport_, options);
+    for (int clients : {1, kMaxClients}) {
+      for (size_t payload : {16_B, 4_KB, 256_KB}) {
+        std::string data(payload, 'x');
+        auto factory = [this, &data](ProxyCache* proxy_cache) -> BenchCall {
+          auto proxy = std::make_shared<rpc_test::CalculatorServiceProxy>(
+              proxy_cache, server_hostport_);
+          return [proxy, &data] {
+            rpc_test::EchoRequestPB req;
+            req.set_data(data);
+            rpc_test::EchoResponsePB resp;
+            RpcController controller;
+            controller.set_timeout(10s);
+            RETURN_NOT_OK(proxy->Echo(req, &resp, &controller));
+            if (resp.data().size() != data.size()) {
+              return STATUS_FORMAT(Corruption, "Wrong echo size: $0", resp.data().size());
+            }
+            return Status::OK();
+          };
+        };
+        HdrHistogram latency(kMaxLatencyUs, kSignificantDigits);
+        std::atomic<int64_t> failed{0};
+        double seconds = 0;
+        RunClients(clients, factory, &latency, &failed, &seconds);
+        ASSERT_EQ(0, failed.load());
+        ReportResult("payload",
+                     {{"server_reactors", reactors}, {"connections", clients},
+                      {"payload_bytes", static_cast<int64_t>(payload)}},
+                     "us", latency, seconds);
+      }
+    }
+  }
+}
+
+// Responses that consist mostly of sidecars, like responses to reads of many rows.
+TEST_F(RpcBench, BenchmarkSidecars) {
+  constexpr size_t kSidecars = 8;
+  StartTestServer(&server_hostport_);
+
+  for (size_t sidecar_size : {1_KB, 64_KB}) {
+    auto factory = [this, sidecar_size](ProxyCache* proxy_cache) -> BenchCall {
+      auto proxy = proxy_cache->Get(server_hostport_, nullptr);
+      return [proxy, sidecar_size] {
+        rpc_test::SendStringsRequestPB req;
+        for (size_t i = 0; i != kSidecars; ++i) {
+          req.add_sizes(sidecar_size);
+        }
+        req.set_random_seed(42);
+        rpc_test::SendStringsResponsePB resp;
+        RpcController controller;
+        controller.set_timeout(10s);
+        return proxy->SyncRequest(
+            GenericCalculatorService::SendStringsMethod(), req, &resp, &controller);
+      };
+    };
+    HdrHistogram latency(kMaxLatencyUs, kSignificantDigits);
+    std::atomic<int64_t> failed{0};
+    double seconds = 0;
+    RunClients(kMaxClients, factory, &latency, &failed, &seconds);
+    ASSERT_EQ(0, failed.load());
+    ReportResult("sidecars",
+                 {{"connections", kMaxClients}, {"sidecars", kSidecars},
+                  {"sidecar_bytes", static_cast<int64_t>(sidecar_size)}},
+                 "us", latency, seconds);
+  }
+}
+
+namespace {
+
+class CountingListener : public BinaryCallParserListener {
+ public:
+  CHECKED_STATUS HandleCall(const ConnectionPtr& connection, CallData* call_data) override {
+    ++calls_;
+    bytes_ += call_data->size();
+    return Status::OK();
+  }
+
+  size_t calls() const { return calls_; }
+
+ private:
+  size_t calls_ = 0;
+  size_t bytes_ = 0;
+};
+
+} // namespace
+
+// Rate of splitting received data to calls by BinaryCallParser, no network involved.
+TEST_F(RpcBench, BenchmarkBinaryCallParser) {
+  constexpr size_t kHeaderSize = 4;
+  constexpr size_t kCallsPerBatch = 1000;
+
+  for (size_t payload : {64_B, 4_KB}) {
+    std::vector<char> data;
+    data.reserve((kHeaderSize + payload) * kCallsPerBatch);
+    for (size_t i = 0; i != kCallsPerBatch; ++i) {
+      char header[kHeaderSize];
+      NetworkByteOrder::Store32(header, payload);
+      data.insert(data.end(), header, header + kHeaderSize);
+      data.insert(data.end(), payload, 'x');
+    }
+    IoVecs io_vecs(1, iovec{data.data(), data.size()});
+
+    CountingListener listener;
+    BinaryCallParser parser(kHeaderSize, 0 /* size_offset */, 1_MB, IncludeHeader::kFalse,
+                            &listener);
+    // Nanoseconds per parsed call.
+    HdrHistogram latency(kMaxLatencyUs, kSignificantDigits);
+    auto start = MonoTime::Now();
+    auto deadline = start + BenchDuration();
+    while (MonoTime::Now() < deadline) {
+      auto batch_start = MonoTime::Now();
+      auto consumed = ASSERT_RESULT(parser.Parse(nullptr, io_vecs));
+      ASSERT_EQ(data.size(), consumed);
+      latency.IncrementBy(
+          MonoTime::Now().GetDeltaSince(batch_start).ToNanoseconds() / kCallsPerBatch,
+          kCallsPerBatch);
+    }
+    ASSERT_EQ(latency.TotalCount(), listener.calls());
+    ReportResult("binary_call_parser", {{"payload_bytes", static_cast<int64_t>(payload)}},
+                 "ns", latency, MonoTime::Now().GetDeltaSince(start).ToSeconds());
+  }
+}
+
+// Behaviour of ServicePool when clients send more calls than a single worker could handle.
+// Reports latency of accepted calls, and counts calls rejected because the queue is full.
+TEST_F(RpcBench, BenchmarkServicePoolOverload) {
+  constexpr int kCallsPerClient = 200;
+  constexpr uint32_t kSleepMicros = 100;
+
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  StartTestServer(&server_hostport_, options);
+
+  HdrHistogram call_latency(kMaxLatencyUs, kSignificantDigits);
+  std::atomic<int64_t> rejected{0};
+  auto factory = [this, &call_latency, &rejected](ProxyCache* proxy_cache) -> BenchCall {
+    auto proxy = proxy_cache->Get(server_hostport_, nullptr);
+    return [proxy, &call_latency, &rejected] {
+      // Keep kCallsPerClient calls in flight from every client.
+      rpc_test::SleepRequestPB req;
+      req.set_sleep_micros(kSleepMicros);
+      std::vector<rpc_test::SleepResponsePB> resps(kCallsPerClient);
+      std::vector<RpcController> controllers(kCallsPerClient);
+      CountDownLatch latch(kCallsPerClient);
+      for (int i = 0; i != kCallsPerClient; ++i) {
+        auto* controller = &controllers[i];
+        controller->set_timeout(30s);
+        auto start = MonoTime::Now();
+        proxy->AsyncRequest(
+            GenericCalculatorService::SleepMethod(), req, &resps[i], controller,
+            [&latch, &call_latency, &rejected, controller, start] {
+              if (controller->status().ok()) {
+                call_latency.Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+              } else {
+                rejected.fetch_add(1, std::memory_order_relaxed);
+              }
+              latch.CountDown();
+            });
+      }
+      latch.Wait();
+      return Status::OK();
+    };
+  };
+
+  HdrHistogram batch_latency(kMaxLatencyUs, kSignificantDigits);
+  std::atomic<int64_t> failed{0};
+  double seconds = 0;
+  RunClients(kMaxClients, factory, &batch_latency, &failed, &seconds);
+  ReportResult("service_pool_overload",
+               {{"connections", kMaxClients}, {"calls_in_flight", kMaxClients * kCallsPerClient},
+                {"workers", 1}, {"sleep_us", kSleepMicros}},
+               "us", call_latency, seconds,
+               {{"rejected", rejected.load()}});
 }
 
 } // namespace rpc
 } // namespace yb
-
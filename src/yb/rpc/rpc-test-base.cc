@@ -125,6 +125,15 @@ void GenericCalculatorService::Handle(InboundCallPtr incoming) {
   }
 }
 
+bool GenericCalculatorService::ShouldHandleInline(const InboundCall& call) {
+  return call.method_name() == kAddMethodName;
+}
+
+CallPriority GenericCalculatorService::GetCallPriority(const InboundCall& call) {
+  return call.method_name() == kSleepMethodName ? CallPriority::kBulk
+                                                : CallPriority::kLatencySensitive;
+}
+
 void GenericCalculatorService::GenericCalculatorService::DoAdd(InboundCall* incoming) {
   Slice param(incoming->serialized_request());
   AddRequestPB req;
@@ -77,6 +77,8 @@ class GenericCalculatorService : public ServiceIf {
   }
 
   void Handle(InboundCallPtr incoming) override;
+  bool ShouldHandleInline(const InboundCall& call) override;
+  CallPriority GetCallPriority(const InboundCall& call) override;
   std::string service_name() const override { return kFullServiceName; }
   static std::string static_service_name() { return kFullServiceName; }
 
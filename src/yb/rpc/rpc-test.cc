@@ -35,6 +35,7 @@
 #include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -44,13 +45,19 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/rpc/io_uring.h"
 #include "yb/rpc/serialization.h"
+#include "yb/rpc/uring_stream.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/test_util.h"
 
+DECLARE_bool(rpc_handle_short_calls_inline);
+DECLARE_int32(rpc_outbound_call_coalescing_window_us);
+
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_histogram(rpc_transfers_per_write);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -150,6 +157,125 @@ TEST_F(TestRpc, TestCall) {
   }
 }
 
+// Test calls that are handled on the reactor thread, mixed with calls queued to the thread pool.
+TEST_F(TestRpc, TestHandleShortCallsInline) {
+  FLAGS_rpc_handle_short_calls_inline = true;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+    DoTestSidecar(&p, {123, 456});
+  }
+}
+
+// Test that queued calls of a higher priority class are handled before calls of a lower class.
+TEST_F(TestRpc, TestCallPriority) {
+  constexpr size_t kQueuedSleeps = 5;
+
+  HostPort server_addr;
+  TestServerOptions options;
+  options.n_worker_threads = 1;
+  StartTestServer(&server_addr, options);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+
+  std::mutex mutex;
+  std::vector<std::string> completed;
+  CountDownLatch latch(kQueuedSleeps + 2);
+  auto callback = [&mutex, &completed, &latch](const std::string& name) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      completed.push_back(name);
+    }
+    latch.CountDown();
+  };
+
+  boost::ptr_vector<RpcController> controllers;
+  boost::ptr_vector<rpc_test::SleepResponsePB> sleep_responses;
+  auto send_sleep = [&](int64_t sleep_ms, const std::string& name) {
+    rpc_test::SleepRequestPB sleep_req;
+    sleep_req.set_sleep_micros(sleep_ms * 1000);
+    auto controller = new RpcController();
+    controllers.push_back(controller);
+    controller->set_timeout(MonoDelta::FromSeconds(30));
+    auto sleep_resp = new rpc_test::SleepResponsePB();
+    sleep_responses.push_back(sleep_resp);
+    p.AsyncRequest(GenericCalculatorService::SleepMethod(), sleep_req, sleep_resp, controller,
+                   std::bind(callback, name));
+  };
+
+  // Occupy the only worker, so following calls wait in the queue.
+  send_sleep(1000, "blocker");
+  SleepFor(MonoDelta::FromMilliseconds(200));
+  for (size_t i = 0; i != kQueuedSleeps; ++i) {
+    send_sleep(100, "sleep");
+  }
+  SleepFor(MonoDelta::FromMilliseconds(200));
+
+  rpc_test::AddRequestPB add_req;
+  add_req.set_x(1);
+  add_req.set_y(2);
+  rpc_test::AddResponsePB add_resp;
+  RpcController add_controller;
+  add_controller.set_timeout(MonoDelta::FromSeconds(30));
+  p.AsyncRequest(GenericCalculatorService::AddMethod(), add_req, &add_resp, &add_controller,
+                 std::bind(callback, "add"));
+
+  latch.Wait();
+  ASSERT_EQ(kQueuedSleeps + 2, completed.size());
+  ASSERT_EQ("blocker", completed[0]);
+  ASSERT_EQ("add", completed[1]);
+}
+
+// Test that outbound calls issued within the coalescing window are written by a single write.
+TEST_F(TestRpc, TestOutboundCallCoalescing) {
+  constexpr size_t kCalls = 20;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
+  Proxy p(client_messenger, server_addr);
+
+  // Establish the connection, so following calls are not accumulated while it is connecting.
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+
+  FLAGS_rpc_outbound_call_coalescing_window_us = 100000;
+
+  rpc_test::AddRequestPB req;
+  req.set_x(1);
+  req.set_y(2);
+  boost::ptr_vector<RpcController> controllers;
+  boost::ptr_vector<rpc_test::AddResponsePB> responses;
+  CountDownLatch latch(kCalls);
+  for (size_t i = 0; i != kCalls; ++i) {
+    auto controller = new RpcController();
+    controllers.push_back(controller);
+    controller->set_timeout(MonoDelta::FromSeconds(30));
+    auto resp = new rpc_test::AddResponsePB();
+    responses.push_back(resp);
+    p.AsyncRequest(GenericCalculatorService::AddMethod(), req, resp, controller, [&latch]() {
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+
+  for (const auto& controller : controllers) {
+    ASSERT_OK(controller.status());
+  }
+  for (const auto& resp : responses) {
+    ASSERT_EQ(3, resp.result());
+  }
+  auto transfers_per_write = METRIC_rpc_transfers_per_write.Instantiate(metric_entity());
+  ASSERT_GE(transfers_per_write->MaxValueForTests(), kCalls);
+}
+
 // Test that connecting to an invalid server properly throws an error.
 TEST_F(TestRpc, TestCallToBadServer) {
   shared_ptr<Messenger> client_messenger(CreateMessenger("Client"));
@@ -313,6 +439,45 @@ TEST_F(TestRpc, TestCallLongerThanKeepalive) {
   ASSERT_OK(p.SyncRequest(GenericCalculatorService::SleepMethod(), req, &resp, &controller));
 }
 
+// Test calls and large sidecars between messengers that use io_uring streams.
+TEST_F(TestRpc, TestUringStream) {
+  if (!IoUring::IsSupported()) {
+    LOG(INFO) << "io_uring is not supported, skipping test";
+    return;
+  }
+
+  auto create_messenger = [this](const std::string& name, const MessengerOptions& options) {
+    auto builder = CreateMessengerBuilder(name, options);
+    builder.AddStreamFactory(UringStream::StaticProtocol(), UringStream::Factory());
+    builder.SetListenProtocol(UringStream::StaticProtocol());
+    return EXPECT_RESULT(builder.Build());
+  };
+
+  TestServerOptions options;
+  options.messenger = create_messenger("TestServer", kDefaultServerMessengerOptions);
+  HostPort server_addr;
+  StartTestServer(&server_addr, options);
+
+  auto client_messenger = create_messenger("Client", kDefaultClientMessengerOptions);
+  Proxy p(client_messenger, server_addr);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+  }
+  DoTestSidecar(&p, {123, 456});
+  DoTestSidecar(&p, {3000 * 1024, 2000 * 1024, 240 * 1024 * 1024});
+
+  // Connections are shut down while their reads are in progress, and their fds are closed only
+  // after the reads are completed, so new connections could not receive data of a reused fd.
+  for (int i = 0; i < 20; i++) {
+    auto messenger = create_messenger(Format("Client$0", i), kDefaultClientMessengerOptions);
+    Proxy proxy(messenger, server_addr);
+    ASSERT_OK(DoTestSyncCall(&proxy, GenericCalculatorService::AddMethod()));
+    messenger->Shutdown();
+  }
+  ASSERT_OK(DoTestSyncCall(&p, GenericCalculatorService::AddMethod()));
+}
+
 // Test that the RpcSidecar transfers the expected messages.
 TEST_F(TestRpc, TestRpcSidecar) {
   // Set up server.
@@ -127,7 +127,9 @@ RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
 }
 
 void RpcContext::RespondSuccess() {
-  if (response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
+  // The response of a local call is handed to the caller in place and never encoded, so it is not
+  // limited by the message size and computing its size would be wasted work.
+  if (!call_->IsLocalCall() && response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
     RespondFailure(STATUS(InvalidArgument, "RPC message too long"));
     return;
   }
@@ -191,6 +193,14 @@ MonoTime RpcContext::GetClientDeadline() const {
   return call_->GetClientDeadline();
 }
 
+MonoDelta RpcContext::GetTimeInQueue() const {
+  return call_->GetTimeInQueue();
+}
+
+size_t RpcContext::RpcSidecarsSize() const {
+  return call_->RpcSidecarsSize();
+}
+
 Trace* RpcContext::trace() {
   return call_->trace();
 }
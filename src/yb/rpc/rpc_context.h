@@ -34,6 +34,8 @@
 
 #include <string>
 
+#include <google/protobuf/arena.h>
+
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/local_call.h"
 #include "yb/rpc/rpc_header.pb.h"
@@ -78,6 +80,19 @@ class RpcContext {
   RpcContext(std::shared_ptr<LocalYBInboundCall> call,
              RpcMethodMetrics metrics);
 
+  // Create an RpcContext with the request and the response allocated in an arena, which is
+  // released in one shot with them. Request and Response should have arenas enabled.
+  template <class Request, class Response>
+  static RpcContext InArena(std::shared_ptr<YBInboundCall> call, RpcMethodMetrics metrics) {
+    auto arena = std::make_shared<google::protobuf::Arena>();
+    auto* request = google::protobuf::Arena::CreateMessage<Request>(arena.get());
+    auto* response = google::protobuf::Arena::CreateMessage<Response>(arena.get());
+    return RpcContext(std::move(call),
+                      std::shared_ptr<google::protobuf::Message>(arena, request),
+                      std::shared_ptr<google::protobuf::Message>(std::move(arena), response),
+                      std::move(metrics));
+  }
+
   RpcContext(RpcContext&& rhs)
       : call_(std::move(rhs.call_)),
         request_pb_(std::move(rhs.request_pb_)),
@@ -193,6 +208,12 @@ class RpcContext {
   // If the client did not specify a deadline, returns MonoTime::Max().
   MonoTime GetClientDeadline() const;
 
+  // Time the call spent in the service queue before its handler was started.
+  MonoDelta GetTimeInQueue() const;
+
+  // Total size of the sidecars added to the response so far.
+  size_t RpcSidecarsSize() const;
+
   // Panic the server. This logs a fatal error with the given message, and
   // also includes the current RPC request, requestor, trace information, etc,
   // to make it easier to debug.
@@ -68,6 +68,7 @@ void RpcController::Swap(RpcController* other) {
 
   std::swap(timeout_, other->timeout_);
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
+  std::swap(enable_compression_, other->enable_compression_);
   std::swap(call_, other->call_);
 }
 
@@ -124,6 +124,13 @@ class RpcController {
   void set_allow_local_calls_in_curr_thread(bool al) { allow_local_calls_in_curr_thread_ = al; }
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
+  // Compress the call when its body is at least --rpc_compression_min_size_bytes.
+  // Intended for calls to servers in a different cloud or region, where the network is slower and
+  // more costly. Requests are compressed only after the server has confirmed that it supports
+  // compression, so it is safe to enable it against servers that do not.
+  void set_enable_compression(bool value) { enable_compression_ = value; }
+  bool enable_compression() const { return enable_compression_; }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -147,6 +154,7 @@ class RpcController {
   // Once the call is sent, it is tracked here.
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
+  bool enable_compression_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
@@ -18,6 +18,7 @@
 
 #include <chrono>
 #include <functional>
+#include <vector>
 
 #include <boost/version.hpp>
 
@@ -26,6 +27,7 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 
 #include "yb/util/enums.h"
+#include "yb/util/memory/size_class_pool.h"
 #include "yb/util/strongly_typed_bool.h"
 
 namespace boost {
@@ -108,11 +110,18 @@ typedef std::shared_ptr<StreamFactory> StreamFactoryPtr;
 
 YB_STRONGLY_TYPED_BOOL(ReadBufferFull);
 
+// Data of a received call or response. Allocated from SizeClassPool, since it is allocated by
+// the reactor thread and usually freed by a worker thread.
+typedef std::vector<char, SizeClassAllocator<char>> CallData;
+
 typedef int64_t ScheduledTaskId;
 const ScheduledTaskId kInvalidTaskId = -1;
 
 YB_DEFINE_ENUM(ServicePriority, (kNormal)(kHigh));
 
+// Priority class of an inbound call within its service pool, from the highest to the lowest.
+YB_DEFINE_ENUM(CallPriority, (kConsensus)(kLatencySensitive)(kBulk));
+
 } // namespace rpc
 } // namespace yb
 
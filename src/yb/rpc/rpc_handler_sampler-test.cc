@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/rpc_handler_sampler.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(rpc_handler_sampling_interval_ms);
+
+namespace yb {
+namespace rpc {
+
+class RpcHandlerSamplerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    // Keep the background sampler idle, so the test controls when samples are taken.
+    FLAGS_rpc_handler_sampling_interval_ms = 3600 * 1000;
+  }
+
+  int64_t SamplesOf(const std::string& service_name, const std::string& method_name) {
+    for (const auto& entry : GetRpcHandlerSamples()) {
+      if (entry.service_name == service_name && entry.method_name == method_name) {
+        return entry.samples;
+      }
+    }
+    return 0;
+  }
+};
+
+TEST_F(RpcHandlerSamplerTest, CountsTaggedThreads) {
+  CountDownLatch tagged(1);
+  CountDownLatch done(1);
+  std::thread handler([&] {
+    ScopedRpcHandlerTag tag("TestService", "Read");
+    tagged.CountDown();
+    done.Wait();
+  });
+  tagged.Wait();
+
+  {
+    ScopedRpcHandlerTag outer("TestService", "Write");
+    TEST_SampleRpcHandlers();
+    {
+      ScopedRpcHandlerTag inner("TestService", "Nested");
+      TEST_SampleRpcHandlers();
+    }
+    TEST_SampleRpcHandlers();
+  }
+  TEST_SampleRpcHandlers();
+
+  done.CountDown();
+  handler.join();
+  TEST_SampleRpcHandlers();
+
+  ASSERT_EQ(4, SamplesOf("TestService", "Read"));
+  ASSERT_EQ(2, SamplesOf("TestService", "Write"));
+  ASSERT_EQ(1, SamplesOf("TestService", "Nested"));
+}
+
+TEST_F(RpcHandlerSamplerTest, Disabled) {
+  FLAGS_rpc_handler_sampling_interval_ms = 0;
+  {
+    ScopedRpcHandlerTag tag("DisabledService", "Read");
+    TEST_SampleRpcHandlers();
+  }
+  ASSERT_EQ(0, SamplesOf("DisabledService", "Read"));
+}
+
+} // namespace rpc
+} // namespace yb
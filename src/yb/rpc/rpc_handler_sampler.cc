@@ -0,0 +1,217 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/rpc_handler_sampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+#include "yb/util/thread.h"
+
+DEFINE_int32(rpc_handler_sampling_interval_ms, 10,
+             "Interval between samples of the RPC methods that service threads are handling, "
+             "shown at /rpc-samples. 0 disables sampling.");
+TAG_FLAG(rpc_handler_sampling_interval_ms, advanced);
+TAG_FLAG(rpc_handler_sampling_interval_ms, runtime);
+
+namespace yb {
+namespace rpc {
+
+class RpcHandlerMethodEntry {
+ public:
+  RpcHandlerMethodEntry(const std::string& service_name, const std::string& method_name)
+      : service_name_(service_name), method_name_(method_name) {}
+
+  const std::string& service_name() const { return service_name_; }
+  const std::string& method_name() const { return method_name_; }
+
+  int64_t samples() const { return samples_.load(std::memory_order_relaxed); }
+
+  void AddSample() { samples_.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+  const std::string service_name_;
+  const std::string method_name_;
+  std::atomic<int64_t> samples_{0};
+};
+
+namespace {
+
+// Method currently handled by a thread, read by the sampler thread.
+struct RpcHandlerThreadSlot {
+  std::atomic<RpcHandlerMethodEntry*> current{nullptr};
+};
+
+class RpcHandlerSampler {
+ public:
+  static RpcHandlerSampler& Instance() {
+    // Intentionally leaked, threads could be tagged during static destruction.
+    static RpcHandlerSampler* instance = new RpcHandlerSampler();
+    return *instance;
+  }
+
+  // Entries are never removed, so their addresses stay valid for thread local caches.
+  RpcHandlerMethodEntry* GetEntry(const std::string& service_name,
+                                  const std::string& method_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& entry = entries_[service_name + "." + method_name];
+    if (!entry) {
+      entry = std::make_unique<RpcHandlerMethodEntry>(service_name, method_name);
+    }
+    return entry.get();
+  }
+
+  void Register(RpcHandlerThreadSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.push_back(slot);
+  }
+
+  void Unregister(RpcHandlerThreadSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.erase(std::remove(slots_.begin(), slots_.end(), slot), slots_.end());
+  }
+
+  void StartIfNeeded() {
+    std::call_once(start_flag_, [this] {
+      auto status = Thread::Create("rpc", "rpc_handler_sampler", &RpcHandlerSampler::Run, this,
+                                   &thread_);
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to start RPC handler sampler: " << status;
+      }
+    });
+  }
+
+  void Sample() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto* slot : slots_) {
+      auto* entry = slot->current.load(std::memory_order_acquire);
+      if (entry) {
+        entry->AddSample();
+      }
+    }
+  }
+
+  std::vector<RpcHandlerSamples> Snapshot() {
+    std::vector<RpcHandlerSamples> result;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      result.reserve(entries_.size());
+      for (const auto& p : entries_) {
+        auto samples = p.second->samples();
+        if (samples != 0) {
+          result.push_back({p.second->service_name(), p.second->method_name(), samples});
+        }
+      }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.samples > rhs.samples;
+    });
+    return result;
+  }
+
+ private:
+  RpcHandlerSampler() = default;
+
+  void Run() {
+    for (;;) {
+      auto interval_ms = FLAGS_rpc_handler_sampling_interval_ms;
+      if (interval_ms <= 0) {
+        SleepFor(MonoDelta::FromSeconds(1));
+        continue;
+      }
+      SleepFor(MonoDelta::FromMilliseconds(interval_ms));
+      Sample();
+    }
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<RpcHandlerMethodEntry>> entries_;
+  std::vector<RpcHandlerThreadSlot*> slots_;
+  std::once_flag start_flag_;
+  scoped_refptr<Thread> thread_;
+};
+
+class RpcHandlerThreadState {
+ public:
+  RpcHandlerThreadState() {
+    RpcHandlerSampler::Instance().Register(&slot_);
+  }
+
+  ~RpcHandlerThreadState() {
+    RpcHandlerSampler::Instance().Unregister(&slot_);
+  }
+
+  RpcHandlerThreadSlot& slot() { return slot_; }
+
+  // Looks up the entry in a thread local cache keyed by method name, so the shared mutex is only
+  // taken the first time a thread handles a method.
+  RpcHandlerMethodEntry* GetEntry(const std::string& service_name,
+                                  const std::string& method_name) {
+    auto& entries = cache_[method_name];
+    for (auto* entry : entries) {
+      if (entry->service_name() == service_name) {
+        return entry;
+      }
+    }
+    auto* entry = RpcHandlerSampler::Instance().GetEntry(service_name, method_name);
+    entries.push_back(entry);
+    return entry;
+  }
+
+ private:
+  RpcHandlerThreadSlot slot_;
+  std::unordered_map<std::string, std::vector<RpcHandlerMethodEntry*>> cache_;
+};
+
+RpcHandlerThreadState& ThreadState() {
+  static thread_local RpcHandlerThreadState state;
+  return state;
+}
+
+} // namespace
+
+ScopedRpcHandlerTag::ScopedRpcHandlerTag(
+    const std::string& service_name, const std::string& method_name) {
+  if (FLAGS_rpc_handler_sampling_interval_ms <= 0) {
+    return;
+  }
+  RpcHandlerSampler::Instance().StartIfNeeded();
+  auto& state = ThreadState();
+  previous_ = state.slot().current.exchange(
+      state.GetEntry(service_name, method_name), std::memory_order_acq_rel);
+  active_ = true;
+}
+
+ScopedRpcHandlerTag::~ScopedRpcHandlerTag() {
+  if (active_) {
+    ThreadState().slot().current.store(previous_, std::memory_order_release);
+  }
+}
+
+std::vector<RpcHandlerSamples> GetRpcHandlerSamples() {
+  return RpcHandlerSampler::Instance().Snapshot();
+}
+
+void TEST_SampleRpcHandlers() {
+  RpcHandlerSampler::Instance().Sample();
+}
+
+} // namespace rpc
+} // namespace yb
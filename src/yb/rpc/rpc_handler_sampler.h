@@ -0,0 +1,59 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_RPC_HANDLER_SAMPLER_H
+#define YB_RPC_RPC_HANDLER_SAMPLER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+namespace rpc {
+
+class RpcHandlerMethodEntry;
+
+// Number of samples that found a thread handling a particular RPC method.
+struct RpcHandlerSamples {
+  std::string service_name;
+  std::string method_name;
+  int64_t samples;
+};
+
+// Marks the current thread as handling the given RPC method while the object is alive. A
+// background sampler wakes up every rpc_handler_sampling_interval_ms and counts, per method, the
+// threads it finds tagged, which attributes the time spent in RPC handlers to their methods.
+class ScopedRpcHandlerTag {
+ public:
+  ScopedRpcHandlerTag(const std::string& service_name, const std::string& method_name);
+  ~ScopedRpcHandlerTag();
+
+ private:
+  RpcHandlerMethodEntry* previous_ = nullptr;
+  bool active_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedRpcHandlerTag);
+};
+
+// Returns the samples collected so far, sorted by descending number of samples.
+std::vector<RpcHandlerSamples> GetRpcHandlerSamples();
+
+// Runs one sampling round synchronously. Used by tests.
+void TEST_SampleRpcHandlers();
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_RPC_HANDLER_SAMPLER_H
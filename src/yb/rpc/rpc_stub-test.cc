@@ -56,6 +56,10 @@ DEFINE_bool(is_panic_test_child, false, "Used by TestRpcPanic");
 DECLARE_bool(socket_inject_short_recvs);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DECLARE_int32(TEST_delay_connect_ms);
+DECLARE_int32(rpc_queue_target_delay_ms);
+DECLARE_int32(rpc_queue_delay_interval_ms);
+
+METRIC_DECLARE_histogram(rpc_bytes_per_write);
 
 using namespace std::chrono_literals;
 
@@ -303,6 +307,29 @@ TEST_F(RpcStubTest, TestBigCallData) {
   }
 }
 
+// Test that big calls with compression enabled are compressed in both directions, once the
+// first response has confirmed that the server supports compression.
+TEST_F(RpcStubTest, TestCompression) {
+  constexpr size_t kMessageSize = 1_MB;
+
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+
+  EchoRequestPB req;
+  req.set_data("negotiate");
+  for (int i = 0; i != 3; ++i) {
+    RpcController controller;
+    controller.set_timeout(30s);
+    controller.set_enable_compression(true);
+    EchoResponsePB resp;
+    ASSERT_OK(p.Echo(req, &resp, &controller));
+    ASSERT_EQ(req.data(), resp.data());
+    req.mutable_data()->assign(kMessageSize, 'x');
+  }
+
+  auto bytes_per_write = METRIC_rpc_bytes_per_write.Instantiate(metric_entity());
+  ASSERT_LT(bytes_per_write->MaxValueForTests(), kMessageSize / 10);
+}
+
 TEST_F(RpcStubTest, TestRespondDeferred) {
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
 
@@ -520,6 +547,76 @@ TEST_F(RpcStubTest, TestDontHandleTimedOutCalls) {
   ASSERT_EQ(1, timed_out_in_queue->value());
 }
 
+// Test that new bulk calls are rejected with a retryable error, while calls stay in the queue
+// longer than the target, and that latency sensitive calls are still handled.
+TEST_F(RpcStubTest, TestRejectBulkCallsWhenOverloaded) {
+  FLAGS_rpc_queue_target_delay_ms = 10;
+  FLAGS_rpc_queue_delay_interval_ms = 50;
+
+  CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
+  vector<AsyncSleep*> sleeps;
+  ElementDeleter d(&sleeps);
+
+  // Queue enough sleep calls, that are bulk in the test service, to keep the time in queue above
+  // the target for several intervals.
+  auto count = client_messenger_->max_concurrent_requests() * 8;
+  CountDownLatch latch(count);
+  for (size_t i = 0; i < count; i++) {
+    gscoped_ptr<AsyncSleep> sleep(new AsyncSleep);
+    sleep->rpc.set_timeout(MonoDelta::FromSeconds(30));
+    sleep->req.set_sleep_micros(100*1000); // 100ms
+    p.SleepAsync(sleep->req, &sleep->resp, &sleep->rpc, [&latch]() { latch.CountDown(); });
+    sleeps.push_back(sleep.release());
+  }
+
+  const Counter* rejected =
+      server().service_pool().RpcsRejectedByAdmissionControlMetricForTests();
+  ASSERT_OK(WaitFor([&p, rejected]() -> Result<bool> {
+    RpcController rpc;
+    rpc.set_timeout(MonoDelta::FromSeconds(30));
+    SleepRequestPB req;
+    SleepResponsePB resp;
+    req.set_sleep_micros(1);
+    auto status = p.Sleep(req, &resp, &rpc);
+    if (status.ok()) {
+      return false;
+    }
+    const ErrorStatusPB* error = rpc.error_response();
+    if (!status.IsRemoteError() || !error ||
+        error->code() != ErrorStatusPB::ERROR_SERVER_TOO_BUSY) {
+      return status;
+    }
+    return rejected->value() > 0;
+  }, 10s, "Bulk call rejected"));
+
+  // Latency sensitive calls are handled while the service is overloaded.
+  {
+    RpcController rpc;
+    rpc.set_timeout(MonoDelta::FromSeconds(30));
+    AddRequestPB req;
+    req.set_x(1);
+    req.set_y(2);
+    AddResponsePB resp;
+    ASSERT_OK(p.Add(req, &resp, &rpc));
+    ASSERT_EQ(3, resp.result());
+  }
+
+  latch.Wait();
+  for (auto* sleep : sleeps) {
+    ASSERT_OK(sleep->rpc.status());
+  }
+
+  // Once the queue has drained, the overloaded state expires and bulk calls are handled again.
+  ASSERT_OK(WaitFor([&p]() -> Result<bool> {
+    RpcController rpc;
+    rpc.set_timeout(MonoDelta::FromSeconds(30));
+    SleepRequestPB req;
+    SleepResponsePB resp;
+    req.set_sleep_micros(1);
+    return p.Sleep(req, &resp, &rpc).ok();
+  }, 10s, "Bulk call handled"));
+}
+
 TEST_F(RpcStubTest, TestDumpCallsInFlight) {
   CountDownLatch latch(1);
   CalculatorServiceProxy p(proxy_cache_.get(), server_hostport_);
@@ -32,6 +32,8 @@
 
 #include "yb/rpc/serialization.h"
 
+#include <lz4.h>
+
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <glog/logging.h>
@@ -40,12 +42,19 @@
 #include "yb/gutil/stringprintf.h"
 #include "yb/rpc/constants.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_int32(rpc_compression_min_size_bytes, 4096,
+             "Minimal size of the body of a call or response, that is compressed when "
+             "compression is enabled for the call.");
+TAG_FLAG(rpc_compression_min_size_bytes, advanced);
+TAG_FLAG(rpc_compression_min_size_bytes, runtime);
+
 using google::protobuf::MessageLite;
 using google::protobuf::io::CodedInputStream;
 using google::protobuf::io::CodedOutputStream;
@@ -137,6 +146,14 @@ Status SerializeHeader(const MessageLite& header,
 Status ParseYBMessage(const Slice& buf,
                       MessageLite* parsed_header,
                       Slice* parsed_main_message) {
+  Slice body;
+  RETURN_NOT_OK(ParseYBHeader(buf, parsed_header, &body));
+  return ParseYBBody(body, parsed_main_message);
+}
+
+Status ParseYBHeader(const Slice& buf,
+                     MessageLite* parsed_header,
+                     Slice* body) {
   if (PREDICT_FALSE(buf.size() < kMsgLengthPrefixLength)) {
     return STATUS(Corruption, "Invalid packet: not enough bytes for length header",
                               buf.ToDebugString());
@@ -159,29 +176,89 @@ Status ParseYBMessage(const Slice& buf,
   }
   in.PopLimit(l);
 
+  *body = Slice(buf.data() + in.CurrentPosition(), buf.size() - in.CurrentPosition());
+  return Status::OK();
+}
+
+Status ParseYBBody(const Slice& body, Slice* parsed_main_message) {
+  CodedInputStream in(body.data(), body.size());
+  in.SetTotalBytesLimit(FLAGS_rpc_max_message_size, FLAGS_rpc_max_message_size*3/4);
+
   uint32_t main_msg_len;
   if (PREDICT_FALSE(!in.ReadVarint32(&main_msg_len))) {
     return STATUS(Corruption, "Invalid packet: missing main msg length",
-                              buf.ToDebugString());
+                              body.ToDebugString());
   }
 
   if (PREDICT_FALSE(!in.Skip(main_msg_len))) {
     return STATUS(Corruption,
         StringPrintf("Invalid packet: data too short, expected %d byte main_msg", main_msg_len),
-        buf.ToDebugString());
+        body.ToDebugString());
   }
 
   if (PREDICT_FALSE(in.BytesUntilLimit() > 0)) {
     return STATUS(Corruption,
       StringPrintf("Invalid packet: %d extra bytes at end of packet", in.BytesUntilLimit()),
-      buf.ToDebugString());
+      body.ToDebugString());
   }
 
-  *parsed_main_message = Slice(buf.data() + buf.size() - main_msg_len,
+  *parsed_main_message = Slice(body.data() + body.size() - main_msg_len,
                               main_msg_len);
   return Status::OK();
 }
 
+Result<bool> CompressBody(CompressionTypePB compression, const Slice& body, faststring* compressed) {
+  if (static_cast<int64_t>(body.size()) < FLAGS_rpc_compression_min_size_bytes) {
+    return false;
+  }
+
+  switch (compression) {
+    case CompressionTypePB::NO_COMPRESSION:
+      return false;
+    case CompressionTypePB::LZ4: {
+      compressed->resize(LZ4_compressBound(body.size()));
+      int size = LZ4_compress_default(
+          body.cdata(), reinterpret_cast<char*>(compressed->data()), body.size(),
+          compressed->size());
+      if (size <= 0) {
+        return STATUS_FORMAT(RuntimeError, "LZ4 failed to compress $0 bytes", body.size());
+      }
+      compressed->resize(size);
+      return static_cast<size_t>(size) < body.size();
+    }
+  }
+
+  return STATUS_FORMAT(InvalidArgument, "Unknown compression: $0", compression);
+}
+
+Status DecompressBody(CompressionTypePB compression,
+                      const Slice& body,
+                      size_t uncompressed_size,
+                      CallData* output) {
+  if (uncompressed_size > static_cast<size_t>(FLAGS_rpc_max_message_size)) {
+    return STATUS_FORMAT(Corruption, "Too big uncompressed body: $0", uncompressed_size);
+  }
+
+  switch (compression) {
+    case CompressionTypePB::NO_COMPRESSION:
+      output->assign(body.cdata(), body.cdata() + body.size());
+      return Status::OK();
+    case CompressionTypePB::LZ4: {
+      output->resize(uncompressed_size);
+      int size = LZ4_decompress_safe(
+          body.cdata(), output->data(), body.size(), uncompressed_size);
+      if (size < 0 || static_cast<size_t>(size) != uncompressed_size) {
+        return STATUS_FORMAT(
+            Corruption, "Failed to decompress body of $0 bytes, expected $1 bytes, got: $2",
+            body.size(), uncompressed_size, size);
+      }
+      return Status::OK();
+    }
+  }
+
+  return STATUS_FORMAT(Corruption, "Unknown compression: $0", compression);
+}
+
 }  // namespace serialization
 }  // namespace rpc
 }  // namespace yb
@@ -36,6 +36,11 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/util/result.h"
+
 namespace google {
 namespace protobuf {
 class MessageLite;
@@ -95,6 +100,26 @@ Status ParseYBMessage(const Slice& buf,
                       google::protobuf::MessageLite* parsed_header,
                       Slice* parsed_main_message);
 
+// The same as ParseYBMessage, but split in two steps, so the caller could decompress the body
+// between them.
+// ParseYBHeader parses the header and sets 'body' to the rest of the buffer.
+// ParseYBBody extracts the main payload from 'body'.
+Status ParseYBHeader(const Slice& buf,
+                     google::protobuf::MessageLite* parsed_header,
+                     Slice* body);
+Status ParseYBBody(const Slice& body, Slice* parsed_main_message);
+
+// Compresses the part of the frame that follows the header.
+// Returns false, leaving 'compressed' unspecified, when the body is smaller than
+// --rpc_compression_min_size_bytes or compression does not make it smaller.
+Result<bool> CompressBody(CompressionTypePB compression, const Slice& body, faststring* compressed);
+
+// Decompresses the body compressed by CompressBody to 'output'.
+Status DecompressBody(CompressionTypePB compression,
+                      const Slice& body,
+                      size_t uncompressed_size,
+                      CallData* output);
+
 
 }  // namespace serialization
 }  // namespace rpc
@@ -66,6 +66,16 @@ class ServiceIf {
   virtual ~ServiceIf();
   virtual void Handle(InboundCallPtr incoming) = 0;
 
+  // Returns true if the call is known to be handled quickly and without blocking, so it could be
+  // handled on the reactor thread that received it, instead of being queued to the thread pool.
+  virtual bool ShouldHandleInline(const InboundCall& call) { return false; }
+
+  // Returns the priority class of the call. Queued calls of a higher class are handled before
+  // calls of a lower class, and calls of the same class are handled in deadline order.
+  virtual CallPriority GetCallPriority(const InboundCall& call) {
+    return CallPriority::kLatencySensitive;
+  }
+
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
 };
@@ -32,7 +32,11 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -41,8 +45,11 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/rpc/connection.h"
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/reactor.h"
+#include "yb/rpc/rpc_handler_sampler.h"
 #include "yb/rpc/service_if.h"
 #include "yb/rpc/tasks_pool.h"
 
@@ -66,6 +73,29 @@ DEFINE_int64(backpressure_recovery_period_ms, 600000,
              "for this duration (in ms)");
 TAG_FLAG(backpressure_recovery_period_ms, advanced);
 TAG_FLAG(backpressure_recovery_period_ms, runtime);
+DEFINE_bool(rpc_handle_short_calls_inline, false,
+            "Handle calls that the service expects to be short and non blocking on the reactor "
+            "thread that received them, instead of queueing them to the service thread pool.");
+TAG_FLAG(rpc_handle_short_calls_inline, advanced);
+TAG_FLAG(rpc_handle_short_calls_inline, runtime);
+DEFINE_bool(rpc_prioritize_calls, true,
+            "Handle queued calls of a service in the order of their priority class, see "
+            "ServiceIf::GetCallPriority, and in the order of their deadlines within the same "
+            "class.");
+TAG_FLAG(rpc_prioritize_calls, advanced);
+TAG_FLAG(rpc_prioritize_calls, runtime);
+DEFINE_int32(rpc_queue_target_delay_ms, 100,
+             "Target time that calls spend in the service queue. If the time in queue of handled "
+             "calls stays above the target for rpc_queue_delay_interval_ms, the service starts "
+             "rejecting new bulk calls with a retryable server too busy error, until the time "
+             "in queue drops below the target. 0 to disable.");
+TAG_FLAG(rpc_queue_target_delay_ms, advanced);
+TAG_FLAG(rpc_queue_target_delay_ms, runtime);
+DEFINE_int32(rpc_queue_delay_interval_ms, 1000,
+             "Interval that the time in queue of handled calls should stay above "
+             "rpc_queue_target_delay_ms, before the service starts rejecting new bulk calls.");
+TAG_FLAG(rpc_queue_delay_interval_ms, advanced);
+TAG_FLAG(rpc_queue_delay_interval_ms, runtime);
 DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
@@ -88,6 +118,12 @@ METRIC_DEFINE_counter(server, rpcs_queue_overflow,
                       "Number of RPCs dropped because the service queue "
                       "was full.");
 
+METRIC_DEFINE_counter(server, rpcs_rejected_by_admission_control,
+                      "RPCs Rejected By Admission Control",
+                      yb::MetricUnit::kRequests,
+                      "Number of bulk RPCs rejected on arrival, because the time that calls "
+                      "spend in the service queue stayed above rpc_queue_target_delay_ms.");
+
 namespace yb {
 namespace rpc {
 
@@ -96,6 +132,9 @@ namespace {
 static constexpr CoarseMonoClock::Duration kNone{
     CoarseTimePoint::min().time_since_epoch()};
 
+YB_DEFINE_ENUM(QueueEnd, (kHighestPriority)(kLowestPriority));
+
+// When call is not specified, the task handles the queued call with the highest priority.
 class InboundCallTask final {
  public:
   InboundCallTask(ServicePoolImpl* pool, InboundCallPtr call)
@@ -123,6 +162,8 @@ class ServicePoolImpl {
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
+        rpcs_rejected_by_admission_control_(
+            METRIC_rpcs_rejected_by_admission_control.Instantiate(entity)),
         tasks_pool_(max_tasks) {
   }
 
@@ -138,10 +179,40 @@ class ServicePoolImpl {
   }
 
   void Enqueue(InboundCallPtr call) {
+    if (GetAtomicFlag(&FLAGS_rpc_handle_short_calls_inline) && TryHandleOnReactor(call)) {
+      return;
+    }
+
+    if (PREDICT_FALSE(call->ClientTimedOut())) {
+      call->RecordHandlingStarted(incoming_queue_time_);
+      TimeOut(call, "Call received past deadline");
+      return;
+    }
+
+    if (PREDICT_FALSE(ShouldShed(*call))) {
+      Shed(call);
+      return;
+    }
+
     TRACE_TO(call->trace(), "Inserting onto call queue");
 
-    if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
-      Overflow(call, "service", tasks_pool_.size());
+    if (!GetAtomicFlag(&FLAGS_rpc_prioritize_calls)) {
+      if (!tasks_pool_.Enqueue(thread_pool_, this, std::move(call))) {
+        Overflow(call, "service", tasks_pool_.size());
+      }
+      return;
+    }
+
+    // Each queued call has a task that handles the queued call with the highest priority, so
+    // the number of running and queued tasks matches the number of queued calls.
+    PushQueuedCall(call);
+    if (!tasks_pool_.Enqueue(thread_pool_, this, nullptr)) {
+      // Drop the call with the lowest priority instead of the new one, it could be a different
+      // call.
+      auto dropped_call = PopQueuedCall(QueueEnd::kLowestPriority);
+      if (dropped_call) {
+        Overflow(dropped_call, "service", tasks_pool_.size());
+      }
     }
   }
 
@@ -153,6 +224,10 @@ class ServicePoolImpl {
     return rpcs_queue_overflow_.get();
   }
 
+  const Counter* RpcsRejectedByAdmissionControlMetricForTests() const {
+    return rpcs_rejected_by_admission_control_.get();
+  }
+
   std::string service_name() const {
     return service_->service_name();
   }
@@ -174,10 +249,18 @@ class ServicePoolImpl {
         CoarseMonoClock::Now().time_since_epoch(), std::memory_order_release);
   }
 
-  void Processed(const InboundCallPtr& call, const Status& status) {
+  void Processed(InboundCallPtr call, const Status& status) {
     if (status.ok()) {
       return;
     }
+    if (!call) {
+      // Task that should handle a queued call was not executed, so fail the queued call with
+      // the lowest priority.
+      call = PopQueuedCall(QueueEnd::kLowestPriority);
+      if (!call) {
+        return;
+      }
+    }
     if (status.IsServiceUnavailable()) {
       Overflow(call, "global", thread_pool_->options().queue_limit);
       return;
@@ -192,29 +275,111 @@ class ServicePoolImpl {
   void Handle(InboundCallPtr incoming) {
     incoming->RecordHandlingStarted(incoming_queue_time_);
     ADOPT_TRACE(incoming->trace());
+    UpdateOverloaded(incoming->GetTimeInQueue());
 
     if (PREDICT_FALSE(incoming->ClientTimedOut() || ShouldDropRequestDuringHighLoad(incoming))) {
-      const char* message =
-          (incoming->ClientTimedOut()
-               ? "Call waited in the queue past deadline"
-               : "The server is overloaded. Call waited in the queue past max_time_in_queue.");
-      TRACE_TO(incoming->trace(), message);
-      VLOG(4) << "Timing out call " << incoming->ToString() << " due to : " << message;
-      rpcs_timed_out_in_queue_->Increment();
-
-      // Respond as a failure, even though the client will probably ignore
-      // the response anyway.
-      incoming->RespondFailure(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, STATUS(TimedOut, message));
-
+      TimeOut(
+          incoming,
+          incoming->ClientTimedOut()
+              ? "Call waited in the queue past deadline"
+              : "The server is overloaded. Call waited in the queue past max_time_in_queue.");
       return;
     }
 
     TRACE_TO(incoming->trace(), "Handling call");
 
+    ScopedRpcHandlerTag handler_tag(incoming->service_name(), incoming->method_name());
     service_->Handle(std::move(incoming));
   }
 
+  void HandleQueued() {
+    // Tasks are enqueued after their calls, so there is always a queued call for a running task.
+    auto call = PopQueuedCall(QueueEnd::kHighestPriority);
+    if (call) {
+      Handle(std::move(call));
+    }
+  }
+
  private:
+  struct QueuedCall {
+    MonoTime deadline;
+    // Preserves arrival order of calls with the same deadline.
+    uint64_t serial;
+    InboundCallPtr call;
+  };
+
+  struct QueuedCallComparator {
+    bool operator()(const QueuedCall& lhs, const QueuedCall& rhs) const {
+      if (lhs.deadline < rhs.deadline) {
+        return true;
+      }
+      if (rhs.deadline < lhs.deadline) {
+        return false;
+      }
+      return lhs.serial < rhs.serial;
+    }
+  };
+
+  typedef std::set<QueuedCall, QueuedCallComparator> CallQueue;
+
+  void PushQueuedCall(const InboundCallPtr& call) {
+    auto priority = service_->GetCallPriority(*call);
+    auto deadline = call->GetClientDeadline();
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queues_[to_underlying(priority)].insert(QueuedCall{deadline, next_call_serial_++, call});
+  }
+
+  InboundCallPtr PopQueuedCall(QueueEnd end) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (end == QueueEnd::kHighestPriority) {
+      for (auto& queue : queues_) {
+        if (!queue.empty()) {
+          auto result = queue.begin()->call;
+          queue.erase(queue.begin());
+          return result;
+        }
+      }
+    } else {
+      for (auto it = queues_.rbegin(); it != queues_.rend(); ++it) {
+        if (!it->empty()) {
+          auto last = std::prev(it->end());
+          auto result = last->call;
+          it->erase(last);
+          return result;
+        }
+      }
+    }
+    LOG(DFATAL) << "No queued call in " << service_->service_name();
+    return nullptr;
+  }
+
+  void TimeOut(const InboundCallPtr& call, const char* message) {
+    TRACE_TO(call->trace(), message);
+    VLOG(4) << "Timing out call " << call->ToString() << " due to : " << message;
+    rpcs_timed_out_in_queue_->Increment();
+
+    // Respond as a failure, even though the client will probably ignore
+    // the response anyway.
+    call->RespondFailure(ErrorStatusPB::ERROR_SERVER_TOO_BUSY, STATUS(TimedOut, message));
+  }
+
+  // Schedules handling of the call on the reactor thread that owns its connection, if the service
+  // expects the call to be short. It is handled after the reactor finishes processing of received
+  // data, so the handler could respond synchronously.
+  // Local calls are not handled inline, since they are enqueued by a thread that could wait for
+  // them.
+  bool TryHandleOnReactor(const InboundCallPtr& call) {
+    auto connection = call->connection();
+    if (!connection || !connection->reactor()->IsCurrentThread() ||
+        !service_->ShouldHandleInline(*call)) {
+      return false;
+    }
+    TRACE_TO(call->trace(), "Scheduling on reactor thread");
+    auto reactor = connection->reactor();
+    return reactor->ScheduleReactorTask(MakeFunctorReactorTask(
+        std::bind(&Messenger::Handle, reactor->messenger(), call), connection, SOURCE_LOCATION()));
+  }
+
   bool ShouldDropRequestDuringHighLoad(InboundCallPtr incoming) {
     auto last_backpressure_at = last_backpressure_at_.load(std::memory_order_acquire);
 
@@ -237,19 +402,99 @@ class ServicePoolImpl {
     return incoming->GetTimeInQueue().ToMilliseconds() > FLAGS_max_time_in_queue_ms;
   }
 
+  // Tracks time in queue of handled calls, like CoDel does for packets. The service is considered
+  // overloaded when the time in queue stays above the target for the whole interval, i.e. the
+  // queue does not drain even though workers take calls from it. The time in queue is measured
+  // from the moment the call was received by the reactor, so it also includes the reactor and
+  // messenger delays.
+  void UpdateOverloaded(MonoDelta time_in_queue) {
+    auto target_ms = GetAtomicFlag(&FLAGS_rpc_queue_target_delay_ms);
+    if (target_ms <= 0 || time_in_queue.ToMilliseconds() < target_ms) {
+      if (above_target_since_.load(std::memory_order_acquire) != kNone) {
+        above_target_since_.store(kNone, std::memory_order_release);
+      }
+      if (overloaded_until_.load(std::memory_order_acquire) != kNone) {
+        overloaded_until_.store(kNone, std::memory_order_release);
+        LOG(INFO) << service_->service_name() << " is no longer overloaded, time in queue: "
+                  << time_in_queue;
+      }
+      return;
+    }
+
+    auto now = CoarseMonoClock::Now().time_since_epoch();
+    auto above_target_since = above_target_since_.load(std::memory_order_acquire);
+    if (above_target_since == kNone) {
+      // Several workers could get here concurrently, it is enough for one of them to succeed.
+      above_target_since_.compare_exchange_strong(above_target_since, now);
+      return;
+    }
+    auto interval = std::chrono::milliseconds(GetAtomicFlag(&FLAGS_rpc_queue_delay_interval_ms));
+    if (now - above_target_since < interval) {
+      return;
+    }
+    // Overloaded state expires, when no call is handled during the interval. Otherwise it would
+    // never be left when all new calls are rejected.
+    if (overloaded_until_.exchange(now + interval, std::memory_order_acq_rel) < now) {
+      LOG(WARNING) << service_->service_name() << " is overloaded, time in queue: "
+                   << time_in_queue << ", rejecting new bulk calls";
+    }
+  }
+
+  // Only bulk calls are rejected, so consensus and latency sensitive calls could still be
+  // handled while the queue drains.
+  bool ShouldShed(const InboundCall& call) {
+    auto overloaded_until = overloaded_until_.load(std::memory_order_acquire);
+    // Test for a sentinel value, to avoid reading the clock.
+    if (overloaded_until == kNone ||
+        overloaded_until < CoarseMonoClock::Now().time_since_epoch()) {
+      return false;
+    }
+    return service_->GetCallPriority(call) == CallPriority::kBulk;
+  }
+
+  void Shed(const InboundCallPtr& call) {
+    const auto err_msg =
+        Substitute("$0 request on $1 from $2 rejected, because the service is overloaded. "
+                   "Calls stay in the queue longer than $3ms.",
+            call->method_name(),
+            service_->service_name(),
+            yb::ToString(call->remote_address()),
+            GetAtomicFlag(&FLAGS_rpc_queue_target_delay_ms));
+    YB_LOG_EVERY_N_SECS(WARNING, 3) << err_msg;
+    rpcs_rejected_by_admission_control_->Increment();
+    call->RespondFailure(
+        ErrorStatusPB::ERROR_SERVER_TOO_BUSY, STATUS(ServiceUnavailable, err_msg));
+  }
+
   ThreadPool* thread_pool_;
   ServiceIfPtr service_;
   scoped_refptr<Histogram> incoming_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
+  scoped_refptr<Counter> rpcs_rejected_by_admission_control_;
   std::atomic<CoarseMonoClock::Duration> last_backpressure_at_;
 
+  // Time since the time in queue of handled calls is above rpc_queue_target_delay_ms,
+  // kNone if it is below.
+  std::atomic<CoarseMonoClock::Duration> above_target_since_{kNone};
+  // Time until new bulk calls are rejected, kNone if the service is not overloaded.
+  std::atomic<CoarseMonoClock::Duration> overloaded_until_{kNone};
+
   std::atomic<bool> closing_ = {false};
   TasksPool<InboundCallTask> tasks_pool_;
+
+  // Calls waiting for a task to handle them, indexed by CallPriority.
+  std::mutex queue_mutex_;
+  std::array<CallQueue, kCallPriorityMapSize> queues_;
+  uint64_t next_call_serial_ = 0;
 };
 
 void InboundCallTask::Run() {
-  pool_->Handle(call_);
+  if (call_) {
+    pool_->Handle(call_);
+  } else {
+    pool_->HandleQueued();
+  }
 }
 
 void InboundCallTask::Done(const Status& status) {
@@ -287,6 +532,10 @@ const Counter* ServicePool::RpcsQueueOverflowMetric() const {
   return impl_->RpcsQueueOverflowMetric();
 }
 
+const Counter* ServicePool::RpcsRejectedByAdmissionControlMetricForTests() const {
+  return impl_->RpcsRejectedByAdmissionControlMetricForTests();
+}
+
 std::string ServicePool::service_name() const {
   return impl_->service_name();
 }
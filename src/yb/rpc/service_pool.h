@@ -72,6 +72,7 @@ class ServicePool : public RpcService {
   virtual void Handle(InboundCallPtr call) override;
   const Counter* RpcsTimedOutInQueueMetricForTests() const;
   const Counter* RpcsQueueOverflowMetric() const;
+  const Counter* RpcsRejectedByAdmissionControlMetricForTests() const;
   std::string service_name() const;
 
  private:
@@ -34,6 +34,9 @@ class StreamContext {
  public:
   virtual void UpdateLastActivity() = 0;
   virtual void Transferred(const OutboundDataPtr& data, const Status& status) = 0;
+  // Invoked after a single write to the socket, with the number of written bytes and the number
+  // of outbound data entries whose transfer was completed by this write.
+  virtual void DataWritten(size_t bytes, size_t transfers) = 0;
   virtual void Destroy(const Status& status) = 0;
   virtual void Connected() = 0;
   virtual Result<size_t> ProcessReceived(const IoVecs& data, ReadBufferFull read_buffer_full) = 0;
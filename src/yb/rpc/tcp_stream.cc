@@ -30,7 +30,9 @@ namespace rpc {
 
 namespace {
 
-const size_t kMaxIov = 16;
+// Calls queued to the connection during the same reactor loop iteration are written by a single
+// system call, as long as they fit into this number of buffers.
+const size_t kMaxIov = 128;
 
 }
 
@@ -189,6 +191,7 @@ Status TcpStream::DoWrite() {
     }
 
     send_position_ += written;
+    size_t transfers = 0;
     while (!sending_.empty()) {
       auto& front = sending_.front();
       if (front.skipped) {
@@ -202,10 +205,12 @@ Status TcpStream::DoWrite() {
       auto data = front.data;
       send_position_ -= full_size;
       sending_.pop_front();
+      ++transfers;
       if (data) {
         context_->Transferred(data, Status::OK());
       }
     }
+    context_->DataWritten(written, transfers);
   }
 
   return Status::OK();
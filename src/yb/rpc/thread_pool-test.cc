@@ -21,9 +21,13 @@
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/metrics.h"
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+METRIC_DECLARE_counter(rpc_thread_pool_tasks_stolen);
+METRIC_DECLARE_histogram(rpc_thread_pool_queue_time);
+
 namespace yb {
 namespace rpc {
 
@@ -250,5 +254,65 @@ TEST_F(ThreadPoolTest, TestOwns) {
   ASSERT_TRUE(pool.Owns(task.thread()));
 }
 
+TEST_F(ThreadPoolTest, TestWorkStealing) {
+  constexpr size_t kTotalTasks = 100;
+  constexpr size_t kTotalWorkers = 4;
+
+  // Task that enqueues subtasks to the local queue of its worker, and waits until they complete.
+  // So subtasks could be executed only by stealing them.
+  class SpawningTask : public ThreadPoolTask {
+   public:
+    explicit SpawningTask(ThreadPool* thread_pool) : thread_pool_(thread_pool) {}
+
+    void Run() {
+      ASSERT_TRUE(thread_pool_->OwnsThisThread());
+      for (auto& task : subtasks_) {
+        task.SetLatch(&subtasks_latch_);
+        ASSERT_TRUE(thread_pool_->Enqueue(&task));
+      }
+      subtasks_latch_.Wait();
+    }
+
+    void Done(const Status& status) {
+      latch_.CountDown();
+    }
+
+    void Wait() {
+      return latch_.Wait();
+    }
+
+    bool AllSubtasksCompleted() const {
+      for (const auto& task : subtasks_) {
+        if (!task.IsCompleted()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    virtual ~SpawningTask() {}
+
+   private:
+    ThreadPool* const thread_pool_;
+    std::vector<TestTask> subtasks_{kTotalTasks};
+    CountDownLatch subtasks_latch_{kTotalTasks};
+    CountDownLatch latch_{1};
+  };
+
+  MetricRegistry metric_registry;
+  auto metric_entity = METRIC_ENTITY_server.Instantiate(&metric_registry, "test.thread_pool");
+  ThreadPool pool("test", kTotalTasks, kTotalWorkers, metric_entity);
+
+  SpawningTask task(&pool);
+  ASSERT_TRUE(pool.Enqueue(&task));
+  task.Wait();
+  ASSERT_TRUE(task.AllSubtasksCompleted());
+
+  auto tasks_stolen = METRIC_rpc_thread_pool_tasks_stolen.Instantiate(metric_entity);
+  ASSERT_EQ(kTotalTasks, tasks_stolen->value());
+  auto queue_time = METRIC_rpc_thread_pool_queue_time.Instantiate(metric_entity);
+  ASSERT_EQ(kTotalTasks + 1, queue_time->TotalCount());
+}
+
 } // namespace rpc
 } // namespace yb
@@ -16,14 +16,31 @@
 #include "yb/rpc/thread_pool.h"
 
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 
 #include <boost/lockfree/queue.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/util/locks.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 #include "yb/util/thread.h"
 
+METRIC_DEFINE_histogram(server, rpc_thread_pool_queue_time,
+                        "RPC Thread Pool Queue Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Number of microseconds tasks spend in the RPC thread pool queues before "
+                        "being picked up by a worker",
+                        60000000LU, 2);
+
+METRIC_DEFINE_counter(server, rpc_thread_pool_tasks_stolen,
+                      "RPC Thread Pool Stolen Tasks",
+                      yb::MetricUnit::kTasks,
+                      "Number of tasks executed by a RPC thread pool worker, that were queued to "
+                      "the local queue of another worker");
+
 namespace yb {
 namespace rpc {
 
@@ -31,18 +48,48 @@ namespace {
 
 class Worker;
 
-typedef boost::lockfree::queue<ThreadPoolTask*> TaskQueue;
+struct QueuedTask {
+  ThreadPoolTask* task;
+  // Initialized only when queue time is tracked.
+  MonoTime enqueue_time;
+};
+
+typedef boost::lockfree::queue<QueuedTask> TaskQueue;
 typedef boost::lockfree::queue<Worker*> WaitingWorkers;
 
 struct ThreadPoolShare {
   ThreadPoolOptions options;
   TaskQueue task_queue;
   WaitingWorkers waiting_workers;
+  // Workers that could be used for stealing, indexed by worker index.
+  std::unique_ptr<std::atomic<Worker*>[]> workers;
+  scoped_refptr<Histogram> queue_time;
+  scoped_refptr<Counter> tasks_stolen;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
       : options(std::move(o)),
         task_queue(options.queue_limit),
-        waiting_workers(options.max_workers) {
+        waiting_workers(options.max_workers),
+        workers(new std::atomic<Worker*>[options.max_workers]()) {
+    if (options.metric_entity) {
+      queue_time = METRIC_rpc_thread_pool_queue_time.Instantiate(options.metric_entity);
+      tasks_stolen = METRIC_rpc_thread_pool_tasks_stolen.Instantiate(options.metric_entity);
+    }
+  }
+
+  QueuedTask MakeQueuedTask(ThreadPoolTask* task) {
+    return QueuedTask{task, queue_time ? MonoTime::Now() : MonoTime()};
+  }
+
+  ThreadPoolTask* Dequeued(const QueuedTask& queued_task, bool stolen) {
+    if (queue_time) {
+      auto wait_time = MonoTime::Now().GetDeltaSince(queued_task.enqueue_time);
+      queue_time->Increment(wait_time.ToMicroseconds());
+    }
+    if (stolen && tasks_stolen) {
+      tasks_stolen->Increment();
+    }
+    return queued_task.task;
   }
 };
 
@@ -52,27 +99,41 @@ const std::string kRpcThreadCategory = "rpc_thread_pool";
 
 } // namespace
 
+// Worker that is executing the current thread, if any.
+thread_local Worker* current_worker = nullptr;
+
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), index_(index) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
 
   ~Worker() {
-    thread_->Join();
+    Join();
   }
 
   Worker(const Worker& worker) = delete;
   void operator=(const Worker& worker) = delete;
 
+  ThreadPoolShare* share() const {
+    return share_;
+  }
+
   void Stop() {
     stop_requested_ = true;
     std::lock_guard<std::mutex> lock(mutex_);
     cond_.notify_one();
   }
 
+  void Join() {
+    if (thread_) {
+      thread_->Join();
+      thread_ = nullptr;
+    }
+  }
+
   bool Notify() {
     std::lock_guard<std::mutex> lock(mutex_);
     added_to_waiting_workers_ = false;
@@ -88,13 +149,54 @@ class Worker {
     return true;
   }
 
+  // Should be invoked only from the thread of this worker.
+  bool PushLocal(ThreadPoolTask* task) {
+    std::lock_guard<simple_spinlock> lock(local_lock_);
+    if (local_queue_.size() >= share_->options.queue_limit) {
+      return false;
+    }
+    local_queue_.push_back(share_->MakeQueuedTask(task));
+    local_size_.store(local_queue_.size(), std::memory_order_release);
+    return true;
+  }
+
+  // Tasks are stolen from the front of the local queue, i.e. the oldest ones, while the owner
+  // takes the most recent ones, that are more likely to have their data in cache.
+  bool Steal(QueuedTask* task) {
+    if (local_size_.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    std::lock_guard<simple_spinlock> lock(local_lock_);
+    if (local_queue_.empty()) {
+      return false;
+    }
+    *task = local_queue_.front();
+    local_queue_.pop_front();
+    local_size_.store(local_queue_.size(), std::memory_order_release);
+    return true;
+  }
+
+  // Should be invoked only after thread of this worker is joined.
+  void AbortLocalTasks(const Status& status) {
+    std::deque<QueuedTask> queue;
+    {
+      std::lock_guard<simple_spinlock> lock(local_lock_);
+      queue.swap(local_queue_);
+      local_size_.store(0, std::memory_order_release);
+    }
+    for (const auto& queued_task : queue) {
+      queued_task.task->Done(status);
+    }
+  }
+
  private:
-  // Our main invariant is empty task queue or empty worker queue.
-  // In other words, one of those queues should be empty.
-  // Meaning that we does not have work (task queue empty) or
+  // Our main invariant is empty task queues or empty worker queue.
+  // In other words, one of those should be empty.
+  // Meaning that we does not have work (task queues empty) or
   // does not have free hands (worker queue empty)
   void Execute() {
     Thread::current_thread()->SetUserData(share_);
+    current_worker = this;
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -102,12 +204,46 @@ class Worker {
         task->Done(Status::OK());
       }
     }
+    current_worker = nullptr;
+  }
+
+  bool PopLocal(QueuedTask* task) {
+    if (local_size_.load(std::memory_order_acquire) == 0) {
+      return false;
+    }
+    std::lock_guard<simple_spinlock> lock(local_lock_);
+    if (local_queue_.empty()) {
+      return false;
+    }
+    *task = local_queue_.back();
+    local_queue_.pop_back();
+    local_size_.store(local_queue_.size(), std::memory_order_release);
+    return true;
+  }
+
+  // Looks for a task in the local queue, then in the shared queue, and then tries to steal a task
+  // from local queues of other workers.
+  bool TryPopTask(ThreadPoolTask** task) {
+    QueuedTask queued_task;
+    if (PopLocal(&queued_task) || share_->task_queue.pop(queued_task)) {
+      *task = share_->Dequeued(queued_task, false /* stolen */);
+      return true;
+    }
+    const auto max_workers = share_->options.max_workers;
+    for (size_t i = 1; i < max_workers; ++i) {
+      auto* worker = share_->workers[(index_ + i) % max_workers].load(std::memory_order_acquire);
+      if (worker && worker->Steal(&queued_task)) {
+        *task = share_->Dequeued(queued_task, true /* stolen */);
+        return true;
+      }
+    }
+    return false;
   }
 
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (TryPopTask(task)) {
       return true;
     }
     std::unique_lock<std::mutex> lock(mutex_);
@@ -123,7 +259,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
         return true;
       }
 
@@ -131,7 +267,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
         return true;
       }
     }
@@ -147,12 +283,19 @@ class Worker {
   }
 
   ThreadPoolShare* share_;
+  const size_t index_;
   scoped_refptr<yb::Thread> thread_;
   std::mutex mutex_;
   std::condition_variable cond_;
   std::atomic<bool> stop_requested_ = {false};
   bool waiting_task_ = false;
   bool added_to_waiting_workers_ = false;
+
+  // Tasks enqueued by this worker. Pushed and popped at the back by this worker, and stolen from
+  // the front by other workers.
+  simple_spinlock local_lock_;
+  std::deque<QueuedTask> local_queue_;
+  std::atomic<size_t> local_size_ = {0};
 };
 
 } // namespace
@@ -181,13 +324,18 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.bounded_push(task);
+    bool added;
+    auto* worker = current_worker;
+    if (worker && worker->share() == &share_) {
+      added = worker->PushLocal(task);
+    } else {
+      added = share_.task_queue.bounded_push(share_.MakeQueuedTask(task));
+    }
     --adding_;
     if (!added) {
       task->Done(queue_full_status_);
       return false;
     }
-    Worker* worker = nullptr;
     while (share_.waiting_workers.pop(worker)) {
       if (worker->Notify()) {
         return true;
@@ -202,6 +350,7 @@ class ThreadPool::Impl {
       std::lock_guard<std::mutex> lock(mutex_);
       if (!closing_) {
         workers_[index].reset(new Worker(&share_, index));
+        share_.workers[index].store(workers_[index].get(), std::memory_order_release);
       }
     } else {
       --created_workers_;
@@ -226,16 +375,29 @@ class ThreadPool::Impl {
         worker->Stop();
       }
     }
-    workers_.clear();
+    // Workers could steal from each other, so all of them should be joined before any of them
+    // is destroyed.
+    for (auto& worker : workers_) {
+      if (worker) {
+        worker->Join();
+      }
+    }
     // Shutdown is quite rare situation otherwise enqueue is quite frequent.
     // Because of this we use "atomic lock" in enqueue and busy wait in shutdown.
     // So we could process enqueue quickly, and stuck in shutdown for sometime.
     while(adding_ != 0) {
       std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
-    ThreadPoolTask* task = nullptr;
-    while (share_.task_queue.pop(task)) {
-      task->Done(shutdown_status_);
+    for (size_t index = 0; index != workers_.size(); ++index) {
+      share_.workers[index].store(nullptr, std::memory_order_release);
+      if (workers_[index]) {
+        workers_[index]->AbortLocalTasks(shutdown_status_);
+      }
+    }
+    workers_.clear();
+    QueuedTask queued_task;
+    while (share_.task_queue.pop(queued_task)) {
+      queued_task.task->Done(shutdown_status_);
     }
   }
 
@@ -19,8 +19,11 @@
 #include <memory>
 #include <string>
 
+#include "yb/gutil/ref_counted.h"
+
 namespace yb {
 
+class MetricEntity;
 class Status;
 class Thread;
 
@@ -41,6 +44,9 @@ struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
   size_t max_workers;
+  // When specified, queue time of tasks and number of tasks stolen by workers from each other
+  // are tracked in this entity.
+  scoped_refptr<MetricEntity> metric_entity;
 };
 
 class ThreadPool {
@@ -60,6 +66,9 @@ class ThreadPool {
 
   const ThreadPoolOptions& options() const;
 
+  // Tasks enqueued by a worker of this pool are placed to the local queue of this worker, so they
+  // are usually executed by the same thread. Idle workers steal tasks from local queues of busy
+  // workers. Tasks enqueued from other threads are placed to the shared queue.
   bool Enqueue(ThreadPoolTask* task);
   void Shutdown();
 
@@ -0,0 +1,603 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/uring_stream.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include <ev++.h>
+
+#include "yb/rpc/io_uring.h"
+#include "yb/rpc/outbound_data.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/string_util.h"
+
+using namespace std::literals;
+
+DEFINE_int32(rpc_io_uring_entries, 4096,
+             "Size of the io_uring submission queue of each reactor that uses io_uring streams.");
+TAG_FLAG(rpc_io_uring_entries, advanced);
+
+DECLARE_uint64(rpc_connection_timeout_ms);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+const size_t kMaxIov = 128;
+
+} // namespace
+
+// The ring shared by all streams of the reactor thread. Operations prepared while handling events
+// of the loop are submitted right before the loop polls for new events, and completions are
+// handled when the ring signals its eventfd.
+class UringEventLoop {
+ public:
+  static Result<UringEventLoop*> Get(ev::loop_ref* loop) {
+    static thread_local std::unique_ptr<UringEventLoop> instance;
+    if (!instance) {
+      std::unique_ptr<UringEventLoop> result(new UringEventLoop(loop));
+      RETURN_NOT_OK(result->Init());
+      instance = std::move(result);
+    }
+    DCHECK_EQ(instance->raw_loop_, loop->raw_loop);
+    return instance.get();
+  }
+
+  ~UringEventLoop() {
+    event_fd_watcher_.stop();
+    prepare_watcher_.stop();
+
+    // Wait for operations of streams that were shut down, since the kernel could still access
+    // their buffers.
+    if (ring_) {
+      while (ring_->operations_in_flight() != 0) {
+        auto status = ring_->WaitCompletion();
+        if (!status.ok()) {
+          LOG(DFATAL) << "Failed to wait for " << ring_->operations_in_flight()
+                      << " io_uring operations: " << status;
+          break;
+        }
+        ring_->ProcessCompletions();
+      }
+      ring_.reset();
+    }
+    if (event_fd_ >= 0) {
+      close(event_fd_);
+    }
+  }
+
+  IoUring& ring() {
+    return *ring_;
+  }
+
+ private:
+  explicit UringEventLoop(ev::loop_ref* loop) : raw_loop_(loop->raw_loop) {
+    event_fd_watcher_.set(*loop);
+    prepare_watcher_.set(*loop);
+  }
+
+  CHECKED_STATUS Init() {
+    ring_ = VERIFY_RESULT(IoUring::Create(FLAGS_rpc_io_uring_entries));
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0) {
+      int err = errno;
+      return STATUS(NetworkError, "eventfd failed: " + ErrnoToString(err), Slice(), err);
+    }
+    RETURN_NOT_OK(ring_->RegisterEventFd(event_fd_));
+
+    event_fd_watcher_.set<UringEventLoop, &UringEventLoop::EventFdHandler>(this);
+    event_fd_watcher_.start(event_fd_, ev::READ);
+    prepare_watcher_.set<UringEventLoop, &UringEventLoop::PrepareHandler>(this);
+    prepare_watcher_.start();
+    return Status::OK();
+  }
+
+  void EventFdHandler(ev::io& watcher, int revents) { // NOLINT
+    uint64_t value;
+    while (read(event_fd_, &value, sizeof(value)) < 0 && errno == EINTR) {}
+    ring_->ProcessCompletions();
+  }
+
+  void PrepareHandler(ev::prepare& watcher, int revents) { // NOLINT
+    auto status = ring_->Submit();
+    if (!status.ok()) {
+      // Operations stay in the submission queue and are retried on the next loop iteration.
+      YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to submit io_uring operations: " << status;
+    }
+  }
+
+  struct ev_loop* const raw_loop_;
+  std::unique_ptr<IoUring> ring_;
+  int event_fd_ = -1;
+  ev::io event_fd_watcher_;
+  ev::prepare prepare_watcher_;
+};
+
+class UringStream::Operation : public IoUringOperation {
+ public:
+  enum class Type {
+    kConnect,
+    kRead,
+    kWrite,
+  };
+
+  explicit Operation(UringStream* stream) : stream_(stream) {
+    memset(&msg_, 0, sizeof(msg_));
+    msg_.msg_iov = iov_;
+  }
+
+  void Completed(int32_t result) override {
+    in_progress_ = false;
+    if (!stream_) {
+      delete this;
+      return;
+    }
+    switch (type_) {
+      case Type::kConnect:
+        stream_->ConnectCompleted(result);
+        return;
+      case Type::kRead:
+        stream_->ReadCompleted(result);
+        return;
+      case Type::kWrite:
+        stream_->WriteCompleted(result);
+        return;
+    }
+    FATAL_INVALID_ENUM_VALUE(Type, type_);
+  }
+
+  // Called when stream is shut down while this operation is in progress. The operation deletes
+  // itself when completed.
+  void Orphan(std::unique_ptr<GrowableBuffer> buffer, std::shared_ptr<Socket> socket) {
+    stream_ = nullptr;
+    orphaned_buffer_ = std::move(buffer);
+    orphaned_socket_ = std::move(socket);
+  }
+
+  bool in_progress() const {
+    return in_progress_;
+  }
+
+  void Start(Type type) {
+    type_ = type;
+    in_progress_ = true;
+  }
+
+  // Called when the operation could not be prepared.
+  void Abort() {
+    in_progress_ = false;
+    bytes_.clear();
+  }
+
+  iovec* iov() {
+    return iov_;
+  }
+
+  msghdr* msg(size_t iov_len) {
+    msg_.msg_iovlen = iov_len;
+    return &msg_;
+  }
+
+  SendingBytes& bytes() {
+    return bytes_;
+  }
+
+ private:
+  UringStream* stream_;
+  Type type_ = Type::kRead;
+  bool in_progress_ = false;
+  iovec iov_[kMaxIov];
+  msghdr msg_;
+
+  // Keeps data that is being sent alive.
+  SendingBytes bytes_;
+
+  // Read buffer of the shut down stream, that could be accessed by the kernel.
+  std::unique_ptr<GrowableBuffer> orphaned_buffer_;
+
+  // Socket of the shut down stream, closed when the last operation of the stream is completed.
+  std::shared_ptr<Socket> orphaned_socket_;
+};
+
+UringStream::UringStream(
+    const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit)
+    : socket_(std::move(socket)),
+      remote_(remote),
+      read_operation_(new Operation(this)),
+      write_operation_(new Operation(this)),
+      read_buffer_(new GrowableBuffer(allocator, limit)) {
+}
+
+UringStream::~UringStream() {
+  // Must clear the outbound_transfers_ list before deleting.
+  CHECK(sending_.empty()) << ToString();
+
+  // Operations in progress reference the stream, so it should be shut down first.
+  CHECK(!read_operation_ || !read_operation_->in_progress()) << ToString();
+  CHECK(!write_operation_ || !write_operation_->in_progress()) << ToString();
+}
+
+Status UringStream::Start(bool connect, ev::loop_ref* loop, StreamContext* context) {
+  context_ = context;
+  connected_ = !connect;
+
+  RETURN_NOT_OK(socket_.SetNoDelay(true));
+  RETURN_NOT_OK(socket_.SetSendTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+  RETURN_NOT_OK(socket_.SetRecvTimeout(FLAGS_rpc_connection_timeout_ms * 1ms));
+
+  loop_ = VERIFY_RESULT(UringEventLoop::Get(loop));
+
+  if (connect) {
+    auto status = socket_.Connect(remote_);
+    if (!status.ok() && !Socket::IsTemporarySocketError(status)) {
+      LOG_WITH_PREFIX(WARNING) << "Connect failed: " << status;
+      return status;
+    }
+  }
+
+  RETURN_NOT_OK(socket_.GetSocketAddress(&local_));
+  log_prefix_.clear();
+
+  DVLOG_WITH_PREFIX(4) << "Starting, fd: " << socket_.GetFd();
+
+  if (connected_) {
+    context_->Connected();
+  } else {
+    // Socket becomes writable when connection is established or failed.
+    write_operation_->Start(Operation::Type::kConnect);
+    auto status = loop_->ring().PreparePollAdd(
+        socket_.GetFd(), POLLOUT, write_operation_.get());
+    if (!status.ok()) {
+      write_operation_->Abort();
+      return status;
+    }
+    return Status::OK();
+  }
+
+  return DoRead();
+}
+
+void UringStream::Close() {
+  if (socket_.GetFd() >= 0) {
+    auto status = socket_.Shutdown(true, true);
+    LOG_IF(INFO, !status.ok()) << "Failed to shutdown socket: " << status;
+  }
+}
+
+void UringStream::Shutdown(const Status& status) {
+  ClearSending(status);
+
+  if (read_buffer_ && !read_buffer_->empty()) {
+    LOG_WITH_PREFIX(WARNING) << "Shutting down with pending inbound data ("
+                             << *read_buffer_ << ", status = " << status << ")";
+  }
+
+  bool read_in_progress = read_operation_ && read_operation_->in_progress();
+  bool write_in_progress = write_operation_ && write_operation_->in_progress();
+  if (!read_in_progress && !write_in_progress) {
+    WARN_NOT_OK(socket_.Close(), "Error closing socket");
+    return;
+  }
+
+  // Shutdown of the socket completes operations that are still waiting for data or buffer space.
+  if (socket_.GetFd() >= 0) {
+    WARN_NOT_OK(socket_.Shutdown(true, true), "Error shutting down socket");
+  }
+  // Operations in progress could still be in the submission queue, so the kernel resolves their
+  // fd only when the ring is submitted. The socket is closed when they are completed, so the fd
+  // number could not be reused by another file in the meantime.
+  auto socket = std::make_shared<Socket>(std::move(socket_));
+  if (read_in_progress) {
+    read_operation_.release()->Orphan(std::move(read_buffer_), socket);
+  }
+  if (write_in_progress) {
+    write_operation_.release()->Orphan(nullptr, socket);
+  }
+}
+
+Status UringStream::TryWrite() {
+  return DoWrite();
+}
+
+int UringStream::FillIov(iovec* out, SendingBytes* bytes) {
+  int index = 0;
+  size_t offset = send_position_;
+  for (auto& data : sending_) {
+    if (data.skipped || (offset == 0 && data.data && data.data->IsFinished())) {
+      data.skipped = true;
+      continue;
+    }
+    for (const auto& entry : data.bytes) {
+      if (offset >= entry.size()) {
+        offset -= entry.size();
+        continue;
+      }
+
+      out[index].iov_base = entry.data() + offset;
+      out[index].iov_len = entry.size() - offset;
+      bytes->push_back(entry);
+      offset = 0;
+      if (++index == kMaxIov) {
+        return index;
+      }
+    }
+  }
+
+  return index;
+}
+
+Status UringStream::DoWrite() {
+  if (!connected_ || !write_operation_ || write_operation_->in_progress()) {
+    return Status::OK();
+  }
+
+  while (!sending_.empty()) {
+    int iov_len = FillIov(write_operation_->iov(), &write_operation_->bytes());
+    if (iov_len == 0) {
+      // All queued data was skipped.
+      DataSent(0);
+      continue;
+    }
+
+    context_->UpdateLastActivity();
+
+    write_operation_->Start(Operation::Type::kWrite);
+    auto status = loop_->ring().PrepareSendMsg(
+        socket_.GetFd(), write_operation_->msg(iov_len), MSG_NOSIGNAL, write_operation_.get());
+    if (!status.ok()) {
+      write_operation_->Abort();
+      return status;
+    }
+    break;
+  }
+
+  return Status::OK();
+}
+
+void UringStream::DataSent(size_t written) {
+  send_position_ += written;
+  size_t transfers = 0;
+  while (!sending_.empty()) {
+    auto& front = sending_.front();
+    if (front.skipped) {
+      sending_.pop_front();
+      continue;
+    }
+    size_t full_size = front.bytes_size();
+    if (send_position_ < full_size) {
+      break;
+    }
+    auto data = front.data;
+    send_position_ -= full_size;
+    sending_.pop_front();
+    ++transfers;
+    if (data) {
+      context_->Transferred(data, Status::OK());
+    }
+  }
+  context_->DataWritten(written, transfers);
+}
+
+void UringStream::ConnectCompleted(int32_t result) {
+  if (result < 0) {
+    context_->Destroy(STATUS(
+        NetworkError, "Connect failed: " + ErrnoToString(-result), Slice(), -result));
+    return;
+  }
+
+  // Connection errors, reported by POLLERR, are returned by the first send.
+  connected_ = true;
+  context_->Connected();
+  auto status = DoRead();
+  if (status.ok()) {
+    status = DoWrite();
+  }
+  if (!status.ok()) {
+    context_->Destroy(status);
+  }
+}
+
+void UringStream::WriteCompleted(int32_t result) {
+  write_operation_->bytes().clear();
+  if (result < 0 && result != -EAGAIN && result != -EINTR) {
+    auto status = STATUS(
+        NetworkError, "sendmsg error: " + ErrnoToString(-result), Slice(), -result);
+    YB_LOG_WITH_PREFIX_EVERY_N(WARNING, 50) << "Send failed: " << status;
+    context_->Destroy(status);
+    return;
+  }
+
+  if (result > 0) {
+    DataSent(result);
+  }
+  auto status = DoWrite();
+  if (!status.ok()) {
+    context_->Destroy(status);
+  }
+}
+
+Status UringStream::DoRead() {
+  if (read_buffer_full_ || !read_operation_ || read_operation_->in_progress()) {
+    return Status::OK();
+  }
+
+  auto iov = read_buffer_->PrepareAppend();
+  if (!iov.ok()) {
+    if (iov.status().IsBusy()) {
+      read_buffer_full_ = true;
+      return Status::OK();
+    }
+    return iov.status();
+  }
+
+  size_t iov_len = std::min(iov->size(), kMaxIov);
+  std::copy_n(iov->begin(), iov_len, read_operation_->iov());
+  read_operation_->Start(Operation::Type::kRead);
+  auto status = loop_->ring().PrepareRecvMsg(
+      socket_.GetFd(), read_operation_->msg(iov_len), MSG_NOSIGNAL, read_operation_.get());
+  if (!status.ok()) {
+    read_operation_->Abort();
+  }
+  return status;
+}
+
+void UringStream::ReadCompleted(int32_t result) {
+  if (result <= 0 && result != -EAGAIN && result != -EINTR) {
+    if (result == 0) {
+      VLOG_WITH_PREFIX(1) << "Shut down by remote end.";
+      context_->Destroy(STATUS(NetworkError, "Recv() got EOF from remote", Slice(), ESHUTDOWN));
+      return;
+    }
+    auto status = STATUS(
+        NetworkError, "recvmsg error: " + ErrnoToString(-result), Slice(), -result);
+    YB_LOG_WITH_PREFIX_EVERY_N(INFO, 50) << " Recv failed: " << status;
+    context_->Destroy(status);
+    return;
+  }
+
+  if (result > 0) {
+    context_->UpdateLastActivity();
+    read_buffer_->DataAppended(result);
+    auto processed = TryProcessReceived();
+    if (!processed.ok()) {
+      context_->Destroy(processed.status());
+      return;
+    }
+  }
+
+  auto status = DoRead();
+  if (!status.ok()) {
+    context_->Destroy(status);
+  }
+}
+
+void UringStream::ParseReceived() {
+  auto result = TryProcessReceived();
+  if (!result.ok()) {
+    context_->Destroy(result.status());
+    return;
+  }
+  if (read_buffer_full_) {
+    read_buffer_full_ = false;
+    auto status = DoRead();
+    if (!status.ok()) {
+      context_->Destroy(status);
+    }
+  }
+}
+
+Result<bool> UringStream::TryProcessReceived() {
+  if (!read_buffer_ || read_buffer_->empty()) {
+    return false;
+  }
+
+  auto consumed = VERIFY_RESULT(context_->ProcessReceived(
+      read_buffer_->AppendedVecs(), ReadBufferFull(read_buffer_->full())));
+
+  read_buffer_->Consume(consumed);
+  return true;
+}
+
+std::string UringStream::ToString() const {
+  return Format("{ local: $0 remote: $1 }", local_, remote_);
+}
+
+const std::string& UringStream::LogPrefix() const {
+  if (log_prefix_.empty()) {
+    log_prefix_ = ToString() + ": ";
+  }
+  return log_prefix_;
+}
+
+bool UringStream::Idle(std::string* reason_not_idle) {
+  bool result = true;
+  // Check if we're in the middle of receiving something.
+  if (read_buffer_ && !read_buffer_->empty()) {
+    if (reason_not_idle) {
+      AppendWithSeparator("read buffer not empty", reason_not_idle);
+    }
+    result = false;
+  }
+
+  // Check if we still need to send something.
+  if (!sending_.empty()) {
+    if (reason_not_idle) {
+      AppendWithSeparator("still sending", reason_not_idle);
+    }
+    result = false;
+  }
+
+  return result;
+}
+
+void UringStream::ClearSending(const Status& status) {
+  // Clear any outbound transfers.
+  for (auto& data : sending_) {
+    if (data.data) {
+      context_->Transferred(data.data, status);
+    }
+  }
+  sending_.clear();
+}
+
+void UringStream::Send(OutboundDataPtr data) {
+  // Serialize the actual bytes to be put on the wire.
+  sending_.emplace_back(std::move(data));
+}
+
+void UringStream::DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) {
+  auto call_in_flight = resp->add_calls_in_flight();
+  for (auto& entry : sending_) {
+    if (entry.data && entry.data->DumpPB(req, call_in_flight)) {
+      call_in_flight = resp->add_calls_in_flight();
+    }
+  }
+  resp->mutable_calls_in_flight()->DeleteSubrange(resp->calls_in_flight_size() - 1, 1);
+}
+
+const Protocol* UringStream::StaticProtocol() {
+  static Protocol result("uring");
+  return &result;
+}
+
+StreamFactoryPtr UringStream::Factory() {
+  class UringStreamFactory : public StreamFactory {
+   private:
+    std::unique_ptr<Stream> Create(
+        const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit)
+            override {
+      return std::make_unique<UringStream>(remote, std::move(socket), allocator, limit);
+    }
+  };
+
+  return std::make_shared<UringStreamFactory>();
+}
+
+UringStream::SendingData::SendingData(OutboundDataPtr data_) : data(std::move(data_)) {
+  data->Serialize(&bytes);
+}
+
+} // namespace rpc
+} // namespace yb
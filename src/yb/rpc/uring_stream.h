@@ -0,0 +1,144 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_URING_STREAM_H
+#define YB_RPC_URING_STREAM_H
+
+#include <deque>
+
+#include <boost/container/small_vector.hpp>
+
+#include "yb/rpc/growable_buffer.h"
+#include "yb/rpc/stream.h"
+
+#include "yb/util/net/socket.h"
+#include "yb/util/ref_cnt_buffer.h"
+
+namespace yb {
+namespace rpc {
+
+class UringEventLoop;
+
+// Stream over a TCP socket, that sends and receives data using io_uring instead of readiness
+// notifications of the libev loop.
+//
+// Operations of all streams of a reactor are collected in a shared ring and are submitted to the
+// kernel by a single system call per loop iteration.
+//
+// The wire format is the same as the one of TcpStream, so it interoperates with remote TcpStreams.
+// Should be used only when IoUring::IsSupported() returns true.
+class UringStream : public Stream {
+ public:
+  UringStream(
+      const Endpoint& remote, Socket socket, GrowableBufferAllocator* allocator, size_t limit);
+  ~UringStream();
+
+  std::string ToString() const;
+
+  static const rpc::Protocol* StaticProtocol();
+  static StreamFactoryPtr Factory();
+
+ private:
+  class Operation;
+  typedef boost::container::small_vector<RefCntBuffer, 4> SendingBytes;
+
+  CHECKED_STATUS Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
+  void Close() override;
+  void Shutdown(const Status& status) override;
+  void Send(OutboundDataPtr data) override;
+  CHECKED_STATUS TryWrite() override;
+
+  bool Idle(std::string* reason_not_idle) override;
+  bool IsConnected() override { return connected_; }
+  void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
+
+  const Endpoint& Remote() override { return remote_; }
+  const Endpoint& Local() override { return local_; }
+
+  const Protocol* GetProtocol() override {
+    return StaticProtocol();
+  }
+
+  void ParseReceived() override;
+
+  // Prepares send of queued data, if there is no send in progress.
+  CHECKED_STATUS DoWrite();
+  // Prepares receive of data, if there is no receive in progress and read buffer is not full.
+  CHECKED_STATUS DoRead();
+
+  void ConnectCompleted(int32_t result);
+  void WriteCompleted(int32_t result);
+  void ReadCompleted(int32_t result);
+
+  // Removes sent data from the queue, and notifies the context about transferred calls.
+  void DataSent(size_t written);
+  void ClearSending(const Status& status);
+
+  // Try to parse received data and process it.
+  Result<bool> TryProcessReceived();
+
+  const std::string& LogPrefix() const;
+
+  int FillIov(iovec* out, SendingBytes* bytes);
+
+  // The socket we're communicating on.
+  Socket socket_;
+
+  // The remote address we're talking from.
+  Endpoint local_;
+
+  // The remote address we're talking to.
+  const Endpoint remote_;
+
+  StreamContext* context_ = nullptr;
+
+  UringEventLoop* loop_ = nullptr;
+
+  mutable std::string log_prefix_;
+
+  bool connected_ = false;
+
+  // Operations used by this stream, they are passed to the orphaned state if the stream is shut
+  // down while they are in progress.
+  std::unique_ptr<Operation> read_operation_;
+  std::unique_ptr<Operation> write_operation_;
+
+  // Data received on this connection that has not been processed yet.
+  // Could be passed to the orphaned read operation on shutdown, since the kernel could write to it.
+  std::unique_ptr<GrowableBuffer> read_buffer_;
+  bool read_buffer_full_ = false;
+
+  struct SendingData {
+    explicit SendingData(OutboundDataPtr data_);
+
+    size_t bytes_size() const {
+      size_t result = 0;
+      for (const auto& entry : bytes) {
+        result += entry.size();
+      }
+      return result;
+    }
+
+    OutboundDataPtr data;
+    SendingBytes bytes;
+    bool skipped = false;
+  };
+
+  std::deque<SendingData> sending_;
+  size_t send_position_ = 0;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_URING_STREAM_H
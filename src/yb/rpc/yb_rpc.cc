@@ -25,6 +25,7 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/serialization.h"
 
+#include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
@@ -44,6 +45,7 @@ DEFINE_int32(rpc_max_message_size, 255_MB,
              "The maximum size of a message of any RPC that the server will accept.");
 
 using std::placeholders::_1;
+DECLARE_int32(rpc_compression_min_size_bytes);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 
 namespace yb {
@@ -108,7 +110,7 @@ Result<size_t> YBInboundConnectionContext::ProcessCalls(const ConnectionPtr& con
 }
 
 Status YBInboundConnectionContext::HandleCall(
-    const ConnectionPtr& connection, std::vector<char>* call_data) {
+    const ConnectionPtr& connection, CallData* call_data) {
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
@@ -158,15 +160,24 @@ MonoTime YBInboundCall::GetClientDeadline() const {
   return deadline;
 }
 
-Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<char>* call_data) {
+Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, CallData* call_data) {
   TRACE_EVENT_FLOW_BEGIN0("rpc", "YBInboundCall", this);
   TRACE_EVENT0("rpc", "YBInboundCall::ParseFrom");
 
-  consumption_ = ScopedTrackedConsumption(mem_tracker, call_data->size());
-
   request_data_.swap(*call_data);
   Slice source(request_data_.data(), request_data_.size());
-  RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &serialized_request_));
+  Slice body;
+  RETURN_NOT_OK(serialization::ParseYBHeader(source, &header_, &body));
+  if (header_.compression() != CompressionTypePB::NO_COMPRESSION) {
+    CallData decompressed;
+    RETURN_NOT_OK(serialization::DecompressBody(
+        header_.compression(), body, header_.uncompressed_size(), &decompressed));
+    request_data_.swap(decompressed);
+    body = Slice(request_data_.data(), request_data_.size());
+  }
+  RETURN_NOT_OK(serialization::ParseYBBody(body, &serialized_request_));
+
+  consumption_ = ScopedTrackedConsumption(mem_tracker, request_data_.size());
 
   // Adopt the service/method info from the header as soon as it's available.
   if (PREDICT_FALSE(!header_.has_remote_method())) {
@@ -178,6 +189,11 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<ch
   }
   remote_method_.FromPB(header_.remote_method());
 
+  // The call is a span of the caller's trace.
+  if (header_.has_trace_id()) {
+    trace_->StartSpan(header_.trace_id(), header_.parent_span_id());
+  }
+
   return Status::OK();
 }
 
@@ -200,6 +216,14 @@ void YBInboundCall::ResetRpcSidecars() {
   sidecars_.clear();
 }
 
+size_t YBInboundCall::RpcSidecarsSize() const {
+  size_t result = 0;
+  for (const auto& car : sidecars_) {
+    result += car.size();
+  }
+  return result;
+}
+
 Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                               bool is_success) {
   using serialization::SerializeMessage;
@@ -218,6 +242,16 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
 
   int additional_size = absolute_sidecar_offset - protobuf_msg_size;
 
+  response_compressed_ = false;
+  if (header_.accept_compression() == CompressionTypePB::LZ4) {
+    resp_hdr.set_accept_compression(CompressionTypePB::LZ4);
+    auto compressed = SerializeCompressedResponseBuffer(response, additional_size, &resp_hdr);
+    if (!compressed.ok() || *compressed) {
+      response_compressed_ = compressed.ok();
+      return compressed.ok() ? Status::OK() : compressed.status();
+    }
+  }
+
   size_t message_size = 0;
   auto status = SerializeMessage(response,
                                  /* param_buf */ nullptr,
@@ -244,6 +278,42 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
                           header_size);
 }
 
+Result<bool> YBInboundCall::SerializeCompressedResponseBuffer(
+    const google::protobuf::MessageLite& response, int additional_size, ResponseHeader* resp_hdr) {
+  RefCntBuffer message_buf;
+  RETURN_NOT_OK(serialization::SerializeMessage(response,
+                                                &message_buf,
+                                                additional_size,
+                                                /* use_cached_size */ true));
+  const size_t body_size = message_buf.size() + additional_size;
+  if (static_cast<int64_t>(body_size) < FLAGS_rpc_compression_min_size_bytes) {
+    return false;
+  }
+
+  // Sidecars are compressed together with the message, so their offsets stay valid after the
+  // body is decompressed.
+  faststring body;
+  body.reserve(body_size);
+  body.append(message_buf.udata(), message_buf.size());
+  for (const auto& car : sidecars_) {
+    body.append(car.udata(), car.size());
+  }
+
+  faststring compressed;
+  if (!VERIFY_RESULT(serialization::CompressBody(
+          CompressionTypePB::LZ4, Slice(body.data(), body.size()), &compressed))) {
+    return false;
+  }
+
+  resp_hdr->set_compression(CompressionTypePB::LZ4);
+  resp_hdr->set_uncompressed_size(body.size());
+  size_t header_size = 0;
+  RETURN_NOT_OK(serialization::SerializeHeader(
+      *resp_hdr, compressed.size(), &response_buf_, compressed.size(), &header_size));
+  memcpy(response_buf_.udata() + header_size, compressed.data(), compressed.size());
+  return true;
+}
+
 string YBInboundCall::ToString() const {
   return strings::Substitute("Call $0 $1 => $2 (request call id $3)",
       remote_method_.ToString(),
@@ -294,6 +364,10 @@ void YBInboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>*
   TRACE_EVENT0("rpc", "YBInboundCall::Serialize");
   CHECK_GT(response_buf_.size(), 0);
   output->push_back(response_buf_);
+  // Compressed response buffer already contains sidecars.
+  if (response_compressed_) {
+    return;
+  }
   for (auto& car : sidecars_) {
     output->push_back(car);
   }
@@ -374,7 +448,7 @@ void YBInboundCall::Respond(const MessageLite& response, bool is_success) {
 }
 
 Status YBOutboundConnectionContext::HandleCall(
-    const ConnectionPtr& connection, std::vector<char>* call_data) {
+    const ConnectionPtr& connection, CallData* call_data) {
   return connection->HandleCallResponse(call_data);
 }
 
@@ -51,14 +51,14 @@ class YBInboundConnectionContext : public YBConnectionContext {
   static std::string Name() { return "Inbound RPC"; }
  private:
   // Takes ownership of call_data content.
-  CHECKED_STATUS HandleCall(const ConnectionPtr& connection, std::vector<char>* call_data) override;
+  CHECKED_STATUS HandleCall(const ConnectionPtr& connection, CallData* call_data) override;
   void Connected(const ConnectionPtr& connection) override;
   Result<size_t> ProcessCalls(const ConnectionPtr& connection,
                               const IoVecs& data,
                               ReadBufferFull read_buffer_full) override;
 
   // Takes ownership of call_data content.
-  CHECKED_STATUS HandleInboundCall(const ConnectionPtr& connection, std::vector<char>* call_data);
+  CHECKED_STATUS HandleInboundCall(const ConnectionPtr& connection, CallData* call_data);
 
   RpcConnectionPB::StateType State() override { return state_; }
 
@@ -82,7 +82,7 @@ class YBInboundCall : public InboundCall {
   // from the reactor thread.
   //
   // Takes ownership of call_data content.
-  CHECKED_STATUS ParseFrom(const MemTrackerPtr& mem_tracker, std::vector<char>* call_data);
+  CHECKED_STATUS ParseFrom(const MemTrackerPtr& mem_tracker, CallData* call_data);
 
   int32_t call_id() const {
     return header_.call_id();
@@ -98,6 +98,9 @@ class YBInboundCall : public InboundCall {
   // See RpcContext::ResetRpcSidecars()
   void ResetRpcSidecars();
 
+  // See RpcContext::RpcSidecarsSize()
+  size_t RpcSidecarsSize() const;
+
   // Serializes 'response' into the InboundCall's internal buffer, and marks
   // the call as a success. Enqueues the response back to the connection
   // that made the call.
@@ -161,12 +164,21 @@ class YBInboundCall : public InboundCall {
   CHECKED_STATUS SerializeResponseBuffer(const google::protobuf::MessageLite& response,
                                          bool is_success);
 
+  // Serializes the response with sidecars compressed to response_buf_. Returns false when
+  // the response is not worth compressing, in this case response_buf_ is not modified.
+  Result<bool> SerializeCompressedResponseBuffer(const google::protobuf::MessageLite& response,
+                                                 int additional_size,
+                                                 ResponseHeader* resp_hdr);
+
   // The header of the incoming call. Set by ParseFrom()
   RequestHeader header_;
 
   // The buffers for serialized response. Set by SerializeResponseBuffer().
   RefCntBuffer response_buf_;
 
+  // Whether response_buf_ is compressed, in this case it also contains the sidecars.
+  bool response_compressed_ = false;
+
   // Proto service this calls belongs to. Used for routing.
   // This field is filled in when the inbound request header is parsed.
   RemoteMethod remote_method_;
@@ -187,7 +199,7 @@ class YBOutboundConnectionContext : public YBConnectionContext {
   }
 
   // Takes ownership of call_data content.
-  CHECKED_STATUS HandleCall(const ConnectionPtr& connection, std::vector<char>* call_data) override;
+  CHECKED_STATUS HandleCall(const ConnectionPtr& connection, CallData* call_data) override;
   void Connected(const ConnectionPtr& connection) override;
   void AssignConnection(const ConnectionPtr& connection) override;
   Result<size_t> ProcessCalls(const ConnectionPtr& connection,
@@ -236,7 +236,28 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
 
 static void WriteForPrometheus(const MetricRegistry* const metrics,
                                const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
+  MetricPrometheusOptions opts;
+  {
+    string arg = FindWithDefault(req.parsed_args, "aggregation", "table");
+    if (arg == "tablet") {
+      opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kTablet;
+    } else if (arg == "server") {
+      opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kServer;
+    } else {
+      opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kTable;
+    }
+  }
+  const string* entity_types_param = FindOrNull(req.parsed_args, "entity_types");
+  if (entity_types_param != nullptr) {
+    SplitStringUsing(*entity_types_param, ",", &opts.entity_types);
+  }
+  const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
+  if (requested_metrics_param != nullptr) {
+    opts.requested_metrics.clear();
+    SplitStringUsing(*requested_metrics_param, ",", &opts.requested_metrics);
+  }
+
+  PrometheusWriter writer(output, opts);
   WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
 }
 
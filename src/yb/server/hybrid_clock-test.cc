@@ -216,5 +216,49 @@ TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
       MonoDelta::FromMicroseconds(1)));
 }
 
+#if !defined(__APPLE__)
+
+namespace {
+
+void BenchmarkClockReads(const std::string& time_source, int num_reads) {
+  scoped_refptr<HybridClock> clock(new HybridClock(time_source));
+  ASSERT_OK(clock->Init());
+  HybridTime prev = HybridTime::kMin;
+  HybridTime now;
+  uint64_t max_error_usec = 0;
+  auto start = MonoTime::Now();
+  for (int i = 0; i != num_reads; ++i) {
+    clock->NowWithError(&now, &max_error_usec);
+    ASSERT_GT(now, prev);
+    prev = now;
+  }
+  auto elapsed = MonoTime::Now() - start;
+  LOG(INFO) << "Time source '" << time_source << "': "
+            << elapsed.ToNanoseconds() / num_reads << " ns per read, last error "
+            << max_error_usec << " us";
+}
+
+} // namespace
+
+TEST_F(HybridClockTest, ClockReadBenchmark) {
+  constexpr int kNumReads = 1000000;
+  ASSERT_NO_FATALS(BenchmarkClockReads("", kNumReads));
+  ASSERT_NO_FATALS(BenchmarkClockReads("adjtime", kNumReads));
+  ASSERT_NO_FATALS(BenchmarkClockReads("adjtime_cached", kNumReads));
+}
+
+// The cached error bound must never be tighter than the one reported by ntp_adjtime().
+TEST_F(HybridClockTest, CachedAdjTimeClockErrorBound) {
+  for (int i = 0; i != 100; ++i) {
+    auto exact = ASSERT_RESULT(AdjTimeClock()->Now());
+    auto cached = ASSERT_RESULT(CachedAdjTimeClock()->Now());
+    ASSERT_GE(cached.time_point, exact.time_point);
+    ASSERT_GE(cached.max_error, exact.max_error);
+    SleepFor(MonoDelta::FromMilliseconds(5));
+  }
+}
+
+#endif // !defined(__APPLE__)
+
 }  // namespace server
 }  // namespace yb
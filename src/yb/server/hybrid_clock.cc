@@ -63,8 +63,10 @@ METRIC_DEFINE_gauge_uint64(server, hybrid_clock_error,
 
 DEFINE_string(time_source, "",
               "The clock source that HybridClock should use (for tests only). "
-              "Leave empty for WallClock, other values depend on added clock providers and "
-              "specific for appropriate tests, that adds them.");
+              "Leave empty for WallClock. 'adjtime' reads the clock and its error bound through "
+              "ntp_adjtime() on every call, 'adjtime_cached' reads the clock through the vDSO "
+              "and refreshes the ntp_adjtime() error bound periodically. Other values depend on "
+              "added clock providers and specific for appropriate tests, that adds them.");
 TAG_FLAG(time_source, hidden);
 
 using yb::Status;
@@ -82,6 +84,14 @@ PhysicalClockPtr GetClock(const std::string& name) {
   if (name.empty()) {
     return WallClock();
   }
+#if !defined(__APPLE__)
+  if (name == "adjtime") {
+    return AdjTimeClock();
+  }
+  if (name == "adjtime_cached") {
+    return CachedAdjTimeClock();
+  }
+#endif
   std::lock_guard<std::mutex> lock(providers_mutex);
   auto it = providers.find(name);
   if (it == providers.end()) {
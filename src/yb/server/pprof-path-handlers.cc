@@ -67,6 +67,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/status.h"
+#include "yb/util/url-coding.h"
 
 DECLARE_bool(enable_process_lifetime_heap_profiling);
 DECLARE_string(heap_profile_path);
@@ -207,6 +208,31 @@ static void PprofContentionHandler(const Webserver::WebRequest& req, stringstrea
 }
 
 
+const int kContentionDefaultSampleSecs = 10;
+
+// Human readable lock contention profile: symbolized stacks of contended spinlocks,
+// rw_spinlocks and ProfiledMutexes, with the cycles spent waiting at each of them.
+static void ContentionHandler(const Webserver::WebRequest& req, stringstream* output) {
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), kContentionDefaultSampleSecs);
+  int64_t discarded_samples = 0;
+
+  uint64_t contention_micros_before = GetSpinLockContentionMicros();
+  StartSynchronizationProfiling();
+  SleepFor(MonoDelta::FromSeconds(seconds));
+  StopSynchronizationProfiling();
+  uint64_t contention_micros = GetSpinLockContentionMicros() - contention_micros_before;
+  stringstream profile;
+  FlushSynchronizationProfile(&profile, &discarded_samples);
+
+  *output << "<h1>Lock Contention</h1>\n";
+  *output << "<p>Sampled for " << seconds << " seconds, use ?seconds=N to change. "
+          << "Threads spent " << contention_micros << " us waiting for locks. "
+          << "Cycles per second: " << static_cast<int64_t>(base::CyclesPerSecond()) << ". "
+          << "Discarded samples: " << discarded_samples << ".</p>\n";
+  *output << "<pre>" << EscapeForHtmlToString(profile.str()) << "</pre>\n";
+}
+
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
 // formatted like: num_symbols: ###
@@ -269,6 +295,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/contention", "Lock Contention", ContentionHandler, true, false);
 }
 
 } // namespace yb
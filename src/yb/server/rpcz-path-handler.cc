@@ -38,10 +38,13 @@
 #include <string>
 
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_handler_sampler.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/server/webserver.h"
+#include "yb/util/url-coding.h"
 
 namespace yb {
 
@@ -70,11 +73,42 @@ void RpczPathHandler(const shared_ptr<Messenger>& messenger,
   writer.Protobuf(dump_resp);
 }
 
+// Shows the number of samples that found a service thread handling each RPC method. With "raw"
+// the samples are printed in the folded stack format, one "service;method count" line per
+// method, that flame graph tools consume.
+void RpcSamplesPathHandler(const Webserver::WebRequest& req, stringstream* output) {
+  auto samples = rpc::GetRpcHandlerSamples();
+  if (ContainsKey(req.parsed_args, "raw")) {
+    for (const auto& entry : samples) {
+      *output << entry.service_name << ";" << entry.method_name << " " << entry.samples << "\n";
+    }
+    return;
+  }
+
+  int64_t total = 0;
+  for (const auto& entry : samples) {
+    total += entry.samples;
+  }
+  *output << "<h1>RPC Handler Samples</h1>\n";
+  *output << "<p>Total samples: " << total << " (<a href=\"?raw\">folded</a>)</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "<tr><th>Service</th><th>Method</th><th>Samples</th><th>Percent</th></tr>\n";
+  for (const auto& entry : samples) {
+    *output << "<tr><td>" << EscapeForHtmlToString(entry.service_name) << "</td>"
+            << "<td>" << EscapeForHtmlToString(entry.method_name) << "</td>"
+            << "<td>" << entry.samples << "</td>"
+            << "<td>" << StringPrintf("%.2f", 100.0 * entry.samples / total) << "%</td></tr>\n";
+  }
+  *output << "</table>\n";
+}
+
 } // anonymous namespace
 
 void AddRpczPathHandlers(const shared_ptr<Messenger>& messenger, Webserver* webserver) {
   webserver->RegisterPathHandler(
       "/rpcz", "RPCs", std::bind(RpczPathHandler, messenger, _1, _2), false, false);
+  webserver->RegisterPathHandler(
+      "/rpc-samples", "RPC Handler Samples", RpcSamplesPathHandler, true, false);
 }
 
 } // namespace yb
@@ -44,7 +44,9 @@
 #include "yb/gutil/strings/strcat.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
+#include "yb/rpc/io_uring.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/uring_stream.h"
 #include "yb/server/default-path-handlers.h"
 #include "yb/server/generic_service.h"
 #include "yb/server/glog_metrics.h"
@@ -63,6 +65,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/mem_tracker.h"
+#include "yb/util/memory/size_class_pool.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/sockaddr.h"
@@ -76,6 +79,12 @@ DEFINE_int32(num_reactor_threads, -1,
              "Number of libev reactor threads to start. If -1, the value is automatically set.");
 TAG_FLAG(num_reactor_threads, advanced);
 
+DEFINE_bool(rpc_use_io_uring, false,
+            "Use io_uring instead of readiness notifications for RPC connections, when it is "
+            "supported by the kernel.");
+TAG_FLAG(rpc_use_io_uring, advanced);
+TAG_FLAG(rpc_use_io_uring, experimental);
+
 DECLARE_bool(use_hybrid_clock);
 
 DEFINE_int32(generic_svc_num_threads, 10,
@@ -176,6 +185,15 @@ Status RpcServerBase::SetupMessengerBuilder(rpc::MessengerBuilder* builder) {
   builder->set_metric_entity(metric_entity());
   builder->set_connection_keepalive_time(options_.rpc_opts.connection_keepalive_time_ms * 1ms);
 
+  if (FLAGS_rpc_use_io_uring) {
+    if (rpc::IoUring::IsSupported()) {
+      builder->AddStreamFactory(rpc::UringStream::StaticProtocol(), rpc::UringStream::Factory());
+      builder->SetListenProtocol(rpc::UringStream::StaticProtocol());
+    } else {
+      LOG(WARNING) << "io_uring is not supported, using readiness notifications for RPC";
+    }
+  }
+
   return Status::OK();
 }
 
@@ -185,6 +203,7 @@ Status RpcServerBase::Init() {
   glog_metrics_.reset(new ScopedGLogMetrics(metric_entity_));
   tcmalloc::RegisterMetrics(metric_entity_);
   RegisterSpinLockContentionMetrics(metric_entity_);
+  RegisterSizeClassPoolMetrics(metric_entity_);
 
   InitSpinLockContentionProfiling();
 
@@ -24,10 +24,12 @@ CHECKED_STATUS AbstractTablet::HandleQLReadRequest(
     const ReadHybridTime& read_time,
     const QLReadRequestPB& ql_read_request,
     const TransactionOperationContextOpt& txn_op_context,
-    QLReadRequestResult* result) {
+    QLReadRequestResult* result,
+    const docdb::QLParallelScanOptions* parallel_scan_options) {
 
   // TODO(Robert): verify that all key column values are provided
   docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
+  doc_op.SetParallelScanOptions(parallel_scan_options);
 
   // Form a schema of columns that are referenced by this query.
   const Schema &schema = SchemaRef();
@@ -21,6 +21,11 @@
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
+
+namespace docdb {
+struct QLParallelScanOptions;
+}
+
 namespace tablet {
 
 struct QLReadRequestResult {
@@ -91,7 +96,8 @@ class AbstractTablet {
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
       const TransactionOperationContextOpt& txn_op_context,
-      QLReadRequestResult* result);
+      QLReadRequestResult* result,
+      const docdb::QLParallelScanOptions* parallel_scan_options = nullptr);
 
 
   //------------------------------------------------------------------------------------------------
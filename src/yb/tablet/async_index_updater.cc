@@ -0,0 +1,202 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/async_index_updater.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/client/client.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/logging.h"
+
+using namespace std::placeholders;
+
+DEFINE_int32(async_index_update_max_batch_size, 1000,
+             "Max number of eventually consistent index updates written by a tablet in one batch.");
+DEFINE_int32(async_index_update_retry_delay_ms, 1000,
+             "Delay before retrying a batch of eventually consistent index updates that failed to "
+             "be written.");
+
+namespace yb {
+namespace tablet {
+
+AsyncIndexUpdater::AsyncIndexUpdater(std::string log_prefix,
+                                     std::shared_future<client::YBClientPtr> client_future)
+    : log_prefix_(std::move(log_prefix)), client_future_(std::move(client_future)) {
+}
+
+AsyncIndexUpdater::~AsyncIndexUpdater() {
+  Shutdown();
+}
+
+void AsyncIndexUpdater::Enqueue(std::vector<AsyncIndexUpdate> updates) {
+  const auto now = MonoTime::Now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      LOG_WITH_PREFIX(WARNING) << "Dropped " << updates.size() << " index updates after shutdown";
+      return;
+    }
+    for (auto& update : updates) {
+      update.enqueue_time = now;
+      queue_.push_back(std::move(update));
+    }
+    if (running_) {
+      return;
+    }
+    running_ = true;
+  }
+  WriteNextBatch();
+}
+
+void AsyncIndexUpdater::Shutdown() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!shutdown_) {
+    shutdown_ = true;
+    if (!queue_.empty()) {
+      LOG_WITH_PREFIX(WARNING) << "Dropped " << queue_.size() << " pending index updates";
+      queue_.clear();
+    }
+    if (retry_task_id_ != rpc::kUninitializedScheduledTaskId) {
+      client_future_.get()->messenger()->scheduler().Abort(retry_task_id_);
+    }
+  }
+  cond_.wait(lock, [this] { return !running_; });
+}
+
+size_t AsyncIndexUpdater::num_pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size() + batch_.size();
+}
+
+MonoDelta AsyncIndexUpdater::lag() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!batch_.empty()) {
+    return MonoTime::Now() - batch_.front().enqueue_time;
+  }
+  if (!queue_.empty()) {
+    return MonoTime::Now() - queue_.front().enqueue_time;
+  }
+  return MonoDelta::kZero;
+}
+
+void AsyncIndexUpdater::WriteNextBatch() {
+  std::vector<std::shared_ptr<client::YBqlWriteOp>> ops;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      StopUnlocked();
+      return;
+    }
+    // A batch that failed is retried as is, so updates are not reordered.
+    if (batch_.empty()) {
+      const size_t batch_size = std::min<size_t>(
+          queue_.size(), std::max(FLAGS_async_index_update_max_batch_size, 1));
+      batch_.reserve(batch_size);
+      for (size_t i = 0; i != batch_size; ++i) {
+        batch_.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+      if (batch_.empty()) {
+        StopUnlocked();
+        return;
+      }
+    }
+    ops.reserve(batch_.size());
+    for (const auto& update : batch_) {
+      std::shared_ptr<client::YBqlWriteOp> op(update.index_table->NewQLWrite());
+      op->mutable_request()->CopyFrom(update.request);
+      ops.push_back(std::move(op));
+    }
+  }
+
+  auto session = std::make_shared<client::YBSession>(client_future_.get());
+  for (const auto& op : ops) {
+    auto status = session->Apply(op);
+    if (!status.ok()) {
+      BatchWritten(status, session, ops);
+      return;
+    }
+  }
+  session->FlushAsync(std::bind(&AsyncIndexUpdater::BatchWritten, this, _1, session, ops));
+}
+
+void AsyncIndexUpdater::BatchWritten(
+    const Status& status,
+    const client::YBSessionPtr& session,
+    const std::vector<std::shared_ptr<client::YBqlWriteOp>>& ops) {
+  if (PREDICT_FALSE(!status.ok())) {
+    // When any error occurs during the dispatching of YBOperation, YBSession saves the error and
+    // returns IOError. When it happens, use the first saved error instead.
+    Status error = status;
+    if (status.IsIOError()) {
+      for (const auto& pending_error : session->GetPendingErrors()) {
+        error = pending_error->status();
+        break;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      StopUnlocked();
+      return;
+    }
+    LOG_WITH_PREFIX(WARNING) << "Failed to write " << batch_.size() << " index updates, "
+                             << "will retry: " << error;
+    retry_task_id_ = client_future_.get()->messenger()->scheduler().Schedule(
+        std::bind(&AsyncIndexUpdater::Retry, this, _1),
+        std::chrono::milliseconds(FLAGS_async_index_update_retry_delay_ms));
+    return;
+  }
+
+  // Updates rejected by the index tablet are not retried, since they would fail the same way and
+  // block all updates behind them.
+  for (const auto& op : ops) {
+    if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      LOG_WITH_PREFIX(WARNING) << "Index update rejected: " << op->response().ShortDebugString();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_.clear();
+  }
+  WriteNextBatch();
+}
+
+void AsyncIndexUpdater::Retry(const Status& status) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retry_task_id_ = rpc::kUninitializedScheduledTaskId;
+    if (!status.ok() || shutdown_) {
+      StopUnlocked();
+      return;
+    }
+  }
+  WriteNextBatch();
+}
+
+void AsyncIndexUpdater::StopUnlocked() {
+  batch_.clear();
+  running_ = false;
+  cond_.notify_all();
+}
+
+} // namespace tablet
+} // namespace yb
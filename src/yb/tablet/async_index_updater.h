@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_ASYNC_INDEX_UPDATER_H
+#define YB_TABLET_ASYNC_INDEX_UPDATER_H
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/common/ql_protocol.pb.h"
+
+#include "yb/rpc/scheduler.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tablet {
+
+// Update of an index table that is written after the write to the indexed table has completed.
+struct AsyncIndexUpdate {
+  client::YBTablePtr index_table;
+  QLWriteRequestPB request;
+  MonoTime enqueue_time;
+};
+
+// Writes updates of eventually consistent indexes of a tablet in the background, so writes to the
+// indexed table do not wait for them. Updates are written in batches, one batch at a time, in the
+// order they were enqueued. So updates of the same index row are applied in the same order as the
+// writes to the indexed table they were derived from. A batch that fails to be delivered is
+// retried until it succeeds or the updater is shut down.
+//
+// Pending updates are kept in memory only and are lost if the tablet server restarts or the tablet
+// is shut down, until the index is rebuilt.
+class AsyncIndexUpdater {
+ public:
+  AsyncIndexUpdater(std::string log_prefix, std::shared_future<client::YBClientPtr> client_future);
+
+  ~AsyncIndexUpdater();
+
+  // Enqueues updates to be written in the background.
+  void Enqueue(std::vector<AsyncIndexUpdate> updates);
+
+  // Stops writing updates and waits for the batch being written, if any. Updates that were not
+  // written yet are dropped.
+  void Shutdown();
+
+  // Number of enqueued updates that are not written yet, including the batch being written.
+  size_t num_pending() const;
+
+  // Time since the oldest pending update was enqueued, or zero if there are no pending updates.
+  MonoDelta lag() const;
+
+ private:
+  // Takes the next batch of updates and writes it, unless there is nothing to write.
+  void WriteNextBatch();
+
+  void BatchWritten(const Status& status,
+                    const client::YBSessionPtr& session,
+                    const std::vector<std::shared_ptr<client::YBqlWriteOp>>& ops);
+
+  void Retry(const Status& status);
+
+  // Drops the current batch and marks the updater idle. Called with mutex_ held.
+  void StopUnlocked();
+
+  const std::string& LogPrefix() const { return log_prefix_; }
+
+  const std::string log_prefix_;
+  const std::shared_future<client::YBClientPtr> client_future_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<AsyncIndexUpdate> queue_;
+  // The batch being written or waiting to be retried. Always empty when not running_.
+  std::vector<AsyncIndexUpdate> batch_;
+  bool running_ = false;
+  bool shutdown_ = false;
+  rpc::ScheduledTaskId retry_task_id_ = rpc::kUninitializedScheduledTaskId;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_ASYNC_INDEX_UPDATER_H
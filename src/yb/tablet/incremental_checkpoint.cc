@@ -0,0 +1,243 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/incremental_checkpoint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/strings/util.h"
+#include "yb/rocksdb/rate_limiter.h"
+#include "yb/util/env.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(checkpoint_upload_threads, 4,
+             "Number of threads copying the files of a checkpoint during upload.");
+
+DEFINE_int64(checkpoint_upload_rate_limit_bytes_per_sec, 0,
+             "Limit on the total rate at which checkpoint files are uploaded, 0 for no limit.");
+
+namespace yb {
+namespace tablet {
+
+const char kCheckpointManifestFileName[] = "CHECKPOINT_MANIFEST";
+
+namespace {
+
+const size_t kUploadChunkSize = 1_MB;
+
+// SST files are never modified after they are written, so a file with the same name and size in
+// two checkpoints of the same tablet has the same content. That also holds for the data files of
+// split SSTs (<number>.sst.sblock.<n>) and for blob files (<number>.blob).
+bool IsImmutableFile(const std::string& name) {
+  return HasSuffixString(name, ".sst") || name.find(".sst.sblock.") != std::string::npos ||
+         HasSuffixString(name, ".blob");
+}
+
+// Lists the files under dir recursively, with paths relative to dir.
+Status ListFiles(Env* env, const std::string& dir, const std::string& prefix,
+                 std::vector<std::string>* result) {
+  auto children = VERIFY_RESULT(env->GetChildren(dir, ExcludeDots::kTrue));
+  std::sort(children.begin(), children.end());
+  for (const auto& child : children) {
+    const auto path = JoinPathSegments(dir, child);
+    const auto name = prefix.empty() ? child : JoinPathSegments(prefix, child);
+    if (VERIFY_RESULT(env->IsDirectory(path))) {
+      RETURN_NOT_OK(ListFiles(env, path, name, result));
+    } else if (name != kCheckpointManifestFileName) {
+      result->push_back(name);
+    }
+  }
+  return Status::OK();
+}
+
+Status UploadFile(Env* env, const std::string& source_path, const std::string& dest_path,
+                  uint64_t size, rocksdb::RateLimiter* rate_limiter) {
+  if (env->FileExists(dest_path) && VERIFY_RESULT(env->GetFileSize(dest_path)) == size) {
+    // Uploaded by an earlier attempt that did not complete.
+    return Status::OK();
+  }
+
+  gscoped_ptr<SequentialFile> source;
+  RETURN_NOT_OK(env->NewSequentialFile(source_path, &source));
+  // Write under a temporary name, so a partially copied file is never taken for a complete one.
+  const auto temp_path = dest_path + ".tmp";
+  gscoped_ptr<WritableFile> dest;
+  RETURN_NOT_OK(env->NewWritableFile(temp_path, &dest));
+
+  size_t chunk_size = kUploadChunkSize;
+  if (rate_limiter) {
+    chunk_size = std::min<size_t>(chunk_size, rate_limiter->GetSingleBurstBytes());
+  }
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[chunk_size]);
+  uint64_t copied = 0;
+  while (copied < size) {
+    const auto bytes = std::min<uint64_t>(size - copied, chunk_size);
+    if (rate_limiter) {
+      rate_limiter->Request(bytes, rocksdb::Env::IO_LOW);
+    }
+    Slice data;
+    RETURN_NOT_OK(source->Read(bytes, &data, scratch.get()));
+    if (data.empty()) {
+      return STATUS_FORMAT(Corruption, "$0 is shorter than expected: $1 of $2 bytes",
+                           source_path, copied, size);
+    }
+    RETURN_NOT_OK(dest->Append(data));
+    copied += data.size();
+  }
+  RETURN_NOT_OK(dest->Sync());
+  RETURN_NOT_OK(dest->Close());
+  return env->RenameFile(temp_path, dest_path);
+}
+
+} // namespace
+
+Result<CheckpointManifestPB> BuildCheckpointManifest(
+    Env* env, const std::string& dir, const std::string& checkpoint_id,
+    const CheckpointManifestPB* base) {
+  std::unordered_map<std::string, const CheckpointManifestPB::FilePB*> base_files;
+  if (base) {
+    for (const auto& file : base->files()) {
+      base_files.emplace(file.name(), &file);
+    }
+  }
+
+  std::vector<std::string> names;
+  RETURN_NOT_OK(ListFiles(env, dir, std::string(), &names));
+
+  CheckpointManifestPB manifest;
+  manifest.set_checkpoint_id(checkpoint_id);
+  if (base) {
+    manifest.set_base_checkpoint_id(base->checkpoint_id());
+  }
+  uint64_t reused_bytes = 0;
+  uint64_t new_bytes = 0;
+  for (const auto& name : names) {
+    auto& file = *manifest.add_files();
+    file.set_name(name);
+    file.set_size_bytes(VERIFY_RESULT(env->GetFileSize(JoinPathSegments(dir, name))));
+    auto it = base_files.find(name);
+    if (IsImmutableFile(name) && it != base_files.end() &&
+        it->second->size_bytes() == file.size_bytes()) {
+      file.set_owner_checkpoint_id(it->second->owner_checkpoint_id());
+      reused_bytes += file.size_bytes();
+    } else {
+      file.set_owner_checkpoint_id(checkpoint_id);
+      new_bytes += file.size_bytes();
+    }
+  }
+  VLOG(1) << "Checkpoint " << checkpoint_id << " in " << dir << ": " << new_bytes
+          << " new bytes, " << reused_bytes << " bytes shared with earlier checkpoints";
+  return manifest;
+}
+
+Status WriteCheckpointManifest(
+    Env* env, const std::string& dir, const CheckpointManifestPB& manifest) {
+  return pb_util::WritePBContainerToPath(
+      env, JoinPathSegments(dir, kCheckpointManifestFileName), manifest, pb_util::OVERWRITE,
+      pb_util::SYNC);
+}
+
+Result<CheckpointManifestPB> ReadCheckpointManifest(Env* env, const std::string& dir) {
+  CheckpointManifestPB manifest;
+  RETURN_NOT_OK(pb_util::ReadPBContainerFromPath(
+      env, JoinPathSegments(dir, kCheckpointManifestFileName), &manifest));
+  return manifest;
+}
+
+Status UploadCheckpoint(
+    Env* env, const std::string& dir, const CheckpointManifestPB& manifest,
+    const std::string& dest_root) {
+  const auto dest_dir = JoinPathSegments(dest_root, manifest.checkpoint_id());
+  std::vector<const CheckpointManifestPB::FilePB*> files;
+  for (const auto& file : manifest.files()) {
+    if (file.owner_checkpoint_id() == manifest.checkpoint_id()) {
+      files.push_back(&file);
+      RETURN_NOT_OK(env->CreateDirs(DirName(JoinPathSegments(dest_dir, file.name()))));
+    }
+  }
+  // Start with the largest files, so they do not end up being copied by a single thread at the end.
+  std::sort(files.begin(), files.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->size_bytes() > rhs->size_bytes();
+  });
+
+  std::unique_ptr<rocksdb::RateLimiter> rate_limiter;
+  if (FLAGS_checkpoint_upload_rate_limit_bytes_per_sec > 0) {
+    rate_limiter.reset(rocksdb::NewGenericRateLimiter(
+        FLAGS_checkpoint_upload_rate_limit_bytes_per_sec));
+  }
+
+  std::atomic<size_t> next_file{0};
+  std::mutex mutex;
+  Status result;
+  auto upload = [&] {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!result.ok()) {
+          return;
+        }
+      }
+      const auto idx = next_file.fetch_add(1, std::memory_order_acq_rel);
+      if (idx >= files.size()) {
+        return;
+      }
+      const auto& file = *files[idx];
+      auto status = UploadFile(
+          env, JoinPathSegments(dir, file.name()), JoinPathSegments(dest_dir, file.name()),
+          file.size_bytes(), rate_limiter.get());
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status.CloneAndPrepend(Format("Failed to upload $0", file.name()));
+        }
+        return;
+      }
+    }
+  };
+
+  const auto num_threads = std::max(
+      1, std::min<int>(FLAGS_checkpoint_upload_threads, files.size()));
+  std::vector<scoped_refptr<Thread>> threads(num_threads);
+  for (auto& thread : threads) {
+    auto status = Thread::Create("checkpoint", "upload", upload, &thread);
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      result = status;
+      break;
+    }
+  }
+  for (auto& thread : threads) {
+    if (thread) {
+      RETURN_NOT_OK(ThreadJoiner(thread.get()).Join());
+    }
+  }
+  RETURN_NOT_OK(result);
+
+  // The manifest is written last, so an upload is complete when the manifest is present.
+  return WriteCheckpointManifest(env, dest_dir, manifest);
+}
+
+} // namespace tablet
+} // namespace yb
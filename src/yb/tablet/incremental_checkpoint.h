@@ -0,0 +1,57 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_INCREMENTAL_CHECKPOINT_H
+#define YB_TABLET_INCREMENTAL_CHECKPOINT_H
+
+#include <string>
+
+#include "yb/tablet/tablet.pb.h"
+
+#include "yb/util/result.h"
+
+namespace yb {
+
+class Env;
+
+namespace tablet {
+
+// Name of the manifest file written into the checkpoint directory.
+extern const char kCheckpointManifestFileName[];
+
+// Builds the manifest of the checkpoint in dir. SST files that have the same name and size as a
+// file of the base manifest are the same immutable file, so they keep the owner recorded by the
+// base. All other files are owned by checkpoint_id. When base is null all files are owned by
+// checkpoint_id, i.e. the checkpoint is a full one.
+Result<CheckpointManifestPB> BuildCheckpointManifest(
+    Env* env, const std::string& dir, const std::string& checkpoint_id,
+    const CheckpointManifestPB* base);
+
+CHECKED_STATUS WriteCheckpointManifest(
+    Env* env, const std::string& dir, const CheckpointManifestPB& manifest);
+
+Result<CheckpointManifestPB> ReadCheckpointManifest(Env* env, const std::string& dir);
+
+// Copies the files of the checkpoint in dir that are owned by it to
+// <dest_root>/<checkpoint_id>/, followed by the manifest. Files owned by earlier checkpoints are
+// expected to be in <dest_root>/<owner_checkpoint_id>/ already. The copy uses
+// --checkpoint_upload_threads threads and is limited to
+// --checkpoint_upload_rate_limit_bytes_per_sec. dest_root could be a mount of an object store.
+CHECKED_STATUS UploadCheckpoint(
+    Env* env, const std::string& dir, const CheckpointManifestPB& manifest,
+    const std::string& dest_root);
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_INCREMENTAL_CHECKPOINT_H
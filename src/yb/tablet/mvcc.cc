@@ -34,6 +34,7 @@
 
 #include <sstream>
 
+#include "yb/util/atomic.h"
 #include "yb/util/logging.h"
 
 namespace yb {
@@ -64,6 +65,7 @@ void MvccManager::Replicated(HybridTime ht) {
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
     PopFront(&lock);
     last_replicated_ = ht;
+    PublishUnlocked();
   }
   cond_.notify_all();
 }
@@ -97,6 +99,12 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
   }
 }
 
+void MvccManager::PublishUnlocked() {
+  published_last_replicated_.store(last_replicated_.ToUint64(), std::memory_order_release);
+  published_propagated_safe_time_.store(
+      propagated_safe_time_.ToUint64(), std::memory_order_release);
+}
+
 void MvccManager::AddPending(HybridTime* ht) {
   const bool is_follower_side = ht->is_valid();
   std::lock_guard<std::mutex> lock(mutex_);
@@ -135,6 +143,8 @@ void MvccManager::AddPending(HybridTime* ht) {
           max_safe_time_returned_with_lease_.safe_time,
           max_safe_time_returned_without_lease_.safe_time,
           max_safe_time_returned_for_follower_.safe_time,
+          HybridTime(max_safe_time_returned_for_follower_lock_free_.load(
+              std::memory_order_acquire)),
           last_replicated_,
           last_ht_in_queue});
 
@@ -199,6 +209,7 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
   {
     std::lock_guard<std::mutex> lock(mutex_);
     last_replicated_ = ht;
+    PublishUnlocked();
   }
   cond_.notify_all();
 }
@@ -210,6 +221,7 @@ void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (ht >= propagated_safe_time_) {
       propagated_safe_time_ = ht;
+      PublishUnlocked();
     } else {
       LOG(WARNING) << "Received propagated safe time " << ht << " less than the old value: "
                    << propagated_safe_time_ << ". This could happen on followers when a new leader "
@@ -233,6 +245,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
     // in here should keep increasing, so we should not see propagated_safe_time_ going backwards.
     CHECK_GE(ht, propagated_safe_time_) << LogPrefix();
     propagated_safe_time_ = ht;
+    PublishUnlocked();
 #else
     // Do not crash in production.
     if (ht < propagated_safe_time_) {
@@ -241,6 +254,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
           << ", but now safe time is " << ht;
     } else {
       propagated_safe_time_ = ht;
+      PublishUnlocked();
     }
 #endif
   }
@@ -249,6 +263,19 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(HybridTime ht_lease) {
 
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, MonoTime deadline) const {
+  {
+    // Fast path. The same result as the predicate below, computed from the published values.
+    auto result = std::max(
+        HybridTime(published_propagated_safe_time_.load(std::memory_order_acquire)),
+        HybridTime(published_last_replicated_.load(std::memory_order_acquire)));
+    if (result >= min_allowed) {
+      UpdateAtomicMax(&max_safe_time_returned_for_follower_lock_free_, result.ToUint64());
+      VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
+                          << "), lock-free result = " << result;
+      return result;
+    }
+  }
+
   std::unique_lock<std::mutex> lock(mutex_);
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
@@ -356,9 +383,9 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 }
 
 HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
-  return last_replicated_;
+  HybridTime result(published_last_replicated_.load(std::memory_order_acquire));
+  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+  return result;
 }
 
 }  // namespace tablet
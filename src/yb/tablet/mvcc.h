@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -120,9 +121,10 @@ class MvccManager {
     return SafeTime(HybridTime::kMin /* min_allowed */, MonoTime::kMax /* deadline */, ht_lease);
   }
 
+  // Does not take the mutex when the safe time already satisfies `min_allowed`.
   HybridTime SafeTimeForFollower(HybridTime min_allowed, MonoTime deadline) const;
 
-  // Returns time of last replicated operation.
+  // Returns time of last replicated operation. Does not take the mutex.
   HybridTime LastReplicatedHybridTime() const;
 
  private:
@@ -134,6 +136,10 @@ class MvccManager {
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
+  // Publishes the current values of last_replicated_ and propagated_safe_time_ for lock-free
+  // readers. Should be called with mutex_ held after updating them.
+  void PublishUnlocked();
+
   std::string prefix_;
   server::ClockPtr clock_;
   mutable std::mutex mutex_;
@@ -161,6 +167,15 @@ class MvccManager {
   mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
+
+  // Values of last_replicated_ and propagated_safe_time_ published by PublishUnlocked. Both only
+  // grow, so a reader that sees a value that is high enough does not need the mutex.
+  std::atomic<uint64_t> published_last_replicated_{kMinHybridTimeValue};
+  std::atomic<uint64_t> published_propagated_safe_time_{kMinHybridTimeValue};
+
+  // Maximum follower safe time returned without taking the mutex. Used for sanity checks only.
+  mutable std::atomic<uint64_t> max_safe_time_returned_for_follower_lock_free_{
+      kMinHybridTimeValue};
 };
 
 }  // namespace tablet
@@ -445,12 +445,23 @@ void OperationDriver::ApplyTask(int64_t leader_term) {
   // and end up calling Finalize() while we're still in this code.
   scoped_refptr<OperationDriver> ref(this);
 
-  {
+  auto apply = [this, leader_term] {
     CHECK_OK(operation_->Apply(leader_term));
-
+  };
+  auto complete = [this, ref] {
     operation_->PreCommit();
 
     Finalize();
+  };
+
+  // On followers the tablet could defer completion until the writes of a batch of committed
+  // operations are written to RocksDB together.
+  Tablet* tablet = operation_->state()->tablet();
+  if (tablet) {
+    tablet->ApplyOperation(operation_type() == OperationType::kWrite, apply, std::move(complete));
+  } else {
+    apply();
+    complete();
   }
 }
 
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <memory>
@@ -23,13 +24,49 @@
 #include "yb/consensus/consensus.h"
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/lockfree.h"
 
+using namespace yb::size_literals;
+
 DEFINE_int32(max_group_replicate_batch_size, 16,
              "Maximum number of operations to submit to consensus for replication in a batch.");
 
+DEFINE_int32(max_group_replicate_batch_size_under_load, 128,
+             "When more operations than max_group_replicate_batch_size are waiting to be "
+             "prepared, batches are allowed to grow with the number of waiting operations up to "
+             "this size.");
+TAG_FLAG(max_group_replicate_batch_size_under_load, advanced);
+TAG_FLAG(max_group_replicate_batch_size_under_load, runtime);
+
+DEFINE_int64(max_group_replicate_batch_bytes, 4_MB,
+             "A batch of operations submitted to consensus for replication is closed once the "
+             "total size of its replicate messages reaches this limit. 0 means no limit.");
+TAG_FLAG(max_group_replicate_batch_bytes, advanced);
+TAG_FLAG(max_group_replicate_batch_bytes, runtime);
+
+DEFINE_int32(max_group_replicate_batch_delay_us, 1000,
+             "A batch of operations submitted to consensus for replication is closed once its "
+             "first operation has waited this long for the batch to fill. 0 means no limit.");
+TAG_FLAG(max_group_replicate_batch_delay_us, advanced);
+TAG_FLAG(max_group_replicate_batch_delay_us, runtime);
+
+METRIC_DEFINE_histogram(tablet, group_replicate_batch_size, "Group Replicate Batch Size",
+                        yb::MetricUnit::kOperations,
+                        "Number of leader-side operations prepared and submitted to consensus for "
+                        "replication in one batch.",
+                        10000, 2);
+METRIC_DEFINE_histogram(tablet, group_replicate_batch_wait_time, "Group Replicate Batch Wait Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds the first operation of a batch waited for the batch to fill "
+                        "before it was prepared.",
+                        60000000LU, 2);
+
 using std::vector;
 
 namespace yb {
@@ -43,7 +80,8 @@ namespace tablet {
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -88,6 +126,14 @@ class PreparerImpl {
 
   OperationDrivers leader_side_batch_;
 
+  // Total size of the replicate messages of leader_side_batch_, and the time when its first
+  // operation was added.
+  int64_t leader_side_batch_bytes_ = 0;
+  CoarseTimePoint leader_side_batch_start_;
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> batch_wait_time_histogram_;
+
   std::unique_ptr<ThreadPoolToken> tablet_prepare_pool_token_;
 
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
@@ -98,6 +144,9 @@ class PreparerImpl {
 
   void ProcessAndClearLeaderSideBatch();
 
+  // Returns true if leader_side_batch_ has to be processed before another operation is added.
+  bool LeaderSideBatchIsFull() const;
+
   // A wrapper around ProcessAndClearLeaderSideBatch that assumes we are currently holding the
   // mutex.
 
@@ -106,10 +155,15 @@ class PreparerImpl {
 };
 
 PreparerImpl::PreparerImpl(consensus::Consensus* consensus,
-                                     ThreadPool* tablet_prepare_pool)
+                                     ThreadPool* tablet_prepare_pool,
+                                     const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
       tablet_prepare_pool_token_(tablet_prepare_pool
                                      ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_group_replicate_batch_size.Instantiate(metric_entity);
+    batch_wait_time_histogram_ = METRIC_group_replicate_batch_wait_time.Instantiate(metric_entity);
+  }
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -199,12 +253,18 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
     // Don't add more than the max number of operations to a batch, and also don't add
     // operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
-    if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
+    if (LeaderSideBatchIsFull() ||
         (!leader_side_batch_.empty() &&
             bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
       ProcessAndClearLeaderSideBatch();
     }
+    if (leader_side_batch_.empty()) {
+      leader_side_batch_start_ = CoarseMonoClock::Now();
+    }
     leader_side_batch_.push_back(item);
+    if (FLAGS_max_group_replicate_batch_bytes > 0) {
+      leader_side_batch_bytes_ += item->consensus_round()->replicate_msg()->ByteSize();
+    }
     if (apply_separately) {
       ProcessAndClearLeaderSideBatch();
     }
@@ -216,6 +276,34 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   }
 }
 
+bool PreparerImpl::LeaderSideBatchIsFull() const {
+  if (leader_side_batch_.empty()) {
+    return false;
+  }
+
+  // While the queue is shallow the batch is closed as soon as the queue is drained, so the static
+  // limit is enough. Under load let the batch grow with the number of waiting operations to
+  // amortize the per-batch consensus overhead.
+  const int64_t waiting = active_tasks_.load(std::memory_order_acquire);
+  int64_t max_size = FLAGS_max_group_replicate_batch_size;
+  if (waiting > max_size) {
+    max_size = std::max<int64_t>(
+        max_size, std::min<int64_t>(waiting, FLAGS_max_group_replicate_batch_size_under_load));
+  }
+  if (static_cast<int64_t>(leader_side_batch_.size()) >= max_size) {
+    return true;
+  }
+
+  if (FLAGS_max_group_replicate_batch_bytes > 0 &&
+      leader_side_batch_bytes_ >= FLAGS_max_group_replicate_batch_bytes) {
+    return true;
+  }
+
+  return FLAGS_max_group_replicate_batch_delay_us > 0 &&
+         CoarseMonoClock::Now() - leader_side_batch_start_ >=
+             std::chrono::microseconds(FLAGS_max_group_replicate_batch_delay_us);
+}
+
 void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   if (leader_side_batch_.empty()) {
     return;
@@ -223,6 +311,12 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
 
   VLOG(2) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
 
+  if (batch_size_histogram_) {
+    batch_size_histogram_->Increment(leader_side_batch_.size());
+    batch_wait_time_histogram_->Increment(
+        ToMicroseconds(CoarseMonoClock::Now() - leader_side_batch_start_));
+  }
+
   auto iter = leader_side_batch_.begin();
   auto replication_subbatch_begin = iter;
   auto replication_subbatch_end = iter;
@@ -253,6 +347,7 @@ void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   ReplicateSubBatch(replication_subbatch_begin, replication_subbatch_end);
 
   leader_side_batch_.clear();
+  leader_side_batch_bytes_ = 0;
 }
 
 void PreparerImpl::ReplicateSubBatch(
@@ -295,8 +390,9 @@ void PreparerImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -16,6 +16,7 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/gutil/ref_counted.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 
@@ -23,6 +24,7 @@ DECLARE_int32(max_group_replicate_batch_size);
 DECLARE_int32(prepare_queue_max_size);
 
 namespace yb {
+class MetricEntity;
 class ThreadPool;
 
 namespace consensus {
@@ -39,9 +41,11 @@ class PreparerImpl;
 // leader-side transactions, submits them for replication to the consensus in batches. This is
 // useful because we have a "fat lock" in the consensus.
 // Preparer does not manage a thread but only submits to a token in a thread pool.
+// Batch size and wait time histograms are registered on 'metric_entity' if it is not null.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity);
   ~Preparer();
 
   CHECKED_STATUS Start();
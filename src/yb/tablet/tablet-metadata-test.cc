@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <thread>
+
 #include <glog/logging.h>
 
 #include "yb/common/schema.h"
@@ -40,6 +42,8 @@
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet-test-util.h"
 
+DECLARE_int32(tablet_metadata_flush_coalesce_delay_ms);
+
 namespace yb {
 namespace tablet {
 
@@ -108,6 +112,52 @@ TEST_F(TestTabletMetadata, TestLoadFromSuperBlock) {
             << superblock_pb_1.DebugString();
 }
 
+TEST_F(TestTabletMetadata, FlushSkipsUnchangedSuperBlock) {
+  TabletMetadata* meta = harness_->tablet()->metadata();
+  ASSERT_OK(meta->Flush());
+  auto writes = meta->num_superblock_writes();
+
+  // Nothing changed since the last flush.
+  ASSERT_OK(meta->Flush());
+  ASSERT_EQ(writes, meta->num_superblock_writes());
+
+  meta->set_tablet_data_state(TABLET_DATA_TOMBSTONED);
+  ASSERT_OK(meta->Flush());
+  ASSERT_EQ(writes + 1, meta->num_superblock_writes());
+
+  TabletSuperBlockPB superblock;
+  ASSERT_OK(meta->ReadSuperBlockFromDisk(&superblock));
+  ASSERT_EQ(TABLET_DATA_TOMBSTONED, superblock.tablet_data_state());
+  meta->set_tablet_data_state(TABLET_DATA_READY);
+}
+
+TEST_F(TestTabletMetadata, ConcurrentFlushesAreCoalesced) {
+  FLAGS_tablet_metadata_flush_coalesce_delay_ms = 100;
+  TabletMetadata* meta = harness_->tablet()->metadata();
+  ASSERT_OK(meta->Flush());
+  auto writes = meta->num_superblock_writes();
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([meta, i] {
+      meta->set_tablet_data_state(
+          i % 2 ? TABLET_DATA_TOMBSTONED : TABLET_DATA_READY);
+      ASSERT_OK(meta->Flush());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_LT(meta->num_superblock_writes() - writes, kNumThreads);
+
+  // Whatever state won, it is the one on disk.
+  TabletSuperBlockPB superblock;
+  ASSERT_OK(meta->ReadSuperBlockFromDisk(&superblock));
+  ASSERT_EQ(meta->tablet_data_state(), superblock.tablet_data_state());
+  meta->set_tablet_data_state(TABLET_DATA_READY);
+}
+
 
 } // namespace tablet
 } // namespace yb
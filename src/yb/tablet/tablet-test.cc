@@ -39,9 +39,12 @@
 
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/util.h"
+#include "yb/tablet/incremental_checkpoint.h"
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet-test-base.h"
+#include "yb/util/path_util.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
 
@@ -214,5 +217,52 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+TYPED_TEST(TestTablet, TestIncrementalCheckpoint) {
+  auto tablet = this->tablet().get();
+  auto env = this->env_.get();
+  const auto checkpoints_dir = this->GetTestPath("checkpoints");
+  const auto upload_dir = this->GetTestPath("upload");
+
+  this->InsertTestRows(0, 1000, 0);
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  auto first = ASSERT_RESULT(tablet->CreateIncrementalCheckpoint(
+      JoinPathSegments(checkpoints_dir, "1"), "1", nullptr /* base */));
+  ASSERT_OK(UploadCheckpoint(env, JoinPathSegments(checkpoints_dir, "1"), first, upload_dir));
+  for (const auto& file : first.files()) {
+    ASSERT_EQ("1", file.owner_checkpoint_id());
+    ASSERT_TRUE(env->FileExists(JoinPathSegments(upload_dir, "1", file.name())));
+  }
+
+  this->InsertTestRows(1000, 1000, 0);
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  auto second = ASSERT_RESULT(tablet->CreateIncrementalCheckpoint(
+      JoinPathSegments(checkpoints_dir, "2"), "2", &first));
+  ASSERT_EQ("1", second.base_checkpoint_id());
+  auto read_back = ASSERT_RESULT(
+      ReadCheckpointManifest(env, JoinPathSegments(checkpoints_dir, "2")));
+  ASSERT_EQ(second.ShortDebugString(), read_back.ShortDebugString());
+
+  ASSERT_OK(UploadCheckpoint(env, JoinPathSegments(checkpoints_dir, "2"), second, upload_dir));
+  int shared_files = 0;
+  int new_sst_files = 0;
+  for (const auto& file : second.files()) {
+    const bool uploaded = env->FileExists(JoinPathSegments(upload_dir, "2", file.name()));
+    if (file.owner_checkpoint_id() == "1") {
+      ++shared_files;
+      ASSERT_FALSE(uploaded) << file.name();
+      ASSERT_TRUE(env->FileExists(JoinPathSegments(upload_dir, "1", file.name())));
+    } else {
+      ASSERT_EQ("2", file.owner_checkpoint_id());
+      ASSERT_TRUE(uploaded) << file.name();
+      if (HasSuffixString(file.name(), ".sst")) {
+        ++new_sst_files;
+      }
+    }
+  }
+  ASSERT_GT(shared_files, 0);
+  ASSERT_GT(new_sst_files, 0);
+  ASSERT_TRUE(env->FileExists(JoinPathSegments(upload_dir, "2", kCheckpointManifestFileName)));
+}
+
 } // namespace tablet
 } // namespace yb
@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -47,6 +48,7 @@
 
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/listener.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
@@ -88,6 +90,8 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
 
+#include "yb/tablet/async_index_updater.h"
+#include "yb/tablet/incremental_checkpoint.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_retention_policy.h"
@@ -97,6 +101,7 @@
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/util/atomic.h"
 #include "yb/util/bloom_filter.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/enums.h"
@@ -106,11 +111,14 @@
 #include "yb/util/locks.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
 
+using namespace yb::size_literals;
+
 DEFINE_bool(tablet_do_dup_key_checks, true,
             "Whether to check primary keys for duplicate on insertion. "
             "Use at your own risk!");
@@ -130,6 +138,13 @@ DEFINE_double(tablet_bloom_target_fp_rate, 0.01f,
               "required for bloom filters.");
 TAG_FLAG(tablet_bloom_target_fp_rate, advanced);
 
+DEFINE_bool(tablet_async_index_updates, false,
+            "Make non-unique secondary indexes of non-transactional tables eventually consistent: "
+            "writes to the indexed table complete without waiting for the index updates, which "
+            "are written in the background in batches. Pending index updates are lost if the "
+            "tablet server restarts.");
+TAG_FLAG(tablet_async_index_updates, advanced);
+
 METRIC_DEFINE_entity(tablet);
 
 // TODO: use a lower default for truncate / snapshot restore Raft operations. The one-minute timeout
@@ -139,10 +154,74 @@ DEFINE_int32(tablet_rocksdb_ops_quiet_down_timeout_ms, 60000,
              "so that we can perform exclusive-ownership operations on RocksDB, such as removing "
              "all data in the tablet by replacing the RocksDB instance with an empty one.");
 
+DEFINE_bool(skip_intents_db_without_running_transactions, true,
+            "Whether non-transactional reads should skip intents DB when tablet does not have "
+            "running transactions.");
+TAG_FLAG(skip_intents_db_without_running_transactions, advanced);
+
+DEFINE_bool(tablet_intent_prefix_filter, true,
+            "Keep an in-memory summary of the intents of each tablet, so conflict resolution only "
+            "seeks the intents DB for keys that could have intents.");
+TAG_FLAG(tablet_intent_prefix_filter, advanced);
+
 DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_int32(ql_parallel_scan_max_ranges, 4,
+             "Max number of key sub-ranges a full-tablet CQL aggregate scan is split into. The "
+             "sub-ranges are scanned in parallel on the read pool. 1 disables parallel scans.");
+TAG_FLAG(ql_parallel_scan_max_ranges, advanced);
+
+DEFINE_int64(ql_parallel_scan_min_tablet_size_bytes, 256_MB,
+             "Min total size of SST files in a tablet for full-tablet CQL aggregate scans to be "
+             "split into sub-ranges.");
+TAG_FLAG(ql_parallel_scan_min_tablet_size_bytes, advanced);
+
+DEFINE_int32(redis_hot_key_value_cache_size, 1024,
+             "Number of recently written Redis strings of a tablet whose latest values are cached, "
+             "so that INCR and APPEND on hot keys do not read them from RocksDB. 0 disables the "
+             "cache.");
+TAG_FLAG(redis_hot_key_value_cache_size, advanced);
+
+DEFINE_bool(redis_use_hashed_memtable, false,
+            "Whether memtables of Redis tablets hash entries by Redis key, so point reads do not "
+            "search the whole memtable.");
+TAG_FLAG(redis_use_hashed_memtable, advanced);
+
+DEFINE_bool(tablet_batch_follower_apply, true,
+            "Whether followers write the non-transactional writes committed by one leader request "
+            "to RocksDB as a single write batch.");
+TAG_FLAG(tablet_batch_follower_apply, advanced);
+TAG_FLAG(tablet_batch_follower_apply, runtime);
+
+DEFINE_int32(intents_db_delete_triggered_compaction_percent, 30,
+             "Compact intents DB files together with the earliest one, when at least this "
+             "percentage of their entries are removals of applied or aborted intents. So removed "
+             "intents do not stay in SST files until the number of files triggers compaction. "
+             "0 disables.");
+TAG_FLAG(intents_db_delete_triggered_compaction_percent, advanced);
+
+DEFINE_bool(tablet_delete_expired_files, true,
+            "Delete the oldest SST files of CQL tables with default time to live, when all their "
+            "records are expired before the history cutoff, instead of rewriting them in "
+            "compactions. Only files written with rocksdb_track_file_expiration are deleted.");
+TAG_FLAG(tablet_delete_expired_files, advanced);
+TAG_FLAG(tablet_delete_expired_files, runtime);
+
+DEFINE_bool(tablet_filter_history_on_flush, true,
+            "Remove versions of rows that are overwritten before the history cutoff within the "
+            "flushed memtable, instead of writing them to SST files. Not used for Redis tables.");
+TAG_FLAG(tablet_filter_history_on_flush, advanced);
+
+DEFINE_int32(index_backfill_rows_per_request, 10000,
+             "Max number of rows a tablet adds to an index in one backfill request.");
+TAG_FLAG(index_backfill_rows_per_request, advanced);
+
+DEFINE_int32(index_backfill_write_batch_size, 128,
+             "Number of index entries index backfill writes in one batch.");
+TAG_FLAG(index_backfill_write_batch_size, advanced);
+
 using namespace std::placeholders;
 
 using std::shared_ptr;
@@ -289,6 +368,35 @@ CHECKED_STATUS EmitRocksDbMetricsAsPrometheus(
   return Status::OK();
 }
 
+// Checks for expired files of the regular DB after each flush and compaction, i.e. whenever the set
+// of files changes. With a time series workload, flushes also happen often enough to follow the
+// history cutoff.
+class ExpiredFilesDeleter : public rocksdb::EventListener {
+ public:
+  explicit ExpiredFilesDeleter(std::shared_ptr<docdb::HistoryRetentionPolicy> retention_policy)
+      : retention_policy_(std::move(retention_policy)) {}
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo&) override {
+    DeleteExpiredFiles(db);
+  }
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo&) override {
+    DeleteExpiredFiles(db);
+  }
+
+ private:
+  void DeleteExpiredFiles(rocksdb::DB* db) {
+    if (!FLAGS_tablet_delete_expired_files) {
+      return;
+    }
+    auto result = docdb::DeleteExpiredFiles(
+        db, retention_policy_->GetHistoryCutoff(), retention_policy_->GetTableTTL());
+    LOG_IF(WARNING, !result.ok()) << "Failed to delete expired files: " << result.status();
+  }
+
+  std::shared_ptr<docdb::HistoryRetentionPolicy> retention_policy_;
+};
+
 } // namespace
 
 const char* Tablet::kDMSMemTrackerId = "DeltaMemStores";
@@ -335,7 +443,7 @@ Tablet::Tablet(
     });
 
     metric_entity_->AddExternalPrometheusMetricsCb(
-        [rocksdb_statistics, attrs](PrometheusWriter* pw) {
+        [rocksdb_statistics](PrometheusWriter* pw, const MetricEntity::AttributeMap& attrs) {
       auto s = EmitRocksDbMetricsAsPrometheus(rocksdb_statistics, pw, attrs);
       if (!s.ok()) {
         YB_LOG_EVERY_N(WARNING, 100) << "Failed to get Prometheus metrics: " << s.ToString();
@@ -348,6 +456,11 @@ Tablet::Tablet(
   }
   dms_mem_tracker_ = MemTracker::CreateTracker(kDMSMemTrackerId, mem_tracker_);
 
+  if (table_type_ == TableType::REDIS_TABLE_TYPE && FLAGS_redis_hot_key_value_cache_size > 0) {
+    hot_key_value_cache_ = std::make_unique<docdb::HotKeyValueCache>(
+        FLAGS_redis_hot_key_value_cache_size);
+  }
+
   if (transaction_participant_context && metadata->schema().table_properties().is_transactional()) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
         transaction_participant_context, this);
@@ -363,6 +476,7 @@ Tablet::Tablet(
   if (!metadata_->index_map().empty()) {
     metadata_cache_.emplace(client_future_.get(), false /* Update roles' permissions cache */);
   }
+  async_index_updater_ = std::make_unique<AsyncIndexUpdater>(LogPrefix(), client_future_);
 
   // If this is a unique index tablet, set up the index primary key schema.
   if (metadata_->is_unique_index()) {
@@ -478,14 +592,39 @@ std::string Tablet::LogPrefix() const {
 }
 
 Status Tablet::OpenKeyValueTablet() {
+  const Schema& schema = metadata()->schema();
+  const size_t bloom_filter_range_components = std::min<size_t>(
+      schema.table_properties().bloom_filter_range_components(), schema.num_range_key_columns());
   rocksdb::Options rocksdb_options;
-  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_);
+  docdb::InitRocksDBOptions(&rocksdb_options, tablet_id(), rocksdb_statistics_, tablet_options_,
+                            bloom_filter_range_components);
   rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker("RegularDB", mem_tracker_);
+  // SST files of the regular DB are read through a memory mapping when the table asks for it, e.g.
+  // because its data fits in memory or is stored on tmpfs.
+  rocksdb_options.allow_mmap_reads = schema.table_properties().mmap_reads();
+  rocksdb_options.min_blob_size = schema.table_properties().min_blob_value_size();
+  if (table_type_ == TableType::REDIS_TABLE_TYPE && FLAGS_redis_use_hashed_memtable) {
+    docdb::UseHashedComponentsMemTable(&rocksdb_options);
+  }
+  const auto compaction_time_window_sec = schema.table_properties().compaction_time_window_sec();
+  if (table_type_ == TableType::YQL_TABLE_TYPE && compaction_time_window_sec != 0) {
+    docdb::UseTimeWindowCompaction(
+        &rocksdb_options, MonoDelta::FromSeconds(compaction_time_window_sec));
+  }
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  auto retention_policy = make_shared<TabletRetentionPolicy>(this);
+  // Flushes of Redis tables are not filtered: the filter removes a TTL merge record once it merges
+  // it into the value that follows, and for a flushed memtable that value could be in older files.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy,
+      FLAGS_tablet_filter_history_on_flush && table_type_ != TableType::REDIS_TABLE_TYPE);
+  // Redis TTL merge records could extend TTL of records in older files, so only CQL tables are
+  // checked for expired files.
+  if (table_type_ == TableType::YQL_TABLE_TYPE) {
+    rocksdb_options.listeners.push_back(make_shared<ExpiredFilesDeleter>(retention_policy));
+  }
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -509,6 +648,10 @@ Status Tablet::OpenKeyValueTablet() {
     return STATUS(IllegalState, rocksdb_open_status.ToString());
   }
   regular_db_.reset(db);
+  if (hot_key_value_cache_) {
+    // Values cached for the previous RocksDB instance, e.g. before truncate, are no longer valid.
+    hot_key_value_cache_->Clear();
+  }
 
   if (transaction_participant_) {
     LOG_WITH_PREFIX(INFO) << "Opening intents DB at: " << db_dir + kIntentsDBSuffix;
@@ -516,16 +659,34 @@ Status Tablet::OpenKeyValueTablet() {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
     });
     rocksdb_options.listeners.clear();
+    // Intents are short lived, so they are not worth mapping, moving to blob files or keeping in
+    // time windows.
+    rocksdb_options.allow_mmap_reads = false;
+    rocksdb_options.min_blob_size = 0;
+    rocksdb_options.time_window_extractor = nullptr;
 
     rocksdb_options.compaction_filter_factory =
         FLAGS_tablet_do_compaction_cleanup_for_intents ?
         std::make_shared<docdb::DocDBIntentsCompactionFilterFactory>(this) : nullptr;
 
     rocksdb_options.mem_tracker = MemTracker::FindOrCreateTracker("IntentsDB", mem_tracker_);
+    rocksdb_options.compaction_options_universal.delete_triggered_compaction_percent =
+        std::max(FLAGS_intents_db_delete_triggered_compaction_percent, 0);
 
     rocksdb::DB* intents_db = nullptr;
     RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options, db_dir + kIntentsDBSuffix, &intents_db));
     intents_db_.reset(intents_db);
+
+    intent_prefix_filter_.reset();
+    if (FLAGS_tablet_intent_prefix_filter) {
+      auto filter = std::make_unique<docdb::IntentPrefixFilter>();
+      auto status = filter->Rebuild(intents_db_.get());
+      if (status.ok()) {
+        intent_prefix_filter_ = std::move(filter);
+      } else {
+        LOG_WITH_PREFIX(WARNING) << "Failed to rebuild intent prefix filter: " << status;
+      }
+    }
   }
 
   ql_storage_.reset(new docdb::QLRocksDBStorage({regular_db_.get(), intents_db_.get()}));
@@ -559,6 +720,10 @@ void Tablet::Shutdown() {
     transaction_coordinator_->Shutdown();
   }
 
+  if (async_index_updater_) {
+    async_index_updater_->Shutdown();
+  }
+
   std::lock_guard<rw_spinlock> lock(component_lock_);
   // Shutdown the RocksDB instance for this table, if present.
   // Destroy intents and regular DBs in reverse order to their creation.
@@ -575,7 +740,8 @@ void Tablet::Shutdown() {
 }
 
 Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
-    const Schema &projection, const boost::optional<TransactionId>& transaction_id) const {
+    const Schema &projection, const boost::optional<TransactionId>& transaction_id,
+    const ReadHybridTime& read_time) const {
   if (state_ != kOpen) {
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
   }
@@ -593,15 +759,129 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   RETURN_NOT_OK(schema()->GetMappedReadProjection(projection, mapped_projection.get()));
 
   auto txn_op_ctx = CreateTransactionOperationContext(transaction_id);
-  auto read_time = ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse));
   auto result = std::make_unique<DocRowwiseIterator>(
       std::move(mapped_projection), *schema(), txn_op_ctx,
       docdb::DocDB{regular_db_.get(), intents_db_.get()},
-      MonoTime::Max() /* deadline */, read_time, &pending_op_counter_);
+      MonoTime::Max() /* deadline */,
+      read_time ? read_time : ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse)),
+      &pending_op_counter_);
   RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
 
+Result<std::string> Tablet::BackfillIndex(const TableId& index_id,
+                                          HybridTime read_time,
+                                          const std::string& start_row_key,
+                                          MonoTime deadline) {
+  if (table_type_ != TableType::YQL_TABLE_TYPE) {
+    return STATUS_FORMAT(NotSupported, "Invalid table type: $0", table_type_);
+  }
+  if (!metadata_cache_) {
+    return STATUS(Corruption, "Table metadata cache is not present for index backfill");
+  }
+
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  const IndexInfo index = *VERIFY_RESULT(metadata_->index_map().FindIndex(index_id));
+  client::YBTablePtr index_table;
+  bool cache_used_ignored = false;
+  RETURN_NOT_OK(metadata_cache_->GetTable(index_id, &index_table, &cache_used_ignored));
+
+  if (!SafeTime(RequireLease::kTrue, read_time, deadline).is_valid()) {
+    return STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_time);
+  }
+
+  Schema projection;
+  RETURN_NOT_OK(schema()->GetMappedReadProjection(*schema(), &projection));
+  DocRowwiseIterator iter(
+      projection, *schema(), CreateTransactionOperationContext(boost::none),
+      docdb::DocDB{regular_db_.get(), intents_db_.get()}, MonoTime::Max() /* deadline */,
+      ReadHybridTime::SingleTime(read_time), &pending_op_counter_);
+  if (!start_row_key.empty()) {
+    iter.SetScanKeyRange(KeyBytes(start_row_key), KeyBytes());
+  }
+  RETURN_NOT_OK(iter.Init());
+
+  // Leave the other half of the time to the master to receive the response.
+  const MonoTime now = MonoTime::Now();
+  const MonoTime stop_time = deadline == MonoTime::Max()
+      ? MonoTime::Max()
+      : now + MonoDelta::FromNanoseconds((deadline - now).ToNanoseconds() / 2);
+
+  auto session = std::make_shared<YBSession>(client_future_.get());
+  std::vector<std::shared_ptr<client::YBqlWriteOp>> index_ops;
+  auto flush = [&session, &index_ops]() -> Status {
+    if (index_ops.empty()) {
+      return Status::OK();
+    }
+    auto status = session->Flush();
+    if (status.IsIOError()) {
+      for (const auto& error : session->GetPendingErrors()) {
+        return error->status();
+      }
+    }
+    RETURN_NOT_OK(status);
+    for (const auto& index_op : index_ops) {
+      switch (index_op->response().status()) {
+        case QLResponsePB::YQL_STATUS_OK:
+          break;
+        case QLResponsePB::YQL_STATUS_USAGE_ERROR:
+          // E.g. duplicate values in a unique index, that the master does not retry.
+          return STATUS_FORMAT(InvalidArgument, "Failed to write index entry: $0",
+                               index_op->response().error_message());
+        default:
+          return STATUS_FORMAT(IllegalState, "Failed to write index entry: $0",
+                               index_op->response().error_message());
+      }
+    }
+    index_ops.clear();
+    return Status::OK();
+  };
+
+  QLTableRow row;
+  int num_rows = 0;
+  while (iter.HasNext()) {
+    if (num_rows >= FLAGS_index_backfill_rows_per_request || MonoTime::Now() >= stop_time) {
+      RETURN_NOT_OK(flush());
+      return iter.row_key().Encode().data();
+    }
+    RETURN_NOT_OK(iter.NextRow(&row));
+
+    std::shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
+    auto* const index_request = index_op->mutable_request();
+    index_request->set_type(QLWriteRequestPB::QL_STMT_INSERT);
+    // Entries written by updates of the row after read_time have later timestamps, so they are not
+    // overwritten by the entry of the older version of the row.
+    index_request->set_user_timestamp_usec(read_time.GetPhysicalValueMicros());
+    for (size_t idx = 0; idx < index.columns().size(); idx++) {
+      const IndexInfo::IndexColumn& index_column = index.column(idx);
+      auto value = row.GetValue(index_column.indexed_column_id);
+      if (idx < index.key_column_count()) {
+        QLExpressionPB* key_column = idx < index.hash_column_count()
+            ? index_request->add_hashed_column_values()
+            : index_request->add_range_column_values();
+        if (value) {
+          key_column->mutable_value()->CopyFrom(*value);
+        }
+      } else if (value) {
+        QLColumnValuePB* covering_column = index_request->add_column_values();
+        covering_column->set_column_id(index_column.column_id);
+        covering_column->mutable_expr()->mutable_value()->CopyFrom(*value);
+      }
+    }
+    RETURN_NOT_OK(session->Apply(index_op));
+    index_ops.push_back(std::move(index_op));
+    ++num_rows;
+
+    if (index_ops.size() >= static_cast<size_t>(FLAGS_index_backfill_write_batch_size)) {
+      RETURN_NOT_OK(flush());
+    }
+  }
+  RETURN_NOT_OK(flush());
+  return std::string();
+}
+
 void Tablet::StartOperation(WriteOperationState* operation_state) {
   // If the state already has a hybrid_time then we're replaying a transaction that occurred
   // before a crash or at another node.
@@ -670,6 +950,15 @@ Status Tablet::CreateCheckpoint(const std::string& dir) {
   return Status::OK();
 }
 
+Result<CheckpointManifestPB> Tablet::CreateIncrementalCheckpoint(
+    const std::string& dir, const std::string& checkpoint_id, const CheckpointManifestPB* base) {
+  RETURN_NOT_OK(CreateCheckpoint(dir));
+  auto env = metadata()->fs_manager()->env();
+  auto manifest = VERIFY_RESULT(BuildCheckpointManifest(env, dir, checkpoint_id, base));
+  RETURN_NOT_OK(WriteCheckpointManifest(env, dir, manifest));
+  return manifest;
+}
+
 void Tablet::PrepareTransactionWriteBatch(
     const KeyValueWriteBatchPB& put_batch,
     HybridTime hybrid_time,
@@ -693,7 +982,8 @@ void Tablet::PrepareTransactionWriteBatch(
   auto isolation_level = metadata_with_write_id->first.isolation;
   auto write_id = metadata_with_write_id->second;
   yb::docdb::PrepareTransactionWriteBatch(
-      put_batch, hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, &write_id);
+      put_batch, hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, &write_id,
+      intent_prefix_filter_.get());
   transaction_participant()->UpdateLastWriteId(transaction_id, write_id);
 }
 
@@ -704,6 +994,22 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     return;
   }
 
+  if (ApplyBatchStartedByThisThread()) {
+    if (!put_batch.has_transaction() && !hot_key_value_cache_) {
+      auto& batch = *apply_batch_;
+      if (batch.write_batch.Count() == 0) {
+        batch.frontiers = frontiers->Clone();
+        batch.min_hybrid_time = hybrid_time;
+      } else {
+        batch.frontiers->Merge(*frontiers);
+      }
+      PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &batch.write_batch);
+      return;
+    }
+    // Writes that are not batched must reach RocksDB after the ones accumulated so far.
+    WriteApplyBatch();
+  }
+
   rocksdb::WriteBatch write_batch;
   if (put_batch.has_transaction()) {
     RequestScope request_scope(transaction_participant_.get());
@@ -711,7 +1017,15 @@ void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
     WriteBatch(frontiers, hybrid_time, &write_batch, intents_db_.get());
   } else {
     PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &write_batch);
+    // Cached values are invalidated before the write, so a reader never gets a cached value older
+    // than the one stored in RocksDB.
+    if (hot_key_value_cache_) {
+      hot_key_value_cache_->Invalidate(put_batch);
+    }
     WriteBatch(frontiers, hybrid_time, &write_batch, regular_db_.get());
+    if (hot_key_value_cache_) {
+      hot_key_value_cache_->Update(put_batch, hybrid_time);
+    }
   }
 }
 
@@ -738,6 +1052,72 @@ void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
   }
 }
 
+struct Tablet::ApplyBatch {
+  rocksdb::WriteBatch write_batch;
+  std::unique_ptr<rocksdb::UserFrontiers> frontiers;
+  // Hybrid time of the first operation in the batch, the smallest one.
+  HybridTime min_hybrid_time;
+  // Completions of the operations whose writes are in write_batch, in Raft order.
+  std::vector<std::function<void()>> completions;
+};
+
+void Tablet::StartApplyBatch() {
+  if (!GetAtomicFlag(&FLAGS_tablet_batch_follower_apply) || !regular_db_) {
+    return;
+  }
+  apply_batch_mutex_.lock();
+  if (!apply_batch_) {
+    apply_batch_ = std::make_unique<ApplyBatch>();
+  }
+  apply_batch_thread_.store(std::this_thread::get_id(), std::memory_order_release);
+}
+
+void Tablet::FinishApplyBatch() {
+  if (!ApplyBatchStartedByThisThread()) {
+    return;
+  }
+  WriteApplyBatch();
+  apply_batch_thread_.store(std::thread::id(), std::memory_order_release);
+  apply_batch_mutex_.unlock();
+}
+
+void Tablet::WriteApplyBatch() {
+  auto& batch = *apply_batch_;
+  if (batch.write_batch.Count() != 0) {
+    WriteBatch(batch.frontiers.get(), batch.min_hybrid_time, &batch.write_batch,
+               regular_db_.get());
+    batch.write_batch.Clear();
+    batch.frontiers.reset();
+  }
+  auto completions = std::move(batch.completions);
+  batch.completions.clear();
+  for (const auto& complete : completions) {
+    complete();
+  }
+}
+
+void Tablet::ApplyOperation(
+    bool is_write, const std::function<void()>& apply, std::function<void()> complete) {
+  if (ApplyBatchStartedByThisThread()) {
+    if (!is_write) {
+      WriteApplyBatch();
+    }
+    apply();
+    if (apply_batch_->write_batch.Count() != 0) {
+      apply_batch_->completions.push_back(std::move(complete));
+      return;
+    }
+    complete();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(apply_batch_mutex_);
+    apply();
+  }
+  complete();
+}
+
 namespace {
 
 // Separate Redis / QL / row operations write batches from write_request in preparation for the
@@ -828,10 +1208,63 @@ Status Tablet::HandleQLReadRequest(
   }
 
   Result<TransactionOperationContextOpt> txn_op_ctx =
-      CreateTransactionOperationContext(transaction_metadata);
+      CreateReadTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
+
+  docdb::QLParallelScanOptions parallel_scan_options;
+  if (ql_read_request.is_aggregate() && ql_read_request.hashed_column_values().empty() &&
+      tablet_options_.read_pool != nullptr) {
+    parallel_scan_options.thread_pool = tablet_options_.read_pool;
+    parallel_scan_options.split_keys = ParallelScanSplitKeys(FLAGS_ql_parallel_scan_max_ranges);
+  }
   return AbstractTablet::HandleQLReadRequest(
-      deadline, read_time, ql_read_request, *txn_op_ctx, result);
+      deadline, read_time, ql_read_request, *txn_op_ctx, result, &parallel_scan_options);
+}
+
+std::vector<docdb::KeyBytes> Tablet::ParallelScanSplitKeys(int max_ranges) const {
+  std::vector<docdb::KeyBytes> result;
+  if (max_ranges <= 1 || !regular_db_) {
+    return result;
+  }
+
+  std::vector<rocksdb::LiveFileMetaData> live_files_metadata;
+  regular_db_->GetLiveFilesMetaData(&live_files_metadata);
+  uint64_t total_size = 0;
+  for (const auto& file : live_files_metadata) {
+    total_size += file.total_size;
+  }
+  if (live_files_metadata.size() < 2 ||
+      total_size < FLAGS_ql_parallel_scan_min_tablet_size_bytes) {
+    return result;
+  }
+
+  // SST file boundaries are used as candidate split points, so every sub-range covers roughly the
+  // same amount of data. Keys are truncated to the doc key, so that a row is never split between
+  // sub-ranges.
+  std::vector<std::string> boundaries;
+  boundaries.reserve(live_files_metadata.size() * 2);
+  for (const auto& file : live_files_metadata) {
+    for (const auto* key : {&file.smallest.key, &file.largest.key}) {
+      auto doc_key_size = docdb::DocKey::EncodedSize(*key, docdb::DocKeyPart::WHOLE_DOC_KEY);
+      if (doc_key_size.ok()) {
+        boundaries.emplace_back(key->data(), *doc_key_size);
+      }
+    }
+  }
+  std::sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+  // The first and the last boundaries are the ends of the tablet, they do not split anything.
+  if (boundaries.size() <= 2) {
+    return result;
+  }
+  const size_t num_candidates = boundaries.size() - 2;
+  const size_t num_splits = std::min<size_t>(max_ranges - 1, num_candidates);
+  result.reserve(num_splits);
+  for (size_t i = 1; i <= num_splits; ++i) {
+    result.emplace_back(boundaries[i * (num_candidates + 1) / (num_splits + 1)]);
+  }
+  return result;
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -958,6 +1391,7 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   client::YBSessionPtr session;
   client::YBTransactionPtr txn;
   std::vector<std::pair<std::shared_ptr<client::YBqlWriteOp>, QLWriteOperation*>> index_ops;
+  std::vector<AsyncIndexUpdate> async_index_updates;
   const ChildTransactionDataPB* child_transaction_data = nullptr;
   for (auto& doc_op : operation->doc_ops()) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
@@ -1011,6 +1445,13 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
         operation->state()->CompleteWithStatus(status);
         return;
       }
+      // Updates of unique indexes are always synchronous, since the write must fail on a duplicate
+      // value. Transactional writes update their indexes in the same transaction.
+      if (FLAGS_tablet_async_index_updates && !pair.first->is_unique() &&
+          !write_op->request().has_child_transaction_data()) {
+        async_index_updates.push_back(AsyncIndexUpdate{index_table, std::move(pair.second), {}});
+        continue;
+      }
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
@@ -1023,7 +1464,11 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
     }
   }
 
-  if (!session) {
+  if (!async_index_updates.empty()) {
+    async_index_updater_->Enqueue(std::move(async_index_updates));
+  }
+
+  if (index_ops.empty()) {
     CompleteQLWriteBatch(std::move(operation), Status::OK());
     return;
   }
@@ -1100,7 +1545,7 @@ Status Tablet::HandlePgsqlReadRequest(
   }
 
   Result<TransactionOperationContextOpt> txn_op_ctx =
-      CreateTransactionOperationContext(transaction_metadata);
+      CreateReadTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
   return AbstractTablet::HandlePgsqlReadRequest(
       deadline, read_time, pgsql_read_request, *txn_op_ctx, result);
@@ -1259,6 +1704,13 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
   set_hybrid_time(data.log_ht, &frontiers);
   WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
   WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+  if (intent_prefix_filter_) {
+    intent_prefix_filter_->Remove(data.transaction_id);
+  }
+
+  auto now = clock_->Now().GetPhysicalValueMicros();
+  auto commit_time = data.commit_ht.GetPhysicalValueMicros();
+  metrics_->transaction_apply_lag->Increment(now > commit_time ? now - commit_time : 0);
   return Status::OK();
 }
 
@@ -1270,7 +1722,11 @@ CHECKED_STATUS Tablet::RemoveIntents(const TransactionId& id) {
 
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
-  return intents_db_->Write(write_options, &intents_write_batch);
+  RETURN_NOT_OK(intents_db_->Write(write_options, &intents_write_batch));
+  if (intent_prefix_filter_) {
+    intent_prefix_filter_->Remove(id);
+  }
+  return Status::OK();
 }
 
 CHECKED_STATUS Tablet::RemoveIntents(const TransactionIdSet& transactions) {
@@ -1283,7 +1739,13 @@ CHECKED_STATUS Tablet::RemoveIntents(const TransactionIdSet& transactions) {
 
   rocksdb::WriteOptions write_options;
   InitRocksDBWriteOptions(&write_options);
-  return intents_db_->Write(write_options, &intents_write_batch);
+  RETURN_NOT_OK(intents_db_->Write(write_options, &intents_write_batch));
+  if (intent_prefix_filter_) {
+    for (const TransactionId& id : transactions) {
+      intent_prefix_filter_->Remove(id);
+    }
+  }
+  return Status::OK();
 }
 
 HybridTime Tablet::ApplierSafeTime(HybridTime min_allowed, MonoTime deadline) {
@@ -1461,6 +1923,19 @@ void Tablet::UpdateMonotonicCounter(int64_t value) {
   }
 }
 
+bool Tablet::StartRead(int64_t max_concurrent_reads) {
+  auto reads = num_reads_in_progress_.fetch_add(1, std::memory_order_acq_rel);
+  if (max_concurrent_reads > 0 && reads >= max_concurrent_reads) {
+    num_reads_in_progress_.fetch_sub(1, std::memory_order_acq_rel);
+    return false;
+  }
+  return true;
+}
+
+void Tablet::FinishRead() {
+  num_reads_in_progress_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 ////////////////////////////////////////////////////////////
 // Tablet
 ////////////////////////////////////////////////////////////
@@ -1478,6 +1953,86 @@ Result<bool> Tablet::HasSSTables() const {
   return !live_files_metadata.empty();
 }
 
+Result<TabletCompactionState> Tablet::GetCompactionState() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  TabletCompactionState result;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (!db) {
+      continue;
+    }
+    uint64_t score = 0, pending = 0, running = 0, sst_files_size = 0;
+    db->GetIntProperty(rocksdb::DB::Properties::kCompactionUrgencyScore, &score);
+    db->GetIntProperty(rocksdb::DB::Properties::kCompactionPending, &pending);
+    db->GetIntProperty(rocksdb::DB::Properties::kNumRunningCompactions, &running);
+    db->GetIntProperty(rocksdb::DB::Properties::kTotalSstFilesSize, &sst_files_size);
+    result.urgency_score = std::max(result.urgency_score, score / 100.0);
+    result.compaction_pending = result.compaction_pending || pending != 0;
+    result.num_running_compactions += running;
+    result.sst_files_size += sst_files_size;
+  }
+  return result;
+}
+
+Result<uint64_t> Tablet::GetL0DelayTriggerCount() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  uint64_t result = 0;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (!db) {
+      continue;
+    }
+    uint64_t count = 0;
+    db->GetIntProperty(rocksdb::DB::Properties::kL0DelayTriggerCount, &count);
+    result = std::max(result, count);
+  }
+  return result;
+}
+
+Result<TabletMemTableState> Tablet::GetMemTableState() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  TabletMemTableState result;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (!db) {
+      continue;
+    }
+    uint64_t active_size = 0, flush_pending = 0, running_flushes = 0;
+    db->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &active_size);
+    db->GetIntProperty(rocksdb::DB::Properties::kMemTableFlushPending, &flush_pending);
+    db->GetIntProperty(rocksdb::DB::Properties::kNumRunningFlushes, &running_flushes);
+    if (db == regular_db_.get()) {
+      result.regular_active_size = active_size;
+    } else {
+      result.intents_active_size = active_size;
+    }
+    result.flush_in_progress = result.flush_in_progress || flush_pending != 0 ||
+                               running_flushes != 0;
+  }
+  return result;
+}
+
+Result<bool> Tablet::HasMemTableEntries() const {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (!db) {
+      continue;
+    }
+    uint64_t active_entries = 0, immutable_entries = 0;
+    db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesActiveMemTable, &active_entries);
+    db->GetIntProperty(rocksdb::DB::Properties::kNumEntriesImmMemTables, &immutable_entries);
+    if (active_entries != 0 || immutable_entries != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Result<DocDbOpIds> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
@@ -1593,9 +2148,12 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   if (*isolation_level == IsolationLevel::NON_TRANSACTIONAL &&
       metadata_->schema().table_properties().is_transactional()) {
     auto now = clock_->Now();
+    TRACE("Resolving operation conflicts");
     auto result = docdb::ResolveOperationConflicts(
-        operation->doc_ops(), now, {regular_db_.get(), intents_db_.get()},
+        operation->doc_ops(), now,
+        {regular_db_.get(), intents_db_.get(), intent_prefix_filter_.get()},
         transaction_participant_.get());
+    TRACE("Resolved operation conflicts");
     RETURN_NOT_OK(result);
     if (now != *result) {
       clock_->Update(*result);
@@ -1611,7 +2169,8 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
       table_type_ == TableType::REDIS_TABLE_TYPE ? InitMarkerBehavior::kRequired
                                                  : InitMarkerBehavior::kOptional,
       &monotonic_counter_,
-      &restart_read_ht));
+      &restart_read_ht,
+      hot_key_value_cache_.get()));
 
   operation->SetRestartReadHt(restart_read_ht);
 
@@ -1620,9 +2179,12 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   }
 
   if (*isolation_level != IsolationLevel::NON_TRANSACTIONAL) {
+    TRACE("Resolving transaction conflicts");
     RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
-        *write_batch, clock_->Now(), {regular_db_.get(), intents_db_.get()},
+        *write_batch, clock_->Now(),
+        {regular_db_.get(), intents_db_.get(), intent_prefix_filter_.get()},
         transaction_participant_.get(), metrics_->transaction_conflicts.get()));
+    TRACE("Resolved transaction conflicts");
   }
   operation->state()->ReplaceDocDBLocks(std::move(keys_locked));
 
@@ -1749,6 +2311,21 @@ uint64_t Tablet::GetUncompressedSSTFileSizes() const {
   return regular_db_->GetUncompressedSSTFileSize();
 }
 
+void Tablet::CloseTableReadersIfIdle() {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+
+  if (!pending_op_counter_.IsReady()) {
+    return;
+  }
+  if (regular_db_) {
+    regular_db_->CloseTableReadersIfIdle();
+  }
+  if (intents_db_) {
+    intents_db_->CloseTableReadersIfIdle();
+  }
+}
+
 // ------------------------------------------------------------------------------------------------
 
 Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext(
@@ -1771,6 +2348,18 @@ Result<TransactionOperationContextOpt> Tablet::CreateTransactionOperationContext
   }
 }
 
+Result<TransactionOperationContextOpt> Tablet::CreateReadTransactionOperationContext(
+    const TransactionMetadataPB& transaction_metadata) const {
+  if (FLAGS_skip_intents_db_without_running_transactions && transaction_participant_ &&
+      !transaction_metadata.has_transaction_id() &&
+      TransactionParticipant::IntentsEpochHasNoIntents(
+          transaction_participant_->intents_epoch())) {
+    // No transaction could have intents that are visible to this read, so read regular DB only.
+    return Result<TransactionOperationContextOpt>(boost::none);
+  }
+  return CreateTransactionOperationContext(transaction_metadata);
+}
+
 TransactionOperationContextOpt Tablet::CreateTransactionOperationContext(
     const boost::optional<TransactionId>& transaction_id) const {
   if (metadata_->schema().table_properties().is_transactional()) {
@@ -37,6 +37,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "yb/rocksdb/cache.h"
@@ -56,6 +57,8 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/hot_key_value_cache.h"
+#include "yb/docdb/intent_prefix_filter.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/shared_lock_manager.h"
 
@@ -69,6 +72,7 @@
 #include "yb/tablet/lock_manager.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
+#include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/transaction_participant.h"
 
@@ -110,6 +114,7 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class AlterSchemaOperationState;
+class AsyncIndexUpdater;
 class ScopedReadOperation;
 struct TabletMetrics;
 struct TransactionApplyData;
@@ -183,6 +188,24 @@ struct DocDbOpIds {
   OpId intents;
 };
 
+// State of compactions of the RocksDB instances of a tablet.
+struct TabletCompactionState {
+  // Max compaction urgency score, see VersionStorageInfo::CompactionUrgencyScore.
+  double urgency_score = 0;
+  bool compaction_pending = false;
+  uint64_t num_running_compactions = 0;
+  uint64_t sst_files_size = 0;
+};
+
+// State of the memtables of the RocksDB instances of a tablet.
+struct TabletMemTableState {
+  // Approximate sizes of the active memtables of the regular and intents DBs.
+  uint64_t regular_active_size = 0;
+  uint64_t intents_active_size = 0;
+  // Whether a memtable of either DB is waiting to be flushed or is being flushed.
+  bool flush_in_progress = false;
+};
+
 class Tablet : public AbstractTablet, public TransactionIntentApplier {
  public:
   class CompactionFaultHooks;
@@ -284,6 +307,20 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
                   rocksdb::WriteBatch* write_batch,
                   rocksdb::DB* dest_db);
 
+  // Follower apply batching. Between StartApplyBatch and FinishApplyBatch, which are called by the
+  // thread applying the operations committed by one leader request, the RocksDB writes of
+  // non-transactional write operations applied by that thread are accumulated into a single write
+  // batch, and completion of those operations is deferred until the batch is written. Operations
+  // applied by other threads wait for the batch to finish, so RocksDB writes and operation
+  // completions keep the Raft order.
+  void StartApplyBatch();
+  void FinishApplyBatch();
+
+  // Applies an operation by calling apply and completes it by calling complete. Operations other
+  // than writes first write out the current apply batch, so they observe all preceding writes.
+  void ApplyOperation(
+      bool is_write, const std::function<void()>& apply, std::function<void()> complete);
+
   //------------------------------------------------------------------------------------------------
   // Redis Request Processing.
   // Takes a Redis WriteRequestPB as input with its redis_write_batch.
@@ -338,12 +375,30 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // YQL_TABLE_TYPE.
   CHECKED_STATUS CreateCheckpoint(const std::string& dir);
 
-  // Create a new row iterator which yields the rows as of the current MVCC
-  // state of this tablet.
+  // Create a RocksDB checkpoint in the provided directory together with its manifest. Files
+  // shared with the base checkpoint are referenced from it, so only new files need to be uploaded.
+  // A full checkpoint is created when base is null.
+  Result<CheckpointManifestPB> CreateIncrementalCheckpoint(
+      const std::string& dir, const std::string& checkpoint_id, const CheckpointManifestPB* base);
+
+  // Create a new row iterator which yields the rows as of the provided read time, or as of the
+  // current MVCC state of this tablet when read_time is not specified.
   // The returned iterator is not initialized.
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const Schema &projection,
-      const boost::optional<TransactionId>& transaction_id) const;
+      const boost::optional<TransactionId>& transaction_id,
+      const ReadHybridTime& read_time = ReadHybridTime()) const;
+
+  // Adds the rows of the tablet as of read_time, starting at the encoded row key start_row_key, to
+  // the index with id index_id. Stops after --index_backfill_rows_per_request rows or when half of
+  // the time till deadline has passed, and returns the key of the next row to add, or an empty
+  // string when all rows were added. Index entries are written with read_time as user timestamp, so
+  // writes to the index done after read_time are not overwritten. Returns InvalidArgument when the
+  // index rejects an entry, e.g. a duplicate value of a unique index, so retries would not help.
+  Result<std::string> BackfillIndex(const TableId& index_id,
+                                    HybridTime read_time,
+                                    const std::string& start_row_key,
+                                    MonoTime deadline);
 
   //------------------------------------------------------------------------------------------------
   // Makes RocksDB Flush.
@@ -384,6 +439,17 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::atomic<int64_t>* monotonic_counter() { return &monotonic_counter_; }
 
+  // Registers a read RPC that is about to be served by this tablet. When 'max_concurrent_reads' is
+  // positive and that many reads are already in progress, returns false without registering it.
+  bool StartRead(int64_t max_concurrent_reads);
+
+  // Unregisters a read RPC registered by a successful StartRead.
+  void FinishRead();
+
+  int64_t num_reads_in_progress() const {
+    return num_reads_in_progress_.load(std::memory_order_acquire);
+  }
+
   // Set the conter to at least 'value'.
   void UpdateMonotonicCounter(int64_t value);
 
@@ -407,6 +473,20 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
+  // Returns state of compactions of the RocksDB instances of this tablet.
+  Result<TabletCompactionState> GetCompactionState() const;
+
+  // Returns the largest number of level 0 files among the RocksDB instances of this tablet, the
+  // value RocksDB compares with the level 0 slowdown and stop writes triggers.
+  Result<uint64_t> GetL0DelayTriggerCount() const;
+
+  // Returns state of the memtables of the RocksDB instances of this tablet.
+  Result<TabletMemTableState> GetMemTableState() const;
+
+  // Returns true if memtables of the RocksDB instances of this tablet contain entries, i.e. not all
+  // applied operations are flushed.
+  Result<bool> HasMemTableEntries() const;
+
   // Returns the maximum persistent op id from all SSTables in RocksDB.
   // First for regular records and second for intents.
   Result<DocDbOpIds> MaxPersistentOpId() const;
@@ -472,6 +552,10 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetTotalSSTFileSizes() const;
   uint64_t GetUncompressedSSTFileSizes() const;
 
+  // Closes the SST table readers of the RocksDB instances of this tablet that had no reads since
+  // the previous call, to release the memory idle tablets hold in index and filter blocks.
+  void CloseTableReadersIfIdle();
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -515,6 +599,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   TransactionOperationContextOpt CreateTransactionOperationContext(
       const boost::optional<TransactionId>& transaction_id) const;
 
+  // Same as CreateTransactionOperationContext, but for reads. Returns none for reads outside of
+  // transaction when transaction participant does not have intents visible to readers.
+  Result<TransactionOperationContextOpt> CreateReadTransactionOperationContext(
+      const TransactionMetadataPB& transaction_metadata) const;
+
   // Pause any new read/write operations and wait for all pending read/write operations to finish.
   util::ScopedPendingOperationPause PauseReadWriteOperations();
 
@@ -617,6 +706,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<rocksdb::DB> intents_db_;
 
+  // Latest values of recently written Redis strings, kept in sync with regular_db_ by the apply
+  // path. Null if the cache is disabled or the table is not a Redis table.
+  std::unique_ptr<docdb::HotKeyValueCache> hot_key_value_cache_;
+
+  // Summary of the intents stored in intents_db_, kept in sync by the apply path and used to skip
+  // intents DB seeks during conflict resolution. Null if disabled or it could not be rebuilt.
+  std::unique_ptr<docdb::IntentPrefixFilter> intent_prefix_filter_;
+
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -656,11 +753,28 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   boost::optional<client::TransactionManager> transaction_manager_;
   boost::optional<client::YBMetaDataCache> metadata_cache_;
 
+  // Writes updates of non-unique indexes of non-transactional tables in the background when
+  // FLAGS_tablet_async_index_updates is set.
+  std::unique_ptr<AsyncIndexUpdater> async_index_updater_;
+
   // Created only if it is a unique index tablet.
   boost::optional<Schema> unique_index_key_schema_;
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  std::atomic<int64_t> num_reads_in_progress_{0};
+
+  struct ApplyBatch;
+
+  // The thread that started the current apply batch, or an empty id when there is no batch.
+  std::atomic<std::thread::id> apply_batch_thread_{std::thread::id()};
+
+  // Held by the thread that started the apply batch until the batch is finished.
+  std::mutex apply_batch_mutex_;
+
+  // Only accessed by apply_batch_thread_.
+  std::unique_ptr<ApplyBatch> apply_batch_;
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
@@ -672,10 +786,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       RequireLease require_lease, HybridTime min_allowed, MonoTime deadline) const override;
 
   void UpdateQLIndexes(std::unique_ptr<WriteOperation> operation);
+
+  bool ApplyBatchStartedByThisThread() const {
+    return apply_batch_thread_.load(std::memory_order_acquire) == std::this_thread::get_id();
+  }
+
+  // Writes the accumulated apply batch to RocksDB and completes the operations it contains.
+  void WriteApplyBatch();
   void CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status);
 
   Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
 
+  // Returns keys splitting the tablet into at most max_ranges sub-ranges of similar size, for
+  // parallel scans. Returns no keys when the tablet is too small to be split.
+  std::vector<docdb::KeyBytes> ParallelScanSplitKeys(int max_ranges) const;
+
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
 
   client::LocalTabletFilter local_tablet_filter_;
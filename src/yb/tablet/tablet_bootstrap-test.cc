@@ -87,6 +87,7 @@ class BootstrapTest : public LogTestBase {
 
   Status LoadTestTabletMetadata(int mrs_id, int delta_id, scoped_refptr<TabletMetadata>* meta) {
     Schema schema = SchemaBuilder(schema_).Build();
+    schema.SetInMemory(in_memory_);
     std::pair<PartitionSchema, Partition> partition = CreateDefaultPartition(schema);
 
     RETURN_NOT_OK(TabletMetadata::LoadOrCreate(
@@ -131,7 +132,9 @@ class BootstrapTest : public LogTestBase {
         nullptr, // transaction_participant_context
         client::LocalTabletFilter(),
         nullptr, // transaction_coordinator_context
-        append_pool_.get()};
+        append_pool_.get(),
+        nullptr, // retryable_requests
+        log_read_pool_.get()};
     RETURN_NOT_OK(BootstrapTablet(data, tablet, &log_, boot_info));
     return Status::OK();
   }
@@ -170,6 +173,11 @@ class BootstrapTest : public LogTestBase {
       VLOG(1) << result;
     }
   }
+
+  std::unique_ptr<ThreadPool> log_read_pool_;
+
+  // Whether the test tablet belongs to an in-memory table.
+  bool in_memory_ = false;
 };
 
 // Tests a normal bootstrap scenario.
@@ -183,6 +191,19 @@ TEST_F(BootstrapTest, TestBootstrap) {
 
   vector<string> results;
   IterateTabletRows(tablet.get(), &results);
+  ASSERT_TRUE(log_->IsDurableForTests());
+}
+
+// Tests that the WAL of an in-memory table is opened with syncs disabled.
+TEST_F(BootstrapTest, TestInMemoryTable) {
+  in_memory_ = true;
+  BuildLog();
+  const auto current_op_id = MakeOpId(1, current_index_);
+  AppendReplicateBatch(current_op_id, current_op_id);
+  shared_ptr<TabletClass> tablet;
+  ConsensusBootstrapInfo boot_info;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_FALSE(log_->IsDurableForTests());
 }
 
 // Tests attempting a local bootstrap of a tablet that was in the middle of a remote bootstrap
@@ -305,6 +326,75 @@ TEST_F(BootstrapTest, TestOperationOverwriting) {
             results[0]);
 }
 
+// Tests replay of log segments that are read ahead in a thread pool.
+TEST_F(BootstrapTest, TestReadAheadSegments) {
+  ASSERT_OK(ThreadPoolBuilder("log-read-ahead").unlimited_threads().Build(&log_read_pool_));
+  BuildLog();
+
+  constexpr int kNumSegments = 5;
+  OpId committed_opid = MakeOpId(0, 0);
+  for (int i = 1; i <= kNumSegments; ++i) {
+    const OpId opid = MakeOpId(1, i);
+    AppendReplicateBatch(opid, committed_opid,
+                         {TupleForAppend(i, 0, "this is a test insert")}, true /* sync */);
+    committed_opid = opid;
+    ASSERT_OK(RollLog());
+  }
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+
+  // All operations except the last one were committed by the following operation.
+  ASSERT_EQ(boot_info.orphaned_replicates.size(), 1);
+  ASSERT_OPID_EQ(boot_info.last_committed_id, MakeOpId(1, kNumSegments - 1));
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumSegments - 1, results.size());
+}
+
+// Tests that the log is not replayed after the tablet was flushed and marked as cleanly shut down.
+TEST_F(BootstrapTest, TestSkipReplayAfterCleanShutdown) {
+  BuildLog();
+
+  const OpId insert_opid = MakeOpId(1, 1);
+  AppendReplicateBatch(insert_opid, MakeOpId(0, 0),
+                       {TupleForAppend(10, 1, "this is a test insert")}, true /* sync */);
+  const OpId mutate_opid = MakeOpId(1, 2);
+  AppendReplicateBatch(mutate_opid, insert_opid,
+                       {TupleForAppend(10, 2, "this is a test mutate")}, true /* sync */);
+
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(BootstrapTestTablet(-1, -1, &tablet, &boot_info));
+  ASSERT_EQ(boot_info.orphaned_replicates.size(), 1);
+
+  // Mark the tablet as cleanly shut down after the first operation.
+  ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  const OpId flushed_opid = ASSERT_RESULT(tablet->MaxPersistentOpId()).regular.ToPB<OpId>();
+  ASSERT_OPID_EQ(flushed_opid, insert_opid);
+  tablet->metadata()->set_clean_shutdown_op_id(yb::OpId::FromPB(flushed_opid));
+  ASSERT_OK(tablet->metadata()->Flush());
+  tablet->Shutdown();
+  tablet.reset();
+  ASSERT_OK(log_->Close());
+
+  scoped_refptr<TabletMetadata> meta;
+  ASSERT_OK(LoadTestTabletMetadata(-1, -1, &meta));
+  ConsensusBootstrapInfo clean_boot_info;
+  ASSERT_OK(RunBootstrapOnTestTablet(meta, &tablet, &clean_boot_info));
+
+  ASSERT_EQ(clean_boot_info.orphaned_replicates.size(), 0);
+  ASSERT_OPID_EQ(clean_boot_info.last_id, insert_opid);
+  ASSERT_OPID_EQ(clean_boot_info.last_committed_id, insert_opid);
+  ASSERT_FALSE(meta->clean_shutdown_op_id());
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(1, results.size());
+}
+
 // Test that we do not crash when a consensus-only operation has a hybrid_time that is higher than a
 // hybrid_time assigned to a write operation that follows it in the log.
 // TODO: this must not happen in YB. Ensure this is not happening and update the test.
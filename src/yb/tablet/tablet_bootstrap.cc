@@ -31,6 +31,9 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <deque>
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
@@ -48,6 +51,7 @@
 #include "yb/util/opid.h"
 #include "yb/util/logging.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -57,6 +61,16 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after processing a log entry during log replay.");
 
+DEFINE_int32(tablet_bootstrap_read_ahead_segments, 2,
+             "Number of WAL segments that are read and decoded in parallel with the replay of "
+             "the current segment during tablet bootstrap. 0 reads every segment right before "
+             "its replay.");
+TAG_FLAG(tablet_bootstrap_read_ahead_segments, advanced);
+
+DEFINE_bool(skip_wal_replay_after_clean_shutdown, true,
+            "Do not replay the log of a tablet that was flushed before it was shut down.");
+TAG_FLAG(skip_wal_replay_after_clean_shutdown, advanced);
+
 DECLARE_uint64(max_clock_sync_error_usec);
 
 namespace yb {
@@ -301,6 +315,19 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
 
   bool has_blocks = VERIFY_RESULT(OpenTablet());
 
+  // The clean shutdown marker is only valid until the tablet accepts new operations, so it is
+  // removed before bootstrap proceeds.
+  const auto clean_shutdown_op_id = meta_->clean_shutdown_op_id();
+  if (clean_shutdown_op_id) {
+    meta_->set_clean_shutdown_op_id(yb::OpId());
+    RETURN_NOT_OK(meta_->Flush());
+    if (has_blocks && FLAGS_skip_wal_replay_after_clean_shutdown &&
+        VERIFY_RESULT(SkipReplayAfterCleanShutdown(clean_shutdown_op_id, consensus_info))) {
+      return FinishBootstrap("Bootstrap complete, log replay skipped after clean shutdown.",
+                             rebuilt_log, rebuilt_tablet);
+    }
+  }
+
   bool needs_recovery;
   RETURN_NOT_OK(PrepareRecoveryDir(&needs_recovery));
   if (needs_recovery) {
@@ -339,6 +366,43 @@ Status TabletBootstrap::Bootstrap(shared_ptr<TabletClass>* rebuilt_tablet,
   return Status::OK();
 }
 
+Result<bool> TabletBootstrap::SkipReplayAfterCleanShutdown(
+    const yb::OpId& clean_shutdown_op_id, ConsensusBootstrapInfo* consensus_info) {
+  FsManager* fs_manager = tablet_->metadata()->fs_manager();
+  const string& log_dir = tablet_->metadata()->wal_dir();
+  if (fs_manager->Exists(fs_manager->GetTabletWalRecoveryDir(log_dir))) {
+    LOG_WITH_PREFIX(INFO) << "Previous recovery directory found, replaying the log";
+    return false;
+  }
+
+  auto flushed_op_id = VERIFY_RESULT(tablet_->MaxPersistentOpId());
+  if (clean_shutdown_op_id < flushed_op_id.regular ||
+      clean_shutdown_op_id < flushed_op_id.intents) {
+    LOG_WITH_PREFIX(WARNING) << "Clean shutdown op id " << clean_shutdown_op_id
+                             << " is behind flushed op ids " << flushed_op_id.regular << "/"
+                             << flushed_op_id.intents << ", replaying the log";
+    return false;
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Tablet was shut down cleanly at " << clean_shutdown_op_id
+                        << ", skipping log replay";
+
+  // The existing segments are kept, new entries are appended to a new segment.
+  RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open log");
+
+  auto max_persistent_hybrid_time = VERIFY_RESULT(tablet_->MaxPersistentHybridTime());
+  data_.clock->Update(max_persistent_hybrid_time);
+  tablet_->mvcc_manager()->SetLastReplicated(max_persistent_hybrid_time);
+
+  consensus_info->last_id = clean_shutdown_op_id.ToPB<consensus::OpId>();
+  consensus_info->last_committed_id = consensus_info->last_id;
+
+  if (data_.retryable_requests) {
+    data_.retryable_requests->MarkReplicatedUpTo(clean_shutdown_op_id);
+  }
+  return true;
+}
+
 Status TabletBootstrap::FinishBootstrap(const string& message,
                                         scoped_refptr<log::Log>* rebuilt_log,
                                         shared_ptr<TabletClass>* rebuilt_tablet) {
@@ -484,7 +548,14 @@ Status TabletBootstrap::OpenNewLog() {
   OpId init;
   init.set_term(0);
   init.set_index(0);
-  RETURN_NOT_OK(Log::Open(LogOptions(),
+  LogOptions log_options;
+  if (tablet_->schema()->table_properties().in_memory()) {
+    // Writes to in-memory tables are only protected by replication, so their WAL is never synced.
+    log_options.durable_wal_write = false;
+    log_options.interval_durable_wal_write = MonoDelta();
+    log_options.bytes_durable_wal_write_mb = 0;
+  }
+  RETURN_NOT_OK(Log::Open(log_options,
                           tablet_->metadata()->fs_manager(),
                           tablet_->tablet_id(),
                           tablet_->metadata()->wal_dir(),
@@ -711,6 +782,71 @@ void TabletBootstrap::DumpReplayStateToLog(const ReplayState& state) {
   }
 }
 
+// ============================================================================
+//  Class SegmentsReadAhead.
+// ============================================================================
+
+// Reads the entries of the segments following the one being replayed in a thread pool, so reading
+// and decoding of the WAL overlaps with the replay. Entries have to be applied in the log order,
+// so the replay itself stays single threaded.
+class SegmentsReadAhead {
+ public:
+  SegmentsReadAhead(const log::SegmentSequence& segments, ThreadPool* pool)
+      : segments_(segments),
+        pool_(pool),
+        window_(pool ? std::max(FLAGS_tablet_bootstrap_read_ahead_segments, 0) : 0) {
+  }
+
+  ~SegmentsReadAhead() {
+    // Tasks refer to the segments, so they should complete before they could be released.
+    for (auto& future : pending_) {
+      future.wait();
+    }
+  }
+
+  // Returns the read result of the next segment. Should be called once per segment.
+  log::ReadEntriesResult ReadNext() {
+    size_t idx = next_to_read_++;
+    SubmitUpTo(idx + window_);
+    if (!pending_.empty()) {
+      auto future = std::move(pending_.front());
+      pending_.pop_front();
+      return future.get();
+    }
+    return segments_[idx]->ReadEntries();
+  }
+
+ private:
+  void SubmitUpTo(size_t last_idx) {
+    last_idx = std::min(last_idx, segments_.size() - 1);
+    // When submit fails, the rest of segments are read synchronously, so pending_ always starts
+    // with the next segment to replay.
+    while (window_ != 0 && next_to_submit_ <= last_idx) {
+      auto promise = std::make_shared<std::promise<log::ReadEntriesResult>>();
+      auto segment = segments_[next_to_submit_];
+      auto future = promise->get_future();
+      auto status = pool_->SubmitFunc([promise, segment] {
+        promise->set_value(segment->ReadEntries());
+      });
+      if (!status.ok()) {
+        LOG(WARNING) << "Failed to submit read of log segment " << segment->path() << ": "
+                     << status;
+        window_ = 0;
+        return;
+      }
+      pending_.push_back(std::move(future));
+      ++next_to_submit_;
+    }
+  }
+
+  const log::SegmentSequence& segments_;
+  ThreadPool* const pool_;
+  size_t window_;
+  size_t next_to_read_ = 0;
+  size_t next_to_submit_ = 0;
+  std::deque<std::future<log::ReadEntriesResult>> pending_;
+};
+
 Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   auto flushed_op_id = VERIFY_RESULT(tablet_->MaxPersistentOpId());
 
@@ -734,11 +870,19 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // from the log we're reading into the log we're writing.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
+  int64_t total_bytes = 0;
+  for (const auto& segment : segments) {
+    total_bytes += segment->file_size();
+  }
+
   int segment_count = 0;
+  int64_t replayed_bytes = 0;
   yb::OpId last_committed_op_id;
   RestartSafeCoarseTimePoint last_entry_time;
+  SegmentsReadAhead read_ahead(segments, data_.log_read_pool);
+  MonoTime replay_start = MonoTime::Now();
   for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    auto read_result = segment->ReadEntries();
+    auto read_result = read_ahead.ReadNext();
     last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
     for (int entry_idx = 0; entry_idx < read_result.entries.size(); ++entry_idx) {
       Status s = HandleEntry(
@@ -771,11 +915,15 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
                            segment->path());
     }
 
-    // TODO: could be more granular here and log during the segments as well, plus give info about
-    // number of MB processed, but this is better than nothing.
-    listener_->StatusMessage(Substitute("Bootstrap replayed $0/$1 log segments. "
-                                        "Stats: $2. Pending: $3 replicates",
+    // Reported on the tablets page of the web UI, so should be enough to estimate the time left.
+    replayed_bytes += segment->file_size();
+    auto elapsed = MonoTime::Now().GetDeltaSince(replay_start);
+    listener_->StatusMessage(Substitute("Bootstrap replayed $0/$1 log segments, $2/$3 MB "
+                                        "($4%) in $5 s. Stats: $6. Pending: $7 replicates",
                                         segment_count + 1, log_reader_->num_segments(),
+                                        replayed_bytes >> 20, total_bytes >> 20,
+                                        total_bytes ? replayed_bytes * 100 / total_bytes : 100,
+                                        elapsed.ToSeconds(),
                                         stats_.ToString(),
                                         state.pending_replicates.size()));
     segment_count++;
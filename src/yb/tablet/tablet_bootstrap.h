@@ -101,6 +101,11 @@ class TabletBootstrap {
   // Opens a new log in the tablet's log directory.  The directory is expected to be clean.
   CHECKED_STATUS OpenNewLog();
 
+  // Prepares the tablet and its log without replaying the log, if the tablet was shut down
+  // cleanly at 'clean_shutdown_op_id'. Returns false when the log should be replayed.
+  Result<bool> SkipReplayAfterCleanShutdown(
+      const yb::OpId& clean_shutdown_op_id, consensus::ConsensusBootstrapInfo* consensus_info);
+
   // Finishes bootstrap, setting 'rebuilt_log' and 'rebuilt_tablet'.
   CHECKED_STATUS FinishBootstrap(const std::string& message,
                                  scoped_refptr<log::Log>* rebuilt_log,
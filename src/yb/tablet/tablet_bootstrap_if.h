@@ -125,6 +125,9 @@ struct BootstrapTabletData {
   TransactionCoordinatorContext* transaction_coordinator_context;
   ThreadPool* append_pool;
   consensus::RetryableRequests* retryable_requests;
+  // Pool used to read log segments ahead of their replay. Segments are read by the bootstrap
+  // thread itself when it is null.
+  ThreadPool* log_read_pool;
 };
 
 // Bootstraps a tablet, initializing it with the provided metadata. If the tablet
@@ -35,6 +35,7 @@ typedef YB_EDITION_NS_PREFIX Tablet TabletClass;
 typedef YB_EDITION_NS_PREFIX TabletPeer TabletPeerClass;
 
 YB_STRONGLY_TYPED_BOOL(RequireLease);
+YB_STRONGLY_TYPED_BOOL(FlushOnShutdown);
 
 }  // namespace tablet
 }  // namespace yb
@@ -56,6 +56,7 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/monotime.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 #include "yb/util/status.h"
@@ -68,6 +69,12 @@ TAG_FLAG(enable_tablet_orphaned_block_deletion, advanced);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, hidden);
 TAG_FLAG(enable_tablet_orphaned_block_deletion, runtime);
 
+DEFINE_int32(tablet_metadata_flush_coalesce_delay_ms, 0,
+             "Time a superblock write waits before taking the metadata, so that changes made by "
+             "concurrent callers of TabletMetadata::Flush are persisted by the same write.");
+TAG_FLAG(tablet_metadata_flush_coalesce_delay_ms, advanced);
+TAG_FLAG(tablet_metadata_flush_coalesce_delay_ms, runtime);
+
 using std::shared_ptr;
 
 using base::subtle::Barrier_AtomicIncrement;
@@ -521,6 +528,12 @@ Status TabletMetadata::LoadFromSuperBlock(const TabletSuperBlockPB& superblock)
       tombstone_last_logged_opid_ = OpId();
     }
 
+    if (superblock.has_clean_shutdown_op_id()) {
+      clean_shutdown_op_id_ = yb::OpId::FromPB(superblock.clean_shutdown_op_id());
+    } else {
+      clean_shutdown_op_id_ = OpId();
+    }
+
     std::unique_ptr<TableInfo> table_info(new TableInfo());
     RETURN_NOT_OK(table_info->LoadFromSuperBlock(superblock));
     primary_table_id_ = table_info->table_id;
@@ -606,9 +619,26 @@ Status TabletMetadata::Flush() {
   TRACE_EVENT1("tablet", "TabletMetadata::Flush",
                "tablet_id", tablet_id_);
 
+  uint64_t request;
+  {
+    std::lock_guard<LockType> l(data_lock_);
+    request = ++flush_requests_;
+  }
+
   MutexLock l_flush(flush_lock_);
+  // Flushes are serialized, so while this one waited, another one could have taken the metadata
+  // with the changes this one was called for. Then there is nothing left to write.
+  if (flushed_requests_ >= request) {
+    TRACE("Metadata flushed by a concurrent flush");
+    return Status::OK();
+  }
+  if (FLAGS_tablet_metadata_flush_coalesce_delay_ms > 0) {
+    SleepFor(MonoDelta::FromMilliseconds(FLAGS_tablet_metadata_flush_coalesce_delay_ms));
+  }
+
   vector<BlockId> orphaned;
   TabletSuperBlockPB pb;
+  uint64_t covered_requests;
   {
     std::lock_guard<LockType> l(data_lock_);
     CHECK_GE(num_flush_pins_, 0);
@@ -620,6 +650,7 @@ Status TabletMetadata::Flush() {
     needs_flush_ = false;
 
     RETURN_NOT_OK(ToSuperBlockUnlocked(&pb));
+    covered_requests = flush_requests_;
 
     // Make a copy of the orphaned blocks list which corresponds to the superblock
     // that we're writing. It's important to take this local copy to avoid a race
@@ -629,8 +660,14 @@ Status TabletMetadata::Flush() {
     // is persisted. See KUDU-701 for details.
     orphaned.assign(orphaned_blocks_.begin(), orphaned_blocks_.end());
   }
-  RETURN_NOT_OK(ReplaceSuperBlockUnlocked(pb));
-  TRACE("Metadata flushed");
+  if (pb.SerializeAsString() == last_written_superblock_) {
+    // Nothing changed since the last write, e.g. a flush of a tablet that was only opened.
+    TRACE("Metadata unchanged");
+  } else {
+    RETURN_NOT_OK(ReplaceSuperBlockUnlocked(pb));
+    TRACE("Metadata flushed");
+  }
+  flushed_requests_ = covered_requests;
   l_flush.Unlock();
 
   // Now that the superblock is written, try to delete the orphaned blocks.
@@ -658,10 +695,13 @@ Status TabletMetadata::ReplaceSuperBlockUnlocked(const TabletSuperBlockPB &pb) {
   flush_lock_.AssertAcquired();
 
   string path = fs_manager_->GetTabletMetadataPath(tablet_id_);
+  last_written_superblock_.clear();
   RETURN_NOT_OK_PREPEND(pb_util::WritePBContainerToPath(
                             fs_manager_->env(), path, pb,
                             pb_util::OVERWRITE, pb_util::SYNC),
                         Substitute("Failed to write tablet metadata $0", tablet_id_));
+  last_written_superblock_ = pb.SerializeAsString();
+  num_superblock_writes_.fetch_add(1, std::memory_order_relaxed);
 
   return Status::OK();
 }
@@ -702,6 +742,9 @@ Status TabletMetadata::ToSuperBlockUnlocked(TabletSuperBlockPB* superblock) cons
   if (tombstone_last_logged_opid_) {
     tombstone_last_logged_opid_.ToPB(pb.mutable_tombstone_last_logged_opid());
   }
+  if (clean_shutdown_op_id_) {
+    clean_shutdown_op_id_.ToPB(pb.mutable_clean_shutdown_op_id());
+  }
 
   for (const BlockId& block_id : orphaned_blocks_) {
     block_id.CopyToPB(pb.mutable_orphaned_blocks()->Add());
@@ -807,5 +850,15 @@ TabletDataState TabletMetadata::tablet_data_state() const {
   return tablet_data_state_;
 }
 
+void TabletMetadata::set_clean_shutdown_op_id(const yb::OpId& op_id) {
+  std::lock_guard<LockType> l(data_lock_);
+  clean_shutdown_op_id_ = op_id;
+}
+
+yb::OpId TabletMetadata::clean_shutdown_op_id() const {
+  std::lock_guard<LockType> l(data_lock_);
+  return clean_shutdown_op_id_;
+}
+
 } // namespace tablet
 } // namespace yb
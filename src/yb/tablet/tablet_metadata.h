@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_TABLET_METADATA_H
 #define YB_TABLET_TABLET_METADATA_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -296,8 +297,16 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // this method.
   CHECKED_STATUS UnPinFlush();
 
+  // Writes the superblock. Concurrent calls are coalesced: a call whose changes were persisted by
+  // a write that started while it waited does not write again. The superblock is not written when
+  // it did not change since the last write.
   CHECKED_STATUS Flush();
 
+  // Number of superblock writes done through this object.
+  int64_t num_superblock_writes() const {
+    return num_superblock_writes_.load(std::memory_order_relaxed);
+  }
+
   // Adds the blocks referenced by 'block_ids' to 'orphaned_blocks_'.
   //
   // This set will be written to the on-disk metadata in any subsequent
@@ -339,6 +348,10 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
 
   yb::OpId tombstone_last_logged_opid() const { return tombstone_last_logged_opid_; }
 
+  // Set / get the OpId of the last operation flushed before a clean shutdown of the tablet.
+  void set_clean_shutdown_op_id(const yb::OpId& op_id);
+  yb::OpId clean_shutdown_op_id() const;
+
   // Loads the currently-flushed superblock from disk into the given protobuf.
   CHECKED_STATUS ReadSuperBlockFromDisk(TabletSuperBlockPB* superblock) const;
 
@@ -429,6 +442,18 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // If taken together with 'data_lock_', must be acquired first.
   mutable Mutex flush_lock_;
 
+  // Number of Flush() calls so far. Protected by 'data_lock_'.
+  uint64_t flush_requests_ = 0;
+
+  // Value of flush_requests_ when the metadata persisted by the last flush was taken. Protected by
+  // 'flush_lock_'.
+  uint64_t flushed_requests_ = 0;
+
+  // Serialized superblock written last, empty if unknown. Protected by 'flush_lock_'.
+  std::string last_written_superblock_;
+
+  std::atomic<int64_t> num_superblock_writes_{0};
+
   // The tablet id and partition.
   const std::string tablet_id_;
   Partition partition_;
@@ -468,6 +493,10 @@ class TabletMetadata : public RefCountedThreadSafe<TabletMetadata> {
   // non-tombstoned tablets.
   yb::OpId tombstone_last_logged_opid_;
 
+  // OpId of the last operation flushed before a clean shutdown, invalid if the tablet was not
+  // shut down cleanly since the last bootstrap.
+  yb::OpId clean_shutdown_op_id_;
+
   // If this counter is > 0 then Flush() will not write any data to disk.
   int32_t num_flush_pins_ = 0;
 
@@ -74,6 +74,11 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, transaction_apply_lag, "Transaction apply lag", yb::MetricUnit::kMicroseconds,
+    "Time from commit of a distributed transaction to apply of its intents to this tablet",
+    60000000LU, 2);
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -114,6 +119,17 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, compaction_debt_rejections,
+  "Compaction Debt Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of write RPC requests rejected because compactions of the tablet fell behind.");
+
+METRIC_DEFINE_counter(tablet, read_concurrency_rejections,
+  "Read Concurrency Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of read RPC requests rejected because the tablet already served the maximum number of "
+  "concurrent reads.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -129,6 +145,36 @@ METRIC_DEFINE_counter(tablet, restart_read_requests,
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, read_cpu_time,
+  "Read CPU Time",
+  yb::MetricUnit::kMicroseconds,
+  "CPU time spent by tablet server threads serving reads of this tablet.");
+
+METRIC_DEFINE_counter(tablet, read_block_cache_hits,
+  "Read Block Cache Hits",
+  yb::MetricUnit::kBlocks,
+  "Number of RocksDB blocks found in the block cache by reads of this tablet.");
+
+METRIC_DEFINE_counter(tablet, read_block_reads,
+  "Read Block Reads",
+  yb::MetricUnit::kBlocks,
+  "Number of RocksDB blocks read from SST files by reads of this tablet.");
+
+METRIC_DEFINE_counter(tablet, read_block_read_bytes,
+  "Read Block Read Bytes",
+  yb::MetricUnit::kBytes,
+  "Number of bytes of RocksDB blocks read from SST files by reads of this tablet.");
+
+METRIC_DEFINE_counter(tablet, read_memtable_lookups,
+  "Read Memtable Lookups",
+  yb::MetricUnit::kOperations,
+  "Number of memtable point lookups and seeks done by reads of this tablet.");
+
+METRIC_DEFINE_counter(tablet, read_seeks,
+  "Read Seeks",
+  yb::MetricUnit::kOperations,
+  "Number of RocksDB iterator seeks done by reads of this tablet.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -140,12 +186,21 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(transaction_apply_lag),
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
+    MINIT(compaction_debt_rejections),
+    MINIT(read_concurrency_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
-    MINIT(restart_read_requests) {
+    MINIT(restart_read_requests),
+    MINIT(read_cpu_time),
+    MINIT(read_block_cache_hits),
+    MINIT(read_block_reads),
+    MINIT(read_block_read_bytes),
+    MINIT(read_memtable_lookups),
+    MINIT(read_seeks) {
 }
 #undef MINIT
 
@@ -57,14 +57,25 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  scoped_refptr<Histogram> transaction_apply_lag;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> compaction_debt_rejections;
+  scoped_refptr<Counter> read_concurrency_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
+
+  // Resources consumed by reads.
+  scoped_refptr<Counter> read_cpu_time;
+  scoped_refptr<Counter> read_block_cache_hits;
+  scoped_refptr<Counter> read_block_reads;
+  scoped_refptr<Counter> read_block_read_bytes;
+  scoped_refptr<Counter> read_memtable_lookups;
+  scoped_refptr<Counter> read_seeks;
 };
 
 class ScopedTabletMetricsTracker {
@@ -17,15 +17,29 @@ namespace rocksdb {
 class Cache;
 class EventListener;
 class MemoryMonitor;
+class RateLimiter;
 }
 
 namespace yb {
+
+class ThreadPool;
+
 namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Cache of compressed blocks on a local device, used under block_cache. May be null.
+  std::shared_ptr<rocksdb::Cache> persistent_block_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
+  // Limits write rate of flushes and compactions of all tablets together. May be null, in this
+  // case each tablet has its own limit.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
+  // Pool used to scan sub-ranges of a tablet in parallel. Not owned, may be null.
+  ThreadPool* read_pool = nullptr;
+  // Pool used to insert updates of a large write batch into the memtable from several threads.
+  // Not owned, may be null.
+  ThreadPool* memtable_insert_pool = nullptr;
 };
 
 } // namespace tablet
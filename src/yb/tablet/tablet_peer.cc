@@ -162,7 +162,9 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
                                   const scoped_refptr<MetricEntity> &metric_entity,
                                   ThreadPool* raft_pool,
                                   ThreadPool* tablet_prepare_pool,
-                                  consensus::RetryableRequests* retryable_requests) {
+                                  consensus::RetryableRequests* retryable_requests,
+                                  consensus::MultiRaftManager* multi_raft_manager,
+                                  AsyncIoExecutor* io_executor) {
 
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
   DCHECK(log) << "A TabletPeer must be provided with a Log";
@@ -230,7 +232,9 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
         mark_dirty_clbk_,
         tablet_->table_type(),
         raft_pool,
-        retryable_requests);
+        retryable_requests,
+        multi_raft_manager,
+        io_executor);
     has_consensus_.store(true, std::memory_order_release);
     auto ht_lease_provider = [this](MicrosTime min_allowed, MonoTime deadline) {
       MicrosTime lease_micros {
@@ -256,7 +260,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
       return mvcc_manager->SafeTime(ht_lease);
     });
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_->GetMetricEntity());
 
     consensus_->SetMajorityReplicatedListener([mvcc_manager, ht_lease_provider] {
       auto ht_lease = ht_lease_provider(/* min_allowed */ 0, /* deadline */ MonoTime::kMax);
@@ -348,7 +353,7 @@ bool TabletPeer::StartShutdown() {
   return true;
 }
 
-void TabletPeer::CompleteShutdown() {
+void TabletPeer::CompleteShutdown(FlushOnShutdown flush_on_shutdown) {
   // TODO: KUDU-183: Keep track of the pending tasks and send an "abort" message.
   LOG_SLOW_EXECUTION(WARNING, 1000,
       Substitute("TabletPeer: tablet $0: Waiting for Operations to complete", tablet_id())) {
@@ -359,7 +364,9 @@ void TabletPeer::CompleteShutdown() {
     prepare_thread_->Stop();
   }
 
+  yb::OpId last_logged_op_id;
   if (log_) {
+    last_logged_op_id = log_->GetLatestEntryOpId();
     WARN_NOT_OK(log_->Close(), "Error closing the Log.");
   }
 
@@ -368,6 +375,10 @@ void TabletPeer::CompleteShutdown() {
   }
 
   if (tablet_) {
+    if (flush_on_shutdown && consensus_ && last_logged_op_id) {
+      WARN_NOT_OK(FlushAndMarkCleanShutdown(last_logged_op_id),
+                  LogPrefix() + "Failed to flush tablet on shutdown");
+    }
     tablet_->Shutdown();
   }
 
@@ -386,6 +397,27 @@ void TabletPeer::CompleteShutdown() {
   }
 }
 
+Status TabletPeer::FlushAndMarkCleanShutdown(const yb::OpId& last_logged_op_id) {
+  // All operations in the tracker are finished, so every committed operation is applied.
+  OpId committed_op_id;
+  RETURN_NOT_OK(consensus_->GetLastOpId(consensus::COMMITTED_OPID, &committed_op_id));
+  if (yb::OpId::FromPB(committed_op_id) != last_logged_op_id) {
+    LOG_WITH_PREFIX(INFO) << "Not marking clean shutdown, last logged op id "
+                          << last_logged_op_id << " is not committed: "
+                          << committed_op_id.ShortDebugString();
+    return Status::OK();
+  }
+
+  LOG_TIMING_PREFIX(INFO, LogPrefix(), "flushing tablet on shutdown") {
+    RETURN_NOT_OK(tablet_->Flush(FlushMode::kSync));
+  }
+  if (VERIFY_RESULT(tablet_->HasMemTableEntries())) {
+    return STATUS(IllegalState, "Memtables are not empty after flush");
+  }
+  meta_->set_clean_shutdown_op_id(last_logged_op_id);
+  return meta_->Flush();
+}
+
 void TabletPeer::WaitUntilShutdown() {
   while (state_.load(std::memory_order_acquire) != TabletStatePB::SHUTDOWN) {
     SleepFor(MonoDelta::FromMilliseconds(10));
@@ -784,6 +816,14 @@ void TabletPeer::SetPropagatedSafeTime(HybridTime ht) {
   (**driver).ExecuteAsync();
 }
 
+void TabletPeer::StartApplyBatch() {
+  tablet_->StartApplyBatch();
+}
+
+void TabletPeer::FinishApplyBatch() {
+  tablet_->FinishApplyBatch();
+}
+
 consensus::Consensus* TabletPeer::consensus() const {
   std::lock_guard<simple_spinlock> lock(lock_);
   return consensus_.get();
@@ -79,6 +79,7 @@ class CatchUpServiceTest;
 class UpdateTransactionResponsePB;
 }
 
+class AsyncIoExecutor;
 class MaintenanceManager;
 class MaintenanceOp;
 class ThreadPool;
@@ -117,7 +118,9 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
                                 const scoped_refptr<MetricEntity> &metric_entity,
                                 ThreadPool* raft_pool,
                                 ThreadPool* tablet_prepare_pool,
-                                consensus::RetryableRequests* retryable_requests);
+                                consensus::RetryableRequests* retryable_requests,
+                                consensus::MultiRaftManager* multi_raft_manager = nullptr,
+                                AsyncIoExecutor* io_executor = nullptr);
 
   // Starts the TabletPeer, making it available for Write()s. If this
   // TabletPeer is part of a consensus configuration this will connect it to other peers
@@ -128,7 +131,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // Returns true if shutdown was just initiated, false if shutdown was already running.
   MUST_USE_RESULT bool StartShutdown();
   // Completes shutdown process and waits for it's completeness.
-  void CompleteShutdown();
+  // With flush_on_shutdown the tablet is flushed before it is shut down, and when all operations
+  // of the log turn out to be flushed, a clean shutdown marker is stored in the tablet metadata,
+  // so the next bootstrap does not have to replay the log.
+  void CompleteShutdown(FlushOnShutdown flush_on_shutdown = FlushOnShutdown::kFalse);
 
   void Shutdown();
 
@@ -173,6 +179,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // UpdateReplica -> EnqueuePreparesUnlocked on Raft heartbeats.
   void SetPropagatedSafeTime(HybridTime ht) override;
 
+  void StartApplyBatch() override;
+
+  void FinishApplyBatch() override;
+
   consensus::Consensus* consensus() const;
 
   std::shared_ptr<consensus::Consensus> shared_consensus() const;
@@ -411,6 +421,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
  private:
   HybridTime ReportReadRestart() override;
 
+  // Flushes the tablet and stores the clean shutdown marker in its metadata, if every operation
+  // of the log up to 'last_logged_op_id' is committed.
+  CHECKED_STATUS FlushAndMarkCleanShutdown(const yb::OpId& last_logged_op_id);
+
   bool IsLeader() override {
     return LeaderTerm() != OpId::kUnknownTerm;
   }
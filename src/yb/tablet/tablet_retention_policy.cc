@@ -18,22 +18,35 @@
 #include "yb/tablet/tablet_retention_policy.h"
 
 DEFINE_int32(timestamp_history_retention_interval_sec, 10,
-             "The time interval in seconds to retain DocDB history for. This should be "
-             "supplemented with read point tracking.");
+             "The time interval in seconds to retain DocDB history for, unless the table sets "
+             "history_retention_min_seconds. This is supplemented with read point tracking.");
 
 namespace yb {
 namespace tablet {
 
 using docdb::TableTTL;
 
-TabletRetentionPolicy::TabletRetentionPolicy(const Tablet* tablet)
-    : tablet_(tablet),
-      retention_delta_(MonoDelta::FromSeconds(-FLAGS_timestamp_history_retention_interval_sec)) {}
+TabletRetentionPolicy::TabletRetentionPolicy(const Tablet* tablet) : tablet_(tablet) {}
 
 HybridTime TabletRetentionPolicy::GetHistoryCutoff() {
-  return std::min<HybridTime>(
+  const TableProperties& table_properties = tablet_->metadata()->schema().table_properties();
+  const int64_t min_retention_sec = table_properties.HasHistoryRetentionMinSec()
+      ? table_properties.history_retention_min_sec()
+      : FLAGS_timestamp_history_retention_interval_sec;
+  const HybridTime now = tablet_->clock()->Now();
+  HybridTime history_cutoff = std::min<HybridTime>(
       tablet_->OldestReadPoint(),
-      server::HybridClock::AddPhysicalTimeToHybridTime(tablet_->clock()->Now(), retention_delta_));
+      server::HybridClock::AddPhysicalTimeToHybridTime(
+          now, MonoDelta::FromSeconds(-min_retention_sec)));
+  if (table_properties.HasHistoryRetentionMaxSec()) {
+    // Readers older than the maximum retention no longer hold back garbage collection, so they
+    // might miss overwritten versions.
+    history_cutoff = std::max<HybridTime>(
+        history_cutoff,
+        server::HybridClock::AddPhysicalTimeToHybridTime(
+            now, MonoDelta::FromSeconds(-table_properties.history_retention_max_sec())));
+  }
+  return history_cutoff;
 }
 
 ColumnIdsPtr TabletRetentionPolicy::GetDeletedColumns() {
@@ -27,16 +27,15 @@ namespace tablet {
 class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
  public:
   explicit TabletRetentionPolicy(const Tablet* tablet);
+
+  // Returns the oldest read point of the tablet, but retains history for at least the table's
+  // history_retention_min_sec and at most its history_retention_max_sec.
   HybridTime GetHistoryCutoff() override;
   ColumnIdsPtr GetDeletedColumns() override;
   MonoDelta GetTableTTL() override;
 
  private:
   const Tablet* tablet_;
-
-  // The delta to be added to the current time to get the history cutoff timestamp. This is always
-  // a negative amount.
-  MonoDelta retention_delta_;
 };
 
 }  // namespace tablet
@@ -16,6 +16,7 @@
 #include "yb/tablet/transaction_coordinator.h"
 
 #include <condition_variable>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -233,13 +234,14 @@ class TransactionState {
 
   CHECKED_STATUS GetStatus(tserver::GetTransactionStatusResponsePB* response) const {
     if (status_ == TransactionStatus::COMMITTED) {
-      response->set_status(TransactionStatus::COMMITTED);
-      response->set_status_hybrid_time(commit_time_.ToUint64());
+      response->add_status(TransactionStatus::COMMITTED);
+      response->add_status_hybrid_time(commit_time_.ToUint64());
     } else if (status_ == TransactionStatus::ABORTED) {
-      response->set_status(TransactionStatus::ABORTED);
+      response->add_status(TransactionStatus::ABORTED);
+      response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
-      response->set_status(TransactionStatus::PENDING);
+      response->add_status(TransactionStatus::PENDING);
       HybridTime status_ht = context_.coordinator_context().clock().Now();
       if (replicating_) {
         auto replicating_status = replicating_->request()->status();
@@ -252,7 +254,7 @@ class TransactionState {
         }
       }
       status_ht = std::min(status_ht, context_.coordinator_context().HtLeaseExpiration());
-      response->set_status_hybrid_time(status_ht.Decremented().ToUint64());
+      response->add_status_hybrid_time(status_ht.Decremented().ToUint64());
     }
     return Status::OK();
   }
@@ -636,20 +638,25 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     rpcs_.Shutdown();
   }
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response) {
-    auto id = FullyDecodeTransactionId(transaction_id);
-    if (!id.ok()) {
-      return std::move(id.status());
+    std::vector<TransactionId> ids;
+    ids.reserve(transaction_ids.size());
+    for (const auto& transaction_id : transaction_ids) {
+      ids.push_back(VERIFY_RESULT(FullyDecodeTransactionId(transaction_id)));
     }
 
     std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto it = managed_transactions_.find(*id);
-    if (it == managed_transactions_.end()) {
-      response->set_status(TransactionStatus::ABORTED);
-      return Status::OK();
+    for (const auto& id : ids) {
+      auto it = managed_transactions_.find(id);
+      if (it == managed_transactions_.end()) {
+        response->add_status(TransactionStatus::ABORTED);
+        response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
+      } else {
+        RETURN_NOT_OK(it->GetStatus(response));
+      }
     }
-    return it->GetStatus(response);
+    return Status::OK();
   }
 
   void Abort(const std::string& transaction_id, int64_t term, TransactionAbortCallback callback) {
@@ -749,37 +756,31 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
   }
 
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request, int64_t term) {
-    auto& state = *request->request();
-    auto id = FullyDecodeTransactionId(state.transaction_id());
-    if (!id.ok()) {
-      LOG(WARNING) << "Failed to decode id from " << state.ShortDebugString() << ": " << id;
-      request->CompleteWithStatus(id.status());
-      return;
-    }
+    std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests;
+    requests.push_back(std::move(request));
+    Handle(std::move(requests), term);
+  }
 
+  void Handle(std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests,
+              int64_t term) {
+    // Requests that could not be handled are completed after releasing the lock.
+    std::vector<std::pair<std::unique_ptr<tablet::UpdateTxnOperationState>, Status>> rejected;
     PostponedLeaderActions actions;
     {
-      std::unique_lock<std::mutex> lock(managed_mutex_);
+      std::lock_guard<std::mutex> lock(managed_mutex_);
       postponed_leader_actions_.leader_term = term;
-      auto it = managed_transactions_.find(*id);
-      if (it == managed_transactions_.end()) {
-        if (state.status() == TransactionStatus::CREATED) {
-          it = managed_transactions_.emplace(
-              this, *id, context_.clock().Now(), log_prefix_).first;
-        } else {
-          lock.unlock();
-          YB_LOG_HIGHER_SEVERITY_WHEN_TOO_MANY(INFO, WARNING, 1s, 50)
-              << LogPrefix() << "Request to unknown transaction " << id << ": "
-              << state.ShortDebugString();
-          request->CompleteWithStatus(STATUS(Expired, "Transaction expired"));
-          return;
+      for (auto& request : requests) {
+        auto status = HandleUnlocked(&request);
+        if (!status.ok()) {
+          rejected.emplace_back(std::move(request), std::move(status));
         }
       }
-
-      Modify(it).Handle(std::move(request));
       postponed_leader_actions_.Swap(&actions);
     }
 
+    for (auto& request_and_status : rejected) {
+      request_and_status.first->CompleteWithStatus(request_and_status.second);
+    }
     ExecutePostponedLeaderActions(&actions);
   }
 
@@ -822,6 +823,30 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
       >
   > ManagedTransactions;
 
+  // Passes request to its transaction, or returns the status it should be completed with.
+  CHECKED_STATUS HandleUnlocked(std::unique_ptr<tablet::UpdateTxnOperationState>* request) {
+    auto& state = *(*request)->request();
+    auto id = FullyDecodeTransactionId(state.transaction_id());
+    if (!id.ok()) {
+      LOG(WARNING) << "Failed to decode id from " << state.ShortDebugString() << ": " << id;
+      return id.status();
+    }
+
+    auto it = managed_transactions_.find(*id);
+    if (it == managed_transactions_.end()) {
+      if (state.status() != TransactionStatus::CREATED) {
+        YB_LOG_HIGHER_SEVERITY_WHEN_TOO_MANY(INFO, WARNING, 1s, 50)
+            << LogPrefix() << "Request to unknown transaction " << id << ": "
+            << state.ShortDebugString();
+        return STATUS(Expired, "Transaction expired");
+      }
+      it = managed_transactions_.emplace(this, *id, context_.clock().Now(), log_prefix_).first;
+    }
+
+    Modify(it).Handle(std::move(*request));
+    return Status::OK();
+  }
+
   static TransactionState& Modify(const ManagedTransactions::iterator& it) {
     return const_cast<TransactionState&>(*it);
   }
@@ -836,16 +861,27 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     }
 
     if (!actions->notify_applying.empty()) {
-      auto deadline = TransactionRpcDeadline();
+      // Transactions applying in the same participant tablet are sent by a single RPC.
+      std::unordered_map<TabletId, tserver::UpdateTransactionRequestPB> requests;
       for (const auto& p : actions->notify_applying) {
-        tserver::UpdateTransactionRequestPB req;
-        req.set_tablet_id(p.tablet);
-        auto& state = *req.mutable_state();
-        state.set_transaction_id(p.transaction.begin(), p.transaction.size());
-        state.set_status(TransactionStatus::APPLYING);
-        state.add_tablets(context_.tablet_id());
-        state.set_commit_hybrid_time(p.commit_time.ToUint64());
+        auto it = requests.find(p.tablet);
+        tserver::TransactionStatePB* state;
+        if (it == requests.end()) {
+          auto& req = requests[p.tablet];
+          req.set_tablet_id(p.tablet);
+          state = req.mutable_state();
+        } else {
+          state = it->second.add_additional_states();
+        }
+        state->set_transaction_id(p.transaction.begin(), p.transaction.size());
+        state->set_status(TransactionStatus::APPLYING);
+        state->add_tablets(context_.tablet_id());
+        state->set_commit_hybrid_time(p.commit_time.ToUint64());
+      }
 
+      auto deadline = TransactionRpcDeadline();
+      for (auto& tablet_and_request : requests) {
+        auto& req = tablet_and_request.second;
         auto handle = rpcs_.Prepare();
         if (handle != rpcs_.InvalidHandle()) {
           *handle = UpdateTransaction(
@@ -1031,6 +1067,11 @@ void TransactionCoordinator::Handle(
   impl_->Handle(std::move(request), term);
 }
 
+void TransactionCoordinator::Handle(
+    std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests, int64_t term) {
+  impl_->Handle(std::move(requests), term);
+}
+
 void TransactionCoordinator::Start() {
   impl_->Start();
 }
@@ -1039,9 +1080,10 @@ void TransactionCoordinator::Shutdown() {
   impl_->Shutdown();
 }
 
-Status TransactionCoordinator::GetStatus(const std::string& transaction_id,
-                                         tserver::GetTransactionStatusResponsePB* response) {
-  return impl_->GetStatus(transaction_id, response);
+Status TransactionCoordinator::GetStatus(
+    const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
+    tserver::GetTransactionStatusResponsePB* response) {
+  return impl_->GetStatus(transaction_ids, response);
 }
 
 void TransactionCoordinator::Abort(const std::string& transaction_id,
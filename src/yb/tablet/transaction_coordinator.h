@@ -18,6 +18,9 @@
 
 #include <future>
 #include <memory>
+#include <vector>
+
+#include <google/protobuf/repeated_field.h>
 
 #include "yb/client/client_fwd.h"
 
@@ -120,6 +123,10 @@ class TransactionCoordinator {
   // Handles new request for transaction update.
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request, int64_t term);
 
+  // Handles a batch of requests, i.e. heartbeats of several transactions, under one lock.
+  void Handle(std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests,
+              int64_t term);
+
   // Prepares log garbage collection. Return min index that should be preserved.
   int64_t PrepareGC();
 
@@ -130,7 +137,8 @@ class TransactionCoordinator {
   // And like most of other Shutdowns in our codebase it wait until shutdown completes.
   void Shutdown();
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  // Fills status and status hybrid time of every transaction, in the same order.
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response);
 
   void Abort(const std::string& transaction_id, int64_t term, TransactionAbortCallback callback);
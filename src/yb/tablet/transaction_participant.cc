@@ -15,8 +15,11 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <unordered_map>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -42,6 +45,8 @@
 
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/random_util.h"
@@ -55,6 +60,12 @@ DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
+DEFINE_int32(transaction_status_requests_in_flight_per_tablet, 1,
+             "Max number of transaction status RPCs in flight from a participant to a status "
+             "tablet. Status requests issued meanwhile are sent by one RPC when a slot frees up. "
+             "0 to send every request immediately.");
+TAG_FLAG(transaction_status_requests_in_flight_per_tablet, advanced);
+TAG_FLAG(transaction_status_requests_in_flight_per_tablet, runtime);
 
 namespace yb {
 namespace tablet {
@@ -147,14 +158,37 @@ class RunningTransactionContext {
 
   virtual const std::string& LogPrefix() const = 0;
 
+  // Requests status of the transaction from its status tablet. Requests to the same status tablet
+  // are batched while the limit of RPCs in flight to it is reached.
+  void RequestStatus(
+      client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& transaction);
+
  protected:
   friend class RunningTransaction;
 
+  typedef std::vector<std::pair<RunningTransactionPtr, int64_t>> StatusRequests;
+
+  struct StatusRequestBatch {
+    // Transactions and serial numbers of their requests.
+    StatusRequests pending;
+    int in_flight = 0;
+  };
+
+  void SendStatusRequests(client::YBClient* client, const TabletId& status_tablet,
+                          StatusRequestBatch* batch, std::unique_lock<std::mutex>* lock);
+
+  void StatusRequestsDone(client::YBClient* client, const TabletId& status_tablet,
+                          rpc::Rpcs::Handle handle, const StatusRequests& requests, Status status,
+                          const tserver::GetTransactionStatusResponsePB& response);
+
   rpc::Rpcs rpcs_;
   TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
+
+  std::mutex status_requests_mutex_;
+  std::unordered_map<TabletId, StatusRequestBatch> status_request_batches_;
 };
 
 class RemoveIntentsTask : public rpc::ThreadPoolTask {
@@ -336,12 +370,11 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
         context_(*context),
         remove_intents_task_(&context->applier_, &context->participant_context_,
                              metadata_.transaction_id),
-        get_status_handle_(context->rpcs_.InvalidHandle()),
         abort_handle_(context->rpcs_.InvalidHandle()) {
   }
 
   ~RunningTransaction() {
-    context_.rpcs_.Abort({&get_status_handle_, &abort_handle_});
+    context_.rpcs_.Abort({&abort_handle_});
   }
 
   const TransactionId& id() const {
@@ -394,7 +427,7 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     auto request_id = context_.NextRequestIdUnlocked();
     auto shared_self = shared_from_this();
     lock->unlock();
-    SendStatusRequest(client, request_id, shared_self);
+    context_.RequestStatus(client, request_id, shared_self);
   }
 
   void Abort(client::YBClient* client,
@@ -446,26 +479,13 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     }
   }
 
-  void SendStatusRequest(
-      client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& shared_self) {
-    tserver::GetTransactionStatusRequestPB req;
-    req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
-    req.set_propagated_hybrid_time(context_.participant_context_.Now().ToUint64());
-    context_.rpcs_.RegisterAndStart(
-        client::GetTransactionStatus(
-            TransactionRpcDeadline(),
-            nullptr /* tablet */,
-            client,
-            &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no,
-                      shared_self)),
-        &get_status_handle_);
-  }
+  friend class RunningTransactionContext;
 
+  // Handles status of this transaction at the specified index of the batched response.
   void StatusReceived(client::YBClient* client,
                       const Status& status,
                       const tserver::GetTransactionStatusResponsePB& response,
+                      int index,
                       int64_t serial_no,
                       const RunningTransactionPtr& shared_self) {
     auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
@@ -473,22 +493,18 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       delayer_.Delay(
           MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
           std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, shared_self));
+                    index, serial_no, shared_self));
     } else {
-      DoStatusReceived(client, status, response, serial_no, shared_self);
+      DoStatusReceived(client, status, response, index, serial_no, shared_self);
     }
   }
 
   void DoStatusReceived(client::YBClient* client,
                         const Status& status,
                         const tserver::GetTransactionStatusResponsePB& response,
+                        int index,
                         int64_t serial_no,
                         const RunningTransactionPtr& shared_self) {
-    if (response.has_propagated_hybrid_time()) {
-      context_.participant_context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
-    }
-
-    context_.rpcs_.Unregister(&get_status_handle_);
     decltype(status_waiters_) status_waiters;
     HybridTime time_of_status;
     TransactionStatus transaction_status;
@@ -505,15 +521,16 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
         return;
       }
 
-      DCHECK(response.has_status_hybrid_time() ||
-             response.status() == TransactionStatus::ABORTED);
-      time_of_status = response.has_status_hybrid_time()
-          ? HybridTime(response.status_hybrid_time())
+      auto response_status = response.status(index);
+      DCHECK(index < response.status_hybrid_time().size() ||
+             response_status == TransactionStatus::ABORTED);
+      time_of_status = index < response.status_hybrid_time().size()
+          ? HybridTime(response.status_hybrid_time(index))
           : HybridTime::kMax;
       if (last_known_status_hybrid_time_ <= time_of_status) {
         last_known_status_hybrid_time_ = time_of_status;
-        last_known_status_ = response.status();
-        if (response.status() == TransactionStatus::ABORTED) {
+        last_known_status_ = response_status;
+        if (response_status == TransactionStatus::ABORTED) {
           if (!local_commit_time_ && remove_intents_task_.Prepare(shared_self)) {
             context_.participant_context_.thread_pool().Enqueue(&remove_intents_task_);
             VLOG_WITH_PREFIX(1) << "Transaction should be aborted: " << id();
@@ -531,7 +548,7 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       }
     }
     if (new_request_id >= 0) {
-      SendStatusRequest(client, new_request_id, shared_self);
+      context_.RequestStatus(client, new_request_id, shared_self);
     }
     NotifyWaiters(serial_no, time_of_status, transaction_status, status_waiters);
   }
@@ -635,7 +652,6 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   TransactionStatus last_known_status_;
   HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   std::vector<StatusRequest> status_waiters_;
-  rpc::Rpcs::Handle get_status_handle_;
   rpc::Rpcs::Handle abort_handle_;
   std::vector<TransactionStatusCallback> abort_waiters_;
 
@@ -643,6 +659,89 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   Delayer delayer_;
 };
 
+void RunningTransactionContext::RequestStatus(
+    client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& transaction) {
+  const auto& status_tablet = transaction->metadata().status_tablet;
+  std::unique_lock<std::mutex> lock(status_requests_mutex_);
+  auto& batch = status_request_batches_[status_tablet];
+  batch.pending.emplace_back(transaction, serial_no);
+  auto limit = GetAtomicFlag(&FLAGS_transaction_status_requests_in_flight_per_tablet);
+  if (limit > 0 && batch.in_flight >= limit) {
+    // Will be sent when one of requests in flight completes.
+    return;
+  }
+  SendStatusRequests(client, status_tablet, &batch, &lock);
+}
+
+void RunningTransactionContext::SendStatusRequests(
+    client::YBClient* client, const TabletId& status_tablet, StatusRequestBatch* batch,
+    std::unique_lock<std::mutex>* lock) {
+  StatusRequests requests;
+  requests.swap(batch->pending);
+  ++batch->in_flight;
+  lock->unlock();
+
+  tserver::GetTransactionStatusRequestPB req;
+  req.set_tablet_id(status_tablet);
+  for (const auto& request : requests) {
+    const auto& id = request.first->id();
+    req.add_transaction_id(id.begin(), id.size());
+  }
+  req.set_propagated_hybrid_time(participant_context_.Now().ToUint64());
+
+  auto handle = rpcs_.Prepare();
+  if (handle == rpcs_.InvalidHandle()) {
+    StatusRequestsDone(client, status_tablet, handle, requests,
+                       STATUS(Aborted, "Transaction participant is shutting down"),
+                       tserver::GetTransactionStatusResponsePB());
+    return;
+  }
+  *handle = client::GetTransactionStatus(
+      TransactionRpcDeadline(),
+      nullptr /* tablet */,
+      client,
+      &req,
+      [this, client, status_tablet, handle, requests](
+          const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+        StatusRequestsDone(client, status_tablet, handle, requests, status, response);
+      });
+  (**handle).SendRpc();
+}
+
+void RunningTransactionContext::StatusRequestsDone(
+    client::YBClient* client, const TabletId& status_tablet, rpc::Rpcs::Handle handle,
+    const StatusRequests& requests, Status status,
+    const tserver::GetTransactionStatusResponsePB& response) {
+  if (response.has_propagated_hybrid_time()) {
+    participant_context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
+  }
+  if (handle != rpcs_.InvalidHandle()) {
+    rpcs_.Unregister(handle);
+  }
+  if (status.ok() && static_cast<size_t>(response.status().size()) != requests.size()) {
+    status = STATUS_FORMAT(
+        IllegalState, "Status tablet $0 returned $1 statuses for $2 transactions",
+        status_tablet, response.status().size(), requests.size());
+  }
+
+  for (size_t i = 0; i != requests.size(); ++i) {
+    const auto& transaction = requests[i].first;
+    transaction->StatusReceived(
+        client, status, response, static_cast<int>(i), requests[i].second, transaction);
+  }
+
+  // Requests issued by the notified waiters are also accumulated in the batch, so they are sent
+  // together.
+  std::unique_lock<std::mutex> lock(status_requests_mutex_);
+  auto it = status_request_batches_.find(status_tablet);
+  --it->second.in_flight;
+  if (!it->second.pending.empty()) {
+    SendStatusRequests(client, status_tablet, &it->second, &lock);
+  } else if (it->second.in_flight == 0) {
+    status_request_batches_.erase(it);
+  }
+}
+
 } // namespace
 
 std::string TransactionApplyData::ToString() const {
@@ -681,6 +780,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
             std::make_shared<RunningTransaction>(*metadata, 0, this));
         lock_and_iterator.iterator = insert_result.first;
         store = insert_result.second;
+        TransactionsModifiedUnlocked();
       } else {
         DCHECK_EQ((**lock_and_iterator.iterator).metadata(), *metadata);
       }
@@ -689,6 +789,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       auto it = transactions_.find(metadata->transaction_id);
       if (it == transactions_.end()) {
         transactions_.insert(std::make_shared<RunningTransaction>(*metadata, 0, this));
+        TransactionsModifiedUnlocked();
         store = true;
       } else {
         DCHECK_EQ((**it).metadata(), *metadata);
@@ -799,6 +900,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       VLOG_WITH_PREFIX(2) << "Cleaned from queue: " << id;
       cleanup_queue_.pop_front();
     }
+    TransactionsModifiedUnlocked();
   }
 
   void Abort(const TransactionId& id, TransactionStatusCallback callback) {
@@ -905,10 +1007,28 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       }
     }
 
+    NotifyCompleted();
     NotifyApplied(data);
     return Status::OK();
   }
 
+  void WaitForTransactionsCompletion(MonoTime deadline) {
+    std::unique_lock<std::mutex> lock(completion_mutex_);
+    auto completions = completions_;
+    completion_cond_.wait_until(lock, deadline.ToSteadyTimePoint(), [this, completions] {
+      return completions_ != completions;
+    });
+  }
+
+  // Wakes up operations waiting for conflicting transactions.
+  void NotifyCompleted() {
+    {
+      std::lock_guard<std::mutex> lock(completion_mutex_);
+      ++completions_;
+    }
+    completion_cond_.notify_all();
+  }
+
   void NotifyApplied(const TransactionApplyData& data) {
     VLOG_WITH_PREFIX(4) << Format("NotifyApplied($0)", data);
 
@@ -956,12 +1076,29 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     auto status = applier_.RemoveIntents(data.transaction_id);
     LOG_IF_WITH_PREFIX(DFATAL, !status.ok()) << "Failed to remove intents for "
                                              << data.transaction_id << ": " << status;
+    NotifyCompleted();
 
     return Status::OK();
   }
 
   void SetDB(rocksdb::DB* db) {
     db_ = db;
+
+    // Transactions are loaded lazily, so intents DB could contain intents of transactions that
+    // we don't know about yet. In this case we could not let readers skip intents DB.
+    auto iter = docdb::CreateRocksDBIterator(db_,
+                                             docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                             boost::none,
+                                             rocksdb::kDefaultQueryId);
+    iter->SeekToFirst();
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_unknown_intents_ = iter->Valid();
+    LOG_IF_WITH_PREFIX(INFO, has_unknown_intents_) << "Intents DB is not empty on start";
+    TransactionsModifiedUnlocked();
+  }
+
+  int64_t intents_epoch() const {
+    return intents_epoch_.load(std::memory_order_acquire);
   }
 
   TransactionParticipantContext* participant_context() const {
@@ -999,6 +1136,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     if (running_requests_.empty()) {
       TransactionId txn_id = (**it).id();
       transactions_.erase(it);
+      TransactionsModifiedUnlocked();
       VLOG_WITH_PREFIX(2) << "Cleaned transaction: " << txn_id
                           << ", left: " << transactions_.size();
       return true;
@@ -1104,6 +1242,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     std::unique_lock<std::mutex> lock(mutex_);
     auto it = transactions_.insert(std::make_shared<RunningTransaction>(
         std::move(*metadata), next_write_id, this)).first;
+    TransactionsModifiedUnlocked();
 
     return LockAndFindOrLoadResult{std::move(lock), it};
   }
@@ -1112,6 +1251,14 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return participant_context_.client_future().get().get();
   }
 
+  // Should be invoked after each modification of transactions_, to keep intents_epoch_ parity.
+  void TransactionsModifiedUnlocked() {
+    bool may_have_intents = has_unknown_intents_ || !transactions_.empty();
+    if (may_have_intents != ((intents_epoch_.load(std::memory_order_relaxed) & 1) != 0)) {
+      intents_epoch_.fetch_add(1, std::memory_order_acq_rel);
+    }
+  }
+
   const std::string& LogPrefix() const override {
     return log_prefix_;
   }
@@ -1125,6 +1272,10 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
 
   rocksdb::DB* db_ = nullptr;
   Transactions transactions_;
+  // Whether intents DB contained records when it was opened.
+  bool has_unknown_intents_ = false;
+  // See TransactionParticipant::intents_epoch.
+  std::atomic<int64_t> intents_epoch_{0};
   // Ids of running requests, stored in increasing order.
   std::deque<int64_t> running_requests_;
   // Ids of complete requests, minimal request is on top.
@@ -1134,6 +1285,11 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+
+  // Number of transactions applied or cleaned up, guarded by completion_mutex_.
+  std::mutex completion_mutex_;
+  std::condition_variable completion_cond_;
+  int64_t completions_ = 0;
 };
 
 TransactionParticipant::TransactionParticipant(
@@ -1197,6 +1353,10 @@ void TransactionParticipant::Cleanup(TransactionIdSet&& set) {
   return impl_->Cleanup(std::move(set), this);
 }
 
+void TransactionParticipant::WaitForTransactionsCompletion(MonoTime deadline) {
+  impl_->WaitForTransactionsCompletion(deadline);
+}
+
 CHECKED_STATUS TransactionParticipant::ProcessApply(const TransactionApplyData& data) {
   return impl_->ProcessApply(data);
 }
@@ -1213,6 +1373,10 @@ TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
 
+int64_t TransactionParticipant::intents_epoch() const {
+  return impl_->intents_epoch();
+}
+
 size_t TransactionParticipant::TEST_GetNumRunningTransactions() const {
   return impl_->TEST_GetNumRunningTransactions();
 }
@@ -128,6 +128,8 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void Cleanup(TransactionIdSet&& set) override;
 
+  void WaitForTransactionsCompletion(MonoTime deadline) override;
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
   // Used to pass arguments to ProcessReplicated.
@@ -145,6 +147,16 @@ class TransactionParticipant : public TransactionStatusManager {
 
   TransactionParticipantContext* context() const;
 
+  // Epoch of intents state, incremented each time participant switches between having and not
+  // having transactions whose intents could be visible to readers.
+  // Odd value means that such transactions could exist. Even value means that intents DB has
+  // no visible intents, so readers that don't belong to a transaction could skip it.
+  int64_t intents_epoch() const;
+
+  static bool IntentsEpochHasNoIntents(int64_t epoch) {
+    return (epoch & 1) == 0;
+  }
+
   size_t TEST_GetNumRunningTransactions() const;
 
   size_t TEST_CountIntents() const;
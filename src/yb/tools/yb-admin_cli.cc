@@ -315,6 +315,14 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
         return Status::OK();
       });
 
+  Register(
+      "list_tablet_split_candidates", "",
+      [client](const CLIArguments&) -> Status {
+        RETURN_NOT_OK_PREPEND(client->ListTabletSplitCandidates(),
+                              "Unable to list tablet split candidates");
+        return Status::OK();
+      });
+
   Register(
       "list_leader_counts", " <keyspace> <table_name>",
       [client](const CLIArguments& args) -> Status {
@@ -328,9 +336,16 @@ void ClusterAdminCli::RegisterCommandHandlers(ClusterAdminClientClass* client) {
       });
 
   Register(
-      "setup_redis_table", "",
-      [client](const CLIArguments&) -> Status {
-        RETURN_NOT_OK_PREPEND(client->SetupRedisTable(),
+      "setup_redis_table", " [in_memory]",
+      [client](const CLIArguments& args) -> Status {
+        bool in_memory = false;
+        if (args.size() > 2) {
+          if (args[2] != "in_memory") {
+            UsageAndExit(args[0]);
+          }
+          in_memory = true;
+        }
+        RETURN_NOT_OK_PREPEND(client->SetupRedisTable(in_memory),
                               "Unable to setup Redis keyspace and table");
         return Status::OK();
       });
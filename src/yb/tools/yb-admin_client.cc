@@ -348,6 +348,31 @@ Status ClusterAdminClient::GetLoadMoveCompletion() {
   return Status::OK();
 }
 
+Status ClusterAdminClient::ListTabletSplitCandidates() {
+  CHECK(initted_);
+  master::ListTabletSplitCandidatesRequestPB req;
+  master::ListTabletSplitCandidatesResponsePB resp;
+
+  RpcController rpc;
+  rpc.set_timeout(timeout_);
+  RETURN_NOT_OK(master_proxy_->ListTabletSplitCandidates(req, &resp, &rpc));
+
+  if (resp.has_error()) {
+    return StatusFromPB(resp.error().status());
+  }
+  cout << RightPadToUuidWidth("Tablet UUID") << kColumnSep
+       << RightPadToUuidWidth("Table UUID") << kColumnSep
+       << "Table Name" << kColumnSep
+       << "SST File Size" << endl;
+  for (const auto& candidate : resp.candidates()) {
+    cout << candidate.tablet_id() << kColumnSep
+         << candidate.table_id() << kColumnSep
+         << candidate.table_name() << kColumnSep
+         << candidate.sst_file_size() << endl;
+  }
+  return Status::OK();
+}
+
 Status ClusterAdminClient::ListLeaderCounts(const YBTableName& table_name) {
   vector<string> tablet_ids, ranges;
   RETURN_NOT_OK(yb_client_->GetTablets(table_name, 0, &tablet_ids, &ranges));
@@ -417,13 +442,16 @@ Status ClusterAdminClient::ListLeaderCounts(const YBTableName& table_name) {
   return Status::OK();
 }
 
-Status ClusterAdminClient::SetupRedisTable() {
+Status ClusterAdminClient::SetupRedisTable(bool in_memory) {
   const YBTableName table_name(common::kRedisKeyspaceName, common::kRedisTableName);
   RETURN_NOT_OK(yb_client_->CreateNamespaceIfNotExists(common::kRedisKeyspaceName));
   // Try to create the table.
   gscoped_ptr<yb::client::YBTableCreator> table_creator(yb_client_->NewTableCreator());
+  TableProperties table_properties;
+  table_properties.SetInMemory(in_memory);
   Status s = table_creator->table_name(table_name)
                               .table_type(yb::client::YBTableType::REDIS_TABLE_TYPE)
+                              .table_properties(table_properties)
                               .Create();
   // If we could create it, then all good!
   if (s.ok()) {
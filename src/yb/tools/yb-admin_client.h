@@ -130,7 +130,12 @@ class ClusterAdminClient {
 
   CHECKED_STATUS ListLeaderCounts(const client::YBTableName& table_name);
 
-  CHECKED_STATUS SetupRedisTable();
+  // List the tablets that the master reports as split candidates, with their SST file sizes.
+  CHECKED_STATUS ListTabletSplitCandidates();
+
+  // Creates the Redis table. WAL of an in_memory table is never synced, see
+  // TablePropertiesPB::in_memory.
+  CHECKED_STATUS SetupRedisTable(bool in_memory);
 
   CHECKED_STATUS DropRedisTable();
 
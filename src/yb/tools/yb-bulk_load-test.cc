@@ -37,6 +37,8 @@
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/util/date_time.h"
+#include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/path_util.h"
 #include "yb/util/random.h"
 #include "yb/util/subprocess.h"
@@ -505,6 +507,7 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
   client::TableHandle table;
   ASSERT_OK(table.Open(*table_name_, client_.get()));
 
+  int tablet_index = 0;
   for (const master::TabletLocationsPB& tablet_location : resp.tablet_locations()) {
     const string& tablet_id = tablet_location.tablet_id();
     string tablet_path = JoinPathSegments(bulk_load_data, tablet_id);
@@ -539,14 +542,43 @@ TEST_F_EX(YBBulkLoadTest, TestCLITool, YBBulkLoadTestWithoutRebalancing) {
     // Wait for load generator to generate some traffic.
     SleepFor(MonoDelta::FromSeconds(5));
 
-    // Import the data into the tserver.
-    tserver::ImportDataRequestPB import_req;
-    import_req.set_tablet_id(tablet_id);
-    import_req.set_source_dir(tablet_path);
-    tserver::ImportDataResponsePB import_resp;
-    rpc::RpcController controller;
-    ASSERT_OK(tserver_proxy->ImportData(import_req, &import_resp, &controller));
-    ASSERT_FALSE(import_resp.has_error()) << import_resp.DebugString();
+    // Import the data into the tserver. Every other tablet streams its files with IngestData,
+    // the rest import the directory in place.
+    if (++tablet_index % 2 == 0) {
+      tserver::IngestDataRequestPB ingest_req;
+      ingest_req.set_tablet_id(tablet_id);
+      ingest_req.set_import_id("test");
+      for (const string& tablet_file : tablet_files) {
+        if (tablet_file == "." || tablet_file == ".." || tablet_file == "LOCK") {
+          continue;
+        }
+        faststring data;
+        ASSERT_OK(ReadFileToString(env, JoinPathSegments(tablet_path, tablet_file), &data));
+        ingest_req.set_file_name(tablet_file);
+        ingest_req.set_offset(0);
+        ingest_req.set_data(data.data(), data.size());
+        tserver::IngestDataResponsePB ingest_resp;
+        rpc::RpcController controller;
+        ASSERT_OK(tserver_proxy->IngestData(ingest_req, &ingest_resp, &controller));
+        ASSERT_FALSE(ingest_resp.has_error()) << ingest_resp.DebugString();
+      }
+      ingest_req.clear_file_name();
+      ingest_req.clear_offset();
+      ingest_req.clear_data();
+      ingest_req.set_finish(true);
+      tserver::IngestDataResponsePB ingest_resp;
+      rpc::RpcController controller;
+      ASSERT_OK(tserver_proxy->IngestData(ingest_req, &ingest_resp, &controller));
+      ASSERT_FALSE(ingest_resp.has_error()) << ingest_resp.DebugString();
+    } else {
+      tserver::ImportDataRequestPB import_req;
+      import_req.set_tablet_id(tablet_id);
+      import_req.set_source_dir(tablet_path);
+      tserver::ImportDataResponsePB import_resp;
+      rpc::RpcController controller;
+      ASSERT_OK(tserver_proxy->ImportData(import_req, &import_resp, &controller));
+      ASSERT_FALSE(import_resp.has_error()) << import_resp.DebugString();
+    }
 
     for (const string& row : tabletid_to_line[tablet_id]) {
       // Build read request.
@@ -12,7 +12,11 @@
 //
 
 #include <sched.h>
+#include <unistd.h>
+
 #include <iostream>
+#include <mutex>
+#include <queue>
 #include <thread>
 #include <boost/algorithm/string.hpp>
 
@@ -20,7 +24,9 @@
 #include <glog/logging.h>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/immutable_options.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/sst_file_writer.h"
 #include "yb/client/client.h"
 #include "yb/common/entity_ids.h"
 #include "yb/common/hybrid_time.h"
@@ -29,13 +35,19 @@
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/doc_operation.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/gutil/casts.h"
+#include "yb/gutil/walltime.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tools/bulk_load_docdb_util.h"
 #include "yb/tools/bulk_load_utils.h"
 #include "yb/tools/yb-generate_partitions.h"
 #include "yb/tserver/tserver_service.proxy.h"
+#include "yb/util/coding.h"
 #include "yb/util/env.h"
+#include "yb/util/env_util.h"
+#include "yb/util/faststring.h"
 #include "yb/util/status.h"
 #include "yb/util/stol_utils.h"
 #include "yb/util/stopwatch.h"
@@ -58,6 +70,7 @@ using yb::client::YBTableName;
 using yb::docdb::DocWriteBatch;
 using yb::docdb::InitMarkerBehavior;
 using yb::operator"" _GB;
+using yb::operator"" _MB;
 
 DEFINE_string(master_addresses, "", "Comma-separated list of YB Master server addresses");
 DEFINE_string(table_name, "", "Name of the table to generate partitions for");
@@ -82,16 +95,219 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_direct_sst, true,
+            "Sort the encoded rows of each tablet and write them straight into a single SSTable "
+            "file, instead of writing them through rocksdb memtables, flushes and compactions.");
+DEFINE_int64(bulk_load_sort_buffer_bytes, 1_GB,
+             "Amount of encoded rows of a tablet sorted in memory, with --bulk_load_direct_sst. "
+             "Rows beyond it are spilled to disk as sorted runs and merged at the end.");
+DEFINE_bool(bulk_load_export_via_rpc, true,
+            "Stream the files of each tablet to its replicas with the IngestData RPC, instead of "
+            "copying them with bulk_load_helper_script over ssh.");
+DEFINE_int32(bulk_load_rpc_chunk_bytes, 4_MB,
+             "Size of the file chunks sent by one IngestData RPC.");
 
 namespace yb {
 namespace tools {
 
 namespace {
 
+typedef std::vector<std::pair<std::string, std::string>> Records;
+
+// Reads a sorted run spilled by TabletSorter: records are fixed32 length prefixed keys, each
+// followed by a fixed32 length prefixed value.
+class SortedRunReader {
+ public:
+  CHECKED_STATUS Open(const string& path) {
+    return env_util::OpenFileForSequential(Env::Default(), path, &file_);
+  }
+
+  // Reads the next record, returns false at the end of the run.
+  Result<bool> Next() {
+    if (!VERIFY_RESULT(ReadLengthPrefixed(&key_))) {
+      return false;
+    }
+    if (!VERIFY_RESULT(ReadLengthPrefixed(&value_))) {
+      return STATUS(Corruption, "Sorted run ends in the middle of a record");
+    }
+    return true;
+  }
+
+  const string& key() const { return key_; }
+  const string& value() const { return value_; }
+
+ private:
+  Result<bool> ReadLengthPrefixed(string* out) {
+    uint8_t length[sizeof(uint32_t)];
+    const auto read = VERIFY_RESULT(Read(sizeof(length), length));
+    if (read == 0) {
+      return false;
+    }
+    if (read != sizeof(length)) {
+      return STATUS(Corruption, "Sorted run ends in the middle of a record");
+    }
+    out->resize(DecodeFixed32(length));
+    if (VERIFY_RESULT(Read(out->size(), pointer_cast<uint8_t*>(&(*out)[0]))) != out->size()) {
+      return STATUS(Corruption, "Sorted run ends in the middle of a record");
+    }
+    return true;
+  }
+
+  Result<size_t> Read(size_t size, uint8_t* out) {
+    size_t done = 0;
+    while (done != size) {
+      Slice result;
+      RETURN_NOT_OK(file_->Read(size - done, &result, out + done));
+      if (result.empty()) {
+        break;
+      }
+      if (result.data() != out + done) {
+        memcpy(out + done, result.data(), result.size());
+      }
+      done += result.size();
+    }
+    return done;
+  }
+
+  gscoped_ptr<SequentialFile> file_;
+  string key_;
+  string value_;
+};
+
+// Collects the encoded DocDB records of a tablet and writes them, sorted, into a single SSTable
+// file, without going through rocksdb memtables. When the records do not fit into
+// --bulk_load_sort_buffer_bytes they are sorted and spilled to disk as runs, which are merged
+// while the file is written.
+class TabletSorter {
+ public:
+  explicit TabletSorter(string dir) : dir_(std::move(dir)) {}
+
+  CHECKED_STATUS Init() {
+    if (Env::Default()->FileExists(dir_)) {
+      RETURN_NOT_OK(Env::Default()->DeleteRecursively(dir_));
+    }
+    return Env::Default()->CreateDir(dir_);
+  }
+
+  // Thread safe.
+  CHECKED_STATUS Add(Records records) {
+    Records run;
+    size_t run_index;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& record : records) {
+        buffer_bytes_ += record.first.size() + record.second.size();
+        buffer_.push_back(std::move(record));
+      }
+      if (buffer_bytes_ < FLAGS_bulk_load_sort_buffer_bytes) {
+        return Status::OK();
+      }
+      run.swap(buffer_);
+      buffer_bytes_ = 0;
+      run_index = runs_.size();
+      runs_.emplace_back();
+    }
+    // Sort and spill outside of the lock, so other tasks keep encoding rows meanwhile.
+    auto path = VERIFY_RESULT(SpillRun(run_index, &run));
+    std::lock_guard<std::mutex> lock(mutex_);
+    runs_[run_index] = std::move(path);
+    return Status::OK();
+  }
+
+  // Writes all added records into the SSTable file at path. Returns false if there were no
+  // records. Should be called after all Add calls have completed.
+  Result<bool> WriteSstFile(const rocksdb::Options& options, const string& path) {
+    rocksdb::SstFileWriter writer(
+        rocksdb::EnvOptions(), rocksdb::ImmutableCFOptions(options), options.comparator);
+    size_t num_records = 0;
+    string last_key;
+    // Records of the same key are written once, they could only come from duplicate input rows.
+    auto add = [&writer, &num_records, &last_key, &path](
+        const string& key, const string& value) -> Status {
+      if (num_records != 0 && key == last_key) {
+        return Status::OK();
+      }
+      if (num_records == 0) {
+        RETURN_NOT_OK(writer.Open(path));
+      }
+      ++num_records;
+      last_key = key;
+      return writer.Add(key, value);
+    };
+
+    if (runs_.empty()) {
+      std::sort(buffer_.begin(), buffer_.end());
+      for (const auto& record : buffer_) {
+        RETURN_NOT_OK(add(record.first, record.second));
+      }
+    } else {
+      if (!buffer_.empty()) {
+        runs_.push_back(VERIFY_RESULT(SpillRun(runs_.size(), &buffer_)));
+      }
+      std::vector<SortedRunReader> readers(runs_.size());
+      auto greater = [&readers](size_t lhs, size_t rhs) {
+        return readers[lhs].key() > readers[rhs].key();
+      };
+      std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+      for (size_t i = 0; i != runs_.size(); ++i) {
+        RETURN_NOT_OK(readers[i].Open(runs_[i]));
+        if (VERIFY_RESULT(readers[i].Next())) {
+          heap.push(i);
+        }
+      }
+      while (!heap.empty()) {
+        auto i = heap.top();
+        heap.pop();
+        RETURN_NOT_OK(add(readers[i].key(), readers[i].value()));
+        if (VERIFY_RESULT(readers[i].Next())) {
+          heap.push(i);
+        }
+      }
+    }
+    buffer_.clear();
+
+    if (num_records == 0) {
+      return false;
+    }
+    LOG(INFO) << "Wrote " << num_records << " records from " << runs_.size()
+              << " sorted runs into " << path;
+    RETURN_NOT_OK(writer.Finish());
+    return true;
+  }
+
+ private:
+  Result<string> SpillRun(size_t run_index, Records* run) {
+    std::sort(run->begin(), run->end());
+    auto path = JoinPathSegments(dir_, Format("run-$0", run_index));
+    gscoped_ptr<WritableFile> file;
+    RETURN_NOT_OK(env_util::OpenFileForWrite(Env::Default(), path, &file));
+    faststring buffer;
+    for (const auto& record : *run) {
+      PutFixed32LengthPrefixedSlice(&buffer, record.first);
+      PutFixed32LengthPrefixedSlice(&buffer, record.second);
+      if (buffer.size() >= 1_MB) {
+        RETURN_NOT_OK(file->Append(buffer));
+        buffer.clear();
+      }
+    }
+    RETURN_NOT_OK(file->Append(buffer));
+    RETURN_NOT_OK(file->Close());
+    Records().swap(*run);
+    return path;
+  }
+
+  const string dir_;
+  std::mutex mutex_;
+  Records buffer_;
+  int64_t buffer_bytes_ = 0;
+  std::vector<string> runs_;
+};
+
 class BulkLoadTask : public Runnable {
  public:
   BulkLoadTask(vector<pair<TabletId, string>> rows, BulkLoadDocDBUtil *db_fixture,
-               const YBTable *table, YBPartitionGenerator *partition_generator);
+               TabletSorter *sorter, const YBTable *table,
+               YBPartitionGenerator *partition_generator);
   void Run();
  private:
   CHECKED_STATUS PopulateColumnValue(const string &column,
@@ -105,6 +321,8 @@ class BulkLoadTask : public Runnable {
                            YBPartitionGenerator *const partition_generator);
   vector<pair<TabletId, string>> rows_;
   BulkLoadDocDBUtil *const db_fixture_;
+  // Receives the encoded rows with --bulk_load_direct_sst, null otherwise.
+  TabletSorter *const sorter_;
   const YBTable *const table_;
   YBPartitionGenerator *const partition_generator_;
 };
@@ -129,12 +347,18 @@ class BulkLoad {
                                         vector<pair<TabletId, string>> rows);
   CHECKED_STATUS RetryableSubmit(vector<pair<TabletId, string>> rows);
   CHECKED_STATUS CompactFiles();
+  CHECKED_STATUS AddSortedFile(const TabletId &tablet_id);
+  CHECKED_STATUS ExportViaHelperScript(const TabletId &tablet_id,
+                                       const master::TabletLocationsPB &tablet_locations);
+  CHECKED_STATUS ExportViaRpc(const TabletId &tablet_id,
+                              const master::TabletLocationsPB &tablet_locations);
 
   shared_ptr<YBClient> client_;
   shared_ptr<YBTable> table_;
   unique_ptr<YBPartitionGenerator> partition_generator_;
   gscoped_ptr<ThreadPool> thread_pool_;
   unique_ptr<BulkLoadDocDBUtil> db_fixture_;
+  unique_ptr<TabletSorter> sorter_;
 };
 
 CompactionTask::CompactionTask(const vector<string>& sst_filenames, BulkLoadDocDBUtil* db_fixture)
@@ -155,10 +379,11 @@ void CompactionTask::Run() {
 }
 
 BulkLoadTask::BulkLoadTask(vector<pair<TabletId, string>> rows,
-                           BulkLoadDocDBUtil *db_fixture, const YBTable *table,
-                           YBPartitionGenerator *partition_generator)
+                           BulkLoadDocDBUtil *db_fixture, TabletSorter *sorter,
+                           const YBTable *table, YBPartitionGenerator *partition_generator)
     : rows_(std::move(rows)),
       db_fixture_(db_fixture),
+      sorter_(sorter),
       table_(table),
       partition_generator_(partition_generator) {
 }
@@ -175,6 +400,19 @@ void BulkLoadTask::Run() {
                        &doc_write_batch, partition_generator_));
   }
 
+  if (sorter_) {
+    // Encode the records the same way WriteToRocksDB does, all with the same hybrid time.
+    const auto encoded_ht = docdb::PrimitiveValue(docdb::DocHybridTime(
+        HybridTime::FromMicros(kYugaByteMicrosecondEpoch), 0)).ToKeyBytes();
+    Records records;
+    records.reserve(doc_write_batch.key_value_pairs().size());
+    for (const auto& entry : doc_write_batch.key_value_pairs()) {
+      records.emplace_back(entry.first + encoded_ht.data(), entry.second);
+    }
+    CHECK_OK(sorter_->Add(std::move(records)));
+    return;
+  }
+
   // Flush the batch.
   CHECK_OK(db_fixture_->WriteToRocksDB(
       doc_write_batch, HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
@@ -299,7 +537,8 @@ Status BulkLoadTask::InsertRow(const string &row,
 
 Status BulkLoad::RetryableSubmit(vector<pair<TabletId, string>> rows) {
   auto runnable = std::make_shared<BulkLoadTask>(
-      std::move(rows), db_fixture_.get(), table_.get(), partition_generator_.get());
+      std::move(rows), db_fixture_.get(), sorter_.get(), table_.get(),
+      partition_generator_.get());
 
   Status s;
   do {
@@ -360,6 +599,17 @@ Status BulkLoad::CompactFiles() {
   return Status::OK();
 }
 
+Status BulkLoad::AddSortedFile(const TabletId &tablet_id) {
+  const string path = JoinPathSegments(FLAGS_base_dir, tablet_id + ".sst");
+  if (!VERIFY_RESULT(sorter_->WriteSstFile(db_fixture_->options(), path))) {
+    return STATUS_FORMAT(IllegalState, "No records for tablet $0", tablet_id);
+  }
+  RETURN_NOT_OK(db_fixture_->rocksdb()->AddFile(path, /* move_file */ true));
+  sorter_.reset();
+  return yb::Env::Default()->DeleteRecursively(
+      JoinPathSegments(FLAGS_base_dir, tablet_id + ".sort"));
+}
+
 Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
                                         vector<pair<TabletId, string>> rows) {
   if (!db_fixture_) {
@@ -373,11 +623,15 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   // Wait for all tasks for the tablet to complete.
   thread_pool_->Wait();
 
-  // Now flush the DB.
-  RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
+  if (sorter_) {
+    RETURN_NOT_OK(AddSortedFile(tablet_id));
+  } else {
+    // Now flush the DB.
+    RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
 
-  // Perform the necessary compactions.
-  RETURN_NOT_OK(CompactFiles());
+    // Perform the necessary compactions.
+    RETURN_NOT_OK(CompactFiles());
+  }
 
   if (!FLAGS_export_files) {
     return Status::OK();
@@ -386,6 +640,87 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   // Find replicas for the tablet.
   master::TabletLocationsPB tablet_locations;
   RETURN_NOT_OK(client_->GetTabletLocation(tablet_id, &tablet_locations));
+  if (FLAGS_bulk_load_export_via_rpc) {
+    RETURN_NOT_OK(ExportViaRpc(tablet_id, tablet_locations));
+  } else {
+    RETURN_NOT_OK(ExportViaHelperScript(tablet_id, tablet_locations));
+  }
+
+  // Delete the data once the import is done.
+  return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+}
+
+Status BulkLoad::ExportViaRpc(const TabletId &tablet_id,
+                              const master::TabletLocationsPB &tablet_locations) {
+  // Files needed to open the rocksdb directory, LOCK and info logs are left behind.
+  vector<string> files;
+  for (const auto& file : VERIFY_RESULT(Env::Default()->GetChildren(
+           db_fixture_->rocksdb_dir(), ExcludeDots::kTrue))) {
+    if (file != "LOCK" && !boost::starts_with(file, "LOG")) {
+      files.push_back(file);
+    }
+  }
+
+  rpc::MessengerBuilder bld("Client");
+  auto client_messenger = VERIFY_RESULT(bld.Build());
+  rpc::ProxyCache proxy_cache(client_messenger);
+  const string import_id = Format("$0-$1-$2", tablet_id, getpid(), GetCurrentTimeMicros());
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[FLAGS_bulk_load_rpc_chunk_bytes]);
+  for (const master::TabletLocationsPB_ReplicaPB &replica : tablet_locations.replicas()) {
+    const HostPort hostport = HostPortFromPB(replica.ts_info().private_rpc_addresses(0));
+    tserver::TabletServerServiceProxy proxy(&proxy_cache, hostport);
+    LOG(INFO) << "Sending " << files.size() << " files of tablet " << tablet_id << " to "
+              << hostport;
+
+    auto send = [&proxy](const tserver::IngestDataRequestPB& req) -> Status {
+      tserver::IngestDataResponsePB resp;
+      rpc::RpcController controller;
+      controller.set_timeout(MonoDelta::FromSeconds(60));
+      RETURN_NOT_OK(proxy.IngestData(req, &resp, &controller));
+      if (resp.has_error()) {
+        return StatusFromPB(resp.error().status());
+      }
+      return Status::OK();
+    };
+
+    tserver::IngestDataRequestPB req;
+    req.set_tablet_id(tablet_id);
+    req.set_import_id(import_id);
+    for (const auto& file_name : files) {
+      gscoped_ptr<SequentialFile> file;
+      RETURN_NOT_OK(env_util::OpenFileForSequential(
+          Env::Default(), JoinPathSegments(db_fixture_->rocksdb_dir(), file_name), &file));
+      req.set_file_name(file_name);
+      uint64_t offset = 0;
+      // Empty files, like an empty MANIFEST tail, are still sent once so that they exist.
+      for (;;) {
+        Slice chunk;
+        RETURN_NOT_OK(file->Read(FLAGS_bulk_load_rpc_chunk_bytes, &chunk, scratch.get()));
+        if (chunk.empty() && offset != 0) {
+          break;
+        }
+        req.set_offset(offset);
+        req.set_data(chunk.cdata(), chunk.size());
+        RETURN_NOT_OK(send(req));
+        if (chunk.empty()) {
+          break;
+        }
+        offset += chunk.size();
+      }
+    }
+
+    req.clear_file_name();
+    req.clear_offset();
+    req.clear_data();
+    req.set_finish(true);
+    LOG(INFO) << "Importing " << import_id << " on " << hostport;
+    RETURN_NOT_OK(send(req));
+  }
+  return Status::OK();
+}
+
+Status BulkLoad::ExportViaHelperScript(const TabletId &tablet_id,
+                                       const master::TabletLocationsPB &tablet_locations) {
   string csv_replicas;
   std::map<string, int32_t> host_to_rpcport;
   for (const master::TabletLocationsPB_ReplicaPB &replica : tablet_locations.replicas()) {
@@ -442,9 +777,7 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
         replica_host, "-i", FLAGS_ssh_key_file};
     RETURN_NOT_OK(Subprocess::Call(cleanup_script));
   }
-
-  // Delete the data once the import is done.
-  return yb::Env::Default()->DeleteRecursively(db_fixture_->rocksdb_dir());
+  return Status::OK();
 }
 
 
@@ -455,6 +788,10 @@ CHECKED_STATUS BulkLoad::InitDBUtil(const TabletId &tablet_id) {
                                           FLAGS_bulk_load_max_background_flushes));
   RETURN_NOT_OK(db_fixture_->InitRocksDBOptions());
   RETURN_NOT_OK(db_fixture_->DisableCompactions()); // This opens rocksdb.
+  if (FLAGS_bulk_load_direct_sst) {
+    sorter_.reset(new TabletSorter(JoinPathSegments(FLAGS_base_dir, tablet_id + ".sort")));
+    RETURN_NOT_OK(sorter_->Init());
+  }
   return Status::OK();
 }
 
@@ -536,8 +873,9 @@ int main(int argc, char** argv) {
         "--base_dir";
   }
 
-  if (FLAGS_export_files && FLAGS_ssh_key_file.empty()) {
-    LOG(FATAL) << "Need to specify --ssh_key_file with --export_files";
+  if (FLAGS_export_files && !FLAGS_bulk_load_export_via_rpc && FLAGS_ssh_key_file.empty()) {
+    LOG(FATAL) << "Need to specify --ssh_key_file with --export_files, unless "
+        "--bulk_load_export_via_rpc is set";
   }
 
   // Verify the bulk load path exists.
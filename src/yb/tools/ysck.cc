@@ -59,14 +59,28 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_bool(checksum_snapshot, true,
+            "Should the checksum scans of all replicas read the data at the same hybrid time.");
+DEFINE_uint64(checksum_snapshot_hybrid_time, 0,
+              "Hybrid time to use for checksum scans when --checksum_snapshot is set. The current "
+              "hybrid time of one of the tablet servers is used if zero.");
 
 ChecksumOptions::ChecksumOptions()
     : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+      scan_concurrency(FLAGS_checksum_scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
 
 ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
+    : ChecksumOptions(std::move(timeout), scan_concurrency, FLAGS_checksum_snapshot,
+                      FLAGS_checksum_snapshot_hybrid_time) {}
+
+ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                                 uint64_t snapshot_hybrid_time)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      use_snapshot(use_snapshot),
+      snapshot_hybrid_time(snapshot_hybrid_time) {}
 
 YsckCluster::~YsckCluster() {
 }
@@ -336,6 +350,16 @@ Status Ysck::ChecksumData(const vector<string>& tables,
     }
   }
 
+  if (options.use_snapshot && options.snapshot_hybrid_time == 0 &&
+      !tablet_server_queues.empty()) {
+    const shared_ptr<YsckTabletServer>& tablet_server = tablet_server_queues.begin()->first;
+    RETURN_NOT_OK_PREPEND(tablet_server->CurrentHybridTime(&options.snapshot_hybrid_time),
+                          Substitute("Unable to get current hybrid time from $0",
+                                     tablet_server->uuid()));
+    LOG(INFO) << "Using snapshot hybrid time " << options.snapshot_hybrid_time
+              << " from tablet server " << tablet_server->uuid();
+  }
+
   // Kick off checksum scans in parallel. For each tablet server, we start
   // scan_concurrency scans. Each callback then initiates one additional
   // scan when it returns if the queue for that TS is not empty.
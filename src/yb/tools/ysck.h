@@ -58,11 +58,22 @@ struct ChecksumOptions {
 
   ChecksumOptions(MonoDelta timeout, int scan_concurrency);
 
+  ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                  uint64_t snapshot_hybrid_time);
+
   // The maximum total time to wait for results to come back from all replicas.
   MonoDelta timeout;
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // Whether all replicas should checksum their data at the same hybrid time, so the results are
+  // comparable while the cluster takes writes.
+  bool use_snapshot;
+
+  // Hybrid time to checksum at when use_snapshot is set. The current hybrid time of one of the
+  // tablet servers is used when it is zero.
+  uint64_t snapshot_hybrid_time;
 };
 
 // Representation of a tablet replica on a tablet server.
@@ -281,8 +281,8 @@ TEST_F(RemoteYsckTest, TestChecksumSnapshot) {
 }
 
 // Test that followers & leader wait until safe time to respond to a snapshot
-// scan at current hybrid_time. TODO: Safe time not yet implemented. See KUDU-1056.
-TEST_F(RemoteYsckTest, DISABLED_TestChecksumSnapshotCurrentHybridTime) {
+// scan at current hybrid_time.
+TEST_F(RemoteYsckTest, TestChecksumSnapshotCurrentHybridTime) {
   CountDownLatch started_writing(1);
   AtomicBool continue_writing(true);
   Promise<Status> promise;
@@ -301,7 +301,9 @@ TEST_F(RemoteYsckTest, DISABLED_TestChecksumSnapshotCurrentHybridTime) {
 
   ASSERT_OK(ysck_->FetchTableAndTabletInfo());
   ASSERT_OK(ysck_->ChecksumData(vector<string>(), vector<string>(),
-                                ChecksumOptions(MonoDelta::FromSeconds(10), 16)));
+                                ChecksumOptions(MonoDelta::FromSeconds(10), 16,
+                                                true /* use_snapshot */,
+                                                0 /* snapshot_hybrid_time */)));
   continue_writing.Store(false);
   ASSERT_OK(promise.Get());
   writer_thread->Join();
@@ -150,6 +150,10 @@ class ChecksumStepper {
   void SendRequest() {
     req_.set_tablet_id(tablet_id_);
     req_.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    if (options_.use_snapshot && options_.snapshot_hybrid_time != 0) {
+      req_.set_read_hybrid_time(options_.snapshot_hybrid_time);
+    }
+    req_.set_order_independent(true);
     rpc_.set_timeout(GetDefaultTimeout());
     auto handler = std::make_unique<ChecksumCallbackHandler>(this);
     rpc::ResponseCallback cb = std::bind(&ChecksumCallbackHandler::Run, handler.get());
@@ -0,0 +1,331 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/cdc_producer.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/transaction.h"
+#include "yb/consensus/consensus.h"
+#include "yb/consensus/log.h"
+#include "yb/consensus/log_reader.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/transaction_participant.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(cdc_read_batch_bytes, 4_MB,
+             "Number of bytes of the WAL read at once while looking for changes of a tablet.");
+TAG_FLAG(cdc_read_batch_bytes, advanced);
+
+DEFINE_int32(cdc_unresolved_transaction_timeout_sec, 300,
+             "Writes of a transaction that is neither applied in the WAL nor known to the "
+             "transaction participant for this long are considered aborted by change data "
+             "capture, and no longer hold back the checkpoint.");
+TAG_FLAG(cdc_unresolved_transaction_timeout_sec, advanced);
+
+DEFINE_int32(cdc_consumer_idle_timeout_sec, 24 * 60 * 60,
+             "Checkpoint of a change data consumer that did not ask for changes for this long is "
+             "dropped, releasing the WAL it retains.");
+TAG_FLAG(cdc_consumer_idle_timeout_sec, advanced);
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// Fills change from the DocDB key and value written to the tablet. Only keeps the encoded form of
+// the parts that could not be decoded.
+void DecodeChange(const Schema& schema, const docdb::KeyValuePairPB& kv, CDCRowChangePB* change) {
+  change->set_encoded_key(kv.key());
+  change->set_encoded_value(kv.value());
+
+  docdb::Value value;
+  if (value.Decode(kv.value()).ok() && value.value_type() == docdb::ValueType::kTombstone) {
+    change->set_type(CDCRowChangePB::DELETE);
+  } else {
+    change->set_type(CDCRowChangePB::WRITE);
+  }
+
+  docdb::SubDocKey key;
+  if (!key.FullyDecodeFrom(kv.key(), docdb::HybridTimeRequired::kFalse).ok()) {
+    return;
+  }
+  const auto& hashed = key.doc_key().hashed_group();
+  const auto& range = key.doc_key().range_group();
+  if (hashed.size() + range.size() != schema.num_key_columns()) {
+    return;
+  }
+  size_t idx = 0;
+  for (const auto* group : {&hashed, &range}) {
+    for (const auto& component : *group) {
+      docdb::PrimitiveValue::ToQLValuePB(
+          component, schema.column(idx).type(), change->add_key());
+      ++idx;
+    }
+  }
+
+  if (key.num_subkeys() == 0) {
+    return;
+  }
+  const auto& subkey = key.subkeys()[0];
+  if (subkey.value_type() != docdb::ValueType::kColumnId &&
+      subkey.value_type() != docdb::ValueType::kSystemColumnId) {
+    return;
+  }
+  const ColumnId column_id = subkey.GetColumnId();
+  change->set_column_id(column_id);
+  if (subkey.value_type() == docdb::ValueType::kColumnId && key.num_subkeys() == 1 &&
+      change->type() == CDCRowChangePB::WRITE &&
+      docdb::IsPrimitiveValueType(value.value_type())) {
+    auto column = schema.column_by_id(column_id);
+    if (column.ok()) {
+      docdb::PrimitiveValue::ToQLValuePB(
+          value.primitive_value(), column->type(), change->mutable_value());
+    }
+  }
+}
+
+struct PendingTransaction {
+  // Last operation before the first write of the transaction, the checkpoint cannot move past it.
+  consensus::OpId before_first_write;
+  HybridTime first_write_time;
+  std::vector<const docdb::KeyValuePairPB*> writes;
+};
+
+} // namespace
+
+Status GetChangesFromLog(const tablet::TabletPeer& tablet_peer,
+                         const CDCCheckpointPB& from_checkpoint,
+                         size_t max_records,
+                         GetChangesResponsePB* resp) {
+  auto consensus = tablet_peer.shared_consensus();
+  auto tablet = tablet_peer.shared_tablet();
+  log::Log* log = tablet_peer.log();
+  if (!consensus || !tablet || !log) {
+    return STATUS(IllegalState, "Tablet is not running", tablet_peer.tablet_id());
+  }
+
+  consensus::OpId committed;
+  RETURN_NOT_OK(consensus->GetLastOpId(consensus::COMMITTED_OPID, &committed));
+
+  CDCCheckpointPB* checkpoint = resp->mutable_checkpoint();
+  if (!from_checkpoint.has_op_id()) {
+    *checkpoint->mutable_op_id() = committed;
+    checkpoint->set_last_returned_index(committed.index());
+    return Status::OK();
+  }
+  *checkpoint = from_checkpoint;
+  const int64_t last_returned_index = from_checkpoint.last_returned_index();
+
+  const Schema schema = tablet->metadata()->schema();
+  auto* participant = tablet->transaction_participant();
+  std::map<TransactionId, PendingTransaction> pending;
+  consensus::OpId last_read = from_checkpoint.op_id();
+  // Replicated messages are kept alive until the response is filled, pending transactions point
+  // into them.
+  std::vector<consensus::ReplicateMsgs> batches;
+
+  bool done = false;
+  while (!done && last_read.index() < committed.index()) {
+    consensus::ReplicateMsgs msgs;
+    RETURN_NOT_OK(log->GetLogReader()->ReadReplicatesInRange(
+        last_read.index() + 1, committed.index(), FLAGS_cdc_read_batch_bytes, &msgs));
+    if (msgs.empty()) {
+      break;
+    }
+    for (const auto& msg : msgs) {
+      const auto& op_id = msg->id();
+      switch (msg->op_type()) {
+        case consensus::WRITE_OP: {
+          const auto& batch = msg->write_request().write_batch();
+          if (batch.kv_pairs_size() == 0) {
+            break;
+          }
+          if (batch.has_transaction()) {
+            auto id = VERIFY_RESULT(FullyDecodeTransactionId(batch.transaction().transaction_id()));
+            auto it = pending.find(id);
+            if (it == pending.end()) {
+              it = pending.emplace(id, PendingTransaction()).first;
+              it->second.before_first_write = last_read;
+              it->second.first_write_time = HybridTime(msg->hybrid_time());
+            }
+            for (const auto& kv : batch.kv_pairs()) {
+              it->second.writes.push_back(&kv);
+            }
+            break;
+          }
+          if (op_id.index() <= last_returned_index) {
+            break;
+          }
+          auto* record = resp->add_records();
+          *record->mutable_op_id() = op_id;
+          record->set_commit_hybrid_time(msg->hybrid_time());
+          for (const auto& kv : batch.kv_pairs()) {
+            DecodeChange(schema, kv, record->add_changes());
+          }
+          break;
+        }
+        case consensus::UPDATE_TRANSACTION_OP: {
+          const auto& state = msg->transaction_state();
+          if (state.status() != TransactionStatus::APPLYING) {
+            break;
+          }
+          auto id = VERIFY_RESULT(FullyDecodeTransactionId(state.transaction_id()));
+          auto it = pending.find(id);
+          // Writes of a transaction that started before the checkpoint of a new consumer are not
+          // available.
+          if (it == pending.end()) {
+            break;
+          }
+          if (op_id.index() > last_returned_index) {
+            auto* record = resp->add_records();
+            *record->mutable_op_id() = op_id;
+            record->set_commit_hybrid_time(state.commit_hybrid_time());
+            record->set_transaction_id(state.transaction_id());
+            for (const auto* kv : it->second.writes) {
+              DecodeChange(schema, *kv, record->add_changes());
+            }
+          }
+          pending.erase(it);
+          break;
+        }
+        default:
+          break;
+      }
+      last_read = op_id;
+      if (max_records != 0 && static_cast<size_t>(resp->records_size()) >= max_records) {
+        done = true;
+        break;
+      }
+    }
+    batches.push_back(std::move(msgs));
+  }
+
+  // Aborted transactions are not recorded in the WAL, so a transaction that the participant does
+  // not know about any more, and that was not applied for a long time, is considered aborted.
+  const auto now = tablet_peer.clock().Now();
+  const MicrosTime timeout_us = FLAGS_cdc_unresolved_transaction_timeout_sec * 1000000LL;
+  consensus::OpId new_op_id = last_read;
+  for (const auto& entry : pending) {
+    const auto& transaction = entry.second;
+    if (!(participant && participant->Metadata(entry.first)) &&
+        transaction.first_write_time.AddMicroseconds(timeout_us) < now) {
+      LOG(INFO) << "T " << tablet_peer.tablet_id() << ": Skipping changes of unresolved "
+                << "transaction " << entry.first;
+      continue;
+    }
+    if (transaction.before_first_write.index() < new_op_id.index()) {
+      new_op_id = transaction.before_first_write;
+    }
+  }
+
+  *checkpoint->mutable_op_id() = new_op_id;
+  checkpoint->set_last_returned_index(std::max(last_returned_index, last_read.index()));
+  return Status::OK();
+}
+
+CDCConsumerRegistry::~CDCConsumerRegistry() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : consumers_) {
+    WARN_NOT_OK(ReleaseAnchor(&entry.second), "Failed to release CDC consumer anchor");
+  }
+}
+
+boost::optional<CDCCheckpointPB> CDCConsumerRegistry::GetCheckpoint(
+    const std::string& tablet_id, const std::string& consumer_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = consumers_.find(ConsumerKey(tablet_id, consumer_id));
+  if (it == consumers_.end()) {
+    return boost::none;
+  }
+  return it->second.checkpoint;
+}
+
+Status CDCConsumerRegistry::UpdateCheckpoint(const tablet::TabletPeer& tablet_peer,
+                                             const std::string& consumer_id,
+                                             const CDCCheckpointPB& checkpoint) {
+  const auto now = MonoTime::Now();
+  const auto& anchor_registry = tablet_peer.log_anchor_registry();
+  const std::string owner = "CDC consumer " + consumer_id;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  DropIdleConsumersUnlocked(now);
+  auto& consumer = consumers_[ConsumerKey(tablet_peer.tablet_id(), consumer_id)];
+  consumer.checkpoint = checkpoint;
+  consumer.last_active = now;
+  const int64_t index = checkpoint.op_id().index();
+  // The tablet could have been recreated on this server since the consumer was registered.
+  if (consumer.anchor && consumer.anchor_registry == anchor_registry) {
+    return anchor_registry->UpdateRegistration(index, owner, consumer.anchor.get());
+  }
+  RETURN_NOT_OK(ReleaseAnchor(&consumer));
+  consumer.anchor_registry = anchor_registry;
+  consumer.anchor.reset(new log::LogAnchor());
+  anchor_registry->Register(index, owner, consumer.anchor.get());
+  return Status::OK();
+}
+
+Status CDCConsumerRegistry::Unregister(const std::string& tablet_id,
+                                       const std::string& consumer_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = consumers_.find(ConsumerKey(tablet_id, consumer_id));
+  if (it == consumers_.end()) {
+    return Status::OK();
+  }
+  auto status = ReleaseAnchor(&it->second);
+  consumers_.erase(it);
+  return status;
+}
+
+size_t CDCConsumerRegistry::num_consumers() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return consumers_.size();
+}
+
+Status CDCConsumerRegistry::ReleaseAnchor(Consumer* consumer) {
+  if (!consumer->anchor) {
+    return Status::OK();
+  }
+  auto status = consumer->anchor_registry->UnregisterIfAnchored(consumer->anchor.get());
+  consumer->anchor.reset();
+  consumer->anchor_registry = nullptr;
+  return status;
+}
+
+void CDCConsumerRegistry::DropIdleConsumersUnlocked(MonoTime now) {
+  const auto timeout = MonoDelta::FromSeconds(FLAGS_cdc_consumer_idle_timeout_sec);
+  for (auto it = consumers_.begin(); it != consumers_.end();) {
+    if (now - it->second.last_active > timeout) {
+      LOG(INFO) << "Dropping checkpoint of idle CDC consumer " << it->first.second
+                << " of tablet " << it->first.first;
+      WARN_NOT_OK(ReleaseAnchor(&it->second), "Failed to release CDC consumer anchor");
+      it = consumers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+} // namespace tserver
+} // namespace yb
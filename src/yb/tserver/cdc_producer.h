@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_CDC_PRODUCER_H
+#define YB_TSERVER_CDC_PRODUCER_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include "yb/consensus/log_anchor_registry.h"
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/tserver.pb.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tserver {
+
+// Reads the changes committed to the tablet after the given checkpoint from its WAL, so change
+// data capture does not have to scan the table.
+//
+// Writes outside of transactions are returned at their own operation. Writes of a transaction are
+// buffered until the operation that applies the transaction, and are returned there with its commit
+// hybrid time. So records are returned in the order the changes became visible on the tablet.
+// While a transaction is pending, the returned checkpoint stays at its first write, so the next
+// call reads its writes again.
+//
+// At most max_records records are returned, 0 means no limit.
+CHECKED_STATUS GetChangesFromLog(const tablet::TabletPeer& tablet_peer,
+                                 const CDCCheckpointPB& from_checkpoint,
+                                 size_t max_records,
+                                 GetChangesResponsePB* resp);
+
+// Keeps checkpoints of change data consumers, and anchors the WAL of their tablets at them, so the
+// log is not garbage collected before the consumers read it. Checkpoints of consumers that did not
+// ask for changes during --cdc_consumer_idle_timeout_sec are dropped.
+class CDCConsumerRegistry {
+ public:
+  CDCConsumerRegistry() = default;
+  ~CDCConsumerRegistry();
+
+  boost::optional<CDCCheckpointPB> GetCheckpoint(const std::string& tablet_id,
+                                                 const std::string& consumer_id);
+
+  CHECKED_STATUS UpdateCheckpoint(const tablet::TabletPeer& tablet_peer,
+                                  const std::string& consumer_id,
+                                  const CDCCheckpointPB& checkpoint);
+
+  CHECKED_STATUS Unregister(const std::string& tablet_id, const std::string& consumer_id);
+
+  size_t num_consumers();
+
+ private:
+  typedef std::pair<std::string, std::string> ConsumerKey;
+
+  struct Consumer {
+    CDCCheckpointPB checkpoint;
+    MonoTime last_active;
+    scoped_refptr<log::LogAnchorRegistry> anchor_registry;
+    std::unique_ptr<log::LogAnchor> anchor;
+  };
+
+  static CHECKED_STATUS ReleaseAnchor(Consumer* consumer);
+
+  void DropIdleConsumersUnlocked(MonoTime now);
+
+  std::mutex mutex_;
+  std::unordered_map<ConsumerKey, Consumer, boost::hash<ConsumerKey>> consumers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CDCConsumerRegistry);
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_CDC_PRODUCER_H
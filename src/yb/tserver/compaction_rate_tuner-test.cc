@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "yb/tserver/compaction_rate_tuner.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(compaction_rate_min_bytes_per_sec);
+DECLARE_int32(compaction_rate_target_read_latency_p99_ms);
+
+METRIC_DEFINE_entity(compaction_rate_tuner_test_entity);
+
+METRIC_DEFINE_histogram(compaction_rate_tuner_test_entity, test_read_latency, "Read Latency",
+                        yb::MetricUnit::kMicroseconds, "Test read latency", 60000000LU, 2);
+METRIC_DEFINE_histogram(compaction_rate_tuner_test_entity, test_sync_latency, "Sync Latency",
+                        yb::MetricUnit::kMicroseconds, "Test sync latency", 60000000LU, 2);
+
+namespace yb {
+namespace tserver {
+
+class CompactionRateTunerTest : public YBTest {
+ public:
+  void SetUp() override {
+    YBTest::SetUp();
+
+    entity_ = METRIC_ENTITY_compaction_rate_tuner_test_entity.Instantiate(&registry_, "test");
+    read_latency_ = METRIC_test_read_latency.Instantiate(entity_);
+    sync_latency_ = METRIC_test_sync_latency.Instantiate(entity_);
+  }
+
+ protected:
+  MetricRegistry registry_;
+  scoped_refptr<MetricEntity> entity_;
+  scoped_refptr<Histogram> read_latency_;
+  scoped_refptr<Histogram> sync_latency_;
+};
+
+TEST_F(CompactionRateTunerTest, HistogramWindow) {
+  HistogramWindow window;
+  ASSERT_EQ(0U, window.Update({read_latency_}, 99));
+
+  // Values below 256 are tracked exactly with 2 significant digits.
+  read_latency_->IncrementBy(100, 99);
+  read_latency_->IncrementBy(200, 1);
+  ASSERT_EQ(100U, window.Update({read_latency_}, 99));
+
+  // Only values recorded since the previous update are taken into account.
+  read_latency_->IncrementBy(200, 10);
+  ASSERT_EQ(200U, window.Update({read_latency_}, 50));
+  ASSERT_EQ(0U, window.Update({read_latency_}, 99));
+
+  // Values of all histograms are merged.
+  read_latency_->IncrementBy(100, 1);
+  sync_latency_->IncrementBy(200, 3);
+  ASSERT_EQ(200U, window.Update({read_latency_, sync_latency_}, 50));
+}
+
+TEST_F(CompactionRateTunerTest, Tune) {
+  constexpr int64_t kMaxRate = 100 * 1024 * 1024;
+  FLAGS_compaction_rate_min_bytes_per_sec = kMaxRate / 10;
+  FLAGS_compaction_rate_target_read_latency_p99_ms = 10;
+
+  CompactionRateTuner tuner(
+      kMaxRate,
+      [this] { return std::vector<scoped_refptr<Histogram>>{read_latency_}; },
+      [this] { return std::vector<scoped_refptr<Histogram>>{sync_latency_}; });
+  ASSERT_EQ(kMaxRate, tuner.bytes_per_sec());
+
+  // Slow reads decrease the rate down to the min rate.
+  int64_t prev_rate = tuner.bytes_per_sec();
+  for (int i = 0; i != 20; ++i) {
+    read_latency_->IncrementBy(20000, 100);
+    tuner.Tune();
+    ASSERT_LE(tuner.bytes_per_sec(), prev_rate);
+    prev_rate = tuner.bytes_per_sec();
+  }
+  ASSERT_GE(tuner.read_latency_p99_us(), 20000U);
+  ASSERT_LT(tuner.read_latency_p99_us(), 21000U);
+  ASSERT_EQ(FLAGS_compaction_rate_min_bytes_per_sec, tuner.bytes_per_sec());
+
+  // Fast reads restore the rate up to the max rate.
+  for (int i = 0; i != 40; ++i) {
+    read_latency_->IncrementBy(1000, 100);
+    tuner.Tune();
+    ASSERT_GE(tuner.bytes_per_sec(), prev_rate);
+    prev_rate = tuner.bytes_per_sec();
+  }
+  ASSERT_EQ(kMaxRate, tuner.bytes_per_sec());
+}
+
+} // namespace tserver
+} // namespace yb
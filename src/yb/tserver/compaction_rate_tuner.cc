@@ -0,0 +1,141 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/compaction_rate_tuner.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rocksdb/rate_limiter.h"
+
+#include "yb/util/histogram.pb.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(compaction_rate_min_bytes_per_sec, 10_MB,
+             "Compaction rate auto tuning never limits write rate of flushes and compactions "
+             "below this value.");
+DEFINE_int32(compaction_rate_target_read_latency_p99_ms, 50,
+             "Compaction rate auto tuning decreases write rate of flushes and compactions while "
+             "99th percentile of foreground read latency exceeds this value.");
+DEFINE_int32(compaction_rate_target_wal_sync_latency_p99_ms, 20,
+             "Compaction rate auto tuning decreases write rate of flushes and compactions while "
+             "99th percentile of WAL sync latency exceeds this value.");
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// The rate is decreased multiplicatively on latency violation, and increased additively by this
+// fraction of the max rate otherwise.
+constexpr double kDecreaseFactor = 0.75;
+constexpr double kIncreaseFraction = 0.05;
+
+} // namespace
+
+uint64_t HistogramWindow::Update(
+    const std::vector<scoped_refptr<Histogram>>& histograms, double percentile) {
+  std::unordered_map<const Histogram*, Counts> new_counts;
+  std::map<uint64_t, uint64_t> window;
+  uint64_t total = 0;
+  MetricJsonOptions opts;
+  opts.include_raw_histograms = true;
+  for (const auto& histogram : histograms) {
+    HistogramSnapshotPB snapshot;
+    if (!histogram->GetHistogramSnapshotPB(&snapshot, opts).ok()) {
+      continue;
+    }
+    auto& counts = new_counts[histogram.get()];
+    counts.histogram = histogram;
+    auto old_it = counts_.find(histogram.get());
+    for (int i = 0; i != snapshot.values_size(); ++i) {
+      auto value = snapshot.values(i);
+      auto count = snapshot.counts(i);
+      counts.counts[value] = count;
+      if (old_it != counts_.end()) {
+        auto old_count_it = old_it->second.counts.find(value);
+        if (old_count_it != old_it->second.counts.end()) {
+          count -= std::min(count, old_count_it->second);
+        }
+      }
+      if (count != 0) {
+        window[value] += count;
+        total += count;
+      }
+    }
+  }
+  // Histograms that were not passed, for instance of deleted tablets, are forgotten.
+  counts_.swap(new_counts);
+
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(total * percentile / 100), 1);
+  uint64_t seen = 0;
+  for (const auto& value_and_count : window) {
+    seen += value_and_count.second;
+    if (seen >= rank) {
+      return value_and_count.first;
+    }
+  }
+  return window.rbegin()->first;
+}
+
+CompactionRateTuner::CompactionRateTuner(int64_t max_bytes_per_sec,
+                                         HistogramsProvider read_latency,
+                                         HistogramsProvider wal_sync_latency)
+    : max_bytes_per_sec_(max_bytes_per_sec),
+      read_latency_(std::move(read_latency)),
+      wal_sync_latency_(std::move(wal_sync_latency)),
+      rate_limiter_(rocksdb::NewGenericRateLimiter(max_bytes_per_sec)),
+      bytes_per_sec_(max_bytes_per_sec) {
+}
+
+CompactionRateTuner::~CompactionRateTuner() {
+}
+
+void CompactionRateTuner::Tune() {
+  auto read_p99 = read_window_.Update(read_latency_(), 99);
+  auto wal_sync_p99 = wal_sync_window_.Update(wal_sync_latency_(), 99);
+  read_latency_p99_us_.store(read_p99, std::memory_order_release);
+  wal_sync_latency_p99_us_.store(wal_sync_p99, std::memory_order_release);
+
+  const int64_t min_bytes_per_sec =
+      std::min<int64_t>(FLAGS_compaction_rate_min_bytes_per_sec, max_bytes_per_sec_);
+  const int64_t old_bytes_per_sec = bytes_per_sec();
+  int64_t new_bytes_per_sec;
+  if (read_p99 > FLAGS_compaction_rate_target_read_latency_p99_ms * 1000ULL ||
+      wal_sync_p99 > FLAGS_compaction_rate_target_wal_sync_latency_p99_ms * 1000ULL) {
+    new_bytes_per_sec = std::max(
+        min_bytes_per_sec, static_cast<int64_t>(old_bytes_per_sec * kDecreaseFactor));
+  } else {
+    new_bytes_per_sec = std::min(
+        max_bytes_per_sec_,
+        old_bytes_per_sec + static_cast<int64_t>(max_bytes_per_sec_ * kIncreaseFraction));
+  }
+  if (new_bytes_per_sec == old_bytes_per_sec) {
+    return;
+  }
+  VLOG(1) << "Compaction rate " << old_bytes_per_sec << " => " << new_bytes_per_sec
+          << ", read latency p99: " << read_p99 << "us, WAL sync latency p99: " << wal_sync_p99
+          << "us";
+  rate_limiter_->SetBytesPerSecond(new_bytes_per_sec);
+  bytes_per_sec_.store(new_bytes_per_sec, std::memory_order_release);
+}
+
+} // namespace tserver
+} // namespace yb
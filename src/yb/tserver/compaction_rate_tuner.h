@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_COMPACTION_RATE_TUNER_H
+#define YB_TSERVER_COMPACTION_RATE_TUNER_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/metrics.h"
+
+namespace rocksdb {
+
+class RateLimiter;
+
+}
+
+namespace yb {
+namespace tserver {
+
+// Computes percentiles of values recorded by a set of histograms during a time window, i.e.
+// between two consecutive calls of Update.
+class HistogramWindow {
+ public:
+  // Returns the value at the given percentile among values recorded by the histograms since the
+  // previous call, or 0 if nothing was recorded.
+  uint64_t Update(const std::vector<scoped_refptr<Histogram>>& histograms, double percentile);
+
+ private:
+  struct Counts {
+    // Keeps the histogram alive, so its address is not reused by another histogram.
+    scoped_refptr<Histogram> histogram;
+    // Number of recorded values by value.
+    std::map<uint64_t, uint64_t> counts;
+  };
+
+  std::unordered_map<const Histogram*, Counts> counts_;
+};
+
+// Tunes the write rate limit of flushes and compactions shared by all tablets of the tablet
+// server. The rate is decreased while foreground read latency or WAL sync latency exceeds its
+// target, and is slowly restored otherwise, so compaction storms do not show up as client latency
+// spikes.
+class CompactionRateTuner {
+ public:
+  typedef std::function<std::vector<scoped_refptr<Histogram>>()> HistogramsProvider;
+
+  // read_latency returns histograms of foreground read latency, wal_sync_latency returns
+  // histograms of WAL sync latency. Both in microseconds.
+  CompactionRateTuner(int64_t max_bytes_per_sec,
+                      HistogramsProvider read_latency,
+                      HistogramsProvider wal_sync_latency);
+
+  ~CompactionRateTuner();
+
+  const std::shared_ptr<rocksdb::RateLimiter>& rate_limiter() const { return rate_limiter_; }
+
+  // Updates the rate using latencies observed since the previous call.
+  void Tune();
+
+  int64_t bytes_per_sec() const { return bytes_per_sec_.load(std::memory_order_acquire); }
+
+  int64_t max_bytes_per_sec() const { return max_bytes_per_sec_; }
+
+  // Latencies observed by the last Tune call, in microseconds.
+  uint64_t read_latency_p99_us() const {
+    return read_latency_p99_us_.load(std::memory_order_acquire);
+  }
+
+  uint64_t wal_sync_latency_p99_us() const {
+    return wal_sync_latency_p99_us_.load(std::memory_order_acquire);
+  }
+
+ private:
+  const int64_t max_bytes_per_sec_;
+  const HistogramsProvider read_latency_;
+  const HistogramsProvider wal_sync_latency_;
+  const std::shared_ptr<rocksdb::RateLimiter> rate_limiter_;
+
+  // Accessed only by Tune.
+  HistogramWindow read_window_;
+  HistogramWindow wal_sync_window_;
+
+  std::atomic<int64_t> bytes_per_sec_;
+  std::atomic<uint64_t> read_latency_p99_us_{0};
+  std::atomic<uint64_t> wal_sync_latency_p99_us_{0};
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_COMPACTION_RATE_TUNER_H
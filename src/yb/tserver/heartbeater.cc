@@ -35,6 +35,7 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <unordered_map>
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -48,6 +49,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -183,6 +185,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_;
   uint64_t prev_writes_;
 
+  // Stores the read and write ops of each tablet at the last metrics submission.
+  std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> prev_tablet_ops_;
+
   MonoTime start_time_;
 
   DISALLOW_COPY_AND_ASSIGN(Thread);
@@ -422,6 +427,37 @@ Status Heartbeater::Thread::TryHeartbeat() {
     prev_writes_ = num_writes;
     req.mutable_metrics()->set_read_ops_per_sec(rops_per_sec);
     req.mutable_metrics()->set_write_ops_per_sec(wops_per_sec);
+
+    // Report the load of the tablets led by this server, so the master can balance by it.
+    std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> tablet_ops;
+    for (const auto& tablet_peer : tablet_peers) {
+      if (!tablet_peer) {
+        continue;
+      }
+      shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
+      if (!tablet_class) {
+        continue;
+      }
+      const auto* tablet_metrics = tablet_class->metrics();
+      const uint64_t tablet_reads = tablet_metrics->ql_read_latency->TotalCount() +
+                                    tablet_metrics->redis_read_latency->TotalCount();
+      const uint64_t tablet_writes = tablet_metrics->write_lock_latency->TotalCount();
+      tablet_ops[tablet_peer->tablet_id()] = std::make_pair(tablet_reads, tablet_writes);
+      if (tablet_peer->LeaderStatus() == consensus::LeaderStatus::NOT_LEADER) {
+        continue;
+      }
+      auto* reported = req.add_tablet_metrics();
+      reported->set_tablet_id(tablet_peer->tablet_id());
+      reported->set_sst_file_size(tablet_class->GetTotalSSTFileSizes());
+      auto prev = prev_tablet_ops_.find(tablet_peer->tablet_id());
+      if (div > 0 && prev != prev_tablet_ops_.end()) {
+        reported->set_read_ops_per_sec(
+            static_cast<double>(tablet_reads - prev->second.first) / div);
+        reported->set_write_ops_per_sec(
+            static_cast<double>(tablet_writes - prev->second.second) / div);
+      }
+    }
+    prev_tablet_ops_ = std::move(tablet_ops);
     uint64_t uptime_seconds = CalculateUptime();
 
     req.mutable_metrics()->set_uptime_seconds(uptime_seconds);
@@ -32,6 +32,9 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <mutex>
+#include <unordered_set>
+
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -64,6 +67,7 @@
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/rate_limiter.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 
 using namespace yb::size_literals;
 
@@ -111,6 +115,13 @@ DEFINE_int64(remote_boostrap_rate_limit_bytes_per_sec, 100_MB,
              "the total limit will be 2 * remote_boostrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files that a remote bootstrap session downloads "
+             "concurrently. The session's share of remote_boostrap_rate_limit_bytes_per_sec is "
+             "split between the files being downloaded.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, runtime);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -592,16 +603,23 @@ Status RemoteBootstrapClient::DownloadFile(
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string linked_path;
+    {
+      std::lock_guard<std::mutex> lock(inode2file_mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_path = it->second;
+      }
+    }
+    if (!linked_path.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
+                          << " => " << linked_path;
+      auto link_status = fs_manager_->env()->LinkFile(linked_path, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_path
                              << ": " << link_status;
     }
   }
@@ -618,12 +636,82 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
   return Status::OK();
 }
 
+namespace {
+
+double TransferRateMBps(uint64_t bytes, const MonoDelta& elapsed) {
+  auto seconds = elapsed.ToSeconds();
+  return seconds > 0 ? bytes / seconds / 1_MB : 0;
+}
+
+} // namespace
+
+Status RemoteBootstrapClient::DownloadRocksDBFile(
+    const tablet::FilePB& file_pb, const std::string& dir) {
+  DataIdPB data_id;
+  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  auto start = MonoTime::Now();
+  n_downloads_in_flight_.fetch_add(1, std::memory_order_acq_rel);
+  auto status = DownloadFile(file_pb, dir, &data_id);
+  n_downloads_in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+  RETURN_NOT_OK(status);
+  auto elapsed = MonoTime::Now().GetDeltaSince(start);
+  LOG_WITH_PREFIX(INFO) << "Downloaded file " << file_pb.name() << " of size "
+                        << file_pb.size_bytes() << " in " << elapsed.ToSeconds() << " seconds ("
+                        << TransferRateMBps(file_pb.size_bytes(), elapsed) << " MB/s)";
+  return Status::OK();
+}
+
+Status RemoteBootstrapClient::DownloadRocksDBFilesConcurrently(
+    const std::vector<const tablet::FilePB*>& files, const std::string& dir) {
+  const int num_threads = std::min<int>(FLAGS_remote_bootstrap_max_concurrent_file_downloads,
+                                        files.size());
+  if (num_threads <= 1) {
+    for (const auto* file_pb : files) {
+      RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, dir));
+    }
+    return Status::OK();
+  }
+
+  // Declared before the pool, so they outlive the tasks running on it.
+  std::mutex mutex;
+  Status result;
+  std::atomic<bool> failed(false);
+  std::unique_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder("rb-download").set_max_threads(num_threads).Build(&pool));
+  for (const auto* file_pb : files) {
+    auto submit_status = pool->SubmitFunc([this, &dir, &mutex, &result, &failed, file_pb] {
+      if (failed.load(std::memory_order_acquire)) {
+        return;
+      }
+      auto status = DownloadRocksDBFile(*file_pb, dir);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+        failed.store(true, std::memory_order_release);
+      }
+    });
+    if (!submit_status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      failed.store(true, std::memory_order_release);
+      if (result.ok()) {
+        result = submit_status;
+      }
+      break;
+    }
+  }
+  pool->Wait();
+  return result;
+}
+
 Status RemoteBootstrapClient::CreateTabletDirectories(const string& db_dir, FsManager* fs) {
   // Create the directory table-uuid first.
   RETURN_NOT_OK_PREPEND(fs->CreateDirIfMissing(DirName(db_dir)),
@@ -645,16 +733,32 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
-  DataIdPB data_id;
-  data_id.set_type(DataIdPB::ROCKSDB_FILE);
+  // Files that share an inode with an earlier file are hard linked once that file is downloaded,
+  // so only the first file of each inode is fetched from the remote peer.
+  std::vector<const tablet::FilePB*> files_to_fetch;
+  std::vector<const tablet::FilePB*> files_to_link;
+  std::unordered_set<uint64_t> fetched_inodes;
+  uint64_t total_bytes = 0;
   for (auto const& file_pb : new_sb->rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-              << " in " << elapsed.ToSeconds() << " seconds";
+    if (file_pb.inode() != 0 && !fetched_inodes.insert(file_pb.inode()).second) {
+      files_to_link.push_back(&file_pb);
+    } else {
+      files_to_fetch.push_back(&file_pb);
+      total_bytes += file_pb.size_bytes();
+    }
   }
 
+  auto start = MonoTime::Now();
+  RETURN_NOT_OK(DownloadRocksDBFilesConcurrently(files_to_fetch, rocksdb_dir));
+  for (const auto* file_pb : files_to_link) {
+    RETURN_NOT_OK(DownloadRocksDBFile(*file_pb, rocksdb_dir));
+  }
+  auto elapsed = MonoTime::Now().GetDeltaSince(start);
+  LOG_WITH_PREFIX(INFO) << "Downloaded " << files_to_fetch.size() << " RocksDB files ("
+                        << files_to_link.size() << " more linked) of total size " << total_bytes
+                        << " in " << elapsed.ToSeconds() << " seconds ("
+                        << TransferRateMBps(total_bytes, elapsed) << " MB/s)";
+
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
   auto intents_tmp_dir = JoinPathSegments(rocksdb_dir, tablet::kIntentsSubdir);
   if (fs_manager_->env()->FileExists(intents_tmp_dir)) {
@@ -753,12 +857,15 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
   std::unique_ptr<RateLimiter> rate_limiter;
 
   if (FLAGS_remote_boostrap_rate_limit_bytes_per_sec > 0) {
-    static auto rate_updater = []() {
+    auto rate_updater = [this]() {
       if (n_started_.load(std::memory_order_acquire) < 1) {
         YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap sessions: " << n_started_;
         return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec);
       }
-      return static_cast<uint64_t>(FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_started_);
+      // Files of this session that are downloaded concurrently share the session's rate.
+      auto downloads = std::max(1, n_downloads_in_flight_.load(std::memory_order_acquire));
+      return static_cast<uint64_t>(
+          FLAGS_remote_boostrap_rate_limit_bytes_per_sec / n_started_ / downloads);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -769,6 +876,7 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
+  controller.set_enable_compression(compress_);
   FetchDataRequestPB req;
 
   bool done = false;
@@ -35,6 +35,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -113,6 +114,9 @@ class RemoteBootstrapClient {
   // ts_manager pointer allows the bootstrap function to assign non-random
   // data and wal directories for the bootstrapped tablets.
   // TODO: Rename these parameters to bootstrap_source_*.
+  // Data is fetched with compressed RPCs when 'compress' is true, see ShouldCompressRpcs().
+  void set_compress(bool compress) { compress_ = compress; }
+
   CHECKED_STATUS Start(const std::string& bootstrap_peer_uuid,
                        rpc::ProxyCache* proxy_cache,
                        const HostPort& bootstrap_peer_addr,
@@ -187,6 +191,14 @@ class RemoteBootstrapClient {
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Download a single RocksDB file into 'dir' and log its transfer rate.
+  CHECKED_STATUS DownloadRocksDBFile(const tablet::FilePB& file_pb, const std::string& dir);
+
+  // Download 'files' into 'dir', up to remote_bootstrap_max_concurrent_file_downloads at a time.
+  // Returns the first error encountered, after all the started downloads are done.
+  CHECKED_STATUS DownloadRocksDBFilesConcurrently(
+      const std::vector<const tablet::FilePB*>& files, const std::string& dir);
+
   // Return standard log prefix.
   std::string LogPrefix();
 
@@ -200,6 +212,8 @@ class RemoteBootstrapClient {
   // Total number of remote bootstrap sessions. Used to calculate the transmission rate across all
   // the sessions.
   static std::atomic<int32_t> n_started_;
+  // Number of files of this session that are being downloaded right now.
+  std::atomic<int32_t> n_downloads_in_flight_{0};
   bool downloaded_wal_;     // WAL segments downloaded.
   bool downloaded_blocks_;  // Data blocks downloaded.
   bool downloaded_rocksdb_files_;
@@ -216,6 +230,7 @@ class RemoteBootstrapClient {
 
   tablet::TabletStatusListener* status_listener_;
   std::shared_ptr<RemoteBootstrapServiceProxy> proxy_;
+  bool compress_ = false;
   std::string session_id_;
   uint64_t session_idle_timeout_millis_;
   gscoped_ptr<tablet::TabletSuperBlockPB> superblock_;
@@ -230,6 +245,7 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
+  std::mutex inode2file_mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
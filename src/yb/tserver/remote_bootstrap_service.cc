@@ -32,6 +32,7 @@
 #include "yb/tserver/remote_bootstrap_service.h"
 
 #include <algorithm>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -48,9 +49,11 @@
 #include "yb/rpc/rpc_context.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/async_io_executor.h"
 #include "yb/util/crc.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 
 // Note, this macro assumes the existence of a local var named 'context'.
 #define RPC_RETURN_APP_ERROR(app_err, message, s) \
@@ -125,10 +128,12 @@ static void SetupErrorAndRespond(rpc::RpcContext* context,
 RemoteBootstrapServiceImpl::RemoteBootstrapServiceImpl(
     FsManager* fs_manager,
     TabletPeerLookupIf* tablet_peer_lookup,
-    const scoped_refptr<MetricEntity>& metric_entity)
+    const scoped_refptr<MetricEntity>& metric_entity,
+    AsyncIoExecutor* io_executor)
     : RemoteBootstrapServiceIf(metric_entity),
       fs_manager_(CHECK_NOTNULL(fs_manager)),
       tablet_peer_lookup_(CHECK_NOTNULL(tablet_peer_lookup)),
+      io_executor_(io_executor),
       shutdown_latch_(1) {
   CHECK_OK(Thread::Create("remote-bootstrap", "rb-session-exp",
                           &RemoteBootstrapServiceImpl::EndExpiredSessions, this,
@@ -287,20 +292,54 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
     ResetSessionExpirationUnlocked(session_id);
   }
 
-  session->EnsureRateLimiterIsInitialized();
+  uint64_t rate_limit;
+  {
+    std::lock_guard<std::mutex> l(session->rate_limiter_mutex());
+    session->EnsureRateLimiterIsInitialized();
+    rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  }
 
   MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
 
-  uint64_t offset = req->offset();
-  VLOG(3) << " rate limiter max len: "  << session->rate_limiter().GetMaxSizeForNextTransmission();
-  auto rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
-  int64_t client_maxlen = rate_limit == 0
-      ? req->max_length() : std::min(static_cast<uint64_t>(req->max_length()), rate_limit);
   const DataIdPB& data_id = req->data_id();
   RemoteBootstrapErrorPB::Code error_code = RemoteBootstrapErrorPB::UNKNOWN_ERROR;
   RPC_RETURN_NOT_OK(ValidateFetchRequestDataId(data_id, &error_code, session),
                     error_code, "Invalid DataId");
 
+  int64_t client_maxlen = rate_limit == 0
+      ? req->max_length() : std::min(static_cast<uint64_t>(req->max_length()), rate_limit);
+  VLOG(3) << " rate limiter max len: "  << rate_limit;
+
+  // Reading the file and waiting for the rate limiter could take a while, so it is done on the
+  // I/O threads, leaving the service threads to other requests.
+  if (io_executor_) {
+    auto context_ptr = std::make_shared<rpc::RpcContext>(std::move(context));
+    num_async_fetches_.fetch_add(1, std::memory_order_acq_rel);
+    auto status = io_executor_->Submit(
+        [this, session, req, resp, client_maxlen, context_ptr] {
+          DoFetchData(session, *req, client_maxlen, resp, context_ptr.get());
+          num_async_fetches_.fetch_sub(1, std::memory_order_acq_rel);
+          return Status::OK();
+        });
+    if (status.ok()) {
+      return;
+    }
+    num_async_fetches_.fetch_sub(1, std::memory_order_acq_rel);
+    YB_LOG_EVERY_N_SECS(WARNING, 10) << "Reading remote bootstrap data inline: " << status;
+    DoFetchData(session, *req, client_maxlen, resp, context_ptr.get());
+    return;
+  }
+  DoFetchData(session, *req, client_maxlen, resp, &context);
+}
+
+void RemoteBootstrapServiceImpl::DoFetchData(
+    const scoped_refptr<RemoteBootstrapSessionClass>& session, const FetchDataRequestPB& req,
+    int64_t client_maxlen, FetchDataResponsePB* resp, rpc::RpcContext* context_ptr) {
+  auto& context = *context_ptr;
+  uint64_t offset = req.offset();
+  const DataIdPB& data_id = req.data_id();
+  RemoteBootstrapErrorPB::Code error_code = RemoteBootstrapErrorPB::UNKNOWN_ERROR;
+
   DataChunkPB* data_chunk = resp->mutable_chunk();
   string* data = data_chunk->mutable_data();
   int64_t total_data_length = 0;
@@ -309,7 +348,10 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Unable to get piece of data file");
 
   data_chunk->set_total_data_length(total_data_length);
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
+  {
+    std::lock_guard<std::mutex> l(session->rate_limiter_mutex());
+    session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
+  }
   data_chunk->set_offset(offset);
 
   // Calculate checksum.
@@ -338,6 +380,11 @@ void RemoteBootstrapServiceImpl::Shutdown() {
   shutdown_latch_.CountDown();
   session_expiration_thread_->Join();
 
+  // Fetches running on the I/O threads use the sessions.
+  while (num_async_fetches_.load(std::memory_order_acquire) != 0) {
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+
   // Destroy all remote bootstrap sessions.
   vector<string> session_ids;
   for (const MonoTimeMap::value_type& entry : session_expirations_) {
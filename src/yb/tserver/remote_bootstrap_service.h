@@ -47,6 +47,7 @@
 #include "yb/util/thread.h"
 
 namespace yb {
+class AsyncIoExecutor;
 class FsManager;
 
 namespace log {
@@ -59,9 +60,11 @@ class TabletPeerLookupIf;
 
 class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
  public:
+  // When io_executor is set, FetchData reads files on its threads instead of the service threads.
   RemoteBootstrapServiceImpl(FsManager* fs_manager,
                              TabletPeerLookupIf* tablet_peer_lookup,
-                             const scoped_refptr<MetricEntity>& metric_entity);
+                             const scoped_refptr<MetricEntity>& metric_entity,
+                             AsyncIoExecutor* io_executor = nullptr);
 
   virtual void BeginRemoteBootstrapSession(const BeginRemoteBootstrapSessionRequestPB* req,
                                            BeginRemoteBootstrapSessionResponsePB* resp,
@@ -107,6 +110,13 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
       RemoteBootstrapErrorPB::Code* app_error,
       const scoped_refptr<RemoteBootstrapSessionClass>& session) const;
 
+  // Reads the requested piece of data, waits for the session rate limiter and responds.
+  void DoFetchData(const scoped_refptr<RemoteBootstrapSessionClass>& session,
+                   const FetchDataRequestPB& req,
+                   int64_t client_maxlen,
+                   FetchDataResponsePB* resp,
+                   rpc::RpcContext* context);
+
   // Take note of session activity; Re-update the session timeout deadline.
   void ResetSessionExpirationUnlocked(const std::string& session_id);
 
@@ -121,6 +131,9 @@ class RemoteBootstrapServiceImpl : public RemoteBootstrapServiceIf {
 
   FsManager* fs_manager_;
   TabletPeerLookupIf* tablet_peer_lookup_;
+  AsyncIoExecutor* const io_executor_;
+  // Number of FetchData calls handed over to io_executor_ that have not completed yet.
+  std::atomic<int> num_async_fetches_{0};
 
   // Protects sessions_ and session_expirations_ maps.
   mutable simple_spinlock sessions_lock_;
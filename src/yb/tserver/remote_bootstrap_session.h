@@ -33,6 +33,7 @@
 #define YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -177,6 +178,10 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   RateLimiter& rate_limiter() { return rate_limiter_; }
 
+  // Serializes access to rate_limiter(), since FetchData requests for different files of the same
+  // session may be processed concurrently.
+  std::mutex& rate_limiter_mutex() { return rate_limiter_mutex_; }
+
  protected:
   friend class RefCountedThreadSafe<RemoteBootstrapSession>;
 
@@ -245,6 +250,7 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   // Used to limit the transmission rate.
   RateLimiter rate_limiter_;
+  std::mutex rate_limiter_mutex_;
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
   // calculate the rate for the rate limiter.
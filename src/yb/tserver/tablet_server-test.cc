@@ -563,6 +563,40 @@ TEST_F(TabletServerTest, TestCreateTablet_TabletExists) {
   }
 }
 
+TEST_F(TabletServerTest, TestCreateTablets) {
+  const std::vector<std::string> kTabletIds = { kTabletId, "batch-tablet-1", "batch-tablet-2" };
+  CreateTabletsRequestPB req;
+  CreateTabletsResponsePB resp;
+  RpcController rpc;
+
+  req.set_dest_uuid(mini_server_->server()->fs_manager()->uuid());
+  Schema schema = SchemaBuilder(schema_).Build();
+  for (const auto& tablet_id : kTabletIds) {
+    auto* tablet_req = req.add_tablets();
+    tablet_req->set_dest_uuid(req.dest_uuid());
+    tablet_req->set_table_id("testtb");
+    tablet_req->set_tablet_id(tablet_id);
+    tablet_req->set_table_name("testtb");
+    tablet_req->mutable_config()->CopyFrom(mini_server_->CreateLocalConfig());
+    ASSERT_OK(SchemaToPB(schema, tablet_req->mutable_schema()));
+  }
+
+  SCOPED_TRACE(req.DebugString());
+  ASSERT_OK(admin_proxy_->CreateTablets(req, &resp, &rpc));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_FALSE(resp.has_error());
+  ASSERT_EQ(kTabletIds.size(), static_cast<size_t>(resp.tablets_size()));
+
+  // The already existing tablet is reported per tablet, without failing the rest of the batch.
+  ASSERT_TRUE(resp.tablets(0).has_error());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_ALREADY_EXISTS, resp.tablets(0).error().code());
+  for (size_t i = 1; i < kTabletIds.size(); ++i) {
+    ASSERT_FALSE(resp.tablets(i).has_error());
+    std::shared_ptr<TabletPeer> tablet;
+    ASSERT_TRUE(mini_server_->server()->tablet_manager()->LookupTablet(kTabletIds[i], &tablet));
+  }
+}
+
 TEST_F(TabletServerTest, TestDeleteTablet) {
   std::shared_ptr<TabletPeer> tablet;
 
@@ -816,6 +850,62 @@ TEST_F(TabletServerTest, TestWriteOutOfBounds) {
   }
 }
 
+TEST_F(TabletServerTest, TestGetChanges) {
+  GetChangesRequestPB req;
+  GetChangesResponsePB resp;
+  RpcController controller;
+  req.set_tablet_id(kTabletId);
+  req.set_consumer_id("consumer");
+
+  // The first request of a consumer starts the stream at the last committed operation.
+  ASSERT_NO_FATALS(InsertTestRowsRemote(0, 1, 1));
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(0, resp.records_size());
+
+  ASSERT_NO_FATALS(InsertTestRowsRemote(0, 2, 3));
+  req.set_max_records(2);
+  resp.Clear();
+  controller.Reset();
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(2, resp.records_size());
+  const auto checkpoint = resp.checkpoint();
+  for (int i = 0; i != resp.records_size(); ++i) {
+    const auto& record = resp.records(i);
+    ASSERT_GT(record.changes_size(), 0);
+    for (const auto& change : record.changes()) {
+      ASSERT_EQ(CDCRowChangePB::WRITE, change.type());
+      ASSERT_EQ(1, change.key_size());
+      ASSERT_EQ(2 + i, change.key(0).int32_value());
+    }
+  }
+
+  // The checkpoint is kept for the consumer, so the remaining row is returned next.
+  req.clear_max_records();
+  resp.Clear();
+  controller.Reset();
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(1, resp.records_size());
+  ASSERT_EQ(4, resp.records(0).changes(0).key(0).int32_value());
+
+  // An explicit checkpoint overrides the kept one.
+  *req.mutable_from_checkpoint() = checkpoint;
+  resp.Clear();
+  controller.Reset();
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+  ASSERT_EQ(1, resp.records_size());
+
+  req.clear_from_checkpoint();
+  req.set_unregister_consumer(true);
+  resp.Clear();
+  controller.Reset();
+  ASSERT_OK(proxy_->GetChanges(req, &resp, &controller));
+  ASSERT_FALSE(resp.has_error()) << resp.ShortDebugString();
+}
+
 namespace {
 
 void CalcTestRowChecksum(uint64_t *out, int32_t key, uint8_t string_field_defined = true) {
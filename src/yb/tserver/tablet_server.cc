@@ -277,9 +277,9 @@ Status TabletServer::RegisterServices() {
                                                      rpc::ServicePriority::kHigh));
 
   std::unique_ptr<ServiceIf> remote_bootstrap_service =
-      std::make_unique<YB_EDITION_NS_PREFIX RemoteBootstrapServiceImpl>(fs_manager_.get(),
-                                                                        tablet_manager_.get(),
-                                                                        metric_entity());
+      std::make_unique<YB_EDITION_NS_PREFIX RemoteBootstrapServiceImpl>(
+          fs_manager_.get(), tablet_manager_.get(), metric_entity(),
+          tablet_manager_->async_io_executor());
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_remote_bootstrap_svc_queue_length,
                                                      std::move(remote_bootstrap_service)));
   return Status::OK();
@@ -332,6 +332,10 @@ Status TabletServer::PopulateLiveTServers(const master::TSHeartbeatResponsePB& h
   // from the master and compare it with information stored here. Based on this information, we
   // can only send diff updates CQL clients about whether a node came up or went down.
   live_tservers_.assign(heartbeat_resp.tservers().begin(), heartbeat_resp.tservers().end());
+  if (heartbeat_resp.has_tablet_locations_version()) {
+    tablet_locations_version_.store(
+        heartbeat_resp.tablet_locations_version(), std::memory_order_release);
+  }
   return Status::OK();
 }
 
@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TABLET_SERVER_H_
 #define YB_TSERVER_TABLET_SERVER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -133,6 +134,11 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
     return Status::OK();
   }
 
+  // Version of tablet locations from the last heartbeat response, 0 if it is not known yet.
+  uint64_t tablet_locations_version() const {
+    return tablet_locations_version_.load(std::memory_order_acquire);
+  }
+
   const std::string& permanent_uuid() const { return fs_manager_->uuid(); }
 
   // Returns the proxy to call this tablet server locally.
@@ -199,6 +205,9 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // List of tservers that are alive from the master's perspective.
   std::vector<master::TSInformationPB> live_tservers_;
 
+  // Version of tablet locations sent by the master with live_tservers_.
+  std::atomic<uint64_t> tablet_locations_version_{0};
+
   // Lock to protect live_tservers_, cluster_uuid_.
   mutable simple_spinlock lock_;
 
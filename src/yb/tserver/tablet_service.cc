@@ -33,10 +33,14 @@
 #include "yb/tserver/tablet_service.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
 #include <boost/scope_exit.hpp>
 
 #include "yb/common/schema.h"
@@ -52,6 +56,10 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/gutil/walltime.h"
+#include "yb/rocksdb/perf_context.h"
+#include "yb/rocksdb/perf_level.h"
+#include "yb/rpc/inbound_call.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tserver/remote_bootstrap_service.h"
@@ -71,10 +79,14 @@
 #include "yb/tserver/tserver.pb.h"
 #include "yb/util/crc.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/env.h"
+#include "yb/util/env_util.h"
 #include "yb/util/faststring.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/hash_util.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/path_util.h"
 #include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
@@ -107,6 +119,34 @@ DEFINE_bool(parallelize_read_ops, true,
 TAG_FLAG(parallelize_read_ops, advanced);
 TAG_FLAG(parallelize_read_ops, runtime);
 
+DEFINE_bool(collect_read_cost, true,
+            "Account the CPU time and the RocksDB block and memtable accesses of reads in tablet "
+            "metrics. Required to return the cost of a read to clients that ask for it.");
+TAG_FLAG(collect_read_cost, advanced);
+TAG_FLAG(collect_read_cost, runtime);
+
+DEFINE_int32(max_concurrent_reads_per_tablet, 0,
+             "Maximum number of read RPCs a tablet serves at the same time. Further reads are "
+             "rejected with a retryable error, so that a single hot tablet cannot occupy all the "
+             "RPC threads of the tablet server. 0 means no limit.");
+TAG_FLAG(max_concurrent_reads_per_tablet, advanced);
+TAG_FLAG(max_concurrent_reads_per_tablet, runtime);
+
+DEFINE_int32(write_throttle_l0_files_soft_limit, 16,
+             "Number of level 0 files of a tablet's RocksDB at which the tablet starts rejecting "
+             "new writes with a retryable error. Between this and "
+             "write_throttle_l0_files_hard_limit writes are rejected with a probability growing "
+             "linearly, so clients back off before RocksDB stalls the apply of replicated "
+             "operations. 0 disables throttling.");
+TAG_FLAG(write_throttle_l0_files_soft_limit, advanced);
+TAG_FLAG(write_throttle_l0_files_soft_limit, runtime);
+
+DEFINE_int32(write_throttle_l0_files_hard_limit, 24,
+             "Number of level 0 files of a tablet's RocksDB at which all new writes to the tablet "
+             "are rejected with a retryable error.");
+TAG_FLAG(write_throttle_l0_files_hard_limit, advanced);
+TAG_FLAG(write_throttle_l0_files_hard_limit, runtime);
+
 // Fault injection flags.
 DEFINE_test_flag(int32, scanner_inject_latency_on_each_batch_ms, 0,
                  "If set, the scanner will pause the specified number of milliesconds "
@@ -143,6 +183,13 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
 DEFINE_test_flag(double, respond_write_failed_probability, 0.0,
                  "Probability to respond that write request is failed");
 
+DEFINE_bool(serve_strong_reads_from_followers, false,
+            "If true, a follower serves non-transactional reads with strong consistency level. "
+            "Such a read is performed at the maximal possible hybrid time of other servers, after "
+            "the safe time propagated by the leader passes it, so it stays linearizable.");
+TAG_FLAG(serve_strong_reads_from_followers, advanced);
+TAG_FLAG(serve_strong_reads_from_followers, runtime);
+
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -188,6 +235,92 @@ using tablet::WriteOperationState;
 
 namespace {
 
+// RocksDB perf context counters that make up the cost of a read.
+struct ReadCostCounters {
+  uint64_t block_cache_hits;
+  uint64_t block_reads;
+  uint64_t block_read_bytes;
+  uint64_t memtable_lookups;
+  uint64_t seeks;
+
+  static ReadCostCounters Current() {
+    const auto& context = rocksdb::perf_context;
+    return ReadCostCounters {
+      context.block_cache_hit_count,
+      context.block_read_count,
+      context.block_read_byte,
+      context.get_from_memtable_count + context.seek_on_memtable_count,
+      context.seek_child_seek_count
+    };
+  }
+};
+
+// Accounts the resources consumed by the current thread from construction until Finish(). The
+// perf context is thread local, so RocksDB counters are taken as deltas, which keeps them
+// correct when the perf context is also collected for the trace.
+class ReadCostTracker {
+ public:
+  ReadCostTracker() : perf_level_(rocksdb::GetPerfLevel()) {
+    rocksdb::SetPerfLevel(std::max(perf_level_, rocksdb::PerfLevel::kEnableCount));
+    start_counters_ = ReadCostCounters::Current();
+    start_cpu_time_us_ = GetThreadCpuTimeMicros();
+  }
+
+  ~ReadCostTracker() {
+    rocksdb::SetPerfLevel(perf_level_);
+  }
+
+  // Adds the consumed resources to the tablet metrics, and to the response when 'cost' is not
+  // null.
+  void Finish(const tablet::TabletMetrics& metrics, const rpc::RpcContext& context,
+              const ReadResponsePB& resp, ReadCostPB* cost) {
+    auto counters = ReadCostCounters::Current();
+    uint64_t cpu_time_us = std::max<MicrosecondsInt64>(
+        GetThreadCpuTimeMicros() - start_cpu_time_us_, 0);
+    uint64_t block_cache_hits = counters.block_cache_hits - start_counters_.block_cache_hits;
+    uint64_t block_reads = counters.block_reads - start_counters_.block_reads;
+    uint64_t block_read_bytes = counters.block_read_bytes - start_counters_.block_read_bytes;
+    uint64_t memtable_lookups = counters.memtable_lookups - start_counters_.memtable_lookups;
+    uint64_t seeks = counters.seeks - start_counters_.seeks;
+
+    metrics.read_cpu_time->IncrementBy(cpu_time_us);
+    metrics.read_block_cache_hits->IncrementBy(block_cache_hits);
+    metrics.read_block_reads->IncrementBy(block_reads);
+    metrics.read_block_read_bytes->IncrementBy(block_read_bytes);
+    metrics.read_memtable_lookups->IncrementBy(memtable_lookups);
+    metrics.read_seeks->IncrementBy(seeks);
+
+    if (!cost) {
+      return;
+    }
+    cost->set_queue_wait_us(context.GetTimeInQueue().ToMicroseconds());
+    cost->set_cpu_time_us(cpu_time_us);
+    cost->set_block_cache_hits(block_cache_hits);
+    cost->set_block_reads(block_reads);
+    cost->set_block_read_bytes(block_read_bytes);
+    cost->set_memtable_lookups(memtable_lookups);
+    cost->set_seeks(seeks);
+    // Includes the cost field itself, with all the values above already set.
+    cost->set_response_bytes(resp.ByteSizeLong() + context.RpcSidecarsSize());
+  }
+
+ private:
+  const rocksdb::PerfLevel perf_level_;
+  ReadCostCounters start_counters_;
+  MicrosecondsInt64 start_cpu_time_us_;
+};
+
+template <class Req>
+bool CanServeStrongReadFromFollower(const Req& req) {
+  return false;
+}
+
+// Reads with a specified read time belong to a transaction, and are served by the leader.
+bool CanServeStrongReadFromFollower(const ReadRequestPB& req) {
+  return FLAGS_serve_strong_reads_from_followers &&
+         req.consistency_level() == YBConsistencyLevel::STRONG && !req.has_read_time();
+}
+
 template<class RespClass>
 bool GetConsensusOrRespond(const TabletPeerPtr& tablet_peer,
                            RespClass* resp,
@@ -203,6 +336,58 @@ bool GetConsensusOrRespond(const TabletPeerPtr& tablet_peer,
   return true;
 }
 
+void SetupError(TabletServerErrorPB* error, const Status& s, TabletServerErrorPB::Code code) {
+  StatusToPB(s, error->mutable_status());
+  error->set_code(code);
+}
+
+// Handles a single request of MultiRaftUpdateConsensus, reporting errors in 'resp' with the same
+// codes UpdateConsensus would use.
+void UpdateConsensusInBatch(
+    TabletPeerLookupIf* tablet_manager, ConsensusRequestPB* req, ConsensusResponsePB* resp) {
+  const string& local_uuid = tablet_manager->NodeInstance().permanent_uuid();
+  if (PREDICT_FALSE(req->has_dest_uuid() && req->dest_uuid() != local_uuid)) {
+    SetupError(resp->mutable_error(),
+               STATUS_SUBSTITUTE(InvalidArgument,
+                                 "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                                 "Local UUID: $0. Requested UUID: $1",
+                                 local_uuid, req->dest_uuid()),
+               TabletServerErrorPB::WRONG_SERVER_UUID);
+    return;
+  }
+
+  TabletPeerPtr tablet_peer;
+  Status s = tablet_manager->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupError(resp->mutable_error(), s,
+               s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                        : TabletServerErrorPB::TABLET_NOT_FOUND);
+    return;
+  }
+
+  tablet::TabletStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    SetupError(resp->mutable_error(),
+               STATUS(IllegalState, "Tablet not RUNNING", tablet::TabletStatePB_Name(state)),
+               TabletServerErrorPB::TABLET_NOT_RUNNING);
+    return;
+  }
+
+  shared_ptr<Consensus> consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    SetupError(resp->mutable_error(),
+               STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running"),
+               TabletServerErrorPB::TABLET_NOT_RUNNING);
+    return;
+  }
+
+  s = consensus->Update(req, resp);
+  if (PREDICT_FALSE(!s.ok())) {
+    resp->Clear();
+    SetupError(resp->mutable_error(), s, TabletServerErrorPB::UNKNOWN_ERROR);
+  }
+}
+
 Status GetTabletRef(const TabletPeerPtr& tablet_peer,
                     shared_ptr<Tablet>* tablet,
                     TabletServerErrorPB::Code* error_code) {
@@ -214,6 +399,58 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
   return Status::OK();
 }
 
+// Completes the operation of the whole request, when operations of all its states complete.
+// Reports the first error, if any.
+class MultiOperationCompletionCallback : public tablet::OperationCompletionCallback {
+ public:
+  struct Shared {
+    Shared(std::unique_ptr<tablet::OperationCompletionCallback> callback_, size_t operations)
+        : callback(std::move(callback_)), operations_left(operations) {}
+
+    std::unique_ptr<tablet::OperationCompletionCallback> callback;
+    std::atomic<size_t> operations_left;
+    std::mutex mutex;
+  };
+
+  explicit MultiOperationCompletionCallback(std::shared_ptr<Shared> shared)
+      : shared_(std::move(shared)) {}
+
+  void OperationCompleted() override {
+    if (!status_.ok()) {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      if (!shared_->callback->has_error()) {
+        shared_->callback->set_error(status_, code_);
+      }
+    }
+    if (shared_->operations_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      shared_->callback->OperationCompleted();
+    }
+  }
+
+ private:
+  std::shared_ptr<Shared> shared_;
+};
+
+// Completes one heartbeat of a batch, storing its result to the response instead of failing the
+// whole request, so expiration of one transaction does not affect other transactions of the batch.
+class HeartbeatCompletionCallback : public tablet::OperationCompletionCallback {
+ public:
+  HeartbeatCompletionCallback(
+      std::shared_ptr<MultiOperationCompletionCallback::Shared> shared, AppStatusPB* result)
+      : shared_(std::move(shared)), result_(result) {}
+
+  void OperationCompleted() override {
+    StatusToPB(status_, result_);
+    if (shared_->operations_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      shared_->callback->OperationCompleted();
+    }
+  }
+
+ private:
+  std::shared_ptr<MultiOperationCompletionCallback::Shared> shared_;
+  AppStatusPB* result_;
+};
+
 } // namespace
 
 template<class Resp>
@@ -241,6 +478,38 @@ bool TabletServiceImpl::CheckMemoryPressure(
   return true;
 }
 
+bool TabletServiceImpl::CheckCompactionDebt(
+    tablet::Tablet* tablet, WriteResponsePB* resp, rpc::RpcContext* context) {
+  const int soft_limit = FLAGS_write_throttle_l0_files_soft_limit;
+  if (soft_limit <= 0) {
+    return true;
+  }
+  auto l0_delay_trigger_count = tablet->GetL0DelayTriggerCount();
+  if (!l0_delay_trigger_count.ok()) {
+    return true;
+  }
+  const auto num_l0_files = static_cast<int64_t>(*l0_delay_trigger_count);
+  if (num_l0_files < soft_limit) {
+    return true;
+  }
+  const int hard_limit = std::max(FLAGS_write_throttle_l0_files_hard_limit, soft_limit);
+  // The probability to reject grows from 0 at the soft limit to 1 at the hard limit.
+  if (num_l0_files < hard_limit && RandomUniformInt(soft_limit, hard_limit - 1) >= num_l0_files) {
+    return true;
+  }
+
+  tablet->metrics()->compaction_debt_rejections->Increment();
+  auto msg = Format(
+      "Compactions fell behind: $0 level 0 files, writes are throttled from $1 files",
+      num_l0_files, soft_limit);
+  YB_LOG_EVERY_N_SECS(INFO, 1) << "T " << tablet->tablet_id() << ": Rejecting Write request: "
+                               << msg << THROTTLE_MSG;
+  SetupErrorAndRespond(resp->mutable_error(), STATUS(ServiceUnavailable, msg),
+                       TabletServerErrorPB::WRITE_THROTTLED,
+                       context);
+  return false;
+}
+
 typedef ListTabletsResponsePB::StatusAndSchemaPB StatusAndSchemaPB;
 
 class WriteOperationCompletionCallback : public OperationCompletionCallback {
@@ -301,7 +570,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
 // Checksums the scan result.
 class ScanResultChecksummer {
  public:
-  ScanResultChecksummer() {}
+  explicit ScanResultChecksummer(bool order_independent) : order_independent_(order_independent) {}
 
   void HandleRow(const Schema& schema, const QLTableRow& row) {
     QLValue value;
@@ -322,15 +591,24 @@ class ScanResultChecksummer {
         value.value().AppendToString(&buffer_);
       }
     }
-    crc_->Compute(buffer_.c_str(), buffer_.size(), &agg_checksum_, nullptr);
+    if (order_independent_) {
+      // Addition is commutative, so the result does not depend on the order rows are visited in.
+      agg_checksum_ += HashUtil::MurmurHash2_64(buffer_.c_str(), buffer_.size(), 0 /* seed */);
+    } else {
+      crc_->Compute(buffer_.c_str(), buffer_.size(), &agg_checksum_, nullptr);
+    }
+    ++num_rows_;
   }
 
   // Accessors for initializing / setting the checksum.
   uint64_t agg_checksum() const { return agg_checksum_; }
+  uint64_t num_rows() const { return num_rows_; }
 
  private:
+  const bool order_independent_;
   crc::Crc* const crc_ = crc::GetCrc32cInstance();
   uint64_t agg_checksum_ = 0;
+  uint64_t num_rows_ = 0;
   std::string buffer_;
 };
 
@@ -339,6 +617,12 @@ TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
       server_(server) {
 }
 
+// Write requests could carry huge batches, so they should not delay reads queued after them.
+rpc::CallPriority TabletServiceImpl::GetCallPriority(const rpc::InboundCall& call) {
+  return call.method_name() == "Write" ? rpc::CallPriority::kBulk
+                                       : rpc::CallPriority::kLatencySensitive;
+}
+
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
     : TabletServerAdminServiceIf(server->MetricEnt()),
       server_(server) {
@@ -442,6 +726,61 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
     return;
   }
 
+  if (!req->additional_states().empty() && req->state().status() == TransactionStatus::PENDING) {
+    // Heartbeats of several transactions with this status tablet, batched by the client.
+    auto shared = std::make_shared<MultiOperationCompletionCallback::Shared>(
+        MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()),
+        req->additional_states().size() + 1);
+    auto* results = resp->mutable_heartbeat_statuses();
+    results->Reserve(req->additional_states().size() + 1);
+    std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> heartbeats;
+    heartbeats.reserve(req->additional_states().size() + 1);
+    auto add = [&tablet, &shared, &heartbeats, results](const TransactionStatePB& state_pb) {
+      auto state = std::make_unique<tablet::UpdateTxnOperationState>(
+          tablet.peer->tablet(), &state_pb);
+      state->set_completion_callback(
+          std::make_unique<HeartbeatCompletionCallback>(shared, results->Add()));
+      if (state_pb.status() != TransactionStatus::PENDING) {
+        state->CompleteWithStatus(STATUS_FORMAT(
+            InvalidArgument, "Only pending states could be sent together with heartbeat: $0",
+            state_pb));
+        return;
+      }
+      heartbeats.push_back(std::move(state));
+    };
+    add(req->state());
+    for (const auto& state_pb : req->additional_states()) {
+      add(state_pb);
+    }
+    tablet.peer->tablet()->transaction_coordinator()->Handle(
+        std::move(heartbeats), tablet.leader_term);
+    return;
+  }
+
+  if (!req->additional_states().empty()) {
+    // Several applying transactions sent together by the coordinator.
+    auto shared = std::make_shared<MultiOperationCompletionCallback::Shared>(
+        MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()),
+        req->additional_states().size() + 1);
+    auto* participant = tablet.peer->tablet()->transaction_participant();
+    auto handle = [&tablet, &shared, participant](const TransactionStatePB& state_pb) {
+      auto state = std::make_unique<tablet::UpdateTxnOperationState>(
+          tablet.peer->tablet(), &state_pb);
+      state->set_completion_callback(std::make_unique<MultiOperationCompletionCallback>(shared));
+      if (state_pb.status() != TransactionStatus::APPLYING || !participant) {
+        state->CompleteWithStatus(STATUS_FORMAT(
+            InvalidArgument, "Only applying states could be sent together: $0", state_pb));
+        return;
+      }
+      participant->Handle(std::move(state), tablet.leader_term);
+    };
+    handle(req->state());
+    for (const auto& state_pb : req->additional_states()) {
+      handle(state_pb);
+    }
+    return;
+  }
+
   auto state = std::make_unique<tablet::UpdateTxnOperationState>(tablet.peer->tablet(),
                                                                  &req->state());
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
@@ -540,57 +879,118 @@ void TabletServiceImpl::Truncate(const TruncateRequestPB* req,
       std::make_unique<tablet::TruncateOperation>(std::move(tx_state)), tablet.leader_term);
 }
 
-void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
-                                          CreateTabletResponsePB* resp,
-                                          rpc::RpcContext context) {
-  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablet", req, resp, &context)) {
-    return;
-  }
+namespace {
+
+// Creates the tablet described by 'req', setting 'code' to the error code to report if the
+// creation fails.
+Status CreateTabletFromRequest(TSTabletManager* tablet_manager,
+                               const CreateTabletRequestPB& req,
+                               TabletServerErrorPB::Code* code) {
   TRACE_EVENT1("tserver", "CreateTablet",
-               "tablet_id", req->tablet_id());
+               "tablet_id", req.tablet_id());
 
   Schema schema;
-  Status s = SchemaFromPB(req->schema(), &schema);
+  Status s = SchemaFromPB(req.schema(), &schema);
   DCHECK(schema.has_column_ids());
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid Schema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid Schema.");
   }
 
   PartitionSchema partition_schema;
-  s = PartitionSchema::FromPB(req->partition_schema(), schema, &partition_schema);
+  s = PartitionSchema::FromPB(req.partition_schema(), schema, &partition_schema);
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid PartitionSchema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid PartitionSchema.");
   }
 
   Partition partition;
-  Partition::FromPB(req->partition(), &partition);
+  Partition::FromPB(req.partition(), &partition);
 
-  LOG(INFO) << "Processing CreateTablet for tablet " << req->tablet_id()
-            << " (table=" << req->table_name()
-            << " [id=" << req->table_id() << "]), partition="
+  LOG(INFO) << "Processing CreateTablet for tablet " << req.tablet_id()
+            << " (table=" << req.table_name()
+            << " [id=" << req.table_id() << "]), partition="
             << partition_schema.PartitionDebugString(partition, schema);
-  VLOG(1) << "Full request: " << req->DebugString();
+  VLOG(1) << "Full request: " << req.DebugString();
 
-  s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema,
-      req->has_index_info() ? boost::optional<IndexInfo>(req->index_info()) : boost::none,
-      req->config(), /* tablet_peer */ nullptr);
+  s = tablet_manager->CreateNewTablet(req.table_id(), req.tablet_id(), partition,
+      req.table_name(), req.table_type(), schema, partition_schema,
+      req.has_index_info() ? boost::optional<IndexInfo>(req.index_info()) : boost::none,
+      req.config(), /* tablet_peer */ nullptr);
   if (PREDICT_FALSE(!s.ok())) {
-    TabletServerErrorPB::Code code;
     if (s.IsAlreadyPresent()) {
-      code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
+      *code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
     } else {
-      code = TabletServerErrorPB::UNKNOWN_ERROR;
+      *code = TabletServerErrorPB::UNKNOWN_ERROR;
     }
-    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+  }
+  return s;
+}
+
+// Runs handler, which responds to the call, on the async I/O threads, because it writes tablet
+// metadata and a slow disk should not hold service threads. Runs it inline when the I/O threads
+// are overloaded.
+void RespondOnIoThread(TSTabletManager* tablet_manager,
+                       rpc::RpcContext* context,
+                       std::function<void(rpc::RpcContext*)> handler) {
+  auto context_ptr = std::make_shared<rpc::RpcContext>(std::move(*context));
+  auto status = tablet_manager->async_io_executor()->Submit([handler, context_ptr] {
+    handler(context_ptr.get());
+    return Status::OK();
+  });
+  if (!status.ok()) {
+    handler(context_ptr.get());
+  }
+}
+
+} // namespace
+
+void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
+                                          CreateTabletResponsePB* resp,
+                                          rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablet", req, resp, &context)) {
     return;
   }
+
+  auto* tablet_manager = server_->tablet_manager();
+  RespondOnIoThread(tablet_manager, &context, [tablet_manager, req, resp](
+      rpc::RpcContext* context) {
+    TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+    Status s = CreateTabletFromRequest(tablet_manager, *req, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      SetupErrorAndRespond(resp->mutable_error(), s, code, context);
+      return;
+    }
+    context->RespondSuccess();
+  });
+}
+
+void TabletServiceAdminImpl::CreateTablets(const CreateTabletsRequestPB* req,
+                                           CreateTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablets", req, resp, &context)) {
+    return;
+  }
+  TRACE_EVENT1("tserver", "CreateTablets",
+               "num_tablets", req->tablets_size());
+
+  LOG(INFO) << "Processing CreateTablets for " << req->tablets_size() << " tablets from "
+            << context.requestor_string();
+
+  std::vector<std::function<void()>> create_funcs;
+  create_funcs.reserve(req->tablets_size());
+  for (const CreateTabletRequestPB& tablet_req : req->tablets()) {
+    CreateTabletResponsePB* tablet_resp = resp->add_tablets();
+    create_funcs.push_back([this, &tablet_req, tablet_resp] {
+      TabletServerErrorPB::Code code = TabletServerErrorPB::UNKNOWN_ERROR;
+      Status s = CreateTabletFromRequest(server_->tablet_manager(), tablet_req, &code);
+      if (!s.ok()) {
+        SetupError(tablet_resp->mutable_error(), s, code);
+      }
+    });
+  }
+  server_->tablet_manager()->RunTabletCreations(create_funcs);
+
   context.RespondSuccess();
 }
 
@@ -618,16 +1018,21 @@ void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
   if (req->has_cas_config_opid_index_less_or_equal()) {
     cas_config_opid_index_less_or_equal = req->cas_config_opid_index_less_or_equal();
   }
-  boost::optional<TabletServerErrorPB::Code> error_code;
-  Status s = server_->tablet_manager()->DeleteTablet(req->tablet_id(),
-                                                     delete_type,
-                                                     cas_config_opid_index_less_or_equal,
-                                                     &error_code);
-  if (PREDICT_FALSE(!s.ok())) {
-    HandleErrorResponse(resp, &context, s, error_code);
-    return;
-  }
-  context.RespondSuccess();
+  auto* tablet_manager = server_->tablet_manager();
+  RespondOnIoThread(tablet_manager, &context, [tablet_manager, req, resp, delete_type,
+                                               cas_config_opid_index_less_or_equal](
+      rpc::RpcContext* context) {
+    boost::optional<TabletServerErrorPB::Code> error_code;
+    Status s = tablet_manager->DeleteTablet(req->tablet_id(),
+                                            delete_type,
+                                            cas_config_opid_index_less_or_equal,
+                                            &error_code);
+    if (PREDICT_FALSE(!s.ok())) {
+      HandleErrorResponse(resp, context, s, error_code);
+      return;
+    }
+    context->RespondSuccess();
+  });
 }
 
 // TODO(sagnik): Modify this to actually create a copartitioned table
@@ -684,6 +1089,35 @@ void TabletServiceAdminImpl::FlushTablets(const FlushTabletsRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceAdminImpl::BackfillIndex(const BackfillIndexRequestPB* req,
+                                           BackfillIndexResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "BackfillIndex", req, resp, &context)) {
+    return;
+  }
+  DVLOG(3) << "Received Backfill Index RPC: " << req->DebugString();
+
+  server::UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  auto next_row_key = tablet.peer->tablet()->BackfillIndex(
+      req->index_table_id(), HybridTime(req->read_hybrid_time()), req->start_row_key(),
+      context.GetClientDeadline());
+  if (!next_row_key.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), next_row_key.status(),
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  resp->set_next_row_key(std::move(*next_row_key));
+  resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::Write(const WriteRequestPB* req,
                               WriteResponsePB* resp,
                               rpc::RpcContext context) {
@@ -702,7 +1136,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
 
   auto tablet = LookupLeaderTabletOrRespond(
       server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
-  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context)) {
+  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context) ||
+      !CheckCompactionDebt(tablet.peer->tablet(), resp, &context)) {
     return;
   }
 
@@ -768,6 +1203,15 @@ Status TabletServiceImpl::CheckPeerIsLeader(const TabletPeer& tablet_peer) {
   return Status::OK();
 }
 
+bool TabletServiceImpl::IsTabletLeader(const string& tablet_id) {
+  TabletPeerPtr tablet_peer;
+  if (!server_->tablet_peer_lookup()->GetTabletPeer(tablet_id, &tablet_peer).ok()) {
+    // The tablet is served by other means, i.e. the sys catalog tablet of master.
+    return true;
+  }
+  return CheckPeerIsLeader(*tablet_peer).ok();
+}
+
 Status TabletServiceImpl::CheckPeerIsLeaderAndReady(const TabletPeer& tablet_peer) {
   RETURN_NOT_OK(CheckPeerIsReady(tablet_peer));
 
@@ -800,7 +1244,8 @@ bool TabletServiceImpl::DoGetTabletOrRespond(const Req* req, Resp* resp, rpc::Rp
   }
 
   // Check for leader only in strong consistency level.
-  if (req->consistency_level() == YBConsistencyLevel::STRONG) {
+  if (req->consistency_level() == YBConsistencyLevel::STRONG &&
+      !CanServeStrongReadFromFollower(*req)) {
     if (PREDICT_FALSE(FLAGS_assert_reads_served_by_follower) &&
         std::is_same<Req, ReadRequestPB>::value) {
       LOG(FATAL) << "--assert_reads_served_by_follower is true but consistency level is invalid: "
@@ -900,6 +1345,21 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
 
+  auto* read_tablet = down_cast<Tablet*>(tablet.get());
+  if (!read_tablet->StartRead(FLAGS_max_concurrent_reads_per_tablet)) {
+    read_tablet->metrics()->read_concurrency_rejections->Increment();
+    YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Read request to tablet " << req->tablet_id()
+                                 << ": too many concurrent reads" << THROTTLE_MSG;
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS_FORMAT(ServiceUnavailable,
+                                       "Tablet $0 is serving too many concurrent reads",
+                                       req->tablet_id()),
+                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+  BOOST_SCOPE_EXIT(read_tablet) {
+    read_tablet->FinishRead();
+  } BOOST_SCOPE_EXIT_END;
 
   if (server_ && server_->Clock()) {
     server::UpdateClock(*req, server_->Clock());
@@ -908,12 +1368,30 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   // safe_ht_to_read is used only for read restart, so if read_time is valid, then we would respond
   // with "restart required".
   HybridTime safe_ht_to_read;
+  HybridTime used_local_limit;
   auto read_time = ReadHybridTime::FromReadTimePB(*req);
   bool allow_retry = !read_time;
   tablet::RequireLease require_lease(req->consistency_level() == YBConsistencyLevel::STRONG);
   // TODO: should check all the tables referenced by the requests to decide if it is transactional.
   bool transactional = tablet->SchemaRef().table_properties().is_transactional();
-  if (!read_time) {
+  if (require_lease && CanServeStrongReadFromFollower(*req) && !IsTabletLeader(req->tablet_id())) {
+    // Any write acknowledged before this read started has a lower hybrid time than MaxGlobalNow,
+    // and the leader propagates safe time only within its hybrid time lease. So when the safe time
+    // passes MaxGlobalNow, this follower has applied every write the read should observe.
+    require_lease = tablet::RequireLease::kFalse;
+    read_time.read = server_->Clock()->MaxGlobalNow();
+    read_time.local_limit = read_time.read;
+    read_time.global_limit = read_time.read;
+    safe_ht_to_read = tablet->SafeTime(require_lease, read_time.read, context.GetClientDeadline());
+    if (!safe_ht_to_read.is_valid()) { // Timed out
+      TRACE("Timed out waiting for safe time on follower");
+      SetupErrorAndRespond(resp->mutable_error(), STATUS(TimedOut, "Timed out waiting for safe "
+                                                         "time on follower"),
+                           TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      return;
+    }
+    VLOG(1) << "Strong read on follower, read time: " << read_time.ToString();
+  } else if (!read_time) {
     safe_ht_to_read = tablet->SafeTime(require_lease);
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
@@ -935,6 +1413,15 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
                            TabletServerErrorPB::UNKNOWN_ERROR, &context);
       return;
     }
+    if (transactional && require_lease && read_time.local_limit > read_time.read) {
+      // The leader assigns hybrid times from its own clock, so anything written after its current
+      // time was written after the transaction started reading. Such a local limit is tighter
+      // than the one the client sent, and is returned to the client so that later reads from this
+      // tablet in the same transaction use it and avoid unnecessary read restarts.
+      read_time.local_limit = std::min(
+          read_time.local_limit, std::max(server_->Clock()->Now(), read_time.read));
+      used_local_limit = read_time.local_limit;
+    }
   }
 
   RequestScope request_scope;
@@ -950,6 +1437,27 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   host_port_pb.set_host(remote_address.address().to_string());
   host_port_pb.set_port(remote_address.port());
 
+  // When the client asked for the trace or the read is sampled, RocksDB counters of this read, such
+  // as block cache hits and seeks, are added to the trace.
+  const bool collect_perf_context =
+      Trace::CurrentTrace() != nullptr &&
+      (req->include_trace() || Trace::CurrentTrace()->sampled());
+  const auto perf_level = rocksdb::GetPerfLevel();
+  if (collect_perf_context) {
+    rocksdb::SetPerfLevel(std::max(perf_level, rocksdb::PerfLevel::kEnableCount));
+    rocksdb::perf_context.Reset();
+  }
+  BOOST_SCOPE_EXIT(collect_perf_context, perf_level) {
+    if (collect_perf_context) {
+      rocksdb::SetPerfLevel(perf_level);
+    }
+  } BOOST_SCOPE_EXIT_END;
+
+  boost::optional<ReadCostTracker> cost_tracker;
+  if (FLAGS_collect_read_cost) {
+    cost_tracker.emplace();
+  }
+
   for (;;) {
     resp->Clear();
     context.ResetRpcSidecars();
@@ -964,6 +1472,9 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     read_time = *result;
     // If read was successful, then restart time is invalid. Finishing.
     if (!read_time) {
+      if (used_local_limit.is_valid()) {
+        resp->set_local_limit_ht(used_local_limit.ToUint64());
+      }
       break;
     }
     if (!allow_retry) {
@@ -984,9 +1495,16 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       return;
     }
   }
+  if (collect_perf_context) {
+    TRACE("RocksDB perf context: $0", rocksdb::perf_context.ToString(true /* exclude_zero */));
+  }
   if (req->include_trace() && Trace::CurrentTrace() != nullptr) {
     resp->set_trace_buffer(Trace::CurrentTrace()->DumpToString(true));
   }
+  if (cost_tracker) {
+    cost_tracker->Finish(*down_cast<Tablet*>(tablet.get())->metrics(), context, *resp,
+                         req->include_cost() ? resp->mutable_cost() : nullptr);
+  }
   RpcOperationCompletionCallback<ReadResponsePB> callback(
       std::move(context), resp, server_->Clock());
   callback.OperationCompleted();
@@ -1068,12 +1586,13 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(tablet::AbstractTablet* tablet,
     DCHECK_EQ(tablet->table_type(), TableType::YQL_TABLE_TYPE);
     ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(req);
     for (QLReadRequestPB& ql_read_req : *mutable_req->mutable_ql_batch()) {
-      // Update the remote endpoint.
-      ql_read_req.set_allocated_remote_endpoint(host_port_pb);
-      ql_read_req.set_allocated_proxy_uuid(mutable_req->mutable_proxy_uuid());
+      // Update the remote endpoint. The request could be allocated in an arena, that would take
+      // ownership of borrowed fields, so they are copied, which is cheap in the arena.
+      *ql_read_req.mutable_remote_endpoint() = *host_port_pb;
+      ql_read_req.set_proxy_uuid(req->proxy_uuid());
       BOOST_SCOPE_EXIT(&ql_read_req) {
-        ql_read_req.release_remote_endpoint();
-        ql_read_req.release_proxy_uuid();
+        ql_read_req.clear_remote_endpoint();
+        ql_read_req.clear_proxy_uuid();
       } BOOST_SCOPE_EXIT_END;
 
       tablet::QLReadRequestResult result;
@@ -1171,6 +1690,19 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  // The requests are handled one by one, since they are heartbeats without ops, which do not block.
+  auto* mutable_req = const_cast<consensus::MultiRaftConsensusRequestPB*>(req);
+  for (auto& consensus_req : *mutable_req->mutable_consensus_request()) {
+    UpdateConsensusInBatch(tablet_manager_, &consensus_req, resp->add_consensus_response());
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1415,6 +1947,10 @@ void TabletServiceImpl::Publish(
     const PublishRequestPB* req, PublishResponsePB* resp, rpc::RpcContext context) {
   rpc::Publisher* publisher = server_->GetPublisher();
   resp->set_num_clients_forwarded_to(publisher ? (*publisher)(req->channel(), req->message()) : 0);
+  for (const auto& message : req->additional_messages()) {
+    resp->add_additional_num_clients_forwarded_to(
+        publisher ? (*publisher)(message.channel(), message.message()) : 0);
+  }
   context.RespondSuccess();
 }
 
@@ -1434,6 +1970,44 @@ void TabletServiceImpl::ListTablets(const ListTabletsRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::GetChanges(const GetChangesRequestPB* req,
+                                   GetChangesResponsePB* resp,
+                                   rpc::RpcContext context) {
+  TRACE("GetChanges");
+
+  if (req->unregister_consumer()) {
+    RETURN_UNKNOWN_ERROR_IF_NOT_OK(
+        cdc_consumers_.Unregister(req->tablet_id(), req->consumer_id()), resp, &context);
+    context.RespondSuccess();
+    return;
+  }
+
+  auto peer = LookupTabletPeerOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!peer.ok()) {
+    return;
+  }
+
+  CDCCheckpointPB from_checkpoint;
+  if (req->has_from_checkpoint()) {
+    from_checkpoint = req->from_checkpoint();
+  } else if (req->has_consumer_id()) {
+    auto checkpoint = cdc_consumers_.GetCheckpoint(req->tablet_id(), req->consumer_id());
+    if (checkpoint) {
+      from_checkpoint = *checkpoint;
+    }
+  }
+
+  RETURN_UNKNOWN_ERROR_IF_NOT_OK(
+      GetChangesFromLog(**peer, from_checkpoint, req->max_records(), resp), resp, &context);
+  if (req->has_consumer_id()) {
+    RETURN_UNKNOWN_ERROR_IF_NOT_OK(
+        cdc_consumers_.UpdateCheckpoint(**peer, req->consumer_id(), resp->checkpoint()),
+        resp, &context);
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::GetMasterAddresses(const GetMasterAddressesRequestPB* req,
                                            GetMasterAddressesResponsePB* resp,
                                            rpc::RpcContext context) {
@@ -1474,21 +2048,32 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+Status CalcChecksum(tablet::Tablet* tablet, const ChecksumRequestPB& req, MonoTime deadline,
+                    ChecksumResponsePB* resp) {
+  ReadHybridTime read_time;
+  if (req.has_read_hybrid_time()) {
+    read_time = ReadHybridTime::FromUint64(req.read_hybrid_time());
+    auto safe_time = tablet->SafeTime(tablet::RequireLease::kFalse, read_time.read, deadline);
+    if (!safe_time.is_valid()) {
+      return STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_time.read);
+    }
+  }
+
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
-  RETURN_NOT_OK(iter);
+  auto iter = VERIFY_RESULT(tablet->NewRowIterator(client_schema, boost::none, read_time));
 
   QLTableRow value_map;
-  ScanResultChecksummer collector;
+  ScanResultChecksummer collector(req.order_independent());
 
-  while ((**iter).HasNext()) {
-    RETURN_NOT_OK((**iter).NextRow(&value_map));
+  while (iter->HasNext()) {
+    RETURN_NOT_OK(iter->NextRow(&value_map));
     collector.HandleRow(schema, value_map);
   }
 
-  return collector.agg_checksum();
+  resp->set_checksum(collector.agg_checksum());
+  resp->set_num_rows(collector.num_rows());
+  return Status::OK();
 }
 
 } // namespace
@@ -1502,15 +2087,14 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
-  if (!checksum.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
-                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
+  auto status = CalcChecksum(
+      down_cast<tablet::Tablet*>(abstract_tablet.get()), *req, context.GetClientDeadline(), resp);
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
     return;
   }
 
-  resp->set_checksum(*checksum);
-
   context.RespondSuccess();
 }
 
@@ -1531,6 +2115,65 @@ void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
   context.RespondSuccess();
 }
 
+namespace {
+
+bool IsPlainFileName(const std::string& name) {
+  return !name.empty() && name != "." && name != ".." && name.find('/') == std::string::npos;
+}
+
+// Appends a chunk of an IngestData request to the staged file, or imports the staged files.
+Status IngestDataChunk(const IngestDataRequestPB& req, tablet::Tablet* tablet) {
+  if (!IsPlainFileName(req.import_id())) {
+    return STATUS_FORMAT(InvalidArgument, "Bad import id: $0", req.import_id());
+  }
+  // Staged next to the rocksdb directory, so imported files could be linked instead of copied.
+  const auto staging_dir = tablet->metadata()->rocksdb_dir() + ".ingest." + req.import_id();
+  auto* env = Env::Default();
+  if (req.finish()) {
+    auto status = tablet->ImportData(staging_dir);
+    WARN_NOT_OK(env->DeleteRecursively(staging_dir), "Failed to remove staged files");
+    return status;
+  }
+
+  if (!IsPlainFileName(req.file_name())) {
+    return STATUS_FORMAT(InvalidArgument, "Bad file name: $0", req.file_name());
+  }
+  RETURN_NOT_OK(env_util::CreateDirIfMissing(env, staging_dir));
+  const auto path = JoinPathSegments(staging_dir, req.file_name());
+  WritableFileOptions options;
+  if (req.offset() != 0) {
+    const auto size = VERIFY_RESULT(env->GetFileSize(path));
+    if (size != req.offset()) {
+      return STATUS_FORMAT(InvalidArgument, "Chunk of $0 at $1, while $2 bytes were received",
+                           req.file_name(), req.offset(), size);
+    }
+    options.mode = Env::OPEN_EXISTING;
+  }
+  gscoped_ptr<WritableFile> file;
+  RETURN_NOT_OK(env->NewWritableFile(options, path, &file));
+  RETURN_NOT_OK(file->Append(req.data()));
+  return file->Close();
+}
+
+} // namespace
+
+void TabletServiceImpl::IngestData(const IngestDataRequestPB* req,
+                                   IngestDataResponsePB* resp,
+                                   rpc::RpcContext context) {
+  auto peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
+
+  auto status = IngestDataChunk(*req, peer->tablet());
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         status,
+                         TabletServerErrorPB::UNKNOWN_ERROR,
+                         &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::GetTabletStatus(const GetTabletStatusRequestPB* req,
                                         GetTabletStatusResponsePB* resp,
                                         rpc::RpcContext context) {
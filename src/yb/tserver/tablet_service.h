@@ -43,6 +43,7 @@
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/cdc_producer.h"
 #include "yb/tserver/tablet_server_interface.h"
 #include "yb/tserver/tserver_admin.service.h"
 #include "yb/tserver/tserver_service.service.h"
@@ -97,6 +98,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                   ImportDataResponsePB* resp,
                   rpc::RpcContext context) override;
 
+  void IngestData(const IngestDataRequestPB* req,
+                  IngestDataResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void UpdateTransaction(const UpdateTransactionRequestPB* req,
                          UpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
@@ -117,14 +122,23 @@ class TabletServiceImpl : public TabletServerServiceIf {
                        GetTabletStatusResponsePB* resp,
                        rpc::RpcContext context) override;
 
+  void GetChanges(const GetChangesRequestPB* req,
+                  GetChangesResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void Shutdown() override;
 
+  rpc::CallPriority GetCallPriority(const rpc::InboundCall& call) override;
+
  private:
   // Check if the tablet peer is the leader and is in ready state for servicing IOs.
   CHECKED_STATUS CheckPeerIsLeaderAndReady(const tablet::TabletPeer& tablet_peer);
 
   CHECKED_STATUS CheckPeerIsLeader(const tablet::TabletPeer& tablet_peer);
 
+  // Returns false if this server hosts a follower replica of the tablet.
+  bool IsTabletLeader(const std::string& tablet_id);
+
   CHECKED_STATUS CheckPeerIsReady(const tablet::TabletPeer& tablet_peer);
 
   template <class Req, class Resp>
@@ -141,6 +155,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
   bool CheckMemoryPressure(
       tablet::Tablet* tablet, Resp* resp, rpc::RpcContext* context);
 
+  // Rejects the write with a retryable error when compactions of the tablet fell behind.
+  bool CheckCompactionDebt(
+      tablet::Tablet* tablet, WriteResponsePB* resp, rpc::RpcContext* context);
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead(tablet::AbstractTablet* tablet,
@@ -153,6 +171,9 @@ class TabletServiceImpl : public TabletServerServiceIf {
                                 rpc::RpcContext* context);
 
   TabletServerIf *const server_;
+
+  // Checkpoints of change data consumers that asked this server for changes.
+  CDCConsumerRegistry cdc_consumers_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -164,6 +185,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                             CreateTabletResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  virtual void CreateTablets(const CreateTabletsRequestPB* req,
+                             CreateTabletsResponsePB* resp,
+                             rpc::RpcContext context) override;
+
   virtual void DeleteTablet(const DeleteTabletRequestPB* req,
                             DeleteTabletResponsePB* resp,
                             rpc::RpcContext context) override;
@@ -180,6 +205,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                             FlushTabletsResponsePB* resp,
                             rpc::RpcContext context) override;
 
+  void BackfillIndex(const BackfillIndexRequestPB* req,
+                     BackfillIndexResponsePB* resp,
+                     rpc::RpcContext context) override;
+
  private:
   TabletServer* server_;
 };
@@ -191,10 +220,18 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
 
   virtual ~ConsensusServiceImpl();
 
+  rpc::CallPriority GetCallPriority(const rpc::InboundCall& call) override {
+    return rpc::CallPriority::kConsensus;
+  }
+
   virtual void UpdateConsensus(const consensus::ConsensusRequestPB *req,
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB* req,
+                                        consensus::MultiRaftConsensusResponsePB* resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -58,6 +58,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(tablet_report_limit);
 
 namespace yb {
 namespace tserver {
@@ -319,5 +320,37 @@ TEST_F(TsTabletManagerTest, TestTabletReports) {
   ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
 }
 
+TEST_F(TsTabletManagerTest, TestTabletReportLimit) {
+  ASSERT_OK(CreateNewTablet("tablet-1", schema_, nullptr));
+  ASSERT_OK(CreateNewTablet("tablet-2", schema_, nullptr));
+  FLAGS_tablet_report_limit = 1;
+
+  // The full report should only carry one of the tablets.
+  TabletReportPB report;
+  tablet_manager_->GenerateFullTabletReport(&report);
+  ASSERT_FALSE(report.is_incremental());
+  ASSERT_EQ(1, report.updated_tablets().size());
+  const string missing_tablet =
+      report.updated_tablets(0).tablet_id() == "tablet-1" ? "tablet-2" : "tablet-1";
+  tablet_manager_->MarkTabletReportAcknowledged(report);
+
+  // The other tablet should follow in the incremental reports, one tablet at a time.
+  MonoDelta timeout(MonoDelta::FromSeconds(10));
+  MonoTime start(MonoTime::Now());
+  while (true) {
+    tablet_manager_->GenerateIncrementalTabletReport(&report);
+    ASSERT_TRUE(report.is_incremental());
+    ASSERT_LE(report.updated_tablets().size(), 1);
+    tablet_manager_->MarkTabletReportAcknowledged(report);
+    if (report.updated_tablets().size() == 1 &&
+        report.updated_tablets(0).tablet_id() == missing_tablet) {
+      break;
+    }
+    ASSERT_TRUE(MonoTime::Now().GetDeltaSince(start).LessThan(timeout))
+        << "Tablet " << missing_tablet << " was never reported";
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+}
+
 } // namespace tserver
 } // namespace yb
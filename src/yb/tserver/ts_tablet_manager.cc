@@ -33,6 +33,8 @@
 #include "yb/tserver/ts_tablet_manager.h"
 
 #include <algorithm>
+#include <limits>
+#include <tuple>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -49,6 +51,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
@@ -56,6 +59,7 @@
 
 #include "yb/fs/fs_manager.h"
 
+#include "yb/gutil/casts.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
@@ -63,6 +67,8 @@
 #include "yb/master/sys_catalog.h"
 
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/table/persistent_block_cache.h"
 
 #include "yb/rpc/messenger.h"
 
@@ -74,19 +80,23 @@
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/tablet_options.h"
 
+#include "yb/tserver/compaction_rate_tuner.h"
 #include "yb/tserver/heartbeater.h"
 #include "yb/tserver/remote_bootstrap_client.h"
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/background_task.h"
+#include "yb/util/countdown_latch.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env.h"
 #include "yb/util/env_util.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
@@ -111,6 +121,45 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_string(db_block_cache_type, "lru",
+              "Eviction policy of the block cache: lru - LRU with single-touch and multi-touch "
+              "pools, clock - CLOCK, whose hits do not serialize on the shard mutex.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+DEFINE_string(db_persistent_block_cache_path, "",
+              "Directory on a fast local device for the cache of compressed SST blocks, that is "
+              "used under the in-memory block cache. Useful when data directories reside on "
+              "network attached storage. Empty to disable.");
+TAG_FLAG(db_persistent_block_cache_path, advanced);
+
+DEFINE_int64(db_persistent_block_cache_size_bytes, 50LL * 1024 * 1024 * 1024,
+             "Max size of the files of the persistent block cache.");
+TAG_FLAG(db_persistent_block_cache_size_bytes, advanced);
+
+DEFINE_int32(db_persistent_block_cache_admission_threshold, 2,
+             "Block is written to the persistent block cache only after it was read from the SST "
+             "file this number of times within the recent history.");
+TAG_FLAG(db_persistent_block_cache_admission_threshold, advanced);
+
+DEFINE_bool(rocksdb_compact_flush_rate_limit_per_tserver, false,
+            "Whether rocksdb_compact_flush_rate_limit_bytes_per_sec limits flushes and "
+            "compactions of all tablets of the tablet server together, instead of each tablet "
+            "separately.");
+TAG_FLAG(rocksdb_compact_flush_rate_limit_per_tserver, advanced);
+
+DEFINE_int32(compaction_rate_tune_interval_ms, 0,
+             "Interval of tuning the write rate limit of flushes and compactions of the tablet "
+             "server, using observed foreground read and WAL sync latencies. The limit is shared "
+             "by all tablets, and rocksdb_compact_flush_rate_limit_bytes_per_sec is its max value. "
+             "0 to disable tuning.");
+TAG_FLAG(compaction_rate_tune_interval_ms, advanced);
+
+DEFINE_int32(close_idle_table_readers_interval_sec, 600,
+             "Interval of closing the SST table readers of tablets that had no reads since the "
+             "previous interval. This releases the index and filter blocks held by idle tablets, "
+             "and the readers are opened again on the next read. 0 to keep them open.");
+TAG_FLAG(close_idle_table_readers_interval_sec, advanced);
+
 DEFINE_test_flag(double, fault_crash_after_blocks_deleted, 0.0,
                  "Fraction of the time when the tablet will crash immediately "
                  "after deleting the data blocks during tablet deletion.");
@@ -152,6 +201,21 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_int32(max_concurrent_memstore_flushes, 2,
+             "Maximum number of tablets that are flushed at the same time because the global "
+             "memstore limit is exceeded. A flush frees memory only once it is done, so more "
+             "tablets are picked only after a running flush finishes. 0 means no limit.");
+TAG_FLAG(max_concurrent_memstore_flushes, advanced);
+TAG_FLAG(max_concurrent_memstore_flushes, runtime);
+
+DEFINE_int32(memstore_flush_age_weight_sec, 60,
+             "When the global memstore limit is exceeded, tablets are picked for flush by their "
+             "memtable size multiplied by 1 + (age of the oldest unflushed write) / this value, "
+             "in seconds. So large memtables are preferred, and old writes that keep WAL segments "
+             "from being garbage collected are eventually flushed too.");
+TAG_FLAG(memstore_flush_age_weight_sec, advanced);
+TAG_FLAG(memstore_flush_age_weight_sec, runtime);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
@@ -171,6 +235,32 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_int32(async_io_max_threads, 16,
+             "The maximum number of threads doing blocking file system work handed over by RPC "
+             "service threads, such as remote bootstrap reads, WAL read ahead for lagging peers "
+             "and tablet metadata writes.");
+DEFINE_int32(async_io_max_queue_size, 1000,
+             "The maximum number of file system operations waiting for an async I/O thread. "
+             "Operations over the limit are done by the calling thread.");
+TAG_FLAG(async_io_max_threads, advanced);
+TAG_FLAG(async_io_max_queue_size, advanced);
+
+DEFINE_uint64(fs_dir_min_free_space_bytes, 10_GB,
+              "New tablets are not placed in data or WAL directories with less free space than "
+              "this, unless all directories are that full.");
+TAG_FLAG(fs_dir_min_free_space_bytes, advanced);
+
+DEFINE_bool(share_consensus_thread_pool, true,
+            "Run Raft, prepare, append and WAL read ahead tasks of all replicas on a single thread "
+            "pool instead of one pool per task class, so idle threads are reused across classes.");
+TAG_FLAG(share_consensus_thread_pool, advanced);
+
+DEFINE_bool(flush_tablets_on_shutdown, false,
+            "Flush all tablets when the tablet server is shut down, so their logs do not have to "
+            "be replayed when the server is restarted.");
+TAG_FLAG(flush_tablets_on_shutdown, advanced);
+TAG_FLAG(flush_tablets_on_shutdown, runtime);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -180,6 +270,27 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
              "Default timeout for the YBClient embedded into the tablet server that is used "
              "for distributed transactions.");
 
+DEFINE_int32(tablet_report_limit, 1000,
+             "Maximum number of tablets to include in a single tablet report. Tablets that do not "
+             "fit are sent in the following heartbeats, so that a master that just became leader "
+             "is not flooded by full reports from every tablet server at once. "
+             "0 means no limit.");
+TAG_FLAG(tablet_report_limit, advanced);
+TAG_FLAG(tablet_report_limit, runtime);
+
+DEFINE_int32(leader_transfer_on_shutdown_timeout_ms, 5000,
+             "How long the tablet server waits on shutdown for the tablets it leads to transfer "
+             "leadership to caught up followers, so they do not stay without a leader for the "
+             "election timeout. 0 disables the transfer.");
+TAG_FLAG(leader_transfer_on_shutdown_timeout_ms, advanced);
+TAG_FLAG(leader_transfer_on_shutdown_timeout_ms, runtime);
+
+DECLARE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec);
+DECLARE_int32(rocksdb_memtable_insert_parallelism);
+
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
+METRIC_DECLARE_histogram(log_sync_latency);
+
 namespace yb {
 namespace tserver {
 
@@ -252,37 +363,115 @@ using tablet::TabletPeerPtr;
 using tablet::TabletStatusListener;
 using tablet::TabletStatusPB;
 
+namespace {
+
+// Asks the leaders among peers to step down in favor of caught up followers, and waits until they
+// are not leaders anymore or the timeout expires.
+void TransferLeadership(const vector<TabletPeerPtr>& peers, MonoDelta timeout) {
+  vector<TabletPeerPtr> transferring;
+  for (const auto& peer : peers) {
+    if (peer->LeaderStatus() == consensus::LeaderStatus::NOT_LEADER) {
+      continue;
+    }
+    auto consensus = peer->shared_consensus();
+    if (!consensus) {
+      continue;
+    }
+    Status s = consensus->TransferLeadership();
+    if (s.ok()) {
+      transferring.push_back(peer);
+    } else {
+      LOG(INFO) << "T " << peer->tablet_id() << ": Not transferring leadership on shutdown: "
+                << s.ToString();
+    }
+  }
+  if (transferring.empty()) {
+    return;
+  }
+
+  LOG(INFO) << "Waiting for " << transferring.size() << " tablets to transfer leadership";
+  const auto deadline = MonoTime::Now() + timeout;
+  while (!transferring.empty() && MonoTime::Now() < deadline) {
+    SleepFor(10ms);
+    transferring.erase(
+        std::remove_if(transferring.begin(), transferring.end(), [](const TabletPeerPtr& peer) {
+          return peer->LeaderStatus() == consensus::LeaderStatus::NOT_LEADER;
+        }),
+        transferring.end());
+  }
+  if (!transferring.empty()) {
+    LOG(WARNING) << transferring.size() << " tablets did not transfer leadership in "
+                 << timeout;
+  }
+}
+
+} // namespace
+
 // Only called from the background task to ensure it's synchronized
 void TSTabletManager::MaybeFlushTablet() {
   int iteration = 0;
   while (memory_monitor()->Exceeded() ||
          (iteration++ == 0 && FLAGS_pretend_memory_exceeded_enforce_flush)) {
     TabletPeerPtr tablet_to_flush = TabletToFlush();
-    // TODO(bojanserafimov): If tablet_to_flush flushes now because of other reasons,
-    // we will schedule a second flush, which will unnecessarily stall writes for a short time. This
-    // will not happen often, but should be fixed.
-    if (tablet_to_flush) {
-      WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
-          Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
+    if (!tablet_to_flush) {
+      // Either nothing to flush or enough flushes are running. The memory monitor wakes us up
+      // again on the next allocation that exceeds the limit.
+      break;
     }
+    WARN_NOT_OK(tablet_to_flush->tablet()->Flush(tablet::FlushMode::kAsync),
+        Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
+void TSTabletManager::CloseIdleTableReaders() {
+  for (const auto& peer : GetTabletPeers()) {
+    const auto tablet = peer->shared_tablet();
+    if (tablet) {
+      tablet->CloseTableReadersIfIdle();
+    }
+  }
+}
+
+// Return the tablet with the highest flush score, or nullptr if all tablet memstores are empty or
+// about to flush, or if enough tablets are flushing already.
 TabletPeerPtr TSTabletManager::TabletToFlush() {
+  const HybridTime now = server_->clock()->Now();
+  const double age_weight_sec = std::max(FLAGS_memstore_flush_age_weight_sec, 1);
   boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
+  double best_score = 0;
+  int flushes_in_progress = 0;
   TabletPeerPtr tablet_to_flush;
   for (const TabletMap::value_type& entry : tablet_map_) {
     const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
-      }
+    if (!tablet) {
+      continue;
+    }
+    const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
+    auto state = tablet->GetMemTableState();
+    if (!state.ok()) {
+      continue;
+    }
+    if (state->flush_in_progress) {
+      ++flushes_in_progress;
+    }
+    if (oldest_write_in_memstore == HybridTime::kMax) {
+      // Memstore is empty or its flush is already scheduled.
+      continue;
     }
+    const double age_sec = oldest_write_in_memstore < now
+        ? now.PhysicalDiff(oldest_write_in_memstore) / 1e6 : 0;
+    const double score = (state->regular_active_size + state->intents_active_size) *
+                         (1 + age_sec / age_weight_sec);
+    if (!tablet_to_flush || score > best_score) {
+      best_score = score;
+      tablet_to_flush = entry.second;
+    }
+  }
+  if (FLAGS_max_concurrent_memstore_flushes > 0 &&
+      flushes_in_progress >= FLAGS_max_concurrent_memstore_flushes) {
+    VLOG(1) << "Not scheduling a memstore flush, " << flushes_in_progress
+            << " tablets are flushing already";
+    return nullptr;
   }
   return tablet_to_flush;
 }
@@ -312,16 +501,31 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   // "number of CPUs" may cause blocking tasks to starve other "fast" tasks).
   // However, the effective upper bound is the number of replicas as each will
   // submit its own tasks via a dedicated token.
-  CHECK_OK(ThreadPoolBuilder("raft")
-               .unlimited_threads()
-               .Build(&raft_pool_));
-  CHECK_OK(ThreadPoolBuilder("prepare")
-               .unlimited_threads()
-               .Build(&tablet_prepare_pool_));
-  CHECK_OK(ThreadPoolBuilder("append")
-               .unlimited_threads()
-               .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
-               .Build(&append_pool_));
+  //
+  // Every task class is submitted through per replica tokens, which keep their own ordering, so
+  // the classes can also share one pool. Its threads then serve whichever class is busy instead of
+  // each pool keeping idle threads of its own.
+  if (FLAGS_share_consensus_thread_pool) {
+    CHECK_OK(ThreadPoolBuilder("consensus")
+                 .unlimited_threads()
+                 .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
+                 .Build(&consensus_pool_));
+  } else {
+    CHECK_OK(ThreadPoolBuilder("raft")
+                 .unlimited_threads()
+                 .Build(&raft_pool_));
+    CHECK_OK(ThreadPoolBuilder("prepare")
+                 .unlimited_threads()
+                 .Build(&tablet_prepare_pool_));
+    CHECK_OK(ThreadPoolBuilder("append")
+                 .unlimited_threads()
+                 .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
+                 .Build(&append_pool_));
+    CHECK_OK(ThreadPoolBuilder("log-read-ahead")
+                 .unlimited_threads()
+                 .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
+                 .Build(&log_read_pool_));
+  }
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -332,6 +536,14 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_max_queue_size(FLAGS_read_pool_max_queue_size)
                .set_metrics(std::move(read_metrics))
                .Build(&read_pool_));
+  tablet_options_.read_pool = read_pool_.get();
+  async_io_executor_ = std::make_unique<AsyncIoExecutor>("async-io");
+  CHECK_OK(async_io_executor_->Init(FLAGS_async_io_max_threads, FLAGS_async_io_max_queue_size));
+  if (FLAGS_rocksdb_memtable_insert_parallelism > 1) {
+    // Inserting threads do not block, so the default number of threads is the number of CPUs.
+    CHECK_OK(ThreadPoolBuilder("memtable-insert").Build(&memtable_insert_pool_));
+    tablet_options_.memtable_insert_pool = memtable_insert_pool_.get();
+  }
 
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
@@ -347,11 +559,35 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
   if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+    if (FLAGS_db_block_cache_type == "clock") {
+      tablet_options_.block_cache = rocksdb::NewClockCache(
+          block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+          false /* strict_capacity_limit */);
+    } else {
+      LOG_IF(DFATAL, FLAGS_db_block_cache_type != "lru")
+          << "Unknown block cache type: " << FLAGS_db_block_cache_type << ", using lru";
+      tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
+                                                         FLAGS_db_block_cache_num_shard_bits);
+    }
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
   }
 
+  if (!FLAGS_db_persistent_block_cache_path.empty()) {
+    rocksdb::PersistentBlockCacheOptions cache_options;
+    cache_options.path = FLAGS_db_persistent_block_cache_path;
+    cache_options.capacity = FLAGS_db_persistent_block_cache_size_bytes;
+    cache_options.admission_threshold = FLAGS_db_persistent_block_cache_admission_threshold;
+    cache_options.mem_tracker = MemTracker::FindOrCreateTracker(
+        "PersistentBlockCache", server_->mem_tracker());
+    auto cache = rocksdb::NewPersistentBlockCache(cache_options);
+    if (cache.ok()) {
+      tablet_options_.persistent_block_cache = std::move(*cache);
+    } else {
+      LOG(WARNING) << "Failed to create persistent block cache at "
+                   << FLAGS_db_persistent_block_cache_path << ": " << cache.status();
+    }
+  }
+
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
   CHECK(FLAGS_global_memstore_size_percentage > 0 && FLAGS_global_memstore_size_percentage <= 100)
@@ -378,6 +614,57 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
+
+  if (FLAGS_close_idle_table_readers_interval_sec > 0) {
+    close_idle_table_readers_task_.reset(new BackgroundTask(
+        [this] { CloseIdleTableReaders(); },
+        "tablet manager",
+        "idle table readers closer",
+        std::chrono::seconds(FLAGS_close_idle_table_readers_interval_sec)));
+  }
+
+  if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    if (FLAGS_compaction_rate_tune_interval_ms > 0) {
+      compaction_rate_tuner_ = std::make_unique<CompactionRateTuner>(
+          FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec,
+          [this] { return ReadLatencyHistograms(); },
+          [this] { return WalSyncLatencyHistograms(); });
+      tablet_options_.rate_limiter = compaction_rate_tuner_->rate_limiter();
+      compaction_rate_tune_task_.reset(new BackgroundTask(
+          [this] { compaction_rate_tuner_->Tune(); },
+          "tablet manager",
+          "compaction rate tuner",
+          std::chrono::milliseconds(FLAGS_compaction_rate_tune_interval_ms)));
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_per_tserver) {
+      tablet_options_.rate_limiter.reset(
+          rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+    }
+  }
+}
+
+std::vector<scoped_refptr<Histogram>> TSTabletManager::ReadLatencyHistograms() const {
+  std::vector<scoped_refptr<Histogram>> result;
+  auto metric = server_->metric_entity()->FindOrNull(
+      METRIC_handler_latency_yb_tserver_TabletServerService_Read);
+  if (metric) {
+    result.push_back(down_cast<Histogram*>(metric.get()));
+  }
+  return result;
+}
+
+std::vector<scoped_refptr<Histogram>> TSTabletManager::WalSyncLatencyHistograms() const {
+  std::vector<scoped_refptr<Histogram>> result;
+  for (const auto& peer : GetTabletPeers()) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto metric = tablet->GetMetricEntity()->FindOrNull(METRIC_log_sync_latency);
+    if (metric) {
+      result.push_back(down_cast<Histogram*>(metric.get()));
+    }
+  }
+  return result;
 }
 
 TSTabletManager::~TSTabletManager() {
@@ -392,6 +679,9 @@ Status TSTabletManager::Init() {
       &server_->options(), server_->metric_entity(), server_->mem_tracker(),
       server_->messenger());
 
+  multi_raft_manager_ = std::make_unique<consensus::MultiRaftManager>(
+      server_->messenger(), &server_->proxy_cache());
+
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
@@ -408,6 +698,9 @@ Status TSTabletManager::Init() {
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
                 .set_max_threads(max_bootstrap_threads)
                 .Build(&open_tablet_pool_));
+  RETURN_NOT_OK(ThreadPoolBuilder("tablet-create")
+                .set_max_threads(max_bootstrap_threads)
+                .Build(&create_tablet_pool_));
 
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
@@ -461,6 +754,14 @@ Status TSTabletManager::Init() {
     RETURN_NOT_OK(background_task_->Init());
   }
 
+  if (compaction_rate_tune_task_) {
+    RETURN_NOT_OK(compaction_rate_tune_task_->Init());
+  }
+
+  if (close_idle_table_readers_task_) {
+    RETURN_NOT_OK(close_idle_table_readers_task_->Init());
+  }
+
   return Status::OK();
 }
 
@@ -570,6 +871,22 @@ Status TSTabletManager::CreateNewTablet(
   return Status::OK();
 }
 
+void TSTabletManager::RunTabletCreations(const std::vector<std::function<void()>>& create_funcs) {
+  CountDownLatch latch(create_funcs.size());
+  for (const auto& create_func : create_funcs) {
+    auto task = [&create_func, &latch] {
+      create_func();
+      latch.CountDown();
+    };
+    Status s = create_tablet_pool_->SubmitFunc(task);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to submit tablet creation, running it inline: " << s;
+      task();
+    }
+  }
+  latch.Wait();
+}
+
 string LogPrefix(const string& tablet_id, const string& uuid) {
   return "T " + tablet_id + " P " + uuid + ": ";
 }
@@ -692,6 +1009,7 @@ Status TSTabletManager::StartRemoteBootstrap(const StartRemoteBootstrapRequestPB
   if (replacing_tablet) {
     RETURN_NOT_OK(rb_client->SetTabletToReplace(meta, leader_term));
   }
+  rb_client->set_compress(ShouldCompressRpcs(req.source_cloud_info(), server_->MakeCloudInfoPB()));
   RETURN_NOT_OK(rb_client->Start(bootstrap_peer_uuid,
                                  &server_->proxy_cache(),
                                  bootstrap_peer_addr,
@@ -956,7 +1274,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
         std::bind(&TSTabletManager::PreserveLocalLeadersOnly, this, _1),
         tablet_peer.get(),
         append_pool(),
-        &retryable_requests};
+        &retryable_requests,
+        log_read_pool()};
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to bootstrap: "
@@ -978,7 +1297,9 @@ void TSTabletManager::OpenTablet(const scoped_refptr<TabletMetadata>& meta,
                                     tablet->GetMetricEntity(),
                                     raft_pool(),
                                     tablet_prepare_pool(),
-                                    &retryable_requests);
+                                    &retryable_requests,
+                                    multi_raft_manager_.get(),
+                                    async_io_executor());
 
     if (!s.ok()) {
       LOG(ERROR) << kLogPrefix << "Tablet failed to init: "
@@ -1016,6 +1337,14 @@ void TSTabletManager::StartShutdown() {
     background_task_->Shutdown();
   }
 
+  if (compaction_rate_tune_task_) {
+    compaction_rate_tune_task_->Shutdown();
+  }
+
+  if (close_idle_table_readers_task_) {
+    close_idle_table_readers_task_->Shutdown();
+  }
+
   {
     std::lock_guard<RWMutex> lock(lock_);
     switch (state_) {
@@ -1039,13 +1368,22 @@ void TSTabletManager::StartShutdown() {
     }
   }
 
-  // Shut down the bootstrap pool, so new tablets are registered after this point.
+  // Shut down the creation and bootstrap pools, so new tablets are registered after this point.
+  create_tablet_pool_->Shutdown();
   open_tablet_pool_->Shutdown();
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
   // inversion. (see KUDU-308 for example).
-  for (const TabletPeerPtr& peer : GetTabletPeers()) {
+  const auto peers = GetTabletPeers();
+
+  // Hand over leadership before the peers stop, so the tablets do not have to detect the failure.
+  const auto leader_transfer_timeout = FLAGS_leader_transfer_on_shutdown_timeout_ms;
+  if (leader_transfer_timeout > 0) {
+    TransferLeadership(peers, MonoDelta::FromMilliseconds(leader_transfer_timeout));
+  }
+
+  for (const TabletPeerPtr& peer : peers) {
     if (peer->StartShutdown()) {
       shutting_down_peers_.push_back(peer);
     }
@@ -1054,12 +1392,16 @@ void TSTabletManager::StartShutdown() {
 
 void TSTabletManager::CompleteShutdown() {
   for (const TabletPeerPtr& peer : shutting_down_peers_) {
-    peer->CompleteShutdown();
+    peer->CompleteShutdown(tablet::FlushOnShutdown(FLAGS_flush_tablets_on_shutdown));
   }
 
   // Shut down the apply pool.
   apply_pool_->Shutdown();
 
+  if (memtable_insert_pool_) {
+    memtable_insert_pool_->Shutdown();
+  }
+
   if (raft_pool_) {
     raft_pool_->Shutdown();
   }
@@ -1069,6 +1411,13 @@ void TSTabletManager::CompleteShutdown() {
   if (append_pool_) {
     append_pool_->Shutdown();
   }
+  if (log_read_pool_) {
+    log_read_pool_->Shutdown();
+  }
+  if (consensus_pool_) {
+    consensus_pool_->Shutdown();
+  }
+  async_io_executor_->Shutdown();
 
   {
     std::lock_guard<RWMutex> l(lock_);
@@ -1286,14 +1635,18 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
   vector<std::shared_ptr<TabletPeer>> to_report;
   {
     boost::shared_lock<RWMutex> shared_lock(lock_);
-    to_report.reserve(dirty_tablets_.size());
+    const size_t limit = TabletReportLimit();
+    to_report.reserve(std::min(dirty_tablets_.size(), limit));
     report->set_sequence_number(next_report_seq_++);
     for (const DirtyMap::value_type& dirty_entry : dirty_tablets_) {
       const string& tablet_id = dirty_entry.first;
       TabletPeerPtr* tablet_peer = FindOrNull(tablet_map_, tablet_id);
       if (tablet_peer) {
-        // Dirty entry, report on it.
-        to_report.push_back(*tablet_peer);
+        // Dirty entry, report on it unless the report is full. Tablets left out stay dirty and
+        // get reported next time.
+        if (to_report.size() < limit) {
+          to_report.push_back(*tablet_peer);
+        }
       } else {
         // Removed.
         report->add_removed_tablet_ids(tablet_id);
@@ -1319,12 +1672,34 @@ void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
     report->set_sequence_number(next_report_seq_++);
     GetTabletPeersUnlocked(&to_report);
   }
+  // Only the first chunk of tablets goes into the full report. The rest are marked dirty, so that
+  // they follow in incremental reports once the master has accepted this one.
+  vector<std::shared_ptr<TabletPeer>> remaining;
+  const size_t limit = TabletReportLimit();
+  if (to_report.size() > limit) {
+    remaining.assign(to_report.begin() + limit, to_report.end());
+    to_report.resize(limit);
+  }
   for (const auto& replica : to_report) {
     CreateReportedTabletPB(replica, report->add_updated_tablets());
   }
 
   std::lock_guard<RWMutex> l(lock_);
   dirty_tablets_.clear();
+  for (const auto& replica : remaining) {
+    TabletReportState state;
+    state.change_seq = next_report_seq_;
+    dirty_tablets_.emplace(replica->tablet_id(), state);
+  }
+  if (!remaining.empty()) {
+    LOG(INFO) << "Full tablet report is limited to " << limit << " tablets, "
+              << remaining.size() << " tablets will follow in incremental reports";
+  }
+}
+
+size_t TSTabletManager::TabletReportLimit() const {
+  return FLAGS_tablet_report_limit > 0 ? FLAGS_tablet_report_limit
+                                       : std::numeric_limits<size_t>::max();
 }
 
 void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report) {
@@ -1333,19 +1708,22 @@ void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report)
   int32_t acked_seq = report.sequence_number();
   CHECK_LT(acked_seq, next_report_seq_);
 
-  // Clear the "dirty" state for any tablets which have not changed since
-  // this report.
-  auto it = dirty_tablets_.begin();
-  while (it != dirty_tablets_.end()) {
-    const TabletReportState& state = it->second;
-    if (state.change_seq <= acked_seq) {
+  // Clear the "dirty" state for any tablets in this report which have not changed since. Dirty
+  // tablets that did not fit into the report are left alone.
+  auto acknowledge = [this, acked_seq](const TabletId& tablet_id) {
+    auto it = dirty_tablets_.find(tablet_id);
+    if (it != dirty_tablets_.end() && it->second.change_seq <= acked_seq) {
       // This entry has not changed since this tablet report, we no longer need
       // to track it as dirty. If it becomes dirty again, it will be re-added
       // with a higher sequence number.
-      it = dirty_tablets_.erase(it);
-    } else {
-      ++it;
+      dirty_tablets_.erase(it);
     }
+  };
+  for (const auto& reported : report.updated_tablets()) {
+    acknowledge(reported.tablet_id());
+  }
+  for (const auto& tablet_id : report.removed_tablet_ids()) {
+    acknowledge(tablet_id);
   }
 }
 
@@ -1411,25 +1789,12 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_data_assignment_map_[table_id][data_root_iter] = tablet_id_set;
     }
   }
-  // Find the data directory with the least count of tablets for this table.
-  table_data_assignment_iter = table_data_assignment_map_.find(table_id);
-  auto data_assignment_value_map = table_data_assignment_iter->second;
-  string min_dir;
-  uint64_t min_dir_count = kuint64max;
-  for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  string min_dir = PickRootDirUnlocked(fs_manager, table_data_assignment_map_, table_id);
   *data_root_dir = min_dir;
   // Increment the count for min_dir.
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
   data_assignment_value_iter->second.insert(tablet_id);
 
-  // Find the wal directory with the least count of tablets for this table.
-  min_dir = "";
-  min_dir_count = kuint64max;
   auto wal_root_dirs = fs_manager->GetWalRootDirs();
   CHECK(!wal_root_dirs.empty()) << "No wal root directories found";
   auto table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
@@ -1439,19 +1804,56 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
       table_wal_assignment_map_[table_id][wal_root_iter] = tablet_id_set;
     }
   }
-  table_wal_assignment_iter = table_wal_assignment_map_.find(table_id);
-  auto wal_assignment_value_map = table_wal_assignment_iter->second;
-  for (auto it = wal_assignment_value_map.begin(); it != wal_assignment_value_map.end(); ++it) {
-    if (min_dir_count > it->second.size()) {
-      min_dir = it->first;
-      min_dir_count = it->second.size();
-    }
-  }
+  min_dir = PickRootDirUnlocked(fs_manager, table_wal_assignment_map_, table_id);
   *wal_root_dir = min_dir;
   auto wal_assignment_value_iter = table_wal_assignment_map_[table_id].find(min_dir);
   wal_assignment_value_iter->second.insert(tablet_id);
 }
 
+string TSTabletManager::PickRootDirUnlocked(FsManager* fs_manager,
+                                            const TableDiskAssignmentMap& assignment_map,
+                                            const string& table_id) const {
+  struct Candidate {
+    const string* dir;
+    size_t table_tablets;
+    size_t total_tablets = 0;
+    uint64_t free_bytes = std::numeric_limits<uint64_t>::max();
+    bool low_on_space = false;
+  };
+  std::vector<Candidate> candidates;
+  for (const auto& dir_and_tablets : assignment_map.at(table_id)) {
+    candidates.push_back({&dir_and_tablets.first, dir_and_tablets.second.size()});
+  }
+  for (auto& candidate : candidates) {
+    for (const auto& table_and_dirs : assignment_map) {
+      auto it = table_and_dirs.second.find(*candidate.dir);
+      if (it != table_and_dirs.second.end()) {
+        candidate.total_tablets += it->second.size();
+      }
+    }
+    auto free_bytes = fs_manager->env()->GetFreeSpaceBytes(*candidate.dir);
+    if (free_bytes.ok()) {
+      candidate.free_bytes = *free_bytes;
+      candidate.low_on_space = *free_bytes < FLAGS_fs_dir_min_free_space_bytes;
+    } else {
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to get free space of " << *candidate.dir
+                                       << ": " << free_bytes.status();
+    }
+  }
+
+  // Directories low on space are avoided while there are other ones. Then tablets of each table
+  // are spread evenly, then all tablets, and the directory with the most free space takes the
+  // remaining ties, so that a disk that filled faster than the others gets fewer new tablets.
+  auto best = std::min_element(
+      candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    return std::make_tuple(lhs.low_on_space, lhs.table_tablets, lhs.total_tablets,
+                           std::numeric_limits<uint64_t>::max() - lhs.free_bytes) <
+           std::make_tuple(rhs.low_on_space, rhs.table_tablets, rhs.total_tablets,
+                           std::numeric_limits<uint64_t>::max() - rhs.free_bytes);
+  });
+  return best == candidates.end() ? string() : *best->dir;
+}
+
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
                                             const string& table_id,
                                             const string& tablet_id,
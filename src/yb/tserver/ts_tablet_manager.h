@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -56,6 +57,7 @@
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/tserver/tserver_admin.pb.h"
+#include "yb/util/async_io_executor.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/rw_mutex.h"
@@ -82,6 +84,7 @@ class TabletReportPB;
 } // namespace master
 
 namespace tserver {
+class CompactionRateTuner;
 class TabletServer;
 class TSMemoryMonitorListener;
 
@@ -149,10 +152,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Completes shutdown process and waits for it's completeness.
   void CompleteShutdown();
 
-  ThreadPool* tablet_prepare_pool() const { return tablet_prepare_pool_.get(); }
-  ThreadPool* raft_pool() const { return raft_pool_.get(); }
+  ThreadPool* tablet_prepare_pool() const { return PoolOrShared(tablet_prepare_pool_); }
+  ThreadPool* raft_pool() const { return PoolOrShared(raft_pool_); }
   ThreadPool* read_pool() const { return read_pool_.get(); }
-  ThreadPool* append_pool() const { return append_pool_.get(); }
+  ThreadPool* append_pool() const { return PoolOrShared(append_pool_); }
+  ThreadPool* log_read_pool() const { return PoolOrShared(log_read_pool_); }
+  AsyncIoExecutor* async_io_executor() const { return async_io_executor_.get(); }
 
   // Create a new tablet and register it with the tablet manager. The new tablet
   // is persisted on disk and opened before this method returns.
@@ -173,6 +178,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
     consensus::RaftConfigPB config,
     std::shared_ptr<tablet::TabletPeer> *tablet_peer);
 
+  // Runs each of the given functions, which are expected to call CreateNewTablet(), concurrently
+  // on the tablet creation pool and waits for all of them to finish. Functions that cannot be
+  // submitted to the pool are run on the calling thread.
+  void RunTabletCreations(const std::vector<std::function<void()>>& create_funcs);
+
   // Delete the specified tablet.
   // 'delete_type' must be one of TABLET_DATA_DELETED or TABLET_DATA_TOMBSTONED
   // or else returns Status::IllegalArgument.
@@ -218,11 +228,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // next tablet report will continue to include the same tablets until one
   // is acknowleged.
   //
+  // At most --tablet_report_limit changed tablets are included, the rest stay dirty.
+  //
   // This is thread-safe to call along with tablet modification, but not safe
   // to call from multiple threads at the same time.
   void GenerateIncrementalTabletReport(master::TabletReportPB* report);
 
   // Generate a full tablet report and reset any incremental state tracking.
+  //
+  // At most --tablet_report_limit tablets are included. The remaining tablets are marked dirty and
+  // are sent by the following incremental reports.
   void GenerateFullTabletReport(master::TabletReportPB* report);
 
   // Mark that the master successfully received and processed the given
@@ -288,9 +303,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
+  // Tunes the write rate limit of flushes and compactions shared by all tablets. Null when the
+  // rate is not auto tuned.
+  const CompactionRateTuner* compaction_rate_tuner() const { return compaction_rate_tuner_.get(); }
+
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Closes the SST table readers of tablets that had no reads since the previous call.
+  void CloseIdleTableReaders();
+
  private:
   FRIEND_TEST(TsTabletManagerTest, TestPersistBlocks);
 
@@ -309,6 +331,24 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   };
   typedef std::unordered_map<std::string, TabletReportState> DirtyMap;
 
+  // Returns the given per class pool, or the shared consensus pool when it is in use.
+  ThreadPool* PoolOrShared(const std::unique_ptr<ThreadPool>& pool) const {
+    return pool ? pool.get() : consensus_pool_.get();
+  }
+
+  // Picks the directory for a new tablet of table_id among the directories of assignment_map.
+  // Requires dir_assignment_lock_ and an initialized entry for table_id.
+  std::string PickRootDirUnlocked(FsManager* fs_manager,
+                                  const TableDiskAssignmentMap& assignment_map,
+                                  const std::string& table_id) const;
+
+  // Maximum number of tablets to put into one tablet report, from --tablet_report_limit.
+  size_t TabletReportLimit() const;
+
+  // Latency histograms used to tune the write rate limit of flushes and compactions.
+  std::vector<scoped_refptr<Histogram>> ReadLatencyHistograms() const;
+  std::vector<scoped_refptr<Histogram>> WalSyncLatencyHistograms() const;
+
   // Returns Status::OK() iff state_ == MANAGER_RUNNING.
   CHECKED_STATUS CheckRunningUnlocked(boost::optional<TabletServerErrorPB::Code>* error_code) const;
 
@@ -380,7 +420,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // TABLET_DATA_READY state. Generally, we tombstone the replica.
   CHECKED_STATUS HandleNonReadyTabletOnStartup(const scoped_refptr<tablet::TabletMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
+  // Return the tablet that benefits most from a flush, or nullptr if there is no such tablet or
+  // max_concurrent_memstore_flushes tablets are already flushing.
   std::shared_ptr<tablet::TabletPeer> TabletToFlush();
 
   TSTabletManagerStatePB state() const {
@@ -442,6 +483,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool used to open the tablets async, whether bootstrap is required or not.
   std::unique_ptr<ThreadPool> open_tablet_pool_;
 
+  // Thread pool used to write the on-disk metadata of a batch of new tablets concurrently.
+  std::unique_ptr<ThreadPool> create_tablet_pool_;
+
   // Thread pool for preparing transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> tablet_prepare_pool_;
 
@@ -454,17 +498,42 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for appender threads, shared between all tablets.
   std::unique_ptr<ThreadPool> append_pool_;
 
+  // Thread pool used to read WAL segments ahead of their replay during tablet bootstrap.
+  std::unique_ptr<ThreadPool> log_read_pool_;
+
+  // Thread pool that replaces the raft, prepare, append and log read pools above when
+  // share_consensus_thread_pool is set.
+  std::unique_ptr<ThreadPool> consensus_pool_;
+
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Blocking file system work moved off RPC service and Raft threads, shared between all tablets.
+  std::unique_ptr<AsyncIoExecutor> async_io_executor_;
+
+  // Thread pool used to insert updates of large write batches into memtables, shared between all
+  // tablets.
+  std::unique_ptr<ThreadPool> memtable_insert_pool_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  std::unique_ptr<CompactionRateTuner> compaction_rate_tuner_;
+
+  // Periodically calls compaction_rate_tuner_->Tune().
+  std::unique_ptr<BackgroundTask> compaction_rate_tune_task_;
+
+  // Periodically calls CloseIdleTableReaders().
+  std::unique_ptr<BackgroundTask> close_idle_table_readers_task_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
   boost::optional<yb::client::AsyncClientInitialiser> async_client_init_;
 
+  // Batches heartbeats of the tablet leaders of this server.
+  std::unique_ptr<consensus::MultiRaftManager> multi_raft_manager_;
+
   TabletPeers shutting_down_peers_;
 
   DISALLOW_COPY_AND_ASSIGN(TSTabletManager);
@@ -47,6 +47,7 @@
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/rocksdb/env.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
@@ -54,6 +55,7 @@
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/compaction_rate_tuner.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/util/url-coding.h"
@@ -113,6 +115,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
       "/maintenance-manager", "",
       std::bind(&TabletServerPathHandlers::HandleMaintenanceManagerPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/compactions", "",
+      std::bind(&TabletServerPathHandlers::HandleCompactionsPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
 
   return Status::OK();
 }
@@ -202,7 +208,8 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Table name</th><th>Tablet ID</th>"
       "<th>Partition</th>"
-      "<th>State</th><th>On-disk size</th><th>RaftConfig</th><th>Last status</th></tr>\n";
+      "<th>State</th><th>On-disk size</th><th>Reads in progress</th><th>RaftConfig</th>"
+      "<th>Last status</th></tr>\n";
   for (const std::shared_ptr<TabletPeer>& peer : peers) {
     TabletStatusPB status;
     peer->GetTabletStatusPB(&status);
@@ -218,6 +225,11 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
     if (status.has_estimated_on_disk_size()) {
       n_bytes = HumanReadableNumBytes::ToString(status.estimated_on_disk_size());
     }
+    string reads_in_progress = "";
+    auto tablet = peer->shared_tablet();
+    if (tablet) {
+      reads_in_progress = std::to_string(tablet->num_reads_in_progress());
+    }
     string partition = peer->tablet_metadata()->partition_schema()
                             .PartitionDebugString(peer->status_listener()->partition(),
                                                   peer->tablet_metadata()->schema());
@@ -227,15 +239,16 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
     (*output) << Substitute(
         // Table name, tablet id, partition
         "<tr><td>$0</td><td>$1</td><td>$2</td>"
-        // State, on-disk size, consensus configuration, last status
-        "<td>$3</td><td>$4</td><td>$5</td><td>$6</td></tr>\n",
+        // State, on-disk size, reads in progress, consensus configuration, last status
+        "<td>$3</td><td>$4</td><td>$5</td><td>$6</td><td>$7</td></tr>\n",
         EscapeForHtmlToString(table_name),  // $0
         tablet_id_or_link,  // $1
         EscapeForHtmlToString(partition),  // $2
         EscapeForHtmlToString(peer->HumanReadableState()), n_bytes,  // $3, $4
+        reads_in_progress,  // $5
         consensus ? ConsensusStatePBToHtml(consensus->ConsensusState(CONSENSUS_CONFIG_COMMITTED))
-                  : "",  // $5
-        EscapeForHtmlToString(status.last_status()));  // $6
+                  : "",  // $6
+        EscapeForHtmlToString(status.last_status()));  // $7
   }
   *output << "</table>\n";
 }
@@ -407,6 +420,8 @@ void TabletServerPathHandlers::HandleDashboardsPage(const Webserver::WebRequest&
   *output << GetDashboardLine("maintenance-manager", "Maintenance Manager",
                               "List of operations that are currently running and those "
                               "that are registered.");
+  *output << GetDashboardLine("compactions", "Compactions",
+                              "Compaction queue of the tablets and the compaction rate limit.");
 }
 
 string TabletServerPathHandlers::GetDashboardLine(const std::string& link,
@@ -476,5 +491,67 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
   *output << "</table>\n";
 }
 
+void TabletServerPathHandlers::HandleCompactionsPage(const Webserver::WebRequest& req,
+                                                     std::stringstream* output) {
+  *output << "<h1>Compactions</h1>\n";
+  *output << "<h3>Rate limit</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  const auto* tuner = tserver_->tablet_manager()->compaction_rate_tuner();
+  if (tuner) {
+    *output << Substitute(
+        "  <tr><td>Current rate limit</td><td>$0/s</td></tr>\n"
+        "  <tr><td>Max rate limit</td><td>$1/s</td></tr>\n"
+        "  <tr><td>Read latency p99</td><td>$2 us</td></tr>\n"
+        "  <tr><td>WAL sync latency p99</td><td>$3 us</td></tr>\n",
+        HumanReadableNumBytes::ToString(tuner->bytes_per_sec()),
+        HumanReadableNumBytes::ToString(tuner->max_bytes_per_sec()),
+        tuner->read_latency_p99_us(), tuner->wal_sync_latency_p99_us());
+  } else {
+    *output << "  <tr><td>Current rate limit</td><td>Not tuned</td></tr>\n";
+  }
+  *output << Substitute(
+      "  <tr><td>Queued background compactions</td><td>$0</td></tr>\n",
+      rocksdb::Env::Default()->GetThreadPoolQueueLen(rocksdb::Env::Priority::LOW));
+  *output << "</table>\n";
+
+  struct TabletEntry {
+    std::string table_name;
+    std::string tablet_id;
+    tablet::TabletCompactionState state;
+  };
+  std::vector<TabletEntry> entries;
+  for (const auto& peer : tserver_->tablet_manager()->GetTabletPeers()) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    auto state = tablet->GetCompactionState();
+    if (!state.ok()) {
+      continue;
+    }
+    entries.push_back({tablet->metadata()->table_name(), tablet->tablet_id(), *state});
+  }
+  // Tablets that need compaction most are shown first, in the order their compactions are run.
+  std::sort(entries.begin(), entries.end(), [](const TabletEntry& lhs, const TabletEntry& rhs) {
+    return lhs.state.urgency_score > rhs.state.urgency_score;
+  });
+
+  *output << "<h3>Tablets</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Urgency score</th>"
+          << "<th>Compaction pending</th><th>Running compactions</th><th>SST files size</th></tr>\n";
+  for (const auto& entry : entries) {
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td></tr>\n",
+        EscapeForHtmlToString(entry.table_name),
+        TabletLink(entry.tablet_id),
+        entry.state.urgency_score,
+        entry.state.compaction_pending ? "yes" : "no",
+        entry.state.num_running_compactions,
+        HumanReadableNumBytes::ToString(entry.state.sst_files_size));
+  }
+  *output << "</table>\n";
+}
+
 }  // namespace tserver
 }  // namespace yb
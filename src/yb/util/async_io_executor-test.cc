@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/async_io_executor.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class AsyncIoExecutorTest : public YBTest {};
+
+TEST_F(AsyncIoExecutorTest, CallbackGetsStatus) {
+  AsyncIoExecutor executor("test-io");
+  ASSERT_OK(executor.Init(2 /* max_threads */, 10 /* max_queue_size */));
+
+  CountDownLatch latch(2);
+  Status ok_status = STATUS(IllegalState, "Not set");
+  Status failed_status;
+  std::thread::id io_thread;
+  ASSERT_OK(executor.Submit(
+      [&io_thread] {
+        io_thread = std::this_thread::get_id();
+        return Status::OK();
+      },
+      [&](const Status& status) {
+        ASSERT_EQ(io_thread, std::this_thread::get_id());
+        ok_status = status;
+        latch.CountDown();
+      }));
+  ASSERT_OK(executor.Submit(
+      [] { return STATUS(IOError, "Disk failed"); },
+      [&](const Status& status) {
+        failed_status = status;
+        latch.CountDown();
+      }));
+  latch.Wait();
+  ASSERT_OK(ok_status);
+  ASSERT_TRUE(failed_status.IsIOError()) << failed_status;
+  ASSERT_NE(std::this_thread::get_id(), io_thread);
+}
+
+TEST_F(AsyncIoExecutorTest, RejectsWhenQueueIsFull) {
+  AsyncIoExecutor executor("test-io");
+  ASSERT_OK(executor.Init(1 /* max_threads */, 1 /* max_queue_size */));
+
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  CountDownLatch done(2);
+  auto callback = [&done](const Status&) { done.CountDown(); };
+  ASSERT_OK(executor.Submit(
+      [&] {
+        started.CountDown();
+        release.Wait();
+        return Status::OK();
+      },
+      callback));
+  started.Wait();
+  ASSERT_OK(executor.Submit([] { return Status::OK(); }, callback));
+
+  auto status = executor.Submit([] { return Status::OK(); }, callback);
+  ASSERT_TRUE(status.IsServiceUnavailable()) << status;
+  ASSERT_EQ(2, executor.num_pending());
+
+  release.CountDown();
+  done.Wait();
+  ASSERT_OK(WaitFor([&executor] { return executor.num_pending() == 0; },
+                    MonoDelta::FromSeconds(10), "Pending I/O"));
+}
+
+} // namespace yb
@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/async_io_executor.h"
+
+#include <glog/logging.h>
+
+namespace yb {
+
+AsyncIoExecutor::AsyncIoExecutor(std::string name) : name_(std::move(name)) {}
+
+AsyncIoExecutor::~AsyncIoExecutor() {
+  Shutdown();
+}
+
+Status AsyncIoExecutor::Init(int max_threads, int max_queue_size) {
+  // Threads mostly wait for the disk, so idle ones are kept around for a while.
+  return ThreadPoolBuilder(name_)
+      .set_max_threads(max_threads)
+      .set_max_queue_size(max_queue_size)
+      .set_idle_timeout(MonoDelta::FromSeconds(10))
+      .Build(&pool_);
+}
+
+Status AsyncIoExecutor::Submit(IoFunction io, Callback callback) {
+  if (!pool_) {
+    return STATUS_FORMAT(ServiceUnavailable, "$0 is not running", name_);
+  }
+  num_pending_.fetch_add(1, std::memory_order_acq_rel);
+  auto status = pool_->SubmitFunc(
+      [this, io = std::move(io), callback = std::move(callback)] {
+    auto status = io();
+    if (callback) {
+      callback(status);
+    }
+    num_pending_.fetch_sub(1, std::memory_order_acq_rel);
+  });
+  if (!status.ok()) {
+    num_pending_.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  return status;
+}
+
+std::unique_ptr<ThreadPoolToken> AsyncIoExecutor::NewSerialToken() {
+  return pool_ ? pool_->NewToken(ThreadPool::ExecutionMode::SERIAL) : nullptr;
+}
+
+void AsyncIoExecutor::Shutdown() {
+  if (pool_) {
+    pool_->Wait();
+    pool_->Shutdown();
+  }
+}
+
+} // namespace yb
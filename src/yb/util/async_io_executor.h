@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ASYNC_IO_EXECUTOR_H
+#define YB_UTIL_ASYNC_IO_EXECUTOR_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "yb/util/status.h"
+#include "yb/util/threadpool.h"
+
+namespace yb {
+
+// Runs blocking file system work, e.g. reads of log and data files or metadata writes, on a
+// bounded pool of threads. RPC service threads hand such work over together with a completion
+// callback, so a slow disk stalls the I/O threads instead of the threads serving heartbeats.
+class AsyncIoExecutor {
+ public:
+  typedef std::function<Status()> IoFunction;
+  typedef std::function<void(const Status&)> Callback;
+
+  explicit AsyncIoExecutor(std::string name);
+  ~AsyncIoExecutor();
+
+  // At most max_threads operations run at the same time and at most max_queue_size operations
+  // wait for a thread.
+  CHECKED_STATUS Init(int max_threads, int max_queue_size);
+
+  // Runs io on an I/O thread, then invokes callback, if set, with its status on the same thread.
+  // Returns ServiceUnavailable without running anything when the queue is full or the executor
+  // is shut down, so the caller could fall back to doing the work itself or reject the request.
+  CHECKED_STATUS Submit(IoFunction io, Callback callback = Callback());
+
+  // Token for I/O that should be done in order, e.g. read ahead of a single log.
+  std::unique_ptr<ThreadPoolToken> NewSerialToken();
+
+  // Number of submitted operations that have not completed yet.
+  int64_t num_pending() const {
+    return num_pending_.load(std::memory_order_acquire);
+  }
+
+  // Waits for the submitted operations to complete, so that their callbacks run, and stops the
+  // threads. Operations submitted afterwards are rejected.
+  void Shutdown();
+
+ private:
+  const std::string name_;
+  std::unique_ptr<ThreadPool> pool_;
+  std::atomic<int64_t> num_pending_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncIoExecutor);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_ASYNC_IO_EXECUTOR_H
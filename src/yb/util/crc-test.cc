@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <vector>
+
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/crc.h"
@@ -102,5 +104,71 @@ TEST_F(CrcTest, BenchmarkCRC32C) {
                           (kNumBytes / elapsed.wall));
 }
 
+// Checks the hardware and software implementations against crcutil, for lengths that cover the
+// interleaved and the tail paths, at all alignments.
+TEST_F(CrcTest, TestCrc32cExtend) {
+  LOG(INFO) << "Hardware CRC32C supported: " << IsHardwareCrc32cSupported();
+  const string test_data("abcdefgh");
+  ASSERT_EQ(0xa9421b7, Crc32c(test_data.data(), test_data.length()));
+  ASSERT_EQ(0xa9421b7, SoftwareCrc32cExtend(0, test_data.data(), test_data.length()));
+
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i != data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7919 + (i >> 8));
+  }
+  Crc* crc32c = GetCrc32cInstance();
+  for (size_t offset = 0; offset != 9; ++offset) {
+    for (size_t length : {0, 1, 7, 8, 9, 100, 767, 768, 1000, 24575, 24576, 24577, 70000, 99000}) {
+      uint64_t expected = 0;
+      crc32c->Compute(data.data() + offset, length, &expected);
+      ASSERT_EQ(expected, Crc32c(data.data() + offset, length)) << offset << ", " << length;
+      ASSERT_EQ(expected, SoftwareCrc32cExtend(0, data.data() + offset, length))
+          << offset << ", " << length;
+
+      // Extending in two parts gives the same result.
+      size_t split = length / 3;
+      uint32_t crc = Crc32cExtend(0, data.data() + offset, split);
+      ASSERT_EQ(expected, Crc32cExtend(crc, data.data() + offset + split, length - split))
+          << offset << ", " << length;
+    }
+  }
+}
+
+// Compares throughput of Crc32cExtend to crcutil, for WAL batch sized and block sized buffers.
+TEST_F(CrcTest, BenchmarkCrc32cExtend) {
+  gscoped_ptr<const uint8_t[]> data;
+  const uint8_t* buf;
+  size_t buflen;
+  GenerateBenchmarkData(&buf, &buflen);
+  data.reset(buf);
+  Crc* crc32c = GetCrc32cInstance();
+  const uint64_t kTotalBytes = AllowSlowTests() ? 40000ULL * buflen : 1000ULL * buflen;
+  for (size_t chunk : {64, 4096, 32768, 1024 * 1024}) {
+    for (bool use_crcutil : {true, false}) {
+      uint64_t bytes = 0;
+      uint64_t sum = 0;
+      Stopwatch sw;
+      sw.start();
+      while (bytes < kTotalBytes) {
+        for (size_t pos = 0; pos + chunk <= buflen; pos += chunk) {
+          if (use_crcutil) {
+            uint64_t cksum = 0;
+            crc32c->Compute(buf + pos, chunk, &cksum);
+            sum += cksum;
+          } else {
+            sum += Crc32c(buf + pos, chunk);
+          }
+          bytes += chunk;
+        }
+      }
+      sw.stop();
+      CpuTimes elapsed = sw.elapsed();
+      LOG(INFO) << Substitute("$0 on $1 byte chunks: $2 bytes per nanosecond (checksum sum $3)",
+                              use_crcutil ? "crcutil" : "Crc32cExtend", chunk,
+                              bytes / elapsed.wall, sum);
+    }
+  }
+}
+
 } // namespace crc
 } // namespace yb
@@ -31,8 +31,19 @@
 //
 #include "yb/util/crc.h"
 
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define YB_HARDWARE_CRC32C 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define YB_HARDWARE_CRC32C 1
+#endif
+
 #include <crcutil/interface.h>
 
+#include "yb/gutil/endian.h"
 #include "yb/gutil/once.h"
 #include "yb/util/debug/leakcheck_disabler.h"
 
@@ -41,6 +52,232 @@ namespace crc {
 
 using debug::ScopedLeakCheckDisabler;
 
+namespace {
+
+// CRC32C polynomial, bit reversed.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// Block sizes at which the hardware implementation interleaves three streams. The CRC
+// instruction has a latency of 3 cycles and a throughput of 1 per cycle, so three independent
+// streams keep the unit busy.
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+// Multiplies a 32x32 matrix over GF(2) by a vector.
+uint32_t Gf2MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  while (vector) {
+    if (vector & 1) {
+      sum ^= *matrix;
+    }
+    vector >>= 1;
+    ++matrix;
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = Gf2MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+// Fills tables that shift a CRC over length zero bytes, where length is a power of two. Used to
+// combine the CRCs of the interleaved streams.
+void FillZerosTables(size_t length, uint32_t zeros[4][256]) {
+  uint32_t even[32];
+  uint32_t odd[32];
+  // Operator for one zero bit.
+  odd[0] = kCrc32cPolynomial;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; ++n) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  // Two and four zero bits.
+  Gf2MatrixSquare(even, odd);
+  Gf2MatrixSquare(odd, even);
+  // Square until the operator covers length bytes.
+  const uint32_t* op = nullptr;
+  for (;;) {
+    Gf2MatrixSquare(even, odd);
+    length >>= 1;
+    if (length == 0) {
+      op = even;
+      break;
+    }
+    Gf2MatrixSquare(odd, even);
+    length >>= 1;
+    if (length == 0) {
+      op = odd;
+      break;
+    }
+  }
+  for (uint32_t n = 0; n < 256; ++n) {
+    zeros[0][n] = Gf2MatrixTimes(op, n);
+    zeros[1][n] = Gf2MatrixTimes(op, n << 8);
+    zeros[2][n] = Gf2MatrixTimes(op, n << 16);
+    zeros[3][n] = Gf2MatrixTimes(op, n << 24);
+  }
+}
+
+struct Crc32cTables {
+  Crc32cTables() {
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t crc = n;
+      for (int k = 0; k < 8; ++k) {
+        crc = crc & 1 ? (crc >> 1) ^ kCrc32cPolynomial : crc >> 1;
+      }
+      bytes[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+      for (int k = 1; k < 4; ++k) {
+        bytes[k][n] = (bytes[k - 1][n] >> 8) ^ bytes[0][bytes[k - 1][n] & 0xff];
+      }
+    }
+    FillZerosTables(kLongBlock, long_zeros);
+    FillZerosTables(kShortBlock, short_zeros);
+  }
+
+  // bytes[k][n] is the CRC of byte n followed by k zero bytes, for slicing by 4.
+  uint32_t bytes[4][256];
+  uint32_t long_zeros[4][256];
+  uint32_t short_zeros[4][256];
+};
+
+const Crc32cTables& Tables() {
+  static const Crc32cTables tables;
+  return tables;
+}
+
+inline uint32_t Shift(const uint32_t zeros[4][256], uint32_t crc) {
+  return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^
+         zeros[3][crc >> 24];
+}
+
+inline uint32_t SoftwareExtend(uint32_t crc, const uint8_t* p, size_t length) {
+  const auto& tables = Tables();
+  crc = ~crc;
+  while (length && (reinterpret_cast<uintptr_t>(p) & 3) != 0) {
+    crc = tables.bytes[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    --length;
+  }
+  while (length >= 4) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    crc ^= LittleEndian::FromHost32(word);
+    crc = tables.bytes[3][crc & 0xff] ^ tables.bytes[2][(crc >> 8) & 0xff] ^
+          tables.bytes[1][(crc >> 16) & 0xff] ^ tables.bytes[0][crc >> 24];
+    p += 4;
+    length -= 4;
+  }
+  while (length) {
+    crc = tables.bytes[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    --length;
+  }
+  return ~crc;
+}
+
+#ifdef YB_HARDWARE_CRC32C
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+#if defined(__x86_64__)
+
+inline uint32_t HardwareCrc8(uint32_t crc, uint8_t value) {
+  return _mm_crc32_u8(crc, value);
+}
+
+inline uint32_t HardwareCrc64(uint32_t crc, const uint8_t* p) {
+  return static_cast<uint32_t>(_mm_crc32_u64(crc, Load64(p)));
+}
+
+bool CpuHasCrc32c() {
+  return __builtin_cpu_supports("sse4.2");
+}
+
+#else
+
+inline uint32_t HardwareCrc8(uint32_t crc, uint8_t value) {
+  return __crc32cb(crc, value);
+}
+
+inline uint32_t HardwareCrc64(uint32_t crc, const uint8_t* p) {
+  return __crc32cd(crc, Load64(p));
+}
+
+bool CpuHasCrc32c() {
+  // Instructions are mandatory when the compiler targets them.
+  return true;
+}
+
+#endif
+
+// Computes three blocks of block_size bytes at once, then combines their CRCs.
+inline uint32_t HardwareInterleaved(
+    uint32_t crc, const uint32_t zeros[4][256], size_t block_size, const uint8_t** p,
+    size_t* length) {
+  while (*length >= block_size * 3) {
+    const uint8_t* next = *p;
+    const uint8_t* end = next + block_size;
+    uint32_t crc1 = 0;
+    uint32_t crc2 = 0;
+    do {
+      crc = HardwareCrc64(crc, next);
+      crc1 = HardwareCrc64(crc1, next + block_size);
+      crc2 = HardwareCrc64(crc2, next + block_size * 2);
+      next += 8;
+    } while (next < end);
+    crc = Shift(zeros, crc) ^ crc1;
+    crc = Shift(zeros, crc) ^ crc2;
+    *p += block_size * 3;
+    *length -= block_size * 3;
+  }
+  return crc;
+}
+
+uint32_t HardwareExtend(uint32_t crc, const uint8_t* p, size_t length) {
+  crc = ~crc;
+  while (length && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+    crc = HardwareCrc8(crc, *p++);
+    --length;
+  }
+  if (length >= kShortBlock * 3) {
+    const auto& tables = Tables();
+    crc = HardwareInterleaved(crc, tables.long_zeros, kLongBlock, &p, &length);
+    crc = HardwareInterleaved(crc, tables.short_zeros, kShortBlock, &p, &length);
+  }
+  while (length >= 8) {
+    crc = HardwareCrc64(crc, p);
+    p += 8;
+    length -= 8;
+  }
+  while (length) {
+    crc = HardwareCrc8(crc, *p++);
+    --length;
+  }
+  return ~crc;
+}
+
+#endif // YB_HARDWARE_CRC32C
+
+typedef uint32_t (*ExtendFunction)(uint32_t crc, const uint8_t* p, size_t length);
+
+ExtendFunction ChooseExtend() {
+#ifdef YB_HARDWARE_CRC32C
+  if (CpuHasCrc32c()) {
+    return &HardwareExtend;
+  }
+#endif
+  return &SoftwareExtend;
+}
+
+} // namespace
+
 static GoogleOnceType crc32c_once = GOOGLE_ONCE_INIT;
 static Crc* crc32c_instance = nullptr;
 
@@ -56,9 +293,20 @@ Crc* GetCrc32cInstance() {
 }
 
 uint32_t Crc32c(const void* data, size_t length) {
-  uint64_t crc32 = 0;
-  GetCrc32cInstance()->Compute(data, length, &crc32);
-  return static_cast<uint32_t>(crc32); // Only uses lower 32 bits.
+  return Crc32cExtend(0, data, length);
+}
+
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length) {
+  static const ExtendFunction extend = ChooseExtend();
+  return extend(crc, static_cast<const uint8_t*>(data), length);
+}
+
+bool IsHardwareCrc32cSupported() {
+  return ChooseExtend() != &SoftwareExtend;
+}
+
+uint32_t SoftwareCrc32cExtend(uint32_t crc, const void* data, size_t length) {
+  return SoftwareExtend(crc, static_cast<const uint8_t*>(data), length);
 }
 
 } // namespace crc
@@ -48,6 +48,17 @@ Crc* GetCrc32cInstance();
 // Helper function to simply calculate a CRC32C of the given data.
 uint32_t Crc32c(const void* data, size_t length);
 
+// Returns the CRC32C of the concatenation of A and data, where crc is the CRC32C of A.
+// Uses the SSE4.2 or ARMv8 CRC32C instructions when the CPU supports them, computing three
+// independent streams at once for large buffers.
+uint32_t Crc32cExtend(uint32_t crc, const void* data, size_t length);
+
+// Whether Crc32cExtend uses CRC32C instructions of the CPU.
+bool IsHardwareCrc32cSupported();
+
+// Table based implementation of Crc32cExtend, used when the CPU lacks CRC32C instructions.
+uint32_t SoftwareCrc32cExtend(uint32_t crc, const void* data, size_t length);
+
 } // namespace crc
 } // namespace yb
 
@@ -201,6 +201,10 @@ class Env {
   // *block_size. fname must exist but it may be a file or a directory.
   virtual Result<uint64_t> GetBlockSize(const std::string& fname) = 0;
 
+  // Returns the number of bytes available to unprivileged users on the filesystem where path
+  // resides.
+  virtual Result<uint64_t> GetFreeSpaceBytes(const std::string& path) = 0;
+
   // Rename file src to target.
   virtual CHECKED_STATUS RenameFile(const std::string& src,
                             const std::string& target) = 0;
@@ -617,6 +621,9 @@ class EnvWrapper : public Env {
   Result<uint64_t> GetBlockSize(const std::string& f) override {
     return target_->GetBlockSize(f);
   }
+  Result<uint64_t> GetFreeSpaceBytes(const std::string& path) override {
+    return target_->GetFreeSpaceBytes(path);
+  }
   CHECKED_STATUS LinkFile(const std::string& s, const std::string& t) override {
     return target_->LinkFile(s, t);
   }
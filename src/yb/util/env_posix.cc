@@ -28,6 +28,7 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -1190,6 +1191,16 @@ class PosixEnv : public Env {
         fname, "PosixEnv::GetBlockSize", [](const struct stat& sbuf) { return sbuf.st_blksize; });
   }
 
+  Result<uint64_t> GetFreeSpaceBytes(const std::string& path) override {
+    TRACE_EVENT1("io", "PosixEnv::GetFreeSpaceBytes", "path", path);
+    ThreadRestrictions::AssertIOAllowed();
+    struct statvfs buf;
+    if (statvfs(path.c_str(), &buf) != 0) {
+      return STATUS_IO_ERROR(path, errno);
+    }
+    return static_cast<uint64_t>(buf.f_bavail) * buf.f_frsize;
+  }
+
   CHECKED_STATUS LinkFile(const std::string& src,
                           const std::string& target) override {
     if (link(src.c_str(), target.c_str()) != 0) {
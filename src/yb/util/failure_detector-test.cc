@@ -124,4 +124,42 @@ TEST_F(FailureDetectorTest, TestDetectsFailure) {
   monitor_->Shutdown();
 }
 
+// Tests that the suspicion level of the phi accrual detector grows with the time since the last
+// message, relative to the observed intervals between messages.
+TEST_F(FailureDetectorTest, TestPhiAccrual) {
+  scoped_refptr<PhiAccrualFailureDetector> detector(new PhiAccrualFailureDetector(
+      8 /* phi_threshold */, 10 /* window_size */, MonoDelta::FromMilliseconds(10)));
+
+  MonoTime now = MonoTime::Now();
+  ASSERT_OK(detector->Track(kNodeName, now,
+                            Bind(&FailureDetectorTest::FailureFunction, Unretained(this))));
+  ASSERT_NOK(detector->Track(kNodeName, now, FailureDetector::FailureDetectedCallback()));
+  ASSERT_FALSE(detector->FailureTimeout(kNodeName, 1).Initialized());
+
+  for (int i = 0; i < 20; ++i) {
+    now.AddDelta(MonoDelta::FromMilliseconds(kExpectedHeartbeatPeriodMillis + (i % 2) * 10));
+    ASSERT_OK(detector->MessageFrom(kNodeName, now));
+  }
+
+  auto timeout = detector->FailureTimeout(kNodeName, 5);
+  ASSERT_TRUE(timeout.Initialized());
+  ASSERT_GT(timeout.ToMilliseconds(), kExpectedHeartbeatPeriodMillis);
+  ASSERT_LT(timeout.ToMilliseconds(), kExpectedHeartbeatPeriodMillis * kMaxMissedHeartbeats);
+
+  MonoTime soon = now;
+  soon.AddDelta(MonoDelta::FromMilliseconds(kExpectedHeartbeatPeriodMillis / 2));
+  MonoTime late = now;
+  late.AddDelta(MonoDelta::FromMilliseconds(kExpectedHeartbeatPeriodMillis * 2));
+  ASSERT_LT(detector->Phi(kNodeName, soon), 1);
+  ASSERT_GT(detector->Phi(kNodeName, late), 8);
+
+  detector->CheckForFailures(soon);
+  ASSERT_EQ(1, latch_.count());
+  detector->CheckForFailures(late);
+  ASSERT_EQ(0, latch_.count());
+
+  ASSERT_OK(detector->UnTrack(kNodeName));
+  ASSERT_NOK(detector->MessageFrom(kNodeName, late));
+}
+
 }  // namespace yb
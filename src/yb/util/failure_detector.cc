@@ -32,6 +32,9 @@
 
 #include "yb/util/failure_detector.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <mutex>
 #include <unordered_map>
 
@@ -132,6 +135,136 @@ void TimedFailureDetector::CheckForFailures(const MonoTime& now) {
   }
 }
 
+PhiAccrualFailureDetector::PhiAccrualFailureDetector(double phi_threshold,
+                                                     size_t window_size,
+                                                     MonoDelta min_std_dev)
+    : phi_threshold_(phi_threshold),
+      window_size_(window_size),
+      min_std_dev_ms_(min_std_dev.ToMilliseconds()) {}
+
+PhiAccrualFailureDetector::~PhiAccrualFailureDetector() {}
+
+Status PhiAccrualFailureDetector::Track(const string& name,
+                                        const MonoTime& now,
+                                        const FailureDetectedCallback& callback) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  Node node;
+  node.last_heard_of = now;
+  node.callback = callback;
+  if (!nodes_.emplace(name, std::move(node)).second) {
+    return STATUS(AlreadyPresent,
+        Substitute("Node with name '$0' is already being monitored", name));
+  }
+  return Status::OK();
+}
+
+Status PhiAccrualFailureDetector::UnTrack(const string& name) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  if (nodes_.erase(name) == 0) {
+    return STATUS(NotFound, Substitute("Node with name '$0' not found", name));
+  }
+  return Status::OK();
+}
+
+bool PhiAccrualFailureDetector::IsTracking(const std::string& name) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  return ContainsKey(nodes_, name);
+}
+
+Status PhiAccrualFailureDetector::MessageFrom(const std::string& name, const MonoTime& now) {
+  VLOG(3) << "Received message from " << name << " at " << now.ToString();
+  std::lock_guard<simple_spinlock> lock(lock_);
+  auto it = nodes_.find(name);
+  if (it == nodes_.end()) {
+    VLOG(1) << "Not tracking node: " << name;
+    return STATUS(NotFound, Substitute("Message from unknown node '$0'", name));
+  }
+  Node& node = it->second;
+  const double interval = now.GetDeltaSince(node.last_heard_of).ToMilliseconds();
+  node.intervals.push_back(interval);
+  node.sum += interval;
+  node.sum_of_squares += interval * interval;
+  if (node.intervals.size() > window_size_) {
+    const double oldest = node.intervals.front();
+    node.intervals.pop_front();
+    node.sum -= oldest;
+    node.sum_of_squares -= oldest * oldest;
+  }
+  node.last_heard_of = now;
+  node.status = ALIVE;
+  return Status::OK();
+}
+
+double PhiAccrualFailureDetector::PhiUnlocked(const Node& node, double elapsed_ms) const {
+  if (node.intervals.empty()) {
+    return 0;
+  }
+  const double count = node.intervals.size();
+  const double mean = node.sum / count;
+  const double variance = std::max(node.sum_of_squares / count - mean * mean, 0.0);
+  const double std_dev = std::max(std::sqrt(variance), min_std_dev_ms_);
+  // Logistic approximation of the cumulative distribution function of the normal distribution.
+  const double y = (elapsed_ms - mean) / std_dev;
+  const double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+  const double p_later = elapsed_ms > mean ? e / (1.0 + e) : 1.0 - 1.0 / (1.0 + e);
+  return -std::log10(std::max(p_later, std::numeric_limits<double>::min()));
+}
+
+double PhiAccrualFailureDetector::Phi(const std::string& name, const MonoTime& now) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  const Node& node = FindOrDie(nodes_, name);
+  return PhiUnlocked(node, now.GetDeltaSince(node.last_heard_of).ToMilliseconds());
+}
+
+MonoDelta PhiAccrualFailureDetector::FailureTimeout(const std::string& name,
+                                                    size_t min_intervals) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  const Node& node = FindOrDie(nodes_, name);
+  if (node.intervals.size() < std::max<size_t>(min_intervals, 1)) {
+    return MonoDelta();
+  }
+  // Phi grows with the elapsed time, so the timeout is found by bisection.
+  double low = 0;
+  double high = node.sum / node.intervals.size() + min_std_dev_ms_;
+  while (PhiUnlocked(node, high) < phi_threshold_) {
+    low = high;
+    high *= 2;
+  }
+  for (int i = 0; i < 30 && high - low > 1; ++i) {
+    const double middle = (low + high) / 2;
+    if (PhiUnlocked(node, middle) < phi_threshold_) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return MonoDelta::FromMilliseconds(high);
+}
+
+void PhiAccrualFailureDetector::CheckForFailures(const MonoTime& now) {
+  unordered_map<string, FailureDetectedCallback> callbacks;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (auto& entry : nodes_) {
+      Node& node = entry.second;
+      if (PhiUnlocked(node, now.GetDeltaSince(node.last_heard_of).ToMilliseconds()) >
+              phi_threshold_) {
+        node.status = DEAD;
+        InsertOrDie(&callbacks, entry.first, node.callback);
+      }
+    }
+  }
+
+  // Invoke failure callbacks outside of lock.
+  for (const auto& entry : callbacks) {
+    const string& node_name = entry.first;
+    const FailureDetectedCallback& callback = entry.second;
+    if (!callback.is_null()) {
+      callback.Run(node_name, STATUS(RemoteError, Substitute("Node '$0' failed", node_name)));
+    }
+  }
+}
+
 RandomizedFailureMonitor::RandomizedFailureMonitor(uint32_t random_seed,
                                                    int64_t period_mean_millis,
                                                    int64_t period_stddev_millis)
@@ -33,6 +33,7 @@
 #ifndef YB_UTIL_FAILURE_DETECTOR_H_
 #define YB_UTIL_FAILURE_DETECTOR_H_
 
+#include <deque>
 #include <string>
 #include <unordered_map>
 
@@ -135,6 +136,60 @@ class TimedFailureDetector : public FailureDetector {
   DISALLOW_COPY_AND_ASSIGN(TimedFailureDetector);
 };
 
+// A phi accrual failure detector (Hayashibara et al.), which adapts to the observed intervals
+// between messages from a node instead of using a fixed timeout. The suspicion level phi of a node
+// is -log10 of the probability that the next message arrives later than now, assuming normally
+// distributed intervals with the mean and standard deviation of the last window_size intervals.
+// A node is considered dead when phi exceeds phi_threshold.
+class PhiAccrualFailureDetector : public FailureDetector {
+ public:
+  // The standard deviation is at least min_std_dev, so that very regular messages do not make the
+  // detector declare a failure after a slight delay.
+  PhiAccrualFailureDetector(double phi_threshold, size_t window_size, MonoDelta min_std_dev);
+  virtual ~PhiAccrualFailureDetector();
+
+  virtual CHECKED_STATUS Track(const std::string& name,
+                               const MonoTime& now,
+                               const FailureDetectedCallback& callback) override;
+
+  virtual CHECKED_STATUS UnTrack(const std::string& name) override;
+
+  virtual bool IsTracking(const std::string& name) override;
+
+  virtual CHECKED_STATUS MessageFrom(const std::string& name, const MonoTime& now) override;
+
+  virtual void CheckForFailures(const MonoTime& now) override;
+
+  // Returns the suspicion level of the node at now.
+  double Phi(const std::string& name, const MonoTime& now);
+
+  // Returns the time since the last message from the node after which its suspicion level
+  // exceeds the threshold, or an uninitialized MonoDelta when fewer than min_intervals intervals
+  // between messages were observed.
+  MonoDelta FailureTimeout(const std::string& name, size_t min_intervals);
+
+ private:
+  struct Node {
+    MonoTime last_heard_of;
+    FailureDetectedCallback callback;
+    NodeStatus status = ALIVE;
+    // Last intervals between messages in milliseconds, and their sum and sum of squares.
+    std::deque<double> intervals;
+    double sum = 0;
+    double sum_of_squares = 0;
+  };
+
+  double PhiUnlocked(const Node& node, double elapsed_ms) const;
+
+  const double phi_threshold_;
+  const size_t window_size_;
+  const double min_std_dev_ms_;
+  mutable simple_spinlock lock_;
+  std::unordered_map<std::string, Node> nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PhiAccrualFailureDetector);
+};
+
 // A randomized failure monitor that wakes up in normally-distributed intervals
 // and runs CheckForFailures() on each failure detector it monitors.
 //
@@ -460,5 +460,24 @@ TEST(FastVarIntTest, DecodeDescendingSignedCheck) {
   }
 }
 
+TEST(FastVarIntTest, DecodeDescendingSignedBatch) {
+  auto values = GenerateRandomValues<int64_t>(500);
+
+  std::string encoded;
+  for (auto value : values) {
+    FastEncodeDescendingSignedVarInt(value, &encoded);
+  }
+  Slice slice(encoded);
+  std::vector<int64_t> decoded(values.size());
+  ASSERT_OK(FastDecodeDescendingSignedVarInts(&slice, decoded.data(), decoded.size()));
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(values, decoded);
+
+  // On truncated input the slice is left untouched.
+  Slice truncated(encoded.data(), encoded.size() - 1);
+  ASSERT_NOK(FastDecodeDescendingSignedVarInts(&truncated, decoded.data(), decoded.size()));
+  ASSERT_EQ(encoded.size() - 1, truncated.size());
+}
+
 }  // namespace util
 }  // namespace yb
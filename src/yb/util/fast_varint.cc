@@ -250,6 +250,18 @@ Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice) {
   return -temp.first;
 }
 
+Status FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* dest, size_t count) {
+  const uint8_t* p = slice->data();
+  const uint8_t* end = slice->end();
+  for (size_t i = 0; i != count; ++i) {
+    auto temp = VERIFY_RESULT(FastDecodeSignedVarInt(p, end - p));
+    dest[i] = -temp.first;
+    p += temp.second;
+  }
+  slice->remove_prefix(p - slice->data());
+  return Status::OK();
+}
+
 size_t UnsignedVarIntLength(uint64_t v) {
   size_t result = 1;
   v >>= 7;
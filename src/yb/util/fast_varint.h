@@ -65,6 +65,10 @@ inline void FastEncodeDescendingSignedVarInt(int64_t v, std::string *dest) {
 CHECKED_STATUS FastDecodeDescendingSignedVarInt(Slice *slice, int64_t *dest);
 Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice);
 
+// Decode count consecutive "descending VarInts" into dest, e.g. the components of an encoded
+// DocHybridTime. Slice is only advanced when all of them were decoded.
+CHECKED_STATUS FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* dest, size_t count);
+
 size_t UnsignedVarIntLength(uint64_t v);
 void FastAppendUnsignedVarIntToStr(uint64_t v, std::string* dest);
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size);
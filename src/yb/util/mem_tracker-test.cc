@@ -46,6 +46,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_consumption_batch_bytes);
 
 namespace yb {
 
@@ -129,6 +130,44 @@ TEST(MemTrackerTest, TrackerHierarchy) {
   c2->Release(60);
 }
 
+TEST(MemTrackerTest, BatchedConsumption) {
+  google::FlagSaver saver;
+  FLAGS_mem_tracker_consumption_batch_bytes = 100;
+
+  shared_ptr<MemTracker> p = MemTracker::CreateTracker(1000, "p");
+  {
+    shared_ptr<MemTracker> c = MemTracker::CreateTracker("c", p);
+
+    // Small deltas stay pending in the child, but are visible in its own consumption.
+    c->Consume(60);
+    EXPECT_EQ(c->consumption(), 60);
+    EXPECT_EQ(p->consumption(), 0);
+
+    // Once the pending delta reaches the batch size, it is propagated to the parent.
+    c->Consume(60);
+    EXPECT_EQ(c->consumption(), 120);
+    EXPECT_EQ(p->consumption(), 120);
+
+    // TryConsume propagates the pending delta of the current thread before checking limits.
+    c->Release(50);
+    EXPECT_EQ(p->consumption(), 120);
+    EXPECT_FALSE(c->TryConsume(950));
+    EXPECT_EQ(p->consumption(), 70);
+    EXPECT_TRUE(c->TryConsume(900));
+    EXPECT_EQ(c->consumption(), 970);
+    EXPECT_EQ(p->consumption(), 970);
+
+    c->Release(940);
+    EXPECT_EQ(c->consumption(), 30);
+    c->Release(10);
+    EXPECT_EQ(c->consumption(), 20);
+    EXPECT_EQ(p->consumption(), 30);
+    c->Release(20);
+  }
+  // Destroying the child propagates what is still pending.
+  EXPECT_EQ(p->consumption(), 0);
+}
+
 namespace {
 
 class GcTest : public GarbageCollector {
@@ -33,11 +33,13 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 #ifdef TCMALLOC_ENABLED
 #include <gperftools/malloc_extension.h>
@@ -102,6 +104,15 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_consumption_batch_bytes, 0,
+             "If positive, consumption and release of non-root memory trackers are accumulated "
+             "per thread stripe and propagated to the tracker and its ancestors once the "
+             "accumulated delta of a stripe reaches this number of bytes. Limit checks could then "
+             "miss up to this many bytes per stripe of every descendant tracker. 0 updates the "
+             "whole hierarchy on every call.");
+TAG_FLAG(mem_tracker_consumption_batch_bytes, advanced);
+TAG_FLAG(mem_tracker_consumption_batch_bytes, runtime);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -146,6 +157,11 @@ bool dummy[] __attribute__((unused)) = {
 #endif
 };
 
+size_t PendingConsumptionStripeIndex() {
+  static thread_local size_t index = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return index;
+}
+
 template <class TrackerMetrics>
 bool TryIncrementBy(int64_t delta, int64_t max, HighWaterMark* consumption,
                     const std::unique_ptr<TrackerMetrics>& metrics) {
@@ -320,6 +336,7 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTrack
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
   if (parent_) {
+    FlushPendingConsumption();
     DCHECK_EQ(consumption(), 0) << "Memory tracker " << ToString();
     if (add_to_parent_) {
       parent_->Release(consumption());
@@ -455,6 +472,9 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  if (BatchConsumption(bytes)) {
+    return;
+  }
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
       IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
@@ -463,6 +483,50 @@ void MemTracker::Consume(int64_t bytes) {
   }
 }
 
+bool MemTracker::BatchConsumption(int64_t bytes) {
+  const auto batch_bytes = GetAtomicFlag(&FLAGS_mem_tracker_consumption_batch_bytes);
+  if (batch_bytes <= 0 || !parent_) {
+    return false;
+  }
+  auto& pending = pending_consumption_[
+      PendingConsumptionStripeIndex() % kNumPendingConsumptionStripes].value;
+  const auto new_pending = pending.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (std::abs(new_pending) >= batch_bytes) {
+    PropagateConsumption(pending.exchange(0, std::memory_order_relaxed));
+  }
+  return true;
+}
+
+void MemTracker::PropagateConsumption(int64_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  // Stripes are propagated independently, so a tracker could temporarily observe the release
+  // of memory whose consumption is still pending in another stripe. Hence no DCHECK on the
+  // resulting consumption here.
+  for (auto& tracker : all_trackers_) {
+    if (!tracker->UpdateConsumption()) {
+      IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
+    }
+  }
+}
+
+void MemTracker::FlushPendingConsumption() {
+  int64_t bytes = 0;
+  for (auto& stripe : pending_consumption_) {
+    bytes += stripe.value.exchange(0, std::memory_order_relaxed);
+  }
+  PropagateConsumption(bytes);
+}
+
+int64_t MemTracker::PendingConsumption() const {
+  int64_t result = 0;
+  for (const auto& stripe : pending_consumption_) {
+    result += stripe.value.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
 bool MemTracker::TryConsume(int64_t bytes) {
   UpdateConsumption();
   if (bytes <= 0) {
@@ -471,6 +535,11 @@ bool MemTracker::TryConsume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  // Limits are checked against propagated consumption, so bring in what this thread has
+  // accumulated. Other stripes could still hide up to mem_tracker_consumption_batch_bytes each.
+  PropagateConsumption(pending_consumption_[
+      PendingConsumptionStripeIndex() % kNumPendingConsumptionStripes].value.exchange(
+          0, std::memory_order_relaxed));
 
   int i = 0;
   // Walk the tracker tree top-down, to avoid expanding a limit on a child whose parent
@@ -536,6 +605,10 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
+  if (BatchConsumption(-bytes)) {
+    return;
+  }
+
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
       IncrementBy(-bytes, &tracker->consumption_, tracker->metrics_);
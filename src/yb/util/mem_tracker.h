@@ -34,6 +34,8 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -46,6 +48,7 @@
 
 #include <boost/optional.hpp>
 
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/high_water_mark.h"
 #include "yb/util/locks.h"
@@ -293,7 +296,7 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   // Returns the memory consumed in bytes.
   int64_t consumption() const {
-    return consumption_.current_value();
+    return consumption_.current_value() + PendingConsumption();
   }
 
   int64_t GetUpdatedConsumption() {
@@ -353,6 +356,20 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Logs the stack of the current consume/release. Used for debugging only.
   void LogUpdate(bool is_consume, int64_t bytes) const;
 
+  // Adds bytes to the pending consumption of the current thread's stripe, see
+  // mem_tracker_consumption_batch_bytes. Returns false when batching does not apply to this
+  // tracker, so the caller should update the hierarchy itself.
+  bool BatchConsumption(int64_t bytes);
+
+  // Adds bytes to the consumption of this tracker and all of its ancestors.
+  void PropagateConsumption(int64_t bytes);
+
+  // Propagates the pending consumption of all stripes.
+  void FlushPendingConsumption();
+
+  // Returns the consumption accumulated in stripes but not propagated yet.
+  int64_t PendingConsumption() const;
+
   // Variant of CreateTracker() that:
   // 1. Must be called with a non-NULL parent, and
   // 2. Must be called with parent->child_trackers_lock_ held.
@@ -390,6 +407,15 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Consumption accumulated by Consume() and Release() but not propagated to consumption_ and
+  // the ancestors yet. Threads are spread across stripes, each in its own cache line.
+  static constexpr size_t kNumPendingConsumptionStripes = 8;
+  struct PendingConsumptionStripe {
+    std::atomic<int64_t> value{0};
+    char padding[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  };
+  std::array<PendingConsumptionStripe, kNumPendingConsumptionStripes> pending_consumption_;
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
@@ -0,0 +1,71 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+#include <vector>
+
+#include "yb/util/test_util.h"
+
+#include "yb/util/memory/size_class_pool.h"
+
+namespace yb {
+
+class SizeClassPoolTest : public YBTest {
+};
+
+TEST_F(SizeClassPoolTest, Recycle) {
+  constexpr int kIterations = 1000;
+
+  auto& pool = SizeClassPool::Instance();
+  auto hits_before = pool.hits();
+  for (int i = 0; i != kIterations; ++i) {
+    // Sizes of the same class.
+    size_t size = 100 + i % 20;
+    auto* block = static_cast<char*>(pool.Allocate(size));
+    ASSERT_NE(block, nullptr);
+    memset(block, i, size);
+    pool.Free(block, size);
+  }
+  // The thread could migrate to another CPU, so not every allocation is a hit.
+  ASSERT_GE(pool.hits() - hits_before, kIterations / 2);
+
+  // Blocks bigger than the biggest size class are not pooled.
+  hits_before = pool.hits();
+  auto misses_before = pool.misses();
+  auto* block = pool.Allocate(SizeClassPool::kMaxBlockSize + 1);
+  pool.Free(block, SizeClassPool::kMaxBlockSize + 1);
+  ASSERT_EQ(hits_before, pool.hits());
+  ASSERT_EQ(misses_before, pool.misses());
+}
+
+TEST_F(SizeClassPoolTest, FreeByOtherThread) {
+  constexpr size_t kVectors = 100;
+
+  std::vector<std::vector<char, SizeClassAllocator<char>>> vectors(kVectors);
+  for (size_t i = 0; i != kVectors; ++i) {
+    vectors[i].assign(i * 100, static_cast<char>(i));
+  }
+
+  std::thread thread([&vectors] {
+    for (size_t i = 0; i != kVectors; ++i) {
+      ASSERT_EQ(i * 100, vectors[i].size());
+      for (auto c : vectors[i]) {
+        ASSERT_EQ(static_cast<char>(i), c);
+      }
+    }
+    vectors.clear();
+  });
+  thread.join();
+}
+
+} // namespace yb
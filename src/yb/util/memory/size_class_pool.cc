@@ -0,0 +1,110 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/memory/size_class_pool.h"
+
+#include <glog/logging.h>
+
+#include "yb/gutil/bind.h"
+#include "yb/gutil/bits.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_bool(use_size_class_pool, true,
+            "Whether RPC buffers and calls are allocated from the pool of size classes with "
+            "per CPU free lists, instead of malloc.");
+TAG_FLAG(use_size_class_pool, advanced);
+
+METRIC_DEFINE_gauge_uint64(server, size_class_pool_hits,
+    "Size Class Pool Hits", yb::MetricUnit::kCacheHits,
+    "Number of allocations of RPC buffers and calls, that reused a cached block.");
+
+METRIC_DEFINE_gauge_uint64(server, size_class_pool_misses,
+    "Size Class Pool Misses", yb::MetricUnit::kCacheQueries,
+    "Number of allocations of RPC buffers and calls, that had to allocate a new block "
+    "from malloc.");
+
+namespace yb {
+
+namespace {
+
+uint64_t GetSizeClassPoolHits() {
+  return SizeClassPool::Instance().hits();
+}
+
+uint64_t GetSizeClassPoolMisses() {
+  return SizeClassPool::Instance().misses();
+}
+
+} // namespace
+
+SizeClassPool& SizeClassPool::Instance() {
+  // Never destroyed, since blocks could be freed by static objects after exit.
+  static SizeClassPool* instance = new SizeClassPool;
+  return *instance;
+}
+
+SizeClassPool::SizeClassPool() {
+  if (!FLAGS_use_size_class_pool) {
+    return;
+  }
+  for (size_t i = 0; i != kNumClasses; ++i) {
+    size_t block_size = kMinBlockSize << i;
+    pools_[i] = std::make_unique<ThreadSafeObjectPool<char>>(
+        [this, block_size] {
+          misses_.fetch_add(1, std::memory_order_relaxed);
+          return static_cast<char*>(malloc(block_size));
+        },
+        [](char* block) { free(block); });
+  }
+}
+
+size_t SizeClassPool::SizeClass(size_t size) {
+  if (size <= kMinBlockSize) {
+    return 0;
+  }
+  if (size > kMaxBlockSize) {
+    return kNumClasses;
+  }
+  return Bits::Log2Ceiling64(size) - kMinBlockSizeLog;
+}
+
+void* SizeClassPool::Allocate(size_t size) {
+  auto size_class = SizeClass(size);
+  if (size_class == kNumClasses || !pools_[size_class]) {
+    return malloc(size);
+  }
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  return pools_[size_class]->Take();
+}
+
+void SizeClassPool::Free(void* block, size_t size) {
+  auto size_class = SizeClass(size);
+  if (size_class == kNumClasses || !pools_[size_class]) {
+    free(block);
+    return;
+  }
+  pools_[size_class]->Release(static_cast<char*>(block));
+}
+
+void RegisterSizeClassPoolMetrics(const scoped_refptr<MetricEntity>& entity) {
+  entity->NeverRetire(
+      METRIC_size_class_pool_hits.InstantiateFunctionGauge(
+          entity, Bind(&GetSizeClassPoolHits)));
+  entity->NeverRetire(
+      METRIC_size_class_pool_misses.InstantiateFunctionGauge(
+          entity, Bind(&GetSizeClassPoolMisses)));
+}
+
+} // namespace yb
@@ -0,0 +1,115 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_MEMORY_SIZE_CLASS_POOL_H
+#define YB_UTIL_MEMORY_SIZE_CLASS_POOL_H
+
+#include <stdlib.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/object_pool.h"
+
+namespace yb {
+
+class MetricEntity;
+
+// Allocator of short living memory blocks, like RPC buffers and calls, that are frequently
+// allocated by one thread and freed by another.
+//
+// Sizes are rounded up to a power of two size class, from kMinBlockSize to kMaxBlockSize.
+// Freed blocks of every class are cached in per CPU free lists of ThreadSafeObjectPool, so most
+// allocations do not touch the shared state of malloc. Bigger blocks are passed to malloc as is.
+//
+// Freed blocks of a size class should be returned with the same size that was used to
+// allocate them.
+class SizeClassPool {
+ public:
+  static constexpr size_t kMinBlockSizeLog = 6;
+  static constexpr size_t kMaxBlockSizeLog = 14;
+  static constexpr size_t kMinBlockSize = 1ULL << kMinBlockSizeLog;
+  static constexpr size_t kMaxBlockSize = 1ULL << kMaxBlockSizeLog;
+
+  static SizeClassPool& Instance();
+
+  void* Allocate(size_t size);
+  void Free(void* block, size_t size);
+
+  // Number of allocations served from the cached blocks.
+  uint64_t hits() const {
+    return allocations_.load(std::memory_order_relaxed) - misses();
+  }
+
+  // Number of allocations in the pooled size classes, that had to allocate a new block.
+  uint64_t misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  SizeClassPool();
+
+  static constexpr size_t kNumClasses = kMaxBlockSizeLog - kMinBlockSizeLog + 1;
+
+  // Returns size class for the given size, or kNumClasses when block is too big to be pooled.
+  static size_t SizeClass(size_t size);
+
+  // Null when the pool is disabled by --use_size_class_pool.
+  std::array<std::unique_ptr<ThreadSafeObjectPool<char>>, kNumClasses> pools_;
+
+  std::atomic<uint64_t> allocations_{0};
+  std::atomic<uint64_t> misses_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(SizeClassPool);
+};
+
+// STL-compliant allocator, that allocates memory from SizeClassPool.
+template <class T>
+class SizeClassAllocator {
+ public:
+  typedef T value_type;
+
+  SizeClassAllocator() = default;
+
+  template <class U>
+  SizeClassAllocator(const SizeClassAllocator<U>&) {} // NOLINT
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(SizeClassPool::Instance().Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    SizeClassPool::Instance().Free(p, n * sizeof(T));
+  }
+};
+
+template <class T, class U>
+bool operator==(const SizeClassAllocator<T>&, const SizeClassAllocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const SizeClassAllocator<T>&, const SizeClassAllocator<U>&) {
+  return false;
+}
+
+// Register metrics in the given server entity which report hit and miss counts of SizeClassPool.
+void RegisterSizeClassPoolMetrics(const scoped_refptr<MetricEntity>& entity);
+
+} // namespace yb
+
+#endif // YB_UTIL_MEMORY_SIZE_CLASS_POOL_H
@@ -34,12 +34,14 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
 #include "yb/gutil/bind.h"
 #include "yb/gutil/map-util.h"
 #include "yb/util/hdr_histogram.h"
+#include "yb/util/histogram.pb.h"
 #include "yb/util/jsonreader.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/metrics.h"
@@ -173,14 +175,78 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
   hist->Increment(2);
   hist->IncrementBy(4, 1);
-  ASSERT_EQ(2, hist->histogram_->MinValue());
-  ASSERT_EQ(3, hist->histogram_->MeanValue());
-  ASSERT_EQ(4, hist->histogram_->MaxValue());
-  ASSERT_EQ(2, hist->histogram_->TotalCount());
-  ASSERT_EQ(6, hist->histogram_->TotalSum());
+  auto snapshot = hist->MergedSnapshot();
+  ASSERT_EQ(2, snapshot->MinValue());
+  ASSERT_EQ(3, snapshot->MeanValue());
+  ASSERT_EQ(4, snapshot->MaxValue());
+  ASSERT_EQ(2, snapshot->TotalCount());
+  ASSERT_EQ(6, snapshot->TotalSum());
   // TODO: Test coverage needs to be improved a lot.
 }
 
+TEST_F(MetricsTest, StripedHistogramTest) {
+  scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
+  constexpr int kThreads = 8;
+  constexpr int kValuesPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kThreads; ++i) {
+    threads.emplace_back([hist, i] {
+      for (int j = 1; j <= kValuesPerThread; ++j) {
+        hist->Increment(i * kValuesPerThread + j);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kThreads * kValuesPerThread, hist->TotalCount());
+  ASSERT_EQ(1, hist->MinValueForTests());
+  ASSERT_EQ(kThreads * kValuesPerThread, hist->MaxValueForTests());
+  HistogramSnapshotPB snapshot;
+  ASSERT_OK(hist->GetHistogramSnapshotPB(&snapshot, MetricJsonOptions()));
+  ASSERT_EQ(kThreads * kValuesPerThread, snapshot.total_count());
+  const int64_t n = kThreads * kValuesPerThread;
+  ASSERT_EQ(n * (n + 1) / 2, snapshot.total_sum());
+}
+
+namespace {
+
+std::string WritePrometheusTabletMetrics(const MetricPrometheusOptions& opts) {
+  std::stringstream out;
+  PrometheusWriter writer(&out, opts);
+  for (int i = 0; i != 4; ++i) {
+    MetricEntity::AttributeMap attr;
+    attr["table_id"] = i < 3 ? "t1" : "t2";
+    attr["metric_id"] = "tablet-" + std::to_string(i);
+    EXPECT_OK(writer.WriteSingleEntry(attr, "rows_inserted", i + 1));
+    EXPECT_OK(writer.WriteSingleEntry(attr, "rows_deleted", 1));
+  }
+  EXPECT_OK(writer.FlushAggregatedValues());
+  return out.str();
+}
+
+} // namespace
+
+TEST_F(MetricsTest, PrometheusAggregationTest) {
+  MetricPrometheusOptions opts;
+  auto out = WritePrometheusTabletMetrics(opts);
+  ASSERT_STR_CONTAINS(out, "rows_inserted{table_id=\"t1\"} 6 ");
+  ASSERT_STR_CONTAINS(out, "rows_inserted{table_id=\"t2\"} 4 ");
+  ASSERT_EQ(std::string::npos, out.find("tablet-"));
+
+  opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kServer;
+  out = WritePrometheusTabletMetrics(opts);
+  ASSERT_STR_CONTAINS(out, "rows_inserted 10 ");
+  ASSERT_STR_CONTAINS(out, "rows_deleted 4 ");
+
+  opts.tablet_aggregation = MetricPrometheusOptions::Aggregation::kTablet;
+  opts.requested_metrics = {"inserted"};
+  out = WritePrometheusTabletMetrics(opts);
+  ASSERT_STR_CONTAINS(out, "metric_id=\"tablet-3\"");
+  ASSERT_EQ(std::string::npos, out.find("rows_deleted"));
+}
+
 TEST_F(MetricsTest, JsonPrintTest) {
   scoped_refptr<Counter> bytes_seen = METRIC_reqs_pending.Instantiate(entity_);
   bytes_seen->Increment();
@@ -31,10 +31,12 @@
 //
 #include "yb/util/metrics.h"
 
+#include <chrono>
 #include <iostream>
 #include <map>
 #include <regex>
 #include <set>
+#include <thread>
 
 #include <gflags/gflags.h>
 
@@ -44,6 +46,7 @@
 #include "yb/gutil/singleton.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/sysinfo.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/histogram.pb.h"
@@ -57,6 +60,14 @@ DEFINE_int32(metrics_retirement_age_ms, 120 * 1000,
 TAG_FLAG(metrics_retirement_age_ms, runtime);
 TAG_FLAG(metrics_retirement_age_ms, advanced);
 
+DEFINE_int32(metrics_histogram_stripes, 8,
+             "Number of per-CPU stripes that histogram metrics record values into, so that "
+             "threads on different CPUs do not contend on the same counters. Stripes are merged "
+             "when the histogram is read. Each used stripe costs a copy of the histogram "
+             "buckets. Only affects histograms created after the change.");
+TAG_FLAG(metrics_histogram_stripes, advanced);
+TAG_FLAG(metrics_histogram_stripes, runtime);
+
 // TODO: changed to empty string and add logic to get this from cluster_uuid in case empty.
 DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
               "Value to use as node name for metrics reporting");
@@ -217,6 +228,54 @@ bool MatchMetricInList(const string& metric_name,
 
 } // anonymous namespace
 
+/////////////////////////////////////////////////
+// PrometheusWriter
+/////////////////////////////////////////////////
+
+PrometheusWriter::PrometheusWriter(std::ostream* output, const MetricPrometheusOptions& opts)
+    : opts_(opts),
+      output_(output),
+      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()) {}
+
+bool PrometheusWriter::ShouldWriteEntityType(const char* entity_type) const {
+  if (opts_.entity_types.empty()) {
+    return true;
+  }
+  for (const auto& type : opts_.entity_types) {
+    if (type == entity_type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PrometheusWriter::ShouldWriteMetric(const string& name) const {
+  return MatchMetricInList(name, opts_.requested_metrics);
+}
+
+MetricEntity::AttributeMap PrometheusWriter::AggregatedAttributes(
+    const MetricEntity::AttributeMap& attr) const {
+  auto result = attr;
+  result.erase("metric_id");
+  result.erase("partition");
+  if (opts_.tablet_aggregation == MetricPrometheusOptions::Aggregation::kServer) {
+    result.erase("table_id");
+    result.erase("table_name");
+  }
+  return result;
+}
+
+Status PrometheusWriter::FlushAggregatedValues() {
+  for (const auto& entry : aggregated_) {
+    for (const auto& metric_entry : entry.second.values) {
+      RETURN_NOT_OK(FlushSingleEntry(
+          entry.second.attributes, metric_entry.first, metric_entry.second));
+    }
+  }
+  aggregated_.clear();
+  return Status::OK();
+}
 
 Status MetricEntity::WriteAsJson(JsonWriter* writer,
                                  const vector<string>& requested_metrics,
@@ -285,6 +344,10 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
+  if (!writer->ShouldWriteEntityType(prototype_->name())) {
+    return Status::OK();
+  }
+
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
   typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
   OrderedMetricMap metrics;
@@ -300,15 +363,18 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
       const MetricPrototype* prototype = val.first;
       const scoped_refptr<Metric>& metric = val.second;
 
-      InsertOrDie(&metrics, prototype->name(), metric);
+      if (writer->ShouldWriteMetric(prototype->name())) {
+        InsertOrDie(&metrics, prototype->name(), metric);
+      }
     }
   }
   AttributeMap prometheus_attr;
   // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
-  // We ignore the tablet part to squash at the table level.
+  // The writer drops the tablet part when it squashes them at the table or server level.
   if (strcmp(prototype_->name(), "tablet") == 0)  {
     prometheus_attr["table_id"] = attrs["table_id"];
     prometheus_attr["table_name"] = attrs["table_name"];
+    prometheus_attr["metric_id"] = id_;
   } else if (strcmp(prototype_->name(), "server") == 0 ||
       strcmp(prototype_->name(), "cluster") == 0) {
     prometheus_attr = attrs;
@@ -328,7 +394,7 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   }
   // Run the external metrics collection callback if there is one set.
   for (const ExternalPrometheusMetricsCb& cb : external_metrics_cbs) {
-    cb(writer);
+    cb(writer, prometheus_attr);
   }
 
   return Status::OK();
@@ -725,15 +791,61 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    extra_stripes_(std::min(std::max(FLAGS_metrics_histogram_stripes, 1), base::NumCPUs()) - 1) {
+}
+
+Histogram::~Histogram() {
+  for (auto& stripe : extra_stripes_) {
+    delete stripe.load(std::memory_order_acquire);
+  }
+}
+
+HdrHistogram* Histogram::CurrentStripe() {
+  if (extra_stripes_.empty()) {
+    return histogram_.get();
+  }
+#if defined(__APPLE__)
+  // OSX doesn't have a way to get the CPU, so we'll pick a stripe based on the thread.
+  static thread_local size_t cpu = std::hash<std::thread::id>()(std::this_thread::get_id());
+#else
+  size_t cpu = sched_getcpu();
+#endif // defined(__APPLE__)
+  size_t index = cpu % (extra_stripes_.size() + 1);
+  if (index == 0) {
+    return histogram_.get();
+  }
+  auto& stripe = extra_stripes_[index - 1];
+  auto* result = stripe.load(std::memory_order_acquire);
+  if (PREDICT_FALSE(!result)) {
+    auto* created = new HdrHistogram(
+        histogram_->highest_trackable_value(), histogram_->num_significant_digits());
+    if (stripe.compare_exchange_strong(result, created, std::memory_order_acq_rel)) {
+      result = created;
+    } else {
+      delete created;
+    }
+  }
+  return result;
+}
+
+std::unique_ptr<HdrHistogram> Histogram::MergedSnapshot() const {
+  auto result = std::make_unique<HdrHistogram>(*histogram_);
+  for (const auto& stripe : extra_stripes_) {
+    auto* histogram = stripe.load(std::memory_order_acquire);
+    if (histogram) {
+      result->MergeFrom(*histogram);
+    }
+  }
+  return result;
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  CurrentStripe()->Increment(value);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  CurrentStripe()->IncrementBy(value, amount);
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -747,7 +859,8 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
+  auto merged = MergedSnapshot();
+  const HdrHistogram& snapshot = *merged;
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -780,7 +893,8 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  auto merged = MergedSnapshot();
+  const HdrHistogram& snapshot = *merged;
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -814,22 +928,29 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return MergedSnapshot()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  uint64_t result = histogram_->TotalCount();
+  for (const auto& stripe : extra_stripes_) {
+    auto* histogram = stripe.load(std::memory_order_acquire);
+    if (histogram) {
+      result += histogram->TotalCount();
+    }
+  }
+  return result;
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return MergedSnapshot()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return MergedSnapshot()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return MergedSnapshot()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(
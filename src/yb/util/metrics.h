@@ -239,6 +239,9 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -441,6 +444,27 @@ struct MetricJsonOptions {
   bool include_schema_info;
 };
 
+struct MetricPrometheusOptions {
+  // Level at which metrics of tablet entities are rolled up. Each level exports one time series
+  // per metric and tablet, table or server respectively.
+  enum class Aggregation {
+    kTablet,
+    kTable,
+    kServer,
+  };
+
+  // Default: kTable
+  Aggregation tablet_aggregation = Aggregation::kTable;
+
+  // Types of the entities whose metrics are exported, e.g. "tablet" or "server".
+  // Default: empty, i.e. all types
+  std::vector<std::string> entity_types;
+
+  // Metrics to export, matched the same way as by MetricRegistry::WriteAsJson.
+  // Default: all metrics
+  std::vector<std::string> requested_metrics = {"*"};
+};
+
 class MetricEntityPrototype {
  public:
   explicit MetricEntityPrototype(const char* name);
@@ -474,7 +498,7 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
   typedef std::unordered_map<std::string, std::string> AttributeMap;
   typedef std::function<void (JsonWriter* writer, const MetricJsonOptions& opts)>
     ExternalJsonMetricsCb;
-  typedef std::function<void (PrometheusWriter* writer)>
+  typedef std::function<void (PrometheusWriter* writer, const AttributeMap& attr)>
     ExternalPrometheusMetricsCb;
 
   scoped_refptr<Counter> FindOrCreateCounter(const CounterPrototype* proto);
@@ -581,44 +605,58 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
 typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
+// Writes metrics in the Prometheus text format. Time series that are not rolled up are written to
+// the output as soon as they are produced, so only the rolled up values are kept in memory, at
+// most one per metric and table.
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
-    : output_(output),
-      timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
-          std::chrono::system_clock::now().time_since_epoch()).count()) {}
+  explicit PrometheusWriter(std::ostream* output,
+                            const MetricPrometheusOptions& opts = MetricPrometheusOptions());
+
+  const MetricPrometheusOptions& options() const { return opts_; }
+
+  // Whether metrics of the given entity type should be written.
+  bool ShouldWriteEntityType(const char* entity_type) const;
+
+  // Whether the metric with the given name should be written.
+  bool ShouldWriteMetric(const std::string& name) const;
 
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
+    if (!ShouldWriteMetric(name)) {
+      return Status::OK();
+    }
     auto it = attr.find("table_id");
-    if (it != attr.end()) {
-      // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
-        // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
-      }
-    } else {
-      // For non-tablet level metrics, export them directly.
-      RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
+    if (it == attr.end() ||
+        opts_.tablet_aggregation == MetricPrometheusOptions::Aggregation::kTablet) {
+      // Non-tablet level metrics, or tablet metrics that are not rolled up, are exported directly.
+      return FlushSingleEntry(attr, name, value);
     }
-    return Status::OK();
-  }
-
-  CHECKED_STATUS FlushAggregatedValues() {
-    for (const auto& entry : per_table_values_) {
-      const auto& attrs = per_table_attributes_[entry.first];
-      for (const auto& metric_entry : entry.second) {
-        RETURN_NOT_OK(FlushSingleEntry(attrs, metric_entry.first, metric_entry.second));
-      }
+    // For tablet level metrics, we roll up on the table or server level.
+    auto& aggregated = aggregated_[
+        opts_.tablet_aggregation == MetricPrometheusOptions::Aggregation::kTable
+            ? it->second : std::string()];
+    if (aggregated.attributes.empty()) {
+      // If it's the first time we see this table, pick the attributes of the aggregate.
+      aggregated.attributes = AggregatedAttributes(attr);
     }
+    aggregated.values[name] += value;
     return Status::OK();
   }
 
+  CHECKED_STATUS FlushAggregatedValues();
+
  private:
+  struct Aggregated {
+    MetricEntity::AttributeMap attributes;
+    // Map from metric name to value.
+    std::map<std::string, double> values;
+  };
+
+  // Drops the attributes that differ between the tablets rolled up into one time series.
+  MetricEntity::AttributeMap AggregatedAttributes(const MetricEntity::AttributeMap& attr) const;
+
   template<typename T>
   CHECKED_STATUS FlushSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
@@ -636,22 +674,19 @@ class PrometheusWriter {
     }
     *output_ << " " << value;
     *output_ << " " << timestamp_;
-    *output_ << std::endl;
+    *output_ << "\n";
     return Status::OK();
   }
 
-  // Map from table_id to attributes
-  std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
-  // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  const MetricPrometheusOptions opts_;
+  // Map from table_id, or empty string for the server level, to the rolled up values.
+  std::map<std::string, Aggregated> aggregated_;
   // Output stream
-  std::stringstream* output_;
+  std::ostream* output_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
 
-
-
 // Base class to allow for putting all metrics into a single container.
 // See documentation at the top of this file for information on metrics ownership.
 class Metric : public RefCountedThreadSafe<Metric> {
@@ -1133,6 +1168,8 @@ class HistogramPrototype : public MetricPrototype {
 
 class Histogram : public Metric {
  public:
+  virtual ~Histogram();
+
   // Increment the histogram for the given value.
   // 'value' must be non-negative.
   void Increment(int64_t value);
@@ -1165,7 +1202,18 @@ class Histogram : public Metric {
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
 
+  // Returns the stripe that values recorded on the current CPU go to.
+  HdrHistogram* CurrentStripe();
+
+  // Returns the values recorded in all stripes.
+  std::unique_ptr<HdrHistogram> MergedSnapshot() const;
+
+  // The first stripe, always allocated.
   const gscoped_ptr<HdrHistogram> histogram_;
+
+  // The other stripes, see metrics_histogram_stripes. Allocated on first use, so histograms that
+  // are only updated from a few CPUs do not pay for the memory of all stripes.
+  std::vector<std::atomic<HdrHistogram*>> extra_stripes_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -79,24 +79,6 @@ size_t IoVecsFullSize(const IoVecs& io_vecs) {
   });
 }
 
-void IoVecsToBuffer(const IoVecs& io_vecs, size_t begin, size_t end, std::vector<char>* result) {
-  result->clear();
-  result->reserve(end - begin);
-  for (const auto& io_vec : io_vecs) {
-    if (begin == end) {
-      break;
-    }
-    if (io_vec.iov_len > begin) {
-      size_t clen = std::min(io_vec.iov_len, end) - begin;
-      auto start = IoVecBegin(io_vec) + begin;
-      result->insert(result->end(), start, start + clen);
-      begin += clen;
-    }
-    begin -= io_vec.iov_len;
-    end -= io_vec.iov_len;
-  }
-}
-
 Socket::Socket()
   : fd_(-1) {
 }
@@ -33,6 +33,8 @@
 #define YB_UTIL_NET_SOCKET_H
 
 #include <sys/uio.h>
+
+#include <algorithm>
 #include <string>
 
 #include <boost/container/small_vector.hpp>
@@ -50,11 +52,30 @@ class MonoTime;
 typedef boost::container::small_vector<::iovec, 2> IoVecs;
 
 size_t IoVecsFullSize(const IoVecs& io_vecs);
-// begin and end are positions in concatenated io_vecs.
-void IoVecsToBuffer(const IoVecs& io_vecs, size_t begin, size_t end, std::vector<char>* result);
 inline const char* IoVecBegin(const iovec& inp) { return static_cast<const char*>(inp.iov_base); }
 inline const char* IoVecEnd(const iovec& inp) { return IoVecBegin(inp) + inp.iov_len; }
 
+// begin and end are positions in concatenated io_vecs.
+// Container is a vector of chars, possibly with a custom allocator.
+template <class Container>
+void IoVecsToBuffer(const IoVecs& io_vecs, size_t begin, size_t end, Container* result) {
+  result->clear();
+  result->reserve(end - begin);
+  for (const auto& io_vec : io_vecs) {
+    if (begin == end) {
+      break;
+    }
+    if (io_vec.iov_len > begin) {
+      size_t clen = std::min(io_vec.iov_len, end) - begin;
+      auto start = IoVecBegin(io_vec) + begin;
+      result->insert(result->end(), start, start + clen);
+      begin += clen;
+    }
+    begin -= io_vec.iov_len;
+    end -= io_vec.iov_len;
+  }
+}
+
 class Socket {
  public:
   static const int FLAG_NONBLOCKING = 0x1;
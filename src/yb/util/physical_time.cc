@@ -13,6 +13,9 @@
 
 #include "yb/util/physical_time.h"
 
+#include <algorithm>
+#include <atomic>
+
 #if !defined(__APPLE__)
 #include <sys/timex.h>
 #endif
@@ -37,6 +40,12 @@ DEFINE_uint64(max_clock_skew_usec, 50000,
               "Transaction read clock skew in usec. "
               "This is the maximum allowed time delta between servers of a single cluster.");
 
+DEFINE_int32(adjtime_clock_error_refresh_ms, 100,
+             "How often the cached adjtime clock refreshes its error bound from ntp_adjtime(). "
+             "Between refreshes the error bound is widened by the maximum clock frequency error.");
+TAG_FLAG(adjtime_clock_error_refresh_ms, advanced);
+TAG_FLAG(adjtime_clock_error_refresh_ms, runtime);
+
 namespace yb {
 
 namespace {
@@ -115,6 +124,47 @@ class AdjTimeClockImpl : public PhysicalClock {
   }
 };
 
+// Reads the time through clock_gettime(), which is served from the vDSO without entering the
+// kernel, and calls ntp_adjtime() only to refresh the error bound once per
+// adjtime_clock_error_refresh_ms. Between NTP updates the kernel adds the maximum frequency error
+// (MAXFREQ, 500us) to maxerror once per second, so the cached error is widened by that amount for
+// every second boundary that could have passed since the refresh. This way the reported bound is
+// not tighter than the one a fresh ntp_adjtime() call would return, unless the NTP daemon itself
+// increases the error.
+class CachedAdjTimeClockImpl : public PhysicalClock {
+ public:
+  Result<PhysicalTime> Now() override {
+    // Amount added to maxerror by the kernel every second.
+    constexpr MicrosTime kMaxErrorGrowthPerSecUsec = 500;
+    constexpr MicrosTime kMicrosPerSec = 1000000;
+
+    const auto now = static_cast<MicrosTime>(GetCurrentTimeMicros());
+    const auto refresh_interval_usec = static_cast<MicrosTime>(
+        std::max(GetAtomicFlag(&FLAGS_adjtime_clock_error_refresh_ms), 0)) * 1000;
+    auto last_sync = last_sync_.load(std::memory_order_acquire);
+    if (now < last_sync.time_point || now - last_sync.time_point >= refresh_interval_usec) {
+      // Concurrent refreshes are harmless, each of them stores a valid bound.
+      timex tx;
+      RETURN_NOT_OK(CallAdjTime(&tx));
+      last_sync = { now, static_cast<MicrosTime>(tx.maxerror) };
+      last_sync_.store(last_sync, std::memory_order_release);
+    }
+
+    const auto elapsed = now - last_sync.time_point;
+    const auto drift = elapsed == 0
+        ? 0 : (elapsed / kMicrosPerSec + 1) * kMaxErrorGrowthPerSecUsec;
+    return CheckClockSyncError({ now, last_sync.max_error + drift });
+  }
+
+  MicrosTime MaxGlobalTime(PhysicalTime time) override {
+    return time.time_point + GetAtomicFlag(&FLAGS_max_clock_skew_usec);
+  }
+
+ private:
+  // Time of the last error bound refresh and the error reported by ntp_adjtime() at that time.
+  std::atomic<PhysicalTime> last_sync_{{0, 0}};
+};
+
 #endif
 
 } // namespace
@@ -129,6 +179,11 @@ const PhysicalClockPtr& AdjTimeClock() {
   static PhysicalClockPtr instance = std::make_shared<AdjTimeClockImpl>();
   return instance;
 }
+
+const PhysicalClockPtr& CachedAdjTimeClock() {
+  static PhysicalClockPtr instance = std::make_shared<CachedAdjTimeClockImpl>();
+  return instance;
+}
 #endif
 
 Result<PhysicalTime> MockClock::Now() {
@@ -62,6 +62,10 @@ const PhysicalClockPtr& WallClock();
 
 #if !defined(__APPLE__)
 const PhysicalClockPtr& AdjTimeClock();
+
+// Same error bounds as AdjTimeClock, but ntp_adjtime() is called only periodically, so reading
+// the clock does not require a system call.
+const PhysicalClockPtr& CachedAdjTimeClock();
 #endif
 
 } // namespace yb
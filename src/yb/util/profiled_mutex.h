@@ -0,0 +1,60 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_PROFILED_MUTEX_H
+#define YB_UTIL_PROFILED_MUTEX_H
+
+#include <mutex>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/port.h"
+#include "yb/gutil/walltime.h"
+#include "yb/util/spinlock_profiling.h"
+
+namespace yb {
+
+// Wrapper around std::mutex that reports the time spent waiting for a contended lock to the
+// synchronization profiler, the same way contended gutil spinlocks do. So it shows up in the
+// spinlock_contention_time metric, /contention and /pprof/contention.
+//
+// An uncontended lock only costs an extra try_lock, the clock is only read when it fails.
+class ProfiledMutex {
+ public:
+  ProfiledMutex() {}
+
+  void lock() {
+    if (PREDICT_TRUE(mutex_.try_lock())) {
+      return;
+    }
+    int64_t wait_start = CycleClock::Now();
+    mutex_.lock();
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
+  }
+
+  void unlock() {
+    mutex_.unlock();
+  }
+
+  bool try_lock() {
+    return mutex_.try_lock();
+  }
+
+ private:
+  std::mutex mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProfiledMutex);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_PROFILED_MUTEX_H
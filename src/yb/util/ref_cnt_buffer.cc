@@ -18,6 +18,7 @@
 #include "yb/util/ref_cnt_buffer.h"
 
 #include "yb/util/faststring.h"
+#include "yb/util/memory/size_class_pool.h"
 
 namespace yb {
 
@@ -26,14 +27,16 @@ RefCntBuffer::RefCntBuffer()
 }
 
 RefCntBuffer::RefCntBuffer(size_t size)
-    : data_(static_cast<char*>(malloc(size + sizeof(CounterType) + sizeof(size_t)))) {
+    : data_(static_cast<char*>(
+          SizeClassPool::Instance().Allocate(size + sizeof(CounterType) + sizeof(size_t)))) {
   CHECK(data_ != nullptr);
   size_reference() = size;
   new (&counter_reference()) CounterType(1);
 }
 
 RefCntBuffer::RefCntBuffer(const char *data, size_t size)
-    : data_(static_cast<char *>(malloc(size + sizeof(CounterType) + sizeof(size_t)))) {
+    : data_(static_cast<char *>(
+          SizeClassPool::Instance().Allocate(size + sizeof(CounterType) + sizeof(size_t)))) {
   CHECK(data_ != nullptr);
   memcpy(this->data(), data, size);
   size_reference() = size;
@@ -75,7 +78,7 @@ void RefCntBuffer::DoReset(char* data) {
   if (data_ != nullptr) {
     if (--counter_reference() == 0) {
       counter_reference().~CounterType();
-      free(data_);
+      SizeClassPool::Instance().Free(data_, size() + sizeof(CounterType) + sizeof(size_t));
     }
   }
   data_ = data;
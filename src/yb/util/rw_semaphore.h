@@ -38,7 +38,9 @@
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/macros.h"
 #include "yb/gutil/port.h"
+#include "yb/gutil/walltime.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/spinlock_profiling.h"
 
 #include "yb/util/thread.h"
 
@@ -72,6 +74,7 @@ class rw_semaphore {
 
   void lock_shared() {
     int loop_count = 0;
+    int64_t wait_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect no write lock
@@ -80,8 +83,10 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartWait(&wait_start);
       boost::detail::yield(loop_count++);
     }
+    SubmitWait(wait_start);
   }
 
   void unlock_shared() {
@@ -119,13 +124,16 @@ class rw_semaphore {
       boost::detail::yield(loop_count++);
     }
 
-    WaitPendingReaders();
+    int64_t wait_start = 0;
+    WaitPendingReaders(&wait_start);
+    SubmitWait(wait_start);
     RecordLockHolderStack();
     return true;
   }
 
   void lock() {
     int loop_count = 0;
+    int64_t wait_start = 0;
     Atomic32 cur_state = base::subtle::NoBarrier_Load(&state_);
     while (true) {
       Atomic32 expected = cur_state & kNumReadersMask;   // I expect some 0+ readers
@@ -136,10 +144,12 @@ class rw_semaphore {
       if (cur_state == expected)
         break;
       // Either was already locked by someone else, or CAS failed.
+      StartWait(&wait_start);
       boost::detail::yield(loop_count++);
     }
 
-    WaitPendingReaders();
+    WaitPendingReaders(&wait_start);
+    SubmitWait(wait_start);
 
 #ifndef NDEBUG
     writer_tid_ = Thread::CurrentThreadId();
@@ -192,13 +202,28 @@ class rw_semaphore {
   }
 #endif
 
-  void WaitPendingReaders() {
+  void WaitPendingReaders(int64_t* wait_start) {
     int loop_count = 0;
     while ((base::subtle::Acquire_Load(&state_) & kNumReadersMask) > 0) {
+      StartWait(wait_start);
       boost::detail::yield(loop_count++);
     }
   }
 
+  // The clock is only read once the lock turns out to be contended, so uncontended acquisitions
+  // are not slowed down by the contention profiling.
+  static void StartWait(int64_t* wait_start) {
+    if (*wait_start == 0) {
+      *wait_start = CycleClock::Now();
+    }
+  }
+
+  void SubmitWait(int64_t wait_start) const {
+    if (PREDICT_FALSE(wait_start != 0)) {
+      SubmitLockContention(this, CycleClock::Now() - wait_start);
+    }
+  }
+
  private:
   volatile Atomic32 state_;
 #ifndef NDEBUG
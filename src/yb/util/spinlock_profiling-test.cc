@@ -33,8 +33,11 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 #include <strstream>
+#include <thread>
 
 #include "yb/gutil/spinlock.h"
+#include "yb/util/locks.h"
+#include "yb/util/profiled_mutex.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/test_util.h"
 #include "yb/util/trace.h"
@@ -86,4 +89,42 @@ TEST_F(SpinLockProfilingTest, TestStackCollection) {
   ASSERT_EQ(0, dropped);
 }
 
+// Holds 'lock' while another thread acquires it with 'acquire', and returns the contention
+// profile collected meanwhile.
+template <class Lock, class Acquire>
+string ContendedProfile(Lock* lock, const Acquire& acquire) {
+  StartSynchronizationProfiling();
+  lock->lock();
+  std::thread waiter([lock, &acquire] { acquire(lock); });
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  lock->unlock();
+  waiter.join();
+  StopSynchronizationProfiling();
+  std::stringstream str;
+  int64_t dropped = 0;
+  FlushSynchronizationProfile(&str, &dropped);
+  return str.str();
+}
+
+TEST_F(SpinLockProfilingTest, TestProfiledMutex) {
+  ProfiledMutex mutex;
+  auto micros_before = GetSpinLockContentionMicros();
+  string s = ContendedProfile(&mutex, [](ProfiledMutex* m) {
+    std::lock_guard<ProfiledMutex> lock(*m);
+  });
+  ASSERT_STR_CONTAINS(s, "\t1 @ ");
+  ASSERT_GE(GetSpinLockContentionMicros() - micros_before, 50000);
+}
+
+TEST_F(SpinLockProfilingTest, TestRwSpinlock) {
+  rw_spinlock lock;
+  auto micros_before = GetSpinLockContentionMicros();
+  string s = ContendedProfile(&lock, [](rw_spinlock* l) {
+    l->lock_shared();
+    l->unlock_shared();
+  });
+  ASSERT_STR_CONTAINS(s, "\t1 @ ");
+  ASSERT_GE(GetSpinLockContentionMicros() - micros_before, 50000);
+}
+
 } // namespace yb
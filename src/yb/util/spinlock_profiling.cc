@@ -292,6 +292,10 @@ uint64_t GetSpinLockContentionMicros() {
   return implicit_cast<int64_t>(micros);
 }
 
+void SubmitLockContention(const void* lock, int64_t wait_cycles) {
+  SubmitSpinLockProfileData(lock, wait_cycles);
+}
+
 void StartSynchronizationProfiling() {
   InitSpinLockContentionProfiling();
   base::subtle::Barrier_AtomicIncrement(&g_profiling_enabled, 1);
@@ -32,6 +32,7 @@
 #ifndef YB_UTIL_SPINLOCK_PROFILING_H
 #define YB_UTIL_SPINLOCK_PROFILING_H
 
+#include <cstdint>
 #include <iosfwd>
 
 #include "yb/gutil/macros.h"
@@ -53,6 +54,11 @@ void InitSpinLockContentionProfiling();
 // since the server started.
 uint64_t GetSpinLockContentionMicros();
 
+// Record 'wait_cycles' spent waiting for a contended 'lock' that is not a gutil spinlock, e.g. a
+// ProfiledMutex or an rw_spinlock. The wait shows up in the contention metric and profiles exactly
+// like spinlock contention.
+void SubmitLockContention(const void* lock, int64_t wait_cycles);
+
 // Register metrics in the given server entity which measure the amount of
 // spinlock contention.
 void RegisterSpinLockContentionMetrics(const scoped_refptr<MetricEntity>& entity);
@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <sstream>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -121,6 +122,50 @@ TEST_F(TraceTest, TestChildTrace) {
             XOutDigits(traceA->DumpToString(false)));
 }
 
+TEST_F(TraceTest, TestSampledSpan) {
+  // Entries are added to sampled traces even with tracing disabled.
+  FLAGS_enable_tracing = false;
+  scoped_refptr<Trace> root(new Trace);
+  TRACE_TO(root, "not sampled");
+  root->StartSampledTrace();
+  ASSERT_TRUE(root->sampled());
+  ASSERT_EQ(0, root->parent_span_id());
+
+  // Child traces share the span of their parent, unless they start their own.
+  scoped_refptr<Trace> same_span(new Trace);
+  scoped_refptr<Trace> child_span(new Trace);
+  root->AddChildTrace(same_span.get());
+  root->AddChildTrace(child_span.get());
+  child_span->StartChildSpan();
+  ASSERT_EQ(root->trace_id(), same_span->trace_id());
+  ASSERT_EQ(root->span_id(), same_span->span_id());
+  ASSERT_EQ(root->trace_id(), child_span->trace_id());
+  ASSERT_EQ(root->span_id(), child_span->parent_span_id());
+  ASSERT_NE(root->span_id(), child_span->span_id());
+
+  const auto start = MonoTime::Now();
+  {
+    ADOPT_TRACE(root.get());
+    TRACE("hello from root");
+  }
+  TRACE_TO(same_span, "hello from the same span");
+  TRACE_TO(child_span, "hello from the child span");
+
+  std::stringstream out;
+  root->DumpSpan(&out, "test_span", start, MonoTime::Now());
+  Document d;
+  d.Parse<0>(out.str().c_str());
+  ASSERT_TRUE(d.IsObject()) << out.str();
+  ASSERT_EQ(32, strlen(d["traceId"].GetString()));
+  ASSERT_EQ(16, strlen(d["spanId"].GetString()));
+  ASSERT_FALSE(d.HasMember("parentSpanId"));
+  ASSERT_EQ(string("test_span"), d["name"].GetString());
+  const Value& events = d["events"];
+  ASSERT_EQ(2, events.Size()) << out.str();
+  ASSERT_EQ(string("hello from root"), events[0]["name"].GetString());
+  ASSERT_EQ(string("hello from the same span"), events[1]["name"].GetString());
+}
+
 static void GenerateTraceEvents(int thread_id,
                                 int num_events) {
   for (int i = 0; i < num_events; i++) {
@@ -32,9 +32,13 @@
 
 #include "yb/util/trace.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <strstream>
 #include <string>
 #include <vector>
@@ -42,12 +46,15 @@
 #include <boost/range/iterator_range.hpp>
 #include <boost/range/adaptor/indirected.hpp>
 
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
 
+#include "yb/util/jsonwriter.h"
 #include "yb/util/memory/arena.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
+#include "yb/util/random_util.h"
 #include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
@@ -156,10 +163,23 @@ int64_t GetCurrentMicrosFast(MonoTime now) {
   return initial_micros_offset + now.GetDeltaSinceMin().ToMicroseconds();
 }
 
+uint64_t NewSpanId() {
+  return RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+}
+
+std::string SpanIdToHex(uint64_t id) {
+  return StringPrintf("%016" PRIx64, id);
+}
+
+std::string MonoTimeToUnixNanos(MonoTime time) {
+  return std::to_string(GetCurrentMicrosFast(time) * 1000);
+}
+
 } // namespace
 
 ScopedAdoptTrace::ScopedAdoptTrace(Trace* t)
-    : old_trace_(Trace::threadlocal_trace_), is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing)) {
+    : old_trace_(Trace::threadlocal_trace_),
+      is_enabled_(GetAtomicFlag(&FLAGS_enable_tracing) || (t != nullptr && t->sampled())) {
   if (is_enabled_) {
     trace_ = t;
     Trace::threadlocal_trace_ = t;
@@ -357,6 +377,115 @@ void Trace::AddChildTrace(Trace* child_trace) {
     child_traces_.push_back(ptr);
   }
   CHECK(!child_trace->HasOneRef());
+  if (sampled() && !child_trace->sampled()) {
+    child_trace->trace_id_ = trace_id_;
+    child_trace->span_id_ = span_id_;
+    child_trace->parent_span_id_ = parent_span_id_;
+  }
+}
+
+void Trace::StartSampledTrace() {
+  StartSpan(NewSpanId(), 0 /* parent_span_id */);
+}
+
+void Trace::StartSpan(uint64_t trace_id, uint64_t parent_span_id) {
+  DCHECK_NE(trace_id, 0U);
+  trace_id_ = trace_id;
+  span_id_ = NewSpanId();
+  parent_span_id_ = parent_span_id;
+}
+
+void Trace::StartChildSpan() {
+  if (sampled()) {
+    StartSpan(trace_id_, span_id_);
+  }
+}
+
+void Trace::CollectSpanEntries(uint64_t span_id, std::vector<const TraceEntry*>* entries) const {
+  vector<scoped_refptr<Trace>> child_traces;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    for (TraceEntry* cur = entries_head_; cur != nullptr; cur = cur->next) {
+      entries->push_back(cur);
+    }
+    child_traces = child_traces_;
+  }
+  for (const auto& child_trace : child_traces) {
+    if (child_trace->span_id_ == span_id) {
+      child_trace->CollectSpanEntries(span_id, entries);
+    }
+  }
+}
+
+void Trace::DumpSpan(
+    std::ostream* out, const std::string& name, MonoTime start, MonoTime end) const {
+  vector<const TraceEntry*> entries;
+  CollectSpanEntries(span_id_, &entries);
+  std::stable_sort(entries.begin(), entries.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->timestamp < rhs->timestamp;
+  });
+
+  std::stringstream s;
+  JsonWriter writer(&s, JsonWriter::COMPACT);
+  writer.StartObject();
+  // Trace ids of OpenTelemetry are 128 bits long.
+  writer.String("traceId");
+  writer.String(SpanIdToHex(0) + SpanIdToHex(trace_id_));
+  writer.String("spanId");
+  writer.String(SpanIdToHex(span_id_));
+  if (parent_span_id_ != 0) {
+    writer.String("parentSpanId");
+    writer.String(SpanIdToHex(parent_span_id_));
+  }
+  writer.String("name");
+  writer.String(name);
+  writer.String("startTimeUnixNano");
+  writer.String(MonoTimeToUnixNanos(start));
+  writer.String("endTimeUnixNano");
+  writer.String(MonoTimeToUnixNanos(end));
+  writer.String("events");
+  writer.StartArray();
+  for (const auto* entry : entries) {
+    writer.StartObject();
+    writer.String("timeUnixNano");
+    writer.String(MonoTimeToUnixNanos(entry->timestamp));
+    writer.String("name");
+    writer.String(entry->message, entry->message_len);
+    writer.String("attributes");
+    writer.StartArray();
+    writer.StartObject();
+    writer.String("key");
+    writer.String("code.filepath");
+    writer.String("value");
+    writer.StartObject();
+    writer.String("stringValue");
+    writer.String(const_basename(entry->file_path));
+    writer.EndObject();
+    writer.EndObject();
+    writer.StartObject();
+    writer.String("key");
+    writer.String("code.lineno");
+    writer.String("value");
+    writer.StartObject();
+    writer.String("intValue");
+    writer.String(std::to_string(entry->line_number));
+    writer.EndObject();
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+  *out << s.str();
+}
+
+void Trace::ExportSpan(const std::string& name, MonoTime start) const {
+  if (!sampled()) {
+    return;
+  }
+  std::stringstream s;
+  DumpSpan(&s, name, start, MonoTime::Now());
+  LOG(INFO) << "Trace span: " << s.str();
 }
 
 PlainTrace::PlainTrace() {
@@ -64,19 +64,17 @@ DECLARE_bool(enable_tracing);
 //  TRACE("Acquired timestamp $0", timestamp);
 #define TRACE(format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
-      yb::Trace* _trace = Trace::CurrentTrace(); \
-      if (_trace) { \
-        _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
-          ##substitutions); \
-      } \
+    yb::Trace* _trace = Trace::CurrentTrace(); \
+    if (_trace != nullptr && yb::IsTracingEnabledFor(_trace)) { \
+      _trace->SubstituteAndTrace(__FILE__, __LINE__, MonoTime::Now(), (format),  \
+        ##substitutions); \
     } \
   } while (0)
 
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO(trace, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (yb::IsTracingEnabledFor(trace)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, MonoTime::Now(), (format), ##substitutions); \
     } \
@@ -85,7 +83,7 @@ DECLARE_bool(enable_tracing);
 // Like the above, but takes the trace pointer as an explicit argument.
 #define TRACE_TO_WITH_TIME(trace, time, format, substitutions...) \
   do { \
-    if (GetAtomicFlag(&FLAGS_enable_tracing)) { \
+    if (yb::IsTracingEnabledFor(trace)) { \
       (trace)->SubstituteAndTrace( \
           __FILE__, __LINE__, (time), (format), ##substitutions); \
     } \
@@ -156,6 +154,42 @@ class Trace : public RefCountedThreadSafe<Trace> {
   // Attaches the given trace which will get appended at the end when Dumping.
   void AddChildTrace(Trace* child_trace);
 
+  // Requests remote servers called while this trace is current to return their traces, so they
+  // are included into this trace.
+  void RequestRemoteTraces() {
+    remote_traces_requested_.store(true, std::memory_order_release);
+  }
+
+  bool remote_traces_requested() const {
+    return remote_traces_requested_.load(std::memory_order_acquire);
+  }
+
+  // Span context of a sampled end-to-end trace, which is propagated to remote servers in RPC
+  // headers. Ids are 0 for traces that are not sampled. A child trace shares the span of its
+  // parent unless it starts a span of its own. The context should be set before the trace is
+  // shared with other threads.
+  uint64_t trace_id() const { return trace_id_; }
+  uint64_t span_id() const { return span_id_; }
+  uint64_t parent_span_id() const { return parent_span_id_; }
+  bool sampled() const { return trace_id_ != 0; }
+
+  // Makes this trace the root span of a new sampled trace.
+  void StartSampledTrace();
+
+  // Makes this trace a new span of the given trace, e.g. of the call of a remote server.
+  void StartSpan(uint64_t trace_id, uint64_t parent_span_id);
+
+  // Makes this trace a new span that is a child of its current span, e.g. for an outbound call.
+  // Does nothing if the trace is not sampled.
+  void StartChildSpan();
+
+  // Writes the span as a JSON object in the format of OpenTelemetry spans. Events of the span are
+  // the entries of this trace and of the child traces that share its span.
+  void DumpSpan(std::ostream* out, const std::string& name, MonoTime start, MonoTime end) const;
+
+  // Logs the span, which started at start and ends now, if the trace is sampled.
+  void ExportSpan(const std::string& name, MonoTime start) const;
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -185,6 +219,9 @@ class Trace : public RefCountedThreadSafe<Trace> {
   // Add the entry to the linked list of entries.
   void AddEntry(TraceEntry* entry);
 
+  // Appends entries of this trace and of its child traces that belong to the given span.
+  void CollectSpanEntries(uint64_t span_id, std::vector<const TraceEntry*>* entries) const;
+
   std::atomic<ThreadSafeArena*> arena_ = {nullptr};
 
   // Lock protecting the entries linked list.
@@ -198,11 +235,26 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  std::atomic<bool> remote_traces_requested_{false};
+
+  uint64_t trace_id_ = 0;
+  uint64_t span_id_ = 0;
+  uint64_t parent_span_id_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
 typedef scoped_refptr<Trace> TracePtr;
 
+// Entries are added to sampled traces even when tracing is disabled.
+inline bool IsTracingEnabledFor(const Trace* trace) {
+  return GetAtomicFlag(&FLAGS_enable_tracing) || (trace != nullptr && trace->sampled());
+}
+
+inline bool IsTracingEnabledFor(const TracePtr& trace) {
+  return IsTracingEnabledFor(trace.get());
+}
+
 // Adopt a Trace object into the current thread for the duration
 // of this object.
 // This should only be used on the stack (and thus created and destroyed
@@ -24,6 +24,12 @@
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
 
+DEFINE_int32(cql_compression_min_body_size, 512,
+             "Response bodies smaller than this size are sent uncompressed even when the "
+             "connection uses compression.");
+
+DECLARE_int32(max_message_length);
+
 namespace yb {
 namespace cqlserver {
 
@@ -247,7 +253,15 @@ bool CQLRequest::ParseRequest(
         }
 
         const uint32_t uncomp_size = static_cast<uint32_t>(NetworkByteOrder::Load32(body_data));
-        buffer = std::make_unique<uint8_t[]>(uncomp_size);
+        if (uncomp_size > static_cast<uint32_t>(FLAGS_max_message_length)) {
+          error_response->reset(
+              new ErrorResponse(
+                  header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
+                  "Uncompressed CQL message too long"));
+          return false;
+        }
+        // The buffer is filled by decompression, so it is not initialized.
+        buffer.reset(new uint8_t[uncomp_size]);
         body_data += sizeof(uncomp_size);
         body_size -= sizeof(uncomp_size);
         const int size = LZ4_decompress_safe(to_char_ptr(body_data), to_char_ptr(buffer.get()),
@@ -265,8 +279,9 @@ bool CQLRequest::ParseRequest(
       }
       case CompressionScheme::SNAPPY: {
         size_t uncomp_size = 0;
-        if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size)) {
-          buffer = std::make_unique<uint8_t[]>(uncomp_size);
+        if (GetUncompressedLength(to_char_ptr(body_data), body_size, &uncomp_size) &&
+            uncomp_size <= static_cast<size_t>(FLAGS_max_message_length)) {
+          buffer.reset(new uint8_t[uncomp_size]);
           if (RawUncompress(to_char_ptr(body_data), body_size, to_char_ptr(buffer.get()))) {
             body_data = buffer.get();
             body_size = uncomp_size;
@@ -277,7 +292,7 @@ bool CQLRequest::ParseRequest(
             new ErrorResponse(
                 header.stream_id, ErrorResponse::Code::PROTOCOL_ERROR,
                 "Error occurred when uncompressing CQL message"));
-        break;
+        return false;
       }
       case CompressionScheme::NONE:
         error_response->reset(
@@ -912,11 +927,24 @@ CQLResponse::~CQLResponse() {
 
 void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg) const {
   const size_t start_pos = mesg->size(); // save the start position
-  const bool compress = (compression_scheme != CQLMessage::CompressionScheme::NONE);
-  SerializeHeader(compress, mesg);
-  if (compress) {
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE) {
     faststring body;
+    SerializeWarnings(&body);
     SerializeBody(&body);
+    const Slice tail = BodyTail();
+    // Compression flag is set per frame, so small bodies are sent as is: compressing them costs
+    // more CPU than it saves bandwidth.
+    if (body.size() + tail.size() < static_cast<size_t>(FLAGS_cql_compression_min_body_size)) {
+      SerializeHeader(false /* compress */, mesg);
+      mesg->append(body.data(), body.size());
+      mesg->append(tail.data(), tail.size());
+      SERIALIZE_INT(
+          mesg->data(), start_pos + kHeaderPosLength,
+          mesg->size() - start_pos - kMessageHeaderLength);
+      return;
+    }
+    SerializeHeader(true /* compress */, mesg);
+    body.append(tail.data(), tail.size());
     switch (compression_scheme) {
       case CQLMessage::CompressionScheme::LZ4: {
         SerializeInt(static_cast<int32_t>(body.size()), mesg);
@@ -946,22 +974,53 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
         break;
     }
   } else {
+    SerializeHeader(false /* compress */, mesg);
+    SerializeWarnings(mesg);
     SerializeBody(mesg);
+    const Slice tail = BodyTail();
+    mesg->append(tail.data(), tail.size());
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+RefCntBuffer CQLResponse::SerializeToBuffer(const CompressionScheme compression_scheme) const {
+  const Slice tail = BodyTail();
+  if (compression_scheme != CQLMessage::CompressionScheme::NONE || tail.empty()) {
+    faststring mesg;
+    Serialize(compression_scheme, &mesg);
+    return RefCntBuffer(mesg);
+  }
+
+  faststring head;
+  SerializeHeader(false /* compress */, &head);
+  SerializeWarnings(&head);
+  SerializeBody(&head);
+  RefCntBuffer result(head.size() + tail.size());
+  memcpy(result.data(), head.data(), head.size());
+  memcpy(result.data() + head.size(), tail.data(), tail.size());
+  SERIALIZE_INT(result.udata(), kHeaderPosLength, result.size() - kMessageHeaderLength);
+  return result;
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
-  SERIALIZE_BYTE(buffer, kHeaderPosFlags, flags() | (compress ? kCompressionFlag : 0));
+  SERIALIZE_BYTE(buffer, kHeaderPosFlags,
+                 flags() | (compress ? kCompressionFlag : 0) |
+                 (warnings_.empty() ? 0 : kWarningFlag));
   SERIALIZE_SHORT(buffer, kHeaderPosStreamId, stream_id());
   SERIALIZE_INT(buffer, kHeaderPosLength, 0);
   SERIALIZE_BYTE(buffer, kHeaderPosOpcode, opcode());
   mesg->append(buffer, sizeof(buffer));
 }
 
+void CQLResponse::SerializeWarnings(faststring* mesg) const {
+  if (!warnings_.empty()) {
+    SerializeStringList(warnings_, mesg);
+  }
+}
+
 #undef SERIALIZE_BYTE
 #undef SERIALIZE_SHORT
 #undef SERIALIZE_INT
@@ -1505,7 +1564,10 @@ void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
+}
+
+Slice RowsResultResponse::BodyTail() const {
+  return Slice(result_->rows_data());
 }
 
 //----------------------------------------------------------------------------------------
@@ -29,6 +29,7 @@
 #include "yb/rpc/server_event.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
@@ -465,13 +466,30 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Serialize the response into a buffer that is sent to the client. When the body is not
+  // compressed, the body tail is copied directly to this buffer.
+  RefCntBuffer SerializeToBuffer(CompressionScheme compression_scheme) const;
+
+  // Adds a warning returned to the client with the response. Supported since V4.
+  void AddWarning(std::string warning) { warnings_.push_back(std::move(warning)); }
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
   void SerializeHeader(bool compress, faststring* mesg) const;
 
+  // Serializes the warnings that precede the body, if any.
+  void SerializeWarnings(faststring* mesg) const;
+
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
+
+  // Data that follows the part of the body serialized by SerializeBody. Used for large data that
+  // is already encoded, to avoid copying it to an intermediate buffer.
+  virtual Slice BodyTail() const { return Slice(); }
+
+ private:
+  std::vector<std::string> warnings_;
 };
 
 // ------------------------------ Individual CQL responses -----------------------------------
@@ -732,6 +750,9 @@ class RowsResultResponse : public ResultResponse {
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
 
+  // Rows data is already encoded by the tablet server, so it is sent as is.
+  virtual Slice BodyTail() const override;
+
  private:
   const ql::RowsResult::SharedPtr result_;
   const bool skip_metadata_;
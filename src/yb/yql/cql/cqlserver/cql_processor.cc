@@ -15,6 +15,12 @@
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "yb/common/ql_protocol.pb.h"
+
 #include "yb/gutil/strings/escaping.h"
 
 #include "yb/rpc/connection.h"
@@ -22,6 +28,7 @@
 #include "yb/rpc/rpc_context.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/trace.h"
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
@@ -59,7 +66,15 @@ METRIC_DEFINE_histogram(
     "RPC requests",
     60000000LU, 2);
 
+DEFINE_int32(cql_parallel_batch_max_parts, 4,
+             "The maximum number of parts a batch of prepared DML statements is split into to be "
+             "executed by several CQL processors in parallel. Each part writes to its own set of "
+             "tablets. 1 means batches are not split.");
+DEFINE_int32(cql_parallel_batch_min_statements_per_part, 100,
+             "The minimum number of statements in each part of a batch executed in parallel.");
+
 DECLARE_bool(use_cassandra_authentication);
+DECLARE_int32(cql_service_max_unprepared_statements);
 
 namespace yb {
 namespace cqlserver {
@@ -96,6 +111,75 @@ using ql::GetErrorCode;
 using strings::Substitute;
 using yb::util::bcrypt_checkpw;
 
+namespace {
+
+// Only parse trees of DML statements are cached for unprepared queries. Other statements are not
+// executed often enough to benefit from caching.
+bool IsCachableUnpreparedStatement(const ParseTree& parse_tree) {
+  if (parse_tree.root() == nullptr) {
+    return false;
+  }
+  switch (parse_tree.root()->opcode()) {
+    case ql::TreeNodeOpcode::kPTSelectStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTDeleteStmt:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the index of the tablet the statement of a batch writes to, or none if it is not known
+// before the statement is executed.
+boost::optional<size_t> GetBatchStatementTablet(const ParseTree& parse_tree,
+                                                const ql::StatementParameters& params) {
+  const ql::TreeNode* tnode = parse_tree.root().get();
+  if (tnode == nullptr) {
+    return boost::none;
+  }
+  switch (tnode->opcode()) {
+    case ql::TreeNodeOpcode::kPTInsertStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTUpdateStmt: FALLTHROUGH_INTENDED;
+    case ql::TreeNodeOpcode::kPTDeleteStmt:
+      break;
+    default:
+      return boost::none;
+  }
+  // Statements that are rejected or handled specially in a batch are not split.
+  const auto& stmt = static_cast<const ql::PTDmlStmt&>(*tnode);
+  if (stmt.if_clause() != nullptr || stmt.returns_status() || stmt.ModifiesMultipleRows() ||
+      stmt.RequiresTransaction()) {
+    return boost::none;
+  }
+
+  // The partition key is computed from the bound values of the hash columns the same way as the
+  // executor does it.
+  const auto& hash_col_bindvars = stmt.hash_col_bindvars();
+  if (hash_col_bindvars.empty()) {
+    return boost::none;
+  }
+  google::protobuf::RepeatedPtrField<QLExpressionPB> hashed_column_values;
+  for (const ql::PTBindVar* bindvar : hash_col_bindvars) {
+    QLValue value;
+    if (!params.GetBindVariable(
+            bindvar->name()->c_str(), bindvar->pos(), bindvar->ql_type(), &value).ok()) {
+      return boost::none;
+    }
+    *hashed_column_values.Add()->mutable_value() = std::move(*value.mutable_value());
+  }
+  const auto& table = stmt.table();
+  string partition_key;
+  if (!table->partition_schema().EncodeKey(hashed_column_values, &partition_key).ok()) {
+    return boost::none;
+  }
+  const auto& partitions = table->GetPartitions();
+  const auto it = std::upper_bound(partitions.begin(), partitions.end(), partition_key);
+  return static_cast<size_t>(it == partitions.begin() ? 0 : it - partitions.begin() - 1);
+}
+
+} // namespace
+
 //------------------------------------------------------------------------------------------------
 CQLMetrics::CQLMetrics(const scoped_refptr<yb::MetricEntity>& metric_entity)
     : QLMetrics(metric_entity) {
@@ -126,7 +210,8 @@ CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListP
       service_impl_(service_impl),
       cql_metrics_(service_impl->cql_metrics()),
       pos_(pos),
-      statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))) {
+      statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))),
+      batch_part_executed_cb_(Bind(&CQLProcessor::BatchPartExecuted, Unretained(this))) {
 }
 
 CQLProcessor::~CQLProcessor() {
@@ -144,7 +229,7 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   if (!CQLRequest::ParseRequest(call_->serialized_request(), compression_scheme,
                                 &request, &response)) {
     cql_metrics_->num_errors_parsing_cql_->Increment();
-    SendResponse(*response);
+    SendResponse(response.get());
     return;
   }
 
@@ -152,6 +237,13 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   cql_metrics_->time_to_parse_cql_wrapper_->Increment(
       execute_begin_.GetDeltaSince(parse_begin_).ToMicroseconds());
 
+  // A request with the tracing flag (e.g. after TRACING ON in cqlsh) gets its execution trace,
+  // including the traces of tablet servers it called, with the response.
+  if (request->flags() & CQLMessage::kTracingFlag) {
+    call_->trace()->RequestRemoteTraces();
+  }
+  TRACE("Parsed CQL request");
+
   // Execute the request (perhaps asynchronously).
   SetCurrentSession(call_->ql_session());
   request_ = std::move(request);
@@ -159,19 +251,30 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   retry_count_ = 0;
   response.reset(ProcessRequest(*request_));
   if (response != nullptr) {
-    SendResponse(*response);
+    SendResponse(response.get());
   }
 }
 
-void CQLProcessor::SendResponse(const CQLResponse& response) {
+void CQLProcessor::SendResponse(CQLResponse* response) {
   // Serialize the response to return to the CQL client. In case of error, an error response
   // should still be present.
   MonoTime response_begin = MonoTime::Now();
+  // Warnings are supported since V4. The trace is returned as a warning rather than as a tracing
+  // session, because there are no system_traces tables to store the trace in.
+  if (request_ != nullptr && (request_->flags() & CQLMessage::kTracingFlag) &&
+      request_->version() >= CQLMessage::kV4Version) {
+    TRACE("Sending response");
+    std::string trace = call_->trace()->DumpToString(true /* include_time_deltas */);
+    // Warnings are strings with 16-bit length.
+    if (trace.size() > std::numeric_limits<uint16_t>::max()) {
+      trace.resize(std::numeric_limits<uint16_t>::max());
+    }
+    response->AddWarning(std::move(trace));
+  }
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
-  faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  call_->RespondSuccess(
+      response->SerializeToBuffer(compression_scheme), cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -188,6 +291,8 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  unprepared_stmt_ = nullptr;
+  batch_parts_.clear();
   SetCurrentSession(nullptr);
   service_impl_->ReturnProcessor(pos_);
 }
@@ -297,10 +402,36 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
+  if (FLAGS_cql_service_max_unprepared_statements > 0) {
+    return ProcessCachedQuery(req);
+  }
   RunAsync(req.query(), req.params(), statement_executed_cb_);
   return nullptr;
 }
 
+CQLResponse* CQLProcessor::ProcessCachedQuery(const QueryRequest& req) {
+  // The query is prepared and cached the same way as a prepared statement, so the same query
+  // received again is executed without being parsed and analyzed again. A stale statement is
+  // deleted from the cache when its execution fails (see ProcessError).
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(
+      ql_env_.CurrentKeyspace(), req.query());
+  shared_ptr<CQLStatement> stmt = service_impl_->AllocateUnpreparedStatement(
+      query_id, ql_env_.CurrentKeyspace(), req.query());
+  Status s = stmt->Prepare(this, service_impl_->unprepared_stmts_mem_tracker());
+  if (!s.ok()) {
+    service_impl_->DeleteUnpreparedStatement(stmt);
+    return ProcessError(s);
+  }
+  const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
+  if (!parse_tree || !IsCachableUnpreparedStatement(*parse_tree)) {
+    service_impl_->DeleteUnpreparedStatement(stmt);
+  }
+  stmt->clear_reparsed();
+  unprepared_stmt_ = stmt;
+  s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+  return s.ok() ? nullptr : ProcessError(s);
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
   VLOG(1) << "BATCH " << req.queries().size();
 
@@ -333,11 +464,128 @@ CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
     }
   }
 
+  if (ExecuteParallelBatch(req, batch)) {
+    return nullptr;
+  }
   ExecuteAsync(batch, statement_executed_cb_);
 
   return nullptr;
 }
 
+bool CQLProcessor::ExecuteParallelBatch(const BatchRequest& req, const StatementBatch& batch) {
+  const size_t min_statements_per_part =
+      std::max(FLAGS_cql_parallel_batch_min_statements_per_part, 1);
+  size_t num_parts = std::min<size_t>(std::max(FLAGS_cql_parallel_batch_max_parts, 1),
+                                      batch.size() / min_statements_per_part);
+  if (num_parts < 2) {
+    return false;
+  }
+
+  // Group the statements by the tablets they write to. Statements writing to the same row write
+  // to the same tablet, so they stay in the same part and are executed in the original order.
+  std::map<std::pair<TableId, size_t>, size_t> group_by_tablet;
+  std::vector<size_t> statement_groups;
+  std::vector<size_t> group_sizes;
+  statement_groups.reserve(batch.size());
+  for (size_t i = 0; i != batch.size(); ++i) {
+    if (!req.queries()[i].is_prepared) {
+      return false;
+    }
+    const ParseTree& parse_tree = batch[i].first;
+    const auto tablet = GetBatchStatementTablet(parse_tree, batch[i].second);
+    if (!tablet) {
+      return false;
+    }
+    const auto& table_id = static_cast<const ql::PTDmlStmt&>(*parse_tree.root()).table()->id();
+    const auto it = group_by_tablet.emplace(
+        std::make_pair(table_id, *tablet), group_sizes.size()).first;
+    if (it->second == group_sizes.size()) {
+      group_sizes.push_back(0);
+    }
+    ++group_sizes[it->second];
+    statement_groups.push_back(it->second);
+  }
+  num_parts = std::min(num_parts, group_sizes.size());
+  if (num_parts < 2) {
+    return false;
+  }
+
+  // Assign the largest groups first, each to the part with the fewest statements so far.
+  std::vector<size_t> groups_by_size(group_sizes.size());
+  for (size_t i = 0; i != groups_by_size.size(); ++i) {
+    groups_by_size[i] = i;
+  }
+  std::sort(groups_by_size.begin(), groups_by_size.end(), [&group_sizes](size_t lhs, size_t rhs) {
+    return group_sizes[lhs] > group_sizes[rhs];
+  });
+  std::vector<size_t> part_sizes(num_parts);
+  std::vector<size_t> group_parts(group_sizes.size());
+  for (size_t group : groups_by_size) {
+    const size_t part = std::min_element(part_sizes.begin(), part_sizes.end()) -
+                        part_sizes.begin();
+    group_parts[group] = part;
+    part_sizes[part] += group_sizes[group];
+  }
+
+  batch_parts_.assign(num_parts, StatementBatch());
+  for (size_t i = 0; i != num_parts; ++i) {
+    batch_parts_[i].reserve(part_sizes[i]);
+  }
+  for (size_t i = 0; i != batch.size(); ++i) {
+    batch_parts_[group_parts[statement_groups[i]]].push_back(batch[i]);
+  }
+  VLOG(1) << "BATCH of " << batch.size() << " statements to " << group_sizes.size()
+          << " tablets is executed in " << num_parts << " parts";
+
+  // Each part is executed in its own session and flushed separately. This processor executes the
+  // first part after queueing the others to helper processors, so it reports the result only after
+  // all parts are executed.
+  batch_parts_status_ = Status::OK();
+  num_pending_batch_parts_.store(num_parts, std::memory_order_release);
+  for (size_t i = 1; i != num_parts; ++i) {
+    CQLProcessor* helper = service_impl_->GetProcessor();
+    helper->parent_ = this;
+    helper->batch_part_ = &batch_parts_[i];
+    helper->SetCurrentSession(call_->ql_session());
+    Reschedule(&helper->execute_batch_part_task_.Bind(helper));
+  }
+  parent_ = this;
+  ExecuteAsync(batch_parts_[0], batch_part_executed_cb_);
+  return true;
+}
+
+void CQLProcessor::BatchPartExecuted(const Status& s, const ExecutedResult::SharedPtr& result) {
+  CQLProcessor* const parent = parent_;
+  parent_ = nullptr;
+  if (parent != this) {
+    // Release the helper processor before notifying the parent, because the parent may send the
+    // response and release the statements the helper used.
+    batch_part_ = nullptr;
+    SetCurrentSession(nullptr);
+    service_impl_->ReturnProcessor(pos_);
+  }
+  parent->ParallelBatchPartDone(s);
+}
+
+void CQLProcessor::ParallelBatchPartDone(const Status& s) {
+  if (!s.ok()) {
+    std::lock_guard<std::mutex> lock(batch_parts_mutex_);
+    if (batch_parts_status_.ok()) {
+      batch_parts_status_ = s;
+    }
+  }
+  if (num_pending_batch_parts_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  Status status;
+  {
+    std::lock_guard<std::mutex> lock(batch_parts_mutex_);
+    status = std::move(batch_parts_status_);
+    batch_parts_status_ = Status::OK();
+  }
+  StatementExecuted(status);
+}
+
 CQLResponse* CQLProcessor::ProcessRequest(const AuthResponseRequest& req) {
   const auto& params = req.params();
   shared_ptr<Statement> stmt = service_impl_->GetAuthPreparedStatement();
@@ -371,7 +619,7 @@ shared_ptr<const CQLStatement> CQLProcessor::GetPreparedStatement(const CQLMessa
 void CQLProcessor::StatementExecuted(const Status& s, const ExecutedResult::SharedPtr& result) {
   unique_ptr<CQLResponse> response(s.ok() ? ProcessResult(result) : ProcessError(s));
   if (response) {
-    SendResponse(*response);
+    SendResponse(response.get());
   }
 }
 
@@ -381,6 +629,11 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
     ErrorCode ql_errcode = GetErrorCode(s);
     if (ql_errcode == ErrorCode::UNPREPARED_STATEMENT ||
         ql_errcode == ErrorCode::STALE_METADATA) {
+      // Delete the stale statement of the unprepared query from the cache, so it is prepared again
+      // when the query is retried below.
+      if (unprepared_stmt_ != nullptr && unprepared_stmt_->stale()) {
+        service_impl_->DeleteUnpreparedStatement(unprepared_stmt_);
+      }
       // Delete all stale prepared statements from our cache. Since CQL protocol allows only one
       // unprepared query id to be returned, we will return just the last unprepared / stale one
       // we found.
@@ -402,6 +655,7 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
       if (++retry_count_ == 1) {
         stmts_.clear();
         parse_trees_.clear();
+        unprepared_stmt_ = nullptr;
         Reschedule(&process_request_task_.Bind(this));
         return nullptr;
       }
@@ -20,6 +20,10 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_PROCESSOR_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_PROCESSOR_H_
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "yb/rpc/service_if.h"
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -29,6 +33,8 @@
 #include "yb/yql/cql/ql/ql_processor.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/trace.h"
+
 namespace yb {
 namespace cqlserver {
 
@@ -82,6 +88,21 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessRequest(const AuthResponseRequest& req);
   CQLResponse* ProcessRequest(const RegisterRequest& req);
 
+  // Process a QUERY request using the cache of unprepared statements.
+  CQLResponse* ProcessCachedQuery(const QueryRequest& req);
+
+  // Execute a batch of prepared statements by several processors in parallel, grouping the
+  // statements by the tablets they write to. Returns false if the batch is not split, in which
+  // case nothing is executed.
+  bool ExecuteParallelBatch(const BatchRequest& req, const ql::StatementBatch& batch);
+
+  // Callback of a part of a batch executed by this processor on behalf of the parent processor
+  // (possibly this one).
+  void BatchPartExecuted(const Status& s, const ql::ExecutedResult::SharedPtr& result = nullptr);
+
+  // Invoked in the parent processor when a part of its batch is executed.
+  void ParallelBatchPartDone(const Status& s);
+
   // Get a prepared statement and adds it to the set of statements currently being executed.
   std::shared_ptr<const CQLStatement> GetPreparedStatement(const CQLMessage::QueryId& id);
 
@@ -93,8 +114,9 @@ class CQLProcessor : public ql::QLProcessor {
   CQLResponse* ProcessError(const Status& s,
                             boost::optional<CQLMessage::QueryId> query_id = boost::none);
 
-  // Send response back to client.
-  void SendResponse(const CQLResponse& response);
+  // Send response back to client. When the request asked for tracing, the execution trace is
+  // added to the response as a warning.
+  void SendResponse(CQLResponse* response);
 
   // Pointer to the containing CQL service implementation.
   CQLServiceImpl* const service_impl_;
@@ -107,11 +129,13 @@ class CQLProcessor : public ql::QLProcessor {
 
   //----------------------------- StatementExecuted callback and state ---------------------------
 
-  // Current call, request, prepared statements and parse trees being processed.
+  // Current call, request, prepared statements, parse trees and the statement of the unprepared
+  // query being processed.
   CQLInboundCallPtr call_;
   std::shared_ptr<const CQLRequest> request_;
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
+  std::shared_ptr<const CQLStatement> unprepared_stmt_;
 
   // Current retry count.
   int retry_count_ = 0;
@@ -123,6 +147,22 @@ class CQLProcessor : public ql::QLProcessor {
   // Statement executed callback.
   ql::StatementExecutedCallback statement_executed_cb_;
 
+  //----------------------------- Parallel batch execution state ---------------------------------
+
+  // Parts of the batch being executed in parallel, the number of parts not executed yet and the
+  // first error. The first part is executed by this processor, the rest by helper processors.
+  std::vector<ql::StatementBatch> batch_parts_;
+  std::atomic<size_t> num_pending_batch_parts_{0};
+  std::mutex batch_parts_mutex_;
+  Status batch_parts_status_;
+
+  // The processor whose batch part this processor is executing, and the part.
+  CQLProcessor* parent_ = nullptr;
+  const ql::StatementBatch* batch_part_ = nullptr;
+
+  // Batch part executed callback.
+  ql::StatementExecutedCallback batch_part_executed_cb_;
+
   //----------------------------------------------------------------------------------------------
 
   class ProcessRequestTask : public rpc::ThreadPoolTask {
@@ -138,9 +178,10 @@ class CQLProcessor : public ql::QLProcessor {
     void Run() override {
       auto processor = processor_;
       processor_ = nullptr;
+      ADOPT_TRACE(processor->call_->trace());
       std::unique_ptr<CQLResponse> response(processor->ProcessRequest(*processor->request_));
       if (response != nullptr) {
-        processor->SendResponse(*response);
+        processor->SendResponse(response.get());
       }
     }
 
@@ -152,6 +193,38 @@ class CQLProcessor : public ql::QLProcessor {
   friend class ProcessRequestTask;
 
   ProcessRequestTask process_request_task_;
+
+  class ExecuteBatchPartTask : public rpc::ThreadPoolTask {
+   public:
+    ExecuteBatchPartTask& Bind(CQLProcessor* processor) {
+      processor_ = processor;
+      return *this;
+    }
+
+    virtual ~ExecuteBatchPartTask() {}
+
+   private:
+    void Run() override {
+      auto processor = processor_;
+      processor_ = nullptr;
+      processor->ExecuteAsync(*processor->batch_part_, processor->batch_part_executed_cb_);
+    }
+
+    void Done(const Status& status) override {
+      // The task is not run if it could not be queued.
+      if (!status.ok() && processor_ != nullptr) {
+        auto processor = processor_;
+        processor_ = nullptr;
+        processor->BatchPartExecuted(status);
+      }
+    }
+
+    CQLProcessor* processor_ = nullptr;
+  };
+
+  friend class ExecuteBatchPartTask;
+
+  ExecuteBatchPartTask execute_batch_part_task_;
 };
 
 }  // namespace cqlserver
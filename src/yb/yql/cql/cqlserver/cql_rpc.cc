@@ -74,7 +74,7 @@ size_t CQLConnectionContext::BufferLimit() {
 }
 
 Status CQLConnectionContext::HandleCall(
-    const rpc::ConnectionPtr& connection, std::vector<char>* call_data) {
+    const rpc::ConnectionPtr& connection, rpc::CallData* call_data) {
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
@@ -117,7 +117,7 @@ CQLInboundCall::CQLInboundCall(rpc::ConnectionPtr conn,
       ql_session_(std::move(ql_session)) {
 }
 
-Status CQLInboundCall::ParseFrom(const MemTrackerPtr& call_tracker, std::vector<char>* call_data) {
+Status CQLInboundCall::ParseFrom(const MemTrackerPtr& call_tracker, rpc::CallData* call_data) {
   TRACE_EVENT_FLOW_BEGIN0("rpc", "CQLInboundCall", this);
   TRACE_EVENT0("rpc", "CQLInboundCall::ParseFrom");
 
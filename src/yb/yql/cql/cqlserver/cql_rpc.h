@@ -65,7 +65,7 @@ class CQLConnectionContext : public rpc::ConnectionContextWithCallId,
 
   // Takes ownership of call_data content.
   CHECKED_STATUS HandleCall(
-      const rpc::ConnectionPtr& connection, std::vector<char>* call_data) override;
+      const rpc::ConnectionPtr& connection, rpc::CallData* call_data) override;
 
   // SQL session of this CQL client connection.
   ql::QLSession::SharedPtr ql_session_;
@@ -85,7 +85,7 @@ class CQLInboundCall : public rpc::InboundCall {
                           ql::QLSession::SharedPtr ql_session);
 
   // Takes ownership of call_data content.
-  CHECKED_STATUS ParseFrom(const MemTrackerPtr& call_tracker, std::vector<char>* call_data);
+  CHECKED_STATUS ParseFrom(const MemTrackerPtr& call_tracker, rpc::CallData* call_data);
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
@@ -31,6 +31,12 @@ DEFINE_int32(cql_nodelist_refresh_interval_secs, 60,
              "Interval after which a node list refresh event should be sent to all CQL clients.");
 TAG_FLAG(cql_nodelist_refresh_interval_secs, advanced);
 
+DEFINE_int32(cql_tablet_locations_check_interval_ms, 1000,
+             "Interval at which the CQL server checks whether tablet replicas or leaders have "
+             "changed, and if so sends a node list refresh event to all CQL clients, so drivers "
+             "reload system.partitions. 0 disables the check.");
+TAG_FLAG(cql_tablet_locations_check_interval_ms, advanced);
+
 DEFINE_int64(cql_rpc_block_size, 1_MB, "CQL RPC block size");
 DEFINE_int64(cql_rpc_memory_limit, 0, "CQL RPC memory limit");
 
@@ -45,6 +51,10 @@ boost::posix_time::time_duration refresh_interval() {
   return boost::posix_time::seconds(FLAGS_cql_nodelist_refresh_interval_secs);
 }
 
+boost::posix_time::time_duration locations_check_interval() {
+  return boost::posix_time::milliseconds(FLAGS_cql_tablet_locations_check_interval_ms);
+}
+
 }
 
 CQLServer::CQLServer(const CQLServerOptions& opts,
@@ -58,6 +68,7 @@ CQLServer::CQLServer(const CQLServerOptions& opts,
               AddToParent::kTrue, CreateMetrics::kFalse)),
       opts_(opts),
       timer_(*io, refresh_interval()),
+      locations_timer_(*io),
       tserver_(tserver),
       local_tablet_filter_(std::move(local_tablet_filter)) {
   SetConnectionContextFactory(rpc::CreateConnectionContextFactory<CQLConnectionContext>(
@@ -77,6 +88,11 @@ Status CQLServer::Start() {
   // Start the CQL node list refresh timer.
   timer_.async_wait(boost::bind(&CQLServer::CQLNodeListRefresh, this,
                                 boost::asio::placeholders::error));
+
+  if (tserver_ != nullptr && FLAGS_cql_tablet_locations_check_interval_ms > 0) {
+    last_tablet_locations_version_ = tserver_->tablet_locations_version();
+    ScheduleTabletLocationsCheck();
+  }
   return Status::OK();
 }
 
@@ -86,6 +102,10 @@ void CQLServer::Shutdown() {
   if (ec) {
     LOG(WARNING) << "Failed to cancel timer: " << ec;
   }
+  locations_timer_.cancel(ec);
+  if (ec) {
+    LOG(WARNING) << "Failed to cancel tablet locations timer: " << ec;
+  }
   server::RpcAndWebServerBase::Shutdown();
 }
 
@@ -101,6 +121,44 @@ void CQLServer::RescheduleTimer() {
                                 boost::asio::placeholders::error));
 }
 
+void CQLServer::ScheduleTabletLocationsCheck() {
+  boost::system::error_code ec;
+  locations_timer_.expires_from_now(locations_check_interval(), ec);
+  if (ec) {
+    LOG(WARNING) << "Failed to schedule tablet locations check: " << ec;
+    return;
+  }
+  locations_timer_.async_wait(boost::bind(&CQLServer::CheckTabletLocations, this,
+                                          boost::asio::placeholders::error));
+}
+
+void CQLServer::CheckTabletLocations(const boost::system::error_code &e) {
+  if (e) {
+    return;
+  }
+  const uint64_t version = tserver_->tablet_locations_version();
+  // Version 0 means that no heartbeat response carried the version yet.
+  if (version != 0 && version != last_tablet_locations_version_) {
+    VLOG(1) << "Tablet locations version changed from " << last_tablet_locations_version_
+            << " to " << version;
+    const bool known_before = last_tablet_locations_version_ != 0;
+    last_tablet_locations_version_ = version;
+    if (known_before) {
+      // The 'MOVED_NODE' event forces the client to refresh its cluster topology, including
+      // system.partitions, so token-aware drivers send requests to the new leaders.
+      auto cqlserver_event_list = std::make_shared<CQLServerEventList>();
+      cqlserver_event_list->AddEvent(
+          BuildTopologyChangeEvent(TopologyChangeEventResponse::kMovedNode, first_rpc_address()));
+      Status s = messenger_->QueueEventOnAllReactors(cqlserver_event_list, SOURCE_LOCATION());
+      if (!s.ok()) {
+        LOG(WARNING) << strings::Substitute("Failed to push events: [$0], due to: $1",
+                                            cqlserver_event_list->ToString(), s.ToString());
+      }
+    }
+  }
+  ScheduleTabletLocationsCheck();
+}
+
 std::unique_ptr<CQLServerEvent> CQLServer::BuildTopologyChangeEvent(
     const std::string& event_type, const Endpoint& addr) {
   std::unique_ptr<EventResponse> event_response(new TopologyChangeEventResponse(event_type, addr));
@@ -60,6 +60,14 @@ class CQLServer : public server::RpcAndWebServerBase {
   void CQLNodeListRefresh(const boost::system::error_code &e);
   void RescheduleTimer();
   boost::asio::deadline_timer timer_;
+
+  // Periodically compares tablet locations version from the master with the last seen one, and
+  // asks clients to refresh their topology when it changes.
+  void ScheduleTabletLocationsCheck();
+  void CheckTabletLocations(const boost::system::error_code &e);
+  boost::asio::deadline_timer locations_timer_;
+  // Accessed only from the locations_timer_ handlers.
+  uint64_t last_tablet_locations_version_ = 0;
   const tserver::TabletServer* const tserver_;
   client::LocalTabletFilter local_tablet_filter_;
 
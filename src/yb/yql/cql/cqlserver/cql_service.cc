@@ -13,6 +13,7 @@
 
 #include "yb/yql/cql/cqlserver/cql_service.h"
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
 
@@ -36,6 +37,10 @@ DECLARE_bool(use_cassandra_authentication);
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 0,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int32(cql_service_max_unprepared_statements, 1000,
+             "The maximum number of unprepared queries, i.e. sent in QUERY requests, whose parsed "
+             "and analyzed statements the CQL proxy caches to be reused by the same queries. "
+             "0 means unprepared queries are not cached.");
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -77,6 +82,8 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts,
       FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
       FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
       "CQL prepared statements", server->mem_tracker());
+  unprepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
+      -1, "CQL unprepared statements", server->mem_tracker());
 
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
@@ -138,7 +145,7 @@ CQLProcessor *CQLServiceImpl::GetProcessor() {
   {
     // Retrieve the next available processor. If none is available, allocate a new slot in the list.
     // Then create the processor outside the mutex below.
-    std::lock_guard<std::mutex> guard(processors_mutex_);
+    std::lock_guard<ProfiledMutex> guard(processors_mutex_);
     pos = (next_available_processor_ != processors_.end() ?
            next_available_processor_++ : processors_.emplace(processors_.end()));
   }
@@ -151,34 +158,42 @@ CQLProcessor *CQLServiceImpl::GetProcessor() {
 
 void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
   // Put the processor back before the next available one.
-  std::lock_guard<std::mutex> guard(processors_mutex_);
+  std::lock_guard<ProfiledMutex> guard(processors_mutex_);
   processors_.splice(next_available_processor_, processors_, pos);
   next_available_processor_ = pos;
 }
 
+CQLServiceImpl::PreparedStmtsShard& CQLServiceImpl::GetPreparedStmtsShard(
+    const CQLMessage::QueryId& query_id) {
+  // Query id is an MD5 hash, so its first byte is good enough to distribute the statements.
+  const size_t hash = query_id.empty() ? 0 : static_cast<uint8_t>(query_id[0]);
+  return prepared_stmts_shards_[hash % kNumPreparedStmtsShards];
+}
+
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Get exclusive lock of the shard before allocating a prepared statement.
+  auto& shard = GetPreparedStmtsShard(query_id);
+  std::lock_guard<ProfiledMutex> guard(shard.mutex);
 
   shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = shard.map.find(query_id);
+  if (itr == shard.map.end()) {
     // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
     // statement to contend on. The statement will then be prepared by one client while the rest
     // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
+    stmt = shard.map.emplace(
         query_id, std::make_shared<CQLStatement>(
-            keyspace, query, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
+            keyspace, query, shard.list.end())).first->second;
+    stmt->set_pos(shard.list.insert(shard.list.begin(), stmt));
   } else {
     // Return existing statement if found.
     stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
+    stmt->MarkUsed();
   }
 
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache shard count = "
+          << shard.map.size() << "/" << shard.list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 
   return stmt;
@@ -186,11 +201,12 @@ shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Get exclusive lock of the shard before looking up a prepared statement.
+  auto& shard = GetPreparedStmtsShard(query_id);
+  std::lock_guard<ProfiledMutex> guard(shard.mutex);
 
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
+  const auto itr = shard.map.find(query_id);
+  if (itr == shard.map.end()) {
     return nullptr;
   }
 
@@ -202,64 +218,128 @@ shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
   }
   // If the statement is stale, delete it.
   if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
+    DeletePreparedStatementUnlocked(&shard, stmt);
     return nullptr;
   }
 
-  MoveLruPreparedStatementUnlocked(stmt);
+  stmt->MarkUsed();
   return stmt;
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
-  // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Get exclusive lock of the shard before deleting the prepared statement.
+  auto& shard = GetPreparedStmtsShard(stmt->query_id());
+  std::lock_guard<ProfiledMutex> guard(shard.mutex);
 
-  DeletePreparedStatementUnlocked(stmt);
+  DeletePreparedStatementUnlocked(&shard, stmt);
 
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
+  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache shard count = "
+          << shard.map.size() << "/" << shard.list.size()
           << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
 }
 
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
 void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
+    PreparedStmtsShard* shard, const std::shared_ptr<const CQLStatement> stmt) {
   // Remove statement from cache by looking it up by query ID and only when it is same statement
   // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
+  // a separate copy of the shared_ptr and not the very shared_ptr in the map or the list we are
+  // deleting.
+  const auto itr = shard->map.find(stmt->query_id());
+  if (itr != shard->map.end() && itr->second == stmt) {
+    shard->map.erase(itr);
   }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
+  // Remove statement from the list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != shard->list.end()) {
+    shard->list.erase(stmt->pos());
+    stmt->set_pos(shard->list.end());
   }
 }
 
 void CQLServiceImpl::CollectGarbage(size_t required) {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
+  // Delete a statement from the first non-empty shard, visiting shards in round-robin order. In
+  // the shard, statements are checked from the end of the list using the clock algorithm: a
+  // statement used since it was last checked is moved to the front of the list, and the first one
+  // not used is deleted. The number of checks is limited, because statements may be marked as
+  // used concurrently.
+  for (size_t i = 0; i != kNumPreparedStmtsShards; ++i) {
+    auto& shard = prepared_stmts_shards_[
+        next_prepared_stmts_shard_to_collect_.fetch_add(1, std::memory_order_relaxed) %
+        kNumPreparedStmtsShards];
+    std::lock_guard<ProfiledMutex> guard(shard.mutex);
+    if (shard.list.empty()) {
+      continue;
+    }
 
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
+    for (size_t checks = shard.list.size(); checks != 0; --checks) {
+      const auto& stmt = shard.list.back();
+      if (!stmt->ResetUsed()) {
+        break;
+      }
+      shard.list.splice(shard.list.begin(), shard.list, stmt->pos());
+    }
+    DeletePreparedStatementUnlocked(&shard, shard.list.back());
+
+    VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache shard count = "
+            << shard.map.size() << "/" << shard.list.size()
+            << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+    return;
+  }
+}
+
+shared_ptr<CQLStatement> CQLServiceImpl::AllocateUnpreparedStatement(
+    const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
+  // Get exclusive lock before allocating an unprepared statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(unprepared_stmts_mutex_);
+
+  auto itr = unprepared_stmts_map_.find(query_id);
+  // If the statement is stale, delete it and allocate a new one.
+  if (itr != unprepared_stmts_map_.end() && !itr->second->unprepared() && itr->second->stale()) {
+    DeleteUnpreparedStatementUnlocked(itr->second);
+    itr = unprepared_stmts_map_.end();
   }
 
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  shared_ptr<CQLStatement> stmt;
+  if (itr == unprepared_stmts_map_.end()) {
+    // Same as for prepared statements, clients running the same new query in parallel contend on
+    // the placeholder, so the query is prepared only once.
+    stmt = unprepared_stmts_map_.emplace(
+        query_id, std::make_shared<CQLStatement>(
+            keyspace, query, unprepared_stmts_list_.end())).first->second;
+    stmt->set_pos(unprepared_stmts_list_.insert(unprepared_stmts_list_.begin(), stmt));
+    // Unprepared queries often differ only in literals, so the cache is limited by the number of
+    // statements rather than by memory, and the least recently used ones are deleted.
+    while (unprepared_stmts_list_.size() >
+           std::max<size_t>(FLAGS_cql_service_max_unprepared_statements, 1)) {
+      DeleteUnpreparedStatementUnlocked(unprepared_stmts_list_.back());
+    }
+  } else {
+    // Return existing statement if found.
+    stmt = itr->second;
+    unprepared_stmts_list_.splice(
+        unprepared_stmts_list_.begin(), unprepared_stmts_list_, stmt->pos());
+  }
+
+  return stmt;
+}
+
+void CQLServiceImpl::DeleteUnpreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
+  // Get exclusive lock before deleting the unprepared statement.
+  std::lock_guard<std::mutex> guard(unprepared_stmts_mutex_);
+
+  DeleteUnpreparedStatementUnlocked(stmt);
+}
+
+void CQLServiceImpl::DeleteUnpreparedStatementUnlocked(
+    const std::shared_ptr<const CQLStatement> stmt) {
+  // See DeletePreparedStatementUnlocked.
+  const auto itr = unprepared_stmts_map_.find(stmt->query_id());
+  if (itr != unprepared_stmts_map_.end() && itr->second == stmt) {
+    unprepared_stmts_map_.erase(itr);
+  }
+  if (stmt->pos() != unprepared_stmts_list_.end()) {
+    unprepared_stmts_list_.erase(stmt->pos());
+    stmt->set_pos(unprepared_stmts_list_.end());
+  }
 }
 
 client::TransactionManager* CQLServiceImpl::GetTransactionManager() {
@@ -17,6 +17,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_SERVICE_H_
 
+#include <array>
 #include <vector>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -26,6 +27,7 @@
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
 
+#include "yb/util/profiled_mutex.h"
 #include "yb/util/string_case.h"
 
 #include "yb/client/async_initializer.h"
@@ -62,6 +64,9 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Processing all incoming request from RPC and sending response back.
   void Handle(yb::rpc::InboundCallPtr call) override;
 
+  // Either gets an available processor or creates a new one.
+  CQLProcessor *GetProcessor();
+
   // Return CQL processor at pos as available.
   void ReturnProcessor(const CQLProcessorListPos& pos);
 
@@ -82,6 +87,19 @@ class CQLServiceImpl : public CQLServerServiceIf,
     return prepared_stmts_mem_tracker_;
   }
 
+  // Allocate a statement for an unprepared query (QUERY request) to cache its parse tree. If the
+  // statement already exists, return it instead.
+  std::shared_ptr<CQLStatement> AllocateUnpreparedStatement(
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& query);
+
+  // Delete the unprepared statement from the cache.
+  void DeleteUnpreparedStatement(const std::shared_ptr<const CQLStatement>& stmt);
+
+  // Return the memory tracker for unprepared statements.
+  const MemTrackerPtr& unprepared_stmts_mem_tracker() const {
+    return unprepared_stmts_mem_tracker_;
+  }
+
   // Return the YBClient to communicate with either master or tserver.
   const std::shared_ptr<client::YBClient>& client() const;
 
@@ -101,24 +119,39 @@ class CQLServiceImpl : public CQLServerServiceIf,
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
-  // Either gets an available processor or creates a new one.
-  CQLProcessor *GetProcessor();
+  // Number of shards of the prepared statements cache.
+  static constexpr size_t kNumPreparedStmtsShards = 16;
+
+  // A shard of the prepared statements cache. Statements are looked up in the shard by their
+  // query ids.
+  struct PreparedStmtsShard {
+    // Prepared statements cache.
+    CQLStatementMap map;
+
+    // Prepared statements in the eviction order. Hits only mark statements as used, the list is
+    // reordered only when looking for a statement to evict (see CollectGarbage).
+    CQLStatementList list;
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+    // Mutex that protects the map and the list.
+    ProfiledMutex mutex;
+  };
 
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+  // Return the shard of the prepared statements cache the query id belongs to.
+  PreparedStmtsShard& GetPreparedStmtsShard(const CQLMessage::QueryId& query_id);
 
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+  // Delete a prepared statement from the shard. The mutex of the shard needs to be locked before
+  // this call.
+  static void DeletePreparedStatementUnlocked(PreparedStmtsShard* shard,
+                                              const std::shared_ptr<const CQLStatement> stmt);
 
-  // Delete the least recently used prepared statement from the cache to free up memory.
+  // Delete an approximately least recently used prepared statement from the cache to free up
+  // memory.
   void CollectGarbage(size_t required) override;
 
+  // Delete an unprepared statement from the cache and the LRU list. "unprepared_stmts_mutex_"
+  // needs to be locked before this call.
+  void DeleteUnpreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+
   // CQLServer of this service.
   CQLServer* const server_;
 
@@ -138,22 +171,27 @@ class CQLServiceImpl : public CQLServerServiceIf,
   CQLProcessorListPos next_available_processor_;
 
   // Mutex that protects access to processors_.
-  std::mutex processors_mutex_;
-
-  // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
+  ProfiledMutex processors_mutex_;
 
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
+  // Prepared statements cache. It is sharded so that concurrent EXECUTE requests of different
+  // statements do not contend on a single mutex.
+  std::array<PreparedStmtsShard, kNumPreparedStmtsShards> prepared_stmts_shards_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Shard to delete a statement from upon the next garbage collection.
+  std::atomic<size_t> next_prepared_stmts_shard_to_collect_{0};
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
   // Tracker to measure and limit memory usage of prepared statements.
   MemTrackerPtr prepared_stmts_mem_tracker_;
 
+  // Unprepared statements cache, LRU list (least recently used one at the end), the mutex that
+  // protects them and the tracker to measure their memory usage.
+  CQLStatementMap unprepared_stmts_map_;
+  CQLStatementList unprepared_stmts_list_;
+  std::mutex unprepared_stmts_mutex_;
+  MemTrackerPtr unprepared_stmts_mem_tracker_;
+
   // Metrics to be collected and reported.
   yb::rpc::RpcMethodMetrics metrics_;
 
@@ -19,6 +19,7 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <atomic>
 #include <list>
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
@@ -51,12 +52,26 @@ class CQLStatement : public ql::Statement {
   CQLStatementListPos pos() const { return pos_; }
   void set_pos(CQLStatementListPos pos) const { pos_ = pos; }
 
+  // Mark the statement as used since it was last checked for eviction. The flag is only written
+  // when not set yet, so hits of a popular statement do not keep invalidating its cache line.
+  void MarkUsed() const {
+    if (!used_.load(std::memory_order_relaxed)) {
+      used_.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Clear the used mark and return whether it was set.
+  bool ResetUsed() const { return used_.exchange(false, std::memory_order_relaxed); }
+
   // Return the query id of a statement.
   static CQLMessage::QueryId GetQueryId(const std::string& keyspace, const std::string& query);
 
  private:
   // Position of the statement in the LRU.
   mutable CQLStatementListPos pos_;
+
+  // Whether the statement was used since it was last checked for eviction.
+  mutable std::atomic<bool> used_{false};
 };
 
 }  // namespace cqlserver
@@ -186,6 +186,18 @@ TEST_F(TestCQLService, OptionsRequest) {
                                "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2"));
 }
 
+TEST_F(TestCQLService, TracedRequest) {
+  LOG(INFO) << "Test CQL request with tracing flag";
+  // Send OPTIONS request with tracing flag using version V4, and check that the response header
+  // has the warning flag set, since the trace is returned as a warning.
+  ASSERT_OK(SendRequestAndGetResponse(
+      BINARY_STRING("\x04\x02\x00\x00\x05" "\x00\x00\x00\x00"), 9 /* header length */));
+  // Version V4 response, warning flag, SUPPORTED opcode.
+  ASSERT_EQ(0x84, resp_[0]);
+  ASSERT_EQ(0x08, resp_[1]);
+  ASSERT_EQ(0x06, resp_[4]);
+}
+
 TEST_F(TestCQLService, InvalidRequest) {
   LOG(INFO) << "Test invalid CQL request";
   // Send response (0x84) as request
@@ -199,50 +199,120 @@ Status Executor::EvalSum(const shared_ptr<QLRowBlock>& row_block,
   return Status::OK();
 }
 
-Status Executor::EvalAvg(const shared_ptr<QLRowBlock>& row_block,
-                         int column_index,
-                         DataType data_type,
-                         QLValue *ql_value) {
-  QLValue sum, count;
+Status Executor::MergeAggregatePartials(const PTSelectStmt* pt_select,
+                                        TnodeContext* tnode_context) {
+  shared_ptr<RowsResult> rows_result = tnode_context->rows_result();
+  if (!pt_select->is_aggregate() || rows_result == nullptr) {
+    return Status::OK();
+  }
+  DCHECK(rows_result->client() == QLClient::YQL_CLIENT_CQL);
+  const size_t row_count = VERIFY_RESULT(QLRowBlock::GetRowCount(rows_result->client(),
+                                                                  rows_result->rows_data()));
+  if (row_count <= 1) {
+    return Status::OK();
+  }
+
+  shared_ptr<QLRowBlock> row_block = rows_result->GetRowBlock();
+  int column_index = 0;
+  faststring buffer;
+
+  CQLEncodeLength(1, &buffer);
+  for (auto expr_node : pt_select->selected_exprs()) {
+    QLValue ql_value;
+
+    switch (expr_node->aggregate_opcode()) {
+      case TSOpcode::kNoOp:
+        break;
+      case TSOpcode::kAvg: {
+        // The partial result of AVG() is a single-entry map of count to sum.
+        QLValue sum, count;
+        RETURN_NOT_OK(EvalAvgPartials(row_block, column_index, expr_node->ql_type()->main(),
+                                      &sum, &count));
+        if (!count.IsNull()) {
+          ql_value.set_map_value();
+          *ql_value.add_map_key() = count.value();
+          *ql_value.add_map_value() = sum.value();
+        }
+        break;
+      }
+      case TSOpcode::kCount:
+        RETURN_NOT_OK(EvalCount(row_block, column_index, &ql_value));
+        break;
+      case TSOpcode::kMax:
+        RETURN_NOT_OK(EvalMax(row_block, column_index, &ql_value));
+        break;
+      case TSOpcode::kMin:
+        RETURN_NOT_OK(EvalMin(row_block, column_index, &ql_value));
+        break;
+      case TSOpcode::kSum:
+        RETURN_NOT_OK(EvalSum(row_block, column_index, expr_node->ql_type()->main(), &ql_value));
+        break;
+      default:
+        return STATUS(RuntimeError, "Unexpected operator while merging aggregate expressions");
+    }
 
+    // Serialize the partial value using the type of the column received from tablet servers.
+    ql_value.Serialize(rows_result->column_schemas()[column_index].type(), rows_result->client(),
+                       &buffer);
+    column_index++;
+  }
+
+  rows_result->set_rows_data(buffer.c_str(), buffer.size());
+  return Status::OK();
+}
+
+Status Executor::EvalAvgPartials(const shared_ptr<QLRowBlock>& row_block,
+                                 int column_index,
+                                 DataType data_type,
+                                 QLValue *sum,
+                                 QLValue *count) {
   for (auto row : row_block->rows()) {
     if (row.column(column_index).IsNull()) {
       continue;
     }
     QLMapValuePB map = row.column(column_index).map_value();
-    if (count.IsNull()) {
-      count = QLValue(map.keys(0));
-      sum = QLValue(map.values(0));
+    if (count->IsNull()) {
+      *count = QLValue(map.keys(0));
+      *sum = QLValue(map.values(0));
       continue;
     }
 
-    count.set_int64_value(count.int64_value() + map.keys(0).int64_value());
+    count->set_int64_value(count->int64_value() + map.keys(0).int64_value());
     switch (data_type) {
       case DataType::INT8:
-        sum.set_int8_value(sum.int8_value() + map.values(0).int8_value());
+        sum->set_int8_value(sum->int8_value() + map.values(0).int8_value());
         break;
       case DataType::INT16:
-        sum.set_int16_value(sum.int16_value() + map.values(0).int16_value());
+        sum->set_int16_value(sum->int16_value() + map.values(0).int16_value());
         break;
       case DataType::INT32:
-        sum.set_int32_value(sum.int32_value() + map.values(0).int32_value());
+        sum->set_int32_value(sum->int32_value() + map.values(0).int32_value());
         break;
       case DataType::INT64:
-        sum.set_int64_value(sum.int64_value() + map.values(0).int64_value());
+        sum->set_int64_value(sum->int64_value() + map.values(0).int64_value());
         break;
       case DataType::VARINT:
-        sum.set_varint_value(sum.varint_value() + QLValue(map.values(0)).varint_value());
+        sum->set_varint_value(sum->varint_value() + QLValue(map.values(0)).varint_value());
         break;
       case DataType::FLOAT:
-        sum.set_float_value(sum.float_value() + map.values(0).float_value());
+        sum->set_float_value(sum->float_value() + map.values(0).float_value());
         break;
       case DataType::DOUBLE:
-        sum.set_double_value(sum.double_value() + map.values(0).double_value());
+        sum->set_double_value(sum->double_value() + map.values(0).double_value());
         break;
       default:
         return STATUS(RuntimeError, "Unexpected datatype for argument of AVG()");
     }
   }
+  return Status::OK();
+}
+
+Status Executor::EvalAvg(const shared_ptr<QLRowBlock>& row_block,
+                         int column_index,
+                         DataType data_type,
+                         QLValue *ql_value) {
+  QLValue sum, count;
+  RETURN_NOT_OK(EvalAvgPartials(row_block, column_index, data_type, &sum, &count));
 
   switch (data_type) {
     case DataType::INT8:
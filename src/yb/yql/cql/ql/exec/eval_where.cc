@@ -315,6 +315,54 @@ Status Executor::WhereKeyToPB(QLReadRequestPB *req,
   return Status::OK();
 }
 
+Status Executor::WhereKeysToPB(QLReadRequestPB *req,
+                               const Schema& schema,
+                               const std::vector<const QLRow*>& keys) {
+  DCHECK(!keys.empty());
+  if (keys.size() == 1) {
+    return WhereKeyToPB(req, schema, *keys.front());
+  }
+
+  // Add the hash column values and the values of all range columns but the last one, which are
+  // the same for all the keys.
+  const QLRow& first_key = *keys.front();
+  DCHECK(req->hashed_column_values().empty());
+  for (size_t idx = 0; idx < schema.num_hash_key_columns(); idx++) {
+    *req->add_hashed_column_values()->mutable_value() = first_key.column(idx).value();
+  }
+
+  QLConditionPB *where_pb = req->mutable_where_expr()->mutable_condition();
+  if (!where_pb->has_op()) {
+    where_pb->set_op(QL_OP_AND);
+  }
+  DCHECK_EQ(where_pb->op(), QL_OP_AND);
+  const size_t last_idx = schema.num_key_columns() - 1;
+  DCHECK_GE(last_idx, schema.num_hash_key_columns());
+  for (size_t idx = schema.num_hash_key_columns(); idx < last_idx; idx++) {
+    QLConditionPB *col_cond_pb = where_pb->add_operands()->mutable_condition();
+    col_cond_pb->set_op(QL_OP_EQUAL);
+    col_cond_pb->add_operands()->set_column_id(schema.column_id(idx));
+    *col_cond_pb->add_operands()->mutable_value() = first_key.column(idx).value();
+  }
+
+  // Add the values of the last range column as IN condition arguments which must be de-duplicated
+  // and ordered.
+  std::set<QLValuePB> opts_set;
+  for (const QLRow* key : keys) {
+    opts_set.insert(key->column(last_idx).value());
+  }
+  QLConditionPB *col_cond_pb = where_pb->add_operands()->mutable_condition();
+  col_cond_pb->set_op(QL_OP_IN);
+  col_cond_pb->add_operands()->set_column_id(schema.column_id(last_idx));
+  QLValuePB* list_pb = col_cond_pb->add_operands()->mutable_value();
+  list_pb->mutable_list_value(); // Set value type to list.
+  for (const auto& value_pb : opts_set) {
+    *list_pb->mutable_list_value()->add_elems() = value_pb;
+  }
+
+  return Status::OK();
+}
+
 Status Executor::WhereJsonColOpToPB(QLConditionPB *condition, const JsonColumnOp& col_op) {
   // Set the operator.
   condition->set_op(col_op.yb_op());
@@ -115,10 +115,43 @@ class TnodeContext {
     return current_partition_index_;
   }
 
+  void set_current_partition_index(const uint64_t index) {
+    current_partition_index_ = index;
+  }
+
   void set_partitions_count(const uint64_t count) {
     partitions_count_ = count;
   }
 
+  // Used for multi-partition selects that read the partitions following the current one ahead in
+  // parallel. Each entry is the op reading a partition, starting from the current one, and its rows
+  // result once the op is done. Empty when partitions are not read ahead.
+  std::vector<std::pair<client::YBqlReadOpPtr, RowsResult::SharedPtr>>& read_ahead_partitions() {
+    return read_ahead_partitions_;
+  }
+
+  // Used for multi-partition selects with ORDER BY and LIMIT, which read all partitions in parallel
+  // and merge their rows in the order of the clustering columns. Each entry is the position of a
+  // clustering column in the selected rows and whether the rows are in its ascending order. Empty
+  // when the partitions are not merged.
+  const std::vector<std::pair<size_t, bool>>& merge_order() const {
+    return merge_order_;
+  }
+
+  size_t merge_limit() const {
+    return merge_limit_;
+  }
+
+  void set_merge_order(std::vector<std::pair<size_t, bool>> merge_order, size_t limit) {
+    merge_order_ = std::move(merge_order);
+    merge_limit_ = limit;
+  }
+
+  // Rows results of the partitions to merge, kept until all partitions are read.
+  std::vector<RowsResult::SharedPtr>& partition_rows_results() {
+    return partition_rows_results_;
+  }
+
   // Access functions for child tnode context.
   TnodeContext* AddChildTnode(const TreeNode* tnode) {
     DCHECK(!child_context_);
@@ -163,6 +196,14 @@ class TnodeContext {
   uint64_t partitions_count_ = 0;
   uint64_t current_partition_index_ = 0;
 
+  // Order, row limit and rows results of partitions read in parallel to be merged.
+  std::vector<std::pair<size_t, bool>> merge_order_;
+  size_t merge_limit_ = 0;
+  std::vector<RowsResult::SharedPtr> partition_rows_results_;
+
+  // Ops and rows results of partitions read ahead.
+  std::vector<std::pair<client::YBqlReadOpPtr, RowsResult::SharedPtr>> read_ahead_partitions_;
+
   // Rows result of this statement tnode for DML statements.
   RowsResult::SharedPtr rows_result_;
 
@@ -13,6 +13,9 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <map>
+#include <vector>
+
 #include <yb/yql/cql/ql/util/errcodes.h>
 #include "yb/yql/cql/ql/exec/executor.h"
 #include "yb/yql/cql/ql/ql_processor.h"
@@ -24,10 +27,24 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_uint64(cql_max_result_page_size_bytes, 16 * 1024 * 1024,
+              "When a paged SELECT has read this many bytes of rows, the rows are returned to the "
+              "client with a paging state even if the page size has not been reached, so the proxy "
+              "does not buffer large pages. 0 means pages are limited by the number of rows only.");
+TAG_FLAG(cql_max_result_page_size_bytes, advanced);
+
+DEFINE_int32(cql_max_read_ahead_partitions, 16,
+             "Maximum number of partitions of a SELECT with IN conditions on the hash columns that "
+             "are read in parallel when the number of rows of the partitions is not known. 1 means "
+             "the partitions are read one by one.");
+TAG_FLAG(cql_max_read_ahead_partitions, advanced);
+TAG_FLAG(cql_max_read_ahead_partitions, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -634,6 +651,51 @@ Status Executor::GetOffsetOrLimit(
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+// Returns the positions of the clustering columns in the rows selected by the statement, with
+// whether the rows of a partition are returned in their ascending order. Returns an empty vector
+// when not all clustering columns are selected, since the rows cannot be merged then.
+std::vector<std::pair<size_t, bool>> ClusteringColumnsOrder(const PTSelectStmt* tnode) {
+  const auto& schema = tnode->table()->schema();
+  const size_t num_hash_key_columns = schema.num_hash_key_columns();
+  const size_t num_key_columns = schema.num_key_columns();
+  std::vector<boost::optional<size_t>> positions(num_key_columns - num_hash_key_columns);
+  size_t position = 0;
+  auto add_column = [&](size_t index) {
+    if (index >= num_hash_key_columns && index < num_key_columns &&
+        !positions[index - num_hash_key_columns]) {
+      positions[index - num_hash_key_columns] = position;
+    }
+    ++position;
+  };
+  for (const auto& expr : tnode->selected_exprs()) {
+    if (expr->opcode() == TreeNodeOpcode::kPTAllColumns) {
+      for (const auto& column : static_cast<const PTAllColumns*>(expr.get())->columns()) {
+        add_column(column.index());
+      }
+    } else if (expr->opcode() == TreeNodeOpcode::kPTRef) {
+      add_column(static_cast<const PTRef*>(expr.get())->desc()->index());
+    } else {
+      ++position;
+    }
+  }
+
+  std::vector<std::pair<size_t, bool>> order;
+  order.reserve(positions.size());
+  for (size_t i = 0; i < positions.size(); ++i) {
+    if (!positions[i]) {
+      return {};
+    }
+    const bool descending = schema.Column(num_hash_key_columns + i).sorting_type() ==
+                            ColumnSchema::SortingType::kDescending;
+    order.emplace_back(*positions[i], descending != tnode->is_forward_scan());
+  }
+  return order;
+}
+
+} // namespace
+
 Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_context) {
   const shared_ptr<client::YBTable>& table = tnode->table();
   if (table == nullptr) {
@@ -785,10 +847,21 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     tnode_context->InitializePartition(select_op->mutable_request(),
                                        continue_select ? params.next_partition_index() : 0);
 
+    // With ORDER BY and a LIMIT within the page size, each tablet returns the first rows of its
+    // partition in the requested order, so the rows of all partitions can be read in parallel and
+    // merged, instead of reading all rows of the partitions one by one.
+    if (tnode->order_by_clause() && tnode->limit() && !req->return_paging_state() &&
+        !req->has_offset() && !tnode->distinct() && !tnode->child_select() &&
+        tnode_context->UnreadPartitionsRemaining() > 1) {
+      tnode_context->set_merge_order(ClusteringColumnsOrder(tnode), req->limit());
+    }
+
     // We can optimize to run the ops in parallel (rather than serially) if:
-    // - the estimated max number of rows is less than req limit (min of page size and CQL limit).
+    // - the estimated max number of rows is less than req limit (min of page size and CQL limit),
+    //   or the rows of the partitions are merged.
     // - there is no offset (which requires passing skipped rows from one request to the next).
-    if (*max_rows_estimate <= req->limit() && !req->has_offset()) {
+    if ((*max_rows_estimate <= req->limit() || !tnode_context->merge_order().empty()) &&
+        !req->has_offset()) {
       RETURN_NOT_OK(AddOperation(select_op, tnode_context));
       while (tnode_context->UnreadPartitionsRemaining() > 1) {
         YBqlReadOpPtr op(table->NewQLSelect());
@@ -800,6 +873,13 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
       }
       return Status::OK();
     }
+
+    // Otherwise the rows of the partitions are returned in the partition order, but the next
+    // partitions are read ahead in parallel instead of one by one after the current one is read.
+    if (FLAGS_cql_max_read_ahead_partitions > 1 && !req->has_offset() && !tnode->is_aggregate() &&
+        !tnode->child_select() && tnode_context->UnreadPartitionsRemaining() > 1) {
+      return ReadAheadPartitions(select_op, tnode_context);
+    }
   }
 
   // If this select statement uses an uncovered index underneath, save this op as a template to
@@ -817,6 +897,122 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   return AddOperation(select_op, tnode_context);
 }
 
+Status Executor::MergeSortedPartitions(TnodeContext* tnode_context) {
+  auto& partition_results = tnode_context->partition_rows_results();
+  if (partition_results.empty()) {
+    return Status::OK();
+  }
+
+  std::vector<std::unique_ptr<QLRowBlock>> row_blocks;
+  row_blocks.reserve(partition_results.size());
+  for (const auto& result : partition_results) {
+    row_blocks.push_back(result->GetRowBlock());
+  }
+
+  // The rows of each partition are already in order, so the next row is the least of the next rows
+  // of all partitions.
+  const auto& order = tnode_context->merge_order();
+  auto less = [&order](const QLRow& lhs, const QLRow& rhs) {
+    for (const auto& column : order) {
+      const int result = lhs.column(column.first).CompareTo(rhs.column(column.first));
+      if (result != 0) {
+        return column.second ? result < 0 : result > 0;
+      }
+    }
+    return false;
+  };
+  std::vector<size_t> next_rows(row_blocks.size(), 0);
+  QLRowBlock merged(row_blocks.front()->schema());
+  while (merged.row_count() < tnode_context->merge_limit()) {
+    QLRowBlock* next_block = nullptr;
+    size_t* next_row = nullptr;
+    for (size_t i = 0; i < row_blocks.size(); ++i) {
+      if (next_rows[i] < row_blocks[i]->row_count() &&
+          (next_block == nullptr ||
+           less(row_blocks[i]->row(next_rows[i]), next_block->row(*next_row)))) {
+        next_block = row_blocks[i].get();
+        next_row = &next_rows[i];
+      }
+    }
+    if (next_block == nullptr) {
+      break;
+    }
+    merged.rows().push_back(std::move(next_block->row((*next_row)++)));
+  }
+
+  faststring buffer;
+  merged.Serialize(YQL_CLIENT_CQL, &buffer);
+  RowsResult::SharedPtr result = std::move(partition_results.front());
+  partition_results.clear();
+  result->rows_data() = buffer.ToString();
+  return tnode_context->AppendRowsResult(std::move(result));
+}
+
+Status Executor::ReadAheadPartitions(const YBqlReadOpPtr& op, TnodeContext* tnode_context) {
+  auto& partitions = tnode_context->read_ahead_partitions();
+  DCHECK(partitions.empty());
+  const uint64_t current_partition_index = tnode_context->current_partition_index();
+  const uint64_t count = std::min<uint64_t>(FLAGS_cql_max_read_ahead_partitions,
+                                            tnode_context->UnreadPartitionsRemaining());
+  YBqlReadOpPtr partition_op = op;
+  for (uint64_t i = 0; i < count; i++) {
+    if (i > 0) {
+      // The next partitions are read from their start, with the limit of the current one.
+      YBqlReadOpPtr next_op(op->table()->NewQLSelect());
+      next_op->mutable_request()->CopyFrom(partition_op->request());
+      next_op->set_yb_consistency_level(op->yb_consistency_level());
+      if (next_op->request().has_paging_state()) {
+        QLPagingStatePB* paging_state = next_op->mutable_request()->mutable_paging_state();
+        paging_state->clear_next_partition_key();
+        paging_state->clear_next_row_key();
+      }
+      tnode_context->AdvanceToNextPartition(next_op->mutable_request());
+      partition_op = next_op;
+    }
+    partitions.emplace_back(partition_op, nullptr);
+    RETURN_NOT_OK(AddOperation(partition_op, tnode_context));
+  }
+  tnode_context->set_current_partition_index(current_partition_index);
+  return Status::OK();
+}
+
+Result<bool> Executor::AppendReadAheadPartitions(const PTSelectStmt* tnode,
+                                                 TnodeContext* tnode_context) {
+  auto partitions = std::move(tnode_context->read_ahead_partitions());
+  tnode_context->read_ahead_partitions().clear();
+
+  // Continue with the rows of each partition as if it was read after the preceding one, until the
+  // select is done or has to read a partition again: to continue the partition when not all of its
+  // rows were returned, or because more rows were read ahead than the limit left for it.
+  const uint64_t first_partition_index = tnode_context->current_partition_index();
+  YBqlReadOpPtr next_op;
+  for (size_t i = 0; i < partitions.size(); i++) {
+    const YBqlReadOpPtr& op = partitions[i].first;
+    RowsResult::SharedPtr& result = partitions[i].second;
+    if (!result) {
+      return STATUS(InternalError, "Missing result for partition read ahead");
+    }
+    if (next_op != nullptr) {
+      if (tnode_context->current_partition_index() != first_partition_index + i ||
+          VERIFY_RESULT(QLRowBlock::GetRowCount(YQL_CLIENT_CQL, result->rows_data())) >
+              next_op->request().limit()) {
+        break;
+      }
+    }
+    if (!result->rows_data().empty()) {
+      RETURN_NOT_OK(tnode_context->AppendRowsResult(std::move(result)));
+    }
+    if (!VERIFY_RESULT(FetchMoreRows(tnode, op, tnode_context, exec_context_))) {
+      return false;
+    }
+    next_op = op;
+  }
+
+  next_op->mutable_response()->Clear();
+  RETURN_NOT_OK(ReadAheadPartitions(next_op, tnode_context));
+  return true;
+}
+
 Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
                                      const YBqlReadOpPtr& op,
                                      TnodeContext* tnode_context,
@@ -884,8 +1080,14 @@ Result<bool> Executor::FetchMoreRows(const PTSelectStmt* tnode,
     tnode_context->AdvanceToNextPartition(op->mutable_request());
   }
 
-  // If we reached the fetch limit (min of paging state and limit clause) we are done.
-  if (current_fetch_row_count >= fetch_limit) {
+  // If we reached the fetch limit (min of paging state and limit clause) we are done. A paged
+  // non-aggregate select is also done when the rows read so far reach the result size limit, so
+  // the rows are sent to the client without waiting for the rest of the page.
+  const bool result_size_limit_reached =
+      FLAGS_cql_max_result_page_size_bytes > 0 && !tnode->is_aggregate() &&
+      op->request().return_paging_state() &&
+      current_result->rows_data().size() >= FLAGS_cql_max_result_page_size_bytes;
+  if (current_fetch_row_count >= fetch_limit || result_size_limit_reached) {
 
     // If we need to return a paging state to the user, we create it here so that we can resume from
     // the exact place where we left off: partition index and primary key within that partition.
@@ -937,15 +1139,42 @@ Result<bool> Executor::FetchRowsByKeys(const PTSelectStmt* tnode,
                                        const QLRowBlock& keys,
                                        TnodeContext* tnode_context) {
   const Schema& schema = tnode->table()->InternalSchema();
-  for (const QLRow& key : keys.rows()) {
+
+  // Group the keys that differ in the last range column only, so the rows of each group are read
+  // by one request with an IN condition instead of one request per key. The groups keep the order
+  // in which their first keys were returned from the index.
+  std::vector<std::vector<const QLRow*>> groups;
+  if (schema.num_range_key_columns() > 0) {
+    std::map<std::vector<QLValuePB>, size_t> group_index;
+    const size_t prefix_size = schema.num_key_columns() - 1;
+    for (const QLRow& key : keys.rows()) {
+      std::vector<QLValuePB> prefix;
+      prefix.reserve(prefix_size);
+      for (size_t idx = 0; idx < prefix_size; idx++) {
+        prefix.push_back(key.column(idx).value());
+      }
+      auto it = group_index.emplace(std::move(prefix), groups.size()).first;
+      if (it->second == groups.size()) {
+        groups.emplace_back();
+      }
+      groups[it->second].push_back(&key);
+    }
+  } else {
+    groups.reserve(keys.rows().size());
+    for (const QLRow& key : keys.rows()) {
+      groups.push_back({&key});
+    }
+  }
+
+  for (const auto& group : groups) {
     YBqlReadOpPtr op(tnode->table()->NewQLSelect());
     op->set_yb_consistency_level(select_op->yb_consistency_level());
     QLReadRequestPB* req = op->mutable_request();
     req->CopyFrom(select_op->request());
-    RETURN_NOT_OK(WhereKeyToPB(req, schema, key));
+    RETURN_NOT_OK(WhereKeysToPB(req, schema, group));
     RETURN_NOT_OK(AddOperation(op, tnode_context));
   }
-  return !keys.rows().empty();
+  return !groups.empty();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1566,18 +1795,37 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       continue;
     }
 
-    // Append the rows if present.
+    // The rows of partitions read ahead are kept until all of them are read.
+    auto& read_ahead_partitions = tnode_context->read_ahead_partitions();
+    if (!read_ahead_partitions.empty()) {
+      for (auto& partition : read_ahead_partitions) {
+        if (partition.first == op) {
+          partition.second = std::make_shared<RowsResult>(partition.first.get());
+        }
+      }
+      op_itr = ops.erase(op_itr);
+      continue;
+    }
+
+    // Append the rows if present. The rows of partitions that are merged are kept until all
+    // partitions are read.
     if (!op->rows_data().empty()) {
-      RETURN_NOT_OK(tnode_context->AppendRowsResult(std::make_shared<RowsResult>(op.get())));
+      if (!tnode_context->merge_order().empty()) {
+        tnode_context->partition_rows_results().push_back(std::make_shared<RowsResult>(op.get()));
+      } else {
+        RETURN_NOT_OK(tnode_context->AppendRowsResult(std::make_shared<RowsResult>(op.get())));
+      }
     }
 
     // For SELECT statement, check if there are more rows to fetch and apply the op as needed.
     if (tnode->opcode() == TreeNodeOpcode::kPTSelectStmt) {
       const auto* select_stmt = static_cast<const PTSelectStmt *>(tnode);
+      // Keep a single row of partial aggregates instead of one row per tablet response.
+      RETURN_NOT_OK(MergeAggregatePartials(select_stmt, tnode_context));
       // Do this except for the parent SELECT with an index. For covered index, we will select
       // from the index only. For uncovered index, the parent SELECT will fetch using the primary
       // keys returned from below.
-      if (!select_stmt->child_select()) {
+      if (!select_stmt->child_select() && tnode_context->merge_order().empty()) {
         DCHECK_EQ(op->type(), YBOperation::Type::QL_READ);
         const auto& read_op = std::static_pointer_cast<YBqlReadOp>(op);
         if (VERIFY_RESULT(FetchMoreRows(select_stmt, read_op, tnode_context, exec_context_))) {
@@ -1595,6 +1843,18 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
     op_itr = ops.erase(op_itr);
   }
 
+  if (ops.empty() && !tnode_context->merge_order().empty()) {
+    RETURN_NOT_OK(MergeSortedPartitions(tnode_context));
+  }
+
+  if (ops.empty() && !tnode_context->read_ahead_partitions().empty()) {
+    DCHECK_EQ(tnode->opcode(), TreeNodeOpcode::kPTSelectStmt);
+    if (VERIFY_RESULT(AppendReadAheadPartitions(
+            static_cast<const PTSelectStmt *>(tnode), tnode_context))) {
+      has_buffered_ops = true;
+    }
+  }
+
   // If there is a child context, process it.
   TnodeContext* child_context = tnode_context->child_context();
   if (child_context != nullptr) {
@@ -196,8 +196,27 @@ class Executor : public QLExprExecutor {
                                const QLRowBlock& keys,
                                TnodeContext* tnode_context);
 
+  // Merge the rows of the partitions read in parallel by a select with ORDER BY and LIMIT, and
+  // keep the first rows up to the limit in the order of the clustering columns.
+  CHECKED_STATUS MergeSortedPartitions(TnodeContext* tnode_context);
+
+  // Read the current partition of a multi-partition select with op, and the next partitions ahead
+  // in parallel, up to cql_max_read_ahead_partitions partitions.
+  CHECKED_STATUS ReadAheadPartitions(const client::YBqlReadOpPtr& op, TnodeContext* tnode_context);
+
+  // Append the rows of the partitions read ahead in the partition order, as long as they are the
+  // rows the select would read from the partitions one by one, and read ahead the next partitions
+  // if the select is not done. Returns true if more partitions are being read.
+  Result<bool> AppendReadAheadPartitions(const PTSelectStmt* tnode, TnodeContext* tnode_context);
+
   // Aggregate all result sets from all tablet servers to form the requested resultset.
   CHECKED_STATUS AggregateResultSets(const PTSelectStmt* pt_select, TnodeContext* tnode_context);
+
+  // Merge the partial aggregate rows received so far from tablet servers into a single row of
+  // partial aggregates, so that the proxy keeps only one row per aggregate SELECT regardless of
+  // the number of tablets and pages read.
+  CHECKED_STATUS MergeAggregatePartials(const PTSelectStmt* pt_select,
+                                        TnodeContext* tnode_context);
   CHECKED_STATUS EvalCount(const std::shared_ptr<QLRowBlock>& row_block,
                            int column_index,
                            QLValue *ql_value);
@@ -215,6 +234,12 @@ class Executor : public QLExprExecutor {
                          int column_index,
                          DataType data_type,
                          QLValue *ql_value);
+  // Add up the partial {count, sum} pairs of AVG() in the given column.
+  CHECKED_STATUS EvalAvgPartials(const std::shared_ptr<QLRowBlock>& row_block,
+                                 int column_index,
+                                 DataType data_type,
+                                 QLValue *sum,
+                                 QLValue *count);
 
   // Invoke statement executed callback.
   void StatementExecuted(const Status& s);
@@ -318,6 +343,12 @@ class Executor : public QLExprExecutor {
   // Set a primary key in a read request.
   CHECKED_STATUS WhereKeyToPB(QLReadRequestPB *req, const Schema& schema, const QLRow& key);
 
+  // Set several primary keys that differ in the last range column only in a read request, using
+  // an IN condition on that column.
+  CHECKED_STATUS WhereKeysToPB(QLReadRequestPB *req,
+                               const Schema& schema,
+                               const std::vector<const QLRow*>& keys);
+
   // Convert an expression op in where clause to protobuf.
   CHECKED_STATUS WhereOpToPB(QLConditionPB *condition, const ColumnOp& col_op);
   CHECKED_STATUS WhereSubColOpToPB(QLConditionPB *condition, const SubscriptedColumnOp& subcol_op);
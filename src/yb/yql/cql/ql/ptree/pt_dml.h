@@ -301,6 +301,12 @@ class PTDmlStmt : public PTCollection {
     return bind_variables_;
   }
 
+  // Bind variables of hash columns ordered by their column ids. Empty unless all hash columns are
+  // bound.
+  const MCSet<PTBindVar*, PTBindVar::HashColCmp>& hash_col_bindvars() const {
+    return hash_col_bindvars_;
+  }
+
   virtual std::vector<int64_t> hash_col_indices() const {
     std::vector<int64_t> indices;
     indices.reserve(hash_col_bindvars_.size());
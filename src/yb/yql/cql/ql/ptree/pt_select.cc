@@ -408,6 +408,10 @@ CHECKED_STATUS PTSelectStmt::AnalyzeIndexes(SemContext *sem_context) {
   selectivities.reserve(table_->index_map().size() + 1);
   selectivities.emplace_back(sem_context->PTempMem(), *this);
   for (const std::pair<TableId, IndexInfo>& index : table_->index_map()) {
+    // An index that is being backfilled does not have entries for all rows yet.
+    if (index.second.is_backfilling()) {
+      continue;
+    }
     selectivities.emplace_back(sem_context->PTempMem(), *this, index.second);
   }
   std::sort(selectivities.begin(), selectivities.end(), std::greater<Selectivity>());
@@ -30,6 +30,7 @@ using client::YBColumnSchema;
 const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPropertyDataTypes
     = {
     {"bloom_filter_fp_chance", KVProperty::kBloomFilterFpChance},
+    {"bloom_filter_range_components", KVProperty::kBloomFilterRangeComponents},
     {"caching", KVProperty::kCaching},
     {"comment", KVProperty::kComment},
     {"compaction", KVProperty::kCompaction},
@@ -38,10 +39,15 @@ const std::map<std::string, PTTableProperty::KVProperty> PTTableProperty::kPrope
     {"dclocal_read_repair_chance", KVProperty::kDclocalReadRepairChance},
     {"default_time_to_live", KVProperty::kDefaultTimeToLive},
     {"gc_grace_seconds", KVProperty::kGcGraceSeconds},
+    {"history_retention_max_seconds", KVProperty::kHistoryRetentionMaxSeconds},
+    {"history_retention_min_seconds", KVProperty::kHistoryRetentionMinSeconds},
+    {"in_memory", KVProperty::kInMemory},
     {"index_interval", KVProperty::kIndexInterval},
     {"memtable_flush_period_in_ms", KVProperty::kMemtableFlushPeriodInMs},
     {"min_index_interval", KVProperty::kMinIndexInterval},
     {"max_index_interval", KVProperty::kMaxIndexInterval},
+    {"min_blob_value_size", KVProperty::kMinBlobValueSize},
+    {"mmap_reads", KVProperty::kMmapReads},
     {"read_repair_chance", KVProperty::kReadRepairChance},
     {"speculative_retry", KVProperty::kSpeculativeRetry},
     {"transactions", KVProperty::kTransactions}
@@ -157,6 +163,7 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
 
   long double double_val;
   int64_t int_val;
+  bool bool_val;
   string str_val;
 
   switch (iterator->second) {
@@ -170,6 +177,21 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
             ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kBloomFilterRangeComponents:
+      // The bloom filter key is fixed when SST files are written, so it cannot be altered.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 cannot be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
+      if (int_val < 0) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be greater than or equal to 0 (got $1)",
+                                             table_property_name, std::to_string(int_val)).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
     case KVProperty::kDclocalReadRepairChance: FALLTHROUGH_INTENDED;
     case KVProperty::kReadRepairChance:
@@ -194,6 +216,8 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
       }
       break;
     case KVProperty::kGcGraceSeconds: FALLTHROUGH_INTENDED;
+    case KVProperty::kHistoryRetentionMaxSeconds: FALLTHROUGH_INTENDED;
+    case KVProperty::kHistoryRetentionMinSeconds: FALLTHROUGH_INTENDED;
     case KVProperty::kMemtableFlushPeriodInMs:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
       if (int_val < 0) {
@@ -215,6 +239,39 @@ CHECKED_STATUS PTTableProperty::Analyze(SemContext *sem_context) {
                                   ErrorCode::INVALID_ARGUMENTS);
       }
       break;
+    case KVProperty::kMinBlobValueSize:
+      // RocksDB options of a tablet are fixed when it is opened, so it cannot be altered.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 cannot be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetIntValueFromExpr(rhs_, table_property_name, &int_val));
+      if (int_val < 0) {
+        return sem_context->Error(this,
+                                  Substitute("$0 must be greater than or equal to 0 (got $1)",
+                                             table_property_name, std::to_string(int_val)).c_str(),
+                                  ErrorCode::INVALID_ARGUMENTS);
+      }
+      break;
+    case KVProperty::kInMemory:
+      // WAL options of a tablet are fixed when it is bootstrapped, so it cannot be altered.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 cannot be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetBoolValueFromExpr(rhs_, table_property_name, &bool_val));
+      break;
+    case KVProperty::kMmapReads:
+      // RocksDB options of a tablet are fixed when it is opened, so it cannot be altered.
+      if (sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this,
+                                  Substitute("$0 cannot be altered", table_property_name).c_str(),
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetBoolValueFromExpr(rhs_, table_property_name, &bool_val));
+      break;
     case KVProperty::kSpeculativeRetry:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetStringValueFromExpr(rhs_, true, table_property_name,
                                                              &str_val));
@@ -371,6 +428,57 @@ Status PTTableProperty::SetTableProperty(yb::TableProperties *table_property) co
       table_property->SetDefaultTimeToLive(val * MonoTime::kMillisecondsPerSecond);
       break;
     }
+    case KVProperty::kBloomFilterRangeComponents: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for bloom_filter_range_components"));
+      }
+      table_property->SetBloomFilterRangeComponents(val);
+      break;
+    }
+    case KVProperty::kHistoryRetentionMaxSeconds: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for history_retention_max_seconds"));
+      }
+      table_property->SetHistoryRetentionMaxSec(val);
+      break;
+    }
+    case KVProperty::kHistoryRetentionMinSeconds: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument,
+                      Substitute("Invalid value for history_retention_min_seconds"));
+      }
+      table_property->SetHistoryRetentionMinSec(val);
+      break;
+    }
+    case KVProperty::kInMemory: {
+      bool val;
+      if (!GetBoolValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for in_memory"));
+      }
+      table_property->SetInMemory(val);
+      break;
+    }
+    case KVProperty::kMmapReads: {
+      bool val;
+      if (!GetBoolValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for mmap_reads"));
+      }
+      table_property->SetMmapReads(val);
+      break;
+    }
+    case KVProperty::kMinBlobValueSize: {
+      int64_t val;
+      if (!GetIntValueFromExpr(rhs_, table_property_name, &val).ok()) {
+        return STATUS(InvalidArgument, Substitute("Invalid value for min_blob_value_size"));
+      }
+      table_property->SetMinBlobValueSize(val);
+      break;
+    }
     case KVProperty::kBloomFilterFpChance: FALLTHROUGH_INTENDED;
     case KVProperty::kComment: FALLTHROUGH_INTENDED;
     case KVProperty::kCrcCheckChance: FALLTHROUGH_INTENDED;
@@ -432,9 +540,18 @@ CHECKED_STATUS PTTablePropertyMap::Analyze(SemContext *sem_context) {
     case PropertyMapType::kCaching:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(AnalyzeCaching());
       break;
-    case PropertyMapType::kCompaction:
+    case PropertyMapType::kCompaction: {
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(AnalyzeCompaction());
+      // RocksDB options of a tablet are fixed when it is opened, so time window compaction could
+      // only be chosen when the table is created.
+      uint64_t window_sec = 0;
+      RETURN_SEM_CONTEXT_ERROR_NOT_OK(GetCompactionTimeWindowSec(&window_sec));
+      if (window_sec != 0 && sem_context->current_alter_table() != nullptr) {
+        return sem_context->Error(this, "Compaction strategy cannot be altered",
+                                  ErrorCode::FEATURE_NOT_SUPPORTED);
+      }
       break;
+    }
     case PropertyMapType::kCompression:
       RETURN_SEM_CONTEXT_ERROR_NOT_OK(AnalyzeCompression());
       break;
@@ -457,8 +574,15 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
     return STATUS(InvalidArgument, Substitute("$0 is not a valid table property", lhs_->c_str()));
   }
   switch (iterator->second) {
+    case PropertyMapType::kCompaction: {
+      // Only TimeWindowCompactionStrategy changes how tables are compacted, other strategies
+      // keep the default size tiered universal compaction.
+      uint64_t window_sec = 0;
+      RETURN_NOT_OK(GetCompactionTimeWindowSec(&window_sec));
+      table_property->SetCompactionTimeWindowSec(window_sec);
+      break;
+    }
     case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
-    case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
     case PropertyMapType::kCompression:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
       break;
@@ -489,6 +613,51 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
   return Status::OK();
 }
 
+Status PTTablePropertyMap::GetCompactionTimeWindowSec(uint64_t* window_sec) const {
+  string class_name;
+  int64_t window_size = 1;
+  string window_unit = "days";
+  for (const auto& subproperty : map_elements_->node_list()) {
+    string subproperty_name;
+    ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+    if (subproperty_name == "class") {
+      RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), false, subproperty_name,
+                                           &class_name));
+      if (class_name.find('.') == string::npos) {
+        class_name.insert(0, Compaction::kClassPrefix);
+      }
+    } else if (subproperty_name == "compaction_window_size") {
+      RETURN_NOT_OK(GetIntValueFromExpr(subproperty->rhs(), subproperty_name, &window_size));
+    } else if (subproperty_name == "compaction_window_unit") {
+      RETURN_NOT_OK(GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name,
+                                           &window_unit));
+    }
+  }
+
+  *window_sec = 0;
+  if (class_name != string(Compaction::kClassPrefix) + "TimeWindowCompactionStrategy") {
+    return Status::OK();
+  }
+  uint64_t unit_sec;
+  if (window_unit == "minutes") {
+    unit_sec = 60;
+  } else if (window_unit == "hours") {
+    unit_sec = 60 * 60;
+  } else if (window_unit == "days") {
+    unit_sec = 24 * 60 * 60;
+  } else {
+    return STATUS(InvalidArgument,
+                  Substitute("$0 is not valid for 'compaction_window_unit'", window_unit));
+  }
+  if (window_size <= 0) {
+    return STATUS(InvalidArgument,
+                  Substitute("compaction_window_size must be greater than 0, but was $0",
+                             window_size));
+  }
+  *window_sec = window_size * unit_sec;
+  return Status::OK();
+}
+
 Status PTTablePropertyMap::AnalyzeCompaction() {
   vector<string> invalid_subproperties;
   vector<PTTableProperty::SharedPtr> subproperties;
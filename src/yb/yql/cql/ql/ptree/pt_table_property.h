@@ -39,6 +39,7 @@ class PTTableProperty : public PTProperty {
  public:
   enum class KVProperty : int {
     kBloomFilterFpChance,
+    kBloomFilterRangeComponents,
     kCaching,
     kComment,
     kCompaction,
@@ -47,10 +48,15 @@ class PTTableProperty : public PTProperty {
     kDclocalReadRepairChance,
     kDefaultTimeToLive,
     kGcGraceSeconds,
+    kHistoryRetentionMaxSeconds,
+    kHistoryRetentionMinSeconds,
+    kInMemory,
     kIndexInterval,
     kMemtableFlushPeriodInMs,
     kMinIndexInterval,
     kMaxIndexInterval,
+    kMinBlobValueSize,
+    kMmapReads,
     kReadRepairChance,
     kSpeculativeRetry,
     kTransactions
@@ -217,6 +223,8 @@ class PTTablePropertyMap : public PTTableProperty {
  private:
   Status AnalyzeCaching();
   Status AnalyzeCompaction();
+  // Returns the time window length of TimeWindowCompactionStrategy, or 0 for other strategies.
+  Status GetCompactionTimeWindowSec(uint64_t* window_sec) const;
   Status AnalyzeCompression();
   Status AnalyzeTransactions(SemContext *sem_context);
 
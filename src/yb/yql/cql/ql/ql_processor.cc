@@ -21,6 +21,7 @@
 #include "yb/client/yb_table_name.h"
 #include "yb/yql/cql/ql/statement.h"
 #include "yb/util/thread_restrictions.h"
+#include "yb/util/trace.h"
 
 DECLARE_bool(use_cassandra_authentication);
 
@@ -147,6 +148,7 @@ Status QLProcessor::Parse(const string& stmt, ParseTree::UniPtr* parse_tree,
   }
   *parse_tree = parser_.Done();
   DCHECK(*parse_tree) << "Parse tree is null";
+  TRACE("Parsed statement");
   return Status::OK();
 }
 
@@ -162,6 +164,7 @@ Status QLProcessor::Analyze(ParseTree::UniPtr* parse_tree) {
   }
   *parse_tree = analyzer_.Done();
   DCHECK(*parse_tree) << "Parse tree is null";
+  TRACE("Analyzed statement");
   return s;
 }
 
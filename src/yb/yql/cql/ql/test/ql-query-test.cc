@@ -24,6 +24,8 @@
 #include "yb/util/crypt.h"
 #include "yb/yql/cql/ql/test/ql-test-base.h"
 
+DECLARE_int32(cql_max_read_ahead_partitions);
+
 using std::string;
 using std::unique_ptr;
 using std::shared_ptr;
@@ -838,6 +840,22 @@ TEST_F(TestQLQuery, TestPagingState) {
     VerifyPaginationSelect(processor, select_stmt, 3,
         "{ { int32:1, int32:99, int32:199 }, { int32:1, int32:100, int32:200 } }");
   }
+
+  // Read fewer partitions ahead than the IN condition has, and none. The rows should be the same.
+  for (int read_ahead_partitions : {2, 1}) {
+    FLAGS_cql_max_read_ahead_partitions = read_ahead_partitions;
+    string select_stmt = "SELECT h, r, v FROM t WHERE h IN (1, 12, 23, 34, 45) AND r > 98;";
+    VerifyPaginationSelect(processor, select_stmt, 2,
+        "{ { int32:1, int32:99, int32:199 }, { int32:1, int32:100, int32:200 } }"
+        "{ { int32:1, int32:101, int32:201 }, { int32:12, int32:112, int32:212 } }"
+        "{ { int32:23, int32:123, int32:223 }, { int32:34, int32:134, int32:234 } }"
+        "{ { int32:45, int32:145, int32:245 } }");
+
+    select_stmt = "SELECT h, r, v FROM t WHERE h IN (1, 12, 23, 34, 45) AND r > 98 LIMIT 4;";
+    VerifyPaginationSelect(processor, select_stmt, 10,
+        "{ { int32:1, int32:99, int32:199 }, { int32:1, int32:100, int32:200 }, "
+        "{ int32:1, int32:101, int32:201 }, { int32:12, int32:112, int32:212 } }");
+  }
 }
 
 #define RUN_PAGINATION_WITH_DESC_TEST(processor, type, values, rows)                               \
@@ -1307,6 +1325,56 @@ TEST_F(TestQLQuery, TestQLQueryPartialHash) {
   EXEC_VALID_STMT(drop_stmt);
 }
 
+TEST_F(TestQLQuery, TestOrderByLimitAcrossPartitions) {
+  // Init the simulated cluster.
+  ASSERT_NO_FATALS(CreateSimulatedCluster());
+
+  // Get a processor.
+  TestQLProcessor *processor = GetQLProcessor();
+
+  CHECK_VALID_STMT("CREATE TABLE test_table(h int, r int, v int, primary key((h), r));");
+
+  // Partition h has the rows with r = h, h + 3, h + 6, ... so the rows of the partitions interleave.
+  static const int kNumPartitions = 3;
+  static const int kNumRowsPerPartition = 10;
+  for (int h = 0; h < kNumPartitions; h++) {
+    for (int i = 0; i < kNumRowsPerPartition; i++) {
+      const int r = h + i * kNumPartitions;
+      CHECK_VALID_STMT(Substitute("INSERT INTO test_table(h, r, v) VALUES($0, $1, $2);",
+                                  h, r, r * 10));
+    }
+  }
+
+  // The first rows of all partitions are merged in the requested order.
+  CHECK_VALID_STMT("SELECT h, r, v FROM test_table WHERE h IN (0, 1, 2) ORDER BY r DESC LIMIT 5;");
+  std::shared_ptr<QLRowBlock> row_block = processor->row_block();
+  ASSERT_EQ(row_block->row_count(), 5);
+  for (int i = 0; i < 5; i++) {
+    const int r = kNumPartitions * kNumRowsPerPartition - 1 - i;
+    const QLRow& row = row_block->row(i);
+    EXPECT_EQ(row.column(0).int32_value(), r % kNumPartitions);
+    EXPECT_EQ(row.column(1).int32_value(), r);
+    EXPECT_EQ(row.column(2).int32_value(), r * 10);
+  }
+
+  CHECK_VALID_STMT("SELECT * FROM test_table WHERE h IN (0, 2) ORDER BY r ASC LIMIT 4;");
+  row_block = processor->row_block();
+  ASSERT_EQ(row_block->row_count(), 4);
+  const std::vector<int> expected_r = {0, 2, 3, 5};
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(row_block->row(i).column(1).int32_value(), expected_r[i]);
+  }
+
+  // The limit is larger than the number of rows.
+  CHECK_VALID_STMT("SELECT r FROM test_table WHERE h IN (1, 2) ORDER BY r DESC LIMIT 50;");
+  row_block = processor->row_block();
+  ASSERT_EQ(row_block->row_count(), 2 * kNumRowsPerPartition);
+  for (size_t i = 1; i < row_block->row_count(); i++) {
+    EXPECT_GT(row_block->row(i - 1).column(0).int32_value(),
+              row_block->row(i).column(0).int32_value());
+  }
+}
+
 TEST_F(TestQLQuery, TestInsertWithTTL) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
@@ -1487,6 +1555,25 @@ TEST_F(TestQLQuery, TestCollectionTypes) {
   EXPECT_EQ("b", list_value.elems(3).string_value());
   EXPECT_EQ("d", list_value.elems(4).string_value());
   EXPECT_EQ("b", list_value.elems(5).string_value());
+
+  // Update elements by index, and append and prepend elements.
+  CHECK_OK(processor->Run("UPDATE list_test SET ls[1] = 'e' WHERE id = 1;"));
+  CHECK_OK(processor->Run("UPDATE list_test SET ls = ls + ['f'] WHERE id = 1;"));
+  CHECK_OK(processor->Run("UPDATE list_test SET ls = ['g'] + ls WHERE id = 1;"));
+  CHECK_OK(processor->Run("UPDATE list_test SET ls[0] = 'h', v = 4 WHERE id = 1;"));
+  // Index out of bounds.
+  EXPECT_FALSE(processor->Run("UPDATE list_test SET ls[8] = 'i' WHERE id = 1;").ok());
+  CHECK_OK(processor->Run(list_select_stmt));
+  list_row_block = processor->row_block();
+  EXPECT_EQ(1, list_row_block->row_count());
+  EXPECT_EQ(4, list_row_block->row(0).column(1).int32_value());
+  list_value = list_row_block->row(0).column(2).list_value();
+  EXPECT_EQ(8, list_value.elems_size());
+  EXPECT_EQ("h", list_value.elems(0).string_value());
+  EXPECT_EQ("c", list_value.elems(1).string_value());
+  EXPECT_EQ("e", list_value.elems(2).string_value());
+  EXPECT_EQ("a", list_value.elems(3).string_value());
+  EXPECT_EQ("f", list_value.elems(7).string_value());
 }
 
 TEST_F(TestQLQuery, TestSystemLocal) {
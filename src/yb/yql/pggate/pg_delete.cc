@@ -51,7 +51,8 @@ PgDelete::~PgDelete() {
 
 void PgDelete::AllocWriteRequest() {
   // Allocate WRITE operation.
-  auto doc_op = make_shared<PgDocWriteOp>(pg_session_, table_desc_->NewPgsqlDelete());
+  auto doc_op = make_shared<PgDocWriteOp>(pg_session_, table_desc_->table(),
+                                          table_desc_->NewPgsqlDelete());
   write_req_ = doc_op->write_op()->mutable_request();
 
   // Preparation complete.
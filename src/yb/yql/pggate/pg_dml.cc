@@ -146,6 +146,23 @@ Status PgDml::BindColumn(int attr_num, PgExpr *attr_value) {
 
 //--------------------------------------------------------------------------------------------------
 
+Status PgDml::AppendWhereCond(PgExpr *cond) {
+  PgsqlExpressionPB *cond_pb = AllocWhereCondPB();
+  if (cond_pb == nullptr) {
+    return STATUS(NotSupported, "Where condition is not supported for this statement");
+  }
+
+  // Column references of the condition are added to the columns read by DocDB.
+  RETURN_NOT_OK(cond->Prepare(this, cond_pb));
+
+  // Link the condition with its protobuf, so that the values of its constants and placeholders are
+  // updated for each execution.
+  expr_binds_[cond_pb] = cond;
+  return Status::OK();
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Status PgDml::UpdateBindPBs() {
   // Process the column binds for two cases.
   // For performance reasons, we might evaluate these expressions together with bind values in YB.
@@ -169,11 +186,10 @@ Status PgDml::Fetch(uint64_t *values, bool *isnulls, PgSysColumns *syscols, bool
     memset(syscols, 0, sizeof(PgSysColumns));
   }
 
-  // Load data from cache in doc_op_ to cursor_ if it is not pointing to any data.
-  if (cursor_.empty()) {
-    int64_t row_count = 0;
+  // Load the next page from cache in doc_op_ if all rows of the current page have been read.
+  if (page_row_ >= page_.row_count()) {
     // Keep reading untill we either reach the end or get some rows.
-    while (row_count == 0) {
+    do {
       if (doc_op_->EndOfResult()) {
         // To be compatible with Postgres code, memset output array with 0.
         *has_data = false;
@@ -182,29 +198,34 @@ Status PgDml::Fetch(uint64_t *values, bool *isnulls, PgSysColumns *syscols, bool
 
       // Read from cache.
       RETURN_NOT_OK(doc_op_->GetResult(&row_batch_));
-      RETURN_NOT_OK(PgDocData::LoadCache(row_batch_, &row_count, &cursor_));
-    }
+      RETURN_NOT_OK(page_.Load(row_batch_));
+    } while (page_.row_count() == 0);
 
-    accumulated_row_count_ += row_count;
+    if (page_.column_count() != targets_.size()) {
+      return STATUS_FORMAT(Corruption, "Unexpected number of columns in result: $0, expected $1",
+                           page_.column_count(), targets_.size());
+    }
+    page_row_ = 0;
+    accumulated_row_count_ += page_.row_count();
   }
 
-  // Read the tuple from cached buffer and write it to postgres buffer.
+  // Read the tuple from cached page and write it to postgres buffer.
   *has_data = true;
   PgTuple pg_tuple(values, isnulls, syscols);
-  RETURN_NOT_OK(WritePgTuple(&pg_tuple));
+  RETURN_NOT_OK(WritePgTuple(page_row_++, &pg_tuple));
 
   return Status::OK();
 }
 
-Status PgDml::WritePgTuple(PgTuple *pg_tuple) {
-  for (const PgExpr *target : targets_) {
+Status PgDml::WritePgTuple(int64_t row, PgTuple *pg_tuple) {
+  for (size_t index = 0; index < targets_.size(); index++) {
+    const PgExpr *target = targets_[index];
     if (target->opcode() != PgColumnRef::Opcode::PG_EXPR_COLREF) {
       return STATUS(InternalError, "Unexpected expression, only column refs supported here");
     }
     const auto *col_ref = static_cast<const PgColumnRef *>(target);
-    PgWireDataHeader header = PgDocData::ReadDataHeader(&cursor_);
     CHECK(target->TranslateData) << "Data format translation is not provided";
-    target->TranslateData(&cursor_, header, pg_tuple, col_ref->attr_num() - 1);
+    target->TranslateData(page_.column(index), row, pg_tuple, col_ref->attr_num() - 1);
   }
 
   return Status::OK();
@@ -18,6 +18,7 @@
 #include "yb/yql/pggate/pg_session.h"
 #include "yb/yql/pggate/pg_statement.h"
 #include "yb/yql/pggate/pg_doc_op.h"
+#include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
 namespace pggate {
@@ -44,12 +45,15 @@ class PgDml : public PgStatement {
   // Bind a column with an expression.
   CHECKED_STATUS BindColumn(int attnum, PgExpr *attr_value);
 
+  // Append a condition that DocDB should use to filter the rows. Conditions are combined with AND.
+  CHECKED_STATUS AppendWhereCond(PgExpr *cond);
+
   // This function is not yet working and might not be needed.
   virtual CHECKED_STATUS ClearBinds();
 
   // Fetch a row and advance cursor to the next row.
   CHECKED_STATUS Fetch(uint64_t *values, bool *isnulls, PgSysColumns *syscols, bool *has_data);
-  CHECKED_STATUS WritePgTuple(PgTuple *pg_tuple);
+  CHECKED_STATUS WritePgTuple(int64_t row, PgTuple *pg_tuple);
 
  protected:
   // Method members.
@@ -69,6 +73,12 @@ class PgDml : public PgStatement {
   // Allocate column protobuf.
   virtual PgsqlExpressionPB *AllocTargetPB() = 0;
 
+  // Allocate protobuf for a where condition. Returns nullptr when DocDB cannot filter the rows of
+  // this statement.
+  virtual PgsqlExpressionPB *AllocWhereCondPB() {
+    return nullptr;
+  }
+
   // Update bind values.
   CHECKED_STATUS UpdateBindPBs();
 
@@ -86,7 +96,7 @@ class PgDml : public PgStatement {
   // -----------------------------------------------------------------------------------------------
   // Data members for generated protobuf.
   // NOTE:
-  // - Where clause processing data is not supported yet.
+  // - Where clause only supports conditions that DocDB evaluates to filter rows of SELECT.
   // - Some protobuf structure are also set up in PgColumn class.
 
   // Column references.
@@ -107,8 +117,9 @@ class PgDml : public PgStatement {
   string row_batch_;
 
   // Data members for navigating the output / result-set from either seleted or returned targets.
-  // Cursor.
-  Slice cursor_;
+  // The columns of the current batch and the next row to be read from it.
+  PgColumnarPage page_;
+  int64_t page_row_ = 0;
 
   // Total number of rows that have been found.
   int64_t accumulated_row_count_ = 0;
@@ -14,13 +14,42 @@
 
 #include "yb/yql/pggate/pg_doc_op.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(pggate_prefetch_pages, 4,
+             "Maximum number of result pages that a PostgreSQL scan keeps fetched ahead of the "
+             "backend. Next pages are requested in the background while there is room. A value "
+             "of 1 requests the next page only when the previous one has been consumed.");
+
+DEFINE_int64(pggate_prefetch_max_bytes, 8 * 1024 * 1024,
+             "Maximum number of bytes of results that a PostgreSQL scan keeps fetched ahead of "
+             "the backend.");
+
+DEFINE_int32(pggate_scan_parallelism, 16,
+             "Maximum number of requests that a PostgreSQL scan of a hash partitioned table "
+             "without conditions on the hash key sends concurrently. The tablets are split into "
+             "this many hash ranges that are scanned in parallel. A value of 1 scans the tablets "
+             "one after another.");
+
 using std::shared_ptr;
 
 namespace yb {
 namespace pggate {
 
+namespace {
+
+// Whether the next page of a request would start past the max_hash_code that bounds it.
+bool IsPastMaxHashCode(const PgsqlReadRequestPB& req, const PgsqlPagingStatePB& paging_state) {
+  return req.has_max_hash_code() && !paging_state.next_partition_key().empty() &&
+         PartitionSchema::DecodeMultiColumnHashValue(paging_state.next_partition_key()) >
+             req.max_hash_code();
+}
+
+} // namespace
+
 PgDocOp::PgDocOp(PgSession::ScopedRefPtr pg_session)
-    : pg_session_(std::move(pg_session)) {
+    : pg_session_(std::move(pg_session)),
+      cache_consumption_(pg_session_->mem_tracker(), 0) {
 }
 
 PgDocOp::~PgDocOp() {
@@ -70,6 +99,7 @@ void PgDocOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
     CHECK(!waiting_for_response_);
   }
   result_cache_.clear();
+  cache_consumption_.Reset(0);
   end_of_data_ = false;
   has_cached_data_ = false;
 }
@@ -105,13 +135,15 @@ Status PgDocOp::GetResult(string *result_set) {
 void PgDocOp::WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op) {
   if (!yb_op->rows_data().empty()) {
     result_cache_.push_back(yb_op->rows_data());
+    cache_consumption_.Add(result_cache_.back().size());
     has_cached_data_ = !result_cache_.empty();
   }
 }
 
 void PgDocOp::ReadFromCacheUnlocked(string *result) {
   if (!result_cache_.empty()) {
-    *result = result_cache_.front();
+    result->swap(result_cache_.front());
+    cache_consumption_.Add(-static_cast<int64_t>(result->size()));
     result_cache_.pop_front();
     has_cached_data_ = !result_cache_.empty();
   }
@@ -127,28 +159,121 @@ Status PgDocOp::SendRequestIfNeededUnlocked() {
 
 //--------------------------------------------------------------------------------------------------
 
-PgDocReadOp::PgDocReadOp(PgSession::ScopedRefPtr pg_session, client::YBPgsqlReadOp *read_op)
-    : PgDocOp(pg_session), read_op_(read_op) {
+PgDocReadOp::PgDocReadOp(PgSession::ScopedRefPtr pg_session,
+                         std::shared_ptr<client::YBTable> table,
+                         client::YBPgsqlReadOp *read_op)
+    : PgDocOp(pg_session), table_(std::move(table)), read_op_(read_op) {
 }
 
 PgDocReadOp::~PgDocReadOp() {
 }
 
+void PgDocReadOp::SetKeyBatch(std::vector<std::shared_ptr<client::YBPgsqlReadOp>> key_ops) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  key_ops_ = std::move(key_ops);
+}
+
 void PgDocReadOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
   PgDocOp::InitUnlocked(lock);
 
   PgsqlReadRequestPB *req = read_op_->mutable_request();
   req->set_limit(kPrefetchLimit);
   req->set_return_paging_state(true);
+
+  if (key_ops_.empty()) {
+    if (!InitParallelScanUnlocked()) {
+      active_ops_ = { read_op_ };
+    }
+    return;
+  }
+  active_ops_ = key_ops_;
+  for (const auto& key_op : key_ops_) {
+    PgsqlReadRequestPB *key_req = key_op->mutable_request();
+    key_req->set_limit(kPrefetchLimit);
+    key_req->set_return_paging_state(true);
+    key_req->clear_paging_state();
+  }
+}
+
+bool PgDocReadOp::InitParallelScanUnlocked() {
+  const PgsqlReadRequestPB& req = read_op_->request();
+  if (FLAGS_pggate_scan_parallelism <= 1 || !req.partition_column_values().empty() ||
+      req.has_hash_code() || req.has_max_hash_code() || !req.is_forward_scan() ||
+      !table_->partition_schema().IsHashPartitioning()) {
+    return false;
+  }
+
+  const std::vector<std::string>& partitions = table_->GetPartitions();
+  const size_t num_ranges = std::min(partitions.size(),
+                                     static_cast<size_t>(FLAGS_pggate_scan_parallelism));
+  if (num_ranges <= 1) {
+    return false;
+  }
+
+  active_ops_.clear();
+  for (size_t i = 0; i < num_ranges; i++) {
+    // Each request scans the tablets [begin, end) one after another.
+    const size_t begin = i * partitions.size() / num_ranges;
+    const size_t end = (i + 1) * partitions.size() / num_ranges;
+    std::shared_ptr<client::YBPgsqlReadOp> range_op(table_->NewPgsqlSelect());
+    PgsqlReadRequestPB *range_req = range_op->mutable_request();
+    range_req->CopyFrom(req);
+    range_req->clear_paging_state();
+    if (begin > 0) {
+      range_req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partitions[begin]));
+    }
+    if (end < partitions.size()) {
+      range_req->set_max_hash_code(
+          PartitionSchema::DecodeMultiColumnHashValue(partitions[end]) - 1);
+    }
+    active_ops_.push_back(std::move(range_op));
+  }
+  return true;
+}
+
+std::vector<std::shared_ptr<client::YBPgsqlOp>> PgDocReadOp::ActiveOpsUnlocked() const {
+  return std::vector<std::shared_ptr<client::YBPgsqlOp>>(active_ops_.begin(), active_ops_.end());
 }
 
 Status PgDocReadOp::SendRequestUnlocked() {
-  RETURN_NOT_OK(pg_session_->ApplyAsync(read_op_));
+  RETURN_NOT_OK(pg_session_->ApplyAndFlushAsync(
+      ActiveOpsUnlocked(), [this](const Status& s) { PgDocReadOp::ReceiveResponse(s); }));
   waiting_for_response_ = true;
-  pg_session_->FlushAsync([this](const Status& s) { PgDocReadOp::ReceiveResponse(s); });
   return Status::OK();
 }
 
+Status PgDocReadOp::SendRequestIfNeededUnlocked() {
+  if (!end_of_data_ && !waiting_for_response_ && CanFetchNextPageUnlocked()) {
+    return SendRequestUnlocked();
+  }
+  return Status::OK();
+}
+
+bool PgDocReadOp::CanFetchNextPageUnlocked() const {
+  if (result_cache_.empty()) {
+    return true;
+  }
+  return result_cache_.size() < static_cast<size_t>(FLAGS_pggate_prefetch_pages) &&
+         cache_consumption_.consumption() < FLAGS_pggate_prefetch_max_bytes &&
+         !pg_session_->mem_tracker()->AnyLimitExceeded();
+}
+
+void PgDocReadOp::PrefetchNextPageUnlocked() {
+  if (is_canceled_ || end_of_data_ || !CanFetchNextPageUnlocked()) {
+    return;
+  }
+  // The backend could be flushing its own operations on the same session. In that case, leave the
+  // next page to be requested by the backend when it reads from the cache.
+  auto sent = pg_session_->TryApplyAndFlushAsync(
+      ActiveOpsUnlocked(), [this](const Status& s) { PgDocReadOp::ReceiveResponse(s); });
+  if (!sent.ok()) {
+    exec_status_ = sent.status();
+    end_of_data_ = true;
+    return;
+  }
+  waiting_for_response_ = *sent;
+}
+
 void PgDocReadOp::ReceiveResponse(Status exec_status) {
   std::unique_lock<std::mutex> lock(mtx_);
   CHECK(waiting_for_response_);
@@ -162,15 +287,24 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
   }
 
   if (!is_canceled_) {
-    // Save it to cache.
-    WriteToCacheUnlocked(read_op_);
-
-    // Setup request for the next batch of data.
-    const PgsqlResponsePB& res = read_op_->response();
-     if (res.has_paging_state()) {
-      PgsqlReadRequestPB *req = read_op_->mutable_request();
-      // Set up paging state for next request.
-      *req->mutable_paging_state() = res.paging_state();
+    std::vector<std::shared_ptr<client::YBPgsqlReadOp>> unfinished_ops;
+    for (const auto& op : active_ops_) {
+      // Save it to cache.
+      WriteToCacheUnlocked(op);
+
+      // Setup request for the next batch of data.
+      const PgsqlResponsePB& res = op->response();
+      if (res.has_paging_state() && !IsPastMaxHashCode(op->request(), res.paging_state())) {
+        PgsqlReadRequestPB *req = op->mutable_request();
+        // Set up paging state for next request.
+        *req->mutable_paging_state() = res.paging_state();
+        unfinished_ops.push_back(op);
+      }
+    }
+    active_ops_.swap(unfinished_ops);
+
+    if (!active_ops_.empty()) {
+      PrefetchNextPageUnlocked();
     } else {
       end_of_data_ = true;
     }
@@ -181,8 +315,10 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
 
 //--------------------------------------------------------------------------------------------------
 
-PgDocWriteOp::PgDocWriteOp(PgSession::ScopedRefPtr pg_session, client::YBPgsqlWriteOp *write_op)
-    : PgDocOp(pg_session), write_op_(write_op) {
+PgDocWriteOp::PgDocWriteOp(PgSession::ScopedRefPtr pg_session,
+                           std::shared_ptr<client::YBTable> table,
+                           client::YBPgsqlWriteOp *write_op)
+    : PgDocOp(pg_session), table_(std::move(table)), write_op_(write_op) {
 }
 
 PgDocWriteOp::~PgDocWriteOp() {
@@ -190,9 +326,21 @@ PgDocWriteOp::~PgDocWriteOp() {
 
 Status PgDocWriteOp::SendRequestUnlocked() {
   CHECK(!waiting_for_response_);
-  RETURN_NOT_OK(pg_session_->ApplyAsync(write_op_));
+  if (pg_session_->CanBufferWriteOperation(*write_op_)) {
+    // Buffer a copy of the request, so that the statement can be executed again with new bind
+    // values while the earlier write is waiting to be flushed.
+    auto buffered_op = std::make_shared<client::YBPgsqlWriteOp>(table_);
+    buffered_op->mutable_request()->CopyFrom(write_op_->request());
+    RETURN_NOT_OK(pg_session_->BufferWriteOperation(buffered_op));
+
+    // Nothing to return, errors are reported when the buffered writes are flushed.
+    end_of_data_ = true;
+    VLOG(1) << __PRETTY_FUNCTION__ << ": Buffered request for " << this;
+    return Status::OK();
+  }
+  RETURN_NOT_OK(pg_session_->ApplyAndFlushAsync(
+      { write_op_ }, [this](const Status& s) { PgDocWriteOp::ReceiveResponse(s); }));
   waiting_for_response_ = true;
-  pg_session_->FlushAsync([this](const Status& s) { PgDocWriteOp::ReceiveResponse(s); });
   VLOG(1) << __PRETTY_FUNCTION__ << ": Sending request for " << this;
   return Status::OK();
 }
@@ -19,6 +19,7 @@
 #include <condition_variable>
 
 #include "yb/util/locks.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/client/yb_op.h"
 #include "yb/yql/pggate/pg_session.h"
 
@@ -63,7 +64,7 @@ class PgDocOp {
 
   // Send another request if no request is pending and we've already consumed
   // all data in the cache.
-  CHECKED_STATUS SendRequestIfNeededUnlocked();
+  virtual CHECKED_STATUS SendRequestIfNeededUnlocked();
 
   // Session control.
   PgSession::ScopedRefPtr pg_session_;
@@ -91,6 +92,9 @@ class PgDocOp {
 
   // Caching state variables.
   std::list<string> result_cache_;
+
+  // Memory held by result_cache_, accounted in the session's memory tracker.
+  ScopedTrackedConsumption cache_consumption_;
 };
 
 class PgDocReadOp : public PgDocOp {
@@ -105,7 +109,9 @@ class PgDocReadOp : public PgDocOp {
   typedef scoped_refptr<PgDocReadOp> ScopedRefPtr;
 
   // Constructors & Destructors.
-  PgDocReadOp(PgSession::ScopedRefPtr pg_session, client::YBPgsqlReadOp *read_op);
+  PgDocReadOp(PgSession::ScopedRefPtr pg_session,
+              std::shared_ptr<client::YBTable> table,
+              client::YBPgsqlReadOp *read_op);
   virtual ~PgDocReadOp();
 
   // Access function.
@@ -113,14 +119,44 @@ class PgDocReadOp : public PgDocOp {
     return read_op_;
   }
 
+  // Read the given requests, one per key of a batched lookup, instead of read_op_ when executed.
+  void SetKeyBatch(std::vector<std::shared_ptr<client::YBPgsqlReadOp>> key_ops);
+
  private:
   // Process response from DocDB.
   virtual void InitUnlocked(std::unique_lock<std::mutex>* lock) override;
   virtual CHECKED_STATUS SendRequestUnlocked() override;
+  virtual CHECKED_STATUS SendRequestIfNeededUnlocked() override;
   virtual void ReceiveResponse(Status exec_status);
 
+  // Whether the next page could be fetched now: either the cache is drained, or fewer than
+  // --pggate_prefetch_pages pages and --pggate_prefetch_max_bytes bytes are cached ahead.
+  bool CanFetchNextPageUnlocked() const;
+
+  // Request the next page from a response callback, so that the cache is refilled while the
+  // backend is consuming rows.
+  void PrefetchNextPageUnlocked();
+
+  // Split a scan of all tablets of a hash partitioned table into up to --pggate_scan_parallelism
+  // requests on disjoint hash ranges that are sent concurrently. Returns false if read_op_ should
+  // be sent alone.
+  bool InitParallelScanUnlocked();
+
+  // The requests of active_ops_, which are applied and flushed together.
+  std::vector<std::shared_ptr<client::YBPgsqlOp>> ActiveOpsUnlocked() const;
+
+  // Table of the operator, to allocate the requests of a parallel scan.
+  std::shared_ptr<client::YBTable> table_;
+
   // Operator.
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
+
+  // Requests of a batched lookup by primary key.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> key_ops_;
+
+  // Requests that have more rows to read: read_op_, the requests of a parallel scan, or those of
+  // key_ops_ that are not done yet.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> active_ops_;
 };
 
 class PgDocWriteOp : public PgDocOp {
@@ -135,7 +171,9 @@ class PgDocWriteOp : public PgDocOp {
   typedef scoped_refptr<PgDocWriteOp> ScopedRefPtr;
 
   // Constructors & Destructors.
-  PgDocWriteOp(PgSession::ScopedRefPtr pg_session, client::YBPgsqlWriteOp *write_op);
+  PgDocWriteOp(PgSession::ScopedRefPtr pg_session,
+               std::shared_ptr<client::YBTable> table,
+               client::YBPgsqlWriteOp *write_op);
   virtual ~PgDocWriteOp();
 
   // Access function.
@@ -148,6 +186,9 @@ class PgDocWriteOp : public PgDocOp {
   virtual CHECKED_STATUS SendRequestUnlocked() override;
   virtual void ReceiveResponse(Status exec_status);
 
+  // Table of the operator, to allocate copies of it that are buffered by the session.
+  std::shared_ptr<client::YBTable> table_;
+
   // Operator.
   std::shared_ptr<client::YBPgsqlWriteOp> write_op_;
 };
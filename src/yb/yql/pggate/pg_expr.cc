@@ -15,6 +15,7 @@
 
 #include "yb/yql/pggate/pg_expr.h"
 
+#include <limits>
 #include <unordered_map>
 
 #include "yb/yql/pggate/pg_dml.h"
@@ -39,6 +40,9 @@ const std::unordered_map<string, PgExpr::Opcode> kOperatorNames = {
   { ">=", PgExpr::Opcode::PG_EXPR_GE },
   { "<", PgExpr::Opcode::PG_EXPR_LT },
   { "<=", PgExpr::Opcode::PG_EXPR_LE },
+  { "in", PgExpr::Opcode::PG_EXPR_IN },
+  { "is null", PgExpr::Opcode::PG_EXPR_IS_NULL },
+  { "is not null", PgExpr::Opcode::PG_EXPR_IS_NOT_NULL },
 
   { "avg", PgExpr::Opcode::PG_EXPR_AVG },
   { "sum", PgExpr::Opcode::PG_EXPR_SUM },
@@ -83,89 +87,77 @@ Status PgExpr::Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
   return Status::OK();
 }
 
-void PgExpr::TranslateText(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateText(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  if (header.is_null()) {
-    return pg_tuple->WriteNull(index, header);
+  if (column.is_null(row)) {
+    return pg_tuple->WriteNull(index, column.header(row));
   }
 
-  int64_t text_size;
-  size_t read_size = PgDocData::ReadNumber(yb_cursor, &text_size);
-  yb_cursor->remove_prefix(read_size);
-
-  pg_tuple->Write(index, header, yb_cursor->cdata(), text_size);
-  yb_cursor->remove_prefix(text_size);
+  Slice value = column.varlen(row);
+  pg_tuple->Write(index, column.header(row), value.cdata(), value.size());
 }
 
-void PgExpr::TranslateBinary(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateBinary(const PgColumnarColumn& column, int64_t row,
                              PgTuple *pg_tuple, int index) {
-  if (header.is_null()) {
-    return pg_tuple->WriteNull(index, header);
+  if (column.is_null(row)) {
+    return pg_tuple->WriteNull(index, column.header(row));
   }
 
-  int64_t data_size;
-  size_t read_size = PgDocData::ReadNumber(yb_cursor, &data_size);
-  yb_cursor->remove_prefix(read_size);
-
-  pg_tuple->Write(index, header, yb_cursor->data(), data_size);
-  yb_cursor->remove_prefix(data_size);
+  Slice value = column.varlen(row);
+  pg_tuple->Write(index, column.header(row), value.data(), value.size());
 }
 
 //--------------------------------------------------------------------------------------------------
 // Translating system columns.
-void PgExpr::TranslateSysCol(Slice *yb_cursor, const PgWireDataHeader& header, PgTuple *pg_tuple,
+void PgExpr::TranslateSysCol(const PgColumnarColumn& column, int64_t row, PgTuple *pg_tuple,
                              uint8_t **pgbuf) {
   *pgbuf = nullptr;
-  if (header.is_null()) {
+  if (column.is_null(row)) {
     return;
   }
 
-  int64_t data_size;
-  size_t read_size = PgDocData::ReadNumber(yb_cursor, &data_size);
-  yb_cursor->remove_prefix(read_size);
-
-  pg_tuple->Write(pgbuf, header, yb_cursor->data(), data_size);
-  yb_cursor->remove_prefix(data_size);
+  Slice value = column.varlen(row);
+  pg_tuple->Write(pgbuf, column.header(row), value.data(), value.size());
 }
 
-void PgExpr::TranslateCtid(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateCtid(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint64_t>(yb_cursor, header, &pg_tuple->syscols()->ctid);
+  TranslateSysCol<uint64_t>(column, row, &pg_tuple->syscols()->ctid);
 }
 
-void PgExpr::TranslateOid(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateOid(const PgColumnarColumn& column, int64_t row,
                           PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->oid);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->oid);
 }
 
-void PgExpr::TranslateTableoid(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateTableoid(const PgColumnarColumn& column, int64_t row,
                                PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->tableoid);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->tableoid);
 }
 
-void PgExpr::TranslateXmin(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateXmin(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->xmin);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->xmin);
 }
 
-void PgExpr::TranslateCmin(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateCmin(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->cmin);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->cmin);
 }
 
-void PgExpr::TranslateXmax(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateXmax(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->xmax);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->xmax);
 }
 
-void PgExpr::TranslateCmax(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateCmax(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index) {
-  TranslateSysCol<uint32_t>(yb_cursor, header, &pg_tuple->syscols()->cmax);
+  TranslateSysCol<uint32_t>(column, row, &pg_tuple->syscols()->cmax);
 }
 
-void PgExpr::TranslateYBCtid(Slice *yb_cursor, const PgWireDataHeader& header,
+void PgExpr::TranslateYBCtid(const PgColumnarColumn& column, int64_t row,
                              PgTuple *pg_tuple, int index) {
-  TranslateSysCol(yb_cursor, header, pg_tuple, &pg_tuple->syscols()->yb_ctid);
+  TranslateSysCol(column, row, pg_tuple, &pg_tuple->syscols()->yb_ctid);
 }
 
 Status PgExpr::ReadHashValue(const char *doc_key, int key_size, uint16_t *hash_value) {
@@ -246,6 +238,14 @@ PgConstant::PgConstant(const void *value, size_t bytes, bool is_null)
 PgConstant::~PgConstant() {
 }
 
+void PgConstant::UpdateConstant(bool value, bool is_null) {
+  if (is_null) {
+    ql_value_.Clear();
+  } else {
+    ql_value_.set_bool_value(value);
+  }
+}
+
 void PgConstant::UpdateConstant(int16_t value, bool is_null) {
   if (is_null) {
     ql_value_.Clear();
@@ -418,5 +418,64 @@ void PgOperator::AppendArg(PgExpr *arg) {
   args_.push_back(arg);
 }
 
+Status PgOperator::Prepare(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  QLOperator ql_op;
+  size_t min_args = 2;
+  size_t max_args = 2;
+  switch (opcode_) {
+    case Opcode::PG_EXPR_EQ:
+      ql_op = QL_OP_EQUAL;
+      break;
+    case Opcode::PG_EXPR_NE:
+      ql_op = QL_OP_NOT_EQUAL;
+      break;
+    case Opcode::PG_EXPR_GE:
+      ql_op = QL_OP_GREATER_THAN_EQUAL;
+      break;
+    case Opcode::PG_EXPR_GT:
+      ql_op = QL_OP_GREATER_THAN;
+      break;
+    case Opcode::PG_EXPR_LE:
+      ql_op = QL_OP_LESS_THAN_EQUAL;
+      break;
+    case Opcode::PG_EXPR_LT:
+      ql_op = QL_OP_LESS_THAN;
+      break;
+    case Opcode::PG_EXPR_IN:
+      ql_op = QL_OP_IN;
+      max_args = std::numeric_limits<size_t>::max();
+      break;
+    case Opcode::PG_EXPR_IS_NULL:
+      ql_op = QL_OP_IS_NULL;
+      min_args = max_args = 1;
+      break;
+    case Opcode::PG_EXPR_IS_NOT_NULL:
+      ql_op = QL_OP_IS_NOT_NULL;
+      min_args = max_args = 1;
+      break;
+    default:
+      return STATUS_SUBSTITUTE(NotSupported, "Operator $0 cannot be executed by DocDB", opname_);
+  }
+  if (args_.size() < min_args || args_.size() > max_args) {
+    return STATUS_SUBSTITUTE(InvalidArgument, "Wrong number of arguments for operator $0",
+                             opname_);
+  }
+
+  PgsqlBCallPB *bocall = expr_pb->mutable_bocall();
+  bocall->set_opcode(ql_op);
+  for (PgExpr *arg : args_) {
+    RETURN_NOT_OK(arg->Prepare(pg_stmt, bocall->add_operands()));
+  }
+  return Status::OK();
+}
+
+Status PgOperator::Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  PgsqlBCallPB *bocall = expr_pb->mutable_bocall();
+  for (size_t i = 0; i < args_.size(); i++) {
+    RETURN_NOT_OK(args_[i]->Eval(pg_stmt, bocall->mutable_operands(i)));
+  }
+  return Status::OK();
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -38,6 +38,9 @@ class PgExpr {
     PG_EXPR_GT,
     PG_EXPR_LE,
     PG_EXPR_LT,
+    PG_EXPR_IN,
+    PG_EXPR_IS_NULL,
+    PG_EXPR_IS_NOT_NULL,
 
     // Aggregate functions.
     PG_EXPR_AVG,
@@ -74,55 +77,51 @@ class PgExpr {
   // Write the result to output buffer (pg_cursor) in Postgres format.
   CHECKED_STATUS ResultToPg(Slice *yb_cursor, Slice *pg_cursor);
 
-  // Translate data to DocDB to Postgres format.
-  std::function<void(Slice *, const PgWireDataHeader&, PgTuple *, int)> TranslateData;
+  // Translate data of a result page from DocDB to Postgres format.
+  std::function<void(const PgColumnarColumn&, int64_t, PgTuple *, int)> TranslateData;
 
   template<typename data_type>
-  static void TranslateNumber(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateNumber(const PgColumnarColumn& column, int64_t row,
                               PgTuple *pg_tuple, int index) {
-    if (header.is_null()) {
-      return pg_tuple->WriteNull(index, header);
+    if (column.is_null(row)) {
+      return pg_tuple->WriteNull(index, column.header(row));
     }
-    data_type result = 0;
-    size_t read_size = PgDocData::ReadNumber(yb_cursor, &result);
-    yb_cursor->remove_prefix(read_size);
-    pg_tuple->Write(index, header, result);
+    pg_tuple->Write(index, column.header(row), column.number<data_type>(row));
   }
 
-  static void TranslateText(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateText(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateBinary(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateBinary(const PgColumnarColumn& column, int64_t row,
                               PgTuple *pg_tuple, int index);
 
   // Translate system column.
   template<typename data_type>
-  static void TranslateSysCol(Slice *yb_cursor, const PgWireDataHeader& header, data_type *value) {
+  static void TranslateSysCol(const PgColumnarColumn& column, int64_t row, data_type *value) {
     *value = 0;
-    if (header.is_null()) {
+    if (column.is_null(row)) {
       // 0 is an invalid OID.
       return;
     }
-    size_t read_size = PgDocData::ReadNumber(yb_cursor, value);
-    yb_cursor->remove_prefix(read_size);
+    *value = column.number<data_type>(row);
   }
 
-  static void TranslateSysCol(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateSysCol(const PgColumnarColumn& column, int64_t row,
                               PgTuple *pg_tuple, uint8_t **value);
-  static void TranslateCtid(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateCtid(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateOid(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateOid(const PgColumnarColumn& column, int64_t row,
                            PgTuple *pg_tuple, int index);
-  static void TranslateXmin(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateXmin(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateCmin(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateCmin(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateXmax(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateXmax(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateCmax(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateCmax(const PgColumnarColumn& column, int64_t row,
                             PgTuple *pg_tuple, int index);
-  static void TranslateTableoid(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateTableoid(const PgColumnarColumn& column, int64_t row,
                                 PgTuple *pg_tuple, int index);
-  static void TranslateYBCtid(Slice *yb_cursor, const PgWireDataHeader& header,
+  static void TranslateYBCtid(const PgColumnarColumn& column, int64_t row,
                               PgTuple *pg_tuple, int index);
 
   // Read hash_value.
@@ -168,6 +167,7 @@ class PgConstant : public PgExpr {
   virtual ~PgConstant();
 
   // Update numeric.
+  void UpdateConstant(bool value, bool is_null);
   void UpdateConstant(int16_t value, bool is_null);
   void UpdateConstant(int32_t value, bool is_null);
   void UpdateConstant(int64_t value, bool is_null);
@@ -224,6 +224,13 @@ class PgOperator : public PgExpr {
   // Append arguments.
   void AppendArg(PgExpr *arg);
 
+  // Setup the operator call and its arguments when constructing statement. Only conditions that
+  // DocDB can evaluate are supported.
+  virtual CHECKED_STATUS Prepare(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb);
+
+  // Update the values of the arguments.
+  virtual CHECKED_STATUS Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb);
+
  private:
   const string opname_;
   std::vector<PgExpr*> args_;
@@ -51,7 +51,8 @@ PgInsert::~PgInsert() {
 
 void PgInsert::AllocWriteRequest() {
   // Allocate WRITE operation.
-  auto doc_op = make_shared<PgDocWriteOp>(pg_session_, table_desc_->NewPgsqlInsert());
+  auto doc_op = make_shared<PgDocWriteOp>(pg_session_, table_desc_->table(),
+                                          table_desc_->NewPgsqlInsert());
   write_req_ = doc_op->write_op()->mutable_request();
 
   // Preparation complete.
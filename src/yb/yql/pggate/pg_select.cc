@@ -40,11 +40,13 @@ Status PgSelect::Prepare() {
   RETURN_NOT_OK(LoadTable(false /* for_write */));
 
   // Allocate READ/SELECT operation.
-  auto doc_op = make_shared<PgDocReadOp>(pg_session_, table_desc_->NewPgsqlSelect());
+  auto doc_op = make_shared<PgDocReadOp>(pg_session_, table_desc_->table(),
+                                         table_desc_->NewPgsqlSelect());
   read_req_ = doc_op->read_op()->mutable_request();
   PrepareColumns();
 
   // Preparation complete.
+  read_doc_op_ = doc_op;
   doc_op_ = doc_op;
   return Status::OK();
 }
@@ -63,7 +65,6 @@ void PgSelect::PrepareColumns() {
 
 //--------------------------------------------------------------------------------------------------
 // DML support.
-// TODO(neil) WHERE clause is not yet supported. Revisit this function when it is.
 
 PgsqlExpressionPB *PgSelect::AllocColumnBindPB(PgColumn *col) {
   return col->AllocBindPB(read_req_);
@@ -73,12 +74,18 @@ PgsqlExpressionPB *PgSelect::AllocTargetPB() {
   return read_req_->add_targets();
 }
 
+PgsqlExpressionPB *PgSelect::AllocWhereCondPB() {
+  PgsqlBCallPB *conds = read_req_->mutable_where_expr()->mutable_bocall();
+  conds->set_opcode(QL_OP_AND);
+  return conds->add_operands();
+}
+
 //--------------------------------------------------------------------------------------------------
 // RESULT SET SUPPORT.
 // For now, selected expressions are just a list of column names (ref).
 //   SELECT column_l, column_m, column_n FROM ...
 
-Status PgSelect::DeleteEmptyPrimaryBinds() {
+Status PgSelect::DeleteEmptyPrimaryBinds(PgsqlReadRequestPB *req, bool *full_scan) {
   bool miss_range_columns = false;
   bool has_range_columns = false;
 
@@ -101,13 +108,14 @@ Status PgSelect::DeleteEmptyPrimaryBinds() {
     }
   }
 
+  *full_scan = miss_partition_columns;
   if (miss_partition_columns) {
     VLOG(1) << "Full scan is needed";
-    read_req_->clear_partition_column_values();
-    read_req_->clear_range_column_values();
+    req->clear_partition_column_values();
+    req->clear_range_column_values();
   } else if (miss_range_columns) {
     VLOG(1) << "Single tablet scan is needed";
-    read_req_->clear_range_column_values();
+    req->clear_range_column_values();
   }
 
   // Set the primary key indicator in protobuf.
@@ -121,8 +129,15 @@ Status PgSelect::DeleteEmptyPrimaryBinds() {
 }
 
 Status PgSelect::Exec() {
+  if (!key_ops_.empty()) {
+    // The requests of a batched lookup were completed when their keys were added.
+    read_doc_op_->SetKeyBatch(key_ops_);
+    return doc_op_->Execute();
+  }
+
   // Delete key columns that are not bound to any values.
-  RETURN_NOT_OK(DeleteEmptyPrimaryBinds());
+  bool full_scan = false;
+  RETURN_NOT_OK(DeleteEmptyPrimaryBinds(read_req_, &full_scan));
 
   // Update bind values for constants and placeholders.
   RETURN_NOT_OK(UpdateBindPBs());
@@ -131,5 +146,22 @@ Status PgSelect::Exec() {
   return doc_op_->Execute();
 }
 
+Status PgSelect::AppendKey() {
+  // Update bind values for constants and placeholders.
+  RETURN_NOT_OK(UpdateBindPBs());
+
+  std::shared_ptr<client::YBPgsqlReadOp> key_op(table_desc_->NewPgsqlSelect());
+  PgsqlReadRequestPB *key_req = key_op->mutable_request();
+  key_req->CopyFrom(*read_req_);
+
+  bool full_scan = false;
+  RETURN_NOT_OK(DeleteEmptyPrimaryBinds(key_req, &full_scan));
+  if (full_scan) {
+    return STATUS(InvalidArgument, "Partition key must be fully specified in a batched lookup");
+  }
+  key_ops_.push_back(std::move(key_op));
+  return Status::OK();
+}
+
 }  // namespace pggate
 }  // namespace yb
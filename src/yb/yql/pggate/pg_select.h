@@ -49,6 +49,10 @@ class PgSelect : public PgDml {
   // Execute.
   CHECKED_STATUS Exec();
 
+  // Add a copy of the request for the currently bound primary key to a batched lookup. Exec()
+  // then reads the rows of all the added keys instead of running the statement as bound.
+  CHECKED_STATUS AppendKey();
+
  private:
   // Allocate column protobuf.
   virtual PgsqlExpressionPB *AllocColumnBindPB(PgColumn *col) override;
@@ -56,12 +60,18 @@ class PgSelect : public PgDml {
   // Allocate protobuf for target.
   PgsqlExpressionPB *AllocTargetPB() override;
 
+  // Allocate protobuf for a where condition, as an operand of the AND of all conditions.
+  PgsqlExpressionPB *AllocWhereCondPB() override;
+
   // Delete allocated target for columns that have no bind-values.
-  CHECKED_STATUS DeleteEmptyPrimaryBinds();
+  CHECKED_STATUS DeleteEmptyPrimaryBinds(PgsqlReadRequestPB *req, bool *full_scan);
 
   // Protobuf instruction.
-  std::shared_ptr<client::YBPgsqlReadOp> read_op_;
+  std::shared_ptr<PgDocReadOp> read_doc_op_;
   PgsqlReadRequestPB *read_req_ = nullptr;
+
+  // Requests of the keys of a batched lookup.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> key_ops_;
 };
 
 }  // namespace pggate
@@ -19,6 +19,17 @@
 #include "yb/client/yb_op.h"
 #include "yb/client/transaction.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(pggate_write_buffer_max_ops, 1024,
+             "Maximum number of write operations of a PostgreSQL transaction that are buffered "
+             "before being flushed. Buffered writes are also flushed before reads and at commit. "
+             "0 disables buffering.");
+
+DEFINE_int64(pggate_write_buffer_max_bytes, 4 * 1024 * 1024,
+             "Maximum size of requests of the buffered write operations of a PostgreSQL "
+             "transaction.");
+
 namespace yb {
 namespace pggate {
 
@@ -47,10 +58,13 @@ static MonoDelta kSessionTimeout = 60s;
 PgSession::PgSession(
     std::shared_ptr<client::YBClient> client,
     const string& database_name,
-    scoped_refptr<PgTxnManager> pg_txn_manager)
+    scoped_refptr<PgTxnManager> pg_txn_manager,
+    MemTrackerPtr mem_tracker)
     : client_(client),
       session_(client_->NewSession()),
-      pg_txn_manager_(std::move(pg_txn_manager)) {
+      table_cache_(std::make_shared<client::YBMetaDataCache>(client_)),
+      pg_txn_manager_(std::move(pg_txn_manager)),
+      mem_tracker_(std::move(mem_tracker)) {
   session_->SetTimeout(kSessionTimeout);
 }
 
@@ -99,6 +113,7 @@ client::YBTableCreator *PgSession::NewTableCreator() {
 }
 
 CHECKED_STATUS PgSession::DropTable(const client::YBTableName& name) {
+  table_cache_->RemoveCachedTable(name);
   return client_->DeleteTable(name);
 }
 
@@ -109,7 +124,8 @@ shared_ptr<client::YBTable> PgSession::GetTableDesc(const client::YBTableName& t
   }
 
   shared_ptr<client::YBTable> yb_table;
-  Status s = client_->OpenTable(table_name, &yb_table);
+  bool cache_used = false;
+  Status s = table_cache_->GetTable(table_name, &yb_table, &cache_used);
   if (!s.ok()) {
     VLOG(3) << "GetTableDesc: Server returns an error: " << s.ToString();
     return nullptr;
@@ -132,7 +148,13 @@ Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const YBTableName& name,
   return make_scoped_refptr<PgTableDesc>(table);
 }
 
+void PgSession::InvalidateCache() {
+  table_cache_->RemoveAllCachedTables();
+}
+
 CHECKED_STATUS PgSession::Apply(const std::shared_ptr<client::YBPgsqlOp>& op) {
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  RETURN_NOT_OK(pg_txn_manager_->FlushBufferedWriteOperations());
   YBSession* session = GetSession(op->read_only());
   return session->ApplyAndFlush(op);
 }
@@ -147,6 +169,60 @@ void PgSession::FlushAsync(StatusFunctor callback) {
   GetSession(/* read_only_op */ true)->FlushAsync(callback);
 }
 
+CHECKED_STATUS PgSession::ApplyAndFlushAsync(
+    const std::vector<std::shared_ptr<client::YBPgsqlOp>>& ops, StatusFunctor callback) {
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  // Reads should see the writes buffered before them, and errors of buffered writes should not be
+  // reported to the callback of another operation.
+  RETURN_NOT_OK(pg_txn_manager_->FlushBufferedWriteOperations());
+  for (const auto& op : ops) {
+    RETURN_NOT_OK(ApplyAsync(op));
+  }
+  FlushAsync(std::move(callback));
+  return Status::OK();
+}
+
+Result<bool> PgSession::TryApplyAndFlushAsync(
+    const std::vector<std::shared_ptr<client::YBPgsqlOp>>& ops, StatusFunctor callback) {
+  std::unique_lock<std::mutex> lock(flush_mutex_, std::try_to_lock);
+  // Buffered writes are flushed synchronously, so leave it to the backend in that case.
+  if (!lock.owns_lock() || pg_txn_manager_->num_buffered_write_ops() != 0) {
+    return false;
+  }
+  for (const auto& op : ops) {
+    RETURN_NOT_OK(ApplyAsync(op));
+  }
+  FlushAsync(std::move(callback));
+  return true;
+}
+
+bool PgSession::CanBufferWriteOperation(const client::YBPgsqlWriteOp& op) {
+  // Only writes of a transaction are buffered, since they are guaranteed to be flushed at commit.
+  // Writes with a RETURNING clause have to be flushed to return their rows.
+  return FLAGS_pggate_write_buffer_max_ops > 0 && pg_txn_manager_->GetTransactionalSession() &&
+         op.request().targets_size() == 0;
+}
+
+CHECKED_STATUS PgSession::BufferWriteOperation(
+    const std::shared_ptr<client::YBPgsqlWriteOp>& op) {
+  DCHECK(CanBufferWriteOperation(*op));
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  RETURN_NOT_OK(ApplyAsync(op));
+  pg_txn_manager_->BufferWriteOperation(op);
+  if (pg_txn_manager_->num_buffered_write_ops() >=
+          static_cast<size_t>(FLAGS_pggate_write_buffer_max_ops) ||
+      pg_txn_manager_->buffered_write_bytes() >=
+          static_cast<size_t>(FLAGS_pggate_write_buffer_max_bytes)) {
+    RETURN_NOT_OK(pg_txn_manager_->FlushBufferedWriteOperations());
+  }
+  return Status::OK();
+}
+
+CHECKED_STATUS PgSession::FlushBufferedWriteOperations() {
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+  return pg_txn_manager_->FlushBufferedWriteOperations();
+}
+
 YBSession* PgSession::GetSession(bool read_only_op) {
   YBSession* txn_session = pg_txn_manager_->GetTransactionalSession();
   if (txn_session) {
@@ -14,6 +14,8 @@
 #ifndef YB_YQL_PGGATE_PG_SESSION_H_
 #define YB_YQL_PGGATE_PG_SESSION_H_
 
+#include <mutex>
+
 #include "yb/client/client.h"
 #include "yb/client/callbacks.h"
 #include "yb/client/schema.h"
@@ -22,6 +24,8 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/callback.h"
 
+#include "yb/util/mem_tracker.h"
+
 #include "yb/yql/pggate/pg_column.h"
 #include "yb/yql/pggate/pg_tabledesc.h"
 
@@ -38,7 +42,8 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // Constructors.
   PgSession(std::shared_ptr<client::YBClient> client,
             const string& database_name,
-            scoped_refptr<PgTxnManager> pg_txn_manager);
+            scoped_refptr<PgTxnManager> pg_txn_manager,
+            MemTrackerPtr mem_tracker);
   virtual ~PgSession();
 
   //------------------------------------------------------------------------------------------------
@@ -70,11 +75,39 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // API for read and write database content.
   Result<PgTableDesc::ScopedRefPtr> LoadTable(const client::YBTableName& name, bool for_write);
 
+  // Forget the cached descriptors of all tables so that they are loaded again from master. Called
+  // when Postgres invalidates its relation cache, e.g. after a table was altered or dropped by
+  // another backend.
+  void InvalidateCache();
+
   // Apply the given operation.
   CHECKED_STATUS Apply(const std::shared_ptr<client::YBPgsqlOp>& op);
   CHECKED_STATUS ApplyAsync(const std::shared_ptr<client::YBPgsqlOp>& op);
   void FlushAsync(StatusFunctor callback);
 
+  // Apply the given operations and flush them, holding the session while doing so, so that the
+  // operations are not mixed with a flush issued concurrently from another thread. Operations on
+  // the same tablet are sent in one request.
+  CHECKED_STATUS ApplyAndFlushAsync(const std::vector<std::shared_ptr<client::YBPgsqlOp>>& ops,
+                                    StatusFunctor callback);
+
+  // Same as ApplyAndFlushAsync, but gives up and returns false if the session is being used by
+  // another thread. Used to send background requests from response callbacks.
+  Result<bool> TryApplyAndFlushAsync(const std::vector<std::shared_ptr<client::YBPgsqlOp>>& ops,
+                                     StatusFunctor callback);
+
+  // Apply the given write operation of the current transaction without flushing it. It is flushed
+  // together with the following writes once --pggate_write_buffer_max_ops operations or
+  // --pggate_write_buffer_max_bytes bytes are buffered, before the next read or unbuffered write,
+  // or at commit. The operation must be one for which CanBufferWriteOperation() returned true.
+  CHECKED_STATUS BufferWriteOperation(const std::shared_ptr<client::YBPgsqlWriteOp>& op);
+
+  // Whether the given write operation can be buffered, instead of being flushed now.
+  bool CanBufferWriteOperation(const client::YBPgsqlWriteOp& op);
+
+  // Flush the buffered write operations, returning the error of the first failed one.
+  CHECKED_STATUS FlushBufferedWriteOperations();
+
   // Return the number of errors which are pending.
   int CountPendingErrors() const;
 
@@ -110,6 +143,11 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
     connected_database_ = "";
   }
 
+  // Memory tracker for results that were fetched ahead of the PostgreSQL backend.
+  const MemTrackerPtr& mem_tracker() const {
+    return mem_tracker_;
+  }
+
  private:
   // Returns the appopriate session to use, in most cases the one used by the current transaction.
   // read_only_op - whether this is being done in the context of a read-only operation. For
@@ -124,12 +162,20 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // YBSession to execute operations.
   std::shared_ptr<client::YBSession> session_;
 
+  // Descriptors of the tables that were opened in this session.
+  std::shared_ptr<client::YBMetaDataCache> table_cache_;
+
   // Connected database.
   std::string connected_database_;
 
   // A transaction manager allowing to begin/abort/commit transactions.
   scoped_refptr<PgTxnManager> pg_txn_manager_;
 
+  // Serializes apply and flush of operations issued by the backend and from response callbacks.
+  std::mutex flush_mutex_;
+
+  MemTrackerPtr mem_tracker_;
+
   // Execution status.
   Status status_;
   string errmsg_;
@@ -13,6 +13,7 @@
 #include "yb/yql/pggate/pggate.h"
 #include "yb/util/status.h"
 #include "yb/client/transaction.h"
+#include "yb/client/yb_op.h"
 #include "yb/common/common.pb.h"
 
 namespace yb {
@@ -82,7 +83,13 @@ Status PgTxnManager::CommitTransaction() {
     ResetTxnAndSession();
     return Status::OK();
   }
-  Status status = txn_->CommitFuture().get();
+  Status status = FlushBufferedWriteOperations();
+  if (!status.ok()) {
+    txn_->Abort();
+    ResetTxnAndSession();
+    return status;
+  }
+  status = txn_->CommitFuture().get();
   ResetTxnAndSession();
   return status;
 }
@@ -102,6 +109,36 @@ Status PgTxnManager::AbortTransaction() {
   return Status::OK();
 }
 
+void PgTxnManager::BufferWriteOperation(std::shared_ptr<client::YBPgsqlWriteOp> op) {
+  buffered_write_bytes_ += op->request().ByteSizeLong();
+  buffered_write_ops_.push_back(std::move(op));
+}
+
+Status PgTxnManager::FlushBufferedWriteOperations() {
+  if (buffered_write_ops_.empty()) {
+    return Status::OK();
+  }
+  auto ops = std::move(buffered_write_ops_);
+  buffered_write_ops_.clear();
+  buffered_write_bytes_ = 0;
+
+  VLOG(2) << "Flushing " << ops.size() << " buffered write operations";
+  Status status = session_->Flush();
+  for (const auto& op : ops) {
+    if (!op->succeeded()) {
+      return STATUS_FORMAT(QLError, "$0: $1", op->ToString(), op->response().error_message());
+    }
+  }
+  if (!status.ok()) {
+    auto errors = session_->GetPendingErrors();
+    if (!errors.empty()) {
+      const auto& error = errors.front();
+      return error->status().CloneAndPrepend(error->failed_op().ToString());
+    }
+  }
+  return status;
+}
+
 // TODO: dedup with similar logic in CQLServiceImpl.
 // TODO: do we need lazy initialization of the txn manager?
 TransactionManager* PgTxnManager::GetOrCreateTransactionManager() {
@@ -132,6 +169,8 @@ void PgTxnManager::ResetTxnAndSession() {
   txn_in_progress_ = false;
   session_ = nullptr;
   txn_ = nullptr;
+  buffered_write_ops_.clear();
+  buffered_write_bytes_ = 0;
 }
 
 }  // namespace pggate
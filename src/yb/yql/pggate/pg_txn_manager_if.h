@@ -15,6 +15,7 @@
 
 #ifdef YBC_CXX_DECLARATION_MODE
 #include <mutex>
+#include <vector>
 
 #include "yb/gutil/macros.h"
 #include "yb/client/client_fwd.h"
@@ -47,6 +48,22 @@ YBC_STATUS_METHOD_NO_ARGS(AbortTransaction)
 
   Status BeginWriteTransactionIfNecessary();
 
+  // Remembers the write operation that was applied to the transactional session without being
+  // flushed, so that it is flushed together with the following ones.
+  void BufferWriteOperation(std::shared_ptr<client::YBPgsqlWriteOp> op);
+
+  // Flushes the buffered write operations. Returns the error of the first failed operation,
+  // prefixed by its description.
+  CHECKED_STATUS FlushBufferedWriteOperations();
+
+  size_t num_buffered_write_ops() const {
+    return buffered_write_ops_.size();
+  }
+
+  size_t buffered_write_bytes() const {
+    return buffered_write_bytes_;
+  }
+
  private:
 
   client::TransactionManager* GetOrCreateTransactionManager();
@@ -57,6 +74,11 @@ YBC_STATUS_METHOD_NO_ARGS(AbortTransaction)
   client::YBTransactionPtr txn_;
   client::YBSessionPtr session_;
 
+  // Write operations applied to session_ that were not flushed yet, and the size of their
+  // requests.
+  std::vector<std::shared_ptr<client::YBPgsqlWriteOp>> buffered_write_ops_;
+  size_t buffered_write_bytes_ = 0;
+
   client::AsyncClientInitialiser* async_client_init_ = nullptr;
   scoped_refptr<ClockBase> clock_;
   std::atomic<client::TransactionManager*> transaction_manager_{nullptr};
@@ -110,7 +110,9 @@ CHECKED_STATUS PgApiImpl::DestroyEnv(PgEnv *pg_env) {
 CHECKED_STATUS PgApiImpl::CreateSession(const PgEnv *pg_env,
                                         const string& database_name,
                                         PgSession **pg_session) {
-  auto session = make_scoped_refptr<PgSession>(client(), database_name, pg_txn_manager_);
+  auto session = make_scoped_refptr<PgSession>(
+      client(), database_name, pg_txn_manager_,
+      MemTracker::FindOrCreateTracker("Prefetched reads", mem_tracker_));
   if (!database_name.empty()) {
     RETURN_NOT_OK(session->ConnectDatabase(database_name));
   }
@@ -146,6 +148,11 @@ CHECKED_STATUS PgApiImpl::ConnectDatabase(PgSession *pg_session, const char *dat
   return pg_session->ConnectDatabase(database_name);
 }
 
+CHECKED_STATUS PgApiImpl::InvalidateCache(PgSession *pg_session) {
+  pg_session->InvalidateCache();
+  return Status::OK();
+}
+
 CHECKED_STATUS PgApiImpl::NewCreateDatabase(PgSession *pg_session,
                                             const char *database_name,
                                             const PgOid database_oid,
@@ -329,6 +336,10 @@ CHECKED_STATUS PgApiImpl::DmlBindColumn(PgStatement *handle, int attr_num, PgExp
   return down_cast<PgDml*>(handle)->BindColumn(attr_num, attr_value);
 }
 
+CHECKED_STATUS PgApiImpl::DmlAppendWhere(PgStatement *handle, PgExpr *cond) {
+  return down_cast<PgDml*>(handle)->AppendWhereCond(cond);
+}
+
 Status PgApiImpl::DmlFetch(PgStatement *handle, uint64_t *values, bool *isnulls,
                            PgSysColumns *syscols, bool *has_data) {
   return down_cast<PgDml*>(handle)->Fetch(values, isnulls, syscols, has_data);
@@ -442,6 +453,14 @@ Status PgApiImpl::ExecSelect(PgStatement *handle) {
   return down_cast<PgSelect*>(handle)->Exec();
 }
 
+Status PgApiImpl::SelectAppendKey(PgStatement *handle) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->AppendKey();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Expressions.
 //--------------------------------------------------------------------------------------------------
@@ -93,6 +93,9 @@ class PgApiImpl {
   // Connect database. Switch the connected database to the given "database_name".
   CHECKED_STATUS ConnectDatabase(PgSession *pg_session, const char *database_name);
 
+  // Invalidate the table descriptors cached by the session.
+  CHECKED_STATUS InvalidateCache(PgSession *pg_session);
+
   // Create database.
   CHECKED_STATUS NewCreateDatabase(PgSession *pg_session,
                                    const char *database_name,
@@ -186,6 +189,9 @@ class PgApiImpl {
   //     execution of the same allocated statement.
   CHECKED_STATUS DmlBindColumn(YBCPgStatement handle, int attr_num, YBCPgExpr attr_value);
 
+  // Append a condition that DocDB evaluates to filter the rows of SELECT.
+  CHECKED_STATUS DmlAppendWhere(PgStatement *handle, PgExpr *cond);
+
   // This function is to fetch the targets in YBCPgDmlAppendTarget() from the rows that were defined
   // by YBCPgDmlBindColumn().
   CHECKED_STATUS DmlFetch(PgStatement *handle, uint64_t *values, bool *isnulls,
@@ -194,10 +200,11 @@ class PgApiImpl {
   // DB Operations: SET, WHERE, ORDER_BY, GROUP_BY, etc.
   // + The following operations are run by DocDB.
   //   - API for "set_clause" (not yet implemented).
+  //   - API for simple conditions of "where_expr" (DmlAppendWhere).
   //
   // + The following operations are run by Postgres layer. An API might be added to move these
   //   operations to DocDB.
-  //   - API for "where_expr"
+  //   - API for the rest of "where_expr"
   //   - API for "order_by_expr"
   //   - API for "group_by_expr"
 
@@ -241,6 +248,9 @@ class PgApiImpl {
 
   CHECKED_STATUS ExecSelect(PgStatement *handle);
 
+  // Add the currently bound primary key to a batched lookup.
+  CHECKED_STATUS SelectAppendKey(PgStatement *handle);
+
   //------------------------------------------------------------------------------------------------
   // Transaction control.
   PgTxnManager* GetPgTxnManager() { return pg_txn_manager_.get(); }
@@ -13,6 +13,8 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <set>
+
 #include "yb/yql/pggate/test/pggate_test.h"
 #include "yb/util/ybc-internal.h"
 
@@ -254,6 +256,130 @@ TEST_F(PggateTestSelect, TestSelectOneTablet) {
 
   CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
   pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing with conditions on regular columns filtered by DocDB";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, nullptr, nullptr, tabname, &pg_stmt));
+
+  // Only select the id column.
+  YBCPgNewColumnRef(pg_stmt, 2, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  // SELECT id ... WHERE hash = 0 AND project_count > 103 AND dependent_count IN (5, 6, 100).
+  CHECK_YBC_STATUS(YBCPgNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+
+  YBCPgExpr cond;
+  YBCPgExpr arg;
+  CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, ">", &cond));
+  CHECK_YBC_STATUS(YBCPgNewColumnRef(pg_stmt, 4, &arg));
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(cond, arg));
+  CHECK_YBC_STATUS(YBCPgNewConstantInt4(pg_stmt, 103, false, &arg));
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(cond, arg));
+  CHECK_YBC_STATUS(YBCPgDmlAppendWhere(pg_stmt, cond));
+
+  CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, "in", &cond));
+  CHECK_YBC_STATUS(YBCPgNewColumnRef(pg_stmt, 3, &arg));
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(cond, arg));
+  for (int16_t value : {5, 6, 100}) {
+    CHECK_YBC_STATUS(YBCPgNewConstantInt2(pg_stmt, value, false, &arg));
+    CHECK_YBC_STATUS(YBCPgOperatorAppendArg(cond, arg));
+  }
+  CHECK_YBC_STATUS(YBCPgDmlAppendWhere(pg_stmt, cond));
+
+  // Execute select statement.
+  YBCPgExecSelect(pg_stmt);
+
+  // Fetching rows and check their contents.
+  values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  std::set<int32_t> selected_ids;
+  for (;;) {
+    bool has_data = false;
+    YBCPgDmlFetch(pg_stmt, values, isnulls, &syscols, &has_data);
+    if (!has_data) {
+      break;
+    }
+    // Columns that are not selected are not returned.
+    CHECK(isnulls[0]);
+    CHECK(!isnulls[1]);
+    CHECK(isnulls[3]);
+    selected_ids.insert(static_cast<int32_t>(values[1]));
+  }
+  CHECK(selected_ids == (std::set<int32_t>{5, 6})) << "Unexpected rows";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing a batch of rows by primary key";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, nullptr, nullptr, tabname, &pg_stmt));
+
+  // Only select the id and job columns.
+  YBCPgNewColumnRef(pg_stmt, 2, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCPgNewColumnRef(pg_stmt, 6, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  // SELECT id, job ... WHERE (hash, id) IN ((0, 2), (0, 4), (0, 7), (0, 100)).
+  CHECK_YBC_STATUS(YBCPgNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgNewConstantInt4(pg_stmt, 0, false, &expr_id));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_id));
+  for (int32_t key_id : {2, 4, 7, 100}) {
+    YBCPgUpdateConstInt4(expr_id, key_id, false);
+    CHECK_YBC_STATUS(YBCPgSelectAppendKey(pg_stmt));
+  }
+
+  // Execute select statement.
+  YBCPgExecSelect(pg_stmt);
+
+  // Fetching rows and check their contents.
+  values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  selected_ids.clear();
+  for (;;) {
+    bool has_data = false;
+    YBCPgDmlFetch(pg_stmt, values, isnulls, &syscols, &has_data);
+    if (!has_data) {
+      break;
+    }
+    int32_t id = static_cast<int32_t>(values[1]);
+    string selected_job_name = reinterpret_cast<char*>(values[5]);
+    CHECK_EQ(selected_job_name, strings::Substitute("Job_title_$0", id));
+    selected_ids.insert(id);
+  }
+  CHECK(selected_ids == (std::set<int32_t>{2, 4, 7})) << "Unexpected rows";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT ----------------------------------------------------------------------------------------
+  LOG(INFO) << "Test SELECTing all rows, scanning tablets in parallel";
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, nullptr, nullptr, tabname, &pg_stmt));
+
+  YBCPgNewColumnRef(pg_stmt, 2, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  // Execute select statement.
+  YBCPgExecSelect(pg_stmt);
+
+  // Every row is fetched exactly once.
+  values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  std::multiset<int32_t> all_ids;
+  for (;;) {
+    bool has_data = false;
+    YBCPgDmlFetch(pg_stmt, values, isnulls, &syscols, &has_data);
+    if (!has_data) {
+      break;
+    }
+    all_ids.insert(static_cast<int32_t>(values[1]));
+  }
+  CHECK(all_ids == (std::multiset<int32_t>{1, 2, 3, 4, 5, 6, 7})) << "Unexpected rows";
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
 }
 
 } // namespace pggate
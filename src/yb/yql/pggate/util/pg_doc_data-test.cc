@@ -0,0 +1,154 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/pggate/util/pg_doc_data.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace pggate {
+
+namespace {
+
+constexpr int kNumRows = 11;
+
+enum Column {
+  kInt32Column,
+  kDoubleColumn,
+  kStringColumn,
+  kBinaryColumn,
+  kNullColumn,
+  kNumColumns,
+};
+
+std::string RowString(int row) {
+  // Values of some rows are empty, which should not be confused with nulls.
+  return std::string(row % 4, 'a' + row);
+}
+
+// Page with a single string column, which has values of the given sizes.
+std::string StringColumnPage(const std::vector<size_t>& sizes) {
+  PgsqlResultSet tuples;
+  for (size_t size : sizes) {
+    tuples.AllocateRSRow(1)->rscol(0)->set_string_value(std::string(size, 'x'));
+  }
+  faststring buffer;
+  CHECK_OK(PgDocData::WriteTuples(tuples, &buffer));
+  return buffer.ToString();
+}
+
+// Offset of the offsets array of the first column in a page.
+size_t FirstColumnOffsetsStart(int64_t row_count) {
+  return 2 * sizeof(int64_t) + sizeof(uint8_t) + (row_count + 7) / 8;
+}
+
+} // namespace
+
+TEST(PgDocDataTest, RoundTrip) {
+  PgsqlResultSet tuples;
+  for (int row = 0; row < kNumRows; row++) {
+    PgsqlRSRow* tuple = tuples.AllocateRSRow(kNumColumns);
+    // Every column but the null one has a null in some rows, including the rows of the last,
+    // partial byte of the null bitmap.
+    if (row % 4 != 1) {
+      tuple->rscol(kInt32Column)->set_int32_value(row * 10);
+    }
+    if (row % 5 != 2) {
+      tuple->rscol(kDoubleColumn)->set_double_value(row / 4.0);
+    }
+    if (row % 3 != 0) {
+      tuple->rscol(kStringColumn)->set_string_value(RowString(row));
+    }
+    if (row != kNumRows - 1) {
+      tuple->rscol(kBinaryColumn)->set_binary_value(std::string(row, '\0'));
+    }
+  }
+
+  faststring buffer;
+  ASSERT_OK(PgDocData::WriteTuples(tuples, &buffer));
+  const std::string data = buffer.ToString();
+  PgColumnarPage page;
+  ASSERT_OK(page.Load(data));
+
+  ASSERT_EQ(kNumRows, page.row_count());
+  ASSERT_EQ(static_cast<size_t>(kNumColumns), page.column_count());
+  ASSERT_EQ(InternalType::kInt32Value, page.column(kInt32Column).type());
+  ASSERT_EQ(InternalType::kDoubleValue, page.column(kDoubleColumn).type());
+  ASSERT_EQ(InternalType::kStringValue, page.column(kStringColumn).type());
+  ASSERT_EQ(InternalType::kBinaryValue, page.column(kBinaryColumn).type());
+  ASSERT_EQ(InternalType::VALUE_NOT_SET, page.column(kNullColumn).type());
+
+  for (int row = 0; row < kNumRows; row++) {
+    SCOPED_TRACE(Format("Row: $0", row));
+    const auto& int32_column = page.column(kInt32Column);
+    ASSERT_EQ(row % 4 == 1, int32_column.is_null(row));
+    if (!int32_column.is_null(row)) {
+      ASSERT_EQ(row * 10, int32_column.number<int32_t>(row));
+    }
+
+    const auto& double_column = page.column(kDoubleColumn);
+    ASSERT_EQ(row % 5 == 2, double_column.is_null(row));
+    if (!double_column.is_null(row)) {
+      ASSERT_EQ(row / 4.0, double_column.number<double>(row));
+    }
+
+    const auto& string_column = page.column(kStringColumn);
+    ASSERT_EQ(row % 3 == 0, string_column.is_null(row));
+    ASSERT_EQ(row % 3 == 0 ? "" : RowString(row), string_column.varlen(row).ToBuffer());
+
+    const auto& binary_column = page.column(kBinaryColumn);
+    ASSERT_EQ(row == kNumRows - 1, binary_column.is_null(row));
+    ASSERT_EQ(row == kNumRows - 1 ? "" : std::string(row, '\0'),
+              binary_column.varlen(row).ToBuffer());
+
+    ASSERT_TRUE(page.column(kNullColumn).is_null(row));
+    ASSERT_TRUE(page.column(kNullColumn).header(row).is_null());
+  }
+}
+
+TEST(PgDocDataTest, EmptyPage) {
+  PgsqlResultSet tuples;
+  faststring buffer;
+  ASSERT_OK(PgDocData::WriteTuples(tuples, &buffer));
+  const std::string data = buffer.ToString();
+  PgColumnarPage page;
+  ASSERT_OK(page.Load(data));
+  ASSERT_EQ(0, page.row_count());
+  ASSERT_EQ(0, page.column_count());
+}
+
+TEST(PgDocDataTest, InvalidOffsets) {
+  const std::vector<size_t> sizes = {1, 2, 3};
+  PgColumnarPage page;
+  ASSERT_OK(page.Load(StringColumnPage(sizes)));
+
+  // Offsets of the rows are 0, 1, 3 and 6. Make them decrease to 0, 1, 0 and 6.
+  std::string data = StringColumnPage(sizes);
+  const size_t offsets_start = FirstColumnOffsetsStart(sizes.size());
+  NetworkByteOrder::Store32(&data[offsets_start + 2 * sizeof(uint32_t)], 0);
+  ASSERT_NOK(page.Load(data));
+
+  // Point the first row past the end of the data.
+  data = StringColumnPage(sizes);
+  NetworkByteOrder::Store32(&data[offsets_start], 7);
+  ASSERT_NOK(page.Load(data));
+
+  // A truncated page is rejected as well.
+  data = StringColumnPage(sizes);
+  data.resize(data.size() - 1);
+  ASSERT_NOK(page.Load(data));
+}
+
+}  // namespace pggate
+}  // namespace yb
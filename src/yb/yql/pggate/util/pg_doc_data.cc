@@ -15,6 +15,8 @@
 
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
+#include <limits>
+
 #include "yb/client/client.h"
 
 namespace yb {
@@ -24,41 +26,102 @@ namespace pggate {
 // Write Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
 Status PgDocData::WriteTuples(const PgsqlResultSet& tuples, faststring *buffer) {
-  // Write the number rows.
-  WriteInt64(tuples.rsrow_count(), buffer);
+  // Write the number rows and columns.
+  const std::vector<PgsqlRSRow>& rows = tuples.rsrows();
+  const size_t col_count = rows.empty() ? 0 : rows.front().rscol_count();
+  WriteInt64(rows.size(), buffer);
+  WriteInt64(col_count, buffer);
 
-  // Write the row contents.
-  for (const PgsqlRSRow& tuple : tuples.rsrows()) {
-    RETURN_NOT_OK(WriteTuple(tuple, buffer));
+  for (const PgsqlRSRow& tuple : rows) {
+    if (tuple.rscol_count() != col_count) {
+      return STATUS_FORMAT(Corruption, "Unexpected number of columns in row: $0, expected $1",
+                           tuple.rscol_count(), col_count);
+    }
   }
-  return Status::OK();
-}
 
-Status PgDocData::WriteTuple(const PgsqlRSRow& tuple, faststring *buffer) {
   // Write the column contents.
-  for (const QLValue& col_value : tuple.rscols()) {
-    RETURN_NOT_OK(WriteColumn(col_value, buffer));
+  for (size_t index = 0; index < col_count; index++) {
+    RETURN_NOT_OK(WriteColumn(tuples, index, buffer));
   }
   return Status::OK();
 }
 
-Status PgDocData::WriteColumn(const QLValue& col_value, faststring *buffer) {
-  // Write data header.
-  bool has_data = true;
-  PgWireDataHeader col_header;
-  if (col_value.IsNull()) {
-    col_header.set_null();
-    has_data = false;
+Status PgDocData::WriteColumn(const PgsqlResultSet& tuples, size_t index, faststring *buffer) {
+  const std::vector<PgsqlRSRow>& rows = tuples.rsrows();
+
+  // All values of a column, except nulls, must have the same type.
+  InternalType type = InternalType::VALUE_NOT_SET;
+  for (const PgsqlRSRow& tuple : rows) {
+    const QLValue& col_value = tuple.rscol_value(index);
+    if (col_value.IsNull()) {
+      continue;
+    }
+    if (type == InternalType::VALUE_NOT_SET) {
+      type = col_value.type();
+    } else if (col_value.type() != type) {
+      return STATUS_FORMAT(Corruption, "Unexpected data was read from database: column $0 has "
+                           "values of types $1 and $2", index, type, col_value.type());
+    }
+  }
+
+  size_t fixed_size = 0;
+  bool is_varlen = false;
+  RETURN_NOT_OK(GetFixedSize(type, &fixed_size, &is_varlen));
+  WriteUint8(static_cast<uint8_t>(type), buffer);
+
+  // Write null bitmap.
+  const size_t nulls_offset = buffer->size();
+  buffer->resize(nulls_offset + (rows.size() + 7) / 8);
+  memset(buffer->data() + nulls_offset, 0, buffer->size() - nulls_offset);
+  for (size_t row = 0; row < rows.size(); row++) {
+    if (rows[row].rscol_value(index).IsNull()) {
+      buffer->data()[nulls_offset + row / 8] |= 1 << (row % 8);
+    }
   }
-  WriteUint8(col_header.ToUint8(), buffer);
 
-  if (!has_data) {
+  if (!is_varlen) {
+    if (fixed_size == 0) {
+      return Status::OK();
+    }
+    for (const PgsqlRSRow& tuple : rows) {
+      const QLValue& col_value = tuple.rscol_value(index);
+      if (col_value.IsNull()) {
+        buffer->resize(buffer->size() + fixed_size);
+        memset(buffer->data() + buffer->size() - fixed_size, 0, fixed_size);
+      } else {
+        WriteFixedValue(col_value, buffer);
+      }
+    }
     return Status::OK();
   }
 
+  // Write offsets of variable size values followed by their contents.
+  uint64_t offset = 0;
+  WriteUint32(0, buffer);
+  for (const PgsqlRSRow& tuple : rows) {
+    const QLValue& col_value = tuple.rscol_value(index);
+    if (!col_value.IsNull()) {
+      offset += type == InternalType::kStringValue ? col_value.string_value().size()
+                                                   : col_value.binary_value().size();
+      if (offset > std::numeric_limits<uint32_t>::max()) {
+        return STATUS_FORMAT(InvalidArgument, "Too much data in column $0 of result page", index);
+      }
+    }
+    WriteUint32(static_cast<uint32_t>(offset), buffer);
+  }
+  for (const PgsqlRSRow& tuple : rows) {
+    const QLValue& col_value = tuple.rscol_value(index);
+    if (!col_value.IsNull()) {
+      const string& value = type == InternalType::kStringValue ? col_value.string_value()
+                                                               : col_value.binary_value();
+      buffer->append(value.data(), value.size());
+    }
+  }
+  return Status::OK();
+}
+
+void PgDocData::WriteFixedValue(const QLValue& col_value, faststring *buffer) {
   switch (col_value.type()) {
-    case InternalType::VALUE_NOT_SET:
-      break;
     case InternalType::kBoolValue:
       WriteBool(col_value.bool_value(), buffer);
       break;
@@ -77,12 +140,39 @@ Status PgDocData::WriteColumn(const QLValue& col_value, faststring *buffer) {
     case InternalType::kDoubleValue:
       WriteDouble(col_value.double_value(), buffer);
       break;
-    case InternalType::kStringValue:
-      WriteText(col_value.string_value(), buffer);
-      break;
+    default:
+      LOG(DFATAL) << "Unexpected fixed size type " << col_value.type();
+  }
+}
+
+Status PgDocData::GetFixedSize(InternalType type, size_t *fixed_size, bool *is_varlen) {
+  *fixed_size = 0;
+  *is_varlen = false;
+  switch (type) {
+    case InternalType::VALUE_NOT_SET:
+      return Status::OK();
+    case InternalType::kBoolValue:
+      *fixed_size = sizeof(bool);
+      return Status::OK();
+    case InternalType::kInt16Value:
+      *fixed_size = sizeof(int16_t);
+      return Status::OK();
+    case InternalType::kInt32Value:
+      *fixed_size = sizeof(int32_t);
+      return Status::OK();
+    case InternalType::kInt64Value:
+      *fixed_size = sizeof(int64_t);
+      return Status::OK();
+    case InternalType::kFloatValue:
+      *fixed_size = sizeof(float);
+      return Status::OK();
+    case InternalType::kDoubleValue:
+      *fixed_size = sizeof(double);
+      return Status::OK();
+    case InternalType::kStringValue: FALLTHROUGH_INTENDED;
     case InternalType::kBinaryValue:
-      WriteBinary(col_value.binary_value(), buffer);
-      break;
+      *is_varlen = true;
+      return Status::OK();
 
     case InternalType::kTimestampValue:
     case InternalType::kDateValue:
@@ -95,7 +185,7 @@ Status PgDocData::WriteColumn(const QLValue& col_value, faststring *buffer) {
     case InternalType::kTimeuuidValue:
       // PgGate has not supported these datatypes yet.
       return STATUS_FORMAT(NotSupported,
-          "Unexpected data was read from database: col_value.type()=$0", col_value.type());
+          "Unexpected data was read from database: col_value.type()=$0", type);
 
     case InternalType::kInt8Value:
     case InternalType::kListValue:
@@ -104,37 +194,77 @@ Status PgDocData::WriteColumn(const QLValue& col_value, faststring *buffer) {
     case InternalType::kFrozenValue:
       // Postgres does not have these datatypes.
       return STATUS_FORMAT(Corruption,
-          "Unexpected data was read from database: col_value.type()=$0", col_value.type());
+          "Unexpected data was read from database: col_value.type()=$0", type);
   }
 
-  return Status::OK();
+  return STATUS_FORMAT(Corruption, "Unexpected data was read from database: type=$0", type);
 }
 
 //--------------------------------------------------------------------------------------------------
 // Read Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
 
-CHECKED_STATUS PgDocData::LoadCache(const string& cache, int64_t *total_row_count, Slice *cursor) {
-  // Setup the buffer to read the next set of tuples.
-  CHECK(cursor->empty()) << "Existing cache is not yet fully read";
-  *cursor = cache;
+namespace {
+
+CHECKED_STATUS ConsumeBytes(Slice *cursor, uint64_t bytes, Slice *result) {
+  if (cursor->size() < bytes) {
+    return STATUS_FORMAT(Corruption, "Result page is truncated: need $0 bytes, $1 left",
+                         bytes, cursor->size());
+  }
+  *result = Slice(cursor->data(), bytes);
+  cursor->remove_prefix(bytes);
+  return Status::OK();
+}
+
+} // namespace
+
+Status PgColumnarColumn::Load(int64_t row_count, Slice *cursor) {
+  Slice type_data;
+  RETURN_NOT_OK(ConsumeBytes(cursor, sizeof(uint8_t), &type_data));
+  type_ = static_cast<InternalType>(type_data[0]);
+  RETURN_NOT_OK(PgDocData::GetFixedSize(type_, &fixed_size_, &is_varlen_));
+
+  RETURN_NOT_OK(ConsumeBytes(cursor, (row_count + 7) / 8, &nulls_));
+  if (!is_varlen_) {
+    return ConsumeBytes(cursor, row_count * fixed_size_, &values_);
+  }
 
-  // Read the number row_count in this set.
-  int64_t this_count;
-  size_t read_size = ReadNumber(cursor, &this_count);
-  *total_row_count = this_count;
-  cursor->remove_prefix(read_size);
+  RETURN_NOT_OK(ConsumeBytes(cursor, (row_count + 1) * sizeof(uint32_t), &values_));
+  const uint32_t data_size = NetworkByteOrder::Load32(values_.data() + row_count * sizeof(uint32_t));
+  RETURN_NOT_OK(ConsumeBytes(cursor, data_size, &data_));
 
+  // Values are read without bounds checks, so make sure that every offset is within the data.
+  uint32_t prev_offset = 0;
+  for (int64_t row = 0; row <= row_count; row++) {
+    const uint32_t offset = NetworkByteOrder::Load32(values_.data() + row * sizeof(uint32_t));
+    if (offset < prev_offset || offset > data_.size()) {
+      return STATUS_FORMAT(Corruption, "Invalid offset $0 of row $1 in result page, previous "
+                           "offset $2, data size $3", offset, row, prev_offset, data_.size());
+    }
+    prev_offset = offset;
+  }
   return Status::OK();
 }
 
-PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
-  // Read for NULL value.
-  uint8_t header_data;
-  size_t read_size = ReadNumber(cursor, &header_data);
-  cursor->remove_prefix(read_size);
+Status PgColumnarPage::Load(const string& data) {
+  Slice cursor(data);
+  Slice header;
+  RETURN_NOT_OK(ConsumeBytes(&cursor, 2 * sizeof(int64_t), &header));
+
+  int64_t col_count;
+  PgWire::ReadNumber(&header, &row_count_);
+  header.remove_prefix(sizeof(int64_t));
+  PgWire::ReadNumber(&header, &col_count);
+  if (row_count_ < 0 || col_count < 0) {
+    return STATUS_FORMAT(Corruption, "Invalid result page with $0 rows and $1 columns",
+                         row_count_, col_count);
+  }
 
-  return PgWireDataHeader(header_data);
+  columns_.resize(col_count);
+  for (PgColumnarColumn& column : columns_) {
+    RETURN_NOT_OK(column.Load(row_count_, &cursor));
+  }
+  return Status::OK();
 }
 
 }  // namespace pggate
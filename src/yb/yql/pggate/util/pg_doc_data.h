@@ -21,17 +21,103 @@
 namespace yb {
 namespace pggate {
 
+// Result pages are sent from DocDB to PgGate in columnar format so that Postgres tuple slots can
+// be filled directly from the page without decoding the rows datum by datum.
+//   int64 row_count
+//   int64 column_count
+//   For each column:
+//     uint8 value type (InternalType). VALUE_NOT_SET is used for columns that are all nulls.
+//     Null bitmap of (row_count + 7) / 8 bytes. Bit (row % 8) of byte (row / 8) is set for nulls.
+//     Fixed size types: an array of row_count values. Null entries are zeros.
+//     Text and binary: an array of (row_count + 1) uint32 offsets, then the bytes of all values.
+//                      The value of a row starts at offsets[row] and ends at offsets[row + 1].
+// All numbers are in network byte order like the rest of the wire protocol.
 class PgDocData : public PgWire {
  public:
   static CHECKED_STATUS WriteTuples(const PgsqlResultSet& tuples, faststring *buffer);
 
-  static CHECKED_STATUS WriteTuple(const PgsqlRSRow& tuple, faststring *buffer);
+  // Get the size of the values of the given type in a page, or whether they have variable size.
+  static CHECKED_STATUS GetFixedSize(InternalType type, size_t *fixed_size, bool *is_varlen);
 
-  static CHECKED_STATUS WriteColumn(const QLValue& col_value, faststring *buffer);
+ private:
+  static CHECKED_STATUS WriteColumn(const PgsqlResultSet& tuples, size_t index,
+                                    faststring *buffer);
 
-  static CHECKED_STATUS LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
+  static void WriteFixedValue(const QLValue& col_value, faststring *buffer);
+};
+
+// A column of a result page. The column points into the page data and cannot outlive it.
+class PgColumnarColumn {
+ public:
+  CHECKED_STATUS Load(int64_t row_count, Slice *cursor);
+
+  InternalType type() const {
+    return type_;
+  }
+
+  bool is_null(int64_t row) const {
+    return (nulls_[row / 8] & (1 << (row % 8))) != 0;
+  }
+
+  PgWireDataHeader header(int64_t row) const {
+    PgWireDataHeader header;
+    if (is_null(row)) {
+      header.set_null();
+    }
+    return header;
+  }
+
+  // Read a fixed size value.
+  template<typename num_type>
+  num_type number(int64_t row) const {
+    DCHECK_EQ(sizeof(num_type), fixed_size_);
+    num_type value;
+    Slice cursor(values_.data() + row * sizeof(num_type), sizeof(num_type));
+    PgWire::ReadNumber(&cursor, &value);
+    return value;
+  }
+
+  // Read a variable size value.
+  Slice varlen(int64_t row) const {
+    DCHECK(is_varlen_);
+    const uint32_t start = NetworkByteOrder::Load32(values_.data() + row * sizeof(uint32_t));
+    const uint32_t end = NetworkByteOrder::Load32(values_.data() + (row + 1) * sizeof(uint32_t));
+    return Slice(data_.data() + start, end - start);
+  }
+
+ private:
+  InternalType type_ = InternalType::VALUE_NOT_SET;
+  size_t fixed_size_ = 0;
+  bool is_varlen_ = false;
+
+  Slice nulls_;
+
+  // Fixed size values, or the offsets of variable size values in data_.
+  Slice values_;
+  Slice data_;
+};
+
+// A page of result rows in columnar format. See PgDocData for the layout.
+class PgColumnarPage {
+ public:
+  // Parse a page. The page points into the data, which must outlive it.
+  CHECKED_STATUS Load(const string& data);
+
+  int64_t row_count() const {
+    return row_count_;
+  }
+
+  size_t column_count() const {
+    return columns_.size();
+  }
+
+  const PgColumnarColumn& column(size_t index) const {
+    return columns_[index];
+  }
 
-  static PgWireDataHeader ReadDataHeader(Slice *cursor);
+ private:
+  int64_t row_count_ = 0;
+  std::vector<PgColumnarColumn> columns_;
 };
 
 }  // namespace pggate
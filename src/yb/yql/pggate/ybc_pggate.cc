@@ -79,6 +79,10 @@ YBCStatus YBCPgConnectDatabase(YBCPgSession pg_session, const char *database_nam
   return ToYBCStatus(pgapi->ConnectDatabase(pg_session, database_name));
 }
 
+YBCStatus YBCPgInvalidateCache(YBCPgSession pg_session) {
+  return ToYBCStatus(pgapi->InvalidateCache(pg_session));
+}
+
 YBCStatus YBCPgNewCreateDatabase(YBCPgSession pg_session,
                                  const char *database_name,
                                  const YBCPgOid database_oid,
@@ -228,6 +232,10 @@ YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle,
   return ToYBCStatus(pgapi->DmlBindColumn(handle, attr_num, attr_value));
 }
 
+YBCStatus YBCPgDmlAppendWhere(YBCPgStatement handle, YBCPgExpr cond) {
+  return ToYBCStatus(pgapi->DmlAppendWhere(handle, cond));
+}
+
 YBCStatus YBCPgDmlFetch(YBCPgStatement handle, uint64_t *values, bool *isnulls,
                         YBCPgSysColumns *syscols, bool *has_data) {
   return ToYBCStatus(pgapi->DmlFetch(handle, values, isnulls, syscols, has_data));
@@ -301,6 +309,10 @@ YBCStatus YBCPgExecSelect(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecSelect(handle));
 }
 
+YBCStatus YBCPgSelectAppendKey(YBCPgStatement handle) {
+  return ToYBCStatus(pgapi->SelectAppendKey(handle));
+}
+
 //--------------------------------------------------------------------------------------------------
 // Expression Operations
 //--------------------------------------------------------------------------------------------------
@@ -350,6 +362,10 @@ YBCStatus YBCPgNewConstantBinary(YBCPgStatement stmt, const void *value, int64_t
 }
 
 // Overwriting the expression's result with any desired values.
+YBCStatus YBCPgUpdateConstBool(YBCPgExpr expr, bool value, bool is_null) {
+  return ToYBCStatus(pgapi->UpdateConstant(expr, value, is_null));
+}
+
 YBCStatus YBCPgUpdateConstInt2(YBCPgExpr expr, int16_t value, bool is_null) {
   return ToYBCStatus(pgapi->UpdateConstant(expr, value, is_null));
 }
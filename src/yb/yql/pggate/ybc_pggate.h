@@ -57,6 +57,10 @@ YBCStatus YBCPgClearBinds(YBCPgStatement handle);
 // Connect database. Switch the connected database to the given "database_name".
 YBCStatus YBCPgConnectDatabase(YBCPgSession pg_session, const char *database_name);
 
+// Invalidate the table descriptors cached by the session. They are loaded again from master the
+// next time the tables are used.
+YBCStatus YBCPgInvalidateCache(YBCPgSession pg_session);
+
 // Create database.
 YBCStatus YBCPgNewCreateDatabase(YBCPgSession pg_session,
                                  const char *database_name,
@@ -158,6 +162,13 @@ YBCStatus YBCPgDmlBindColumn(YBCPgStatement handle,
                              int attr_num,
                              YBCPgExpr attr_value);
 
+// Append a condition that is evaluated by DocDB to filter the rows of SELECT, such as
+//   SELECT ... WHERE col > value
+// The condition is an operator built by YBCPgNewOperator() on a column and constants:
+// comparisons, "in" (the column followed by the values) and "is null" / "is not null".
+// Conditions are combined with AND.
+YBCStatus YBCPgDmlAppendWhere(YBCPgStatement handle, YBCPgExpr cond);
+
 // This function is to fetch the targets in YBCPgDmlAppendTarget() from the rows that were defined
 // by YBCPgDmlBindColumn().
 YBCStatus YBCPgDmlFetch(YBCPgStatement handle, uint64_t *values, bool *isnulls,
@@ -166,10 +177,11 @@ YBCStatus YBCPgDmlFetch(YBCPgStatement handle, uint64_t *values, bool *isnulls,
 // DB Operations: SET, WHERE, ORDER_BY, GROUP_BY, etc.
 // + The following operations are run by DocDB.
 //   - API for "set_clause" (not yet implemented).
+//   - API for simple conditions of "where_expr" (YBCPgDmlAppendWhere).
 //
 // + The following operations are run by Postgres layer. An API might be added to move these
 //   operations to DocDB.
-//   - API for "where_expr"
+//   - API for the rest of "where_expr"
 //   - API for "order_by_expr"
 //   - API for "group_by_expr"
 
@@ -209,6 +221,15 @@ YBCStatus YBCPgNewSelect(YBCPgSession pg_session,
 
 YBCStatus YBCPgExecSelect(YBCPgStatement handle);
 
+// Batched lookup of rows by primary key, e.g. to fetch the base rows found in a secondary index.
+// - Bind the key columns with YBCPgDmlBindColumn() once. For every key, update the bound values
+//   (e.g. with YBCPgUpdateConstInt4()) and call YBCPgSelectAppendKey() to add the key to the
+//   batch. Then call YBCPgExecSelect() once.
+// - The partition columns of every key must be bound. The range columns are either all bound or
+//   all unbound.
+// - Keys of the same tablet are sent to DocDB in one request.
+YBCStatus YBCPgSelectAppendKey(YBCPgStatement handle);
+
 // Transaction control -----------------------------------------------------------------------------
 YBCPgTxnManager YBCGetPgTxnManager();
 
@@ -238,6 +259,7 @@ YBCStatus YBCPgNewConstantBinary(YBCPgStatement stmt, const void *value, int64_t
 
 // The following update functions only work for constants.
 // Overwriting the constant expression with new value.
+YBCStatus YBCPgUpdateConstBool(YBCPgExpr expr, bool value, bool is_null);
 YBCStatus YBCPgUpdateConstInt2(YBCPgExpr expr, int16_t value, bool is_null);
 YBCStatus YBCPgUpdateConstInt4(YBCPgExpr expr, int32_t value, bool is_null);
 YBCStatus YBCPgUpdateConstInt8(YBCPgExpr expr, int64_t value, bool is_null);
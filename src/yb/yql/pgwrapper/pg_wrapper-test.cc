@@ -75,5 +75,25 @@ TEST_F(PgWrapperTest, TestStartStop) {
   ASSERT_OK(postgres.Start());
 }
 
+TEST_F(PgWrapperTest, TestMaxConnections) {
+  PgWrapperConf conf {
+    pg_data_dir_,
+    pg_port_
+  };
+  conf.max_connections = 10;
+  PgWrapper postgres(conf);
+
+  ASSERT_OK(postgres.InitDB());
+  ASSERT_OK(postgres.Start());
+
+  // The postmaster records its command line options in postmaster.opts once it is running.
+  const string opts_path = JoinPathSegments(pg_data_dir_, "postmaster.opts");
+  ASSERT_OK(WaitFor([&opts_path] { return Env::Default()->FileExists(opts_path); },
+                    MonoDelta::FromSeconds(30), "Wait for postmaster.opts"));
+  faststring opts;
+  ASSERT_OK(ReadFileToString(Env::Default(), opts_path, &opts));
+  ASSERT_STR_CONTAINS(opts.ToString(), "max_connections=10");
+}
+
 }  // namespace pgwrapper
 }  // namespace yb
@@ -15,11 +15,19 @@
 #include <vector>
 #include <string>
 
+#include <gflags/gflags.h>
+
 #include "yb/util/logging.h"
 #include "yb/util/subprocess.h"
 #include "yb/util/env_util.h"
 #include "yb/util/path_util.h"
 
+DEFINE_int32(pg_wrapper_max_connections, 0,
+             "Overrides max_connections of the PostgreSQL server started by the tablet server, "
+             "i.e. the maximum number of concurrent backends. Each backend keeps its own catalog "
+             "cache and DocDB session, so a lower value bounds the memory they use. 0 keeps the "
+             "value of the PostgreSQL configuration.");
+
 using std::vector;
 using std::string;
 
@@ -40,6 +48,12 @@ Status PgWrapper::Start() {
     "--port",
     std::to_string(conf_.pg_port)
   };
+  const int max_connections =
+      conf_.max_connections > 0 ? conf_.max_connections : FLAGS_pg_wrapper_max_connections;
+  if (max_connections > 0) {
+    argv.push_back("-c");
+    argv.push_back("max_connections=" + std::to_string(max_connections));
+  }
 
   if (!Env::Default()->FileExists(postgres_executable)) {
     return STATUS_FORMAT(IOError, "PostgreSQL executable not found: $0", postgres_executable);
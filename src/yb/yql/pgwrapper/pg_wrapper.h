@@ -30,6 +30,11 @@ std::string GetPostgresInstallRoot();
 struct PgWrapperConf {
   std::string data_dir;
   uint16_t pg_port;
+
+  // Upper bound on the number of backends the PostgreSQL server may run at once. Zero means the
+  // value of --pg_wrapper_max_connections is used, and if that is zero too, the value of the
+  // PostgreSQL configuration.
+  int max_connections = 0;
 };
 
 class PgWrapper {
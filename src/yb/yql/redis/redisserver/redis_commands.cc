@@ -59,6 +59,8 @@ DEFINE_string(redis_passwords_separator, ",", "The character used to separate mu
 
 DEFINE_int32(redis_keys_threshold, 10000,
              "Maximum number of keys allowed to be in the db before the KEYS operation errors out");
+DEFINE_int32(redis_scan_parallel_tablets, 8,
+             "Maximum number of tablets a single SCAN command reads from in parallel.");
 
 __attribute__((unused))
 DEFINE_validator(redis_passwords_separator, &ValidateRedisPasswordSeparator);
@@ -130,10 +132,14 @@ namespace redisserver {
     ((psubscribe, PSubscribe, -2, LOCAL)) \
     ((punsubscribe, PUnsubscribe, -1, LOCAL)) \
     ((quit, Quit, 1, LOCAL)) \
+    ((multi, Multi, 1, LOCAL)) \
+    ((exec, Exec, 1, LOCAL)) \
+    ((discard, Discard, 1, LOCAL)) \
     ((flushdb, FlushDB, 1, LOCAL)) \
     ((flushall, FlushAll, 1, LOCAL)) \
     ((debugsleep, DebugSleep, 2, LOCAL)) \
     ((keys, Keys, 2, LOCAL)) \
+    ((scan, Scan, -2, LOCAL)) \
     ((cluster, Cluster, -2, CLUSTER)) \
     ((persist, Persist, 2, WRITE)) \
     ((expire, Expire, 3, WRITE)) \
@@ -215,6 +221,16 @@ void Command(
     BOOST_PP_CAT(Handle, cname)({info, idx, context});
 #define CLUSTER_COMMAND(cname) ClusterCommand(info, idx, context)
 
+#define READ_COMMAND_READ_ONLY true
+#define WRITE_COMMAND_READ_ONLY false
+#define LOCAL_COMMAND_READ_ONLY false
+#define CLUSTER_COMMAND_READ_ONLY false
+
+#define READ_COMMAND_LOCAL false
+#define WRITE_COMMAND_LOCAL false
+#define LOCAL_COMMAND_LOCAL true
+#define CLUSTER_COMMAND_LOCAL true
+
 #define DO_POPULATE_HANDLER(name, cname, arity, type) \
   { \
     auto functor = [](const RedisCommandInfo& info, \
@@ -223,7 +239,9 @@ void Command(
       BOOST_PP_CAT(type, _COMMAND)(cname); \
     }; \
     yb::rpc::RpcMethodMetrics metrics(YB_REDIS_METRIC(name).Instantiate(metric_entity)); \
-    setup_method({BOOST_PP_STRINGIZE(name), functor, arity, std::move(metrics)}); \
+    setup_method({BOOST_PP_STRINGIZE(name), functor, arity, std::move(metrics), \
+                  BOOST_PP_CAT(type, _COMMAND_READ_ONLY), \
+                  BOOST_PP_CAT(type, _COMMAND_LOCAL)}); \
   } \
   /**/
 
@@ -558,119 +576,277 @@ void HandlePing(LocalCommandData data) {
   data.Respond(&response);
 }
 
+// Sends a keys request to each of the given partitions in parallel, and builds the response from
+// the tablet responses once all of them are received.
 class KeysProcessor : public std::enable_shared_from_this<KeysProcessor> {
  public:
-  explicit KeysProcessor(const LocalCommandData& data)
-      : data_(data),
-        partitions_(data.table()->GetPartitions()), sessions_(partitions_.size()),
-        callbacks_(partitions_.size()) {
-    resp_.set_code(RedisResponsePB::OK);
+  KeysProcessor(const LocalCommandData& data, std::vector<std::string> partitions)
+      : data_(data), partitions_(std::move(partitions)), sessions_(partitions_.size()),
+        callbacks_(partitions_.size()), operations_(partitions_.size()),
+        statuses_(partitions_.size()) {
+  }
+
+  virtual ~KeysProcessor() = default;
+
+  void Start() {
+    size_t idx = 0;
+    for (const std::string& partition_key : partitions_) {
+      data_.Apply(std::bind(&KeysProcessor::Store, shared_from_this(), idx, _1, _2),
+                  partition_key, ManualResponse::kTrue);
+      ++idx;
+    }
+  }
+
+ protected:
+  virtual void FillRequest(RedisKeysRequestPB* request) = 0;
+
+  // Builds the response from the tablet responses, that are ordered by partition.
+  virtual void ProcessResponses(
+      const std::vector<std::shared_ptr<client::YBRedisReadOp>>& operations,
+      RedisResponsePB* resp) = 0;
+
+  const LocalCommandData& data() const {
+    return data_;
+  }
+
+  static void MoveElements(RedisResponsePB* source, RedisArrayPB* dest) {
+    auto* elements = source->mutable_array_response()->mutable_elements();
+    const int count = elements->size();
+    auto** data = elements->mutable_data();
+    for (int i = 0; i != count; ++i) {
+      dest->mutable_elements()->AddAllocated(data[i]);
+    }
+    elements->ExtractSubrange(0, count, nullptr);
   }
 
+ private:
   bool Store(size_t idx, client::YBSession* session, const StatusFunctor& callback) {
     sessions_[idx] = session;
     callbacks_[idx] = callback;
     if (stored_.fetch_add(1, std::memory_order_acq_rel) + 1 == callbacks_.size()) {
-      Execute(0);
+      Execute();
     }
     return true;
   }
 
-  const std::vector<std::string>& partitions() const {
-    return partitions_;
+  void Execute() {
+    for (size_t idx = 0; idx != partitions_.size(); ++idx) {
+      const auto& partition_key = partitions_[idx];
+      auto operation = std::make_shared<client::YBRedisReadOp>(data_.table()->shared_from_this());
+      auto request = operation->mutable_request();
+      uint16_t hash_code = partition_key.size() == 0 ?
+          0 : PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+      request->mutable_key_value()->set_hash_code(hash_code);
+      FillRequest(request->mutable_keys_request());
+      operations_[idx] = operation;
+      sessions_[idx]->set_allow_local_calls_in_curr_thread(false);
+      auto status = sessions_[idx]->Apply(operation);
+      if (!status.ok()) {
+        ProcessedOne(idx, status);
+        continue;
+      }
+      sessions_[idx]->FlushAsync(std::bind(
+          &KeysProcessor::ProcessedOne, shared_from_this(), idx, _1));
+    }
   }
 
- private:
-  void Execute(size_t idx) {
-    if (idx == partitions_.size()) {
-      ProcessedAll(Status::OK());
-      return;
+  void ProcessedOne(size_t idx, const Status& status) {
+    statuses_[idx] = status;
+    if (processed_.fetch_add(1, std::memory_order_acq_rel) + 1 == partitions_.size()) {
+      ProcessedAll();
     }
+  }
 
-    const auto& partition_key = partitions_[idx];
-    auto operation = std::make_shared<client::YBRedisReadOp>(data_.table()->shared_from_this());
-    auto request = operation->mutable_request();
-    uint16_t hash_code = partition_key.size() == 0 ?
-        0 : PartitionSchema::DecodeMultiColumnHashValue(partition_key);
-    request->mutable_key_value()->set_hash_code(hash_code);
-    request->mutable_keys_request()->set_pattern(data_.arg(1).ToBuffer());
-    request->mutable_keys_request()->set_threshold(keys_threshold_);
-    sessions_[idx]->set_allow_local_calls_in_curr_thread(false);
-    auto status = sessions_[idx]->Apply(operation);
-    if (!status.ok()) {
-      ProcessedAll(status);
-      return;
+  void ProcessedAll() {
+    Status status;
+    for (const auto& partition_status : statuses_) {
+      if (!partition_status.ok()) {
+        status = partition_status;
+        break;
+      }
     }
-    sessions_[idx]->FlushAsync(std::bind(
-        &KeysProcessor::ProcessedOne, shared_from_this(), idx, operation, _1));
-  }
 
-  void ProcessedOne(
-      size_t idx, const std::shared_ptr<client::YBRedisReadOp>& operation, const Status& status) {
-    if (!status.ok()) {
-      ProcessedAll(status);
-      return;
+    RedisResponsePB resp;
+    resp.set_code(RedisResponsePB::OK);
+    if (status.ok()) {
+      ProcessResponses(operations_, &resp);
     }
+    data_.Respond(status, &resp);
 
-    auto& response = *operation->mutable_response();
-    if (response.code() == RedisResponsePB::SERVER_ERROR) {
-      // We received too many keys, forwarding the error message.
-      resp_ = response;
-      ProcessedAll(Status::OK());
-      return;
+    for (const auto& callback : callbacks_) {
+      callback(status);
     }
+  }
 
-    size_t count = response.array_response().elements_size();
-    auto** elements = response.mutable_array_response()->mutable_elements()->mutable_data();
-    keys_threshold_ -= count;
+  LocalCommandData data_;
 
-    auto& array_response = *resp_.mutable_array_response();
-    for (size_t i = 0; i != count; ++i) {
-      array_response.mutable_elements()->AddAllocated(elements[i]);
-    }
+  std::vector<std::string> partitions_;
+  std::vector<client::YBSession*> sessions_;
+  std::vector<StatusFunctor> callbacks_;
+  std::vector<std::shared_ptr<client::YBRedisReadOp>> operations_;
+  std::vector<Status> statuses_;
+  std::atomic<size_t> stored_{0};
+  std::atomic<size_t> processed_{0};
+};
 
-    response.mutable_array_response()->mutable_elements()->ExtractSubrange(0, count, nullptr);
+class KeysCommandProcessor : public KeysProcessor {
+ public:
+  explicit KeysCommandProcessor(const LocalCommandData& data)
+      : KeysProcessor(data, data.table()->GetPartitions()) {
+  }
+
+ private:
+  void FillRequest(RedisKeysRequestPB* request) override {
+    request->set_pattern(data().arg(1).ToBuffer());
+    request->set_threshold(FLAGS_redis_keys_threshold);
+  }
 
-    if (keys_threshold_ == 0) {
-      ProcessedAll(Status::OK());
+  void ProcessResponses(
+      const std::vector<std::shared_ptr<client::YBRedisReadOp>>& operations,
+      RedisResponsePB* resp) override {
+    int total_keys = 0;
+    for (const auto& operation : operations) {
+      const auto& response = operation->response();
+      if (response.code() == RedisResponsePB::SERVER_ERROR) {
+        // We received too many keys, forwarding the error message.
+        *resp = response;
+        return;
+      }
+      total_keys += response.array_response().elements_size();
+    }
+    if (total_keys > FLAGS_redis_keys_threshold) {
+      resp->set_code(RedisResponsePB::SERVER_ERROR);
+      resp->set_error_message("Too many keys in the database.");
       return;
     }
 
-    Execute(idx + 1);
+    auto& array_response = *resp->mutable_array_response();
+    for (const auto& operation : operations) {
+      MoveElements(operation->mutable_response(), &array_response);
+    }
   }
+};
 
-  void ProcessedAll(const Status& status) {
-    data_.Respond(status, &resp_);
+// SCAN cursor is the hash code to continue the scan from, so it stays a plain integer for clients
+// and still identifies both the tablet and the position in it. Each tablet stops at a hash code
+// boundary, so no key is returned twice or skipped.
+class ScanProcessor : public KeysProcessor {
+ public:
+  ScanProcessor(const LocalCommandData& data, std::vector<std::string> partitions,
+                uint16_t cursor, std::string pattern, int count)
+      : KeysProcessor(data, std::move(partitions)), cursor_(cursor), pattern_(std::move(pattern)),
+        count_(count) {
+  }
 
-    for (const auto& callback : callbacks_) {
-      callback(status);
-    }
+ private:
+  void FillRequest(RedisKeysRequestPB* request) override {
+    // Tablets after the first one contain only keys with higher hash codes, so the same start is
+    // valid for them.
+    request->set_pattern(pattern_);
+    request->set_start_hash_code(cursor_);
+    request->set_count(count_);
   }
 
-  LocalCommandData data_;
+  void ProcessResponses(
+      const std::vector<std::shared_ptr<client::YBRedisReadOp>>& operations,
+      RedisResponsePB* resp) override {
+    RedisResponsePB keys;
+    int next_cursor = 0;
+    for (const auto& operation : operations) {
+      auto* response = operation->mutable_response();
+      if (response->code() != RedisResponsePB::OK) {
+        *resp = *response;
+        return;
+      }
+      MoveElements(response, keys.mutable_array_response());
+      if (response->has_next_hash_code()) {
+        // Cursor 0 tells the client that the scan is complete.
+        next_cursor = response->next_hash_code() < kRedisClusterSlots
+            ? response->next_hash_code() : 0;
+        break;
+      }
+    }
 
-  std::vector<std::string> partitions_;
-  std::vector<client::YBSession*> sessions_;
-  std::vector<StatusFunctor> callbacks_;
-  std::atomic<size_t> stored_{0};
-  RedisResponsePB resp_;
-  size_t keys_threshold_ = FLAGS_redis_keys_threshold;
+    auto* array_response = resp->mutable_array_response();
+    AddElements(redisserver::EncodeAsBulkString(std::to_string(next_cursor)), array_response);
+    AddElements(redisserver::EncodeAsArray(keys.array_response().elements()), array_response);
+    array_response->set_encoded(true);
+  }
+
+  const uint16_t cursor_;
+  const std::string pattern_;
+  const int count_;
 };
 
 void HandleKeys(LocalCommandData data) {
-  auto processor = std::make_shared<KeysProcessor>(data);
-  size_t idx = 0;
-  for (const std::string& partition_key : processor->partitions()) {
-    data.Apply(std::bind(
-        &KeysProcessor::Store, processor, idx, _1, _2), partition_key, ManualResponse::kTrue);
-    ++idx;
+  std::make_shared<KeysCommandProcessor>(data)->Start();
+}
+
+// SCAN cursor [MATCH pattern] [COUNT count]
+void HandleScan(LocalCommandData data) {
+  auto cursor = util::CheckedStoll(data.arg(1));
+  if (!cursor.ok() || *cursor < 0 || *cursor >= kRedisClusterSlots) {
+    data.Respond(STATUS(InvalidArgument, "invalid cursor"), nullptr);
+    return;
+  }
+  std::string pattern = "*";
+  int64_t count = 10;
+  for (size_t i = 2; i < data.arg_size(); i += 2) {
+    if (i + 1 == data.arg_size()) {
+      data.Respond(STATUS(InvalidArgument, "syntax error"), nullptr);
+      return;
+    }
+    if (boost::iequals(data.arg(i).ToBuffer(), "MATCH")) {
+      pattern = data.arg(i + 1).ToBuffer();
+    } else if (boost::iequals(data.arg(i).ToBuffer(), "COUNT")) {
+      auto parsed_count = util::CheckedStoll(data.arg(i + 1));
+      if (!parsed_count.ok() || *parsed_count < 1 ||
+          *parsed_count > std::numeric_limits<int32_t>::max()) {
+        data.Respond(STATUS(InvalidArgument, "value is not an integer or out of range"), nullptr);
+        return;
+      }
+      count = *parsed_count;
+    } else {
+      data.Respond(STATUS(InvalidArgument, "syntax error"), nullptr);
+      return;
+    }
   }
+
+  // Scan the tablet containing the cursor and the tablets following it in hash order.
+  auto all_partitions = data.table()->GetPartitions();
+  size_t first = 0;
+  while (first + 1 < all_partitions.size() &&
+         PartitionSchema::DecodeMultiColumnHashValue(all_partitions[first + 1]) <= *cursor) {
+    ++first;
+  }
+  const size_t last =
+      std::min<size_t>(all_partitions.size(), first + FLAGS_redis_scan_parallel_tablets);
+  std::vector<std::string> partitions(
+      all_partitions.begin() + first, all_partitions.begin() + last);
+  std::make_shared<ScanProcessor>(
+      data, std::move(partitions), *cursor, std::move(pattern), count)->Start();
 }
 
 void HandleCommand(LocalCommandData data) {
   data.Respond();
 }
 
+// MULTI followed by EXEC or DISCARD in the same batch is handled by the service, so we get here
+// only when the batch does not contain the end of the transaction.
+void HandleMulti(LocalCommandData data) {
+  data.Respond(
+      STATUS(InvalidCommand, "MULTI must be followed by EXEC or DISCARD in the same pipeline"),
+      nullptr);
+}
+
+void HandleExec(LocalCommandData data) {
+  data.Respond(STATUS(InvalidCommand, "EXEC without MULTI"), nullptr);
+}
+
+void HandleDiscard(LocalCommandData data) {
+  data.Respond(STATUS(InvalidCommand, "DISCARD without MULTI"), nullptr);
+}
+
 void HandleQuit(LocalCommandData data) {
   data.call()->MarkForClose();
   data.Respond();
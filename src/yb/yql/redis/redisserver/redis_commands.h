@@ -124,6 +124,10 @@ struct RedisCommandInfo {
   // that we expect at least -arity-1 arguments.
   int arity;
   yb::rpc::RpcMethodMetrics metrics;
+  // Whether command only reads data, so it is handled by a single asynchronous read.
+  bool read_only;
+  // Whether command is handled by the proxy instead of being sent to a tablet.
+  bool local;
 };
 
 typedef std::shared_ptr<RedisCommandInfo> RedisCommandInfoPtr;
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+#include <vector>
+
+#include "yb/yql/redis/redisserver/redis_parser.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(redis_parser_test_iterations, 200000,
+             "Number of commands to parse in RedisParserTest.Throughput");
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+IoVecs SingleBlock(const std::string& data) {
+  return IoVecs(1, iovec{const_cast<char*>(data.data()), data.size()});
+}
+
+} // namespace
+
+class RedisParserTest : public YBTest {
+ protected:
+  void CheckArgs(const std::string& data, const std::vector<std::string>& expected) {
+    RedisParser parser(SingleBlock(data));
+    RedisClientCommand args;
+    parser.SetArgs(&args);
+    auto end = ASSERT_RESULT(parser.NextCommand());
+    ASSERT_EQ(data.size(), end);
+    ASSERT_EQ(expected.size(), args.size());
+    for (size_t i = 0; i != expected.size(); ++i) {
+      ASSERT_EQ(expected[i], args[i].ToBuffer());
+    }
+  }
+
+  void CheckInvalid(const std::string& data) {
+    RedisParser parser(SingleBlock(data));
+    ASSERT_NOK(parser.NextCommand()) << data;
+  }
+};
+
+TEST_F(RedisParserTest, Bulk) {
+  CheckArgs("*1\r\n$4\r\nPING\r\n", {"PING"});
+  CheckArgs("*3\r\n$3\r\nSET\r\n$0\r\n\r\n$5\r\nvalue\r\n", {"SET", "", "value"});
+  CheckArgs("*2\r\n$3\r\nGET\r\n$010\r\n0123456789\r\n", {"GET", "0123456789"});
+  CheckArgs("*1\r\n$+4\r\nPING\r\n", {"PING"});
+
+  CheckInvalid("*0\r\n");
+  CheckInvalid("*-1\r\n");
+  CheckInvalid("*x\r\n");
+  CheckInvalid("*\r\n");
+  CheckInvalid("* 1\r\n");
+  CheckInvalid("*1\r\n$-1\r\n");
+  CheckInvalid("*1\r\n$4x\r\nPING\r\n");
+  CheckInvalid("*1\r\n$999999999999999999\r\n");
+  CheckInvalid("*1\r\n$99999999999999999999\r\n");
+  CheckInvalid("*1\r\n$4\nPING\r\n");
+}
+
+// Checks that numbers crossing block boundary are parsed correctly.
+TEST_F(RedisParserTest, SplitBlocks) {
+  const std::string data = "*2\r\n$3\r\nGET\r\n$12\r\nkey_12345678\r\n";
+  for (size_t split = 1; split != data.size(); ++split) {
+    std::string first = data.substr(0, split);
+    std::string second = data.substr(split);
+    IoVecs source = {
+      iovec{const_cast<char*>(first.data()), first.size()},
+      iovec{const_cast<char*>(second.data()), second.size()},
+    };
+    RedisParser parser(source);
+    auto end = ASSERT_RESULT(parser.NextCommand());
+    ASSERT_EQ(data.size(), end) << "Split at " << split;
+  }
+}
+
+TEST_F(RedisParserTest, Throughput) {
+  const std::string command =
+      "*3\r\n$3\r\nSET\r\n$16\r\nkey_0123456789ab\r\n$32\r\n"
+      "value_0123456789abcdef0123456789\r\n";
+  std::string data;
+  const int kCommandsPerBlock = 1000;
+  data.reserve(command.size() * kCommandsPerBlock);
+  for (int i = 0; i != kCommandsPerBlock; ++i) {
+    data += command;
+  }
+
+  const int iterations = FLAGS_redis_parser_test_iterations / kCommandsPerBlock;
+  auto start = MonoTime::Now();
+  for (int i = 0; i != iterations; ++i) {
+    RedisParser parser(SingleBlock(data));
+    for (int j = 0; j != kCommandsPerBlock; ++j) {
+      auto end = ASSERT_RESULT(parser.NextCommand());
+      ASSERT_EQ(command.size() * (j + 1), end);
+    }
+  }
+  auto passed = MonoTime::Now() - start;
+  auto total_bytes = data.size() * iterations;
+  LOG(INFO) << "Parsed " << iterations * kCommandsPerBlock << " commands, " << total_bytes
+            << " bytes in " << passed << ", "
+            << total_bytes / std::max(passed.ToSeconds(), 1e-6) / 1_MB << " MB/s";
+}
+
+} // namespace redisserver
+} // namespace yb
@@ -1187,6 +1187,33 @@ const char* RedisParser::offset_to_pointer(size_t offset) const {
   return IoVecBegin(source_[p.first]) + p.second;
 }
 
+// Fast path for the common case of a number that consists only of decimal digits and is
+// located in a single block of data. Such numbers are parsed in place, without copying them to
+// number_buffer_ and calling strtoll. Since the number of digits is limited, the result could not
+// overflow. Returns false if the number should be parsed by the generic path, that also reports
+// errors.
+bool RedisParser::ParsePlainNumber(size_t begin, size_t end, int64_t* result) const {
+  if (begin >= end || end - begin > kMaxPlainNumberLength) {
+    return false;
+  }
+  auto p = offset_to_idx_and_local_offset(begin);
+  if (p.second + (end - begin) > source_[p.first].iov_len) {
+    return false;
+  }
+  auto* ptr = IoVecBegin(source_[p.first]) + p.second;
+  auto* stop = ptr + (end - begin);
+  int64_t value = 0;
+  for (; ptr != stop; ++ptr) {
+    unsigned digit = static_cast<unsigned char>(*ptr) - '0';
+    if (digit > 9) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  *result = value;
+  return true;
+}
+
 // Parses number with specified bounds.
 // Number is located in separate line, and contain prefix before actual number.
 // Line starts at token_begin_ and pos_ is a start of next line.
@@ -1205,11 +1232,14 @@ Result<ptrdiff_t> RedisParser::ParseNumber(char prefix,
     return STATUS_FORMAT(
         Corruption, "Too long $0 of length $1", name, expected_stop - number_begin);
   }
-  number_buffer_.reserve(kMaxNumberLength);
-  IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
-  number_buffer_.push_back(0);
-  auto parsed_number = VERIFY_RESULT(util::CheckedStoll(
-      Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  int64_t parsed_number;
+  if (!ParsePlainNumber(number_begin, expected_stop, &parsed_number)) {
+    number_buffer_.reserve(kMaxNumberLength);
+    IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
+    number_buffer_.push_back(0);
+    parsed_number = VERIFY_RESULT(util::CheckedStoll(
+        Slice(number_buffer_.data(), number_buffer_.size() - 1)));
+  }
   static_assert(sizeof(parsed_number) == sizeof(ptrdiff_t), "Expected size");
   SCHECK_BOUNDS(parsed_number,
                 min,
@@ -105,6 +105,10 @@ class RedisParser {
                                 ptrdiff_t max,
                                 const char* name);
 
+  // Parses number located in [begin, end) that consists only of decimal digits and does not
+  // cross block boundary. Returns false when generic parsing should be used instead.
+  bool ParsePlainNumber(size_t begin, size_t end, int64_t* result) const;
+
   // Returns pointer to byte with specified offset in all iovecs of source_.
   // Pointer byte is valid, the end of valid range should be determined separately if required.
   const char* offset_to_pointer(size_t offset) const;
@@ -117,6 +121,9 @@ class RedisParser {
 
   static constexpr size_t kNoToken = std::numeric_limits<size_t>::max();
 
+  // 18 decimal digits always fit into int64_t.
+  static constexpr size_t kMaxPlainNumberLength = 18;
+
   // Data to parse.
   IoVecs source_;
 
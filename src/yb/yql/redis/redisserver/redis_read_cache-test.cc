@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
+
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+RedisResponsePB StringResponse(const std::string& value) {
+  RedisResponsePB response;
+  response.set_code(RedisResponsePB::OK);
+  response.set_string_response(value);
+  return response;
+}
+
+} // namespace
+
+class RedisReadCacheTest : public YBTest {
+};
+
+TEST_F(RedisReadCacheTest, PutAndInvalidate) {
+  RedisReadCache cache(2, MonoDelta::FromSeconds(60));
+  RedisResponsePB response;
+
+  cache.Put("a", cache.Version("a"), StringResponse("1"));
+  ASSERT_TRUE(cache.Get("a", &response));
+  ASSERT_EQ("1", response.string_response());
+
+  cache.Invalidate("a");
+  ASSERT_FALSE(cache.Get("a", &response));
+
+  // A read sent before a write must not be cached when it completes after the write.
+  auto version = cache.Version("a");
+  cache.Invalidate("a");
+  cache.Put("a", version, StringResponse("old"));
+  ASSERT_FALSE(cache.Get("a", &response));
+
+  // The least recently used key is evicted.
+  cache.Put("a", cache.Version("a"), StringResponse("1"));
+  cache.Put("b", cache.Version("b"), StringResponse("2"));
+  ASSERT_TRUE(cache.Get("a", &response));
+  cache.Put("c", cache.Version("c"), StringResponse("3"));
+  ASSERT_TRUE(cache.Get("a", &response));
+  ASSERT_FALSE(cache.Get("b", &response));
+  ASSERT_TRUE(cache.Get("c", &response));
+
+  cache.Clear();
+  ASSERT_FALSE(cache.Get("a", &response));
+  ASSERT_FALSE(cache.Get("c", &response));
+}
+
+TEST_F(RedisReadCacheTest, Staleness) {
+  RedisReadCache cache(10, MonoDelta::FromMilliseconds(100));
+  RedisResponsePB response;
+
+  cache.Put("a", cache.Version("a"), StringResponse("1"));
+  ASSERT_TRUE(cache.Get("a", &response));
+  std::this_thread::sleep_for(200ms);
+  ASSERT_FALSE(cache.Get("a", &response));
+}
+
+}  // namespace redisserver
+}  // namespace yb
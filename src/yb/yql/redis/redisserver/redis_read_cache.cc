@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
+
+namespace yb {
+namespace redisserver {
+
+RedisReadCache::RedisReadCache(size_t capacity, MonoDelta max_staleness)
+    : capacity_(capacity), max_staleness_(max_staleness.ToSteadyDuration()) {
+  for (auto& version : versions_) {
+    version.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool RedisReadCache::Get(const std::string& key, RedisResponsePB* response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  if (it->second.expiration <= CoarseMonoClock::Now()) {
+    EraseUnlocked(key);
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  *response = it->second.response;
+  return true;
+}
+
+uint64_t RedisReadCache::Version(const std::string& key) const {
+  return VersionOf(key).load(std::memory_order_acquire);
+}
+
+void RedisReadCache::Put(
+    const std::string& key, uint64_t version, const RedisResponsePB& response) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Invalidate changes the version before taking the mutex, so either we see the new version here
+  // or the entry is erased after we add it.
+  if (Version(key) != version) {
+    return;
+  }
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.erase(it->second.lru_position);
+  } else {
+    if (entries_.size() >= capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+    it = entries_.emplace(key, Entry()).first;
+  }
+  lru_.push_front(key);
+  it->second.response = response;
+  it->second.expiration = CoarseMonoClock::Now() + max_staleness_;
+  it->second.lru_position = lru_.begin();
+}
+
+void RedisReadCache::Invalidate(const std::string& key) {
+  VersionOf(key).fetch_add(1, std::memory_order_acq_rel);
+  std::lock_guard<std::mutex> lock(mutex_);
+  EraseUnlocked(key);
+}
+
+void RedisReadCache::Clear() {
+  for (auto& version : versions_) {
+    version.fetch_add(1, std::memory_order_acq_rel);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+std::atomic<uint64_t>& RedisReadCache::VersionOf(const std::string& key) const {
+  return versions_[std::hash<std::string>()(key) % kNumVersions];
+}
+
+void RedisReadCache::EraseUnlocked(const std::string& key) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+}
+
+}  // namespace redisserver
+}  // namespace yb
@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
+#define YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/redis_protocol.pb.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace redisserver {
+
+// A small cache of Redis read responses in the proxy, so reads of hot keys could be served from
+// memory instead of the tablet leader.
+//
+// A cached response is returned for at most max_staleness after it was received, so writes done
+// through other proxies become visible after that time. Writes done through this proxy invalidate
+// the key both when they are sent and when they complete. A read response is not cached if the
+// key was invalidated after the read was sent, so this proxy's clients always see their own
+// writes.
+//
+// This class is thread-safe.
+class RedisReadCache {
+ public:
+  RedisReadCache(size_t capacity, MonoDelta max_staleness);
+
+  // Looks up a fresh cached response of the given key.
+  bool Get(const std::string& key, RedisResponsePB* response);
+
+  // Returns the version of the given key, that should be passed to Put with the response of a
+  // read sent after this call.
+  uint64_t Version(const std::string& key) const;
+
+  // Caches the response of a read that was sent at the given version of the key. Does nothing if
+  // the key was invalidated since then.
+  void Put(const std::string& key, uint64_t version, const RedisResponsePB& response);
+
+  // Removes the cached response of the given key, and prevents caching of reads sent before.
+  void Invalidate(const std::string& key);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    RedisResponsePB response;
+    CoarseTimePoint expiration;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  // Versions are shared by keys with the same hash, so their number does not depend on the number
+  // of written keys.
+  static constexpr size_t kNumVersions = 1024;
+
+  std::atomic<uint64_t>& VersionOf(const std::string& key) const;
+
+  void EraseUnlocked(const std::string& key);
+
+  const size_t capacity_;
+  const CoarseDuration max_staleness_;
+
+  mutable std::array<std::atomic<uint64_t>, kNumVersions> versions_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // Keys from the most to the least recently used.
+  std::list<std::string> lru_;
+};
+
+}  // namespace redisserver
+}  // namespace yb
+
+#endif  // YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H
@@ -14,6 +14,8 @@
 //
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 
+#include <boost/range/iterator_range.hpp>
+
 #include "yb/client/client_fwd.h"
 #include "yb/client/meta_cache.h"
 
@@ -86,7 +88,7 @@ Result<size_t> RedisConnectionContext::ProcessCalls(const rpc::ConnectionPtr& co
     }
     end_of_batch_ = end_of_command;
     if (++commands_in_batch_ >= FLAGS_redis_max_batch) {
-      std::vector<char> call_data;
+      rpc::CallData call_data;
       IoVecsToBuffer(data, begin_of_batch, end_of_batch_, &call_data);
       RETURN_NOT_OK(HandleInboundCall(connection, commands_in_batch_, &call_data));
       begin_of_batch = end_of_batch_;
@@ -97,7 +99,7 @@ Result<size_t> RedisConnectionContext::ProcessCalls(const rpc::ConnectionPtr& co
   // Do not form new call if we are in a middle of command.
   // It means that soon we should receive remaining data for this command and could wait.
   if (commands_in_batch_ > 0 && (end_of_batch_ == IoVecsFullSize(data) || read_buffer_full)) {
-    std::vector<char> call_data;
+    rpc::CallData call_data;
     IoVecsToBuffer(data, begin_of_batch, end_of_batch_, &call_data);
     RETURN_NOT_OK(HandleInboundCall(connection, commands_in_batch_, &call_data));
     begin_of_batch = end_of_batch_;
@@ -110,7 +112,7 @@ Result<size_t> RedisConnectionContext::ProcessCalls(const rpc::ConnectionPtr& co
 
 Status RedisConnectionContext::HandleInboundCall(const rpc::ConnectionPtr& connection,
                                                  size_t commands_in_batch,
-                                                 std::vector<char>* data) {
+                                                 rpc::CallData* data) {
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
@@ -159,7 +161,7 @@ RedisInboundCall::~RedisInboundCall() {
 }
 
 Status RedisInboundCall::ParseFrom(
-    const MemTrackerPtr& mem_tracker, size_t commands, std::vector<char>* data) {
+    const MemTrackerPtr& mem_tracker, size_t commands, rpc::CallData* data) {
   TRACE_EVENT_FLOW_BEGIN0("rpc", "RedisInboundCall", this);
   TRACE_EVENT0("rpc", "RedisInboundCall::ParseFrom");
 
@@ -306,7 +308,28 @@ RefCntBuffer SerializeResponses(const Collection& responses) {
 }
 
 void RedisInboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) const {
-  output->push_back(SerializeResponses(responses_));
+  if (transactions_.empty()) {
+    output->push_back(SerializeResponses(responses_));
+    return;
+  }
+
+  auto responses = responses_;
+  for (const auto& transaction : transactions_) {
+    auto* exec_response = &responses[transaction.second];
+    exec_response->Clear();
+    exec_response->set_code(RedisResponsePB::OK);
+    auto* array_response = exec_response->mutable_array_response();
+    array_response->set_encoded(true);
+    for (size_t idx = transaction.first + 1; idx != transaction.second; ++idx) {
+      auto& response = responses[idx];
+      array_response->add_elements(
+          SerializeResponses(boost::make_iterator_range(&response, &response + 1)).ToBuffer());
+      response.Clear();
+      response.set_code(RedisResponsePB::OK);
+      response.set_status_response("QUEUED");
+    }
+  }
+  output->push_back(SerializeResponses(responses));
 }
 
 RedisConnectionContext& RedisInboundCall::connection_context() const {
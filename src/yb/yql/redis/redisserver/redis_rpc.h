@@ -81,7 +81,7 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
   // Takes ownership of data content.
   CHECKED_STATUS HandleInboundCall(const rpc::ConnectionPtr& connection,
                                    size_t commands_in_batch,
-                                   std::vector<char>* data);
+                                   rpc::CallData* data);
 
   std::unique_ptr<RedisParser> parser_;
   size_t commands_in_batch_ = 0;
@@ -104,7 +104,7 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   ~RedisInboundCall();
   // Takes ownership of data content.
   CHECKED_STATUS ParseFrom(
-      const MemTrackerPtr& mem_tracker, size_t commands, std::vector<char>* data);
+      const MemTrackerPtr& mem_tracker, size_t commands, rpc::CallData* data);
 
   // Serialize the response packet for the finished call.
   // The resulting slices refer to memory in this object.
@@ -117,6 +117,7 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   MonoTime GetClientDeadline() const override;
 
   RedisClientBatch& client_batch() { return client_batch_; }
+  const RedisClientBatch& client_batch() const { return client_batch_; }
   RedisConnectionContext& connection_context() const;
 
   const std::string& service_name() const override;
@@ -132,6 +133,11 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
                       RedisResponsePB* resp);
   void MarkForClose() { quit_.store(true, std::memory_order_release); }
 
+  // Marks the commands between MULTI at index begin and EXEC at index end as a transaction.
+  // The commands are responded with QUEUED, and their actual responses are returned as an array
+  // in the response of EXEC.
+  void AddTransaction(size_t begin, size_t end) { transactions_.emplace_back(begin, end); }
+
  private:
 
   // The connection on which this inbound call arrived.
@@ -141,6 +147,7 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   std::atomic<size_t> ready_count_{0};
   std::atomic<bool> had_failures_{false};
   RedisClientBatch client_batch_;
+  std::vector<std::pair<size_t, size_t>> transactions_;
 
   // Atomic bool to indicate if the command batch has been parsed.
   std::atomic<bool> parsed_ = {false};
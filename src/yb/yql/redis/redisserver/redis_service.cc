@@ -14,14 +14,18 @@
 #include "yb/yql/redis/redisserver/redis_service.h"
 
 #include <iostream>
+#include <map>
 #include <thread>
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include <boost/lockfree/queue.hpp>
 
 #include <boost/logic/tribool.hpp>
 
+#include <boost/optional.hpp>
+
 #include <gflags/gflags.h>
 
 #include "yb/gutil/strings/join.h"
@@ -41,6 +45,7 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 
 #include "yb/rpc/connection.h"
@@ -116,7 +121,26 @@ DEFINE_int32(redis_password_caching_duration_ms, 5000,
              "The duration for which we will cache the redis passwords. 0 to disable.");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_int32(redis_coalescing_window_us, 0,
+             "Time window in microseconds during which operations from different connections "
+             "that target the same tablet are accumulated and flushed together. "
+             "0 to disable.");
+DEFINE_int32(redis_coalescing_max_operations, 500,
+             "Maximum number of operations in a block of coalesced operations. When reached, "
+             "the block is flushed without waiting for the end of the coalescing window.");
 DEFINE_bool(enable_redis_auth, true, "Enable AUTH for the Redis service");
+DEFINE_int32(redis_publish_batch_window_us, 0,
+             "Time window in microseconds during which messages published to the same server "
+             "are accumulated and forwarded in a single RPC. 0 to disable. Should be enabled only "
+             "after all servers support batched publish requests.");
+DEFINE_int32(redis_publish_max_batch_size, 1000,
+             "Maximum number of messages forwarded to a server in a single publish RPC.");
+DEFINE_int32(redis_read_cache_max_staleness_ms, 0,
+             "Maximum time in milliseconds for which GET responses are cached by the Redis "
+             "proxy. Writes done through other proxies could be invisible for that long. "
+             "0 to disable the cache.");
+DEFINE_int32(redis_read_cache_capacity, 1000,
+             "Maximum number of keys in the Redis proxy read cache.");
 
 DECLARE_string(placement_cloud);
 DECLARE_string(placement_region);
@@ -198,6 +222,14 @@ class Operation {
     return responded_.load(std::memory_order_acquire);
   }
 
+  // Makes a read put its response to the read cache, or a write invalidate the read cache, when
+  // the operation completes.
+  void SetReadCache(RedisReadCache* read_cache, std::string cache_key, uint64_t cache_version) {
+    read_cache_ = read_cache;
+    cache_key_ = std::move(cache_key);
+    cache_version_ = cache_version;
+  }
+
   size_t index() const {
     return index_;
   }
@@ -206,6 +238,15 @@ class Operation {
     return type_;
   }
 
+  // Whether this is the first operation of a MULTI/EXEC transaction.
+  bool transaction_start() const {
+    return transaction_start_;
+  }
+
+  void SetTransactionStart() {
+    transaction_start_ = true;
+  }
+
   const YBRedisOp& operation() const {
     return *operation_;
   }
@@ -294,6 +335,9 @@ class Operation {
 
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
+    if (read_cache_) {
+      UpdateReadCache(status);
+    }
     if (manual_response_) {
       return;
     }
@@ -318,6 +362,18 @@ class Operation {
   }
 
  private:
+  void UpdateReadCache(const Status& status) {
+    if (type_ == OperationType::kWrite) {
+      read_cache_->Invalidate(cache_key_);
+      return;
+    }
+    const auto& resp = response();
+    if (status.ok() &&
+        (resp.code() == RedisResponsePB::OK || resp.code() == RedisResponsePB::NIL)) {
+      read_cache_->Put(cache_key_, cache_version_, resp);
+    }
+  }
+
   OperationType type_;
   std::shared_ptr<RedisInboundCall> call_;
   size_t index_;
@@ -328,6 +384,10 @@ class Operation {
   ManualResponse manual_response_;
   client::internal::RemoteTabletPtr tablet_;
   std::atomic<bool> responded_{false};
+  RedisReadCache* read_cache_ = nullptr;
+  std::string cache_key_;
+  uint64_t cache_version_ = 0;
+  bool transaction_start_ = false;
 };
 
 class SessionPool {
@@ -369,20 +429,41 @@ class SessionPool {
   scoped_refptr<AtomicGauge<uint64_t>> available_sessions_metric_;
 };
 
+typedef std::unordered_map<const client::YBOperation*, Status> OperationErrors;
+
+// Collects errors of failed operations from the session.
+// Returns true if one of operations failed because of not found tablet.
+bool CollectErrors(client::YBSession* session, OperationErrors* op_errors) {
+  bool tablet_not_found = false;
+  for (const auto& error : session->GetPendingErrors()) {
+    if (error->status().IsNotFound()) {
+      tablet_not_found = true;
+    }
+    (*op_errors)[&error->failed_op()] = std::move(error->status());
+    YB_LOG_EVERY_N_SECS(WARNING, 1) << "Explicit error while inserting: "
+                                    << error->status().ToString();
+  }
+  return tablet_not_found;
+}
+
 class Block;
 typedef std::shared_ptr<Block> BlockPtr;
 
+class BlockCoalescer;
+
 class Block : public std::enable_shared_from_this<Block> {
  public:
   typedef MCVector<Operation*> Ops;
 
   Block(const BatchContextPtr& context,
         Ops::allocator_type allocator,
-        rpc::RpcMethodMetrics metrics_internal)
+        rpc::RpcMethodMetrics metrics_internal,
+        BlockCoalescer* coalescer)
       : context_(context),
         ops_(allocator),
         metrics_internal_(std::move(metrics_internal)),
-        start_(MonoTime::Now()) {
+        start_(MonoTime::Now()),
+        coalescer_(coalescer) {
   }
 
   Block(const Block&) = delete;
@@ -392,9 +473,10 @@ class Block : public std::enable_shared_from_this<Block> {
     ops_.push_back(operation);
   }
 
-  void Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread = true) {
-    session_pool_ = session_pool;
-    session_ = session_pool->Take();
+  void Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread = true);
+
+  void DoLaunch(bool allow_local_calls_in_curr_thread) {
+    session_ = session_pool_->Take();
     bool has_ok = false;
     bool applied_operations = false;
     // Supposed to be called only once.
@@ -445,37 +527,49 @@ class Block : public std::enable_shared_from_this<Block> {
   };
 
   friend class BlockCallback;
+  friend class BlockCoalescer;
+
+  // Type of operations in this block, blocks contain operations of a single type.
+  OperationType type() const {
+    return ops_.empty() ? OperationType::kNone : ops_.front()->type();
+  }
+
+  // Applies operations of this block to the session shared with other blocks.
+  // Returns true if at least one operation was applied.
+  bool ApplyTo(client::YBSession* session) {
+    bool applied_operations = false;
+    // Callback is used only by local operations, that are never coalesced.
+    StatusFunctor callback;
+    for (auto* op : ops_) {
+      op->Apply(session, callback, &applied_operations);
+    }
+    return applied_operations;
+  }
 
   void Done(const Status& status) {
+    OperationErrors op_errors;
+    bool tablet_not_found = false;
+    if (!status.ok() && session_ != nullptr) {
+      tablet_not_found = CollectErrors(session_.get(), &op_errors);
+    }
+    Done(status, op_errors, tablet_not_found);
+  }
+
+  void Done(const Status& status, const OperationErrors& op_errors, bool tablet_not_found) {
     MonoTime now = MonoTime::Now();
     metrics_internal_.handler_latency->Increment(now.GetDeltaSince(start_).ToMicroseconds());
     VLOG(3) << "Received status from call " << status.ToString(true);
 
-    std::unordered_map<const client::YBOperation*, Status> op_errors;
-    bool tablet_not_found = false;
-    if (!status.ok()) {
-      if (session_ != nullptr) {
-        for (const auto& error : session_->GetPendingErrors()) {
-          if (error->status().IsNotFound()) {
-            tablet_not_found = true;
-          }
-          op_errors[&error->failed_op()] = std::move(error->status());
-          YB_LOG_EVERY_N_SECS(WARNING, 1) << "Explicit error while inserting: "
-                                          << error->status().ToString();
-        }
-      }
-    }
-
     if (tablet_not_found && Retrying()) {
         // We will retry and not mark the ops as failed.
         return;
     }
 
     for (auto* op : ops_) {
-      if (op->has_operation() && op_errors.find(&op->operation()) != op_errors.end()) {
+      auto it = op->has_operation() ? op_errors.find(&op->operation()) : op_errors.end();
+      if (it != op_errors.end()) {
         // Could check here for NotFound either.
-        auto s = op_errors[&op->operation()];
-        op->Respond(s);
+        op->Respond(it->second);
       } else {
         op->Respond(Status::OK());
       }
@@ -537,12 +631,145 @@ class Block : public std::enable_shared_from_this<Block> {
   Ops ops_;
   rpc::RpcMethodMetrics metrics_internal_;
   MonoTime start_;
+  BlockCoalescer* coalescer_;
   SessionPool* session_pool_;
   std::shared_ptr<client::YBSession> session_;
   BlockPtr next_;
   int num_retries_ = 1;
 };
 
+// Accumulates read and write blocks from different connections that target the same tablet,
+// and flushes them using a single session, so they are sent to the tablet in one RPC.
+// Since the next block of a connection is launched only after its previous block is done,
+// coalescing does not change the order of operations within a connection.
+class BlockCoalescer : public std::enable_shared_from_this<BlockCoalescer> {
+ public:
+  void Init(SessionPool* session_pool, rpc::Messenger* messenger) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    session_pool_ = session_pool;
+    messenger_ = messenger;
+  }
+
+  // Returns false if the block could not be coalesced and should be launched separately.
+  bool Add(const BlockPtr& block) {
+    auto window_us = FLAGS_redis_coalescing_window_us;
+    auto type = block->type();
+    if (window_us <= 0 || (type != OperationType::kRead && type != OperationType::kWrite)) {
+      return false;
+    }
+    const auto& tablet = block->ops_.front()->tablet();
+    if (!tablet) {
+      return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!messenger_) {
+      return false;
+    }
+    Key key(tablet->tablet_id(), type);
+    auto it = batches_.find(key);
+    if (it == batches_.end()) {
+      it = batches_.emplace(key, Batch()).first;
+      auto batch_id = it->second.id = ++last_batch_id_;
+      std::weak_ptr<BlockCoalescer> weak_self = shared_from_this();
+      // The batch is flushed even if the task is aborted, so the operations are responded in
+      // any case.
+      messenger_->scheduler().Schedule(
+          [weak_self, key, batch_id](const Status& status) {
+            auto self = weak_self.lock();
+            if (self) {
+              self->Flush(key, batch_id);
+            }
+          },
+          std::chrono::microseconds(window_us));
+    }
+    auto& batch = it->second;
+    batch.blocks.push_back(block);
+    batch.num_operations += block->ops_.size();
+    if (batch.num_operations >= std::max(FLAGS_redis_coalescing_max_operations, 1)) {
+      FlushUnlocked(it, &lock);
+    }
+    return true;
+  }
+
+ private:
+  typedef std::pair<std::string, OperationType> Key;
+
+  struct Batch {
+    uint64_t id = 0;
+    std::vector<BlockPtr> blocks;
+    size_t num_operations = 0;
+  };
+
+  typedef std::map<Key, Batch> Batches;
+
+  void Flush(const Key& key, uint64_t batch_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = batches_.find(key);
+    if (it == batches_.end() || it->second.id != batch_id) {
+      // This batch was already flushed because it was full.
+      return;
+    }
+    FlushUnlocked(it, &lock);
+  }
+
+  void FlushUnlocked(Batches::iterator it, std::unique_lock<std::mutex>* lock) {
+    auto blocks = std::move(it->second.blocks);
+    batches_.erase(it);
+    auto* session_pool = session_pool_;
+    lock->unlock();
+
+    auto session = session_pool->Take();
+    std::vector<BlockPtr> applied_blocks;
+    applied_blocks.reserve(blocks.size());
+    for (auto& block : blocks) {
+      if (block->ApplyTo(session.get())) {
+        applied_blocks.push_back(std::move(block));
+      } else {
+        // All operations of this block were already responded.
+        // Block context owns the arena upon which this block is created, so keep it alive
+        // until the block reference is released. See BlockCallback for details.
+        auto context = block->context_;
+        block->Processed();
+        block.reset();
+      }
+    }
+    if (applied_blocks.empty()) {
+      session_pool->Release(session);
+      return;
+    }
+
+    session->FlushAsync([session_pool, session, blocks = std::move(applied_blocks)](
+        const Status& status) mutable {
+      OperationErrors op_errors;
+      bool tablet_not_found = false;
+      if (!status.ok()) {
+        tablet_not_found = CollectErrors(session.get(), &op_errors);
+      }
+      session_pool->Release(session);
+      for (auto& block : blocks) {
+        auto context = block->context_;
+        block->Done(status, op_errors, tablet_not_found);
+        block.reset();
+      }
+    });
+  }
+
+  std::mutex mutex_;
+  SessionPool* session_pool_ = nullptr;
+  rpc::Messenger* messenger_ = nullptr;
+  Batches batches_;
+  uint64_t last_batch_id_ = 0;
+};
+
+void Block::Launch(SessionPool* session_pool, bool allow_local_calls_in_curr_thread) {
+  session_pool_ = session_pool;
+  if (coalescer_ && coalescer_->Add(shared_from_this())) {
+    return;
+  }
+  DoLaunch(allow_local_calls_in_curr_thread);
+}
+
 typedef std::array<rpc::RpcMethodMetrics, kOperationTypeMapSize> InternalMetrics;
 
 struct BlockData {
@@ -560,8 +787,8 @@ struct BlockData {
 
 class TabletOperations {
  public:
-  explicit TabletOperations(Arena* arena)
-      : read_data_(arena), write_data_(arena) {
+  TabletOperations(Arena* arena, BlockCoalescer* coalescer)
+      : read_data_(arena), write_data_(arena), coalescer_(coalescer) {
   }
 
   BlockData& data(OperationType type) {
@@ -596,9 +823,14 @@ class TabletOperations {
                const InternalMetrics& metrics_internal) {
     auto type = operation->type();
     if (type == OperationType::kLocal) {
-      ProcessLocalOperation(context, arena, operation, metrics_internal);
+      AddBarrier(context, arena, metrics_internal)->AddOperation(operation);
       return;
     }
+    if (operation->transaction_start()) {
+      // Operations of a transaction are all reads or all writes of this tablet, so after the
+      // barrier they are added to a single block, that is sent to the tablet in one RPC.
+      AddBarrier(context, arena, metrics_internal);
+    }
     boost::container::small_vector<Slice, RedisClientCommand::static_capacity> keys;
     operation->GetKeys(&keys);
     CheckConflicts(type, keys);
@@ -606,7 +838,8 @@ class TabletOperations {
     if (!data.block) {
       ArenaAllocator<Block> alloc(arena);
       data.block = std::allocate_shared<Block>(
-          alloc, context, alloc, metrics_internal[static_cast<size_t>(OperationType::kRead)]);
+          alloc, context, alloc, metrics_internal[static_cast<size_t>(OperationType::kRead)],
+          coalescer_);
       if (last_conflict_type_ == OperationType::kLocal) {
         last_local_block_->SetNext(data.block);
         last_conflict_type_ = type;
@@ -629,13 +862,15 @@ class TabletOperations {
   }
 
  private:
-  void ProcessLocalOperation(const BatchContextPtr& context,
-                             Arena* arena,
-                             Operation* operation,
-                             const InternalMetrics& metrics_internal) {
+  // Adds a block that is launched after all blocks added so far, and before all blocks added
+  // later. Returns the added block, that is empty unless a local operation is added to it.
+  BlockPtr AddBarrier(const BatchContextPtr& context,
+                      Arena* arena,
+                      const InternalMetrics& metrics_internal) {
     ArenaAllocator<Block> alloc(arena);
     auto block = std::allocate_shared<Block>(
-        alloc, context, alloc, metrics_internal[static_cast<size_t>(OperationType::kLocal)]);
+        alloc, context, alloc, metrics_internal[static_cast<size_t>(OperationType::kLocal)],
+        nullptr /* coalescer */);
     switch (last_conflict_type_) {
       case OperationType::kNone:
         if (read_data_.block) {
@@ -668,7 +903,7 @@ class TabletOperations {
     write_data_.used_keys.clear();
     last_local_block_ = block;
     last_conflict_type_ = OperationType::kLocal;
-    block->AddOperation(operation);
+    return block;
   }
 
   void ConflictFound(OperationType type) {
@@ -734,6 +969,7 @@ class TabletOperations {
   BlockData write_data_;
   BlockPtr flush_head_;
   BlockPtr last_local_block_;
+  BlockCoalescer* coalescer_;
 
   // Type of command that caused last conflict between reads and writes.
   OperationType last_conflict_type_ = OperationType::kNone;
@@ -741,6 +977,8 @@ class TabletOperations {
 
 YB_STRONGLY_TYPED_BOOL(IsMonitorMessage);
 
+class PublishBatcher;
+
 struct RedisServiceImplData : public RedisServiceData {
   RedisServiceImplData(RedisServer* server, string&& yb_tier_master_addresses);
 
@@ -774,6 +1012,11 @@ struct RedisServiceImplData : public RedisServiceData {
   CHECKED_STATUS Initialize();
   bool initialized() const { return initialized_.load(std::memory_order_relaxed); }
 
+  // Whether table for the db was already opened, so it could be used without an RPC.
+  bool IsYBTableForDBCached(const string& db_name) {
+    return tables_cache_->GetCachedTable(GetYBTableNameForRedisDatabase(db_name)) != nullptr;
+  }
+
   // yb::Result<std::shared_ptr<client::YBTable>> GetYBTableForDB(const string& db_name);
 
   std::string yb_tier_master_addresses_;
@@ -786,6 +1029,9 @@ struct RedisServiceImplData : public RedisServiceData {
   std::atomic<bool> initialized_;
   std::shared_ptr<client::YBClient> client_;
   SessionPool session_pool_;
+  std::shared_ptr<BlockCoalescer> block_coalescer_ = std::make_shared<BlockCoalescer>();
+  // Cache of GET responses, null when disabled.
+  std::unique_ptr<RedisReadCache> read_cache_;
   std::unordered_map<std::string, std::shared_ptr<client::YBTable>> db_to_opened_table_;
   std::shared_ptr<client::YBMetaDataCache> tables_cache_;
 
@@ -798,6 +1044,10 @@ struct RedisServiceImplData : public RedisServiceData {
   };
   std::unordered_map<Connection*, ClientSubscription> clients_to_subscriptions_;
 
+  // Batchers of messages forwarded to other servers, keyed by server address.
+  std::mutex publish_batchers_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<PublishBatcher>> publish_batchers_;
+
   std::unordered_set<Connection*> monitoring_clients_;
   scoped_refptr<AtomicGauge<uint64_t>> num_clients_monitoring_;
 
@@ -884,18 +1134,58 @@ class BatchContextImpl : public BatchContext {
     }
   }
 
+  // Operations applied until EndTransaction are sent after all operations applied before, and
+  // before all operations applied after. Reads of the transaction bypass the read cache.
+  void StartTransaction() {
+    in_transaction_ = true;
+    transaction_start_pending_ = true;
+  }
+
+  void EndTransaction() {
+    in_transaction_ = false;
+    transaction_start_pending_ = false;
+  }
+
   void Apply(
       size_t index,
       std::shared_ptr<client::YBRedisReadOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    auto* read_cache = impl_data_->read_cache_.get();
+    if (!read_cache || in_transaction_ || !operation->request().has_get_request() ||
+        operation->request().get_request().request_type() != RedisGetRequestPB::GET) {
+      DoApply(index, std::move(operation), metrics);
+      return;
+    }
+
+    auto cache_key = ReadCacheKey(*operation);
+    RedisResponsePB cached_response;
+    if (read_cache->Get(cache_key, &cached_response)) {
+      call_->RespondSuccess(index, metrics, &cached_response);
+      return;
+    }
+    auto cache_version = read_cache->Version(cache_key);
+    if (DoApply(index, std::move(operation), metrics)) {
+      operations_.back().SetReadCache(read_cache, std::move(cache_key), cache_version);
+    }
   }
 
   void Apply(
       size_t index,
       std::shared_ptr<client::YBRedisWriteOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    auto* read_cache = impl_data_->read_cache_.get();
+    if (!read_cache) {
+      DoApply(index, std::move(operation), metrics);
+      return;
+    }
+
+    // Invalidate before the write is sent, so reads that follow it in this batch are not served
+    // from the cache, and once more when it completes.
+    auto cache_key = ReadCacheKey(*operation);
+    read_cache->Invalidate(cache_key);
+    if (DoApply(index, std::move(operation), metrics)) {
+      operations_.back().SetReadCache(read_cache, std::move(cache_key), 0);
+    }
   }
 
   void Apply(
@@ -912,14 +1202,24 @@ class BatchContextImpl : public BatchContext {
   }
 
  private:
+  // Returns false if the operation was responded immediately.
   template <class... Args>
-  void DoApply(Args&&... args) {
+  bool DoApply(Args&&... args) {
     operations_.emplace_back(call_, std::forward<Args>(args)...);
     if (PREDICT_FALSE(operations_.back().responded())) {
       operations_.pop_back();
-    } else {
-      consumption_.Add(operations_.back().space_used_by_request());
+      return false;
     }
+    consumption_.Add(operations_.back().space_used_by_request());
+    if (transaction_start_pending_) {
+      operations_.back().SetTransactionStart();
+      transaction_start_pending_ = false;
+    }
+    return true;
+  }
+
+  std::string ReadCacheKey(const YBRedisOp& operation) const {
+    return db_name_ + '\0' + operation.GetKey();
   }
 
   void LookupDone(
@@ -950,7 +1250,9 @@ class BatchContextImpl : public BatchContext {
       if (!operation.responded()) {
         auto it = tablets_.find(operation.tablet()->tablet_id());
         if (it == tablets_.end()) {
-          it = tablets_.emplace(operation.tablet()->tablet_id(), TabletOperations(&arena_)).first;
+          it = tablets_.emplace(
+              operation.tablet()->tablet_id(),
+              TabletOperations(&arena_, impl_data_->block_coalescer_.get())).first;
         }
         it->second.Process(self, &arena_, &operation, impl_data_->metrics_internal_);
       }
@@ -974,6 +1276,8 @@ class BatchContextImpl : public BatchContext {
   std::atomic<bool> retry_lookups_;
   std::atomic<size_t> lookups_left_;
   MCUnorderedMap<Slice, TabletOperations, Slice::Hash> tablets_;
+  bool in_transaction_ = false;
+  bool transaction_start_pending_ = false;
 };
 
 } // namespace
@@ -991,6 +1295,11 @@ class RedisServiceImpl::Impl {
 
   void Handle(yb::rpc::InboundCallPtr call_ptr);
 
+  bool ShouldHandleInline(const RedisInboundCall& call);
+
+  // Returns true if all commands of the call are known read only commands.
+  bool IsReadOnly(const RedisInboundCall& call);
+
  private:
   void SetupMethod(const RedisCommandInfo& info) {
     auto info_ptr = std::make_shared<RedisCommandInfo>(info);
@@ -1029,6 +1338,26 @@ class RedisServiceImpl::Impl {
   // Fetches the appropriate handler for the command, nullptr if none exists.
   const RedisCommandInfo* FetchHandler(const RedisClientCommand& cmd_args);
 
+  // Returns the handler of the command at the given index, or responds with a failure and returns
+  // nullptr if the command could not be executed.
+  const RedisCommandInfo* CheckCommand(
+      const std::shared_ptr<RedisInboundCall>& call, size_t idx,
+      RedisConnectionContext* conn_context);
+
+  // Returns the index of EXEC or DISCARD that ends the transaction started by MULTI at begin.
+  boost::optional<size_t> FindTransactionEnd(const RedisClientBatch& batch, size_t begin);
+
+  // Handles the transaction from MULTI at begin to EXEC or DISCARD at end.
+  void HandleTransaction(
+      const std::shared_ptr<RedisInboundCall>& call, size_t begin, size_t end,
+      const std::string& remote, const std::string& db_name, BatchContextImpl* context);
+
+  // Checks that the commands of the transaction can be executed atomically: all of them are reads
+  // or all of them are writes, of keys that belong to a single tablet.
+  CHECKED_STATUS CheckTransaction(
+      BatchContextImpl* context, const RedisClientBatch& batch,
+      const std::vector<std::pair<size_t, const RedisCommandInfo*>>& commands);
+
   std::deque<std::string> names_;
   std::unordered_map<Slice, RedisCommandInfoPtr, Slice::Hash> command_name_to_info_map_;
 
@@ -1206,8 +1535,8 @@ class PublishResponseHandler {
   PublishResponseHandler(int32_t n, IntFunctor f)
       : num_replies_pending(n), done_functor(std::move(f)) {}
 
-  void HandleResponse(const tserver::PublishResponsePB* resp) {
-    num_clients_forwarded_to.IncrementBy(resp->num_clients_forwarded_to());
+  void HandleResponse(int32_t num_clients) {
+    num_clients_forwarded_to.IncrementBy(num_clients);
 
     if (0 == num_replies_pending.IncrementBy(-1)) {
       done_functor(num_clients_forwarded_to.Load());
@@ -1220,6 +1549,108 @@ class PublishResponseHandler {
   IntFunctor done_functor;
 };
 
+namespace {
+
+// Accumulates messages published to the same server and forwards them in a single RPC.
+class PublishBatcher : public std::enable_shared_from_this<PublishBatcher> {
+ public:
+  PublishBatcher(std::shared_ptr<tserver::TabletServerServiceProxy> proxy,
+                 rpc::Messenger* messenger)
+      : proxy_(std::move(proxy)), messenger_(messenger) {}
+
+  void Add(const string& channel, const string& message,
+           std::shared_ptr<PublishResponseHandler> handler) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto window_us = FLAGS_redis_publish_batch_window_us;
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<Batch>();
+      current_batch_->request.set_channel(channel);
+      current_batch_->request.set_message(message);
+      if (window_us > 0) {
+        std::weak_ptr<PublishBatcher> weak_self = shared_from_this();
+        auto batch_id = batch_id_;
+        // The batch is sent even if the task is aborted, so the handlers are invoked in any case.
+        messenger_->scheduler().Schedule(
+            [weak_self, batch_id](const Status& status) {
+              auto self = weak_self.lock();
+              if (self) {
+                self->Send(batch_id);
+              }
+            },
+            std::chrono::microseconds(window_us));
+      }
+    } else {
+      auto* additional_message = current_batch_->request.add_additional_messages();
+      additional_message->set_channel(channel);
+      additional_message->set_message(message);
+    }
+    current_batch_->handlers.push_back(std::move(handler));
+
+    if (window_us <= 0 ||
+        current_batch_->handlers.size() >=
+            static_cast<size_t>(std::max(FLAGS_redis_publish_max_batch_size, 1))) {
+      SendUnlocked(&lock);
+    }
+  }
+
+ private:
+  struct Batch {
+    tserver::PublishRequestPB request;
+    tserver::PublishResponsePB response;
+    rpc::RpcController controller;
+    std::vector<std::shared_ptr<PublishResponseHandler>> handlers;
+  };
+
+  void Send(uint64_t batch_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (batch_id != batch_id_ || !current_batch_) {
+      // This batch was already sent because it was full.
+      return;
+    }
+    SendUnlocked(&lock);
+  }
+
+  void SendUnlocked(std::unique_lock<std::mutex>* lock) {
+    auto batch = std::move(current_batch_);
+    ++batch_id_;
+    lock->unlock();
+
+    // The callback holds the batch, so the request, response and controller stay valid.
+    proxy_->PublishAsync(
+        batch->request, &batch->response, &batch->controller,
+        [batch]() {
+          BatchDone(*batch);
+        });
+  }
+
+  static void BatchDone(const Batch& batch) {
+    const auto& response = batch.response;
+    if (!batch.controller.status().ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 1) << "Failed to forward published messages: "
+                                      << batch.controller.status();
+    }
+    for (size_t i = 0; i != batch.handlers.size(); ++i) {
+      int32_t num_clients = 0;
+      if (batch.controller.status().ok()) {
+        if (i == 0) {
+          num_clients = response.num_clients_forwarded_to();
+        } else if (i <= static_cast<size_t>(response.additional_num_clients_forwarded_to_size())) {
+          num_clients = response.additional_num_clients_forwarded_to(i - 1);
+        }
+      }
+      batch.handlers[i]->HandleResponse(num_clients);
+    }
+  }
+
+  std::shared_ptr<tserver::TabletServerServiceProxy> proxy_;
+  rpc::Messenger* messenger_;
+  std::mutex mutex_;
+  std::shared_ptr<Batch> current_batch_;
+  uint64_t batch_id_ = 0;
+};
+
+} // namespace
+
 void RedisServiceImplData::ForwardToInterestedProxies(
     const string& channel, const string& message, const IntFunctor& f) {
   auto interested_servers = GetServerAddrsForChannel(channel);
@@ -1227,32 +1658,26 @@ void RedisServiceImplData::ForwardToInterestedProxies(
     LOG(ERROR) << "Could not get servers to forward to " << interested_servers.status();
     return;
   }
+  if (interested_servers->empty()) {
+    f(0);
+    return;
+  }
   std::shared_ptr<PublishResponseHandler> resp_handler =
       std::make_shared<PublishResponseHandler>(interested_servers->size(), f);
   for (auto& hostport_pb : *interested_servers) {
-    tserver::PublishRequestPB requestPB;
-    requestPB.set_channel(channel);
-    requestPB.set_message(message);
-    std::shared_ptr<tserver::TabletServerServiceProxy> proxy =
-        std::make_shared<tserver::TabletServerServiceProxy>(
-            &client_->proxy_cache(), HostPortFromPB(hostport_pb));
-    std::shared_ptr<tserver::PublishResponsePB> responsePB =
-        std::make_shared<tserver::PublishResponsePB>();
-    std::shared_ptr<yb::rpc::RpcController> rpcController = std::make_shared<rpc::RpcController>();
-    // Hold a copy of the shared ptr in the callback to ensure that the proxy, responsePB and
-    // rpcController are valid.
-    // these self-destruct on the latter of the two events
-    //  (i)  exit this loop, and
-    //  (ii) done with the callback.
-    proxy->PublishAsync(
-        requestPB, responsePB.get(), rpcController.get(),
-        [resp_handler, responsePB, rpcController, proxy]() mutable {
-          resp_handler->HandleResponse(responsePB.get());
-          responsePB.reset();
-          rpcController.reset();
-          proxy.reset();
-          resp_handler.reset();
-        });
+    auto host_port = HostPortFromPB(hostport_pb);
+    std::shared_ptr<PublishBatcher> batcher;
+    {
+      std::lock_guard<std::mutex> lock(publish_batchers_mutex_);
+      auto& entry = publish_batchers_[host_port.ToString()];
+      if (!entry) {
+        entry = std::make_shared<PublishBatcher>(
+            std::make_shared<tserver::TabletServerServiceProxy>(&client_->proxy_cache(), host_port),
+            client_->messenger().get());
+      }
+      batcher = entry;
+    }
+    batcher->Add(channel, message, resp_handler);
   }
 }
 
@@ -1382,6 +1807,12 @@ Status RedisServiceImplData::Initialize() {
     tables_cache_ = std::make_shared<YBMetaDataCache>(client_,
         false /* Update roles permissions cache */);
     session_pool_.Init(client_, server_->metric_entity());
+    block_coalescer_->Init(&session_pool_, client_->messenger().get());
+    if (FLAGS_redis_read_cache_max_staleness_ms > 0) {
+      read_cache_ = std::make_unique<RedisReadCache>(
+          FLAGS_redis_read_cache_capacity,
+          MonoDelta::FromMilliseconds(FLAGS_redis_read_cache_max_staleness_ms));
+    }
 
     initialized_.store(true, std::memory_order_release);
   }
@@ -1442,6 +1873,30 @@ const RedisCommandInfo* RedisServiceImpl::Impl::FetchHandler(const RedisClientCo
   return iter->second.get();
 }
 
+// Batches of read commands only parse the commands and start asynchronous reads, so they do not
+// block the reactor thread once the client is initialized and the table of the db is opened.
+bool RedisServiceImpl::Impl::ShouldHandleInline(const RedisInboundCall& call) {
+  if (!data_.initialized() ||
+      call.serialized_request().size() > FLAGS_redis_max_command_size ||
+      !data_.IsYBTableForDBCached(call.connection_context().redis_db_to_use())) {
+    return false;
+  }
+  return IsReadOnly(call);
+}
+
+bool RedisServiceImpl::Impl::IsReadOnly(const RedisInboundCall& call) {
+  for (const auto& command : call.client_batch()) {
+    if (command.empty()) {
+      return false;
+    }
+    auto it = command_name_to_info_map_.find(command[0]);
+    if (it == command_name_to_info_map_.end() || !it->second->read_only) {
+      return false;
+    }
+  }
+  return true;
+}
+
 RedisServiceImpl::Impl::Impl(RedisServer* server, string yb_tier_master_addresses)
     : data_(server, std::move(yb_tier_master_addresses)) {
   PopulateHandlers();
@@ -1497,58 +1952,195 @@ void RedisServiceImpl::Impl::Handle(rpc::InboundCallPtr call_ptr) {
   string db_name = conn_context->redis_db_to_use();
   auto context = make_scoped_refptr<BatchContextImpl>(db_name, call, &data_);
   for (size_t idx = 0; idx != batch.size(); ++idx) {
+    auto cmd_info = CheckCommand(call, idx, conn_context);
+    if (cmd_info == nullptr) {
+      continue;
+    }
+
+    if (cmd_info->name == "multi") {
+      auto end = FindTransactionEnd(batch, idx);
+      if (end) {
+        HandleTransaction(call, idx, *end, remote, db_name, context.get());
+        idx = *end;
+        continue;
+      }
+    }
+
     const RedisClientCommand& c = batch[idx];
+    if (cmd_info->name != "config" && cmd_info->name != "monitor") {
+      data_.LogToMonitors(remote, db_name, c);
+    }
 
-    auto cmd_info = FetchHandler(c);
+    // Handle the call.
+    cmd_info->functor(*cmd_info, idx, context.get());
 
-    // Handle the current redis command.
-    if (cmd_info == nullptr) {
-      RespondWithFailure(call, idx, "Unsupported call.");
-      continue;
-    } else if (!AllowedInClientMode(cmd_info, conn_context->ClientMode())) {
-      RespondWithFailure(
-          call, idx, Substitute(
-                         "Command $0 not allowed in client mode $1.", cmd_info->name,
-                         yb::ToString(conn_context->ClientMode())));
+    if (cmd_info->name == "select" && db_name != conn_context->redis_db_to_use()) {
+      // update context.
+      context->Commit();
+      db_name = conn_context->redis_db_to_use();
+      context = make_scoped_refptr<BatchContextImpl>(db_name, call, &data_);
+    }
+  }
+  context->Commit();
+}
+
+const RedisCommandInfo* RedisServiceImpl::Impl::CheckCommand(
+    const std::shared_ptr<RedisInboundCall>& call, size_t idx,
+    RedisConnectionContext* conn_context) {
+  const RedisClientCommand& c = call->client_batch()[idx];
+
+  auto cmd_info = FetchHandler(c);
+
+  if (cmd_info == nullptr) {
+    RespondWithFailure(call, idx, "Unsupported call.");
+    return nullptr;
+  } else if (!AllowedInClientMode(cmd_info, conn_context->ClientMode())) {
+    RespondWithFailure(
+        call, idx, Substitute(
+                       "Command $0 not allowed in client mode $1.", cmd_info->name,
+                       yb::ToString(conn_context->ClientMode())));
+    return nullptr;
+  }
+
+  size_t arity = static_cast<size_t>(std::abs(cmd_info->arity) - 1);
+  bool exact_count = cmd_info->arity > 0;
+  size_t passed_arguments = c.size() - 1;
+  if (!exact_count && passed_arguments < arity) {
+    // -X means that the command needs >= X arguments.
+    YB_LOG_EVERY_N_SECS(ERROR, 60)
+        << "Requested command " << c[0] << " does not have enough arguments."
+        << " At least " << arity << " expected, but " << passed_arguments << " found.";
+    RespondWithFailure(call, idx, "Too few arguments.");
+  } else if (exact_count && passed_arguments != arity) {
+    // X (> 0) means that the command needs exactly X arguments.
+    YB_LOG_EVERY_N_SECS(ERROR, 60)
+        << "Requested command " << c[0] << " has wrong number of arguments. "
+        << arity << " expected, but " << passed_arguments << " found.";
+    RespondWithFailure(call, idx, "Wrong number of arguments.");
+  } else if (!CheckArgumentSizeOK(c)) {
+    RespondWithFailure(call, idx, "Redis argument too long.");
+  } else if (!CheckAuthentication(conn_context) && cmd_info->name != "auth") {
+    RespondWithFailure(call, idx, "Authentication required.", "NOAUTH");
+  } else {
+    return cmd_info;
+  }
+  return nullptr;
+}
+
+boost::optional<size_t> RedisServiceImpl::Impl::FindTransactionEnd(
+    const RedisClientBatch& batch, size_t begin) {
+  for (size_t idx = begin + 1; idx != batch.size(); ++idx) {
+    if (batch[idx].empty()) {
       continue;
     }
+    const auto name = batch[idx][0].ToBuffer();
+    if (boost::iequals(name, "exec") || boost::iequals(name, "discard")) {
+      return idx;
+    }
+    if (boost::iequals(name, "multi")) {
+      break;
+    }
+  }
+  return boost::none;
+}
+
+// Commands of the transaction are checked before any of them is executed, so an invalid command
+// aborts the whole transaction, as in Redis. Since Redis tables are not transactional, the
+// commands should belong to a single tablet and should not mix reads and writes. Then the
+// commands are sent to the tablet in a single RPC, whose writes the tablet applies atomically, or
+// whose reads the tablet serves at a single read time.
+void RedisServiceImpl::Impl::HandleTransaction(
+    const std::shared_ptr<RedisInboundCall>& call, size_t begin, size_t end,
+    const std::string& remote, const std::string& db_name, BatchContextImpl* context) {
+  const auto& batch = call->client_batch();
+  RedisConnectionContext* conn_context = &call->connection_context();
+  const RedisCommandInfo* begin_info = FetchHandler(batch[begin]);
 
-    size_t arity = static_cast<size_t>(std::abs(cmd_info->arity) - 1);
-    bool exact_count = cmd_info->arity > 0;
-    size_t passed_arguments = c.size() - 1;
-    if (!exact_count && passed_arguments < arity) {
-      // -X means that the command needs >= X arguments.
-      YB_LOG_EVERY_N_SECS(ERROR, 60)
-          << "Requested command " << c[0] << " does not have enough arguments."
-          << " At least " << arity << " expected, but " << passed_arguments << " found.";
-      RespondWithFailure(call, idx, "Too few arguments.");
-    } else if (exact_count && passed_arguments != arity) {
-      // X (> 0) means that the command needs exactly X arguments.
-      YB_LOG_EVERY_N_SECS(ERROR, 60)
-          << "Requested command " << c[0] << " has wrong number of arguments. "
-          << arity << " expected, but " << passed_arguments << " found.";
-      RespondWithFailure(call, idx, "Wrong number of arguments.");
-    } else if (!CheckArgumentSizeOK(c)) {
-      RespondWithFailure(call, idx, "Redis argument too long.");
-    } else if (!CheckAuthentication(conn_context) && cmd_info->name != "auth") {
-      RespondWithFailure(call, idx, "Authentication required.", "NOAUTH");
+  std::vector<std::pair<size_t, const RedisCommandInfo*>> commands;
+  bool failed = false;
+  for (size_t idx = begin + 1; idx != end; ++idx) {
+    auto cmd_info = CheckCommand(call, idx, conn_context);
+    if (cmd_info == nullptr) {
+      failed = true;
+    } else if (cmd_info->local) {
+      RespondWithFailure(call, idx, "Command not allowed inside a transaction.");
+      failed = true;
     } else {
-      if (cmd_info->name != "config" && cmd_info->name != "monitor") {
-        data_.LogToMonitors(remote, db_name, c);
-      }
+      commands.emplace_back(idx, cmd_info);
+    }
+  }
+  const RedisCommandInfo* end_info = CheckCommand(call, end, conn_context);
+  failed = failed || end_info == nullptr;
 
-      // Handle the call.
-      cmd_info->functor(*cmd_info, idx, context.get());
+  RedisResponsePB ok_response;
+  call->RespondSuccess(begin, begin_info->metrics, &ok_response);
 
-      if (cmd_info->name == "select" && db_name != conn_context->redis_db_to_use()) {
-        // update context.
-        context->Commit();
-        db_name = conn_context->redis_db_to_use();
-        context = make_scoped_refptr<BatchContextImpl>(db_name, call, &data_);
+  Status status;
+  if (!failed && end_info->name == "exec") {
+    status = CheckTransaction(context, batch, commands);
+    if (status.ok()) {
+      call->AddTransaction(begin, end);
+      context->StartTransaction();
+      for (const auto& command : commands) {
+        data_.LogToMonitors(remote, db_name, batch[command.first]);
+        command.second->functor(*command.second, command.first, context);
       }
+      context->EndTransaction();
+      // Actual response is built from responses of the transaction commands.
+      call->RespondSuccess(end, end_info->metrics, &ok_response);
+      return;
     }
   }
-  context->Commit();
+
+  for (const auto& command : commands) {
+    RedisResponsePB queued_response;
+    queued_response.set_code(RedisResponsePB::OK);
+    queued_response.set_status_response("QUEUED");
+    call->RespondSuccess(command.first, command.second->metrics, &queued_response);
+  }
+  if (end_info == nullptr) {
+    return;
+  }
+  if (end_info->name == "discard") {
+    call->RespondSuccess(end, end_info->metrics, &ok_response);
+  } else if (failed) {
+    call->RespondFailure(end, STATUS(InvalidCommand,
+        "EXECABORT Transaction discarded because of previous errors."));
+  } else {
+    call->RespondFailure(end, status);
+  }
+}
+
+Status RedisServiceImpl::Impl::CheckTransaction(
+    BatchContextImpl* context, const RedisClientBatch& batch,
+    const std::vector<std::pair<size_t, const RedisCommandInfo*>>& commands) {
+  for (const auto& command : commands) {
+    if (command.second->read_only != commands.front().second->read_only) {
+      return STATUS(InvalidCommand,
+                    "ERR Transactions that mix reads and writes are not supported, since the reads "
+                    "would not be isolated from the writes of the transaction");
+    }
+  }
+  auto table = context->table();
+  if (!table) {
+    return STATUS(IllegalState, "Could not open YBTable");
+  }
+  const auto& partitions = table->GetPartitions();
+  boost::optional<size_t> tablet_idx;
+  for (const auto& command : commands) {
+    std::string partition_key;
+    RETURN_NOT_OK(table->partition_schema().EncodeRedisKey(batch[command.first][1],
+                                                           &partition_key));
+    size_t idx = std::upper_bound(partitions.begin(), partitions.end(), partition_key) -
+                 partitions.begin() - 1;
+    if (tablet_idx && *tablet_idx != idx) {
+      return STATUS(InvalidCommand,
+                    "CROSSSLOT Keys in a transaction should belong to the same tablet, "
+                    "use hash tags to place them together");
+    }
+    tablet_idx = idx;
+  }
+  return Status::OK();
 }
 
 RedisServiceImpl::RedisServiceImpl(RedisServer* server, string yb_tier_master_address)
@@ -1562,5 +2154,14 @@ void RedisServiceImpl::Handle(yb::rpc::InboundCallPtr call) {
   impl_->Handle(std::move(call));
 }
 
+bool RedisServiceImpl::ShouldHandleInline(const rpc::InboundCall& call) {
+  return impl_->ShouldHandleInline(static_cast<const RedisInboundCall&>(call));
+}
+
+rpc::CallPriority RedisServiceImpl::GetCallPriority(const rpc::InboundCall& call) {
+  return impl_->IsReadOnly(static_cast<const RedisInboundCall&>(call))
+      ? rpc::CallPriority::kLatencySensitive : rpc::CallPriority::kBulk;
+}
+
 }  // namespace redisserver
 }  // namespace yb
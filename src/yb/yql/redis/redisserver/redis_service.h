@@ -31,6 +31,10 @@ class RedisServiceImpl : public RedisServerServiceIf {
 
   void Handle(yb::rpc::InboundCallPtr call) override;
 
+  bool ShouldHandleInline(const rpc::InboundCall& call) override;
+
+  rpc::CallPriority GetCallPriority(const rpc::InboundCall& call) override;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -46,6 +46,7 @@ DECLARE_uint64(redis_max_read_buffer_size);
 DECLARE_uint64(redis_max_queued_bytes);
 DECLARE_int64(redis_rpc_block_size);
 DECLARE_bool(redis_safe_batch);
+DECLARE_int32(redis_coalescing_window_us);
 DECLARE_bool(emulate_redis_responses);
 DECLARE_bool(enable_backpressure_mode_for_testing);
 DECLARE_bool(yedis_enable_flush);
@@ -57,6 +58,7 @@ DECLARE_int32(rpc_max_message_size);
 DECLARE_int32(consensus_max_batch_size_bytes);
 DECLARE_int32(consensus_rpc_timeout_ms);
 DECLARE_int64(max_time_in_queue_ms);
+DECLARE_int32(redis_packed_collection_max_entries);
 
 DEFINE_uint64(test_redis_max_concurrent_commands, 20,
     "Value of redis_max_concurrent_commands for pipeline test");
@@ -907,6 +909,86 @@ TEST_F(TestRedisService, SimpleCommandInline) {
   SendCommandAndExpectResponse(__LINE__, "set foo bar\r\n", "+OK\r\n");
 }
 
+TEST_F(TestRedisService, MultiExec) {
+  // Hash tags place all keys of a transaction in the same tablet.
+  SendCommandAndExpectResponse(
+      __LINE__,
+      "multi\r\nset {t}a 1\r\nincr {t}b\r\nincr {t}a\r\nexec\r\n",
+      "+OK\r\n+QUEUED\r\n+QUEUED\r\n+QUEUED\r\n*3\r\n+OK\r\n:1\r\n:2\r\n");
+  // Commands of the pipeline around the transaction keep their order, and the writes of the
+  // transaction are sent in a single batch even if they conflict with preceding reads.
+  SendCommandAndExpectResponse(
+      __LINE__,
+      "get {t}a\r\nmulti\r\nset {t}c 3\r\nset {t}a 3\r\nexec\r\n"
+      "multi\r\nget {t}a\r\nget {t}c\r\nexec\r\n",
+      "$1\r\n2\r\n+OK\r\n+QUEUED\r\n+QUEUED\r\n*2\r\n+OK\r\n+OK\r\n"
+      "+OK\r\n+QUEUED\r\n+QUEUED\r\n*2\r\n$1\r\n3\r\n$1\r\n3\r\n");
+  // Reads are not isolated from writes of the same transaction, so mixing them is rejected.
+  SendCommandAndExpectResponse(
+      __LINE__,
+      "multi\r\nset {t}a 1\r\nget {t}a\r\nincr {t}a\r\nexec\r\nget {t}a\r\n",
+      "+OK\r\n+QUEUED\r\n+QUEUED\r\n+QUEUED\r\n"
+      "-ERR Transactions that mix reads and writes are not supported, since the reads would not be "
+      "isolated from the writes of the transaction\r\n$1\r\n3\r\n");
+  SendCommandAndExpectResponse(
+      __LINE__,
+      "multi\r\nset {t}d 1\r\ndiscard\r\nget {t}d\r\n",
+      "+OK\r\n+QUEUED\r\n+OK\r\n$-1\r\n");
+  // Invalid command aborts the transaction.
+  SendCommandAndExpectResponse(
+      __LINE__,
+      "multi\r\nset {t}d 2\r\nset {t}d\r\nexec\r\nget {t}d\r\n",
+      "+OK\r\n+QUEUED\r\n-ERR set: Wrong number of arguments.\r\n"
+      "-EXECABORT Transaction discarded because of previous errors.\r\n$-1\r\n");
+  SendCommandAndExpectResponse(__LINE__, "exec\r\n", "-EXEC without MULTI\r\n");
+}
+
+TEST_F(TestRedisService, PackedCollections) {
+  FLAGS_redis_packed_collection_max_entries = 3;
+
+  // A hash stays packed while it holds at most 3 fields.
+  DoRedisTestInt(__LINE__, {"HSET", "packed_hash", "f1", "v1"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"HSET", "packed_hash", "f2", "v2"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"HSET", "packed_hash", "f1", "v3"}, 0);
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"HGET", "packed_hash", "f1"}, "v3");
+  DoRedisTestNull(__LINE__, {"HGET", "packed_hash", "f3"});
+  DoRedisTestInt(__LINE__, {"HLEN", "packed_hash"}, 2);
+  DoRedisTestInt(__LINE__, {"HEXISTS", "packed_hash", "f2"}, 1);
+  DoRedisTestArray(__LINE__, {"HGETALL", "packed_hash"}, {"f1", "v3", "f2", "v2"});
+  DoRedisTestInt(__LINE__, {"HINCRBY", "packed_hash", "counter", "5"}, 5);
+  SyncClient();
+  // The fourth field converts the hash to one key per field.
+  DoRedisTestOk(__LINE__, {"HMSET", "packed_hash", "f4", "v4", "f5", "v5"});
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"HGETALL", "packed_hash"},
+                   {"counter", "5", "f1", "v3", "f2", "v2", "f4", "v4", "f5", "v5"});
+  DoRedisTestInt(__LINE__, {"HDEL", "packed_hash", "f1", "f6"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"HLEN", "packed_hash"}, 4);
+
+  DoRedisTestInt(__LINE__, {"SADD", "packed_set", "m1", "m2"}, 2);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"SADD", "packed_set", "m2", "m3"}, 1);
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"SMEMBERS", "packed_set"}, {"m1", "m2", "m3"});
+  DoRedisTestInt(__LINE__, {"SISMEMBER", "packed_set", "m3"}, 1);
+  DoRedisTestInt(__LINE__, {"SREM", "packed_set", "m1", "m4"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"SCARD", "packed_set"}, 2);
+  DoRedisTestInt(__LINE__, {"EXPIRE", "packed_set", "1000"}, 1);
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"SMEMBERS", "packed_set"}, {"m2", "m3"});
+  // Removing the last members removes the key.
+  DoRedisTestInt(__LINE__, {"SREM", "packed_set", "m2", "m3"}, 2);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"EXISTS", "packed_set"}, 0);
+  SyncClient();
+  VerifyCallbacks();
+}
+
 void TestRedisService::TestAbort(const std::string& command) {
   ASSERT_OK(Send(command));
   std::this_thread::sleep_for(1000ms);
@@ -1302,6 +1384,40 @@ TEST_F_EX(TestRedisService, SafeBatchPipeline, TestRedisServiceSafeBatch) {
   LOG(INFO) << yb::Format("Safe set: $0ms, get: $1ms", set_time.count(), get_time.count());
 }
 
+class TestRedisServiceCoalescing : public TestRedisService {
+ public:
+  void SetUp() override {
+    FLAGS_redis_coalescing_window_us = 5000;
+    TestRedisService::SetUp();
+  }
+};
+
+// Checks that operations from different connections are coalesced without breaking the order
+// of operations within each connection.
+TEST_F_EX(TestRedisService, CoalescedConnections, TestRedisServiceCoalescing) {
+  constexpr int kClients = 4;
+  constexpr int kKeys = 50;
+  std::vector<shared_ptr<RedisClient>> clients;
+  for (int i = 0; i != kClients; ++i) {
+    clients.push_back(std::make_shared<RedisClient>("127.0.0.1", server_port()));
+  }
+  for (int i = 0; i != kClients; ++i) {
+    UseClient(clients[i]);
+    for (int j = 0; j != kKeys; ++j) {
+      auto key = Format("key_$0", j);
+      auto value = Format("value_$0_$1", i, j);
+      DoRedisTestOk(__LINE__, {"SET", Format("$0_$1", key, i), value});
+      DoRedisTestBulkString(__LINE__, {"GET", Format("$0_$1", key, i)}, value);
+    }
+  }
+  for (const auto& client : clients) {
+    UseClient(client);
+    SyncClient();
+  }
+  VerifyCallbacks();
+  UseClient(nullptr);
+}
+
 TEST_F(TestRedisService, BatchedCommandMulti) {
   SendCommandAndExpectResponse(
       __LINE__,
@@ -2521,6 +2637,19 @@ TEST_F(TestRedisServiceExternal, TestSubscribeCluster) {
   TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kSubscribe, PatternOrChannel::kChannel);
 }
 
+class TestRedisServiceExternalBatchedPublish : public TestRedisServiceExternal {
+ protected:
+  void CustomizeExternalMiniCluster(ExternalMiniClusterOptions* opts) override {
+    opts->extra_tserver_flags.push_back("--redis_publish_batch_window_us=2000");
+  }
+};
+
+TEST_F_EX(TestRedisServiceExternal, TestSubscribeClusterBatchedPublish,
+          TestRedisServiceExternalBatchedPublish) {
+  expected_no_sessions_ = true;
+  TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kSubscribe, PatternOrChannel::kChannel);
+}
+
 TEST_F(TestRedisServiceExternal, TestUnsubscribe) {
   expected_no_sessions_ = true;
   TestPubSub(LocalOrCluster::kLocal, SubOrUnsub::kUnsubscribe, PatternOrChannel::kChannel);
@@ -3198,6 +3327,40 @@ TEST_F(TestRedisService, TestZRevRange) {
   VerifyCallbacks();
 }
 
+// Ranges close to the end of a sorted set are read by scanning the set backward.
+TEST_F(TestRedisService, TestZRevRangeLargeSet) {
+  FLAGS_emulate_redis_responses = true;
+  constexpr int kMembers = 100;
+  // Members of a deleted set should not be visible after the set is created again.
+  DoRedisTestInt(__LINE__, {"ZADD", "z_large", "1000", "old_member"}, 1);
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"DEL", "z_large"}, 1);
+  SyncClient();
+  for (int i = 0; i != kMembers; ++i) {
+    DoRedisTestInt(__LINE__, {"ZADD", "z_large", std::to_string(i), Format("v$0", i)}, 1);
+  }
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_large", "0", "2"}, {"v99", "v98", "v97"});
+  DoRedisTestScoreValueArray(__LINE__, {"ZRANGE", "z_large", "-2", "-1", "WITHSCORES"},
+                             {98, 99}, {"v98", "v99"});
+
+  // Removed and updated members.
+  DoRedisTestInt(__LINE__, {"ZREM", "z_large", "v98"}, 1);
+  DoRedisTestInt(__LINE__, {"ZADD", "z_large", "CH", "-1", "v99"}, 1);
+  DoRedisTestInt(__LINE__, {"ZADD", "z_large", "97", "w97"}, 1);
+  SyncClient();
+
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_large", "0", "2"}, {"w97", "v97", "v96"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_large", "1", "2"}, {"v97", "v96"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_large", "-3", "-1"}, {"v96", "v97", "w97"});
+  DoRedisTestArray(__LINE__, {"ZRANGE", "z_large", "0", "1"}, {"v99", "v0"});
+  DoRedisTestArray(__LINE__, {"ZREVRANGE", "z_large", "-2", "-1"}, {"v0", "v99"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestZRange) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;
@@ -4693,6 +4856,46 @@ TEST_F(TestRedisService, Keys) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, Scan) {
+  constexpr int kNumKeys = 50;
+  for (int i = 0; i != kNumKeys; ++i) {
+    DoRedisTestOk(__LINE__, {"SET", Format("scan_key_$0", i), "v"});
+  }
+  DoRedisTestInt(__LINE__, {"HSET", "other_key", "f", "v"}, 1);
+  SyncClient();
+
+  for (const std::string& count : {"1", "7", "1000"}) {
+    std::string cursor = "0";
+    std::unordered_multiset<std::string> keys;
+    int iterations = 0;
+    do {
+      DoRedisTest(__LINE__, {"SCAN", cursor, "MATCH", "scan_key_*", "COUNT", count},
+                  RedisReplyType::kArray,
+                  [&cursor, &keys](const RedisReply& reply) {
+                    const auto& replies = reply.as_array();
+                    ASSERT_EQ(2, replies.size());
+                    cursor = replies[0].as_string();
+                    for (const auto& key : replies[1].as_array()) {
+                      keys.insert(key.as_string());
+                    }
+                  });
+      SyncClient();
+      ASSERT_LE(++iterations, 2 * kNumKeys + 2);
+    } while (cursor != "0");
+
+    ASSERT_EQ(kNumKeys, keys.size()) << "COUNT " << count;
+    for (int i = 0; i != kNumKeys; ++i) {
+      ASSERT_EQ(1, keys.count(Format("scan_key_$0", i))) << "COUNT " << count;
+    }
+  }
+
+  DoRedisTestExpectError(__LINE__, {"SCAN", "x"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "COUNT", "0"});
+  DoRedisTestExpectError(__LINE__, {"SCAN", "0", "MATCH"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, KeysZeroChar) {
   FLAGS_emulate_redis_responses = true;
   string s("foo\0bar", 6);